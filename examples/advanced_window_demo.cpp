@@ -76,6 +76,25 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
             }
             return 0;
             
+        case WM_ENTERSIZEMOVE: {
+            // Snap targets are read once per drag
+            auto& manager = SDK::WindowManager::GetInstance();
+            manager.GetSnapping().BeginMove(hwnd, manager.GetWindowsByDepth());
+            
+            // Resizing shows a stretched copy of the last frame
+            auto window = manager.GetWindow(hwnd);
+            if (window) window->BeginLiveResize();
+            return 0;
+        }
+        
+        case WM_EXITSIZEMOVE: {
+            auto& manager = SDK::WindowManager::GetInstance();
+            manager.GetSnapping().EndMove();
+            auto window = manager.GetWindow(hwnd);
+            if (window) window->EndLiveResize();
+            return 0;
+        }
+            
         case WM_MOVING: {
             // Apply snapping during window move
             RECT* pRect = reinterpret_cast<RECT*>(lParam);
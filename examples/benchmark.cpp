@@ -0,0 +1,1064 @@
+/**
+ * 5D GUI SDK Benchmarks
+ * Times the SDK's hot paths without opening a window and writes the results
+ * as JSON, so one release can be compared against the next. Runs on the
+ * Windows and Linux builds; benchmarks that need GDI are Windows only.
+ * Before timing anything it checks the vectorized blur and bloom against the
+ * scalar reference kernels, and exits with 1 if any output differs.
+ *
+ * Input replays report frame-time statistics under "replays": a built-in
+ * drag, and with --trace a file recorded with SDK::InputTrace, each replayed
+ * into the same headless particle scene on a fixed 60 Hz clock.
+ *
+ * Usage: 5DGUI_Bench [--filter text] [--out results.json] [--min-time ms] [--quick] [--trace file]
+ *   --filter    Only run benchmarks whose name contains text
+ *   --out       Write the JSON there instead of to stdout
+ *   --min-time  Keep repeating each benchmark for at least this long (default 250)
+ *   --quick     Skip the largest sizes
+ *   --trace     Also replay this recorded input trace
+ */
+
+#include "SDK/Platform.h"
+#include "SDK/PixelKernels.h"
+#include "SDK/ParticleSystem.h"
+#include "SDK/NeuralNetwork.h"
+#include "SDK/SimplexSolver.h"
+#include "SDK/JobScheduler.h"
+#include "SDK/ImageCache.h"
+#include "SDK/GlyphAtlas.h"
+#include "SDK/StringUtils.h"
+#include "SDK/AnimationTimeline.h"
+#include "SDK/Easing.h"
+#include "SDK/InputTrace.h"
+#include "SDK/PointerHistory.h"
+#include "SDK/HeadlessRenderBackend.h"
+#include "SDK/PngEncoder.h"
+#include "SDK/Widget.h"
+#include "SDK/Layout.h"
+#include "SDK/DataGrid.h"
+#include "SDK/WidgetSpatialIndex.h"
+
+#if SDK_PLATFORM_WINDOWS
+#include "SDK/Renderer.h"
+#include "SDK/RichText.h"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifndef SDK_BENCH_VERSION
+#define SDK_BENCH_VERSION "unknown"
+#endif
+
+namespace {
+
+// Results are written here so the optimizer can't drop the work
+volatile uint64_t g_sink = 0;
+
+struct Options {
+    std::string filter;
+    std::string out;
+    std::string trace;
+    double minTimeMs;
+    bool quick;
+
+    Options() : minTimeMs(250.0), quick(false) {}
+};
+
+struct Result {
+    std::string name;
+    int iterations;
+    double meanNs;
+    double medianNs;
+    double minNs;
+    double maxNs;
+    double stddevNs;
+    double itemsPerSecond;  // Items per iteration over the median time
+};
+
+struct ReplayResult {
+    std::string name;
+    SDK::InputTrace::ReplayStats stats;
+};
+
+class Bench {
+public:
+    explicit Bench(const Options& options) : m_options(options) {}
+
+    bool IsQuick() const { return m_options.quick; }
+
+    // setup runs only when the benchmark isn't filtered out, and returns the
+    // body to time; items is the work one call of the body does
+    template <typename Setup>
+    void Run(const std::string& name, double items, Setup setup) {
+        if (!m_options.filter.empty() && name.find(m_options.filter) == std::string::npos) return;
+
+        std::function<void()> body = setup();
+        body();     // Warm caches and lazy initialization
+
+        std::vector<double> samples;
+        auto start = std::chrono::steady_clock::now();
+        double elapsedMs = 0.0;
+        while ((elapsedMs < m_options.minTimeMs || samples.size() < MIN_ITERATIONS) &&
+               samples.size() < MAX_ITERATIONS) {
+            auto begin = std::chrono::steady_clock::now();
+            body();
+            auto end = std::chrono::steady_clock::now();
+            samples.push_back(std::chrono::duration<double, std::nano>(end - begin).count());
+            elapsedMs = std::chrono::duration<double, std::milli>(end - start).count();
+        }
+
+        Result result;
+        result.name = name;
+        result.iterations = (int)samples.size();
+        std::sort(samples.begin(), samples.end());
+        double sum = 0.0;
+        for (double s : samples) sum += s;
+        result.meanNs = sum / samples.size();
+        result.medianNs = samples[samples.size() / 2];
+        result.minNs = samples.front();
+        result.maxNs = samples.back();
+        double variance = 0.0;
+        for (double s : samples) variance += (s - result.meanNs) * (s - result.meanNs);
+        result.stddevNs = std::sqrt(variance / samples.size());
+        result.itemsPerSecond = result.medianNs > 0.0 ? items * 1e9 / result.medianNs : 0.0;
+        m_results.push_back(result);
+
+        fprintf(stderr, "%-40s %8d iters %14.0f ns median\n", name.c_str(), result.iterations, result.medianNs);
+    }
+
+    // Replays once and keeps the frame times; replay returns the statistics
+    void Replay(const std::string& name, std::function<SDK::InputTrace::ReplayStats()> replay) {
+        if (!m_options.filter.empty() && name.find(m_options.filter) == std::string::npos) return;
+
+        ReplayResult result = { name, replay() };
+        m_replays.push_back(result);
+        fprintf(stderr, "%-40s %8llu frames %8.3f ms median %8.3f ms p99\n", name.c_str(),
+                (unsigned long long)result.stats.frames, result.stats.medianFrameMs, result.stats.p99FrameMs);
+    }
+
+    void WriteJson(FILE* file) const;
+
+private:
+    static constexpr size_t MIN_ITERATIONS = 5;
+    static constexpr size_t MAX_ITERATIONS = 100000;
+
+    Options m_options;
+    std::vector<Result> m_results;
+    std::vector<ReplayResult> m_replays;
+};
+
+void WriteString(FILE* file, const std::string& text) {
+    fputc('"', file);
+    for (char c : text) {
+        if (c == '"' || c == '\\') fputc('\\', file);
+        fputc(c, file);
+    }
+    fputc('"', file);
+}
+
+void Bench::WriteJson(FILE* file) const {
+    fprintf(file, "{\n  \"version\": ");
+    WriteString(file, SDK_BENCH_VERSION);
+    fprintf(file, ",\n  \"platform\": \"%s\",\n",
+            SDK_PLATFORM_WINDOWS ? "windows" : SDK_PLATFORM_LINUX ? "linux" : "macos");
+    fprintf(file, "  \"instructionSet\": \"%s\",\n",
+            SDK::PixelKernels::GetInstructionSetName(SDK::PixelKernels::GetActiveInstructionSet()));
+    fprintf(file, "  \"workers\": %u,\n", SDK::JobScheduler::GetWorkerCount());
+    fprintf(file, "  \"results\": [");
+    for (size_t i = 0; i < m_results.size(); i++) {
+        const Result& r = m_results[i];
+        fprintf(file, "%s\n    {\"name\": ", i ? "," : "");
+        WriteString(file, r.name);
+        fprintf(file, ", \"iterations\": %d, \"meanNs\": %.1f, \"medianNs\": %.1f, \"minNs\": %.1f, "
+                      "\"maxNs\": %.1f, \"stddevNs\": %.1f, \"itemsPerSecond\": %.1f}",
+                r.iterations, r.meanNs, r.medianNs, r.minNs, r.maxNs, r.stddevNs, r.itemsPerSecond);
+    }
+    fprintf(file, "\n  ],\n  \"replays\": [");
+    for (size_t i = 0; i < m_replays.size(); i++) {
+        const SDK::InputTrace::ReplayStats& s = m_replays[i].stats;
+        fprintf(file, "%s\n    {\"name\": ", i ? "," : "");
+        WriteString(file, m_replays[i].name);
+        fprintf(file, ", \"frames\": %llu, \"events\": %llu, \"meanFrameMs\": %.4f, \"medianFrameMs\": %.4f, "
+                      "\"p95FrameMs\": %.4f, \"p99FrameMs\": %.4f, \"maxFrameMs\": %.4f}",
+                (unsigned long long)s.frames, (unsigned long long)s.events, s.meanFrameMs, s.medianFrameMs,
+                s.p95FrameMs, s.p99FrameMs, s.maxFrameMs);
+    }
+    fprintf(file, "\n  ]\n}\n");
+}
+
+std::vector<uint32_t> NoiseImage(int size) {
+    std::vector<uint32_t> pixels((size_t)size * size);
+    std::mt19937 random(1);
+    for (auto& pixel : pixels) pixel = random() | 0xFF000000u;
+    return pixels;
+}
+
+// ---------------------------------------------------------------------------
+// Portable benchmarks
+
+// The vectorized blur and bloom must match the scalar reference kernels bit
+// for bit on every instruction set the CPU has; timing wrong output is moot
+bool CheckPixelKernels() {
+    using SDK::PixelKernels;
+    const PixelKernels::InstructionSet active = PixelKernels::GetActiveInstructionSet();
+    const int width = 97, height = 61, stride = 101;   // Odd sizes cover the SIMD tails
+    std::vector<uint32_t> source = NoiseImage(stride);
+    source.resize((size_t)stride * height);
+
+    bool ok = true;
+    for (auto set : { PixelKernels::InstructionSet::SCALAR, PixelKernels::InstructionSet::SSE2,
+                      PixelKernels::InstructionSet::AVX2, PixelKernels::InstructionSet::NEON }) {
+        if (!PixelKernels::IsSupported(set)) continue;
+        PixelKernels::SetInstructionSet(set);
+
+        auto check = [&](const std::string& what, const std::function<void(uint32_t*)>& kernel,
+                         const std::function<void(uint32_t*)>& reference) {
+            std::vector<uint32_t> actual = source;
+            std::vector<uint32_t> expected = source;
+            kernel(actual.data());
+            reference(expected.data());
+            if (actual != expected) {
+                fprintf(stderr, "%s %s differs from the scalar reference\n",
+                        PixelKernels::GetInstructionSetName(set), what.c_str());
+                ok = false;
+            }
+        };
+        for (int radius : { 1, 4, 8, 40 }) {
+            for (int passes : { 1, 3 }) {
+                check("box blur r" + std::to_string(radius) + " x" + std::to_string(passes),
+                      [=](uint32_t* pixels) { PixelKernels::BoxBlur(pixels, width, height, stride, radius, passes); },
+                      [=](uint32_t* pixels) { PixelKernels::BoxBlurReference(pixels, width, height, stride, radius, passes); });
+            }
+            check("bloom r" + std::to_string(radius),
+                  [=](uint32_t* pixels) { PixelKernels::Bloom(pixels, width, height, stride, 0.5f, 1.5f, radius); },
+                  [=](uint32_t* pixels) { PixelKernels::BloomReference(pixels, width, height, stride, 0.5f, 1.5f, radius); });
+        }
+    }
+    PixelKernels::SetInstructionSet(active);
+    return ok;
+}
+
+void PixelBenchmarks(Bench& bench) {
+    for (int size : { 256, 512, 1024 }) {
+        std::string suffix = "/" + std::to_string(size);
+        double pixels = (double)size * size;
+
+        bench.Run("pixels/box_blur" + suffix, pixels, [size]() {
+            auto image = std::make_shared<std::vector<uint32_t>>(NoiseImage(size));
+            return [image, size]() { SDK::PixelKernels::BoxBlur(image->data(), size, size, size, 8); };
+        });
+        bench.Run("pixels/gaussian_blur" + suffix, pixels, [size]() {
+            auto image = std::make_shared<std::vector<uint32_t>>(NoiseImage(size));
+            return [image, size]() { SDK::PixelKernels::GaussianBlur(image->data(), size, size, size, 6.0f); };
+        });
+        bench.Run("pixels/bloom" + suffix, pixels, [size]() {
+            auto image = std::make_shared<std::vector<uint32_t>>(NoiseImage(size));
+            return [image, size]() { SDK::PixelKernels::Bloom(image->data(), size, size, size, 0.7f, 1.5f); };
+        });
+        bench.Run("pixels/blend_over" + suffix, pixels, [size]() {
+            auto layer = std::make_shared<std::vector<uint32_t>>(NoiseImage(size));
+            for (auto& pixel : *layer) pixel = SDK::PremultipliedPixel::FromStraight(pixel & 0x80FFFFFFu);
+            auto image = std::make_shared<std::vector<uint32_t>>(NoiseImage(size));
+            return [layer, image]() { SDK::PixelKernels::BlendOver(image->data(), layer->data(), image->size()); };
+        });
+        bench.Run("image/scale_half" + suffix, pixels, [size]() {
+            auto image = std::make_shared<std::vector<uint32_t>>(NoiseImage(size));
+            auto scaled = std::make_shared<std::vector<uint32_t>>((size_t)(size / 2) * (size / 2));
+            return [image, scaled, size]() {
+                SDK::ImageCache::Scale(image->data(), size, size, scaled->data(), size / 2, size / 2);
+            };
+        });
+    }
+}
+
+void ParticleBenchmarks(Bench& bench) {
+    for (int count : { 10000, 100000 }) {
+        bench.Run("particles/update/" + std::to_string(count), count, [count]() {
+            auto particles = std::make_shared<SDK::ParticleSystem>(count);
+            std::mt19937 random(2);
+            std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+            for (int i = 0; i < count; i++) {
+                // Long lives keep the count steady while timing
+                particles->Emit(unit(random) * 500.0f, unit(random) * 500.0f,
+                                unit(random) * 50.0f, unit(random) * 50.0f, 1e6f, SDK::Color(255, 128, 0));
+            }
+            particles->Update(0.0f);
+            return [particles]() { particles->Update(1.0f / 60.0f); };
+        });
+    }
+
+    bench.Run("particles/splat/100000", 100000, []() {
+        const int size = 1024;
+        auto image = std::make_shared<std::vector<uint32_t>>((size_t)size * size, 0u);
+        auto x = std::make_shared<std::vector<float>>(100000);
+        auto y = std::make_shared<std::vector<float>>(100000);
+        auto colors = std::make_shared<std::vector<uint32_t>>(100000, 0x80FF8000u);
+        std::mt19937 random(3);
+        std::uniform_real_distribution<float> position(0.0f, (float)size);
+        for (size_t i = 0; i < x->size(); i++) {
+            (*x)[i] = position(random);
+            (*y)[i] = position(random);
+        }
+        return [=]() {
+            SDK::PixelKernels::SplatParticles(image->data(), size, size, size, x->data(), y->data(),
+                                              colors->data(), x->size(), 0, 0, 3);
+        };
+    });
+}
+
+void AnimationBenchmarks(Bench& bench) {
+    using EasingType = SDK::Renderer::EasingType;
+    const int count = 10000;
+
+    bench.Run("animation/timeline/" + std::to_string(count), count, [count]() {
+        auto timeline = std::make_shared<SDK::AnimationTimeline>();
+        auto values = std::make_shared<std::vector<float>>(count);
+        for (int i = 0; i < count; i++) {
+            // Every easing in turn, staggered so the tracks sit mid-segment
+            std::vector<SDK::Renderer::Keyframe> keys = {
+                { 0.0f, 0.0f, (EasingType)(i % 16) },
+                { 1.0f, 100.0f, EasingType::EASE_OUT_ELASTIC },
+                { 2.0f, 0.0f, EasingType::LINEAR }
+            };
+            auto track = timeline->CreateTrack(keys, 2.0f, true);
+            timeline->Bind(track, &(*values)[i]);
+            timeline->Play(track);
+            timeline->Advance((float)(i % 97) / 97.0f);
+        }
+        return [timeline, values]() { timeline->Advance(1.0f / 60.0f); };
+    });
+
+    for (bool exact : { true, false }) {
+        bench.Run(exact ? "animation/ease_exact" : "animation/ease_table", count, [count, exact]() {
+            auto t = std::make_shared<std::vector<float>>(count);
+            return [t, count, exact]() {
+                for (int i = 0; i < count; i++) (*t)[i] = (float)i / count;
+                float* values = t->data();
+                if (exact) {
+                    for (int i = 0; i < count; i++) {
+                        values[i] = SDK::Easing::EvaluateExact(EasingType::EASE_OUT_ELASTIC, values[i]);
+                    }
+                } else {
+                    SDK::Easing::EvaluateBatch(EasingType::EASE_OUT_ELASTIC, values, count);
+                }
+            };
+        });
+    }
+
+    bench.Run("animation/cubic_bezier", count, [count]() {
+        auto curve = SDK::Easing::GetCubicBezier(0.25f, 0.1f, 0.25f, 1.0f);
+        auto sum = std::make_shared<float>(0.0f);
+        return [curve, sum, count]() {
+            for (int i = 0; i < count; i++) *sum += curve->Evaluate((float)i / count);
+        };
+    });
+}
+
+const std::vector<std::wstring>& SamplePrompts() {
+    static const std::vector<std::wstring> prompts = {
+        L"Create a window titled 'Settings' with size 800x600",
+        L"Add a button labeled 'Save' that closes the window on click",
+        L"Add a red progress bar at 75 percent",
+        L"Add a checkbox 'Remember me'",
+        L"Add a combobox with items Small, Medium, Large",
+        L"Use a grid layout with 3 columns",
+        L"Set the theme to dark",
+        L"Add a slider from 0 to 100",
+    };
+    return prompts;
+}
+
+void NeuralBenchmarks(Bench& bench) {
+    auto network = std::make_shared<SDK::NeuralNetwork>();
+    network->Initialize();
+    const auto& prompts = SamplePrompts();
+
+    bench.Run("neural/parse_prompt", (double)prompts.size(), [network, &prompts]() {
+        return [network, &prompts]() {
+            for (const auto& prompt : prompts) {
+                g_sink += (uint64_t)network->ParsePrompt(prompt).intent;
+            }
+        };
+    });
+    bench.Run("neural/parse_prompts", (double)prompts.size(), [network, &prompts]() {
+        return [network, &prompts]() { g_sink += network->ParsePrompts(prompts).size(); };
+    });
+
+    const int epochs = 5;
+    bench.Run("neural/train", (double)prompts.size() * epochs, [&prompts, epochs]() {
+        auto trainee = std::make_shared<SDK::NeuralNetwork>();
+        trainee->Initialize();
+        auto samples = std::make_shared<std::vector<std::pair<std::wstring, SDK::NeuralNetwork::ParsedPrompt>>>();
+        for (const auto& prompt : prompts) {
+            samples->emplace_back(prompt, trainee->ParsePrompt(prompt));
+        }
+        SDK::NeuralNetwork::TrainingOptions options;
+        options.epochs = epochs;
+        options.shuffle = false;
+        return [trainee, samples, options]() { trainee->Train(*samples, options); };
+    });
+}
+
+// Widgets in a row: each left of the next with a gap, all preferring their
+// initial place, the first one dragged
+struct SimplexChain {
+    SDK::SimplexSolver solver;
+    std::vector<SDK::SimplexSolver::Variable> lefts;
+
+    explicit SimplexChain(int count) {
+        for (int i = 0; i < count; i++) {
+            lefts.push_back(solver.AddVariable());
+            SDK::SimplexSolver::Expression place(-15.0 * i);
+            solver.AddConstraint(place.Add(lefts[i]), SDK::SimplexSolver::Relation::EQUAL, SDK::SimplexSolver::WEAK);
+            if (i > 0) {
+                SDK::SimplexSolver::Expression gap(-10.0);
+                gap.Add(lefts[i]).Add(lefts[i - 1], -1.0);
+                solver.AddConstraint(gap, SDK::SimplexSolver::Relation::GREATER_THAN_OR_EQUAL);
+            }
+        }
+        solver.AddEditVariable(lefts[0], SDK::SimplexSolver::STRONG);
+    }
+};
+
+void SimplexBenchmarks(Bench& bench) {
+    for (int count : { 100, 1000 }) {
+        std::string suffix = "/" + std::to_string(count);
+        bench.Run("simplex/build" + suffix, count, [count]() {
+            return [count]() {
+                SimplexChain chain(count);
+                chain.solver.UpdateVariables();
+                g_sink += (uint64_t)chain.solver.GetValue(chain.lefts.back());
+            };
+        });
+        bench.Run("simplex/suggest" + suffix, count, [count]() {
+            auto chain = std::make_shared<SimplexChain>(count);
+            auto offset = std::make_shared<int>(0);
+            return [chain, offset]() {
+                *offset = (*offset + 7) % 200;
+                chain->solver.SuggestValue(chain->lefts[0], *offset);
+                chain->solver.UpdateVariables();
+                g_sink += (uint64_t)chain->solver.GetValue(chain->lefts.back());
+            };
+        });
+    }
+}
+
+// Short UI strings: labels, with every fourth one carrying accented text
+std::vector<std::wstring> MakeLabels(int count, bool accented) {
+    std::vector<std::wstring> labels;
+    for (int i = 0; i < count; i++) {
+        std::wstring label = L"Label number " + std::to_wstring(i) + L" of the toolbar";
+        if (accented && i % 4 == 0) label += L" \u00e9t\u00e9 \u65e5\u672c";
+        labels.push_back(label);
+    }
+    return labels;
+}
+
+void StringBenchmarks(Bench& bench) {
+    const int count = 1000;
+    for (bool accented : { false, true }) {
+        std::string suffix = accented ? "/mixed" : "/ascii";
+        bench.Run("strings/to_utf8" + suffix, count, [accented]() {
+            auto labels = std::make_shared<std::vector<std::wstring>>(MakeLabels(count, accented));
+            return [labels]() {
+                for (const auto& label : *labels) {
+                    g_sink += SDK::WStringToUTF8(label).size();
+                }
+            };
+        });
+        bench.Run("strings/to_utf8_scratch" + suffix, count, [accented]() {
+            // A frame's draw calls, then the frame's reset
+            auto labels = std::make_shared<std::vector<std::wstring>>(MakeLabels(count, accented));
+            return [labels]() {
+                for (const auto& label : *labels) {
+                    g_sink += SDK::UTF8Scratch::Convert(label).size();
+                }
+                SDK::UTF8Scratch::Reset();
+            };
+        });
+        bench.Run("strings/from_utf8" + suffix, count, [accented]() {
+            auto labels = std::make_shared<std::vector<std::string>>();
+            for (const auto& label : MakeLabels(count, accented)) {
+                labels->push_back(SDK::WStringToUTF8(label));
+            }
+            return [labels]() {
+                for (const auto& label : *labels) {
+                    g_sink += SDK::UTF8ToWString(label.data(), label.size()).size();
+                }
+            };
+        });
+    }
+
+    // A frame of labels laid out from the glyph atlas; the rasterizer only
+    // runs while the first frame warms the caches
+    bench.Run("strings/glyph_runs", count, []() {
+        auto labels = std::make_shared<std::vector<std::wstring>>(MakeLabels(count, false));
+        auto atlas = std::make_shared<SDK::GlyphAtlas>(1024, 512,
+            [](uint32_t, uint32_t codepoint, SDK::GlyphAtlas::Bitmap& bitmap) {
+                bitmap.width = 7;
+                bitmap.height = 12;
+                bitmap.top = 10;
+                bitmap.advance = 8;
+                bitmap.coverage.assign(7 * 12, (uint8_t)codepoint);
+                return true;
+            });
+        atlas->SetRunCapacity(count);
+        return [labels, atlas]() {
+            for (const auto& label : *labels) {
+                g_sink += atlas->GetRun(0, label).width;
+            }
+        };
+    });
+}
+
+// A press, a drag along a spiral with a move every 4 ms, a release and some
+// keys; window 0 throughout
+SDK::InputTrace MakeDragTrace(int moves) {
+    SDK::InputTrace trace;
+    auto add = [&trace](uint32_t time, SDK::InputEvent::Type type, int x, int y, int value) {
+        trace.Add({ time, type, 0, x, y, value });
+    };
+    uint32_t time = 0;
+    add(time, SDK::InputEvent::Type::MOUSE_DOWN, 256, 256, 1);
+    int x = 256;
+    int y = 256;
+    for (int i = 0; i < moves; i++) {
+        float angle = i * 0.05f;
+        float radius = 20.0f + i * 0.2f;
+        x = 256 + (int)(std::cos(angle) * radius);
+        y = 256 + (int)(std::sin(angle) * radius);
+        add(time += 4, SDK::InputEvent::Type::MOUSE_MOVE, x, y, 0);
+    }
+    add(time += 4, SDK::InputEvent::Type::MOUSE_UP, x, y, 1);
+    for (int key = 'A'; key <= 'J'; key++) {
+        add(time += 30, SDK::InputEvent::Type::KEY_DOWN, 0, 0, key);
+        add(time += 30, SDK::InputEvent::Type::KEY_UP, 0, 0, key);
+    }
+    return trace;
+}
+
+// Headless stand-in for a window: dragging sprays particles along the
+// pointer path; every frame updates them and splats them into a frame buffer
+struct ReplayScene {
+    static constexpr int SIZE = 512;
+
+    SDK::PointerHistory history;
+    SDK::ParticleSystem particles;
+    std::vector<uint32_t> image;
+    bool dragging;
+
+    ReplayScene() : image((size_t)SIZE * SIZE), dragging(false) {}
+
+    SDK::InputTrace::ReplayStats Replay(const SDK::InputTrace& trace) {
+        auto dispatch = [this](const SDK::InputEvent& event) {
+            switch (event.type) {
+                case SDK::InputEvent::Type::MOUSE_MOVE:
+                    history.Add({ event.x, event.y, event.time });
+                    if (dragging) particles.EmitBurst((float)event.x, (float)event.y, 8, SDK::Color(255, 160, 40));
+                    break;
+                case SDK::InputEvent::Type::MOUSE_DOWN:
+                    dragging = true;
+                    break;
+                case SDK::InputEvent::Type::MOUSE_UP:
+                    dragging = false;
+                    break;
+                default:
+                    g_sink += (uint64_t)event.value;
+                    break;
+            }
+        };
+        auto frame = [this](double, float deltaTime) {
+            particles.Update(deltaTime);
+            std::fill(image.begin(), image.end(), 0xFF000000u);
+            SDK::PixelKernels::SplatParticles(image.data(), SIZE, SIZE, SIZE, particles.GetX(), particles.GetY(),
+                                              particles.GetColors(), particles.GetCount(), 0, 0, 2);
+        };
+        return trace.Replay(dispatch, frame, 60.0);
+    }
+};
+
+void InputBenchmarks(Bench& bench, const std::string& tracePath) {
+    const int events = 10000;
+    bench.Run("input/encode/" + std::to_string(events), events, []() {
+        auto trace = std::make_shared<SDK::InputTrace>(MakeDragTrace(events));
+        auto bytes = std::make_shared<std::vector<uint8_t>>();
+        return [trace, bytes]() {
+            bytes->clear();
+            trace->Encode(*bytes);
+            g_sink += bytes->size();
+        };
+    });
+    bench.Run("input/decode/" + std::to_string(events), events, []() {
+        auto trace = std::make_shared<SDK::InputTrace>();
+        auto bytes = std::make_shared<std::vector<uint8_t>>();
+        MakeDragTrace(events).Encode(*bytes);
+        return [trace, bytes]() {
+            trace->Decode(bytes->data(), bytes->size());
+            g_sink += trace->GetEvents().size();
+        };
+    });
+
+    // About ten seconds of dragging at four moves a frame
+    bench.Replay("replay/drag", []() {
+        ReplayScene scene;
+        return scene.Replay(MakeDragTrace(2400));
+    });
+
+    if (!tracePath.empty()) {
+        SDK::InputTrace trace;
+        std::filesystem::path path(tracePath);
+        if (!trace.Load(path.wstring())) {
+            fprintf(stderr, "Can't read the input trace %s\n", tracePath.c_str());
+            return;
+        }
+        bench.Replay("replay/" + path.filename().string(), [&trace]() {
+            ReplayScene scene;
+            return scene.Replay(trace);
+        });
+    }
+}
+
+// A card like a thumbnail: gradient header, shadowed panel, labels, a button
+void DrawSnapshot(SDK::HeadlessRenderBackend& backend, size_t index) {
+    using SDK::Color;
+    int width = backend.GetWidth();
+    int height = backend.GetHeight();
+    backend.Clear(Color(245, 246, 250));
+    backend.DrawLinearGradient(RECT{ 0, 0, width, 40 }, Color(40, 90, 200), Color(120, 60, 200), true);
+    RECT panel = { 16, 56, width - 16, height - 16 };
+    backend.DrawShadow(panel, 0, 4, 10, Color(0, 0, 0, 80));
+    backend.DrawRoundedRectangle(panel, 8.0f, Color(255, 255, 255), Color(210, 214, 222), 1.0f);
+    backend.DrawTextLine(L"Snapshot " + std::to_wstring(index), RECT{ 12, 0, width, 40 }, Color(255, 255, 255),
+                         L"", 16.0f, FW_BOLD, SDK::RenderBackend::TextAlign::LEFT);
+    for (int line = 0; line < 4; line++) {
+        int top = panel.top + 12 + line * 22;
+        backend.DrawTextLine(L"Row " + std::to_wstring(line) + L": the quick brown fox", RECT{ panel.left + 12, top, panel.right, top + 20 },
+                             Color(40, 40, 48), L"", 13.0f, FW_NORMAL, SDK::RenderBackend::TextAlign::LEFT);
+    }
+    RECT button = { panel.right - 96, panel.bottom - 40, panel.right - 12, panel.bottom - 12 };
+    backend.DrawGlow(button, 6, Color(60, 120, 255, 120));
+    backend.DrawRoundedRectangle(button, 6.0f, Color(60, 120, 255), Color(0, 0, 0, 0), 0.0f);
+    backend.DrawEllipse(panel.right - 40, panel.top + 30, 16, 16, Color(250, 180, 40), Color(0, 0, 0, 0), 0.0f);
+}
+
+void SnapshotBenchmarks(Bench& bench) {
+    const int size = 256;
+    const int count = bench.IsQuick() ? 32 : 128;
+    double pixels = (double)size * size;
+
+    bench.Run("snapshot/render/" + std::to_string(size), 1, [size]() {
+        auto backend = std::make_shared<SDK::HeadlessRenderBackend>(size, size);
+        return [backend]() {
+            DrawSnapshot(*backend, 0);
+            g_sink += backend->GetPixels()[0];
+        };
+    });
+    bench.Run("snapshot/png_encode/" + std::to_string(size), pixels, [size]() {
+        auto backend = std::make_shared<SDK::HeadlessRenderBackend>(size, size);
+        DrawSnapshot(*backend, 0);
+        auto png = std::make_shared<std::vector<uint8_t>>();
+        return [backend, png]() {
+            png->clear();
+            backend->EncodePNG(*png);
+            g_sink += png->size();
+        };
+    });
+
+    // Render and encode a batch, serially and on every core; items are snapshots
+    bench.Run("snapshot/batch_serial/" + std::to_string(count), count, [size, count]() {
+        return [size, count]() {
+            SDK::HeadlessRenderBackend backend(size, size);
+            std::vector<uint8_t> png;
+            for (int i = 0; i < count; i++) {
+                backend.Resize(size, size);
+                DrawSnapshot(backend, i);
+                png.clear();
+                backend.EncodePNG(png);
+                g_sink += png.size();
+            }
+        };
+    });
+    bench.Run("snapshot/batch_parallel/" + std::to_string(count), count, [size, count]() {
+        return [size, count]() {
+            std::atomic<size_t> bytes(0);
+            SDK::HeadlessRenderBackend::RenderParallel(count, size, size,
+                [&bytes](size_t index, SDK::HeadlessRenderBackend& backend) {
+                    DrawSnapshot(backend, index);
+                    std::vector<uint8_t> png;
+                    backend.EncodePNG(png);
+                    bytes += png.size();
+                });
+            g_sink += bytes;
+        };
+    });
+}
+
+#if SDK_PLATFORM_WINDOWS
+// ---------------------------------------------------------------------------
+// Windows benchmarks: GDI on a memory DC
+
+struct Surface {
+    HDC dc;
+    HBITMAP bitmap;
+    HGDIOBJ previous;
+    uint32_t* pixels;
+
+    explicit Surface(int size) : dc(CreateCompatibleDC(nullptr)), bitmap(nullptr), previous(nullptr), pixels(nullptr) {
+        BITMAPINFO bmi = {};
+        bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+        bmi.bmiHeader.biWidth = size;
+        bmi.bmiHeader.biHeight = -size;
+        bmi.bmiHeader.biPlanes = 1;
+        bmi.bmiHeader.biBitCount = 32;
+        bmi.bmiHeader.biCompression = BI_RGB;
+        void* bits = nullptr;
+        bitmap = CreateDIBSection(dc, &bmi, DIB_RGB_COLORS, &bits, nullptr, 0);
+        pixels = static_cast<uint32_t*>(bits);
+        previous = SelectObject(dc, bitmap);
+        std::vector<uint32_t> noise = NoiseImage(size);
+        if (pixels) memcpy(pixels, noise.data(), noise.size() * sizeof(uint32_t));
+    }
+    ~Surface() {
+        SelectObject(dc, previous);
+        DeleteObject(bitmap);
+        DeleteDC(dc);
+    }
+};
+
+void RendererBenchmarks(Bench& bench) {
+    for (int size : { 256, 512, 1024 }) {
+        std::string suffix = "/" + std::to_string(size);
+        double pixels = (double)size * size;
+        RECT rect = { 0, 0, size, size };
+
+        bench.Run("renderer/gradient" + suffix, pixels, [size, rect]() {
+            auto surface = std::make_shared<Surface>(size);
+            return [surface, rect]() {
+                SDK::Renderer::SetGradientCacheEnabled(false);
+                SDK::Renderer::DrawVerticalGradient(surface->dc, rect, SDK::Color(20, 40, 80), SDK::Color(200, 220, 255));
+                SDK::Renderer::SetGradientCacheEnabled(true);
+            };
+        });
+        bench.Run("renderer/gradient_cached" + suffix, pixels, [size, rect]() {
+            auto surface = std::make_shared<Surface>(size);
+            return [surface, rect]() {
+                SDK::Renderer::DrawVerticalGradient(surface->dc, rect, SDK::Color(20, 40, 80), SDK::Color(200, 220, 255));
+            };
+        });
+        bench.Run("renderer/radial_gradient" + suffix, pixels, [size, rect]() {
+            auto surface = std::make_shared<Surface>(size);
+            return [surface, rect, size]() {
+                SDK::Renderer::SetGradientCacheEnabled(false);
+                SDK::Renderer::DrawRadialGradient(surface->dc, rect, SDK::Color(255, 255, 255), SDK::Color(0, 0, 0),
+                                                  size / 2, size / 2);
+                SDK::Renderer::SetGradientCacheEnabled(true);
+            };
+        });
+        bench.Run("renderer/blur" + suffix, pixels, [size, rect]() {
+            auto surface = std::make_shared<Surface>(size);
+            return [surface, rect]() { SDK::Renderer::ApplyBlur(surface->dc, rect, 8); };
+        });
+        bench.Run("renderer/bloom" + suffix, pixels, [size, rect]() {
+            auto surface = std::make_shared<Surface>(size);
+            return [surface, rect]() { SDK::Renderer::ApplyBloom(surface->dc, rect, 0.7f, 1.5f); };
+        });
+    }
+}
+#endif
+
+// ---------------------------------------------------------------------------
+// Widget benchmarks: widgets without a window
+
+// Grid over provider rows: a random integer column and a text column
+std::shared_ptr<SDK::DataGrid> MakeGrid(int rows) {
+    auto ids = std::make_shared<std::vector<std::wstring>>();
+    auto names = std::make_shared<std::vector<std::wstring>>();
+    ids->reserve(rows);
+    names->reserve(rows);
+    std::mt19937 random(4);
+    for (int i = 0; i < rows; i++) {
+        ids->push_back(std::to_wstring(random() % 1000000));
+        names->push_back(L"item " + std::to_wstring(random() % 100000));
+    }
+
+    auto grid = std::make_shared<SDK::DataGrid>();
+    grid->AddColumn(SDK::DataGrid::Column(L"Id", 80, SDK::DataGrid::ColumnType::INTEGER));
+    grid->AddColumn(SDK::DataGrid::Column(L"Name", 160));
+    grid->SetDataProvider(
+        [rows]() { return rows; },
+        [ids, names](int row, int column) { return column == 0 ? (*ids)[row] : (*names)[row]; });
+    return grid;
+}
+
+void DataGridBenchmarks(Bench& bench) {
+    for (int rows : { 10000, 100000, 1000000 }) {
+        if (rows > 100000 && bench.IsQuick()) continue;
+        std::string suffix = "/" + std::to_string(rows);
+
+        bench.Run("datagrid/sort_integer" + suffix, rows, [rows]() {
+            auto grid = MakeGrid(rows);
+            auto ascending = std::make_shared<bool>(false);
+            return [grid, ascending]() {
+                *ascending = !*ascending;
+                grid->SortByColumn(0, *ascending ? SDK::DataGrid::SortOrder::ASCENDING
+                                                 : SDK::DataGrid::SortOrder::DESCENDING);
+            };
+        });
+        bench.Run("datagrid/sort_string" + suffix, rows, [rows]() {
+            auto grid = MakeGrid(rows);
+            auto ascending = std::make_shared<bool>(false);
+            return [grid, ascending]() {
+                *ascending = !*ascending;
+                grid->SortByColumn(1, *ascending ? SDK::DataGrid::SortOrder::ASCENDING
+                                                 : SDK::DataGrid::SortOrder::DESCENDING);
+            };
+        });
+        bench.Run("datagrid/filter" + suffix, rows, [rows]() {
+            // Alternating filters that don't narrow each other, so every call filters all rows
+            auto grid = MakeGrid(rows);
+            auto flip = std::make_shared<bool>(false);
+            return [grid, flip]() {
+                *flip = !*flip;
+                grid->SetFilter(*flip ? L"17" : L"29");
+                g_sink += grid->GetDisplayRowCount();
+            };
+        });
+    }
+}
+
+std::vector<std::shared_ptr<SDK::Widget>> MakeWidgets(int count, int area, uint32_t seed) {
+    std::vector<std::shared_ptr<SDK::Widget>> widgets;
+    std::mt19937 random(seed);
+    for (int i = 0; i < count; i++) {
+        auto button = std::make_shared<SDK::Button>(L"Button");
+        button->SetBounds(random() % area, random() % area, 40 + random() % 80, 20 + random() % 20);
+        widgets.push_back(button);
+    }
+    return widgets;
+}
+
+void LayoutBenchmarks(Bench& bench) {
+    for (int count : { 100, 1000 }) {
+        bench.Run("layout/grid/" + std::to_string(count), count, [count]() {
+            auto widgets = std::make_shared<std::vector<std::shared_ptr<SDK::Widget>>>(MakeWidgets(count, 1000, 5));
+            auto layout = std::make_shared<SDK::GridLayout>(10);
+            auto width = std::make_shared<int>(1000);
+            return [widgets, layout, width]() {
+                // A different width each time, so the layout can't reuse its arrangement
+                *width = *width == 1000 ? 1001 : 1000;
+                RECT bounds = { 0, 0, *width, 1000 };
+                layout->Apply(bounds, *widgets);
+            };
+        });
+    }
+
+    // Resizing back and forth between two sizes; the engine's result cache copies the known arrangements
+    for (bool cached : { true, false }) {
+        bench.Run(std::string("layout/engine_resize_") + (cached ? "cached" : "uncached") + "/1000", 1000, [cached]() {
+            auto widgets = std::make_shared<std::vector<std::shared_ptr<SDK::Widget>>>(MakeWidgets(1000, 1000, 5));
+            auto engine = std::make_shared<SDK::LayoutEngine>();
+            engine->SetBaseLayout(std::make_shared<SDK::GridLayout>(10));
+            engine->SetLayoutCacheCapacity(cached ? 16 : 0);
+            auto width = std::make_shared<int>(1000);
+            return [widgets, engine, width]() {
+                *width = *width == 1000 ? 1001 : 1000;
+                RECT bounds = { 0, 0, *width, 1000 };
+                engine->Apply(bounds, *widgets);
+            };
+        });
+    }
+
+    for (int count : { 50, 200 }) {
+        for (auto mode : { SDK::LayoutConstraintSolver::Mode::SIMPLEX, SDK::LayoutConstraintSolver::Mode::RELAXATION }) {
+            std::string name = std::string("layout/constraints_") +
+                               (mode == SDK::LayoutConstraintSolver::Mode::SIMPLEX ? "simplex/" : "relaxation/") +
+                               std::to_string(count);
+            bench.Run(name, count, [count, mode]() {
+                using SDK::LayoutConstraint;
+                auto widgets = std::make_shared<std::vector<std::shared_ptr<SDK::Widget>>>(MakeWidgets(count, 1000, 6));
+                auto engine = std::make_shared<SDK::LayoutEngine>();
+                engine->SetSolverMode(mode);
+                const auto& w = *widgets;
+                engine->AddConstraint(LayoutConstraint(w[0], LayoutConstraint::Attribute::LEFT,
+                                                       LayoutConstraint::Type::EQUAL, LayoutConstraint::Attribute::LEFT, 10));
+                for (int i = 0; i < count; i++) {
+                    engine->AddConstraint(LayoutConstraint(w[i], LayoutConstraint::Attribute::TOP,
+                                                           LayoutConstraint::Type::EQUAL, LayoutConstraint::Attribute::TOP, 10));
+                    if (i == 0) continue;
+                    engine->AddConstraint(LayoutConstraint(w[i], LayoutConstraint::Attribute::LEFT,
+                                                           LayoutConstraint::Type::EQUAL,
+                                                           w[i - 1], LayoutConstraint::Attribute::RIGHT, 5));
+                }
+                LayoutConstraint last(w[count - 1], LayoutConstraint::Attribute::RIGHT,
+                                      LayoutConstraint::Type::LESS_THAN_OR_EQUAL, LayoutConstraint::Attribute::RIGHT, -10);
+                last.SetPriority(500);
+                engine->AddConstraint(last);
+
+                auto width = std::make_shared<int>(20000);
+                return [widgets, engine, width]() {
+                    // Container relative constraints re-solve when the width changes
+                    *width = *width == 20000 ? 20001 : 20000;
+                    RECT bounds = { 0, 0, *width, 1000 };
+                    engine->Apply(bounds, *widgets);
+                };
+            });
+        }
+    }
+}
+
+void HitTestBenchmarks(Bench& bench) {
+    const int queries = 1000;
+    for (int count : { 10000, 100000, 1000000 }) {
+        if (count > 100000 && bench.IsQuick()) continue;
+        bench.Run("hittest/spatial_index/" + std::to_string(count), queries, [count, queries]() {
+            // The area grows with the count, so each size has the same widget density
+            int area = (int)(40 * std::sqrt((double)count));
+            auto index = std::make_shared<SDK::WidgetSpatialIndex>();
+            for (const auto& widget : MakeWidgets(count, area, 7)) {
+                index->Insert(widget);
+            }
+            auto points = std::make_shared<std::vector<POINT>>();
+            std::mt19937 random(8);
+            for (int i = 0; i < queries; i++) {
+                points->push_back({ (LONG)(random() % area), (LONG)(random() % area) });
+            }
+            return [index, points]() {
+                for (const POINT& pt : *points) {
+                    g_sink += index->HitTest(pt.x, pt.y) ? 1 : 0;
+                }
+            };
+        });
+    }
+}
+
+#if SDK_PLATFORM_WINDOWS
+// Markdown of about the given size: headings, paragraphs with inline styles and links
+std::wstring MakeMarkdown(size_t bytes) {
+    std::wstring markdown;
+    std::mt19937 random(9);
+    for (int section = 0; markdown.size() * sizeof(wchar_t) < bytes; section++) {
+        markdown += L"## Section " + std::to_wstring(section) + L"\n\n";
+        for (int line = 0; line < 8; line++) {
+            markdown += L"Some **bold** text, some *italic* text and a [link](https://example.com/" +
+                        std::to_wstring(random() % 1000) + L") in line " + std::to_wstring(line) + L".\n";
+        }
+        markdown += L"\n";
+    }
+    return markdown;
+}
+
+void RichTextBenchmarks(Bench& bench) {
+    for (size_t megabytes : { 1, 8 }) {
+        if (megabytes > 1 && bench.IsQuick()) continue;
+        std::string suffix = "/" + std::to_string(megabytes) + "mb";
+        double bytes = megabytes * 1024.0 * 1024.0;
+
+        bench.Run("richtext/parse_markdown" + suffix, bytes, [megabytes]() {
+            auto markdown = std::make_shared<std::wstring>(MakeMarkdown(megabytes * 1024 * 1024));
+            auto document = std::make_shared<SDK::RichTextDocument>();
+            return [markdown, document]() {
+                document->ParseMarkdown(*markdown);
+                g_sink += document->GetSpans().size();
+            };
+        });
+        bench.Run("richtext/update_markdown" + suffix, 1, [megabytes]() {
+            // One keystroke in the middle of the document, typed and deleted
+            auto markdown = std::make_shared<std::wstring>(MakeMarkdown(megabytes * 1024 * 1024));
+            auto edited = std::make_shared<std::wstring>(*markdown);
+            edited->insert(edited->find(L'\n', edited->size() / 2), L"x");
+            auto document = std::make_shared<SDK::RichTextDocument>();
+            document->ParseMarkdown(*markdown);
+            auto flip = std::make_shared<bool>(false);
+            return [markdown, edited, document, flip]() {
+                *flip = !*flip;
+                document->UpdateMarkdown(*flip ? *edited : *markdown);
+                g_sink += document->GetSpans().size();
+            };
+        });
+        bench.Run("richtext/to_html" + suffix, bytes, [megabytes]() {
+            auto document = std::make_shared<SDK::RichTextDocument>();
+            document->ParseMarkdown(MakeMarkdown(megabytes * 1024 * 1024));
+            return [document]() {
+                g_sink += document->ToHtml().size();
+            };
+        });
+    }
+}
+#endif
+
+bool ParseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--filter" && hasValue) {
+            options.filter = argv[++i];
+        } else if (arg == "--out" && hasValue) {
+            options.out = argv[++i];
+        } else if (arg == "--min-time" && hasValue) {
+            options.minTimeMs = atof(argv[++i]);
+        } else if (arg == "--trace" && hasValue) {
+            options.trace = argv[++i];
+        } else if (arg == "--quick") {
+            options.quick = true;
+        } else {
+            fprintf(stderr, "Usage: %s [--filter text] [--out results.json] [--min-time ms] [--quick] [--trace file]\n", argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        return 2;
+    }
+
+    if (!CheckPixelKernels()) {
+        return 1;
+    }
+
+    Bench bench(options);
+    PixelBenchmarks(bench);
+    ParticleBenchmarks(bench);
+    AnimationBenchmarks(bench);
+    NeuralBenchmarks(bench);
+    SimplexBenchmarks(bench);
+    StringBenchmarks(bench);
+    InputBenchmarks(bench, options.trace);
+    SnapshotBenchmarks(bench);
+#if SDK_PLATFORM_WINDOWS
+    RendererBenchmarks(bench);
+#endif
+    DataGridBenchmarks(bench);
+    LayoutBenchmarks(bench);
+    HitTestBenchmarks(bench);
+#if SDK_PLATFORM_WINDOWS
+    RichTextBenchmarks(bench);
+#endif
+
+    FILE* file = options.out.empty() ? stdout : fopen(options.out.c_str(), "w");
+    if (!file) {
+        fprintf(stderr, "Can't write %s\n", options.out.c_str());
+        return 1;
+    }
+    bench.WriteJson(file);
+    if (file != stdout) {
+        fclose(file);
+    }
+
+    SDK::JobScheduler::Shutdown();
+    return 0;
+}
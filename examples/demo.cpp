@@ -120,7 +120,7 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
 // Custom rendering callback for main window
 void RenderMainWindow(HDC hdc) {
     RECT rect;
-    GetClientRect(WindowFromDC(hdc), &rect);
+    GetClientRect(g_mainWindow, &rect);
     
     // Draw buttons
     const int buttonY = 80;
@@ -262,6 +262,13 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
             SDK::DPIManager::GetInstance().HandleDPIChange(hwnd, wParam, lParam);
             return 0;
             
+        case WM_DISPLAYCHANGE:
+            // Monitors were added, removed or rearranged
+            SDK::MonitorManager::GetInstance().HandleDisplayChange();
+            UpdateMonitorInfo(hwnd);
+            InvalidateRect(hwnd, nullptr, TRUE);
+            return 0;
+            
         case WM_PAINT: {
             PAINTSTRUCT ps;
             HDC hdc = BeginPaint(hwnd, &ps);
@@ -2,6 +2,8 @@
 #include "SDK/Window.h"
 #include "SDK/Widget.h"
 #include "SDK/Layout.h"
+#include <chrono>
+#include <cstdio>
 #include <memory>
 #include <vector>
 
@@ -38,6 +40,8 @@ std::shared_ptr<Window> g_demoWindow;
 std::vector<std::shared_ptr<Widget>> g_widgets;
 std::shared_ptr<LayoutEngine> g_layoutEngine;
 int g_layoutMode = 0; // 0: Auto, 1: Grid, 2: Flow, 3: Stack, 4: Constraints
+LayoutConstraintSolver::Mode g_solverMode = LayoutConstraintSolver::Mode::RELAXATION;
+std::wstring g_benchmarkResult;
 
 void CreateDemoWidgets() {
     g_widgets.clear();
@@ -56,6 +60,7 @@ void ApplyLayout() {
     GetClientRect(g_demoWindow->GetHandle(), &clientRect);
     
     g_layoutEngine->ClearConstraints();
+    g_layoutEngine->SetSolverMode(g_solverMode);
     
     switch (g_layoutMode) {
         case 0: // Auto layout
@@ -144,6 +149,58 @@ void ApplyLayout() {
     g_layoutEngine->Apply(clientRect, g_widgets);
 }
 
+// Times both solver modes on a vertical chain of widgets pinned to the
+// container's sides: the first solve, then 100 resizes
+void RunSolverBenchmark() {
+    const int widgetCount = 200;
+    const int resizeCount = 100;
+    
+    wchar_t result[256];
+    std::wstring text;
+    for (int mode = 0; mode < 2; mode++) {
+        std::vector<std::shared_ptr<Widget>> chain;
+        for (int i = 0; i < widgetCount; i++) {
+            auto widget = std::make_shared<DemoButton>(L"");
+            widget->SetBounds(0, 0, 100, 20);
+            chain.push_back(widget);
+        }
+        
+        LayoutConstraintSolver solver;
+        solver.SetMode(mode == 0 ? LayoutConstraintSolver::Mode::RELAXATION : LayoutConstraintSolver::Mode::SIMPLEX);
+        solver.AddConstraint(LayoutConstraint(chain[0], LayoutConstraint::Attribute::TOP,
+            LayoutConstraint::Type::EQUAL, LayoutConstraint::Attribute::TOP, 10));
+        for (int i = 0; i < widgetCount; i++) {
+            solver.AddConstraint(LayoutConstraint(chain[i], LayoutConstraint::Attribute::LEFT,
+                LayoutConstraint::Type::EQUAL, LayoutConstraint::Attribute::LEFT, 10));
+            solver.AddConstraint(LayoutConstraint(chain[i], LayoutConstraint::Attribute::RIGHT,
+                LayoutConstraint::Type::EQUAL, LayoutConstraint::Attribute::RIGHT, -10));
+            if (i > 0) {
+                solver.AddConstraint(LayoutConstraint(chain[i], LayoutConstraint::Attribute::TOP,
+                    LayoutConstraint::Type::EQUAL, chain[i - 1], LayoutConstraint::Attribute::BOTTOM, 4));
+            }
+        }
+        
+        RECT bounds = { 0, 0, 800, 600 };
+        auto start = std::chrono::steady_clock::now();
+        solver.Solve(bounds, chain);
+        auto solved = std::chrono::steady_clock::now();
+        for (int i = 0; i < resizeCount; i++) {
+            bounds.right = 600 + i * 4;
+            solver.Solve(bounds, chain);
+        }
+        auto resized = std::chrono::steady_clock::now();
+        
+        double firstMs = std::chrono::duration<double, std::milli>(solved - start).count();
+        double resizeMs = std::chrono::duration<double, std::milli>(resized - solved).count() / resizeCount;
+        swprintf(result, 256, L"%ls: first %.2f ms, resize %.3f ms%ls",
+                 mode == 0 ? L"Relaxation" : L"Simplex", firstMs, resizeMs,
+                 solver.DidConverge() ? L"" : L" (not converged)");
+        if (!text.empty()) text += L"   |   ";
+        text += result;
+    }
+    g_benchmarkResult = std::to_wstring(widgetCount) + L" widgets - " + text;
+}
+
 void RenderDemo(HDC hdc) {
     // Clear background
     RECT clientRect;
@@ -179,7 +236,14 @@ void RenderDemo(HDC hdc) {
                         DEFAULT_CHARSET, OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS,
                         CLEARTYPE_QUALITY, DEFAULT_PITCH, L"Segoe UI");
     hOldFont = (HFONT)SelectObject(hdc, hFont);
-    DrawTextW(hdc, L"Press SPACE to cycle through layout modes", -1, &instrRect, DT_LEFT | DT_VCENTER | DT_SINGLELINE);
+    std::wstring instructions = L"Press SPACE to cycle through layout modes, S to switch solver (";
+    instructions += g_solverMode == LayoutConstraintSolver::Mode::SIMPLEX ? L"simplex" : L"relaxation";
+    instructions += L"), B to benchmark the solvers";
+    if (!g_benchmarkResult.empty()) {
+        instructions += L"\n" + g_benchmarkResult;
+        instrRect.bottom += 20;
+    }
+    DrawTextW(hdc, instructions.c_str(), -1, &instrRect, DT_LEFT | DT_TOP);
     SelectObject(hdc, hOldFont);
     DeleteObject(hFont);
     
@@ -206,6 +270,14 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
                 g_layoutMode = (g_layoutMode + 1) % 5;
                 ApplyLayout();
                 InvalidateRect(hwnd, NULL, TRUE);
+            } else if (wParam == 'S') {
+                g_solverMode = g_solverMode == LayoutConstraintSolver::Mode::SIMPLEX
+                    ? LayoutConstraintSolver::Mode::RELAXATION : LayoutConstraintSolver::Mode::SIMPLEX;
+                ApplyLayout();
+                InvalidateRect(hwnd, NULL, TRUE);
+            } else if (wParam == 'B') {
+                RunSolverBenchmark();
+                InvalidateRect(hwnd, NULL, TRUE);
             }
             return 0;
         
@@ -198,10 +198,10 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
                         
                         // Set up render callback for the generated window
                         auto widgetMgr = g_promptBuilder.GetLastWidgetManager();
-                        window->SetRenderCallback([widgetMgr](HDC hdc) {
+                        window->SetRenderCallback([widgetMgr, generatedWindow](HDC hdc) {
                             // Clear background
                             RECT clientRect;
-                            GetClientRect(WindowFromDC(hdc), &clientRect);
+                            GetClientRect(generatedWindow, &clientRect);
                             HBRUSH bgBrush = CreateSolidBrush(RGB(245, 245, 250));
                             FillRect(hdc, &clientRect, bgBrush);
                             DeleteObject(bgBrush);
@@ -86,7 +86,7 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
 // Custom rendering callback
 void RenderWidgetShowcase(HDC hdc) {
     RECT rect;
-    GetClientRect(WindowFromDC(hdc), &rect);
+    GetClientRect(g_mainWindow, &rect);
     
     // Draw title
     SetBkMode(hdc, TRANSPARENT);
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "Platform.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace SDK {
+
+class Menu;
+class MenuItem;
+class Toolbar;
+
+/**
+ * AcceleratorTable - Keyboard shortcuts of menus and toolbars, by key
+ * Shortcut strings such as L"Ctrl+Shift+S" are parsed once into a modifier
+ * set and a virtual key, and the table maps each to its command. A key press
+ * is then a single hash lookup instead of a walk over menu trees. The table
+ * is compiled on first use and again only after a source changes: menu items
+ * and toolbars carry revisions, compared on each dispatch. When two commands
+ * share a shortcut, the one registered first wins; commands added with Add()
+ * come before menus, and menus before toolbars.
+ */
+class AcceleratorTable {
+public:
+    enum Modifier : uint8_t {
+        NONE = 0,
+        CTRL = 1,
+        SHIFT = 2,
+        ALT = 4
+    };
+
+    struct Accelerator {
+        uint8_t modifiers;      // Modifier flags
+        uint16_t key;           // Virtual key code
+
+        bool operator==(const Accelerator& other) const {
+            return modifiers == other.modifiers && key == other.key;
+        }
+    };
+
+    AcceleratorTable();
+    ~AcceleratorTable();
+
+    // Modifier names (Ctrl, Control, Shift, Alt) and key names are case
+    // insensitive: letters, digits, F1-F24, named keys such as Del, PgUp
+    // or Space, and punctuation. False when the text isn't a shortcut.
+    static bool Parse(const std::wstring& text, Accelerator& accelerator);
+
+    // Sources are held weakly; a destroyed one drops out at the next rebuild
+    bool Add(const std::wstring& shortcut, std::function<void()> command);  // False when unparsable
+    void AddMenu(std::shared_ptr<Menu> menu);
+    void AddMenuItem(std::shared_ptr<MenuItem> item);   // An item and its submenus
+    void AddToolbar(std::shared_ptr<Toolbar> toolbar);
+    void Clear();
+    // Forces a rebuild, after items were edited in place
+    void Invalidate() { m_dirty = true; }
+
+    // Runs the command bound to the key with the modifiers held now; false
+    // when nothing is bound or its item is disabled
+    bool Dispatch(int keyCode);
+    bool Dispatch(int keyCode, uint8_t modifiers);
+    static uint8_t GetHeldModifiers();
+
+    // Null when nothing is bound
+    std::shared_ptr<MenuItem> FindMenuItem(const Accelerator& accelerator);
+    size_t GetCount();
+
+    struct Stats {
+        uint64_t lookups;
+        uint64_t dispatched;
+        uint64_t rebuilds;
+        uint64_t conflicts;     // Shortcuts shadowed by an earlier binding, at the last rebuild
+    };
+    const Stats& GetStats() const { return m_stats; }
+    void ResetStats();
+
+private:
+    struct Command {
+        std::weak_ptr<MenuItem> menuItem;
+        std::weak_ptr<Toolbar> toolbar;
+        int toolbarItemId;
+        int commandIndex;       // Into m_commands, or -1
+    };
+
+    struct ToolbarSource {
+        std::weak_ptr<Toolbar> toolbar;
+        uint64_t revision;
+    };
+
+    struct ExplicitCommand {
+        Accelerator accelerator;
+        std::function<void()> callback;
+    };
+
+    static uint32_t MakeKey(const Accelerator& accelerator) {
+        return ((uint32_t)accelerator.modifiers << 16) | accelerator.key;
+    }
+
+    bool IsStale() const;
+    void Rebuild();
+    void Bind(const Accelerator& accelerator, const Command& command);
+    void BindMenuItem(const std::shared_ptr<MenuItem>& item);
+
+    std::vector<ExplicitCommand> m_commands;
+    std::vector<std::weak_ptr<Menu>> m_menus;
+    std::vector<std::weak_ptr<MenuItem>> m_menuItems;
+    std::vector<ToolbarSource> m_toolbars;
+
+    std::unordered_map<uint32_t, Command> m_table;
+    uint64_t m_menuRevision;
+    bool m_dirty;
+
+    Stats m_stats;
+};
+
+} // namespace SDK
@@ -3,9 +3,15 @@
 
 #include "Platform.h"
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
+#include <functional>
+#include <algorithm>
+#include <unordered_set>
+#include <unordered_map>
 #include "Widget.h"
+#include "DirectoryLoader.h"
 
 namespace SDK {
 
@@ -19,19 +25,47 @@ public:
     void RemoveItem(int index);
     void ClearItems();
     
+    // Item provider
+    // The combo box asks for the item count and fetches text only for the rows
+    // it draws; owned items are ignored while a provider is set. Call
+    // RefreshItems after the provider's items change.
+    using ItemCountProvider = std::function<int()>;
+    using ItemTextProvider = std::function<std::wstring(int index)>;
+    
+    void SetItemProvider(ItemCountProvider itemCount, ItemTextProvider itemText);
+    void ClearItemProvider();
+    bool HasItemProvider() const { return static_cast<bool>(m_itemTextProvider); }
+    void RefreshItems();
+    
+    int GetItemCount() const;
+    std::wstring GetItemText(int index) const;
+    
     void SetSelectedIndex(int index);
     int GetSelectedIndex() const { return m_selectedIndex; }
     std::wstring GetSelectedItem() const;
     
+    // Rows shown before the drop-down scrolls
+    void SetMaxDropdownItems(int count) { m_maxDropdownItems = std::max(count, 1); }
+    int GetMaxDropdownItems() const { return m_maxDropdownItems; }
+    
     void Render(HDC hdc) override;
     bool HandleMouseDown(int x, int y, int button) override;
+    bool HandleKeyDown(int keyCode) override;
+    void GetHitBounds(RECT& rect) const override;
     
 private:
     RECT GetDropdownRect(const RECT& bounds) const;
+    void SetDropdownOpen(bool open);
+    void EnsureDropdownItemVisible(int index);
     
     std::vector<std::wstring> m_items;
+    ItemCountProvider m_itemCountProvider;
+    ItemTextProvider m_itemTextProvider;
+    int m_providerItemCount;
     int m_selectedIndex;
     bool m_dropdownOpen;
+    int m_maxDropdownItems;
+    int m_dropdownScrollOffset;     // First row shown in the drop-down
     Color m_backgroundColor;
     Color m_textColor;
 };
@@ -43,20 +77,55 @@ public:
     virtual ~ListBox();
     
     void AddItem(const std::wstring& item);
+    void AddItem(std::wstring&& item);
     void RemoveItem(int index);
     void ClearItems();
     
+    // Bulk loading; pass move iterators to move the strings in. SetItems
+    // replaces the items and clears the selection, like ClearItems.
+    void ReserveItems(int count) { if (count > 0) m_items.reserve(count); }
+    template<typename Iterator>
+    void AddItems(Iterator first, Iterator last) {
+        m_items.insert(m_items.end(), first, last);
+    }
+    void SetItems(std::vector<std::wstring>&& items);
+    
+    // Item provider
+    // The list box asks for the item count and fetches text only for the rows
+    // it draws; owned items are ignored while a provider is set. Call
+    // RefreshItems after the provider's items change.
+    using ItemCountProvider = std::function<int()>;
+    using ItemTextProvider = std::function<std::wstring(int index)>;
+    
+    void SetItemProvider(ItemCountProvider itemCount, ItemTextProvider itemText);
+    void ClearItemProvider();
+    bool HasItemProvider() const { return static_cast<bool>(m_itemTextProvider); }
+    void RefreshItems();
+    
+    int GetItemCount() const;
+    std::wstring GetItemText(int index) const;
+    
     void SetSelectedIndex(int index);
     int GetSelectedIndex() const { return m_selectedIndex; }
     
     void SetMultiSelect(bool multiSelect) { m_multiSelect = multiSelect; }
     std::vector<int> GetSelectedIndices() const { return m_selectedIndices; }
     
+    // Scrolling; only the rows in the viewport are drawn and hit-tested
+    void ScrollToItem(int index);           // Makes index the first visible row
+    void EnsureItemVisible(int index);
+    int GetFirstVisibleItem() const { return m_scrollOffset; }
+    int GetVisibleItemCount() const;
+    
     void Render(HDC hdc) override;
     bool HandleMouseDown(int x, int y, int button) override;
+    bool HandleKeyDown(int keyCode) override;
     
 private:
     std::vector<std::wstring> m_items;
+    ItemCountProvider m_itemCountProvider;
+    ItemTextProvider m_itemTextProvider;
+    int m_providerItemCount;
     int m_selectedIndex;
     bool m_multiSelect;
     std::vector<int> m_selectedIndices;
@@ -73,15 +142,42 @@ public:
         
         ListViewItem(const std::wstring& t = L"") 
             : text(t), checked(false), userData(nullptr) {}
+        ListViewItem(std::wstring&& t)
+            : text(std::move(t)), checked(false), userData(nullptr) {}
     };
     
     ListView();
     virtual ~ListView();
     
     void AddItem(const std::wstring& text, bool checked = false);
+    void AddItem(std::wstring&& text, bool checked = false);
     void RemoveItem(int index);
     void ClearItems();
     
+    // Bulk loading of ListViewItems or strings; pass move iterators to move
+    // them in. SetItems replaces the items, keeping their check states.
+    void ReserveItems(int count) { if (count > 0) m_items.reserve(count); }
+    template<typename Iterator>
+    void AddItems(Iterator first, Iterator last) {
+        m_items.insert(m_items.end(), first, last);
+    }
+    void SetItems(std::vector<ListViewItem>&& items);
+    
+    // Item provider
+    // The list view asks for the item count and fetches text only for the rows
+    // it draws; owned items are ignored while a provider is set and check
+    // states are kept by index. Call RefreshItems after the provider's items change.
+    using ItemCountProvider = std::function<int()>;
+    using ItemTextProvider = std::function<std::wstring(int index)>;
+    
+    void SetItemProvider(ItemCountProvider itemCount, ItemTextProvider itemText);
+    void ClearItemProvider();
+    bool HasItemProvider() const { return static_cast<bool>(m_itemTextProvider); }
+    void RefreshItems();
+    
+    int GetItemCount() const;
+    std::wstring GetItemText(int index) const;
+    
     void SetItemChecked(int index, bool checked);
     bool IsItemChecked(int index) const;
     
@@ -90,11 +186,23 @@ public:
     
     std::vector<int> GetCheckedItems() const;
     
+    // Scrolling; only the rows in the viewport are drawn and hit-tested
+    void ScrollToItem(int index);           // Makes index the first visible row
+    void EnsureItemVisible(int index);
+    int GetFirstVisibleItem() const { return m_scrollOffset; }
+    int GetVisibleItemCount() const;
+    
     void Render(HDC hdc) override;
     bool HandleMouseDown(int x, int y, int button) override;
+    bool HandleKeyDown(int keyCode) override;
     
 private:
     std::vector<ListViewItem> m_items;
+    ItemCountProvider m_itemCountProvider;
+    ItemTextProvider m_itemTextProvider;
+    int m_providerItemCount;
+    std::unordered_set<int> m_providerChecked;     // Checked indices of a provider
+    int m_changedIndex;     // VALUE_CHANGED data; outlives a coalesced delivery
     bool m_checkboxEnabled;
     int m_scrollOffset;
     int m_itemHeight;
@@ -138,16 +246,25 @@ public:
         HORIZONTAL
     };
     
+    enum class LoadState {
+        NOT_LOADED,
+        LOADING,        // Children arrive in batches ahead of a placeholder node
+        LOADED
+    };
+    
     struct TreeNode {
         std::wstring name;
         std::wstring fullPath;
         bool isDirectory;
         bool expanded;
+        bool isPlaceholder;     // "Loading..." row of a directory being listed
+        LoadState loadState;
         std::vector<std::shared_ptr<TreeNode>> children;
         int depth;
         
         TreeNode(const std::wstring& n, const std::wstring& path, bool isDir)
-            : name(n), fullPath(path), isDirectory(isDir), expanded(false), depth(0) {}
+            : name(n), fullPath(path), isDirectory(isDir), expanded(false), isPlaceholder(false)
+            , loadState(LoadState::NOT_LOADED), depth(0) {}
     };
     
     FileTree();
@@ -172,26 +289,56 @@ public:
     // Refresh tree while preserving expansion state
     void Refresh();
     
+    // Directories are listed on DirectoryLoader's workers; with watching on,
+    // directories that change on disk are reloaded without calling Refresh
+    void SetWatchChanges(bool watch);
+    bool GetWatchChanges() const { return m_watchChanges; }
+    bool IsLoading() const { return !m_loads.empty(); }
+    
+    void Update(float deltaTime) override;
     void Render(HDC hdc) override;
     bool HandleMouseDown(int x, int y, int button) override;
     
 private:
-    void LoadDirectory(std::shared_ptr<TreeNode> node);
-    void RenderNode(HDC hdc, std::shared_ptr<TreeNode> node, int& offset);
-    void RenderNodeVertical(HDC hdc, std::shared_ptr<TreeNode> node, int& yOffset);
-    void RenderNodeHorizontal(HDC hdc, std::shared_ptr<TreeNode> node, int& xOffset);
-    void RenderExpandIndicator(HDC hdc, std::shared_ptr<TreeNode> node, int x, int y);
+    // A listing in flight for one directory
+    struct PendingLoad {
+        std::weak_ptr<TreeNode> node;
+        DirectoryLoader::RequestPtr request;
+        bool expandAll;     // Expand and load child directories as they arrive
+        bool reload;        // Merge into the existing children once complete
+        std::vector<DirectoryLoader::Entry> entries;    // Reload results so far
+    };
+    
+    void LoadDirectory(std::shared_ptr<TreeNode> node, bool expandAll = false);
+    void ReloadDirectory(std::shared_ptr<TreeNode> node);
+    void ReloadLoadedRecursive(std::shared_ptr<TreeNode> node);
+    void MergeChildren(std::shared_ptr<TreeNode> node, std::vector<DirectoryLoader::Entry>& entries);
+    void CancelLoads(std::shared_ptr<TreeNode> node);   // node and its descendants; null for all
+    bool ProcessLoads();
+    void RenderNodeVertical(HDC hdc, const TreeNode& node, int y);
+    void RenderNodeHorizontal(HDC hdc, const TreeNode& node, int x);
+    void RenderExpandIndicator(HDC hdc, const TreeNode& node, int x, int y);
     std::shared_ptr<TreeNode> HitTestNode(int x, int y);
-    std::shared_ptr<TreeNode> HitTestNodeRecursive(std::shared_ptr<TreeNode> node, int x, int y, int& offset);
-    std::shared_ptr<TreeNode> FindNodeByPath(std::shared_ptr<TreeNode> node, const std::wstring& path);
+    std::shared_ptr<TreeNode> FindNodeByPath(const std::wstring& path);
+    
+    // Nodes shown, in display order: the root and the children of every
+    // expanded directory, flattened on first use after the tree changes
+    const std::vector<std::shared_ptr<TreeNode>>& GetVisibleNodes();
+    void AppendVisibleNodes(const std::shared_ptr<TreeNode>& node);
+    void IndexNode(const std::shared_ptr<TreeNode>& node);
+    void UnindexChildren(const TreeNode& node);     // node's descendants
     void ExpandAllRecursive(std::shared_ptr<TreeNode> node);
     void CollapseAllRecursive(std::shared_ptr<TreeNode> node);
-    void GetExpandedPaths(std::shared_ptr<TreeNode> node, std::vector<std::wstring>& paths);
-    void RestoreExpandedPaths(std::shared_ptr<TreeNode> node, const std::vector<std::wstring>& paths);
     
     std::wstring m_rootPath;
     std::shared_ptr<TreeNode> m_rootNode;
     std::shared_ptr<TreeNode> m_selectedNode;
+    std::vector<std::shared_ptr<TreeNode>> m_visibleNodes;
+    bool m_visibleNodesDirty;
+    std::unordered_map<std::wstring, std::weak_ptr<TreeNode>> m_nodesByPath;   // Every listed node
+    std::vector<PendingLoad> m_loads;
+    DirectoryWatcher m_watcher;
+    bool m_watchChanges;
     int m_scrollOffset;
     int m_itemHeight;
     Orientation m_orientation;
@@ -213,9 +360,18 @@ public:
     virtual ~SyntaxHighlightTextEditor();
     
     void SetText(const std::wstring& text);
-    std::wstring GetText() const { return m_text; }
+    std::wstring GetText() const { return m_buffer.GetText(); }
+    const TextBuffer& GetBuffer() const { return m_buffer; }
+    
+    int GetLineCount() const { return (int)m_buffer.GetLineCount(); }
+    std::wstring GetLine(int index) const { return m_buffer.GetLine(index); }
+    void SetLine(int index, const std::wstring& text);
     
-    void SetLanguage(Language language) { m_language = language; }
+    // Each edit keeps a snapshot of the buffer (O(1), shared structure)
+    bool Undo();
+    bool CanUndo() const { return !m_undoStack.empty(); }
+    
+    void SetLanguage(Language language);
     Language GetLanguage() const { return m_language; }
     
     void SetLineNumbers(bool show) { m_showLineNumbers = show; }
@@ -227,16 +383,46 @@ public:
     bool HandleChar(wchar_t ch) override;
     
 private:
+    // Lexer state carried across line ends
+    enum class LexState : uint8_t {
+        NORMAL,
+        BLOCK_COMMENT
+    };
+    
     struct SyntaxToken {
-        std::wstring text;
+        size_t start;       // Offset into the line
+        size_t length;
+        int x;              // Pixel offset from the line start
         Color color;
     };
     
-    std::vector<SyntaxToken> TokenizeLine(const std::wstring& line);
-    void UpdateSyntaxHighlighting();
+    // Cached tokens of one line, valid while its text and start state are unchanged
+    struct LineTokens {
+        std::vector<SyntaxToken> tokens;
+        LexState startState;
+        LexState endState;
+        bool valid;
+        
+        LineTokens() : startState(LexState::NORMAL), endState(LexState::NORMAL), valid(false) {}
+    };
     
-    std::wstring m_text;
-    std::vector<std::wstring> m_lines;
+    // Replaces tokens, keeping their capacity
+    void TokenizeLine(std::wstring_view line, LexState& state, std::vector<SyntaxToken>& tokens);
+    void UpdateSyntaxHighlighting();    // Drops the token cache
+    void EnsureTokens(HDC hdc, size_t endLine);
+    void InvalidateLine(size_t line);
+    void ReplaceText(size_t offset, size_t length, const std::wstring& text);   // All edits go through here
+    
+    struct UndoState {
+        TextBuffer buffer;
+        int cursorLine;
+        int cursorColumn;
+    };
+    
+    TextBuffer m_buffer;
+    std::vector<UndoState> m_undoStack;
+    std::vector<LineTokens> m_lineTokens;   // One per buffer line
+    size_t m_tokensCheckedThrough;          // Lines before this have current tokens
     Language m_language;
     bool m_showLineNumbers;
     bool m_wordWrap;
@@ -267,24 +453,33 @@ public:
     
     void SetFilter(const std::wstring& filter) { m_filter = filter; }
     
+    // Listing runs on DirectoryLoader's workers; with watching on, the current
+    // directory is reloaded in the background when it changes on disk
+    void SetWatchChanges(bool watch);
+    bool GetWatchChanges() const { return m_watchChanges; }
+    bool IsLoading() const { return m_request != nullptr; }
+    
+    void Update(float deltaTime) override;
     void Render(HDC hdc) override;
     bool HandleMouseDown(int x, int y, int button) override;
     
 private:
-    struct FileItem {
-        std::wstring name;
-        std::wstring fullPath;
-        bool isDirectory;
-        ULONGLONG size;
-        FILETIME modifiedTime;
-    };
+    using FileItem = DirectoryLoader::Entry;
     
-    void LoadDirectory();
+    void LoadDirectory();       // Replaces the items as the new listing arrives
+    void ReloadDirectory();     // Keeps the items until the new listing is complete
+    bool ProcessLoad();
     void RenderAddressBar(HDC hdc, RECT& rect);
     void RenderFileList(HDC hdc, RECT& rect);
     
     std::wstring m_currentPath;
     std::vector<FileItem> m_items;
+    std::vector<FileItem> m_reloadItems;
+    DirectoryLoader::RequestPtr m_request;
+    bool m_reloading;
+    std::wstring m_pendingSelection;    // SetSelectedFile name not listed yet
+    DirectoryWatcher m_watcher;
+    bool m_watchChanges;
     int m_selectedIndex;
     std::wstring m_filter;
     int m_scrollOffset;
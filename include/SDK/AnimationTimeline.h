@@ -0,0 +1,100 @@
+#pragma once
+
+#include "Renderer.h"
+#include <cstdint>
+#include <vector>
+
+namespace SDK {
+
+/**
+ * AnimationTimeline - Keyframed float tracks advanced together
+ * Track state lives in parallel arrays and all keyframes in one pool, each
+ * track owning a contiguous, time-sorted run of it. Advance() walks the
+ * playing tracks in a single pass, finding each one's segment by binary
+ * search, eases every segment in one Easing::EvaluateBatch() call, then
+ * writes the values to bound floats, so a frame's property writes happen
+ * together after every track is evaluated.
+ * Keyframe semantics match Renderer::Animation: a segment eases with the
+ * easing of the keyframe that starts it, and values hold outside the run.
+ */
+class AnimationTimeline {
+public:
+    using TrackId = uint32_t;
+    static constexpr TrackId INVALID_TRACK = 0xFFFFFFFFu;
+
+    AnimationTimeline();
+    ~AnimationTimeline() = default;
+
+    // Keyframes need not be sorted. Ids of destroyed tracks are reused.
+    TrackId CreateTrack(const Renderer::Keyframe* keyframes, size_t count, float duration, bool looping = false);
+    TrackId CreateTrack(const std::vector<Renderer::Keyframe>& keyframes, float duration, bool looping = false) {
+        return CreateTrack(keyframes.data(), keyframes.size(), duration, looping);
+    }
+    void DestroyTrack(TrackId track);
+    void Clear();
+
+    // target receives the track's value whenever Advance() evaluates it;
+    // nullptr unbinds. The float must outlive the binding.
+    void Bind(TrackId track, float* target);
+
+    void Play(TrackId track);       // From the start
+    void Stop(TrackId track);       // Back to the start, not playing
+    void Pause(TrackId track);
+    void Resume(TrackId track);
+    void SetLooping(TrackId track, bool looping);
+
+    bool IsPlaying(TrackId track) const;
+    bool IsFinished(TrackId track) const;
+    float GetTime(TrackId track) const;
+    float GetValue(TrackId track) const;
+
+    // Moves every playing track deltaTime seconds on
+    void Advance(float deltaTime);
+
+    bool HasPlayingTracks() const { return m_playingCount > 0; }
+    size_t GetTrackCount() const { return m_duration.size() - m_freeTracks.size(); }
+
+    // Shared by Renderer::ApplyEasing; see Easing
+    static float Ease(float t, Renderer::EasingType type);
+
+private:
+    enum : uint8_t {
+        TRACK_ALIVE = 1,
+        TRACK_PLAYING = 2,
+        TRACK_LOOPING = 4
+    };
+
+    bool IsValid(TrackId track) const { return track < m_flags.size() && (m_flags[track] & TRACK_ALIVE); }
+    void SetPlaying(TrackId track, bool playing);
+    float Evaluate(TrackId track, float time) const;
+    // False when the value holds at time, with value set; otherwise key is the
+    // pool index of the keyframe starting the segment and t the progress through it
+    bool FindSegment(TrackId track, float time, uint32_t& key, float& t, float& value) const;
+    void CompactKeyframes();
+
+    // Per track
+    std::vector<float> m_time;
+    std::vector<float> m_duration;
+    std::vector<float> m_value;
+    std::vector<uint32_t> m_firstKey;
+    std::vector<uint32_t> m_keyCount;
+    std::vector<uint8_t> m_flags;
+    std::vector<float*> m_target;
+    std::vector<TrackId> m_freeTracks;
+    size_t m_playingCount;
+
+    // Keyframe pool
+    std::vector<float> m_keyTime;
+    std::vector<float> m_keyValue;
+    std::vector<Renderer::EasingType> m_keyEasing;
+    size_t m_deadKeys;              // Pool entries left by destroyed tracks
+
+    // Advance() scratch
+    std::vector<TrackId> m_evaluated;
+    std::vector<TrackId> m_easeTracks;
+    std::vector<uint32_t> m_easeKeys;
+    std::vector<float> m_easeProgress;
+    std::vector<Renderer::EasingType> m_easeTypes;
+};
+
+} // namespace SDK
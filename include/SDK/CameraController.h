@@ -81,6 +81,18 @@ public:
     // Apply camera transformations to projection
     void ApplyToProjection(const Renderer::Vector3D& point3D, int& x2D, int& y2D, int originX, int originY, float scale) const;
 
+    // Batch forms of TransformPoint3D and ApplyToProjection
+    void TransformPoints(const Renderer::Vector3D* worldPoints, Renderer::Vector3D* viewPoints, size_t count) const;
+    void ProjectPoints(const Renderer::Vector3D* worldPoints, POINT* screenPoints, size_t count,
+                       int originX, int originY, float scale) const;
+
+    // Row-major 4x4 matrices for column vectors, rebuilt when the camera
+    // moves rather than per point. The view matrix maps world space onto the
+    // right, up and forward axes; the view-projection matrix is what
+    // ApplyToProjection divides by its last row (clamped to the near plane).
+    const float* GetViewMatrix() const { return m_viewMatrix; }
+    const float* GetViewProjectionMatrix() const { return m_viewProjection; }
+
     // Camera movement methods
     void MoveForward(float amount);
     void MoveRight(float amount);
@@ -106,6 +118,7 @@ public:
 
 private:
     void UpdateCameraVectors();
+    void UpdateMatrices();
     void ProcessOrbitInput(int deltaX, int deltaY);
     void ProcessPanInput(int deltaX, int deltaY);
     void ProcessZoomInput(int delta);
@@ -150,6 +163,10 @@ private:
     Renderer::Vector3D m_forward;
     Renderer::Vector3D m_right;
     Renderer::Vector3D m_upVector;
+
+    // Cached transforms
+    float m_viewMatrix[16];
+    float m_viewProjection[16];
 };
 
 } // namespace SDK
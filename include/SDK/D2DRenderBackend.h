@@ -2,7 +2,12 @@
 
 #include "RenderBackend.h"
 #include <d2d1.h>
+#include <d2d1_1.h>
 #include <dwrite.h>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #pragma comment(lib, "d2d1.lib")
 #pragma comment(lib, "dwrite.lib")
@@ -12,6 +17,12 @@ namespace SDK {
 /**
  * D2DRenderBackend - Hardware accelerated rendering using Direct2D
  * Requires Windows 7 or later with Platform Update
+ *
+ * Brushes, gradient stops, text formats, scratch bitmaps and effects are
+ * created on first use and kept, keyed by what they depend on. Device-bound
+ * resources are dropped when the render target is lost and rebuilt on demand.
+ * Single lines of text keep their shaped DirectWrite layout, keyed by font
+ * and text, so DrawTextLine and MeasureText shape a repeated label once.
  */
 class D2DRenderBackend : public RenderBackend {
 public:
@@ -28,12 +39,18 @@ public:
     HDC GetDC() const override;
     void* GetNativeContext() const override;
     
+    // Counted as fallback readbacks, like the effect fallbacks
+    HDC BeginGDIInterop() override { return GetGDIFallbackDC(); }
+    void EndGDIInterop(HDC hdc) override { ReleaseGDIFallbackDC(hdc); }
+    
     void DrawRectangle(const RECT& rect, Color fillColor, Color borderColor, float borderWidth) override;
     void DrawRoundedRectangle(const RECT& rect, float radius, Color fillColor, Color borderColor, float borderWidth) override;
     void DrawLine(int x1, int y1, int x2, int y2, Color color, float width) override;
     void DrawEllipse(int cx, int cy, int rx, int ry, Color fillColor, Color borderColor, float borderWidth) override;
     
     void DrawText(const std::wstring& text, const RECT& rect, Color color, const std::wstring& fontFamily, float fontSize, int fontWeight) override;
+    void DrawTextLine(const std::wstring& text, const RECT& rect, Color color, const std::wstring& fontFamily, float fontSize, int fontWeight, TextAlign align) override;
+    int MeasureText(const std::wstring& text, const std::wstring& fontFamily, float fontSize, int fontWeight) override;
     
     void DrawLinearGradient(const RECT& rect, Color startColor, Color endColor, bool horizontal) override;
     void DrawRadialGradient(const RECT& rect, Color centerColor, Color edgeColor, int cx, int cy) override;
@@ -41,29 +58,99 @@ public:
     void DrawShadow(const RECT& rect, int offsetX, int offsetY, int blur, Color shadowColor) override;
     void DrawGlow(const RECT& rect, int radius, Color glowColor) override;
     
+    // Splats into a cached bitmap and draws it once; no readback
+    void DrawParticleBatch(const float* x, const float* y, const uint32_t* colors, size_t count, int size) override;
+    
+    // Strokes all polylines as one path geometry
+    void DrawPolylines(const POINT* points, const DWORD* counts, size_t polylineCount, Color color, float width) override;
+    
+    // Draws from a device bitmap mirroring the atlas, re-uploaded when it changes
+    void DrawAtlasTexture(const TextureAtlas& atlas, const std::string& name, const RECT& dest) override;
+    
     bool SupportsGPUEffects() const override { return true; }
     void ApplyBlur(const RECT& rect, int blurRadius) override;
     void ApplyBloom(const RECT& rect, float threshold, float intensity) override;
     void ApplyDepthOfField(const RECT& rect, int focalDepth, int blurAmount, float focalRange) override;
     void ApplyMotionBlur(const RECT& rect, int directionX, int directionY, float intensity) override;
     void ApplyChromaticAberration(const RECT& rect, float strength, int offsetX, int offsetY) override;
+    // Chains the stages as one effect graph over a single capture
+    void ApplyEffectGraph(const RECT& rect, EffectGraph& graph) override;
     
     BackendType GetType() const override { return BackendType::DIRECT2D; }
     bool IsHardwareAccelerated() const override { return true; }
     Capabilities GetCapabilities() const override;
     
+    // Resource cache sizes, for diagnostics
+    struct ResourceStats {
+        size_t brushes;
+        size_t gradients;
+        size_t textFormats;
+        size_t textLayouts;     // Shaped single lines
+        size_t scratchBitmaps;
+        size_t effects;
+        uint64_t deviceResets;
+        uint64_t fallbackReadbacks;     // Effects that went through a GDI DC
+    };
+    ResourceStats GetResourceStats() const;
+    
 private:
+    // Effects kept for the backend's lifetime, one per use so graphs can be
+    // wired once and only inputs and properties change per call
+    enum EffectSlot {
+        EFFECT_BLUR,
+        EFFECT_BLOOM_THRESHOLD,
+        EFFECT_BLOOM_BLUR,
+        EFFECT_BLOOM_COMPOSITE,
+        EFFECT_DEPTH_BLUR,
+        EFFECT_MOTION_BLUR,
+        EFFECT_CHROMA_RED,
+        EFFECT_CHROMA_GREEN,
+        EFFECT_CHROMA_BLUE,
+        EFFECT_SHADOW_FLOOD,
+        EFFECT_SHADOW_CROP,
+        EFFECT_SHADOW,
+        EFFECT_COUNT
+    };
+    
+    struct GradientResources {
+        ID2D1GradientStopCollection* stops;
+        ID2D1LinearGradientBrush* linear;   // Created on first linear use
+        ID2D1RadialGradientBrush* radial;   // Created on first radial use
+    };
+    
+    struct ScratchBitmap {
+        ID2D1Bitmap* bitmap;
+        UINT32 width;
+        UINT32 height;
+        uint64_t lastUse;
+    };
+    
     // Helper to convert SDK Color to D2D1_COLOR_F
     D2D1_COLOR_F ToD2DColor(Color color) const;
     
     // Helper to convert RECT to D2D1_RECT_F
     D2D1_RECT_F ToD2DRect(const RECT& rect) const;
     
-    // Create brush from color
+    // Cached resources; null when the render target is missing or creation fails
     ID2D1SolidColorBrush* GetBrush(Color color);
+    GradientResources* GetGradient(Color startColor, Color endColor);
+    IDWriteTextFormat* GetTextFormat(const std::wstring& fontFamily, float fontSize, int fontWeight);
+    IDWriteTextLayout* GetTextLayout(const std::wstring& text, const std::wstring& fontFamily, float fontSize, int fontWeight);
+    ID2D1Effect* GetEffect(EffectSlot slot, REFCLSID effectId);
+    
+    // Scratch bitmap holding a copy of rect from the render target
+    ID2D1Bitmap* CaptureRegion(const D2D1_RECT_F& rect);
+    
+    bool CreateDeviceResources();
+    void ReleaseDeviceResources();      // Everything tied to the render target
     
-    // Helper to get HDC for GDI fallback rendering
-    HDC GetGDIFallbackDC() const;
+    // Without D2D1.1 effects, blurs run as repeated bitmap draws on the
+    // device: taps spaced (stepX, stepY) apart, averaged in place over rect
+    void DrawTapBlur(const D2D1_RECT_F& rect, float stepX, float stepY, int taps, bool symmetric);
+    
+    // Helper to get HDC for GDI fallback rendering; each call is a
+    // GPU -> CPU -> GPU round trip and is counted in ResourceStats
+    HDC GetGDIFallbackDC();
     
     // Helper to release GDI fallback DC
     void ReleaseGDIFallbackDC(HDC hdc) const;
@@ -71,18 +158,26 @@ private:
     HWND m_hwnd;
     ID2D1Factory* m_pD2DFactory;
     ID2D1HwndRenderTarget* m_pRenderTarget;
+    ID2D1DeviceContext* m_pDeviceContext;   // D2D 1.1 interface of the target; null on Windows 7 RTM
     IDWriteFactory* m_pDWriteFactory;
     
-    // Cached brushes for performance
-    ID2D1SolidColorBrush* m_pCachedBrush;
-    Color m_cachedBrushColor;
-    
-    // Effects
-    ID2D1Effect* m_pBlurEffect;
-    ID2D1Effect* m_pBloomEffect;
-    ID2D1Effect* m_pDepthOfFieldEffect;
-    ID2D1Effect* m_pMotionBlurEffect;
-    ID2D1Effect* m_pChromaticAberrationEffect;
+    // Device-bound caches
+    std::unordered_map<uint32_t, ID2D1SolidColorBrush*> m_brushes;      // Keyed by RGBA
+    std::unordered_map<uint64_t, GradientResources> m_gradients;        // Keyed by both stop colors
+    std::vector<ScratchBitmap> m_scratchBitmaps;
+    ID2D1Bitmap* m_particleBitmap;                  // Grows to the largest batch drawn
+    std::vector<uint32_t> m_particlePixels;         // Premultiplied staging for m_particleBitmap
+    ID2D1Effect* m_effects[EFFECT_COUNT];
+    
+    // Text formats and stroke styles don't depend on the device and survive a reset
+    std::unordered_map<std::wstring, IDWriteTextFormat*> m_textFormats;
+    std::unordered_map<std::wstring, IDWriteTextLayout*> m_textLayouts;    // Keyed by format and text
+    std::wstring m_textKey;                                                 // Reused for lookups
+    ID2D1StrokeStyle* m_roundStroke;                // Round caps and joins, for DrawPolylines
+    
+    uint64_t m_captureClock;
+    uint64_t m_deviceResets;
+    uint64_t m_fallbackReadbacks;
 };
 
 } // namespace SDK
@@ -1,8 +1,11 @@
 #pragma once
 
 #include "Platform.h"
+#include "Theme.h"
 #include <functional>
+#include <memory>
 #include <unordered_map>
+#include <vector>
 
 namespace SDK {
 
@@ -31,6 +34,33 @@ struct DPIScaleInfo {
     DPIScaleInfo() : dpiX(96.0f), dpiY(96.0f), scaleX(1.0f), scaleY(1.0f), dpi(96) {}
 };
 
+/**
+ * ThemeMetrics - A theme's pixel metrics scaled to one DPI
+ * Computed once per (metrics, DPI) by DPIManager::GetThemeMetrics and shared
+ * by every window showing that theme at that DPI. Scaled shadow blurs are
+ * also what ShadowCache keys its tiles by, so each DPI keeps its own tiles.
+ */
+struct ThemeMetrics {
+    UINT dpi;
+    int titleBarHeight;
+    int borderWidth;
+    int cornerRadius;
+    int shadowOffsetX;
+    int shadowOffsetY;
+    int shadowBlur;
+    
+    // The unscaled theme values these were computed from
+    struct Source {
+        int titleBarHeight, borderWidth, cornerRadius;
+        int shadowOffsetX, shadowOffsetY, shadowBlur;
+        
+        bool operator==(const Source& other) const;
+    } source;
+    
+    static Source SourceOf(const Theme& theme);
+    bool Matches(const Theme& theme, UINT dpiValue) const { return dpi == dpiValue && source == SourceOf(theme); }
+};
+
 /**
  * DPIManager - Centralized DPI management for the SDK
  * Handles per-monitor DPI awareness and automatic scaling
@@ -80,6 +110,12 @@ public:
     POINT ScalePoint(const POINT& pt, const DPIScaleInfo& dpi) const;
     POINT UnscalePoint(const POINT& pt, const DPIScaleInfo& dpi) const;
     
+    // Theme metrics pre-scaled to dpi, from a cache shared by all windows.
+    // A window crossing to a monitor with another DPI swaps to that DPI's
+    // set, which is only computed the first time the DPI is seen.
+    std::shared_ptr<const ThemeMetrics> GetThemeMetrics(const Theme& theme, UINT dpi);
+    size_t GetThemeMetricsCacheSize() const { return m_themeMetrics.size(); }
+    
     // DPI change notifications
     using DPIChangeCallback = std::function<void(HWND, const DPIScaleInfo&, const DPIScaleInfo&)>;
     void RegisterDPIChangeCallback(HWND hwnd, DPIChangeCallback callback);
@@ -110,6 +146,9 @@ private:
     // Cache DPI info per window
     mutable std::unordered_map<HWND, DPIScaleInfo> m_windowDPICache;
     
+    // Scaled theme metrics, one entry per (source values, DPI)
+    std::vector<std::shared_ptr<const ThemeMetrics>> m_themeMetrics;
+    
     // DPI change callbacks
     std::unordered_map<HWND, DPIChangeCallback> m_dpiChangeCallbacks;
     
@@ -5,12 +5,21 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <atomic>
+#include <cstdint>
 #include <functional>
+#include <iterator>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace SDK {
 
 /**
  * DataGrid - Advanced table widget with sorting, filtering, and editing
+ * Rows come either from the grid's own Row storage or from a data provider.
+ * Sorting and filtering produce a view of source row indices; row data is
+ * never copied, and only rows inside the viewport are read while rendering.
  */
 class DataGrid : public Widget {
 public:
@@ -21,6 +30,17 @@ public:
         
         Cell() : userData(nullptr) {}
         Cell(const std::wstring& val) : value(val), userData(nullptr) {}
+        Cell(std::wstring&& val) : value(std::move(val)), userData(nullptr) {}
+    };
+    
+    // Column value type; decides how the column sorts. Cells that don't
+    // parse as the type (including empty ones, and impossible dates or
+    // times) sort after all others, ordered among themselves by text.
+    enum class ColumnType {
+        STRING,
+        INTEGER,
+        DOUBLE,
+        TIMESTAMP   // "YYYY-MM-DD[ HH:MM[:SS]]" (or 'T' separator), or integer epoch seconds
     };
     
     // Column definition
@@ -29,9 +49,10 @@ public:
         int width;
         bool sortable;
         bool editable;
+        ColumnType type;
         
-        Column(const std::wstring& h, int w = 100)
-            : header(h), width(w), sortable(true), editable(false) {}
+        Column(const std::wstring& h, int w = 100, ColumnType t = ColumnType::STRING)
+            : header(h), width(w), sortable(true), editable(false), type(t) {}
     };
     
     // Row data
@@ -66,33 +87,106 @@ public:
     void RemoveColumn(int index);
     void ClearColumns();
     
-    Column& GetColumn(int index) { return m_columns[index]; }
+    Column& GetColumn(int index) { InvalidateColumnOffsets(); return m_columns[index]; }   // May change the width
     const Column& GetColumn(int index) const { return m_columns[index]; }
     int GetColumnCount() const { return static_cast<int>(m_columns.size()); }
     
     void SetColumnWidth(int columnIndex, int width);
     void SetColumnSortable(int columnIndex, bool sortable);
     void SetColumnEditable(int columnIndex, bool editable);
+    void SetColumnType(int columnIndex, ColumnType type);
     
     // Row management
     void AddRow(const std::vector<std::wstring>& values);
+    void AddRow(std::vector<std::wstring>&& values);
     void AddRow(const Row& row);
+    void AddRow(Row&& row);
     void InsertRow(int index, const std::vector<std::wstring>& values);
     void RemoveRow(int index);
     void ClearRows();
-    
+    void ReserveRows(int count);
+    
+    // Bulk loading. Each AddRow on a sorted or filtered grid places the row in
+    // the view right away, which costs a shift of the view per row. Between
+    // BeginUpdate and EndUpdate rows are only stored, and sorting, filtering
+    // and view placement run once at the outermost EndUpdate; until then the
+    // view still shows what it showed at BeginUpdate. Calls nest.
+    // AddRows batches a range of Rows or value vectors (pass move iterators to
+    // move the strings); SetRows replaces all rows without copying them.
+    void BeginUpdate() { m_updateDepth++; }
+    void EndUpdate();
+    bool IsUpdating() const { return m_updateDepth > 0; }
+    
+    template<typename Iterator>
+    void AddRows(Iterator first, Iterator last) {
+        BeginUpdate();
+        ReserveRows(static_cast<int>(m_rows.size() + std::distance(first, last)));
+        for (; first != last; ++first) {
+            AddRow(*first);
+        }
+        EndUpdate();
+    }
+    void SetRows(std::vector<Row>&& rows);
+    
+    // Owned rows only; row indices here are source indices
     Row& GetRow(int index) { return m_rows[index]; }
     const Row& GetRow(int index) const { return m_rows[index]; }
-    int GetRowCount() const { return static_cast<int>(m_rows.size()); }
-    
-    // Cell access
+    int GetRowCount() const;
+    
+    // Data provider
+    // The grid asks for the row count and fetches cell text on demand instead of
+    // storing rows; owned rows are ignored while a provider is set. Call
+    // RefreshData after the provider's rows change.
+    using RowCountProvider = std::function<int()>;
+    using CellValueProvider = std::function<std::wstring(int row, int column)>;
+    
+    void SetDataProvider(RowCountProvider rowCount, CellValueProvider cellValue);
+    void ClearDataProvider();
+    bool HasDataProvider() const { return static_cast<bool>(m_cellValueProvider); }
+    void RefreshData();
+    
+    // Shows a CSV/TSV file through the data provider without loading it (see
+    // DelimitedFile); columns come from its first row. Replaces the columns,
+    // sorting and filters. The provider keeps the file mapped until replaced.
+    bool LoadDelimitedFile(const std::wstring& path, wchar_t delimiter = 0, bool hasHeader = true);
+    
+    // Displayed rows after filtering and sorting. Selection, editing, scrolling
+    // and hit testing use display indices; cell access and callbacks use source
+    // indices.
+    int GetDisplayRowCount() const;
+    int GetSourceRowIndex(int displayRow) const;
+    
+    // Cell access (source row indices)
     void SetCellValue(int row, int column, const std::wstring& value);
     std::wstring GetCellValue(int row, int column) const;
     
+    // Owned rows only
     Cell& GetCell(int row, int column);
     const Cell& GetCell(int row, int column) const;
     
+    // Live updates (owned rows only)
+    // PostCellUpdate may be called from any thread; updates wait in a
+    // lock-free queue until ApplyCellUpdates runs on the UI thread, which
+    // Update does while live updates are enabled. The first update into an
+    // empty queue wakes the grid and the thread that created it, so an idle
+    // scheduled window sleeps until updates arrive. Repeated updates
+    // of one cell collapse to the newest, and unchanged values are skipped.
+    // Only the visible cells that changed are repainted unless a row moves:
+    // a changed sort or filter column places just that row, and a large burst
+    // of such changes re-sorts and re-filters once instead.
+    void SetLiveUpdatesEnabled(bool enabled);
+    bool IsLiveUpdatesEnabled() const { return m_liveUpdates; }
+    void PostCellUpdate(int row, int column, std::wstring value);
+    int ApplyCellUpdates();     // Returns the number of cells changed
+    
+    // Cells changed by live updates fade from color to their background over
+    // duration seconds; 0 turns the flash off
+    void SetChangeFlash(Color color, float duration);
+    
     // Sorting
+    // Sorts a permutation of row indices. Numeric and timestamp columns use a
+    // radix sort over cached parsed keys; large string sorts run on several
+    // threads. AddRow and SetCellValue on a sorted grid insert the row in place.
     void SortByColumn(int columnIndex, SortOrder order = SortOrder::ASCENDING);
     void ToggleSort(int columnIndex);
     
@@ -107,6 +201,14 @@ public:
     std::wstring GetFilter() const { return m_filterText; }
     bool IsFiltered() const { return !m_filterText.empty() || !m_columnFilters.empty(); }
     
+    // Filters are applied incrementally: a filter that only narrows the previous
+    // one re-tests just the rows still shown, and row edits re-test only the
+    // affected row. An indexed column keeps a trigram index, so filters of three
+    // or more characters only test rows containing every trigram of the text.
+    // The global filter uses the indexes when every column is indexed.
+    void SetColumnFilterIndexed(int columnIndex, bool indexed);
+    bool IsColumnFilterIndexed(int columnIndex) const { return m_filterIndexes.count(columnIndex) != 0; }
+    
     // Selection
     void SetSelectionMode(SelectionMode mode) { m_selectionMode = mode; }
     SelectionMode GetSelectionMode() const { return m_selectionMode; }
@@ -128,7 +230,7 @@ public:
     int GetEditingRow() const { return m_editingRow; }
     int GetEditingColumn() const { return m_editingColumn; }
     
-    // Virtual scrolling
+    // Virtual scrolling (rows outside the viewport are never drawn)
     void SetVirtualScrolling(bool enabled) { m_virtualScrolling = enabled; }
     bool IsVirtualScrolling() const { return m_virtualScrolling; }
     
@@ -138,6 +240,18 @@ public:
     void ScrollToRow(int index);
     int GetFirstVisibleRow() const { return m_firstVisibleRow; }
     
+    // Horizontal scrolling (columns outside the viewport are never drawn)
+    // Frozen columns stay at the left edge and the others scroll under them.
+    // Column positions are prefix sums rebuilt only after columns change, and
+    // the visible columns are found by binary search, so painting and hit
+    // testing don't grow with the column count.
+    void SetFrozenColumnCount(int count);
+    int GetFrozenColumnCount() const { return m_frozenColumns; }
+    void SetHorizontalScroll(int offset);   // Pixels scrolled past the frozen columns; clamped
+    int GetHorizontalScroll() const { return m_scrollX; }
+    void ScrollToColumn(int column);        // Scrolls just far enough to show it whole
+    int GetTotalColumnWidth() const { return GetColumnOffsets().back(); }
+    
     // Appearance
     void SetHeaderHeight(int height) { m_headerHeight = height; }
     int GetHeaderHeight() const { return m_headerHeight; }
@@ -152,7 +266,7 @@ public:
     void SetAlternateRowColor(Color color) { m_alternateRowColor = color; }
     void SetSelectionColor(Color color) { m_selectionColor = color; }
     
-    // Events
+    // Events (row is the source row index)
     using CellClickCallback = std::function<void(int row, int column)>;
     using CellEditCallback = std::function<void(int row, int column, const std::wstring& oldValue, const std::wstring& newValue)>;
     using SortCallback = std::function<void(int column, SortOrder order)>;
@@ -174,16 +288,44 @@ private:
     // Data
     std::vector<Column> m_columns;
     std::vector<Row> m_rows;
-    std::vector<Row> m_filteredRows; // Filtered view of rows
+    int m_updateDepth;          // BeginUpdate nesting
+    bool m_refreshPending;      // View work deferred to EndUpdate
+    RowCountProvider m_rowCountProvider;
+    CellValueProvider m_cellValueProvider;
+    std::unordered_set<int> m_providerSelection;    // Selected source rows of a provider
+    
+    // View: display row -> source row. Inactive (identity) when neither
+    // filtered nor sorted, so an unfiltered grid needs no index storage.
+    std::vector<int> m_viewRows;
+    bool m_viewActive;
     
     // Sorting
     int m_sortColumn;
     SortOrder m_sortOrder;
     
+    // Parsed sort keys by source row, kept in step with row edits
+    std::vector<uint64_t> m_sortKeys;       // Numeric and timestamp columns
+    std::vector<std::wstring> m_sortText;   // String columns of a data provider
+    int m_sortKeyColumn;                    // -1 when the cache is stale
+    ColumnType m_sortKeyType;
+    
     // Filtering
     std::wstring m_filterText;
     std::map<int, std::wstring> m_columnFilters;
     
+    // Filter the current view was built with, to detect narrowing
+    std::wstring m_appliedFilterText;
+    std::map<int, std::wstring> m_appliedColumnFilters;
+    
+    // Trigram -> ascending source rows whose cell contains it
+    struct FilterIndex {
+        std::unordered_map<uint64_t, std::vector<int>> postings;
+        bool stale;
+        
+        FilterIndex() : stale(true) {}
+    };
+    std::map<int, FilterIndex> m_filterIndexes;
+    
     // Selection
     SelectionMode m_selectionMode;
     int m_hoveredRow;
@@ -194,6 +336,12 @@ private:
     int m_editingColumn;
     std::wstring m_editBuffer;
     
+    // Column left edges from the grid's left, then the total width
+    mutable std::vector<int> m_columnOffsets;
+    mutable bool m_columnOffsetsDirty;
+    int m_frozenColumns;
+    int m_scrollX;
+    
     // Virtual scrolling
     bool m_virtualScrolling;
     int m_visibleRowCount;
@@ -208,6 +356,22 @@ private:
     Color m_alternateRowColor;
     Color m_selectionColor;
     
+    // Live updates
+    struct CellUpdate {
+        CellUpdate* next;
+        int row;
+        int column;
+        std::wstring value;
+    };
+    std::atomic<CellUpdate*> m_cellUpdates;     // Stack of posted updates, newest first
+#if SDK_PLATFORM_WINDOWS
+    DWORD m_uiThreadId;         // Woken when the queue fills
+#endif
+    bool m_liveUpdates;
+    Color m_flashColor;
+    float m_flashDuration;
+    std::unordered_map<uint64_t, float> m_flashes;  // Cell key -> seconds left
+    
     // Callbacks
     CellClickCallback m_cellClickCallback;
     CellEditCallback m_cellEditCallback;
@@ -216,11 +380,44 @@ private:
     // Helper methods
     void RenderHeader(HDC hdc, const RECT& bounds);
     void RenderRows(HDC hdc, const RECT& bounds);
-    void RenderCell(HDC hdc, const RECT& rect, const Cell& cell, bool selected, bool editing);
+    void RenderCell(HDC hdc, const RECT& rect, const std::wstring& text, bool selected, bool editing, float flash = 0.0f);
     void RenderEditBox(HDC hdc, const RECT& rect);
     
-    void ApplyFilter();
+    bool StoreCellValue(int row, int column, std::wstring value, bool& moved);
+    void InvalidateCells(const std::vector<uint64_t>& cells);
+    void UpdateFlashes(float deltaTime);
+    void ShiftFlashes(int index, int delta);    // Rows from index moved by delta; a removed row's flashes go
+    float GetFlash(int sourceRow, int column) const;
+    
+    void ApplyFilter();     // Rebuilds the view, then re-applies sorting
+    void UpdateFilter();    // Narrows the current view when possible, else ApplyFilter
+    bool IsFilterNarrowing() const;
+    void MarkFilterIndexesStale();
+    void UpdateFilterIndexes(int sourceRow, int column, const std::wstring& oldText, const std::wstring& newText);
+    FilterIndex& GetFilterIndex(int column);
+    bool QueryFilterIndex(int column, const std::wstring& text, std::vector<int>& rows);
+    bool GatherFilterCandidates(std::vector<int>& rows);
     void ApplySorting();
+    void InvalidateSortKeys() { m_sortKeyColumn = -1; }
+    void EnsureSortKeys();
+    uint64_t MakeSortKey(int sourceRow, int column) const;    // Key of the cell under column's type
+    bool IsSorted() const { return m_sortColumn >= 0 && m_sortOrder != SortOrder::NONE; }
+    bool SortsBefore(int sourceRowA, int sourceRowB) const;
+    void InsertIntoView(int sourceRow);     // Places one row into the active view
+    bool RowMatchesFilter(int sourceRow) const;
+    
+    int GetSourceRowCount() const;
+    int GetSourceCellCount(int sourceRow) const;
+    std::wstring GetSourceCellText(int sourceRow, int column) const;
+    bool IsSourceRowSelected(int sourceRow) const;
+    void SetSourceRowSelected(int sourceRow, bool selected);
+    
+    const std::vector<int>& GetColumnOffsets() const;
+    void InvalidateColumnOffsets() { m_columnOffsetsDirty = true; }
+    int GetFrozenWidth() const;
+    int GetColumnLeft(int column, const RECT& bounds) const;
+    void GetScrolledColumnRange(const RECT& bounds, int& first, int& last) const;
+    int HitTestColumn(int x, const RECT& bounds) const;
     
     bool GetCellRect(int row, int column, RECT& rect) const;
     bool HitTestCell(int x, int y, int& row, int& column) const;
@@ -228,9 +425,6 @@ private:
     
     void UpdateScrollbar();
     void CalculateVisibleRows();
-    
-    std::vector<Row>& GetDisplayRows() { return (!m_filterText.empty() || !m_columnFilters.empty()) ? m_filteredRows : m_rows; }
-    const std::vector<Row>& GetDisplayRows() const { return (!m_filterText.empty() || !m_columnFilters.empty()) ? m_filteredRows : m_rows; }
 };
 
 } // namespace SDK
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Platform.h"
+#include <vector>
+
+namespace SDK {
+
+/**
+ * DeferredWindowPos - Batches window moves into one DeferWindowPos pass
+ * While a batch is open on the calling thread, Move() records the move
+ * instead of calling SetWindowPos, a later move of the same window merging
+ * into the earlier one. Closing the outermost batch applies them all between one
+ * BeginDeferWindowPos and EndDeferWindowPos, so the windows move, resize and
+ * repaint together. Without an open batch Move() is SetWindowPos.
+ */
+class DeferredWindowPos {
+public:
+    DeferredWindowPos();    // Opens a batch; batches nest
+    ~DeferredWindowPos();   // Closes it
+
+    DeferredWindowPos(const DeferredWindowPos&) = delete;
+    DeferredWindowPos& operator=(const DeferredWindowPos&) = delete;
+
+    static void Move(HWND hwnd, HWND insertAfter, int x, int y, int width, int height, UINT flags);
+
+    // Applies hwnd's pending move now, for calls that must see the window
+    // where it was moved, such as ShowWindow
+    static void Flush(HWND hwnd);
+
+    // GetWindowRect with hwnd's pending move applied, for moves made
+    // relative to where a window was last moved to
+    static bool GetRect(HWND hwnd, RECT& rect);
+
+    static bool IsBatching();
+    static size_t GetPendingCount();
+
+private:
+    struct Entry {
+        HWND hwnd;
+        HWND insertAfter;
+        int x, y, width, height;
+        UINT flags;
+    };
+
+    struct Batch {
+        int depth;
+        std::vector<Entry> entries;
+
+        Batch() : depth(0) {}
+    };
+
+    static Batch& GetBatch();   // The calling thread's
+    static void Merge(Entry& pending, const Entry& entry);
+    static void Apply(const Entry& entry);
+};
+
+} // namespace SDK
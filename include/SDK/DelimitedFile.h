@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Platform.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SDK {
+
+/**
+ * DelimitedFile - Memory-mapped CSV/TSV table
+ * Open() maps the file read-only and indexes where each row starts, scanning
+ * chunks of the file on JobScheduler workers. Nothing else is copied: cells
+ * stay bytes in the mapping until GetCell() splits their row and decodes the
+ * one asked for, so memory grows by 8 bytes a row however wide the rows are.
+ * Fields follow RFC 4180, so quoted fields may hold delimiters, line breaks
+ * and doubled quotes. A quote elsewhere than at the start of a field is kept
+ * as text, as in 5" disk. Text is UTF-8; a leading byte order mark is skipped.
+ * DataGrid::LoadDelimitedFile() shows one through the grid's data provider.
+ * GetCell() keeps the last split row, so call it from one thread at a time.
+ */
+class DelimitedFile {
+public:
+    DelimitedFile();
+    ~DelimitedFile();
+    DelimitedFile(const DelimitedFile&) = delete;
+    DelimitedFile& operator=(const DelimitedFile&) = delete;
+
+    // A zero delimiter picks tab for .tsv and .tab files, else comma. With a
+    // header the first row names the columns and isn't counted as a row.
+    bool Open(const std::wstring& path, wchar_t delimiter = 0, bool hasHeader = true);
+    void Close();
+    bool IsOpen() const { return m_open; }
+
+    int GetRowCount() const;
+    int GetColumnCount() const { return static_cast<int>(m_columnNames.size()); }   // Of the first row
+    std::wstring GetColumnName(int column) const;   // Empty without a header
+    std::wstring GetCell(int row, int column) const;
+    uint64_t GetFileSize() const { return m_size; }
+
+private:
+    struct Field {
+        uint64_t begin;
+        uint64_t end;
+        bool quoted;        // Doubled quotes inside still need collapsing
+    };
+
+    bool Map(const std::wstring& path);
+    void Unmap();
+    void IndexRows();
+    const std::vector<Field>& SplitLine(size_t line) const;
+    std::wstring DecodeField(const Field& field) const;
+
+    const char* m_data;
+    uint64_t m_size;
+    uint64_t m_start;                   // Past the byte order mark
+#if SDK_PLATFORM_WINDOWS
+    HANDLE m_file;
+    HANDLE m_mapping;
+#endif
+    bool m_open;
+    char m_delimiter;
+    bool m_hasHeader;
+    std::vector<uint64_t> m_lineStarts; // Plus the end of the data
+    std::vector<std::wstring> m_columnNames;
+    mutable size_t m_cachedLine;
+    mutable std::vector<Field> m_cachedFields;
+};
+
+} // namespace SDK
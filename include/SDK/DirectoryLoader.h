@@ -0,0 +1,108 @@
+#pragma once
+
+#include "Platform.h"
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace SDK {
+
+/**
+ * DirectoryLoader - Enumerates directories on a shared pool of worker threads
+ * Load() queues a request and returns immediately. The worker publishes entries
+ * in batches as it finds them, and the UI thread drains them with TakeEntries(),
+ * typically from a widget's Update(). A cancelled request is dropped from the
+ * queue or stopped at the worker's next entry.
+ */
+class DirectoryLoader {
+public:
+    struct Entry {
+        std::wstring name;
+        std::wstring fullPath;
+        bool isDirectory;
+        ULONGLONG size;
+        FILETIME modifiedTime;
+    };
+
+    class Request {
+    public:
+        explicit Request(const std::wstring& path);
+        Request(const Request&) = delete;
+        Request& operator=(const Request&) = delete;
+
+        const std::wstring& GetPath() const { return m_path; }
+
+        void Cancel() { m_cancelled = true; }
+        bool IsCancelled() const { return m_cancelled; }
+
+        // True once the worker has finished and every entry has been taken
+        bool IsComplete() const;
+
+        // Moves out up to maxEntries of the entries published so far
+        std::vector<Entry> TakeEntries(size_t maxEntries = SIZE_MAX);
+
+    private:
+        friend class DirectoryLoader;
+        void Publish(std::vector<Entry>& entries, bool finished);
+
+        std::wstring m_path;
+        std::atomic<bool> m_cancelled;
+        mutable std::mutex m_mutex;
+        std::deque<Entry> m_ready;
+        bool m_finished;
+    };
+    using RequestPtr = std::shared_ptr<Request>;
+
+    static RequestPtr Load(const std::wstring& path);
+
+    // Takes effect when the pool next starts; call before the first Load()
+    static void SetWorkerCount(unsigned count);
+
+    // Cancels every request and joins the workers; Load() restarts the pool
+    static void Shutdown();
+
+    // Worker-side enumeration; runs on the calling thread
+    static void Enumerate(Request& request);
+};
+
+/**
+ * DirectoryWatcher - Reports which directories under a root have changed
+ * Keeps one overlapped ReadDirectoryChangesW outstanding and polls it without
+ * blocking, so a widget can reload only the directories that changed instead
+ * of re-listing everything.
+ */
+class DirectoryWatcher {
+public:
+    DirectoryWatcher();
+    ~DirectoryWatcher();
+    DirectoryWatcher(const DirectoryWatcher&) = delete;
+    DirectoryWatcher& operator=(const DirectoryWatcher&) = delete;
+
+    // notifyFilter takes FILE_NOTIFY_CHANGE_* flags; names only by default
+    bool Start(const std::wstring& path, bool recursive,
+               DWORD notifyFilter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME);
+    void Stop();
+    bool IsWatching() const { return m_directory != INVALID_HANDLE_VALUE; }
+    const std::wstring& GetPath() const { return m_path; }
+
+    // Full paths of the directories whose entries changed since the last poll,
+    // without duplicates. overflowed is set when changes were lost and
+    // everything under the root should be reloaded.
+    std::vector<std::wstring> Poll(bool& overflowed);
+
+private:
+    bool Issue();
+
+    std::wstring m_path;
+    bool m_recursive;
+    DWORD m_notifyFilter;
+    HANDLE m_directory;
+    OVERLAPPED m_overlapped;
+    std::vector<DWORD> m_buffer;    // DWORD-aligned, as ReadDirectoryChangesW requires
+};
+
+} // namespace SDK
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Renderer.h"
+#include <cstddef>
+#include <memory>
+
+namespace SDK {
+
+/**
+ * Easing - Table-driven easing curves
+ * The elastic and bounce curves, which cost pow/sin or a chain of branches,
+ * are sampled once into tables and read back with linear interpolation; the
+ * polynomial curves are cheaper to compute than to look up and stay exact.
+ * EvaluateBatch() eases a whole array in one call. Cubic Bezier curves are
+ * solved once per set of control points into a table shared by everyone
+ * asking for the same curve. Thread-safe.
+ */
+class Easing {
+public:
+    // t outside (0, 1) is computed exactly
+    static float Evaluate(Renderer::EasingType type, float t);
+    static float EvaluateExact(Renderer::EasingType type, float t);
+
+    // Eases t[i] in place, by types[i] or by one type for all
+    static void EvaluateBatch(const Renderer::EasingType* types, float* t, size_t count);
+    static void EvaluateBatch(Renderer::EasingType type, float* t, size_t count);
+
+    /**
+     * CubicBezier - CSS-style timing curve from (0, 0) to (1, 1)
+     * Solved for y at evenly spaced x when made; Evaluate() interpolates.
+     */
+    class CubicBezier {
+    public:
+        CubicBezier(float x1, float y1, float x2, float y2);
+
+        float Evaluate(float x) const;      // x clamped to [0, 1]
+        float Solve(float x) const;         // Newton's method, bisection where it stalls
+
+    private:
+        static constexpr int TABLE_STEPS = 128;
+
+        float SampleX(float t) const { return ((m_ax * t + m_bx) * t + m_cx) * t; }
+        float SampleY(float t) const { return ((m_ay * t + m_by) * t + m_cy) * t; }
+        float SampleDerivativeX(float t) const { return (3.0f * m_ax * t + 2.0f * m_bx) * t + m_cx; }
+
+        float m_ax, m_bx, m_cx;
+        float m_ay, m_by, m_cy;
+        float m_table[TABLE_STEPS + 1];
+    };
+
+    // Shared per set of control points
+    static std::shared_ptr<const CubicBezier> GetCubicBezier(float x1, float y1, float x2, float y2);
+
+private:
+    Easing() = delete;
+};
+
+} // namespace SDK
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "RenderBackend.h"
+#include <cstdint>
+#include <vector>
+
+namespace SDK {
+
+/**
+ * EffectGraph - RenderBackend::EffectSettings compiled into a stage list
+ * Applied one call per effect, a chain reads the region back, and snapshots
+ * it for every copy-based effect, once per stage. Compiling drops stages that
+ * would change nothing and hands bloom's bright pass to the row-local stage
+ * before it, so those rows are extracted while still in cache. Running keeps
+ * one snapshot and one bright buffer across stages and calls. CPU backends run
+ * a graph on pixels read back once; D2DRenderBackend chains it as effects.
+ */
+class EffectGraph {
+public:
+    using Settings = RenderBackend::EffectSettings;
+
+    // In the order they run
+    enum class StageType {
+        BLUR,
+        DEPTH_OF_FIELD,
+        MOTION_BLUR,
+        CHROMATIC_ABERRATION,
+        BLOOM
+    };
+
+    struct Stage {
+        StageType type;
+        bool extractsBloom;     // Also writes the next stage's bloom bright pass, band by band
+    };
+
+    EffectGraph();
+
+    void Compile(const Settings& settings);
+    bool IsCompiledFrom(const Settings& settings) const;
+
+    const Settings& GetSettings() const { return m_settings; }
+    const std::vector<Stage>& GetStages() const { return m_stages; }
+    bool IsEmpty() const { return m_stages.empty(); }
+
+    // Runs on a 0xAARRGGBB buffer. focalDepth is the settings' focal row moved
+    // into the buffer, for callers whose buffer starts below the region's top.
+    void Run(uint32_t* pixels, int width, int height, int stride, int focalDepth);
+    void Run(uint32_t* pixels, int width, int height, int stride) { Run(pixels, width, height, stride, m_settings.focalDepth); }
+
+    // Frees the scratch buffers; the stages stay compiled
+    void ReleaseBuffers();
+
+private:
+    template<typename Body>
+    void RunRows(const Stage& stage, uint32_t* pixels, int width, int height, int stride, Body&& body);
+    void Snapshot(const uint32_t* pixels, int width, int height, int stride);
+
+    Settings m_settings;
+    bool m_compiled;
+    std::vector<Stage> m_stages;
+    std::vector<uint32_t> m_snapshot;  // Unmodified input of the stage being run
+    std::vector<uint32_t> m_bright;    // Bloom's bright pass
+};
+
+} // namespace SDK
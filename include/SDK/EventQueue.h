@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Widget.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace SDK {
+
+/**
+ * EventQueue - Per-thread queue for frame-coalesced widget events
+ * Widgets whose callback was set with EventDelivery::COALESCED post
+ * MOUSE_MOVE, VALUE_CHANGED and TEXT_CHANGED here instead of calling it.
+ * Repeats of one event on one widget collapse into the pending entry, which
+ * keeps its place and takes the newest data pointer, so a slider dragged
+ * through a hundred values reports the last one once. Dispatch() delivers the
+ * batch in posting order; WindowManager::RunFrame(), Window::Render() and
+ * WidgetManager::UpdateAll() call it, and custom loops call it once a frame.
+ * Events posted during Dispatch() wait for the next one.
+ */
+class EventQueue {
+public:
+    static bool IsCoalescable(WidgetEvent event);
+
+    static void Post(Widget* widget, WidgetEvent event, void* data);
+    // Delivers the queued batch; returns the number of events delivered
+    static size_t Dispatch();
+    // Delivers the widget's queued events now, ahead of one sent immediately
+    static void Flush(Widget* widget);
+    // Drops the widget's queued events; widgets call it when destroyed
+    static void Cancel(Widget* widget);
+
+    static size_t GetPendingCount();
+
+    struct Stats {
+        uint64_t posted;
+        uint64_t coalesced;     // Posts folded into a pending entry
+        uint64_t dispatched;
+    };
+    static Stats GetStats();    // The calling thread's
+    static void ResetStats();
+
+private:
+    EventQueue() = delete;
+};
+
+} // namespace SDK
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Platform.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace SDK {
+
+/**
+ * FontCache - Process-wide cache of GDI fonts
+ * Fonts are keyed by (family, size, weight, italic, underline, strikeout, DPI)
+ * and shared through reference-counted handles. Least recently used fonts are
+ * evicted past the capacity; an evicted font stays valid until its last
+ * handle is released.
+ */
+class FontCache {
+public:
+    struct Font {
+        HFONT handle;
+
+        explicit Font(HFONT font) : handle(font) {}
+        ~Font();
+        Font(const Font&) = delete;
+        Font& operator=(const Font&) = delete;
+    };
+    using FontPtr = std::shared_ptr<const Font>;
+
+    // size is the character height in pixels at 96 DPI; it is scaled by dpi / 96
+    static FontPtr Get(const std::wstring& family, int size, int weight = FW_NORMAL,
+                       bool italic = false, bool underline = false, bool strikeout = false,
+                       int dpi = 96);
+
+    struct Stats {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t evictions;
+        size_t size;        // Fonts currently cached
+        size_t inUse;       // Cached fonts with a live handle outside the cache
+    };
+    static Stats GetStats();
+    static void ResetStats();
+
+    // Cache management
+    static void SetCapacity(size_t maxFonts);   // Default: 64
+    static void Clear();
+    static size_t GetSize();
+
+private:
+    FontCache() = delete;
+};
+
+/**
+ * ScopedFont - Selects a cached font into a DC for the current scope
+ * The previous font is restored on destruction.
+ */
+class ScopedFont {
+public:
+    ScopedFont(HDC hdc, FontCache::FontPtr font);
+    ~ScopedFont();
+    ScopedFont(const ScopedFont&) = delete;
+    ScopedFont& operator=(const ScopedFont&) = delete;
+
+private:
+    HDC m_hdc;
+    FontCache::FontPtr m_font;
+    HGDIOBJ m_oldFont;
+};
+
+} // namespace SDK
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+namespace SDK {
+
+/**
+ * FrameArena - Per-thread bump allocator for memory that lives one frame
+ * Render paths take scratch pixels, token lists and text from the calling
+ * thread's arena through GetResource(), usually as a FrameVector or
+ * FrameWString. Freeing does nothing: a Scope gives back everything taken
+ * inside it, and EndFrame() gives back the rest. When a frame spilled into
+ * more than one block, EndFrame() swaps them for one block of the combined
+ * size, so from the next frame on the same work touches the heap zero times.
+ * WindowManager and X11WindowManager call EndFrame() after each frame, next
+ * to GdiObjectCache::EndFrame(); work run on other threads opens a Scope.
+ * Memory from the arena must not be kept past the Scope or frame it came from.
+ */
+class FrameArena {
+public:
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+    // The calling thread's arena as a memory resource for pmr containers
+    static std::pmr::memory_resource* GetResource();
+    static void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    // Rewinds the calling thread's arena to where it stood when the scope opened
+    class Scope {
+    public:
+        Scope();
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        size_t m_block;
+        size_t m_offset;
+    };
+
+    // Rewinds the calling thread's arena; ignored while a Scope is open
+    static void EndFrame();
+
+    // Blocks over this many bytes in total are freed at EndFrame() rather than kept
+    static void SetRetainLimit(size_t bytes);
+    static size_t GetRetainLimit();
+
+    struct Stats {
+        size_t bytesUsed;           // Taken since the last EndFrame(), alignment included
+        size_t bytesReserved;
+        size_t peakBytes;           // Most used in one frame
+        uint64_t frames;
+        uint64_t heapAllocations;   // Blocks allocated since the last EndFrame()
+        uint64_t lastFrameHeapAllocations;
+        uint64_t totalHeapAllocations;
+    };
+    static Stats GetStats();        // The calling thread's arena
+
+private:
+    FrameArena() = delete;
+};
+
+// Containers drawing on the calling thread's arena: FrameVector<int> v(FrameArena::GetResource());
+template<typename T>
+using FrameVector = std::pmr::vector<T>;
+using FrameWString = std::pmr::wstring;
+
+} // namespace SDK
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Platform.h"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+namespace SDK {
+
+/**
+ * FrameClock - One frame per display refresh
+ * BeginFrame() blocks until the next refresh and stamps the frame; everything
+ * drawn or animated in that frame reads the same GetFrameTime(). On Windows the
+ * wait is DwmFlush (the compositor's vblank) while composition is on; elsewhere,
+ * or when vsync is off, it sleeps to the next deadline on a fixed grid, so a
+ * late frame drops whole refresh intervals instead of drifting.
+ */
+class FrameClock {
+public:
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    struct FrameTiming {
+        uint64_t frameIndex;
+        float deltaTime;        // Seconds since the previous frame began
+        float waitTime;         // Seconds BeginFrame() blocked
+        float workTime;         // Seconds from BeginFrame() to EndFrame()
+        int missedRefreshes;    // Refresh intervals skipped before this frame
+        int windowsRendered;
+        int windowsSkipped;     // Clean windows left alone
+        int windowsCulled;      // Invalidated windows left alone while covered or suspended
+        bool vsync;             // Waited on the compositor rather than a timer
+
+        FrameTiming() : frameIndex(0), deltaTime(0.0f), waitTime(0.0f), workTime(0.0f),
+                        missedRefreshes(0), windowsRendered(0), windowsSkipped(0), windowsCulled(0), vsync(false) {}
+    };
+    using FrameCallback = std::function<void(const FrameTiming&)>;
+
+    FrameClock();
+
+    // Queried from the compositor on Windows, 60 Hz otherwise
+    void SetRefreshRate(double hz);
+    double GetRefreshRate() const { return m_refreshRate; }
+
+    void SetVSyncEnabled(bool enabled) { m_vsync = enabled; }
+    bool IsVSyncEnabled() const { return m_vsync; }
+
+    // Blocks until the next refresh; returns the frame time
+    TimePoint BeginFrame();
+    // Records the frame's work and reports it to the frame callback
+    void EndFrame(int windowsRendered, int windowsSkipped, int windowsCulled = 0);
+
+    TimePoint GetFrameTime() const { return m_frameTime; }
+    float GetDeltaTime() const { return m_timing.deltaTime; }
+    uint64_t GetFrameIndex() const { return m_timing.frameIndex; }
+
+    const FrameTiming& GetLastFrameTiming() const { return m_lastTiming; }
+    float GetAverageFrameTime() const;  // Mean delta over the recent frames
+    // Copies up to maxCount recent deltas, oldest first; returns how many
+    int GetFrameTimeHistory(float* deltas, int maxCount) const;
+    static constexpr int GetFrameHistoryCapacity() { return FRAME_HISTORY_SIZE; }
+
+    void SetFrameCallback(FrameCallback callback) { m_frameCallback = callback; }
+
+private:
+    bool WaitForVBlank();
+
+    double m_refreshRate;
+    std::chrono::steady_clock::duration m_interval;
+    bool m_vsync;
+
+    TimePoint m_frameTime;
+    TimePoint m_deadline;       // Next refresh on the timer grid
+    bool m_started;
+
+    FrameTiming m_timing;       // Frame in progress
+    FrameTiming m_lastTiming;   // Last finished frame
+
+    static constexpr int FRAME_HISTORY_SIZE = 64;
+    float m_history[FRAME_HISTORY_SIZE];
+    int m_historyNext;
+    int m_historyCount;
+
+    FrameCallback m_frameCallback;
+};
+
+} // namespace SDK
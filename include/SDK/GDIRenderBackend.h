@@ -29,6 +29,8 @@ public:
     void DrawEllipse(int cx, int cy, int rx, int ry, Color fillColor, Color borderColor, float borderWidth) override;
     
     void DrawText(const std::wstring& text, const RECT& rect, Color color, const std::wstring& fontFamily, float fontSize, int fontWeight) override;
+    void DrawTextLine(const std::wstring& text, const RECT& rect, Color color, const std::wstring& fontFamily, float fontSize, int fontWeight, TextAlign align) override;
+    int MeasureText(const std::wstring& text, const std::wstring& fontFamily, float fontSize, int fontWeight) override;
     
     void DrawLinearGradient(const RECT& rect, Color startColor, Color endColor, bool horizontal) override;
     void DrawRadialGradient(const RECT& rect, Color centerColor, Color edgeColor, int cx, int cy) override;
@@ -36,12 +38,20 @@ public:
     void DrawShadow(const RECT& rect, int offsetX, int offsetY, int blur, Color shadowColor) override;
     void DrawGlow(const RECT& rect, int radius, Color glowColor) override;
     
+    // Splats into the back buffer through one DIB section
+    void DrawParticleBatch(const float* x, const float* y, const uint32_t* colors, size_t count, int size) override;
+    
+    // One PolyPolyline per batch
+    void DrawPolylines(const POINT* points, const DWORD* counts, size_t polylineCount, Color color, float width) override;
+    
     bool SupportsGPUEffects() const override { return false; }
     void ApplyBlur(const RECT& rect, int blurRadius) override;
     void ApplyBloom(const RECT& rect, float threshold, float intensity) override;
     void ApplyDepthOfField(const RECT& rect, int focalDepth, int blurAmount, float focalRange) override;
     void ApplyMotionBlur(const RECT& rect, int directionX, int directionY, float intensity) override;
     void ApplyChromaticAberration(const RECT& rect, float strength, int offsetX, int offsetY) override;
+    // The whole chain on one DIB copy of the region
+    void ApplyEffectGraph(const RECT& rect, EffectGraph& graph) override;
     
     BackendType GetType() const override { return BackendType::GDI; }
     bool IsHardwareAccelerated() const override { return false; }
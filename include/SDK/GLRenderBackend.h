@@ -0,0 +1,129 @@
+#pragma once
+
+#include "Platform.h"
+
+#if SDK_PLATFORM_LINUX && SDK_HAS_X11
+
+#include "RenderBackend.h"
+#include "GlyphAtlas.h"
+#include <X11/Xlib.h>
+#include <memory>
+#include <vector>
+
+namespace SDK {
+
+struct GLState;
+class XftFontSource;
+
+/**
+ * GLRenderBackend - OpenGL 3.3 core rendering backend for Linux
+ * Creates a GLX context on the window and draws into an offscreen color
+ * texture that EndDraw() copies to the window, so content survives between
+ * frames as it does with the X11 back buffer. Every shape, gradient, glyph,
+ * shadow and atlas texture is a quad in one vertex batch, drawn by a single
+ * shader that branches on the primitive kind, so a frame of widgets is a
+ * handful of draw calls. Rounded rects, ellipses and lines are antialiased
+ * from signed distances; text comes from a GlyphAtlas mirrored into a
+ * texture. Blur, bloom, depth of field, motion blur and chromatic
+ * aberration run as fragment passes over scratch textures and never read
+ * the pixels back. Built only when CMake finds OpenGL (SDK_HAS_OPENGL);
+ * otherwise Initialize() fails and RenderBackend::Create() keeps X11.
+ */
+class GLRenderBackend : public RenderBackend {
+public:
+    GLRenderBackend();
+    ~GLRenderBackend() override;
+    GLRenderBackend(const GLRenderBackend&) = delete;
+    GLRenderBackend& operator=(const GLRenderBackend&) = delete;
+
+    // A GLX 1.3 server with core profile contexts; checked once per process
+    static bool IsAvailable();
+
+    bool Initialize(HWND hwnd) override;
+    void Shutdown() override;
+
+    bool BeginDraw() override;
+    void EndDraw() override;
+    void Clear(Color color) override;
+
+    HDC GetDC() const override;
+    void* GetNativeContext() const override;   // The GLXContext
+
+    // No GDI surface to draw on
+    HDC BeginGDIInterop() override { return nullptr; }
+
+    void DrawRectangle(const RECT& rect, Color fillColor, Color borderColor, float borderWidth) override;
+    void DrawRoundedRectangle(const RECT& rect, float radius, Color fillColor, Color borderColor, float borderWidth) override;
+    void DrawLine(int x1, int y1, int x2, int y2, Color color, float width) override;
+    void DrawEllipse(int cx, int cy, int rx, int ry, Color fillColor, Color borderColor, float borderWidth) override;
+
+    void DrawText(const std::wstring& text, const RECT& rect, Color color, const std::wstring& fontFamily, float fontSize, int fontWeight) override;
+    void DrawTextLine(const std::wstring& text, const RECT& rect, Color color, const std::wstring& fontFamily, float fontSize, int fontWeight, TextAlign align) override;
+    int MeasureText(const std::wstring& text, const std::wstring& fontFamily, float fontSize, int fontWeight) override;
+
+    void DrawParticleBatch(const float* x, const float* y, const uint32_t* colors, size_t count, int size) override;
+    // Nearest-neighbour copy; the atlas is uploaded again when its version changes
+    void DrawAtlasTexture(const TextureAtlas& atlas, const std::string& name, const RECT& dest) override;
+
+    void DrawLinearGradient(const RECT& rect, Color startColor, Color endColor, bool horizontal) override;
+    void DrawRadialGradient(const RECT& rect, Color centerColor, Color edgeColor, int cx, int cy) override;
+
+    void DrawShadow(const RECT& rect, int offsetX, int offsetY, int blur, Color shadowColor) override;
+    void DrawGlow(const RECT& rect, int radius, Color glowColor) override;
+
+    bool SupportsGPUEffects() const override { return true; }
+    void ApplyBlur(const RECT& rect, int blurRadius) override;
+    void ApplyBloom(const RECT& rect, float threshold, float intensity) override;
+    void ApplyDepthOfField(const RECT& rect, int focalDepth, int blurAmount, float focalRange) override;
+    void ApplyMotionBlur(const RECT& rect, int directionX, int directionY, float intensity) override;
+    void ApplyChromaticAberration(const RECT& rect, float strength, int offsetX, int offsetY) override;
+
+    BackendType GetType() const override { return BackendType::OPENGL; }
+    bool IsHardwareAccelerated() const override { return true; }
+    Capabilities GetCapabilities() const override;
+
+    // The frame so far as premultiplied 0xAARRGGBB rows, top row first
+    bool ReadPixels(std::vector<uint32_t>& pixels);
+    GlyphAtlas::Stats GetTextStats() const;
+    size_t GetDrawCallCount() const;    // Since BeginDraw(), effect passes included
+
+    Display* GetDisplay() const { return m_display; }
+    Window GetWindow() const { return m_window; }
+
+private:
+    enum class Kind;
+
+    // Functions, shaders, buffers and the render target, once the context is current
+    bool CreateResources(int width, int height);
+    void ReleaseResources();
+    bool ResizeTarget(int width, int height);
+
+    // Queues a quad covering bounds; local coordinates run from localMin at the
+    // top-left corner to localMax at the bottom-right
+    void PushQuad(const RECT& bounds, float localMinX, float localMinY, float localMaxX, float localMaxY,
+                  Kind kind, uint32_t fill, uint32_t border, float p0, float p1, float p2, float p3);
+    void Flush();
+
+    const GlyphAtlas::Run* LayoutText(const std::wstring& text, const std::wstring& fontFamily, float fontSize,
+                                      int fontWeight, int& ascent, int& descent);
+    void DrawRun(const GlyphAtlas::Run& run, int x, int baseline, Color color);
+    bool UploadAtlas(const TextureAtlas& atlas);
+
+    // Flushes and clips rect to the frame; false when nothing is left to process
+    bool BeginEffect(const RECT& rect, RECT& clipped);
+
+    Display* m_display;
+    Window m_window;
+    int m_width;
+    int m_height;
+
+    std::unique_ptr<GLState> m_gl;
+    std::unique_ptr<XftFontSource> m_fonts;     // Declared before the atlas, which calls into it
+    std::unique_ptr<GlyphAtlas> m_glyphs;
+
+    bool m_initialized;
+};
+
+} // namespace SDK
+
+#endif // SDK_PLATFORM_LINUX && SDK_HAS_X11
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Platform.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace SDK {
+
+// Owners of long-lived GDI handles, for GdiHandleCounter
+enum class GdiSubsystem {
+    OBJECT_CACHE,       // GdiObjectCache pens, brushes and regions
+    FONTS,              // FontCache
+    BACK_BUFFERS,       // Window render caches
+    LAYERS,             // LayerCompositor surfaces
+    SHADOWS,            // ShadowCache tile surfaces
+    ATLAS,              // TextureAtlas surfaces
+    ANIMATION,          // WindowAnimation snapshots
+    EFFECTS,            // Pixel access surfaces held during an effect
+    IMAGES,             // ImageCache surfaces
+    OTHER,
+    COUNT
+};
+
+/**
+ * GdiHandleCounter - Live GDI handles per SDK subsystem
+ * Subsystems report the handles they create and delete, so a process creeping
+ * toward the 10,000 GDI object limit shows which part of the SDK holds them.
+ * GetProcessCount() is the system's own count, which includes the
+ * application's handles too.
+ */
+class GdiHandleCounter {
+public:
+    static void Add(GdiSubsystem subsystem, int handles = 1);
+    static void Remove(GdiSubsystem subsystem, int handles = 1);
+
+    static int64_t GetLive(GdiSubsystem subsystem);
+    static int64_t GetPeak(GdiSubsystem subsystem);
+    static int64_t GetTotalLive();
+    static const char* GetName(GdiSubsystem subsystem);
+
+    static uint32_t GetProcessCount();
+
+private:
+    GdiHandleCounter() = delete;
+};
+
+/**
+ * GdiObjectCache - Per-thread cache of solid brushes, pens and rounded regions
+ * Replaces the create/select/delete per draw call with a lookup keyed by
+ * color, width and style. Each thread keeps its own objects, so lookups take
+ * no lock. EndFrame() deletes objects unused for a while and, past the
+ * capacity, the least recently used; Window::Render() and
+ * WindowManager::RunFrame() call it, and other threads that draw call it
+ * themselves. Returned handles belong to the cache: never delete them, and
+ * deselect them before the frame ends.
+ */
+class GdiObjectCache {
+public:
+    static HBRUSH GetBrush(COLORREF color);
+    static HPEN GetPen(COLORREF color, int width = 1, int style = PS_SOLID);
+
+    // Region for CreateRoundRectRgn(rect.left, rect.top, rect.right + 1,
+    // rect.bottom + 1, radius * 2, radius * 2). Regions are shared by size and
+    // moved into place, so one is valid only until the next call for the same size.
+    static HRGN GetRoundRectRegion(const RECT& rect, int radius);
+
+    // Trims the calling thread's cache
+    static void EndFrame();
+
+    // Per thread
+    static void SetCapacity(size_t maxObjects);
+    static size_t GetCapacity();
+    static void SetIdleFrames(uint32_t frames);     // Unused this long, an object is deleted
+    static void Clear();                            // The calling thread's objects
+
+    struct Stats {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t evictions;
+        size_t size;        // Objects in the calling thread's cache
+    };
+    static Stats GetStats();                        // Hits, misses and evictions across threads
+    static void ResetStats();
+
+private:
+    GdiObjectCache() = delete;
+};
+
+} // namespace SDK
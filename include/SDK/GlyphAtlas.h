@@ -0,0 +1,132 @@
+#pragma once
+
+#include "Platform.h"
+#include "MemoryRegistry.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace SDK {
+
+/**
+ * GlyphAtlas - Rasterized glyphs packed into one coverage surface
+ * Each glyph is rasterized once per font, through a callback the backend
+ * supplies, and shelf-packed into an 8-bit coverage buffer. Strings are laid
+ * out once into runs of glyphs and pen positions, cached by font and text,
+ * so a label drawn every frame costs one lookup and a blit per glyph. When
+ * the surface fills, every glyph is dropped and rasterized again on next
+ * use. Backends mirror the coverage into their own surface, uploading
+ * GetDirtyRect() before they draw from it. Reports to MemoryRegistry, which
+ * trims the cached runs. Not thread-safe.
+ */
+class GlyphAtlas {
+public:
+    // Where a glyph sits in the atlas and where it goes relative to the pen
+    struct Glyph {
+        int x, y, width, height;
+        int left;       // Bitmap's left edge, right of the pen
+        int top;        // Bitmap's top edge, above the baseline
+        int advance;
+    };
+
+    // A rasterizer's output; coverage rows are width bytes apart
+    struct Bitmap {
+        int width, height;
+        int left, top;
+        int advance;
+        std::vector<uint8_t> coverage;
+    };
+    using Rasterizer = std::function<bool(uint32_t font, uint32_t codepoint, Bitmap& bitmap)>;
+
+    struct RunGlyph {
+        const Glyph* glyph;
+        int x;          // Pen position from the start of the run
+    };
+    struct Run {
+        std::vector<RunGlyph> glyphs;   // Empty glyphs (spaces) are left out
+        int width;
+    };
+
+    GlyphAtlas(int width, int height, Rasterizer rasterizer);
+    GlyphAtlas(const GlyphAtlas&) = delete;
+    GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+
+    // Null when the rasterizer fails or the glyph is larger than the atlas
+    const Glyph* GetGlyph(uint32_t font, uint32_t codepoint);
+
+    // One line of text laid out in font; valid until the next GetGlyph(),
+    // GetRun() or Clear()
+    const Run& GetRun(uint32_t font, const std::wstring& text);
+
+    void Clear();
+    void SetRunCapacity(size_t maxRuns);    // Default: 512
+
+    int GetWidth() const { return m_width; }
+    int GetHeight() const { return m_height; }
+    const uint8_t* GetCoverage() const { return m_coverage.data(); }   // stride == GetWidth()
+
+    // Area rasterized into since the last ClearDirtyRect(); false when none
+    bool GetDirtyRect(RECT& rect) const;
+    void ClearDirtyRect();
+
+    struct Stats {
+        uint64_t glyphHits;
+        uint64_t glyphMisses;   // Glyphs rasterized
+        uint64_t runHits;
+        uint64_t runMisses;     // Runs laid out
+        uint64_t resets;        // Times the atlas filled and was emptied
+        size_t glyphs;
+        size_t runs;
+    };
+    Stats GetStats() const;
+    void ResetStats();
+
+private:
+    struct Shelf {
+        int y, height, x;       // x: where the next glyph goes
+    };
+
+    struct CachedRun {
+        uint32_t font;
+        std::wstring text;
+        Run run;
+        uint64_t epoch;         // Glyph pointers are stale once m_epoch moves on
+    };
+    using RunList = std::list<CachedRun>;
+
+    bool Pack(int width, int height, int& x, int& y);
+    void Reset();
+    void Layout(CachedRun& cached);
+    void TrimRuns(size_t maxRuns);
+    size_t GetRunBytes(const CachedRun& cached) const;
+    size_t GetMemoryBytes() const;
+    void TrimMemory(size_t targetBytes);
+
+    int m_width;
+    int m_height;
+    Rasterizer m_rasterizer;
+    std::vector<uint8_t> m_coverage;
+    std::vector<Shelf> m_shelves;
+    std::unordered_map<uint64_t, Glyph> m_glyphs;   // Keyed by font and codepoint; null glyphs too
+    uint64_t m_epoch;
+    int m_dirtyLeft, m_dirtyTop, m_dirtyRight, m_dirtyBottom;
+
+    RunList m_runs;                 // Most recently used first
+    std::unordered_map<uint32_t, std::unordered_map<std::wstring, RunList::iterator>> m_runIndex;
+    size_t m_runCapacity;
+    Bitmap m_scratch;
+
+    uint64_t m_glyphHits;
+    uint64_t m_glyphMisses;
+    uint64_t m_runHits;
+    uint64_t m_runMisses;
+    uint64_t m_resets;
+
+    MemoryRegistry::Source m_memorySource;  // Last: unregisters before the rest goes
+};
+
+} // namespace SDK
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "RenderBackend.h"
+#include "GlyphAtlas.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace SDK {
+
+/**
+ * HeadlessRenderBackend - Software rendering into memory, with no window system
+ * Draws into its own premultiplied 0xAARRGGBB buffer: shapes are antialiased
+ * from signed distances, shadows and glows come from ShadowCache and effects
+ * run the PixelKernels in place. Text goes through a per-instance GlyphAtlas
+ * fed by a FontRasterizer; the default uses GDI glyph outlines on Windows and
+ * draws box glyphs elsewhere. Instances share nothing mutable, so each thread
+ * can render its own; RenderParallel() spreads a batch of snapshots over
+ * JobScheduler. Widgets without a backend path draw through a GDI memory DC
+ * on Windows. Use for thumbnails, golden-image tests and server-side renders.
+ */
+class HeadlessRenderBackend : public RenderBackend {
+public:
+    // Fills bitmap with one glyph of fontFamily at pixelSize; FW_* weight.
+    // Ascent is taken as 80% of the pixel size.
+    using FontRasterizer = std::function<bool(const std::wstring& fontFamily, int pixelSize, int fontWeight,
+                                              uint32_t codepoint, GlyphAtlas::Bitmap& bitmap)>;
+
+    explicit HeadlessRenderBackend(int width = 0, int height = 0);
+    ~HeadlessRenderBackend() override;
+    HeadlessRenderBackend(const HeadlessRenderBackend&) = delete;
+    HeadlessRenderBackend& operator=(const HeadlessRenderBackend&) = delete;
+
+    // Reallocates and clears to transparent black
+    void Resize(int width, int height);
+    int GetWidth() const { return m_width; }
+    int GetHeight() const { return m_height; }
+    const uint32_t* GetPixels() const { return m_pixels.data(); }     // stride == GetWidth()
+    uint32_t* GetPixels() { return m_pixels.data(); }
+
+    bool EncodePNG(std::vector<uint8_t>& png) const;
+    bool SavePNG(const std::wstring& path) const;
+
+    // Replaces the glyph source and drops every cached glyph; null restores the default
+    void SetFontRasterizer(FontRasterizer rasterizer);
+    const GlyphAtlas& GetGlyphAtlas() const { return m_glyphs; }
+
+    // Renders count images of width x height on the JobScheduler pool. Each
+    // chunk of indices gets one backend, cleared before every render. The
+    // callback runs concurrently and must not share unsynchronized state
+    // (one TextureAtlas per thread, for instance).
+    static void RenderParallel(size_t count, int width, int height,
+                               const std::function<void(size_t index, HeadlessRenderBackend& backend)>& render);
+
+    // No window; the handle is ignored
+    bool Initialize(HWND hwnd) override;
+    void Shutdown() override;
+
+    bool BeginDraw() override;
+    void EndDraw() override;
+    void Clear(Color color) override;
+
+    HDC GetDC() const override { return nullptr; }
+    void* GetNativeContext() const override;    // The pixel buffer
+
+    // A memory DC over a copy of the buffer; pixels GDI changed come back opaque
+    HDC BeginGDIInterop() override;
+    void EndGDIInterop(HDC hdc) override;
+
+    void DrawRectangle(const RECT& rect, Color fillColor, Color borderColor, float borderWidth) override;
+    void DrawRoundedRectangle(const RECT& rect, float radius, Color fillColor, Color borderColor, float borderWidth) override;
+    void DrawLine(int x1, int y1, int x2, int y2, Color color, float width) override;
+    void DrawEllipse(int cx, int cy, int rx, int ry, Color fillColor, Color borderColor, float borderWidth) override;
+
+    void DrawText(const std::wstring& text, const RECT& rect, Color color, const std::wstring& fontFamily, float fontSize, int fontWeight) override;
+    void DrawTextLine(const std::wstring& text, const RECT& rect, Color color, const std::wstring& fontFamily, float fontSize, int fontWeight, TextAlign align) override;
+    int MeasureText(const std::wstring& text, const std::wstring& fontFamily, float fontSize, int fontWeight) override;
+
+    void DrawParticleBatch(const float* x, const float* y, const uint32_t* colors, size_t count, int size) override;
+    void DrawAtlasTexture(const TextureAtlas& atlas, const std::string& name, const RECT& dest) override;
+
+    void DrawLinearGradient(const RECT& rect, Color startColor, Color endColor, bool horizontal) override;
+    void DrawRadialGradient(const RECT& rect, Color centerColor, Color edgeColor, int cx, int cy) override;
+
+    void DrawShadow(const RECT& rect, int offsetX, int offsetY, int blur, Color shadowColor) override;
+    void DrawGlow(const RECT& rect, int radius, Color glowColor) override;
+
+    bool SupportsGPUEffects() const override { return false; }
+    void ApplyBlur(const RECT& rect, int blurRadius) override;
+    void ApplyBloom(const RECT& rect, float threshold, float intensity) override;
+    void ApplyDepthOfField(const RECT& rect, int focalDepth, int blurAmount, float focalRange) override;
+    void ApplyMotionBlur(const RECT& rect, int directionX, int directionY, float intensity) override;
+    void ApplyChromaticAberration(const RECT& rect, float strength, int offsetX, int offsetY) override;
+    void ApplyEffectGraph(const RECT& rect, EffectGraph& graph) override;
+
+    BackendType GetType() const override { return BackendType::HEADLESS; }
+    bool IsHardwareAccelerated() const override { return false; }
+    Capabilities GetCapabilities() const override;
+
+private:
+    struct FontKey {
+        std::wstring family;
+        int pixelSize;
+        int weight;
+        int ascent;
+        int descent;
+    };
+    struct GdiSurface;
+
+    // The part of rect inside the buffer; false when empty
+    bool Clip(const RECT& rect, RECT& clipped) const;
+    template<typename Fn>
+    void WithPixels(const RECT& rect, Fn&& kernel);
+    template<typename Distance>
+    void FillShape(const RECT& bounds, Distance&& distance, Color fillColor, Color borderColor, float borderWidth);
+
+    const FontKey* GetFont(const std::wstring& fontFamily, float fontSize, int fontWeight, uint32_t& id);
+    void DrawRun(const GlyphAtlas::Run& run, int x, int baseline, Color color);
+    bool Rasterize(uint32_t font, uint32_t codepoint, GlyphAtlas::Bitmap& bitmap);
+    HDC GetGlyphDC();   // Null without GDI
+
+    int m_width;
+    int m_height;
+    std::vector<uint32_t> m_pixels;
+
+    FontRasterizer m_rasterizer;
+    std::vector<FontKey> m_fonts;               // Index is the GlyphAtlas font id
+    std::unordered_map<std::wstring, uint32_t> m_fontIds;
+    std::wstring m_fontKey;                     // Reused for lookups
+    GlyphAtlas m_glyphs;
+
+    std::unique_ptr<GdiSurface> m_gdi;          // Windows only
+};
+
+} // namespace SDK
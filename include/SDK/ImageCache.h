@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Platform.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace SDK {
+
+/**
+ * ImageCache - Decoded images shared by file and display size
+ * Get() returns at once. A file not cached yet is decoded on a JobScheduler
+ * worker: through WIC on Windows, elsewhere by a small built-in decoder for
+ * BMP and binary PPM/PGM. An image asked for at another size is scaled from
+ * the decoded original, also on a worker, so drawing never stretches. Every
+ * widget showing a file at one size shares one entry; least recently used
+ * entries are dropped past the byte capacity, surviving until their last
+ * handle goes. Widgets poll GetState() from Update() while an entry loads.
+ */
+class ImageCache {
+public:
+    enum class State {
+        LOADING,
+        READY,
+        FAILED
+    };
+
+    class Entry {
+    public:
+        Entry(const std::wstring& path, int width, int height);
+        ~Entry();
+        Entry(const Entry&) = delete;
+        Entry& operator=(const Entry&) = delete;
+
+        State GetState() const { return m_state.load(std::memory_order_acquire); }
+        const std::wstring& GetPath() const { return m_path; }
+
+        // Valid once ready: premultiplied 0xAARRGGBB, rows top-down
+        int GetWidth() const { return m_width; }
+        int GetHeight() const { return m_height; }
+        const uint32_t* GetPixels() const { return m_pixels.data(); }
+        bool IsOpaque() const { return m_opaque; }
+
+        // Draws the pixels into dest, stretching when the sizes differ. The
+        // GDI surface is made on first draw; UI thread only.
+        bool Draw(HDC hdc, const RECT& dest) const;
+
+    private:
+        friend class ImageCache;
+
+        std::wstring m_path;
+        std::atomic<State> m_state;
+        int m_width;            // As requested until ready; 0 x 0 is the file's own size
+        int m_height;
+        bool m_scaled;
+        std::vector<uint32_t> m_pixels;
+        bool m_opaque;
+        std::vector<std::shared_ptr<Entry>> m_waiting;     // Sizes to scale once decoded
+#if SDK_PLATFORM_WINDOWS
+        mutable HDC m_dc;
+        mutable HBITMAP m_bitmap;
+#endif
+    };
+    using EntryPtr = std::shared_ptr<const Entry>;
+
+    // The image at path scaled to width x height; 0 x 0 keeps its own size
+    static EntryPtr Get(const std::wstring& path, int width = 0, int height = 0);
+
+    // Synchronous decode on the calling thread, into premultiplied 0xAARRGGBB
+    static bool Decode(const std::wstring& path, int& width, int& height, std::vector<uint32_t>& pixels);
+
+    // Area-averaging resample of premultiplied pixels; tightly packed rows
+    static void Scale(const uint32_t* source, int sourceWidth, int sourceHeight,
+                      uint32_t* dest, int destWidth, int destHeight);
+
+    struct Stats {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t decodes;       // Files decoded, as opposed to scaled
+        uint64_t evictions;
+        size_t size;            // Entries cached
+        size_t bytes;           // Pixel bytes of the cached entries
+    };
+    static Stats GetStats();
+    static void ResetStats();
+
+    static void SetCapacity(size_t maxBytes);   // Default: 64 MB
+    static void Clear();
+
+private:
+    ImageCache() = delete;
+
+    static void Finish(const std::shared_ptr<Entry>& entry, bool ok);
+    static void StartScale(const std::shared_ptr<Entry>& source, const std::shared_ptr<Entry>& entry);
+};
+
+} // namespace SDK
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace SDK {
+
+struct InputEvent {
+    enum class Type : uint8_t {
+        MOUSE_MOVE,
+        MOUSE_DOWN,     // value: button
+        MOUSE_UP,
+        MOUSE_WHEEL,    // value: delta
+        KEY_DOWN,       // value: virtual key code
+        KEY_UP,
+        CHAR,           // value: character
+        RESIZE,         // x, y: the new client width and height
+        CLOSE,
+        COUNT
+    };
+
+    uint32_t time;      // Milliseconds since the recording began
+    Type type;
+    uint16_t window;    // Windows numbered in the order they first had input
+    int32_t x;
+    int32_t y;
+    int32_t value;
+};
+
+/**
+ * InputTrace - Recorded input for replaying a session as a performance test
+ * While a Recording is open on a thread, the window event loops on it (Window's
+ * input handlers and WindowX11::ProcessEvents) add every event they handle,
+ * moves before coalescing. Save() writes a compact file: times and positions
+ * are stored as varint deltas, a few bytes per move. Replay() runs the trace
+ * at full speed on a fixed frame clock: each frame delivers the events due by
+ * its time, then runs the frame callback, and is timed as a whole, so two
+ * builds replaying the same file can be compared frame for frame.
+ */
+class InputTrace {
+public:
+    void Add(const InputEvent& event);
+    void Clear();
+
+    const std::vector<InputEvent>& GetEvents() const { return m_events; }
+    size_t GetWindowCount() const;
+    uint32_t GetDuration() const { return m_events.empty() ? 0 : m_events.back().time; }
+
+    void Encode(std::vector<uint8_t>& bytes) const;
+    bool Decode(const uint8_t* data, size_t size);     // False leaves the trace empty
+    bool Save(const std::wstring& path) const;
+    bool Load(const std::wstring& path);
+
+    // Adds this thread's input to trace for its lifetime. Recordings nest; the
+    // innermost one records.
+    class Recording {
+    public:
+        explicit Recording(InputTrace& trace);
+        ~Recording();
+
+        Recording(const Recording&) = delete;
+        Recording& operator=(const Recording&) = delete;
+
+    private:
+        friend class InputTrace;
+
+        InputTrace& m_trace;
+        Recording* m_previous;
+        std::chrono::steady_clock::time_point m_start;
+        std::vector<const void*> m_windows;     // Index is the event's window
+    };
+
+    // Called by the event loops; window is any pointer that identifies it.
+    // Does nothing unless a Recording is open on this thread.
+    static void Record(const void* window, InputEvent::Type type, int x = 0, int y = 0, int value = 0);
+    static bool IsRecording();
+
+    struct ReplayStats {
+        uint64_t frames;
+        uint64_t events;
+        double seconds;         // Wall time of the whole replay
+        double meanFrameMs;
+        double medianFrameMs;
+        double p95FrameMs;
+        double p99FrameMs;
+        double maxFrameMs;
+    };
+    using DispatchFn = std::function<void(const InputEvent& event)>;
+    // time: seconds since the first frame on the fixed clock
+    using FrameFn = std::function<void(double time, float deltaTime)>;
+
+    // One frame per 1 / frameRate of trace time, through the last event
+    ReplayStats Replay(const DispatchFn& dispatch, const FrameFn& frame, double frameRate = 60.0) const;
+
+private:
+    std::vector<InputEvent> m_events;
+};
+
+} // namespace SDK
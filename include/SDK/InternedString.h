@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+namespace SDK {
+
+/**
+ * InternedString - Handle to one shared copy of a string
+ * Equal strings intern to the same pooled copy, so the handle is a pointer:
+ * copies and comparisons cost nothing, and a thousand widgets set to
+ * "Segoe UI" store the family once. Pooled strings live until the process
+ * exits; intern identifiers such as font families and widget names, not
+ * text that keeps changing.
+ */
+class InternedString {
+public:
+    InternedString() : m_string(&GetEmpty()) {}
+    InternedString(const std::wstring& text) : m_string(Intern(text)) {}
+    InternedString(const wchar_t* text) : m_string(Intern(text ? text : L"")) {}
+
+    const std::wstring& str() const { return *m_string; }
+    operator const std::wstring&() const { return *m_string; }
+    bool empty() const { return m_string->empty(); }
+
+    bool operator==(const InternedString& other) const { return m_string == other.m_string; }
+    bool operator!=(const InternedString& other) const { return m_string != other.m_string; }
+
+    // Handle of text if it is already pooled; lookups by name use it so a
+    // miss doesn't grow the pool
+    static bool Find(const std::wstring& text, InternedString& result);
+
+    // Distinct strings in the pool
+    static size_t GetPoolSize();
+
+private:
+    static const std::wstring& GetEmpty();
+    static const std::wstring* Intern(const std::wstring& text);
+
+    const std::wstring* m_string;
+
+    friend struct std::hash<InternedString>;
+};
+
+} // namespace SDK
+
+namespace std {
+template<>
+struct hash<SDK::InternedString> {
+    size_t operator()(const SDK::InternedString& s) const { return std::hash<const void*>()(s.m_string); }
+};
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace SDK {
+
+struct JobGroupState;
+
+/**
+ * JobScheduler - Shared work-stealing pool for CPU-bound SDK work
+ * Each worker keeps its own deque: it runs its newest task first and idle
+ * workers steal the oldest tasks of busy ones. Tasks submitted from outside
+ * the pool go through a shared queue. Waiting inside the pool (TaskGroup::Wait,
+ * ParallelFor, TaskGraph::Run) runs other queued tasks instead of blocking,
+ * so tasks may wait on work they spawn. Blocking I/O doesn't belong here;
+ * DirectoryLoader keeps its own threads for that.
+ */
+class JobScheduler {
+public:
+    using Task = std::function<void()>;
+
+    // Per-task timing, reported after the task finishes
+    struct TaskProfile {
+        const char* name;   // As passed on submission; never null
+        int worker;         // Worker index, or -1 for a thread outside the pool
+        std::chrono::steady_clock::time_point start;
+        std::chrono::steady_clock::time_point end;
+    };
+    using ProfileHook = std::function<void(const TaskProfile&)>;
+
+    // Tasks that can be waited on together
+    class TaskGroup {
+    public:
+        TaskGroup();
+        ~TaskGroup();   // Waits
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+        void Run(Task task, const char* name = nullptr);
+        void Wait();
+        bool IsDone() const;
+
+    private:
+        std::shared_ptr<JobGroupState> m_state;
+    };
+
+    // Tasks with ordering constraints. Run() starts every task whose
+    // dependencies are done and waits until all of them have run.
+    class TaskGraph {
+    public:
+        int AddTask(Task task, const char* name = nullptr);
+        void AddDependency(int before, int after);
+
+        // False, without running anything, when the dependencies form a cycle
+        bool Run();
+
+        void Clear() { m_nodes.clear(); }
+        size_t GetTaskCount() const { return m_nodes.size(); }
+
+    private:
+        struct Node {
+            Task task;
+            const char* name;
+            std::vector<int> dependents;
+            int dependencies;
+        };
+        std::vector<Node> m_nodes;
+    };
+
+    // Fire and forget
+    static void Submit(Task task, const char* name = nullptr);
+
+    // Result through a future. Don't block on it from inside a task; a
+    // TaskGroup waits without holding up a worker.
+    template<typename Fn>
+    static auto Async(Fn fn, const char* name = nullptr) -> std::future<decltype(fn())> {
+        using Result = decltype(fn());
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::move(fn));
+        std::future<Result> future = task->get_future();
+        Submit([task]() { (*task)(); }, name);
+        return future;
+    }
+
+    // Calls fn(begin, end) for consecutive chunks of grain indices covering
+    // [0, count) and returns when all have run. The caller runs chunks too.
+    static void ParallelFor(int count, int grain, const std::function<void(int begin, int end)>& fn,
+                            const char* name = nullptr);
+
+    // Workers to start; 0 runs every task inline on the submitting thread.
+    // Takes effect when the pool next starts. Defaults to one less than the
+    // number of hardware threads.
+    static void SetWorkerCount(unsigned count);
+    static unsigned GetWorkerCount();
+
+    // Index of the calling worker, or -1 outside the pool
+    static int GetCurrentWorkerIndex();
+
+    // Called on the thread that ran the task; pass nullptr to remove
+    static void SetProfileHook(ProfileHook hook);
+
+    // Runs what is queued, then joins the workers; the next task restarts the pool.
+    // Callers must not submit or wait concurrently with Shutdown().
+    static void Shutdown();
+
+private:
+    JobScheduler() = delete;
+};
+
+} // namespace SDK
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Widget.h"
+#include "Renderer.h"
+#include <unordered_map>
+
+namespace SDK {
+
+/**
+ * LayerCompositor - Draws animated widgets from retained layer surfaces
+ * A widget with a layer (Widget::HasLayer) is rasterized once into a
+ * premultiplied 32-bit surface covering its layer bounds. Later frames only
+ * AlphaBlend that surface with the widget's opacity and layer scale, and it
+ * is rasterized again only when the widget's content version or layer size
+ * changes. Per-pixel alpha comes from rendering the widget over black and
+ * over white: the difference is the coverage, the black pass the color.
+ */
+class LayerCompositor {
+public:
+    struct Stats {
+        int composited;     // Layers blended into the target
+        int rasterized;     // Of those, layers drawn again first
+
+        Stats() : composited(0), rasterized(0) {}
+    };
+
+    LayerCompositor() = default;
+    ~LayerCompositor();
+
+    LayerCompositor(const LayerCompositor&) = delete;
+    LayerCompositor& operator=(const LayerCompositor&) = delete;
+
+    // Draws widget through its layer. Returns false when it has none or the
+    // surface can't be created; the caller then renders the widget directly.
+    // A layer left from a widget that is no longer animated is released.
+    bool Composite(HDC hdc, Widget& widget, Stats& stats);
+
+    bool HasLayers() const { return !m_layers.empty(); }
+    // Rasterize every layer again on its next composite
+    void InvalidateAll();
+    void RemoveWidget(const Widget* widget);
+    void Clear();
+
+private:
+    struct Layer {
+        Renderer::PixelSurface surface;
+        uint32_t version;   // Widget content version when rasterized
+        bool valid;
+
+        Layer() : version(0), valid(false) {}
+    };
+
+    bool Rasterize(Widget& widget, Layer& layer, const RECT& bounds);
+    static void Release(Layer& layer);
+
+    std::unordered_map<const Widget*, Layer> m_layers;
+};
+
+} // namespace SDK
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Widget.h"
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -8,6 +9,10 @@ namespace SDK {
 
 /**
  * Layout - Base class for automatic widget layout
+ * Apply() is a measure pass followed by an arrange pass. The measure pass
+ * reads each widget's size and layout dirty flag; when those, the widget list,
+ * the layout settings and the parts of the bounds the layout reads all match
+ * the last call, the arrange pass is skipped and no widget is touched.
  */
 class Layout {
 public:
@@ -27,7 +32,7 @@ public:
     virtual LayoutType GetType() const = 0;
     
     // Spacing configuration
-    void SetSpacing(int spacing) { m_spacing = spacing; }
+    void SetSpacing(int spacing) { if (m_spacing != spacing) { m_spacing = spacing; Invalidate(); } }
     int GetSpacing() const { return m_spacing; }
     
     void SetPadding(int left, int top, int right, int bottom) {
@@ -35,14 +40,54 @@ public:
         m_paddingTop = top;
         m_paddingRight = right;
         m_paddingBottom = bottom;
+        Invalidate();
     }
     
+    // Forces the next Apply() to arrange
+    void Invalidate() { m_dirty = true; ++m_revision; }
+    bool IsDirty() const { return m_dirty; }
+    
+    // Changes whenever a setting does, or on Invalidate()
+    uint64_t GetRevision() const { return m_revision; }
+    
+    // Whether the arrangement depends on the widgets' sizes, not just their count
+    virtual bool ReadsWidgetSizes() const { return true; }
+    
+    // Takes the widgets' current bounds as this layout's result, so changes
+    // made after Apply() (e.g. by a constraint pass) don't force a re-arrange
+    void Commit(const std::vector<std::shared_ptr<Widget>>& widgets);
+    
+    // Arrange passes run, as opposed to Apply() calls
+    uint64_t GetArrangeCount() const { return m_arrangeCount; }
+    
 protected:
+    struct DesiredSize {
+        int width, height;
+    };
+    
+    // Measure pass: refreshes m_desired and returns true when an arrange is due
+    bool Measure(const RECT& bounds, const std::vector<std::shared_ptr<Widget>>& widgets);
+    // End of the arrange pass: records the result and clears the dirty flags
+    void EndArrange(const std::vector<std::shared_ptr<Widget>>& widgets);
+    
+    // The parts of the bounds the arrange pass reads; edges it ignores are zeroed
+    virtual RECT GetConstraintBounds(const RECT& bounds) const { return bounds; }
+    
+    std::vector<DesiredSize> m_desired;     // Widget sizes at the last measure
+    
     int m_spacing = 5;
     int m_paddingLeft = 10;
     int m_paddingTop = 10;
     int m_paddingRight = 10;
     int m_paddingBottom = 10;
+    
+private:
+    bool m_dirty = true;
+    uint64_t m_revision = 0;
+    RECT m_constraints = {};
+    std::vector<Widget*> m_arrangedWidgets;
+    std::vector<RECT> m_arrangedBounds;     // Widget bounds the last arrange left
+    uint64_t m_arrangeCount = 0;
 };
 
 /**
@@ -57,16 +102,18 @@ public:
     LayoutType GetType() const override { return LayoutType::GRID; }
     
     // Grid configuration
-    void SetColumns(int columns) { m_columns = columns; }
+    void SetColumns(int columns) { if (m_columns != columns) { m_columns = columns; Invalidate(); } }
     int GetColumns() const { return m_columns; }
     
-    void SetRows(int rows) { m_rows = rows; }
+    void SetRows(int rows) { if (m_rows != rows) { m_rows = rows; Invalidate(); } }
     int GetRows() const { return m_rows; }
     
     // Cell sizing
-    void SetUniformCellSize(bool uniform) { m_uniformCellSize = uniform; }
+    void SetUniformCellSize(bool uniform) { if (m_uniformCellSize != uniform) { m_uniformCellSize = uniform; Invalidate(); } }
     bool IsUniformCellSize() const { return m_uniformCellSize; }
     
+    bool ReadsWidgetSizes() const override { return !m_uniformCellSize; }
+    
 private:
     int m_columns;
     int m_rows;
@@ -92,10 +139,10 @@ public:
     LayoutType GetType() const override { return LayoutType::FLOW; }
     
     // Flow configuration
-    void SetDirection(Direction direction) { m_direction = direction; }
+    void SetDirection(Direction direction) { if (m_direction != direction) { m_direction = direction; Invalidate(); } }
     Direction GetDirection() const { return m_direction; }
     
-    void SetWrap(bool wrap) { m_wrap = wrap; }
+    void SetWrap(bool wrap) { if (m_wrap != wrap) { m_wrap = wrap; Invalidate(); } }
     bool IsWrap() const { return m_wrap; }
     
     // Alignment
@@ -106,9 +153,12 @@ public:
         STRETCH
     };
     
-    void SetAlignment(Alignment alignment) { m_alignment = alignment; }
+    void SetAlignment(Alignment alignment) { if (m_alignment != alignment) { m_alignment = alignment; Invalidate(); } }
     Alignment GetAlignment() const { return m_alignment; }
     
+protected:
+    RECT GetConstraintBounds(const RECT& bounds) const override;
+    
 private:
     Direction m_direction;
     bool m_wrap;
@@ -132,7 +182,7 @@ public:
     LayoutType GetType() const override { return LayoutType::STACK; }
     
     // Stack configuration
-    void SetOrientation(Orientation orientation) { m_orientation = orientation; }
+    void SetOrientation(Orientation orientation) { if (m_orientation != orientation) { m_orientation = orientation; Invalidate(); } }
     Orientation GetOrientation() const { return m_orientation; }
     
     // Distribution
@@ -145,9 +195,12 @@ public:
         SPACE_EVENLY    // Equal space including edges
     };
     
-    void SetDistribution(Distribution distribution) { m_distribution = distribution; }
+    void SetDistribution(Distribution distribution) { if (m_distribution != distribution) { m_distribution = distribution; Invalidate(); } }
     Distribution GetDistribution() const { return m_distribution; }
     
+protected:
+    RECT GetConstraintBounds(const RECT& bounds) const override;
+    
 private:
     Orientation m_orientation;
     Distribution m_distribution;
@@ -181,14 +234,22 @@ public:
                      int constant = 0)
         : m_widget1(widget1), m_attr1(attr1), m_type(type),
           m_widget2(widget2), m_attr2(attr2), m_constant(constant),
-          m_priority(1000) {}
+          m_priority(1000), m_containerRelative(false) {}
     
     // Constraint to container bounds
     LayoutConstraint(std::shared_ptr<Widget> widget, Attribute attr,
                      Type type, int value)
         : m_widget1(widget), m_attr1(attr), m_type(type),
           m_widget2(nullptr), m_attr2(Attribute::LEFT), m_constant(value),
-          m_priority(1000) {}
+          m_priority(1000), m_containerRelative(false) {}
+    
+    // Constraint to an edge or size of the bounds passed to Solve(), so it
+    // follows the container when it resizes
+    LayoutConstraint(std::shared_ptr<Widget> widget, Attribute attr,
+                     Type type, Attribute containerAttr, int constant = 0)
+        : m_widget1(widget), m_attr1(attr), m_type(type),
+          m_widget2(nullptr), m_attr2(containerAttr), m_constant(constant),
+          m_priority(1000), m_containerRelative(true) {}
     
     std::shared_ptr<Widget> GetWidget1() const { return m_widget1; }
     Attribute GetAttribute1() const { return m_attr1; }
@@ -196,6 +257,7 @@ public:
     std::shared_ptr<Widget> GetWidget2() const { return m_widget2; }
     Attribute GetAttribute2() const { return m_attr2; }
     int GetConstant() const { return m_constant; }
+    bool IsContainerRelative() const { return m_containerRelative; }
     
     void SetPriority(int priority) { m_priority = priority; }
     int GetPriority() const { return m_priority; }
@@ -207,17 +269,33 @@ private:
     std::shared_ptr<Widget> m_widget2;
     Attribute m_attr2;
     int m_constant;
-    int m_priority;  // Higher priority constraints are satisfied first
+    int m_priority;  // Higher priority constraints are satisfied first; 1000 and up is required
+    bool m_containerRelative;
 };
 
 /**
- * LayoutConstraintSolver - Solves layout constraints using iterative relaxation
+ * LayoutConstraintSolver - Solves layout constraints
+ * RELAXATION nudges widgets toward each constraint in turn, with damping,
+ * until the error is under the tolerance or maxIterations runs out.
+ * SIMPLEX keeps an incremental Cassowary tableau (SimplexSolver): priority
+ * 1000 and up is required and holds exactly, lower priorities give way in
+ * order, and widget bounds the constraints leave free stay where they are.
+ * The container edges and any widget edit variables are suggested values, so
+ * a resize or drag re-solves with a few pivots rather than from scratch.
  */
 class LayoutConstraintSolver {
 public:
+    enum class Mode {
+        RELAXATION,
+        SIMPLEX
+    };
+    
     LayoutConstraintSolver();
     ~LayoutConstraintSolver();
     
+    void SetMode(Mode mode);
+    Mode GetMode() const { return m_mode; }
+    
     // Add constraint to the solver
     void AddConstraint(const LayoutConstraint& constraint);
     void ClearConstraints();
@@ -226,24 +304,48 @@ public:
     bool Solve(const RECT& bounds, std::vector<std::shared_ptr<Widget>>& widgets,
                int maxIterations = 100, float tolerance = 0.1f);
     
-    // Get solver status
+    // SIMPLEX only: an attribute the application drives directly, e.g. a
+    // splitter being dragged. SuggestValue() takes effect on the next Solve().
+    bool AddEditVariable(std::shared_ptr<Widget> widget, LayoutConstraint::Attribute attr, int priority = 999);
+    bool RemoveEditVariable(std::shared_ptr<Widget> widget, LayoutConstraint::Attribute attr);
+    bool SuggestValue(std::shared_ptr<Widget> widget, LayoutConstraint::Attribute attr, int value);
+    
+    // Get solver status; in SIMPLEX mode the iteration count is simplex pivots,
+    // and it fails to converge only when required constraints conflict
     bool DidConverge() const { return m_converged; }
     int GetIterationCount() const { return m_iterations; }
     
+    // Whether Solve() reads the bounds, i.e. any constraint is container relative
+    bool DependsOnContainer() const;
+    
+    // Changes whenever the constraints, mode or edit values do
+    uint64_t GetRevision() const { return m_revision; }
+    
     // Configure solver behavior
     void SetDampingFactor(float damping) { m_dampingFactor = damping; }
     float GetDampingFactor() const { return m_dampingFactor; }
     
 private:
+    struct SimplexState;
+    
     std::vector<LayoutConstraint> m_constraints;
     bool m_converged;
     int m_iterations;
     float m_dampingFactor;  // Damping factor for convergence (0.0 to 1.0)
+    Mode m_mode;
+    uint64_t m_revision;
+    std::unique_ptr<SimplexState> m_simplex;
     
     // Helper methods
     int GetAttributeValue(std::shared_ptr<Widget> widget, LayoutConstraint::Attribute attr) const;
     void SetAttributeValue(std::shared_ptr<Widget> widget, LayoutConstraint::Attribute attr, int value);
-    float EvaluateConstraintError(const LayoutConstraint& constraint) const;
+    int GetTargetValue(const LayoutConstraint& constraint, const RECT& bounds) const;
+    float EvaluateConstraintError(const LayoutConstraint& constraint, const RECT& bounds) const;
+    
+    bool SolveRelaxation(const RECT& bounds, int maxIterations, float tolerance);
+    bool SolveSimplex(const RECT& bounds);
+    void BuildSimplex();
+    void AddSimplexConstraint(const LayoutConstraint& constraint);
 };
 
 /**
@@ -262,6 +364,10 @@ public:
     void AddConstraint(const LayoutConstraint& constraint);
     void ClearConstraints();
     
+    // Constraint solver mode and edit variables
+    void SetSolverMode(LayoutConstraintSolver::Mode mode) { m_solver.SetMode(mode); }
+    LayoutConstraintSolver& GetSolver() { return m_solver; }
+    
     // Apply layout with constraints
     void Apply(const RECT& bounds, std::vector<std::shared_ptr<Widget>>& widgets);
     
@@ -272,11 +378,71 @@ public:
     // Get suggested layout based on widget count and container size
     static std::shared_ptr<Layout> SuggestLayout(int widgetCount, int containerWidth, int containerHeight);
     
+    // Constraint solves run, as opposed to Apply() calls
+    uint64_t GetSolveCount() const { return m_solveCount; }
+    
+    // Results of recent Apply() calls with a layout, keyed by the container
+    // bounds, the layout and its revision, the constraint revision and, for
+    // layouts that read them, the widgets' sizes. A known configuration
+    // copies its result instead of arranging and solving again. Changing the
+    // widget list empties the cache, as does filling it.
+    void SetLayoutCacheCapacity(size_t capacity);     // Default: 16, 0 disables
+    void ClearLayoutCache();
+    
+    struct LayoutCacheStats {
+        uint64_t hits;
+        uint64_t misses;
+        size_t entries;
+    };
+    LayoutCacheStats GetLayoutCacheStats() const;
+    void ResetLayoutCacheStats();
+    
 private:
+    // An auto-layout suggestion: its type and column count or orientation
+    struct Suggestion {
+        Layout::LayoutType type;
+        int variant;
+    };
+    
+    struct CachedLayout {
+        RECT bounds;
+        const Layout* layout;
+        uint64_t layoutRevision;
+        uint64_t constraintRevision;
+        std::vector<int> sizes;         // Widths and heights going in, when the layout reads them
+        std::vector<RECT> result;
+    };
+    
+    static Suggestion Suggest(int widgetCount, int containerWidth, int containerHeight);
+    static std::shared_ptr<Layout> CreateLayout(const Suggestion& suggestion);
+    
+    CachedLayout* FindCachedLayout(const RECT& bounds, const Layout& layout);
+    void StoreCachedLayout(const RECT& bounds, const Layout& layout,
+                           const std::vector<std::shared_ptr<Widget>>& widgets);
+    
     std::shared_ptr<Layout> m_baseLayout;
+    // One layout object per suggestion, kept so its arrange cache and the
+    // result cache outlive a switch to another suggestion and back
+    std::vector<std::pair<Suggestion, std::shared_ptr<Layout>>> m_autoLayouts;
     LayoutConstraintSolver m_solver;
     bool m_autoLayout;
     
+    // Widget bounds after the last solve; re-solved only when they, the
+    // solver's revision or (for container relative constraints) the bounds change
+    bool m_solved;
+    uint64_t m_solvedRevision;
+    RECT m_solvedContainer;
+    std::vector<Widget*> m_solvedWidgets;
+    std::vector<RECT> m_solvedBounds;
+    uint64_t m_solveCount;
+    
+    std::vector<CachedLayout> m_layoutCache;
+    std::vector<Widget*> m_cachedWidgets;       // The list the cached results are for
+    std::vector<int> m_sizeScratch;
+    size_t m_layoutCacheCapacity;
+    uint64_t m_layoutCacheHits;
+    uint64_t m_layoutCacheMisses;
+    
     // Auto-layout heuristics
     std::shared_ptr<Layout> DetermineOptimalLayout(const RECT& bounds, 
                                                     const std::vector<std::shared_ptr<Widget>>& widgets);
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace SDK {
+
+/**
+ * MemoryRegistry - Bytes held by the SDK's caches and pools, by source
+ * Each cache or pool registers a Source that reports the bytes it holds and,
+ * when it can give memory back, trims down toward a target. Sample() reads
+ * every source, adds up sources of the same name and keeps each name's peak;
+ * a name over its budget is trimmed there. TrimAll() releases all that can be
+ * released, as Window::HandleLowMemory() does. Peaks are as seen by samples.
+ * Callbacks run on the thread calling Sample() or Trim*(), so sources owned
+ * by the UI thread should be sampled from it, as PerformanceHUD does.
+ */
+class MemoryRegistry {
+public:
+    using BytesFn = std::function<size_t()>;
+    // Frees what it can while staying at or above targetBytes; 0 frees all it can
+    using TrimFn = std::function<void(size_t targetBytes)>;
+
+    // Registered for its lifetime. Owners that capture this in the callbacks
+    // must not be copied or moved.
+    class Source {
+    public:
+        Source() : m_id(0) {}
+        // name must be a string literal or otherwise outlive the source
+        Source(const char* name, BytesFn bytes, TrimFn trim = nullptr);
+        ~Source() { Reset(); }
+
+        Source(const Source&) = delete;
+        Source& operator=(const Source&) = delete;
+
+        void Reset();
+        bool IsRegistered() const { return m_id != 0; }
+
+    private:
+        uint64_t m_id;
+    };
+
+    struct Usage {
+        const char* name;
+        size_t bytes;       // All sources of the name, at the last sample
+        size_t peak;
+        size_t budget;      // 0 when unlimited
+        size_t sources;
+        uint64_t trims;     // Trims for going over budget or TrimAll()
+    };
+
+    // Reads every source and trims the names over budget; largest first
+    static std::vector<Usage> Sample();
+    static size_t GetTotalBytes();  // As of the last sample
+    static size_t GetTotalPeak();
+
+    // Budgets apply to the sum of a name's sources; 0 removes the budget
+    static void SetBudget(const char* name, size_t bytes);
+    static size_t GetBudget(const char* name);
+
+    // Trims every source of name toward targetBytes between them
+    static void Trim(const char* name, size_t targetBytes);
+    static void TrimAll();
+
+    static void ResetPeaks();
+
+private:
+    MemoryRegistry() = delete;
+};
+
+} // namespace SDK
@@ -6,6 +6,7 @@
 #include <vector>
 #include <memory>
 #include <functional>
+#include <cstdint>
 
 namespace SDK {
 
@@ -29,7 +30,7 @@ public:
     void SetText(const std::wstring& text) { m_text = text; }
     std::wstring GetText() const { return m_text; }
     
-    void SetType(Type type) { m_type = type; }
+    void SetType(Type type);
     Type GetType() const { return m_type; }
     
     void SetEnabled(bool enabled) { m_enabled = enabled; }
@@ -38,7 +39,8 @@ public:
     void SetChecked(bool checked) { m_checked = checked; }
     bool IsChecked() const { return m_checked; }
     
-    void SetShortcut(const std::wstring& shortcut) { m_shortcut = shortcut; }
+    // Display text such as L"Ctrl+Shift+S", also parsed into an accelerator
+    void SetShortcut(const std::wstring& shortcut);
     std::wstring GetShortcut() const { return m_shortcut; }
     
     void SetIcon(HICON icon) { m_icon = icon; }
@@ -54,6 +56,11 @@ public:
     void SetOnClick(std::function<void()> callback) { m_onClick = callback; }
     void Click();
     
+    // Bumped by any change that can alter an accelerator table: a shortcut,
+    // a type or an item list. Items edited through GetSubMenuItems() or
+    // Menu::GetItems() need AcceleratorTable::Invalidate() instead.
+    static uint64_t GetRevision();
+    
 private:
     std::wstring m_text;
     Type m_type;
@@ -84,7 +91,7 @@ public:
     
     // Widget overrides
     void Render(HDC hdc) override;
-    void HandleEvent(WidgetEvent event, void* data) override;
+    void HandleEvent(WidgetEvent event, void* data);
     
     // Menu appearance
     void SetItemHeight(int height) { m_itemHeight = height; }
@@ -123,7 +130,7 @@ public:
     
     // Widget overrides
     void Render(HDC hdc) override;
-    void HandleEvent(WidgetEvent event, void* data) override;
+    void HandleEvent(WidgetEvent event, void* data);
     
 private:
     bool m_visible;
@@ -145,7 +152,7 @@ public:
     
     // Widget overrides
     void Render(HDC hdc) override;
-    void HandleEvent(WidgetEvent event, void* data) override;
+    void HandleEvent(WidgetEvent event, void* data);
     
     // Appearance
     void SetMenuHeight(int height) { m_menuHeight = height; }
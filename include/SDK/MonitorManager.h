@@ -3,6 +3,7 @@
 #include "Platform.h"
 #include "Theme.h"
 #include "DPIManager.h"
+#include "MonitorTopology.h"
 #include <vector>
 #include <memory>
 #include <unordered_map>
@@ -57,11 +58,16 @@ struct MonitorInfo {
 
 /**
  * MonitorManager - Multi-monitor management for the SDK
- * Handles monitor enumeration, tracking, and monitor-specific settings
+ * Handles monitor enumeration, tracking, and monitor-specific settings.
+ * Lookups by handle, point, rect or window go through a MonitorTopology
+ * rebuilt on every refresh, so they don't query the system per call; call
+ * HandleDisplayChange() on WM_DISPLAYCHANGE to keep it current.
  */
 class MonitorManager {
 public:
+    // Enumerates the monitors on the first call, and the first after Shutdown()
     static MonitorManager& GetInstance();
+    static bool IsStarted();    // Enumerated and not shut down; doesn't enumerate
     
     // Initialize monitor management
     bool Initialize();
@@ -69,8 +75,10 @@ public:
     
     // Monitor enumeration
     void RefreshMonitors();
+    void HandleDisplayChange();     // WM_DISPLAYCHANGE, or WM_SETTINGCHANGE for SPI_SETWORKAREA
     const std::vector<MonitorInfo>& GetMonitors() const { return m_monitors; }
     int GetMonitorCount() const { return static_cast<int>(m_monitors.size()); }
+    const MonitorTopology& GetTopology() const { return m_topology; }
     
     // Get monitor by various criteria
     const MonitorInfo* GetMonitor(HMONITOR hMonitor) const;
@@ -126,6 +134,7 @@ private:
     MonitorManager(const MonitorManager&) = delete;
     MonitorManager& operator=(const MonitorManager&) = delete;
     
+    static MonitorManager& GetStorage();    // The instance, as it is
     void EnumerateMonitors();
     void GatherMonitorDetails(MonitorInfo& info);
     void NotifyMonitorChange(HWND hwnd, HMONITOR oldMonitor, HMONITOR newMonitor);
@@ -134,6 +143,7 @@ private:
     
     bool m_initialized;
     std::vector<MonitorInfo> m_monitors;
+    MonitorTopology m_topology;     // Same order as m_monitors
     
     // Monitor-specific themes
     std::unordered_map<HMONITOR, std::shared_ptr<Theme>> m_monitorThemes;
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Platform.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace SDK {
+
+/**
+ * MonitorTopology - Monitor layout indexed for point and rect lookups
+ * Built once from the monitors' bounds and rebuilt only when the display
+ * configuration changes. The virtual screen is cut into vertical slabs at
+ * every monitor's left and right edge; each slab lists the monitors crossing
+ * it from top to bottom. A point is found with a binary search over the slabs
+ * and another within its slab, without calling into the system. Like
+ * MONITOR_DEFAULTTONEAREST, queries outside every monitor return the nearest.
+ */
+class MonitorTopology {
+public:
+    struct Monitor {
+        HMONITOR handle;
+        RECT bounds;
+        RECT workArea;
+        UINT dpi;
+    };
+
+    static constexpr int NOT_FOUND = -1;
+
+    MonitorTopology();
+
+    void Build(const std::vector<Monitor>& monitors);
+    void Clear();
+
+    bool IsEmpty() const { return m_monitors.empty(); }
+    size_t GetCount() const { return m_monitors.size(); }
+    const std::vector<Monitor>& GetMonitors() const { return m_monitors; }
+    const Monitor* Get(int index) const { return index >= 0 ? &m_monitors[index] : nullptr; }
+
+    // Indices into GetMonitors(), in the order given to Build()
+    int FromPoint(const POINT& pt) const;
+    int FromRect(const RECT& rect) const;       // Largest overlap
+    int FromHandle(HMONITOR handle) const;      // NOT_FOUND when unknown
+
+    RECT GetVirtualBounds() const { return m_virtualBounds; }
+    uint32_t GetVersion() const { return m_version; }     // Bumped by every Build()
+
+private:
+    int Nearest(const RECT& rect) const;
+    int SlabAt(int x) const;
+
+    std::vector<Monitor> m_monitors;
+    std::vector<int> m_slabEdges;               // Sorted; slab i spans [edges[i], edges[i + 1])
+    std::vector<uint32_t> m_slabStart;          // Per slab plus one, into m_slabMonitors
+    std::vector<uint32_t> m_slabMonitors;       // Per slab, sorted by top
+    std::vector<std::pair<HMONITOR, uint32_t>> m_handles;   // Sorted by handle
+    RECT m_virtualBounds;
+    uint32_t m_version;
+};
+
+} // namespace SDK
@@ -1,15 +1,22 @@
 #pragma once
 
+#include "MemoryRegistry.h"
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <map>
 #include <memory>
+#include <new>
 #include <functional>
 #include <cmath>
 #include <random>
 
 namespace SDK {
 
+class SharedAssetCache;
+
 /**
  * Simple Neural Network implementation with no external dependencies
  * Designed to interpret natural language prompts for GUI creation
@@ -20,6 +27,13 @@ namespace SDK {
  * - Pre-trained on project documentation
  * - Classifies intents (create window, add button, set callback, etc.)
  * - Extracts entities (dimensions, widget types, event types)
+ * - Flat, aligned weight matrices with SIMD (SSE2/AVX2/NEON) kernels
+ *   selected at runtime, and batched inference over many prompts
+ * - Versioned binary model files, and one shared read-only model per process
+ * - Open-addressed word tables and a tokenizer that yields views into one
+ *   buffer, so parsing a prompt doesn't allocate per token
+ * - Optional int8 inference with per-row weight scales and int32 accumulation
+ * - Embeddings, weights and int8 copies reported to MemoryRegistry
  */
 class NeuralNetwork {
 public:
@@ -104,68 +118,277 @@ public:
         int GetCount() const;
     };
     
+    // Mini-batch training settings
+    struct TrainingOptions {
+        int epochs = 100;
+        int batchSize = 64;
+        float learningRate = 0.01f;
+        bool shuffle = true;            // Reshuffle the training samples every epoch
+        
+        // Fraction of the samples held out to measure validation loss; 0 trains on all.
+        // Training stops once the validation loss hasn't improved for patience epochs,
+        // and keeps the weights from the best epoch.
+        float validationSplit = 0.0f;
+        int patience = 5;
+    };
+    
+    struct EpochReport {
+        int epoch;                  // From 0
+        int samples;                // Training samples this epoch
+        float trainingLoss;         // Mean squared error per sample
+        float validationLoss;       // Mean over the held-out samples; -1 without a split
+        double seconds;
+        double samplesPerSecond;
+        bool stoppingEarly;         // Last epoch; the best epoch's weights are restored
+    };
+    using EpochCallback = std::function<void(const EpochReport&)>;
+    
+    // Arithmetic used for inference. Training always runs in float.
+    enum class Precision {
+        FLOAT32,
+        INT8        // Int8 copies of the embeddings and weights made by Quantize()
+    };
+    
+    // Float against int8 inference over the same samples, network path only
+    // (keyword matching is skipped, so every sample reaches the network)
+    struct QuantizationReport {
+        int samples;
+        float floatAccuracy;        // Fraction whose top intent matches the label
+        float int8Accuracy;
+        float agreement;            // Fraction where both paths pick the same intent
+        float meanOutputError;      // Mean |int8 - float| over every output activation
+        float maxOutputError;
+        size_t floatBytes;          // Embeddings, weights and biases
+        size_t int8Bytes;           // The same with int8 values and their scales
+    };
+    
     NeuralNetwork();
     ~NeuralNetwork() = default;
     
     // Initialize the network with pre-trained weights
     void Initialize();
     
-    // Parse a natural language prompt
-    ParsedPrompt ParsePrompt(const std::wstring& prompt);
+    // Binary model: vocabulary, embeddings, weights and keyword patterns.
+    // Float sections sit at 32-byte aligned offsets, and Load() maps the file
+    // rather than reading it. Load fails, leaving the network as it was, on a
+    // different version or architecture.
+    static constexpr uint32_t MODEL_VERSION = 1;
+    bool Save(const std::wstring& path) const;
+    bool Load(const std::wstring& path);
+    std::vector<uint8_t> Serialize() const;
+    bool Deserialize(const void* data, size_t size);
+    
+    // Process-wide model for NeuralPromptBuilder and anyone else parsing
+    // prompts. Loaded on first use from the current SharedAssetCache, else
+    // from the path given to SetSharedModelPath(), or built by Initialize()
+    // when neither has one that loads.
+    static std::shared_ptr<const NeuralNetwork> GetShared();
+    static void SetSharedModelPath(const std::wstring& path);  // Before the first GetShared()
+    // Adds the serialized model to a cache being published
+    bool ExportShared(SharedAssetCache& cache) const;
     
-    // Train the network (optional - for extending training data)
+    // Parse a natural language prompt. Const and thread-safe, so one network
+    // can serve every builder.
+    ParsedPrompt ParsePrompt(const std::wstring& prompt) const;
+    
+    // Parse many prompts; those the keywords don't settle share one batched
+    // pass through the network. Same results as ParsePrompt() on each.
+    std::vector<ParsedPrompt> ParsePrompts(const std::vector<std::wstring>& prompts) const;
+    
+    // Train the network (optional - for extending training data). Each batch's
+    // gradient is accumulated across JobScheduler's workers; the result is the
+    // same for any number of them.
     void Train(const std::vector<std::pair<std::wstring, ParsedPrompt>>& trainingData, int epochs = 100);
+    void Train(const std::vector<std::pair<std::wstring, ParsedPrompt>>& trainingData,
+               const TrainingOptions& options, EpochCallback callback = nullptr);
+    
+    // Quantize the current embeddings and weights to int8, one scale per row,
+    // and switch to Precision::INT8. Train() quantizes the trained weights
+    // again; Load() and Initialize() drop the int8 copies and return to
+    // FLOAT32. The float weights are kept for training and Save().
+    void Quantize();
+    bool SetPrecision(Precision precision);  // False for INT8 before Quantize()
+    Precision GetPrecision() const { return m_precision; }
+    
+    // Both paths over the given samples; needs Quantize() first. Without
+    // samples, uses the built-in set of every intent keyword with its intent.
+    QuantizationReport CompareQuantized(const std::vector<std::pair<std::wstring, ParsedPrompt>>& samples) const;
+    QuantizationReport CompareQuantized() const;
+    
+    // Precision of the model GetShared() builds; INT8 quantizes it once loaded
+    static void SetSharedPrecision(Precision precision);  // Before the first GetShared()
     
     // Get vocabulary size
     size_t GetVocabularySize() const { return m_vocabulary.size(); }
     
 private:
+    // Weights and batches start on a 32-byte boundary, and rows are padded to
+    // a multiple of SIMD_WIDTH floats, so no vector load splits a cache line
+    static constexpr size_t SIMD_ALIGNMENT = 32;
+    static constexpr int SIMD_WIDTH = 8;
+    
+    template <typename T>
+    struct AlignedAllocator {
+        using value_type = T;
+        
+        AlignedAllocator() = default;
+        template <typename U>
+        AlignedAllocator(const AlignedAllocator<U>&) {}
+        
+        T* allocate(size_t count) {
+            return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(SIMD_ALIGNMENT)));
+        }
+        void deallocate(T* pointer, size_t) {
+            ::operator delete(pointer, std::align_val_t(SIMD_ALIGNMENT));
+        }
+        
+        template <typename U>
+        bool operator==(const AlignedAllocator<U>&) const { return true; }
+        template <typename U>
+        bool operator!=(const AlignedAllocator<U>&) const { return false; }
+    };
+    using AlignedVector = std::vector<float, AlignedAllocator<float>>;
+    
+    static constexpr int PaddedSize(int count) { return (count + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH; }
+    
+    // Row-major rows x cols; padding columns are kept at zero
+    struct Matrix {
+        int rows = 0;
+        int cols = 0;
+        int stride = 0;
+        AlignedVector data;
+        
+        void Resize(int rowCount, int colCount);
+        float* Row(int row) { return data.data() + (size_t)row * stride; }
+        const float* Row(int row) const { return data.data() + (size_t)row * stride; }
+    };
+    
+    // Open-addressed hash table keyed by words, built once at load time.
+    // Keys live back to back in one buffer and Find() takes a view, so a
+    // lookup neither allocates nor changes the table.
+    template <typename Value>
+    class WordTable {
+    public:
+        void Clear();
+        void Insert(std::wstring_view word, Value value);  // Replaces an existing entry
+        const Value* Find(std::wstring_view word) const;
+        size_t size() const { return m_entries.size(); }
+        
+        // Visits entries in insertion order
+        template <typename Visitor>
+        void ForEach(Visitor visitor) const {
+            for (const Entry& entry : m_entries) {
+                visitor(Key(entry), entry.value);
+            }
+        }
+        
+    private:
+        struct Entry {
+            uint32_t offset;
+            uint32_t length;
+            Value value;
+        };
+        struct Slot {
+            uint32_t hash;
+            uint32_t entry;  // Index into m_entries plus one; zero when empty
+        };
+        
+        std::wstring_view Key(const Entry& entry) const { return std::wstring_view(m_keys).substr(entry.offset, entry.length); }
+        void Grow();
+        
+        std::wstring m_keys;
+        std::vector<Entry> m_entries;
+        std::vector<Slot> m_slots;  // Power-of-two size, at most half full
+    };
+    
+    // Lowercased tokens of one prompt, as views into text. Reusing a list
+    // keeps its buffers, so tokenizing in steady state doesn't allocate.
+    struct TokenList {
+        std::wstring lower;  // The whole prompt lowercased, for phrase searches
+        std::wstring text;   // Token characters back to back
+        std::vector<std::wstring_view> tokens;
+    };
+    
+    // Row-major int8 rows with one scale each: value = scales[row] * data.
+    // Rows are padded to 32 bytes with zeros.
+    struct QuantizedMatrix {
+        int rows = 0;
+        int cols = 0;
+        int stride = 0;
+        std::vector<int8_t, AlignedAllocator<int8_t>> data;
+        std::vector<float> scales;
+        
+        void Quantize(const Matrix& source);
+        const int8_t* Row(int row) const { return data.data() + (size_t)row * stride; }
+    };
+    
     // Neural network architecture
     struct Layer {
-        std::vector<std::vector<float>> weights;  // weights[neuron][input]
+        Matrix weights;  // outputs x inputs, one row per neuron
         std::vector<float> biases;
-        std::vector<float> activations;
-        std::vector<float> deltas;  // For backpropagation
     };
     
     // Network layers
     std::vector<Layer> m_layers;
     
     // Vocabulary and word embeddings
-    std::map<std::wstring, int> m_vocabulary;
-    std::vector<std::vector<float>> m_embeddings;
+    WordTable<int> m_vocabulary;
+    Matrix m_embeddings;  // One row per vocabulary index
     
     // Intent and entity patterns
-    std::map<std::wstring, Intent> m_intentKeywords;
-    std::map<std::wstring, std::wstring> m_entityPatterns;
+    WordTable<Intent> m_intentKeywords;
+    WordTable<std::wstring> m_entityPatterns;
+    
+    // Int8 copies for Precision::INT8; empty until Quantize()
+    QuantizedMatrix m_quantizedEmbeddings;
+    QuantizedMatrix m_quantizedHidden;
+    QuantizedMatrix m_quantizedOutput;
+    Precision m_precision = Precision::FLOAT32;
     
     // Network parameters
     static constexpr int EMBEDDING_DIM = 32;
     static constexpr int HIDDEN_LAYER_SIZE = 64;
     static constexpr int OUTPUT_SIZE = 22;  // Number of intent classes (expanded)
-    static constexpr float LEARNING_RATE = 0.01f;
     
     // Helper functions
     void InitializeVocabulary();
     void InitializeWeights();
     void InitializePatterns();
     
-    std::vector<std::wstring> Tokenize(const std::wstring& text);
-    std::vector<float> TextToEmbedding(const std::wstring& text);
-    std::vector<float> Forward(const std::vector<float>& input);
-    void Backward(const std::vector<float>& target);
+    static void Tokenize(const std::wstring& text, TokenList& tokens);
+    // Averaged word embeddings into EMBEDDING_DIM floats
+    void TextToEmbedding(const TokenList& tokens, float* embedding, Precision precision) const;
+    
+    // One row of output per row of input
+    void Forward(const Matrix& input, Matrix& output, Precision precision) const;
+    // input is EMBEDDING_DIM floats; hidden and output take the activations
+    void ForwardSample(const float* input, float* hidden, float* output) const;
+    // The same through the int8 layers; the activations are quantized per sample
+    void ForwardSampleInt8(const float* input, float* hidden, float* output) const;
+    void DropQuantized();
     
-    float Sigmoid(float x);
-    float SigmoidDerivative(float x);
-    float ReLU(float x);
-    float ReLUDerivative(float x);
+    // Adds the output layer's gradient over the given sample indices to
+    // weightGradient (laid out like its weights) and biasGradient, when they
+    // aren't null. Returns the samples' summed squared error.
+    float AccumulateGradient(const Matrix& inputs, const std::vector<int>& labels, const int* samples, int count,
+                             float* weightGradient, float* biasGradient) const;
     
-    Intent OutputToIntent(const std::vector<float>& output, float& confidence);
-    std::map<std::wstring, std::wstring> ExtractEntities(const std::wstring& prompt);
-    std::vector<Intent> ExtractMultipleWidgets(const std::wstring& prompt);
-    LayoutType DetermineLayout(const std::wstring& prompt);
+    static float Sigmoid(float x);
+    static float SigmoidDerivative(float x);
+    static float ReLU(float x);
+    static float ReLUDerivative(float x);
+    
+    Intent OutputToIntent(const float* output, float& confidence) const;
+    // Everything but the network; tokens is filled from prompt
+    ParsedPrompt MatchPrompt(const std::wstring& prompt, TokenList& tokens) const;
+    std::map<std::wstring, std::wstring> ExtractEntities(const std::wstring& prompt, const TokenList& tokens) const;
+    std::vector<Intent> ExtractMultipleWidgets(const TokenList& tokens) const;
+    LayoutType DetermineLayout(const TokenList& tokens) const;
+    size_t GetMemoryBytes() const;
     
     std::mt19937 m_rng;
+    
+    MemoryRegistry::Source m_memorySource;  // Last: unregisters before the rest goes
 };
 
 } // namespace SDK
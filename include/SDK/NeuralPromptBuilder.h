@@ -23,8 +23,7 @@ public:
     NeuralPromptBuilder();
     ~NeuralPromptBuilder() = default;
     
-    // Parse a prompt using neural network
-    WindowSpec ParsePrompt(const std::wstring& prompt) override;
+    // ParsePrompt() parses with the neural network, through the prompt cache
     
     // Create a complete window with widgets and callbacks from a natural language prompt
     HWND BuildFromPrompt(const std::wstring& prompt, HINSTANCE hInstance, HWND parent = nullptr) override;
@@ -42,14 +41,23 @@ public:
     // Returns a lambda that can be used with SetEventCallback
     std::function<void(Widget*, WidgetEvent, void*)> GenerateCallback(const std::wstring& prompt);
     
-    // Get the neural network instance (for training or inspection)
-    std::shared_ptr<NeuralNetwork> GetNeuralNetwork() const { return m_neuralNetwork; }
+    // Get the neural network instance (for inspection). Builders share
+    // NeuralNetwork::GetShared(), fetched on the first parse, until
+    // TrainOnData() gives one its own copy.
+    std::shared_ptr<const NeuralNetwork> GetNeuralNetwork() const;
     
-    // Train the network on custom data
+    // Train the network on custom data; clears the prompt cache
     void TrainOnData(const std::vector<std::pair<std::wstring, NeuralNetwork::ParsedPrompt>>& trainingData);
     
+protected:
+    // The network's parse is cached with the spec for BuildFromPrompt()
+    struct CachedParse : CachedPrompt {
+        NeuralNetwork::ParsedPrompt parsed;
+    };
+    std::shared_ptr<CachedPrompt> ParseCachedPrompt(const std::wstring& prompt) override;
+    
 private:
-    std::shared_ptr<NeuralNetwork> m_neuralNetwork;
+    mutable std::shared_ptr<const NeuralNetwork> m_neuralNetwork;   // Null until first needed
     
     // Convert neural network result to WindowSpec
     WindowSpec ConvertToWindowSpec(const NeuralNetwork::ParsedPrompt& parsed);
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Widget.h"
+#include "Renderer.h"
+#include "RendererOptimizer.h"
+#include "LayerCompositor.h"
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace SDK {
+
+/**
+ * OptimizedWidgetRenderer - Draws a widget list as RendererOptimizer decides
+ * Each widget is registered with the optimizer on first sight and gets a
+ * cache surface on demand. Per frame the widgets being repainted are decided
+ * in one batch: FULL_RENDER and LOD_HIGH draw normally, CACHED_RENDER blits
+ * the widget's surface (capturing it on a miss), LOD_MEDIUM and LOD_LOW draw
+ * at Widget detail levels 1 and 2. Widgets covered by opaque widgets drawn
+ * after them are skipped (Widget::CullOccluded), and animated widgets go
+ * through the LayerCompositor when one is given. Render times and cache hits
+ * are fed back to the optimizer.
+ */
+class OptimizedWidgetRenderer {
+public:
+    struct Stats {
+        int rendered;       // Drawn at full detail
+        int cached;         // Blitted from their surface
+        int simplified;     // Drawn at a reduced detail level
+        int occluded;       // Hidden under an opaque widget
+        int skipped;        // Outside every region
+        LayerCompositor::Stats layers;  // Animated widgets composited
+
+        Stats() : rendered(0), cached(0), simplified(0), occluded(0), skipped(0) {}
+    };
+
+    explicit OptimizedWidgetRenderer(std::shared_ptr<RendererOptimizer> optimizer);
+    ~OptimizedWidgetRenderer() = default;
+
+    const std::shared_ptr<RendererOptimizer>& GetOptimizer() const { return m_optimizer; }
+
+    // Draws, in order, the widgets intersecting regions. The regions must have
+    // been repainted beneath the widgets this frame, since surfaces capture the
+    // background along with the widget. view is the area the widgets are shown
+    // in, for the optimizer's screen coverage. Widgets with a layer are drawn
+    // by compositor, when given, instead of being decided by the optimizer.
+    void Render(HDC hdc, const std::vector<std::shared_ptr<Widget>>& widgets,
+                const std::vector<RECT>& regions, const RECT& view, Stats& stats,
+                LayerCompositor* compositor = nullptr);
+
+    // Content inside rect changed: surfaces overlapping it are recaptured
+    void Invalidate(const RECT& rect);
+    void InvalidateAll();
+
+    void RemoveWidget(const Widget* widget);
+    void Clear() { m_surfaces.clear(); }
+
+private:
+    struct Surface {
+        RendererOptimizer::ElementHandle handle;
+        std::unique_ptr<Renderer::RenderCache> cache;
+        RECT bounds;        // Where the cache was captured, or the last bounds seen
+        bool valid;
+    };
+
+    Surface& GetSurface(const Widget* widget);
+    bool Capture(HDC hdc, Widget& widget, Surface& surface, const std::vector<RECT>& regions);
+
+    std::shared_ptr<RendererOptimizer> m_optimizer;
+    std::unordered_map<const Widget*, Surface> m_surfaces;
+
+    // Per-frame scratch, kept to avoid reallocating
+    std::vector<size_t> m_frameWidgets;
+    std::vector<uint8_t> m_frameLayered;
+    std::vector<RendererOptimizer::ElementHandle> m_frameHandles;
+    std::vector<RendererOptimizer::RenderStrategy> m_frameStrategies;
+    std::vector<uint8_t> m_hidden;
+};
+
+} // namespace SDK
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Theme.h"
+#include "MemoryRegistry.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace SDK {
+
+/**
+ * ParticleSystem - Structure-of-arrays particles for large effects
+ * Live particles are packed at [0, GetCount()) in one array per field, so the
+ * integrate step streams through memory four particles at a time and never
+ * visits dead slots. Emit() and Kill() may be called from any thread,
+ * including JobScheduler tasks, but not during Update(). Requests go to
+ * per-thread queues that Update() merges at the end of the frame, so the
+ * arrays themselves take no lock. A burst's capacity stays reserved until a
+ * MemoryRegistry trim shrinks the arrays to the live particles.
+ */
+class ParticleSystem {
+public:
+    explicit ParticleSystem(size_t initialCapacity = 1024);
+    ParticleSystem(const ParticleSystem&) = delete;
+    ParticleSystem& operator=(const ParticleSystem&) = delete;
+
+    // Queued until the next Update()
+    void Emit(float x, float y, float vx, float vy, float life, Color color);
+    void EmitBurst(float x, float y, int count, Color color);  // Same spread as Renderer::CreateParticleEmission
+    void Kill(size_t index);                                   // Index as of the last Update()
+
+    // Integrates every live particle on JobScheduler, then frees expired and
+    // killed slots by swapping in the last live particle, then appends
+    // queued emissions
+    void Update(float deltaTime);
+
+    void Clear();
+    void Reserve(size_t capacity);
+    size_t GetCount() const { return m_x.size(); }
+
+    void SetGravity(float gravity) { m_gravity = gravity; }
+    float GetGravity() const { return m_gravity; }
+
+    // Field arrays, GetCount() entries each; colors are 0xAARRGGBB
+    const float* GetX() const { return m_x.data(); }
+    const float* GetY() const { return m_y.data(); }
+    const float* GetVelocityX() const { return m_vx.data(); }
+    const float* GetVelocityY() const { return m_vy.data(); }
+    const float* GetLife() const { return m_life.data(); }
+    const uint32_t* GetColors() const { return m_color.data(); }
+
+private:
+    struct Pending {
+        std::mutex mutex;           // Uncontended unless two threads share a slot
+        std::vector<float> x, y, vx, vy, life;
+        std::vector<uint32_t> color;
+        std::vector<uint32_t> kills;
+        uint32_t random;            // Spread for EmitBurst
+    };
+
+    Pending& GetPending();
+    void Integrate(size_t begin, size_t end, float deltaTime, std::vector<uint32_t>& expired);
+    size_t GetMemoryBytes() const;
+    void TrimMemory(size_t targetBytes);
+
+    // Live particles only; swap-remove keeps them packed
+    std::vector<float> m_x, m_y, m_vx, m_vy, m_life;
+    std::vector<uint32_t> m_color;
+    float m_gravity;
+
+    // One slot per JobScheduler worker plus one for other threads
+    std::vector<std::unique_ptr<Pending>> m_pending;
+    std::vector<std::vector<uint32_t>> m_expired;   // Per integrate chunk
+
+    MemoryRegistry::Source m_memorySource;  // Last: unregisters before the rest goes
+};
+
+} // namespace SDK
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Widget.h"
+#include "Renderer.h"
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace SDK {
+
+class ParticleSystem;
+class D2DRenderBackend;
+
+/**
+ * PerformanceHUD - Live frame and cache statistics overlay
+ * Add it to any window like another widget. Shows the frame rate, a histogram
+ * of recent frame times, the most expensive windows with their repainted
+ * pixels, GDI and USER handle counts, the font, shadow, atlas and render
+ * optimizer hit rates, and particle counts. Statistics are sampled a few times
+ * a second; between samples Render() only blits the last drawn panel, so the
+ * HUD adds next to nothing to the frames it measures.
+ */
+class PerformanceHUD : public Widget {
+public:
+    PerformanceHUD();
+    virtual ~PerformanceHUD();
+
+    // Seconds between samples
+    void SetSampleInterval(float seconds) { m_sampleInterval = seconds > 0.0f ? seconds : 0.0f; }
+    float GetSampleInterval() const { return m_sampleInterval; }
+
+    // Windows listed by render cost, most expensive first
+    void SetMaxWindows(int count) { m_maxWindows = count > 0 ? count : 0; }
+    int GetMaxWindows() const { return m_maxWindows; }
+
+    // Frame time at the top of the histogram
+    void SetHistogramScale(float seconds) { m_histogramScale = seconds > 0.0f ? seconds : 1.0f / 30.0f; }
+
+    // Sources the HUD can't find on its own; they must outlive the HUD or be removed
+    void TrackParticleSystem(const ParticleSystem* system);
+    void UntrackParticleSystem(const ParticleSystem* system);
+    void SetD2DBackend(const D2DRenderBackend* backend) { m_d2dBackend = backend; }
+
+    // Application counters, evaluated once per sample
+    using CounterSource = std::function<double()>;
+    void AddCounter(const std::wstring& label, CounterSource source);
+    void ClearCounters() { m_counters.clear(); }
+
+    void SetBackgroundColor(Color color) { m_backgroundColor = color; m_panelDirty = true; }
+    void SetTextColor(Color color) { m_textColor = color; m_panelDirty = true; }
+
+    // Takes a sample now instead of waiting for the interval
+    void Sample();
+
+    virtual void Update(float deltaTime) override;
+    virtual void Render(HDC hdc) override;
+
+private:
+    void DrawPanel();
+    void ReleasePanel();
+
+    struct Counter {
+        std::wstring label;
+        CounterSource source;
+    };
+
+    float m_sampleInterval;
+    float m_sinceSample;
+    int m_maxWindows;
+    float m_histogramScale;
+
+    std::vector<const ParticleSystem*> m_particleSystems;
+    const D2DRenderBackend* m_d2dBackend;
+    std::vector<Counter> m_counters;
+
+    Color m_backgroundColor;
+    Color m_textColor;
+
+    // Last sample
+    std::vector<std::wstring> m_lines;
+    std::vector<float> m_frameTimes;
+    std::vector<float> m_updateDeltas;      // Fallback history when the frame clock isn't running
+    float m_hudTime;        // Seconds the HUD's own sampling and rendering took per sample
+
+    // Panel drawn at the last sample
+    HDC m_panelDC;
+    HBITMAP m_panelBitmap;
+    uint32_t* m_panelPixels;
+    int m_panelWidth;
+    int m_panelHeight;
+    bool m_panelDirty;
+};
+
+} // namespace SDK
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace SDK {
+
+/**
+ * PremultipliedPixel - 0xAARRGGBB with the color channels already scaled by alpha
+ * In memory the bytes run B, G, R, A, which is DXGI_FORMAT_B8G8R8A8_UNORM with
+ * D2D1_ALPHA_MODE_PREMULTIPLIED, XRender's PictStandardARGB32 (the 32-bit ARGB
+ * visual) and an AC_SRC_ALPHA source for AlphaBlend, so premultiplied buffers
+ * go to any backend without conversion. Premultiplied colors blend with one
+ * multiply per channel and never bleed the color of transparent pixels.
+ */
+struct PremultipliedPixel {
+    // a * b / 255, rounded to nearest; exact for a, b <= 255
+    static uint32_t MulDiv255(uint32_t a, uint32_t b) {
+        uint32_t v = a * b + 128;
+        return (v + (v >> 8)) >> 8;
+    }
+
+    static uint32_t FromStraight(uint32_t argb) {
+        uint32_t a = argb >> 24;
+        return (a << 24) | (MulDiv255((argb >> 16) & 0xFF, a) << 16) |
+               (MulDiv255((argb >> 8) & 0xFF, a) << 8) | MulDiv255(argb & 0xFF, a);
+    }
+
+    // Straight channels rounded to nearest; 0 where alpha is 0
+    static uint32_t ToStraight(uint32_t pixel) {
+        uint32_t a = pixel >> 24;
+        if (a == 0) return 0;
+        uint32_t result = a << 24;
+        for (int shift = 0; shift < 24; shift += 8) {
+            uint32_t c = (((pixel >> shift) & 0xFF) * 255 + a / 2) / a;
+            result |= (c < 255 ? c : 255) << shift;
+        }
+        return result;
+    }
+
+    // Source-over: dst * (255 - src alpha) / 255 + src, saturated
+    static uint32_t Over(uint32_t dst, uint32_t src) {
+        uint32_t inv = 255 - (src >> 24);
+        uint32_t result = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            uint32_t c = ((src >> shift) & 0xFF) + MulDiv255((dst >> shift) & 0xFF, inv);
+            result |= (c < 255 ? c : 255) << shift;
+        }
+        return result;
+    }
+};
+
+/**
+ * PixelKernels - Software pixel kernels for 32-bit 0xAARRGGBB buffers
+ * Shared by Renderer (GDI DIB sections) and X11RenderBackend (XImage data).
+ * Vectorized kernels (SSE2/AVX2/NEON) are selected at runtime and produce
+ * the same output as the scalar reference kernels; 5DGUI_Bench checks that
+ * on every supported set before it times them.
+ * Large buffers are split into tiles on TileScheduler's worker pool; the
+ * output is the same for any number of workers.
+ */
+class PixelKernels {
+public:
+    enum class InstructionSet {
+        SCALAR,
+        SSE2,
+        AVX2,
+        NEON
+    };
+
+    // Runtime CPU dispatch
+    static bool IsSupported(InstructionSet set);
+    static InstructionSet GetBestInstructionSet();
+    static InstructionSet GetActiveInstructionSet();
+    static void SetInstructionSet(InstructionSet set);  // Falls back to best supported set
+    static const char* GetInstructionSetName(InstructionSet set);
+
+    // Sliding-window box blur, O(1) per pixel for any radius.
+    // All four channels are blurred; stride is in pixels.
+    static void BoxBlur(uint32_t* pixels, int width, int height, int stride, int radius, int passes = 1);
+
+    // Gaussian approximation using three box blur passes sized to match sigma
+    static void GaussianBlur(uint32_t* pixels, int width, int height, int stride, float sigma);
+
+    // Extract pixels brighter than threshold, amplify by intensity, blur and add back
+    static void Bloom(uint32_t* pixels, int width, int height, int stride, float threshold, float intensity, int radius = 5);
+
+    // Horizontal blur whose radius grows from 0 at row focalDepth to blurAmount
+    // at focalRange rows away
+    static void DepthOfField(uint32_t* pixels, int width, int height, int stride, int focalDepth, int blurAmount, float focalRange);
+
+    // Blends samples copies of the image, shifted progressively along
+    // (directionX, directionY), each at intensity / samples opacity
+    static void MotionBlur(uint32_t* pixels, int width, int height, int stride, int directionX, int directionY, float intensity, int samples = 5);
+
+    // Samples red offset by (offsetX, offsetY) * strength and blue by the opposite;
+    // the shift is truncated to whole pixels
+    static void ChromaticAberration(uint32_t* pixels, int width, int height, int stride, float strength, int offsetX, int offsetY);
+
+    // Row-range forms of the kernels above, for pipelines that run several
+    // effects band by band (EffectGraph). Each writes only rows [begin, end);
+    // source is an unmodified copy of the whole image, stride width.
+    static void DepthOfFieldRows(uint32_t* pixels, int width, int height, int stride, int begin, int end,
+                                 int focalDepth, int blurAmount, float focalRange);
+    static void MotionBlurRows(uint32_t* pixels, const uint32_t* source, int width, int height, int stride,
+                               int begin, int end, int directionX, int directionY, float intensity, int samples = 5);
+    static void ChromaticAberrationRows(uint32_t* pixels, const uint32_t* source, int width, int height, int stride,
+                                        int begin, int end, int shiftX, int shiftY);
+
+    // Bloom's bright pass over height rows: pixels brighter than threshold,
+    // amplified by intensity, else 0. bright has stride width.
+    static void ExtractBright(const uint32_t* pixels, int width, int height, int stride,
+                              float threshold, float intensity, uint32_t* bright);
+
+    // Alpha-blends a size x size square for each particle, centered on
+    // (x[i] - originX, y[i] - originY), in index order. colors are 0xAARRGGBB;
+    // alpha composites source-over too, so a cleared buffer ends up premultiplied.
+    static void SplatParticles(uint32_t* pixels, int width, int height, int stride,
+                               const float* x, const float* y, const uint32_t* colors, size_t count,
+                               int originX, int originY, int size);
+
+    // Saturating per-channel add: dst = min(255, dst + src). On premultiplied
+    // pixels this is the additive (plus) blend.
+    static void AddSaturate(uint32_t* dst, const uint32_t* src, size_t count);
+
+    // Premultiplied blends (PremultipliedPixel), all channels treated alike
+    // Source-over, with src first scaled by opacity
+    static void BlendOver(uint32_t* dst, const uint32_t* src, size_t count, uint8_t opacity = 255);
+    // Multiply blend: src * dst + src * (1 - dst alpha) + dst * (1 - src alpha)
+    static void BlendMultiply(uint32_t* dst, const uint32_t* src, size_t count);
+    // Every channel, alpha included, scaled by opacity: fades a premultiplied buffer
+    static void Scale(uint32_t* pixels, size_t count, uint8_t opacity);
+    // Straight to premultiplied and back, in place
+    static void Premultiply(uint32_t* pixels, size_t count);
+    static void Unpremultiply(uint32_t* pixels, size_t count);
+
+    // Scalar reference kernels (direct window sums, no sliding or SIMD)
+    static void BoxBlurReference(uint32_t* pixels, int width, int height, int stride, int radius, int passes = 1);
+    static void BloomReference(uint32_t* pixels, int width, int height, int stride, float threshold, float intensity, int radius = 5);
+
+private:
+    PixelKernels() = delete;
+};
+
+} // namespace SDK
@@ -57,6 +57,9 @@
     typedef void* HDC;
     typedef void* HBRUSH;
     typedef void* HPEN;
+    typedef void* HRGN;
+    typedef void* HFONT;
+    typedef void* HGDIOBJ;
     typedef unsigned long COLORREF;  // RGB color value
     typedef const wchar_t* LPCWSTR;
     typedef struct tagRECT {
@@ -75,6 +78,34 @@
     typedef long long LONGLONG;
     #define TRUE 1
     #define FALSE 0
+    #define FW_NORMAL 400
+    #define FW_BOLD 700
+    #define PS_SOLID 0
+    
+    // DrawText format flags, kept by widgets as their text alignment
+    #define DT_LEFT 0x0000
+    #define DT_CENTER 0x0001
+    #define DT_RIGHT 0x0002
+    #define DT_VCENTER 0x0004
+    #define DT_SINGLELINE 0x0020
+    
+    // Virtual key codes; WindowX11 maps keysyms to these
+    #define VK_BACK 0x08
+    #define VK_TAB 0x09
+    #define VK_RETURN 0x0D
+    #define VK_ESCAPE 0x1B
+    #define VK_SPACE 0x20
+    #define VK_PRIOR 0x21
+    #define VK_NEXT 0x22
+    #define VK_END 0x23
+    #define VK_HOME 0x24
+    #define VK_LEFT 0x25
+    #define VK_UP 0x26
+    #define VK_RIGHT 0x27
+    #define VK_DOWN 0x28
+    #define VK_DELETE 0x2E
+    #define VK_F1 0x70
+    #define VK_F2 0x71
     
     // RGB macro for Linux
     #define RGB(r,g,b) ((COLORREF)(((BYTE)(r)|((WORD)((BYTE)(g))<<8))|(((DWORD)(BYTE)(b))<<16)))
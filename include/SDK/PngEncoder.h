@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SDK {
+
+/**
+ * PngEncoder - Writes premultiplied 0xAARRGGBB buffers as 8-bit RGBA PNG files
+ * Self-contained: rows are filtered with whichever PNG filter leaves the
+ * smallest residuals, then compressed with a built-in deflate (LZ77 over
+ * hash chains, fixed Huffman codes). Files are larger than zlib's best but
+ * need no library, and the output depends only on the pixels, so snapshots
+ * of the same frame compare byte for byte. Thread-safe; keeps no state.
+ */
+class PngEncoder {
+public:
+    // stride is in pixels. Appends the file to png; false when the size is invalid.
+    static bool Encode(const uint32_t* pixels, int width, int height, int stride, std::vector<uint8_t>& png);
+    static bool Save(const std::wstring& path, const uint32_t* pixels, int width, int height, int stride);
+
+private:
+    PngEncoder() = delete;
+};
+
+} // namespace SDK
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace SDK {
+
+struct PointerSample {
+    int x;
+    int y;
+    uint32_t time;      // Milliseconds on the platform's event clock; wraps
+};
+
+/**
+ * PointerHistory - Recent pointer positions, including those never dispatched
+ * Window event loops fold a burst of queued mouse moves into one dispatch at
+ * the latest position, so widgets pay for one move per burst, not per event.
+ * Every position still lands here. While a move is dispatched, GetCoalesced()
+ * holds the positions it stands for, oldest first and ending at the dispatched
+ * one, so a widget tracing a stroke or an orbit can follow the whole path.
+ */
+class PointerHistory {
+public:
+    explicit PointerHistory(size_t capacity = 128);
+
+    void Add(const PointerSample& sample);
+    void Clear();
+
+    size_t GetCount() const { return m_count; }
+    size_t GetCapacity() const { return m_samples.size(); }
+    const PointerSample& GetSample(size_t index) const;    // 0 is the oldest
+
+    // Appends the samples newer than time, oldest first; returns how many
+    size_t GetSamplesSince(uint32_t time, std::vector<PointerSample>& samples) const;
+
+    // Makes samples the coalesced positions on this thread for the scope of a
+    // move dispatch; nests
+    class CoalescedScope {
+    public:
+        explicit CoalescedScope(const std::vector<PointerSample>& samples);
+        ~CoalescedScope();
+
+        CoalescedScope(const CoalescedScope&) = delete;
+        CoalescedScope& operator=(const CoalescedScope&) = delete;
+
+    private:
+        const std::vector<PointerSample>* m_previous;
+    };
+    // Empty outside a move dispatch
+    static const std::vector<PointerSample>& GetCoalesced();
+
+    // Wrap-safe: a is later than b
+    static bool IsLater(uint32_t a, uint32_t b) { return (int32_t)(a - b) > 0; }
+
+private:
+    std::vector<PointerSample> m_samples;
+    size_t m_start;     // Oldest sample
+    size_t m_count;
+};
+
+} // namespace SDK
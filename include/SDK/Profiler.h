@@ -0,0 +1,108 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Zones compile to nothing when the SDK is built with SDK_ENABLE_PROFILER off
+#ifndef SDK_PROFILER_ENABLED
+#define SDK_PROFILER_ENABLED 1
+#endif
+
+namespace SDK {
+
+/**
+ * Profiler - Scoped timing zones for finding where a frame goes
+ * Each thread records into its own ring buffer, so recording takes no lock
+ * and never waits on another thread; once a ring is full its oldest zones are
+ * overwritten. Recording is off until SetEnabled(true), and a disabled zone
+ * costs one relaxed atomic load. Collect() copies every thread's zones, and
+ * ExportChromeTrace() writes them in the Chrome trace event format, which
+ * chrome://tracing and ui.perfetto.dev open. Zone names and categories are
+ * stored as pointers and must be string literals or otherwise outlive the
+ * profile.
+ */
+class Profiler {
+public:
+    struct Event {
+        const char* name;
+        const char* category;
+        uint64_t start;         // Nanoseconds since the profiler's epoch
+        uint64_t duration;      // Nanoseconds
+        uint32_t thread;        // In order of each thread's first zone, from 1
+    };
+
+    struct ThreadInfo {
+        uint32_t thread;
+        std::string name;
+        uint64_t dropped;       // Zones overwritten before they were collected
+    };
+
+    static void SetEnabled(bool enabled);
+    static bool IsEnabled();
+
+    // Zones each thread keeps, rounded up to a power of two; applies to
+    // threads that record their first zone afterwards
+    static void SetBufferCapacity(size_t events);
+    static size_t GetBufferCapacity();
+
+    static uint64_t Now();
+    static void Record(const char* name, const char* category, uint64_t start, uint64_t end);
+    // Times taken elsewhere, e.g. a JobScheduler::TaskProfile from the worker's profile hook
+    static void Record(const char* name, const char* category,
+                       std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
+
+    // Shown as the thread's name in the trace
+    static void SetThreadName(const char* name);
+
+    // Every thread's zones recorded since the last Clear(), ordered by start.
+    // Safe while other threads record; zones overwritten during the copy are
+    // left out.
+    static std::vector<Event> Collect();
+    static std::vector<ThreadInfo> GetThreads();
+    static void Clear();
+
+    // Complete ("X") events in microseconds, plus thread name metadata
+    static std::string ToChromeTrace();
+    static bool ExportChromeTrace(const std::wstring& path);
+
+private:
+    Profiler() = delete;
+};
+
+/**
+ * ProfileZone - Records the time from construction to destruction
+ * Normally declared through SDK_PROFILE_ZONE.
+ */
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* name, const char* category = "sdk")
+        : m_name(name), m_category(category), m_start(Profiler::IsEnabled() ? Profiler::Now() : 0) {}
+    ~ProfileZone() {
+        if (m_start) Profiler::Record(m_name, m_category, m_start, Profiler::Now());
+    }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* m_name;
+    const char* m_category;
+    uint64_t m_start;       // 0 when the profiler was off at construction
+};
+
+} // namespace SDK
+
+#define SDK_PROFILE_CONCAT_INNER(a, b) a##b
+#define SDK_PROFILE_CONCAT(a, b) SDK_PROFILE_CONCAT_INNER(a, b)
+
+#if SDK_PROFILER_ENABLED
+#define SDK_PROFILE_ZONE(name) ::SDK::ProfileZone SDK_PROFILE_CONCAT(sdkProfileZone, __LINE__)(name)
+#define SDK_PROFILE_ZONE_CATEGORY(name, category) \
+    ::SDK::ProfileZone SDK_PROFILE_CONCAT(sdkProfileZone, __LINE__)(name, category)
+#else
+#define SDK_PROFILE_ZONE(name) ((void)0)
+#define SDK_PROFILE_ZONE_CATEGORY(name, category) ((void)0)
+#endif
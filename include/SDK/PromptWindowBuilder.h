@@ -5,9 +5,13 @@
 #include "ProgressBar.h"
 #include "Tooltip.h"
 #include "Window.h"
+#include "WidgetArena.h"
+#include <cstdint>
 #include <string>
 #include <vector>
+#include <list>
 #include <map>
+#include <unordered_map>
 #include <memory>
 
 namespace SDK {
@@ -22,9 +26,15 @@ namespace SDK {
  * - "window 800x600 'My App' with progressbar and tooltip"
  * - "create dialog with 3 progressbars and ok button"
  * - "window with subwindow 'Settings' and 2 progressbars"
+ *
+ * Parsed prompts are memoized in a small LRU cache, so rebuilding the same
+ * dialog from the same prompt skips tokenizing and parsing.
  */
 class PromptWindowBuilder {
 public:
+    // Resolved widget factories for a spec; see CreateWidgetsFromSpec()
+    struct WidgetTemplate;
+    
     struct WindowSpec {
         std::wstring title;
         int width;
@@ -34,26 +44,49 @@ public:
         bool isDialog;
         std::vector<std::wstring> widgets;
         std::vector<WindowSpec> subwindows;
+        std::shared_ptr<const WidgetTemplate> widgetTemplate;  // Set on specs from the prompt cache
     };
     
     PromptWindowBuilder();
-    ~PromptWindowBuilder() = default;
+    virtual ~PromptWindowBuilder() = default;
     
-    // Parse a prompt and generate window specification
-    WindowSpec ParsePrompt(const std::wstring& prompt);
+    // Parse a prompt and generate window specification. Results are cached
+    // by the prompt with whitespace outside quotes collapsed.
+    virtual WindowSpec ParsePrompt(const std::wstring& prompt);
     
     // Create a window from specification
     HWND CreateWindowFromSpec(const WindowSpec& spec, HINSTANCE hInstance, HWND parent = nullptr);
     
-    // Create widgets from specification
+    // Create widgets from specification. A cached spec carries a template
+    // with the factories already looked up, so only the factories run.
     std::vector<std::shared_ptr<Widget>> CreateWidgetsFromSpec(const WindowSpec& spec);
     
-    // Register custom widget factory
+    // Register custom widget factory; clears the prompt cache. Factories that
+    // create widgets with MakeWidget() allocate from the build's arena.
     using WidgetFactory = std::function<std::shared_ptr<Widget>(const std::wstring&)>;
     void RegisterWidgetFactory(const std::wstring& widgetType, WidgetFactory factory);
     
     // Parse and create a complete window with widgets in one call
-    HWND BuildFromPrompt(const std::wstring& prompt, HINSTANCE hInstance, HWND parent = nullptr);
+    virtual HWND BuildFromPrompt(const std::wstring& prompt, HINSTANCE hInstance, HWND parent = nullptr);
+    
+    struct PromptCacheStats {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t evictions;
+        size_t size;        // Prompts currently cached
+        float hitRate;      // hits / (hits + misses); 0 before any lookup
+    };
+    PromptCacheStats GetPromptCacheStats() const;
+    void ResetPromptCacheStats();
+    
+    // Least recently used prompts are evicted past the capacity
+    void SetPromptCacheCapacity(size_t maxPrompts);   // Default: 32; 0 disables the cache
+    void ClearPromptCache();
+    
+    // Allocates each build's widgets from one WidgetArena, sized from the
+    // previous build so a tree usually fits one block. Off by default.
+    void SetWidgetArenaEnabled(bool enabled) { m_widgetArenaEnabled = enabled; }
+    bool IsWidgetArenaEnabled() const { return m_widgetArenaEnabled; }
     
     // Universal window creation function that consolidates all window creation patterns
     // Creates window, registers with SDK, applies theme, and optionally adds widgets
@@ -97,6 +130,31 @@ public:
     // Get last created widget manager (for accessing widgets)
     std::shared_ptr<WidgetManager> GetLastWidgetManager() const { return m_lastWidgetManager; }
     
+protected:
+    // One cache entry. Builders that need more than the spec derive from it
+    // and fill the rest in ParseCachedPrompt().
+    struct CachedPrompt {
+        virtual ~CachedPrompt() = default;
+        WindowSpec spec;
+    };
+    
+    // Cached entry for prompt, parsed on a miss
+    std::shared_ptr<const CachedPrompt> LookupPrompt(const std::wstring& prompt);
+    
+    // Parses an already normalized prompt into a new entry
+    virtual std::shared_ptr<CachedPrompt> ParseCachedPrompt(const std::wstring& prompt);
+    
+    static std::wstring NormalizePrompt(const std::wstring& prompt);
+    
+    void LayoutWidgets(std::vector<std::shared_ptr<Widget>>& widgets, int windowWidth, int windowHeight);
+    
+    // Arena for one build when enabled and no arena is current, else null;
+    // hand it back to EndBuildArena() once the widgets are created
+    std::unique_ptr<WidgetArena> BeginBuildArena();
+    void EndBuildArena(const WidgetArena* arena);
+    
+    std::shared_ptr<WidgetManager> m_lastWidgetManager;
+    
 private:
     struct Token {
         enum Type {
@@ -118,10 +176,21 @@ private:
     void ParseSubwindows(const std::vector<Token>& tokens, size_t& index, WindowSpec& spec);
     
     std::shared_ptr<Widget> CreateWidget(const std::wstring& widgetType);
-    void LayoutWidgets(std::vector<std::shared_ptr<Widget>>& widgets, int windowWidth, int windowHeight);
+    std::shared_ptr<const WidgetTemplate> BuildWidgetTemplate(const WindowSpec& spec) const;
     
     std::map<std::wstring, WidgetFactory> m_widgetFactories;
-    std::shared_ptr<WidgetManager> m_lastWidgetManager;
+    
+    // Most recently used first
+    using PromptList = std::list<std::pair<std::wstring, std::shared_ptr<const CachedPrompt>>>;
+    PromptList m_promptList;
+    std::unordered_map<std::wstring, PromptList::iterator> m_promptIndex;
+    size_t m_promptCapacity;
+    uint64_t m_promptHits;
+    uint64_t m_promptMisses;
+    uint64_t m_promptEvictions;
+    
+    bool m_widgetArenaEnabled;
+    size_t m_widgetArenaBlockSize;
 };
 
 } // namespace SDK
@@ -7,6 +7,11 @@
 
 namespace SDK {
 
+class RenderCommandList;
+class ParticleSystem;
+class TextureAtlas;
+class EffectGraph;
+
 /**
  * RenderBackend - Abstract interface for rendering backends
  * Allows switching between GDI, Direct2D, or other rendering systems
@@ -16,6 +21,8 @@ public:
     enum class BackendType {
         GDI,        // Software rendering (default)
         DIRECT2D,   // Hardware accelerated (Windows 7+)
+        HEADLESS,   // Software, into memory; no window (HeadlessRenderBackend)
+        OPENGL,     // Hardware accelerated through OpenGL 3.3 (Linux)
         AUTO        // Automatic selection
     };
     
@@ -37,6 +44,12 @@ public:
     virtual HDC GetDC() const = 0;
     virtual void* GetNativeContext() const = 0;
     
+    // GDI surface for drawing code that only takes an HDC, such as widgets
+    // without a backend path. Null when the backend has none. Pair every
+    // non-null result with EndGDIInterop().
+    virtual HDC BeginGDIInterop() { return GetDC(); }
+    virtual void EndGDIInterop(HDC hdc) { (void)hdc; }
+    
     // Basic drawing
     virtual void DrawRectangle(const RECT& rect, Color fillColor, Color borderColor, float borderWidth) = 0;
     virtual void DrawRoundedRectangle(const RECT& rect, float radius, Color fillColor, Color borderColor, float borderWidth) = 0;
@@ -46,6 +59,34 @@ public:
     // Text rendering
     virtual void DrawText(const std::wstring& text, const RECT& rect, Color color, const std::wstring& fontFamily, float fontSize, int fontWeight) = 0;
     
+    // Widget text - a single line centered vertically in rect. The defaults
+    // estimate glyph widths from the font size; backends measure real fonts.
+    enum class TextAlign {
+        LEFT,
+        CENTER,
+        RIGHT
+    };
+    virtual void DrawTextLine(const std::wstring& text, const RECT& rect, Color color, const std::wstring& fontFamily, float fontSize, int fontWeight, TextAlign align);
+    virtual int MeasureText(const std::wstring& text, const std::wstring& fontFamily, float fontSize, int fontWeight);
+    
+    // Particles - a size x size square centered on each position, alpha
+    // blended in index order; colors are 0xAARRGGBB. Backends splat the whole
+    // batch in one pass. The default draws one rectangle per particle.
+    virtual void DrawParticleBatch(const float* x, const float* y, const uint32_t* colors, size_t count, int size);
+    void DrawParticles(const ParticleSystem& particles, int size = 4);
+    
+    // Line batches - polyline i runs through the next counts[i] points; all
+    // share color and width, with round caps and joins. Backends submit the
+    // batch at once. The default draws one DrawLine per segment.
+    virtual void DrawPolylines(const POINT* points, const DWORD* counts, size_t polylineCount, Color color, float width);
+    
+    // Pixels a batch covers, clipped to clip; false when it covers none
+    static bool GetParticleBounds(const float* x, const float* y, size_t count, int size, const RECT& clip, RECT& bounds);
+    
+    // Atlas textures - copies a texture's sub-rect to dest, stretched when the
+    // sizes differ. The default blits through BeginGDIInterop().
+    virtual void DrawAtlasTexture(const TextureAtlas& atlas, const std::string& name, const RECT& dest);
+    
     // Gradients
     virtual void DrawLinearGradient(const RECT& rect, Color startColor, Color endColor, bool horizontal) = 0;
     virtual void DrawRadialGradient(const RECT& rect, Color centerColor, Color edgeColor, int cx, int cy) = 0;
@@ -112,9 +153,20 @@ public:
         int chromaticOffsetY = 2;
     };
     
+    // Both compile the settings into an EffectGraph, kept per preset and
+    // recompiled only when the settings change, and apply it
     virtual void ApplyEffectPreset(const RECT& rect, EffectPreset preset);
     virtual void ApplyCustomEffects(const RECT& rect, const EffectSettings& settings);
     
+    // Applies a compiled chain. The default makes one Apply call per stage;
+    // backends with pixel access read the region back once for all of them.
+    virtual void ApplyEffectGraph(const RECT& rect, EffectGraph& graph);
+    
+    // Retained mode - submits a recorded list batch by batch. The default
+    // replays each command through the calls above; backends may override
+    // to draw a whole batch at once.
+    virtual void ExecuteCommandList(const RenderCommandList& commands);
+    
 protected:
     RenderBackend() = default;
 };
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "Platform.h"
+#include "Theme.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace SDK {
+
+class RenderBackend;
+
+/**
+ * RenderCommandList - Recorded RenderBackend draw calls
+ * Record a frame once with the same calls RenderBackend takes, then submit it
+ * with RenderBackend::ExecuteCommandList() as often as needed. Before
+ * submission, commands are grouped by state (primitive, colors, width, font)
+ * so backends switch brushes and fonts less often; a command only moves past
+ * another when their bounds don't overlap, so the picture is unchanged.
+ * Compare a new recording with the last one through Matches() to skip
+ * redrawing an identical frame.
+ */
+class RenderCommandList {
+public:
+    enum class CommandType : uint8_t {
+        RECTANGLE,
+        ROUNDED_RECTANGLE,
+        LINE,
+        ELLIPSE,
+        TEXT,
+        LINEAR_GRADIENT,
+        RADIAL_GRADIENT,
+        SHADOW,
+        GLOW,
+        BLUR,
+        BLOOM,
+        DEPTH_OF_FIELD,
+        MOTION_BLUR,
+        CHROMATIC_ABERRATION
+    };
+
+    // Arguments of one recorded call; which fields are used depends on type
+    struct Command {
+        CommandType type;
+        RECT rect;          // Lines store their end points, ellipses their bounding box
+        Color color;        // Fill, line, text, shadow or first gradient color
+        Color secondColor;  // Border or second gradient color
+        float width;        // Border or line width
+        float value[2];     // Corner radius, font size, bloom threshold and intensity, ...
+        int param[3];       // Offsets, radii, directions, font weight, ...
+        uint32_t text;      // String index, for TEXT
+        uint32_t font;      // Font family string index, for TEXT
+    };
+
+    // Consecutive commands in submission order that share the same state
+    struct Batch {
+        size_t first;
+        size_t count;
+    };
+
+    RenderCommandList();
+
+    // Recording, mirroring RenderBackend
+    void DrawRectangle(const RECT& rect, Color fillColor, Color borderColor, float borderWidth);
+    void DrawRoundedRectangle(const RECT& rect, float radius, Color fillColor, Color borderColor, float borderWidth);
+    void DrawLine(int x1, int y1, int x2, int y2, Color color, float width);
+    void DrawEllipse(int cx, int cy, int rx, int ry, Color fillColor, Color borderColor, float borderWidth);
+    void DrawText(const std::wstring& text, const RECT& rect, Color color, const std::wstring& fontFamily, float fontSize, int fontWeight);
+    void DrawLinearGradient(const RECT& rect, Color startColor, Color endColor, bool horizontal);
+    void DrawRadialGradient(const RECT& rect, Color centerColor, Color edgeColor, int cx, int cy);
+    void DrawShadow(const RECT& rect, int offsetX, int offsetY, int blur, Color shadowColor);
+    void DrawGlow(const RECT& rect, int radius, Color glowColor);
+
+    // Effects read pixels back, so nothing is reordered across them
+    void ApplyBlur(const RECT& rect, int blurRadius);
+    void ApplyBloom(const RECT& rect, float threshold, float intensity);
+    void ApplyDepthOfField(const RECT& rect, int focalDepth, int blurAmount, float focalRange);
+    void ApplyMotionBlur(const RECT& rect, int directionX, int directionY, float intensity);
+    void ApplyChromaticAberration(const RECT& rect, float strength, int offsetX, int offsetY);
+
+    void Reset();
+    size_t GetCommandCount() const { return m_commands.size(); }
+    bool IsEmpty() const { return m_commands.empty(); }
+
+    // Recorded order
+    const Command& GetCommand(size_t index) const { return m_commands[index]; }
+    const std::wstring& GetString(uint32_t index) const { return m_strings[index]; }
+
+    // When disabled, commands are submitted in recorded order and only
+    // consecutive commands with the same state are batched
+    void SetSortingEnabled(bool enabled);
+    bool IsSortingEnabled() const { return m_sortingEnabled; }
+
+    // Submission order, built on first use after recording changes.
+    // Sorting compares every pair of commands, so lists longer than
+    // MAX_SORTED_COMMANDS keep their recorded order.
+    static constexpr size_t MAX_SORTED_COMMANDS = 4096;
+    const Command& GetOrderedCommand(size_t index) const;
+    const std::vector<Batch>& GetBatches() const;
+
+    // Hash of everything recorded, updated as commands are added
+    uint64_t GetContentHash() const { return m_hash; }
+
+    // True when both lists record the same calls in the same order
+    bool Matches(const RenderCommandList& other) const;
+
+    // Issues every command to backend, batch by batch
+    void Replay(RenderBackend& backend) const;
+    void Replay(RenderBackend& backend, const Batch& batch) const;
+
+private:
+    void Push(const Command& command);
+    uint32_t AddString(const std::wstring& text);
+    void BuildOrder() const;
+
+    std::vector<Command> m_commands;
+    std::vector<std::wstring> m_strings;                    // Interned text and font families
+    std::unordered_map<std::wstring, uint32_t> m_stringIndex;
+    bool m_sortingEnabled;
+    uint64_t m_hash;
+
+    // Submission order cache
+    mutable bool m_orderValid;
+    mutable std::vector<uint32_t> m_order;
+    mutable std::vector<Batch> m_batches;
+};
+
+} // namespace SDK
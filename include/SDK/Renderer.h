@@ -4,14 +4,22 @@
 #include "Platform.h"
 #include <vector>
 #include <memory>
+#include <cstdint>
 #include <unordered_map>
 #include <string>
 #include <thread>
 #include <mutex>
 #include "Theme.h"
+#include "TextureAtlas.h"
+#include "GdiObjectCache.h"
+#include "MemoryRegistry.h"
 
 namespace SDK {
 
+class CameraController;
+class RenderBackend;
+class SharedAssetCache;
+
 /**
  * Renderer - Advanced rendering utilities for 5D GUI
  * Implements gradients, shadows, rounded corners, and effects
@@ -34,11 +42,23 @@ public:
     static void DrawMultiStopGradient(HDC hdc, const RECT& rect, const std::vector<GradientStop>& stops, bool horizontal = true);
     static void DrawConicalGradient(HDC hdc, const RECT& rect, const std::vector<GradientStop>& stops, int cx, int cy, float startAngle = 0.0f);
     
+    // Radial and conical gradients are rasterized once per (size, center, stops)
+    // and blitted from this cache on later draws
+    static void SetGradientCacheEnabled(bool enabled);
+    static bool IsGradientCacheEnabled();
+    static void SetGradientCacheCapacity(size_t maxEntries);  // Least recently used entries are evicted
+    static void ClearGradientCache();
+    static size_t GetGradientCacheSize();
+    // Adds the cached gradients to a SharedAssetCache being published; processes
+    // attached to it blit them from the shared section instead of rasterizing.
+    // Returns how many were added.
+    static size_t ExportSharedGradients(SharedAssetCache& cache);
+    
     // Rounded rectangle with alpha
     static void DrawRoundedRect(HDC hdc, const RECT& rect, int radius, Color fillColor, Color borderColor, int borderWidth);
     
-    // Shadow rendering
-    static void DrawShadow(HDC hdc, const RECT& rect, int offsetX, int offsetY, int blur, Color shadowColor);
+    // Shadow rendering (nine-slice tiles from ShadowCache)
+    static void DrawShadow(HDC hdc, const RECT& rect, int offsetX, int offsetY, int blur, Color shadowColor, int cornerRadius = 0);
     
     // Glow effect
     static void DrawGlow(HDC hdc, const RECT& rect, int radius, Color glowColor);
@@ -58,7 +78,8 @@ public:
         bool active;  // For object pooling
     };
     
-    // Particle pool for memory optimization
+    // Particle pool for memory optimization. Reports to MemoryRegistry as
+    // "ParticlePool"; a trim shrinks an idle pool back to its initial size.
     class ParticlePool {
     public:
         ParticlePool(size_t initialSize = 1000);
@@ -69,11 +90,15 @@ public:
         void ReleaseAll();
         size_t GetActiveCount() const;
         size_t GetTotalCount() const;
+        size_t GetMemoryBytes() const;
+        void Shrink();      // Only while no particle is active
         
     private:
         std::vector<Particle> particles_;
         std::vector<Particle*> available_;
         size_t activeCount_;
+        size_t initialSize_;
+        MemoryRegistry::Source memorySource_;
     };
     
     static void DrawParticles(HDC hdc, const std::vector<Particle>& particles);
@@ -81,6 +106,7 @@ public:
     static std::vector<Particle> CreateParticleEmission(int x, int y, int count, Color color);
     static void DrawParticlesFromPool(HDC hdc, ParticlePool& pool);
     static void UpdateParticlesInPool(ParticlePool& pool, float deltaTime);
+    // Runs on JobScheduler; numThreads caps the chunk count (0 = one per worker)
     static void UpdateParticlesInPoolMultiThreaded(ParticlePool& pool, float deltaTime, int numThreads = 0);
     
     // Icon rendering for 5D icon system
@@ -95,29 +121,7 @@ public:
     static void DrawIcon(HDC hdc, IconType type, int x, int y, int size, Color color, float alpha = 1.0f);
     
     // Texture atlas for icon optimization
-    class TextureAtlas {
-    public:
-        struct AtlasEntry {
-            int x, y, width, height;
-            HBITMAP bitmap;
-        };
-        
-        TextureAtlas(int width, int height);
-        ~TextureAtlas();
-        
-        bool AddTexture(const std::string& name, HBITMAP bitmap, int width, int height);
-        const AtlasEntry* GetTexture(const std::string& name) const;
-        bool RemoveTexture(const std::string& name);
-        void Clear();
-        
-    private:
-        int atlasWidth_;
-        int atlasHeight_;
-        int currentX_;
-        int currentY_;
-        int rowHeight_;
-        std::unordered_map<std::string, AtlasEntry> textures_;
-    };
+    using TextureAtlas = SDK::TextureAtlas;
     
     // Animation system
     enum class EasingType {
@@ -185,10 +189,21 @@ public:
         ~RenderCache();
         
         void MarkDirty(const RECT& rect);
+        void MarkAllDirty();
         void MarkClean();
         bool IsDirty(const RECT& rect) const;
+        bool HasDirtyRegions() const { return !dirtyRegions_.empty(); }
+        
+        // Merge dirty rects that overlap or lie within mergeDistance pixels of each
+        // other; too many fragments collapse into their bounding rect
+        void MergeDirtyRegions(int mergeDistance = 16, size_t maxRegions = 16);
+        const std::vector<DirtyRect>& GetDirtyRegions() const { return dirtyRegions_; }
+        bool GetDirtyBounds(RECT& bounds) const;
+        long long GetDirtyPixelCount() const;
         
         HDC GetCacheDC() { return cacheDC_; }
+        int GetWidth() const { return width_; }
+        int GetHeight() const { return height_; }
         void CopyToTarget(HDC targetDC, const RECT& srcRect, int destX, int destY);
         
     private:
@@ -197,9 +212,10 @@ public:
         int width_;
         int height_;
         std::vector<DirtyRect> dirtyRegions_;
+        MemoryRegistry::Source memorySource_;   // "RenderCache", the 32bpp bitmap
     };
     
-    // Occlusion culling helper
+    // Occlusion culling helper: true when the union of the occluders covers rect
     static bool IsRectOccluded(const RECT& rect, const std::vector<RECT>& occluders);
     static bool RectsIntersect(const RECT& a, const RECT& b);
     
@@ -207,9 +223,37 @@ public:
     static Color InterpolateColor(Color c1, Color c2, float t);
     static BYTE BlendAlpha(BYTE src, BYTE dst, BYTE alpha);
     
-    // Create memory DC for offscreen rendering
-    static HDC CreateMemoryDC(int width, int height, HBITMAP* outBitmap);
-    static void DeleteMemoryDC(HDC hdc, HBITMAP bitmap);
+    // Create memory DC for offscreen rendering. The DC and bitmap are counted
+    // against subsystem in GdiHandleCounter; delete with the same subsystem.
+    static HDC CreateMemoryDC(int width, int height, HBITMAP* outBitmap, GdiSubsystem subsystem = GdiSubsystem::OTHER);
+    static void DeleteMemoryDC(HDC hdc, HBITMAP bitmap, GdiSubsystem subsystem = GdiSubsystem::OTHER);
+    
+    // Direct pixel access for post-processing effects
+    enum class PixelAccessMode {
+        DIB_SECTION,    // Copy the rect into a 32-bit DIB section, process the raw buffer, blit once
+        PER_PIXEL       // Legacy GetPixel/SetPixel path (fallback)
+    };
+    
+    struct PixelSurface {
+        HDC dc;
+        HBITMAP bitmap;
+        uint32_t* pixels;   // 0xAARRGGBB (BGRA byte order), top-down, stride == width
+        int width;
+        int height;
+        
+        PixelSurface() : dc(nullptr), bitmap(nullptr), pixels(nullptr), width(0), height(0) {}
+    };
+    
+    static void SetPixelAccessMode(PixelAccessMode mode);
+    static PixelAccessMode GetPixelAccessMode();
+    
+    // Create a memory DC backed by a top-down 32-bit DIB section
+    static HDC CreateDIBMemoryDC(int width, int height, HBITMAP* outBitmap, uint32_t** outPixels,
+                                 GdiSubsystem subsystem = GdiSubsystem::OTHER);
+    
+    // Copy rect of hdc into a DIB surface; EndPixelAccess blits it back and releases it
+    static bool BeginPixelAccess(HDC hdc, const RECT& rect, PixelSurface& surface);
+    static void EndPixelAccess(HDC hdc, const RECT& rect, PixelSurface& surface, bool writeBack = true);
     
     // Multi-dimensional rendering (3D/4D/5D/6D)
     struct Vector3D {
@@ -235,25 +279,86 @@ public:
             : x(_x), y(_y), z(_z), w(_w), d(_d), t(_t) {}
     };
     
+    // Retained 5D point set for Render5DScene. Points are grouped into one
+    // index list per color when set, so a frame projects them in one batch
+    // and submits one dot batch per color. UpdatePoints moves points in
+    // place without regrouping.
+    class SceneBuffer {
+    public:
+        void SetPoints(const std::vector<Vector5D>& points, const std::vector<Color>& colors);
+        void UpdatePoints(size_t first, const Vector5D* points, size_t count);
+        void Clear();
+        
+        const std::vector<Vector5D>& GetPoints() const { return points_; }
+        size_t GetCount() const { return points_.size(); }
+        size_t GetColorCount() const { return batches_.size(); }
+        
+    private:
+        friend class Renderer;
+        
+        struct ColorBatch {
+            Color color;
+            std::vector<uint32_t> indices;
+        };
+        
+        void Project(float time, int originX, int originY, const CameraController* camera);
+        size_t BuildDots(const ColorBatch& batch);
+        
+        std::vector<Vector5D> points_;
+        std::vector<ColorBatch> batches_;
+        
+        // Per-frame scratch, kept to avoid reallocating
+        std::vector<Vector3D> scene_;
+        std::vector<POINT> projected_;
+        std::vector<POINT> dots_;
+        std::vector<DWORD> counts_;
+    };
+    
+    // Polyline i runs through the next counts[i] (at least 2) points; all
+    // are drawn by one PolyPolyline with a single pen
+    static void DrawPolylines(HDC hdc, const POINT* points, const DWORD* counts, size_t polylineCount, Color color, int width);
+    
     // 3D Rendering (basic perspective projection)
     static void Render3DPoint(HDC hdc, const Vector3D& point, int originX, int originY, Color color, float scale = 1.0f);
     static void Render3DLine(HDC hdc, const Vector3D& start, const Vector3D& end, int originX, int originY, Color color, float scale = 1.0f);
-    static void Render3DCube(HDC hdc, const Vector3D& center, float size, int originX, int originY, Color color, float rotationX = 0, float rotationY = 0, float rotationZ = 0);
+    // Scenes project all their vertices in one batch, through camera when
+    // given and otherwise the fixed perspective of Project3Dto2D
+    static void Render3DCube(HDC hdc, const Vector3D& center, float size, int originX, int originY, Color color, float rotationX = 0, float rotationY = 0, float rotationZ = 0,
+                             const CameraController* camera = nullptr);
     
     // 4D Rendering (time-animated 3D)
     static void Render4DPoint(HDC hdc, const Vector4D& point, float time, int originX, int originY, Color color, float scale = 1.0f);
-    static void Render4DHypercube(HDC hdc, const Vector4D& center, float size, float time, int originX, int originY, Color color);
+    static void Render4DHypercube(HDC hdc, const Vector4D& center, float size, float time, int originX, int originY, Color color,
+                                  const CameraController* camera = nullptr);
+    static void Render4DHypercube(RenderBackend& backend, const Vector4D& center, float size, float time, int originX, int originY,
+                                  Color color, const CameraController* camera = nullptr);
     
     // 5D Rendering (depth layers + 3D)
     static void Render5DPoint(HDC hdc, const Vector5D& point, float time, int originX, int originY, Color color, float scale = 1.0f);
-    static void Render5DScene(HDC hdc, const std::vector<Vector5D>& points, float time, int originX, int originY, const std::vector<Color>& colors);
+    static void Render5DScene(HDC hdc, const std::vector<Vector5D>& points, float time, int originX, int originY, const std::vector<Color>& colors,
+                              const CameraController* camera = nullptr);
+    static void Render5DScene(HDC hdc, SceneBuffer& scene, float time, int originX, int originY,
+                              const CameraController* camera = nullptr);
+    static void Render5DScene(RenderBackend& backend, SceneBuffer& scene, float time, int originX, int originY,
+                              const CameraController* camera = nullptr);
     
     // 6D Rendering (multi-timeline rendering)
     static void Render6DPoint(HDC hdc, const Vector6D& point, int originX, int originY, Color color, float scale = 1.0f);
-    static void Render6DPath(HDC hdc, const std::vector<Vector6D>& path, int originX, int originY, Color color);
+    static void Render6DPath(HDC hdc, const std::vector<Vector6D>& path, int originX, int originY, Color color,
+                             const CameraController* camera = nullptr);
+    static void Render6DPath(RenderBackend& backend, const std::vector<Vector6D>& path, int originX, int originY, Color color,
+                             const CameraController* camera = nullptr);
     
     // Projection helpers
     static void Project3Dto2D(const Vector3D& point3D, int& x2D, int& y2D, int originX, int originY, float scale);
+    
+    // Batch transforms through a row-major 4x4 matrix applied to column
+    // vectors, four points per SSE2 step. TransformPoints keeps rows 0-2.
+    // ProjectPoints divides rows 0 and 1 by row 3, clamped to minW, then
+    // scales and offsets them like Project3Dto2D.
+    static void TransformPoints(const float* matrix, const Vector3D* points, Vector3D* out, size_t count);
+    static void ProjectPoints(const float* matrix, float minW, const Vector3D* points, POINT* out, size_t count,
+                              int originX, int originY, float scale);
     static void Project4Dto3D(const Vector4D& point4D, Vector3D& point3D, float time);
     static void Project5Dto4D(const Vector5D& point5D, Vector4D& point4D, float depthScale);
     static void Project6Dto5D(const Vector6D& point6D, Vector5D& point5D);
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "Platform.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <memory>
 #include <unordered_map>
@@ -11,9 +14,17 @@ namespace SDK {
 /**
  * RendererOptimizer - Machine Learning-based renderer optimization
  * Uses lightweight ML algorithms to predict optimal rendering strategies
+ * 
+ * Elements are stored densely and addressed by integer handles. The string
+ * IDs remain for registration and convenience; a frame's decisions are best
+ * made in one GetOptimalStrategies() call over handles.
  */
 class RendererOptimizer {
 public:
+    using ElementHandle = uint32_t;
+    static constexpr ElementHandle INVALID_ELEMENT = UINT32_MAX;
+    static constexpr int FEATURE_COUNT = 6;
+    
     // Rendering decision types
     enum class RenderStrategy {
         FULL_RENDER,        // Full render of element
@@ -38,6 +49,21 @@ public:
         float lastUpdateTime;       // Time since last update
     };
     
+    // Features of many elements, one array per feature, so a batch is
+    // scored with straight loops the compiler vectorizes. The arrays only
+    // grow; a batch no larger than the last allocates nothing.
+    struct FeatureBatch {
+        size_t count = 0;
+        std::array<std::vector<float>, FEATURE_COUNT> features;
+        std::vector<float> screenCoverage;
+        std::vector<float> changeFrequency;
+        std::vector<uint8_t> isAnimated;
+        std::vector<float> scores;          // Weighted sums, before the sigmoid
+        
+        void Resize(size_t elementCount);
+        void Set(size_t index, const ElementMetrics& metrics);
+    };
+    
     // ML model for optimization decisions
     class OptimizationModel {
     public:
@@ -46,50 +72,72 @@ public:
         // Predict best rendering strategy
         RenderStrategy Predict(const ElementMetrics& metrics) const;
         
+        // Predict every element of batch; same results as Predict() on each
+        void PredictBatch(FeatureBatch& batch, RenderStrategy* strategies) const;
+        
         // Update model with feedback (online learning)
         void Learn(const ElementMetrics& metrics, RenderStrategy actual, float performance);
         
         // Get model confidence (0-1)
         float GetConfidence() const { return confidence_; }
         
+        // Feature extraction from metrics into FEATURE_COUNT floats
+        static void ExtractFeatures(const ElementMetrics& metrics, float* features);
+        
     private:
         // Simple neural network weights (lightweight)
-        std::vector<float> weights_;
+        std::array<float, FEATURE_COUNT> weights_;
         float bias_;
         float learningRate_;
         float confidence_;
         int trainingCount_;
         
-        // Feature extraction from metrics
-        std::vector<float> ExtractFeatures(const ElementMetrics& metrics) const;
-        
         // Activation function
         float Sigmoid(float x) const;
         
+        // Strategy for a weighted sum; compares against the sigmoid's
+        // thresholds in logit space, so no exp is needed
+        static RenderStrategy Decide(float score, float screenCoverage, float changeFrequency, bool isAnimated);
+        
         // Update weights based on feedback
-        void UpdateWeights(const std::vector<float>& features, float error);
+        void UpdateWeights(const float* features, float error);
     };
     
     RendererOptimizer();
     ~RendererOptimizer() = default;
     
-    // Register an element for optimization
-    void RegisterElement(const std::string& elementId, const RECT& bounds);
+    // Register an element for optimization; returns its handle, the
+    // existing one if the ID is already registered
+    ElementHandle RegisterElement(const std::string& elementId, const RECT& bounds);
+    ElementHandle GetHandle(const std::string& elementId) const;  // INVALID_ELEMENT if unknown
     
     // Get recommended rendering strategy for element
     RenderStrategy GetOptimalStrategy(const std::string& elementId);
+    RenderStrategy GetOptimalStrategy(ElementHandle element);
+    
+    // One frame's decisions: strategies[i] is for handles[i]. Invalid
+    // handles get FULL_RENDER, as GetOptimalStrategy() gives unknown IDs.
+    void GetOptimalStrategies(const ElementHandle* handles, size_t count, RenderStrategy* strategies);
     
     // Update metrics after rendering
     void RecordRenderMetrics(const std::string& elementId, float renderTime, bool wasVisible);
+    void RecordRenderMetrics(ElementHandle element, float renderTime, bool wasVisible);
     
     // Record cache hit/miss
     void RecordCacheAccess(const std::string& elementId, bool hit);
+    void RecordCacheAccess(ElementHandle element, bool hit);
     
     // Mark element as changed
     void MarkElementChanged(const std::string& elementId);
+    void MarkElementChanged(ElementHandle element);
     
-    // Get current metrics for element
+    // Get current metrics for element; valid until the next RegisterElement()
     const ElementMetrics* GetMetrics(const std::string& elementId) const;
+    const ElementMetrics* GetMetrics(ElementHandle element) const;
+    
+    // Track an element's new bounds; screenArea is the pixel area of the
+    // view it is drawn in, for the coverage feature
+    void UpdateElementBounds(ElementHandle element, const RECT& bounds, int64_t screenArea);
     
     // Calculate appropriate LOD level based on screen coverage and distance
     int CalculateLOD(const std::string& elementId, float screenCoverage);
@@ -116,8 +164,10 @@ public:
     
 private:
     bool enabled_;
-    std::unordered_map<std::string, ElementMetrics> elementMetrics_;
+    std::vector<ElementMetrics> elementMetrics_;                 // Indexed by handle
+    std::unordered_map<std::string, ElementHandle> elementHandles_;
     std::unique_ptr<OptimizationModel> model_;
+    FeatureBatch batch_;
     
     // Statistics
     mutable int totalDecisions_;
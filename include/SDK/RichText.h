@@ -4,7 +4,10 @@
 #include "Theme.h"
 #include <string>
 #include <vector>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <algorithm>
 
 namespace SDK {
 
@@ -45,6 +48,9 @@ struct TextSpan {
 
 /**
  * RichTextDocument - Container for rich text content
+ * Keeps a layout cache of measured glyph advances per span and of the wrapped
+ * lines for the last wrap width. Spans changed since the previous layout are
+ * re-measured, and lines are rebuilt from the first line they can affect.
  */
 class RichTextDocument {
 public:
@@ -57,8 +63,20 @@ public:
     void InsertSpan(size_t index, const TextSpan& span);
     void RemoveSpan(size_t index);
     
-    std::vector<TextSpan>& GetSpans() { return m_spans; }
-    const std::vector<TextSpan>& GetSpans() const { return m_spans; }
+    // Call InvalidateSpan after changing a span through the mutable list.
+    // A deque, so the streaming ring buffer can drop old lines in O(1).
+    std::deque<TextSpan>& GetSpans() { return m_spans; }
+    const std::deque<TextSpan>& GetSpans() const { return m_spans; }
+    
+    // Streaming
+    // AppendStream splits text at line breaks so every line ends a span, and
+    // continues the open last line when the formatting matches. With a line
+    // limit set, the oldest lines are dropped once the document holds more
+    // line breaks; only the appended text is measured and laid out.
+    void AppendStream(const TextSpan& span);
+    void SetMaxLines(size_t maxLines);      // 0 = unlimited
+    size_t GetMaxLines() const { return m_maxLines; }
+    size_t GetLineBreakCount() const { return m_lineBreaks; }
     
     // Quick text addition with formatting
     void AddText(const std::wstring& text, bool bold = false, bool italic = false);
@@ -67,14 +85,90 @@ public:
     void AddParagraph(const std::wstring& text);
     
     // Markdown parsing (basic)
+    // One pass over the source; each run's text is copied once, into its
+    // span. UpdateMarkdown re-parses only the lines that differ from the last
+    // parsed source and keeps the measurements of the rest, so a preview can
+    // follow an editor keystroke by keystroke. It parses everything when the
+    // spans were changed in between.
     void ParseMarkdown(const std::wstring& markdown);
+    void UpdateMarkdown(const std::wstring& markdown);
     
     // Export
     std::wstring ToPlainText() const;
     std::wstring ToHtml() const;
     
+    // Layout cache
+    // A run is a piece of one span on one line; positions are relative to the
+    // top-left of the text area and indices to the current spans and runs.
+    struct LayoutRun {
+        size_t span;
+        size_t start;
+        size_t length;
+        int x;
+        int width;
+        int yOffset;        // From the line top to the run top, aligning baselines
+    };
+    
+    struct LayoutLine {
+        size_t startSpan;   // Where the line's text begins, for relayout
+        size_t startOffset;
+        size_t firstRun;
+        size_t runCount;
+        int y;
+        int height;
+    };
+    
+    // Brings the layout up to date for the given wrap width, measuring only
+    // spans changed since the last call. lineSpacing scales font sizes to line heights.
+    void UpdateLayout(HDC hdc, int wrapWidth, float lineSpacing);
+    void InvalidateSpan(size_t index);
+    void InvalidateLayout();
+    
+    size_t GetLayoutLineCount() const { return m_lines.size(); }
+    LayoutLine GetLayoutLine(size_t index) const;
+    LayoutRun GetLayoutRun(size_t index) const;
+    int GetLayoutHeight() const;
+    size_t FindLayoutLine(int y) const;     // Line at or above y; 0 when empty
+    
 private:
-    std::vector<TextSpan> m_spans;
+    std::deque<TextSpan> m_spans;
+    size_t m_maxLines;
+    size_t m_lineBreaks;
+    
+    // Source of the spans for UpdateMarkdown
+    std::wstring m_markdown;
+    std::vector<size_t> m_markdownLines;    // Start of each line, plus the source length
+    std::vector<size_t> m_markdownSpans;    // First span of each line, plus the span count
+    bool m_hasMarkdown;
+    
+    // Per-span measurements, independent of the wrap width
+    struct SpanMetrics {
+        std::vector<int> advances;  // Per character; 0 for line breaks
+        int ascent;
+        bool valid;
+        
+        SpanMetrics() : ascent(0), valid(false) {}
+    };
+    std::deque<SpanMetrics> m_metrics;
+    
+    // Stored lines and runs use absolute span/run indices and y positions, so
+    // dropping old lines doesn't renumber the rest; the bases map them back.
+    std::deque<LayoutLine> m_lines;
+    std::deque<LayoutRun> m_runs;
+    size_t m_spanBase;      // Spans dropped from the front
+    size_t m_runBase;       // Runs dropped from the front
+    int m_yBase;            // Top of the first line
+    int m_layoutWidth;
+    float m_layoutLineSpacing;
+    size_t m_dirtySpan;     // First span whose lines are stale; npos when clean
+    
+    void MarkDirty(size_t index) { m_dirtySpan = std::min(m_dirtySpan, index); }
+    void MeasureSpan(HDC hdc, size_t index);
+    void FinishLine(LayoutLine& line, int lineHeight, int ascent);
+    void ResetLayout();
+    void TrimToMaxLines();
+    void RecountLineBreaks();
+    void ForgetMarkdown();
 };
 
 /**
@@ -94,8 +188,20 @@ public:
     std::wstring GetText() const;
     
     void AppendText(const std::wstring& text);
+    void AppendText(const TextSpan& span);
     void Clear();
     
+    // Streaming (log consoles)
+    // AppendText may then be called from any thread: appends are queued and
+    // coalesced, then moved into the document at most once per frame by
+    // Update (or the next Render), followed by a single repaint. A view
+    // scrolled to the bottom stays there as text arrives.
+    void SetStreamingMode(bool streaming, size_t maxLines = 0);
+    bool IsStreamingMode() const { return m_streaming; }
+    void SetMaxLineCount(size_t maxLines) { m_document->SetMaxLines(maxLines); }
+    size_t GetMaxLineCount() const { return m_document->GetMaxLines(); }
+    void FlushPendingText();    // UI thread only
+    
     // Editing
     void SetReadOnly(bool readOnly) { m_readOnly = readOnly; }
     bool IsReadOnly() const { return m_readOnly; }
@@ -133,6 +239,7 @@ public:
     
     // Widget overrides
     void Render(HDC hdc) override;
+    void Update(float deltaTime) override;
     void HandleEvent(WidgetEvent event, void* data) override;
     
     // Appearance
@@ -159,15 +266,23 @@ private:
     float m_lineSpacing;
     int m_paragraphSpacing;
     
-    // Rendering helpers
-    void RenderSpan(HDC hdc, const RECT& rect, const TextSpan& span, int& x, int& y);
-    void CalculateLayout();
-    int GetLineHeight(const TextSpan& span) const;
+    RECT m_textRect;    // Text area of the last layout
+    
+    // Streaming
+    bool m_streaming;
+    std::mutex m_pendingMutex;
+    std::vector<TextSpan> m_pendingSpans;   // Guarded by m_pendingMutex
     
     // Interaction
     int m_hoveredSpanIndex;
     void HandleMouseMove(int x, int y);
     void HandleMouseClick(int x, int y);
+    int HitTestSpan(int x, int y) const;
+    
+protected:
+    // Rendering helpers
+    void CalculateLayout(HDC hdc, const RECT& textRect);
+    void RenderLines(HDC hdc, const RECT& textRect);   // Draws only the visible lines
 };
 
 /**
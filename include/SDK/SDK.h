@@ -43,25 +43,56 @@
 #include "WindowAnimation.h"
 #include "Theme.h"
 #include "Renderer.h"
+#include "PixelKernels.h"
+#include "JobScheduler.h"
+#include "ParticleSystem.h"
+#include "TileScheduler.h"
+#include "ShadowCache.h"
+#include "TextureAtlas.h"
+#include "MemoryRegistry.h"
+#include "FrameArena.h"
+#include "SharedAssetCache.h"
+#include "FrameClock.h"
+#include "FontCache.h"
+#include "GdiObjectCache.h"
+#include "TextBuffer.h"
 #include "RenderBackend.h"
+#include "EffectGraph.h"
+#include "RenderCommandList.h"
 #include "GDIRenderBackend.h"
 #include "D2DRenderBackend.h"
+#include "HeadlessRenderBackend.h"
+#include "PngEncoder.h"
 #include "Widget.h"
+#include "EventQueue.h"
+#include "InputTrace.h"
+#include "UpdateScheduler.h"
 #include "ProgressBar.h"
 #include "Tooltip.h"
+#include "PerformanceHUD.h"
 #include "Toolbar.h"
+#include "AcceleratorTable.h"
+#include "ScrollPanel.h"
 #include "WidgetManager.h"
+#include "WidgetSpatialIndex.h"
 #include "PromptWindowBuilder.h"
 #include "NeuralNetwork.h"
 #include "NeuralPromptBuilder.h"
 #include "AdvancedWidgets.h"
+#include "DirectoryLoader.h"
+#include "DelimitedFile.h"
+#include "ImageCache.h"
+#include "GlyphAtlas.h"
+#include "Easing.h"
 #include "CameraController.h"
 #include "Widget3D.h"
+#include "SimplexSolver.h"
 #include "Layout.h"
 #include "Menu.h"
 #include "RichText.h"
 #include "DPIManager.h"
 #include "MonitorManager.h"
+#include "StartupTiming.h"
 
 namespace SDK {
 
@@ -70,11 +101,27 @@ constexpr int SDK_VERSION_MAJOR = 2;
 constexpr int SDK_VERSION_MINOR = 0;
 constexpr int SDK_VERSION_PATCH = 0;
 
+struct InitOptions {
+    // Installs the CreateWindowExW hook after the first frame is presented
+    // instead of in Initialize(). Windows of this thread created before then
+    // are queued for registration when it goes in.
+    bool deferWindowHook;
+
+    // Name of a published SharedAssetCache to attach, so themed windows take
+    // gradients, shadows, icons and the model from it; empty for none. A
+    // missing cache isn't an error, the assets are built locally instead.
+    std::wstring sharedAssetCache;
+
+    InitOptions() : deferWindowHook(false) {}
+};
+
 /**
  * Initialize the 5D GUI SDK
- * Must be called before creating any windows
+ * Must be called before creating any windows. Sets DPI awareness and starts
+ * the window manager; monitors are enumerated and the shared neural network
+ * is built on first use. StartupTiming reports where the time went.
  */
-bool Initialize();
+bool Initialize(const InitOptions& options = InitOptions());
 
 /**
  * Shutdown the SDK and cleanup resources
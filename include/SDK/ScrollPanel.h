@@ -0,0 +1,145 @@
+#pragma once
+
+#include "Widget.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace SDK {
+
+/**
+ * ScrollPanel - Panel scrolling a list of items, realizing only those in view
+ * Items are indexes up to a count. Widgets exist only for the items that
+ * intersect the viewport: the factory makes one per item template and the
+ * binder points it at an item. A widget scrolled out goes to its template's
+ * pool and is bound again to an item scrolled in, so a list of any length
+ * keeps about a screenful of widgets. Items stack vertically, or fill a grid
+ * of fixed columns a line at a time. A line's extent is estimated until its
+ * items are bound, then measured from their heights. Line offsets are prefix
+ * sums rebuilt only after extents change, and the first visible line is
+ * found by binary search. The realized items are the panel's only children.
+ */
+class ScrollPanel : public Panel {
+public:
+    enum class Arrangement {
+        STACK,      // One item per line, as wide as the viewport
+        GRID        // Columns of equal width
+    };
+
+    using ItemFactory = std::function<std::shared_ptr<Widget>(int templateId)>;
+    using ItemBinder = std::function<void(Widget& widget, int index)>;
+    using TemplateSelector = std::function<int(int index)>;
+
+    ScrollPanel();
+    ~ScrollPanel() override;
+
+    // The binder sets the widget's content and may set its height; the
+    // panel sets its position and width. Replacing the source drops every
+    // widget and scrolls to the top.
+    void SetItemSource(int count, ItemFactory factory, ItemBinder binder);
+    // Template of each item; without one, every item uses template 0
+    void SetTemplateSelector(TemplateSelector selector);
+    // Keeps the scroll position and binds the realized items again
+    void SetItemCount(int count);
+    int GetItemCount() const { return m_itemCount; }
+    void RefreshItems();                // Binds the realized items again
+
+    void SetArrangement(Arrangement arrangement, int columns = 1);
+    Arrangement GetArrangement() const { return m_arrangement; }
+    int GetColumnCount() const { return m_arrangement == Arrangement::GRID ? m_columns : 1; }
+    void SetEstimatedItemExtent(int extent);    // Default: 30
+    void SetItemSpacing(int spacing);           // Default: 4
+
+    // Pixel scrolling. Animated scrolls glide toward the target over the
+    // next frames; the wheel, keys and track clicks animate, and dragging
+    // the thumb follows the mouse.
+    void SetScrollOffset(int offset, bool animate = false);  // Clamped
+    int GetScrollOffset() const { return (int)m_scrollOffset; }
+    int GetScrollTarget() const { return (int)m_scrollTarget; }
+    int GetContentExtent() const;
+    int GetViewportExtent() const;
+    void ScrollToItem(int index, bool animate = false);      // Item's line at the top
+    void EnsureItemVisible(int index, bool animate = false);
+
+    // Null when the item isn't realized
+    Widget* GetItemWidget(int index) const;
+    int GetFirstRealizedItem() const { return m_realized.empty() ? -1 : m_realized.front().index; }
+    int GetRealizedItemCount() const { return (int)m_realized.size(); }
+
+    struct Stats {
+        uint64_t created;       // Widgets made by the factory
+        uint64_t bound;         // Binder calls
+        uint64_t recycled;      // Widgets returned to a pool
+        size_t realized;
+        size_t pooled;
+    };
+    Stats GetStats() const;
+    void ResetStats();
+
+    void Update(float deltaTime) override;
+    void Render(HDC hdc) override;
+    // Clipping to the viewport needs GDI; backends draw through their interop surface
+    void Render(RenderBackend& backend) override { Widget::Render(backend); }
+    // Items are made and bound, by application callbacks, on the UI thread
+    bool IsRenderThreadSafe() const override { return false; }
+    bool HandleMouseMove(int x, int y) override;
+    bool HandleMouseDown(int x, int y, int button) override;
+    bool HandleMouseUp(int x, int y, int button) override;
+    bool HandleMouseWheel(int x, int y, int delta) override;
+    bool HandleKeyDown(int keyCode) override;
+
+private:
+    struct RealizedItem {
+        int index;
+        int templateId;
+        std::shared_ptr<Widget> widget;
+    };
+
+    RECT GetViewportRect() const;
+    bool GetScrollTrack(RECT& track) const;     // False when everything fits
+    RECT GetThumbRect(const RECT& track) const;
+    int GetLineCount() const;
+    int GetLineExtent(int line) const;
+    const std::vector<int>& GetLineOffsets() const;
+    int GetMaxScroll() const;
+    int GetLineStep() const;
+    int GetColumnWidth(const RECT& viewport) const;
+
+    void Realize();
+    void RealizeRange(int first, int last, int columnWidth);
+    void RecycleAll();
+    void PlaceItems(const RECT& viewport);
+    void SetScrollPosition(float offset, bool animate);
+
+    int m_itemCount;
+    ItemFactory m_factory;
+    ItemBinder m_binder;
+    TemplateSelector m_templateSelector;
+
+    Arrangement m_arrangement;
+    int m_columns;
+    int m_estimatedExtent;
+    int m_itemSpacing;
+
+    std::vector<int> m_lineExtents;             // Measured, or -1 while estimated
+    mutable std::vector<int> m_lineOffsets;     // Line tops, then the total
+    mutable bool m_lineOffsetsDirty;
+
+    std::vector<RealizedItem> m_realized;       // By index
+    std::vector<RealizedItem> m_realizeScratch;
+    std::unordered_map<int, std::vector<std::shared_ptr<Widget>>> m_pool;   // By template
+    RECT m_realizedViewport;
+    bool m_realizeDirty;
+
+    float m_scrollOffset;
+    float m_scrollTarget;
+    bool m_draggingThumb;
+    int m_dragStartY;
+    float m_dragStartOffset;
+
+    Stats m_stats;
+};
+
+} // namespace SDK
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Platform.h"
+#include "Theme.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace SDK {
+
+class SharedAssetCache;
+
+/**
+ * ShadowCache - Nine-slice shadow and glow tiles
+ * Each (kind, blur/radius, corner radius, color) is rasterized once into a small
+ * premultiplied tile and then stretched to any rect size: corners are copied,
+ * edges and center are stretched from their one-pixel middle row/column.
+ * A tile missing here is copied from the current SharedAssetCache when it
+ * has one, rather than rasterized.
+ */
+class ShadowCache {
+public:
+    enum class Kind {
+        SHADOW,     // Blurred filled rounded rect
+        GLOW        // Linear falloff outside the rect, hollow center
+    };
+
+    struct NineSlice {
+        Kind kind;
+        int extent;         // Pixels covered outside the shape rect
+        int cornerRadius;
+        int slice;          // Corner tile size; the tile is (2 * slice + 1) square
+        int size;
+        std::vector<uint32_t> pixels;   // Premultiplied 0xAARRGGBB, stride == size
+
+        // Backends attach their own surface for the tile (e.g. a GDI memory DC);
+        // it is released together with the tile when the tile is evicted
+        mutable std::shared_ptr<void> platformData;
+
+        NineSlice() : kind(Kind::SHADOW), extent(0), cornerRadius(0), slice(0), size(0) {}
+    };
+
+    static std::shared_ptr<const NineSlice> GetShadow(int blur, int cornerRadius, Color color);
+    static std::shared_ptr<const NineSlice> GetGlow(int radius, Color color);
+
+    // Rect covered by the tile when drawn around shapeRect
+    static RECT GetOuterRect(const NineSlice& tile, const RECT& shapeRect);
+
+    // Split one axis of the outer rect into the three slice spans (destination and tile source)
+    struct SliceSpans {
+        int dstStart[3];
+        int dstLength[3];
+        int srcStart[3];
+        int srcLength[3];
+    };
+    static SliceSpans ComputeSpans(const NineSlice& tile, int outerLength);
+
+    // Software composite of the tile around shapeRect onto a premultiplied 0xAARRGGBB
+    // buffer whose top-left pixel is at (bufferLeft, bufferTop), source-over
+    static void Composite(const NineSlice& tile, const RECT& shapeRect,
+                          uint32_t* pixels, int bufferLeft, int bufferTop,
+                          int width, int height, int stride);
+
+    // Cache management
+    static void SetCapacity(size_t maxTiles);   // Least recently used tiles are evicted
+    static void Clear();
+    static size_t GetSize();
+
+    struct Stats {
+        uint64_t hits;
+        uint64_t misses;    // Tiles rasterized
+        size_t size;
+    };
+    static Stats GetStats();
+    static void ResetStats();
+
+    // Adds every cached tile to a cache being published; returns how many went in
+    static size_t ExportShared(SharedAssetCache& cache);
+
+private:
+    ShadowCache() = delete;
+};
+
+} // namespace SDK
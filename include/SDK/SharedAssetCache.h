@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Platform.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace SDK {
+
+/**
+ * SharedAssetCache - Read-only assets shared between processes
+ * One process creates a named shared-memory section, fills it with
+ * pre-rasterized assets and publishes it; other processes, typically the
+ * ones WindowHook themes, open it read-only and Attach() it, and the SDK's
+ * caches look there before building anything themselves:
+ * - Renderer's radial and conical gradients are blitted straight from the
+ *   section (Windows)
+ * - ShadowCache copies tiles in instead of blurring them
+ * - TextureAtlas::GetShared() starts with the published icons
+ * - NeuralNetwork::GetShared() loads the published model instead of
+ *   building one
+ * Each subsystem's ExportShared() adds what it holds. The section is a
+ * named file mapping on Windows ("Local\5DGUI.<name>", per session) and a
+ * POSIX shared memory object elsewhere ("/5DGUI.<name>"). Windows removes the
+ * name once no process holds it; on Linux the creator removes it when
+ * destroyed, so later processes can't open it, but those attached keep
+ * their mapping. Opening checks every offset against the section size, so
+ * a damaged or foreign section is refused rather than read past its end.
+ */
+class SharedAssetCache {
+public:
+    static constexpr uint32_t FORMAT_VERSION = 1;
+
+    ~SharedAssetCache();
+    SharedAssetCache(const SharedAssetCache&) = delete;
+    SharedAssetCache& operator=(const SharedAssetCache&) = delete;
+
+    // A writable section of capacity bytes; null when the name is taken on
+    // Windows or shared memory is unavailable. On Linux a leftover object of
+    // the same name is replaced.
+    static std::unique_ptr<SharedAssetCache> Create(const std::wstring& name, size_t capacity);
+    // Null unless the section exists, is published and has this format
+    static std::shared_ptr<const SharedAssetCache> Open(const std::wstring& name);
+
+    // Copies data in under key; false once published, when full, or when the key is taken
+    bool Add(std::string_view key, const void* data, size_t size);
+    // Writes the index and makes the entries visible to Open(); nothing can be added after
+    bool Publish();
+
+    struct Blob {
+        const void* data;       // Aligned to 16 bytes; valid while the cache is alive
+        size_t size;
+    };
+    bool Find(std::string_view key, Blob& blob) const;
+
+    bool IsPublished() const { return m_published; }
+    size_t GetEntryCount() const { return m_entryCount; }
+    size_t GetBytesUsed() const;
+    size_t GetCapacity() const { return m_capacity; }
+
+    // Cache the SDK's caches consult in this process; Attach() opens and sets it.
+    // InitOptions::sharedAssetCache attaches one during Initialize().
+    static bool Attach(const std::wstring& name);
+    static void SetCurrent(std::shared_ptr<const SharedAssetCache> cache);
+    static std::shared_ptr<const SharedAssetCache> GetCurrent();
+    // Find() on the current cache, counted in GetStats(); returns the cache
+    // that holds the blob, to be kept for as long as the blob is used
+    static std::shared_ptr<const SharedAssetCache> FindCurrent(std::string_view key, Blob& blob);
+
+    struct Stats {
+        uint64_t hits;      // Assets taken from the current cache instead of being built
+        uint64_t misses;
+    };
+    static Stats GetStats();
+    static void ResetStats();
+
+private:
+    struct Entry;
+
+    SharedAssetCache();
+    bool Map(const std::wstring& name, size_t capacity, bool create);
+    bool Validate();
+    void Unmap();
+
+    unsigned char* m_base;
+    size_t m_capacity;
+    size_t m_entryCount;
+    const Entry* m_entries;     // Sorted by key hash once published
+    std::vector<Entry> m_pending;
+    bool m_writable;
+    bool m_published;
+
+#if SDK_PLATFORM_WINDOWS
+    HANDLE m_mapping;
+#else
+    int m_fd;
+    std::string m_unlinkName;   // Set on the creator
+#endif
+};
+
+} // namespace SDK
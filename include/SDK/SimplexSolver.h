@@ -0,0 +1,178 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace SDK {
+
+/**
+ * SimplexSolver - Incremental Cassowary linear constraint solver
+ * Constraints are linear expressions compared against zero, each with a
+ * strength. Required constraints hold exactly; weaker ones are satisfied in
+ * strength order as far as the required ones allow. Edit variables take
+ * suggested values: SuggestValue() re-solves from the current tableau with a
+ * few dual simplex pivots, so dragging or resizing doesn't rebuild anything.
+ */
+class SimplexSolver {
+public:
+    using Variable = int;
+    using ConstraintId = int;
+
+    static constexpr ConstraintId INVALID_CONSTRAINT = -1;
+
+    enum class Relation {
+        EQUAL,
+        LESS_THAN_OR_EQUAL,     // expression <= 0
+        GREATER_THAN_OR_EQUAL   // expression >= 0
+    };
+
+    struct Term {
+        Variable variable;
+        double coefficient;
+    };
+
+    // Sum of the terms plus the constant
+    struct Expression {
+        std::vector<Term> terms;
+        double constant;
+
+        Expression() : constant(0.0) {}
+        explicit Expression(double value) : constant(value) {}
+
+        Expression& Add(Variable variable, double coefficient = 1.0) {
+            terms.push_back(Term{ variable, coefficient });
+            return *this;
+        }
+    };
+
+    // Each tier outweighs any amount of the one below it up to 1000x
+    static double Strength(double strong, double medium, double weak, double weight = 1.0);
+    static constexpr double REQUIRED = 1001001000.0;   // Strength(1000, 1000, 1000)
+    static constexpr double STRONG = 1000000.0;
+    static constexpr double MEDIUM = 1000.0;
+    static constexpr double WEAK = 1.0;
+
+    SimplexSolver();
+    ~SimplexSolver();
+    SimplexSolver(const SimplexSolver&) = delete;
+    SimplexSolver& operator=(const SimplexSolver&) = delete;
+
+    Variable AddVariable();
+    double GetValue(Variable variable) const;
+
+    // INVALID_CONSTRAINT when a required constraint contradicts the others;
+    // the solver is unchanged in that case
+    ConstraintId AddConstraint(const Expression& expression, Relation relation, double strength = REQUIRED);
+    bool RemoveConstraint(ConstraintId constraint);
+    bool HasConstraint(ConstraintId constraint) const;
+
+    // Edits must be weaker than REQUIRED; the variable starts suggested at 0
+    bool AddEditVariable(Variable variable, double strength);
+    bool RemoveEditVariable(Variable variable);
+    bool HasEditVariable(Variable variable) const;
+    bool SuggestValue(Variable variable, double value);
+
+    // Copies the solution into the values GetValue() reports
+    void UpdateVariables();
+
+    void Reset();
+
+    // Simplex pivots since the last Reset(); a measure of the work done
+    uint64_t GetPivotCount() const { return m_pivots; }
+
+private:
+    enum class SymbolType : uint8_t {
+        INVALID,
+        EXTERNAL,
+        SLACK,
+        ERROR_TERM,
+        DUMMY
+    };
+
+    struct Symbol {
+        uint64_t id;
+        SymbolType type;
+
+        Symbol() : id(0), type(SymbolType::INVALID) {}
+        Symbol(uint64_t symbolId, SymbolType symbolType) : id(symbolId), type(symbolType) {}
+
+        bool IsValid() const { return type != SymbolType::INVALID; }
+        bool operator<(const Symbol& other) const { return id < other.id; }
+        bool operator==(const Symbol& other) const { return id == other.id; }
+    };
+
+    // constant + sum(coefficient * symbol) for one basic variable. Cells are
+    // a vector sorted by symbol: rows are scanned far more than edited, and
+    // adding one row to another is a merge.
+    struct Row {
+        using Cell = std::pair<Symbol, double>;
+        std::vector<Cell> cells;
+        double constant;
+
+        Row() : constant(0.0) {}
+        explicit Row(double value) : constant(value) {}
+
+        double Add(double value) { return constant += value; }
+        void Insert(const Symbol& symbol, double coefficient);
+        void Insert(const Row& other, double coefficient);
+        void Remove(const Symbol& symbol);
+        void ReverseSign();
+        void SolveFor(const Symbol& symbol);
+        void SolveFor(const Symbol& lhs, const Symbol& rhs);
+        double CoefficientFor(const Symbol& symbol) const;
+        void Substitute(const Symbol& symbol, const Row& row);
+
+        std::vector<Cell>::iterator Find(const Symbol& symbol);
+        std::vector<Cell>::const_iterator Find(const Symbol& symbol) const;
+    };
+
+    // The slack/error symbols that identify a constraint in the tableau
+    struct Tag {
+        Symbol marker;
+        Symbol other;
+    };
+
+    struct ConstraintInfo {
+        Tag tag;
+        double strength;
+    };
+
+    struct EditInfo {
+        ConstraintId constraint;
+        double constant;
+    };
+
+    Symbol NewSymbol(SymbolType type) { return Symbol(++m_symbolTick, type); }
+
+    std::unique_ptr<Row> CreateRow(const Expression& expression, Relation relation, double strength, Tag& tag);
+    Symbol ChooseSubject(const Row& row, const Tag& tag) const;
+    bool AddWithArtificialVariable(const Row& row);
+    void Substitute(const Symbol& symbol, const Row& row);
+    bool Optimize(const Row& objective);
+    bool DualOptimize();
+    Symbol GetEnteringSymbol(const Row& objective) const;
+    Symbol GetDualEnteringSymbol(const Row& row) const;
+    Symbol AnyPivotableSymbol(const Row& row) const;
+    std::map<Symbol, std::unique_ptr<Row>>::iterator GetLeavingRow(const Symbol& entering);
+    std::map<Symbol, std::unique_ptr<Row>>::iterator GetMarkerLeavingRow(const Symbol& marker);
+    void RemoveConstraintEffects(const ConstraintInfo& info);
+    void RemoveMarkerEffects(const Symbol& marker, double strength);
+    static bool AllDummies(const Row& row);
+
+    std::map<Symbol, std::unique_ptr<Row>> m_rows;
+    std::vector<Symbol> m_variables;            // Indexed by Variable
+    std::vector<double> m_values;
+    std::map<ConstraintId, ConstraintInfo> m_constraints;
+    std::map<Variable, EditInfo> m_edits;
+    std::vector<Symbol> m_infeasibleRows;
+    std::unique_ptr<Row> m_objective;
+    std::unique_ptr<Row> m_artificial;
+    uint64_t m_symbolTick;
+    ConstraintId m_nextConstraint;
+    uint64_t m_pivots;
+};
+
+} // namespace SDK
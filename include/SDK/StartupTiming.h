@@ -0,0 +1,59 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+
+namespace SDK {
+
+/**
+ * StartupTiming - Where the time before the first frame went
+ * SDK::Initialize() brings up only what must exist before a window does; the
+ * other subsystems come up on first use. Each records how long it took here,
+ * as does the first presented frame, measured from Initialize(). Phases that
+ * never ran read as negative. Thread-safe.
+ */
+class StartupTiming {
+public:
+    enum class Phase {
+        INITIALIZE,         // All of SDK::Initialize()
+        DPI_MANAGER,
+        MONITOR_MANAGER,    // Monitor enumeration, on first use
+        WINDOW_MANAGER,
+        WINDOW_HOOK,        // In Initialize(), or after the first frame when deferred
+        NEURAL_NETWORK,     // The shared model, on first use
+        FIRST_FRAME,        // From Initialize() to the end of the first presented frame
+        COUNT
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    static void Start();    // Time zero; SDK::Initialize() calls it
+    // The first record of a phase stands
+    static void Record(Phase phase, Clock::time_point start, Clock::time_point end);
+    static void MarkFirstFrame();   // Cheap once the first frame is recorded
+
+    static double GetSeconds(Phase phase);     // Negative when it hasn't run
+    static const char* GetPhaseName(Phase phase);
+    // One line per phase that ran, in milliseconds
+    static std::string GetReport();
+    static void Reset();
+
+    // Records the time from construction to destruction
+    class Scope {
+    public:
+        explicit Scope(Phase phase) : m_phase(phase), m_start(Clock::now()) {}
+        ~Scope() { Record(m_phase, m_start, Clock::now()); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        Phase m_phase;
+        Clock::time_point m_start;
+    };
+
+private:
+    StartupTiming() = delete;
+};
+
+} // namespace SDK
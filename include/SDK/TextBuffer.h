@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <string>
+
+namespace SDK {
+
+struct TextBufferNode;
+
+/**
+ * TextBuffer - Editable text stored as a balanced rope
+ * Text lives in chunks at the leaves of a height-balanced tree whose nodes are
+ * never modified, so inserts and erases copy only the O(log n) nodes on the
+ * path. Copies share every node and cost O(1); keep one as an undo snapshot.
+ * Nodes also count line breaks, so line lookups are O(log n) as well.
+ */
+class TextBuffer {
+public:
+    TextBuffer() = default;
+    explicit TextBuffer(const std::wstring& text);
+
+    void SetText(const std::wstring& text);
+    std::wstring GetText() const;
+    std::wstring GetText(size_t offset, size_t length) const;
+    wchar_t GetChar(size_t offset) const;
+
+    size_t GetLength() const;
+    bool IsEmpty() const { return GetLength() == 0; }
+
+    // Offsets past the end are clamped
+    void Insert(size_t offset, const std::wstring& text);
+    void Erase(size_t offset, size_t length);
+    void Clear() { m_root.reset(); }
+
+    // Lines are separated by '\n'; there is always at least one
+    size_t GetLineCount() const;
+    size_t GetLineStart(size_t line) const;     // Offset of the line's first character
+    size_t GetLineLength(size_t line) const;    // Excluding the line break
+    std::wstring GetLine(size_t line) const;
+    void GetLine(size_t line, std::pmr::wstring& out) const;    // Replaces out, e.g. a FrameWString
+    size_t GetLineFromOffset(size_t offset) const;
+
+private:
+    std::shared_ptr<const TextBufferNode> m_root;
+};
+
+} // namespace SDK
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "Platform.h"
+#include "MemoryRegistry.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace SDK {
+
+class SharedAssetCache;
+
+/**
+ * TextureAtlas - Small images packed into one shared surface
+ * Textures are copied into a single 0xAARRGGBB buffer with skyline packing
+ * and drawn as sub-rects of it, so a toolbar full of icons is one bitmap
+ * rather than one per icon. When nothing fits, it drops the least recently
+ * drawn textures that aren't pinned and repacks the rest. Backends mirror the
+ * buffer into their own surface (a GDI DIB section, a Direct2D bitmap) and
+ * refresh it when GetVersion() changes.
+ */
+class TextureAtlas {
+public:
+    struct AtlasEntry {
+        int x, y, width, height;
+    };
+
+    TextureAtlas(int width, int height);
+    ~TextureAtlas() = default;
+    TextureAtlas(const TextureAtlas&) = delete;
+    TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+    // Shared by Toolbar and Image. Starts with the textures published in the
+    // current SharedAssetCache, so attach one before the first call.
+    static TextureAtlas& GetShared();
+
+    // Adds every texture, under its name, to a cache being published. Names
+    // should mean the same in every process, so publish an atlas of theme
+    // icons rather than one holding Toolbar or Image textures.
+    bool ExportShared(SharedAssetCache& cache) const;
+
+    // Copies the pixels in, replacing any texture of the same name. Pinned
+    // textures are never evicted. False when the texture can't fit even
+    // after eviction.
+    bool AddTexture(const std::string& name, const uint32_t* pixels, int width, int height, int stride, bool pinned = false);
+
+    // Copies a GDI bitmap's pixels; the caller keeps the bitmap. Fails where
+    // there is no GDI.
+    bool AddTexture(const std::string& name, HBITMAP bitmap, int width, int height, bool pinned = false);
+
+    // Null when absent or evicted. Counts as a use for eviction.
+    const AtlasEntry* GetTexture(const std::string& name) const;
+    bool RemoveTexture(const std::string& name);
+    void Clear();
+
+    // Repacks the remaining textures, reclaiming space left by removals
+    void Defragment();
+
+    // Blits a texture to hdc, stretched to dest; false when absent or there is no GDI
+    bool Draw(HDC hdc, const std::string& name, const RECT& dest) const;
+
+    int GetWidth() const { return m_width; }
+    int GetHeight() const { return m_height; }
+    size_t GetTextureCount() const { return m_textures.size(); }
+    float GetOccupancy() const;     // Fraction of the surface holding live textures
+
+    // GetTexture() lookups that found / missed their texture
+    uint64_t GetHitCount() const { return m_hits; }
+    uint64_t GetMissCount() const { return m_misses; }
+    void ResetStats() { m_hits = 0; m_misses = 0; }
+
+    // stride == GetWidth()
+    const uint32_t* GetPixels() const { return m_pixels.data(); }
+    uint64_t GetVersion() const { return m_version; }   // Changes whenever the pixels do
+
+    // Backend copies of the pixels, released with the atlas or by a
+    // MemoryRegistry trim; backends recreate a released copy on next draw
+    enum class Surface {
+        GDI,
+        DIRECT2D,
+        COUNT
+    };
+    std::shared_ptr<void>& GetPlatformSurface(Surface surface) const { return m_surfaces[(int)surface]; }
+
+private:
+    struct Entry {
+        AtlasEntry rect;
+        bool pinned;
+        mutable uint64_t lastUse;
+    };
+
+    // Top edge of the packed area over [x, x + width)
+    struct SkylineSegment {
+        int x, y, width;
+    };
+
+    bool Pack(int width, int height, int& outX, int& outY);
+    bool Place(const std::string& name, const uint32_t* pixels, int width, int height, int stride, bool pinned);
+    bool EvictFor(int width, int height);
+    void ResetSkyline();
+    bool ImportShared();    // From the current SharedAssetCache
+    size_t GetMemoryBytes() const;
+    void TrimMemory(size_t targetBytes);
+
+    int m_width;
+    int m_height;
+    std::vector<uint32_t> m_pixels;
+    std::vector<SkylineSegment> m_skyline;
+    std::unordered_map<std::string, Entry> m_textures;
+    size_t m_usedArea;
+    uint64_t m_version;
+    mutable uint64_t m_clock;
+    mutable uint64_t m_hits;
+    mutable uint64_t m_misses;
+    mutable std::shared_ptr<void> m_surfaces[(int)Surface::COUNT];
+
+    MemoryRegistry::Source m_memorySource;  // Last: unregisters before the rest goes
+};
+
+} // namespace SDK
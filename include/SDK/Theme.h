@@ -2,6 +2,7 @@
 
 
 #include "Platform.h"
+#include "PixelKernels.h"
 #include <string>
 #include <vector>
 
@@ -29,6 +30,16 @@ struct Color {
     static Color FromRGB(int r, int g, int b) {
         return Color(r, g, b, 255);
     }
+    
+    // 0xAARRGGBB with r, g and b scaled by a, for PixelKernels buffers
+    uint32_t ToPremultiplied() const {
+        return PremultipliedPixel::FromStraight(((uint32_t)a << 24) | ((uint32_t)r << 16) | ((uint32_t)g << 8) | b);
+    }
+    
+    static Color FromPremultiplied(uint32_t pixel) {
+        uint32_t argb = PremultipliedPixel::ToStraight(pixel);
+        return Color((argb >> 16) & 0xFF, (argb >> 8) & 0xFF, argb & 0xFF, argb >> 24);
+    }
 };
 
 // Gradient definition
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace SDK {
+
+/**
+ * TileScheduler - Splits pixel work into tiles for JobScheduler
+ * Each tile writes only its own part of the output, so results are identical
+ * for any worker count. Small buffers run inline on the caller.
+ */
+class TileScheduler {
+public:
+    // 64 x 64 32-bit pixels is 16 KB, which stays in L1/L2 with the kernel's sums
+    static constexpr int TILE_SIZE = 64;
+
+    // Work below this many pixels isn't worth waking the pool for
+    static constexpr size_t MIN_PARALLEL_PIXELS = 64 * 1024;
+
+    // Calls fn(begin, end) for consecutive chunks of grain indices covering [0, count)
+    // on JobScheduler's workers and the caller
+    static void ParallelFor(int count, int grain, const std::function<void(int begin, int end)>& fn);
+
+    // Row bands of at least TILE_SIZE rows, sized so each holds MIN_PARALLEL_PIXELS;
+    // calls fn(firstRow, lastRow)
+    static void ForEachRowBand(int width, int height, const std::function<void(int begin, int end)>& fn);
+
+    // Column strips of TILE_SIZE columns over the full height; calls fn(firstColumn, lastColumn)
+    static void ForEachColumnStrip(int width, int height, const std::function<void(int begin, int end)>& fn);
+
+private:
+    TileScheduler() = delete;
+};
+
+} // namespace SDK
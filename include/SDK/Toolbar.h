@@ -6,8 +6,10 @@
 #include <vector>
 #include <memory>
 #include <functional>
+#include <cstdint>
 #include "Widget.h"
 #include "Theme.h"
+#include "TextureAtlas.h"
 
 namespace SDK {
 
@@ -26,7 +28,9 @@ public:
         int id;
         std::wstring text;
         std::wstring tooltip;
-        HBITMAP icon;
+        std::wstring shortcut;  // Display text such as L"Ctrl+S"; empty for none
+        HBITMAP icon;           // Not owned; reloads iconName after eviction
+        std::string iconName;   // Texture in TextureAtlas::GetShared(); empty for none
         bool enabled;
         bool separator;
         void* userData;
@@ -48,7 +52,15 @@ public:
     void ClearItems();
     
     void SetItemEnabled(int id, bool enabled);
-    void SetItemIcon(int id, HBITMAP icon);
+    void SetItemShortcut(int id, const std::wstring& shortcut);
+    const std::vector<ToolbarItem>& GetItems() const { return m_items; }
+    // Clicks an enabled item as the mouse would; false for a separator,
+    // a disabled item or an unknown id
+    bool ClickItem(int id);
+    // Bumped when items or their shortcuts change
+    uint64_t GetRevision() const { return m_revision; }
+    void SetItemIcon(int id, HBITMAP icon);                     // Copied into the shared atlas; the caller keeps the bitmap
+    void SetItemIcon(int id, const std::string& atlasName);     // A texture already in the shared atlas
     
     // Orientation
     void SetOrientation(Orientation orientation);
@@ -113,8 +125,14 @@ private:
     
     ItemLayout* GetItemAt(int x, int y);
     
+    // Icons copied from an HBITMAP live under a key owned by this toolbar
+    std::string GetIconKey(int id) const;
+    const TextureAtlas::AtlasEntry* GetItemIcon(const ToolbarItem& item) const;
+    void ReleaseItemIcon(ToolbarItem& item);
+    
     std::vector<ToolbarItem> m_items;
     std::vector<ItemLayout> m_itemLayouts;
+    uint64_t m_revision;
     
     Orientation m_orientation;
     bool m_autoHide;
@@ -9,7 +9,10 @@ namespace SDK {
 
 /**
  * Tooltip - Popup text widget that appears on hover
- * Supports auto-positioning, fade animations, and multi-line text
+ * Supports auto-positioning, fade animations, and multi-line text. The
+ * tooltip is animated (Widget::SetAnimated), so a top-level one is drawn
+ * into a compositor layer once per content change; moving it and fading it
+ * in and out only recomposite that layer with the widget's opacity.
  */
 class Tooltip : public Widget {
 public:
@@ -86,9 +89,6 @@ public:
     // Check if currently showing
     bool IsShowing() const { return m_isShowing; }
     
-    // Opacity for fade effect
-    float GetOpacity() const { return m_opacity; }
-    
 private:
     void UpdatePosition();
     void ParseMultilineText();
@@ -101,7 +101,6 @@ private:
     int m_targetY;
     
     bool m_isShowing;
-    float m_opacity;
     
     bool m_fadeEnabled;
     float m_fadeSpeed;
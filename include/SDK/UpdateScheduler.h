@@ -0,0 +1,89 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace SDK {
+
+class Widget;
+
+/**
+ * UpdateScheduler - Timer wheel of widget wake-ups
+ * Widgets under a scheduler are ticked only when they asked to be: on the
+ * next frame while they animate, or at a deadline for timers and polling.
+ * Deadlines hash into a ring of SLOT_MS-wide slots, so scheduling is
+ * constant time and a tick visits only the slots that came due; deadlines
+ * further out than one turn wait in their slot for later rounds. With
+ * nothing due the loop can sleep for GetTimeUntilNextWake().
+ * Window owns one when update scheduling is on and Widget::AttachToTree
+ * registers its widgets; the scheduler only stores pointers.
+ */
+class UpdateScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr uint32_t SLOT_MS = 4;
+    static constexpr uint32_t SLOT_COUNT = 512;     // About two seconds per turn
+
+    UpdateScheduler();
+
+    // Registered widgets get one tick on the next frame
+    void Register(Widget* widget);
+    void Unregister(Widget* widget);
+    bool IsRegistered(const Widget* widget) const;
+    void Clear();
+
+    // An earlier wake-up replaces a later one, never the reverse
+    void WakeNextFrame(Widget* widget);
+    void WakeAfter(Widget* widget, float seconds);
+
+    // Moves the widgets due at now into the due list
+    void CollectDue(Clock::time_point now);
+    // Next due widget and the seconds since its last tick; null when done.
+    // Widgets unregistered meanwhile are skipped.
+    Widget* PopDue(float& deltaTime);
+
+    // Seconds until the earliest wake-up: 0 when a widget waits for the
+    // next frame, negative when none is scheduled
+    float GetTimeUntilNextWake(Clock::time_point now) const;
+
+    // Callable from any thread: the scheduler the widget is registered with
+    // wakes it on its next frame. Doesn't end a loop's idle wait; the caller
+    // wakes the widget's thread (e.g. with a posted message) when it sleeps.
+    static void RequestWake(Widget* widget);
+    static void CancelWake(Widget* widget);    // Widget's destructor calls it
+
+    size_t GetRegisteredCount() const { return m_states.size(); }
+    size_t GetScheduledCount() const { return m_scheduled; }
+
+private:
+    static constexpr uint64_t NEVER = ~0ull;
+
+    struct State {
+        uint64_t deadline;          // In ms since m_origin; NEVER when asleep
+        Clock::time_point lastTick;
+    };
+    struct SlotEntry {
+        Widget* widget;
+        uint64_t deadline;          // Stale once the state's deadline moves
+    };
+
+    uint64_t ToTicks(Clock::time_point time) const;
+    void Schedule(Widget* widget, State& state, uint64_t deadline);
+    void TakeWakeRequests();
+    bool HasWakeRequest() const;
+
+    Clock::time_point m_origin;
+    uint64_t m_cursor;              // Ms time of the last CollectDue
+    std::unordered_map<const Widget*, State> m_states;
+    std::vector<std::vector<SlotEntry>> m_slots;
+    std::vector<Widget*> m_nextFrame;
+    std::vector<Widget*> m_due;
+    size_t m_dueNext;
+    size_t m_scheduled;
+};
+
+} // namespace SDK
@@ -6,12 +6,22 @@
 #include <memory>
 #include <functional>
 #include <vector>
+#include <cstdint>
+#include "FontCache.h"
+#include "ImageCache.h"
+#include "TextBuffer.h"
 #include "Theme.h"
+#include "InternedString.h"
+#include "WidgetStyle.h"
+#include "WidgetTree.h"
 
 namespace SDK {
 
 // Forward declarations
 class Window;
+class WidgetManager;
+class WidgetSpatialIndex;
+class RenderBackend;
 
 // Widget event types
 enum class WidgetEvent {
@@ -28,18 +38,10 @@ enum class WidgetEvent {
     VALUE_CHANGED
 };
 
-// Widget alignment types
-enum class WidgetAlignment {
-    NONE,
-    LEFT,
-    RIGHT,
-    TOP,
-    BOTTOM,
-    CENTER,
-    TOP_LEFT,
-    TOP_RIGHT,
-    BOTTOM_LEFT,
-    BOTTOM_RIGHT
+// When a widget's event callback runs
+enum class EventDelivery : uint8_t {
+    IMMEDIATE,      // Inside TriggerEvent
+    COALESCED       // MOUSE_MOVE, VALUE_CHANGED and TEXT_CHANGED once a frame (EventQueue)
 };
 
 /**
@@ -75,8 +77,85 @@ public:
     // Hit testing
     virtual bool HitTest(int x, int y) const;
     
-    // Rendering
+    // Area that can receive mouse input (bounds plus any popup such as an open dropdown).
+    // Spatial indices bin widgets by this rect.
+    virtual void GetHitBounds(RECT& rect) const { GetBounds(rect); }
+    
+    // Geometry versioning for spatial indices: the widget's version changes whenever
+    // its position, size, z-index or hit bounds change, and the global epoch changes
+    // whenever any widget's geometry changes. A WidgetSpatialIndex holding the widget
+    // is also told directly.
+    uint64_t GetGeometryVersion() const { return m_geometryVersion; }
+    static uint64_t GetGeometryEpoch();
+    
+    // Dirty-region invalidation. Requests bubble up the parent chain to the
+    // handler installed by the owning Window, which repaints only that rect.
+    using InvalidateHandler = std::function<void(const RECT&)>;
+    void SetInvalidateHandler(InvalidateHandler handler);
+    void Invalidate();
+    void InvalidateRegion(const RECT& rect);
+    
+    // Rendering. Outside Windows there is no GDI, so the built-in widgets'
+    // Render(HDC) draws nothing and custom widgets need not override it.
+#if SDK_PLATFORM_WINDOWS
     virtual void Render(HDC hdc) = 0;
+#else
+    virtual void Render(HDC hdc);
+#endif
+    
+    // True when Render(HDC) reads only this widget's own state and draws
+    // through GdiObjectCache, FontCache and Renderer, so a window made of such
+    // widgets can redraw on a worker thread (Window::CanRenderOffscreen).
+    // Off unless a widget opts in; custom widgets may override it.
+    virtual bool IsRenderThreadSafe() const { return false; }
+    bool IsTreeRenderThreadSafe() const;    // This widget and its descendants
+    
+    // Draws through a backend so one widget tree renders on GDI, Direct2D or
+    // X11. Widgets without a backend path fall back to Render(HDC) on the
+    // backend's GDI interop surface, and are skipped where there is none.
+    virtual void Render(RenderBackend& backend);
+    
+    // Level of detail for the next Render(HDC): 0 is full detail, 1 drops
+    // decoration, 2 draws only a flat stand-in. Set by renderers that trade
+    // detail for speed; widgets without a simpler form ignore it.
+    void SetDetailLevel(int level) { m_detailLevel = level; }
+    int GetDetailLevel() const { return m_detailLevel; }
+    
+    // Part of the bounds painted fully opaque, for occlusion culling
+    virtual bool GetOpaqueBounds(RECT& /*rect*/) const { return false; }
+    
+    // Bounds grown to cover every visible descendant
+    void GetPaintBounds(RECT& rect) const;
+    
+    // Front-to-back occlusion pass over widgets drawn in order, the last on
+    // top. hidden[i] is set when widget i's paint bounds lie under the union
+    // of the opaque bounds of visible, fully opaque widgets drawn after it.
+    // Returns the number hidden.
+#if SDK_PLATFORM_WINDOWS
+    static int CullOccluded(const std::vector<std::shared_ptr<Widget>>& widgets, std::vector<uint8_t>& hidden);
+#endif
+    
+    // Compositor layer. A top-level animated widget is rasterized once into a
+    // layer that the Window composites with the widget's opacity and layer
+    // scale (about the bounds center) until its content changes. Position,
+    // opacity and scale changes then only recomposite; a move re-rasterizes
+    // widgets with children, whose bounds stay put. Nested widgets draw
+    // inside their parent's layer and ignore both settings.
+    void SetAnimated(bool animated);
+    bool IsAnimated() const { return m_animated; }
+    bool HasLayer() const { return m_animated && !m_parent; }
+    void SetLayerScale(float scale);
+    float GetLayerScale() const { return m_layerScale; }
+    
+    // Bumped on every content invalidation of the widget or a descendant
+    uint32_t GetContentVersion() const { return m_contentVersion; }
+    
+    // Untransformed layer extent: paint bounds grown by the invalidate margin
+    void GetLayerBounds(RECT& rect) const;
+    // Maps rect through the layer transform; unchanged without a layer
+    void ApplyLayerTransform(RECT& rect) const;
+    // Where the widget shows: the composited layer, or else the bounds
+    void GetCompositeBounds(RECT& rect) const;
     
     // Update (for animations)
     virtual void Update(float deltaTime);
@@ -89,17 +168,17 @@ public:
     virtual void OnMouseUp(int x, int y);
     virtual void OnClick();
     
-    // ID for identification
-    void SetId(int id) { m_id = id; }
+    // ID for identification; a WidgetManager holding the widget reindexes it
+    void SetId(int id);
     int GetId() const { return m_id; }
     
     // Tag for custom data
     void SetTag(void* tag) { m_tag = tag; }
     void* GetTag() const { return m_tag; }
     
-    // Name for identification
-    void SetName(const std::wstring& name) { m_name = name; }
-    std::wstring GetName() const { return m_name; }
+    // Name for identification; interned, so use names that repeat or stay put
+    void SetName(const std::wstring& name);
+    const std::wstring& GetName() const { return m_name; }
     
     // Padding properties
     void SetPadding(int padding);
@@ -123,31 +202,36 @@ public:
     
     // Border properties
     void SetBorderWidth(int width);
-    int GetBorderWidth() const { return m_borderWidth; }
+    int GetBorderWidth() const { return m_style->borderWidth; }
     void SetBorderRadius(int radius);
-    int GetBorderRadius() const { return m_borderRadius; }
+    int GetBorderRadius() const { return m_style->borderRadius; }
     
     // Tooltip
-    void SetTooltipText(const std::wstring& text) { m_tooltipText = text; }
-    std::wstring GetTooltipText() const { return m_tooltipText; }
+    void SetTooltipText(const std::wstring& text);
+    const std::wstring& GetTooltipText() const { return m_style->tooltipText; }
     
     // Cursor
-    void SetCursor(HCURSOR cursor) { m_cursor = cursor; }
-    HCURSOR GetCursor() const { return m_cursor; }
+    void SetCursor(HCURSOR cursor);
+    HCURSOR GetCursor() const { return m_style->cursor; }
     
     // Z-index for layering
-    void SetZIndex(int zIndex) { m_zIndex = zIndex; }
+    void SetZIndex(int zIndex) { m_zIndex = zIndex; NotifyGeometryChanged(); }
     int GetZIndex() const { return m_zIndex; }
     
     // Font properties
-    void SetFontFamily(const std::wstring& family) { m_fontFamily = family; }
-    std::wstring GetFontFamily() const { return m_fontFamily; }
+    void SetFontFamily(const std::wstring& family);
+    const std::wstring& GetFontFamily() const { return m_style->fontFamily; }
     void SetFontSize(int size);
-    int GetFontSize() const { return m_fontSize; }
-    void SetFontBold(bool bold) { m_fontBold = bold; }
-    bool IsFontBold() const { return m_fontBold; }
-    void SetFontItalic(bool italic) { m_fontItalic = italic; }
-    bool IsFontItalic() const { return m_fontItalic; }
+    int GetFontSize() const { return m_style->fontSize; }
+    void SetFontBold(bool bold);
+    bool IsFontBold() const { return m_style->fontBold; }
+    void SetFontItalic(bool italic);
+    bool IsFontItalic() const { return m_style->fontItalic; }
+    // DPI fonts are created at, for this widget and its children. Font sizes
+    // stay as given; Window::HandleDPIChange scales this with the bounds, and
+    // FontCache keeps each DPI's fonts, so moving back is a cache hit.
+    void SetDPI(int dpi);
+    int GetDPI() const { return m_dpi; }
     
     // Focus management
     void SetFocused(bool focused);
@@ -161,25 +245,60 @@ public:
     void RemoveChild(std::shared_ptr<Widget> child);
     const std::vector<std::shared_ptr<Widget>>& GetChildren() const { return m_children; }
     
+    // Flat copy of the hierarchy this widget sits in, kept by the WidgetManager
+    // or Window holding its top-level ancestor; null while detached. A widget
+    // is in at most one tree, so attaching moves it and its descendants.
+    WidgetTree* GetTree() const { return m_tree; }
+    WidgetHandle GetTreeHandle() const { return m_treeHandle; }
+    void AttachToTree(WidgetTree* tree, WidgetHandle parent = WidgetHandle());
+    void DetachFromTree();
+    
+    // Under a tree with an UpdateScheduler (Window::SetUpdateSchedulingEnabled)
+    // a widget is ticked only when it asks: ScheduleUpdate() for the next
+    // frame while it animates, or after delay seconds for a timer. Update()
+    // then gets the time since the widget's last tick and doesn't recurse;
+    // each child is ticked on its own. Otherwise the widget is ticked every
+    // frame and these calls do nothing.
+    void ScheduleUpdate(float delay = 0.0f);
+    bool IsUpdateScheduled() const;
+    
+    // Layout dirty flag; set on this widget and its ancestors. Size and child
+    // changes set it; call InvalidateLayout() when other content affects layout.
+    void InvalidateLayout();
+    bool IsLayoutDirty() const { return m_layoutDirty; }
+    void ClearLayoutDirty() { m_layoutDirty = false; }
+    
     // Event handling
     using EventCallback = std::function<void(Widget*, WidgetEvent, void* data)>;
-    void SetEventCallback(EventCallback callback) { m_eventCallback = callback; }
+    // A coalesced callback gets the newest data pointer of the frame's
+    // repeats, and other events after the widget's queued ones. Replacing a
+    // coalesced callback drops its queued events.
+    void SetEventCallback(EventCallback callback, EventDelivery delivery = EventDelivery::IMMEDIATE);
+    EventDelivery GetEventDelivery() const { return m_eventDelivery; }
     
     // Input handling
     virtual bool HandleMouseMove(int x, int y);
     virtual bool HandleMouseDown(int x, int y, int button);
     virtual bool HandleMouseUp(int x, int y, int button);
+    // delta in WHEEL_DELTA units, positive away from the user
+    virtual bool HandleMouseWheel(int x, int y, int delta);
     virtual bool HandleKeyDown(int keyCode);
     virtual bool HandleKeyUp(int keyCode);
     virtual bool HandleChar(wchar_t ch);
     
     // Theme support
-    void SetTheme(std::shared_ptr<Theme> theme) { m_theme = theme; }
-    std::shared_ptr<Theme> GetTheme() const { return m_theme; }
+    void SetTheme(std::shared_ptr<Theme> theme);
+    std::shared_ptr<Theme> GetTheme() const { return m_style->theme; }
     
     // Alignment properties
-    void SetAlignment(WidgetAlignment alignment) { m_alignment = alignment; }
-    WidgetAlignment GetAlignment() const { return m_alignment; }
+    void SetAlignment(WidgetAlignment alignment);
+    WidgetAlignment GetAlignment() const { return m_style->alignment; }
+    
+    // Shared style block behind the padding, margin, size limit, border, font,
+    // tooltip, cursor, theme and alignment properties; widgets with equal
+    // settings point at the same block
+    const WidgetStyle& GetStyle() const { return *m_style; }
+    void SetStyle(const WidgetStyle& style);
     void AlignToWidget(Widget* target, WidgetAlignment alignment, int spacing = 0);
     void AlignToParent(WidgetAlignment alignment, int margin = 0);
     
@@ -191,38 +310,83 @@ public:
 protected:
     void TriggerEvent(WidgetEvent event, void* data = nullptr);
     
+    // Call when anything reported by GetHitBounds or GetZIndex changes
+    void NotifyGeometryChanged();
+    
+    // Cached font for the widget's family, size, bold and italic settings
+#if SDK_PLATFORM_WINDOWS
+    FontCache::FontPtr GetFont(bool bold = false) const;
+#endif
+    int GetFontWeight() const { return m_style->fontBold ? FW_BOLD : FW_NORMAL; }
+    
+    // Replaces the style block with a pooled copy changed by edit; returns
+    // false, keeping the block, when the edit changed nothing
+    template<typename Edit>
+    bool EditStyle(Edit edit) {
+        WidgetStyle style = *m_style;
+        edit(style);
+        if (style == *m_style) return false;
+        m_style = WidgetStyle::Intern(style);
+        return true;
+    }
+    
+    // Backend counterpart of the children pass in Render(HDC)
+    void RenderChildren(RenderBackend& backend);
+    
+    // Bounds grown by the border width and a small margin
+    static constexpr int INVALIDATE_MARGIN = 2;
+    RECT GetInvalidateRect() const;
+    
+    // Repaints the layer where it is composited without bumping the content
+    // version, for changes a layer applies at composite time
+    void InvalidateLayer();
+    
+    // Opaque bounds of a shape filled with color and rounded by radius: the
+    // bounds inset past the corners, or false when color is translucent
+    bool GetRoundedOpaqueBounds(const Color& color, int radius, RECT& rect) const;
+    
+    // Ordered to pack; per-widget state only, shared settings live in m_style
     int m_x, m_y;
     int m_width, m_height;
-    bool m_visible;
-    bool m_enabled;
-    bool m_focused;
-    bool m_hovered;
     int m_id;
+    int m_zIndex;
     void* m_tag;
     
     Widget* m_parent;
     std::vector<std::shared_ptr<Widget>> m_children;
+    WidgetTree* m_tree;
+    WidgetHandle m_treeHandle;
+    WidgetManager* m_manager;       // Set while a WidgetManager holds the widget
+    uint32_t m_managerSlot;         // Position in its widget list
+    std::vector<WidgetSpatialIndex*> m_spatialIndexes;      // Indexes holding the widget
     
     EventCallback m_eventCallback;
-    std::shared_ptr<Theme> m_theme;
-    
-    // New properties
-    std::wstring m_name;
-    int m_paddingLeft, m_paddingTop, m_paddingRight, m_paddingBottom;
-    int m_marginLeft, m_marginTop, m_marginRight, m_marginBottom;
-    int m_minWidth, m_minHeight;
-    int m_maxWidth, m_maxHeight;
+    std::unique_ptr<InvalidateHandler> m_invalidateHandler;     // Only top-level widgets have one
+    
+    std::shared_ptr<const WidgetStyle> m_style;
+    InternedString m_name;
+    uint64_t m_geometryVersion;
     float m_opacity;
-    int m_borderWidth;
-    int m_borderRadius;
-    std::wstring m_tooltipText;
-    HCURSOR m_cursor;
-    int m_zIndex;
-    std::wstring m_fontFamily;
-    int m_fontSize;
-    bool m_fontBold;
-    bool m_fontItalic;
-    WidgetAlignment m_alignment;
+    int m_dpi;
+    int m_detailLevel;
+    float m_layerScale;
+    uint32_t m_contentVersion;
+    bool m_visible;
+    bool m_enabled;
+    bool m_focused;
+    bool m_hovered;
+    bool m_layoutDirty;
+    bool m_animated;
+    EventDelivery m_eventDelivery;
+    
+private:
+    friend class EventQueue;
+    friend class WidgetManager;
+    friend class WidgetSpatialIndex;
+    void DeliverEvent(WidgetEvent event, void* data);
+    void MarkContentChanged();
+    void PropagateInvalidate(const RECT& rect);
+    void ClearTreeLinks();
 };
 
 // Button widget
@@ -231,7 +395,7 @@ public:
     Button(const std::wstring& text = L"");
     virtual ~Button();
     
-    void SetText(const std::wstring& text) { m_text = text; }
+    void SetText(const std::wstring& text) { m_text = text; Invalidate(); }
     std::wstring GetText() const { return m_text; }
     
     void SetBackgroundColor(const Color& color) { m_backgroundColor = color; }
@@ -240,9 +404,12 @@ public:
     void SetPressColor(const Color& color) { m_pressColor = color; }
     
     void Render(HDC hdc) override;
+    bool IsRenderThreadSafe() const override { return true; }
+    void Render(RenderBackend& backend) override;
     bool HandleMouseMove(int x, int y) override;
     bool HandleMouseDown(int x, int y, int button) override;
     bool HandleMouseUp(int x, int y, int button) override;
+    bool GetOpaqueBounds(RECT& rect) const override;
     
 private:
     std::wstring m_text;
@@ -259,13 +426,15 @@ public:
     Label(const std::wstring& text = L"");
     virtual ~Label();
     
-    void SetText(const std::wstring& text) { m_text = text; }
+    void SetText(const std::wstring& text) { m_text = text; Invalidate(); }
     std::wstring GetText() const { return m_text; }
     
     void SetTextColor(const Color& color) { m_textColor = color; }
     void SetTextAlignment(UINT alignment) { m_textAlignment = alignment; }
     
     void Render(HDC hdc) override;
+    bool IsRenderThreadSafe() const override { return true; }
+    void Render(RenderBackend& backend) override;
     
 private:
     std::wstring m_text;
@@ -280,7 +449,12 @@ public:
     virtual ~TextBox();
     
     void SetText(const std::wstring& text);
-    std::wstring GetText() const { return m_text; }
+    std::wstring GetText() const { return m_text.GetText(); }
+    const TextBuffer& GetBuffer() const { return m_text; }
+    
+    // Each edit keeps a snapshot of the buffer (O(1), shared structure)
+    bool Undo();
+    bool CanUndo() const { return !m_undoStack.empty(); }
     
     void SetPlaceholder(const std::wstring& placeholder) { m_placeholder = placeholder; }
     void SetMaxLength(int maxLength) { m_maxLength = maxLength; }
@@ -290,14 +464,18 @@ public:
     void SetBorderColor(const Color& color) { m_borderColor = color; }
     
     void Render(HDC hdc) override;
+    void Render(RenderBackend& backend) override;
     bool HandleMouseDown(int x, int y, int button) override;
     bool HandleKeyDown(int keyCode) override;
     bool HandleChar(wchar_t ch) override;
+    bool GetOpaqueBounds(RECT& rect) const override;
     
 private:
     void UpdateCursorPosition();
+    void PushUndo();
     
-    std::wstring m_text;
+    TextBuffer m_text;
+    std::vector<std::pair<TextBuffer, int>> m_undoStack;    // Text and cursor position
     std::wstring m_placeholder;
     int m_maxLength;
     int m_cursorPosition;
@@ -315,13 +493,15 @@ public:
     CheckBox(const std::wstring& text = L"");
     virtual ~CheckBox();
     
-    void SetText(const std::wstring& text) { m_text = text; }
+    void SetText(const std::wstring& text) { m_text = text; Invalidate(); }
     std::wstring GetText() const { return m_text; }
     
     void SetChecked(bool checked);
     bool IsChecked() const { return m_checked; }
     
     void Render(HDC hdc) override;
+    bool IsRenderThreadSafe() const override { return true; }
+    void Render(RenderBackend& backend) override;
     bool HandleMouseDown(int x, int y, int button) override;
     
 private:
@@ -346,6 +526,8 @@ public:
     void SetColor(const Color& color) { m_color = color; }
     
     void Render(HDC hdc) override;
+    bool IsRenderThreadSafe() const override { return true; }
+    void Render(RenderBackend& backend) override;
     
 private:
     Orientation m_orientation;
@@ -353,24 +535,46 @@ private:
 };
 
 // Image widget
+// Files load through ImageCache: LoadFromFile returns at once and the
+// placeholder color fills the bounds until the decode lands. Stretched
+// images are drawn from a copy scaled to the widget's size, shared with
+// other Images showing the file at that size.
 class Image : public Widget {
 public:
     Image();
     virtual ~Image();
     
-    bool LoadFromFile(const std::wstring& filename);
-    bool LoadFromResource(HINSTANCE hInstance, int resourceId);
-    void SetHBITMAP(HBITMAP bitmap);
+    bool LoadFromFile(const std::wstring& filename);    // False when there is no such file
+    bool LoadFromResource(HINSTANCE hInstance, int resourceId);    // Windows only; false elsewhere
+    void SetHBITMAP(HBITMAP bitmap);                                // Windows only
     
     void SetStretchMode(bool stretch) { m_stretch = stretch; }
+    void SetPlaceholderColor(const Color& color) { m_placeholderColor = color; }
+    bool IsLoading() const { return m_pending != nullptr; }
     
+    void Update(float deltaTime) override;
     void Render(HDC hdc) override;
+    void Render(RenderBackend& backend) override;
     
 private:
-    HBITMAP m_bitmap;
+    // Takes ownership; images small enough move into the shared atlas
+    void AdoptBitmap(HBITMAP bitmap);
+    void ReleaseImage();
+    RECT GetImageRect() const;
+    void RequestImage();        // The file at the current display size
+    
+    HBITMAP m_bitmap;           // Only for images too large for the atlas
+    std::string m_atlasName;    // Pinned texture in TextureAtlas::GetShared(), or empty
     bool m_stretch;
     int m_imageWidth;
     int m_imageHeight;
+    
+    std::wstring m_path;                // File shown through ImageCache, or empty
+    ImageCache::EntryPtr m_image;       // Drawn; may be another size while m_pending loads
+    ImageCache::EntryPtr m_pending;
+    int m_requestWidth;                 // Size last asked of the cache; 0 x 0 for the file's own
+    int m_requestHeight;
+    Color m_placeholderColor;
 };
 
 // Slider widget
@@ -398,6 +602,8 @@ public:
     void SetFillColor(const Color& color) { m_fillColor = color; }
     
     void Render(HDC hdc) override;
+    bool IsRenderThreadSafe() const override { return true; }
+    void Render(RenderBackend& backend) override;
     bool HandleMouseDown(int x, int y, int button) override;
     bool HandleMouseMove(int x, int y) override;
     bool HandleMouseUp(int x, int y, int button) override;
@@ -422,7 +628,7 @@ public:
     RadioButton(const std::wstring& text = L"", int groupId = 0);
     virtual ~RadioButton();
     
-    void SetText(const std::wstring& text) { m_text = text; }
+    void SetText(const std::wstring& text) { m_text = text; Invalidate(); }
     std::wstring GetText() const { return m_text; }
     
     void SetChecked(bool checked);
@@ -432,6 +638,8 @@ public:
     int GetGroupId() const { return m_groupId; }
     
     void Render(HDC hdc) override;
+    bool IsRenderThreadSafe() const override { return true; }
+    void Render(RenderBackend& backend) override;
     bool HandleMouseDown(int x, int y, int button) override;
     
 private:
@@ -475,14 +683,24 @@ public:
     void ClampChildPosition(Widget* child);
     
     void Render(HDC hdc) override;
+    bool IsRenderThreadSafe() const override { return true; }
+    void Render(RenderBackend& backend) override;
     bool HandleMouseDown(int x, int y, int button) override;
+    bool GetOpaqueBounds(RECT& rect) const override;
     
     // Override to enforce boundaries on child widgets
     void AddChild(std::shared_ptr<Widget> child);
     
+protected:
+    // Background, border and title bar; false when the detail level stops there
+    bool RenderChrome(HDC hdc);
+    int GetTitleBarHeight() const { return m_title.empty() ? 0 : m_titleBarHeight; }
+    RECT GetCollapseButtonRect() const;
+    
 private:
     void RenderCollapseButton(HDC hdc, const RECT& buttonRect);
-    RECT GetCollapseButtonRect() const;
+    void RenderCollapseButton(RenderBackend& backend, const RECT& buttonRect);
+    void GetCollapseTriangle(const RECT& buttonRect, POINT triangle[3]) const;
     int GetCollapsedSize() const;
     
     std::wstring m_title;
@@ -518,6 +736,7 @@ public:
     int GetStep() const { return m_step; }
     
     void Render(HDC hdc) override;
+    void Render(RenderBackend& backend) override;
     bool HandleMouseDown(int x, int y, int button) override;
     bool HandleKeyDown(int keyCode) override;
     
@@ -5,6 +5,7 @@
 #include "Widget.h"
 #include "Renderer.h"
 #include "CameraController.h"
+#include "Widget3DBVH.h"
 
 namespace SDK {
 
@@ -27,7 +28,7 @@ public:
     void GetRotation3D(float& pitch, float& yaw, float& roll) const;
     
     // 3D scale
-    void SetScale3D(float scale) { m_scale3D = scale; }
+    void SetScale3D(float scale);
     float GetScale3D() const { return m_scale3D; }
     
     // Billboard mode - always face camera
@@ -45,12 +46,17 @@ public:
     void Render(HDC hdc) override;
     void Render3D(HDC hdc, CameraController* camera, int originX, int originY);
     
-    // Hit testing in 3D space
+    // Hit testing in 3D space, against a sphere of GetBoundingRadius()
+    float GetBoundingRadius() const;
     bool HitTest3D(const Renderer::Vector3D& rayOrigin, const Renderer::Vector3D& rayDirection, float& distance) const;
     
     // Get distance from camera (for sorting)
     float GetDistanceFromCamera(const CameraController* camera) const;
     
+    // Frustum test: depth along the view direction within the camera's near
+    // and far planes and, when viewport is given, a projected rect touching it
+    bool IsInFrustum(const CameraController* camera, int originX, int originY, const RECT* viewport = nullptr) const;
+    
     // Calculate ray from screen coordinates
     // Note: If camera is null, rayOrigin and rayDirection will be left unmodified.
     // Callers should verify camera is valid before calling this method.
@@ -184,8 +190,15 @@ public:
     // Sort widgets by depth (for proper rendering order)
     void SortByDepth(const CameraController* camera);
     
+    // Widgets left out of the last RenderAll by the frustum test
+    int GetCulledCount() const { return m_culledCount; }
+    
 private:
     std::vector<std::shared_ptr<Widget3D>> m_widgets;
+    Widget3DBVH m_bvh;                  // Picking; m_widgets is reordered by depth
+    std::vector<float> m_depthKeys;     // Per-frame sort keys, parallel to m_widgets
+    std::vector<size_t> m_depthOrder;   // Scratch for the full-sort fallback
+    int m_culledCount;
     std::shared_ptr<Widget3D> m_hoveredWidget;
     std::shared_ptr<Widget3D> m_focusedWidget;
 };
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Renderer.h"
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace SDK {
+
+class Widget3D;
+
+/**
+ * Widget3DBVH - Bounding volume hierarchy over 3D widget bounding spheres
+ * Ray picking descends only the boxes the ray enters, nearest first, and
+ * stops once no remaining box can beat the closest hit, so it runs in about
+ * logarithmic time rather than testing every widget. Like WidgetSpatialIndex
+ * it syncs lazily: after Widget::GetGeometryEpoch() moves, leaves whose
+ * geometry version changed (SetPosition3D, SetScale3D, SetSize) are refit
+ * and their ancestors' boxes grown or shrunk to match. The tree is rebuilt
+ * after inserts and removals, and once refits have degraded it.
+ */
+class Widget3DBVH {
+public:
+    Widget3DBVH();
+    ~Widget3DBVH() = default;
+
+    void Insert(std::shared_ptr<Widget3D> widget);
+    void Remove(const Widget3D* widget);
+    void Clear();
+
+    // Closest visible, enabled widget whose HitTest3D the ray passes, with
+    // its hit distance
+    std::shared_ptr<Widget3D> Raycast(const Renderer::Vector3D& origin, const Renderer::Vector3D& direction,
+                                      float& distance) const;
+
+    size_t GetCount() const { return m_entries.size(); }
+
+private:
+    struct Bounds {
+        float min[3];
+        float max[3];
+    };
+
+    struct Node {
+        Bounds bounds;
+        int left;       // Children, -1 for a leaf
+        int right;
+        int parent;
+        int entry;      // Leaf's index into m_entries, -1 for an inner node
+    };
+
+    struct Entry {
+        std::shared_ptr<Widget3D> widget;
+        uint64_t version;
+        int node;
+    };
+
+    static Bounds GetBounds(const Widget3D& widget);
+    void Sync() const;
+    void Build() const;
+    int BuildRange(size_t begin, size_t end, int parent) const;
+    void Refit(int node) const;
+
+    mutable std::vector<Entry> m_entries;
+    mutable std::vector<Node> m_nodes;
+    mutable std::vector<size_t> m_order;    // Build scratch: entries being split
+    mutable std::vector<std::pair<int, float>> m_stack;    // Raycast scratch: node, entry distance
+    mutable int m_root;
+    mutable bool m_dirty;
+    mutable size_t m_refits;                // Leaves refit since the last build
+    mutable uint64_t m_syncedEpoch;
+};
+
+} // namespace SDK
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace SDK {
+
+/**
+ * WidgetArena - Bump allocator for the widgets of one window or dialog
+ * Create() places each widget and its shared_ptr control block back to back
+ * in large blocks, so a tree built in one go sits contiguously and render
+ * traversal walks adjacent memory. Destroying a widget runs its destructor
+ * but frees nothing; the blocks go in one release when the arena and the
+ * last widget allocated from it are gone. One widget kept alive keeps its
+ * whole tree's blocks, so use an arena for trees that live and die together.
+ * Allocation is single-threaded; releasing widgets may happen on any thread.
+ */
+class WidgetArena {
+public:
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+    explicit WidgetArena(size_t blockSize = DEFAULT_BLOCK_SIZE);
+
+    WidgetArena(const WidgetArena&) = delete;
+    WidgetArena& operator=(const WidgetArena&) = delete;
+
+    void* Allocate(size_t size, size_t alignment);
+
+    template<typename T, typename... Args>
+    std::shared_ptr<T> Create(Args&&... args) {
+        return std::allocate_shared<T>(Allocator<T>(m_storage), std::forward<Args>(args)...);
+    }
+
+    size_t GetBytesUsed() const;        // Including alignment padding
+    size_t GetBytesReserved() const;
+    size_t GetBlockCount() const;
+
+    // Makes an arena current on this thread for MakeWidget(); nests, and a
+    // null arena turns the arena off inside the scope
+    class Scope {
+    public:
+        explicit Scope(WidgetArena* arena);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        WidgetArena* m_previous;
+    };
+    static WidgetArena* GetCurrent();
+
+private:
+    struct Storage;
+
+    template<typename T>
+    struct Allocator {
+        using value_type = T;
+
+        explicit Allocator(std::shared_ptr<Storage> storage) : storage(std::move(storage)) {}
+        template<typename U>
+        Allocator(const Allocator<U>& other) : storage(other.storage) {}
+
+        T* allocate(size_t count) {
+            return static_cast<T*>(AllocateFrom(*storage, count * sizeof(T), alignof(T)));
+        }
+        void deallocate(T*, size_t) {}     // Released with the blocks
+
+        template<typename U>
+        bool operator==(const Allocator<U>& other) const { return storage == other.storage; }
+        template<typename U>
+        bool operator!=(const Allocator<U>& other) const { return storage != other.storage; }
+
+        std::shared_ptr<Storage> storage;   // Control blocks keep the blocks alive
+    };
+
+    static void* AllocateFrom(Storage& storage, size_t size, size_t alignment);
+
+    std::shared_ptr<Storage> m_storage;
+};
+
+// Widget from the current arena if a WidgetArena::Scope is active, else make_shared
+template<typename T, typename... Args>
+std::shared_ptr<T> MakeWidget(Args&&... args) {
+    if (WidgetArena* arena = WidgetArena::GetCurrent()) {
+        return arena->Create<T>(std::forward<Args>(args)...);
+    }
+    return std::make_shared<T>(std::forward<Args>(args)...);
+}
+
+} // namespace SDK
@@ -1,8 +1,11 @@
 #pragma once
 
 #include "Widget.h"
+#include "WidgetSpatialIndex.h"
+#include "OptimizedWidgetRenderer.h"
 #include <vector>
 #include <memory>
+#include <unordered_map>
 
 namespace SDK {
 
@@ -15,18 +18,36 @@ public:
     WidgetManager();
     ~WidgetManager();
     
-    // Add/remove widgets
+    // Add/remove widgets. A widget belongs to one manager; adding it to
+    // another moves it. Removal is constant time: the widget leaves a hole
+    // that the next render, update or GetWidgets() closes.
     void AddWidget(std::shared_ptr<Widget> widget);
     void RemoveWidget(std::shared_ptr<Widget> widget);
     void RemoveWidgetById(int id);
     void Clear();
     
-    // Find widgets
+    // Find widgets; hashed, and kept current through SetId/SetName. With
+    // duplicates, the earliest added wins.
     std::shared_ptr<Widget> GetWidgetById(int id) const;
+    std::shared_ptr<Widget> GetWidgetByName(const std::wstring& name) const;
     std::shared_ptr<Widget> GetWidgetAt(int x, int y) const;
     
     // Render all widgets
     void RenderAll(HDC hdc);
+    void RenderAll(RenderBackend& backend);
+    
+    // Lets the optimizer choose how RenderAll(HDC) draws each widget inside
+    // the DC's clip box, as Window::SetRenderOptimizer() does. While set, the
+    // manager installs invalidate handlers on its widgets to keep their cache
+    // surfaces current, and forwards invalidations to SetInvalidateHandler's.
+    void SetRenderOptimizer(std::shared_ptr<RendererOptimizer> optimizer);
+    std::shared_ptr<RendererOptimizer> GetRenderOptimizer() const;
+    void SetInvalidateHandler(Widget::InvalidateHandler handler) { m_invalidateHandler = handler; }
+    
+    // Counts from the last RenderAll(); widgets covered by opaque widgets
+    // drawn after them are culled in every mode. RenderAll(HDC) blends
+    // animated widgets from their layers (LayerCompositor).
+    const OptimizedWidgetRenderer::Stats& GetRenderStats() const { return m_renderStats; }
     
     // Update all widgets (for animations)
     void UpdateAll(float deltaTime);
@@ -37,15 +58,44 @@ public:
     void HandleMouseUp(int x, int y);
     
     // Get all widgets
-    const std::vector<std::shared_ptr<Widget>>& GetWidgets() const { return m_widgets; }
+    const std::vector<std::shared_ptr<Widget>>& GetWidgets() const;
+    
+    // Flat copy of the managed widgets and their descendants
+    const WidgetTree& GetTree() const { return m_tree; }
+    Widget* Resolve(WidgetHandle handle) const { return m_tree.Get(handle); }
     
     // Enable/disable all widgets
     void SetAllEnabled(bool enabled);
     
 private:
-    std::vector<std::shared_ptr<Widget>> m_widgets;
+    friend class Widget;
+    void ReindexId(Widget* widget, int previousId);
+    void ReindexName(Widget* widget, InternedString previousName);
+    
+    void InstallInvalidateHandler(Widget& widget);
+    void CompactWidgets() const;
+    template <typename Key>
+    static Widget* FindIndexEntry(const std::unordered_multimap<Key, Widget*>& index, const Key& key);
+    
+    // Renders the widgets not covered by opaque widgets drawn after them;
+    // render returns false for widgets it composited instead of drawing
+    template <typename RenderFn>
+    void RenderUnoccluded(RenderFn render);
+    
+    WidgetTree m_tree;      // Outlives m_widgets, which detach from it
+    mutable std::vector<std::shared_ptr<Widget>> m_widgets;    // Null where removed
+    mutable size_t m_widgetHoles;
+    std::unordered_multimap<int, Widget*> m_widgetsById;
+    std::unordered_multimap<InternedString, Widget*> m_widgetsByName;
+    WidgetSpatialIndex m_widgetIndex;
     std::shared_ptr<Widget> m_hoveredWidget;
     std::shared_ptr<Widget> m_pressedWidget;
+    
+    std::unique_ptr<OptimizedWidgetRenderer> m_optimizedRenderer;
+    OptimizedWidgetRenderer::Stats m_renderStats;
+    std::vector<uint8_t> m_hiddenWidgets;
+    LayerCompositor m_compositor;
+    Widget::InvalidateHandler m_invalidateHandler;
 };
 
 } // namespace SDK
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Widget.h"
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace SDK {
+
+/**
+ * WidgetSpatialIndex - Uniform grid over widget hit bounds
+ * Point queries only look at the widgets binned in one cell, so hit testing
+ * stays near-constant regardless of widget count. Results follow z-order:
+ * higher GetZIndex() first, later insertion first among equal z-index.
+ * The index re-bins lazily: a held widget whose geometry changes marks itself
+ * dirty here, and the next query re-inserts only the dirty widgets.
+ */
+class WidgetSpatialIndex {
+public:
+    explicit WidgetSpatialIndex(int cellSize = 64);
+    ~WidgetSpatialIndex();
+
+    void Insert(std::shared_ptr<Widget> widget);
+    void Remove(const Widget* widget);
+    void Clear();
+
+    // Topmost visible widget whose hit bounds contain the point and whose
+    // Widget::HitTest accepts it
+    std::shared_ptr<Widget> HitTest(int x, int y) const;
+
+    // All visible widgets whose hit bounds contain the point, topmost first
+    void QueryPoint(int x, int y, std::vector<std::shared_ptr<Widget>>& results) const;
+
+    // All widgets whose hit bounds intersect rect, topmost first
+    void QueryRect(const RECT& rect, std::vector<std::shared_ptr<Widget>>& results) const;
+
+    void SetCellSize(int cellSize);
+    int GetCellSize() const { return m_cellSize; }
+    size_t GetCount() const { return m_entries.size(); }
+
+private:
+    struct Entry {
+        std::shared_ptr<Widget> widget;
+        RECT bounds;
+        int zIndex;
+        uint64_t order;
+        uint64_t stamp;     // Last QueryRect that visited the entry
+        bool oversized;     // Spans too many cells; kept in m_oversized instead
+        bool dirty;         // Queued in m_dirty
+    };
+
+    friend class Widget;
+
+    static int64_t CellKey(int cx, int cy) { return ((int64_t)cx << 32) ^ (uint32_t)cy; }
+    bool IsAbove(const Entry& a, const Entry& b) const;
+    void Bin(Entry& entry) const;
+    void Unbin(const Entry& entry) const;
+    void MarkDirty(const Widget* widget);
+    void Sync() const;
+    void SortTopmostFirst(std::vector<const Entry*>& entries) const;
+
+    int m_cellSize;
+    uint64_t m_nextOrder;
+    mutable uint64_t m_queryStamp;
+    mutable std::unordered_map<const Widget*, Entry> m_entries;
+    mutable std::vector<const Widget*> m_dirty;     // Moved since the last query
+    mutable std::unordered_map<int64_t, std::vector<const Widget*>> m_cells;
+    mutable std::vector<const Widget*> m_oversized;
+};
+
+} // namespace SDK
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Platform.h"
+#include "InternedString.h"
+#include "Theme.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace SDK {
+
+// Widget alignment types
+enum class WidgetAlignment {
+    NONE,
+    LEFT,
+    RIGHT,
+    TOP,
+    BOTTOM,
+    CENTER,
+    TOP_LEFT,
+    TOP_RIGHT,
+    BOTTOM_LEFT,
+    BOTTOM_RIGHT
+};
+
+/**
+ * WidgetStyle - Layout and visual properties most widgets leave at defaults
+ * Widgets point at a shared, immutable block instead of holding the fields
+ * themselves. Intern() returns the pooled block equal to a style, so widgets
+ * with the same padding, font and border share one; a setter on Widget
+ * copies its block, changes the field and interns the result (copy-on-write).
+ * Blocks nobody points at are dropped from the pool.
+ */
+struct WidgetStyle {
+    int paddingLeft = 0, paddingTop = 0, paddingRight = 0, paddingBottom = 0;
+    int marginLeft = 0, marginTop = 0, marginRight = 0, marginBottom = 0;
+    int minWidth = 0, minHeight = 0;
+    int maxWidth = 65535, maxHeight = 65535;
+    int borderWidth = 0;
+    int borderRadius = 0;
+    int fontSize = 12;
+    bool fontBold = false;
+    bool fontItalic = false;
+    WidgetAlignment alignment = WidgetAlignment::NONE;
+    InternedString fontFamily = L"Segoe UI";
+    std::wstring tooltipText;
+    HCURSOR cursor = nullptr;
+    std::shared_ptr<Theme> theme;
+
+    bool operator==(const WidgetStyle& other) const;
+    size_t Hash() const;
+
+    // Pooled block equal to style
+    static std::shared_ptr<const WidgetStyle> Intern(const WidgetStyle& style);
+    static const std::shared_ptr<const WidgetStyle>& GetDefault();
+
+    // Distinct blocks in use
+    static size_t GetPoolSize();
+};
+
+} // namespace SDK
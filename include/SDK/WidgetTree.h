@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace SDK {
+
+class Widget;
+class UpdateScheduler;
+
+// Slot in a WidgetTree; stale once the widget leaves the tree, even if the
+// slot is reused
+struct WidgetHandle {
+    static constexpr uint32_t INVALID = 0xFFFFFFFFu;
+
+    uint32_t index = INVALID;
+    uint32_t generation = 0;
+
+    bool IsValid() const { return index != INVALID; }
+    bool operator==(const WidgetHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const WidgetHandle& other) const { return !(*this == other); }
+};
+
+/**
+ * WidgetTree - Flat retained copy of a widget hierarchy
+ * Parent, first-child and next-sibling links are indices into parallel
+ * arrays, and GetOrder() lists the tree depth first in one contiguous array
+ * with each entry's subtree end, so a traversal is a linear scan that skips a
+ * hidden subtree in one step. Widgets keep owning their children through
+ * shared_ptr; WidgetManager and Window attach their widgets here, and
+ * Widget::AddChild/RemoveChild keep the copy in step.
+ */
+class WidgetTree {
+public:
+    struct OrderEntry {
+        Widget* widget;
+        uint32_t subtreeEnd;    // One past the entry's last descendant in GetOrder()
+        uint32_t depth;         // 0 for top-level widgets
+    };
+
+    // Appended as the parent's last child; an invalid parent adds a top-level widget
+    WidgetHandle Insert(Widget* widget, WidgetHandle parent = WidgetHandle());
+
+    // Removes the widget and its descendants; their handles go stale
+    void Remove(WidgetHandle handle);
+    void Clear();
+
+    // Null for stale handles
+    Widget* Get(WidgetHandle handle) const;
+    bool Contains(WidgetHandle handle) const { return Get(handle) != nullptr; }
+
+    WidgetHandle GetParent(WidgetHandle handle) const;
+    WidgetHandle GetFirstChild(WidgetHandle handle) const;
+    WidgetHandle GetNextSibling(WidgetHandle handle) const;
+    WidgetHandle GetFirstRoot() const { return MakeHandle(m_firstRoot); }
+
+    // Depth-first order, rebuilt after structural changes
+    const std::vector<OrderEntry>& GetOrder() const;
+    // Position of handle in GetOrder(), or INVALID
+    uint32_t GetOrderIndex(WidgetHandle handle) const;
+
+    size_t GetSize() const { return m_size; }
+
+    // Scheduler that widgets attaching to the tree register with; not owned
+    void SetUpdateScheduler(UpdateScheduler* scheduler) { m_updateScheduler = scheduler; }
+    UpdateScheduler* GetUpdateScheduler() const { return m_updateScheduler; }
+
+private:
+    static constexpr uint32_t NONE = WidgetHandle::INVALID;
+
+    WidgetHandle MakeHandle(uint32_t index) const;
+    bool IsLive(WidgetHandle handle) const;
+    void Unlink(uint32_t index);
+    void Release(uint32_t index);
+    void RebuildOrder() const;
+
+    // Indexed by slot
+    std::vector<Widget*> m_widgets;
+    std::vector<uint32_t> m_generations;
+    std::vector<uint32_t> m_parents;
+    std::vector<uint32_t> m_firstChildren;
+    std::vector<uint32_t> m_lastChildren;
+    std::vector<uint32_t> m_nextSiblings;
+    std::vector<uint32_t> m_prevSiblings;
+    std::vector<uint32_t> m_freeSlots;
+    uint32_t m_firstRoot = NONE;
+    uint32_t m_lastRoot = NONE;
+    size_t m_size = 0;
+    UpdateScheduler* m_updateScheduler = nullptr;
+
+    mutable std::vector<OrderEntry> m_order;
+    mutable std::vector<uint32_t> m_orderIndices;   // Slot -> position in m_order
+    mutable bool m_orderDirty = false;
+};
+
+} // namespace SDK
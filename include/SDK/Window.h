@@ -2,17 +2,29 @@
 
 
 #include "Platform.h"
+#include <chrono>
 #include <string>
 #include <memory>
 #include <functional>
 #include <vector>
 #include "Theme.h"
 #include "DPIManager.h"
+#include "Renderer.h"
+#include "RendererOptimizer.h"
+#include "WidgetSpatialIndex.h"
+#include "WidgetTree.h"
+#include "UpdateScheduler.h"
+#include "PointerHistory.h"
+#include "InputTrace.h"
 
 namespace SDK {
 
 // Forward declarations
 class Widget;
+class OptimizedWidgetRenderer;
+class LayerCompositor;
+class AcceleratorTable;
+class HeadlessRenderBackend;
 
 // Window depth levels for 5D rendering
 enum class WindowDepth {
@@ -23,6 +35,16 @@ enum class WindowDepth {
     FOREGROUND = 4        // 100% scale, alpha 255
 };
 
+// Whether a window can be seen; past OCCLUDED, the window is suspended
+enum class WindowVisibility {
+    VISIBLE,
+    OCCLUDED,       // Covered by opaque managed windows
+    OFF_SCREEN,     // On no connected monitor
+    CLOAKED,        // Hidden by DWM, e.g. on another virtual desktop
+    MINIMIZED,
+    HIDDEN
+};
+
 /**
  * Window - Enhanced window with 5D rendering support
  * Supports layered rendering, theming, and multimodal display
@@ -54,6 +76,9 @@ public:
     // Theming
     void SetTheme(std::shared_ptr<Theme> theme);
     std::shared_ptr<Theme> GetTheme() const { return m_theme; }
+    // The theme's metrics scaled to the window's DPI, shared through
+    // DPIManager's cache; nullptr without a theme
+    const ThemeMetrics* GetThemeMetrics();
     
     // Rounded corners
     void SetRoundedCorners(bool enabled, int radius = 12);
@@ -77,39 +102,199 @@ public:
     void BeginUpdate();
     void EndUpdate();
     
-    // Custom rendering callback
-    void SetRenderCallback(std::function<void(HDC)> callback);
+    // Custom rendering callback. threadSafe: it draws only from its own state
+    // and the SDK's thread-safe caches, so the window may render off the UI
+    // thread (see CanRenderOffscreen)
+    void SetRenderCallback(std::function<void(HDC)> callback, bool threadSafe = false);
     void Render(HDC hdc);
     
+    // Full repaint of the client area into backend, resized to fit, through
+    // its GDI interop: snapshots and golden-image tests. Call on the window's
+    // thread; false when the window has no client area.
+    bool RenderSnapshot(HeadlessRenderBackend& backend);
+    
+    // Dirty-region repaint: only the merged invalidated rects are redrawn into the
+    // cached back buffer and blitted. Widgets added to the window report here.
+    void InvalidateRegion(const RECT& rect);
+    void SetPartialRedrawEnabled(bool enabled) { m_partialRedraw = enabled; }
+    bool IsPartialRedrawEnabled() const { return m_partialRedraw; }
+    
+    struct FrameStats {
+        long long repaintedPixels;  // Pixels redrawn into the back buffer
+        int dirtyRects;             // Merged rects redrawn this frame
+        int widgetsRendered;
+        int widgetsSkipped;         // Widgets outside every dirty rect
+        int widgetsCached;          // Blitted from their cache surface (render optimizer)
+        int widgetsSimplified;      // Drawn at reduced detail (render optimizer)
+        int widgetsOccluded;        // Covered by opaque widgets drawn after them
+        int layersComposited;       // Animated widgets blended from their layer
+        int layersRasterized;       // Of those, layers whose content was redrawn
+        bool fullRedraw;
+        bool resizePreview;         // The last frame shown again during a live resize
+        float renderTime;           // Seconds spent in the render, presenting included
+        
+        FrameStats() : repaintedPixels(0), dirtyRects(0), widgetsRendered(0), widgetsSkipped(0),
+                       widgetsCached(0), widgetsSimplified(0), widgetsOccluded(0),
+                       layersComposited(0), layersRasterized(0), fullRedraw(false), resizePreview(false),
+                       renderTime(0.0f) {}
+    };
+    const FrameStats& GetFrameStats() const { return m_frameStats; }
+    
+    // Live resize: call BeginLiveResize() on WM_ENTERSIZEMOVE and
+    // EndLiveResize() on WM_EXITSIZEMOVE. While the user drags, renders show
+    // the last full frame stretched (or cropped) to the new size, background
+    // filling the rest, and a full frame runs at most once per interval. In
+    // WM_SIZE, re-run the layout only when TakeResizeFrame() returns true.
+    // EndLiveResize() invalidates the window for the final layout and render.
+    enum class LiveResizeMode {
+        OFF,        // Every render is a full one
+        STRETCH,
+        CROP        // Unscaled, anchored at the top left
+    };
+    void SetLiveResizeMode(LiveResizeMode mode) { m_liveResizeMode = mode; }
+    LiveResizeMode GetLiveResizeMode() const { return m_liveResizeMode; }
+    // Default: 0.1; 0 renders in full only at EndLiveResize()
+    void SetLiveResizeInterval(float seconds) { m_liveResizeInterval = seconds > 0.0f ? seconds : 0.0f; }
+    float GetLiveResizeInterval() const { return m_liveResizeInterval; }
+    void BeginLiveResize();
+    void EndLiveResize();
+    bool IsLiveResizing() const { return m_liveResizing; }
+    // True when a full layout and render are due; false when the next render
+    // is a preview. Renders ask it themselves when the application didn't.
+    bool TakeResizeFrame();
+    
+    // Frame-scheduled windows don't post WM_PAINT for their own invalidations;
+    // WindowManager::RunFrame() picks them up once per display refresh instead.
+    // System-initiated WM_PAINT still goes through Render().
+    void SetFrameScheduled(bool scheduled) { m_frameScheduled = scheduled; }
+    bool IsFrameScheduled() const { return m_frameScheduled; }
+    bool HasPendingFrame() const { return m_framePending; }
+    
+    // Background throttling (WindowManager::EnableBackgroundThrottling).
+    // RunFrame() refreshes the visibility every frame. An occluded window's
+    // widgets and window animations tick once per throttle interval; a
+    // suspended window neither ticks nor renders, and keeps its invalidations
+    // for when it is seen again. Work tied to a window, such as particles,
+    // can gate itself with AccumulateBackgroundTime(): pending collects the
+    // frames' deltas, and when it returns true the caller advances by pending
+    // and resets it, so skipped time is caught up rather than lost.
+    WindowVisibility QueryVisibility(bool occluded) const;
+    WindowVisibility GetVisibility() const { return m_visibility; }
+    void SetVisibility(WindowVisibility visibility) { m_visibility = visibility; }
+    bool IsSuspended() const { return m_visibility > WindowVisibility::OCCLUDED; }
+    void SetThrottleInterval(float seconds) { m_throttleInterval = seconds > 0.0f ? seconds : 0.0f; }
+    float GetThrottleInterval() const { return m_throttleInterval; }
+    bool AccumulateBackgroundTime(float deltaTime, float& pending) const;
+    // The manager's own gate for the window's widgets and animations
+    bool TakeBackgroundTick(float deltaTime);
+    
+    // Redraws only what was invalidated; for a DC from GetDC, which has no
+    // update region to add
+    void RenderPending(HDC hdc);
+    
+    // A render in three steps, so WindowManager can redraw several windows'
+    // back buffers at once. BeginFrame() picks the regions to redraw; false
+    // when there are none, or when it painted hdc directly for want of a back
+    // buffer. DrawFrame() redraws them into the back buffer and may run on
+    // another thread, one window per thread at a time. PresentFrame() copies
+    // them to hdc. Begin and present stay on the UI thread.
+    bool BeginFrame(HDC hdc, bool includeClipBox);
+    void DrawFrame();
+    void PresentFrame(HDC hdc);
+    
+    // True when DrawFrame() may run off the UI thread: partial redraw is on,
+    // no render optimizer is set, every widget is render-thread-safe
+    // (Widget::IsRenderThreadSafe) and the render callback, if any, was
+    // declared thread-safe
+    bool CanRenderOffscreen() const;
+    
+    // Lets the optimizer choose how each widget is redrawn: in full, from a
+    // cache surface the window manages, at reduced detail, or not at all when
+    // an opaque widget covers it. Render times are reported back to it.
+    // nullptr returns to plain rendering.
+    void SetRenderOptimizer(std::shared_ptr<RendererOptimizer> optimizer);
+    std::shared_ptr<RendererOptimizer> GetRenderOptimizer() const;
+    
     // Widget management
     void AddWidget(std::shared_ptr<Widget> widget);
     void RemoveWidget(std::shared_ptr<Widget> widget);
     void ClearWidgets();
     const std::vector<std::shared_ptr<Widget>>& GetWidgets() const { return m_widgets; }
+    // Flat copy of the window's widgets and their descendants
+    const WidgetTree& GetWidgetTree() const { return m_widgetTree; }
     
     // Widget input handling
+    // Mouse events are routed through a spatial index: only widgets under the
+    // cursor, the widget holding the mouse capture, and widgets the cursor just
+    // left receive them. Key and char events still go to every widget.
     bool HandleWidgetMouseMove(int x, int y);
     bool HandleWidgetMouseDown(int x, int y, int button);
     bool HandleWidgetMouseUp(int x, int y, int button);
-    bool HandleWidgetKeyDown(int keyCode);
+    bool HandleWidgetMouseWheel(int x, int y, int delta);   // From WM_MOUSEWHEEL, in client coordinates
+    bool HandleWidgetKeyDown(int keyCode);     // Accelerators first, then widgets
     bool HandleWidgetKeyUp(int keyCode);
     bool HandleWidgetChar(wchar_t ch);
     
+    // With coalescing on (the default), a move from WM_MOUSEMOVE is skipped
+    // when a newer one is already waiting, so widgets see only the latest
+    // position. The positions between two dispatched moves are read back with
+    // GetMouseMovePointsEx, kept in the pointer history, and are
+    // PointerHistory::GetCoalesced() while widgets handle the move.
+    void SetMouseMoveCoalescing(bool enabled) { m_coalesceMouseMoves = enabled; }
+    bool IsMouseMoveCoalescing() const { return m_coalesceMouseMoves; }
+    const PointerHistory& GetPointerHistory() const { return m_pointerHistory; }
+    
+    // The handlers above add their input to an open InputTrace::Recording.
+    // ReplayEvent() feeds a recorded event back through them; with coalescing
+    // on, replayed moves wait for the next other event or ReplayFrame().
+    // WindowManager::Replay() drives both.
+    void ReplayEvent(const InputEvent& event);
+    void ReplayFrame();
+    
+    // Shortcuts of menus and toolbars, dispatched by HandleWidgetKeyDown()
+    // before any widget sees the key. nullptr for none.
+    void SetAcceleratorTable(std::shared_ptr<AcceleratorTable> table) { m_accelerators = table; }
+    std::shared_ptr<AcceleratorTable> GetAcceleratorTable() const { return m_accelerators; }
+    
     // Update widgets
+    // With update scheduling on, only widgets that asked for a tick
+    // (Widget::ScheduleUpdate) are updated, each with the time since its own
+    // last tick, and WindowManager::RunFrame() calls this itself. Every widget
+    // gets one tick when it is added.
     void UpdateWidgets(float deltaTime);
+    void SetUpdateSchedulingEnabled(bool enabled);
+    bool IsUpdateSchedulingEnabled() const { return m_updateScheduling; }
+    // Seconds until a scheduled widget is due: 0 when one is, negative when
+    // none is scheduled
+    float GetTimeUntilNextUpdate() const;
     
     // DPI Support (v2.0)
     DPIScaleInfo GetDPIScale() const;
     void HandleDPIChange(const DPIScaleInfo& oldDPI, const DPIScaleInfo& newDPI);
     void UpdateForDPI();
     
+    // Screen rects for occlusion culling between windows: the client area,
+    // and the part of it known to be painted opaque (none while hidden,
+    // minimized or translucent)
+    bool GetClientScreenRect(RECT& rect) const;
+    bool GetOpaqueScreenRect(RECT& rect) const;
+    
     // Monitor Support (v2.0)
     HMONITOR GetMonitor() const;
     void HandleMonitorChange(HMONITOR oldMonitor, HMONITOR newMonitor);
     
+    // From WM_COMPACTING: trims every MemoryRegistry source
+    void HandleLowMemory();
+    
 private:
     void ApplyDepthSettings();
     void UpdateLayeredWindow();
+    void RenderFrame(HDC hdc, bool includeClipBox);
+    void RenderContent(HDC hdc, const RECT& rect, const std::vector<RECT>& regions);
+    void RenderResizePreview(HDC hdc, const RECT& rect);
+    void CollectMovePoints(int x, int y);      // Fills m_moveSamples for a move being dispatched
+    bool DispatchMouseMove(int x, int y);
+    void FlushReplayedMoves();
     
     HWND m_hwnd;
     WindowDepth m_depth;
@@ -125,8 +310,22 @@ private:
     float m_shadowIntensity;
     
     std::shared_ptr<Theme> m_theme;
+    std::shared_ptr<const ThemeMetrics> m_themeMetrics;    // m_theme at m_currentDPI
     std::function<void(HDC)> m_renderCallback;
+    bool m_renderCallbackThreadSafe;
+    UpdateScheduler m_updateScheduler;
+    WidgetTree m_widgetTree;    // Outlives m_widgets, which detach from it
     std::vector<std::shared_ptr<Widget>> m_widgets;
+    WidgetSpatialIndex m_widgetIndex;
+    std::vector<std::shared_ptr<Widget>> m_widgetsUnderMouse;   // Candidates of the last mouse move
+    std::shared_ptr<Widget> m_capturedWidget;   // Accepted the last mouse down; gets moves and the up
+    std::shared_ptr<Widget> m_activeWidget;     // Offered the next mouse down first (e.g. to close a dropdown)
+    std::shared_ptr<AcceleratorTable> m_accelerators;
+    bool m_coalesceMouseMoves;
+    PointerHistory m_pointerHistory;
+    std::vector<PointerSample> m_moveSamples;   // The dispatched move's coalesced positions
+    uint32_t m_lastMoveTime;                    // Message time of the last dispatched move; 0 before one
+    std::vector<PointerSample> m_replayedMoves; // Replayed moves not yet dispatched
     
     // v2.0: DPI and Monitor support
     DPIScaleInfo m_currentDPI;
@@ -135,6 +334,29 @@ private:
     // Flag to defer appearance updates during batch changes
     bool m_deferUpdates;
     bool m_needsUpdate;
+    
+    // Back buffer and dirty regions for partial repaints
+    std::unique_ptr<Renderer::RenderCache> m_renderCache;
+    bool m_partialRedraw;
+    FrameStats m_frameStats;
+    RECT m_frameRect;                   // Between BeginFrame() and PresentFrame()
+    std::vector<RECT> m_frameRegions;
+    bool m_frameScheduled;
+    bool m_framePending;    // Invalidated since the last render
+    bool m_updateScheduling;
+    WindowVisibility m_visibility;
+    float m_throttleInterval;
+    float m_backgroundPending;
+    
+    LiveResizeMode m_liveResizeMode;
+    float m_liveResizeInterval;
+    bool m_liveResizing;
+    int m_resizeFrame;          // TakeResizeFrame() since the last render: -1 not asked, else its answer
+    std::chrono::steady_clock::time_point m_resizeRenderTime;  // Last full frame while resizing
+    
+    std::unique_ptr<OptimizedWidgetRenderer> m_optimizedRenderer;
+    std::vector<uint8_t> m_hiddenWidgets;   // Occlusion pass scratch
+    std::unique_ptr<LayerCompositor> m_compositor;  // Layers of animated widgets
 };
 
 } // namespace SDK
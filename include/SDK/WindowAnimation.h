@@ -2,6 +2,8 @@
 
 
 #include "Platform.h"
+#include "Renderer.h"
+#include "Easing.h"
 #include <functional>
 #include <chrono>
 #include <vector>
@@ -65,6 +67,8 @@ public:
     WindowAnimation(HWND hwnd);
     ~WindowAnimation();
     
+    HWND GetHandle() const { return m_hwnd; }
+    
     // Configuration
     void SetMinimizeAnimation(AnimationType type) { m_minimizeType = type; }
     AnimationType GetMinimizeAnimation() const { return m_minimizeType; }
@@ -81,10 +85,17 @@ public:
     void SetEasingType(EasingType easing) { m_easing = easing; }
     EasingType GetEasingType() const { return m_easing; }
     
-    // Bezier curve control
-    void SetBezierCurve(const BezierCurve& curve) { m_bezierCurve = curve; }
+    // Bezier curve control; curves are solved once and shared (see Easing)
+    void SetBezierCurve(const BezierCurve& curve) { m_bezierCurve = curve; m_bezierSolver.reset(); }
     BezierCurve GetBezierCurve() const { return m_bezierCurve; }
     
+    // Scale and zoom animations capture the window once and present scaled,
+    // faded frames of it with UpdateLayeredWindow, instead of resizing the
+    // window (and so repainting all of it) every frame. The window's own
+    // painting comes back when the animation ends. On by default.
+    void SetLayerCompositing(bool enabled) { m_layerCompositing = enabled; }
+    bool IsLayerCompositing() const { return m_layerCompositing; }
+    
     // Animation control
     void AnimateMinimize();
     void AnimateMaximize();
@@ -103,6 +114,9 @@ public:
     
     // Update animation (call from message loop)
     void Update();
+    // Update at a given frame time, e.g. FrameClock::GetFrameTime(), so every
+    // animation ticked in a frame samples the same instant
+    void Update(std::chrono::steady_clock::time_point frameTime);
     
     // Callbacks
     void SetOnAnimationComplete(std::function<void()> callback) {
@@ -121,6 +135,7 @@ private:
     int m_duration; // milliseconds
     EasingType m_easing;
     BezierCurve m_bezierCurve;
+    mutable std::shared_ptr<const Easing::CubicBezier> m_bezierSolver;    // m_bezierCurve's, on first use
     
     bool m_paused;
     bool m_reversed;
@@ -134,14 +149,27 @@ private:
     
     std::function<void()> m_onComplete;
     
+    // Window layer for scale and zoom
+    bool m_layerCompositing;
+    bool m_layerActive;
+    LONG m_savedExStyle;
+    BYTE m_layerAlpha;                  // Alpha of the last presented frame
+    Renderer::PixelSurface m_layer;     // The window as captured
+    Renderer::PixelSurface m_frame;     // Scaled frame handed to UpdateLayeredWindow
+    
     // Helper methods
-    float GetProgress() const;
+    float GetProgress(std::chrono::steady_clock::time_point now) const;
     float ApplyEasing(float t) const;
     float EvaluateBezier(float t) const;
     void PerformFadeAnimation(float progress);
     void PerformSlideAnimation(float progress);
     void PerformScaleAnimation(float progress);
     void PerformZoomAnimation(float progress);
+    void MoveFrame(int left, int top, int width, int height, float progress);
+    BYTE GetAlpha(float progress) const;
+    bool BeginLayer();
+    void PresentLayer(int left, int top, int width, int height, BYTE alpha);
+    void EndLayer();
     void CompleteAnimation();
 };
 
@@ -176,6 +204,7 @@ public:
     
     // Update all animations (call from message loop)
     void Update();
+    void Update(std::chrono::steady_clock::time_point frameTime);
     
     // Configuration
     void SetPlayMode(PlayMode mode) { m_playMode = mode; }
@@ -3,10 +3,13 @@
 
 #include "Platform.h"
 #include "InstructionDecoder.h"
+#include <atomic>
 #include <functional>
+#include <string>
 #include <unordered_map>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 namespace SDK {
 
@@ -17,6 +20,26 @@ class WindowManager;
 // Hook callback type
 using CreateWindowCallback = std::function<void(HWND)>;
 
+/**
+ * CreateWindowFilter - A pre-filter rule for windows seen by the hook
+ * A window matches when its class name (compared without ASCII case; empty
+ * matches any) and its masked style and extended style bits all match.
+ */
+struct CreateWindowFilter {
+    std::wstring className;
+    DWORD styleMask;
+    DWORD style;            // Required value of dwStyle & styleMask
+    DWORD exStyleMask;
+    DWORD exStyle;          // Required value of dwExStyle & exStyleMask
+    bool include;           // Matching windows go to the callback, or are skipped
+    
+    CreateWindowFilter() : styleMask(0), style(0), exStyleMask(0), exStyle(0), include(false) {}
+    
+    static CreateWindowFilter ExcludeClass(const std::wstring& name);
+    static CreateWindowFilter ExcludeStyle(DWORD mask, DWORD value);
+    static CreateWindowFilter ExcludeExStyle(DWORD mask, DWORD value);
+};
+
 /**
  * WindowHook - Enhanced hooking system with inline hooking support
  * Intercepts window creation to enable custom rendering and theming
@@ -40,6 +63,19 @@ public:
     // Register callback for window creation
     void RegisterCreateCallback(CreateWindowCallback callback);
     
+    // Pre-filter run inside the hook before the callback, without allocating.
+    // Rules are checked in order and the first match decides; windows matching
+    // none reach the callback, message-only windows never do. The table starts
+    // with GetDefaultFilters(): tooltips, IME and COM/OLE helper windows.
+    void AddCreateFilter(const CreateWindowFilter& filter);
+    void SetCreateFilters(const std::vector<CreateWindowFilter>& filters);
+    void ClearCreateFilters() { SetCreateFilters(std::vector<CreateWindowFilter>()); }
+    static std::vector<CreateWindowFilter> GetDefaultFilters();
+    
+    // Whether a window created with these arguments passes the filter
+    bool PassesCreateFilter(HWND hwnd, LPCWSTR className, DWORD style, DWORD exStyle, HWND parent) const;
+    uint64_t GetFilteredCount() const { return m_filteredCount.load(std::memory_order_relaxed); }
+    
     // Hooked CreateWindowExW function
     static HWND WINAPI HookedCreateWindowExW(
         DWORD dwExStyle,
@@ -90,6 +126,24 @@ private:
     // IAT hook helper
     PIMAGE_THUNK_DATA FindIATEntry(HMODULE hModule, const char* dllName, const char* functionName);
     
+    // A filter with its class name folded to lower case and hashed
+    struct CompiledFilter {
+        uint32_t classHash;     // 0 when any class matches
+        std::wstring className;
+        DWORD styleMask;
+        DWORD style;
+        DWORD exStyleMask;
+        DWORD exStyle;
+        bool include;
+    };
+    using FilterTable = std::vector<CompiledFilter>;
+    
+    static CompiledFilter CompileFilter(const CreateWindowFilter& filter);
+    static uint32_t HashClassName(const wchar_t* name, size_t& length);
+    
+    std::shared_ptr<const FilterTable> m_filters;   // Swapped whole; read in the hook with an atomic load
+    mutable std::atomic<uint64_t> m_filteredCount;
+    
     CreateWindowExW_t m_pOriginalCreateWindowExW;
     void* m_pTrampoline;
     BYTE m_originalBytes[32];  // Increased size for safety
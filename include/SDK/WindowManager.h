@@ -2,22 +2,34 @@
 
 
 #include "Platform.h"
+#include <atomic>
+#include <functional>
+#include <mutex>
 #include <vector>
 #include <memory>
-#include <unordered_map>
+#include <unordered_set>
 #include "Window.h"
+#include "WindowRegistry.h"
 #include "WindowGroup.h"
 #include "WindowSnapping.h"
 #include "Theme.h"
+#include "FrameClock.h"
+#include "AnimationTimeline.h"
+#include "InputTrace.h"
 
 namespace SDK {
 
 // Forward declaration
 class WindowAnimation;
+class AnimationGroup;
 
 /**
  * WindowManager - Manages multiple windows with multimodal support
- * Handles window creation, depth sorting, and rendering orchestration
+ * Handles window creation, depth sorting, and rendering orchestration.
+ * RegisterWindow, UnregisterWindow, GetWindow and GetWindowsByDepth are safe
+ * from any thread (the CreateWindowExW hook registers windows on the thread
+ * creating them); the rest belongs to the UI thread, which renders from a
+ * snapshot of the registry without locking.
  */
 class WindowManager {
 public:
@@ -32,8 +44,16 @@ public:
     void UnregisterWindow(HWND hwnd);
     std::shared_ptr<Window> GetWindow(HWND hwnd);
     
+    // Registers hwnd when it is first needed instead of now: on the first
+    // GetWindow() or RegisterWindow() for it, or the first RunFrame() or
+    // RenderAllWindows() while it is visible. Used by the CreateWindowExW
+    // hook, so creating a window only records its handle.
+    void QueueWindow(HWND hwnd);
+    size_t GetQueuedWindowCount() const { return m_queuedCount.load(std::memory_order_relaxed); }
+    
     // Get all windows sorted by depth
     std::vector<std::shared_ptr<Window>> GetWindowsByDepth() const;
+    WindowRegistry::SnapshotPtr GetWindowSnapshot() const { return m_registry.GetSnapshot(); }
     
     // Multimodal window support
     void SetActiveModal(HWND hwnd);
@@ -46,7 +66,21 @@ public:
     
     // Rendering
     void RenderAllWindows();
-    void UpdateWindowDepths();
+    void UpdateWindowDepths();  // Call after changing windows' depths
+    
+    // RenderAllWindows() and RunFrame() cull windows whose client area is
+    // covered by opaque managed windows above them in the screen z-order.
+    // Culled windows keep their invalidations and render once uncovered.
+    int GetCulledWindowCount() const { return m_culledWindows; }   // At the last pass
+    
+    // RenderAllWindows() and RunFrame() redraw the back buffers of windows
+    // that can render offscreen (Window::CanRenderOffscreen) in parallel on
+    // JobScheduler workers, then present every window on this thread back to
+    // front. Each window draws only into its own buffer, so the result is the
+    // same as rendering one by one. Other windows render here in their turn.
+    // On by default.
+    void EnableParallelRendering(bool enabled) { m_parallelRendering = enabled; }
+    bool IsParallelRenderingEnabled() const { return m_parallelRendering; }
     
     // Animation and effects
     void EnableDepthAnimation(bool enabled);
@@ -54,6 +88,56 @@ public:
     
     void Update(float deltaTime);
     
+    // Frame pacing: RunFrame() waits for the next display refresh, ticks the
+    // registered animations and Update() at that frame's time, then renders
+    // back to front only the windows invalidated since their last render.
+    // With scheduling enabled, windows stop posting WM_PAINT for their own
+    // invalidations, so changes to any number of windows land in one frame.
+    // Windows with update scheduling on get their due widgets ticked too.
+    // Typical loop: drain PeekMessage, then if (!RunFrame())
+    // MsgWaitForMultipleObjects(0, nullptr, FALSE, GetIdleTimeout(), QS_ALLINPUT).
+    void EnableFrameScheduling(bool enabled);
+    bool IsFrameSchedulingEnabled() const { return m_frameScheduling; }
+    bool HasPendingFrame() const;
+    bool RunFrame();    // False, without waiting, when nothing needs a frame
+    // Milliseconds until a scheduled widget update is due, INFINITE when none is
+    DWORD GetIdleTimeout() const;
+    
+    // RunFrame() tracks each window's visibility (see Window::QueryVisibility).
+    // Occluded windows' scheduled widgets and window animations tick once per
+    // throttle interval; minimized, cloaked, off-screen and hidden windows are
+    // suspended and neither tick, render nor breathe, except that minimize and
+    // restore animations always run. Time-based state catches up when a
+    // window is seen again. On by default.
+    void EnableBackgroundThrottling(bool enabled) { m_backgroundThrottling = enabled; }
+    bool IsBackgroundThrottlingEnabled() const { return m_backgroundThrottling; }
+    
+    FrameClock& GetFrameClock() { return m_frameClock; }
+    const FrameClock& GetFrameClock() const { return m_frameClock; }
+    
+    // Runs the callback on this thread once RunFrame() or RenderAllWindows()
+    // has presented a first frame, or at once if one has. For startup work
+    // that can wait until the app is on screen.
+    void RunAfterFirstFrame(std::function<void()> callback);
+    
+    // Replays a recorded trace at full speed into windows, indexed as in the
+    // trace. Each frame of the fixed clock delivers the due events, ticks the
+    // timeline, Update() and the windows' widgets, and renders every window;
+    // nothing waits for the display.
+    InputTrace::ReplayStats Replay(const InputTrace& trace, const std::vector<std::shared_ptr<Window>>& windows,
+                                   double frameRate = 60.0);
+    
+    // Tracks advanced by RunFrame() at the frame's delta time. Window moves
+    // made by animations during RunFrame() are applied in one
+    // DeferWindowPos batch (see DeferredWindowPos).
+    AnimationTimeline& GetTimeline() { return m_timeline; }
+    
+    // Ticked by RunFrame(); not owned, remove before destroying
+    void AddAnimation(WindowAnimation* animation);
+    void RemoveAnimation(WindowAnimation* animation);
+    void AddAnimationGroup(AnimationGroup* group);
+    void RemoveAnimationGroup(AnimationGroup* group);
+    
     // Advanced window features
     WindowSnapping& GetSnapping() { return m_snapping; }
     const WindowSnapping& GetSnapping() const { return m_snapping; }
@@ -65,18 +149,48 @@ private:
     WindowManager(const WindowManager&) = delete;
     WindowManager& operator=(const WindowManager&) = delete;
     
-    void SortWindowsByDepth();
+    void CullOccludedWindows(const WindowRegistry::Snapshot& windows) const;
+    // Renders windows.byDepth[i] for each index, in the given order
+    void RenderWindows(const WindowRegistry::Snapshot& windows, const std::vector<size_t>& indices,
+                       bool pendingOnly);
+    void ThrottleWindows(const WindowRegistry::Snapshot& windows, float deltaTime);
+    bool IsWindowSuspended(const Window& window) const;
+    bool TakeQueuedWindow(HWND hwnd);
+    void RegisterVisibleQueuedWindows();
+    void FinishFirstFrame();
     
-    std::unordered_map<HWND, std::shared_ptr<Window>> m_windows;
-    std::vector<std::shared_ptr<Window>> m_sortedWindows;
+    WindowRegistry m_registry;
     
-    HWND m_activeModal;
+    // Handles from QueueWindow() not yet registered
+    std::unordered_set<HWND> m_queuedWindows;
+    std::atomic<size_t> m_queuedCount;
+    std::mutex m_queueMutex;
+    
+    std::atomic<HWND> m_activeModal;
     std::shared_ptr<Theme> m_defaultTheme;
     
     bool m_depthAnimation;
     float m_animationTime;
     
     WindowSnapping m_snapping;
+    
+    std::atomic<bool> m_frameScheduling;
+    FrameClock m_frameClock;
+    AnimationTimeline m_timeline;
+    std::vector<WindowAnimation*> m_animations;
+    std::vector<AnimationGroup*> m_animationGroups;
+    
+    mutable std::vector<uint8_t> m_windowOccluded;     // Parallel to the culled snapshot's byDepth
+    std::vector<uint8_t> m_windowTicked;                // Parallel to RunFrame's snapshot
+    bool m_backgroundThrottling;
+    mutable int m_culledWindows;
+    bool m_parallelRendering;
+    std::vector<size_t> m_renderIndices;                // RenderWindows() arguments, reused
+    std::vector<uint8_t> m_renderSteps;                 // Parallel to the indices passed to RenderWindows()
+    std::vector<Window*> m_offscreenWindows;
+    
+    bool m_firstFramePresented;
+    std::vector<std::function<void()>> m_afterFirstFrame;
 };
 
 } // namespace SDK
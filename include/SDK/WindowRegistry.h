@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Platform.h"
+#include "Window.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace SDK {
+
+/**
+ * WindowRegistry - Managed windows by handle and in depth order
+ * Readers take an immutable snapshot with one atomic load and never wait for
+ * a writer, so windows registered from the CreateWindowExW hook on other
+ * threads don't stall the UI thread. Writers are serialized among
+ * themselves: each copies the current snapshot, changes the copy and
+ * publishes it. A new window goes to its place in the depth order by binary
+ * search; Resort() repairs the order after depth changes with an insertion
+ * sort, which only moves the windows whose depth changed.
+ */
+class WindowRegistry {
+public:
+    struct Snapshot {
+        std::vector<std::shared_ptr<Window>> byDepth;   // Back to front; registration order within a depth
+        std::vector<int> depths;                        // Parallel to byDepth, as of the last sort
+        std::vector<HWND> handles;                      // Sorted
+        std::vector<uint32_t> handleIndex;              // Parallel to handles, into byDepth
+        uint64_t version;
+
+        Snapshot() : version(0) {}
+
+        static constexpr size_t NOT_FOUND = (size_t)-1;
+        size_t IndexOf(HWND hwnd) const;                // Into byDepth
+        std::shared_ptr<Window> Find(HWND hwnd) const;
+        size_t Size() const { return byDepth.size(); }
+    };
+    using SnapshotPtr = std::shared_ptr<const Snapshot>;
+
+    WindowRegistry();
+    ~WindowRegistry() = default;
+
+    WindowRegistry(const WindowRegistry&) = delete;
+    WindowRegistry& operator=(const WindowRegistry&) = delete;
+
+    // Safe from any thread; the snapshot stays valid while held
+    SnapshotPtr GetSnapshot() const { return std::atomic_load(&m_snapshot); }
+    std::shared_ptr<Window> Find(HWND hwnd) const { return GetSnapshot()->Find(hwnd); }
+
+    // Returns the window already registered for the handle, if there is one,
+    // instead of adding window
+    std::shared_ptr<Window> Insert(const std::shared_ptr<Window>& window);
+    bool Remove(HWND hwnd);
+    void Resort();      // After windows' depths changed
+    void Clear();
+
+private:
+    static void IndexHandles(Snapshot& snapshot);
+    void Publish(const std::shared_ptr<Snapshot>& snapshot);
+
+    SnapshotPtr m_snapshot;
+    std::mutex m_writeMutex;
+};
+
+} // namespace SDK
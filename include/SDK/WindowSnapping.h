@@ -10,7 +10,10 @@ namespace SDK {
 
 /**
  * WindowSnapping - Provides window snapping functionality
- * Supports edge snapping, grid snapping, and magnetic windows
+ * Supports edge snapping, grid snapping, and magnetic windows. Other windows'
+ * edges are kept in sorted lists and the nearest one within the threshold
+ * is found by binary search. Between BeginMove() and EndMove() the lists and
+ * the monitors' work areas are read once, not on every WM_MOVING.
  */
 class WindowSnapping {
 public:
@@ -48,7 +51,23 @@ public:
     RECT ApplySnapping(HWND hwnd, const RECT& proposed,
                        const std::vector<std::shared_ptr<Window>>& windows);
     
+    // Call on WM_ENTERSIZEMOVE and WM_EXITSIZEMOVE. Snaps of hwnd in between
+    // use the edges of windows and monitors as they were at BeginMove().
+    void BeginMove(HWND hwnd, const std::vector<std::shared_ptr<Window>>& windows);
+    void EndMove();
+    bool IsMoving() const { return m_moveHwnd != nullptr; }
+    
 private:
+    struct EdgeList {
+        std::vector<RECT> workAreas;    // Every monitor's
+        // Other windows' edges, each list sorted
+        std::vector<int> lefts;
+        std::vector<int> rights;
+        std::vector<int> tops;
+        std::vector<int> bottoms;
+    };
+    
+
     bool m_edgeSnapEnabled;
     bool m_gridSnapEnabled;
     bool m_magneticEnabled;
@@ -59,10 +78,19 @@ private:
     int m_gridWidth;
     int m_gridHeight;
     
+    HWND m_moveHwnd;            // Window being moved, or nullptr
+    EdgeList m_moveEdges;       // Read at BeginMove()
+    EdgeList m_scratchEdges;    // Read per snap outside a move
+    
     // Helper methods
     bool IsNearEdge(int value, int edge, int threshold) const;
     int SnapToValue(int value, int target, int threshold) const;
     RECT GetScreenWorkArea(HWND hwnd);
+    static RECT GetWorkArea(const RECT& proposed, const std::vector<RECT>& workAreas);
+    static void CollectWindowEdges(HWND hwnd, const std::vector<std::shared_ptr<Window>>& windows,
+                                   EdgeList& edges);
+    static bool FindNearest(const std::vector<int>& edges, int value, int threshold, int& nearest);
+    static BOOL CALLBACK WorkAreaEnumProc(HMONITOR hMonitor, HDC hdcMonitor, LPRECT lprcMonitor, LPARAM dwData);
 };
 
 } // namespace SDK
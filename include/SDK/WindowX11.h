@@ -6,8 +6,14 @@
 
 #include <X11/Xlib.h>
 #include <X11/Xutil.h>
+#include "FrameClock.h"
+#include "PointerHistory.h"
+#include "InputTrace.h"
+#include <atomic>
+#include <chrono>
 #include <string>
 #include <memory>
+#include <mutex>
 #include <functional>
 #include <vector>
 
@@ -41,6 +47,7 @@ public:
     void SetTitle(const std::wstring& title);
     void SetPosition(int x, int y);
     void SetSize(int width, int height);
+    void SetBounds(int x, int y, int width, int height);    // One XConfigureWindow
     void GetPosition(int& x, int& y) const;
     void GetSize(int& width, int& height) const;
     
@@ -49,10 +56,18 @@ public:
     bool HasPendingEvents() const;
     
     // Rendering
+    // Frame-scheduled windows (those from X11WindowManager) only mark themselves
+    // on Invalidate(); the event loop paints them at the next refresh. Others
+    // send themselves an Expose.
     void Invalidate();
     void BeginPaint();
     void EndPaint();
     
+    void SetFrameScheduled(bool scheduled) { m_frameScheduled = scheduled; }
+    bool IsFrameScheduled() const { return m_frameScheduled; }
+    bool HasPendingFrame() const { return m_framePending; }
+    void RenderPendingFrame();
+    
     // Callbacks
     void SetCloseCallback(std::function<void()> callback) { m_closeCallback = callback; }
     void SetPaintCallback(std::function<void()> callback) { m_paintCallback = callback; }
@@ -60,12 +75,58 @@ public:
     void SetMouseButtonCallback(std::function<void(int, int, int, bool)> callback) { m_mouseButtonCallback = callback; }
     void SetKeyCallback(std::function<void(int, bool)> callback) { m_keyCallback = callback; }
     
+    // With coalescing on (the default), ProcessEvents() reports a run of
+    // queued MotionNotify events as one move to the latest position, just
+    // before the next other event or when the queue drains. Every position is
+    // kept in the pointer history and is PointerHistory::GetCoalesced()
+    // during the move callback.
+    void SetMotionCoalescing(bool enabled);
+    bool IsMotionCoalescing() const { return m_coalesceMotion; }
+    const PointerHistory& GetPointerHistory() const { return m_pointerHistory; }
+    
+    // ProcessEvents() adds the input it handles, resizes and closes to an
+    // open InputTrace::Recording. ReplayEvent() feeds a recorded event to the
+    // callbacks the way ProcessEvents() would; a replayed resize only marks a
+    // frame. ReplayFrame() reports the pending move and paints a pending
+    // frame. X11WindowManager::Replay() drives both.
+    void ReplayEvent(const InputEvent& event);
+    void ReplayFrame();
+    
     // Get render backend
     std::shared_ptr<X11RenderBackend> GetRenderBackend() const { return m_renderBackend; }
     
+    /**
+     * ConfigureBatch - Defers window moves and resizes on the calling thread
+     * While one is open, SetPosition, SetSize and SetBounds record the change,
+     * merged per window. Closing the outermost batch sends one
+     * XConfigureWindow per window and flushes each connection once, so a
+     * group of windows moves together. Batches nest.
+     */
+    class ConfigureBatch {
+    public:
+        ConfigureBatch();
+        ~ConfigureBatch();
+        
+        ConfigureBatch(const ConfigureBatch&) = delete;
+        ConfigureBatch& operator=(const ConfigureBatch&) = delete;
+    };
+    
 private:
+    struct ConfigureQueue {
+        int depth;
+        std::vector<WindowX11*> windows;
+        
+        ConfigureQueue() : depth(0) {}
+    };
+    
+    static ConfigureQueue& GetConfigureQueue();     // The calling thread's
+    void Configure(unsigned int mask, int x, int y, int width, int height);
+    void SendConfigure();
+    
     void InitializeX11();
     void ProcessEvent(XEvent& event);
+    void AddMotion(const PointerSample& sample);
+    void DispatchMotion();      // Reports the pending motion, if any
     int XKeyToVirtualKey(KeySym keysym);
     
     Display* m_display;
@@ -77,6 +138,16 @@ private:
     int m_width;
     int m_height;
     
+    unsigned int m_configureMask;   // CW* changes waiting for a batch to close
+    XWindowChanges m_configure;
+    
+    bool m_frameScheduled;
+    bool m_framePending;
+    
+    bool m_coalesceMotion;
+    std::vector<PointerSample> m_pendingMotion;     // Since the last move reported
+    PointerHistory m_pointerHistory;
+    
     std::shared_ptr<X11RenderBackend> m_renderBackend;
     
     // Callbacks
@@ -89,9 +160,14 @@ private:
 
 /**
  * X11WindowManager - Manages X11 windows and event loop
+ * The loop blocks in poll() on the X connections, an eventfd for wakeups from
+ * other threads and the nearest timer deadline, so an idle GUI takes no CPU.
+ * Invalidated windows are painted at most once per display refresh.
  */
 class X11WindowManager {
 public:
+    using Callback = std::function<void()>;
+    
     static X11WindowManager& GetInstance();
     
     // Window management
@@ -101,16 +177,54 @@ public:
     // Event loop
     void RunEventLoop();
     void ProcessEvents();
-    bool ShouldQuit() const { return m_shouldQuit; }
-    void Quit() { m_shouldQuit = true; }
+    bool RunFrame();    // False, without waiting, when no window is invalidated
+    
+    FrameClock& GetFrameClock() { return m_frameClock; }
+    bool ShouldQuit() const { return m_shouldQuit.load(); }
+    void Quit();        // Safe from any thread
+    
+    // Timers run on the loop thread; returns an id for KillTimer, never 0
+    int SetTimer(int intervalMs, Callback callback, bool repeat = true);
+    void KillTimer(int id);
+    
+    // Runs the callback on the loop thread at its next wakeup; safe from any thread
+    void Post(Callback callback);
+    
+    // Replays a recorded trace at full speed into windows, indexed as in the
+    // trace; each frame of the fixed clock delivers the due events, then
+    // paints every window with a pending frame. Timers don't run.
+    InputTrace::ReplayStats Replay(const InputTrace& trace, const std::vector<std::shared_ptr<WindowX11>>& windows,
+                                   double frameRate = 60.0);
     
 private:
-    X11WindowManager() : m_shouldQuit(false) {}
+    X11WindowManager();
+    ~X11WindowManager();
     X11WindowManager(const X11WindowManager&) = delete;
     X11WindowManager& operator=(const X11WindowManager&) = delete;
     
+    struct Timer {
+        int id;
+        std::chrono::steady_clock::duration interval;
+        std::chrono::steady_clock::time_point due;
+        Callback callback;
+        bool repeat;
+    };
+    
+    void WaitForEvents();
+    void RunTimers();
+    void RunPosted();
+    void Wake();
+    
     std::vector<std::shared_ptr<WindowX11>> m_windows;
-    bool m_shouldQuit;
+    std::atomic<bool> m_shouldQuit;
+    FrameClock m_frameClock;
+    
+    std::vector<Timer> m_timers;
+    int m_nextTimerId;
+    
+    int m_wakeFd;       // eventfd; -1 when unavailable
+    std::mutex m_postMutex;
+    std::vector<Callback> m_posted;
 };
 
 } // namespace SDK
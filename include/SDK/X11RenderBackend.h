@@ -5,6 +5,7 @@
 #if SDK_PLATFORM_LINUX && SDK_HAS_X11
 
 #include "RenderBackend.h"
+#include "GlyphAtlas.h"
 #include <X11/Xlib.h>
 #include <X11/Xutil.h>
 #include <memory>
@@ -12,9 +13,20 @@
 
 namespace SDK {
 
+struct X11Acceleration;
+struct X11Text;
+
 /**
  * X11RenderBackend - X11-based rendering backend for Linux
- * Implements the RenderBackend interface using X11/Xlib
+ * Implements the RenderBackend interface using X11/Xlib. Where the server
+ * has them, two extensions take over from core requests: XRender draws
+ * antialiased, alpha-blended fills, gradients and atlas composites, and
+ * MIT-SHM shares the pixel buffer that software effects read and write, so
+ * the pixels don't travel through the socket. Without them, or over a remote
+ * connection, it falls back to core X11. With XRender, text is drawn from a
+ * GlyphAtlas: glyphs are rasterized once through Xft and FreeType, laid-out
+ * strings are cached, and each glyph is one composite from the atlas. Core
+ * fonts remain the fallback.
  */
 class X11RenderBackend : public RenderBackend {
 public:
@@ -32,12 +44,17 @@ public:
     HDC GetDC() const override;
     void* GetNativeContext() const override;
     
+    // GetDC() is only the window handle; there is no GDI surface to draw on
+    HDC BeginGDIInterop() override { return nullptr; }
+    
     void DrawRectangle(const RECT& rect, Color fillColor, Color borderColor, float borderWidth) override;
     void DrawRoundedRectangle(const RECT& rect, float radius, Color fillColor, Color borderColor, float borderWidth) override;
     void DrawLine(int x1, int y1, int x2, int y2, Color color, float width) override;
     void DrawEllipse(int cx, int cy, int rx, int ry, Color fillColor, Color borderColor, float borderWidth) override;
     
     void DrawText(const std::wstring& text, const RECT& rect, Color color, const std::wstring& fontFamily, float fontSize, int fontWeight) override;
+    void DrawTextLine(const std::wstring& text, const RECT& rect, Color color, const std::wstring& fontFamily, float fontSize, int fontWeight, TextAlign align) override;
+    int MeasureText(const std::wstring& text, const std::wstring& fontFamily, float fontSize, int fontWeight) override;
     
     void DrawLinearGradient(const RECT& rect, Color startColor, Color endColor, bool horizontal) override;
     void DrawRadialGradient(const RECT& rect, Color centerColor, Color edgeColor, int cx, int cy) override;
@@ -45,17 +62,35 @@ public:
     void DrawShadow(const RECT& rect, int offsetX, int offsetY, int blur, Color shadowColor) override;
     void DrawGlow(const RECT& rect, int radius, Color glowColor) override;
     
+    // Splats into the back buffer through one XImage
+    void DrawParticleBatch(const float* x, const float* y, const uint32_t* colors, size_t count, int size) override;
+    
+    // Nearest-neighbour copy from the atlas pixels into the back buffer
+    void DrawAtlasTexture(const TextureAtlas& atlas, const std::string& name, const RECT& dest) override;
+    
     bool SupportsGPUEffects() const override { return false; }
     void ApplyBlur(const RECT& rect, int blurRadius) override;
     void ApplyBloom(const RECT& rect, float threshold, float intensity) override;
     void ApplyDepthOfField(const RECT& rect, int focalDepth, int blurAmount, float focalRange) override;
     void ApplyMotionBlur(const RECT& rect, int directionX, int directionY, float intensity) override;
     void ApplyChromaticAberration(const RECT& rect, float strength, int offsetX, int offsetY) override;
+    // The whole chain on one GetImage/PutImage round trip
+    void ApplyEffectGraph(const RECT& rect, EffectGraph& graph) override;
     
     BackendType GetType() const override { return BackendType::GDI; }
     bool IsHardwareAccelerated() const override { return false; }
     Capabilities GetCapabilities() const override;
     
+    // Draws batches of plain rectangles and lines with one request each
+    void ExecuteCommandList(const RenderCommandList& commands) override;
+    
+    // False forces the core X11 path even when the extensions are present
+    void SetExtensionsEnabled(bool enabled);
+    bool IsRenderActive() const;    // XRender fills and composites
+    bool IsShmActive() const;       // MIT-SHM pixel access
+    bool IsAtlasTextActive() const; // Antialiased text from the glyph atlas
+    GlyphAtlas::Stats GetTextStats() const;
+    
     // X11-specific methods
     Display* GetDisplay() const { return m_display; }
     Window GetWindow() const { return m_window; }
@@ -66,6 +101,22 @@ private:
     void SetGCColor(const Color& color);
     XFontStruct* GetOrCreateFont(int fontSize);
     
+    // Text laid out in the glyph atlas; null when atlas text is unavailable
+    const GlyphAtlas::Run* LayoutText(const std::wstring& text, const std::wstring& fontFamily, float fontSize,
+                                      int fontWeight, int& ascent, int& descent);
+    void DrawRun(const GlyphAtlas::Run& run, int x, int baseline, Color color);
+    bool UploadGlyphs();
+    
+    // Read rect from the back buffer into an XImage, run kernel(pixels, left, top, w, h, stride), write it back.
+    // False when the visual has no 32-bit pixel layout to hand out.
+    template<typename Fn>
+    bool WithBackBufferPixels(const RECT& rect, Fn&& kernel);
+    
+    // Extension resources tied to the back buffer; recreated when it is
+    void AttachSurfaces(Visual* visual, int depth);
+    void ReleaseSurfaces();
+    bool UploadAtlas(const TextureAtlas& atlas);
+    
     Display* m_display;
     Window m_window;
     HWND m_hwnd;
@@ -77,6 +128,10 @@ private:
     // Font cache
     std::map<int, XFontStruct*> m_fontCache;
     
+    std::unique_ptr<X11Acceleration> m_accel;
+    std::unique_ptr<X11Text> m_text;
+    bool m_extensionsEnabled;
+    
     bool m_initialized;
 };
 
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Platform.h"
+
+#if SDK_PLATFORM_LINUX && SDK_HAS_X11
+
+#include "GlyphAtlas.h"
+#include <X11/Xlib.h>
+#include <memory>
+#include <string>
+
+namespace SDK {
+
+struct XftFontSet;
+
+/**
+ * XftFontSource - Fonts opened through Xft, rasterized into GlyphAtlas bitmaps
+ * Hands out one id per family, pixel size and weight - the font id a
+ * GlyphAtlas keys its glyphs by - and renders glyph coverage with FreeType.
+ * The X11 and OpenGL backends share it. Built without Xft (SDK_HAS_XFT)
+ * no font ever opens. Fonts are closed with the source, so it must not
+ * outlive its display. Not thread-safe.
+ */
+class XftFontSource {
+public:
+    explicit XftFontSource(Display* display);
+    ~XftFontSource();
+    XftFontSource(const XftFontSource&) = delete;
+    XftFontSource& operator=(const XftFontSource&) = delete;
+
+    // False when no font matches; fontSize <= 0 means 12 pixels
+    bool GetFont(const std::wstring& fontFamily, float fontSize, int fontWeight,
+                 uint32_t& id, int& ascent, int& descent);
+    bool Rasterize(uint32_t id, uint32_t codepoint, GlyphAtlas::Bitmap& bitmap);
+
+    // Rasterize() as a GlyphAtlas callback; valid while the source is
+    GlyphAtlas::Rasterizer GetRasterizer();
+
+    static bool IsAvailable();  // Built with Xft
+
+private:
+    Display* m_display;
+    std::unique_ptr<XftFontSet> m_fonts;
+};
+
+} // namespace SDK
+
+#endif // SDK_PLATFORM_LINUX && SDK_HAS_X11
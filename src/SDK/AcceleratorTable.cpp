@@ -0,0 +1,338 @@
+#include "../../include/SDK/AcceleratorTable.h"
+#include "../../include/SDK/Menu.h"
+#include "../../include/SDK/Toolbar.h"
+#include <algorithm>
+#include <cwctype>
+
+namespace SDK {
+
+namespace {
+    struct NamedKey {
+        const wchar_t* name;
+        uint16_t key;
+    };
+
+    // Lowercase; single characters other than letters and digits included
+    const NamedKey NAMED_KEYS[] = {
+        { L"backspace", (uint16_t)VK_BACK },
+        { L"tab", (uint16_t)VK_TAB },
+        { L"enter", (uint16_t)VK_RETURN },
+        { L"return", (uint16_t)VK_RETURN },
+        { L"esc", (uint16_t)VK_ESCAPE },
+        { L"escape", (uint16_t)VK_ESCAPE },
+        { L"space", (uint16_t)VK_SPACE },
+        { L"pgup", (uint16_t)VK_PRIOR },
+        { L"pageup", (uint16_t)VK_PRIOR },
+        { L"pgdn", (uint16_t)VK_NEXT },
+        { L"pagedown", (uint16_t)VK_NEXT },
+        { L"end", (uint16_t)VK_END },
+        { L"home", (uint16_t)VK_HOME },
+        { L"left", (uint16_t)VK_LEFT },
+        { L"up", (uint16_t)VK_UP },
+        { L"right", (uint16_t)VK_RIGHT },
+        { L"down", (uint16_t)VK_DOWN },
+        { L"ins", (uint16_t)VK_INSERT },
+        { L"insert", (uint16_t)VK_INSERT },
+        { L"del", (uint16_t)VK_DELETE },
+        { L"delete", (uint16_t)VK_DELETE },
+        { L"plus", (uint16_t)VK_OEM_PLUS },
+        { L"+", (uint16_t)VK_OEM_PLUS },
+        { L"=", (uint16_t)VK_OEM_PLUS },
+        { L"minus", (uint16_t)VK_OEM_MINUS },
+        { L"-", (uint16_t)VK_OEM_MINUS },
+        { L",", (uint16_t)VK_OEM_COMMA },
+        { L".", (uint16_t)VK_OEM_PERIOD },
+        { L";", (uint16_t)VK_OEM_1 },
+        { L"/", (uint16_t)VK_OEM_2 },
+        { L"`", (uint16_t)VK_OEM_3 },
+        { L"[", (uint16_t)VK_OEM_4 },
+        { L"\\", (uint16_t)VK_OEM_5 },
+        { L"]", (uint16_t)VK_OEM_6 },
+        { L"'", (uint16_t)VK_OEM_7 }
+    };
+
+    constexpr int MAX_FUNCTION_KEY = 24;
+
+    std::wstring Normalize(const std::wstring& text, size_t begin, size_t end) {
+        while (begin < end && std::iswspace(text[begin])) begin++;
+        while (end > begin && std::iswspace(text[end - 1])) end--;
+        std::wstring token;
+        token.reserve(end - begin);
+        for (size_t i = begin; i < end; i++) {
+            token += (wchar_t)std::towlower(text[i]);
+        }
+        return token;
+    }
+
+    bool ParseKey(const std::wstring& token, uint16_t& key) {
+        if (token.size() == 1) {
+            wchar_t ch = token[0];
+            if (ch >= L'a' && ch <= L'z') {
+                key = (uint16_t)(L'A' + (ch - L'a'));
+                return true;
+            }
+            if (ch >= L'0' && ch <= L'9') {
+                key = (uint16_t)ch;
+                return true;
+            }
+        }
+
+        if (token.size() >= 2 && token[0] == L'f') {
+            int number = 0;
+            for (size_t i = 1; i < token.size(); i++) {
+                if (token[i] < L'0' || token[i] > L'9' || number > MAX_FUNCTION_KEY) return false;
+                number = number * 10 + (token[i] - L'0');
+            }
+            if (number < 1 || number > MAX_FUNCTION_KEY) return false;
+            key = (uint16_t)(VK_F1 + number - 1);
+            return true;
+        }
+
+        for (const NamedKey& named : NAMED_KEYS) {
+            if (token == named.name) {
+                key = named.key;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool ParseModifier(const std::wstring& token, uint8_t& modifiers) {
+        if (token == L"ctrl" || token == L"control") {
+            modifiers |= AcceleratorTable::CTRL;
+        } else if (token == L"shift") {
+            modifiers |= AcceleratorTable::SHIFT;
+        } else if (token == L"alt") {
+            modifiers |= AcceleratorTable::ALT;
+        } else {
+            return false;
+        }
+        return true;
+    }
+}
+
+AcceleratorTable::AcceleratorTable()
+    : m_menuRevision(0)
+    , m_dirty(true)
+    , m_stats()
+{
+}
+
+AcceleratorTable::~AcceleratorTable() = default;
+
+bool AcceleratorTable::Parse(const std::wstring& text, Accelerator& accelerator) {
+    // The key follows the last '+', unless the key is '+' itself ("Ctrl++")
+    size_t end = text.size();
+    while (end > 0 && std::iswspace(text[end - 1])) end--;
+    if (end == 0) return false;
+
+    size_t keyBegin;
+    size_t modifiersEnd;
+    if (text[end - 1] == L'+') {
+        keyBegin = end - 1;
+        modifiersEnd = keyBegin;
+        if (modifiersEnd > 0) {
+            if (text[modifiersEnd - 1] != L'+') return false;
+            modifiersEnd--;
+        }
+    } else {
+        size_t plus = text.rfind(L'+', end - 1);
+        keyBegin = plus == std::wstring::npos ? 0 : plus + 1;
+        modifiersEnd = plus == std::wstring::npos ? 0 : plus;
+    }
+
+    uint16_t key = 0;
+    if (!ParseKey(Normalize(text, keyBegin, end), key)) return false;
+
+    uint8_t modifiers = NONE;
+    if (keyBegin > 0) {
+        size_t begin = 0;
+        while (true) {
+            size_t plus = text.find(L'+', begin);
+            if (plus == std::wstring::npos || plus > modifiersEnd) plus = modifiersEnd;
+            if (!ParseModifier(Normalize(text, begin, plus), modifiers)) return false;
+            if (plus >= modifiersEnd) break;
+            begin = plus + 1;
+        }
+    }
+
+    accelerator.modifiers = modifiers;
+    accelerator.key = key;
+    return true;
+}
+
+bool AcceleratorTable::Add(const std::wstring& shortcut, std::function<void()> command) {
+    Accelerator accelerator;
+    if (!command || !Parse(shortcut, accelerator)) return false;
+
+    m_commands.push_back({ accelerator, std::move(command) });
+    m_dirty = true;
+    return true;
+}
+
+void AcceleratorTable::AddMenu(std::shared_ptr<Menu> menu) {
+    if (!menu) return;
+    m_menus.push_back(menu);
+    m_dirty = true;
+}
+
+void AcceleratorTable::AddMenuItem(std::shared_ptr<MenuItem> item) {
+    if (!item) return;
+    m_menuItems.push_back(item);
+    m_dirty = true;
+}
+
+void AcceleratorTable::AddToolbar(std::shared_ptr<Toolbar> toolbar) {
+    if (!toolbar) return;
+    m_toolbars.push_back({ toolbar, toolbar->GetRevision() });
+    m_dirty = true;
+}
+
+void AcceleratorTable::Clear() {
+    m_commands.clear();
+    m_menus.clear();
+    m_menuItems.clear();
+    m_toolbars.clear();
+    m_table.clear();
+    m_dirty = true;
+}
+
+uint8_t AcceleratorTable::GetHeldModifiers() {
+    uint8_t modifiers = NONE;
+    if (GetKeyState(VK_CONTROL) < 0) modifiers |= CTRL;
+    if (GetKeyState(VK_SHIFT) < 0) modifiers |= SHIFT;
+    if (GetKeyState(VK_MENU) < 0) modifiers |= ALT;
+    return modifiers;
+}
+
+bool AcceleratorTable::Dispatch(int keyCode) {
+    return Dispatch(keyCode, GetHeldModifiers());
+}
+
+bool AcceleratorTable::Dispatch(int keyCode, uint8_t modifiers) {
+    if (IsStale()) Rebuild();
+    m_stats.lookups++;
+    if (keyCode <= 0 || keyCode > 0xFFFF) return false;
+
+    auto it = m_table.find(MakeKey({ modifiers, (uint16_t)keyCode }));
+    if (it == m_table.end()) return false;
+
+    // Copied: a command may edit the table
+    Command command = it->second;
+    if (command.commandIndex >= 0) {
+        std::function<void()> callback = m_commands[command.commandIndex].callback;
+        m_stats.dispatched++;
+        callback();
+        return true;
+    }
+
+    if (auto item = command.menuItem.lock()) {
+        if (!item->IsEnabled()) return false;
+        m_stats.dispatched++;
+        item->Click();
+        return true;
+    }
+
+    if (auto toolbar = command.toolbar.lock()) {
+        if (!toolbar->ClickItem(command.toolbarItemId)) return false;
+        m_stats.dispatched++;
+        return true;
+    }
+    return false;
+}
+
+std::shared_ptr<MenuItem> AcceleratorTable::FindMenuItem(const Accelerator& accelerator) {
+    if (IsStale()) Rebuild();
+    auto it = m_table.find(MakeKey(accelerator));
+    return it != m_table.end() ? it->second.menuItem.lock() : nullptr;
+}
+
+size_t AcceleratorTable::GetCount() {
+    if (IsStale()) Rebuild();
+    return m_table.size();
+}
+
+void AcceleratorTable::ResetStats() {
+    m_stats = Stats();
+}
+
+bool AcceleratorTable::IsStale() const {
+    if (m_dirty) return true;
+    if (m_menuRevision != MenuItem::GetRevision() && (!m_menus.empty() || !m_menuItems.empty())) return true;
+    for (const ToolbarSource& source : m_toolbars) {
+        auto toolbar = source.toolbar.lock();
+        if (toolbar && toolbar->GetRevision() != source.revision) return true;
+    }
+    return false;
+}
+
+void AcceleratorTable::Rebuild() {
+    m_table.clear();
+    m_stats.conflicts = 0;
+
+    for (size_t i = 0; i < m_commands.size(); i++) {
+        Command command = {};
+        command.commandIndex = (int)i;
+        Bind(m_commands[i].accelerator, command);
+    }
+
+    m_menus.erase(std::remove_if(m_menus.begin(), m_menus.end(),
+        [](const std::weak_ptr<Menu>& menu) { return menu.expired(); }), m_menus.end());
+    for (const auto& weakMenu : m_menus) {
+        auto menu = weakMenu.lock();
+        for (const auto& item : menu->GetItems()) {
+            BindMenuItem(item);
+        }
+    }
+
+    m_menuItems.erase(std::remove_if(m_menuItems.begin(), m_menuItems.end(),
+        [](const std::weak_ptr<MenuItem>& item) { return item.expired(); }), m_menuItems.end());
+    for (const auto& item : m_menuItems) {
+        BindMenuItem(item.lock());
+    }
+
+    m_toolbars.erase(std::remove_if(m_toolbars.begin(), m_toolbars.end(),
+        [](const ToolbarSource& source) { return source.toolbar.expired(); }), m_toolbars.end());
+    for (ToolbarSource& source : m_toolbars) {
+        auto toolbar = source.toolbar.lock();
+        source.revision = toolbar->GetRevision();
+        for (const auto& item : toolbar->GetItems()) {
+            Accelerator accelerator;
+            if (item.separator || item.shortcut.empty() || !Parse(item.shortcut, accelerator)) continue;
+            Command command = {};
+            command.toolbar = toolbar;
+            command.toolbarItemId = item.id;
+            command.commandIndex = -1;
+            Bind(accelerator, command);
+        }
+    }
+
+    m_menuRevision = MenuItem::GetRevision();
+    m_dirty = false;
+    m_stats.rebuilds++;
+}
+
+void AcceleratorTable::Bind(const Accelerator& accelerator, const Command& command) {
+    if (!m_table.emplace(MakeKey(accelerator), command).second) {
+        m_stats.conflicts++;
+    }
+}
+
+void AcceleratorTable::BindMenuItem(const std::shared_ptr<MenuItem>& item) {
+    if (!item || item->GetType() == MenuItem::Type::SEPARATOR) return;
+
+    Accelerator accelerator;
+    std::wstring shortcut = item->GetShortcut();
+    if (!item->HasSubMenu() && !shortcut.empty() && Parse(shortcut, accelerator)) {
+        Command command = {};
+        command.menuItem = item;
+        command.commandIndex = -1;
+        Bind(accelerator, command);
+    }
+
+    for (const auto& subItem : item->GetSubMenuItems()) {
+        BindMenuItem(subItem);
+    }
+}
+
+} // namespace SDK
@@ -1,14 +1,91 @@
 #include "../../include/SDK/AdvancedWidgets.h"
 #include "../../include/SDK/Renderer.h"
+#include "../../include/SDK/FrameArena.h"
 #include <algorithm>
+#include <cwchar>
+#include <unordered_map>
 
 namespace SDK {
 
+namespace {
+    constexpr size_t MAX_EDITOR_UNDO_STEPS = 100;
+    
+    // Listed entries inserted per frame, so huge directories don't stall a frame
+    constexpr size_t MAX_TREE_ENTRIES_PER_UPDATE = 512;
+    constexpr size_t MAX_EXPLORER_ENTRIES_PER_UPDATE = 512;
+    
+    // The explorer lists sizes and dates, so content changes matter too
+    constexpr DWORD EXPLORER_WATCH_FILTER = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME |
+                                            FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE;
+    
+    // Seconds between watcher polls of an idle, scheduled tree or explorer
+    constexpr float WATCH_POLL_INTERVAL = 0.1f;
+    
+    // Rows of ListBox and the ComboBox drop-down
+    constexpr int LIST_ITEM_HEIGHT = 25;
+    constexpr int DEFAULT_DROPDOWN_ITEMS = 10;
+    constexpr int SCROLL_THUMB_WIDTH = 4;
+    
+    // FileTree geometry: vertical rows indent per level; horizontal trees
+    // place nodes in columns and drop a level per depth
+    constexpr int TREE_INDENT = 15;
+    constexpr int TREE_COLUMN_WIDTH = 60;
+    constexpr int TREE_COLUMN_STEP = 70;
+    constexpr int TREE_LEVEL_HEIGHT = 80;
+    constexpr int NAVIGATE_UNHANDLED = -2;
+    
+    // First visible row that keeps a full viewport on screen where possible
+    int ClampFirstVisible(int first, int count, int visible) {
+        return std::max(std::min(first, count - visible), 0);
+    }
+    
+    // Smallest scroll from first that brings index into view
+    int FirstVisibleForItem(int first, int index, int visible) {
+        if (index < first) return index;
+        if (index >= first + visible) return index - visible + 1;
+        return first;
+    }
+    
+    // Selection after a navigation key, or NAVIGATE_UNHANDLED for other keys
+    int NavigateIndex(int keyCode, int current, int count, int pageSize) {
+        if (count <= 0) return NAVIGATE_UNHANDLED;
+        int index;
+        switch (keyCode) {
+            case VK_UP:     index = current - 1; break;
+            case VK_DOWN:   index = current + 1; break;
+            case VK_PRIOR:  index = current - pageSize; break;
+            case VK_NEXT:   index = current + pageSize; break;
+            case VK_HOME:   index = 0; break;
+            case VK_END:    index = count - 1; break;
+            default:        return NAVIGATE_UNHANDLED;
+        }
+        return std::max(std::min(index, count - 1), 0);
+    }
+    
+    // Thumb sized and placed by the visible share of the rows
+    void DrawScrollThumb(HDC hdc, const RECT& track, int first, int visible, int count) {
+        int trackHeight = track.bottom - track.top;
+        int thumbHeight = std::max((int)((long long)trackHeight * visible / count), SCROLL_THUMB_WIDTH * 2);
+        int thumbTop = track.top + (int)((long long)(trackHeight - thumbHeight) * first / std::max(count - visible, 1));
+        RECT thumb = {track.left, thumbTop, track.right, thumbTop + thumbHeight};
+        HBRUSH brush = GdiObjectCache::GetBrush(RGB(180, 180, 180));
+        FillRect(hdc, &thumb, brush);
+    }
+    
+    bool IsSameOrUnder(const std::wstring& path, const std::wstring& root) {
+        if (path.compare(0, root.length(), root) != 0) return false;
+        return path.length() == root.length() || path[root.length()] == L'\\';
+    }
+}
+
 // ComboBox implementation
 ComboBox::ComboBox()
     : Widget()
+    , m_providerItemCount(0)
     , m_selectedIndex(-1)
     , m_dropdownOpen(false)
+    , m_maxDropdownItems(DEFAULT_DROPDOWN_ITEMS)
+    , m_dropdownScrollOffset(0)
     , m_backgroundColor(255, 255, 255, 255)
     , m_textColor(0, 0, 0, 255)
 {
@@ -36,25 +113,59 @@ void ComboBox::RemoveItem(int index) {
 void ComboBox::ClearItems() {
     m_items.clear();
     m_selectedIndex = -1;
+    m_dropdownScrollOffset = 0;
+}
+
+void ComboBox::SetItemProvider(ItemCountProvider itemCount, ItemTextProvider itemText) {
+    m_itemCountProvider = itemCount;
+    m_itemTextProvider = itemText;
+    m_selectedIndex = -1;
+    RefreshItems();
+}
+
+void ComboBox::ClearItemProvider() {
+    m_itemCountProvider = nullptr;
+    m_itemTextProvider = nullptr;
+    m_selectedIndex = -1;
+    RefreshItems();
+}
+
+void ComboBox::RefreshItems() {
+    m_providerItemCount = m_itemCountProvider ? std::max(m_itemCountProvider(), 0) : 0;
+    
+    int count = GetItemCount();
+    if (m_selectedIndex >= count) {
+        m_selectedIndex = -1;
+    }
+    m_dropdownScrollOffset = ClampFirstVisible(m_dropdownScrollOffset, count, m_maxDropdownItems);
+    Invalidate();
+}
+
+int ComboBox::GetItemCount() const {
+    return m_itemTextProvider ? m_providerItemCount : (int)m_items.size();
+}
+
+std::wstring ComboBox::GetItemText(int index) const {
+    if (index < 0 || index >= GetItemCount()) return L"";
+    return m_itemTextProvider ? m_itemTextProvider(index) : m_items[index];
 }
 
 void ComboBox::SetSelectedIndex(int index) {
-    if (index >= -1 && index < (int)m_items.size()) {
+    if (index >= -1 && index < GetItemCount()) {
         m_selectedIndex = index;
         TriggerEvent(WidgetEvent::VALUE_CHANGED, &m_selectedIndex);
     }
 }
 
 std::wstring ComboBox::GetSelectedItem() const {
-    if (m_selectedIndex >= 0 && m_selectedIndex < (int)m_items.size()) {
-        return m_items[m_selectedIndex];
-    }
-    return L"";
+    return GetItemText(m_selectedIndex);
 }
 
 void ComboBox::Render(HDC hdc) {
     if (!m_visible) return;
     
+    ScopedFont font(hdc, GetFont());
+    
     RECT bounds; GetBounds(bounds);
     
     // Draw main box
@@ -66,15 +177,16 @@ void ComboBox::Render(HDC hdc) {
         textRect.left += 5;
         textRect.right -= 25;
         
+        std::wstring text = GetItemText(m_selectedIndex);
         SetBkMode(hdc, TRANSPARENT);
         SetTextColor(hdc, m_textColor.ToCOLORREF());
-        DrawTextW(hdc, m_items[m_selectedIndex].c_str(), -1, &textRect, DT_LEFT | DT_VCENTER | DT_SINGLELINE);
+        DrawTextW(hdc, text.c_str(), -1, &textRect, DT_LEFT | DT_VCENTER | DT_SINGLELINE);
     }
     
     // Draw dropdown arrow
     int arrowX = bounds.right - 15;
     int arrowY = (bounds.top + bounds.bottom) / 2;
-    HPEN pen = CreatePen(PS_SOLID, 2, RGB(50, 50, 50));
+    HPEN pen = GdiObjectCache::GetPen(RGB(50, 50, 50), 2);
     HPEN oldPen = (HPEN)SelectObject(hdc, pen);
     
     MoveToEx(hdc, arrowX - 4, arrowY - 2, nullptr);
@@ -82,25 +194,37 @@ void ComboBox::Render(HDC hdc) {
     LineTo(hdc, arrowX + 4, arrowY - 2);
     
     SelectObject(hdc, oldPen);
-    DeleteObject(pen);
     
-    // Draw dropdown list if open
-    if (m_dropdownOpen && !m_items.empty()) {
+    // Draw dropdown list if open; only the rows in view
+    int count = GetItemCount();
+    if (m_dropdownOpen && count > 0) {
         RECT dropRect = GetDropdownRect(bounds);
         Renderer::DrawRoundedRect(hdc, dropRect, 4, m_backgroundColor, Color(128, 128, 128, 255), 1);
         
+        int visibleItems = std::min(count, m_maxDropdownItems);
+        bool scrollable = count > visibleItems;
+        int textRight = dropRect.right - (scrollable ? 5 + SCROLL_THUMB_WIDTH : 5);
+        
         SetBkMode(hdc, TRANSPARENT);
-        for (size_t i = 0; i < m_items.size(); i++) {
-            RECT itemRect = {dropRect.left + 5, dropRect.top + (int)i * 25, dropRect.right - 5, dropRect.top + (int)(i + 1) * 25};
+        int last = std::min(m_dropdownScrollOffset + visibleItems, count);
+        for (int i = m_dropdownScrollOffset; i < last; i++) {
+            int row = i - m_dropdownScrollOffset;
+            RECT itemRect = {dropRect.left + 5, dropRect.top + row * LIST_ITEM_HEIGHT,
+                             textRight, dropRect.top + (row + 1) * LIST_ITEM_HEIGHT};
             
-            if ((int)i == m_selectedIndex) {
-                HBRUSH brush = CreateSolidBrush(RGB(200, 220, 255));
+            if (i == m_selectedIndex) {
+                HBRUSH brush = GdiObjectCache::GetBrush(RGB(200, 220, 255));
                 FillRect(hdc, &itemRect, brush);
-                DeleteObject(brush);
             }
             
+            std::wstring text = GetItemText(i);
             SetTextColor(hdc, m_textColor.ToCOLORREF());
-            DrawTextW(hdc, m_items[i].c_str(), -1, &itemRect, DT_LEFT | DT_VCENTER | DT_SINGLELINE);
+            DrawTextW(hdc, text.c_str(), -1, &itemRect, DT_LEFT | DT_VCENTER | DT_SINGLELINE);
+        }
+        
+        if (scrollable) {
+            RECT track = {dropRect.right - 3 - SCROLL_THUMB_WIDTH, dropRect.top + 2, dropRect.right - 3, dropRect.bottom - 2};
+            DrawScrollThumb(hdc, track, m_dropdownScrollOffset, visibleItems, count);
         }
     }
     
@@ -108,12 +232,13 @@ void ComboBox::Render(HDC hdc) {
 }
 
 RECT ComboBox::GetDropdownRect(const RECT& bounds) const {
-    if (m_items.empty()) {
+    int count = GetItemCount();
+    if (count == 0) {
         return {0, 0, 0, 0};
     }
     
     const int SCREEN_MARGIN = 10;
-    int dropdownHeight = (int)m_items.size() * 25;
+    int dropdownHeight = std::min(count, m_maxDropdownItems) * LIST_ITEM_HEIGHT;
     int screenHeight = GetSystemMetrics(SM_CYSCREEN);
     
     // Check if there's enough space below
@@ -140,23 +265,79 @@ bool ComboBox::HandleMouseDown(int x, int y, int button) {
         // Check dropdown items
         RECT dropRect = GetDropdownRect(bounds);
         if (x >= dropRect.left && x < dropRect.right && y >= dropRect.top && y < dropRect.bottom) {
-            int index = (y - dropRect.top) / 25;
-            SetSelectedIndex(index);
-            m_dropdownOpen = false;
+            int index = m_dropdownScrollOffset + (y - dropRect.top) / LIST_ITEM_HEIGHT;
+            if (index < GetItemCount()) {
+                SetSelectedIndex(index);
+            }
+            SetDropdownOpen(false);
             return true;
         }
-        m_dropdownOpen = false;
+        SetDropdownOpen(false);
     } else if (HitTest(x, y)) {
-        m_dropdownOpen = true;
+        SetFocused(true);
+        SetDropdownOpen(true);
         return true;
     }
     
     return false;
 }
 
+bool ComboBox::HandleKeyDown(int keyCode) {
+    if (!Widget::HandleKeyDown(keyCode)) return false;
+    
+    if (m_dropdownOpen && (keyCode == VK_RETURN || keyCode == VK_ESCAPE)) {
+        SetDropdownOpen(false);
+        return true;
+    }
+    
+    int pageSize = m_dropdownOpen ? m_maxDropdownItems : 1;
+    int index = NavigateIndex(keyCode, m_selectedIndex, GetItemCount(), pageSize);
+    if (index == NAVIGATE_UNHANDLED) return false;
+    
+    if (index != m_selectedIndex) {
+        SetSelectedIndex(index);
+        EnsureDropdownItemVisible(index);
+        Invalidate();
+    }
+    return true;
+}
+
+void ComboBox::EnsureDropdownItemVisible(int index) {
+    int first = FirstVisibleForItem(m_dropdownScrollOffset, index, m_maxDropdownItems);
+    m_dropdownScrollOffset = ClampFirstVisible(first, GetItemCount(), m_maxDropdownItems);
+}
+
+void ComboBox::GetHitBounds(RECT& rect) const {
+    GetBounds(rect);
+    if (m_dropdownOpen) {
+        RECT dropRect = GetDropdownRect(rect);
+        rect.left = std::min(rect.left, dropRect.left);
+        rect.top = std::min(rect.top, dropRect.top);
+        rect.right = std::max(rect.right, dropRect.right);
+        rect.bottom = std::max(rect.bottom, dropRect.bottom);
+    }
+}
+
+void ComboBox::SetDropdownOpen(bool open) {
+    if (m_dropdownOpen == open) return;
+    
+    // The dropdown paints outside the widget bounds
+    RECT bounds; GetBounds(bounds);
+    InvalidateRegion(GetDropdownRect(bounds));
+    
+    if (open) {
+        EnsureDropdownItemVisible(std::max(m_selectedIndex, 0));
+    }
+    
+    m_dropdownOpen = open;
+    NotifyGeometryChanged();
+    Invalidate();
+}
+
 // ListBox implementation
 ListBox::ListBox()
     : Widget()
+    , m_providerItemCount(0)
     , m_selectedIndex(-1)
     , m_multiSelect(false)
     , m_scrollOffset(0)
@@ -171,9 +352,19 @@ void ListBox::AddItem(const std::wstring& item) {
     m_items.push_back(item);
 }
 
+void ListBox::AddItem(std::wstring&& item) {
+    m_items.push_back(std::move(item));
+}
+
+void ListBox::SetItems(std::vector<std::wstring>&& items) {
+    ClearItems();
+    m_items = std::move(items);
+}
+
 void ListBox::RemoveItem(int index) {
     if (index >= 0 && index < (int)m_items.size()) {
         m_items.erase(m_items.begin() + index);
+        m_scrollOffset = ClampFirstVisible(m_scrollOffset, GetItemCount(), GetVisibleItemCount());
     }
 }
 
@@ -181,10 +372,50 @@ void ListBox::ClearItems() {
     m_items.clear();
     m_selectedIndex = -1;
     m_selectedIndices.clear();
+    m_scrollOffset = 0;
+}
+
+void ListBox::SetItemProvider(ItemCountProvider itemCount, ItemTextProvider itemText) {
+    m_itemCountProvider = itemCount;
+    m_itemTextProvider = itemText;
+    m_selectedIndex = -1;
+    m_selectedIndices.clear();
+    RefreshItems();
+}
+
+void ListBox::ClearItemProvider() {
+    m_itemCountProvider = nullptr;
+    m_itemTextProvider = nullptr;
+    m_selectedIndex = -1;
+    m_selectedIndices.clear();
+    RefreshItems();
+}
+
+void ListBox::RefreshItems() {
+    m_providerItemCount = m_itemCountProvider ? std::max(m_itemCountProvider(), 0) : 0;
+    
+    int count = GetItemCount();
+    if (m_selectedIndex >= count) {
+        m_selectedIndex = -1;
+    }
+    m_selectedIndices.erase(std::remove_if(m_selectedIndices.begin(), m_selectedIndices.end(),
+                                           [count](int index) { return index >= count; }),
+                            m_selectedIndices.end());
+    m_scrollOffset = ClampFirstVisible(m_scrollOffset, count, GetVisibleItemCount());
+    Invalidate();
+}
+
+int ListBox::GetItemCount() const {
+    return m_itemTextProvider ? m_providerItemCount : (int)m_items.size();
+}
+
+std::wstring ListBox::GetItemText(int index) const {
+    if (index < 0 || index >= GetItemCount()) return L"";
+    return m_itemTextProvider ? m_itemTextProvider(index) : m_items[index];
 }
 
 void ListBox::SetSelectedIndex(int index) {
-    if (index >= -1 && index < (int)m_items.size()) {
+    if (index >= -1 && index < GetItemCount()) {
         m_selectedIndex = index;
         if (!m_multiSelect) {
             m_selectedIndices.clear();
@@ -196,25 +427,46 @@ void ListBox::SetSelectedIndex(int index) {
     }
 }
 
+int ListBox::GetVisibleItemCount() const {
+    return std::max(m_height / LIST_ITEM_HEIGHT, 1);
+}
+
+void ListBox::ScrollToItem(int index) {
+    int first = ClampFirstVisible(index, GetItemCount(), GetVisibleItemCount());
+    if (first != m_scrollOffset) {
+        m_scrollOffset = first;
+        Invalidate();
+    }
+}
+
+void ListBox::EnsureItemVisible(int index) {
+    ScrollToItem(FirstVisibleForItem(m_scrollOffset, index, GetVisibleItemCount()));
+}
+
 void ListBox::Render(HDC hdc) {
     if (!m_visible) return;
     
+    ScopedFont font(hdc, GetFont());
+    
     RECT bounds; GetBounds(bounds);
     
     // Draw background
     Renderer::DrawRoundedRect(hdc, bounds, 4, Color(255, 255, 255, 255), Color(128, 128, 128, 255), 1);
     
-    // Draw items
+    // Draw the items in view only
     SetBkMode(hdc, TRANSPARENT);
-    int itemHeight = 25;
-    int visibleItems = m_height / itemHeight;
+    int count = GetItemCount();
+    int visibleItems = GetVisibleItemCount();
+    bool scrollable = count > visibleItems;
+    int textRight = bounds.right - (scrollable ? 5 + SCROLL_THUMB_WIDTH : 5);
     
-    for (int i = m_scrollOffset; i < (int)m_items.size() && i < m_scrollOffset + visibleItems; i++) {
+    int last = std::min(m_scrollOffset + visibleItems, count);
+    for (int i = m_scrollOffset; i < last; i++) {
         RECT itemRect = {
             bounds.left + 5,
-            bounds.top + (i - m_scrollOffset) * itemHeight,
-            bounds.right - 5,
-            bounds.top + (i - m_scrollOffset + 1) * itemHeight
+            bounds.top + (i - m_scrollOffset) * LIST_ITEM_HEIGHT,
+            textRight,
+            bounds.top + (i - m_scrollOffset + 1) * LIST_ITEM_HEIGHT
         };
         
         // Highlight selected items
@@ -222,15 +474,20 @@ void ListBox::Render(HDC hdc) {
                          (m_multiSelect && std::find(m_selectedIndices.begin(), m_selectedIndices.end(), i) != m_selectedIndices.end());
         
         if (isSelected) {
-            HBRUSH brush = CreateSolidBrush(RGB(100, 149, 237));
+            HBRUSH brush = GdiObjectCache::GetBrush(RGB(100, 149, 237));
             FillRect(hdc, &itemRect, brush);
-            DeleteObject(brush);
             SetTextColor(hdc, RGB(255, 255, 255));
         } else {
             SetTextColor(hdc, RGB(0, 0, 0));
         }
         
-        DrawTextW(hdc, m_items[i].c_str(), -1, &itemRect, DT_LEFT | DT_VCENTER | DT_SINGLELINE);
+        std::wstring text = GetItemText(i);
+        DrawTextW(hdc, text.c_str(), -1, &itemRect, DT_LEFT | DT_VCENTER | DT_SINGLELINE);
+    }
+    
+    if (scrollable) {
+        RECT track = {bounds.right - 3 - SCROLL_THUMB_WIDTH, bounds.top + 2, bounds.right - 3, bounds.bottom - 2};
+        DrawScrollThumb(hdc, track, m_scrollOffset, visibleItems, count);
     }
     
     Widget::Render(hdc);
@@ -240,12 +497,13 @@ bool ListBox::HandleMouseDown(int x, int y, int button) {
     if (!m_visible || !m_enabled) return false;
     
     if (HitTest(x, y)) {
+        SetFocused(true);
         RECT bounds; GetBounds(bounds);
-        int itemHeight = 25;
         int relY = y - bounds.top;
-        int index = m_scrollOffset + relY / itemHeight;
+        int row = relY / LIST_ITEM_HEIGHT;
+        int index = m_scrollOffset + row;
         
-        if (index >= 0 && index < (int)m_items.size()) {
+        if (row < GetVisibleItemCount() && index >= 0 && index < GetItemCount()) {
             if (m_multiSelect) {
                 auto it = std::find(m_selectedIndices.begin(), m_selectedIndices.end(), index);
                 if (it != m_selectedIndices.end()) {
@@ -262,9 +520,25 @@ bool ListBox::HandleMouseDown(int x, int y, int button) {
     return false;
 }
 
+bool ListBox::HandleKeyDown(int keyCode) {
+    if (!Widget::HandleKeyDown(keyCode)) return false;
+    
+    int index = NavigateIndex(keyCode, m_selectedIndex, GetItemCount(), GetVisibleItemCount());
+    if (index == NAVIGATE_UNHANDLED) return false;
+    
+    if (index != m_selectedIndex) {
+        SetSelectedIndex(index);
+        EnsureItemVisible(index);
+        Invalidate();
+    }
+    return true;
+}
+
 // ListView implementation
 ListView::ListView()
     : Widget()
+    , m_providerItemCount(0)
+    , m_changedIndex(-1)
     , m_checkboxEnabled(false)
     , m_scrollOffset(0)
     , m_itemHeight(25)
@@ -278,28 +552,87 @@ ListView::~ListView() {
 void ListView::AddItem(const std::wstring& text, bool checked) {
     ListViewItem item(text);
     item.checked = checked;
-    m_items.push_back(item);
+    m_items.push_back(std::move(item));
+}
+
+void ListView::AddItem(std::wstring&& text, bool checked) {
+    ListViewItem item(std::move(text));
+    item.checked = checked;
+    m_items.push_back(std::move(item));
+}
+
+void ListView::SetItems(std::vector<ListViewItem>&& items) {
+    ClearItems();
+    m_items = std::move(items);
 }
 
 void ListView::RemoveItem(int index) {
     if (index >= 0 && index < (int)m_items.size()) {
         m_items.erase(m_items.begin() + index);
+        m_scrollOffset = ClampFirstVisible(m_scrollOffset, GetItemCount(), GetVisibleItemCount());
     }
 }
 
 void ListView::ClearItems() {
     m_items.clear();
+    m_scrollOffset = 0;
+}
+
+void ListView::SetItemProvider(ItemCountProvider itemCount, ItemTextProvider itemText) {
+    m_itemCountProvider = itemCount;
+    m_itemTextProvider = itemText;
+    m_providerChecked.clear();
+    RefreshItems();
+}
+
+void ListView::ClearItemProvider() {
+    m_itemCountProvider = nullptr;
+    m_itemTextProvider = nullptr;
+    m_providerChecked.clear();
+    RefreshItems();
+}
+
+void ListView::RefreshItems() {
+    m_providerItemCount = m_itemCountProvider ? std::max(m_itemCountProvider(), 0) : 0;
+    
+    int count = GetItemCount();
+    for (auto it = m_providerChecked.begin(); it != m_providerChecked.end();) {
+        it = (*it >= count) ? m_providerChecked.erase(it) : std::next(it);
+    }
+    m_scrollOffset = ClampFirstVisible(m_scrollOffset, count, GetVisibleItemCount());
+    Invalidate();
+}
+
+int ListView::GetItemCount() const {
+    return m_itemTextProvider ? m_providerItemCount : (int)m_items.size();
+}
+
+std::wstring ListView::GetItemText(int index) const {
+    if (index < 0 || index >= GetItemCount()) return L"";
+    return m_itemTextProvider ? m_itemTextProvider(index) : m_items[index].text;
 }
 
 void ListView::SetItemChecked(int index, bool checked) {
-    if (index >= 0 && index < (int)m_items.size()) {
-        m_items[index].checked = checked;
-        TriggerEvent(WidgetEvent::VALUE_CHANGED, &index);
+    if (index >= 0 && index < GetItemCount()) {
+        if (m_itemTextProvider) {
+            if (checked) {
+                m_providerChecked.insert(index);
+            } else {
+                m_providerChecked.erase(index);
+            }
+        } else {
+            m_items[index].checked = checked;
+        }
+        m_changedIndex = index;
+        TriggerEvent(WidgetEvent::VALUE_CHANGED, &m_changedIndex);
     }
 }
 
 bool ListView::IsItemChecked(int index) const {
-    if (index >= 0 && index < (int)m_items.size()) {
+    if (index >= 0 && index < GetItemCount()) {
+        if (m_itemTextProvider) {
+            return m_providerChecked.count(index) != 0;
+        }
         return m_items[index].checked;
     }
     return false;
@@ -307,6 +640,12 @@ bool ListView::IsItemChecked(int index) const {
 
 std::vector<int> ListView::GetCheckedItems() const {
     std::vector<int> checked;
+    if (m_itemTextProvider) {
+        checked.assign(m_providerChecked.begin(), m_providerChecked.end());
+        std::sort(checked.begin(), checked.end());
+        return checked;
+    }
+    
     for (size_t i = 0; i < m_items.size(); i++) {
         if (m_items[i].checked) {
             checked.push_back((int)i);
@@ -315,19 +654,41 @@ std::vector<int> ListView::GetCheckedItems() const {
     return checked;
 }
 
+int ListView::GetVisibleItemCount() const {
+    return m_itemHeight > 0 ? std::max(m_height / m_itemHeight, 1) : 1;
+}
+
+void ListView::ScrollToItem(int index) {
+    int first = ClampFirstVisible(index, GetItemCount(), GetVisibleItemCount());
+    if (first != m_scrollOffset) {
+        m_scrollOffset = first;
+        Invalidate();
+    }
+}
+
+void ListView::EnsureItemVisible(int index) {
+    ScrollToItem(FirstVisibleForItem(m_scrollOffset, index, GetVisibleItemCount()));
+}
+
 void ListView::Render(HDC hdc) {
     if (!m_visible) return;
     
+    ScopedFont font(hdc, GetFont());
+    
     RECT bounds; GetBounds(bounds);
     
     // Draw background
     Renderer::DrawRoundedRect(hdc, bounds, 4, Color(255, 255, 255, 255), Color(128, 128, 128, 255), 1);
     
-    // Draw items
+    // Draw the items in view only
     SetBkMode(hdc, TRANSPARENT);
-    int visibleItems = m_height / m_itemHeight;
+    int count = GetItemCount();
+    int visibleItems = GetVisibleItemCount();
+    bool scrollable = count > visibleItems;
+    int textRight = bounds.right - (scrollable ? 5 + SCROLL_THUMB_WIDTH : 5);
     
-    for (int i = m_scrollOffset; i < (int)m_items.size() && i < m_scrollOffset + visibleItems; i++) {
+    int last = std::min(m_scrollOffset + visibleItems, count);
+    for (int i = m_scrollOffset; i < last; i++) {
         int yOffset = bounds.top + (i - m_scrollOffset) * m_itemHeight;
         int xOffset = bounds.left + 5;
         
@@ -336,8 +697,8 @@ void ListView::Render(HDC hdc) {
             RECT checkRect = {xOffset, yOffset + 2, xOffset + 18, yOffset + 20};
             Renderer::DrawRoundedRect(hdc, checkRect, 3, Color(255, 255, 255, 255), Color(128, 128, 128, 255), 1);
             
-            if (m_items[i].checked) {
-                HPEN pen = CreatePen(PS_SOLID, 2, RGB(0, 128, 0));
+            if (IsItemChecked(i)) {
+                HPEN pen = GdiObjectCache::GetPen(RGB(0, 128, 0), 2);
                 HPEN oldPen = (HPEN)SelectObject(hdc, pen);
                 
                 MoveToEx(hdc, xOffset + 3, yOffset + 10, nullptr);
@@ -345,16 +706,21 @@ void ListView::Render(HDC hdc) {
                 LineTo(hdc, xOffset + 15, yOffset + 6);
                 
                 SelectObject(hdc, oldPen);
-                DeleteObject(pen);
             }
             
             xOffset += 25;
         }
         
         // Draw text
-        RECT textRect = {xOffset, yOffset, bounds.right - 5, yOffset + m_itemHeight};
+        RECT textRect = {xOffset, yOffset, textRight, yOffset + m_itemHeight};
+        std::wstring text = GetItemText(i);
         SetTextColor(hdc, RGB(0, 0, 0));
-        DrawTextW(hdc, m_items[i].text.c_str(), -1, &textRect, DT_LEFT | DT_VCENTER | DT_SINGLELINE);
+        DrawTextW(hdc, text.c_str(), -1, &textRect, DT_LEFT | DT_VCENTER | DT_SINGLELINE);
+    }
+    
+    if (scrollable) {
+        RECT track = {bounds.right - 3 - SCROLL_THUMB_WIDTH, bounds.top + 2, bounds.right - 3, bounds.bottom - 2};
+        DrawScrollThumb(hdc, track, m_scrollOffset, visibleItems, count);
     }
     
     Widget::Render(hdc);
@@ -364,15 +730,16 @@ bool ListView::HandleMouseDown(int x, int y, int button) {
     if (!m_visible || !m_enabled) return false;
     
     if (HitTest(x, y)) {
+        SetFocused(true);
         RECT bounds; GetBounds(bounds);
         int relY = y - bounds.top;
         int index = m_scrollOffset + relY / m_itemHeight;
         
-        if (index >= 0 && index < (int)m_items.size()) {
+        if (relY / m_itemHeight < GetVisibleItemCount() && index >= 0 && index < GetItemCount()) {
             if (m_checkboxEnabled) {
                 int xOffset = bounds.left + 5;
                 if (x >= xOffset && x < xOffset + 18) {
-                    SetItemChecked(index, !m_items[index].checked);
+                    SetItemChecked(index, !IsItemChecked(index));
                     return true;
                 }
             }
@@ -385,6 +752,25 @@ bool ListView::HandleMouseDown(int x, int y, int button) {
     return false;
 }
 
+bool ListView::HandleKeyDown(int keyCode) {
+    if (!Widget::HandleKeyDown(keyCode)) return false;
+    
+    // No selection here, so the keys move the view itself
+    int visibleItems = GetVisibleItemCount();
+    int first = m_scrollOffset;
+    switch (keyCode) {
+        case VK_UP:     first -= 1; break;
+        case VK_DOWN:   first += 1; break;
+        case VK_PRIOR:  first -= visibleItems; break;
+        case VK_NEXT:   first += visibleItems; break;
+        case VK_HOME:   first = 0; break;
+        case VK_END:    first = GetItemCount(); break;
+        default:        return false;
+    }
+    ScrollToItem(first);
+    return true;
+}
+
 // TabControl implementation
 TabControl::TabControl()
     : Widget()
@@ -449,6 +835,8 @@ std::shared_ptr<Widget> TabControl::GetTabContent(int index) {
 void TabControl::Render(HDC hdc) {
     if (!m_visible) return;
     
+    ScopedFont font(hdc, GetFont());
+    
     RECT bounds; GetBounds(bounds);
     
     // Draw tab headers
@@ -514,6 +902,8 @@ bool TabControl::HandleMouseDown(int x, int y, int button) {
 
 FileTree::FileTree()
     : Widget()
+    , m_visibleNodesDirty(true)
+    , m_watchChanges(false)
     , m_scrollOffset(0)
     , m_itemHeight(20)
     , m_orientation(Orientation::VERTICAL)
@@ -522,12 +912,33 @@ FileTree::FileTree()
 }
 
 FileTree::~FileTree() {
+    CancelLoads(nullptr);
 }
 
 void FileTree::SetRootPath(const std::wstring& path) {
+    CancelLoads(nullptr);
+    m_selectedNode.reset();
+    
     m_rootPath = path;
     m_rootNode = std::make_shared<TreeNode>(path, path, true);
+    m_nodesByPath.clear();
+    IndexNode(m_rootNode);
+    m_visibleNodesDirty = true;
     LoadDirectory(m_rootNode);
+    
+    if (m_watchChanges) {
+        m_watcher.Start(m_rootPath, true);
+    }
+}
+
+void FileTree::SetWatchChanges(bool watch) {
+    m_watchChanges = watch;
+    if (watch && !m_rootPath.empty()) {
+        m_watcher.Start(m_rootPath, true);
+        ScheduleUpdate();
+    } else {
+        m_watcher.Stop();
+    }
 }
 
 std::wstring FileTree::GetSelectedPath() const {
@@ -540,39 +951,44 @@ std::wstring FileTree::GetSelectedPath() const {
 void FileTree::SetSelectedPath(const std::wstring& path) {
     if (!m_rootNode) return;
     
-    m_selectedNode = FindNodeByPath(m_rootNode, path);
+    m_selectedNode = FindNodeByPath(path);
 }
 
 void FileTree::ExpandAll() {
     if (m_rootNode) {
         ExpandAllRecursive(m_rootNode);
+        m_visibleNodesDirty = true;
     }
 }
 
 void FileTree::CollapseAll() {
     if (m_rootNode) {
         CollapseAllRecursive(m_rootNode);
+        m_visibleNodesDirty = true;
     }
 }
 
 void FileTree::ExpandNode(const std::wstring& path) {
     if (!m_rootNode) return;
     
-    auto node = FindNodeByPath(m_rootNode, path);
+    auto node = FindNodeByPath(path);
     if (node && node->isDirectory) {
         node->expanded = true;
-        if (node->children.empty()) {
-            LoadDirectory(node);
-        }
+        m_visibleNodesDirty = true;
+        LoadDirectory(node);
     }
 }
 
 void FileTree::CollapseNode(const std::wstring& path) {
     if (!m_rootNode) return;
     
-    auto node = FindNodeByPath(m_rootNode, path);
+    auto node = FindNodeByPath(path);
     if (node && node->isDirectory) {
         node->expanded = false;
+        m_visibleNodesDirty = true;
+        if (node->loadState == LoadState::LOADING) {
+            CancelLoads(node);
+        }
     }
 }
 
@@ -581,9 +997,8 @@ void FileTree::ExpandAllRecursive(std::shared_ptr<TreeNode> node) {
     
     if (node->isDirectory) {
         node->expanded = true;
-        if (node->children.empty()) {
-            LoadDirectory(node);
-        }
+        // Children still to come are expanded as they arrive
+        LoadDirectory(node, true);
         
         for (auto& child : node->children) {
             ExpandAllRecursive(child);
@@ -596,6 +1011,10 @@ void FileTree::CollapseAllRecursive(std::shared_ptr<TreeNode> node) {
     
     if (node->isDirectory) {
         node->expanded = false;
+        if (node->loadState == LoadState::LOADING) {
+            CancelLoads(node);
+            return;
+        }
         
         for (auto& child : node->children) {
             CollapseAllRecursive(child);
@@ -608,186 +1027,306 @@ void FileTree::Refresh() {
         return;
     }
     
-    // Save current expansion state
-    std::vector<std::wstring> expandedPaths;
-    GetExpandedPaths(m_rootNode, expandedPaths);
+    // Reloads merge into the existing nodes, so expansion and selection survive
+    ReloadLoadedRecursive(m_rootNode);
+}
+
+void FileTree::ReloadLoadedRecursive(std::shared_ptr<TreeNode> node) {
+    if (!node || node->loadState != LoadState::LOADED) return;
     
-    // Save selected path
-    std::wstring selectedPath = GetSelectedPath();
+    ReloadDirectory(node);
+    for (auto& child : node->children) {
+        ReloadLoadedRecursive(child);
+    }
+}
+
+void FileTree::LoadDirectory(std::shared_ptr<TreeNode> node, bool expandAll) {
+    if (!node || !node->isDirectory) return;
     
-    // Reload the tree
-    m_rootNode->children.clear();
-    LoadDirectory(m_rootNode);
+    if (node->loadState == LoadState::LOADING) {
+        if (expandAll) {
+            for (auto& load : m_loads) {
+                if (!load.reload && load.node.lock() == node) load.expandAll = true;
+            }
+        }
+        return;
+    }
+    if (node->loadState == LoadState::LOADED) return;
     
-    // Restore expansion state
-    RestoreExpandedPaths(m_rootNode, expandedPaths);
+    auto placeholder = std::make_shared<TreeNode>(L"Loading...", L"", false);
+    placeholder->isPlaceholder = true;
+    placeholder->depth = node->depth + 1;
+    UnindexChildren(*node);
+    node->children.clear();
+    node->children.push_back(placeholder);
+    node->loadState = LoadState::LOADING;
+    m_visibleNodesDirty = true;
     
-    // Restore selection
-    if (!selectedPath.empty()) {
-        SetSelectedPath(selectedPath);
-    }
+    m_loads.push_back({ node, DirectoryLoader::Load(node->fullPath), expandAll, false, {} });
+    ScheduleUpdate();
 }
 
-void FileTree::GetExpandedPaths(std::shared_ptr<TreeNode> node, std::vector<std::wstring>& paths) {
-    if (!node) return;
+void FileTree::ReloadDirectory(std::shared_ptr<TreeNode> node) {
+    if (!node || node->loadState != LoadState::LOADED) return;
     
-    if (node->expanded && node->isDirectory) {
-        paths.push_back(node->fullPath);
+    // A newer reload supersedes one still in flight
+    for (auto it = m_loads.begin(); it != m_loads.end(); ++it) {
+        if (it->reload && it->node.lock() == node) {
+            it->request->Cancel();
+            m_loads.erase(it);
+            break;
+        }
     }
-    
+    m_loads.push_back({ node, DirectoryLoader::Load(node->fullPath), false, true, {} });
+    ScheduleUpdate();
+}
+
+void FileTree::MergeChildren(std::shared_ptr<TreeNode> node, std::vector<DirectoryLoader::Entry>& entries) {
+    // Keep nodes that still exist so their expansion and loaded children survive
+    std::unordered_map<std::wstring, std::shared_ptr<TreeNode>> existing;
     for (auto& child : node->children) {
-        GetExpandedPaths(child, paths);
+        existing[child->fullPath] = child;
+    }
+    
+    std::vector<std::shared_ptr<TreeNode>> children;
+    children.reserve(entries.size());
+    for (auto& entry : entries) {
+        auto it = existing.find(entry.fullPath);
+        if (it != existing.end() && it->second->isDirectory == entry.isDirectory) {
+            children.push_back(it->second);
+            existing.erase(it);
+        } else {
+            auto child = std::make_shared<TreeNode>(entry.name, entry.fullPath, entry.isDirectory);
+            child->depth = node->depth + 1;
+            IndexNode(child);
+            children.push_back(child);
+        }
+    }
+    node->children.swap(children);
+    m_visibleNodesDirty = true;
+    
+    // Whatever is left was removed from disk
+    for (auto& pair : existing) {
+        CancelLoads(pair.second);
+        UnindexChildren(*pair.second);
+        // A replacement of the other kind is indexed under the same path
+        auto indexed = m_nodesByPath.find(pair.first);
+        if (indexed != m_nodesByPath.end() && indexed->second.lock() == pair.second) {
+            m_nodesByPath.erase(indexed);
+        }
+        if (m_selectedNode && IsSameOrUnder(m_selectedNode->fullPath, pair.first)) {
+            m_selectedNode.reset();
+        }
     }
 }
 
-void FileTree::RestoreExpandedPaths(std::shared_ptr<TreeNode> node, const std::vector<std::wstring>& paths) {
-    if (!node) return;
+void FileTree::CancelLoads(std::shared_ptr<TreeNode> node) {
+    for (size_t i = 0; i < m_loads.size();) {
+        auto loadNode = m_loads[i].node.lock();
+        if (node && loadNode && !IsSameOrUnder(loadNode->fullPath, node->fullPath)) {
+            i++;
+            continue;
+        }
+        
+        m_loads[i].request->Cancel();
+        if (loadNode && !m_loads[i].reload) {
+            // Drop the partial listing; expanding again starts over
+            UnindexChildren(*loadNode);
+            loadNode->children.clear();
+            loadNode->loadState = LoadState::NOT_LOADED;
+            m_visibleNodesDirty = true;
+            if (m_selectedNode && m_selectedNode != loadNode &&
+                IsSameOrUnder(m_selectedNode->fullPath, loadNode->fullPath)) {
+                m_selectedNode.reset();
+            }
+        }
+        m_loads.erase(m_loads.begin() + i);
+    }
+}
+
+bool FileTree::ProcessLoads() {
+    bool changed = false;
+    size_t budget = MAX_TREE_ENTRIES_PER_UPDATE;
+    std::vector<std::shared_ptr<TreeNode>> expandQueue;
     
-    // Check if this node should be expanded
-    for (const auto& path : paths) {
-        if (node->fullPath == path) {
-            node->expanded = true;
-            if (node->children.empty()) {
-                LoadDirectory(node);
+    for (size_t i = 0; i < m_loads.size();) {
+        PendingLoad& load = m_loads[i];
+        auto node = load.node.lock();
+        if (!node) {
+            load.request->Cancel();
+            m_loads.erase(m_loads.begin() + i);
+            continue;
+        }
+        
+        auto entries = load.request->TakeEntries(budget);
+        budget -= entries.size();
+        
+        if (load.reload) {
+            for (auto& entry : entries) {
+                load.entries.push_back(std::move(entry));
             }
-            break;
+        } else if (!entries.empty()) {
+            // Insert ahead of the placeholder, which stays last until the listing ends
+            std::vector<std::shared_ptr<TreeNode>> children;
+            children.reserve(entries.size());
+            for (const auto& entry : entries) {
+                auto child = std::make_shared<TreeNode>(entry.name, entry.fullPath, entry.isDirectory);
+                child->depth = node->depth + 1;
+                IndexNode(child);
+                if (load.expandAll && child->isDirectory) {
+                    child->expanded = true;
+                    expandQueue.push_back(child);
+                }
+                children.push_back(child);
+            }
+            node->children.insert(node->children.end() - 1, children.begin(), children.end());
+            changed = true;
+        }
+        
+        if (!load.request->IsComplete()) {
+            i++;
+            continue;
+        }
+        
+        // Merging can cancel loads of removed directories, so take this one out first
+        PendingLoad finished = std::move(load);
+        m_loads.erase(m_loads.begin() + i);
+        
+        if (finished.reload) {
+            MergeChildren(node, finished.entries);
+        } else {
+            if (!node->children.empty() && node->children.back()->isPlaceholder) {
+                node->children.pop_back();
+            }
+            node->loadState = LoadState::LOADED;
         }
+        changed = true;
     }
     
-    // Recursively restore children
-    for (auto& child : node->children) {
-        RestoreExpandedPaths(child, paths);
+    if (changed) {
+        m_visibleNodesDirty = true;
     }
+    
+    for (auto& child : expandQueue) {
+        LoadDirectory(child, true);
+    }
+    return changed;
 }
 
-void FileTree::LoadDirectory(std::shared_ptr<TreeNode> node) {
-    if (!node || !node->isDirectory) return;
+void FileTree::Update(float deltaTime) {
+    Widget::Update(deltaTime);
     
-    // SECURITY: Validate path to prevent directory traversal attacks
-    // In production, add additional path validation to prevent malicious paths
+    if (m_watcher.IsWatching()) {
+        bool overflowed = false;
+        auto changedDirectories = m_watcher.Poll(overflowed);
+        if (overflowed) {
+            Refresh();
+        } else {
+            for (const auto& path : changedDirectories) {
+                ReloadDirectory(FindNodeByPath(path));
+            }
+        }
+    }
     
-    WIN32_FIND_DATAW findData;
-    std::wstring searchPath = node->fullPath + L"\\*";
-    HANDLE hFind = FindFirstFileW(searchPath.c_str(), &findData);
+    if (ProcessLoads()) {
+        Invalidate();
+    }
     
-    if (hFind != INVALID_HANDLE_VALUE) {
-        do {
-            if (wcscmp(findData.cFileName, L".") != 0 && wcscmp(findData.cFileName, L"..") != 0) {
-                std::wstring fullPath = node->fullPath + L"\\" + findData.cFileName;
-                bool isDir = (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
-                
-                auto child = std::make_shared<TreeNode>(findData.cFileName, fullPath, isDir);
-                child->depth = node->depth + 1;
-                node->children.push_back(child);
-            }
-        } while (FindNextFileW(hFind, &findData));
-        
-        FindClose(hFind);
+    if (IsLoading()) {
+        ScheduleUpdate();
+    } else if (m_watcher.IsWatching()) {
+        ScheduleUpdate(WATCH_POLL_INTERVAL);
     }
 }
 
 void FileTree::Render(HDC hdc) {
     if (!m_visible || !m_rootNode) return;
     
+    ScopedFont font(hdc, GetFont());
+    
     RECT bounds; GetBounds(bounds);
     Renderer::DrawRoundedRect(hdc, bounds, 4, Color(255, 255, 255, 255), Color(128, 128, 128, 255), 1);
     
-    int offset = (m_orientation == Orientation::VERTICAL) ? bounds.top : bounds.left;
-    RenderNode(hdc, m_rootNode, offset);
-    
-    Widget::Render(hdc);
-}
-
-void FileTree::RenderNode(HDC hdc, std::shared_ptr<TreeNode> node, int& offset) {
-    if (!node) return;
-    
+    // Rows (or columns) are evenly spaced, so only the ones in view are drawn
+    const auto& nodes = GetVisibleNodes();
+    int count = (int)nodes.size();
     if (m_orientation == Orientation::VERTICAL) {
-        RenderNodeVertical(hdc, node, offset);
+        int first = std::max(m_scrollOffset / m_itemHeight, 0);
+        int last = std::min((m_scrollOffset + m_height + m_itemHeight - 1) / m_itemHeight, count);
+        for (int i = first; i < last; i++) {
+            RenderNodeVertical(hdc, *nodes[i], bounds.top + i * m_itemHeight - m_scrollOffset);
+        }
     } else {
-        RenderNodeHorizontal(hdc, node, offset);
+        int first = std::max(m_scrollOffset / TREE_COLUMN_STEP, 0);
+        int last = std::min((m_scrollOffset + m_width + TREE_COLUMN_STEP - 1) / TREE_COLUMN_STEP, count);
+        for (int i = first; i < last; i++) {
+            RenderNodeHorizontal(hdc, *nodes[i], bounds.left + i * TREE_COLUMN_STEP - m_scrollOffset);
+        }
     }
+    
+    Widget::Render(hdc);
 }
 
-void FileTree::RenderNodeVertical(HDC hdc, std::shared_ptr<TreeNode> node, int& yOffset) {
-    if (!node) return;
-    
+void FileTree::RenderNodeVertical(HDC hdc, const TreeNode& node, int y) {
     RECT bounds; GetBounds(bounds);
-    int indent = node->depth * 15;
+    int indent = node.depth * TREE_INDENT;
     
-    RECT nodeRect = {bounds.left + indent, yOffset, bounds.right, yOffset + m_itemHeight};
+    RECT nodeRect = {bounds.left + indent, y, bounds.right, y + m_itemHeight};
     
-    if (node == m_selectedNode) {
-        HBRUSH brush = CreateSolidBrush(RGB(200, 220, 255));
+    if (&node == m_selectedNode.get()) {
+        HBRUSH brush = GdiObjectCache::GetBrush(RGB(200, 220, 255));
         FillRect(hdc, &nodeRect, brush);
-        DeleteObject(brush);
     }
     
-    // Draw expand/collapse indicator for directories
-    if (node->isDirectory && !node->children.empty()) {
-        RenderExpandIndicator(hdc, node, bounds.left + indent, yOffset + m_itemHeight / 2);
+    // Draw expand/collapse indicator for directories; unlisted ones may have children
+    if (node.isDirectory && (node.loadState != LoadState::LOADED || !node.children.empty())) {
+        RenderExpandIndicator(hdc, node, bounds.left + indent, y + m_itemHeight / 2);
     }
     
     SetBkMode(hdc, TRANSPARENT);
-    SetTextColor(hdc, RGB(0, 0, 0));
+    SetTextColor(hdc, node.isPlaceholder ? RGB(128, 128, 128) : RGB(0, 0, 0));
     
-    std::wstring displayText = node->isDirectory ? L"📁 " : L"📄 ";
-    displayText += node->name;
+    std::wstring displayText;
+    if (!node.isPlaceholder) {
+        displayText = node.isDirectory ? L"📁 " : L"📄 ";
+    }
+    displayText += node.name;
     
     RECT textRect = nodeRect;
     textRect.left += 20; // Space for expand indicator
     DrawTextW(hdc, displayText.c_str(), -1, &textRect, DT_LEFT | DT_VCENTER | DT_SINGLELINE);
-    
-    yOffset += m_itemHeight;
-    
-    if (node->expanded && node->isDirectory) {
-        for (auto& child : node->children) {
-            RenderNodeVertical(hdc, child, yOffset);
-        }
-    }
 }
 
-void FileTree::RenderNodeHorizontal(HDC hdc, std::shared_ptr<TreeNode> node, int& xOffset) {
-    if (!node) return;
-    
+void FileTree::RenderNodeHorizontal(HDC hdc, const TreeNode& node, int x) {
     RECT bounds; GetBounds(bounds);
-    int indent = node->depth * 80;
+    int indent = node.depth * TREE_LEVEL_HEIGHT;
     
-    RECT nodeRect = {xOffset, bounds.top + indent, xOffset + 60, bounds.top + indent + m_itemHeight};
+    RECT nodeRect = {x, bounds.top + indent, x + TREE_COLUMN_WIDTH, bounds.top + indent + m_itemHeight};
     
-    if (node == m_selectedNode) {
-        HBRUSH brush = CreateSolidBrush(RGB(200, 220, 255));
+    if (&node == m_selectedNode.get()) {
+        HBRUSH brush = GdiObjectCache::GetBrush(RGB(200, 220, 255));
         FillRect(hdc, &nodeRect, brush);
-        DeleteObject(brush);
     }
     
-    // Draw expand/collapse indicator for directories
-    if (node->isDirectory && !node->children.empty()) {
-        RenderExpandIndicator(hdc, node, xOffset + 30, bounds.top + indent);
+    // Draw expand/collapse indicator for directories; unlisted ones may have children
+    if (node.isDirectory && (node.loadState != LoadState::LOADED || !node.children.empty())) {
+        RenderExpandIndicator(hdc, node, x + TREE_COLUMN_WIDTH / 2, bounds.top + indent);
     }
     
     SetBkMode(hdc, TRANSPARENT);
-    SetTextColor(hdc, RGB(0, 0, 0));
+    SetTextColor(hdc, node.isPlaceholder ? RGB(128, 128, 128) : RGB(0, 0, 0));
     
-    std::wstring displayText = node->isDirectory ? L"📁" : L"📄";
+    std::wstring displayText = node.isPlaceholder ? L"..." : (node.isDirectory ? L"📁" : L"📄");
     DrawTextW(hdc, displayText.c_str(), -1, &nodeRect, DT_CENTER | DT_VCENTER | DT_SINGLELINE);
-    
-    xOffset += 70;
-    
-    if (node->expanded && node->isDirectory) {
-        int childYStart = bounds.top + indent + m_itemHeight;
-        for (auto& child : node->children) {
-            RenderNodeHorizontal(hdc, child, xOffset);
-        }
-    }
 }
 
-void FileTree::RenderExpandIndicator(HDC hdc, std::shared_ptr<TreeNode> node, int x, int y) {
-    if (!node || !node->isDirectory) return;
+void FileTree::RenderExpandIndicator(HDC hdc, const TreeNode& node, int x, int y) {
+    if (!node.isDirectory) return;
     
     int size = 4;
     POINT triangle[3];
     
-    if (node->expanded) {
+    if (node.expanded) {
         // Down-pointing triangle (expanded)
         triangle[0] = {x, y + size};
         triangle[1] = {x - size, y - size};
@@ -799,8 +1338,8 @@ void FileTree::RenderExpandIndicator(HDC hdc, std::shared_ptr<TreeNode> node, in
         triangle[2] = {x - size, y + size};
     }
     
-    HBRUSH brush = CreateSolidBrush(RGB(100, 100, 100));
-    HPEN pen = CreatePen(PS_SOLID, 1, RGB(100, 100, 100));
+    HBRUSH brush = GdiObjectCache::GetBrush(RGB(100, 100, 100));
+    HPEN pen = GdiObjectCache::GetPen(RGB(100, 100, 100));
     HGDIOBJ oldBrush = SelectObject(hdc, brush);
     HGDIOBJ oldPen = SelectObject(hdc, pen);
     
@@ -808,67 +1347,81 @@ void FileTree::RenderExpandIndicator(HDC hdc, std::shared_ptr<TreeNode> node, in
     
     SelectObject(hdc, oldBrush);
     SelectObject(hdc, oldPen);
-    DeleteObject(brush);
-    DeleteObject(pen);
 }
 
 std::shared_ptr<FileTree::TreeNode> FileTree::HitTestNode(int x, int y) {
     if (!m_rootNode) return nullptr;
     
     RECT bounds; GetBounds(bounds);
-    int offset = (m_orientation == Orientation::VERTICAL) ? bounds.top : bounds.left;
-    return HitTestNodeRecursive(m_rootNode, x, y, offset);
-}
-
-std::shared_ptr<FileTree::TreeNode> FileTree::HitTestNodeRecursive(std::shared_ptr<TreeNode> node, int x, int y, int& offset) {
-    if (!node) return nullptr;
-    
-    RECT bounds; GetBounds(bounds);
-    RECT nodeRect;
+    const auto& nodes = GetVisibleNodes();
     
+    // The row or column under the point, then whether the node's rect covers it
     if (m_orientation == Orientation::VERTICAL) {
-        int indent = node->depth * 15;
-        nodeRect = {bounds.left + indent, offset, bounds.right, offset + m_itemHeight};
-        
-        if (x >= nodeRect.left && x < nodeRect.right && y >= nodeRect.top && y < nodeRect.bottom) {
-            return node;
-        }
-        
-        offset += m_itemHeight;
-    } else {
-        int indent = node->depth * 80;
-        nodeRect = {offset, bounds.top + indent, offset + 60, bounds.top + indent + m_itemHeight};
+        int offset = y - bounds.top + m_scrollOffset;
+        if (offset < 0) return nullptr;
+        size_t index = (size_t)(offset / m_itemHeight);
+        if (index >= nodes.size()) return nullptr;
         
-        if (x >= nodeRect.left && x < nodeRect.right && y >= nodeRect.top && y < nodeRect.bottom) {
-            return node;
-        }
-        
-        offset += 70;
+        const auto& node = nodes[index];
+        if (x < bounds.left + node->depth * TREE_INDENT || x >= bounds.right) return nullptr;
+        return node;
     }
     
+    int offset = x - bounds.left + m_scrollOffset;
+    if (offset < 0) return nullptr;
+    size_t index = (size_t)(offset / TREE_COLUMN_STEP);
+    if (index >= nodes.size() || offset % TREE_COLUMN_STEP >= TREE_COLUMN_WIDTH) return nullptr;
+    
+    const auto& node = nodes[index];
+    int top = bounds.top + node->depth * TREE_LEVEL_HEIGHT;
+    if (y < top || y >= top + m_itemHeight) return nullptr;
+    return node;
+}
+
+const std::vector<std::shared_ptr<FileTree::TreeNode>>& FileTree::GetVisibleNodes() {
+    if (m_visibleNodesDirty) {
+        m_visibleNodes.clear();
+        if (m_rootNode) {
+            AppendVisibleNodes(m_rootNode);
+        }
+        m_visibleNodesDirty = false;
+    }
+    return m_visibleNodes;
+}
+
+void FileTree::AppendVisibleNodes(const std::shared_ptr<TreeNode>& node) {
+    m_visibleNodes.push_back(node);
     if (node->expanded && node->isDirectory) {
-        for (auto& child : node->children) {
-            auto result = HitTestNodeRecursive(child, x, y, offset);
-            if (result) return result;
+        for (const auto& child : node->children) {
+            AppendVisibleNodes(child);
         }
     }
-    
-    return nullptr;
 }
 
-std::shared_ptr<FileTree::TreeNode> FileTree::FindNodeByPath(std::shared_ptr<TreeNode> node, const std::wstring& path) {
-    if (!node) return nullptr;
-    
-    if (node->fullPath == path) {
-        return node;
+void FileTree::IndexNode(const std::shared_ptr<TreeNode>& node) {
+    m_nodesByPath[node->fullPath] = node;
+}
+
+void FileTree::UnindexChildren(const TreeNode& node) {
+    for (const auto& child : node.children) {
+        if (child->isPlaceholder) continue;
+        UnindexChildren(*child);
+        auto it = m_nodesByPath.find(child->fullPath);
+        if (it != m_nodesByPath.end() && it->second.lock() == child) {
+            m_nodesByPath.erase(it);
+        }
     }
+}
+
+std::shared_ptr<FileTree::TreeNode> FileTree::FindNodeByPath(const std::wstring& path) {
+    auto it = m_nodesByPath.find(path);
+    if (it == m_nodesByPath.end()) return nullptr;
     
-    for (auto& child : node->children) {
-        auto result = FindNodeByPath(child, path);
-        if (result) return result;
+    auto node = it->second.lock();
+    if (!node) {
+        m_nodesByPath.erase(it);
     }
-    
-    return nullptr;
+    return node;
 }
 
 bool FileTree::HandleMouseDown(int x, int y, int button) {
@@ -876,12 +1429,19 @@ bool FileTree::HandleMouseDown(int x, int y, int button) {
     
     if (HitTest(x, y)) {
         auto node = HitTestNode(x, y);
+        if (node && node->isPlaceholder) {
+            return true;
+        }
         if (node) {
             m_selectedNode = node;
             if (node->isDirectory) {
                 node->expanded = !node->expanded;
-                if (node->expanded && node->children.empty()) {
+                m_visibleNodesDirty = true;
+                if (node->expanded) {
                     LoadDirectory(node);
+                } else if (node->loadState == LoadState::LOADING) {
+                    // Collapsing walks away from the listing
+                    CancelLoads(node);
                 }
             }
             TriggerEvent(WidgetEvent::CLICK, node.get());
@@ -895,6 +1455,7 @@ bool FileTree::HandleMouseDown(int x, int y, int button) {
 // SyntaxHighlightTextEditor implementation
 SyntaxHighlightTextEditor::SyntaxHighlightTextEditor()
     : Widget()
+    , m_tokensCheckedThrough(0)
     , m_language(Language::PLAIN_TEXT)
     , m_showLineNumbers(true)
     , m_wordWrap(false)
@@ -909,38 +1470,79 @@ SyntaxHighlightTextEditor::SyntaxHighlightTextEditor()
     , m_operatorColor(128, 0, 128, 255)
 {
     m_height = 400;
+    UpdateSyntaxHighlighting();
 }
 
 SyntaxHighlightTextEditor::~SyntaxHighlightTextEditor() {
 }
 
 void SyntaxHighlightTextEditor::SetText(const std::wstring& text) {
-    m_text = text;
-    m_lines.clear();
+    m_buffer.SetText(text);
+    m_undoStack.clear();
     
-    // Split into lines
-    size_t pos = 0;
-    size_t newlinePos;
-    while ((newlinePos = text.find(L'\n', pos)) != std::wstring::npos) {
-        m_lines.push_back(text.substr(pos, newlinePos - pos));
-        pos = newlinePos + 1;
-    }
-    if (pos < text.length()) {
-        m_lines.push_back(text.substr(pos));
+    m_cursorLine = 0;
+    m_cursorColumn = 0;
+    UpdateSyntaxHighlighting();
+    Invalidate();
+}
+
+void SyntaxHighlightTextEditor::SetLanguage(Language language) {
+    if (m_language != language) {
+        m_language = language;
+        UpdateSyntaxHighlighting();
+        Invalidate();
     }
+}
+
+void SyntaxHighlightTextEditor::SetLine(int index, const std::wstring& text) {
+    if (index < 0 || index >= GetLineCount()) return;
+    ReplaceText(m_buffer.GetLineStart(index), m_buffer.GetLineLength(index), text);
+    Invalidate();
+}
+
+bool SyntaxHighlightTextEditor::Undo() {
+    if (m_undoStack.empty()) return false;
+    
+    m_buffer = m_undoStack.back().buffer;
+    m_cursorLine = m_undoStack.back().cursorLine;
+    m_cursorColumn = m_undoStack.back().cursorColumn;
+    m_undoStack.pop_back();
     
     UpdateSyntaxHighlighting();
+    TriggerEvent(WidgetEvent::TEXT_CHANGED);
+    Invalidate();
+    return true;
 }
 
-std::vector<SyntaxHighlightTextEditor::SyntaxToken> SyntaxHighlightTextEditor::TokenizeLine(const std::wstring& line) {
-    std::vector<SyntaxToken> tokens;
+void SyntaxHighlightTextEditor::ReplaceText(size_t offset, size_t length, const std::wstring& text) {
+    // Snapshots share the buffer's tree, so one per edit is cheap
+    if (m_undoStack.size() >= MAX_EDITOR_UNDO_STEPS) {
+        m_undoStack.erase(m_undoStack.begin());
+    }
+    m_undoStack.push_back({ m_buffer, m_cursorLine, m_cursorColumn });
+    
+    size_t line = m_buffer.GetLineFromOffset(offset);
+    std::wstring removed = m_buffer.GetText(offset, length);
+    size_t removedBreaks = (size_t)std::count(removed.begin(), removed.end(), L'\n');
+    size_t addedBreaks = (size_t)std::count(text.begin(), text.end(), L'\n');
+    
+    m_buffer.Erase(offset, length);
+    m_buffer.Insert(offset, text);
+    
+    // Keep the token cache in step: lines after the edited one shift, and the
+    // edited line is re-lexed (and any following ones until the state converges)
+    m_lineTokens.erase(m_lineTokens.begin() + line + 1, m_lineTokens.begin() + line + 1 + removedBreaks);
+    m_lineTokens.insert(m_lineTokens.begin() + line + 1, addedBreaks, LineTokens());
+    InvalidateLine(line);
+}
+
+void SyntaxHighlightTextEditor::TokenizeLine(std::wstring_view line, LexState& state, std::vector<SyntaxToken>& tokens) {
+    tokens.clear();
+    Color plainColor(0, 0, 0, 255);
     
     if (m_language == Language::PLAIN_TEXT || line.empty()) {
-        SyntaxToken token;
-        token.text = line;
-        token.color = Color(0, 0, 0, 255);
-        tokens.push_back(token);
-        return tokens;
+        tokens.push_back({ 0, line.length(), 0, plainColor });
+        return;
     }
     
     // Simple tokenization for C++
@@ -957,6 +1559,19 @@ std::vector<SyntaxHighlightTextEditor::SyntaxToken> SyntaxHighlightTextEditor::T
         while (pos < line.length()) {
             wchar_t ch = line[pos];
             
+            // Block comments may continue from the previous line
+            if (state == LexState::BLOCK_COMMENT) {
+                size_t end = line.find(L"*/", pos);
+                if (end == std::wstring::npos) {
+                    tokens.push_back({ pos, line.length() - pos, 0, m_commentColor });
+                    break;
+                }
+                tokens.push_back({ pos, end + 2 - pos, 0, m_commentColor });
+                pos = end + 2;
+                state = LexState::NORMAL;
+                continue;
+            }
+            
             // Skip whitespace
             if (iswspace(ch)) {
                 pos++;
@@ -965,13 +1580,22 @@ std::vector<SyntaxHighlightTextEditor::SyntaxToken> SyntaxHighlightTextEditor::T
             
             // Comments
             if (pos + 1 < line.length() && line[pos] == L'/' && line[pos + 1] == L'/') {
-                SyntaxToken token;
-                token.text = line.substr(pos);
-                token.color = m_commentColor;
-                tokens.push_back(token);
+                tokens.push_back({ pos, line.length() - pos, 0, m_commentColor });
                 break;
             }
             
+            if (pos + 1 < line.length() && line[pos] == L'/' && line[pos + 1] == L'*') {
+                size_t end = line.find(L"*/", pos + 2);
+                if (end == std::wstring::npos) {
+                    tokens.push_back({ pos, line.length() - pos, 0, m_commentColor });
+                    state = LexState::BLOCK_COMMENT;
+                    break;
+                }
+                tokens.push_back({ pos, end + 2 - pos, 0, m_commentColor });
+                pos = end + 2;
+                continue;
+            }
+            
             // String literals
             if (ch == L'"' || ch == L'\'') {
                 size_t end = pos + 1;
@@ -985,10 +1609,7 @@ std::vector<SyntaxHighlightTextEditor::SyntaxToken> SyntaxHighlightTextEditor::T
                 }
                 if (end < line.length()) end++;
                 
-                SyntaxToken token;
-                token.text = line.substr(pos, end - pos);
-                token.color = m_stringColor;
-                tokens.push_back(token);
+                tokens.push_back({ pos, end - pos, 0, m_stringColor });
                 pos = end;
                 continue;
             }
@@ -1030,10 +1651,7 @@ std::vector<SyntaxHighlightTextEditor::SyntaxToken> SyntaxHighlightTextEditor::T
                     end++;
                 }
                 
-                SyntaxToken token;
-                token.text = line.substr(pos, end - pos);
-                token.color = m_numberColor;
-                tokens.push_back(token);
+                tokens.push_back({ pos, end - pos, 0, m_numberColor });
                 pos = end;
                 continue;
             }
@@ -1045,57 +1663,84 @@ std::vector<SyntaxHighlightTextEditor::SyntaxToken> SyntaxHighlightTextEditor::T
                     end++;
                 }
                 
-                std::wstring word = line.substr(pos, end - pos);
-                SyntaxToken token;
-                token.text = word;
-                
                 // Check if keyword
                 bool isKeyword = false;
                 for (const auto& keyword : keywords) {
-                    if (word == keyword) {
-                        token.color = m_keywordColor;
+                    if (line.compare(pos, end - pos, keyword) == 0) {
                         isKeyword = true;
                         break;
                     }
                 }
                 
-                if (!isKeyword) {
-                    token.color = Color(0, 0, 0, 255);
-                }
-                
-                tokens.push_back(token);
+                tokens.push_back({ pos, end - pos, 0, isKeyword ? m_keywordColor : plainColor });
                 pos = end;
                 continue;
             }
             
             // Operators and punctuation
-            SyntaxToken token;
-            token.text = std::wstring(1, ch);
-            token.color = m_operatorColor;
-            tokens.push_back(token);
+            tokens.push_back({ pos, 1, 0, m_operatorColor });
             pos++;
         }
     }
     
     if (tokens.empty()) {
-        SyntaxToken token;
-        token.text = line;
-        token.color = Color(0, 0, 0, 255);
-        tokens.push_back(token);
+        tokens.push_back({ 0, line.length(), 0, plainColor });
     }
-    
-    return tokens;
 }
 
 void SyntaxHighlightTextEditor::UpdateSyntaxHighlighting() {
-    // Tokenize all lines for syntax highlighting
-    // This method is called when text or language changes
-    // In a real implementation, this would build a token cache for faster rendering
+    // Called when the text or language changes; lines are lexed again on demand
+    m_lineTokens.assign(m_buffer.GetLineCount(), LineTokens());
+    m_tokensCheckedThrough = 0;
+}
+
+void SyntaxHighlightTextEditor::InvalidateLine(size_t line) {
+    if (line < m_lineTokens.size()) {
+        m_lineTokens[line].valid = false;
+    }
+    m_tokensCheckedThrough = std::min(m_tokensCheckedThrough, line);
+}
+
+void SyntaxHighlightTextEditor::EnsureTokens(HDC hdc, size_t endLine) {
+    endLine = std::min(endLine, m_buffer.GetLineCount());
+    
+    FrameArena::Scope scratch;
+    FrameWString line(FrameArena::GetResource());
+    FrameVector<int> extents(FrameArena::GetResource());
+    for (size_t i = m_tokensCheckedThrough; i < endLine; i++) {
+        LexState state = i == 0 ? LexState::NORMAL : m_lineTokens[i - 1].endState;
+        LineTokens& cache = m_lineTokens[i];
+        
+        // An unchanged line entered in the same state lexes the same way, so
+        // re-lexing after an edit stops as soon as the states converge
+        if (cache.valid && cache.startState == state) continue;
+        
+        cache.startState = state;
+        m_buffer.GetLine(i, line);
+        TokenizeLine(line, state, cache.tokens);
+        cache.endState = state;
+        cache.valid = true;
+        
+        // Token positions from one measurement of the whole line
+        if (!line.empty()) {
+            extents.resize(line.length());
+            SIZE size;
+            if (GetTextExtentExPointW(hdc, line.c_str(), (int)line.length(), 0, nullptr, extents.data(), &size)) {
+                for (auto& token : cache.tokens) {
+                    token.x = token.start > 0 ? extents[token.start - 1] : 0;
+                }
+            }
+        }
+    }
+    
+    m_tokensCheckedThrough = std::max(m_tokensCheckedThrough, endLine);
 }
 
 void SyntaxHighlightTextEditor::Render(HDC hdc) {
     if (!m_visible) return;
     
+    ScopedFont font(hdc, FontCache::Get(L"Consolas", 14, FW_NORMAL, false, false, false, GetDPI()));
+    
     RECT bounds; GetBounds(bounds);
     Renderer::DrawRoundedRect(hdc, bounds, 4, Color(255, 255, 255, 255), Color(128, 128, 128, 255), 1);
     
@@ -1103,31 +1748,34 @@ void SyntaxHighlightTextEditor::Render(HDC hdc) {
     int lineHeight = 18;
     int lineNumberWidth = m_showLineNumbers ? 40 : 0;
     
-    for (size_t i = m_scrollOffsetY; i < m_lines.size(); i++) {
-        int yPos = bounds.top + (int)(i - m_scrollOffsetY) * lineHeight;
-        if (yPos >= bounds.bottom) break;
+    // Only the visible lines are lexed and drawn
+    size_t firstLine = (size_t)std::max(0, m_scrollOffsetY);
+    size_t endLine = firstLine + (bounds.bottom - bounds.top + lineHeight - 1) / lineHeight;
+    EnsureTokens(hdc, endLine);
+    
+    FrameArena::Scope scratch;
+    FrameWString line(FrameArena::GetResource());
+    for (size_t i = firstLine; i < std::min(endLine, m_buffer.GetLineCount()); i++) {
+        int yPos = bounds.top + (int)(i - firstLine) * lineHeight;
         
         // Draw line number
         if (m_showLineNumbers) {
             RECT lineNumRect = {bounds.left, yPos, bounds.left + lineNumberWidth, yPos + lineHeight};
             SetTextColor(hdc, RGB(128, 128, 128));
-            std::wstring lineNum = std::to_wstring(i + 1);
-            DrawTextW(hdc, lineNum.c_str(), -1, &lineNumRect, DT_RIGHT | DT_VCENTER | DT_SINGLELINE);
+            wchar_t lineNum[24];
+            swprintf(lineNum, sizeof(lineNum) / sizeof(lineNum[0]), L"%zu", i + 1);
+            DrawTextW(hdc, lineNum, -1, &lineNumRect, DT_RIGHT | DT_VCENTER | DT_SINGLELINE);
         }
         
         // Draw line text with syntax highlighting
         int xPos = bounds.left + lineNumberWidth + 5;
-        auto tokens = TokenizeLine(m_lines[i]);
+        m_buffer.GetLine(i, line);
         
-        for (const auto& token : tokens) {
-            RECT textRect = {xPos, yPos, bounds.right, yPos + lineHeight};
+        for (const auto& token : m_lineTokens[i].tokens) {
+            RECT textRect = {xPos + token.x, yPos, bounds.right, yPos + lineHeight};
             SetTextColor(hdc, token.color.ToCOLORREF());
-            DrawTextW(hdc, token.text.c_str(), -1, &textRect, DT_LEFT | DT_VCENTER | DT_SINGLELINE | DT_NOCLIP);
-            
-            // Calculate width of token for next position
-            SIZE tokenSize;
-            GetTextExtentPoint32W(hdc, token.text.c_str(), (int)token.text.length(), &tokenSize);
-            xPos += tokenSize.cx;
+            DrawTextW(hdc, line.c_str() + token.start, (int)token.length, &textRect,
+                      DT_LEFT | DT_VCENTER | DT_SINGLELINE | DT_NOCLIP);
         }
     }
     
@@ -1149,7 +1797,7 @@ bool SyntaxHighlightTextEditor::HandleMouseDown(int x, int y, int button) {
         int relY = y - bounds.top;
         int clickedLine = m_scrollOffsetY + relY / lineHeight;
         
-        if (clickedLine >= 0 && clickedLine < (int)m_lines.size()) {
+        if (clickedLine >= 0 && clickedLine < GetLineCount()) {
             m_cursorLine = clickedLine;
             
             // Calculate column position (approximate)
@@ -1160,16 +1808,17 @@ bool SyntaxHighlightTextEditor::HandleMouseDown(int x, int y, int button) {
                 // Use average character width for approximation
                 HDC hdc = GetDC(nullptr);
                 SIZE charSize;
-                GetTextExtentPoint32W(hdc, L"W", 1, &charSize);
+                {
+                    ScopedFont font(hdc, FontCache::Get(L"Consolas", 14, FW_NORMAL, false, false, false, GetDPI()));
+                    GetTextExtentPoint32W(hdc, L"W", 1, &charSize);
+                }
                 ReleaseDC(nullptr, hdc);
                 
                 int charWidth = charSize.cx;
                 m_cursorColumn = relX / charWidth;
                 
                 // Clamp to line length
-                if (m_cursorColumn > (int)m_lines[m_cursorLine].length()) {
-                    m_cursorColumn = (int)m_lines[m_cursorLine].length();
-                }
+                m_cursorColumn = std::min(m_cursorColumn, (int)m_buffer.GetLineLength(m_cursorLine));
             }
         }
         
@@ -1182,20 +1831,75 @@ bool SyntaxHighlightTextEditor::HandleMouseDown(int x, int y, int button) {
 bool SyntaxHighlightTextEditor::HandleKeyDown(int keyCode) {
     if (!Widget::HandleKeyDown(keyCode)) return false;
     
-    // Handle text editor key commands
+    m_cursorLine = std::max(0, std::min(m_cursorLine, GetLineCount() - 1));
+    int lineLength = (int)m_buffer.GetLineLength(m_cursorLine);
+    m_cursorColumn = std::max(0, std::min(m_cursorColumn, lineLength));
+    size_t offset = m_buffer.GetLineStart(m_cursorLine) + m_cursorColumn;
+    
+    if (keyCode == VK_BACK) {
+        if (offset == 0) return true;
+        if (m_cursorColumn > 0) {
+            m_cursorColumn--;
+        } else {
+            // Join with the previous line
+            m_cursorLine--;
+            m_cursorColumn = (int)m_buffer.GetLineLength(m_cursorLine);
+        }
+        ReplaceText(offset - 1, 1, L"");
+        TriggerEvent(WidgetEvent::TEXT_CHANGED);
+    } else if (keyCode == VK_DELETE) {
+        if (offset >= m_buffer.GetLength()) return true;
+        ReplaceText(offset, 1, L"");
+        TriggerEvent(WidgetEvent::TEXT_CHANGED);
+    } else if (keyCode == VK_LEFT && m_cursorColumn > 0) {
+        m_cursorColumn--;
+    } else if (keyCode == VK_RIGHT && m_cursorColumn < lineLength) {
+        m_cursorColumn++;
+    } else if (keyCode == VK_UP && m_cursorLine > 0) {
+        m_cursorLine--;
+    } else if (keyCode == VK_DOWN && m_cursorLine + 1 < GetLineCount()) {
+        m_cursorLine++;
+    } else if (keyCode == VK_HOME) {
+        m_cursorColumn = 0;
+    } else if (keyCode == VK_END) {
+        m_cursorColumn = lineLength;
+    } else {
+        return true;
+    }
+    
+    Invalidate();
     return true;
 }
 
 bool SyntaxHighlightTextEditor::HandleChar(wchar_t ch) {
-    if (!Widget::HandleChar(ch)) return false;
+    if (!m_visible || !m_enabled || !m_focused) return false;
+    
+    m_cursorLine = std::max(0, std::min(m_cursorLine, GetLineCount() - 1));
+    m_cursorColumn = std::max(0, std::min(m_cursorColumn, (int)m_buffer.GetLineLength(m_cursorLine)));
+    size_t offset = m_buffer.GetLineStart(m_cursorLine) + m_cursorColumn;
+    
+    if (ch == L'\r') {
+        // Split the line at the cursor
+        ReplaceText(offset, 0, L"\n");
+        m_cursorLine++;
+        m_cursorColumn = 0;
+    } else if ((ch >= 32 && ch != 127) || ch == L'\t') {
+        ReplaceText(offset, 0, std::wstring(1, ch));
+        m_cursorColumn++;
+    } else {
+        return false;
+    }
     
-    // Insert character at cursor
+    TriggerEvent(WidgetEvent::TEXT_CHANGED);
+    Invalidate();
     return true;
 }
 
 // FileExplorer implementation
 FileExplorer::FileExplorer()
     : Widget()
+    , m_reloading(false)
+    , m_watchChanges(false)
     , m_selectedIndex(-1)
     , m_scrollOffset(0)
 {
@@ -1203,20 +1907,43 @@ FileExplorer::FileExplorer()
 }
 
 FileExplorer::~FileExplorer() {
+    if (m_request) {
+        m_request->Cancel();
+    }
 }
 
 void FileExplorer::SetCurrentPath(const std::wstring& path) {
     m_currentPath = path;
     LoadDirectory();
+    
+    if (m_watchChanges) {
+        m_watcher.Start(m_currentPath, false, EXPLORER_WATCH_FILTER);
+    }
+}
+
+void FileExplorer::SetWatchChanges(bool watch) {
+    m_watchChanges = watch;
+    if (watch && !m_currentPath.empty()) {
+        m_watcher.Start(m_currentPath, false, EXPLORER_WATCH_FILTER);
+        ScheduleUpdate();
+    } else {
+        m_watcher.Stop();
+    }
 }
 
 void FileExplorer::SetSelectedFile(const std::wstring& filename) {
     for (size_t i = 0; i < m_items.size(); i++) {
         if (m_items[i].name == filename) {
             m_selectedIndex = (int)i;
-            break;
+            m_pendingSelection.clear();
+            return;
         }
     }
+    
+    // Select it when it arrives
+    if (m_request && !m_reloading) {
+        m_pendingSelection = filename;
+    }
 }
 
 std::wstring FileExplorer::GetSelectedFile() const {
@@ -1227,34 +1954,108 @@ std::wstring FileExplorer::GetSelectedFile() const {
 }
 
 void FileExplorer::LoadDirectory() {
+    // Results for the previous path are no longer wanted
+    if (m_request) {
+        m_request->Cancel();
+    }
+    
     m_items.clear();
+    m_reloadItems.clear();
+    m_pendingSelection.clear();
     m_selectedIndex = -1;
+    m_scrollOffset = 0;
+    m_reloading = false;
+    m_request = DirectoryLoader::Load(m_currentPath);
+    ScheduleUpdate();
+}
+
+void FileExplorer::ReloadDirectory() {
+    // A fresh listing is already on its way
+    if (m_request && !m_reloading) return;
     
-    WIN32_FIND_DATAW findData;
-    std::wstring searchPath = m_currentPath + L"\\*";
-    HANDLE hFind = FindFirstFileW(searchPath.c_str(), &findData);
-    
-    if (hFind != INVALID_HANDLE_VALUE) {
-        do {
-            if (wcscmp(findData.cFileName, L".") != 0 && wcscmp(findData.cFileName, L"..") != 0) {
-                FileItem item;
-                item.name = findData.cFileName;
-                item.fullPath = m_currentPath + L"\\" + findData.cFileName;
-                item.isDirectory = (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
-                item.size = ((ULONGLONG)findData.nFileSizeHigh << 32) | findData.nFileSizeLow;
-                item.modifiedTime = findData.ftLastWriteTime;
-                
-                m_items.push_back(item);
-            }
-        } while (FindNextFileW(hFind, &findData));
+    if (m_request) {
+        m_request->Cancel();
+    }
+    m_reloadItems.clear();
+    m_reloading = true;
+    m_request = DirectoryLoader::Load(m_currentPath);
+    ScheduleUpdate();
+}
+
+bool FileExplorer::ProcessLoad() {
+    if (!m_request) return false;
+    
+    auto entries = m_request->TakeEntries(MAX_EXPLORER_ENTRIES_PER_UPDATE);
+    bool changed = !entries.empty() && !m_reloading;
+    
+    for (auto& entry : entries) {
+        if (m_reloading) {
+            m_reloadItems.push_back(std::move(entry));
+            continue;
+        }
+        if (!m_pendingSelection.empty() && entry.name == m_pendingSelection) {
+            m_selectedIndex = (int)m_items.size();
+            m_pendingSelection.clear();
+        }
+        m_items.push_back(std::move(entry));
+    }
+    
+    if (!m_request->IsComplete()) {
+        return changed;
+    }
+    
+    if (m_reloading) {
+        // Swap in the new listing at once, keeping the selection by name
+        std::wstring selectedName;
+        if (m_selectedIndex >= 0 && m_selectedIndex < (int)m_items.size()) {
+            selectedName = m_items[m_selectedIndex].name;
+        }
         
-        FindClose(hFind);
+        m_items.swap(m_reloadItems);
+        m_reloadItems.clear();
+        m_selectedIndex = -1;
+        for (size_t i = 0; i < m_items.size() && !selectedName.empty(); i++) {
+            if (m_items[i].name == selectedName) {
+                m_selectedIndex = (int)i;
+                break;
+            }
+        }
+        m_scrollOffset = std::min(m_scrollOffset, std::max((int)m_items.size() - 1, 0));
+        m_reloading = false;
+    }
+    
+    m_request.reset();
+    m_pendingSelection.clear();
+    return true;
+}
+
+void FileExplorer::Update(float deltaTime) {
+    Widget::Update(deltaTime);
+    
+    if (m_watcher.IsWatching()) {
+        bool overflowed = false;
+        auto changedDirectories = m_watcher.Poll(overflowed);
+        if (overflowed || !changedDirectories.empty()) {
+            ReloadDirectory();
+        }
+    }
+    
+    if (ProcessLoad()) {
+        Invalidate();
+    }
+    
+    if (IsLoading()) {
+        ScheduleUpdate();
+    } else if (m_watcher.IsWatching()) {
+        ScheduleUpdate(WATCH_POLL_INTERVAL);
     }
 }
 
 void FileExplorer::Render(HDC hdc) {
     if (!m_visible) return;
     
+    ScopedFont font(hdc, GetFont());
+    
     RECT bounds; GetBounds(bounds);
     Renderer::DrawRoundedRect(hdc, bounds, 4, Color(255, 255, 255, 255), Color(128, 128, 128, 255), 1);
     
@@ -1292,9 +2093,8 @@ void FileExplorer::RenderFileList(HDC hdc, RECT& rect) {
         };
         
         if (i == m_selectedIndex) {
-            HBRUSH brush = CreateSolidBrush(RGB(200, 220, 255));
+            HBRUSH brush = GdiObjectCache::GetBrush(RGB(200, 220, 255));
             FillRect(hdc, &itemRect, brush);
-            DeleteObject(brush);
         }
         
         std::wstring displayText = m_items[i].isDirectory ? L"📁 " : L"📄 ";
@@ -1303,6 +2103,19 @@ void FileExplorer::RenderFileList(HDC hdc, RECT& rect) {
         SetTextColor(hdc, RGB(0, 0, 0));
         DrawTextW(hdc, displayText.c_str(), -1, &itemRect, DT_LEFT | DT_VCENTER | DT_SINGLELINE);
     }
+    
+    // Placeholder row after what has arrived so far
+    int loadingRow = (int)m_items.size();
+    if (m_request && !m_reloading && loadingRow >= m_scrollOffset && loadingRow < m_scrollOffset + visibleItems) {
+        RECT itemRect = {
+            rect.left + 5,
+            rect.top + (loadingRow - m_scrollOffset) * itemHeight,
+            rect.right - 5,
+            rect.top + (loadingRow - m_scrollOffset + 1) * itemHeight
+        };
+        SetTextColor(hdc, RGB(128, 128, 128));
+        DrawTextW(hdc, L"Loading...", -1, &itemRect, DT_LEFT | DT_VCENTER | DT_SINGLELINE);
+    }
 }
 
 bool FileExplorer::HandleMouseDown(int x, int y, int button) {
@@ -0,0 +1,268 @@
+#include "../../include/SDK/AnimationTimeline.h"
+#include "../../include/SDK/Easing.h"
+#include <algorithm>
+#include <cmath>
+
+namespace SDK {
+
+AnimationTimeline::AnimationTimeline()
+    : m_playingCount(0)
+    , m_deadKeys(0)
+{
+}
+
+AnimationTimeline::TrackId AnimationTimeline::CreateTrack(const Renderer::Keyframe* keyframes, size_t count,
+                                                          float duration, bool looping) {
+    TrackId track;
+    if (!m_freeTracks.empty()) {
+        track = m_freeTracks.back();
+        m_freeTracks.pop_back();
+    } else {
+        track = (TrackId)m_duration.size();
+        m_time.push_back(0.0f);
+        m_duration.push_back(0.0f);
+        m_value.push_back(0.0f);
+        m_firstKey.push_back(0);
+        m_keyCount.push_back(0);
+        m_flags.push_back(0);
+        m_target.push_back(nullptr);
+    }
+
+    // The track's run goes at the end of the pool, sorted by time
+    std::vector<size_t> order(count);
+    for (size_t i = 0; i < count; i++) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [keyframes](size_t a, size_t b) {
+        return keyframes[a].time < keyframes[b].time;
+    });
+    size_t first = m_keyTime.size();
+    for (size_t i : order) {
+        m_keyTime.push_back(keyframes[i].time);
+        m_keyValue.push_back(keyframes[i].value);
+        m_keyEasing.push_back(keyframes[i].easing);
+    }
+
+    m_time[track] = 0.0f;
+    m_duration[track] = duration;
+    m_firstKey[track] = (uint32_t)first;
+    m_keyCount[track] = (uint32_t)count;
+    m_flags[track] = TRACK_ALIVE | (looping ? TRACK_LOOPING : 0);
+    m_target[track] = nullptr;
+    m_value[track] = Evaluate(track, 0.0f);
+    return track;
+}
+
+void AnimationTimeline::DestroyTrack(TrackId track) {
+    if (!IsValid(track)) return;
+
+    SetPlaying(track, false);
+    m_flags[track] = 0;
+    m_target[track] = nullptr;
+    m_deadKeys += m_keyCount[track];
+    m_keyCount[track] = 0;
+    m_freeTracks.push_back(track);
+
+    // Reclaim the pool once most of it belongs to destroyed tracks
+    if (m_deadKeys > 64 && m_deadKeys * 2 > m_keyTime.size()) {
+        CompactKeyframes();
+    }
+}
+
+void AnimationTimeline::CompactKeyframes() {
+    // Runs slide toward the front in pool order, so none is overwritten
+    // before it has moved
+    std::vector<TrackId> order;
+    for (TrackId track = 0; track < (TrackId)m_flags.size(); track++) {
+        if (m_flags[track] & TRACK_ALIVE) order.push_back(track);
+    }
+    std::sort(order.begin(), order.end(), [this](TrackId a, TrackId b) {
+        return m_firstKey[a] < m_firstKey[b];
+    });
+
+    size_t next = 0;
+    for (TrackId track : order) {
+        uint32_t first = m_firstKey[track];
+        uint32_t count = m_keyCount[track];
+        if (first != next) {
+            std::move(m_keyTime.begin() + first, m_keyTime.begin() + first + count, m_keyTime.begin() + next);
+            std::move(m_keyValue.begin() + first, m_keyValue.begin() + first + count, m_keyValue.begin() + next);
+            std::move(m_keyEasing.begin() + first, m_keyEasing.begin() + first + count, m_keyEasing.begin() + next);
+        }
+        m_firstKey[track] = (uint32_t)next;
+        next += count;
+    }
+    m_keyTime.resize(next);
+    m_keyValue.resize(next);
+    m_keyEasing.resize(next);
+    m_deadKeys = 0;
+}
+
+void AnimationTimeline::Clear() {
+    m_time.clear();
+    m_duration.clear();
+    m_value.clear();
+    m_firstKey.clear();
+    m_keyCount.clear();
+    m_flags.clear();
+    m_target.clear();
+    m_freeTracks.clear();
+    m_playingCount = 0;
+    m_keyTime.clear();
+    m_keyValue.clear();
+    m_keyEasing.clear();
+    m_deadKeys = 0;
+}
+
+void AnimationTimeline::Bind(TrackId track, float* target) {
+    if (!IsValid(track)) return;
+    m_target[track] = target;
+}
+
+void AnimationTimeline::SetPlaying(TrackId track, bool playing) {
+    bool wasPlaying = (m_flags[track] & TRACK_PLAYING) != 0;
+    if (playing == wasPlaying) return;
+
+    if (playing) {
+        m_flags[track] |= TRACK_PLAYING;
+        m_playingCount++;
+    } else {
+        m_flags[track] &= ~TRACK_PLAYING;
+        m_playingCount--;
+    }
+}
+
+void AnimationTimeline::Play(TrackId track) {
+    if (!IsValid(track)) return;
+    m_time[track] = 0.0f;
+    SetPlaying(track, true);
+}
+
+void AnimationTimeline::Stop(TrackId track) {
+    if (!IsValid(track)) return;
+    m_time[track] = 0.0f;
+    SetPlaying(track, false);
+}
+
+void AnimationTimeline::Pause(TrackId track) {
+    if (!IsValid(track)) return;
+    SetPlaying(track, false);
+}
+
+void AnimationTimeline::Resume(TrackId track) {
+    if (!IsValid(track)) return;
+    SetPlaying(track, true);
+}
+
+void AnimationTimeline::SetLooping(TrackId track, bool looping) {
+    if (!IsValid(track)) return;
+    if (looping) {
+        m_flags[track] |= TRACK_LOOPING;
+    } else {
+        m_flags[track] &= ~TRACK_LOOPING;
+    }
+}
+
+bool AnimationTimeline::IsPlaying(TrackId track) const {
+    return IsValid(track) && (m_flags[track] & TRACK_PLAYING);
+}
+
+bool AnimationTimeline::IsFinished(TrackId track) const {
+    return IsValid(track) && !(m_flags[track] & TRACK_LOOPING) && m_time[track] >= m_duration[track];
+}
+
+float AnimationTimeline::GetTime(TrackId track) const {
+    return IsValid(track) ? m_time[track] : 0.0f;
+}
+
+float AnimationTimeline::GetValue(TrackId track) const {
+    return IsValid(track) ? m_value[track] : 0.0f;
+}
+
+bool AnimationTimeline::FindSegment(TrackId track, float time, uint32_t& key, float& t, float& value) const {
+    uint32_t count = m_keyCount[track];
+    if (count == 0) {
+        value = 0.0f;
+        return false;
+    }
+
+    const float* times = m_keyTime.data() + m_firstKey[track];
+    const float* values = m_keyValue.data() + m_firstKey[track];
+    if (count == 1 || time <= times[0]) {
+        value = values[0];
+        return false;
+    }
+    if (time >= times[count - 1]) {
+        value = values[count - 1];
+        return false;
+    }
+
+    // First keyframe after time; the segment starts one before it
+    uint32_t next = (uint32_t)(std::upper_bound(times, times + count, time) - times);
+    uint32_t prev = next - 1;
+    float span = times[next] - times[prev];
+    t = span > 0.0f ? (time - times[prev]) / span : 1.0f;
+    key = m_firstKey[track] + prev;
+    return true;
+}
+
+float AnimationTimeline::Evaluate(TrackId track, float time) const {
+    uint32_t key;
+    float t;
+    float value;
+    if (!FindSegment(track, time, key, t, value)) return value;
+    t = Easing::Evaluate(m_keyEasing[key], t);
+    return m_keyValue[key] + (m_keyValue[key + 1] - m_keyValue[key]) * t;
+}
+
+void AnimationTimeline::Advance(float deltaTime) {
+    if (m_playingCount == 0) return;
+
+    // Find every playing track's segment first...
+    m_evaluated.clear();
+    m_easeTracks.clear();
+    m_easeKeys.clear();
+    m_easeProgress.clear();
+    m_easeTypes.clear();
+    for (TrackId track = 0; track < (TrackId)m_flags.size(); track++) {
+        uint8_t flags = m_flags[track];
+        if (!(flags & TRACK_PLAYING)) continue;
+
+        float time = m_time[track] + deltaTime;
+        float duration = m_duration[track];
+        if (time >= duration) {
+            if ((flags & TRACK_LOOPING) && duration > 0.0f) {
+                time = std::fmod(time, duration);
+            } else {
+                time = duration;
+                SetPlaying(track, false);
+            }
+        }
+        m_time[track] = time;
+        uint32_t key;
+        float t;
+        if (FindSegment(track, time, key, t, m_value[track])) {
+            m_easeTracks.push_back(track);
+            m_easeKeys.push_back(key);
+            m_easeProgress.push_back(t);
+            m_easeTypes.push_back(m_keyEasing[key]);
+        }
+        if (m_target[track]) m_evaluated.push_back(track);
+    }
+
+    // ...ease the segments in one batch...
+    Easing::EvaluateBatch(m_easeTypes.data(), m_easeProgress.data(), m_easeProgress.size());
+    for (size_t i = 0; i < m_easeTracks.size(); i++) {
+        uint32_t key = m_easeKeys[i];
+        m_value[m_easeTracks[i]] = m_keyValue[key] + (m_keyValue[key + 1] - m_keyValue[key]) * m_easeProgress[i];
+    }
+
+    // ...then write the bound properties together
+    for (TrackId track : m_evaluated) {
+        *m_target[track] = m_value[track];
+    }
+}
+
+float AnimationTimeline::Ease(float t, Renderer::EasingType type) {
+    return Easing::Evaluate(type, t);
+}
+
+} // namespace SDK
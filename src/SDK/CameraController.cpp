@@ -107,10 +107,12 @@ void CameraController::GetRotation(float& pitch, float& yaw, float& roll) const
 
 void CameraController::SetDistance(float distance) {
     m_distance = std::max(MIN_DISTANCE, std::min(MAX_DISTANCE, distance));
+    UpdateMatrices();
 }
 
 void CameraController::SetFieldOfView(float fov) {
     m_fov = fov;
+    UpdateMatrices();
 }
 
 void CameraController::SetNearPlane(float near) {
@@ -266,6 +268,33 @@ void CameraController::UpdateCameraVectors() {
     }
     
     m_up = m_upVector;
+    UpdateMatrices();
+}
+
+void CameraController::UpdateMatrices() {
+    // Rows are the camera axes, with the position folded into the last column
+    const Renderer::Vector3D* axes[3] = { &m_right, &m_upVector, &m_forward };
+    for (int row = 0; row < 3; row++) {
+        const Renderer::Vector3D& axis = *axes[row];
+        float* r = m_viewMatrix + row * 4;
+        r[0] = axis.x;
+        r[1] = axis.y;
+        r[2] = axis.z;
+        r[3] = -(axis.x * m_position.x + axis.y * m_position.y + axis.z * m_position.z);
+    }
+    m_viewMatrix[12] = 0.0f;
+    m_viewMatrix[13] = 0.0f;
+    m_viewMatrix[14] = 0.0f;
+    m_viewMatrix[15] = 1.0f;
+    
+    // x and y carry the field of view; w is the view depth plus the distance
+    for (int i = 0; i < 4; i++) {
+        m_viewProjection[i] = m_viewMatrix[i] * m_fov;
+        m_viewProjection[4 + i] = m_viewMatrix[4 + i] * m_fov;
+        m_viewProjection[8 + i] = m_viewMatrix[8 + i];
+        m_viewProjection[12 + i] = m_viewMatrix[8 + i];
+    }
+    m_viewProjection[15] += m_distance;
 }
 
 void CameraController::ProcessOrbitInput(int deltaX, int deltaY) {
@@ -282,6 +311,7 @@ void CameraController::ProcessOrbitInput(int deltaX, int deltaY) {
     m_position.x = m_target.x - m_distance * std::cos(pitchRad) * std::sin(yawRad);
     m_position.y = m_target.y - m_distance * std::sin(pitchRad);
     m_position.z = m_target.z - m_distance * std::cos(pitchRad) * std::cos(yawRad);
+    UpdateMatrices();
 }
 
 void CameraController::ProcessPanInput(int deltaX, int deltaY) {
@@ -295,6 +325,7 @@ void CameraController::ProcessPanInput(int deltaX, int deltaY) {
     m_target.x -= m_right.x * deltaX * panSpeed + m_upVector.x * deltaY * panSpeed;
     m_target.y -= m_right.y * deltaX * panSpeed + m_upVector.y * deltaY * panSpeed;
     m_target.z -= m_right.z * deltaX * panSpeed + m_upVector.z * deltaY * panSpeed;
+    UpdateMatrices();
 }
 
 void CameraController::ProcessZoomInput(int delta) {
@@ -341,6 +372,7 @@ void CameraController::MoveForward(float amount) {
     m_target.x += m_forward.x * amount;
     m_target.y += m_forward.y * amount;
     m_target.z += m_forward.z * amount;
+    UpdateMatrices();
 }
 
 void CameraController::MoveRight(float amount) {
@@ -351,6 +383,7 @@ void CameraController::MoveRight(float amount) {
     m_target.x += m_right.x * amount;
     m_target.y += m_right.y * amount;
     m_target.z += m_right.z * amount;
+    UpdateMatrices();
 }
 
 void CameraController::MoveUp(float amount) {
@@ -361,6 +394,7 @@ void CameraController::MoveUp(float amount) {
     m_target.x += m_upVector.x * amount;
     m_target.y += m_upVector.y * amount;
     m_target.z += m_upVector.z * amount;
+    UpdateMatrices();
 }
 
 void CameraController::RotateYaw(float amount) {
@@ -382,6 +416,7 @@ void CameraController::Zoom(float amount) {
     m_position.x = m_target.x - m_distance * m_forward.x;
     m_position.y = m_target.y - m_distance * m_forward.y;
     m_position.z = m_target.z - m_distance * m_forward.z;
+    UpdateMatrices();
 }
 
 void CameraController::Reset() {
@@ -407,15 +442,7 @@ Renderer::Vector3D CameraController::GetUpVector() const {
 
 void CameraController::TransformPoint3D(const Renderer::Vector3D& worldPoint, Renderer::Vector3D& viewPoint) const {
     // Transform from world space to camera view space
-    Renderer::Vector3D relative;
-    relative.x = worldPoint.x - m_position.x;
-    relative.y = worldPoint.y - m_position.y;
-    relative.z = worldPoint.z - m_position.z;
-    
-    // Apply camera rotation
-    viewPoint.x = relative.x * m_right.x + relative.y * m_right.y + relative.z * m_right.z;
-    viewPoint.y = relative.x * m_upVector.x + relative.y * m_upVector.y + relative.z * m_upVector.z;
-    viewPoint.z = relative.x * m_forward.x + relative.y * m_forward.y + relative.z * m_forward.z;
+    Renderer::TransformPoints(m_viewMatrix, &worldPoint, &viewPoint, 1);
 }
 
 void CameraController::TransformPoint4D(const Renderer::Vector4D& worldPoint, Renderer::Vector4D& viewPoint) const {
@@ -442,18 +469,20 @@ void CameraController::TransformPoint5D(const Renderer::Vector5D& worldPoint, Re
 }
 
 void CameraController::ApplyToProjection(const Renderer::Vector3D& point3D, int& x2D, int& y2D, int originX, int originY, float scale) const {
-    // Transform point to view space
-    Renderer::Vector3D viewPoint;
-    TransformPoint3D(point3D, viewPoint);
-    
-    // Apply perspective projection
-    float distance = viewPoint.z + m_distance;
-    distance = std::max(distance, m_nearPlane); // Clamp to near plane
-    
-    float perspectiveScale = m_fov / distance;
-    
-    x2D = originX + (int)(viewPoint.x * perspectiveScale * scale);
-    y2D = originY + (int)(viewPoint.y * perspectiveScale * scale);
+    POINT screenPoint;
+    ProjectPoints(&point3D, &screenPoint, 1, originX, originY, scale);
+    x2D = screenPoint.x;
+    y2D = screenPoint.y;
+}
+
+void CameraController::TransformPoints(const Renderer::Vector3D* worldPoints, Renderer::Vector3D* viewPoints, size_t count) const {
+    Renderer::TransformPoints(m_viewMatrix, worldPoints, viewPoints, count);
+}
+
+void CameraController::ProjectPoints(const Renderer::Vector3D* worldPoints, POINT* screenPoints, size_t count,
+                                     int originX, int originY, float scale) const {
+    // Perspective divide by the depth, clamped to the near plane
+    Renderer::ProjectPoints(m_viewProjection, m_nearPlane, worldPoints, screenPoints, count, originX, originY, scale);
 }
 
 } // namespace SDK
@@ -1,8 +1,14 @@
 #include "../../include/SDK/D2DRenderBackend.h"
 #include "../../include/SDK/Renderer.h"
+#include "../../include/SDK/PixelKernels.h"
+#include "../../include/SDK/TextureAtlas.h"
+#include "../../include/SDK/EffectGraph.h"
+#include "../../include/SDK/StringUtils.h"
 #include <d2d1_1.h>
 #include <d2d1effects.h>
 #include <dxgiformat.h>
+#include <algorithm>
+#include <cfloat>
 #include <cmath>
 
 namespace SDK {
@@ -11,17 +17,76 @@ namespace SDK {
 namespace {
     constexpr float BLOOM_BASE_BLUR = 3.0f;      // Base blur radius for bloom
     constexpr float BLOOM_INTENSITY_SCALE = 2.0f; // Multiplier for intensity-based blur
+    
+    // Cache bounds; a full cache is flushed rather than tracked per entry,
+    // which only happens when colors or fonts are generated per frame
+    constexpr size_t MAX_CACHED_BRUSHES = 256;
+    constexpr size_t MAX_CACHED_GRADIENTS = 64;
+    constexpr size_t MAX_CACHED_TEXT_FORMATS = 64;
+    constexpr size_t MAX_CACHED_TEXT_LAYOUTS = 512;
+    constexpr size_t MAX_SCRATCH_BITMAPS = 8;    // Least recently used is replaced
+    
+    // Tap blur fallback: draws per axis, and samples along a motion blur
+    constexpr int MAX_BLUR_TAPS = 9;
+    constexpr int MOTION_BLUR_TAPS = 5;
+    
+    // Sizes are keyed to a thousandth of a DIP
+    void AppendFormatKey(std::wstring& key, const std::wstring& fontFamily, float fontSize, int fontWeight) {
+        key.assign(fontFamily).push_back(L'|');
+        AppendDecimal(key, (int64_t)std::lround(fontSize * 1000.0f));
+        key.push_back(L'|');
+        AppendDecimal(key, fontWeight);
+    }
+    
+    uint32_t PackColor(Color color) {
+        return ((uint32_t)color.r << 24) | ((uint32_t)color.g << 16) | ((uint32_t)color.b << 8) | color.a;
+    }
+    
+    // Bright-pass color matrix: output = max(0, input * intensity - threshold * 255)
+    D2D1_MATRIX_5X4_F BloomThresholdMatrix(float threshold, float intensity) {
+        float offset = -threshold * 255.0f;
+        return D2D1::Matrix5x4F(
+            intensity, 0, 0, 0,
+            0, intensity, 0, 0,
+            0, 0, intensity, 0,
+            0, 0, 0, 1,
+            offset, offset, offset, 0
+        );
+    }
+    
+    template <typename T>
+    void SafeRelease(T*& resource) {
+        if (resource) {
+            resource->Release();
+            resource = nullptr;
+        }
+    }
+    
+    // Device copy of a TextureAtlas, kept in the atlas's DIRECT2D surface slot.
+    // It belongs to one backend and device; a different one replaces it.
+    struct D2DAtlasSurface {
+        ID2D1Bitmap* bitmap;
+        const void* owner;
+        uint64_t deviceResets;
+        uint64_t version;
+        
+        D2DAtlasSurface() : bitmap(nullptr), owner(nullptr), deviceResets(0), version(0) {}
+        ~D2DAtlasSurface() { SafeRelease(bitmap); }
+    };
 }
 
 D2DRenderBackend::D2DRenderBackend()
     : m_hwnd(nullptr)
     , m_pD2DFactory(nullptr)
     , m_pRenderTarget(nullptr)
+    , m_pDeviceContext(nullptr)
     , m_pDWriteFactory(nullptr)
-    , m_pCachedBrush(nullptr)
-    , m_cachedBrushColor{0, 0, 0, 255}
-    , m_pBlurEffect(nullptr)
-    , m_pBloomEffect(nullptr)
+    , m_particleBitmap(nullptr)
+    , m_effects{}
+    , m_roundStroke(nullptr)
+    , m_captureClock(0)
+    , m_deviceResets(0)
+    , m_fallbackReadbacks(0)
 {
 }
 
@@ -42,25 +107,66 @@ bool D2DRenderBackend::Initialize(HWND hwnd) {
         return false;
     }
     
+    // Create DWrite factory for text rendering
+    hr = DWriteCreateFactory(
+        DWRITE_FACTORY_TYPE_SHARED,
+        __uuidof(IDWriteFactory),
+        reinterpret_cast<IUnknown**>(&m_pDWriteFactory)
+    );
+    
+    if (FAILED(hr) || !CreateDeviceResources()) {
+        Shutdown();
+        return false;
+    }
+    
+    return true;
+}
+
+void D2DRenderBackend::Shutdown() {
+    ReleaseDeviceResources();
+    
+    for (auto& entry : m_textFormats) {
+        entry.second->Release();
+    }
+    m_textFormats.clear();
+    for (auto& entry : m_textLayouts) {
+        entry.second->Release();
+    }
+    m_textLayouts.clear();
+    SafeRelease(m_roundStroke);
+    
+    SafeRelease(m_pDWriteFactory);
+    SafeRelease(m_pD2DFactory);
+    
+    m_hwnd = nullptr;
+}
+
+bool D2DRenderBackend::CreateDeviceResources() {
+    if (!m_pD2DFactory) return false;
+    
     // Get window size
     RECT rc;
-    GetClientRect(hwnd, &rc);
+    GetClientRect(m_hwnd, &rc);
     
     D2D1_SIZE_U size = D2D1::SizeU(
         rc.right - rc.left,
         rc.bottom - rc.top
     );
     
-    // Create render target
-    hr = m_pD2DFactory->CreateHwndRenderTarget(
-        D2D1::RenderTargetProperties(),
-        D2D1::HwndRenderTargetProperties(hwnd, size),
+    // Create render target; GDI compatible so HDC-only drawing can interop
+    HRESULT hr = m_pD2DFactory->CreateHwndRenderTarget(
+        D2D1::RenderTargetProperties(
+            D2D1_RENDER_TARGET_TYPE_DEFAULT,
+            D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED),
+            0.0f, 0.0f,
+            D2D1_RENDER_TARGET_USAGE_GDI_COMPATIBLE
+        ),
+        D2D1::HwndRenderTargetProperties(m_hwnd, size),
         &m_pRenderTarget
     );
     
     if (FAILED(hr)) {
-        m_pD2DFactory->Release();
-        m_pD2DFactory = nullptr;
+        m_pRenderTarget = nullptr;
         return false;
     }
     
@@ -68,73 +174,45 @@ bool D2DRenderBackend::Initialize(HWND hwnd) {
     m_pRenderTarget->SetAntialiasMode(D2D1_ANTIALIAS_MODE_PER_PRIMITIVE);
     m_pRenderTarget->SetTextAntialiasMode(D2D1_TEXT_ANTIALIAS_MODE_CLEARTYPE);
     
-    // Create DWrite factory for text rendering
-    hr = DWriteCreateFactory(
-        DWRITE_FACTORY_TYPE_SHARED,
-        __uuidof(IDWriteFactory),
-        reinterpret_cast<IUnknown**>(&m_pDWriteFactory)
-    );
-    
-    if (FAILED(hr)) {
-        m_pRenderTarget->Release();
-        m_pD2DFactory->Release();
-        m_pRenderTarget = nullptr;
-        m_pD2DFactory = nullptr;
-        return false;
-    }
-    
-    // Try to create effects (requires D2D1.1+, may fail on Windows 7)
-    ID2D1DeviceContext* pDeviceContext = nullptr;
-    hr = m_pRenderTarget->QueryInterface(&pDeviceContext);
-    if (SUCCEEDED(hr) && pDeviceContext) {
-        // Create blur effect
-        pDeviceContext->CreateEffect(CLSID_D2D1GaussianBlur, &m_pBlurEffect);
-        
-        // Note: Bloom is not a built-in effect, would need custom implementation
-        // For now, we'll implement it in software when needed
-        
-        pDeviceContext->Release();
+    // Effects need D2D1.1 (Windows 8, or 7 with the Platform Update)
+    if (FAILED(m_pRenderTarget->QueryInterface(&m_pDeviceContext))) {
+        m_pDeviceContext = nullptr;
     }
     
     return true;
 }
 
-void D2DRenderBackend::Shutdown() {
-    if (m_pBloomEffect) {
-        m_pBloomEffect->Release();
-        m_pBloomEffect = nullptr;
+void D2DRenderBackend::ReleaseDeviceResources() {
+    // Effects hold references to their input bitmaps, so they go first
+    for (auto& effect : m_effects) {
+        SafeRelease(effect);
     }
     
-    if (m_pBlurEffect) {
-        m_pBlurEffect->Release();
-        m_pBlurEffect = nullptr;
+    for (auto& scratch : m_scratchBitmaps) {
+        scratch.bitmap->Release();
     }
+    m_scratchBitmaps.clear();
+    SafeRelease(m_particleBitmap);
     
-    if (m_pCachedBrush) {
-        m_pCachedBrush->Release();
-        m_pCachedBrush = nullptr;
+    for (auto& entry : m_gradients) {
+        SafeRelease(entry.second.linear);
+        SafeRelease(entry.second.radial);
+        SafeRelease(entry.second.stops);
     }
+    m_gradients.clear();
     
-    if (m_pDWriteFactory) {
-        m_pDWriteFactory->Release();
-        m_pDWriteFactory = nullptr;
+    for (auto& entry : m_brushes) {
+        entry.second->Release();
     }
+    m_brushes.clear();
     
-    if (m_pRenderTarget) {
-        m_pRenderTarget->Release();
-        m_pRenderTarget = nullptr;
-    }
-    
-    if (m_pD2DFactory) {
-        m_pD2DFactory->Release();
-        m_pD2DFactory = nullptr;
-    }
-    
-    m_hwnd = nullptr;
+    SafeRelease(m_pDeviceContext);
+    SafeRelease(m_pRenderTarget);
 }
 
 bool D2DRenderBackend::BeginDraw() {
-    if (!m_pRenderTarget) {
+    // Recreate the target dropped after a device loss
+    if (!m_pRenderTarget && !CreateDeviceResources()) {
         return false;
     }
     
@@ -146,19 +224,12 @@ void D2DRenderBackend::EndDraw() {
     if (m_pRenderTarget) {
         HRESULT hr = m_pRenderTarget->EndDraw();
         
-        // Handle device loss
+        // Handle device loss; the factories and text formats are
+        // device-independent and survive, everything else is rebuilt on demand
         if (hr == D2DERR_RECREATE_TARGET) {
-            // Re-create the render target
-            if (m_pCachedBrush) {
-                m_pCachedBrush->Release();
-                m_pCachedBrush = nullptr;
-            }
-            
-            m_pRenderTarget->Release();
-            m_pRenderTarget = nullptr;
-            
-            // Re-initialize
-            Initialize(m_hwnd);
+            ReleaseDeviceResources();
+            m_deviceResets++;
+            CreateDeviceResources();
         }
     }
 }
@@ -198,33 +269,234 @@ D2D1_RECT_F D2DRenderBackend::ToD2DRect(const RECT& rect) const {
 }
 
 ID2D1SolidColorBrush* D2DRenderBackend::GetBrush(Color color) {
-    // Reuse cached brush if color matches
-    if (m_pCachedBrush && 
-        m_cachedBrushColor.r == color.r &&
-        m_cachedBrushColor.g == color.g &&
-        m_cachedBrushColor.b == color.b &&
-        m_cachedBrushColor.a == color.a) {
-        return m_pCachedBrush;
+    if (!m_pRenderTarget) return nullptr;
+    
+    uint32_t key = PackColor(color);
+    auto it = m_brushes.find(key);
+    if (it != m_brushes.end()) {
+        return it->second;
     }
     
-    // Release old brush
-    if (m_pCachedBrush) {
-        m_pCachedBrush->Release();
-        m_pCachedBrush = nullptr;
+    if (m_brushes.size() >= MAX_CACHED_BRUSHES) {
+        for (auto& entry : m_brushes) {
+            entry.second->Release();
+        }
+        m_brushes.clear();
     }
     
-    // Create new brush
-    if (m_pRenderTarget) {
-        m_pRenderTarget->CreateSolidColorBrush(ToD2DColor(color), &m_pCachedBrush);
-        m_cachedBrushColor = color;
+    ID2D1SolidColorBrush* brush = nullptr;
+    if (FAILED(m_pRenderTarget->CreateSolidColorBrush(ToD2DColor(color), &brush)) || !brush) {
+        return nullptr;
+    }
+    m_brushes[key] = brush;
+    return brush;
+}
+
+D2DRenderBackend::GradientResources* D2DRenderBackend::GetGradient(Color startColor, Color endColor) {
+    if (!m_pRenderTarget) return nullptr;
+    
+    uint64_t key = ((uint64_t)PackColor(startColor) << 32) | PackColor(endColor);
+    auto it = m_gradients.find(key);
+    if (it != m_gradients.end()) {
+        return &it->second;
+    }
+    
+    if (m_gradients.size() >= MAX_CACHED_GRADIENTS) {
+        for (auto& entry : m_gradients) {
+            SafeRelease(entry.second.linear);
+            SafeRelease(entry.second.radial);
+            SafeRelease(entry.second.stops);
+        }
+        m_gradients.clear();
     }
     
-    return m_pCachedBrush;
+    D2D1_GRADIENT_STOP gradientStops[2];
+    gradientStops[0].color = ToD2DColor(startColor);
+    gradientStops[0].position = 0.0f;
+    gradientStops[1].color = ToD2DColor(endColor);
+    gradientStops[1].position = 1.0f;
+    
+    ID2D1GradientStopCollection* pGradientStops = nullptr;
+    HRESULT hr = m_pRenderTarget->CreateGradientStopCollection(
+        gradientStops,
+        2,
+        D2D1_GAMMA_2_2,
+        D2D1_EXTEND_MODE_CLAMP,
+        &pGradientStops
+    );
+    
+    if (FAILED(hr) || !pGradientStops) {
+        return nullptr;
+    }
+    
+    GradientResources& gradient = m_gradients[key];
+    gradient.stops = pGradientStops;
+    gradient.linear = nullptr;
+    gradient.radial = nullptr;
+    return &gradient;
 }
 
-HDC D2DRenderBackend::GetGDIFallbackDC() const {
+IDWriteTextFormat* D2DRenderBackend::GetTextFormat(const std::wstring& fontFamily, float fontSize, int fontWeight) {
+    if (!m_pDWriteFactory) return nullptr;
+    
+    std::wstring& key = m_textKey;
+    AppendFormatKey(key, fontFamily, fontSize, fontWeight);
+    auto it = m_textFormats.find(key);
+    if (it != m_textFormats.end()) {
+        return it->second;
+    }
+    
+    if (m_textFormats.size() >= MAX_CACHED_TEXT_FORMATS) {
+        for (auto& entry : m_textFormats) {
+            entry.second->Release();
+        }
+        m_textFormats.clear();
+    }
+    
+    IDWriteTextFormat* pTextFormat = nullptr;
+    HRESULT hr = m_pDWriteFactory->CreateTextFormat(
+        fontFamily.c_str(),
+        nullptr,
+        (DWRITE_FONT_WEIGHT)fontWeight,
+        DWRITE_FONT_STYLE_NORMAL,
+        DWRITE_FONT_STRETCH_NORMAL,
+        fontSize,
+        L"en-us",
+        &pTextFormat
+    );
+    
+    if (FAILED(hr) || !pTextFormat) {
+        return nullptr;
+    }
+    m_textFormats[key] = pTextFormat;
+    return pTextFormat;
+}
+
+IDWriteTextLayout* D2DRenderBackend::GetTextLayout(const std::wstring& text, const std::wstring& fontFamily, float fontSize, int fontWeight) {
+    IDWriteTextFormat* pTextFormat = GetTextFormat(fontFamily, fontSize, fontWeight);
+    if (!pTextFormat) return nullptr;
+    
+    std::wstring& key = m_textKey;
+    AppendFormatKey(key, fontFamily, fontSize, fontWeight);
+    key.push_back(L'|');
+    key.append(text);
+    auto it = m_textLayouts.find(key);
+    if (it != m_textLayouts.end()) {
+        return it->second;
+    }
+    
+    if (m_textLayouts.size() >= MAX_CACHED_TEXT_LAYOUTS) {
+        for (auto& entry : m_textLayouts) {
+            entry.second->Release();
+        }
+        m_textLayouts.clear();
+    }
+    
+    // Unbounded, so the line never wraps; the format is in its default layout here
+    IDWriteTextLayout* pLayout = nullptr;
+    HRESULT hr = m_pDWriteFactory->CreateTextLayout(
+        text.c_str(),
+        (UINT32)text.length(),
+        pTextFormat,
+        FLT_MAX,
+        FLT_MAX,
+        &pLayout
+    );
+    if (FAILED(hr) || !pLayout) {
+        return nullptr;
+    }
+    m_textLayouts[key] = pLayout;
+    return pLayout;
+}
+
+ID2D1Effect* D2DRenderBackend::GetEffect(EffectSlot slot, REFCLSID effectId) {
+    if (!m_pDeviceContext) return nullptr;
+    
+    if (!m_effects[slot] && FAILED(m_pDeviceContext->CreateEffect(effectId, &m_effects[slot]))) {
+        m_effects[slot] = nullptr;
+    }
+    return m_effects[slot];
+}
+
+ID2D1Bitmap* D2DRenderBackend::CaptureRegion(const D2D1_RECT_F& rect) {
     if (!m_pRenderTarget) return nullptr;
     
+    UINT32 width = (UINT32)(rect.right - rect.left);
+    UINT32 height = (UINT32)(rect.bottom - rect.top);
+    if (width == 0 || height == 0) return nullptr;
+    
+    // Effect inputs are drawn whole, so only an exact size can be reused
+    ScratchBitmap* scratch = nullptr;
+    for (auto& candidate : m_scratchBitmaps) {
+        if (candidate.width == width && candidate.height == height) {
+            scratch = &candidate;
+            break;
+        }
+    }
+    
+    if (!scratch) {
+        ID2D1Bitmap* pBitmap = nullptr;
+        D2D1_BITMAP_PROPERTIES bitmapProps = D2D1::BitmapProperties(
+            D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED)
+        );
+        
+        HRESULT hr = m_pRenderTarget->CreateBitmap(D2D1::SizeU(width, height), bitmapProps, &pBitmap);
+        if (FAILED(hr) || !pBitmap) {
+            return nullptr;
+        }
+        
+        if (m_scratchBitmaps.size() < MAX_SCRATCH_BITMAPS) {
+            m_scratchBitmaps.push_back(ScratchBitmap{});
+            scratch = &m_scratchBitmaps.back();
+        } else {
+            scratch = &*std::min_element(m_scratchBitmaps.begin(), m_scratchBitmaps.end(),
+                [](const ScratchBitmap& a, const ScratchBitmap& b) { return a.lastUse < b.lastUse; });
+            scratch->bitmap->Release();     // Effects still using it hold their own reference
+        }
+        scratch->bitmap = pBitmap;
+        scratch->width = width;
+        scratch->height = height;
+    }
+    scratch->lastUse = ++m_captureClock;
+    
+    // Copy the region to bitmap (called during render cycle between BeginDraw/EndDraw)
+    D2D1_POINT_2U destPoint = D2D1::Point2U(0, 0);
+    D2D1_RECT_U sourceRect = D2D1::RectU(
+        (UINT32)rect.left, (UINT32)rect.top,
+        (UINT32)rect.right, (UINT32)rect.bottom
+    );
+    
+    if (FAILED(scratch->bitmap->CopyFromRenderTarget(&destPoint, m_pRenderTarget, &sourceRect))) {
+        return nullptr;
+    }
+    return scratch->bitmap;
+}
+
+void D2DRenderBackend::DrawTapBlur(const D2D1_RECT_F& rect, float stepX, float stepY, int taps, bool symmetric) {
+    if (taps < 2) return;
+    
+    ID2D1Bitmap* pBitmap = CaptureRegion(rect);
+    if (!pBitmap) return;
+    
+    // The target already holds the unshifted tap; drawing the k-th extra tap
+    // at 1/(k+1) opacity keeps a running average of all taps so far
+    m_pRenderTarget->PushAxisAlignedClip(rect, D2D1_ANTIALIAS_MODE_ALIASED);
+    for (int k = 1; k < taps; k++) {
+        float distance = symmetric ? (float)((k + 1) / 2) * ((k % 2) ? 1.0f : -1.0f) : (float)k;
+        D2D1_RECT_F dest = D2D1::RectF(
+            rect.left + stepX * distance, rect.top + stepY * distance,
+            rect.right + stepX * distance, rect.bottom + stepY * distance
+        );
+        m_pRenderTarget->DrawBitmap(pBitmap, dest, 1.0f / (float)(k + 1));
+    }
+    m_pRenderTarget->PopAxisAlignedClip();
+}
+
+HDC D2DRenderBackend::GetGDIFallbackDC() {
+    if (!m_pRenderTarget) return nullptr;
+    
+    m_fallbackReadbacks++;
+    
     HDC hdc = nullptr;
     ID2D1GdiInteropRenderTarget* pGdiInterop = nullptr;
     HRESULT hr = m_pRenderTarget->QueryInterface(&pGdiInterop);
@@ -338,165 +610,145 @@ void D2DRenderBackend::DrawEllipse(int cx, int cy, int rx, int ry, Color fillCol
 }
 
 void D2DRenderBackend::DrawText(const std::wstring& text, const RECT& rect, Color color, const std::wstring& fontFamily, float fontSize, int fontWeight) {
-    if (!m_pRenderTarget || !m_pDWriteFactory) return;
-    
-    // Create text format
-    IDWriteTextFormat* pTextFormat = nullptr;
-    HRESULT hr = m_pDWriteFactory->CreateTextFormat(
-        fontFamily.c_str(),
-        nullptr,
-        (DWRITE_FONT_WEIGHT)fontWeight,
-        DWRITE_FONT_STYLE_NORMAL,
-        DWRITE_FONT_STRETCH_NORMAL,
-        fontSize,
-        L"en-us",
-        &pTextFormat
-    );
+    if (!m_pRenderTarget) return;
     
-    if (SUCCEEDED(hr) && pTextFormat) {
-        ID2D1SolidColorBrush* brush = GetBrush(color);
-        if (brush) {
-            m_pRenderTarget->DrawText(
-                text.c_str(),
-                (UINT32)text.length(),
-                pTextFormat,
-                ToD2DRect(rect),
-                brush
-            );
-        }
-        
-        pTextFormat->Release();
+    IDWriteTextFormat* pTextFormat = GetTextFormat(fontFamily, fontSize, fontWeight);
+    ID2D1SolidColorBrush* brush = GetBrush(color);
+    if (pTextFormat && brush) {
+        m_pRenderTarget->DrawText(
+            text.c_str(),
+            (UINT32)text.length(),
+            pTextFormat,
+            ToD2DRect(rect),
+            brush
+        );
     }
 }
 
-void D2DRenderBackend::DrawLinearGradient(const RECT& rect, Color startColor, Color endColor, bool horizontal) {
+void D2DRenderBackend::DrawTextLine(const std::wstring& text, const RECT& rect, Color color, const std::wstring& fontFamily, float fontSize, int fontWeight, TextAlign align) {
     if (!m_pRenderTarget) return;
     
-    D2D1_GRADIENT_STOP gradientStops[2];
-    gradientStops[0].color = ToD2DColor(startColor);
-    gradientStops[0].position = 0.0f;
-    gradientStops[1].color = ToD2DColor(endColor);
-    gradientStops[1].position = 1.0f;
+    // Shaped once and kept, so a label redrawn every frame skips DirectWrite layout
+    IDWriteTextLayout* pLayout = GetTextLayout(text, fontFamily, fontSize, fontWeight);
+    ID2D1SolidColorBrush* brush = GetBrush(color);
+    if (!pLayout || !brush) return;
     
-    ID2D1GradientStopCollection* pGradientStops = nullptr;
-    HRESULT hr = m_pRenderTarget->CreateGradientStopCollection(
-        gradientStops,
-        2,
-        D2D1_GAMMA_2_2,
-        D2D1_EXTEND_MODE_CLAMP,
-        &pGradientStops
-    );
+    DWRITE_TEXT_METRICS metrics = {};
+    pLayout->GetMetrics(&metrics);
     
-    if (SUCCEEDED(hr) && pGradientStops) {
-        ID2D1LinearGradientBrush* pBrush = nullptr;
-        
-        D2D1_POINT_2F start, end;
-        if (horizontal) {
-            start = D2D1::Point2F((float)rect.left, (float)rect.top);
-            end = D2D1::Point2F((float)rect.right, (float)rect.top);
-        } else {
-            start = D2D1::Point2F((float)rect.left, (float)rect.top);
-            end = D2D1::Point2F((float)rect.left, (float)rect.bottom);
-        }
-        
-        hr = m_pRenderTarget->CreateLinearGradientBrush(
+    float x = (float)rect.left;
+    if (align == TextAlign::CENTER) {
+        x += (rect.right - rect.left - metrics.widthIncludingTrailingWhitespace) / 2;
+    } else if (align == TextAlign::RIGHT) {
+        x = rect.right - metrics.widthIncludingTrailingWhitespace;
+    }
+    float y = (rect.top + rect.bottom - metrics.height) / 2;
+    m_pRenderTarget->DrawTextLayout(D2D1::Point2F(x, y), pLayout, brush);
+}
+
+int D2DRenderBackend::MeasureText(const std::wstring& text, const std::wstring& fontFamily, float fontSize, int fontWeight) {
+    IDWriteTextLayout* pLayout = GetTextLayout(text, fontFamily, fontSize, fontWeight);
+    if (!pLayout) return RenderBackend::MeasureText(text, fontFamily, fontSize, fontWeight);
+    
+    DWRITE_TEXT_METRICS metrics = {};
+    pLayout->GetMetrics(&metrics);
+    return (int)(metrics.widthIncludingTrailingWhitespace + 0.5f);
+}
+
+void D2DRenderBackend::DrawLinearGradient(const RECT& rect, Color startColor, Color endColor, bool horizontal) {
+    GradientResources* gradient = GetGradient(startColor, endColor);
+    if (!gradient) return;
+    
+    D2D1_POINT_2F start, end;
+    if (horizontal) {
+        start = D2D1::Point2F((float)rect.left, (float)rect.top);
+        end = D2D1::Point2F((float)rect.right, (float)rect.top);
+    } else {
+        start = D2D1::Point2F((float)rect.left, (float)rect.top);
+        end = D2D1::Point2F((float)rect.left, (float)rect.bottom);
+    }
+    
+    // The brush is kept per color pair; only its geometry changes per call
+    if (!gradient->linear) {
+        HRESULT hr = m_pRenderTarget->CreateLinearGradientBrush(
             D2D1::LinearGradientBrushProperties(start, end),
-            pGradientStops,
-            &pBrush
+            gradient->stops,
+            &gradient->linear
         );
-        
-        if (SUCCEEDED(hr) && pBrush) {
-            m_pRenderTarget->FillRectangle(ToD2DRect(rect), pBrush);
-            pBrush->Release();
+        if (FAILED(hr)) {
+            gradient->linear = nullptr;
+            return;
         }
-        
-        pGradientStops->Release();
+    } else {
+        gradient->linear->SetStartPoint(start);
+        gradient->linear->SetEndPoint(end);
     }
+    
+    m_pRenderTarget->FillRectangle(ToD2DRect(rect), gradient->linear);
 }
 
 void D2DRenderBackend::DrawRadialGradient(const RECT& rect, Color centerColor, Color edgeColor, int cx, int cy) {
-    if (!m_pRenderTarget) return;
+    GradientResources* gradient = GetGradient(centerColor, edgeColor);
+    if (!gradient) return;
     
-    D2D1_GRADIENT_STOP gradientStops[2];
-    gradientStops[0].color = ToD2DColor(centerColor);
-    gradientStops[0].position = 0.0f;
-    gradientStops[1].color = ToD2DColor(edgeColor);
-    gradientStops[1].position = 1.0f;
+    D2D1_POINT_2F center = D2D1::Point2F((float)cx, (float)cy);
+    float radiusX = (float)(rect.right - rect.left) / 2.0f;
+    float radiusY = (float)(rect.bottom - rect.top) / 2.0f;
     
-    ID2D1GradientStopCollection* pGradientStops = nullptr;
-    HRESULT hr = m_pRenderTarget->CreateGradientStopCollection(
-        gradientStops,
-        2,
-        D2D1_GAMMA_2_2,
-        D2D1_EXTEND_MODE_CLAMP,
-        &pGradientStops
-    );
-    
-    if (SUCCEEDED(hr) && pGradientStops) {
-        ID2D1RadialGradientBrush* pBrush = nullptr;
-        
-        float radiusX = (float)(rect.right - rect.left) / 2.0f;
-        float radiusY = (float)(rect.bottom - rect.top) / 2.0f;
-        
-        hr = m_pRenderTarget->CreateRadialGradientBrush(
+    if (!gradient->radial) {
+        HRESULT hr = m_pRenderTarget->CreateRadialGradientBrush(
             D2D1::RadialGradientBrushProperties(
-                D2D1::Point2F((float)cx, (float)cy),
+                center,
                 D2D1::Point2F(0, 0),
                 radiusX,
                 radiusY
             ),
-            pGradientStops,
-            &pBrush
+            gradient->stops,
+            &gradient->radial
         );
-        
-        if (SUCCEEDED(hr) && pBrush) {
-            m_pRenderTarget->FillRectangle(ToD2DRect(rect), pBrush);
-            pBrush->Release();
+        if (FAILED(hr)) {
+            gradient->radial = nullptr;
+            return;
         }
-        
-        pGradientStops->Release();
+    } else {
+        gradient->radial->SetCenter(center);
+        gradient->radial->SetRadiusX(radiusX);
+        gradient->radial->SetRadiusY(radiusY);
     }
+    
+    m_pRenderTarget->FillRectangle(ToD2DRect(rect), gradient->radial);
 }
 
 void D2DRenderBackend::DrawShadow(const RECT& rect, int offsetX, int offsetY, int blur, Color shadowColor) {
     if (!m_pRenderTarget) return;
     
-    // Create shadow effect using D2D shadow effect if available
-    ID2D1DeviceContext* pDeviceContext = nullptr;
-    HRESULT hr = m_pRenderTarget->QueryInterface(&pDeviceContext);
+    RECT shadowRect = rect;
+    OffsetRect(&shadowRect, offsetX, offsetY);
+    
+    // Blurred shadows run on the GPU: flood -> crop to the rect -> shadow
+    ID2D1Effect* pFlood = blur > 0 ? GetEffect(EFFECT_SHADOW_FLOOD, CLSID_D2D1Flood) : nullptr;
+    ID2D1Effect* pCrop = pFlood ? GetEffect(EFFECT_SHADOW_CROP, CLSID_D2D1Crop) : nullptr;
+    ID2D1Effect* pShadow = pCrop ? GetEffect(EFFECT_SHADOW, CLSID_D2D1Shadow) : nullptr;
     
-    if (SUCCEEDED(hr) && pDeviceContext) {
-        ID2D1Effect* pShadowEffect = nullptr;
-        hr = pDeviceContext->CreateEffect(CLSID_D2D1Shadow, &pShadowEffect);
+    if (pShadow) {
+        D2D1_RECT_F d2dRect = ToD2DRect(shadowRect);
+        D2D1_VECTOR_4F cropRect = D2D1::Vector4F(d2dRect.left, d2dRect.top, d2dRect.right, d2dRect.bottom);
         
-        if (SUCCEEDED(hr) && pShadowEffect) {
-            // Set shadow properties
-            pShadowEffect->SetValue(D2D1_SHADOW_PROP_BLUR_STANDARD_DEVIATION, (float)blur);
-            pShadowEffect->SetValue(D2D1_SHADOW_PROP_COLOR, ToD2DColor(shadowColor));
-            
-            // Apply shadow (would need bitmap input)
-            // For now, fallback to simple rectangle
-            RECT shadowRect = rect;
-            OffsetRect(&shadowRect, offsetX, offsetY);
-            
-            ID2D1SolidColorBrush* brush = GetBrush(shadowColor);
-            if (brush) {
-                m_pRenderTarget->FillRectangle(ToD2DRect(shadowRect), brush);
-            }
-            
-            pShadowEffect->Release();
-        }
+        pCrop->SetInputEffect(0, pFlood);
+        pCrop->SetValue(D2D1_CROP_PROP_RECT, cropRect);
         
-        pDeviceContext->Release();
-    } else {
-        // Fallback to simple shadow
-        RECT shadowRect = rect;
-        OffsetRect(&shadowRect, offsetX, offsetY);
+        pShadow->SetInputEffect(0, pCrop);
+        pShadow->SetValue(D2D1_SHADOW_PROP_BLUR_STANDARD_DEVIATION, (float)blur);
+        pShadow->SetValue(D2D1_SHADOW_PROP_COLOR, ToD2DColor(shadowColor));
         
-        ID2D1SolidColorBrush* brush = GetBrush(shadowColor);
-        if (brush) {
-            m_pRenderTarget->FillRectangle(ToD2DRect(shadowRect), brush);
-        }
+        m_pDeviceContext->DrawImage(pShadow);
+        return;
+    }
+    
+    // Hard-edged or no D2D1.1: a plain offset fill
+    ID2D1SolidColorBrush* brush = GetBrush(shadowColor);
+    if (brush) {
+        m_pRenderTarget->FillRectangle(ToD2DRect(shadowRect), brush);
     }
 }
 
@@ -521,87 +773,46 @@ void D2DRenderBackend::DrawGlow(const RECT& rect, int radius, Color glowColor) {
 void D2DRenderBackend::ApplyBlur(const RECT& rect, int blurRadius) {
     if (!m_pRenderTarget) return;
     
-    // Try to get device context for effects
-    ID2D1DeviceContext* pDeviceContext = nullptr;
-    HRESULT hr = m_pRenderTarget->QueryInterface(&pDeviceContext);
+    ID2D1Effect* pBlurEffect = GetEffect(EFFECT_BLUR, CLSID_D2D1GaussianBlur);
     
-    // Check if D2D1.1 device context is available
-    if (FAILED(hr) || !pDeviceContext) {
-        // Fallback to software blur - D2D1.1 not available
-        HDC hdc = GetGDIFallbackDC();
-        if (hdc) {
-            Renderer::ApplyBlur(hdc, rect, blurRadius);
-            ReleaseGDIFallbackDC(hdc);
-        }
-        return;
-    }
+    D2D1_RECT_F d2dRect = ToD2DRect(rect);
     
-    // Check if blur effect is available (created during initialization)
-    if (!m_pBlurEffect) {
-        // Fallback to software blur - blur effect not available
-        HDC hdc = GetGDIFallbackDC();
-        if (hdc) {
-            Renderer::ApplyBlur(hdc, rect, blurRadius);
-            ReleaseGDIFallbackDC(hdc);
+    if (!pBlurEffect) {
+        // D2D1.1 or the blur effect not available - separable box blur on the device
+        if (blurRadius > 0) {
+            int taps = std::min(2 * blurRadius + 1, MAX_BLUR_TAPS);
+            float step = (float)(2 * blurRadius) / (float)(taps - 1);
+            DrawTapBlur(d2dRect, step, 0.0f, taps, true);
+            DrawTapBlur(d2dRect, 0.0f, step, taps, true);
         }
-        pDeviceContext->Release();
         return;
     }
     
-    // Create a bitmap from the render target area
-    D2D1_SIZE_F size = m_pRenderTarget->GetSize();
-    D2D1_RECT_F d2dRect = ToD2DRect(rect);
-    
-    // Create bitmap to hold the region
-    ID2D1Bitmap* pBitmap = nullptr;
-    D2D1_BITMAP_PROPERTIES bitmapProps = D2D1::BitmapProperties(
-        D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED)
-    );
-    
-    D2D1_SIZE_U bitmapSize = D2D1::SizeU(
-        (UINT32)(d2dRect.right - d2dRect.left),
-        (UINT32)(d2dRect.bottom - d2dRect.top)
-    );
+    ID2D1Bitmap* pBitmap = CaptureRegion(d2dRect);
+    if (!pBitmap) return;
     
-    hr = m_pRenderTarget->CreateBitmap(bitmapSize, bitmapProps, &pBitmap);
+    // Set blur effect parameters
+    pBlurEffect->SetValue(D2D1_GAUSSIANBLUR_PROP_STANDARD_DEVIATION, (float)blurRadius);
+    pBlurEffect->SetValue(D2D1_GAUSSIANBLUR_PROP_BORDER_MODE, D2D1_BORDER_MODE_SOFT);
     
-    if (SUCCEEDED(hr) && pBitmap) {
-        // Copy the region to bitmap (called during render cycle between BeginDraw/EndDraw)
-        D2D1_POINT_2U destPoint = D2D1::Point2U(0, 0);
-        D2D1_RECT_U sourceRect = D2D1::RectU(
-            (UINT32)d2dRect.left, (UINT32)d2dRect.top,
-            (UINT32)d2dRect.right, (UINT32)d2dRect.bottom
-        );
-        
-        hr = pBitmap->CopyFromRenderTarget(&destPoint, m_pRenderTarget, &sourceRect);
-        
-        if (SUCCEEDED(hr)) {
-            // Set blur effect parameters
-            m_pBlurEffect->SetValue(D2D1_GAUSSIANBLUR_PROP_STANDARD_DEVIATION, (float)blurRadius);
-            m_pBlurEffect->SetValue(D2D1_GAUSSIANBLUR_PROP_BORDER_MODE, D2D1_BORDER_MODE_SOFT);
-            
-            // Set input bitmap
-            m_pBlurEffect->SetInput(0, pBitmap);
-            
-            // Draw the blurred result back
-            pDeviceContext->DrawImage(m_pBlurEffect, D2D1::Point2F(d2dRect.left, d2dRect.top));
-        }
-        
-        pBitmap->Release();
-    }
+    // Set input bitmap
+    pBlurEffect->SetInput(0, pBitmap);
     
-    pDeviceContext->Release();
+    // Draw the blurred result back
+    m_pDeviceContext->DrawImage(pBlurEffect, D2D1::Point2F(d2dRect.left, d2dRect.top));
 }
 
 void D2DRenderBackend::ApplyBloom(const RECT& rect, float threshold, float intensity) {
     if (!m_pRenderTarget) return;
     
-    // Try to get device context for effects
-    ID2D1DeviceContext* pDeviceContext = nullptr;
-    HRESULT hr = m_pRenderTarget->QueryInterface(&pDeviceContext);
+    // Effects for bloom: brightness threshold -> blur -> composite
+    ID2D1Effect* pThresholdEffect = GetEffect(EFFECT_BLOOM_THRESHOLD, CLSID_D2D1ColorMatrix);
+    ID2D1Effect* pBlurEffect = GetEffect(EFFECT_BLOOM_BLUR, CLSID_D2D1GaussianBlur);
+    ID2D1Effect* pCompositeEffect = GetEffect(EFFECT_BLOOM_COMPOSITE, CLSID_D2D1Composite);
     
-    if (FAILED(hr) || !pDeviceContext) {
-        // Fallback to software bloom - D2D1.1 not available
+    if (!pThresholdEffect || !pBlurEffect || !pCompositeEffect) {
+        // Fallback to software bloom - D2D1.1 not available, and a brightness
+        // threshold can't be expressed with plain bitmap draws
         HDC hdc = GetGDIFallbackDC();
         if (hdc) {
             Renderer::ApplyBloom(hdc, rect, threshold, intensity);
@@ -610,399 +821,424 @@ void D2DRenderBackend::ApplyBloom(const RECT& rect, float threshold, float inten
         return;
     }
     
-    // Create a bitmap from the render target area
     D2D1_RECT_F d2dRect = ToD2DRect(rect);
+    ID2D1Bitmap* pBitmap = CaptureRegion(d2dRect);
+    if (!pBitmap) return;
     
-    // Create bitmap to hold the region
-    ID2D1Bitmap* pBitmap = nullptr;
-    D2D1_BITMAP_PROPERTIES bitmapProps = D2D1::BitmapProperties(
-        D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED)
-    );
+    // 1. Brightness extraction using color matrix
+    pThresholdEffect->SetInput(0, pBitmap);
     
-    D2D1_SIZE_U bitmapSize = D2D1::SizeU(
-        (UINT32)(d2dRect.right - d2dRect.left),
-        (UINT32)(d2dRect.bottom - d2dRect.top)
-    );
+    // Isolates pixels brighter than the threshold
+    pThresholdEffect->SetValue(D2D1_COLORMATRIX_PROP_COLOR_MATRIX, BloomThresholdMatrix(threshold, intensity));
     
-    hr = m_pRenderTarget->CreateBitmap(bitmapSize, bitmapProps, &pBitmap);
+    // 2. Blur the bright areas
+    pBlurEffect->SetInputEffect(0, pThresholdEffect);
+    // Calculate blur radius: base + (intensity scaling)
+    float blurRadius = BLOOM_BASE_BLUR + (intensity * BLOOM_INTENSITY_SCALE);
+    pBlurEffect->SetValue(D2D1_GAUSSIANBLUR_PROP_STANDARD_DEVIATION, blurRadius);
+    pBlurEffect->SetValue(D2D1_GAUSSIANBLUR_PROP_BORDER_MODE, D2D1_BORDER_MODE_SOFT);
     
-    if (SUCCEEDED(hr) && pBitmap) {
-        // Copy the region to bitmap (works during render cycle between BeginDraw/EndDraw)
-        D2D1_POINT_2U destPoint = D2D1::Point2U(0, 0);
-        D2D1_RECT_U sourceRect = D2D1::RectU(
-            (UINT32)d2dRect.left, (UINT32)d2dRect.top,
-            (UINT32)d2dRect.right, (UINT32)d2dRect.bottom
-        );
-        
-        hr = pBitmap->CopyFromRenderTarget(&destPoint, m_pRenderTarget, &sourceRect);
-        
-        if (SUCCEEDED(hr)) {
-            // Create effects for bloom: brightness threshold -> blur -> composite
-            
-            // 1. Create brightness extraction effect using color matrix
-            ID2D1Effect* pThresholdEffect = nullptr;
-            hr = pDeviceContext->CreateEffect(CLSID_D2D1ColorMatrix, &pThresholdEffect);
-            
-            if (SUCCEEDED(hr) && pThresholdEffect) {
-                pThresholdEffect->SetInput(0, pBitmap);
-                
-                // Create a color matrix that extracts bright pixels
-                // The threshold parameter (0-1) is scaled to 0-255 and negated for subtraction
-                // Matrix applies: output = max(0, input * intensity - threshold_255)
-                // This isolates pixels brighter than the threshold value
-                float scale = intensity;
-                float offset = -threshold * 255.0f;  // Negative offset for threshold subtraction
-                D2D1_MATRIX_5X4_F matrix = D2D1::Matrix5x4F(
-                    scale, 0, 0, 0,      // Red channel
-                    0, scale, 0, 0,      // Green channel  
-                    0, 0, scale, 0,      // Blue channel
-                    0, 0, 0, 1,          // Alpha channel
-                    offset, offset, offset, 0  // Negative offset to create threshold cutoff
-                );
-                pThresholdEffect->SetValue(D2D1_COLORMATRIX_PROP_COLOR_MATRIX, matrix);
-                
-                // 2. Create blur effect for the bright areas (created on-demand, not cached)
-                ID2D1Effect* pBlurEffect = nullptr;
-                hr = pDeviceContext->CreateEffect(CLSID_D2D1GaussianBlur, &pBlurEffect);
-                
-                if (SUCCEEDED(hr) && pBlurEffect) {
-                    pBlurEffect->SetInputEffect(0, pThresholdEffect);
-                    // Calculate blur radius: base + (intensity scaling)
-                    float blurRadius = BLOOM_BASE_BLUR + (intensity * BLOOM_INTENSITY_SCALE);
-                    pBlurEffect->SetValue(D2D1_GAUSSIANBLUR_PROP_STANDARD_DEVIATION, blurRadius);
-                    pBlurEffect->SetValue(D2D1_GAUSSIANBLUR_PROP_BORDER_MODE, D2D1_BORDER_MODE_SOFT);
-                    
-                    // 3. Create composite effect to blend bloom with original
-                    ID2D1Effect* pCompositeEffect = nullptr;
-                    hr = pDeviceContext->CreateEffect(CLSID_D2D1Composite, &pCompositeEffect);
-                    
-                    if (SUCCEEDED(hr) && pCompositeEffect) {
-                        pCompositeEffect->SetInput(0, pBitmap);  // Original
-                        pCompositeEffect->SetInputEffect(1, pBlurEffect);  // Bloom
-                        pCompositeEffect->SetValue(D2D1_COMPOSITE_PROP_MODE, D2D1_COMPOSITE_MODE_PLUS);
-                        
-                        // Draw the final composited result
-                        pDeviceContext->DrawImage(pCompositeEffect, D2D1::Point2F(d2dRect.left, d2dRect.top));
-                        
-                        pCompositeEffect->Release();
-                    }
-                    
-                    pBlurEffect->Release();
-                }
-                
-                pThresholdEffect->Release();
-            }
-        }
-        
-        pBitmap->Release();
-    }
+    // 3. Blend bloom with original
+    pCompositeEffect->SetInput(0, pBitmap);  // Original
+    pCompositeEffect->SetInputEffect(1, pBlurEffect);  // Bloom
+    pCompositeEffect->SetValue(D2D1_COMPOSITE_PROP_MODE, D2D1_COMPOSITE_MODE_PLUS);
     
-    pDeviceContext->Release();
+    // Draw the final composited result
+    m_pDeviceContext->DrawImage(pCompositeEffect, D2D1::Point2F(d2dRect.left, d2dRect.top));
 }
 
 void D2DRenderBackend::ApplyDepthOfField(const RECT& rect, int focalDepth, int blurAmount, float focalRange) {
     if (!m_pRenderTarget) return;
     
-    // Try to get device context for effects
-    ID2D1DeviceContext* pDeviceContext = nullptr;
-    HRESULT hr = m_pRenderTarget->QueryInterface(&pDeviceContext);
+    ID2D1Effect* pBlurEffect = GetEffect(EFFECT_DEPTH_BLUR, CLSID_D2D1GaussianBlur);
     
-    if (FAILED(hr) || !pDeviceContext) {
-        // Fallback to software implementation
-        HDC hdc = GetGDIFallbackDC();
-        if (hdc) {
-            // Software depth of field implementation
-            int centerY = (rect.top + rect.bottom) / 2;
-            for (int y = rect.top; y < rect.bottom; y++) {
-                int distanceFromFocus = abs(y - (rect.top + focalDepth));
-                float blurFactor = (float)distanceFromFocus / focalRange;
-                blurFactor = std::min(blurFactor, 1.0f);
-                
-                int currentBlur = (int)(blurAmount * blurFactor);
-                if (currentBlur > 0) {
-                    RECT lineRect = { rect.left, y, rect.right, y + 1 };
-                    Renderer::ApplyBlur(hdc, lineRect, currentBlur);
-                }
-            }
-            ReleaseGDIFallbackDC(hdc);
-        }
+    if (!pBlurEffect) {
+        // D2D1.1 not available - the same uniform blur as the tap blur fallback of ApplyBlur
+        ApplyBlur(rect, blurAmount);
         return;
     }
     
     // GPU-accelerated depth of field using Direct2D
     D2D1_RECT_F d2dRect = ToD2DRect(rect);
+    ID2D1Bitmap* pBitmap = CaptureRegion(d2dRect);
+    if (!pBitmap) return;
     
-    // Create bitmap from render target region
-    ID2D1Bitmap* pBitmap = nullptr;
-    D2D1_BITMAP_PROPERTIES bitmapProps = D2D1::BitmapProperties(
-        D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED)
-    );
-    
-    D2D1_SIZE_U bitmapSize = D2D1::SizeU(
-        (UINT32)(d2dRect.right - d2dRect.left),
-        (UINT32)(d2dRect.bottom - d2dRect.top)
-    );
-    
-    hr = m_pRenderTarget->CreateBitmap(bitmapSize, bitmapProps, &pBitmap);
-    
-    if (SUCCEEDED(hr) && pBitmap) {
-        D2D1_POINT_2U destPoint = D2D1::Point2U(0, 0);
-        D2D1_RECT_U sourceRect = D2D1::RectU(
-            (UINT32)d2dRect.left, (UINT32)d2dRect.top,
-            (UINT32)d2dRect.right, (UINT32)d2dRect.bottom
-        );
-        
-        hr = pBitmap->CopyFromRenderTarget(&destPoint, m_pRenderTarget, &sourceRect);
-        
-        if (SUCCEEDED(hr)) {
-            // Apply variable blur based on depth
-            ID2D1Effect* pBlurEffect = nullptr;
-            hr = pDeviceContext->CreateEffect(CLSID_D2D1GaussianBlur, &pBlurEffect);
-            
-            if (SUCCEEDED(hr) && pBlurEffect) {
-                pBlurEffect->SetInput(0, pBitmap);
-                pBlurEffect->SetValue(D2D1_GAUSSIANBLUR_PROP_STANDARD_DEVIATION, (float)blurAmount);
-                pBlurEffect->SetValue(D2D1_GAUSSIANBLUR_PROP_BORDER_MODE, D2D1_BORDER_MODE_SOFT);
-                
-                // Draw blurred image
-                pDeviceContext->DrawImage(pBlurEffect, D2D1::Point2F(d2dRect.left, d2dRect.top));
-                
-                pBlurEffect->Release();
-            }
-        }
-        
-        pBitmap->Release();
-    }
+    // Apply variable blur based on depth
+    pBlurEffect->SetInput(0, pBitmap);
+    pBlurEffect->SetValue(D2D1_GAUSSIANBLUR_PROP_STANDARD_DEVIATION, (float)blurAmount);
+    pBlurEffect->SetValue(D2D1_GAUSSIANBLUR_PROP_BORDER_MODE, D2D1_BORDER_MODE_SOFT);
     
-    pDeviceContext->Release();
+    // Draw blurred image
+    m_pDeviceContext->DrawImage(pBlurEffect, D2D1::Point2F(d2dRect.left, d2dRect.top));
 }
 
 void D2DRenderBackend::ApplyMotionBlur(const RECT& rect, int directionX, int directionY, float intensity) {
     if (!m_pRenderTarget) return;
     
-    // Try to get device context for effects
-    ID2D1DeviceContext* pDeviceContext = nullptr;
-    HRESULT hr = m_pRenderTarget->QueryInterface(&pDeviceContext);
+    ID2D1Effect* pDirectionalBlurEffect = GetEffect(EFFECT_MOTION_BLUR, CLSID_D2D1DirectionalBlur);
     
-    if (FAILED(hr) || !pDeviceContext) {
-        // Fallback to software implementation
-        HDC hdc = GetGDIFallbackDC();
-        if (hdc) {
-            // Software motion blur - simplified fallback
-            int width = rect.right - rect.left;
-            int height = rect.bottom - rect.top;
-            
-            HDC tempDC = CreateCompatibleDC(hdc);
-            HBITMAP tempBitmap = CreateCompatibleBitmap(hdc, width, height);
-            HBITMAP oldBitmap = (HBITMAP)SelectObject(tempDC, tempBitmap);
-            
-            BitBlt(tempDC, 0, 0, width, height, hdc, rect.left, rect.top, SRCCOPY);
-            
-            int samples = 5;
-            BLENDFUNCTION blend = { AC_SRC_OVER, 0, (BYTE)(255 * intensity / samples), 0 };
-            
-            for (int i = 0; i < samples; i++) {
-                int offsetX = (directionX * i) / samples;
-                int offsetY = (directionY * i) / samples;
-                
-                AlphaBlend(hdc, rect.left + offsetX, rect.top + offsetY, width, height,
-                           tempDC, 0, 0, width, height, blend);
-            }
-            
-            SelectObject(tempDC, oldBitmap);
-            DeleteObject(tempBitmap);
-            DeleteDC(tempDC);
-            
-            ReleaseGDIFallbackDC(hdc);
-        }
+    if (!pDirectionalBlurEffect) {
+        // D2D1.1 not available - trail of shifted copies along the direction, on the device
+        float scale = intensity / (float)(MOTION_BLUR_TAPS - 1);
+        DrawTapBlur(ToD2DRect(rect), directionX * scale, directionY * scale, MOTION_BLUR_TAPS, false);
         return;
     }
     
     // GPU-accelerated directional blur using Direct2D
     D2D1_RECT_F d2dRect = ToD2DRect(rect);
+    ID2D1Bitmap* pBitmap = CaptureRegion(d2dRect);
+    if (!pBitmap) return;
     
-    ID2D1Bitmap* pBitmap = nullptr;
-    D2D1_BITMAP_PROPERTIES bitmapProps = D2D1::BitmapProperties(
-        D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED)
-    );
+    pDirectionalBlurEffect->SetInput(0, pBitmap);
     
-    D2D1_SIZE_U bitmapSize = D2D1::SizeU(
-        (UINT32)(d2dRect.right - d2dRect.left),
-        (UINT32)(d2dRect.bottom - d2dRect.top)
-    );
+    // Calculate angle and amount from direction vector
+    float angle = atan2f((float)directionY, (float)directionX);
+    float amount = sqrtf((float)(directionX * directionX + directionY * directionY)) * intensity;
     
-    hr = m_pRenderTarget->CreateBitmap(bitmapSize, bitmapProps, &pBitmap);
+    pDirectionalBlurEffect->SetValue(D2D1_DIRECTIONALBLUR_PROP_STANDARD_DEVIATION, amount);
+    pDirectionalBlurEffect->SetValue(D2D1_DIRECTIONALBLUR_PROP_ANGLE, angle);
     
-    if (SUCCEEDED(hr) && pBitmap) {
-        D2D1_POINT_2U destPoint = D2D1::Point2U(0, 0);
-        D2D1_RECT_U sourceRect = D2D1::RectU(
-            (UINT32)d2dRect.left, (UINT32)d2dRect.top,
-            (UINT32)d2dRect.right, (UINT32)d2dRect.bottom
-        );
-        
-        hr = pBitmap->CopyFromRenderTarget(&destPoint, m_pRenderTarget, &sourceRect);
-        
-        if (SUCCEEDED(hr)) {
-            // Use directional blur effect
-            ID2D1Effect* pDirectionalBlurEffect = nullptr;
-            hr = pDeviceContext->CreateEffect(CLSID_D2D1DirectionalBlur, &pDirectionalBlurEffect);
-            
-            if (SUCCEEDED(hr) && pDirectionalBlurEffect) {
-                pDirectionalBlurEffect->SetInput(0, pBitmap);
-                
-                // Calculate angle and amount from direction vector
-                float angle = atan2f((float)directionY, (float)directionX);
-                float amount = sqrtf((float)(directionX * directionX + directionY * directionY)) * intensity;
-                
-                pDirectionalBlurEffect->SetValue(D2D1_DIRECTIONALBLUR_PROP_STANDARD_DEVIATION, amount);
-                pDirectionalBlurEffect->SetValue(D2D1_DIRECTIONALBLUR_PROP_ANGLE, angle);
-                
-                // Draw the blurred result
-                pDeviceContext->DrawImage(pDirectionalBlurEffect, D2D1::Point2F(d2dRect.left, d2dRect.top));
-                
-                pDirectionalBlurEffect->Release();
-            }
-        }
-        
-        pBitmap->Release();
-    }
-    
-    pDeviceContext->Release();
+    // Draw the blurred result
+    m_pDeviceContext->DrawImage(pDirectionalBlurEffect, D2D1::Point2F(d2dRect.left, d2dRect.top));
 }
 
 void D2DRenderBackend::ApplyChromaticAberration(const RECT& rect, float strength, int offsetX, int offsetY) {
     if (!m_pRenderTarget) return;
     
-    // Try to get device context for effects
-    ID2D1DeviceContext* pDeviceContext = nullptr;
-    HRESULT hr = m_pRenderTarget->QueryInterface(&pDeviceContext);
+    // One color matrix per channel
+    ID2D1Effect* pRedEffect = GetEffect(EFFECT_CHROMA_RED, CLSID_D2D1ColorMatrix);
+    ID2D1Effect* pGreenEffect = GetEffect(EFFECT_CHROMA_GREEN, CLSID_D2D1ColorMatrix);
+    ID2D1Effect* pBlueEffect = GetEffect(EFFECT_CHROMA_BLUE, CLSID_D2D1ColorMatrix);
     
-    if (FAILED(hr) || !pDeviceContext) {
-        // Fallback to software implementation
-        HDC hdc = GetGDIFallbackDC();
-        if (hdc) {
-            // Note: Software chromatic aberration is complex, skipping fallback
-            // Could implement using GDI+ or manual bitmap manipulation
-            ReleaseGDIFallbackDC(hdc);
-        }
+    if (!pRedEffect || !pGreenEffect || !pBlueEffect) {
+        // Channel separation needs the color matrix effect; without D2D1.1
+        // the region is left as is rather than read back for nothing
         return;
     }
     
     // GPU-accelerated chromatic aberration using channel shifts
     D2D1_RECT_F d2dRect = ToD2DRect(rect);
-    
-    ID2D1Bitmap* pBitmap = nullptr;
-    D2D1_BITMAP_PROPERTIES bitmapProps = D2D1::BitmapProperties(
-        D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED)
+    ID2D1Bitmap* pBitmap = CaptureRegion(d2dRect);
+    if (!pBitmap) return;
+    
+    // Create three shifted versions for R, G, B channels
+    float scaledOffsetX = offsetX * strength;
+    float scaledOffsetY = offsetY * strength;
+    
+    // Red channel - shift right
+    pRedEffect->SetInput(0, pBitmap);
+    
+    // Extract only red channel
+    D2D1_MATRIX_5X4_F redMatrix = D2D1::Matrix5x4F(
+        1, 0, 0, 0,  // Keep red
+        0, 0, 0, 0,  // Remove green
+        0, 0, 0, 0,  // Remove blue
+        0, 0, 0, 1,  // Keep alpha
+        0, 0, 0, 0
     );
-    
-    D2D1_SIZE_U bitmapSize = D2D1::SizeU(
-        (UINT32)(d2dRect.right - d2dRect.left),
-        (UINT32)(d2dRect.bottom - d2dRect.top)
+    pRedEffect->SetValue(D2D1_COLORMATRIX_PROP_COLOR_MATRIX, redMatrix);
+    
+    // Draw red channel shifted
+    m_pDeviceContext->DrawImage(pRedEffect, 
+        D2D1::Point2F(d2dRect.left + scaledOffsetX, d2dRect.top + scaledOffsetY));
+    
+    // Blue channel - shift left
+    pBlueEffect->SetInput(0, pBitmap);
+    
+    // Extract only blue channel
+    D2D1_MATRIX_5X4_F blueMatrix = D2D1::Matrix5x4F(
+        0, 0, 0, 0,  // Remove red
+        0, 0, 0, 0,  // Remove green
+        0, 0, 1, 0,  // Keep blue
+        0, 0, 0, 1,  // Keep alpha
+        0, 0, 0, 0
+    );
+    pBlueEffect->SetValue(D2D1_COLORMATRIX_PROP_COLOR_MATRIX, blueMatrix);
+    
+    // Draw blue channel shifted opposite direction
+    m_pDeviceContext->DrawImage(pBlueEffect, 
+        D2D1::Point2F(d2dRect.left - scaledOffsetX, d2dRect.top - scaledOffsetY));
+    
+    // Green channel - no shift (center)
+    pGreenEffect->SetInput(0, pBitmap);
+    
+    // Extract only green channel
+    D2D1_MATRIX_5X4_F greenMatrix = D2D1::Matrix5x4F(
+        0, 0, 0, 0,  // Remove red
+        0, 1, 0, 0,  // Keep green
+        0, 0, 0, 0,  // Remove blue
+        0, 0, 0, 1,  // Keep alpha
+        0, 0, 0, 0
     );
+    pGreenEffect->SetValue(D2D1_COLORMATRIX_PROP_COLOR_MATRIX, greenMatrix);
+    
+    // Draw green channel at original position
+    m_pDeviceContext->DrawImage(pGreenEffect, D2D1::Point2F(d2dRect.left, d2dRect.top));
+}
+
+void D2DRenderBackend::ApplyEffectGraph(const RECT& rect, EffectGraph& graph) {
+    if (!m_pRenderTarget || graph.IsEmpty()) return;
+    
+    const EffectSettings& settings = graph.GetSettings();
+    const auto& stages = graph.GetStages();
+    
+    // Every stage but chromatic aberration needs its effect; without D2D1.1
+    // each stage takes its own fallback
+    bool available = true;
+    for (const EffectGraph::Stage& stage : stages) {
+        switch (stage.type) {
+            case EffectGraph::StageType::BLUR:
+                available = available && GetEffect(EFFECT_BLUR, CLSID_D2D1GaussianBlur);
+                break;
+            case EffectGraph::StageType::DEPTH_OF_FIELD:
+                available = available && GetEffect(EFFECT_DEPTH_BLUR, CLSID_D2D1GaussianBlur);
+                break;
+            case EffectGraph::StageType::MOTION_BLUR:
+                available = available && GetEffect(EFFECT_MOTION_BLUR, CLSID_D2D1DirectionalBlur);
+                break;
+            case EffectGraph::StageType::BLOOM:
+                available = available && GetEffect(EFFECT_BLOOM_THRESHOLD, CLSID_D2D1ColorMatrix) &&
+                            GetEffect(EFFECT_BLOOM_BLUR, CLSID_D2D1GaussianBlur) &&
+                            GetEffect(EFFECT_BLOOM_COMPOSITE, CLSID_D2D1Composite);
+                break;
+            case EffectGraph::StageType::CHROMATIC_ABERRATION:
+                break;
+        }
+    }
+    if (!available) {
+        RenderBackend::ApplyEffectGraph(rect, graph);
+        return;
+    }
     
-    hr = m_pRenderTarget->CreateBitmap(bitmapSize, bitmapProps, &pBitmap);
+    D2D1_RECT_F d2dRect = ToD2DRect(rect);
+    D2D1_POINT_2F origin = D2D1::Point2F(d2dRect.left, d2dRect.top);
     
-    if (SUCCEEDED(hr) && pBitmap) {
-        D2D1_POINT_2U destPoint = D2D1::Point2U(0, 0);
-        D2D1_RECT_U sourceRect = D2D1::RectU(
-            (UINT32)d2dRect.left, (UINT32)d2dRect.top,
-            (UINT32)d2dRect.right, (UINT32)d2dRect.bottom
-        );
+    // Consecutive stages feed each other from one capture and draw once.
+    // Chromatic aberration draws three images rather than producing one, so
+    // it ends a chain and works from its own capture.
+    ID2D1Bitmap* pBitmap = nullptr;
+    ID2D1Effect* pLast = nullptr;
+    auto connect = [&](ID2D1Effect* effect, UINT32 index) {
+        if (pLast) {
+            effect->SetInputEffect(index, pLast);
+        } else {
+            effect->SetInput(index, pBitmap);
+        }
+    };
+    auto flush = [&]() {
+        if (pLast) {
+            m_pDeviceContext->DrawImage(pLast, origin);
+        }
+        pBitmap = nullptr;
+        pLast = nullptr;
+    };
+    
+    for (const EffectGraph::Stage& stage : stages) {
+        if (stage.type == EffectGraph::StageType::CHROMATIC_ABERRATION) {
+            flush();
+            ApplyChromaticAberration(rect, settings.chromaticStrength,
+                                     settings.chromaticOffsetX, settings.chromaticOffsetY);
+            continue;
+        }
         
-        hr = pBitmap->CopyFromRenderTarget(&destPoint, m_pRenderTarget, &sourceRect);
+        if (!pBitmap) {
+            pBitmap = CaptureRegion(d2dRect);
+            if (!pBitmap) return;
+        }
         
-        if (SUCCEEDED(hr)) {
-            // Create three shifted versions for R, G, B channels
-            float scaledOffsetX = offsetX * strength;
-            float scaledOffsetY = offsetY * strength;
-            
-            // Red channel - shift right
-            ID2D1Effect* pRedEffect = nullptr;
-            hr = pDeviceContext->CreateEffect(CLSID_D2D1ColorMatrix, &pRedEffect);
-            
-            if (SUCCEEDED(hr) && pRedEffect) {
-                pRedEffect->SetInput(0, pBitmap);
-                
-                // Extract only red channel
-                D2D1_MATRIX_5X4_F redMatrix = D2D1::Matrix5x4F(
-                    1, 0, 0, 0,  // Keep red
-                    0, 0, 0, 0,  // Remove green
-                    0, 0, 0, 0,  // Remove blue
-                    0, 0, 0, 1,  // Keep alpha
-                    0, 0, 0, 0
-                );
-                pRedEffect->SetValue(D2D1_COLORMATRIX_PROP_COLOR_MATRIX, redMatrix);
-                
-                // Draw red channel shifted
-                pDeviceContext->DrawImage(pRedEffect, 
-                    D2D1::Point2F(d2dRect.left + scaledOffsetX, d2dRect.top + scaledOffsetY));
-                
-                pRedEffect->Release();
+        switch (stage.type) {
+            case EffectGraph::StageType::BLUR:
+            case EffectGraph::StageType::DEPTH_OF_FIELD: {
+                // Depth of field is the uniform blur ApplyDepthOfField draws
+                bool blur = stage.type == EffectGraph::StageType::BLUR;
+                ID2D1Effect* pBlur = m_effects[blur ? EFFECT_BLUR : EFFECT_DEPTH_BLUR];
+                connect(pBlur, 0);
+                pBlur->SetValue(D2D1_GAUSSIANBLUR_PROP_STANDARD_DEVIATION,
+                                (float)(blur ? settings.blurRadius : settings.dofBlurAmount));
+                pBlur->SetValue(D2D1_GAUSSIANBLUR_PROP_BORDER_MODE, D2D1_BORDER_MODE_SOFT);
+                pLast = pBlur;
+                break;
             }
             
-            // Blue channel - shift left
-            ID2D1Effect* pBlueEffect = nullptr;
-            hr = pDeviceContext->CreateEffect(CLSID_D2D1ColorMatrix, &pBlueEffect);
+            case EffectGraph::StageType::MOTION_BLUR: {
+                ID2D1Effect* pMotion = m_effects[EFFECT_MOTION_BLUR];
+                connect(pMotion, 0);
+                float directionX = (float)settings.motionDirX;
+                float directionY = (float)settings.motionDirY;
+                pMotion->SetValue(D2D1_DIRECTIONALBLUR_PROP_STANDARD_DEVIATION,
+                                  sqrtf(directionX * directionX + directionY * directionY) * settings.motionIntensity);
+                pMotion->SetValue(D2D1_DIRECTIONALBLUR_PROP_ANGLE, atan2f(directionY, directionX));
+                pLast = pMotion;
+                break;
+            }
             
-            if (SUCCEEDED(hr) && pBlueEffect) {
-                pBlueEffect->SetInput(0, pBitmap);
-                
-                // Extract only blue channel
-                D2D1_MATRIX_5X4_F blueMatrix = D2D1::Matrix5x4F(
-                    0, 0, 0, 0,  // Remove red
-                    0, 0, 0, 0,  // Remove green
-                    0, 0, 1, 0,  // Keep blue
-                    0, 0, 0, 1,  // Keep alpha
-                    0, 0, 0, 0
-                );
-                pBlueEffect->SetValue(D2D1_COLORMATRIX_PROP_COLOR_MATRIX, blueMatrix);
+            case EffectGraph::StageType::BLOOM: {
+                ID2D1Effect* pThreshold = m_effects[EFFECT_BLOOM_THRESHOLD];
+                ID2D1Effect* pBlur = m_effects[EFFECT_BLOOM_BLUR];
+                ID2D1Effect* pComposite = m_effects[EFFECT_BLOOM_COMPOSITE];
                 
-                // Draw blue channel shifted opposite direction
-                pDeviceContext->DrawImage(pBlueEffect, 
-                    D2D1::Point2F(d2dRect.left - scaledOffsetX, d2dRect.top - scaledOffsetY));
-                
-                pBlueEffect->Release();
+                connect(pThreshold, 0);
+                pThreshold->SetValue(D2D1_COLORMATRIX_PROP_COLOR_MATRIX,
+                                     BloomThresholdMatrix(settings.bloomThreshold, settings.bloomIntensity));
+                pBlur->SetInputEffect(0, pThreshold);
+                pBlur->SetValue(D2D1_GAUSSIANBLUR_PROP_STANDARD_DEVIATION,
+                                BLOOM_BASE_BLUR + settings.bloomIntensity * BLOOM_INTENSITY_SCALE);
+                pBlur->SetValue(D2D1_GAUSSIANBLUR_PROP_BORDER_MODE, D2D1_BORDER_MODE_SOFT);
+                connect(pComposite, 0);
+                pComposite->SetInputEffect(1, pBlur);
+                pComposite->SetValue(D2D1_COMPOSITE_PROP_MODE, D2D1_COMPOSITE_MODE_PLUS);
+                pLast = pComposite;
+                break;
             }
             
-            // Green channel - no shift (center)
-            ID2D1Effect* pGreenEffect = nullptr;
-            hr = pDeviceContext->CreateEffect(CLSID_D2D1ColorMatrix, &pGreenEffect);
-            
-            if (SUCCEEDED(hr) && pGreenEffect) {
-                pGreenEffect->SetInput(0, pBitmap);
-                
-                // Extract only green channel
-                D2D1_MATRIX_5X4_F greenMatrix = D2D1::Matrix5x4F(
-                    0, 0, 0, 0,  // Remove red
-                    0, 1, 0, 0,  // Keep green
-                    0, 0, 0, 0,  // Remove blue
-                    0, 0, 0, 1,  // Keep alpha
-                    0, 0, 0, 0
-                );
-                pGreenEffect->SetValue(D2D1_COLORMATRIX_PROP_COLOR_MATRIX, greenMatrix);
-                
-                // Draw green channel at original position
-                pDeviceContext->DrawImage(pGreenEffect, D2D1::Point2F(d2dRect.left, d2dRect.top));
-                
-                pGreenEffect->Release();
+            case EffectGraph::StageType::CHROMATIC_ABERRATION:
+                break;
+        }
+    }
+    flush();
+}
+
+void D2DRenderBackend::DrawParticleBatch(const float* x, const float* y, const uint32_t* colors, size_t count, int size) {
+    if (!m_pRenderTarget) return;
+    
+    D2D1_SIZE_U targetSize = m_pRenderTarget->GetPixelSize();
+    RECT clip = { 0, 0, (LONG)targetSize.width, (LONG)targetSize.height };
+    RECT bounds;
+    if (!GetParticleBounds(x, y, count, size, clip, bounds)) return;
+    
+    UINT32 width = (UINT32)(bounds.right - bounds.left);
+    UINT32 height = (UINT32)(bounds.bottom - bounds.top);
+    
+    // Reuse the bitmap while it is big enough, so a moving burst doesn't
+    // allocate a texture per frame
+    D2D1_SIZE_U bitmapSize = m_particleBitmap ? m_particleBitmap->GetPixelSize() : D2D1::SizeU(0, 0);
+    if (bitmapSize.width < width || bitmapSize.height < height) {
+        SafeRelease(m_particleBitmap);
+        D2D1_BITMAP_PROPERTIES bitmapProps = D2D1::BitmapProperties(
+            D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED)
+        );
+        bitmapSize = D2D1::SizeU(std::max(width, bitmapSize.width), std::max(height, bitmapSize.height));
+        if (FAILED(m_pRenderTarget->CreateBitmap(bitmapSize, bitmapProps, &m_particleBitmap))) {
+            m_particleBitmap = nullptr;
+            RenderBackend::DrawParticleBatch(x, y, colors, count, size);
+            return;
+        }
+    }
+    
+    // Splatting over transparent black leaves premultiplied pixels, which the
+    // target composites source-over in one draw
+    m_particlePixels.assign((size_t)width * height, 0);
+    PixelKernels::SplatParticles(m_particlePixels.data(), (int)width, (int)height, (int)width,
+                                 x, y, colors, count, bounds.left, bounds.top, size);
+    
+    D2D1_RECT_U destRect = D2D1::RectU(0, 0, width, height);
+    if (FAILED(m_particleBitmap->CopyFromMemory(&destRect, m_particlePixels.data(), width * 4))) return;
+    
+    m_pRenderTarget->DrawBitmap(m_particleBitmap, ToD2DRect(bounds), 1.0f,
+                                D2D1_BITMAP_INTERPOLATION_MODE_NEAREST_NEIGHBOR,
+                                D2D1::RectF(0.0f, 0.0f, (float)width, (float)height));
+}
+
+void D2DRenderBackend::DrawPolylines(const POINT* points, const DWORD* counts, size_t polylineCount, Color color, float width) {
+    if (!m_pRenderTarget || !points || !counts) return;
+    
+    ID2D1SolidColorBrush* brush = GetBrush(color);
+    if (!brush) return;
+    
+    if (!m_roundStroke) {
+        D2D1_STROKE_STYLE_PROPERTIES props = D2D1::StrokeStyleProperties(
+            D2D1_CAP_STYLE_ROUND, D2D1_CAP_STYLE_ROUND, D2D1_CAP_STYLE_ROUND, D2D1_LINE_JOIN_ROUND);
+        if (FAILED(m_pD2DFactory->CreateStrokeStyle(props, nullptr, 0, &m_roundStroke))) {
+            m_roundStroke = nullptr;
+        }
+    }
+    
+    // One open figure per polyline, stroked in a single draw
+    ID2D1PathGeometry* geometry = nullptr;
+    ID2D1GeometrySink* sink = nullptr;
+    if (FAILED(m_pD2DFactory->CreatePathGeometry(&geometry)) || FAILED(geometry->Open(&sink))) {
+        SafeRelease(geometry);
+        RenderBackend::DrawPolylines(points, counts, polylineCount, color, width);
+        return;
+    }
+    for (size_t i = 0; i < polylineCount; i++) {
+        DWORD count = counts[i];
+        if (count >= 2) {
+            sink->BeginFigure(D2D1::Point2F((float)points[0].x, (float)points[0].y), D2D1_FIGURE_BEGIN_HOLLOW);
+            for (DWORD k = 1; k < count; k++) {
+                sink->AddLine(D2D1::Point2F((float)points[k].x, (float)points[k].y));
             }
+            sink->EndFigure(D2D1_FIGURE_END_OPEN);
         }
-        
-        pBitmap->Release();
+        points += count;
+    }
+    HRESULT hr = sink->Close();
+    SafeRelease(sink);
+    
+    if (SUCCEEDED(hr)) {
+        m_pRenderTarget->DrawGeometry(geometry, brush, width, m_roundStroke);
+    }
+    SafeRelease(geometry);
+}
+
+void D2DRenderBackend::DrawAtlasTexture(const TextureAtlas& atlas, const std::string& name, const RECT& dest) {
+    const TextureAtlas::AtlasEntry* entry = atlas.GetTexture(name);
+    if (!m_pRenderTarget || !entry) return;
+    
+    std::shared_ptr<void>& slot = atlas.GetPlatformSurface(TextureAtlas::Surface::DIRECT2D);
+    D2DAtlasSurface* surface = static_cast<D2DAtlasSurface*>(slot.get());
+    if (!surface || surface->owner != this || surface->deviceResets != m_deviceResets) {
+        // GDI-sourced pixels carry no alpha, so the mirror is opaque like the GDI blit
+        D2D1_BITMAP_PROPERTIES bitmapProps = D2D1::BitmapProperties(
+            D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_IGNORE)
+        );
+        auto created = std::make_shared<D2DAtlasSurface>();
+        HRESULT hr = m_pRenderTarget->CreateBitmap(D2D1::SizeU((UINT32)atlas.GetWidth(), (UINT32)atlas.GetHeight()),
+                                                   bitmapProps, &created->bitmap);
+        if (FAILED(hr) || !created->bitmap) {
+            created->bitmap = nullptr;
+            return;
+        }
+        created->owner = this;
+        created->deviceResets = m_deviceResets;
+        slot = created;
+        surface = created.get();
+    }
+    
+    if (surface->version != atlas.GetVersion()) {
+        if (FAILED(surface->bitmap->CopyFromMemory(nullptr, atlas.GetPixels(), (UINT32)atlas.GetWidth() * 4))) return;
+        surface->version = atlas.GetVersion();
     }
     
-    pDeviceContext->Release();
+    bool scaled = dest.right - dest.left != entry->width || dest.bottom - dest.top != entry->height;
+    m_pRenderTarget->DrawBitmap(surface->bitmap, ToD2DRect(dest), 1.0f,
+                                scaled ? D2D1_BITMAP_INTERPOLATION_MODE_LINEAR : D2D1_BITMAP_INTERPOLATION_MODE_NEAREST_NEIGHBOR,
+                                D2D1::RectF((float)entry->x, (float)entry->y,
+                                            (float)(entry->x + entry->width), (float)(entry->y + entry->height)));
 }
 
 RenderBackend::Capabilities D2DRenderBackend::GetCapabilities() const {
     Capabilities caps;
     caps.supportsGPUAcceleration = true;
-    caps.supportsAdvancedEffects = (m_pBlurEffect != nullptr);
+    caps.supportsAdvancedEffects = (m_pDeviceContext != nullptr);
     caps.supportsAntialiasing = true;
     caps.supportsTransparency = true;
     caps.maxTextureSize = 16384;  // D2D typical limit
     return caps;
 }
 
+D2DRenderBackend::ResourceStats D2DRenderBackend::GetResourceStats() const {
+    ResourceStats stats;
+    stats.brushes = m_brushes.size();
+    stats.gradients = m_gradients.size();
+    stats.textFormats = m_textFormats.size();
+    stats.textLayouts = m_textLayouts.size();
+    stats.scratchBitmaps = m_scratchBitmaps.size();
+    stats.effects = std::count_if(std::begin(m_effects), std::end(m_effects),
+                                  [](ID2D1Effect* effect) { return effect != nullptr; });
+    stats.deviceResets = m_deviceResets;
+    stats.fallbackReadbacks = m_fallbackReadbacks;
+    return stats;
+}
+
 } // namespace SDK
@@ -1,4 +1,5 @@
 #include "SDK/DPIManager.h"
+#include "SDK/MonitorManager.h"
 #include <ShellScalingApi.h>
 #include <algorithm>
 
@@ -50,6 +51,7 @@ bool DPIManager::Initialize(DPIAwareness awareness) {
 
 void DPIManager::Shutdown() {
     m_windowDPICache.clear();
+    m_themeMetrics.clear();
     m_dpiChangeCallbacks.clear();
     m_initialized = false;
 }
@@ -172,6 +174,13 @@ DPIScaleInfo DPIManager::GetDPIForMonitor(HMONITOR hMonitor) const {
         return m_systemDPI;
     }
     
+    // Known monitors keep the DPI read when the layout was last enumerated
+    const MonitorTopology& topology = MonitorManager::GetInstance().GetTopology();
+    const MonitorTopology::Monitor* monitor = topology.Get(topology.FromHandle(hMonitor));
+    if (monitor) {
+        return CalculateDPIScaleInfo(monitor->dpi);
+    }
+    
     UINT dpiX = 96;
     UINT dpiY = 96;
     
@@ -310,6 +319,49 @@ void DPIManager::UnregisterDPIChangeCallback(HWND hwnd) {
     m_dpiChangeCallbacks.erase(hwnd);
 }
 
+bool ThemeMetrics::Source::operator==(const Source& other) const {
+    return titleBarHeight == other.titleBarHeight && borderWidth == other.borderWidth &&
+           cornerRadius == other.cornerRadius && shadowOffsetX == other.shadowOffsetX &&
+           shadowOffsetY == other.shadowOffsetY && shadowBlur == other.shadowBlur;
+}
+
+ThemeMetrics::Source ThemeMetrics::SourceOf(const Theme& theme) {
+    Source source;
+    source.titleBarHeight = theme.GetTitleBarHeight();
+    source.borderWidth = theme.GetBorderWidth();
+    source.cornerRadius = theme.GetCornerRadius();
+    theme.GetShadowOffset(source.shadowOffsetX, source.shadowOffsetY);
+    source.shadowBlur = theme.GetShadowBlur();
+    return source;
+}
+
+std::shared_ptr<const ThemeMetrics> DPIManager::GetThemeMetrics(const Theme& theme, UINT dpi) {
+    // Few themes are shown at few DPIs, so a short list does
+    static constexpr size_t MAX_THEME_METRICS = 32;
+    
+    ThemeMetrics::Source source = ThemeMetrics::SourceOf(theme);
+    for (const auto& metrics : m_themeMetrics) {
+        if (metrics->dpi == dpi && metrics->source == source) return metrics;
+    }
+    
+    auto metrics = std::make_shared<ThemeMetrics>();
+    metrics->dpi = dpi;
+    metrics->source = source;
+    metrics->titleBarHeight = MulDiv(source.titleBarHeight, dpi, 96);
+    metrics->borderWidth = source.borderWidth > 0 ? std::max(1, MulDiv(source.borderWidth, dpi, 96)) : 0;
+    metrics->cornerRadius = MulDiv(source.cornerRadius, dpi, 96);
+    metrics->shadowOffsetX = MulDiv(source.shadowOffsetX, dpi, 96);
+    metrics->shadowOffsetY = MulDiv(source.shadowOffsetY, dpi, 96);
+    metrics->shadowBlur = MulDiv(source.shadowBlur, dpi, 96);
+    
+    // Drop the oldest set; windows still holding it keep it alive
+    if (m_themeMetrics.size() >= MAX_THEME_METRICS) {
+        m_themeMetrics.erase(m_themeMetrics.begin());
+    }
+    m_themeMetrics.push_back(metrics);
+    return metrics;
+}
+
 void DPIManager::HandleDPIChange(HWND hwnd, WPARAM wParam, LPARAM lParam) {
     if (!hwnd) {
         return;
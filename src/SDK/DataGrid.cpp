@@ -1,19 +1,212 @@
 #include "../../include/SDK/DataGrid.h"
 #include "../../include/SDK/Renderer.h"
+#include "../../include/SDK/JobScheduler.h"
+#include "../../include/SDK/DelimitedFile.h"
+#include "../../include/SDK/UpdateScheduler.h"
 #include <algorithm>
 #include <map>
+#include <cstring>
+#include <cwchar>
+#include <iterator>
+#include <numeric>
 
 namespace SDK {
 
+namespace {
+    // Key for cells that don't parse as the column type; sorts last either way
+    constexpr uint64_t INVALID_SORT_KEY = UINT64_MAX;
+    
+    // Live updates that move rows beyond this many re-sort the view once instead
+    constexpr size_t LIVE_REORDER_BATCH = 64;
+    
+    inline uint64_t CellKey(int row, int column) {
+        return ((uint64_t)(uint32_t)row << 32) | (uint32_t)column;
+    }
+    
+    // Below these sizes a plain comparison sort is faster
+    constexpr size_t RADIX_SORT_THRESHOLD = 2048;
+    constexpr size_t PARALLEL_SORT_THRESHOLD = 100000;
+    
+    // Maps values to unsigned keys whose integer order matches the value order
+    inline uint64_t OrderedKey(int64_t value) {
+        return (uint64_t)value ^ 0x8000000000000000ull;
+    }
+    
+    inline uint64_t OrderedKey(double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return (bits & 0x8000000000000000ull) ? ~bits : (bits | 0x8000000000000000ull);
+    }
+    
+    // Copies the number out of a cell, dropping surrounding blanks and
+    // thousands separators ("1,234.5")
+    bool ExtractNumber(const std::wstring& text, std::wstring& number) {
+        number.clear();
+        for (wchar_t ch : text) {
+            if (ch == L',' || ch == L' ' || ch == L'\t') continue;
+            number += ch;
+        }
+        return !number.empty();
+    }
+    
+    bool ParseInteger(const std::wstring& text, int64_t& value) {
+        std::wstring number;
+        if (!ExtractNumber(text, number)) return false;
+        wchar_t* end = nullptr;
+        value = (int64_t)std::wcstoll(number.c_str(), &end, 10);
+        return end && *end == L'\0';
+    }
+    
+    bool ParseDouble(const std::wstring& text, double& value) {
+        std::wstring number;
+        if (!ExtractNumber(text, number)) return false;
+        wchar_t* end = nullptr;
+        value = std::wcstod(number.c_str(), &end);
+        return end && *end == L'\0' && value == value;   // Rejects NaN
+    }
+    
+    // Days since 1970-01-01 for a proleptic Gregorian date
+    int64_t DaysFromCivil(int64_t year, int month, int day) {
+        year -= month <= 2;
+        int64_t era = (year >= 0 ? year : year - 399) / 400;
+        int64_t yearOfEra = year - era * 400;
+        int64_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+        return era * 146097 + dayOfEra - 719468;
+    }
+    
+    int DaysInMonth(int64_t year, int month) {
+        static const int DAYS[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+        bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+        return (month == 2 && leap) ? 29 : DAYS[month - 1];
+    }
+    
+    bool ParseTimestamp(const std::wstring& text, int64_t& seconds) {
+        // %n is only stored once everything before it matched, so end equals
+        // the length only when one of the forms spans the whole cell
+        const int length = (int)text.size();
+        int year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0;
+        int end = -1;
+        swscanf(text.c_str(), L" %d-%d-%d%*1[ T]%d:%d:%d %n", &year, &month, &day, &hour, &minute, &second, &end);
+        if (end != length) {
+            end = -1;
+            second = 0;
+            swscanf(text.c_str(), L" %d-%d-%d%*1[ T]%d:%d %n", &year, &month, &day, &hour, &minute, &end);
+        }
+        if (end != length) {
+            end = -1;
+            hour = minute = 0;
+            swscanf(text.c_str(), L" %d-%d-%d %n", &year, &month, &day, &end);
+        }
+        if (end != length) return ParseInteger(text, seconds);
+        
+        // Anything that reads as a date but isn't one sorts as text
+        if (month < 1 || month > 12 || day < 1 || day > DaysInMonth(year, month)) return false;
+        if (hour < 0 || hour > 23 || minute < 0 || minute > 59 || second < 0 || second > 60) return false;
+        seconds = DaysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+        return true;
+    }
+    
+    // Stable LSD radix sort of (key, row) pairs on 16-bit digits; digits that
+    // are equal across all keys are skipped, so small integers take one pass
+    void RadixSort(std::vector<std::pair<uint64_t, int>>& items) {
+        std::vector<std::pair<uint64_t, int>> scratch(items.size());
+        std::vector<size_t> counts(65536);
+        
+        for (int shift = 0; shift < 64; shift += 16) {
+            std::fill(counts.begin(), counts.end(), 0);
+            for (const auto& item : items) {
+                counts[(item.first >> shift) & 0xFFFF]++;
+            }
+            if (counts[(items[0].first >> shift) & 0xFFFF] == items.size()) continue;
+            
+            size_t offset = 0;
+            for (auto& count : counts) {
+                size_t bucket = count;
+                count = offset;
+                offset += bucket;
+            }
+            for (const auto& item : items) {
+                scratch[counts[(item.first >> shift) & 0xFFFF]++] = item;
+            }
+            items.swap(scratch);
+        }
+    }
+    
+    // Packs three characters into one trigram key
+    inline uint64_t TrigramKey(const wchar_t* text) {
+        return ((uint64_t)(text[0] & 0x1FFFFF) << 42) | ((uint64_t)(text[1] & 0x1FFFFF) << 21) | (uint64_t)(text[2] & 0x1FFFFF);
+    }
+    
+    // Distinct trigrams of text, sorted
+    std::vector<uint64_t> Trigrams(const std::wstring& text) {
+        std::vector<uint64_t> keys;
+        for (size_t i = 0; i + 3 <= text.size(); i++) {
+            keys.push_back(TrigramKey(text.c_str() + i));
+        }
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        return keys;
+    }
+    
+    void SortedInsert(std::vector<int>& rows, int row) {
+        auto it = std::lower_bound(rows.begin(), rows.end(), row);
+        if (it == rows.end() || *it != row) rows.insert(it, row);
+    }
+    
+    void SortedErase(std::vector<int>& rows, int row) {
+        auto it = std::lower_bound(rows.begin(), rows.end(), row);
+        if (it != rows.end() && *it == row) rows.erase(it);
+    }
+    
+    // Sorts chunks on JobScheduler workers, then merges them pairwise
+    template<typename Compare>
+    void ParallelSort(std::vector<int>& items, Compare compare) {
+        unsigned threadCount = std::min(JobScheduler::GetWorkerCount() + 1, 8u);
+        if (threadCount < 2 || items.size() < PARALLEL_SORT_THRESHOLD) {
+            std::sort(items.begin(), items.end(), compare);
+            return;
+        }
+        
+        size_t chunkSize = (items.size() + threadCount - 1) / threadCount;
+        std::vector<size_t> bounds;
+        for (unsigned i = 0; i <= threadCount; i++) {
+            bounds.push_back(std::min(i * chunkSize, items.size()));
+        }
+        
+        JobScheduler::ParallelFor((int)threadCount, 1, [&](int begin, int end) {
+            for (int i = begin; i < end; i++) {
+                std::sort(items.begin() + bounds[i], items.begin() + bounds[i + 1], compare);
+            }
+        }, "DataGridSort");
+        
+        for (size_t width = 1; width < threadCount; width *= 2) {
+            for (size_t i = 0; i + width < threadCount; i += 2 * width) {
+                size_t last = std::min(i + 2 * width, (size_t)threadCount);
+                std::inplace_merge(items.begin() + bounds[i], items.begin() + bounds[i + width],
+                                   items.begin() + bounds[last], compare);
+            }
+        }
+    }
+}
+
 DataGrid::DataGrid()
     : Widget()
+    , m_updateDepth(0)
+    , m_refreshPending(false)
+    , m_viewActive(false)
     , m_sortColumn(-1)
     , m_sortOrder(SortOrder::NONE)
+    , m_sortKeyColumn(-1)
+    , m_sortKeyType(ColumnType::STRING)
     , m_selectionMode(SelectionMode::SINGLE)
     , m_hoveredRow(-1)
     , m_hoveredColumn(-1)
     , m_editingRow(-1)
     , m_editingColumn(-1)
+    , m_columnOffsetsDirty(true)
+    , m_frozenColumns(0)
+    , m_scrollX(0)
     , m_virtualScrolling(false)
     , m_visibleRowCount(20)
     , m_firstVisibleRow(0)
@@ -24,27 +217,53 @@ DataGrid::DataGrid()
     , m_headerColor(240, 240, 240, 255)
     , m_alternateRowColor(250, 250, 250, 255)
     , m_selectionColor(200, 220, 255, 255)
+    , m_cellUpdates(nullptr)
+#if SDK_PLATFORM_WINDOWS
+    , m_uiThreadId(GetCurrentThreadId())
+#endif
+    , m_liveUpdates(false)
+    , m_flashColor(255, 230, 120, 255)
+    , m_flashDuration(0.0f)
 {
     m_width = 600;
     m_height = 400;
 }
 
 DataGrid::~DataGrid() {
+    CellUpdate* update = m_cellUpdates.exchange(nullptr);
+    while (update) {
+        CellUpdate* next = update->next;
+        delete update;
+        update = next;
+    }
 }
 
 // Column management
 void DataGrid::AddColumn(const std::wstring& header, int width) {
     Column col(header, width);
     m_columns.push_back(col);
+    InvalidateColumnOffsets();
 }
 
 void DataGrid::AddColumn(const Column& column) {
     m_columns.push_back(column);
+    InvalidateColumnOffsets();
 }
 
 void DataGrid::RemoveColumn(int index) {
     if (index >= 0 && index < (int)m_columns.size()) {
         m_columns.erase(m_columns.begin() + index);
+        InvalidateColumnOffsets();
+        InvalidateSortKeys();
+        
+        // Indexes of later columns shift down by one
+        std::map<int, FilterIndex> indexes;
+        for (auto& entry : m_filterIndexes) {
+            if (entry.first != index) {
+                indexes[entry.first > index ? entry.first - 1 : entry.first] = FilterIndex();
+            }
+        }
+        m_filterIndexes.swap(indexes);
         
         // Remove cells from all rows
         for (auto& row : m_rows) {
@@ -57,12 +276,16 @@ void DataGrid::RemoveColumn(int index) {
 
 void DataGrid::ClearColumns() {
     m_columns.clear();
+    InvalidateColumnOffsets();
+    m_scrollX = 0;
     ClearRows();
 }
 
 void DataGrid::SetColumnWidth(int columnIndex, int width) {
-    if (columnIndex >= 0 && columnIndex < (int)m_columns.size()) {
+    if (columnIndex >= 0 && columnIndex < (int)m_columns.size() && m_columns[columnIndex].width != width) {
         m_columns[columnIndex].width = width;
+        InvalidateColumnOffsets();
+        Invalidate();
     }
 }
 
@@ -78,24 +301,71 @@ void DataGrid::SetColumnEditable(int columnIndex, bool editable) {
     }
 }
 
+void DataGrid::SetColumnFilterIndexed(int columnIndex, bool indexed) {
+    if (columnIndex < 0 || columnIndex >= (int)m_columns.size()) return;
+    
+    // Built lazily by the first filter that can use it
+    if (indexed) {
+        m_filterIndexes.emplace(columnIndex, FilterIndex());
+    } else {
+        m_filterIndexes.erase(columnIndex);
+    }
+}
+
+void DataGrid::SetColumnType(int columnIndex, ColumnType type) {
+    if (columnIndex >= 0 && columnIndex < (int)m_columns.size() && m_columns[columnIndex].type != type) {
+        m_columns[columnIndex].type = type;
+        
+        if (columnIndex == m_sortColumn && IsSorted()) {
+            ApplyFilter();
+            Invalidate();
+        }
+    }
+}
+
 // Row management
 void DataGrid::AddRow(const std::vector<std::wstring>& values) {
     Row row;
+    row.cells.reserve(values.size());
     for (const auto& value : values) {
         row.cells.push_back(Cell(value));
     }
-    m_rows.push_back(row);
-    
-    if (IsFiltered()) {
-        ApplyFilter();
+    AddRow(std::move(row));
+}
+
+void DataGrid::AddRow(std::vector<std::wstring>&& values) {
+    Row row;
+    row.cells.reserve(values.size());
+    for (auto& value : values) {
+        row.cells.push_back(Cell(std::move(value)));
     }
+    AddRow(std::move(row));
 }
 
 void DataGrid::AddRow(const Row& row) {
-    m_rows.push_back(row);
+    AddRow(Row(row));
+}
+
+void DataGrid::AddRow(Row&& row) {
+    m_rows.push_back(std::move(row));
+    int sourceRow = (int)m_rows.size() - 1;
+    const Row& added = m_rows.back();
     
-    if (IsFiltered()) {
-        ApplyFilter();
+    if (m_sortKeyColumn >= 0 && m_sortKeyType != ColumnType::STRING) {
+        m_sortKeys.push_back(MakeSortKey(sourceRow, m_sortKeyColumn));
+    }
+    
+    // The new row has the highest index, so it appends to every posting list
+    for (auto& entry : m_filterIndexes) {
+        if (!entry.second.stale && entry.first < (int)added.cells.size()) {
+            for (uint64_t key : Trigrams(added.cells[entry.first].value)) {
+                entry.second.postings[key].push_back(sourceRow);
+            }
+        }
+    }
+    
+    if (m_viewActive && !m_cellValueProvider) {
+        InsertIntoView(sourceRow);
     }
 }
 
@@ -107,8 +377,18 @@ void DataGrid::InsertRow(int index, const std::vector<std::wstring>& values) {
         }
         m_rows.insert(m_rows.begin() + index, row);
         
-        if (IsFiltered()) {
-            ApplyFilter();
+        if (m_sortKeyColumn >= 0 && m_sortKeyType != ColumnType::STRING) {
+            m_sortKeys.insert(m_sortKeys.begin() + index, MakeSortKey(index, m_sortKeyColumn));
+        }
+        ShiftFlashes(index, 1);
+        MarkFilterIndexesStale();
+        
+        // Later rows shift down; only the new row needs testing
+        if (m_viewActive) {
+            for (int& sourceRow : m_viewRows) {
+                if (sourceRow >= index) sourceRow++;
+            }
+            InsertIntoView(index);
         }
     }
 }
@@ -117,31 +397,347 @@ void DataGrid::RemoveRow(int index) {
     if (index >= 0 && index < (int)m_rows.size()) {
         m_rows.erase(m_rows.begin() + index);
         
-        if (IsFiltered()) {
-            ApplyFilter();
+        if (m_sortKeyColumn >= 0 && m_sortKeyType != ColumnType::STRING) {
+            m_sortKeys.erase(m_sortKeys.begin() + index);
+        }
+        ShiftFlashes(index, -1);
+        MarkFilterIndexesStale();
+        
+        if (m_viewActive) {
+            m_viewRows.erase(std::remove(m_viewRows.begin(), m_viewRows.end(), index), m_viewRows.end());
+            for (int& sourceRow : m_viewRows) {
+                if (sourceRow > index) sourceRow--;
+            }
         }
     }
 }
 
 void DataGrid::ClearRows() {
     m_rows.clear();
-    m_filteredRows.clear();
+    m_flashes.clear();
+    InvalidateSortKeys();
+    MarkFilterIndexesStale();
+    ApplyFilter();
+}
+
+int DataGrid::GetRowCount() const {
+    return GetSourceRowCount();
+}
+
+void DataGrid::ReserveRows(int count) {
+    if (count <= 0) return;
+    m_rows.reserve(count);
+    if (m_sortKeyColumn >= 0 && m_sortKeyType != ColumnType::STRING) {
+        m_sortKeys.reserve(count);
+    }
+}
+
+void DataGrid::SetRows(std::vector<Row>&& rows) {
+    m_rows = std::move(rows);
+    RefreshData();
+}
+
+void DataGrid::EndUpdate() {
+    if (m_updateDepth == 0 || --m_updateDepth > 0) return;
+    
+    if (m_refreshPending) {
+        m_refreshPending = false;
+        ApplyFilter();
+        ScrollToRow(std::min(m_firstVisibleRow, std::max(GetDisplayRowCount() - 1, 0)));
+    }
+    Invalidate();
+}
+
+// Data provider
+void DataGrid::SetDataProvider(RowCountProvider rowCount, CellValueProvider cellValue) {
+    m_rowCountProvider = rowCount;
+    m_cellValueProvider = cellValue;
+    m_providerSelection.clear();
+    RefreshData();
+}
+
+void DataGrid::ClearDataProvider() {
+    m_rowCountProvider = nullptr;
+    m_cellValueProvider = nullptr;
+    m_providerSelection.clear();
+    RefreshData();
+}
+
+void DataGrid::RefreshData() {
+    if (m_editingRow >= 0) {
+        CancelEdit();
+    }
+    
+    int count = GetSourceRowCount();
+    for (auto it = m_providerSelection.begin(); it != m_providerSelection.end();) {
+        it = (*it >= count) ? m_providerSelection.erase(it) : std::next(it);
+    }
+    
+    m_flashes.clear();
+    InvalidateSortKeys();
+    MarkFilterIndexesStale();
+    ApplyFilter();
+    ScrollToRow(std::min(m_firstVisibleRow, std::max(GetDisplayRowCount() - 1, 0)));
+    Invalidate();
+}
+
+bool DataGrid::LoadDelimitedFile(const std::wstring& path, wchar_t delimiter, bool hasHeader) {
+    auto file = std::make_shared<DelimitedFile>();
+    if (!file->Open(path, delimiter, hasHeader)) return false;
+    
+    // Column indexes of the old layout mean nothing here
+    m_columns.clear();
+    m_scrollX = 0;
+    m_filterIndexes.clear();
+    m_filterText.clear();
+    m_columnFilters.clear();
+    m_sortColumn = -1;
+    m_sortOrder = SortOrder::NONE;
+    InvalidateSortKeys();
+    for (int column = 0; column < file->GetColumnCount(); column++) {
+        std::wstring header = file->GetColumnName(column);
+        AddColumn(header.empty() ? L"Column " + std::to_wstring(column + 1) : header);
+    }
+    
+    SetDataProvider([file]() { return file->GetRowCount(); },
+                    [file](int row, int column) { return file->GetCell(row, column); });
+    return true;
+}
+
+int DataGrid::GetDisplayRowCount() const {
+    return m_viewActive ? static_cast<int>(m_viewRows.size()) : GetSourceRowCount();
+}
+
+int DataGrid::GetSourceRowIndex(int displayRow) const {
+    if (displayRow < 0 || displayRow >= GetDisplayRowCount()) return -1;
+    return m_viewActive ? m_viewRows[displayRow] : displayRow;
+}
+
+int DataGrid::GetSourceRowCount() const {
+    if (m_cellValueProvider) {
+        return m_rowCountProvider ? std::max(m_rowCountProvider(), 0) : 0;
+    }
+    return static_cast<int>(m_rows.size());
+}
+
+int DataGrid::GetSourceCellCount(int sourceRow) const {
+    if (m_cellValueProvider) {
+        return static_cast<int>(m_columns.size());
+    }
+    return static_cast<int>(m_rows[sourceRow].cells.size());
+}
+
+std::wstring DataGrid::GetSourceCellText(int sourceRow, int column) const {
+    if (m_cellValueProvider) {
+        return m_cellValueProvider(sourceRow, column);
+    }
+    const auto& cells = m_rows[sourceRow].cells;
+    return column < (int)cells.size() ? cells[column].value : std::wstring();
+}
+
+bool DataGrid::IsSourceRowSelected(int sourceRow) const {
+    if (m_cellValueProvider) {
+        return m_providerSelection.count(sourceRow) != 0;
+    }
+    return m_rows[sourceRow].selected;
+}
+
+void DataGrid::SetSourceRowSelected(int sourceRow, bool selected) {
+    if (m_cellValueProvider) {
+        if (selected) {
+            m_providerSelection.insert(sourceRow);
+        } else {
+            m_providerSelection.erase(sourceRow);
+        }
+    } else {
+        m_rows[sourceRow].selected = selected;
+    }
 }
 
 // Cell access
 void DataGrid::SetCellValue(int row, int column, const std::wstring& value) {
-    if (row >= 0 && row < (int)m_rows.size() && column >= 0 && column < (int)m_rows[row].cells.size()) {
-        m_rows[row].cells[column].value = value;
+    bool moved = false;
+    if (StoreCellValue(row, column, value, moved)) {
+        Invalidate();
+    }
+}
+
+bool DataGrid::StoreCellValue(int row, int column, std::wstring value, bool& moved) {
+    if (row < 0 || row >= (int)m_rows.size() || column < 0 || column >= (int)m_rows[row].cells.size()) {
+        return false;
+    }
+    std::wstring& cell = m_rows[row].cells[column].value;
+    if (cell == value) return false;
+    
+    std::wstring oldValue = std::move(cell);
+    cell = std::move(value);
+    UpdateFilterIndexes(row, column, oldValue, cell);
+    
+    if (column == m_sortKeyColumn && m_sortKeyType != ColumnType::STRING) {
+        m_sortKeys[row] = MakeSortKey(row, m_sortKeyColumn);
+    }
+    
+    // Move just this row within the view instead of re-sorting everything;
+    // other columns can't change its place. Inside BeginUpdate the view is
+    // rebuilt once at EndUpdate instead.
+    if (m_viewActive && (IsFiltered() || (IsSorted() && column == m_sortColumn))) {
+        moved = true;
+        if (m_updateDepth > 0) {
+            m_refreshPending = true;
+            return true;
+        }
+        auto it = std::find(m_viewRows.begin(), m_viewRows.end(), row);
+        if (it != m_viewRows.end()) {
+            m_viewRows.erase(it);
+        }
+        InsertIntoView(row);
+    }
+    return true;
+}
+
+void DataGrid::SetLiveUpdatesEnabled(bool enabled) {
+    m_liveUpdates = enabled;
+    if (enabled) ScheduleUpdate();
+}
+
+void DataGrid::PostCellUpdate(int row, int column, std::wstring value) {
+    CellUpdate* update = new CellUpdate{ nullptr, row, column, std::move(value) };
+    update->next = m_cellUpdates.load(std::memory_order_relaxed);
+    while (!m_cellUpdates.compare_exchange_weak(update->next, update, std::memory_order_release,
+                                                std::memory_order_relaxed)) {
+    }
+    
+    // Only the first update of a batch wakes the grid; Update takes the
+    // whole queue, so later ones find it non-empty until then
+    if (!update->next) {
+        UpdateScheduler::RequestWake(this);
+#if SDK_PLATFORM_WINDOWS
+        PostThreadMessageW(m_uiThreadId, WM_NULL, 0, 0);   // Ends an idle MsgWaitForMultipleObjects
+#endif
+    }
+}
+
+int DataGrid::ApplyCellUpdates() {
+    CellUpdate* head = m_cellUpdates.exchange(nullptr, std::memory_order_acquire);
+    if (!head) return 0;
+    
+    // Newest first, so the first update seen for a cell is the one kept;
+    // applying oldest first keeps posting order between cells
+    std::vector<CellUpdate*> latest;
+    std::unordered_set<uint64_t> seen;
+    for (CellUpdate* update = head; update; update = update->next) {
+        if (seen.insert(CellKey(update->row, update->column)).second) {
+            latest.push_back(update);
+        }
+    }
+    std::reverse(latest.begin(), latest.end());
+    
+    // Owned cells only; a provider's rows live elsewhere
+    std::vector<uint64_t> changed;
+    if (!m_cellValueProvider) {
+        size_t reorders = 0;
+        for (CellUpdate* update : latest) {
+            if (m_viewActive && (IsFiltered() || (IsSorted() && update->column == m_sortColumn))) reorders++;
+        }
+        bool batch = reorders > LIVE_REORDER_BATCH;
+        if (batch) BeginUpdate();
         
-        if (IsFiltered()) {
-            ApplyFilter();
+        bool moved = false;
+        for (CellUpdate* update : latest) {
+            if (StoreCellValue(update->row, update->column, std::move(update->value), moved)) {
+                changed.push_back(CellKey(update->row, update->column));
+            }
+        }
+        if (batch) EndUpdate();
+        
+        if (m_flashDuration > 0.0f) {
+            for (uint64_t cell : changed) {
+                m_flashes[cell] = m_flashDuration;
+            }
+            if (!changed.empty()) ScheduleUpdate();
+        }
+        if (moved) {
+            Invalidate();
+        } else if (!batch) {
+            InvalidateCells(changed);
+        }
+    }
+    
+    while (head) {
+        CellUpdate* next = head->next;
+        delete head;
+        head = next;
+    }
+    return (int)changed.size();
+}
+
+void DataGrid::SetChangeFlash(Color color, float duration) {
+    m_flashColor = color;
+    m_flashDuration = std::max(duration, 0.0f);
+    if (m_flashDuration == 0.0f && !m_flashes.empty()) {
+        m_flashes.clear();
+        Invalidate();
+    }
+}
+
+void DataGrid::InvalidateCells(const std::vector<uint64_t>& cells) {
+    if (cells.empty()) return;
+    
+    // Source row -> display row for the rows in the viewport
+    int rowCount = GetDisplayRowCount();
+    int startRow = std::min(std::max(m_firstVisibleRow, 0), rowCount);
+    int endRow = std::min(startRow + m_visibleRowCount + 1, rowCount);
+    std::unordered_map<int, int> visible;
+    for (int i = startRow; i < endRow; i++) {
+        visible[GetSourceRowIndex(i)] = i;
+    }
+    
+    for (uint64_t cell : cells) {
+        auto it = visible.find((int)(cell >> 32));
+        RECT rect;
+        if (it != visible.end() && GetCellRect(it->second, (int)(uint32_t)cell, rect)) {
+            InvalidateRegion(rect);
+        }
+    }
+}
+
+void DataGrid::UpdateFlashes(float deltaTime) {
+    std::vector<uint64_t> cells;
+    cells.reserve(m_flashes.size());
+    for (auto it = m_flashes.begin(); it != m_flashes.end();) {
+        cells.push_back(it->first);
+        it->second -= deltaTime;
+        it = it->second <= 0.0f ? m_flashes.erase(it) : std::next(it);
+    }
+    InvalidateCells(cells);
+}
+
+void DataGrid::ShiftFlashes(int index, int delta) {
+    if (m_flashes.empty()) return;
+    
+    std::unordered_map<uint64_t, float> shifted;
+    shifted.reserve(m_flashes.size());
+    for (const auto& flash : m_flashes) {
+        int row = (int)(flash.first >> 32);
+        int column = (int)(uint32_t)flash.first;
+        if (row < index) {
+            shifted.emplace(flash.first, flash.second);
+        } else if (delta > 0 || row > index) {
+            shifted.emplace(CellKey(row + delta, column), flash.second);
         }
     }
+    m_flashes.swap(shifted);
+}
+
+float DataGrid::GetFlash(int sourceRow, int column) const {
+    if (m_flashes.empty()) return 0.0f;
+    auto it = m_flashes.find(CellKey(sourceRow, column));
+    return it != m_flashes.end() ? it->second / m_flashDuration : 0.0f;
 }
 
 std::wstring DataGrid::GetCellValue(int row, int column) const {
-    if (row >= 0 && row < (int)m_rows.size() && column >= 0 && column < (int)m_rows[row].cells.size()) {
-        return m_rows[row].cells[column].value;
+    if (row >= 0 && row < GetSourceRowCount() && column >= 0 && column < GetSourceCellCount(row)) {
+        return GetSourceCellText(row, column);
     }
     return L"";
 }
@@ -162,7 +758,8 @@ void DataGrid::SortByColumn(int columnIndex, SortOrder order) {
     m_sortColumn = columnIndex;
     m_sortOrder = order;
     
-    ApplySorting();
+    ApplyFilter();
+    Invalidate();
     
     if (m_sortCallback) {
         m_sortCallback(columnIndex, order);
@@ -188,37 +785,168 @@ void DataGrid::ToggleSort(int columnIndex) {
         m_sortOrder = SortOrder::ASCENDING;
     }
     
-    if (m_sortOrder != SortOrder::NONE) {
-        ApplySorting();
-    }
+    // NONE goes back to source order
+    ApplyFilter();
+    Invalidate();
     
     if (m_sortCallback) {
         m_sortCallback(columnIndex, m_sortOrder);
     }
 }
 
+void DataGrid::EnsureSortKeys() {
+    ColumnType type = m_columns[m_sortColumn].type;
+    int count = GetSourceRowCount();
+    if (m_sortKeyColumn == m_sortColumn && m_sortKeyType == type) {
+        size_t cached = (type != ColumnType::STRING) ? m_sortKeys.size() : (m_cellValueProvider ? m_sortText.size() : (size_t)count);
+        if (cached == (size_t)count) return;
+    }
+    
+    m_sortKeys.clear();
+    m_sortText.clear();
+    if (type != ColumnType::STRING) {
+        m_sortKeys.resize(count);
+        for (int i = 0; i < count; i++) {
+            m_sortKeys[i] = MakeSortKey(i, m_sortColumn);
+        }
+    } else if (m_cellValueProvider) {
+        // Owned string cells are compared in place; provider text is fetched once
+        m_sortText.resize(count);
+        for (int i = 0; i < count; i++) {
+            m_sortText[i] = m_cellValueProvider(i, m_sortColumn);
+        }
+    }
+    
+    m_sortKeyColumn = m_sortColumn;
+    m_sortKeyType = type;
+}
+
+uint64_t DataGrid::MakeSortKey(int sourceRow, int column) const {
+    if (column < 0 || column >= GetSourceCellCount(sourceRow)) return INVALID_SORT_KEY;
+    
+    std::wstring text = GetSourceCellText(sourceRow, column);
+    int64_t integer = 0;
+    double real = 0.0;
+    uint64_t key;
+    switch (m_columns[column].type) {
+        case ColumnType::INTEGER:
+            if (!ParseInteger(text, integer)) return INVALID_SORT_KEY;
+            key = OrderedKey(integer);
+            break;
+        case ColumnType::DOUBLE:
+            if (!ParseDouble(text, real)) return INVALID_SORT_KEY;
+            key = OrderedKey(real);
+            break;
+        case ColumnType::TIMESTAMP:
+            if (!ParseTimestamp(text, integer)) return INVALID_SORT_KEY;
+            key = OrderedKey(integer);
+            break;
+        default:
+            return INVALID_SORT_KEY;
+    }
+    
+    // Keep INVALID_SORT_KEY unique to unparsed cells
+    return std::min(key, INVALID_SORT_KEY - 1);
+}
+
+bool DataGrid::SortsBefore(int sourceRowA, int sourceRowB) const {
+    const bool ascending = m_sortOrder == SortOrder::ASCENDING;
+    
+    if (m_sortKeyType != ColumnType::STRING) {
+        uint64_t a = m_sortKeys[sourceRowA];
+        uint64_t b = m_sortKeys[sourceRowB];
+        if (a != b) {
+            if (a == INVALID_SORT_KEY || b == INVALID_SORT_KEY) return b == INVALID_SORT_KEY;
+            return ascending ? a < b : b < a;
+        }
+        if (a != INVALID_SORT_KEY) return sourceRowA < sourceRowB;
+        // Cells that don't parse trail the rest, ordered by their text
+    }
+    
+    int order;
+    if (!m_sortText.empty()) {
+        order = m_sortText[sourceRowA].compare(m_sortText[sourceRowB]);
+    } else if (m_cellValueProvider) {
+        order = m_cellValueProvider(sourceRowA, m_sortColumn).compare(m_cellValueProvider(sourceRowB, m_sortColumn));
+    } else {
+        // Rows without the column sort as empty
+        static const std::wstring empty;
+        const auto& cellsA = m_rows[sourceRowA].cells;
+        const auto& cellsB = m_rows[sourceRowB].cells;
+        const std::wstring& a = m_sortColumn < (int)cellsA.size() ? cellsA[m_sortColumn].value : empty;
+        const std::wstring& b = m_sortColumn < (int)cellsB.size() ? cellsB[m_sortColumn].value : empty;
+        order = a.compare(b);
+    }
+    if (order != 0) {
+        return ascending ? order < 0 : order > 0;
+    }
+    // Ties keep source order, which makes the order total and stable
+    return sourceRowA < sourceRowB;
+}
+
 void DataGrid::ApplySorting() {
-    if (m_sortColumn < 0 || m_sortOrder == SortOrder::NONE) return;
+    if (!IsSorted() || m_sortColumn >= (int)m_columns.size()) return;
     
-    auto& rows = GetDisplayRows();
+    if (!m_viewActive) {
+        m_viewRows.resize(GetSourceRowCount());
+        std::iota(m_viewRows.begin(), m_viewRows.end(), 0);
+        m_viewActive = true;
+    }
+    EnsureSortKeys();
     
-    std::sort(rows.begin(), rows.end(), [this](const Row& a, const Row& b) {
-        if (m_sortColumn >= (int)a.cells.size() || m_sortColumn >= (int)b.cells.size()) {
-            return false;
+    auto compare = [this](int a, int b) { return SortsBefore(a, b); };
+    
+    if (m_sortKeyType != ColumnType::STRING && m_viewRows.size() >= RADIX_SORT_THRESHOLD) {
+        // The view arrives in source order, so the stable radix sort breaks
+        // ties by source row exactly like SortsBefore
+        const bool ascending = m_sortOrder == SortOrder::ASCENDING;
+        std::vector<std::pair<uint64_t, int>> keyed;
+        keyed.reserve(m_viewRows.size());
+        for (int sourceRow : m_viewRows) {
+            uint64_t key = m_sortKeys[sourceRow];
+            if (!ascending && key != INVALID_SORT_KEY) {
+                key = INVALID_SORT_KEY - 1 - key;
+            }
+            keyed.emplace_back(key, sourceRow);
+        }
+        RadixSort(keyed);
+        size_t parsed = keyed.size();
+        while (parsed > 0 && keyed[parsed - 1].first == INVALID_SORT_KEY) parsed--;
+        for (size_t i = 0; i < keyed.size(); i++) {
+            m_viewRows[i] = keyed[i].second;
         }
         
-        const std::wstring& aVal = a.cells[m_sortColumn].value;
-        const std::wstring& bVal = b.cells[m_sortColumn].value;
-        
-        bool result = aVal < bVal;
-        return m_sortOrder == SortOrder::ASCENDING ? result : !result;
-    });
+        // Unparsed cells all share one key; SortsBefore orders them by text
+        if (keyed.size() - parsed > 1) {
+            std::stable_sort(m_viewRows.begin() + parsed, m_viewRows.end(), compare);
+        }
+    } else {
+        ParallelSort(m_viewRows, compare);
+    }
+}
+
+void DataGrid::InsertIntoView(int sourceRow) {
+    if (m_updateDepth > 0) {
+        m_refreshPending = true;
+        return;
+    }
+    if (IsFiltered() && !RowMatchesFilter(sourceRow)) return;
+    
+    if (IsSorted()) {
+        EnsureSortKeys();
+        auto pos = std::lower_bound(m_viewRows.begin(), m_viewRows.end(), sourceRow,
+                                    [this](int a, int b) { return SortsBefore(a, b); });
+        m_viewRows.insert(pos, sourceRow);
+    } else {
+        m_viewRows.insert(std::lower_bound(m_viewRows.begin(), m_viewRows.end(), sourceRow), sourceRow);
+    }
 }
 
 // Filtering
 void DataGrid::SetFilter(const std::wstring& filterText) {
     m_filterText = filterText;
-    ApplyFilter();
+    UpdateFilter();
+    Invalidate();
 }
 
 void DataGrid::SetColumnFilter(int columnIndex, const std::wstring& filterText) {
@@ -228,107 +956,272 @@ void DataGrid::SetColumnFilter(int columnIndex, const std::wstring& filterText)
         } else {
             m_columnFilters[columnIndex] = filterText;
         }
-        ApplyFilter();
+        UpdateFilter();
+        Invalidate();
     }
 }
 
 void DataGrid::ClearFilter() {
     m_filterText.clear();
     m_columnFilters.clear();
-    m_filteredRows.clear();
+    ApplyFilter();
+    Invalidate();
 }
 
-void DataGrid::ApplyFilter() {
-    m_filteredRows.clear();
+bool DataGrid::RowMatchesFilter(int sourceRow) const {
+    // Only displayed columns take part, matching what the filter indexes cover
+    int cellCount = std::min(GetSourceCellCount(sourceRow), (int)m_columns.size());
+    auto contains = [&](int column, const std::wstring& text) {
+        if (m_cellValueProvider) {
+            return m_cellValueProvider(sourceRow, column).find(text) != std::wstring::npos;
+        }
+        return m_rows[sourceRow].cells[column].value.find(text) != std::wstring::npos;
+    };
     
-    if (m_filterText.empty() && m_columnFilters.empty()) {
+    // Check global filter
+    if (!m_filterText.empty()) {
+        bool foundInRow = false;
+        for (int column = 0; column < cellCount && !foundInRow; column++) {
+            foundInRow = contains(column, m_filterText);
+        }
+        if (!foundInRow) {
+            return false;
+        }
+    }
+    
+    // Check column filters
+    for (const auto& filter : m_columnFilters) {
+        if (filter.first < cellCount && !contains(filter.first, filter.second)) {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+void DataGrid::ApplyFilter() {
+    if (m_updateDepth > 0) {
+        // The view waits for EndUpdate, minus rows that no longer exist
+        int count = GetSourceRowCount();
+        m_viewRows.erase(std::remove_if(m_viewRows.begin(), m_viewRows.end(),
+                                        [count](int sourceRow) { return sourceRow >= count; }),
+                         m_viewRows.end());
+        m_refreshPending = true;
         return;
     }
     
-    for (const auto& row : m_rows) {
-        bool matches = true;
-        
-        // Check global filter
-        if (!m_filterText.empty()) {
-            bool foundInRow = false;
-            for (const auto& cell : row.cells) {
-                if (cell.value.find(m_filterText) != std::wstring::npos) {
-                    foundInRow = true;
-                    break;
+    m_viewRows.clear();
+    m_viewActive = false;
+    m_appliedFilterText = m_filterText;
+    m_appliedColumnFilters = m_columnFilters;
+    
+    if (IsFiltered()) {
+        std::vector<int> candidates;
+        if (GatherFilterCandidates(candidates)) {
+            for (int sourceRow : candidates) {
+                if (RowMatchesFilter(sourceRow)) {
+                    m_viewRows.push_back(sourceRow);
                 }
             }
-            if (!foundInRow) {
-                matches = false;
+        } else {
+            int count = GetSourceRowCount();
+            for (int sourceRow = 0; sourceRow < count; sourceRow++) {
+                if (RowMatchesFilter(sourceRow)) {
+                    m_viewRows.push_back(sourceRow);
+                }
             }
         }
-        
-        // Check column filters
-        if (matches && !m_columnFilters.empty()) {
-            for (const auto& filter : m_columnFilters) {
-                int columnIndex = filter.first;
-                const std::wstring& filterText = filter.second;
-                
-                if (columnIndex < (int)row.cells.size()) {
-                    if (row.cells[columnIndex].value.find(filterText) == std::wstring::npos) {
-                        matches = false;
-                        break;
-                    }
-                }
+        m_viewActive = true;
+    }
+    
+    ApplySorting();
+}
+
+void DataGrid::UpdateFilter() {
+    if (m_updateDepth > 0 || !m_viewActive || !IsFilterNarrowing()) {
+        ApplyFilter();
+        return;
+    }
+    
+    // Every row the new filter accepts is already in the view, and dropping
+    // rows keeps the sort order intact
+    m_viewRows.erase(std::remove_if(m_viewRows.begin(), m_viewRows.end(),
+                                    [this](int sourceRow) { return !RowMatchesFilter(sourceRow); }),
+                     m_viewRows.end());
+    m_appliedFilterText = m_filterText;
+    m_appliedColumnFilters = m_columnFilters;
+}
+
+bool DataGrid::IsFilterNarrowing() const {
+    if (m_appliedFilterText.empty() && m_appliedColumnFilters.empty()) return false;
+    
+    // A cell containing the new text also contains any substring of it
+    if (m_filterText.find(m_appliedFilterText) == std::wstring::npos) return false;
+    for (const auto& applied : m_appliedColumnFilters) {
+        auto it = m_columnFilters.find(applied.first);
+        if (it == m_columnFilters.end() || it->second.find(applied.second) == std::wstring::npos) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void DataGrid::MarkFilterIndexesStale() {
+    for (auto& entry : m_filterIndexes) {
+        entry.second.postings.clear();
+        entry.second.stale = true;
+    }
+}
+
+void DataGrid::UpdateFilterIndexes(int sourceRow, int column, const std::wstring& oldText, const std::wstring& newText) {
+    auto it = m_filterIndexes.find(column);
+    if (it == m_filterIndexes.end() || it->second.stale) return;
+    
+    auto& postings = it->second.postings;
+    for (uint64_t key : Trigrams(oldText)) {
+        auto posting = postings.find(key);
+        if (posting == postings.end()) continue;
+        SortedErase(posting->second, sourceRow);
+        if (posting->second.empty()) postings.erase(posting);
+    }
+    for (uint64_t key : Trigrams(newText)) {
+        SortedInsert(postings[key], sourceRow);
+    }
+}
+
+DataGrid::FilterIndex& DataGrid::GetFilterIndex(int column) {
+    FilterIndex& index = m_filterIndexes[column];
+    if (index.stale) {
+        index.postings.clear();
+        int count = GetSourceRowCount();
+        for (int sourceRow = 0; sourceRow < count; sourceRow++) {
+            if (column >= GetSourceCellCount(sourceRow)) continue;
+            for (uint64_t key : Trigrams(GetSourceCellText(sourceRow, column))) {
+                index.postings[key].push_back(sourceRow);
             }
         }
-        
-        if (matches) {
-            m_filteredRows.push_back(row);
+        index.stale = false;
+    }
+    return index;
+}
+
+bool DataGrid::QueryFilterIndex(int column, const std::wstring& text, std::vector<int>& rows) {
+    if (text.size() < 3 || !IsColumnFilterIndexed(column)) return false;
+    
+    const FilterIndex& index = GetFilterIndex(column);
+    std::vector<const std::vector<int>*> lists;
+    for (uint64_t key : Trigrams(text)) {
+        auto posting = index.postings.find(key);
+        if (posting == index.postings.end()) {
+            rows.clear();
+            return true;
         }
+        lists.push_back(&posting->second);
+    }
+    
+    // Intersect starting from the rarest trigram
+    std::sort(lists.begin(), lists.end(), [](const std::vector<int>* a, const std::vector<int>* b) {
+        return a->size() < b->size();
+    });
+    rows = *lists[0];
+    std::vector<int> narrowed;
+    for (size_t i = 1; i < lists.size() && !rows.empty(); i++) {
+        narrowed.clear();
+        std::set_intersection(rows.begin(), rows.end(), lists[i]->begin(), lists[i]->end(), std::back_inserter(narrowed));
+        rows.swap(narrowed);
     }
+    return true;
 }
 
-// Selection
-void DataGrid::SelectRow(int index, bool selected) {
-    auto& rows = GetDisplayRows();
+bool DataGrid::GatherFilterCandidates(std::vector<int>& rows) {
+    bool narrowed = false;
+    std::vector<int> columnRows;
+    std::vector<int> merged;
     
-    if (index >= 0 && index < (int)rows.size()) {
-        if (m_selectionMode == SelectionMode::SINGLE && selected) {
-            // Clear other selections
-            for (auto& row : rows) {
-                row.selected = false;
+    // Column filters must all match: intersect
+    for (const auto& filter : m_columnFilters) {
+        if (!QueryFilterIndex(filter.first, filter.second, columnRows)) continue;
+        if (!narrowed) {
+            rows.swap(columnRows);
+            narrowed = true;
+        } else {
+            merged.clear();
+            std::set_intersection(rows.begin(), rows.end(), columnRows.begin(), columnRows.end(), std::back_inserter(merged));
+            rows.swap(merged);
+        }
+    }
+    
+    // The global filter may match any column: union, only when all are indexed
+    if (m_filterText.size() >= 3 && !m_columns.empty() && m_filterIndexes.size() >= m_columns.size()) {
+        std::vector<int> anyColumn;
+        bool allIndexed = true;
+        for (int column = 0; column < (int)m_columns.size() && allIndexed; column++) {
+            allIndexed = QueryFilterIndex(column, m_filterText, columnRows);
+            merged.clear();
+            std::set_union(anyColumn.begin(), anyColumn.end(), columnRows.begin(), columnRows.end(), std::back_inserter(merged));
+            anyColumn.swap(merged);
+        }
+        if (allIndexed) {
+            if (!narrowed) {
+                rows.swap(anyColumn);
+                narrowed = true;
+            } else {
+                merged.clear();
+                std::set_intersection(rows.begin(), rows.end(), anyColumn.begin(), anyColumn.end(), std::back_inserter(merged));
+                rows.swap(merged);
             }
         }
-        rows[index].selected = selected;
     }
+    
+    return narrowed;
+}
+
+// Selection
+void DataGrid::SelectRow(int index, bool selected) {
+    int sourceRow = GetSourceRowIndex(index);
+    if (sourceRow < 0) return;
+    
+    if (m_selectionMode == SelectionMode::SINGLE && selected) {
+        // Clear other selections
+        ClearSelection();
+    }
+    SetSourceRowSelected(sourceRow, selected);
+    Invalidate();
 }
 
 void DataGrid::SelectAll() {
     if (m_selectionMode == SelectionMode::MULTI) {
-        auto& rows = GetDisplayRows();
-        for (auto& row : rows) {
-            row.selected = true;
+        int count = GetDisplayRowCount();
+        for (int i = 0; i < count; i++) {
+            SetSourceRowSelected(GetSourceRowIndex(i), true);
         }
+        Invalidate();
     }
 }
 
 void DataGrid::ClearSelection() {
-    auto& rows = GetDisplayRows();
-    for (auto& row : rows) {
+    m_providerSelection.clear();
+    for (auto& row : m_rows) {
         row.selected = false;
     }
+    Invalidate();
 }
 
 bool DataGrid::IsRowSelected(int index) const {
-    const auto& rows = GetDisplayRows();
-    if (index >= 0 && index < (int)rows.size()) {
-        return rows[index].selected;
-    }
-    return false;
+    int sourceRow = GetSourceRowIndex(index);
+    return sourceRow >= 0 && IsSourceRowSelected(sourceRow);
 }
 
 std::vector<int> DataGrid::GetSelectedRows() const {
     std::vector<int> selected;
-    const auto& rows = GetDisplayRows();
+    if (m_cellValueProvider && m_providerSelection.empty()) {
+        return selected;
+    }
     
-    for (size_t i = 0; i < rows.size(); i++) {
-        if (rows[i].selected) {
-            selected.push_back(static_cast<int>(i));
+    int count = GetDisplayRowCount();
+    for (int i = 0; i < count; i++) {
+        if (IsSourceRowSelected(GetSourceRowIndex(i))) {
+            selected.push_back(i);
         }
     }
     
@@ -341,34 +1234,41 @@ int DataGrid::GetSelectedRowCount() const {
 
 // Editing
 void DataGrid::BeginEdit(int row, int column) {
-    auto& rows = GetDisplayRows();
+    int sourceRow = GetSourceRowIndex(row);
     
-    if (row >= 0 && row < (int)rows.size() && column >= 0 && column < (int)m_columns.size()) {
+    if (sourceRow >= 0 && column >= 0 && column < (int)m_columns.size() && column < GetSourceCellCount(sourceRow)) {
         if (m_columns[column].editable) {
             m_editingRow = row;
             m_editingColumn = column;
-            m_editBuffer = rows[row].cells[column].value;
+            m_editBuffer = GetSourceCellText(sourceRow, column);
+            Invalidate();
         }
     }
 }
 
 void DataGrid::EndEdit(bool commit) {
     if (m_editingRow >= 0 && m_editingColumn >= 0) {
-        if (commit) {
-            auto& rows = GetDisplayRows();
-            if (m_editingRow < (int)rows.size() && m_editingColumn < (int)rows[m_editingRow].cells.size()) {
-                std::wstring oldValue = rows[m_editingRow].cells[m_editingColumn].value;
-                rows[m_editingRow].cells[m_editingColumn].value = m_editBuffer;
-                
-                if (m_cellEditCallback) {
-                    m_cellEditCallback(m_editingRow, m_editingColumn, oldValue, m_editBuffer);
-                }
-            }
-        }
+        int sourceRow = GetSourceRowIndex(m_editingRow);
+        int column = m_editingColumn;
+        std::wstring newValue = m_editBuffer;
         
         m_editingRow = -1;
         m_editingColumn = -1;
         m_editBuffer.clear();
+        Invalidate();
+        
+        if (commit && sourceRow >= 0 && column < GetSourceCellCount(sourceRow)) {
+            std::wstring oldValue = GetSourceCellText(sourceRow, column);
+            
+            // Provider grids leave storing the value to the edit callback
+            if (!m_cellValueProvider) {
+                SetCellValue(sourceRow, column, newValue);
+            }
+            
+            if (m_cellEditCallback) {
+                m_cellEditCallback(sourceRow, column, oldValue, newValue);
+            }
+        }
     }
 }
 
@@ -378,20 +1278,110 @@ void DataGrid::CancelEdit() {
 
 // Virtual scrolling
 void DataGrid::ScrollToRow(int index) {
-    const auto& rows = GetDisplayRows();
-    
-    if (index >= 0 && index < (int)rows.size()) {
-        m_firstVisibleRow = index;
+    if (index >= 0 && index < std::max(GetDisplayRowCount(), 1)) {
+        if (m_firstVisibleRow != index) {
+            m_firstVisibleRow = index;
+            Invalidate();
+        }
         CalculateVisibleRows();
     }
 }
 
+const std::vector<int>& DataGrid::GetColumnOffsets() const {
+    if (m_columnOffsetsDirty) {
+        m_columnOffsets.resize(m_columns.size() + 1);
+        m_columnOffsets[0] = 0;
+        for (size_t i = 0; i < m_columns.size(); i++) {
+            m_columnOffsets[i + 1] = m_columnOffsets[i] + std::max(m_columns[i].width, 0);
+        }
+        m_columnOffsetsDirty = false;
+    }
+    return m_columnOffsets;
+}
+
+int DataGrid::GetFrozenWidth() const {
+    return GetColumnOffsets()[std::min(m_frozenColumns, (int)m_columns.size())];
+}
+
+int DataGrid::GetColumnLeft(int column, const RECT& bounds) const {
+    return bounds.left + GetColumnOffsets()[column] - (column >= m_frozenColumns ? m_scrollX : 0);
+}
+
+void DataGrid::GetScrolledColumnRange(const RECT& bounds, int& first, int& last) const {
+    const std::vector<int>& offsets = GetColumnOffsets();
+    int count = (int)m_columns.size();
+    int frozen = std::min(m_frozenColumns, count);
+    
+    // Scrolled columns whose right edge passes the frozen ones, up to the
+    // first one starting past the right edge
+    int left = offsets[frozen] + m_scrollX;
+    int right = (bounds.right - bounds.left) + m_scrollX;
+    first = (int)(std::upper_bound(offsets.begin() + frozen + 1, offsets.end(), left) - offsets.begin()) - 1;
+    last = (int)(std::lower_bound(offsets.begin() + first, offsets.begin() + count, right) - offsets.begin());
+}
+
+int DataGrid::HitTestColumn(int x, const RECT& bounds) const {
+    const std::vector<int>& offsets = GetColumnOffsets();
+    int count = (int)m_columns.size();
+    int frozen = std::min(m_frozenColumns, count);
+    
+    int local = x - bounds.left;
+    if (local < 0 || x >= bounds.right) return -1;
+    int begin = 0;
+    int end = frozen;
+    if (local >= offsets[frozen]) {
+        local += m_scrollX;
+        begin = frozen;
+        end = count;
+    }
+    int column = (int)(std::upper_bound(offsets.begin() + begin, offsets.begin() + end + 1, local) - offsets.begin()) - 1;
+    return (column >= begin && column < end) ? column : -1;
+}
+
+void DataGrid::SetFrozenColumnCount(int count) {
+    count = std::max(count, 0);
+    if (count != m_frozenColumns) {
+        m_frozenColumns = count;
+        SetHorizontalScroll(m_scrollX);
+        Invalidate();
+    }
+}
+
+void DataGrid::SetHorizontalScroll(int offset) {
+    RECT bounds;
+    GetBounds(bounds);
+    int maximum = std::max(GetTotalColumnWidth() - (int)(bounds.right - bounds.left), 0);
+    offset = std::min(std::max(offset, 0), maximum);
+    if (offset != m_scrollX) {
+        m_scrollX = offset;
+        Invalidate();
+    }
+}
+
+void DataGrid::ScrollToColumn(int column) {
+    if (column < std::min(m_frozenColumns, (int)m_columns.size()) || column >= (int)m_columns.size()) return;
+    
+    RECT bounds;
+    GetBounds(bounds);
+    const std::vector<int>& offsets = GetColumnOffsets();
+    int viewport = (int)(bounds.right - bounds.left) - GetFrozenWidth();
+    
+    // Content positions past the frozen columns
+    int left = offsets[column] - GetFrozenWidth();
+    int right = offsets[column + 1] - GetFrozenWidth();
+    if (left < m_scrollX) {
+        SetHorizontalScroll(left);
+    } else if (right > m_scrollX + viewport) {
+        SetHorizontalScroll(std::min(right - viewport, left));
+    }
+}
+
 void DataGrid::CalculateVisibleRows() {
     RECT bounds;
     GetBounds(bounds);
     
     int availableHeight = bounds.bottom - bounds.top - m_headerHeight;
-    m_visibleRowCount = availableHeight / m_rowHeight;
+    m_visibleRowCount = m_rowHeight > 0 ? std::max(availableHeight / m_rowHeight, 0) : 0;
 }
 
 // Helper methods
@@ -399,12 +1389,8 @@ bool DataGrid::GetCellRect(int row, int column, RECT& rect) const {
     RECT bounds;
     GetBounds(bounds);
     
-    int x = bounds.left;
-    for (int i = 0; i < column && i < (int)m_columns.size(); i++) {
-        x += m_columns[i].width;
-    }
-    
-    if (column >= (int)m_columns.size()) return false;
+    if (column < 0 || column >= (int)m_columns.size()) return false;
+    int x = GetColumnLeft(column, bounds);
     
     int displayRow = row - m_firstVisibleRow;
     int y = bounds.top + m_headerHeight + displayRow * m_rowHeight;
@@ -428,20 +1414,10 @@ bool DataGrid::HitTestCell(int x, int y, int& row, int& column) const {
     int displayRow = relativeY / m_rowHeight;
     row = displayRow + m_firstVisibleRow;
     
-    const auto& rows = GetDisplayRows();
-    if (row < 0 || row >= (int)rows.size()) return false;
-    
-    // Calculate column
-    int currentX = bounds.left;
-    for (size_t i = 0; i < m_columns.size(); i++) {
-        if (x >= currentX && x < currentX + m_columns[i].width) {
-            column = static_cast<int>(i);
-            return true;
-        }
-        currentX += m_columns[i].width;
-    }
+    if (row < 0 || row >= GetDisplayRowCount()) return false;
     
-    return false;
+    column = HitTestColumn(x, bounds);
+    return column >= 0;
 }
 
 bool DataGrid::HitTestHeader(int x, int y, int& column) const {
@@ -450,54 +1426,44 @@ bool DataGrid::HitTestHeader(int x, int y, int& column) const {
     
     if (y < bounds.top || y >= bounds.top + m_headerHeight) return false;
     
-    int currentX = bounds.left;
-    for (size_t i = 0; i < m_columns.size(); i++) {
-        if (x >= currentX && x < currentX + m_columns[i].width) {
-            column = static_cast<int>(i);
-            return true;
-        }
-        currentX += m_columns[i].width;
-    }
-    
-    return false;
+    column = HitTestColumn(x, bounds);
+    return column >= 0;
 }
 
+#if SDK_PLATFORM_WINDOWS
 void DataGrid::RenderHeader(HDC hdc, const RECT& bounds) {
     RECT headerRect = {bounds.left, bounds.top, bounds.right, bounds.top + m_headerHeight};
     
     // Draw header background
-    HBRUSH headerBrush = CreateSolidBrush(m_headerColor.ToCOLORREF());
+    HBRUSH headerBrush = GdiObjectCache::GetBrush(m_headerColor.ToCOLORREF());
     FillRect(hdc, &headerRect, headerBrush);
-    DeleteObject(headerBrush);
     
-    // Draw columns
-    int x = bounds.left;
-    for (size_t i = 0; i < m_columns.size(); i++) {
+    ScopedFont font(hdc, FontCache::Get(L"Segoe UI", 14, FW_BOLD, false, false, false, GetDPI()));
+    
+    // Draw the scrolled columns in view, then the frozen ones over them
+    auto drawColumn = [&](size_t i) {
+        int x = GetColumnLeft((int)i, bounds);
         RECT colRect = {x, headerRect.top, x + m_columns[i].width, headerRect.bottom};
+        if (i < (size_t)m_frozenColumns) {
+            HBRUSH frozenBrush = GdiObjectCache::GetBrush(m_headerColor.ToCOLORREF());
+            FillRect(hdc, &colRect, frozenBrush);
+        }
         
         // Draw header text
         SetBkMode(hdc, TRANSPARENT);
         SetTextColor(hdc, RGB(0, 0, 0));
         
-        HFONT hFont = CreateFontW(14, 0, 0, 0, FW_BOLD, FALSE, FALSE, FALSE,
-            DEFAULT_CHARSET, OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS,
-            CLEARTYPE_QUALITY, DEFAULT_PITCH | FF_DONTCARE, L"Segoe UI");
-        HFONT oldFont = (HFONT)SelectObject(hdc, hFont);
-        
         RECT textRect = colRect;
         textRect.left += 5;
         textRect.right -= 5;
         DrawTextW(hdc, m_columns[i].header.c_str(), -1, &textRect, DT_LEFT | DT_VCENTER | DT_SINGLELINE);
         
-        SelectObject(hdc, oldFont);
-        DeleteObject(hFont);
-        
         // Draw sort indicator
         if (m_sortColumn == (int)i && m_sortOrder != SortOrder::NONE) {
             int arrowX = colRect.right - 15;
             int arrowY = (colRect.top + colRect.bottom) / 2;
             
-            HPEN pen = CreatePen(PS_SOLID, 2, RGB(50, 50, 50));
+            HPEN pen = GdiObjectCache::GetPen(RGB(50, 50, 50), 2);
             HPEN oldPen = (HPEN)SelectObject(hdc, pen);
             
             if (m_sortOrder == SortOrder::ASCENDING) {
@@ -513,43 +1479,47 @@ void DataGrid::RenderHeader(HDC hdc, const RECT& bounds) {
             }
             
             SelectObject(hdc, oldPen);
-            DeleteObject(pen);
         }
         
         // Draw column separator
-        HPEN gridPen = CreatePen(PS_SOLID, 1, m_gridLineColor.ToCOLORREF());
+        HPEN gridPen = GdiObjectCache::GetPen(m_gridLineColor.ToCOLORREF());
         HPEN oldPen = (HPEN)SelectObject(hdc, gridPen);
         
         MoveToEx(hdc, x + m_columns[i].width, headerRect.top, nullptr);
         LineTo(hdc, x + m_columns[i].width, headerRect.bottom);
         
         SelectObject(hdc, oldPen);
-        DeleteObject(gridPen);
-        
-        x += m_columns[i].width;
+    };
+    
+    int first, last;
+    GetScrolledColumnRange(bounds, first, last);
+    for (int i = first; i < last; i++) {
+        drawColumn(i);
+    }
+    for (int i = 0; i < std::min(m_frozenColumns, (int)m_columns.size()); i++) {
+        drawColumn(i);
     }
     
     // Draw header bottom border
-    HPEN borderPen = CreatePen(PS_SOLID, 2, m_gridLineColor.ToCOLORREF());
+    HPEN borderPen = GdiObjectCache::GetPen(m_gridLineColor.ToCOLORREF(), 2);
     HPEN oldPen = (HPEN)SelectObject(hdc, borderPen);
     
     MoveToEx(hdc, headerRect.left, headerRect.bottom, nullptr);
     LineTo(hdc, headerRect.right, headerRect.bottom);
     
     SelectObject(hdc, oldPen);
-    DeleteObject(borderPen);
 }
 
-void DataGrid::RenderCell(HDC hdc, const RECT& rect, const Cell& cell, bool selected, bool editing) {
-    // Draw cell background
-    HBRUSH cellBrush;
-    if (selected) {
-        cellBrush = CreateSolidBrush(m_selectionColor.ToCOLORREF());
-    } else {
-        cellBrush = CreateSolidBrush(RGB(255, 255, 255));
+void DataGrid::RenderCell(HDC hdc, const RECT& rect, const std::wstring& text, bool selected, bool editing, float flash) {
+    // Draw cell background, blended toward the change flash
+    Color background = selected ? m_selectionColor : Color(255, 255, 255);
+    if (flash > 0.0f) {
+        auto blend = [flash](BYTE from, BYTE to) { return (int)(from + (to - from) * std::min(flash, 1.0f) + 0.5f); };
+        background = Color(blend(background.r, m_flashColor.r), blend(background.g, m_flashColor.g),
+                           blend(background.b, m_flashColor.b));
     }
+    HBRUSH cellBrush = GdiObjectCache::GetBrush(background.ToCOLORREF());
     FillRect(hdc, &rect, cellBrush);
-    DeleteObject(cellBrush);
     
     if (editing) {
         RenderEditBox(hdc, rect);
@@ -562,15 +1532,14 @@ void DataGrid::RenderCell(HDC hdc, const RECT& rect, const Cell& cell, bool sele
         textRect.left += 5;
         textRect.right -= 5;
         
-        DrawTextW(hdc, cell.value.c_str(), -1, &textRect, DT_LEFT | DT_VCENTER | DT_SINGLELINE);
+        DrawTextW(hdc, text.c_str(), -1, &textRect, DT_LEFT | DT_VCENTER | DT_SINGLELINE);
     }
 }
 
 void DataGrid::RenderEditBox(HDC hdc, const RECT& rect) {
     // Draw edit background
-    HBRUSH brush = CreateSolidBrush(RGB(255, 255, 200));
+    HBRUSH brush = GdiObjectCache::GetBrush(RGB(255, 255, 200));
     FillRect(hdc, &rect, brush);
-    DeleteObject(brush);
     
     // Draw edit text
     SetBkMode(hdc, TRANSPARENT);
@@ -584,7 +1553,7 @@ void DataGrid::RenderEditBox(HDC hdc, const RECT& rect) {
     DrawTextW(hdc, displayText.c_str(), -1, &textRect, DT_LEFT | DT_VCENTER | DT_SINGLELINE);
     
     // Draw border
-    HPEN pen = CreatePen(PS_SOLID, 2, RGB(0, 120, 215));
+    HPEN pen = GdiObjectCache::GetPen(RGB(0, 120, 215), 2);
     HPEN oldPen = (HPEN)SelectObject(hdc, pen);
     HBRUSH oldBrush = (HBRUSH)SelectObject(hdc, GetStockObject(NULL_BRUSH));
     
@@ -592,40 +1561,52 @@ void DataGrid::RenderEditBox(HDC hdc, const RECT& rect) {
     
     SelectObject(hdc, oldPen);
     SelectObject(hdc, oldBrush);
-    DeleteObject(pen);
 }
 
 void DataGrid::RenderRows(HDC hdc, const RECT& bounds) {
-    const auto& rows = GetDisplayRows();
-    
     CalculateVisibleRows();
     
-    int startRow = m_virtualScrolling ? m_firstVisibleRow : 0;
-    int endRow = m_virtualScrolling ? std::min(m_firstVisibleRow + m_visibleRowCount, (int)rows.size()) : (int)rows.size();
+    // Only rows inside the viewport are fetched and drawn; one extra row
+    // covers a partially visible last row
+    int rowCount = GetDisplayRowCount();
+    int startRow = std::min(std::max(m_firstVisibleRow, 0), rowCount);
+    int endRow = std::min(startRow + m_visibleRowCount + 1, rowCount);
+    
+    // Likewise only the columns in view, frozen ones last so they cover
+    // scrolled columns passing beneath
+    int firstColumn, lastColumn;
+    GetScrolledColumnRange(bounds, firstColumn, lastColumn);
+    int frozenColumns = std::min(m_frozenColumns, (int)m_columns.size());
+    HPEN gridPen = GdiObjectCache::GetPen(m_gridLineColor.ToCOLORREF());
     
     for (int i = startRow; i < endRow; i++) {
-        const Row& row = rows[i];
+        int sourceRow = GetSourceRowIndex(i);
+        bool selected = IsSourceRowSelected(sourceRow);
+        int cellCount = GetSourceCellCount(sourceRow);
         int displayRow = i - m_firstVisibleRow;
         int y = bounds.top + m_headerHeight + displayRow * m_rowHeight;
         
         // Draw row background (alternating colors)
-        if (i % 2 == 1 && !row.selected) {
+        if (i % 2 == 1 && !selected) {
             RECT rowRect = {bounds.left, y, bounds.right, y + m_rowHeight};
-            HBRUSH brush = CreateSolidBrush(m_alternateRowColor.ToCOLORREF());
+            HBRUSH brush = GdiObjectCache::GetBrush(m_alternateRowColor.ToCOLORREF());
             FillRect(hdc, &rowRect, brush);
-            DeleteObject(brush);
         }
         
         // Draw cells
-        int x = bounds.left;
-        for (size_t j = 0; j < m_columns.size() && j < row.cells.size(); j++) {
+        auto drawCell = [&](int j) {
+            if (j >= cellCount) return;
+            int x = GetColumnLeft(j, bounds);
             RECT cellRect = {x, y, x + m_columns[j].width, y + m_rowHeight};
             
-            bool editing = (m_editingRow == i && m_editingColumn == (int)j);
-            RenderCell(hdc, cellRect, row.cells[j], row.selected, editing);
+            bool editing = (m_editingRow == i && m_editingColumn == j);
+            if (m_cellValueProvider) {
+                RenderCell(hdc, cellRect, m_cellValueProvider(sourceRow, j), selected, editing);
+            } else {
+                RenderCell(hdc, cellRect, m_rows[sourceRow].cells[j].value, selected, editing, GetFlash(sourceRow, j));
+            }
             
             // Draw grid lines
-            HPEN gridPen = CreatePen(PS_SOLID, 1, m_gridLineColor.ToCOLORREF());
             HPEN oldPen = (HPEN)SelectObject(hdc, gridPen);
             
             // Vertical line
@@ -637,23 +1618,30 @@ void DataGrid::RenderRows(HDC hdc, const RECT& bounds) {
             LineTo(hdc, cellRect.right, cellRect.bottom);
             
             SelectObject(hdc, oldPen);
-            DeleteObject(gridPen);
-            
-            x += m_columns[j].width;
+        };
+        for (int j = firstColumn; j < lastColumn; j++) {
+            drawCell(j);
+        }
+        for (int j = 0; j < frozenColumns; j++) {
+            drawCell(j);
         }
     }
 }
 
+#endif
+
 void DataGrid::Render(HDC hdc) {
+#if SDK_PLATFORM_WINDOWS
     if (!m_visible) return;
     
+    ScopedFont font(hdc, GetFont());
+    
     RECT bounds;
     GetBounds(bounds);
     
     // Draw background
-    HBRUSH brush = CreateSolidBrush(RGB(255, 255, 255));
+    HBRUSH brush = GdiObjectCache::GetBrush(RGB(255, 255, 255));
     FillRect(hdc, &bounds, brush);
-    DeleteObject(brush);
     
     // Draw border
     Renderer::DrawRoundedRect(hdc, bounds, 4, Color(255, 255, 255, 255), Color(180, 180, 180, 255), 1);
@@ -673,11 +1661,15 @@ void DataGrid::Render(HDC hdc) {
     DeleteObject(clipRegion);
     
     Widget::Render(hdc);
+#else
+    (void)hdc;
+#endif
 }
 
 bool DataGrid::HandleMouseDown(int x, int y, int button) {
     if (!m_visible || !m_enabled) return false;
     if (!HitTest(x, y)) return false;
+    SetFocused(true);
     
     // Check header click (for sorting)
     int headerColumn = -1;
@@ -700,7 +1692,7 @@ bool DataGrid::HandleMouseDown(int x, int y, int button) {
         
         // Trigger callback
         if (m_cellClickCallback) {
-            m_cellClickCallback(row, column);
+            m_cellClickCallback(GetSourceRowIndex(row), column);
         }
         
         return true;
@@ -729,6 +1721,8 @@ bool DataGrid::HandleMouseMove(int x, int y) {
 }
 
 bool DataGrid::HandleKeyDown(int keyCode) {
+    if (!Widget::HandleKeyDown(keyCode)) return false;
+    
     if (IsEditing()) {
         if (keyCode == VK_RETURN) {
             EndEdit(true);
@@ -743,8 +1737,27 @@ bool DataGrid::HandleKeyDown(int keyCode) {
             return true;
         }
     } else {
+        // Left and right scroll by a column
+        if (keyCode == VK_LEFT || keyCode == VK_RIGHT) {
+            RECT bounds;
+            GetBounds(bounds);
+            int first, last;
+            GetScrolledColumnRange(bounds, first, last);
+            int frozenWidth = GetFrozenWidth();
+            const std::vector<int>& offsets = GetColumnOffsets();
+            if (keyCode == VK_LEFT && first > m_frozenColumns) {
+                // A partly hidden first column shows whole before moving on
+                int target = offsets[first] - frozenWidth < m_scrollX ? first : first - 1;
+                SetHorizontalScroll(offsets[target] - frozenWidth);
+            } else if (keyCode == VK_RIGHT && first < (int)m_columns.size()) {
+                SetHorizontalScroll(offsets[first + 1] - frozenWidth);
+            } else if (keyCode == VK_LEFT) {
+                SetHorizontalScroll(0);
+            }
+            return true;
+        }
+        
         // Handle navigation
-        auto& rows = GetDisplayRows();
         std::vector<int> selected = GetSelectedRows();
         
         if (!selected.empty()) {
@@ -754,7 +1767,7 @@ bool DataGrid::HandleKeyDown(int keyCode) {
                 SelectRow(currentRow, false);
                 SelectRow(currentRow - 1, true);
                 return true;
-            } else if (keyCode == VK_DOWN && currentRow < (int)rows.size() - 1) {
+            } else if (keyCode == VK_DOWN && currentRow < GetDisplayRowCount() - 1) {
                 SelectRow(currentRow, false);
                 SelectRow(currentRow + 1, true);
                 return true;
@@ -784,6 +1797,19 @@ bool DataGrid::HandleChar(wchar_t ch) {
 
 void DataGrid::Update(float deltaTime) {
     Widget::Update(deltaTime);
+    
+    if (m_liveUpdates) {
+        ApplyCellUpdates();
+        // PostCellUpdate wakes the grid when updates arrive, so it sleeps otherwise
+        if (m_cellUpdates.load(std::memory_order_relaxed)) ScheduleUpdate();
+    }
+    if (!IsUpdateScheduled()) {
+        UpdateScheduler::CancelWake(this);      // Ticked every frame anyway
+    }
+    if (!m_flashes.empty()) {
+        UpdateFlashes(deltaTime);
+        ScheduleUpdate();
+    }
 }
 
 } // namespace SDK
@@ -0,0 +1,125 @@
+#include "../../include/SDK/DeferredWindowPos.h"
+
+namespace SDK {
+
+DeferredWindowPos::Batch& DeferredWindowPos::GetBatch() {
+    thread_local Batch batch;
+    return batch;
+}
+
+DeferredWindowPos::DeferredWindowPos() {
+    GetBatch().depth++;
+}
+
+DeferredWindowPos::~DeferredWindowPos() {
+    Batch& batch = GetBatch();
+    if (--batch.depth > 0 || batch.entries.empty()) return;
+
+    // Taken first, so moves made from the messages these send start afresh
+    std::vector<Entry> entries;
+    entries.swap(batch.entries);
+
+    if (entries.size() == 1) {
+        Apply(entries[0]);
+        return;
+    }
+
+    HDWP hdwp = BeginDeferWindowPos((int)entries.size());
+    for (size_t i = 0; hdwp && i < entries.size(); i++) {
+        const Entry& e = entries[i];
+        if (!IsWindow(e.hwnd)) continue;
+        hdwp = DeferWindowPos(hdwp, e.hwnd, e.insertAfter, e.x, e.y, e.width, e.height, e.flags);
+    }
+    if (hdwp && EndDeferWindowPos(hdwp)) return;
+
+    // A failed DeferWindowPos discards the whole batch; move them one by one
+    for (const Entry& entry : entries) {
+        if (IsWindow(entry.hwnd)) Apply(entry);
+    }
+}
+
+void DeferredWindowPos::Move(HWND hwnd, HWND insertAfter, int x, int y, int width, int height, UINT flags) {
+    Entry entry = { hwnd, insertAfter, x, y, width, height, flags };
+
+    Batch& batch = GetBatch();
+    if (batch.depth == 0) {
+        Apply(entry);
+        return;
+    }
+
+    for (auto& pending : batch.entries) {
+        if (pending.hwnd == hwnd) {
+            Merge(pending, entry);
+            return;
+        }
+    }
+    batch.entries.push_back(entry);
+}
+
+void DeferredWindowPos::Merge(Entry& pending, const Entry& entry) {
+    // Each part of the later move replaces that part of the earlier one; a
+    // part the later move leaves alone keeps the earlier move's value
+    const UINT parts = SWP_NOMOVE | SWP_NOSIZE | SWP_NOZORDER;
+    UINT flags = (pending.flags | entry.flags) & ~parts;
+    flags |= pending.flags & entry.flags & parts;
+    if (!(entry.flags & SWP_NOMOVE)) {
+        pending.x = entry.x;
+        pending.y = entry.y;
+    }
+    if (!(entry.flags & SWP_NOSIZE)) {
+        pending.width = entry.width;
+        pending.height = entry.height;
+    }
+    if (!(entry.flags & SWP_NOZORDER)) {
+        pending.insertAfter = entry.insertAfter;
+    }
+    pending.flags = flags;
+}
+
+bool DeferredWindowPos::GetRect(HWND hwnd, RECT& rect) {
+    if (!GetWindowRect(hwnd, &rect)) return false;
+
+    for (const auto& pending : GetBatch().entries) {
+        if (pending.hwnd != hwnd) continue;
+        int width = rect.right - rect.left;
+        int height = rect.bottom - rect.top;
+        if (!(pending.flags & SWP_NOSIZE)) {
+            width = pending.width;
+            height = pending.height;
+        }
+        if (!(pending.flags & SWP_NOMOVE)) {
+            rect.left = pending.x;
+            rect.top = pending.y;
+        }
+        rect.right = rect.left + width;
+        rect.bottom = rect.top + height;
+        break;
+    }
+    return true;
+}
+
+void DeferredWindowPos::Flush(HWND hwnd) {
+    auto& entries = GetBatch().entries;
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (entries[i].hwnd == hwnd) {
+            Entry entry = entries[i];
+            entries.erase(entries.begin() + i);
+            Apply(entry);
+            return;
+        }
+    }
+}
+
+bool DeferredWindowPos::IsBatching() {
+    return GetBatch().depth > 0;
+}
+
+size_t DeferredWindowPos::GetPendingCount() {
+    return GetBatch().entries.size();
+}
+
+void DeferredWindowPos::Apply(const Entry& entry) {
+    SetWindowPos(entry.hwnd, entry.insertAfter, entry.x, entry.y, entry.width, entry.height, entry.flags);
+}
+
+} // namespace SDK
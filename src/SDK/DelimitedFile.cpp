@@ -0,0 +1,332 @@
+#include "../../include/SDK/DelimitedFile.h"
+#include "../../include/SDK/JobScheduler.h"
+#include "../../include/SDK/StringUtils.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <cwchar>
+#include <cwctype>
+
+#if !SDK_PLATFORM_WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace SDK {
+
+namespace {
+    // Bytes each worker scans when indexing rows
+    constexpr uint64_t INDEX_CHUNK_SIZE = 4 * 1024 * 1024;
+    constexpr size_t NO_LINE = SIZE_MAX;
+
+    bool EndsWith(const std::wstring& text, const wchar_t* suffix) {
+        size_t length = wcslen(suffix);
+        if (text.size() < length) return false;
+        for (size_t i = 0; i < length; i++) {
+            if (towlower(text[text.size() - length + i]) != (wint_t)suffix[i]) return false;
+        }
+        return true;
+    }
+
+    // Where IndexRows() stands in a line, by the rules SplitLine() splits it with:
+    // a quote opens a quoted field only at the start of a field and is literal
+    // anywhere else, and inside quotes "" is an escaped quote
+    enum ScanState : uint8_t {
+        FIELD_START,
+        UNQUOTED,
+        QUOTED,
+        QUOTE_SEEN,     // A quote inside quotes: closes them unless another follows
+        SCAN_STATE_COUNT
+    };
+
+    inline ScanState Step(ScanState state, char ch, char delimiter) {
+        if (state == QUOTED) return ch == '"' ? QUOTE_SEEN : QUOTED;
+        if (ch == '"') {
+            if (state == FIELD_START || state == QUOTE_SEEN) return QUOTED;
+            return UNQUOTED;
+        }
+        if (ch == delimiter || ch == '\n') return FIELD_START;
+        return UNQUOTED;
+    }
+}
+
+DelimitedFile::DelimitedFile()
+    : m_data(nullptr)
+    , m_size(0)
+    , m_start(0)
+#if SDK_PLATFORM_WINDOWS
+    , m_file(INVALID_HANDLE_VALUE)
+    , m_mapping(nullptr)
+#endif
+    , m_open(false)
+    , m_delimiter(',')
+    , m_hasHeader(true)
+    , m_cachedLine(NO_LINE)
+{
+}
+
+DelimitedFile::~DelimitedFile() {
+    Close();
+}
+
+bool DelimitedFile::Open(const std::wstring& path, wchar_t delimiter, bool hasHeader) {
+    Close();
+    if (delimiter == 0) {
+        delimiter = (EndsWith(path, L".tsv") || EndsWith(path, L".tab")) ? L'\t' : L',';
+    }
+    if (delimiter > 0x7F || delimiter == L'"' || delimiter == L'\n' || delimiter == L'\r') return false;
+    if (!Map(path)) return false;
+
+    m_delimiter = (char)delimiter;
+    m_hasHeader = hasHeader;
+    m_open = true;
+    if (m_size >= 3 && memcmp(m_data, "\xEF\xBB\xBF", 3) == 0) {
+        m_start = 3;
+    }
+    IndexRows();
+
+    // The first row decides the column count
+    if (m_lineStarts.size() > 1) {
+        const std::vector<Field>& fields = SplitLine(0);
+        for (const Field& field : fields) {
+            m_columnNames.push_back(hasHeader ? DecodeField(field) : std::wstring());
+        }
+    }
+    return true;
+}
+
+void DelimitedFile::Close() {
+    Unmap();
+    m_open = false;
+    m_start = 0;
+    m_lineStarts.clear();
+    m_lineStarts.shrink_to_fit();
+    m_columnNames.clear();
+    m_cachedLine = NO_LINE;
+    m_cachedFields.clear();
+}
+
+#if SDK_PLATFORM_WINDOWS
+bool DelimitedFile::Map(const std::wstring& path) {
+    m_file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                         FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_file, &size) || (uint64_t)size.QuadPart > SIZE_MAX) {
+        Unmap();
+        return false;
+    }
+    m_size = (uint64_t)size.QuadPart;
+    if (m_size == 0) return true;   // Empty files can't be mapped
+
+    m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    m_data = m_mapping ? (const char*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!m_data) {
+        Unmap();
+        return false;
+    }
+    return true;
+}
+
+void DelimitedFile::Unmap() {
+    if (m_data) UnmapViewOfFile(m_data);
+    if (m_mapping) CloseHandle(m_mapping);
+    if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+    m_data = nullptr;
+    m_mapping = nullptr;
+    m_file = INVALID_HANDLE_VALUE;
+    m_size = 0;
+}
+#else
+bool DelimitedFile::Map(const std::wstring& path) {
+    int file = open(WStringToUTF8(path).c_str(), O_RDONLY);
+    if (file < 0) return false;
+
+    struct stat info;
+    if (fstat(file, &info) != 0 || (uint64_t)info.st_size > SIZE_MAX) {
+        close(file);
+        return false;
+    }
+    m_size = (uint64_t)info.st_size;
+    if (m_size > 0) {
+        void* data = mmap(nullptr, (size_t)m_size, PROT_READ, MAP_PRIVATE, file, 0);
+        m_data = data != MAP_FAILED ? (const char*)data : nullptr;
+    }
+    close(file);     // The mapping keeps the file open
+    if (m_size > 0 && !m_data) {
+        m_size = 0;
+        return false;
+    }
+    return true;
+}
+
+void DelimitedFile::Unmap() {
+    if (m_data) munmap((void*)m_data, (size_t)m_size);
+    m_data = nullptr;
+    m_size = 0;
+}
+#endif
+
+void DelimitedFile::IndexRows() {
+    m_lineStarts.clear();
+    if (m_start >= m_size) {
+        m_lineStarts.push_back(m_size);
+        return;
+    }
+
+    // A line break ends a row only outside quotes. Whether a quote opens one
+    // depends on what precedes it, so workers first run each chunk from every
+    // state it could start in, usually converging within a line. Chaining
+    // those gives each chunk's real start state, from which the second pass
+    // collects its row starts.
+    uint64_t length = m_size - m_start;
+    int chunkCount = (int)((length + INDEX_CHUNK_SIZE - 1) / INDEX_CHUNK_SIZE);
+    auto chunkBegin = [&](int chunk) { return m_start + (uint64_t)chunk * INDEX_CHUNK_SIZE; };
+    auto chunkEnd = [&](int chunk) { return std::min(chunkBegin(chunk) + INDEX_CHUNK_SIZE, m_size); };
+    char delimiter = m_delimiter;
+
+    // endStates[chunk * SCAN_STATE_COUNT + s]: state after the chunk when it starts in s
+    std::vector<ScanState> endStates((size_t)chunkCount * SCAN_STATE_COUNT);
+    JobScheduler::ParallelFor(chunkCount, 1, [&](int begin, int end) {
+        for (int chunk = begin; chunk < end; chunk++) {
+            ScanState states[SCAN_STATE_COUNT] = { FIELD_START, UNQUOTED, QUOTED, QUOTE_SEEN };
+            uint64_t i = chunkBegin(chunk);
+            uint64_t last = chunkEnd(chunk);
+            bool converged = false;
+            while (i < last && !converged) {
+                converged = true;
+                for (int s = 0; s < SCAN_STATE_COUNT; s++) {
+                    states[s] = Step(states[s], m_data[i], delimiter);
+                    converged = converged && states[s] == states[0];
+                }
+                i++;
+            }
+            // From here on every start state takes the same path
+            for (; i < last; i++) {
+                states[0] = Step(states[0], m_data[i], delimiter);
+            }
+            for (int s = 0; s < SCAN_STATE_COUNT; s++) {
+                endStates[(size_t)chunk * SCAN_STATE_COUNT + s] = converged ? states[0] : states[s];
+            }
+        }
+    }, "DelimitedFileQuotes");
+
+    std::vector<ScanState> startStates(chunkCount);
+    ScanState state = FIELD_START;
+    for (int chunk = 0; chunk < chunkCount; chunk++) {
+        startStates[chunk] = state;
+        state = endStates[(size_t)chunk * SCAN_STATE_COUNT + state];
+    }
+
+    std::vector<std::vector<uint64_t>> starts(chunkCount);
+    JobScheduler::ParallelFor(chunkCount, 1, [&](int begin, int end) {
+        for (int chunk = begin; chunk < end; chunk++) {
+            ScanState chunkState = startStates[chunk];
+            uint64_t last = chunkEnd(chunk);
+            for (uint64_t i = chunkBegin(chunk); i < last; i++) {
+                char ch = m_data[i];
+                if (ch == '\n' && chunkState != QUOTED && i + 1 < m_size) {
+                    starts[chunk].push_back(i + 1);
+                }
+                chunkState = Step(chunkState, ch, delimiter);
+            }
+        }
+    }, "DelimitedFileRows");
+
+    size_t total = 1;
+    for (const auto& chunk : starts) {
+        total += chunk.size();
+    }
+    m_lineStarts.reserve(total + 1);
+    m_lineStarts.push_back(m_start);
+    for (const auto& chunk : starts) {
+        m_lineStarts.insert(m_lineStarts.end(), chunk.begin(), chunk.end());
+    }
+    m_lineStarts.push_back(m_size);
+}
+
+int DelimitedFile::GetRowCount() const {
+    size_t lines = m_lineStarts.empty() ? 0 : m_lineStarts.size() - 1;
+    if (m_hasHeader && lines > 0) lines--;
+    return (int)std::min(lines, (size_t)INT_MAX);
+}
+
+std::wstring DelimitedFile::GetColumnName(int column) const {
+    if (column < 0 || column >= (int)m_columnNames.size()) return std::wstring();
+    return m_columnNames[column];
+}
+
+std::wstring DelimitedFile::GetCell(int row, int column) const {
+    if (row < 0 || row >= GetRowCount() || column < 0) return std::wstring();
+
+    // Drawing asks for a row's cells one after another, so one split serves them all
+    const std::vector<Field>& fields = SplitLine((size_t)row + (m_hasHeader ? 1 : 0));
+    return column < (int)fields.size() ? DecodeField(fields[column]) : std::wstring();
+}
+
+const std::vector<DelimitedFile::Field>& DelimitedFile::SplitLine(size_t line) const {
+    if (line == m_cachedLine) return m_cachedFields;
+    m_cachedLine = line;
+    m_cachedFields.clear();
+
+    uint64_t position = m_lineStarts[line];
+    uint64_t end = m_lineStarts[line + 1];
+    while (end > position && (m_data[end - 1] == '\n' || m_data[end - 1] == '\r')) {
+        end--;
+    }
+
+    for (;;) {
+        Field field;
+        field.quoted = position < end && m_data[position] == '"';
+        if (field.quoted) {
+            field.begin = ++position;
+            while (position < end) {
+                if (m_data[position] == '"') {
+                    if (position + 1 < end && m_data[position + 1] == '"') {
+                        position += 2;
+                        continue;
+                    }
+                    break;
+                }
+                position++;
+            }
+            field.end = position;
+
+            // Anything between the closing quote and the delimiter is dropped
+            while (position < end && m_data[position] != m_delimiter) {
+                position++;
+            }
+        } else {
+            field.begin = position;
+            const void* delimiter = memchr(m_data + position, m_delimiter, (size_t)(end - position));
+            position = delimiter ? (uint64_t)((const char*)delimiter - m_data) : end;
+            field.end = position;
+        }
+        m_cachedFields.push_back(field);
+
+        if (position >= end) break;
+        position++;     // Past the delimiter
+    }
+    return m_cachedFields;
+}
+
+std::wstring DelimitedFile::DecodeField(const Field& field) const {
+    const char* text = m_data + field.begin;
+    size_t length = (size_t)(field.end - field.begin);
+    if (!field.quoted || !memchr(text, '"', length)) {
+        return UTF8ToWString(text, length);
+    }
+
+    std::string unescaped;
+    unescaped.reserve(length);
+    for (size_t i = 0; i < length; i++) {
+        unescaped.push_back(text[i]);
+        if (text[i] == '"') i++;    // The second of a doubled quote
+    }
+    return UTF8ToWString(unescaped.data(), unescaped.size());
+}
+
+} // namespace SDK
@@ -0,0 +1,279 @@
+#include "../../include/SDK/DirectoryLoader.h"
+#include <algorithm>
+#include <condition_variable>
+#include <thread>
+
+namespace SDK {
+
+namespace {
+    // Listing is I/O bound; several workers keep one slow share from stalling the rest
+    constexpr unsigned DEFAULT_WORKER_COUNT = 4;
+    constexpr size_t PUBLISH_BATCH_SIZE = 128;
+    constexpr ULONGLONG PUBLISH_INTERVAL_MS = 50;   // Flush partial batches of slow listings
+    constexpr DWORD WATCH_BUFFER_SIZE = 64 * 1024;  // Largest buffer supported over the network
+
+    struct WorkerPool {
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::deque<DirectoryLoader::RequestPtr> queue;
+        std::vector<DirectoryLoader::RequestPtr> running;
+        std::vector<std::thread> threads;
+        unsigned workerCount = DEFAULT_WORKER_COUNT;
+        bool stopping = false;
+
+        ~WorkerPool() { Stop(); }
+
+        void Stop() {
+            std::vector<std::thread> workers;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+                for (auto& request : running) {
+                    request->Cancel();
+                }
+                workers.swap(threads);
+            }
+            wake.notify_all();
+            for (auto& worker : workers) {
+                worker.join();
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = false;
+        }
+    };
+
+    WorkerPool g_pool;
+
+    void WorkerLoop() {
+        for (;;) {
+            DirectoryLoader::RequestPtr request;
+            {
+                std::unique_lock<std::mutex> lock(g_pool.mutex);
+                g_pool.wake.wait(lock, [] { return g_pool.stopping || !g_pool.queue.empty(); });
+                if (g_pool.stopping) return;
+                request = std::move(g_pool.queue.front());
+                g_pool.queue.pop_front();
+                g_pool.running.push_back(request);
+            }
+
+            DirectoryLoader::Enumerate(*request);
+
+            std::lock_guard<std::mutex> lock(g_pool.mutex);
+            auto it = std::find(g_pool.running.begin(), g_pool.running.end(), request);
+            if (it != g_pool.running.end()) g_pool.running.erase(it);
+        }
+    }
+}
+
+// Request
+DirectoryLoader::Request::Request(const std::wstring& path)
+    : m_path(path)
+    , m_cancelled(false)
+    , m_finished(false)
+{
+}
+
+bool DirectoryLoader::Request::IsComplete() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_finished && m_ready.empty();
+}
+
+std::vector<DirectoryLoader::Entry> DirectoryLoader::Request::TakeEntries(size_t maxEntries) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t count = std::min(maxEntries, m_ready.size());
+    std::vector<Entry> entries(std::make_move_iterator(m_ready.begin()),
+                               std::make_move_iterator(m_ready.begin() + count));
+    m_ready.erase(m_ready.begin(), m_ready.begin() + count);
+    return entries;
+}
+
+void DirectoryLoader::Request::Publish(std::vector<Entry>& entries, bool finished) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_cancelled) {
+        for (auto& entry : entries) {
+            m_ready.push_back(std::move(entry));
+        }
+    }
+    entries.clear();
+    m_finished = finished;
+}
+
+// DirectoryLoader
+DirectoryLoader::RequestPtr DirectoryLoader::Load(const std::wstring& path) {
+    auto request = std::make_shared<Request>(path);
+    {
+        std::lock_guard<std::mutex> lock(g_pool.mutex);
+        if (g_pool.threads.empty()) {
+            for (unsigned i = 0; i < std::max(g_pool.workerCount, 1u); i++) {
+                g_pool.threads.emplace_back(WorkerLoop);
+            }
+        }
+        g_pool.queue.push_back(request);
+    }
+    g_pool.wake.notify_one();
+    return request;
+}
+
+void DirectoryLoader::SetWorkerCount(unsigned count) {
+    std::lock_guard<std::mutex> lock(g_pool.mutex);
+    g_pool.workerCount = count;
+}
+
+void DirectoryLoader::Shutdown() {
+    std::deque<RequestPtr> queued;
+    {
+        std::lock_guard<std::mutex> lock(g_pool.mutex);
+        queued.swap(g_pool.queue);
+    }
+    std::vector<Entry> none;
+    for (auto& request : queued) {
+        request->Cancel();
+        request->Publish(none, true);
+    }
+    g_pool.Stop();
+}
+
+void DirectoryLoader::Enumerate(Request& request) {
+    std::vector<Entry> batch;
+
+    if (!request.IsCancelled()) {
+        // SECURITY: Validate path to prevent directory traversal attacks
+        // In production, add additional path validation to prevent malicious paths
+
+        // Basic info skips short names; large fetch cuts round trips on network shares
+        WIN32_FIND_DATAW findData;
+        std::wstring searchPath = request.m_path + L"\\*";
+        HANDLE hFind = FindFirstFileExW(searchPath.c_str(), FindExInfoBasic, &findData,
+                                        FindExSearchNameMatch, nullptr, FIND_FIRST_EX_LARGE_FETCH);
+
+        if (hFind != INVALID_HANDLE_VALUE) {
+            ULONGLONG lastPublish = GetTickCount64();
+            do {
+                if (request.IsCancelled()) break;
+
+                if (wcscmp(findData.cFileName, L".") != 0 && wcscmp(findData.cFileName, L"..") != 0) {
+                    Entry entry;
+                    entry.name = findData.cFileName;
+                    entry.fullPath = request.m_path + L"\\" + findData.cFileName;
+                    entry.isDirectory = (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+                    entry.size = ((ULONGLONG)findData.nFileSizeHigh << 32) | findData.nFileSizeLow;
+                    entry.modifiedTime = findData.ftLastWriteTime;
+                    batch.push_back(std::move(entry));
+                }
+
+                if (batch.size() >= PUBLISH_BATCH_SIZE ||
+                    (!batch.empty() && GetTickCount64() - lastPublish >= PUBLISH_INTERVAL_MS)) {
+                    request.Publish(batch, false);
+                    lastPublish = GetTickCount64();
+                }
+            } while (FindNextFileW(hFind, &findData));
+
+            FindClose(hFind);
+        }
+    }
+
+    request.Publish(batch, true);
+}
+
+// DirectoryWatcher
+DirectoryWatcher::DirectoryWatcher()
+    : m_recursive(false)
+    , m_notifyFilter(0)
+    , m_directory(INVALID_HANDLE_VALUE)
+    , m_overlapped()
+    , m_buffer(WATCH_BUFFER_SIZE / sizeof(DWORD))
+{
+}
+
+DirectoryWatcher::~DirectoryWatcher() {
+    Stop();
+}
+
+bool DirectoryWatcher::Start(const std::wstring& path, bool recursive, DWORD notifyFilter) {
+    Stop();
+
+    m_directory = CreateFileW(path.c_str(), FILE_LIST_DIRECTORY,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+    if (m_directory == INVALID_HANDLE_VALUE) return false;
+
+    m_overlapped = OVERLAPPED();
+    m_overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    m_path = path;
+    m_recursive = recursive;
+    m_notifyFilter = notifyFilter;
+
+    if (!m_overlapped.hEvent || !Issue()) {
+        Stop();
+        return false;
+    }
+    return true;
+}
+
+void DirectoryWatcher::Stop() {
+    if (m_directory != INVALID_HANDLE_VALUE) {
+        // Wait for the cancelled read so it can't write into the buffer later
+        DWORD bytes = 0;
+        CancelIoEx(m_directory, &m_overlapped);
+        GetOverlappedResult(m_directory, &m_overlapped, &bytes, TRUE);
+        CloseHandle(m_directory);
+        m_directory = INVALID_HANDLE_VALUE;
+    }
+    if (m_overlapped.hEvent) {
+        CloseHandle(m_overlapped.hEvent);
+        m_overlapped.hEvent = nullptr;
+    }
+}
+
+bool DirectoryWatcher::Issue() {
+    ResetEvent(m_overlapped.hEvent);
+    return ReadDirectoryChangesW(m_directory, m_buffer.data(), (DWORD)(m_buffer.size() * sizeof(DWORD)),
+                                 m_recursive ? TRUE : FALSE, m_notifyFilter, nullptr, &m_overlapped, nullptr) != FALSE;
+}
+
+std::vector<std::wstring> DirectoryWatcher::Poll(bool& overflowed) {
+    std::vector<std::wstring> changed;
+    overflowed = false;
+    if (!IsWatching()) return changed;
+
+    DWORD bytes = 0;
+    if (!GetOverlappedResult(m_directory, &m_overlapped, &bytes, FALSE)) {
+        DWORD error = GetLastError();
+        if (error == ERROR_IO_INCOMPLETE) return changed;
+        if (error != ERROR_NOTIFY_ENUM_DIR) {
+            // The directory went away or the share dropped
+            Stop();
+            return changed;
+        }
+        bytes = 0;
+    }
+
+    if (bytes == 0) {
+        // The buffer overflowed and the individual changes were dropped
+        overflowed = true;
+    } else {
+        const BYTE* data = reinterpret_cast<const BYTE*>(m_buffer.data());
+        for (;;) {
+            const auto* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(data);
+            std::wstring relative(info->FileName, info->FileNameLength / sizeof(WCHAR));
+            size_t separator = relative.find_last_of(L'\\');
+            std::wstring directory = separator == std::wstring::npos
+                ? m_path
+                : m_path + L"\\" + relative.substr(0, separator);
+
+            if (std::find(changed.begin(), changed.end(), directory) == changed.end()) {
+                changed.push_back(directory);
+            }
+
+            if (info->NextEntryOffset == 0) break;
+            data += info->NextEntryOffset;
+        }
+    }
+
+    if (!Issue()) {
+        Stop();
+    }
+    return changed;
+}
+
+} // namespace SDK
@@ -0,0 +1,253 @@
+#include "../../include/SDK/Easing.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+#include <mutex>
+
+namespace SDK {
+
+namespace {
+    using EasingType = Renderer::EasingType;
+
+    constexpr int EASING_TABLE_STEPS = 512;
+    // The tabled curves close the enum, EASE_IN_ELASTIC through EASE_IN_OUT_BOUNCE
+    constexpr int FIRST_TABLED = (int)EasingType::EASE_IN_ELASTIC;
+    constexpr int TABLED_COUNT = (int)EasingType::EASE_IN_OUT_BOUNCE - FIRST_TABLED + 1;
+
+    constexpr float BEZIER_EPSILON = 1e-6f;
+    constexpr int BEZIER_NEWTON_STEPS = 8;
+    constexpr int BEZIER_BISECTION_STEPS = 32;
+    constexpr size_t MAX_CACHED_CURVES = 64;
+
+    // Built on first use: pow and sin aren't constexpr in C++17. The elastic
+    // curves snap to 0 and 1 exactly at the ends, so the end samples are the
+    // limits from inside and t of exactly 0 or 1 is left to the formula.
+    struct EasingTables {
+        float values[TABLED_COUNT][EASING_TABLE_STEPS + 1];
+
+        EasingTables() {
+            for (int k = 0; k < TABLED_COUNT; k++) {
+                for (int i = 0; i <= EASING_TABLE_STEPS; i++) {
+                    float t = (float)i / EASING_TABLE_STEPS;
+                    if (i == 0) t = std::nextafter(0.0f, 1.0f);
+                    if (i == EASING_TABLE_STEPS) t = std::nextafter(1.0f, 0.0f);
+                    values[k][i] = Easing::EvaluateExact((EasingType)(FIRST_TABLED + k), t);
+                }
+            }
+        }
+    };
+
+    const EasingTables& GetTables() {
+        static const EasingTables tables;
+        return tables;
+    }
+
+    // t in [0, 1]
+    inline float Lookup(const float* table, int steps, float t) {
+        float x = t * steps;
+        int i = (int)x;
+        if (i >= steps) return table[steps];
+        return table[i] + (table[i + 1] - table[i]) * (x - (float)i);
+    }
+
+    inline float EvaluateWith(const EasingTables& tables, EasingType type, float t) {
+        int index = (int)type - FIRST_TABLED;
+        if (index < 0 || index >= TABLED_COUNT || !(t > 0.0f && t < 1.0f)) {
+            return Easing::EvaluateExact(type, t);
+        }
+        return Lookup(tables.values[index], EASING_TABLE_STEPS, t);
+    }
+
+    std::mutex g_curveMutex;
+    std::map<std::array<float, 4>, std::shared_ptr<const Easing::CubicBezier>> g_curves;
+}
+
+float Easing::Evaluate(EasingType type, float t) {
+    if ((int)type < FIRST_TABLED) return EvaluateExact(type, t);
+    return EvaluateWith(GetTables(), type, t);
+}
+
+void Easing::EvaluateBatch(const EasingType* types, float* t, size_t count) {
+    const EasingTables& tables = GetTables();
+    for (size_t i = 0; i < count; i++) {
+        t[i] = EvaluateWith(tables, types[i], t[i]);
+    }
+}
+
+void Easing::EvaluateBatch(EasingType type, float* t, size_t count) {
+    int index = (int)type - FIRST_TABLED;
+    if (index < 0 || index >= TABLED_COUNT) {
+        for (size_t i = 0; i < count; i++) {
+            t[i] = EvaluateExact(type, t[i]);
+        }
+        return;
+    }
+
+    const float* table = GetTables().values[index];
+    for (size_t i = 0; i < count; i++) {
+        t[i] = t[i] > 0.0f && t[i] < 1.0f ? Lookup(table, EASING_TABLE_STEPS, t[i]) : EvaluateExact(type, t[i]);
+    }
+}
+
+float Easing::EvaluateExact(EasingType type, float t) {
+    const float PI = 3.14159265358979323846f;
+
+    switch (type) {
+        case EasingType::LINEAR:
+            return t;
+
+        case EasingType::EASE_IN_QUAD:
+            return t * t;
+
+        case EasingType::EASE_OUT_QUAD:
+            return t * (2.0f - t);
+
+        case EasingType::EASE_IN_OUT_QUAD:
+            return t < 0.5f ? 2.0f * t * t : -1.0f + (4.0f - 2.0f * t) * t;
+
+        case EasingType::EASE_IN_CUBIC:
+            return t * t * t;
+
+        case EasingType::EASE_OUT_CUBIC: {
+            float u = t - 1.0f;
+            return u * u * u + 1.0f;
+        }
+
+        case EasingType::EASE_IN_OUT_CUBIC:
+            return t < 0.5f ? 4.0f * t * t * t : (t - 1.0f) * (2.0f * t - 2.0f) * (2.0f * t - 2.0f) + 1.0f;
+
+        case EasingType::EASE_IN_QUART:
+            return t * t * t * t;
+
+        case EasingType::EASE_OUT_QUART: {
+            float u = t - 1.0f;
+            return 1.0f - u * u * u * u;
+        }
+
+        case EasingType::EASE_IN_OUT_QUART: {
+            if (t < 0.5f) return 8.0f * t * t * t * t;
+            float u = t - 1.0f;
+            return 1.0f - 8.0f * u * u * u * u;
+        }
+
+        case EasingType::EASE_IN_ELASTIC: {
+            if (t == 0.0f || t == 1.0f) return t;
+            float p = 0.3f;
+            return -std::pow(2.0f, 10.0f * (t - 1.0f)) * std::sin((t - 1.1f) * 2.0f * PI / p);
+        }
+
+        case EasingType::EASE_OUT_ELASTIC: {
+            if (t == 0.0f || t == 1.0f) return t;
+            float p = 0.3f;
+            return std::pow(2.0f, -10.0f * t) * std::sin((t - 0.1f) * 2.0f * PI / p) + 1.0f;
+        }
+
+        case EasingType::EASE_IN_OUT_ELASTIC: {
+            if (t == 0.0f || t == 1.0f) return t;
+            float p = 0.45f;
+            t *= 2.0f;
+            if (t < 1.0f) {
+                return -0.5f * std::pow(2.0f, 10.0f * (t - 1.0f)) * std::sin((t - 1.1f) * 2.0f * PI / p);
+            }
+            return std::pow(2.0f, -10.0f * (t - 1.0f)) * std::sin((t - 1.1f) * 2.0f * PI / p) * 0.5f + 1.0f;
+        }
+
+        case EasingType::EASE_IN_BOUNCE:
+            return 1.0f - EvaluateExact(EasingType::EASE_OUT_BOUNCE, 1.0f - t);
+
+        case EasingType::EASE_OUT_BOUNCE: {
+            if (t < (1.0f / 2.75f)) {
+                return 7.5625f * t * t;
+            } else if (t < (2.0f / 2.75f)) {
+                t -= (1.5f / 2.75f);
+                return 7.5625f * t * t + 0.75f;
+            } else if (t < (2.5f / 2.75f)) {
+                t -= (2.25f / 2.75f);
+                return 7.5625f * t * t + 0.9375f;
+            } else {
+                t -= (2.625f / 2.75f);
+                return 7.5625f * t * t + 0.984375f;
+            }
+        }
+
+        case EasingType::EASE_IN_OUT_BOUNCE:
+            return t < 0.5f
+                ? EvaluateExact(EasingType::EASE_IN_BOUNCE, t * 2.0f) * 0.5f
+                : EvaluateExact(EasingType::EASE_OUT_BOUNCE, t * 2.0f - 1.0f) * 0.5f + 0.5f;
+
+        default:
+            return t;
+    }
+}
+
+// ==================== CUBIC BEZIER ====================
+
+Easing::CubicBezier::CubicBezier(float x1, float y1, float x2, float y2) {
+    // x must rise monotonically for a curve to be a function of time
+    x1 = std::min(std::max(x1, 0.0f), 1.0f);
+    x2 = std::min(std::max(x2, 0.0f), 1.0f);
+
+    m_cx = 3.0f * x1;
+    m_bx = 3.0f * (x2 - x1) - m_cx;
+    m_ax = 1.0f - m_cx - m_bx;
+    m_cy = 3.0f * y1;
+    m_by = 3.0f * (y2 - y1) - m_cy;
+    m_ay = 1.0f - m_cy - m_by;
+
+    for (int i = 0; i <= TABLE_STEPS; i++) {
+        m_table[i] = Solve((float)i / TABLE_STEPS);
+    }
+}
+
+float Easing::CubicBezier::Evaluate(float x) const {
+    x = std::min(std::max(x, 0.0f), 1.0f);
+    return Lookup(m_table, TABLE_STEPS, x);
+}
+
+float Easing::CubicBezier::Solve(float x) const {
+    if (x <= 0.0f) return 0.0f;
+    if (x >= 1.0f) return 1.0f;
+
+    // Newton's method converges in a few steps except where x(t) flattens
+    float t = x;
+    for (int i = 0; i < BEZIER_NEWTON_STEPS; i++) {
+        float error = SampleX(t) - x;
+        if (std::fabs(error) < BEZIER_EPSILON) return SampleY(t);
+        float derivative = SampleDerivativeX(t);
+        if (std::fabs(derivative) < BEZIER_EPSILON) break;
+        t -= error / derivative;
+    }
+
+    float low = 0.0f;
+    float high = 1.0f;
+    t = x;
+    for (int i = 0; i < BEZIER_BISECTION_STEPS; i++) {
+        float sample = SampleX(t);
+        if (std::fabs(sample - x) < BEZIER_EPSILON) break;
+        if (sample < x) {
+            low = t;
+        } else {
+            high = t;
+        }
+        t = (low + high) * 0.5f;
+    }
+    return SampleY(t);
+}
+
+std::shared_ptr<const Easing::CubicBezier> Easing::GetCubicBezier(float x1, float y1, float x2, float y2) {
+    std::array<float, 4> key = { x1, y1, x2, y2 };
+    std::lock_guard<std::mutex> lock(g_curveMutex);
+    auto it = g_curves.find(key);
+    if (it != g_curves.end()) return it->second;
+
+    // Holders keep their curves alive past a clear
+    if (g_curves.size() >= MAX_CACHED_CURVES) {
+        g_curves.clear();
+    }
+    auto curve = std::make_shared<const CubicBezier>(x1, y1, x2, y2);
+    g_curves.emplace(key, curve);
+    return curve;
+}
+
+} // namespace SDK
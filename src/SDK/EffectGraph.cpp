@@ -0,0 +1,165 @@
+#include "../../include/SDK/EffectGraph.h"
+#include "../../include/SDK/PixelKernels.h"
+#include "../../include/SDK/TileScheduler.h"
+#include <algorithm>
+
+namespace SDK {
+
+namespace {
+    // PixelKernels::Bloom's default, which ApplyBloom uses
+    constexpr int BLOOM_RADIUS = 5;
+
+    bool SameSettings(const EffectGraph::Settings& a, const EffectGraph::Settings& b) {
+        return a.enableBlur == b.enableBlur && a.blurRadius == b.blurRadius &&
+               a.enableBloom == b.enableBloom && a.bloomThreshold == b.bloomThreshold &&
+               a.bloomIntensity == b.bloomIntensity &&
+               a.enableDepthOfField == b.enableDepthOfField && a.focalDepth == b.focalDepth &&
+               a.dofBlurAmount == b.dofBlurAmount && a.focalRange == b.focalRange &&
+               a.enableMotionBlur == b.enableMotionBlur && a.motionDirX == b.motionDirX &&
+               a.motionDirY == b.motionDirY && a.motionIntensity == b.motionIntensity &&
+               a.enableChromaticAberration == b.enableChromaticAberration &&
+               a.chromaticStrength == b.chromaticStrength &&
+               a.chromaticOffsetX == b.chromaticOffsetX && a.chromaticOffsetY == b.chromaticOffsetY;
+    }
+
+    // Stages that write each output row from that row alone, or from a snapshot
+    bool IsRowLocal(EffectGraph::StageType type) {
+        return type == EffectGraph::StageType::DEPTH_OF_FIELD ||
+               type == EffectGraph::StageType::MOTION_BLUR ||
+               type == EffectGraph::StageType::CHROMATIC_ABERRATION;
+    }
+}
+
+EffectGraph::EffectGraph()
+    : m_settings()
+    , m_compiled(false)
+{
+}
+
+void EffectGraph::Compile(const Settings& settings) {
+    m_settings = settings;
+    m_compiled = true;
+    m_stages.clear();
+
+    // The order RenderBackend has always applied them in
+    if (settings.enableBlur && settings.blurRadius > 0) {
+        m_stages.push_back({ StageType::BLUR, false });
+    }
+    if (settings.enableDepthOfField && settings.dofBlurAmount > 0 && settings.focalRange > 0.0f) {
+        m_stages.push_back({ StageType::DEPTH_OF_FIELD, false });
+    }
+    if (settings.enableMotionBlur && settings.motionIntensity > 0.0f) {
+        m_stages.push_back({ StageType::MOTION_BLUR, false });
+    }
+    if (settings.enableChromaticAberration && settings.chromaticStrength != 0.0f &&
+        (settings.chromaticOffsetX != 0 || settings.chromaticOffsetY != 0)) {
+        m_stages.push_back({ StageType::CHROMATIC_ABERRATION, false });
+    }
+    if (settings.enableBloom) {
+        if (!m_stages.empty() && IsRowLocal(m_stages.back().type)) {
+            m_stages.back().extractsBloom = true;
+        }
+        m_stages.push_back({ StageType::BLOOM, false });
+    }
+}
+
+bool EffectGraph::IsCompiledFrom(const Settings& settings) const {
+    return m_compiled && SameSettings(m_settings, settings);
+}
+
+template<typename Body>
+void EffectGraph::RunRows(const Stage& stage, uint32_t* pixels, int width, int height, int stride, Body&& body) {
+    if (stage.extractsBloom) {
+        m_bright.resize((size_t)width * height);
+    }
+
+    TileScheduler::ForEachRowBand(width, height, [&](int begin, int end) {
+        body(begin, end);
+        if (stage.extractsBloom) {
+            PixelKernels::ExtractBright(pixels + (size_t)begin * stride, width, end - begin, stride,
+                                        m_settings.bloomThreshold, m_settings.bloomIntensity,
+                                        m_bright.data() + (size_t)begin * width);
+        }
+    });
+}
+
+void EffectGraph::Snapshot(const uint32_t* pixels, int width, int height, int stride) {
+    m_snapshot.resize((size_t)width * height);
+    TileScheduler::ForEachRowBand(width, height, [&](int begin, int end) {
+        for (int y = begin; y < end; y++) {
+            std::copy(pixels + (size_t)y * stride, pixels + (size_t)y * stride + width,
+                      m_snapshot.data() + (size_t)y * width);
+        }
+    });
+}
+
+void EffectGraph::Run(uint32_t* pixels, int width, int height, int stride, int focalDepth) {
+    if (!pixels || width <= 0 || height <= 0 || m_stages.empty()) return;
+
+    const Settings& s = m_settings;
+    bool extracted = false;
+
+    for (const Stage& stage : m_stages) {
+        switch (stage.type) {
+            case StageType::BLUR:
+                PixelKernels::BoxBlur(pixels, width, height, stride, s.blurRadius);
+                break;
+
+            case StageType::DEPTH_OF_FIELD:
+                RunRows(stage, pixels, width, height, stride, [&](int begin, int end) {
+                    PixelKernels::DepthOfFieldRows(pixels, width, height, stride, begin, end,
+                                                   focalDepth, s.dofBlurAmount, s.focalRange);
+                });
+                break;
+
+            case StageType::MOTION_BLUR:
+                Snapshot(pixels, width, height, stride);
+                RunRows(stage, pixels, width, height, stride, [&](int begin, int end) {
+                    PixelKernels::MotionBlurRows(pixels, m_snapshot.data(), width, height, stride, begin, end,
+                                                 s.motionDirX, s.motionDirY, s.motionIntensity);
+                });
+                break;
+
+            case StageType::CHROMATIC_ABERRATION: {
+                // Truncated as ChromaticAberration does; a sub-pixel shift only
+                // shows on backends that sample between pixels
+                int shiftX = (int)(s.chromaticOffsetX * s.chromaticStrength);
+                int shiftY = (int)(s.chromaticOffsetY * s.chromaticStrength);
+                bool shifted = shiftX != 0 || shiftY != 0;
+                if (shifted) Snapshot(pixels, width, height, stride);
+                RunRows(stage, pixels, width, height, stride, [&](int begin, int end) {
+                    if (!shifted) return;
+                    PixelKernels::ChromaticAberrationRows(pixels, m_snapshot.data(), width, height, stride,
+                                                          begin, end, shiftX, shiftY);
+                });
+                break;
+            }
+
+            case StageType::BLOOM:
+                if (!extracted) {
+                    m_bright.resize((size_t)width * height);
+                    TileScheduler::ForEachRowBand(width, height, [&](int begin, int end) {
+                        PixelKernels::ExtractBright(pixels + (size_t)begin * stride, width, end - begin, stride,
+                                                    s.bloomThreshold, s.bloomIntensity,
+                                                    m_bright.data() + (size_t)begin * width);
+                    });
+                }
+                PixelKernels::BoxBlur(m_bright.data(), width, height, width, BLOOM_RADIUS);
+                TileScheduler::ForEachRowBand(width, height, [&](int begin, int end) {
+                    for (int y = begin; y < end; y++) {
+                        PixelKernels::AddSaturate(pixels + (size_t)y * stride, m_bright.data() + (size_t)y * width,
+                                                  (size_t)width);
+                    }
+                });
+                break;
+        }
+        extracted = stage.extractsBloom;
+    }
+}
+
+void EffectGraph::ReleaseBuffers() {
+    std::vector<uint32_t>().swap(m_snapshot);
+    std::vector<uint32_t>().swap(m_bright);
+}
+
+} // namespace SDK
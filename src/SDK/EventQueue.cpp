@@ -0,0 +1,155 @@
+#include "../../include/SDK/EventQueue.h"
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+namespace SDK {
+
+namespace {
+    constexpr uint32_t NONE = 0xFFFFFFFFu;
+
+    struct Entry {
+        Widget* widget;     // Null once flushed or cancelled
+        WidgetEvent event;
+        void* data;
+    };
+
+    // Pending entry per coalescable event
+    struct Slots {
+        uint32_t index[3] = { NONE, NONE, NONE };
+    };
+
+    struct ThreadQueue {
+        std::vector<Entry> pending;
+        std::unordered_map<Widget*, Slots> slots;
+        std::vector<Entry> batch;       // Being dispatched
+        bool dispatching = false;
+        size_t live = 0;
+        EventQueue::Stats stats = {};
+    };
+
+    ThreadQueue& GetQueue() {
+        thread_local ThreadQueue queue;
+        return queue;
+    }
+
+    int SlotOf(WidgetEvent event) {
+        switch (event) {
+        case WidgetEvent::MOUSE_MOVE: return 0;
+        case WidgetEvent::TEXT_CHANGED: return 1;
+        case WidgetEvent::VALUE_CHANGED: return 2;
+        default: return -1;
+        }
+    }
+}
+
+bool EventQueue::IsCoalescable(WidgetEvent event) {
+    return SlotOf(event) >= 0;
+}
+
+void EventQueue::Post(Widget* widget, WidgetEvent event, void* data) {
+    if (!widget) return;
+    int slot = SlotOf(event);
+    if (slot < 0) {
+        Flush(widget);
+        widget->DeliverEvent(event, data);
+        return;
+    }
+
+    ThreadQueue& queue = GetQueue();
+    queue.stats.posted++;
+    uint32_t& index = queue.slots[widget].index[slot];
+    if (index != NONE) {
+        queue.pending[index].data = data;
+        queue.stats.coalesced++;
+        return;
+    }
+    index = (uint32_t)queue.pending.size();
+    queue.pending.push_back({ widget, event, data });
+    queue.live++;
+}
+
+size_t EventQueue::Dispatch() {
+    ThreadQueue& queue = GetQueue();
+    if (queue.dispatching) return 0;
+    if (queue.live == 0) {
+        queue.pending.clear();      // Only flushed or cancelled entries
+        return 0;
+    }
+
+    queue.batch.swap(queue.pending);
+    queue.slots.clear();
+    queue.live = 0;
+    queue.dispatching = true;
+
+    size_t delivered = 0;
+    for (size_t i = 0; i < queue.batch.size(); i++) {
+        Entry entry = queue.batch[i];   // Handlers may cancel later entries
+        if (!entry.widget) continue;
+        entry.widget->DeliverEvent(entry.event, entry.data);
+        delivered++;
+    }
+
+    queue.batch.clear();
+    queue.dispatching = false;
+    queue.stats.dispatched += delivered;
+    return delivered;
+}
+
+void EventQueue::Flush(Widget* widget) {
+    ThreadQueue& queue = GetQueue();
+    auto it = queue.slots.find(widget);
+    if (it == queue.slots.end()) return;
+
+    // Taken out first; the handlers may post again
+    Slots slots = it->second;
+    queue.slots.erase(it);
+    std::sort(slots.index, slots.index + 3);
+
+    Entry entries[3];
+    int count = 0;
+    for (uint32_t index : slots.index) {
+        if (index == NONE) continue;
+        entries[count++] = queue.pending[index];
+        queue.pending[index].widget = nullptr;
+        queue.live--;
+    }
+    for (int i = 0; i < count; i++) {
+        widget->DeliverEvent(entries[i].event, entries[i].data);
+    }
+    queue.stats.dispatched += count;
+}
+
+void EventQueue::Cancel(Widget* widget) {
+    ThreadQueue& queue = GetQueue();
+    auto it = queue.slots.find(widget);
+    if (it != queue.slots.end()) {
+        for (uint32_t index : it->second.index) {
+            if (index == NONE) continue;
+            queue.pending[index].widget = nullptr;
+            queue.live--;
+        }
+        queue.slots.erase(it);
+    }
+
+    // A handler in the running batch may destroy a widget still to come
+    if (queue.dispatching) {
+        for (auto& entry : queue.batch) {
+            if (entry.widget == widget) entry.widget = nullptr;
+        }
+    }
+}
+
+size_t EventQueue::GetPendingCount() {
+    return GetQueue().live;
+}
+
+EventQueue::Stats EventQueue::GetStats() {
+    return GetQueue().stats;
+}
+
+void EventQueue::ResetStats() {
+    GetQueue().stats = {};
+}
+
+} // namespace SDK
@@ -0,0 +1,151 @@
+#include "../../include/SDK/FontCache.h"
+#include "../../include/SDK/GdiObjectCache.h"
+#include <mutex>
+#include <unordered_map>
+
+namespace SDK {
+
+namespace {
+    constexpr size_t DEFAULT_CAPACITY = 64;
+
+    struct CacheEntry {
+        FontCache::FontPtr font;
+        uint64_t lastUse;
+    };
+
+    std::mutex g_cacheMutex;
+    std::unordered_map<std::wstring, CacheEntry> g_cache;
+    size_t g_capacity = DEFAULT_CAPACITY;
+    uint64_t g_clock = 0;
+    uint64_t g_hits = 0;
+    uint64_t g_misses = 0;
+    uint64_t g_evictions = 0;
+
+    std::wstring MakeKey(const std::wstring& family, int height, int weight, bool italic, bool underline, bool strikeout) {
+        std::wstring key = family;
+        key.push_back(L'\0');
+        key.append(std::to_wstring(height));
+        key.push_back(L'/');
+        key.append(std::to_wstring(weight));
+        key.push_back(italic ? L'i' : L'-');
+        key.push_back(underline ? L'u' : L'-');
+        key.push_back(strikeout ? L's' : L'-');
+        return key;
+    }
+
+    // Prefers fonts nobody else holds; those would outlive eviction anyway
+    void EvictOldest() {
+        auto oldest = g_cache.end();
+        auto oldestIdle = g_cache.end();
+        for (auto it = g_cache.begin(); it != g_cache.end(); ++it) {
+            if (oldest == g_cache.end() || it->second.lastUse < oldest->second.lastUse) oldest = it;
+            if (it->second.font.use_count() == 1 &&
+                (oldestIdle == g_cache.end() || it->second.lastUse < oldestIdle->second.lastUse)) {
+                oldestIdle = it;
+            }
+        }
+        auto victim = oldestIdle != g_cache.end() ? oldestIdle : oldest;
+        if (victim != g_cache.end()) {
+            g_cache.erase(victim);
+            g_evictions++;
+        }
+    }
+}
+
+FontCache::Font::~Font() {
+    if (handle) {
+        DeleteObject(handle);
+        GdiHandleCounter::Remove(GdiSubsystem::FONTS);
+    }
+}
+
+FontCache::FontPtr FontCache::Get(const std::wstring& family, int size, int weight,
+                                  bool italic, bool underline, bool strikeout, int dpi) {
+    // Scale here so fonts for different DPIs get distinct entries
+    int height = MulDiv(size, dpi > 0 ? dpi : 96, 96);
+    std::wstring key = MakeKey(family, height, weight, italic, underline, strikeout);
+
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    auto it = g_cache.find(key);
+    if (it != g_cache.end()) {
+        it->second.lastUse = ++g_clock;
+        g_hits++;
+        return it->second.font;
+    }
+
+    g_misses++;
+    HFONT handle = CreateFontW(
+        height, 0, 0, 0, weight,
+        italic ? TRUE : FALSE, underline ? TRUE : FALSE, strikeout ? TRUE : FALSE,
+        DEFAULT_CHARSET, OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS,
+        CLEARTYPE_QUALITY, DEFAULT_PITCH | FF_DONTCARE,
+        family.c_str()
+    );
+    if (handle) GdiHandleCounter::Add(GdiSubsystem::FONTS);
+    auto font = std::make_shared<const Font>(handle);
+    if (!handle || g_capacity == 0) return font;
+
+    while (g_cache.size() >= g_capacity) {
+        EvictOldest();
+    }
+    g_cache[key] = { font, ++g_clock };
+    return font;
+}
+
+FontCache::Stats FontCache::GetStats() {
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    Stats stats;
+    stats.hits = g_hits;
+    stats.misses = g_misses;
+    stats.evictions = g_evictions;
+    stats.size = g_cache.size();
+    stats.inUse = 0;
+    for (const auto& pair : g_cache) {
+        if (pair.second.font.use_count() > 1) stats.inUse++;
+    }
+    return stats;
+}
+
+void FontCache::ResetStats() {
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    g_hits = 0;
+    g_misses = 0;
+    g_evictions = 0;
+}
+
+void FontCache::SetCapacity(size_t maxFonts) {
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    g_capacity = maxFonts;
+    while (g_cache.size() > g_capacity) {
+        EvictOldest();
+    }
+}
+
+void FontCache::Clear() {
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    g_cache.clear();
+}
+
+size_t FontCache::GetSize() {
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    return g_cache.size();
+}
+
+// ScopedFont
+ScopedFont::ScopedFont(HDC hdc, FontCache::FontPtr font)
+    : m_hdc(hdc)
+    , m_font(std::move(font))
+    , m_oldFont(nullptr)
+{
+    if (m_hdc && m_font && m_font->handle) {
+        m_oldFont = SelectObject(m_hdc, m_font->handle);
+    }
+}
+
+ScopedFont::~ScopedFont() {
+    if (m_oldFont) {
+        SelectObject(m_hdc, m_oldFont);
+    }
+}
+
+} // namespace SDK
@@ -0,0 +1,171 @@
+#include "../../include/SDK/FrameArena.h"
+#include "../../include/SDK/MemoryRegistry.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace SDK {
+
+namespace {
+    constexpr size_t DEFAULT_RETAIN_LIMIT = 32 * 1024 * 1024;
+
+    std::atomic<size_t> g_retainLimit(DEFAULT_RETAIN_LIMIT);
+    std::atomic<size_t> g_reserved(0);          // Across threads
+    std::atomic<uint64_t> g_trimGeneration(0);  // Bumped to make every thread free its blocks
+
+    class ThreadArena : public std::pmr::memory_resource {
+    public:
+        struct Block {
+            std::unique_ptr<unsigned char[]> data;
+            size_t size;
+        };
+
+        std::vector<Block> blocks;
+        size_t block = 0;       // Block being filled
+        size_t offset = 0;      // Into that block
+        size_t base = 0;        // Bytes in the blocks before it
+        size_t frameHigh = 0;   // Furthest position this frame
+        size_t reserved = 0;
+        int scopes = 0;
+
+        size_t peak = 0;
+        uint64_t frames = 0;
+        uint64_t heapAllocations = 0;
+        uint64_t lastFrameHeapAllocations = 0;
+        uint64_t totalHeapAllocations = 0;
+        uint64_t trimGeneration = g_trimGeneration.load(std::memory_order_relaxed);
+
+        ~ThreadArena() override { Release(); }
+
+        void Release() {
+            g_reserved.fetch_sub(reserved, std::memory_order_relaxed);
+            blocks.clear();
+            reserved = 0;
+            block = offset = base = 0;
+        }
+
+        void AddBlock(size_t size) {
+            blocks.push_back({ std::unique_ptr<unsigned char[]>(new unsigned char[size]), size });
+            reserved += size;
+            g_reserved.fetch_add(size, std::memory_order_relaxed);
+            heapAllocations++;
+            totalHeapAllocations++;
+        }
+
+        void Rewind(size_t toBlock, size_t toOffset) {
+            block = toBlock;
+            offset = toOffset;
+            base = 0;
+            for (size_t i = 0; i < block && i < blocks.size(); i++) {
+                base += blocks[i].size;
+            }
+        }
+
+        void EndFrame() {
+            if (scopes > 0) return;
+            frames++;
+            peak = std::max(peak, frameHigh);
+
+            uint64_t generation = g_trimGeneration.load(std::memory_order_relaxed);
+            if (generation != trimGeneration || reserved > g_retainLimit.load(std::memory_order_relaxed)) {
+                trimGeneration = generation;
+                Release();
+            } else if (blocks.size() > 1) {
+                // One block that holds what this frame needed, so the next one fits
+                size_t total = reserved;
+                Release();
+                AddBlock(total);
+            }
+            lastFrameHeapAllocations = heapAllocations;
+            heapAllocations = 0;
+            frameHigh = 0;
+            Rewind(0, 0);
+        }
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            for (;;) {
+                if (block < blocks.size()) {
+                    unsigned char* data = blocks[block].data.get();
+                    uintptr_t cursor = (uintptr_t)(data + offset);
+                    uintptr_t aligned = (cursor + alignment - 1) & ~(uintptr_t)(alignment - 1);
+                    if (aligned + bytes <= (uintptr_t)(data + blocks[block].size)) {
+                        offset = (size_t)(aligned - (uintptr_t)data) + bytes;
+                        frameHigh = std::max(frameHigh, base + offset);
+                        return (void*)aligned;
+                    }
+                    if (block + 1 < blocks.size()) {
+                        base += blocks[block].size;
+                        block++;
+                        offset = 0;
+                        continue;
+                    }
+                    base += blocks[block].size;
+                }
+                // Oversized requests get a block of their own
+                AddBlock(std::max(FrameArena::DEFAULT_BLOCK_SIZE, bytes + alignment));
+                block = blocks.size() - 1;
+                offset = 0;
+            }
+        }
+
+        void do_deallocate(void*, size_t, size_t) override {}     // Given back by Scope and EndFrame()
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    thread_local ThreadArena t_arena;
+
+    // Other threads' blocks can't be freed from here, so a trim asks every
+    // thread to free its blocks at its next EndFrame()
+    MemoryRegistry::Source g_memorySource("FrameArena",
+        []() { return g_reserved.load(std::memory_order_relaxed); },
+        [](size_t) { g_trimGeneration.fetch_add(1, std::memory_order_relaxed); });
+}
+
+std::pmr::memory_resource* FrameArena::GetResource() {
+    return &t_arena;
+}
+
+void* FrameArena::Allocate(size_t size, size_t alignment) {
+    return t_arena.allocate(size, alignment);
+}
+
+FrameArena::Scope::Scope()
+    : m_block(t_arena.block)
+    , m_offset(t_arena.offset) {
+    t_arena.scopes++;
+}
+
+FrameArena::Scope::~Scope() {
+    t_arena.Rewind(m_block, m_offset);
+    t_arena.scopes--;
+}
+
+void FrameArena::EndFrame() {
+    t_arena.EndFrame();
+}
+
+void FrameArena::SetRetainLimit(size_t bytes) {
+    g_retainLimit.store(bytes, std::memory_order_relaxed);
+}
+
+size_t FrameArena::GetRetainLimit() {
+    return g_retainLimit.load(std::memory_order_relaxed);
+}
+
+FrameArena::Stats FrameArena::GetStats() {
+    Stats stats;
+    stats.bytesUsed = t_arena.base + t_arena.offset;
+    stats.bytesReserved = t_arena.reserved;
+    stats.peakBytes = std::max(t_arena.peak, t_arena.frameHigh);
+    stats.frames = t_arena.frames;
+    stats.heapAllocations = t_arena.heapAllocations;
+    stats.lastFrameHeapAllocations = t_arena.lastFrameHeapAllocations;
+    stats.totalHeapAllocations = t_arena.totalHeapAllocations;
+    return stats;
+}
+
+} // namespace SDK
@@ -0,0 +1,134 @@
+#include "../../include/SDK/FrameClock.h"
+#include "../../include/SDK/Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#if SDK_PLATFORM_WINDOWS
+#include <dwmapi.h>
+#pragma comment(lib, "dwmapi.lib")
+#endif
+
+namespace SDK {
+
+namespace {
+    constexpr double DEFAULT_REFRESH_RATE = 60.0;
+
+    // Outside this range the compositor's answer is taken as bogus
+    constexpr double MIN_REFRESH_RATE = 10.0;
+    constexpr double MAX_REFRESH_RATE = 1000.0;
+
+    float Seconds(std::chrono::steady_clock::duration duration) {
+        return std::chrono::duration<float>(duration).count();
+    }
+}
+
+FrameClock::FrameClock()
+    : m_refreshRate(DEFAULT_REFRESH_RATE)
+    , m_interval(0)
+    , m_vsync(true)
+    , m_started(false)
+    , m_historyNext(0)
+    , m_historyCount(0)
+{
+    double rate = DEFAULT_REFRESH_RATE;
+#if SDK_PLATFORM_WINDOWS
+    DWM_TIMING_INFO info = {};
+    info.cbSize = sizeof(info);
+    if (SUCCEEDED(DwmGetCompositionTimingInfo(nullptr, &info)) && info.rateRefresh.uiDenominator != 0) {
+        rate = (double)info.rateRefresh.uiNumerator / (double)info.rateRefresh.uiDenominator;
+    }
+#endif
+    SetRefreshRate(rate);
+}
+
+void FrameClock::SetRefreshRate(double hz) {
+    if (!(hz >= MIN_REFRESH_RATE && hz <= MAX_REFRESH_RATE)) hz = DEFAULT_REFRESH_RATE;
+    m_refreshRate = hz;
+    m_interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(1.0 / hz));
+}
+
+bool FrameClock::WaitForVBlank() {
+#if SDK_PLATFORM_WINDOWS
+    // Fails when composition is off (e.g. some remote sessions); the timer takes over
+    BOOL composited = FALSE;
+    if (SUCCEEDED(DwmIsCompositionEnabled(&composited)) && composited) {
+        return SUCCEEDED(DwmFlush());
+    }
+#endif
+    return false;
+}
+
+FrameClock::TimePoint FrameClock::BeginFrame() {
+    SDK_PROFILE_ZONE("FrameClock::BeginFrame");
+    TimePoint waitStart = std::chrono::steady_clock::now();
+
+    bool vsync = m_vsync && WaitForVBlank();
+    if (!vsync) {
+        if (!m_started) {
+            m_deadline = waitStart;
+        } else if (waitStart > m_deadline) {
+            // Late: start now and keep the next deadline on the grid
+            auto behind = (waitStart - m_deadline) / m_interval;
+            m_deadline += m_interval * behind;
+        } else {
+            std::this_thread::sleep_until(m_deadline);
+        }
+        m_deadline += m_interval;
+    }
+
+    TimePoint now = std::chrono::steady_clock::now();
+    FrameTiming timing;
+    timing.frameIndex = m_started ? m_timing.frameIndex + 1 : 0;
+    timing.waitTime = Seconds(now - waitStart);
+    timing.vsync = vsync;
+    if (m_started) {
+        timing.deltaTime = Seconds(now - m_frameTime);
+        float intervals = timing.deltaTime * (float)m_refreshRate;
+        timing.missedRefreshes = std::max(0, (int)std::lround(intervals) - 1);
+    }
+    m_timing = timing;
+    m_frameTime = now;
+    m_started = true;
+
+    if (m_timing.frameIndex > 0) {
+        m_history[m_historyNext] = m_timing.deltaTime;
+        m_historyNext = (m_historyNext + 1) % FRAME_HISTORY_SIZE;
+        m_historyCount = std::min(m_historyCount + 1, FRAME_HISTORY_SIZE);
+    }
+    return now;
+}
+
+void FrameClock::EndFrame(int windowsRendered, int windowsSkipped, int windowsCulled) {
+    m_timing.workTime = Seconds(std::chrono::steady_clock::now() - m_frameTime);
+    m_timing.windowsRendered = windowsRendered;
+    m_timing.windowsSkipped = windowsSkipped;
+    m_timing.windowsCulled = windowsCulled;
+    m_lastTiming = m_timing;
+
+    if (m_frameCallback) {
+        m_frameCallback(m_lastTiming);
+    }
+}
+
+float FrameClock::GetAverageFrameTime() const {
+    if (m_historyCount == 0) return 0.0f;
+
+    float total = 0.0f;
+    for (int i = 0; i < m_historyCount; i++) {
+        total += m_history[i];
+    }
+    return total / (float)m_historyCount;
+}
+
+int FrameClock::GetFrameTimeHistory(float* deltas, int maxCount) const {
+    int count = std::min(maxCount, m_historyCount);
+    int start = (m_historyNext - count + FRAME_HISTORY_SIZE) % FRAME_HISTORY_SIZE;
+    for (int i = 0; i < count; i++) {
+        deltas[i] = m_history[(start + i) % FRAME_HISTORY_SIZE];
+    }
+    return count;
+}
+
+} // namespace SDK
@@ -1,5 +1,8 @@
 #include "../../include/SDK/GDIRenderBackend.h"
 #include "../../include/SDK/Renderer.h"
+#include "../../include/SDK/FontCache.h"
+#include "../../include/SDK/PixelKernels.h"
+#include "../../include/SDK/EffectGraph.h"
 #include <vector>
 #include <algorithm>
 
@@ -99,9 +102,8 @@ void GDIRenderBackend::Clear(Color color) {
     if (!m_memDC) return;
     
     RECT rc = { 0, 0, m_width, m_height };
-    HBRUSH brush = CreateSolidBrush(RGB(color.r, color.g, color.b));
+    HBRUSH brush = GdiObjectCache::GetBrush(RGB(color.r, color.g, color.b));
     FillRect(m_memDC, &rc, brush);
-    DeleteObject(brush);
 }
 
 HDC GDIRenderBackend::GetDC() const {
@@ -115,8 +117,8 @@ void* GDIRenderBackend::GetNativeContext() const {
 void GDIRenderBackend::DrawRectangle(const RECT& rect, Color fillColor, Color borderColor, float borderWidth) {
     if (!m_memDC) return;
     
-    HBRUSH brush = CreateSolidBrush(RGB(fillColor.r, fillColor.g, fillColor.b));
-    HPEN pen = CreatePen(PS_SOLID, (int)borderWidth, RGB(borderColor.r, borderColor.g, borderColor.b));
+    HBRUSH brush = GdiObjectCache::GetBrush(RGB(fillColor.r, fillColor.g, fillColor.b));
+    HPEN pen = GdiObjectCache::GetPen(RGB(borderColor.r, borderColor.g, borderColor.b), (int)borderWidth);
     
     HBRUSH oldBrush = (HBRUSH)SelectObject(m_memDC, brush);
     HPEN oldPen = (HPEN)SelectObject(m_memDC, pen);
@@ -125,8 +127,6 @@ void GDIRenderBackend::DrawRectangle(const RECT& rect, Color fillColor, Color bo
     
     SelectObject(m_memDC, oldPen);
     SelectObject(m_memDC, oldBrush);
-    DeleteObject(pen);
-    DeleteObject(brush);
 }
 
 void GDIRenderBackend::DrawRoundedRectangle(const RECT& rect, float radius, Color fillColor, Color borderColor, float borderWidth) {
@@ -139,21 +139,20 @@ void GDIRenderBackend::DrawRoundedRectangle(const RECT& rect, float radius, Colo
 void GDIRenderBackend::DrawLine(int x1, int y1, int x2, int y2, Color color, float width) {
     if (!m_memDC) return;
     
-    HPEN pen = CreatePen(PS_SOLID, (int)width, RGB(color.r, color.g, color.b));
+    HPEN pen = GdiObjectCache::GetPen(RGB(color.r, color.g, color.b), (int)width);
     HPEN oldPen = (HPEN)SelectObject(m_memDC, pen);
     
     MoveToEx(m_memDC, x1, y1, nullptr);
     LineTo(m_memDC, x2, y2);
     
     SelectObject(m_memDC, oldPen);
-    DeleteObject(pen);
 }
 
 void GDIRenderBackend::DrawEllipse(int cx, int cy, int rx, int ry, Color fillColor, Color borderColor, float borderWidth) {
     if (!m_memDC) return;
     
-    HBRUSH brush = CreateSolidBrush(RGB(fillColor.r, fillColor.g, fillColor.b));
-    HPEN pen = CreatePen(PS_SOLID, (int)borderWidth, RGB(borderColor.r, borderColor.g, borderColor.b));
+    HBRUSH brush = GdiObjectCache::GetBrush(RGB(fillColor.r, fillColor.g, fillColor.b));
+    HPEN pen = GdiObjectCache::GetPen(RGB(borderColor.r, borderColor.g, borderColor.b), (int)borderWidth);
     
     HBRUSH oldBrush = (HBRUSH)SelectObject(m_memDC, brush);
     HPEN oldPen = (HPEN)SelectObject(m_memDC, pen);
@@ -162,29 +161,42 @@ void GDIRenderBackend::DrawEllipse(int cx, int cy, int rx, int ry, Color fillCol
     
     SelectObject(m_memDC, oldPen);
     SelectObject(m_memDC, oldBrush);
-    DeleteObject(pen);
-    DeleteObject(brush);
 }
 
 void GDIRenderBackend::DrawText(const std::wstring& text, const RECT& rect, Color color, const std::wstring& fontFamily, float fontSize, int fontWeight) {
     if (!m_memDC) return;
     
-    HFONT font = CreateFontW(
-        (int)fontSize, 0, 0, 0, fontWeight,
-        FALSE, FALSE, FALSE,
-        DEFAULT_CHARSET, OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS,
-        CLEARTYPE_QUALITY, DEFAULT_PITCH | FF_DONTCARE,
-        fontFamily.c_str()
-    );
-    
-    HFONT oldFont = (HFONT)SelectObject(m_memDC, font);
+    ScopedFont font(m_memDC, FontCache::Get(fontFamily, (int)fontSize, fontWeight));
     SetTextColor(m_memDC, RGB(color.r, color.g, color.b));
     SetBkMode(m_memDC, TRANSPARENT);
     
     DrawTextW(m_memDC, text.c_str(), -1, (LPRECT)&rect, DT_LEFT | DT_TOP | DT_WORDBREAK);
+}
+
+void GDIRenderBackend::DrawTextLine(const std::wstring& text, const RECT& rect, Color color, const std::wstring& fontFamily, float fontSize, int fontWeight, TextAlign align) {
+    if (!m_memDC) return;
+    
+    UINT format = DT_SINGLELINE | DT_VCENTER;
+    if (align == TextAlign::CENTER) {
+        format |= DT_CENTER;
+    } else if (align == TextAlign::RIGHT) {
+        format |= DT_RIGHT;
+    }
+    
+    ScopedFont font(m_memDC, FontCache::Get(fontFamily, (int)fontSize, fontWeight));
+    SetTextColor(m_memDC, RGB(color.r, color.g, color.b));
+    SetBkMode(m_memDC, TRANSPARENT);
     
-    SelectObject(m_memDC, oldFont);
-    DeleteObject(font);
+    ::DrawTextW(m_memDC, text.c_str(), -1, (LPRECT)&rect, format);
+}
+
+int GDIRenderBackend::MeasureText(const std::wstring& text, const std::wstring& fontFamily, float fontSize, int fontWeight) {
+    if (!m_memDC) return RenderBackend::MeasureText(text, fontFamily, fontSize, fontWeight);
+    
+    ScopedFont font(m_memDC, FontCache::Get(fontFamily, (int)fontSize, fontWeight));
+    SIZE size = {};
+    GetTextExtentPoint32W(m_memDC, text.c_str(), (int)text.length(), &size);
+    return size.cx;
 }
 
 void GDIRenderBackend::DrawLinearGradient(const RECT& rect, Color startColor, Color endColor, bool horizontal) {
@@ -232,6 +244,14 @@ void GDIRenderBackend::ApplyBloom(const RECT& rect, float threshold, float inten
 void GDIRenderBackend::ApplyDepthOfField(const RECT& rect, int focalDepth, int blurAmount, float focalRange) {
     if (!m_memDC) return;
     
+    Renderer::PixelSurface surface;
+    if (Renderer::BeginPixelAccess(m_memDC, rect, surface)) {
+        PixelKernels::DepthOfField(surface.pixels, surface.width, surface.height, surface.width,
+                                   focalDepth, blurAmount, focalRange);
+        Renderer::EndPixelAccess(m_memDC, rect, surface);
+        return;
+    }
+    
     // Software depth of field implementation
     // Create a depth-based blur effect where areas outside focal range are blurred
     int centerY = (rect.top + rect.bottom) / 2;
@@ -254,6 +274,14 @@ void GDIRenderBackend::ApplyDepthOfField(const RECT& rect, int focalDepth, int b
 void GDIRenderBackend::ApplyMotionBlur(const RECT& rect, int directionX, int directionY, float intensity) {
     if (!m_memDC) return;
     
+    Renderer::PixelSurface surface;
+    if (Renderer::BeginPixelAccess(m_memDC, rect, surface)) {
+        PixelKernels::MotionBlur(surface.pixels, surface.width, surface.height, surface.width,
+                                 directionX, directionY, intensity);
+        Renderer::EndPixelAccess(m_memDC, rect, surface);
+        return;
+    }
+    
     // Software motion blur implementation
     // Create directional blur by sampling pixels along motion vector
     int width = rect.right - rect.left;
@@ -288,6 +316,14 @@ void GDIRenderBackend::ApplyMotionBlur(const RECT& rect, int directionX, int dir
 void GDIRenderBackend::ApplyChromaticAberration(const RECT& rect, float strength, int offsetX, int offsetY) {
     if (!m_memDC) return;
     
+    Renderer::PixelSurface surface;
+    if (Renderer::BeginPixelAccess(m_memDC, rect, surface)) {
+        PixelKernels::ChromaticAberration(surface.pixels, surface.width, surface.height, surface.width,
+                                          strength, offsetX, offsetY);
+        Renderer::EndPixelAccess(m_memDC, rect, surface);
+        return;
+    }
+    
     // Software chromatic aberration implementation
     // Shift color channels to simulate lens distortion
     int width = rect.right - rect.left;
@@ -340,6 +376,43 @@ void GDIRenderBackend::ApplyChromaticAberration(const RECT& rect, float strength
     SetDIBits(m_memDC, m_memBitmap, rect.top, height, result.data(), &bmi, DIB_RGB_COLORS);
 }
 
+void GDIRenderBackend::ApplyEffectGraph(const RECT& rect, EffectGraph& graph) {
+    if (!m_memDC || graph.IsEmpty()) return;
+    
+    Renderer::PixelSurface surface;
+    if (Renderer::BeginPixelAccess(m_memDC, rect, surface)) {
+        graph.Run(surface.pixels, surface.width, surface.height, surface.width);
+        Renderer::EndPixelAccess(m_memDC, rect, surface);
+        return;
+    }
+    
+    RenderBackend::ApplyEffectGraph(rect, graph);
+}
+
+void GDIRenderBackend::DrawParticleBatch(const float* x, const float* y, const uint32_t* colors, size_t count, int size) {
+    if (!m_memDC) return;
+    
+    RECT clip = { 0, 0, m_width, m_height };
+    RECT bounds;
+    if (!GetParticleBounds(x, y, count, size, clip, bounds)) return;
+    
+    Renderer::PixelSurface surface;
+    if (Renderer::BeginPixelAccess(m_memDC, bounds, surface)) {
+        PixelKernels::SplatParticles(surface.pixels, surface.width, surface.height, surface.width,
+                                     x, y, colors, count, bounds.left, bounds.top, size);
+        Renderer::EndPixelAccess(m_memDC, bounds, surface);
+        return;
+    }
+    
+    RenderBackend::DrawParticleBatch(x, y, colors, count, size);
+}
+
+void GDIRenderBackend::DrawPolylines(const POINT* points, const DWORD* counts, size_t polylineCount, Color color, float width) {
+    if (!m_memDC) return;
+    
+    Renderer::DrawPolylines(m_memDC, points, counts, polylineCount, color, (int)width);
+}
+
 RenderBackend::Capabilities GDIRenderBackend::GetCapabilities() const {
     Capabilities caps;
     caps.supportsGPUAcceleration = false;
@@ -0,0 +1,1423 @@
+#include "SDK/GLRenderBackend.h"
+
+#if SDK_PLATFORM_LINUX && SDK_HAS_X11
+
+#include "SDK/PixelKernels.h"
+#include "SDK/TextureAtlas.h"
+#include "SDK/XftFontSource.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+#ifndef SDK_HAS_OPENGL
+#define SDK_HAS_OPENGL 0
+#endif
+
+#if SDK_HAS_OPENGL
+#include <GL/glx.h>
+#include <GL/glext.h>
+#endif
+
+namespace SDK {
+
+#if SDK_HAS_OPENGL
+// Entry points past OpenGL 1.1, which the GL library need not export
+#define SDK_GL_FUNCTIONS(X) \
+    X(PFNGLACTIVETEXTUREPROC, ActiveTexture) \
+    X(PFNGLCREATESHADERPROC, CreateShader) \
+    X(PFNGLSHADERSOURCEPROC, ShaderSource) \
+    X(PFNGLCOMPILESHADERPROC, CompileShader) \
+    X(PFNGLGETSHADERIVPROC, GetShaderiv) \
+    X(PFNGLDELETESHADERPROC, DeleteShader) \
+    X(PFNGLCREATEPROGRAMPROC, CreateProgram) \
+    X(PFNGLATTACHSHADERPROC, AttachShader) \
+    X(PFNGLLINKPROGRAMPROC, LinkProgram) \
+    X(PFNGLGETPROGRAMIVPROC, GetProgramiv) \
+    X(PFNGLDELETEPROGRAMPROC, DeleteProgram) \
+    X(PFNGLUSEPROGRAMPROC, UseProgram) \
+    X(PFNGLGETUNIFORMLOCATIONPROC, GetUniformLocation) \
+    X(PFNGLUNIFORM1IPROC, Uniform1i) \
+    X(PFNGLUNIFORM2IPROC, Uniform2i) \
+    X(PFNGLUNIFORM4IPROC, Uniform4i) \
+    X(PFNGLUNIFORM2FPROC, Uniform2f) \
+    X(PFNGLUNIFORM4FPROC, Uniform4f) \
+    X(PFNGLGENVERTEXARRAYSPROC, GenVertexArrays) \
+    X(PFNGLBINDVERTEXARRAYPROC, BindVertexArray) \
+    X(PFNGLDELETEVERTEXARRAYSPROC, DeleteVertexArrays) \
+    X(PFNGLGENBUFFERSPROC, GenBuffers) \
+    X(PFNGLBINDBUFFERPROC, BindBuffer) \
+    X(PFNGLBUFFERDATAPROC, BufferData) \
+    X(PFNGLDELETEBUFFERSPROC, DeleteBuffers) \
+    X(PFNGLVERTEXATTRIBPOINTERPROC, VertexAttribPointer) \
+    X(PFNGLENABLEVERTEXATTRIBARRAYPROC, EnableVertexAttribArray) \
+    X(PFNGLGENFRAMEBUFFERSPROC, GenFramebuffers) \
+    X(PFNGLBINDFRAMEBUFFERPROC, BindFramebuffer) \
+    X(PFNGLFRAMEBUFFERTEXTURE2DPROC, FramebufferTexture2D) \
+    X(PFNGLCHECKFRAMEBUFFERSTATUSPROC, CheckFramebufferStatus) \
+    X(PFNGLDELETEFRAMEBUFFERSPROC, DeleteFramebuffers) \
+    X(PFNGLBLITFRAMEBUFFERPROC, BlitFramebuffer)
+
+struct GLFunctions {
+#define SDK_GL_DECLARE(type, name) type name = nullptr;
+    SDK_GL_FUNCTIONS(SDK_GL_DECLARE)
+#undef SDK_GL_DECLARE
+};
+#endif
+
+enum class GLRenderBackend::Kind {
+    SOLID,
+    ROUNDED_RECT,       // p: half width, half height, radius, border width
+    ELLIPSE,            // p: rx, ry, -, border width
+    CAPSULE,            // p: segment x, y, half width
+    LINEAR_GRADIENT,    // p: span, horizontal; straight colors
+    RADIAL_GRADIENT,    // p: radius; straight colors
+    GLYPH,              // local: glyph atlas texels
+    TEXTURE,            // p: entry x, y, scale x, y
+    SHADOW,             // p: width, height, sigma
+    GLOW                // p: width, height, radius
+};
+
+struct GLState {
+#if SDK_HAS_OPENGL
+    struct Vertex {
+        float x, y;
+        float localX, localY;
+        float p[4];
+        uint32_t fill;      // 0xAARRGGBB, read as BGRA bytes
+        uint32_t border;
+        float kind;
+    };
+
+    GLXFBConfig config = nullptr;
+    GLXContext context = nullptr;
+    GLXWindow drawable = 0;
+    GLFunctions gl;
+
+    GLuint drawProgram = 0;
+    GLint drawViewport = -1;
+
+    struct {
+        GLuint program = 0;
+        GLint viewport = -1;
+        GLint effect = -1;
+        GLint rect = -1;
+        GLint height = -1;
+        GLint radius = -1;
+        GLint direction = -1;
+        GLint params = -1;
+    } effect;
+
+    GLuint vertexArray = 0;
+    GLuint vertexBuffer = 0;
+    std::vector<Vertex> vertices;
+    bool pendingGlyphs = false;     // Queued quads sample the textures below
+    bool pendingTextures = false;
+    size_t drawCalls = 0;
+    GLint maxTextureSize = 0;
+
+    // The frame; rows run bottom-up, as everywhere in GL
+    GLuint target = 0;
+    GLuint targetFramebuffer = 0;
+    // Same size as the frame, allocated on the first effect
+    GLuint scratch[2] = {};
+    GLuint scratchFramebuffer[2] = {};
+
+    GLuint glyphTexture = 0;        // R8 mirror of the GlyphAtlas coverage
+    GLuint atlasTexture = 0;
+    const TextureAtlas* atlas = nullptr;
+    uint64_t atlasVersion = 0;
+    int atlasWidth = 0;
+    int atlasHeight = 0;
+#endif
+};
+
+namespace {
+    constexpr int GLYPH_ATLAS_WIDTH = 1024;
+    constexpr int GLYPH_ATLAS_HEIGHT = 512;
+    constexpr int BLOOM_RADIUS = 5;         // As PixelKernels::Bloom
+    constexpr int MOTION_SAMPLES = 5;       // As PixelKernels::MotionBlur
+
+    // Gradient stops go to the shader unpremultiplied
+    uint32_t ToStraight(const Color& color)
+    {
+        return ((uint32_t)color.a << 24) | ((uint32_t)color.r << 16) | ((uint32_t)color.g << 8) | color.b;
+    }
+}
+
+#if SDK_HAS_OPENGL
+namespace {
+    // Texture units, bound once: shapes sample 0 and 1, effects 2
+    constexpr GLenum GLYPH_UNIT = GL_TEXTURE0;
+    constexpr GLenum ATLAS_UNIT = GL_TEXTURE1;
+    constexpr GLenum SOURCE_UNIT = GL_TEXTURE2;
+
+    // Pixel coordinates, top-left origin, to clip space
+    const char* VERTEX_SHADER = R"(#version 330 core
+layout(location = 0) in vec2 a_position;
+layout(location = 1) in vec2 a_local;
+layout(location = 2) in vec4 a_params;
+layout(location = 3) in vec4 a_fill;
+layout(location = 4) in vec4 a_border;
+layout(location = 5) in float a_kind;
+uniform vec2 u_viewport;
+out vec2 v_local;
+flat out vec4 v_params;
+flat out vec4 v_fill;
+flat out vec4 v_border;
+flat out int v_kind;
+void main() {
+    v_local = a_local;
+    v_params = a_params;
+    v_fill = a_fill;
+    v_border = a_border;
+    v_kind = int(a_kind + 0.5);
+    gl_Position = vec4(a_position.x / u_viewport.x * 2.0 - 1.0, 1.0 - a_position.y / u_viewport.y * 2.0, 0.0, 1.0);
+}
+)";
+
+    // One shader for every primitive; outputs premultiplied color
+    const char* DRAW_SHADER = R"(#version 330 core
+in vec2 v_local;
+flat in vec4 v_params;
+flat in vec4 v_fill;
+flat in vec4 v_border;
+flat in int v_kind;
+uniform sampler2D u_glyphs;
+uniform sampler2D u_texture;
+out vec4 o_color;
+
+float Coverage(float distance) {
+    return clamp(0.5 - distance, 0.0, 1.0);
+}
+
+// The border lies inside the outline; fill covers what is left
+vec4 Shape(float distance, float stroke) {
+    float outer = Coverage(distance);
+    float inner = stroke > 0.0 ? Coverage(distance + stroke) : outer;
+    vec4 border = v_border * (outer - inner);
+    return border + v_fill * inner * (1.0 - border.a);
+}
+
+vec4 Premultiply(vec4 color) {
+    return vec4(color.rgb * color.a, color.a);
+}
+
+// Abramowitz and Stegun 7.1.26
+float Erf(float x) {
+    float t = 1.0 / (1.0 + 0.3275911 * abs(x));
+    float y = 1.0 - ((((1.061405429 * t - 1.453152027) * t + 1.421413741) * t - 0.284496736) * t + 0.254829592) * t * exp(-x * x);
+    return sign(x) * y;
+}
+
+// A box blurred by a gaussian, along one axis
+float BlurredSpan(float position, float length, float sigma) {
+    if (sigma <= 0.0) return position >= 0.0 && position < length ? 1.0 : 0.0;
+    float scale = 0.70710678 / sigma;
+    return 0.5 * (Erf(position * scale) - Erf((position - length) * scale));
+}
+
+void main() {
+    vec4 p = v_params;
+    if (v_kind == 0) {
+        o_color = v_fill;
+    } else if (v_kind == 1) {
+        vec2 q = abs(v_local) - (p.xy - p.z);
+        float distance = length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - p.z;
+        o_color = Shape(distance, p.w);
+    } else if (v_kind == 2) {
+        // Distance approximated from the gradient of the implicit ellipse; exact on circles
+        vec2 k = v_local / p.xy;
+        float k0 = length(k);
+        float k1 = length(k / p.xy);
+        o_color = Shape(k1 > 0.0 ? k0 * (k0 - 1.0) / k1 : -min(p.x, p.y), p.w);
+    } else if (v_kind == 3) {
+        float lengthSquared = dot(p.xy, p.xy);
+        float t = lengthSquared > 0.0 ? clamp(dot(v_local, p.xy) / lengthSquared, 0.0, 1.0) : 0.0;
+        o_color = Shape(length(v_local - p.xy * t) - p.z, 0.0);
+    } else if (v_kind == 4) {
+        float index = floor(p.y > 0.5 ? v_local.x : v_local.y);
+        float t = p.x > 1.0 ? index / (p.x - 1.0) : 0.0;
+        o_color = Premultiply(mix(v_fill, v_border, t));
+    } else if (v_kind == 5) {
+        o_color = Premultiply(mix(v_fill, v_border, min(1.0, length(v_local) / p.x)));
+    } else if (v_kind == 6) {
+        o_color = v_fill * texelFetch(u_glyphs, ivec2(v_local), 0).r;
+    } else if (v_kind == 7) {
+        // Nearest texel, copied opaque
+        vec2 texel = p.xy + floor(floor(v_local) * p.zw + 0.001);
+        o_color = vec4(texelFetch(u_texture, ivec2(texel), 0).rgb, 1.0);
+    } else if (v_kind == 8) {
+        o_color = v_fill * BlurredSpan(v_local.x, p.x, p.z) * BlurredSpan(v_local.y, p.y, p.z);
+    } else {
+        // Full color on the rect's edge pixels, fading linearly to nothing at the radius
+        vec2 pixel = floor(v_local);
+        vec2 outside = max(max(-pixel, pixel - (p.xy - 1.0)), 0.0);
+        bool interior = all(greaterThan(pixel, vec2(0.0))) && all(lessThan(pixel, p.xy - 1.0));
+        o_color = interior ? vec4(0.0) : v_fill * max(p.z - max(outside.x, outside.y), 0.0) / p.z;
+    }
+}
+)";
+
+    // Effect passes over a region, reading u_source at the pixel being written.
+    // Sample windows stop at the region's edges, as PixelKernels' do.
+    const char* EFFECT_SHADER = R"(#version 330 core
+uniform sampler2D u_source;
+uniform int u_effect;
+uniform ivec4 u_rect;       // left, top, right, bottom; top-down pixels
+uniform int u_height;       // Of the source and destination
+uniform int u_radius;       // Blur radius or sample count
+uniform ivec2 u_direction;
+uniform vec4 u_params;
+out vec4 o_color;
+
+vec4 Fetch(int x, int y) {
+    return texelFetch(u_source, ivec2(x, u_height - 1 - y), 0);
+}
+
+// Rounds toward zero like C; GLSL leaves negative division undefined
+int Divide(int a, int b) {
+    return a >= 0 ? a / b : -(-a / b);
+}
+
+vec4 BoxRow(int x, int y, int radius) {
+    int first = max(u_rect.x, x - radius);
+    int last = min(u_rect.z - 1, x + radius);
+    vec4 sum = vec4(0.0);
+    for (int i = first; i <= last; i++) sum += Fetch(i, y);
+    return sum / float(last - first + 1);
+}
+
+vec4 BoxColumn(int x, int y, int radius) {
+    int first = max(u_rect.y, y - radius);
+    int last = min(u_rect.w - 1, y + radius);
+    vec4 sum = vec4(0.0);
+    for (int i = first; i <= last; i++) sum += Fetch(x, i);
+    return sum / float(last - first + 1);
+}
+
+bool Inside(int x, int y) {
+    return x >= u_rect.x && x < u_rect.z && y >= u_rect.y && y < u_rect.w;
+}
+
+void main() {
+    int x = int(gl_FragCoord.x);
+    int y = u_height - 1 - int(gl_FragCoord.y);
+    if (u_effect == 0) {
+        o_color = BoxRow(x, y, u_radius);
+    } else if (u_effect == 1) {
+        o_color = BoxColumn(x, y, u_radius);
+    } else if (u_effect == 2) {
+        // Bright pass: threshold, intensity. Alpha stays zero, so adding it back leaves alpha alone.
+        vec3 color = round(Fetch(x, y).rgb * 255.0);
+        bool bright = (color.r + color.g + color.b) / (3.0 * 255.0) > u_params.x;
+        o_color = bright ? vec4(min(floor(color * u_params.y), 255.0) / 255.0, 0.0) : vec4(0.0);
+    } else if (u_effect == 3) {
+        // Depth of field: focal row, focal range; the radius grows away from the focal row
+        float factor = min(abs(float(y) - u_params.x) / u_params.y, 1.0);
+        int radius = int(float(u_radius) * factor);
+        o_color = radius > 0 ? BoxRow(x, y, radius) : Fetch(x, y);
+    } else if (u_effect == 4) {
+        // Motion blur: each earlier position blended over in turn with alpha u_params.x
+        vec4 color = Fetch(x, y);
+        for (int i = 0; i < u_radius; i++) {
+            int sx = x - Divide(u_direction.x * i, u_radius);
+            int sy = y - Divide(u_direction.y * i, u_radius);
+            if (Inside(sx, sy)) color = mix(color, Fetch(sx, sy), u_params.x);
+        }
+        o_color = color;
+    } else {
+        // Chromatic aberration: red from one side, blue from the other
+        vec4 color = Fetch(x, y);
+        ivec2 red = ivec2(x, y) + u_direction;
+        ivec2 blue = ivec2(x, y) - u_direction;
+        if (Inside(red.x, red.y)) color.r = Fetch(red.x, red.y).r;
+        if (Inside(blue.x, blue.y)) color.b = Fetch(blue.x, blue.y).b;
+        o_color = color;
+    }
+}
+)";
+
+    enum class Effect {
+        BLUR_ROWS,
+        BLUR_COLUMNS,
+        BRIGHT,
+        DEPTH_OF_FIELD,
+        MOTION_BLUR,
+        CHROMATIC_ABERRATION
+    };
+
+    struct EffectPass {
+        Effect effect;
+        GLuint source;          // Sampled through SOURCE_UNIT
+        GLuint framebuffer;     // Drawn into
+        bool additive;          // Added to the destination instead of replacing it
+        int radius;
+        int directionX, directionY;
+        float params[2];
+    };
+
+    // glXCreateContextAttribsARB reports failure through an X error; trap it
+    bool g_contextFailed = false;
+
+    int TrapContextError(Display*, XErrorEvent*)
+    {
+        g_contextFailed = true;
+        return 0;
+    }
+
+    bool HasExtension(const char* extensions, const char* name)
+    {
+        size_t length = std::strlen(name);
+        for (const char* found = extensions; found && (found = std::strstr(found, name)); found += length) {
+            bool start = found == extensions || found[-1] == ' ';
+            if (start && (found[length] == ' ' || found[length] == '\0')) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // A double-buffered config drawing to the window's own visual
+    GLXFBConfig ChooseConfig(Display* display, VisualID visual)
+    {
+        const int attributes[] = {
+            GLX_X_RENDERABLE, True,
+            GLX_DRAWABLE_TYPE, GLX_WINDOW_BIT,
+            GLX_RENDER_TYPE, GLX_RGBA_BIT,
+            GLX_DOUBLEBUFFER, True,
+            None
+        };
+        int count = 0;
+        GLXFBConfig* configs = glXChooseFBConfig(display, DefaultScreen(display), attributes, &count);
+        GLXFBConfig chosen = nullptr;
+        for (int i = 0; i < count && !chosen; i++) {
+            int configVisual = 0;
+            if (glXGetFBConfigAttrib(display, configs[i], GLX_VISUAL_ID, &configVisual) == Success &&
+                (VisualID)configVisual == visual) {
+                chosen = configs[i];
+            }
+        }
+        if (configs) XFree(configs);
+        return chosen;
+    }
+
+    GLXContext CreateContext(Display* display, GLXFBConfig config)
+    {
+        auto createContext = (PFNGLXCREATECONTEXTATTRIBSARBPROC)glXGetProcAddressARB(
+            (const GLubyte*)"glXCreateContextAttribsARB");
+        if (!createContext) {
+            return nullptr;
+        }
+        const int attributes[] = {
+            GLX_CONTEXT_MAJOR_VERSION_ARB, 3,
+            GLX_CONTEXT_MINOR_VERSION_ARB, 3,
+            GLX_CONTEXT_PROFILE_MASK_ARB, GLX_CONTEXT_CORE_PROFILE_BIT_ARB,
+            None
+        };
+        g_contextFailed = false;
+        XSync(display, False);
+        int (*previous)(Display*, XErrorEvent*) = XSetErrorHandler(TrapContextError);
+        GLXContext context = createContext(display, config, nullptr, True, attributes);
+        XSync(display, False);
+        XSetErrorHandler(previous);
+        if (g_contextFailed && context) {
+            glXDestroyContext(display, context);
+            context = nullptr;
+        }
+        return context;
+    }
+
+    bool LoadFunctions(GLFunctions& gl)
+    {
+        bool loaded = true;
+#define SDK_GL_LOAD(type, name) \
+        gl.name = (type)glXGetProcAddressARB((const GLubyte*)"gl" #name); \
+        loaded = loaded && gl.name;
+        SDK_GL_FUNCTIONS(SDK_GL_LOAD)
+#undef SDK_GL_LOAD
+        return loaded;
+    }
+
+    GLuint CompileShader(const GLFunctions& gl, GLenum type, const char* source)
+    {
+        GLuint shader = gl.CreateShader(type);
+        gl.ShaderSource(shader, 1, &source, nullptr);
+        gl.CompileShader(shader);
+        GLint compiled = GL_FALSE;
+        gl.GetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+        if (!compiled) {
+            gl.DeleteShader(shader);
+            return 0;
+        }
+        return shader;
+    }
+
+    GLuint LinkProgram(const GLFunctions& gl, const char* fragmentSource)
+    {
+        GLuint vertex = CompileShader(gl, GL_VERTEX_SHADER, VERTEX_SHADER);
+        GLuint fragment = CompileShader(gl, GL_FRAGMENT_SHADER, fragmentSource);
+        GLuint program = 0;
+        if (vertex && fragment) {
+            program = gl.CreateProgram();
+            gl.AttachShader(program, vertex);
+            gl.AttachShader(program, fragment);
+            gl.LinkProgram(program);
+            GLint linked = GL_FALSE;
+            gl.GetProgramiv(program, GL_LINK_STATUS, &linked);
+            if (!linked) {
+                gl.DeleteProgram(program);
+                program = 0;
+            }
+        }
+        // Flagged shaders go with the program
+        if (vertex) gl.DeleteShader(vertex);
+        if (fragment) gl.DeleteShader(fragment);
+        return program;
+    }
+
+    GLuint CreateTexture(GLenum internalFormat, int width, int height, GLenum format)
+    {
+        GLuint texture = 0;
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexImage2D(GL_TEXTURE_2D, 0, (GLint)internalFormat, width, height, 0, format, GL_UNSIGNED_BYTE, nullptr);
+        return texture;
+    }
+
+    // A color texture of the frame's size and a framebuffer drawing into it; false when incomplete
+    bool CreateSurface(const GLFunctions& gl, int width, int height, GLuint& texture, GLuint& framebuffer)
+    {
+        texture = CreateTexture(GL_RGBA8, width, height, GL_RGBA);
+        gl.GenFramebuffers(1, &framebuffer);
+        gl.BindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        gl.FramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+        return gl.CheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    }
+
+    void ReleaseSurface(const GLFunctions& gl, GLuint& texture, GLuint& framebuffer)
+    {
+        if (framebuffer) gl.DeleteFramebuffers(1, &framebuffer);
+        if (texture) glDeleteTextures(1, &texture);
+        texture = 0;
+        framebuffer = 0;
+    }
+
+    void SetVertexLayout(const GLFunctions& gl)
+    {
+        using Vertex = GLState::Vertex;
+        const GLsizei stride = sizeof(Vertex);
+        gl.VertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (const void*)offsetof(Vertex, x));
+        gl.VertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (const void*)offsetof(Vertex, localX));
+        gl.VertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, stride, (const void*)offsetof(Vertex, p));
+        // GL_BGRA size: the little-endian 0xAARRGGBB bytes arrive as rgba
+        gl.VertexAttribPointer(3, GL_BGRA, GL_UNSIGNED_BYTE, GL_TRUE, stride, (const void*)offsetof(Vertex, fill));
+        gl.VertexAttribPointer(4, GL_BGRA, GL_UNSIGNED_BYTE, GL_TRUE, stride, (const void*)offsetof(Vertex, border));
+        gl.VertexAttribPointer(5, 1, GL_FLOAT, GL_FALSE, stride, (const void*)offsetof(Vertex, kind));
+        for (GLuint i = 0; i <= 5; i++) {
+            gl.EnableVertexAttribArray(i);
+        }
+    }
+
+    void AppendQuad(std::vector<GLState::Vertex>& vertices, const GLState::Vertex& topLeft,
+                    float right, float bottom, float localRight, float localBottom)
+    {
+        GLState::Vertex corners[4] = { topLeft, topLeft, topLeft, topLeft };
+        corners[1].x = right;
+        corners[1].localX = localRight;
+        corners[2].y = bottom;
+        corners[2].localY = localBottom;
+        corners[3].x = right;
+        corners[3].localX = localRight;
+        corners[3].y = bottom;
+        corners[3].localY = localBottom;
+        const int order[6] = { 0, 1, 2, 2, 1, 3 };
+        for (int index : order) {
+            vertices.push_back(corners[index]);
+        }
+    }
+
+    void EnsureScratch(GLState& state, int width, int height)
+    {
+        if (state.scratch[0]) {
+            return;
+        }
+        state.gl.ActiveTexture(SOURCE_UNIT);
+        for (int i = 0; i < 2; i++) {
+            CreateSurface(state.gl, width, height, state.scratch[i], state.scratchFramebuffer[i]);
+        }
+        state.gl.BindFramebuffer(GL_FRAMEBUFFER, state.targetFramebuffer);
+    }
+
+    // One full-screen-style pass over clipped; leaves the frame's framebuffer bound
+    void RunEffect(GLState& state, const EffectPass& pass, const RECT& clipped, int height)
+    {
+        const GLFunctions& gl = state.gl;
+        gl.BindFramebuffer(GL_FRAMEBUFFER, pass.framebuffer);
+        gl.UseProgram(state.effect.program);
+        gl.Uniform1i(state.effect.effect, (int)pass.effect);
+        gl.Uniform4i(state.effect.rect, (int)clipped.left, (int)clipped.top, (int)clipped.right, (int)clipped.bottom);
+        gl.Uniform1i(state.effect.height, height);
+        gl.Uniform1i(state.effect.radius, pass.radius);
+        gl.Uniform2i(state.effect.direction, pass.directionX, pass.directionY);
+        gl.Uniform4f(state.effect.params, pass.params[0], pass.params[1], 0.0f, 0.0f);
+        gl.ActiveTexture(SOURCE_UNIT);
+        glBindTexture(GL_TEXTURE_2D, pass.source);
+        if (pass.additive) {
+            glBlendFunc(GL_ONE, GL_ONE);
+        } else {
+            glDisable(GL_BLEND);
+        }
+
+        GLState::Vertex corner = {};
+        corner.x = (float)clipped.left;
+        corner.y = (float)clipped.top;
+        std::vector<GLState::Vertex> quad;
+        AppendQuad(quad, corner, (float)clipped.right, (float)clipped.bottom, 0.0f, 0.0f);
+        gl.BufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(quad.size() * sizeof(GLState::Vertex)), quad.data(), GL_STREAM_DRAW);
+        glDrawArrays(GL_TRIANGLES, 0, (GLsizei)quad.size());
+        state.drawCalls++;
+
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+        gl.BindFramebuffer(GL_FRAMEBUFFER, state.targetFramebuffer);
+    }
+
+    // A copy of clipped from the frame into the first scratch texture, for passes
+    // that write back where they read
+    void CopyToScratch(GLState& state, const RECT& clipped, int height)
+    {
+        state.gl.ActiveTexture(SOURCE_UNIT);
+        glBindTexture(GL_TEXTURE_2D, state.scratch[0]);
+        int bottom = height - (int)clipped.bottom;
+        glCopyTexSubImage2D(GL_TEXTURE_2D, 0, (int)clipped.left, bottom, (int)clipped.left, bottom,
+            (int)(clipped.right - clipped.left), (int)(clipped.bottom - clipped.top));
+    }
+
+    // Box blur of source into the frame, rows through the second scratch texture then columns
+    void BoxBlur(GLState& state, GLuint source, const RECT& clipped, int height, int radius, bool additive)
+    {
+        EffectPass rows = { Effect::BLUR_ROWS, source, state.scratchFramebuffer[1], false, radius, 0, 0, { 0, 0 } };
+        RunEffect(state, rows, clipped, height);
+        EffectPass columns = { Effect::BLUR_COLUMNS, state.scratch[1], state.targetFramebuffer, additive, radius, 0, 0, { 0, 0 } };
+        RunEffect(state, columns, clipped, height);
+    }
+}
+#endif
+
+GLRenderBackend::GLRenderBackend()
+    : m_display(nullptr)
+    , m_window(0)
+    , m_width(0)
+    , m_height(0)
+    , m_gl(new GLState())
+    , m_initialized(false)
+{
+}
+
+GLRenderBackend::~GLRenderBackend()
+{
+    Shutdown();
+}
+
+bool GLRenderBackend::IsAvailable()
+{
+#if SDK_HAS_OPENGL
+    static const bool available = [] {
+        Display* display = XOpenDisplay(nullptr);
+        if (!display) {
+            return false;
+        }
+        int major = 0;
+        int minor = 0;
+        bool usable = glXQueryVersion(display, &major, &minor) && (major > 1 || minor >= 3) &&
+            HasExtension(glXQueryExtensionsString(display, DefaultScreen(display)), "GLX_ARB_create_context_profile");
+        XCloseDisplay(display);
+        return usable;
+    }();
+    return available;
+#else
+    return false;
+#endif
+}
+
+bool GLRenderBackend::Initialize(HWND hwnd)
+{
+    if (m_initialized) {
+        return true;
+    }
+
+#if SDK_HAS_OPENGL
+    m_window = (Window)hwnd;
+    m_display = XOpenDisplay(nullptr);
+    if (!m_display) {
+        return false;
+    }
+
+    GLState& state = *m_gl;
+    XWindowAttributes attrs;
+    bool created = XGetWindowAttributes(m_display, m_window, &attrs) != 0;
+    if (created) {
+        state.config = ChooseConfig(m_display, XVisualIDFromVisual(attrs.visual));
+        state.context = state.config ? CreateContext(m_display, state.config) : nullptr;
+        state.drawable = state.context ? glXCreateWindow(m_display, state.config, m_window, nullptr) : 0;
+        created = state.drawable && glXMakeContextCurrent(m_display, state.drawable, state.drawable, state.context) &&
+                  CreateResources(attrs.width, attrs.height);
+    }
+    m_initialized = true;
+    if (!created) {
+        Shutdown();
+    }
+    return created;
+#else
+    (void)hwnd;
+    return false;
+#endif
+}
+
+void GLRenderBackend::Shutdown()
+{
+    if (!m_initialized) {
+        return;
+    }
+
+#if SDK_HAS_OPENGL
+    GLState& state = *m_gl;
+    if (state.context && glXMakeContextCurrent(m_display, state.drawable, state.drawable, state.context)) {
+        ReleaseResources();
+        glXMakeContextCurrent(m_display, None, None, nullptr);
+    }
+    if (state.drawable) glXDestroyWindow(m_display, state.drawable);
+    if (state.context) glXDestroyContext(m_display, state.context);
+    *m_gl = GLState();
+#endif
+
+    m_glyphs.reset();
+    m_fonts.reset();
+    if (m_display) {
+        XCloseDisplay(m_display);
+        m_display = nullptr;
+    }
+    m_width = 0;
+    m_height = 0;
+    m_initialized = false;
+}
+
+bool GLRenderBackend::CreateResources(int width, int height)
+{
+#if SDK_HAS_OPENGL
+    GLState& state = *m_gl;
+    const GLFunctions& gl = state.gl;
+    if (!LoadFunctions(state.gl)) {
+        return false;
+    }
+
+    state.drawProgram = LinkProgram(gl, DRAW_SHADER);
+    state.effect.program = LinkProgram(gl, EFFECT_SHADER);
+    if (!state.drawProgram || !state.effect.program) {
+        return false;
+    }
+    state.drawViewport = gl.GetUniformLocation(state.drawProgram, "u_viewport");
+    gl.UseProgram(state.drawProgram);
+    gl.Uniform1i(gl.GetUniformLocation(state.drawProgram, "u_glyphs"), (int)(GLYPH_UNIT - GL_TEXTURE0));
+    gl.Uniform1i(gl.GetUniformLocation(state.drawProgram, "u_texture"), (int)(ATLAS_UNIT - GL_TEXTURE0));
+
+    GLuint effect = state.effect.program;
+    state.effect.viewport = gl.GetUniformLocation(effect, "u_viewport");
+    state.effect.effect = gl.GetUniformLocation(effect, "u_effect");
+    state.effect.rect = gl.GetUniformLocation(effect, "u_rect");
+    state.effect.height = gl.GetUniformLocation(effect, "u_height");
+    state.effect.radius = gl.GetUniformLocation(effect, "u_radius");
+    state.effect.direction = gl.GetUniformLocation(effect, "u_direction");
+    state.effect.params = gl.GetUniformLocation(effect, "u_params");
+    gl.UseProgram(effect);
+    gl.Uniform1i(gl.GetUniformLocation(effect, "u_source"), (int)(SOURCE_UNIT - GL_TEXTURE0));
+
+    // One buffer for everything, refilled at each flush
+    gl.GenVertexArrays(1, &state.vertexArray);
+    gl.BindVertexArray(state.vertexArray);
+    gl.GenBuffers(1, &state.vertexBuffer);
+    gl.BindBuffer(GL_ARRAY_BUFFER, state.vertexBuffer);
+    SetVertexLayout(gl);
+    state.vertices.reserve(6 * 1024);
+
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &state.maxTextureSize);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);   // Premultiplied source-over
+    return ResizeTarget(width, height);
+#else
+    (void)width; (void)height;
+    return false;
+#endif
+}
+
+void GLRenderBackend::ReleaseResources()
+{
+#if SDK_HAS_OPENGL
+    GLState& state = *m_gl;
+    const GLFunctions& gl = state.gl;
+    if (!gl.DeleteProgram) {
+        return;
+    }
+    ReleaseSurface(gl, state.target, state.targetFramebuffer);
+    for (int i = 0; i < 2; i++) {
+        ReleaseSurface(gl, state.scratch[i], state.scratchFramebuffer[i]);
+    }
+    if (state.glyphTexture) glDeleteTextures(1, &state.glyphTexture);
+    if (state.atlasTexture) glDeleteTextures(1, &state.atlasTexture);
+    if (state.vertexBuffer) gl.DeleteBuffers(1, &state.vertexBuffer);
+    if (state.vertexArray) gl.DeleteVertexArrays(1, &state.vertexArray);
+    if (state.drawProgram) gl.DeleteProgram(state.drawProgram);
+    if (state.effect.program) gl.DeleteProgram(state.effect.program);
+    state.glyphTexture = 0;
+    state.atlasTexture = 0;
+    state.atlas = nullptr;
+#endif
+}
+
+bool GLRenderBackend::ResizeTarget(int width, int height)
+{
+#if SDK_HAS_OPENGL
+    GLState& state = *m_gl;
+    const GLFunctions& gl = state.gl;
+    m_width = std::max(1, width);
+    m_height = std::max(1, height);
+
+    // Contents don't survive a resize, as with the X11 back buffer
+    ReleaseSurface(gl, state.target, state.targetFramebuffer);
+    for (int i = 0; i < 2; i++) {
+        ReleaseSurface(gl, state.scratch[i], state.scratchFramebuffer[i]);
+    }
+    gl.ActiveTexture(SOURCE_UNIT);
+    if (!CreateSurface(gl, m_width, m_height, state.target, state.targetFramebuffer)) {
+        return false;
+    }
+    glViewport(0, 0, m_width, m_height);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    gl.UseProgram(state.drawProgram);
+    gl.Uniform2f(state.drawViewport, (float)m_width, (float)m_height);
+    gl.UseProgram(state.effect.program);
+    gl.Uniform2f(state.effect.viewport, (float)m_width, (float)m_height);
+    return true;
+#else
+    (void)width; (void)height;
+    return false;
+#endif
+}
+
+bool GLRenderBackend::BeginDraw()
+{
+    if (!m_initialized) {
+        return false;
+    }
+
+#if SDK_HAS_OPENGL
+    GLState& state = *m_gl;
+    XWindowAttributes attrs;
+    if (XGetWindowAttributes(m_display, m_window, &attrs) == 0 ||
+        !glXMakeContextCurrent(m_display, state.drawable, state.drawable, state.context)) {
+        return false;
+    }
+    if ((attrs.width != m_width || attrs.height != m_height) && !ResizeTarget(attrs.width, attrs.height)) {
+        return false;
+    }
+    state.gl.BindFramebuffer(GL_FRAMEBUFFER, state.targetFramebuffer);
+    state.drawCalls = 0;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void GLRenderBackend::EndDraw()
+{
+    if (!m_initialized) {
+        return;
+    }
+
+#if SDK_HAS_OPENGL
+    Flush();
+    GLState& state = *m_gl;
+    const GLFunctions& gl = state.gl;
+
+    // The frame to the window's back buffer, then present
+    gl.BindFramebuffer(GL_READ_FRAMEBUFFER, state.targetFramebuffer);
+    gl.BindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    gl.BlitFramebuffer(0, 0, m_width, m_height, 0, 0, m_width, m_height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    if (m_display && state.drawable) {
+        glXSwapBuffers(m_display, state.drawable);
+    }
+    gl.BindFramebuffer(GL_FRAMEBUFFER, state.targetFramebuffer);
+#endif
+}
+
+void GLRenderBackend::Clear(Color color)
+{
+    if (!m_initialized) {
+        return;
+    }
+
+#if SDK_HAS_OPENGL
+    // Queued draws come first
+    m_gl->vertices.clear();
+    m_gl->pendingGlyphs = false;
+    m_gl->pendingTextures = false;
+    float alpha = color.a / 255.0f;
+    glClearColor(color.r / 255.0f * alpha, color.g / 255.0f * alpha, color.b / 255.0f * alpha, alpha);
+    glClear(GL_COLOR_BUFFER_BIT);
+#else
+    (void)color;
+#endif
+}
+
+HDC GLRenderBackend::GetDC() const
+{
+    // The window handle, as X11RenderBackend returns
+    return reinterpret_cast<HDC>(m_window);
+}
+
+void* GLRenderBackend::GetNativeContext() const
+{
+#if SDK_HAS_OPENGL
+    return m_gl->context;
+#else
+    return nullptr;
+#endif
+}
+
+void GLRenderBackend::PushQuad(const RECT& bounds, float localMinX, float localMinY, float localMaxX, float localMaxY,
+                               Kind kind, uint32_t fill, uint32_t border, float p0, float p1, float p2, float p3)
+{
+#if SDK_HAS_OPENGL
+    if (bounds.right <= bounds.left || bounds.bottom <= bounds.top) {
+        return;
+    }
+    GLState::Vertex corner;
+    corner.x = (float)bounds.left;
+    corner.y = (float)bounds.top;
+    corner.localX = localMinX;
+    corner.localY = localMinY;
+    corner.p[0] = p0;
+    corner.p[1] = p1;
+    corner.p[2] = p2;
+    corner.p[3] = p3;
+    corner.fill = fill;
+    corner.border = border;
+    corner.kind = (float)kind;
+    AppendQuad(m_gl->vertices, corner, (float)bounds.right, (float)bounds.bottom, localMaxX, localMaxY);
+#else
+    (void)bounds; (void)localMinX; (void)localMinY; (void)localMaxX; (void)localMaxY;
+    (void)kind; (void)fill; (void)border; (void)p0; (void)p1; (void)p2; (void)p3;
+#endif
+}
+
+void GLRenderBackend::Flush()
+{
+#if SDK_HAS_OPENGL
+    GLState& state = *m_gl;
+    if (state.vertices.empty()) {
+        return;
+    }
+    const GLFunctions& gl = state.gl;
+    gl.UseProgram(state.drawProgram);
+    gl.BufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(state.vertices.size() * sizeof(GLState::Vertex)),
+        state.vertices.data(), GL_STREAM_DRAW);
+    glDrawArrays(GL_TRIANGLES, 0, (GLsizei)state.vertices.size());
+    state.drawCalls++;
+    state.vertices.clear();
+    state.pendingGlyphs = false;
+    state.pendingTextures = false;
+#endif
+}
+
+void GLRenderBackend::DrawRectangle(const RECT& rect, Color fillColor, Color borderColor, float borderWidth)
+{
+    if (!m_initialized) {
+        return;
+    }
+
+    // The border as four strips inside the rect, the fill within
+    int stroke = borderColor.a > 0 && borderWidth > 0 ? std::max(1, (int)std::lround(borderWidth)) : 0;
+    RECT inner = { rect.left + stroke, rect.top + stroke, rect.right - stroke, rect.bottom - stroke };
+    uint32_t fill = fillColor.ToPremultiplied();
+    if (fill) {
+        PushQuad(inner, 0, 0, 0, 0, Kind::SOLID, fill, 0, 0, 0, 0, 0);
+    }
+    if (stroke > 0) {
+        uint32_t border = borderColor.ToPremultiplied();
+        // Strokes wider than half the rect leave no inside
+        inner.left = std::min(inner.left, rect.right);
+        inner.right = std::max(inner.right, inner.left);
+        inner.top = std::min(inner.top, rect.bottom);
+        inner.bottom = std::max(inner.bottom, inner.top);
+        PushQuad({ rect.left, rect.top, rect.right, inner.top }, 0, 0, 0, 0, Kind::SOLID, border, 0, 0, 0, 0, 0);
+        PushQuad({ rect.left, inner.bottom, rect.right, rect.bottom }, 0, 0, 0, 0, Kind::SOLID, border, 0, 0, 0, 0, 0);
+        PushQuad({ rect.left, inner.top, inner.left, inner.bottom }, 0, 0, 0, 0, Kind::SOLID, border, 0, 0, 0, 0, 0);
+        PushQuad({ inner.right, inner.top, rect.right, inner.bottom }, 0, 0, 0, 0, Kind::SOLID, border, 0, 0, 0, 0, 0);
+    }
+}
+
+void GLRenderBackend::DrawRoundedRectangle(const RECT& rect, float radius, Color fillColor, Color borderColor, float borderWidth)
+{
+    float halfWidth = (rect.right - rect.left) * 0.5f;
+    float halfHeight = (rect.bottom - rect.top) * 0.5f;
+    if (!m_initialized || halfWidth <= 0 || halfHeight <= 0) {
+        return;
+    }
+
+    float r = std::min(std::max(radius, 0.0f), std::min(halfWidth, halfHeight));
+    float stroke = borderColor.a > 0 && borderWidth > 0 ? borderWidth : 0.0f;
+    PushQuad(rect, -halfWidth, -halfHeight, halfWidth, halfHeight, Kind::ROUNDED_RECT,
+        fillColor.ToPremultiplied(), borderColor.ToPremultiplied(), halfWidth, halfHeight, r, stroke);
+}
+
+void GLRenderBackend::DrawLine(int x1, int y1, int x2, int y2, Color color, float width)
+{
+    if (!m_initialized) {
+        return;
+    }
+
+    // A capsule around the segment between pixel centers: round caps, as in DrawPolylines
+    float half = std::max(width, 1.0f) * 0.5f;
+    int pad = (int)std::ceil(half) + 1;
+    RECT bounds = { std::min(x1, x2) - pad, std::min(y1, y2) - pad, std::max(x1, x2) + pad + 1, std::max(y1, y2) + pad + 1 };
+    float originX = x1 + 0.5f;
+    float originY = y1 + 0.5f;
+    PushQuad(bounds, bounds.left - originX, bounds.top - originY, bounds.right - originX, bounds.bottom - originY,
+        Kind::CAPSULE, color.ToPremultiplied(), 0, (float)(x2 - x1), (float)(y2 - y1), half, 0);
+}
+
+void GLRenderBackend::DrawEllipse(int cx, int cy, int rx, int ry, Color fillColor, Color borderColor, float borderWidth)
+{
+    if (!m_initialized || rx <= 0 || ry <= 0) {
+        return;
+    }
+
+    float stroke = borderColor.a > 0 && borderWidth > 0 ? borderWidth : 0.0f;
+    RECT bounds = { cx - rx - 1, cy - ry - 1, cx + rx + 1, cy + ry + 1 };
+    PushQuad(bounds, (float)(-rx - 1), (float)(-ry - 1), (float)(rx + 1), (float)(ry + 1), Kind::ELLIPSE,
+        fillColor.ToPremultiplied(), borderColor.ToPremultiplied(), (float)rx, (float)ry, 0, stroke);
+}
+
+const GlyphAtlas::Run* GLRenderBackend::LayoutText(const std::wstring& text, const std::wstring& fontFamily, float fontSize,
+                                                    int fontWeight, int& ascent, int& descent)
+{
+    if (!m_initialized || !m_display) {
+        return nullptr;
+    }
+    if (!m_fonts) {
+        m_fonts.reset(new XftFontSource(m_display));
+    }
+
+    uint32_t id;
+    if (!m_fonts->GetFont(fontFamily, fontSize, fontWeight, id, ascent, descent)) {
+        return nullptr;
+    }
+    if (!m_glyphs) {
+        m_glyphs.reset(new GlyphAtlas(GLYPH_ATLAS_WIDTH, GLYPH_ATLAS_HEIGHT, m_fonts->GetRasterizer()));
+    }
+    return &m_glyphs->GetRun(id, text);
+}
+
+void GLRenderBackend::DrawRun(const GlyphAtlas::Run& run, int x, int baseline, Color color)
+{
+#if SDK_HAS_OPENGL
+    uint32_t source = color.ToPremultiplied();
+    if (run.glyphs.empty() || !source) {
+        return;
+    }
+
+    GLState& state = *m_gl;
+    const GLFunctions& gl = state.gl;
+    GlyphAtlas& atlas = *m_glyphs;
+    RECT dirty;
+    if (!state.glyphTexture) {
+        gl.ActiveTexture(GLYPH_UNIT);
+        state.glyphTexture = CreateTexture(GL_R8, atlas.GetWidth(), atlas.GetHeight(), GL_RED);
+        dirty = { 0, 0, atlas.GetWidth(), atlas.GetHeight() };
+    } else if (!atlas.GetDirtyRect(dirty)) {
+        dirty = {};
+    }
+    if (dirty.right > dirty.left) {
+        // A full atlas starts over, moving glyphs that queued quads still point at
+        if (state.pendingGlyphs) {
+            Flush();
+        }
+        gl.ActiveTexture(GLYPH_UNIT);
+        glBindTexture(GL_TEXTURE_2D, state.glyphTexture);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, atlas.GetWidth());
+        glTexSubImage2D(GL_TEXTURE_2D, 0, dirty.left, dirty.top, dirty.right - dirty.left, dirty.bottom - dirty.top,
+            GL_RED, GL_UNSIGNED_BYTE, atlas.GetCoverage() + (size_t)dirty.top * atlas.GetWidth() + dirty.left);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        atlas.ClearDirtyRect();
+    }
+
+    for (const GlyphAtlas::RunGlyph& placed : run.glyphs) {
+        const GlyphAtlas::Glyph& glyph = *placed.glyph;
+        int left = x + placed.x + glyph.left;
+        int top = baseline - glyph.top;
+        PushQuad({ left, top, left + glyph.width, top + glyph.height },
+            (float)glyph.x, (float)glyph.y, (float)(glyph.x + glyph.width), (float)(glyph.y + glyph.height),
+            Kind::GLYPH, source, 0, 0, 0, 0, 0);
+    }
+    state.pendingGlyphs = true;
+#else
+    (void)run; (void)x; (void)baseline; (void)color;
+#endif
+}
+
+void GLRenderBackend::DrawText(const std::wstring& text, const RECT& rect, Color color,
+                               const std::wstring& fontFamily, float fontSize, int fontWeight)
+{
+    if (text.empty()) {
+        return;
+    }
+
+    int ascent, descent;
+    if (const GlyphAtlas::Run* run = LayoutText(text, fontFamily, fontSize, fontWeight, ascent, descent)) {
+        DrawRun(*run, rect.left + 5, rect.top + ascent + 5, color);
+    }
+}
+
+void GLRenderBackend::DrawTextLine(const std::wstring& text, const RECT& rect, Color color,
+                                   const std::wstring& fontFamily, float fontSize, int fontWeight, TextAlign align)
+{
+    if (text.empty()) {
+        return;
+    }
+
+    int ascent, descent;
+    const GlyphAtlas::Run* run = LayoutText(text, fontFamily, fontSize, fontWeight, ascent, descent);
+    if (!run) {
+        return;
+    }
+    int x = rect.left;
+    if (align == TextAlign::CENTER) {
+        x += (rect.right - rect.left - run->width) / 2;
+    } else if (align == TextAlign::RIGHT) {
+        x = rect.right - run->width;
+    }
+    DrawRun(*run, x, (rect.top + rect.bottom + ascent - descent) / 2, color);
+}
+
+int GLRenderBackend::MeasureText(const std::wstring& text, const std::wstring& fontFamily, float fontSize, int fontWeight)
+{
+    int ascent, descent;
+    if (const GlyphAtlas::Run* run = LayoutText(text, fontFamily, fontSize, fontWeight, ascent, descent)) {
+        return run->width;
+    }
+    return RenderBackend::MeasureText(text, fontFamily, fontSize, fontWeight);
+}
+
+void GLRenderBackend::DrawParticleBatch(const float* x, const float* y, const uint32_t* colors, size_t count, int size)
+{
+    if (!m_initialized || !x || !y || !colors || size <= 0) {
+        return;
+    }
+
+    // Squares placed as PixelKernels::SplatParticles places them
+    for (size_t i = 0; i < count; i++) {
+        uint32_t color = PremultipliedPixel::FromStraight(colors[i]);
+        if (!color || !std::isfinite(x[i]) || !std::isfinite(y[i])) {
+            continue;
+        }
+        int left = (int)std::floor(x[i]) - size / 2;
+        int top = (int)std::floor(y[i]) - size / 2;
+        if (left >= m_width || top >= m_height || left + size <= 0 || top + size <= 0) {
+            continue;
+        }
+        PushQuad({ left, top, left + size, top + size }, 0, 0, 0, 0, Kind::SOLID, color, 0, 0, 0, 0, 0);
+    }
+}
+
+bool GLRenderBackend::UploadAtlas(const TextureAtlas& atlas)
+{
+#if SDK_HAS_OPENGL
+    GLState& state = *m_gl;
+    if (state.atlas == &atlas && state.atlasVersion == atlas.GetVersion()) {
+        return true;
+    }
+    if (atlas.GetWidth() <= 0 || atlas.GetHeight() <= 0) {
+        return false;
+    }
+
+    // Queued quads sample the pixels about to be replaced
+    if (state.pendingTextures) {
+        Flush();
+    }
+    state.gl.ActiveTexture(ATLAS_UNIT);
+    if (!state.atlasTexture || state.atlasWidth != atlas.GetWidth() || state.atlasHeight != atlas.GetHeight()) {
+        if (state.atlasTexture) glDeleteTextures(1, &state.atlasTexture);
+        state.atlasTexture = CreateTexture(GL_RGBA8, atlas.GetWidth(), atlas.GetHeight(), GL_BGRA);
+        state.atlasWidth = atlas.GetWidth();
+        state.atlasHeight = atlas.GetHeight();
+    }
+    glBindTexture(GL_TEXTURE_2D, state.atlasTexture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, atlas.GetWidth(), atlas.GetHeight(), GL_BGRA, GL_UNSIGNED_BYTE, atlas.GetPixels());
+    state.atlas = &atlas;
+    state.atlasVersion = atlas.GetVersion();
+    return true;
+#else
+    (void)atlas;
+    return false;
+#endif
+}
+
+void GLRenderBackend::DrawAtlasTexture(const TextureAtlas& atlas, const std::string& name, const RECT& dest)
+{
+    const TextureAtlas::AtlasEntry* entry = atlas.GetTexture(name);
+    int destWidth = dest.right - dest.left;
+    int destHeight = dest.bottom - dest.top;
+    if (!m_initialized || !entry || destWidth <= 0 || destHeight <= 0 || !UploadAtlas(atlas)) {
+        return;
+    }
+
+    PushQuad(dest, 0, 0, (float)destWidth, (float)destHeight, Kind::TEXTURE, 0, 0,
+        (float)entry->x, (float)entry->y, (float)entry->width / destWidth, (float)entry->height / destHeight);
+#if SDK_HAS_OPENGL
+    m_gl->pendingTextures = true;
+#endif
+}
+
+void GLRenderBackend::DrawLinearGradient(const RECT& rect, Color startColor, Color endColor, bool horizontal)
+{
+    if (!m_initialized) {
+        return;
+    }
+
+    // Straight colors, mixed per pixel and premultiplied in the shader
+    float width = (float)(rect.right - rect.left);
+    float height = (float)(rect.bottom - rect.top);
+    PushQuad(rect, 0, 0, width, height, Kind::LINEAR_GRADIENT, ToStraight(startColor), ToStraight(endColor),
+        horizontal ? width : height, horizontal ? 1.0f : 0.0f, 0, 0);
+}
+
+void GLRenderBackend::DrawRadialGradient(const RECT& rect, Color centerColor, Color edgeColor, int cx, int cy)
+{
+    if (!m_initialized) {
+        return;
+    }
+
+    // Center and radius as on the other backends: the farthest corner is the edge color
+    int rectWidth = rect.right - rect.left;
+    int rectHeight = rect.bottom - rect.top;
+    int gradientCx = (cx >= 0 && cx < rectWidth) ? rect.left + cx : (rect.left + rect.right) / 2;
+    int gradientCy = (cy >= 0 && cy < rectHeight) ? rect.top + cy : (rect.top + rect.bottom) / 2;
+    int dx1 = gradientCx - rect.left;
+    int dy1 = gradientCy - rect.top;
+    int dx2 = rect.right - gradientCx;
+    int dy2 = rect.bottom - gradientCy;
+    float maxRadius = std::sqrt((float)std::max({ dx1 * dx1 + dy1 * dy1, dx2 * dx2 + dy1 * dy1,
+                                                  dx1 * dx1 + dy2 * dy2, dx2 * dx2 + dy2 * dy2 }));
+    if (maxRadius <= 0) {
+        return;
+    }
+
+    PushQuad(rect, (float)(rect.left - gradientCx), (float)(rect.top - gradientCy),
+        (float)(rect.right - gradientCx), (float)(rect.bottom - gradientCy), Kind::RADIAL_GRADIENT,
+        ToStraight(centerColor), ToStraight(edgeColor), maxRadius, 0, 0, 0);
+}
+
+void GLRenderBackend::DrawShadow(const RECT& rect, int offsetX, int offsetY, int blur, Color shadowColor)
+{
+    if (!m_initialized) {
+        return;
+    }
+
+    // The rect blurred with the gaussian ShadowCache uses, sigma = blur / 3, out to blur pixels
+    blur = std::max(0, blur);
+    RECT shadow = { rect.left + offsetX, rect.top + offsetY, rect.right + offsetX, rect.bottom + offsetY };
+    RECT outer = { shadow.left - blur, shadow.top - blur, shadow.right + blur, shadow.bottom + blur };
+    PushQuad(outer, (float)-blur, (float)-blur, (float)(outer.right - shadow.left), (float)(outer.bottom - shadow.top),
+        Kind::SHADOW, shadowColor.ToPremultiplied(), 0,
+        (float)(shadow.right - shadow.left), (float)(shadow.bottom - shadow.top), blur / 3.0f, 0);
+}
+
+void GLRenderBackend::DrawGlow(const RECT& rect, int radius, Color glowColor)
+{
+    if (!m_initialized || radius <= 0) {
+        return;
+    }
+
+    RECT outer = { rect.left - radius, rect.top - radius, rect.right + radius, rect.bottom + radius };
+    PushQuad(outer, (float)-radius, (float)-radius, (float)(outer.right - rect.left), (float)(outer.bottom - rect.top),
+        Kind::GLOW, glowColor.ToPremultiplied(), 0,
+        (float)(rect.right - rect.left), (float)(rect.bottom - rect.top), (float)radius, 0);
+}
+
+bool GLRenderBackend::BeginEffect(const RECT& rect, RECT& clipped)
+{
+    if (!m_initialized) {
+        return false;
+    }
+    clipped.left = std::max(0L, (long)rect.left);
+    clipped.top = std::max(0L, (long)rect.top);
+    clipped.right = std::min((long)m_width, (long)rect.right);
+    clipped.bottom = std::min((long)m_height, (long)rect.bottom);
+    if (clipped.right <= clipped.left || clipped.bottom <= clipped.top) {
+        return false;
+    }
+
+#if SDK_HAS_OPENGL
+    Flush();
+    EnsureScratch(*m_gl, m_width, m_height);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void GLRenderBackend::ApplyBlur(const RECT& rect, int blurRadius)
+{
+    RECT clipped;
+    if (blurRadius <= 0 || !BeginEffect(rect, clipped)) {
+        return;
+    }
+
+#if SDK_HAS_OPENGL
+    GLState& state = *m_gl;
+    CopyToScratch(state, clipped, m_height);
+    BoxBlur(state, state.scratch[0], clipped, m_height, blurRadius, false);
+#endif
+}
+
+void GLRenderBackend::ApplyBloom(const RECT& rect, float threshold, float intensity)
+{
+    RECT clipped;
+    if (!BeginEffect(rect, clipped)) {
+        return;
+    }
+
+#if SDK_HAS_OPENGL
+    // Bright pixels into scratch, blurred, and added back onto the frame
+    GLState& state = *m_gl;
+    EffectPass bright = { Effect::BRIGHT, state.target, state.scratchFramebuffer[0], false, 0, 0, 0, { threshold, intensity } };
+    RunEffect(state, bright, clipped, m_height);
+    BoxBlur(state, state.scratch[0], clipped, m_height, BLOOM_RADIUS, true);
+#else
+    (void)threshold; (void)intensity;
+#endif
+}
+
+void GLRenderBackend::ApplyDepthOfField(const RECT& rect, int focalDepth, int blurAmount, float focalRange)
+{
+    RECT clipped;
+    if (blurAmount <= 0 || focalRange <= 0.0f || !BeginEffect(rect, clipped)) {
+        return;
+    }
+
+#if SDK_HAS_OPENGL
+    // The focal row is relative to rect, not to the clipped region
+    GLState& state = *m_gl;
+    CopyToScratch(state, clipped, m_height);
+    EffectPass pass = { Effect::DEPTH_OF_FIELD, state.scratch[0], state.targetFramebuffer, false, blurAmount, 0, 0,
+                        { (float)(rect.top + focalDepth), focalRange } };
+    RunEffect(state, pass, clipped, m_height);
+#else
+    (void)focalDepth;
+#endif
+}
+
+void GLRenderBackend::ApplyMotionBlur(const RECT& rect, int directionX, int directionY, float intensity)
+{
+    float alpha = std::min(255.0f, 255.0f * intensity / MOTION_SAMPLES);
+    RECT clipped;
+    if ((int)alpha <= 0 || !BeginEffect(rect, clipped)) {
+        return;
+    }
+
+#if SDK_HAS_OPENGL
+    GLState& state = *m_gl;
+    CopyToScratch(state, clipped, m_height);
+    EffectPass pass = { Effect::MOTION_BLUR, state.scratch[0], state.targetFramebuffer, false, MOTION_SAMPLES,
+                        directionX, directionY, { (int)alpha / 255.0f, 0 } };
+    RunEffect(state, pass, clipped, m_height);
+#else
+    (void)directionX; (void)directionY;
+#endif
+}
+
+void GLRenderBackend::ApplyChromaticAberration(const RECT& rect, float strength, int offsetX, int offsetY)
+{
+    int shiftX = (int)(offsetX * strength);
+    int shiftY = (int)(offsetY * strength);
+    RECT clipped;
+    if ((shiftX == 0 && shiftY == 0) || !BeginEffect(rect, clipped)) {
+        return;
+    }
+
+#if SDK_HAS_OPENGL
+    GLState& state = *m_gl;
+    CopyToScratch(state, clipped, m_height);
+    EffectPass pass = { Effect::CHROMATIC_ABERRATION, state.scratch[0], state.targetFramebuffer, false, 0,
+                        shiftX, shiftY, { 0, 0 } };
+    RunEffect(state, pass, clipped, m_height);
+#endif
+}
+
+bool GLRenderBackend::ReadPixels(std::vector<uint32_t>& pixels)
+{
+    if (!m_initialized) {
+        return false;
+    }
+
+#if SDK_HAS_OPENGL
+    Flush();
+    GLState& state = *m_gl;
+    pixels.resize((size_t)m_width * m_height);
+    state.gl.BindFramebuffer(GL_READ_FRAMEBUFFER, state.targetFramebuffer);
+    glReadPixels(0, 0, m_width, m_height, GL_BGRA, GL_UNSIGNED_BYTE, pixels.data());
+
+    // GL rows run bottom-up
+    for (int y = 0; y < m_height / 2; y++) {
+        std::swap_ranges(pixels.begin() + (size_t)y * m_width, pixels.begin() + (size_t)(y + 1) * m_width,
+            pixels.begin() + (size_t)(m_height - 1 - y) * m_width);
+    }
+    return glGetError() == GL_NO_ERROR;
+#else
+    pixels.clear();
+    return false;
+#endif
+}
+
+GlyphAtlas::Stats GLRenderBackend::GetTextStats() const
+{
+    return m_glyphs ? m_glyphs->GetStats() : GlyphAtlas::Stats();
+}
+
+size_t GLRenderBackend::GetDrawCallCount() const
+{
+#if SDK_HAS_OPENGL
+    return m_gl->drawCalls;
+#else
+    return 0;
+#endif
+}
+
+RenderBackend::Capabilities GLRenderBackend::GetCapabilities() const
+{
+    Capabilities caps;
+    caps.supportsGPUAcceleration = true;
+    caps.supportsAdvancedEffects = true;
+    caps.supportsAntialiasing = true;
+    caps.supportsTransparency = true;
+#if SDK_HAS_OPENGL
+    caps.maxTextureSize = m_gl->maxTextureSize;
+#else
+    caps.maxTextureSize = 0;
+#endif
+    return caps;
+}
+
+} // namespace SDK
+
+#endif // SDK_PLATFORM_LINUX && SDK_HAS_X11
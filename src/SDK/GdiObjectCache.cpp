@@ -0,0 +1,214 @@
+#include "../../include/SDK/GdiObjectCache.h"
+#include <algorithm>
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+
+namespace SDK {
+
+namespace {
+    constexpr size_t DEFAULT_CAPACITY = 256;
+    constexpr uint32_t DEFAULT_IDLE_FRAMES = 120;
+    constexpr uint64_t SWEEP_INTERVAL = 32;     // Frames between idle sweeps under capacity
+
+    const char* const SUBSYSTEM_NAMES[] = {
+        "object cache", "fonts", "back buffers", "layers", "shadows", "atlas", "animation", "effects", "images", "other"
+    };
+    static_assert(sizeof(SUBSYSTEM_NAMES) / sizeof(SUBSYSTEM_NAMES[0]) == (size_t)GdiSubsystem::COUNT,
+                  "one name per subsystem");
+
+    std::atomic<int64_t> g_live[(size_t)GdiSubsystem::COUNT];
+    std::atomic<int64_t> g_peak[(size_t)GdiSubsystem::COUNT];
+
+    std::atomic<size_t> g_capacity(DEFAULT_CAPACITY);
+    std::atomic<uint32_t> g_idleFrames(DEFAULT_IDLE_FRAMES);
+    std::atomic<uint64_t> g_hits(0);
+    std::atomic<uint64_t> g_misses(0);
+    std::atomic<uint64_t> g_evictions(0);
+
+    // Top two bits tell brushes, pens and regions apart
+    constexpr uint64_t KEY_BRUSH = 1ull << 62;
+    constexpr uint64_t KEY_PEN = 2ull << 62;
+    constexpr uint64_t KEY_REGION = 3ull << 62;
+
+    struct Entry {
+        HGDIOBJ handle;
+        uint64_t lastFrame;
+        POINT origin;       // Where a region currently sits
+    };
+
+    struct ThreadCache {
+        std::unordered_map<uint64_t, Entry> objects;
+        uint64_t frame = 0;
+
+        ~ThreadCache() { Clear(); }
+
+        void Clear() {
+            for (auto& pair : objects) {
+                DeleteObject(pair.second.handle);
+            }
+            GdiHandleCounter::Remove(GdiSubsystem::OBJECT_CACHE, (int)objects.size());
+            objects.clear();
+        }
+
+        Entry* Find(uint64_t key) {
+            auto it = objects.find(key);
+            if (it == objects.end()) {
+                g_misses.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            g_hits.fetch_add(1, std::memory_order_relaxed);
+            it->second.lastFrame = frame;
+            return &it->second;
+        }
+
+        Entry* Insert(uint64_t key, HGDIOBJ handle) {
+            if (!handle) return nullptr;
+            GdiHandleCounter::Add(GdiSubsystem::OBJECT_CACHE);
+            Entry& entry = objects[key];
+            entry.handle = handle;
+            entry.lastFrame = frame;
+            entry.origin = { 0, 0 };
+            return &entry;
+        }
+
+        void Evict(std::unordered_map<uint64_t, Entry>::iterator it) {
+            DeleteObject(it->second.handle);
+            GdiHandleCounter::Remove(GdiSubsystem::OBJECT_CACHE);
+            g_evictions.fetch_add(1, std::memory_order_relaxed);
+            objects.erase(it);
+        }
+
+        void Trim() {
+            size_t capacity = g_capacity.load(std::memory_order_relaxed);
+            bool overCapacity = objects.size() > capacity;
+            if (!overCapacity && frame % SWEEP_INTERVAL != 0) return;
+
+            uint64_t idleFrames = g_idleFrames.load(std::memory_order_relaxed);
+            for (auto it = objects.begin(); it != objects.end();) {
+                auto next = std::next(it);
+                if (frame - it->second.lastFrame > idleFrames) Evict(it);
+                it = next;
+            }
+            if (objects.size() <= capacity) return;
+
+            // Still over: the least recently used go, oldest first
+            std::vector<std::pair<uint64_t, uint64_t>> byUse;
+            byUse.reserve(objects.size());
+            for (const auto& pair : objects) {
+                byUse.emplace_back(pair.second.lastFrame, pair.first);
+            }
+            size_t excess = objects.size() - capacity;
+            std::nth_element(byUse.begin(), byUse.begin() + (excess - 1), byUse.end());
+            for (size_t i = 0; i < excess; i++) {
+                Evict(objects.find(byUse[i].second));
+            }
+        }
+    };
+
+    thread_local ThreadCache t_cache;
+}
+
+void GdiHandleCounter::Add(GdiSubsystem subsystem, int handles) {
+    size_t index = (size_t)subsystem;
+    int64_t live = g_live[index].fetch_add(handles, std::memory_order_relaxed) + handles;
+    int64_t peak = g_peak[index].load(std::memory_order_relaxed);
+    while (live > peak && !g_peak[index].compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+}
+
+void GdiHandleCounter::Remove(GdiSubsystem subsystem, int handles) {
+    g_live[(size_t)subsystem].fetch_sub(handles, std::memory_order_relaxed);
+}
+
+int64_t GdiHandleCounter::GetLive(GdiSubsystem subsystem) {
+    return g_live[(size_t)subsystem].load(std::memory_order_relaxed);
+}
+
+int64_t GdiHandleCounter::GetPeak(GdiSubsystem subsystem) {
+    return g_peak[(size_t)subsystem].load(std::memory_order_relaxed);
+}
+
+int64_t GdiHandleCounter::GetTotalLive() {
+    int64_t total = 0;
+    for (const auto& live : g_live) {
+        total += live.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+const char* GdiHandleCounter::GetName(GdiSubsystem subsystem) {
+    return subsystem < GdiSubsystem::COUNT ? SUBSYSTEM_NAMES[(size_t)subsystem] : "";
+}
+
+uint32_t GdiHandleCounter::GetProcessCount() {
+    return (uint32_t)GetGuiResources(GetCurrentProcess(), GR_GDIOBJECTS);
+}
+
+HBRUSH GdiObjectCache::GetBrush(COLORREF color) {
+    uint64_t key = KEY_BRUSH | color;
+    Entry* entry = t_cache.Find(key);
+    if (!entry) entry = t_cache.Insert(key, CreateSolidBrush(color));
+    return entry ? (HBRUSH)entry->handle : nullptr;
+}
+
+HPEN GdiObjectCache::GetPen(COLORREF color, int width, int style) {
+    uint64_t key = KEY_PEN | ((uint64_t)(style & 0xFF) << 48) | ((uint64_t)(width & 0xFFFF) << 32) | color;
+    Entry* entry = t_cache.Find(key);
+    if (!entry) entry = t_cache.Insert(key, CreatePen(style, width, color));
+    return entry ? (HPEN)entry->handle : nullptr;
+}
+
+HRGN GdiObjectCache::GetRoundRectRegion(const RECT& rect, int radius) {
+    uint64_t width = (uint64_t)(std::max)(0L, (long)(rect.right - rect.left)) & 0xFFFFF;
+    uint64_t height = (uint64_t)(std::max)(0L, (long)(rect.bottom - rect.top)) & 0xFFFFF;
+    uint64_t key = KEY_REGION | (width << 40) | (height << 20) | ((uint64_t)(std::max)(0, radius) & 0xFFFFF);
+
+    Entry* entry = t_cache.Find(key);
+    if (!entry) {
+        entry = t_cache.Insert(key, CreateRoundRectRgn(0, 0, (int)width + 1, (int)height + 1, radius * 2, radius * 2));
+        if (!entry) return nullptr;
+    }
+    if (entry->origin.x != rect.left || entry->origin.y != rect.top) {
+        OffsetRgn((HRGN)entry->handle, rect.left - entry->origin.x, rect.top - entry->origin.y);
+        entry->origin = { rect.left, rect.top };
+    }
+    return (HRGN)entry->handle;
+}
+
+void GdiObjectCache::EndFrame() {
+    t_cache.frame++;
+    t_cache.Trim();
+}
+
+void GdiObjectCache::SetCapacity(size_t maxObjects) {
+    g_capacity.store(maxObjects, std::memory_order_relaxed);
+}
+
+size_t GdiObjectCache::GetCapacity() {
+    return g_capacity.load(std::memory_order_relaxed);
+}
+
+void GdiObjectCache::SetIdleFrames(uint32_t frames) {
+    g_idleFrames.store(frames, std::memory_order_relaxed);
+}
+
+void GdiObjectCache::Clear() {
+    t_cache.Clear();
+}
+
+GdiObjectCache::Stats GdiObjectCache::GetStats() {
+    Stats stats;
+    stats.hits = g_hits.load(std::memory_order_relaxed);
+    stats.misses = g_misses.load(std::memory_order_relaxed);
+    stats.evictions = g_evictions.load(std::memory_order_relaxed);
+    stats.size = t_cache.objects.size();
+    return stats;
+}
+
+void GdiObjectCache::ResetStats() {
+    g_hits.store(0, std::memory_order_relaxed);
+    g_misses.store(0, std::memory_order_relaxed);
+    g_evictions.store(0, std::memory_order_relaxed);
+}
+
+} // namespace SDK
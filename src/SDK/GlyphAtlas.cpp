@@ -0,0 +1,261 @@
+#include "../../include/SDK/GlyphAtlas.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+namespace SDK {
+
+namespace {
+    // Empty texels right and below each glyph, so filtered sampling stays clean
+    constexpr int GLYPH_PADDING = 1;
+    constexpr size_t DEFAULT_RUN_CAPACITY = 512;
+
+    uint64_t GlyphKey(uint32_t font, uint32_t codepoint) {
+        return ((uint64_t)font << 32) | codepoint;
+    }
+}
+
+GlyphAtlas::GlyphAtlas(int width, int height, Rasterizer rasterizer)
+    : m_width(std::max(1, width))
+    , m_height(std::max(1, height))
+    , m_rasterizer(std::move(rasterizer))
+    , m_coverage((size_t)m_width * m_height, 0)
+    , m_epoch(0)
+    , m_dirtyLeft(INT_MAX)
+    , m_dirtyTop(INT_MAX)
+    , m_dirtyRight(0)
+    , m_dirtyBottom(0)
+    , m_runCapacity(DEFAULT_RUN_CAPACITY)
+    , m_glyphHits(0)
+    , m_glyphMisses(0)
+    , m_runHits(0)
+    , m_runMisses(0)
+    , m_resets(0)
+    , m_memorySource("GlyphAtlas", [this]() { return GetMemoryBytes(); },
+                     [this](size_t targetBytes) { TrimMemory(targetBytes); })
+{
+}
+
+const GlyphAtlas::Glyph* GlyphAtlas::GetGlyph(uint32_t font, uint32_t codepoint) {
+    uint64_t key = GlyphKey(font, codepoint);
+    auto it = m_glyphs.find(key);
+    if (it != m_glyphs.end()) {
+        m_glyphHits++;
+        return it->second.x < 0 ? nullptr : &it->second;
+    }
+    m_glyphMisses++;
+
+    // Failures are cached too (x < 0), so a missing glyph isn't retried every frame
+    Glyph glyph = { -1, -1, 0, 0, 0, 0, 0 };
+    Bitmap& bitmap = m_scratch;
+    bitmap.width = bitmap.height = bitmap.left = bitmap.top = bitmap.advance = 0;
+    bitmap.coverage.clear();
+    if (m_rasterizer && m_rasterizer(font, codepoint, bitmap) && bitmap.width >= 0 && bitmap.height >= 0 &&
+        bitmap.coverage.size() >= (size_t)bitmap.width * bitmap.height) {
+        glyph.left = bitmap.left;
+        glyph.top = bitmap.top;
+        glyph.advance = bitmap.advance;
+        if (bitmap.width == 0 || bitmap.height == 0) {
+            glyph.x = glyph.y = 0;
+        } else {
+            int x, y;
+            bool packed = Pack(bitmap.width + GLYPH_PADDING, bitmap.height + GLYPH_PADDING, x, y);
+            if (!packed) {
+                Reset();
+                packed = Pack(bitmap.width + GLYPH_PADDING, bitmap.height + GLYPH_PADDING, x, y);
+            }
+            if (packed) {
+                glyph.x = x;
+                glyph.y = y;
+                glyph.width = bitmap.width;
+                glyph.height = bitmap.height;
+                for (int row = 0; row < bitmap.height; row++) {
+                    memcpy(&m_coverage[(size_t)(y + row) * m_width + x],
+                           &bitmap.coverage[(size_t)row * bitmap.width], bitmap.width);
+                }
+                m_dirtyLeft = std::min(m_dirtyLeft, x);
+                m_dirtyTop = std::min(m_dirtyTop, y);
+                m_dirtyRight = std::max(m_dirtyRight, x + bitmap.width);
+                m_dirtyBottom = std::max(m_dirtyBottom, y + bitmap.height);
+            }
+        }
+    }
+
+    Glyph& stored = m_glyphs.emplace(key, glyph).first->second;
+    return stored.x < 0 ? nullptr : &stored;
+}
+
+const GlyphAtlas::Run& GlyphAtlas::GetRun(uint32_t font, const std::wstring& text) {
+    auto& index = m_runIndex[font];
+    auto found = index.find(text);
+    if (found != index.end()) {
+        m_runs.splice(m_runs.begin(), m_runs, found->second);
+        CachedRun& cached = m_runs.front();
+        if (cached.epoch == m_epoch) {
+            m_runHits++;
+        } else {
+            m_runMisses++;
+            Layout(cached);
+        }
+        return cached.run;
+    }
+
+    m_runMisses++;
+    m_runs.push_front(CachedRun{ font, text, Run(), 0 });
+    index.emplace(text, m_runs.begin());
+    Layout(m_runs.front());
+    TrimRuns(m_runCapacity);
+    return m_runs.front().run;
+}
+
+void GlyphAtlas::Layout(CachedRun& cached) {
+    const std::wstring& text = cached.text;
+    Run& run = cached.run;
+
+    // Adding a glyph may empty a full atlas, leaving the glyphs placed so far
+    // stale. Laying out again from an empty atlas fits any sensible line; one
+    // that still overflows keeps only what followed the last reset.
+    for (int attempt = 0; attempt < 2; attempt++) {
+        run.glyphs.clear();
+        uint64_t epoch = m_epoch;
+        bool restart = false;
+        int pen = 0;
+        for (size_t i = 0; i < text.size() && !restart; i++) {
+            uint32_t codepoint = (uint32_t)text[i];
+            if (sizeof(wchar_t) == 2 && codepoint >= 0xD800 && codepoint < 0xDC00 && i + 1 < text.size() &&
+                (uint32_t)text[i + 1] >= 0xDC00 && (uint32_t)text[i + 1] < 0xE000) {
+                codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + ((uint32_t)text[i + 1] - 0xDC00);
+                i++;
+            }
+
+            const Glyph* glyph = GetGlyph(cached.font, codepoint);
+            if (m_epoch != epoch) {
+                epoch = m_epoch;
+                restart = attempt == 0;
+                run.glyphs.clear();
+            }
+            if (!glyph || restart) continue;
+            if (glyph->width > 0 && glyph->height > 0) {
+                run.glyphs.push_back({ glyph, pen });
+            }
+            pen += glyph->advance;
+        }
+        run.width = pen;
+        if (!restart) break;
+    }
+    cached.epoch = m_epoch;
+}
+
+void GlyphAtlas::TrimRuns(size_t maxRuns) {
+    while (m_runs.size() > maxRuns) {
+        const CachedRun& oldest = m_runs.back();
+        auto fontRuns = m_runIndex.find(oldest.font);
+        fontRuns->second.erase(oldest.text);
+        if (fontRuns->second.empty()) m_runIndex.erase(fontRuns);
+        m_runs.pop_back();
+    }
+}
+
+size_t GlyphAtlas::GetRunBytes(const CachedRun& cached) const {
+    return sizeof(CachedRun) + cached.text.capacity() * sizeof(wchar_t) +
+           cached.run.glyphs.capacity() * sizeof(RunGlyph);
+}
+
+size_t GlyphAtlas::GetMemoryBytes() const {
+    size_t bytes = m_coverage.capacity() + m_scratch.coverage.capacity() +
+                   m_shelves.capacity() * sizeof(Shelf) +
+                   m_glyphs.size() * (sizeof(uint64_t) + sizeof(Glyph));
+    for (const CachedRun& cached : m_runs) {
+        bytes += GetRunBytes(cached);
+    }
+    return bytes;
+}
+
+// The coverage surface is fixed, so trimming gives back cached runs, oldest first
+void GlyphAtlas::TrimMemory(size_t targetBytes) {
+    size_t bytes = GetMemoryBytes();
+    size_t keep = m_runs.size();
+    for (auto it = m_runs.rbegin(); it != m_runs.rend() && bytes > targetBytes; ++it) {
+        bytes -= GetRunBytes(*it);
+        keep--;
+    }
+    TrimRuns(keep);
+    std::vector<uint8_t>().swap(m_scratch.coverage);
+}
+
+bool GlyphAtlas::Pack(int width, int height, int& x, int& y) {
+    if (width > m_width || height > m_height) return false;
+
+    // The shortest shelf the glyph fits without wasting much of its height
+    Shelf* best = nullptr;
+    for (Shelf& shelf : m_shelves) {
+        if (shelf.height >= height && shelf.height <= height + height / 4 + 2 && m_width - shelf.x >= width &&
+            (!best || shelf.height < best->height)) {
+            best = &shelf;
+        }
+    }
+    if (!best) {
+        int top = m_shelves.empty() ? 0 : m_shelves.back().y + m_shelves.back().height;
+        if (top + height > m_height) return false;
+        m_shelves.push_back({ top, height, 0 });
+        best = &m_shelves.back();
+    }
+    x = best->x;
+    y = best->y;
+    best->x += width;
+    return true;
+}
+
+void GlyphAtlas::Reset() {
+    m_glyphs.clear();
+    m_shelves.clear();
+    m_epoch++;
+    m_resets++;
+}
+
+void GlyphAtlas::Clear() {
+    Reset();
+    m_runs.clear();
+    m_runIndex.clear();
+}
+
+void GlyphAtlas::SetRunCapacity(size_t maxRuns) {
+    m_runCapacity = std::max<size_t>(1, maxRuns);
+    TrimRuns(m_runCapacity);
+}
+
+bool GlyphAtlas::GetDirtyRect(RECT& rect) const {
+    if (m_dirtyRight <= m_dirtyLeft || m_dirtyBottom <= m_dirtyTop) return false;
+    rect.left = m_dirtyLeft;
+    rect.top = m_dirtyTop;
+    rect.right = m_dirtyRight;
+    rect.bottom = m_dirtyBottom;
+    return true;
+}
+
+void GlyphAtlas::ClearDirtyRect() {
+    m_dirtyLeft = m_dirtyTop = INT_MAX;
+    m_dirtyRight = m_dirtyBottom = 0;
+}
+
+GlyphAtlas::Stats GlyphAtlas::GetStats() const {
+    Stats stats;
+    stats.glyphHits = m_glyphHits;
+    stats.glyphMisses = m_glyphMisses;
+    stats.runHits = m_runHits;
+    stats.runMisses = m_runMisses;
+    stats.resets = m_resets;
+    stats.glyphs = m_glyphs.size();
+    stats.runs = m_runs.size();
+    return stats;
+}
+
+void GlyphAtlas::ResetStats() {
+    m_glyphHits = 0;
+    m_glyphMisses = 0;
+    m_runHits = 0;
+    m_runMisses = 0;
+    m_resets = 0;
+}
+
+} // namespace SDK
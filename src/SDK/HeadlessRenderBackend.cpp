@@ -0,0 +1,729 @@
+#include "../../include/SDK/HeadlessRenderBackend.h"
+#include "../../include/SDK/EffectGraph.h"
+#include "../../include/SDK/JobScheduler.h"
+#include "../../include/SDK/PixelKernels.h"
+#include "../../include/SDK/PngEncoder.h"
+#include "../../include/SDK/ShadowCache.h"
+#include "../../include/SDK/StringUtils.h"
+#include "../../include/SDK/TextureAtlas.h"
+#include <algorithm>
+#include <cmath>
+
+#if SDK_PLATFORM_WINDOWS
+#include "../../include/SDK/FontCache.h"
+#endif
+
+namespace SDK {
+
+namespace {
+    constexpr int GLYPH_ATLAS_WIDTH = 1024;
+    constexpr int GLYPH_ATLAS_HEIGHT = 512;
+    constexpr int CHUNKS_PER_THREAD = 4;    // RenderParallel: small enough to balance uneven renders
+    constexpr float ASCENT_FRACTION = 0.8f; // Of the pixel size, when the font has no metrics
+
+    // Every channel scaled by coverage / 255
+    uint32_t Scale(uint32_t pixel, uint32_t coverage) {
+        if (coverage >= 255) return pixel;
+        return (PremultipliedPixel::MulDiv255(pixel >> 24, coverage) << 24) |
+               (PremultipliedPixel::MulDiv255((pixel >> 16) & 0xFF, coverage) << 16) |
+               (PremultipliedPixel::MulDiv255((pixel >> 8) & 0xFF, coverage) << 8) |
+               PremultipliedPixel::MulDiv255(pixel & 0xFF, coverage);
+    }
+
+    void Blend(uint32_t& dst, uint32_t src) {
+        if ((src >> 24) == 255) {
+            dst = src;
+        } else if (src) {
+            dst = PremultipliedPixel::Over(dst, src);
+        }
+    }
+
+    // Coverage of a pixel whose center is distance outside an edge
+    float EdgeCoverage(float distance) {
+        return std::min(1.0f, std::max(0.0f, 0.5f - distance));
+    }
+
+    Color Lerp(Color a, Color b, float t) {
+        auto mix = [t](int from, int to) { return (int)std::lround(from + (to - from) * t); };
+        return Color(mix(a.r, b.r), mix(a.g, b.g), mix(a.b, b.b), mix(a.a, b.a));
+    }
+
+    int DefaultAdvance(int pixelSize, int weight) {
+        // Matches RenderBackend::MeasureText's estimate
+        return std::max(1, (int)std::lround(pixelSize * (weight >= FW_BOLD ? 0.6f : 0.55f)));
+    }
+
+    // Placeholder glyphs where there is no font engine: an outlined box per
+    // character, lower case at x-height, so layout and color still show
+    bool RasterizeBoxGlyph(int pixelSize, int weight, uint32_t codepoint, GlyphAtlas::Bitmap& bitmap) {
+        bitmap.advance = DefaultAdvance(pixelSize, weight);
+        bool blank = codepoint <= 0x20 || codepoint == 0x7F || codepoint == 0xA0 || codepoint == 0x3000;
+        if (blank) {
+            bitmap.width = bitmap.height = bitmap.left = bitmap.top = 0;
+            bitmap.coverage.clear();
+            return true;
+        }
+
+        int margin = std::max(1, bitmap.advance / 8);
+        bool lower = codepoint >= 'a' && codepoint <= 'z';
+        bitmap.width = std::max(1, bitmap.advance - 2 * margin);
+        bitmap.height = std::max(1, (int)std::lround(pixelSize * (lower ? 0.5f : 0.7f)));
+        bitmap.left = margin;
+        bitmap.top = bitmap.height;
+        int stroke = std::max(1, (int)std::lround(pixelSize / (weight >= FW_BOLD ? 8.0f : 12.0f)));
+
+        bitmap.coverage.assign((size_t)bitmap.width * bitmap.height, 0);
+        for (int y = 0; y < bitmap.height; y++) {
+            for (int x = 0; x < bitmap.width; x++) {
+                bool edge = x < stroke || y < stroke || x >= bitmap.width - stroke || y >= bitmap.height - stroke;
+                if (edge) bitmap.coverage[(size_t)y * bitmap.width + x] = 255;
+            }
+        }
+        return true;
+    }
+
+#if SDK_PLATFORM_WINDOWS
+    bool RasterizeGdiGlyph(HDC dc, const std::wstring& family, int pixelSize, int weight,
+                           uint32_t codepoint, GlyphAtlas::Bitmap& bitmap) {
+        if (codepoint > 0xFFFF) return false;
+        FontCache::FontPtr font = FontCache::Get(family.empty() ? L"Segoe UI" : family, pixelSize, weight);
+        if (!font || !font->handle) return false;
+        HGDIOBJ oldFont = SelectObject(dc, font->handle);
+
+        // GGO_GRAY8_BITMAP: 65 levels, rows padded to four bytes
+        const MAT2 identity = { {0, 1}, {0, 0}, {0, 0}, {0, 1} };
+        GLYPHMETRICS metrics;
+        DWORD size = GetGlyphOutlineW(dc, codepoint, GGO_GRAY8_BITMAP, &metrics, 0, nullptr, &identity);
+        bool ok = size != GDI_ERROR;
+        std::vector<uint8_t> gray;
+        if (ok && size > 0) {
+            gray.resize(size);
+            ok = GetGlyphOutlineW(dc, codepoint, GGO_GRAY8_BITMAP, &metrics, size, gray.data(), &identity) != GDI_ERROR;
+        }
+        SelectObject(dc, oldFont);
+        if (!ok) return false;
+
+        bitmap.advance = metrics.gmCellIncX;
+        if (size == 0) {
+            // Blank glyphs report a one-pixel black box but no bitmap
+            bitmap.width = bitmap.height = bitmap.left = bitmap.top = 0;
+            bitmap.coverage.clear();
+            return true;
+        }
+        bitmap.width = (int)metrics.gmBlackBoxX;
+        bitmap.height = (int)metrics.gmBlackBoxY;
+        bitmap.left = metrics.gmptGlyphOrigin.x;
+        bitmap.top = metrics.gmptGlyphOrigin.y;
+        bitmap.coverage.resize((size_t)bitmap.width * bitmap.height);
+        size_t pitch = ((size_t)bitmap.width + 3) & ~(size_t)3;
+        for (int y = 0; y < bitmap.height; y++) {
+            for (int x = 0; x < bitmap.width; x++) {
+                uint32_t level = std::min<uint32_t>(gray[y * pitch + x], 64);
+                bitmap.coverage[(size_t)y * bitmap.width + x] = (uint8_t)((level * 255 + 32) / 64);
+            }
+        }
+        return true;
+    }
+#endif
+}
+
+struct HeadlessRenderBackend::GdiSurface {
+#if SDK_PLATFORM_WINDOWS
+    HDC dc = nullptr;           // Interop: a DIB section mirroring the buffer
+    HBITMAP bitmap = nullptr;
+    HGDIOBJ oldBitmap = nullptr;
+    uint32_t* bits = nullptr;
+    int width = 0;
+    int height = 0;
+    HDC glyphDC = nullptr;      // The default rasterizer's fonts are selected here
+
+    ~GdiSurface() {
+        if (dc) {
+            SelectObject(dc, oldBitmap);
+            if (bitmap) DeleteObject(bitmap);
+            DeleteDC(dc);
+        }
+        if (glyphDC) DeleteDC(glyphDC);
+    }
+#endif
+};
+
+HeadlessRenderBackend::HeadlessRenderBackend(int width, int height)
+    : m_width(0)
+    , m_height(0)
+    , m_glyphs(GLYPH_ATLAS_WIDTH, GLYPH_ATLAS_HEIGHT,
+        [this](uint32_t font, uint32_t codepoint, GlyphAtlas::Bitmap& bitmap) {
+            return Rasterize(font, codepoint, bitmap);
+        })
+{
+    Resize(width, height);
+}
+
+HeadlessRenderBackend::~HeadlessRenderBackend() = default;
+
+void HeadlessRenderBackend::Resize(int width, int height)
+{
+    m_width = std::max(0, width);
+    m_height = std::max(0, height);
+    m_pixels.assign((size_t)m_width * m_height, 0);
+}
+
+bool HeadlessRenderBackend::EncodePNG(std::vector<uint8_t>& png) const
+{
+    return PngEncoder::Encode(m_pixels.data(), m_width, m_height, m_width, png);
+}
+
+bool HeadlessRenderBackend::SavePNG(const std::wstring& path) const
+{
+    return PngEncoder::Save(path, m_pixels.data(), m_width, m_height, m_width);
+}
+
+void HeadlessRenderBackend::SetFontRasterizer(FontRasterizer rasterizer)
+{
+    // Metrics and glyphs both came from the old rasterizer
+    m_rasterizer = std::move(rasterizer);
+    m_glyphs.Clear();
+    m_fonts.clear();
+    m_fontIds.clear();
+}
+
+void HeadlessRenderBackend::RenderParallel(size_t count, int width, int height,
+                                           const std::function<void(size_t index, HeadlessRenderBackend& backend)>& render)
+{
+    if (count == 0 || !render) return;
+
+    // A backend per chunk, so consecutive renders on a worker reuse its glyphs
+    int total = (int)std::min<size_t>(count, INT32_MAX);
+    int chunks = (int)(JobScheduler::GetWorkerCount() + 1) * CHUNKS_PER_THREAD;
+    int grain = std::max(1, total / chunks);
+    JobScheduler::ParallelFor(total, grain, [&](int begin, int end) {
+        HeadlessRenderBackend backend(width, height);
+        for (int i = begin; i < end; i++) {
+            if (i > begin) backend.Resize(width, height);
+            render((size_t)i, backend);
+        }
+    }, "HeadlessRenderBackend::RenderParallel");
+}
+
+bool HeadlessRenderBackend::Initialize(HWND hwnd)
+{
+    (void)hwnd;
+    return true;
+}
+
+void HeadlessRenderBackend::Shutdown()
+{
+    m_gdi.reset();
+    m_glyphs.Clear();
+}
+
+bool HeadlessRenderBackend::BeginDraw()
+{
+    return m_width > 0 && m_height > 0;
+}
+
+void HeadlessRenderBackend::EndDraw()
+{
+}
+
+void HeadlessRenderBackend::Clear(Color color)
+{
+    std::fill(m_pixels.begin(), m_pixels.end(), color.ToPremultiplied());
+}
+
+void* HeadlessRenderBackend::GetNativeContext() const
+{
+    return const_cast<uint32_t*>(m_pixels.data());
+}
+
+HDC HeadlessRenderBackend::BeginGDIInterop()
+{
+#if SDK_PLATFORM_WINDOWS
+    if (m_width <= 0 || m_height <= 0) return nullptr;
+    if (!m_gdi) m_gdi.reset(new GdiSurface());
+    GdiSurface& gdi = *m_gdi;
+
+    if (!gdi.dc) {
+        gdi.dc = CreateCompatibleDC(nullptr);
+        if (!gdi.dc) return nullptr;
+    }
+    if (!gdi.bitmap || gdi.width != m_width || gdi.height != m_height) {
+        BITMAPINFO info = {};
+        info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+        info.bmiHeader.biWidth = m_width;
+        info.bmiHeader.biHeight = -m_height;    // Top-down, like the buffer
+        info.bmiHeader.biPlanes = 1;
+        info.bmiHeader.biBitCount = 32;
+        info.bmiHeader.biCompression = BI_RGB;
+        void* bits = nullptr;
+        HBITMAP bitmap = CreateDIBSection(nullptr, &info, DIB_RGB_COLORS, &bits, nullptr, 0);
+        if (!bitmap) return nullptr;
+
+        if (gdi.bitmap) {
+            SelectObject(gdi.dc, gdi.oldBitmap);
+            DeleteObject(gdi.bitmap);
+        }
+        gdi.oldBitmap = SelectObject(gdi.dc, bitmap);
+        gdi.bitmap = bitmap;
+        gdi.bits = static_cast<uint32_t*>(bits);
+        gdi.width = m_width;
+        gdi.height = m_height;
+    }
+
+    // Copied in opaque: GDI clears the alpha of what it draws, which marks
+    // even a black pixel drawn over transparent black
+    for (size_t i = 0; i < m_pixels.size(); i++) {
+        gdi.bits[i] = m_pixels[i] | 0xFF000000;
+    }
+    return gdi.dc;
+#else
+    return nullptr;
+#endif
+}
+
+void HeadlessRenderBackend::EndGDIInterop(HDC hdc)
+{
+#if SDK_PLATFORM_WINDOWS
+    if (!m_gdi || !hdc || hdc != m_gdi->dc || m_gdi->width != m_width || m_gdi->height != m_height) return;
+    GdiFlush();
+
+    // Whatever GDI touched comes back opaque; the rest keeps its alpha
+    const uint32_t* bits = m_gdi->bits;
+    for (size_t i = 0; i < m_pixels.size(); i++) {
+        if (bits[i] != (m_pixels[i] | 0xFF000000)) {
+            m_pixels[i] = bits[i] | 0xFF000000;
+        }
+    }
+#else
+    (void)hdc;
+#endif
+}
+
+bool HeadlessRenderBackend::Clip(const RECT& rect, RECT& clipped) const
+{
+    clipped.left = std::max(0L, (long)rect.left);
+    clipped.top = std::max(0L, (long)rect.top);
+    clipped.right = std::min((long)m_width, (long)rect.right);
+    clipped.bottom = std::min((long)m_height, (long)rect.bottom);
+    return clipped.right > clipped.left && clipped.bottom > clipped.top;
+}
+
+template<typename Fn>
+void HeadlessRenderBackend::WithPixels(const RECT& rect, Fn&& kernel)
+{
+    RECT clipped;
+    if (!Clip(rect, clipped)) return;
+    uint32_t* pixels = m_pixels.data() + (size_t)clipped.top * m_width + clipped.left;
+    kernel(pixels, (int)clipped.left, (int)clipped.top,
+           (int)(clipped.right - clipped.left), (int)(clipped.bottom - clipped.top), m_width);
+}
+
+template<typename Distance>
+void HeadlessRenderBackend::FillShape(const RECT& bounds, Distance&& distance, Color fillColor, Color borderColor, float borderWidth)
+{
+    RECT clipped;
+    if (!Clip(bounds, clipped)) return;
+
+    // The border lies inside the outline; fill covers what is left
+    float stroke = borderColor.a > 0 && borderWidth > 0 ? borderWidth : 0.0f;
+    uint32_t fill = fillColor.ToPremultiplied();
+    uint32_t border = borderColor.ToPremultiplied();
+    for (long y = clipped.top; y < clipped.bottom; y++) {
+        uint32_t* row = m_pixels.data() + (size_t)y * m_width;
+        for (long x = clipped.left; x < clipped.right; x++) {
+            float d = distance(x + 0.5f, y + 0.5f);
+            if (d >= 0.5f) continue;
+            float outer = EdgeCoverage(d);
+            float inner = stroke > 0 ? EdgeCoverage(d + stroke) : outer;
+            if (fill && inner > 0) {
+                Blend(row[x], Scale(fill, (uint32_t)std::lround(inner * 255)));
+            }
+            if (stroke > 0 && outer > inner) {
+                Blend(row[x], Scale(border, (uint32_t)std::lround((outer - inner) * 255)));
+            }
+        }
+    }
+}
+
+void HeadlessRenderBackend::DrawRectangle(const RECT& rect, Color fillColor, Color borderColor, float borderWidth)
+{
+    RECT clipped;
+    if (!Clip(rect, clipped)) return;
+
+    int stroke = borderColor.a > 0 && borderWidth > 0 ? std::max(1, (int)std::lround(borderWidth)) : 0;
+    RECT inner = { rect.left + stroke, rect.top + stroke, rect.right - stroke, rect.bottom - stroke };
+    uint32_t fill = fillColor.ToPremultiplied();
+    uint32_t border = borderColor.ToPremultiplied();
+    for (long y = clipped.top; y < clipped.bottom; y++) {
+        uint32_t* row = m_pixels.data() + (size_t)y * m_width;
+        bool innerRow = y >= inner.top && y < inner.bottom;
+        for (long x = clipped.left; x < clipped.right; x++) {
+            bool inside = innerRow && x >= inner.left && x < inner.right;
+            Blend(row[x], inside ? fill : border);
+        }
+    }
+}
+
+void HeadlessRenderBackend::DrawRoundedRectangle(const RECT& rect, float radius, Color fillColor, Color borderColor, float borderWidth)
+{
+    float halfWidth = (rect.right - rect.left) * 0.5f;
+    float halfHeight = (rect.bottom - rect.top) * 0.5f;
+    if (halfWidth <= 0 || halfHeight <= 0) return;
+    float cx = rect.left + halfWidth;
+    float cy = rect.top + halfHeight;
+    float r = std::min(std::max(radius, 0.0f), std::min(halfWidth, halfHeight));
+
+    FillShape(rect, [=](float px, float py) {
+        float qx = std::fabs(px - cx) - (halfWidth - r);
+        float qy = std::fabs(py - cy) - (halfHeight - r);
+        float ox = std::max(qx, 0.0f);
+        float oy = std::max(qy, 0.0f);
+        return std::sqrt(ox * ox + oy * oy) + std::min(std::max(qx, qy), 0.0f) - r;
+    }, fillColor, borderColor, borderWidth);
+}
+
+void HeadlessRenderBackend::DrawLine(int x1, int y1, int x2, int y2, Color color, float width)
+{
+    // A capsule around the segment between pixel centers: round caps, as in DrawPolylines
+    float half = std::max(width, 1.0f) * 0.5f;
+    float ax = x1 + 0.5f;
+    float ay = y1 + 0.5f;
+    float bx = (float)(x2 - x1);
+    float by = (float)(y2 - y1);
+    float lengthSquared = bx * bx + by * by;
+    int pad = (int)std::ceil(half) + 1;
+    RECT bounds = { std::min(x1, x2) - pad, std::min(y1, y2) - pad, std::max(x1, x2) + pad + 1, std::max(y1, y2) + pad + 1 };
+
+    FillShape(bounds, [=](float px, float py) {
+        float dx = px - ax;
+        float dy = py - ay;
+        float t = lengthSquared > 0 ? std::min(1.0f, std::max(0.0f, (dx * bx + dy * by) / lengthSquared)) : 0.0f;
+        float ex = dx - bx * t;
+        float ey = dy - by * t;
+        return std::sqrt(ex * ex + ey * ey) - half;
+    }, color, Color(0, 0, 0, 0), 0.0f);
+}
+
+void HeadlessRenderBackend::DrawEllipse(int cx, int cy, int rx, int ry, Color fillColor, Color borderColor, float borderWidth)
+{
+    if (rx <= 0 || ry <= 0) return;
+
+    // Distance approximated from the gradient of the implicit ellipse; exact on circles
+    float fx = (float)rx;
+    float fy = (float)ry;
+    RECT bounds = { cx - rx - 1, cy - ry - 1, cx + rx + 1, cy + ry + 1 };
+    FillShape(bounds, [=](float px, float py) {
+        float dx = px - cx;
+        float dy = py - cy;
+        float k0 = std::sqrt((dx / fx) * (dx / fx) + (dy / fy) * (dy / fy));
+        float k1 = std::sqrt((dx / (fx * fx)) * (dx / (fx * fx)) + (dy / (fy * fy)) * (dy / (fy * fy)));
+        return k1 > 0 ? k0 * (k0 - 1.0f) / k1 : -std::min(fx, fy);
+    }, fillColor, borderColor, borderWidth);
+}
+
+const HeadlessRenderBackend::FontKey* HeadlessRenderBackend::GetFont(const std::wstring& fontFamily, float fontSize,
+                                                                     int fontWeight, uint32_t& id)
+{
+    int pixelSize = std::max(1, (int)std::lround(fontSize > 0 ? fontSize : 12.0f));
+    std::wstring& key = m_fontKey;
+    key.assign(fontFamily).push_back(L'|');
+    AppendDecimal(key, pixelSize);
+    key.push_back(L'|');
+    AppendDecimal(key, fontWeight);
+    auto found = m_fontIds.find(key);
+    if (found != m_fontIds.end()) {
+        id = found->second;
+        return &m_fonts[id];
+    }
+
+    FontKey font = { fontFamily, pixelSize, fontWeight, 0, 0 };
+    font.ascent = (int)std::lround(pixelSize * ASCENT_FRACTION);
+    font.descent = pixelSize - font.ascent;
+#if SDK_PLATFORM_WINDOWS
+    if (!m_rasterizer) {
+        FontCache::FontPtr gdiFont = FontCache::Get(fontFamily.empty() ? L"Segoe UI" : fontFamily, pixelSize, fontWeight);
+        HDC dc = GetGlyphDC();
+        TEXTMETRICW metrics;
+        if (dc && gdiFont && gdiFont->handle) {
+            HGDIOBJ oldFont = SelectObject(dc, gdiFont->handle);
+            if (GetTextMetricsW(dc, &metrics)) {
+                font.ascent = metrics.tmAscent;
+                font.descent = metrics.tmDescent;
+            }
+            SelectObject(dc, oldFont);
+        }
+    }
+#endif
+
+    id = (uint32_t)m_fonts.size();
+    m_fontIds.emplace(key, id);
+    m_fonts.push_back(font);
+    return &m_fonts.back();
+}
+
+HDC HeadlessRenderBackend::GetGlyphDC()
+{
+#if SDK_PLATFORM_WINDOWS
+    if (!m_gdi) m_gdi.reset(new GdiSurface());
+    if (!m_gdi->glyphDC) m_gdi->glyphDC = CreateCompatibleDC(nullptr);
+    return m_gdi->glyphDC;
+#else
+    return nullptr;
+#endif
+}
+
+bool HeadlessRenderBackend::Rasterize(uint32_t font, uint32_t codepoint, GlyphAtlas::Bitmap& bitmap)
+{
+    if (font >= m_fonts.size()) return false;
+    const FontKey& key = m_fonts[font];
+    if (m_rasterizer) {
+        return m_rasterizer(key.family, key.pixelSize, key.weight, codepoint, bitmap);
+    }
+#if SDK_PLATFORM_WINDOWS
+    if (HDC dc = GetGlyphDC()) {
+        return RasterizeGdiGlyph(dc, key.family, key.pixelSize, key.weight, codepoint, bitmap);
+    }
+#endif
+    return RasterizeBoxGlyph(key.pixelSize, key.weight, codepoint, bitmap);
+}
+
+void HeadlessRenderBackend::DrawRun(const GlyphAtlas::Run& run, int x, int baseline, Color color)
+{
+    uint32_t source = color.ToPremultiplied();
+    if (!source) return;
+
+    // Coverage straight from the atlas; nothing to upload
+    const uint8_t* coverage = m_glyphs.GetCoverage();
+    int atlasStride = m_glyphs.GetWidth();
+    for (const GlyphAtlas::RunGlyph& placed : run.glyphs) {
+        const GlyphAtlas::Glyph& glyph = *placed.glyph;
+        int left = x + placed.x + glyph.left;
+        int top = baseline - glyph.top;
+        RECT dest = { left, top, left + glyph.width, top + glyph.height };
+        RECT clipped;
+        if (!Clip(dest, clipped)) continue;
+
+        for (long y = clipped.top; y < clipped.bottom; y++) {
+            const uint8_t* in = coverage + (size_t)(glyph.y + y - top) * atlasStride + glyph.x + (clipped.left - left);
+            uint32_t* out = m_pixels.data() + (size_t)y * m_width + clipped.left;
+            for (long i = 0; i < clipped.right - clipped.left; i++) {
+                if (in[i]) Blend(out[i], Scale(source, in[i]));
+            }
+        }
+    }
+    m_glyphs.ClearDirtyRect();
+}
+
+void HeadlessRenderBackend::DrawText(const std::wstring& text, const RECT& rect, Color color,
+                                     const std::wstring& fontFamily, float fontSize, int fontWeight)
+{
+    if (text.empty()) return;
+
+    uint32_t id;
+    const FontKey* font = GetFont(fontFamily, fontSize, fontWeight, id);
+    DrawRun(m_glyphs.GetRun(id, text), rect.left + 5, rect.top + font->ascent + 5, color);
+}
+
+void HeadlessRenderBackend::DrawTextLine(const std::wstring& text, const RECT& rect, Color color,
+                                         const std::wstring& fontFamily, float fontSize, int fontWeight, TextAlign align)
+{
+    if (text.empty()) return;
+
+    uint32_t id;
+    const FontKey* font = GetFont(fontFamily, fontSize, fontWeight, id);
+    const GlyphAtlas::Run& run = m_glyphs.GetRun(id, text);
+    int x = rect.left;
+    if (align == TextAlign::CENTER) {
+        x += (rect.right - rect.left - run.width) / 2;
+    } else if (align == TextAlign::RIGHT) {
+        x = rect.right - run.width;
+    }
+    DrawRun(run, x, (rect.top + rect.bottom + font->ascent - font->descent) / 2, color);
+}
+
+int HeadlessRenderBackend::MeasureText(const std::wstring& text, const std::wstring& fontFamily, float fontSize, int fontWeight)
+{
+    uint32_t id;
+    GetFont(fontFamily, fontSize, fontWeight, id);
+    return m_glyphs.GetRun(id, text).width;
+}
+
+void HeadlessRenderBackend::DrawParticleBatch(const float* x, const float* y, const uint32_t* colors, size_t count, int size)
+{
+    RECT clip = { 0, 0, m_width, m_height };
+    RECT bounds;
+    if (!GetParticleBounds(x, y, count, size, clip, bounds)) return;
+
+    WithPixels(bounds, [&](uint32_t* pixels, int left, int top, int width, int height, int stride) {
+        PixelKernels::SplatParticles(pixels, width, height, stride, x, y, colors, count, left, top, size);
+    });
+}
+
+void HeadlessRenderBackend::DrawAtlasTexture(const TextureAtlas& atlas, const std::string& name, const RECT& dest)
+{
+    const TextureAtlas::AtlasEntry* entry = atlas.GetTexture(name);
+    int destWidth = dest.right - dest.left;
+    int destHeight = dest.bottom - dest.top;
+    if (!entry || destWidth <= 0 || destHeight <= 0) return;
+
+    // Nearest filtering, copied as on the other backends
+    const uint32_t* source = atlas.GetPixels();
+    int sourceStride = atlas.GetWidth();
+    WithPixels(dest, [&](uint32_t* pixels, int left, int top, int width, int height, int stride) {
+        for (int y = 0; y < height; y++) {
+            int sy = entry->y + (int)((int64_t)(top + y - dest.top) * entry->height / destHeight);
+            const uint32_t* in = source + (size_t)sy * sourceStride;
+            uint32_t* out = pixels + (size_t)y * stride;
+            for (int x = 0; x < width; x++) {
+                out[x] = in[entry->x + (int)((int64_t)(left + x - dest.left) * entry->width / destWidth)];
+            }
+        }
+    });
+}
+
+void HeadlessRenderBackend::DrawLinearGradient(const RECT& rect, Color startColor, Color endColor, bool horizontal)
+{
+    RECT clipped;
+    if (!Clip(rect, clipped)) return;
+
+    // One ramp entry per column (or row) in view
+    long span = horizontal ? rect.right - rect.left : rect.bottom - rect.top;
+    long first = horizontal ? clipped.left - rect.left : clipped.top - rect.top;
+    long last = horizontal ? clipped.right - rect.left : clipped.bottom - rect.top;
+    std::vector<uint32_t> ramp((size_t)(last - first));
+    for (long i = first; i < last; i++) {
+        float t = span > 1 ? (float)i / (span - 1) : 0.0f;
+        ramp[i - first] = Lerp(startColor, endColor, t).ToPremultiplied();
+    }
+
+    for (long y = clipped.top; y < clipped.bottom; y++) {
+        uint32_t* row = m_pixels.data() + (size_t)y * m_width;
+        for (long x = clipped.left; x < clipped.right; x++) {
+            Blend(row[x], ramp[horizontal ? x - clipped.left : y - clipped.top]);
+        }
+    }
+}
+
+void HeadlessRenderBackend::DrawRadialGradient(const RECT& rect, Color centerColor, Color edgeColor, int cx, int cy)
+{
+    RECT clipped;
+    if (!Clip(rect, clipped)) return;
+
+    // Center and radius as on the other backends: the farthest corner is the edge color
+    int rectWidth = rect.right - rect.left;
+    int rectHeight = rect.bottom - rect.top;
+    int gradientCx = (cx >= 0 && cx < rectWidth) ? rect.left + cx : (rect.left + rect.right) / 2;
+    int gradientCy = (cy >= 0 && cy < rectHeight) ? rect.top + cy : (rect.top + rect.bottom) / 2;
+    int dx1 = gradientCx - rect.left;
+    int dy1 = gradientCy - rect.top;
+    int dx2 = rect.right - gradientCx;
+    int dy2 = rect.bottom - gradientCy;
+    float maxRadius = std::sqrt((float)std::max({ dx1 * dx1 + dy1 * dy1, dx2 * dx2 + dy1 * dy1,
+                                                  dx1 * dx1 + dy2 * dy2, dx2 * dx2 + dy2 * dy2 }));
+    if (maxRadius <= 0) return;
+
+    uint32_t ramp[256];
+    for (int i = 0; i < 256; i++) {
+        ramp[i] = Lerp(centerColor, edgeColor, i / 255.0f).ToPremultiplied();
+    }
+
+    for (long y = clipped.top; y < clipped.bottom; y++) {
+        uint32_t* row = m_pixels.data() + (size_t)y * m_width;
+        float dy = y + 0.5f - gradientCy;
+        for (long x = clipped.left; x < clipped.right; x++) {
+            float dx = x + 0.5f - gradientCx;
+            float t = std::min(1.0f, std::sqrt(dx * dx + dy * dy) / maxRadius);
+            Blend(row[x], ramp[(int)std::lround(t * 255)]);
+        }
+    }
+}
+
+void HeadlessRenderBackend::DrawShadow(const RECT& rect, int offsetX, int offsetY, int blur, Color shadowColor)
+{
+    RECT shadowRect = {
+        rect.left + offsetX,
+        rect.top + offsetY,
+        rect.right + offsetX,
+        rect.bottom + offsetY
+    };
+
+    auto tile = ShadowCache::GetShadow(blur, 0, shadowColor);
+    WithPixels(ShadowCache::GetOuterRect(*tile, shadowRect),
+        [&](uint32_t* pixels, int left, int top, int width, int height, int stride) {
+            ShadowCache::Composite(*tile, shadowRect, pixels, left, top, width, height, stride);
+        });
+}
+
+void HeadlessRenderBackend::DrawGlow(const RECT& rect, int radius, Color glowColor)
+{
+    if (radius <= 0) return;
+
+    auto tile = ShadowCache::GetGlow(radius, glowColor);
+    WithPixels(ShadowCache::GetOuterRect(*tile, rect),
+        [&](uint32_t* pixels, int left, int top, int width, int height, int stride) {
+            ShadowCache::Composite(*tile, rect, pixels, left, top, width, height, stride);
+        });
+}
+
+void HeadlessRenderBackend::ApplyBlur(const RECT& rect, int blurRadius)
+{
+    if (blurRadius <= 0) return;
+
+    WithPixels(rect, [&](uint32_t* pixels, int, int, int width, int height, int stride) {
+        PixelKernels::BoxBlur(pixels, width, height, stride, blurRadius);
+    });
+}
+
+void HeadlessRenderBackend::ApplyBloom(const RECT& rect, float threshold, float intensity)
+{
+    WithPixels(rect, [&](uint32_t* pixels, int, int, int width, int height, int stride) {
+        PixelKernels::Bloom(pixels, width, height, stride, threshold, intensity);
+    });
+}
+
+void HeadlessRenderBackend::ApplyDepthOfField(const RECT& rect, int focalDepth, int blurAmount, float focalRange)
+{
+    if (blurAmount <= 0) return;
+
+    // Clipping may drop rows above the rect; keep the focal row where the caller put it
+    WithPixels(rect, [&](uint32_t* pixels, int, int top, int width, int height, int stride) {
+        PixelKernels::DepthOfField(pixels, width, height, stride, focalDepth - (top - (int)rect.top), blurAmount, focalRange);
+    });
+}
+
+void HeadlessRenderBackend::ApplyMotionBlur(const RECT& rect, int directionX, int directionY, float intensity)
+{
+    WithPixels(rect, [&](uint32_t* pixels, int, int, int width, int height, int stride) {
+        PixelKernels::MotionBlur(pixels, width, height, stride, directionX, directionY, intensity);
+    });
+}
+
+void HeadlessRenderBackend::ApplyChromaticAberration(const RECT& rect, float strength, int offsetX, int offsetY)
+{
+    WithPixels(rect, [&](uint32_t* pixels, int, int, int width, int height, int stride) {
+        PixelKernels::ChromaticAberration(pixels, width, height, stride, strength, offsetX, offsetY);
+    });
+}
+
+void HeadlessRenderBackend::ApplyEffectGraph(const RECT& rect, EffectGraph& graph)
+{
+    if (graph.IsEmpty()) return;
+
+    // Clipping may drop rows above the rect, as in ApplyDepthOfField
+    WithPixels(rect, [&](uint32_t* pixels, int, int top, int width, int height, int stride) {
+        graph.Run(pixels, width, height, stride, graph.GetSettings().focalDepth - (top - (int)rect.top));
+    });
+}
+
+RenderBackend::Capabilities HeadlessRenderBackend::GetCapabilities() const
+{
+    Capabilities caps;
+    caps.supportsGPUAcceleration = false;
+    caps.supportsAdvancedEffects = false;
+    caps.supportsAntialiasing = true;
+    caps.supportsTransparency = true;
+    caps.maxTextureSize = 16384;
+    return caps;
+}
+
+} // namespace SDK
@@ -0,0 +1,562 @@
+#include "../../include/SDK/ImageCache.h"
+#include "../../include/SDK/JobScheduler.h"
+#include "../../include/SDK/MemoryRegistry.h"
+#include "../../include/SDK/StringUtils.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <mutex>
+#include <unordered_map>
+
+#if SDK_PLATFORM_WINDOWS
+#include "../../include/SDK/Renderer.h"
+#include <wincodec.h>
+#endif
+
+namespace SDK {
+
+namespace {
+    constexpr size_t DEFAULT_CAPACITY = 64 * 1024 * 1024;
+
+    // Larger images are refused rather than decoded into gigabytes
+    constexpr int MAX_IMAGE_SIZE = 16384;
+
+    // Resampling weights are 16.16 fixed point
+    constexpr uint32_t WEIGHT_ONE = 1 << 16;
+
+    struct CacheItem {
+        std::shared_ptr<ImageCache::Entry> entry;
+        uint64_t lastUse;
+        size_t bytes;           // Counted once the entry is ready
+    };
+
+    std::mutex g_cacheMutex;
+    std::unordered_map<std::wstring, CacheItem> g_cache;
+    size_t g_capacity = DEFAULT_CAPACITY;
+    size_t g_bytes = 0;
+    uint64_t g_clock = 0;
+    uint64_t g_hits = 0;
+    uint64_t g_misses = 0;
+    uint64_t g_decodes = 0;
+    uint64_t g_evictions = 0;
+
+    std::wstring MakeKey(const std::wstring& path, int width, int height) {
+        std::wstring key = path;
+        key.push_back(L'\0');
+        key.append(std::to_wstring(width));
+        key.push_back(L'x');
+        key.append(std::to_wstring(height));
+        return key;
+    }
+
+    // Entries still loading hold no pixels, and ones in use would outlive
+    // eviction, so idle finished entries go first, oldest first
+    void EvictOver(size_t limit) {
+        while (g_bytes > limit) {
+            auto victim = g_cache.end();
+            for (auto it = g_cache.begin(); it != g_cache.end(); ++it) {
+                if (it->second.bytes == 0 || it->second.entry.use_count() > 1) continue;
+                if (victim == g_cache.end() || it->second.lastUse < victim->second.lastUse) victim = it;
+            }
+            if (victim == g_cache.end()) break;
+            g_bytes -= victim->second.bytes;
+            g_cache.erase(victim);
+            g_evictions++;
+        }
+    }
+
+    void EvictOverCapacity() {
+        EvictOver(g_capacity);
+    }
+
+    MemoryRegistry::Source g_memorySource("ImageCache",
+        []() {
+            std::lock_guard<std::mutex> lock(g_cacheMutex);
+            return g_bytes;
+        },
+        [](size_t targetBytes) {
+            std::lock_guard<std::mutex> lock(g_cacheMutex);
+            EvictOver(targetBytes);
+        });
+
+    uint32_t Premultiply(uint32_t r, uint32_t g, uint32_t b, uint32_t a) {
+        if (a != 255) {
+            r = (r * a + 127) / 255;
+            g = (g * a + 127) / 255;
+            b = (b * a + 127) / 255;
+        }
+        return (a << 24) | (r << 16) | (g << 8) | b;
+    }
+
+    uint32_t Read16(const uint8_t* p) {
+        return (uint32_t)p[0] | ((uint32_t)p[1] << 8);
+    }
+
+    uint32_t Read32(const uint8_t* p) {
+        return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+    }
+
+    // Channel under a bit-field mask, widened or narrowed to 8 bits
+    uint32_t ExtractChannel(uint32_t value, uint32_t mask) {
+        if (mask == 0) return 0;
+        int shift = 0;
+        while (!(mask & (1u << shift))) shift++;
+        uint32_t max = mask >> shift;
+        int bits = 0;
+        while (max >> bits) bits++;
+        uint32_t channel = (value & mask) >> shift;
+        return bits >= 8 ? channel >> (bits - 8) : channel * 255 / max;
+    }
+
+    bool ReadWholeFile(const std::wstring& path, std::vector<uint8_t>& data) {
+#if SDK_PLATFORM_WINDOWS
+        FILE* file = _wfopen(path.c_str(), L"rb");
+#else
+        FILE* file = fopen(WStringToUTF8(path).c_str(), "rb");
+#endif
+        if (!file) return false;
+        bool read = fseek(file, 0, SEEK_END) == 0;
+        long size = read ? ftell(file) : -1;
+        read = size >= 0 && fseek(file, 0, SEEK_SET) == 0;
+        if (read) {
+            data.resize((size_t)size);
+            read = fread(data.data(), 1, data.size(), file) == data.size();
+        }
+        fclose(file);
+        return read;
+    }
+
+    // Uncompressed 8-bit palette, 24-bit and 32-bit (with bit fields) BMPs
+    bool DecodeBMP(const std::vector<uint8_t>& data, int& width, int& height, std::vector<uint32_t>& pixels) {
+        if (data.size() < 54 || data[0] != 'B' || data[1] != 'M') return false;
+        uint32_t offset = Read32(&data[10]);
+        uint32_t headerSize = Read32(&data[14]);
+        int64_t w = (int32_t)Read32(&data[18]);
+        int64_t h = (int32_t)Read32(&data[22]);
+        uint32_t bits = Read16(&data[28]);
+        uint32_t compression = Read32(&data[30]);
+        if (headerSize < 40 || (uint64_t)headerSize + 14 > data.size()) return false;
+
+        bool topDown = h < 0;
+        h = topDown ? -h : h;
+        if (w <= 0 || h <= 0 || w > MAX_IMAGE_SIZE || h > MAX_IMAGE_SIZE) return false;
+        if (bits != 8 && bits != 24 && bits != 32) return false;
+
+        // Red, green, blue, alpha; BI_RGB's fourth byte is padding
+        uint32_t masks[4] = { 0x00FF0000, 0x0000FF00, 0x000000FF, 0 };
+        if (compression == 3 && bits == 32) {
+            // Right after the 40-byte header, whether inside a larger one or not
+            if (data.size() < 66) return false;
+            for (int i = 0; i < 3; i++) {
+                masks[i] = Read32(&data[54 + i * 4]);
+            }
+            if (headerSize >= 56) masks[3] = Read32(&data[66]);
+        } else if (compression != 0) {
+            return false;
+        }
+
+        size_t stride = ((size_t)w * bits + 31) / 32 * 4;
+        if (offset > data.size() || (data.size() - offset) / stride < (size_t)h) return false;
+
+        const uint8_t* palette = data.data() + 14 + headerSize;
+        size_t paletteSize = 0;
+        if (bits == 8) {
+            paletteSize = Read32(&data[46]);
+            if (paletteSize == 0 || paletteSize > 256) paletteSize = 256;
+            paletteSize = std::min(paletteSize, (size_t)(data.size() - 14 - headerSize) / 4);
+        }
+
+        width = (int)w;
+        height = (int)h;
+        pixels.resize((size_t)width * height);
+        for (int y = 0; y < height; y++) {
+            const uint8_t* row = &data[offset + stride * (size_t)(topDown ? y : height - 1 - y)];
+            uint32_t* out = &pixels[(size_t)y * width];
+            for (int x = 0; x < width; x++) {
+                if (bits == 8) {
+                    const uint8_t* color = row[x] < paletteSize ? palette + row[x] * 4 : nullptr;
+                    out[x] = color ? Premultiply(color[2], color[1], color[0], 255) : 0xFF000000;
+                } else if (bits == 24) {
+                    const uint8_t* color = row + x * 3;
+                    out[x] = Premultiply(color[2], color[1], color[0], 255);
+                } else {
+                    uint32_t value = Read32(row + x * 4);
+                    out[x] = Premultiply(ExtractChannel(value, masks[0]), ExtractChannel(value, masks[1]),
+                                         ExtractChannel(value, masks[2]),
+                                         masks[3] ? ExtractChannel(value, masks[3]) : 255);
+                }
+            }
+        }
+        return true;
+    }
+
+    // Binary PGM (P5) and PPM (P6) with 8-bit samples
+    bool DecodePNM(const std::vector<uint8_t>& data, int& width, int& height, std::vector<uint32_t>& pixels) {
+        if (data.size() < 3 || data[0] != 'P' || (data[1] != '5' && data[1] != '6')) return false;
+        int channels = data[1] == '6' ? 3 : 1;
+
+        size_t pos = 2;
+        int values[3];      // Width, height, maximum sample
+        for (int& value : values) {
+            while (pos < data.size() && (isspace(data[pos]) || data[pos] == '#')) {
+                if (data[pos] == '#') {
+                    while (pos < data.size() && data[pos] != '\n') pos++;
+                } else {
+                    pos++;
+                }
+            }
+            if (pos >= data.size() || !isdigit(data[pos])) return false;
+            value = 0;
+            while (pos < data.size() && isdigit(data[pos]) && value <= MAX_IMAGE_SIZE) {
+                value = value * 10 + (data[pos++] - '0');
+            }
+        }
+        pos++;      // The single whitespace before the samples
+
+        if (values[0] <= 0 || values[1] <= 0 || values[0] > MAX_IMAGE_SIZE || values[1] > MAX_IMAGE_SIZE ||
+            values[2] <= 0 || values[2] > 255) {
+            return false;
+        }
+        size_t samples = (size_t)values[0] * values[1] * channels;
+        if (pos > data.size() || data.size() - pos < samples) return false;
+
+        width = values[0];
+        height = values[1];
+        pixels.resize((size_t)width * height);
+        const uint8_t* sample = &data[pos];
+        uint32_t max = (uint32_t)values[2];
+        for (uint32_t& pixel : pixels) {
+            uint32_t r = std::min<uint32_t>(sample[0], max) * 255 / max;
+            uint32_t g = channels == 3 ? std::min<uint32_t>(sample[1], max) * 255 / max : r;
+            uint32_t b = channels == 3 ? std::min<uint32_t>(sample[2], max) * 255 / max : r;
+            pixel = Premultiply(r, g, b, 255);
+            sample += channels;
+        }
+        return true;
+    }
+
+#if SDK_PLATFORM_WINDOWS
+    template <typename T>
+    void SafeRelease(T*& resource) {
+        if (resource) {
+            resource->Release();
+            resource = nullptr;
+        }
+    }
+
+    bool DecodeWIC(const std::wstring& path, int& width, int& height, std::vector<uint32_t>& pixels) {
+        // Workers don't start in an apartment; each decode joins and leaves one
+        HRESULT com = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+
+        IWICImagingFactory* factory = nullptr;
+        IWICBitmapDecoder* decoder = nullptr;
+        IWICBitmapFrameDecode* frame = nullptr;
+        IWICFormatConverter* converter = nullptr;
+        UINT w = 0;
+        UINT h = 0;
+        bool decoded = false;
+        if (SUCCEEDED(CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER,
+                                       IID_PPV_ARGS(&factory))) &&
+            SUCCEEDED(factory->CreateDecoderFromFilename(path.c_str(), nullptr, GENERIC_READ,
+                                                         WICDecodeMetadataCacheOnDemand, &decoder)) &&
+            SUCCEEDED(decoder->GetFrame(0, &frame)) &&
+            SUCCEEDED(factory->CreateFormatConverter(&converter)) &&
+            SUCCEEDED(converter->Initialize(frame, GUID_WICPixelFormat32bppPBGRA, WICBitmapDitherTypeNone,
+                                            nullptr, 0.0, WICBitmapPaletteTypeCustom)) &&
+            SUCCEEDED(converter->GetSize(&w, &h)) &&
+            w > 0 && h > 0 && w <= MAX_IMAGE_SIZE && h <= MAX_IMAGE_SIZE) {
+            pixels.resize((size_t)w * h);
+            decoded = SUCCEEDED(converter->CopyPixels(nullptr, w * 4, (UINT)(pixels.size() * 4),
+                                                      reinterpret_cast<BYTE*>(pixels.data())));
+            width = (int)w;
+            height = (int)h;
+        }
+
+        SafeRelease(converter);
+        SafeRelease(frame);
+        SafeRelease(decoder);
+        SafeRelease(factory);
+        if (SUCCEEDED(com)) CoUninitialize();
+        return decoded;
+    }
+#endif
+
+    // Source pixels covering each destination pixel and their share of it
+    struct Taps {
+        struct Tap {
+            int source;
+            uint32_t weight;
+        };
+        std::vector<size_t> starts;     // Per destination index, plus the end
+        std::vector<Tap> taps;
+    };
+
+    Taps BuildTaps(int sourceSize, int destSize) {
+        Taps result;
+        result.starts.reserve((size_t)destSize + 1);
+        double scale = (double)sourceSize / destSize;
+        for (int d = 0; d < destSize; d++) {
+            result.starts.push_back(result.taps.size());
+            double low = d * scale;
+            double high = std::min((d + 1) * scale, (double)sourceSize);
+            int first = std::min((int)low, sourceSize - 1);
+            int last = std::max(first, std::min(sourceSize - 1, (int)std::ceil(high) - 1));
+
+            // Rounding down all but the last tap, which takes the remainder,
+            // keeps every sum exactly one
+            uint32_t total = 0;
+            for (int s = first; s <= last; s++) {
+                uint32_t weight = WEIGHT_ONE - total;
+                if (s < last) {
+                    double overlap = std::min(high, s + 1.0) - std::max(low, (double)s);
+                    weight = (uint32_t)(std::max(0.0, overlap) / (high - low) * WEIGHT_ONE);
+                }
+                if (weight == 0) continue;
+                result.taps.push_back({ s, weight });
+                total += weight;
+            }
+        }
+        result.starts.push_back(result.taps.size());
+        return result;
+    }
+}
+
+ImageCache::Entry::Entry(const std::wstring& path, int width, int height)
+    : m_path(path)
+    , m_state(State::LOADING)
+    , m_width(width)
+    , m_height(height)
+    , m_scaled(width > 0)
+    , m_opaque(true)
+#if SDK_PLATFORM_WINDOWS
+    , m_dc(nullptr)
+    , m_bitmap(nullptr)
+#endif
+{
+}
+
+ImageCache::Entry::~Entry() {
+#if SDK_PLATFORM_WINDOWS
+    if (m_dc) Renderer::DeleteMemoryDC(m_dc, m_bitmap, GdiSubsystem::IMAGES);
+#endif
+}
+
+bool ImageCache::Entry::Draw(HDC hdc, const RECT& dest) const {
+#if SDK_PLATFORM_WINDOWS
+    if (!hdc || GetState() != State::READY || m_pixels.empty()) return false;
+    if (!m_dc) {
+        uint32_t* bits = nullptr;
+        m_dc = Renderer::CreateDIBMemoryDC(m_width, m_height, &m_bitmap, &bits, GdiSubsystem::IMAGES);
+        if (!m_dc) return false;
+        std::copy(m_pixels.begin(), m_pixels.end(), bits);
+    }
+
+    int width = dest.right - dest.left;
+    int height = dest.bottom - dest.top;
+    if (!m_opaque) {
+        BLENDFUNCTION blend = { AC_SRC_OVER, 0, 255, AC_SRC_ALPHA };
+        AlphaBlend(hdc, dest.left, dest.top, width, height, m_dc, 0, 0, m_width, m_height, blend);
+    } else if (width == m_width && height == m_height) {
+        BitBlt(hdc, dest.left, dest.top, width, height, m_dc, 0, 0, SRCCOPY);
+    } else {
+        StretchBlt(hdc, dest.left, dest.top, width, height, m_dc, 0, 0, m_width, m_height, SRCCOPY);
+    }
+    return true;
+#else
+    (void)hdc; (void)dest;
+    return false;
+#endif
+}
+
+ImageCache::EntryPtr ImageCache::Get(const std::wstring& path, int width, int height) {
+    if (width <= 0 || height <= 0) {
+        width = 0;
+        height = 0;
+    }
+
+    std::shared_ptr<Entry> entry;
+    std::shared_ptr<Entry> decode;      // Jobs start after the lock is released:
+    std::shared_ptr<Entry> scaleFrom;   // with no workers they run inline
+    {
+        std::lock_guard<std::mutex> lock(g_cacheMutex);
+        auto find = [](const std::wstring& key, bool& created) -> std::shared_ptr<Entry>& {
+            CacheItem& item = g_cache[key];
+            created = !item.entry;
+            item.lastUse = ++g_clock;
+            return item.entry;
+        };
+
+        bool created = false;
+        std::shared_ptr<Entry>& slot = find(MakeKey(path, width, height), created);
+        if (!created) {
+            g_hits++;
+            return slot;
+        }
+        g_misses++;
+        slot = std::make_shared<Entry>(path, width, height);
+        entry = slot;
+
+        if (width == 0) {
+            decode = entry;
+        } else {
+            // Scaled from the original, which is decoded first if it isn't cached
+            std::shared_ptr<Entry>& source = find(MakeKey(path, 0, 0), created);
+            if (created) {
+                source = std::make_shared<Entry>(path, 0, 0);
+                decode = source;
+            }
+            State state = source->GetState();
+            if (state == State::LOADING) {
+                source->m_waiting.push_back(entry);
+            } else if (state == State::READY) {
+                scaleFrom = source;
+            } else {
+                entry->m_state.store(State::FAILED, std::memory_order_release);
+            }
+        }
+    }
+
+    if (decode) {
+        JobScheduler::Submit([decode]() {
+            int decodedWidth = 0;
+            int decodedHeight = 0;
+            bool decoded = Decode(decode->m_path, decodedWidth, decodedHeight, decode->m_pixels);
+            if (decoded) {
+                decode->m_width = decodedWidth;
+                decode->m_height = decodedHeight;
+                decode->m_opaque = std::all_of(decode->m_pixels.begin(), decode->m_pixels.end(),
+                                               [](uint32_t pixel) { return (pixel >> 24) == 0xFF; });
+            } else {
+                decode->m_pixels.clear();
+            }
+            Finish(decode, decoded);
+        }, "ImageDecode");
+    }
+    if (scaleFrom) StartScale(scaleFrom, entry);
+    return entry;
+}
+
+void ImageCache::StartScale(const std::shared_ptr<Entry>& source, const std::shared_ptr<Entry>& entry) {
+    JobScheduler::Submit([source, entry]() {
+        entry->m_pixels.resize((size_t)entry->m_width * entry->m_height);
+        Scale(source->m_pixels.data(), source->m_width, source->m_height,
+              entry->m_pixels.data(), entry->m_width, entry->m_height);
+        entry->m_opaque = source->m_opaque;     // Averages of opaque pixels stay opaque
+        Finish(entry, true);
+    }, "ImageScale");
+}
+
+void ImageCache::Finish(const std::shared_ptr<Entry>& entry, bool ok) {
+    std::vector<std::shared_ptr<Entry>> waiting;
+    {
+        std::lock_guard<std::mutex> lock(g_cacheMutex);
+        entry->m_state.store(ok ? State::READY : State::FAILED, std::memory_order_release);
+        waiting.swap(entry->m_waiting);
+        if (ok) {
+            if (!entry->m_scaled) g_decodes++;
+            auto it = entry->m_scaled ? g_cache.find(MakeKey(entry->m_path, entry->m_width, entry->m_height))
+                                      : g_cache.find(MakeKey(entry->m_path, 0, 0));
+            if (it != g_cache.end() && it->second.entry == entry && it->second.bytes == 0) {
+                it->second.bytes = std::max<size_t>(1, entry->m_pixels.size() * sizeof(uint32_t));
+                g_bytes += it->second.bytes;
+            }
+        }
+        EvictOverCapacity();
+    }
+
+    for (const auto& scaled : waiting) {
+        if (ok) {
+            StartScale(entry, scaled);
+        } else {
+            Finish(scaled, false);
+        }
+    }
+}
+
+bool ImageCache::Decode(const std::wstring& path, int& width, int& height, std::vector<uint32_t>& pixels) {
+#if SDK_PLATFORM_WINDOWS
+    if (DecodeWIC(path, width, height, pixels)) return true;
+#endif
+    std::vector<uint8_t> data;
+    if (!ReadWholeFile(path, data)) return false;
+    return DecodeBMP(data, width, height, pixels) || DecodePNM(data, width, height, pixels);
+}
+
+void ImageCache::Scale(const uint32_t* source, int sourceWidth, int sourceHeight,
+                       uint32_t* dest, int destWidth, int destHeight) {
+    if (sourceWidth <= 0 || sourceHeight <= 0 || destWidth <= 0 || destHeight <= 0) return;
+    if (sourceWidth == destWidth && sourceHeight == destHeight) {
+        std::copy(source, source + (size_t)sourceWidth * sourceHeight, dest);
+        return;
+    }
+
+    Taps columns = BuildTaps(sourceWidth, destWidth);
+    Taps rows = BuildTaps(sourceHeight, destHeight);
+
+    // Horizontal pass into 8.8 fixed-point channels, then the vertical one
+    std::vector<uint16_t> narrowed((size_t)sourceHeight * destWidth * 4);
+    for (int y = 0; y < sourceHeight; y++) {
+        const uint32_t* row = source + (size_t)y * sourceWidth;
+        uint16_t* out = &narrowed[(size_t)y * destWidth * 4];
+        for (int x = 0; x < destWidth; x++) {
+            uint32_t sum[4] = {};
+            for (size_t t = columns.starts[x]; t < columns.starts[x + 1]; t++) {
+                uint32_t pixel = row[columns.taps[t].source];
+                uint32_t weight = columns.taps[t].weight;
+                for (int c = 0; c < 4; c++) {
+                    sum[c] += ((pixel >> (c * 8)) & 0xFF) * weight;
+                }
+            }
+            for (int c = 0; c < 4; c++) {
+                out[x * 4 + c] = (uint16_t)((sum[c] + 128) >> 8);
+            }
+        }
+    }
+
+    for (int y = 0; y < destHeight; y++) {
+        uint32_t* out = dest + (size_t)y * destWidth;
+        for (int x = 0; x < destWidth; x++) {
+            uint64_t sum[4] = {};
+            for (size_t t = rows.starts[y]; t < rows.starts[y + 1]; t++) {
+                const uint16_t* channels = &narrowed[((size_t)rows.taps[t].source * destWidth + x) * 4];
+                uint64_t weight = rows.taps[t].weight;
+                for (int c = 0; c < 4; c++) {
+                    sum[c] += channels[c] * weight;
+                }
+            }
+            uint32_t pixel = 0;
+            for (int c = 0; c < 4; c++) {
+                pixel |= (uint32_t)std::min<uint64_t>(255, (sum[c] + (1u << 23)) >> 24) << (c * 8);
+            }
+            out[x] = pixel;
+        }
+    }
+}
+
+ImageCache::Stats ImageCache::GetStats() {
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    return Stats{ g_hits, g_misses, g_decodes, g_evictions, g_cache.size(), g_bytes };
+}
+
+void ImageCache::ResetStats() {
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    g_hits = 0;
+    g_misses = 0;
+    g_decodes = 0;
+    g_evictions = 0;
+}
+
+void ImageCache::SetCapacity(size_t maxBytes) {
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    g_capacity = maxBytes;
+    EvictOverCapacity();
+}
+
+void ImageCache::Clear() {
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    g_cache.clear();
+    g_bytes = 0;
+}
+
+} // namespace SDK
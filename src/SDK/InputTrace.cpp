@@ -0,0 +1,241 @@
+#include "../../include/SDK/InputTrace.h"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace SDK {
+
+namespace {
+    const uint8_t MAGIC[4] = { '5', 'D', 'I', 'T' };
+    const uint8_t VERSION = 1;
+    const size_t MIN_EVENT_BYTES = 6;   // Type, window, time, x, y, value
+
+    thread_local InputTrace::Recording* t_recording = nullptr;
+
+    void WriteVarint(std::vector<uint8_t>& bytes, uint64_t value) {
+        while (value >= 0x80) {
+            bytes.push_back((uint8_t)(value | 0x80));
+            value >>= 7;
+        }
+        bytes.push_back((uint8_t)value);
+    }
+
+    void WriteSigned(std::vector<uint8_t>& bytes, int64_t value) {
+        WriteVarint(bytes, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+    }
+
+    bool ReadVarint(const uint8_t*& data, const uint8_t* end, uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64 && data < end; shift += 7) {
+            uint8_t byte = *data++;
+            value |= (uint64_t)(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+
+    bool ReadSigned(const uint8_t*& data, const uint8_t* end, int64_t& value) {
+        uint64_t encoded;
+        if (!ReadVarint(data, end, encoded)) return false;
+        value = (int64_t)(encoded >> 1) ^ -(int64_t)(encoded & 1);
+        return true;
+    }
+
+    bool FitsInt32(int64_t value) {
+        return value >= INT32_MIN && value <= INT32_MAX;
+    }
+
+    double Percentile(const std::vector<double>& sorted, double fraction) {
+        size_t rank = (size_t)std::ceil(fraction * sorted.size());
+        return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+    }
+}
+
+void InputTrace::Add(const InputEvent& event) {
+    m_events.push_back(event);
+    // Times never go backwards, so they encode as deltas
+    if (m_events.size() > 1) {
+        InputEvent& added = m_events.back();
+        added.time = std::max(added.time, m_events[m_events.size() - 2].time);
+    }
+}
+
+void InputTrace::Clear() {
+    m_events.clear();
+}
+
+size_t InputTrace::GetWindowCount() const {
+    size_t count = 0;
+    for (const InputEvent& event : m_events) {
+        count = std::max(count, (size_t)event.window + 1);
+    }
+    return count;
+}
+
+void InputTrace::Encode(std::vector<uint8_t>& bytes) const {
+    bytes.insert(bytes.end(), std::begin(MAGIC), std::end(MAGIC));
+    bytes.push_back(VERSION);
+    WriteVarint(bytes, m_events.size());
+
+    // Positions are deltas from the previous event, which keeps a drag small
+    uint32_t time = 0;
+    int64_t x = 0;
+    int64_t y = 0;
+    for (const InputEvent& event : m_events) {
+        bytes.push_back((uint8_t)event.type);
+        WriteVarint(bytes, event.window);
+        WriteVarint(bytes, event.time - time);
+        WriteSigned(bytes, event.x - x);
+        WriteSigned(bytes, event.y - y);
+        WriteSigned(bytes, event.value);
+        time = event.time;
+        x = event.x;
+        y = event.y;
+    }
+}
+
+bool InputTrace::Decode(const uint8_t* data, size_t size) {
+    m_events.clear();
+    const uint8_t* end = data + size;
+    if (size < sizeof(MAGIC) + 1 || !std::equal(std::begin(MAGIC), std::end(MAGIC), data) ||
+        data[sizeof(MAGIC)] != VERSION) {
+        return false;
+    }
+    data += sizeof(MAGIC) + 1;
+
+    uint64_t count;
+    if (!ReadVarint(data, end, count) || count > (uint64_t)(end - data) / MIN_EVENT_BYTES) return false;
+
+    std::vector<InputEvent> events;
+    events.reserve((size_t)count);
+    uint64_t time = 0;
+    int64_t x = 0;
+    int64_t y = 0;
+    for (uint64_t i = 0; i < count; i++) {
+        if (data >= end || *data >= (uint8_t)InputEvent::Type::COUNT) return false;
+        InputEvent event;
+        event.type = (InputEvent::Type)*data++;
+
+        uint64_t window;
+        uint64_t delta;
+        int64_t dx;
+        int64_t dy;
+        int64_t value;
+        if (!ReadVarint(data, end, window) || !ReadVarint(data, end, delta) ||
+            !ReadSigned(data, end, dx) || !ReadSigned(data, end, dy) || !ReadSigned(data, end, value)) {
+            return false;
+        }
+        time += delta;
+        x += dx;
+        y += dy;
+        if (window > UINT16_MAX || time > UINT32_MAX || !FitsInt32(x) || !FitsInt32(y) || !FitsInt32(value)) {
+            return false;
+        }
+
+        event.window = (uint16_t)window;
+        event.time = (uint32_t)time;
+        event.x = (int32_t)x;
+        event.y = (int32_t)y;
+        event.value = (int32_t)value;
+        events.push_back(event);
+    }
+    if (data != end) return false;
+
+    m_events.swap(events);
+    return true;
+}
+
+bool InputTrace::Save(const std::wstring& path) const {
+    std::vector<uint8_t> bytes;
+    Encode(bytes);
+    std::ofstream file(std::filesystem::path(path), std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+    file.write((const char*)bytes.data(), (std::streamsize)bytes.size());
+    return (bool)file;
+}
+
+bool InputTrace::Load(const std::wstring& path) {
+    std::ifstream file(std::filesystem::path(path), std::ios::binary);
+    if (!file) {
+        m_events.clear();
+        return false;
+    }
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return Decode(bytes.data(), bytes.size());
+}
+
+InputTrace::Recording::Recording(InputTrace& trace)
+    : m_trace(trace)
+    , m_previous(t_recording)
+    , m_start(std::chrono::steady_clock::now())
+{
+    t_recording = this;
+}
+
+InputTrace::Recording::~Recording() {
+    t_recording = m_previous;
+}
+
+void InputTrace::Record(const void* window, InputEvent::Type type, int x, int y, int value) {
+    Recording* recording = t_recording;
+    if (!recording) return;
+
+    auto it = std::find(recording->m_windows.begin(), recording->m_windows.end(), window);
+    size_t index = (size_t)(it - recording->m_windows.begin());
+    if (it == recording->m_windows.end()) {
+        if (index > UINT16_MAX) return;
+        recording->m_windows.push_back(window);
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - recording->m_start;
+    InputEvent event;
+    event.time = (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+    event.type = type;
+    event.window = (uint16_t)index;
+    event.x = x;
+    event.y = y;
+    event.value = value;
+    recording->m_trace.Add(event);
+}
+
+bool InputTrace::IsRecording() {
+    return t_recording != nullptr;
+}
+
+InputTrace::ReplayStats InputTrace::Replay(const DispatchFn& dispatch, const FrameFn& frame, double frameRate) const {
+    using Clock = std::chrono::steady_clock;
+    double interval = 1.0 / (frameRate > 0.0 ? frameRate : 60.0);
+
+    ReplayStats stats = {};
+    std::vector<double> frameMs;
+    frameMs.reserve((size_t)(GetDuration() / 1000.0 / interval) + 2);
+    size_t next = 0;
+    Clock::time_point begin = Clock::now();
+    do {
+        double time = stats.frames * interval;
+        Clock::time_point start = Clock::now();
+        while (next < m_events.size() && m_events[next].time <= time * 1000.0) {
+            if (dispatch) dispatch(m_events[next]);
+            next++;
+        }
+        if (frame) frame(time, stats.frames > 0 ? (float)interval : 0.0f);
+        frameMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        stats.frames++;
+    } while (next < m_events.size());
+    stats.seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    stats.events = next;
+
+    double total = 0.0;
+    for (double ms : frameMs) total += ms;
+    std::sort(frameMs.begin(), frameMs.end());
+    stats.meanFrameMs = total / frameMs.size();
+    stats.medianFrameMs = frameMs[frameMs.size() / 2];
+    stats.p95FrameMs = Percentile(frameMs, 0.95);
+    stats.p99FrameMs = Percentile(frameMs, 0.99);
+    stats.maxFrameMs = frameMs.back();
+    return stats;
+}
+
+} // namespace SDK
@@ -0,0 +1,46 @@
+#include "../../include/SDK/InternedString.h"
+#include <mutex>
+#include <unordered_set>
+
+namespace SDK {
+
+namespace {
+    // Node-based, so pooled strings never move
+    struct Pool {
+        std::mutex mutex;
+        std::unordered_set<std::wstring> strings;
+    };
+
+    Pool& GetPool() {
+        static Pool* pool = new Pool();     // Outlives static widgets destroyed at exit
+        return *pool;
+    }
+}
+
+const std::wstring& InternedString::GetEmpty() {
+    static const std::wstring* empty = Intern(std::wstring());
+    return *empty;
+}
+
+const std::wstring* InternedString::Intern(const std::wstring& text) {
+    Pool& pool = GetPool();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    return &*pool.strings.insert(text).first;
+}
+
+bool InternedString::Find(const std::wstring& text, InternedString& result) {
+    Pool& pool = GetPool();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    auto it = pool.strings.find(text);
+    if (it == pool.strings.end()) return false;
+    result.m_string = &*it;
+    return true;
+}
+
+size_t InternedString::GetPoolSize() {
+    Pool& pool = GetPool();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    return pool.strings.size();
+}
+
+} // namespace SDK
@@ -0,0 +1,341 @@
+#include "../../include/SDK/JobScheduler.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace SDK {
+
+struct JobGroupState {
+    std::atomic<int> outstanding{0};
+    std::mutex mutex;
+    std::condition_variable finished;
+};
+
+namespace {
+    constexpr unsigned AUTO_WORKER_COUNT = ~0u;
+
+    // Waiters re-check for stealable work this often in case a wake was missed
+    constexpr auto WAIT_POLL_INTERVAL = std::chrono::milliseconds(1);
+
+    const char* const UNNAMED_TASK = "Task";
+
+    struct TaskItem {
+        JobScheduler::Task fn;
+        const char* name;
+        std::shared_ptr<JobGroupState> group;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<TaskItem> tasks;     // Owner uses the back, thieves the front
+        std::thread thread;
+    };
+
+    struct Pool {
+        std::mutex mutex;               // Guards startup, shutdown and sleeping
+        std::condition_variable wake;
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::atomic<size_t> running{0}; // Published once workers are in place
+        unsigned workerCount = AUTO_WORKER_COUNT;
+        bool stopping = false;
+
+        std::mutex injectionMutex;
+        std::deque<TaskItem> injection; // Tasks from threads outside the pool
+        std::atomic<int> pending{0};    // Queued, not yet taken
+
+        std::atomic<bool> hasHook{false};   // Skips the hook lock when profiling is off
+        std::mutex hookMutex;
+        std::shared_ptr<JobScheduler::ProfileHook> hook;
+
+        ~Pool() { Stop(); }
+        void Stop();
+    };
+
+    Pool g_pool;
+    thread_local int t_workerIndex = -1;
+
+    unsigned ResolveWorkerCount(unsigned count) {
+        if (count != AUTO_WORKER_COUNT) return count;
+        unsigned hardware = std::thread::hardware_concurrency();
+        return hardware > 1 ? hardware - 1 : 0;
+    }
+
+    void Execute(TaskItem& item) {
+        std::shared_ptr<JobScheduler::ProfileHook> hook;
+        if (g_pool.hasHook.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(g_pool.hookMutex);
+            hook = g_pool.hook;
+        }
+
+        if (hook) {
+            JobScheduler::TaskProfile profile;
+            profile.name = item.name ? item.name : UNNAMED_TASK;
+            profile.worker = t_workerIndex;
+            profile.start = std::chrono::steady_clock::now();
+            item.fn();
+            profile.end = std::chrono::steady_clock::now();
+            (*hook)(profile);
+        } else {
+            item.fn();
+        }
+
+        if (item.group && item.group->outstanding.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(item.group->mutex);
+            item.group->finished.notify_all();
+        }
+    }
+
+    bool TakeBack(std::deque<TaskItem>& queue, std::mutex& mutex, TaskItem& item) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (queue.empty()) return false;
+        item = std::move(queue.back());
+        queue.pop_back();
+        return true;
+    }
+
+    bool TakeFront(std::deque<TaskItem>& queue, std::mutex& mutex, TaskItem& item) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (queue.empty()) return false;
+        item = std::move(queue.front());
+        queue.pop_front();
+        return true;
+    }
+
+    // Own deque newest first, then the shared queue, then steal oldest from the others
+    bool TryTake(TaskItem& item) {
+        if (g_pool.pending.load() <= 0) return false;
+
+        size_t count = g_pool.running.load();
+        int self = t_workerIndex;
+        bool found = false;
+
+        if (self >= 0 && (size_t)self < count) {
+            Worker& own = *g_pool.workers[self];
+            found = TakeBack(own.tasks, own.mutex, item);
+        }
+        if (!found) {
+            found = TakeFront(g_pool.injection, g_pool.injectionMutex, item);
+        }
+        for (size_t i = 1; !found && i <= count; i++) {
+            size_t victim = ((self >= 0 ? (size_t)self : 0) + i) % count;
+            if ((int)victim == self) continue;
+            Worker& other = *g_pool.workers[victim];
+            found = TakeFront(other.tasks, other.mutex, item);
+        }
+
+        if (found) g_pool.pending.fetch_sub(1);
+        return found;
+    }
+
+    void WorkerLoop(int index) {
+        t_workerIndex = index;
+        for (;;) {
+            TaskItem item;
+            if (TryTake(item)) {
+                Execute(item);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(g_pool.mutex);
+            g_pool.wake.wait(lock, [] { return g_pool.stopping || g_pool.pending.load() > 0; });
+            if (g_pool.stopping && g_pool.pending.load() <= 0) return;
+        }
+    }
+
+    // Starts the workers on first use; false when tasks should run inline
+    bool EnsureStarted() {
+        if (g_pool.running.load() > 0) return true;
+
+        std::lock_guard<std::mutex> lock(g_pool.mutex);
+        if (g_pool.workers.empty()) {
+            unsigned count = ResolveWorkerCount(g_pool.workerCount);
+            for (unsigned i = 0; i < count; i++) {
+                g_pool.workers.push_back(std::make_unique<Worker>());
+            }
+            g_pool.running.store(g_pool.workers.size());
+            for (unsigned i = 0; i < count; i++) {
+                g_pool.workers[i]->thread = std::thread(WorkerLoop, (int)i);
+            }
+        }
+        return !g_pool.workers.empty();
+    }
+
+    void Push(TaskItem item) {
+        if (!EnsureStarted()) {
+            Execute(item);
+            return;
+        }
+
+        int self = t_workerIndex;
+        if (self >= 0) {
+            Worker& own = *g_pool.workers[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            own.tasks.push_back(std::move(item));
+        } else {
+            std::lock_guard<std::mutex> lock(g_pool.injectionMutex);
+            g_pool.injection.push_back(std::move(item));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(g_pool.mutex);
+            g_pool.pending.fetch_add(1);
+        }
+        g_pool.wake.notify_one();
+    }
+
+    void Pool::Stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers) {
+            if (worker->thread.joinable()) worker->thread.join();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        running.store(0);
+        workers.clear();
+        stopping = false;
+    }
+}
+
+// TaskGroup
+JobScheduler::TaskGroup::TaskGroup()
+    : m_state(std::make_shared<JobGroupState>())
+{
+}
+
+JobScheduler::TaskGroup::~TaskGroup() {
+    Wait();
+}
+
+void JobScheduler::TaskGroup::Run(Task task, const char* name) {
+    m_state->outstanding.fetch_add(1);
+    Push(TaskItem{ std::move(task), name, m_state });
+}
+
+void JobScheduler::TaskGroup::Wait() {
+    while (m_state->outstanding.load() > 0) {
+        // Help instead of blocking, so waiting inside a task can't starve the pool
+        TaskItem item;
+        if (TryTake(item)) {
+            Execute(item);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_state->mutex);
+        m_state->finished.wait_for(lock, WAIT_POLL_INTERVAL, [&] { return m_state->outstanding.load() == 0; });
+    }
+}
+
+bool JobScheduler::TaskGroup::IsDone() const {
+    return m_state->outstanding.load() == 0;
+}
+
+// TaskGraph
+int JobScheduler::TaskGraph::AddTask(Task task, const char* name) {
+    m_nodes.push_back(Node{ std::move(task), name, {}, 0 });
+    return (int)m_nodes.size() - 1;
+}
+
+void JobScheduler::TaskGraph::AddDependency(int before, int after) {
+    if (before < 0 || after < 0 || before >= (int)m_nodes.size() || after >= (int)m_nodes.size()) return;
+    m_nodes[before].dependents.push_back(after);
+    m_nodes[after].dependencies++;
+}
+
+bool JobScheduler::TaskGraph::Run() {
+    size_t count = m_nodes.size();
+    std::vector<int> ready;
+    for (size_t i = 0; i < count; i++) {
+        if (m_nodes[i].dependencies == 0) ready.push_back((int)i);
+    }
+
+    // Every task must be reachable in dependency order
+    {
+        std::vector<int> remaining(count);
+        std::vector<int> order = ready;
+        for (size_t i = 0; i < count; i++) remaining[i] = m_nodes[i].dependencies;
+        for (size_t i = 0; i < order.size(); i++) {
+            for (int next : m_nodes[order[i]].dependents) {
+                if (--remaining[next] == 0) order.push_back(next);
+            }
+        }
+        if (order.size() != count) return false;
+    }
+
+    std::unique_ptr<std::atomic<int>[]> remaining(new std::atomic<int>[count]);
+    for (size_t i = 0; i < count; i++) remaining[i].store(m_nodes[i].dependencies);
+
+    TaskGroup group;
+    std::function<void(int)> start = [&](int index) {
+        group.Run([&, index]() {
+            m_nodes[index].task();
+            for (int next : m_nodes[index].dependents) {
+                if (remaining[next].fetch_sub(1) == 1) start(next);
+            }
+        }, m_nodes[index].name);
+    };
+    for (int index : ready) {
+        start(index);
+    }
+    group.Wait();
+    return true;
+}
+
+// JobScheduler
+void JobScheduler::Submit(Task task, const char* name) {
+    Push(TaskItem{ std::move(task), name, nullptr });
+}
+
+void JobScheduler::ParallelFor(int count, int grain, const std::function<void(int begin, int end)>& fn, const char* name) {
+    if (count <= 0) return;
+    grain = std::max(1, grain);
+
+    int chunks = (count + grain - 1) / grain;
+    if (chunks == 1) {
+        fn(0, count);
+        return;
+    }
+
+    // Later chunks become tasks; the caller runs the first, then helps with the rest
+    TaskGroup group;
+    for (int chunk = 1; chunk < chunks; chunk++) {
+        int begin = chunk * grain;
+        int end = std::min(count, begin + grain);
+        group.Run([&fn, begin, end]() { fn(begin, end); }, name);
+    }
+    fn(0, std::min(count, grain));
+    group.Wait();
+}
+
+void JobScheduler::SetWorkerCount(unsigned count) {
+    std::lock_guard<std::mutex> lock(g_pool.mutex);
+    g_pool.workerCount = count;
+}
+
+unsigned JobScheduler::GetWorkerCount() {
+    std::lock_guard<std::mutex> lock(g_pool.mutex);
+    if (!g_pool.workers.empty()) return (unsigned)g_pool.workers.size();
+    return ResolveWorkerCount(g_pool.workerCount);
+}
+
+int JobScheduler::GetCurrentWorkerIndex() {
+    return t_workerIndex;
+}
+
+void JobScheduler::SetProfileHook(ProfileHook hook) {
+    std::lock_guard<std::mutex> lock(g_pool.hookMutex);
+    g_pool.hook = hook ? std::make_shared<ProfileHook>(std::move(hook)) : nullptr;
+    g_pool.hasHook.store(g_pool.hook != nullptr);
+}
+
+void JobScheduler::Shutdown() {
+    g_pool.Stop();
+}
+
+} // namespace SDK
@@ -0,0 +1,136 @@
+#include "../../include/SDK/LayerCompositor.h"
+#include <algorithm>
+
+namespace SDK {
+
+LayerCompositor::~LayerCompositor() {
+    Clear();
+}
+
+bool LayerCompositor::Composite(HDC hdc, Widget& widget, Stats& stats) {
+    if (!widget.HasLayer()) {
+        // Drop the layer of a widget that stopped animating
+        if (!m_layers.empty()) RemoveWidget(&widget);
+        return false;
+    }
+    if (!widget.IsVisible()) return true;
+
+    RECT bounds;
+    widget.GetLayerBounds(bounds);
+    int width = bounds.right - bounds.left;
+    int height = bounds.bottom - bounds.top;
+    if (width <= 0 || height <= 0) return false;
+
+    Layer& layer = m_layers[&widget];
+    bool resized = layer.surface.width != width || layer.surface.height != height;
+    if (!layer.surface.dc || resized || !layer.valid || layer.version != widget.GetContentVersion()) {
+        if (!Rasterize(widget, layer, bounds)) {
+            Release(layer);
+            m_layers.erase(&widget);
+            return false;
+        }
+        stats.rasterized++;
+    }
+
+    // The layer follows the widget's current bounds, so moves only recomposite
+    RECT target = bounds;
+    widget.ApplyLayerTransform(target);
+    BYTE alpha = (BYTE)(widget.GetOpacity() * 255.0f + 0.5f);
+    if (alpha > 0 && target.right > target.left && target.bottom > target.top) {
+        BLENDFUNCTION blend;
+        blend.BlendOp = AC_SRC_OVER;
+        blend.BlendFlags = 0;
+        blend.SourceConstantAlpha = alpha;
+        blend.AlphaFormat = AC_SRC_ALPHA;
+        AlphaBlend(hdc, target.left, target.top, target.right - target.left, target.bottom - target.top,
+                   layer.surface.dc, 0, 0, width, height, blend);
+    }
+    stats.composited++;
+    return true;
+}
+
+bool LayerCompositor::Rasterize(Widget& widget, Layer& layer, const RECT& bounds) {
+    int width = bounds.right - bounds.left;
+    int height = bounds.bottom - bounds.top;
+
+    if (!layer.surface.dc || layer.surface.width != width || layer.surface.height != height) {
+        Release(layer);
+        layer.surface.dc = Renderer::CreateDIBMemoryDC(width, height, &layer.surface.bitmap, &layer.surface.pixels, GdiSubsystem::LAYERS);
+        if (!layer.surface.dc) return false;
+        layer.surface.width = width;
+        layer.surface.height = height;
+    }
+
+    Renderer::PixelSurface white;
+    white.dc = Renderer::CreateDIBMemoryDC(width, height, &white.bitmap, &white.pixels, GdiSubsystem::LAYERS);
+    if (!white.dc) return false;
+
+    // The same widget over black and over white
+    size_t count = (size_t)width * height;
+    std::fill(layer.surface.pixels, layer.surface.pixels + count, 0x00000000u);
+    std::fill(white.pixels, white.pixels + count, 0x00FFFFFFu);
+    HDC targets[2] = { layer.surface.dc, white.dc };
+    for (HDC dc : targets) {
+        POINT origin;
+        SetWindowOrgEx(dc, bounds.left, bounds.top, &origin);
+        widget.Render(dc);
+        SetWindowOrgEx(dc, origin.x, origin.y, nullptr);
+    }
+    GdiFlush();
+
+    // Coverage is 255 minus how far white showed through; the black pass
+    // is the color already multiplied by it
+    uint32_t* black = layer.surface.pixels;
+    for (size_t i = 0; i < count; i++) {
+        uint32_t b = black[i];
+        uint32_t w = white.pixels[i];
+        int through = 0;
+        for (int shift = 0; shift < 24; shift += 8) {
+            int diff = (int)((w >> shift) & 0xFF) - (int)((b >> shift) & 0xFF);
+            through = std::max(through, diff);
+        }
+        uint32_t a = 255 - (uint32_t)through;
+        uint32_t pixel = a << 24;
+        for (int shift = 0; shift < 24; shift += 8) {
+            pixel |= std::min((b >> shift) & 0xFF, a) << shift;
+        }
+        black[i] = pixel;
+    }
+
+    Renderer::DeleteMemoryDC(white.dc, white.bitmap, GdiSubsystem::LAYERS);
+
+    layer.version = widget.GetContentVersion();
+    layer.valid = true;
+    return true;
+}
+
+void LayerCompositor::Release(Layer& layer) {
+    if (layer.surface.dc) {
+        Renderer::DeleteMemoryDC(layer.surface.dc, layer.surface.bitmap, GdiSubsystem::LAYERS);
+    }
+    layer.surface = Renderer::PixelSurface();
+    layer.valid = false;
+}
+
+void LayerCompositor::InvalidateAll() {
+    for (auto& pair : m_layers) {
+        pair.second.valid = false;
+    }
+}
+
+void LayerCompositor::RemoveWidget(const Widget* widget) {
+    auto it = m_layers.find(widget);
+    if (it == m_layers.end()) return;
+
+    Release(it->second);
+    m_layers.erase(it);
+}
+
+void LayerCompositor::Clear() {
+    for (auto& pair : m_layers) {
+        Release(pair.second);
+    }
+    m_layers.clear();
+}
+
+} // namespace SDK
@@ -1,9 +1,95 @@
 #include "SDK/Layout.h"
+#include "SDK/SimplexSolver.h"
+#include "SDK/Profiler.h"
 #include <algorithm>
 #include <cmath>
+#include <unordered_map>
 
 namespace SDK {
 
+namespace {
+    bool SameRect(const RECT& a, const RECT& b) {
+        return a.left == b.left && a.top == b.top && a.right == b.right && a.bottom == b.bottom;
+    }
+
+    // True when the list and every widget's bounds match the snapshot
+    bool MatchesSnapshot(const std::vector<std::shared_ptr<Widget>>& widgets,
+                         const std::vector<Widget*>& snapshotWidgets,
+                         const std::vector<RECT>& snapshotBounds) {
+        if (widgets.size() != snapshotWidgets.size()) return false;
+
+        for (size_t i = 0; i < widgets.size(); ++i) {
+            if (widgets[i].get() != snapshotWidgets[i]) return false;
+            RECT current;
+            widgets[i]->GetBounds(current);
+            if (!SameRect(current, snapshotBounds[i])) return false;
+        }
+        return true;
+    }
+
+    bool MatchesWidgets(const std::vector<std::shared_ptr<Widget>>& widgets, const std::vector<Widget*>& list) {
+        if (widgets.size() != list.size()) return false;
+
+        for (size_t i = 0; i < widgets.size(); ++i) {
+            if (widgets[i].get() != list[i]) return false;
+        }
+        return true;
+    }
+
+    void TakeSnapshot(const std::vector<std::shared_ptr<Widget>>& widgets,
+                      std::vector<Widget*>& snapshotWidgets,
+                      std::vector<RECT>& snapshotBounds) {
+        snapshotWidgets.resize(widgets.size());
+        snapshotBounds.resize(widgets.size());
+        for (size_t i = 0; i < widgets.size(); ++i) {
+            snapshotWidgets[i] = widgets[i].get();
+            widgets[i]->GetBounds(snapshotBounds[i]);
+        }
+    }
+
+    constexpr size_t DEFAULT_LAYOUT_CACHE_CAPACITY = 16;
+}
+
+// ============================================================================
+// Layout Implementation
+// ============================================================================
+
+bool Layout::Measure(const RECT& bounds, const std::vector<std::shared_ptr<Widget>>& widgets) {
+    RECT constraints = GetConstraintBounds(bounds);
+    bool changed = m_dirty || !SameRect(constraints, m_constraints) ||
+                   !MatchesSnapshot(widgets, m_arrangedWidgets, m_arrangedBounds);
+
+    m_desired.resize(widgets.size());
+    for (size_t i = 0; i < widgets.size(); ++i) {
+        widgets[i]->GetSize(m_desired[i].width, m_desired[i].height);
+        changed = changed || widgets[i]->IsLayoutDirty();
+    }
+
+    m_constraints = constraints;
+    return changed;
+}
+
+void Layout::EndArrange(const std::vector<std::shared_ptr<Widget>>& widgets) {
+    TakeSnapshot(widgets, m_arrangedWidgets, m_arrangedBounds);
+    for (auto& widget : widgets) {
+        widget->ClearLayoutDirty();
+    }
+    m_dirty = false;
+    ++m_arrangeCount;
+}
+
+void Layout::Commit(const std::vector<std::shared_ptr<Widget>>& widgets) {
+    // Only a result this layout produced; another list still needs arranging
+    if (m_dirty || widgets.size() != m_arrangedWidgets.size()) return;
+    for (size_t i = 0; i < widgets.size(); ++i) {
+        if (widgets[i].get() != m_arrangedWidgets[i]) return;
+    }
+    TakeSnapshot(widgets, m_arrangedWidgets, m_arrangedBounds);
+    for (auto& widget : widgets) {
+        widget->ClearLayoutDirty();
+    }
+}
+
 // ============================================================================
 // GridLayout Implementation
 // ============================================================================
@@ -14,6 +100,7 @@ GridLayout::GridLayout(int columns, int rows)
 
 void GridLayout::Apply(const RECT& bounds, std::vector<std::shared_ptr<Widget>>& widgets) {
     if (widgets.empty()) return;
+    if (!Measure(bounds, widgets)) return;
     
     int widgetCount = static_cast<int>(widgets.size());
     
@@ -44,8 +131,8 @@ void GridLayout::Apply(const RECT& bounds, std::vector<std::shared_ptr<Widget>>&
                 widget->SetBounds(x, y, cellWidth, cellHeight);
             } else {
                 // Respect widget's preferred size
-                int widgetWidth, widgetHeight;
-                widget->GetSize(widgetWidth, widgetHeight);
+                int widgetWidth = m_desired[index].width;
+                int widgetHeight = m_desired[index].height;
                 if (widgetWidth <= 0) widgetWidth = cellWidth;
                 if (widgetHeight <= 0) widgetHeight = cellHeight;
                 widget->SetPosition(x, y);
@@ -55,6 +142,8 @@ void GridLayout::Apply(const RECT& bounds, std::vector<std::shared_ptr<Widget>>&
             ++index;
         }
     }
+    
+    EndArrange(widgets);
 }
 
 // ============================================================================
@@ -65,8 +154,33 @@ FlowLayout::FlowLayout(Direction direction)
     : m_direction(direction), m_wrap(true), m_alignment(Alignment::START) {
 }
 
+RECT FlowLayout::GetConstraintBounds(const RECT& bounds) const {
+    // The edge a row or column wraps at is only read when wrapping
+    RECT used = bounds;
+    switch (m_direction) {
+        case Direction::LEFT_TO_RIGHT:
+            used.bottom = 0;
+            if (!m_wrap) used.right = 0;
+            break;
+        case Direction::RIGHT_TO_LEFT:
+            used.bottom = 0;
+            if (!m_wrap) used.left = 0;
+            break;
+        case Direction::TOP_TO_BOTTOM:
+            used.right = 0;
+            if (!m_wrap) used.bottom = 0;
+            break;
+        case Direction::BOTTOM_TO_TOP:
+            used.right = 0;
+            if (!m_wrap) used.top = 0;
+            break;
+    }
+    return used;
+}
+
 void FlowLayout::Apply(const RECT& bounds, std::vector<std::shared_ptr<Widget>>& widgets) {
     if (widgets.empty()) return;
+    if (!Measure(bounds, widgets)) return;
     
     int availableWidth = (bounds.right - bounds.left) - m_paddingLeft - m_paddingRight;
     int availableHeight = (bounds.bottom - bounds.top) - m_paddingTop - m_paddingBottom;
@@ -78,9 +192,10 @@ void FlowLayout::Apply(const RECT& bounds, std::vector<std::shared_ptr<Widget>>&
         int currentY = bounds.top + m_paddingTop;
         int rowHeight = 0;
         
-        for (auto& widget : widgets) {
-            int widgetWidth, widgetHeight;
-            widget->GetSize(widgetWidth, widgetHeight);
+        for (size_t i = 0; i < widgets.size(); ++i) {
+            auto& widget = widgets[i];
+            int widgetWidth = m_desired[i].width;
+            int widgetHeight = m_desired[i].height;
             
             // Check if we need to wrap (would widget extend beyond boundary?)
             bool needsWrap = m_wrap && 
@@ -113,9 +228,10 @@ void FlowLayout::Apply(const RECT& bounds, std::vector<std::shared_ptr<Widget>>&
                        bounds.top + m_paddingTop : bounds.bottom - m_paddingBottom;
         int colWidth = 0;
         
-        for (auto& widget : widgets) {
-            int widgetWidth, widgetHeight;
-            widget->GetSize(widgetWidth, widgetHeight);
+        for (size_t i = 0; i < widgets.size(); ++i) {
+            auto& widget = widgets[i];
+            int widgetWidth = m_desired[i].width;
+            int widgetHeight = m_desired[i].height;
             
             // Check if we need to wrap (would widget extend beyond boundary?)
             bool needsWrap = m_wrap &&
@@ -142,6 +258,8 @@ void FlowLayout::Apply(const RECT& bounds, std::vector<std::shared_ptr<Widget>>&
             colWidth = std::max(colWidth, widgetWidth);
         }
     }
+    
+    EndArrange(widgets);
 }
 
 // ============================================================================
@@ -152,18 +270,33 @@ StackLayout::StackLayout(Orientation orientation)
     : m_orientation(orientation), m_distribution(Distribution::START) {
 }
 
+RECT StackLayout::GetConstraintBounds(const RECT& bounds) const {
+    bool vertical = m_orientation == Orientation::VERTICAL;
+    RECT used = bounds;
+
+    // The cross axis only supplies the start edge; widgets keep their size
+    if (vertical) used.right = 0; else used.bottom = 0;
+
+    // Packed to one end, the other end of the main axis is never read
+    if (m_distribution == Distribution::START) {
+        if (vertical) used.bottom = 0; else used.right = 0;
+    } else if (m_distribution == Distribution::END) {
+        if (vertical) used.top = 0; else used.left = 0;
+    }
+    return used;
+}
+
 void StackLayout::Apply(const RECT& bounds, std::vector<std::shared_ptr<Widget>>& widgets) {
     if (widgets.empty()) return;
+    if (!Measure(bounds, widgets)) return;
     
     int availableWidth = (bounds.right - bounds.left) - m_paddingLeft - m_paddingRight;
     int availableHeight = (bounds.bottom - bounds.top) - m_paddingTop - m_paddingBottom;
     
     // Calculate total size of all widgets
     int totalSize = 0;
-    for (auto& widget : widgets) {
-        int w, h;
-        widget->GetSize(w, h);
-        totalSize += (m_orientation == Orientation::VERTICAL) ? h : w;
+    for (const DesiredSize& size : m_desired) {
+        totalSize += (m_orientation == Orientation::VERTICAL) ? size.height : size.width;
     }
     
     // Add spacing between widgets
@@ -222,8 +355,8 @@ void StackLayout::Apply(const RECT& bounds, std::vector<std::shared_ptr<Widget>>
     // Position widgets
     int index = 0;
     for (auto& widget : widgets) {
-        int widgetWidth, widgetHeight;
-        widget->GetSize(widgetWidth, widgetHeight);
+        int widgetWidth = m_desired[index].width;
+        int widgetHeight = m_desired[index].height;
         
         if (m_orientation == Orientation::VERTICAL) {
             int x = bounds.left + m_paddingLeft;
@@ -259,25 +392,299 @@ void StackLayout::Apply(const RECT& bounds, std::vector<std::shared_ptr<Widget>>
         
         ++index;
     }
+    
+    EndArrange(widgets);
 }
 
 // ============================================================================
 // LayoutConstraintSolver Implementation
 // ============================================================================
 
+namespace {
+    // An attribute of a widget's bounds or of the container
+    int GetRectValue(const RECT& bounds, LayoutConstraint::Attribute attr) {
+        switch (attr) {
+            case LayoutConstraint::Attribute::LEFT:
+                return bounds.left;
+            case LayoutConstraint::Attribute::RIGHT:
+                return bounds.right;
+            case LayoutConstraint::Attribute::TOP:
+                return bounds.top;
+            case LayoutConstraint::Attribute::BOTTOM:
+                return bounds.bottom;
+            case LayoutConstraint::Attribute::WIDTH:
+                return bounds.right - bounds.left;
+            case LayoutConstraint::Attribute::HEIGHT:
+                return bounds.bottom - bounds.top;
+            case LayoutConstraint::Attribute::CENTER_X:
+                return (bounds.left + bounds.right) / 2;
+            case LayoutConstraint::Attribute::CENTER_Y:
+                return (bounds.top + bounds.bottom) / 2;
+        }
+        return 0;
+    }
+}
+
+// Cassowary tableau for SIMPLEX mode, built on the first solve after the
+// constraints or mode change and updated incrementally after that
+struct LayoutConstraintSolver::SimplexState {
+    enum { LEFT, TOP, WIDTH, HEIGHT, COUNT };
+    enum { CONTAINER_LEFT, CONTAINER_TOP, CONTAINER_RIGHT, CONTAINER_BOTTOM };
+
+    struct WidgetVariables {
+        SimplexSolver::Variable variables[COUNT];
+        int written[COUNT];     // Bounds last written back to the widget
+    };
+
+    struct EditRequest {
+        std::shared_ptr<Widget> widget;
+        LayoutConstraint::Attribute attr;
+        int priority;
+        int value;
+        bool suggested;
+        SimplexSolver::Variable variable;
+        SimplexSolver::ConstraintId binding;    // variable == the attribute's expression
+    };
+
+    SimplexSolver solver;
+    bool built = false;
+    bool requiredFailed = false;
+    SimplexSolver::Variable container[4] = {};
+    RECT containerBounds = {};
+    bool containerSuggested = false;
+    std::vector<std::pair<Widget*, WidgetVariables>> widgets;
+    std::unordered_map<Widget*, size_t> widgetIndex;
+    std::vector<EditRequest> edits;             // Kept across rebuilds
+
+    // Strength tiers, strongest first: required constraints, the container,
+    // prioritized constraints and edits (priority x 10^6), a widget keeping
+    // its size, a widget keeping its place. Size outranks place by enough
+    // that a long chain of constraints moves widgets rather than squashing them.
+    static constexpr double CONTAINER_STRENGTH = 1.0e9;
+    static constexpr double SIZE_STAY_STRENGTH = 5.0e5;
+    static constexpr double POSITION_STAY_STRENGTH = SimplexSolver::WEAK;
+
+    static double GetStrength(int priority) {
+        if (priority >= 1000) return SimplexSolver::REQUIRED;
+        return SimplexSolver::Strength((double)std::max(1, priority), 0.0, 0.0);
+    }
+
+    static void GetBoundsValues(Widget* widget, int values[COUNT]) {
+        RECT bounds;
+        widget->GetBounds(bounds);
+        values[LEFT] = bounds.left;
+        values[TOP] = bounds.top;
+        values[WIDTH] = bounds.right - bounds.left;
+        values[HEIGHT] = bounds.bottom - bounds.top;
+    }
+
+    // Edit holding a variable at its current value, so whatever the
+    // constraints leave free doesn't move
+    void AddStay(const WidgetVariables& entry, int index, double strength) {
+        solver.AddEditVariable(entry.variables[index], strength);
+        solver.SuggestValue(entry.variables[index], entry.written[index]);
+    }
+
+    // Variables for a widget the first time a constraint or edit mentions it
+    WidgetVariables& GetWidget(Widget* widget) {
+        auto it = widgetIndex.find(widget);
+        if (it != widgetIndex.end()) return widgets[it->second].second;
+
+        WidgetVariables entry;
+        for (int i = 0; i < COUNT; i++) {
+            entry.variables[i] = solver.AddVariable();
+        }
+        GetBoundsValues(widget, entry.written);
+
+        SimplexSolver::Expression width;
+        solver.AddConstraint(width.Add(entry.variables[WIDTH]), SimplexSolver::Relation::GREATER_THAN_OR_EQUAL);
+        SimplexSolver::Expression height;
+        solver.AddConstraint(height.Add(entry.variables[HEIGHT]), SimplexSolver::Relation::GREATER_THAN_OR_EQUAL);
+
+        widgetIndex[widget] = widgets.size();
+        widgets.emplace_back(widget, entry);
+        return widgets.back().second;
+    }
+
+    // Stays go in after the constraints; ones the next constraint
+    // contradicts would cost a pivot apiece, which is quadratic over a build
+    void AddStays(size_t index) {
+        const WidgetVariables& entry = widgets[index].second;
+        AddStay(entry, WIDTH, SIZE_STAY_STRENGTH);
+        AddStay(entry, HEIGHT, SIZE_STAY_STRENGTH);
+        AddStay(entry, LEFT, POSITION_STAY_STRENGTH);
+        AddStay(entry, TOP, POSITION_STAY_STRENGTH);
+    }
+
+    SimplexSolver::Expression GetExpression(Widget* widget, LayoutConstraint::Attribute attr) {
+        const WidgetVariables& entry = GetWidget(widget);
+        SimplexSolver::Expression expression;
+        switch (attr) {
+            case LayoutConstraint::Attribute::LEFT:
+                expression.Add(entry.variables[LEFT]);
+                break;
+            case LayoutConstraint::Attribute::RIGHT:
+                expression.Add(entry.variables[LEFT]).Add(entry.variables[WIDTH]);
+                break;
+            case LayoutConstraint::Attribute::TOP:
+                expression.Add(entry.variables[TOP]);
+                break;
+            case LayoutConstraint::Attribute::BOTTOM:
+                expression.Add(entry.variables[TOP]).Add(entry.variables[HEIGHT]);
+                break;
+            case LayoutConstraint::Attribute::WIDTH:
+                expression.Add(entry.variables[WIDTH]);
+                break;
+            case LayoutConstraint::Attribute::HEIGHT:
+                expression.Add(entry.variables[HEIGHT]);
+                break;
+            case LayoutConstraint::Attribute::CENTER_X:
+                expression.Add(entry.variables[LEFT]).Add(entry.variables[WIDTH], 0.5);
+                break;
+            case LayoutConstraint::Attribute::CENTER_Y:
+                expression.Add(entry.variables[TOP]).Add(entry.variables[HEIGHT], 0.5);
+                break;
+        }
+        return expression;
+    }
+
+    SimplexSolver::Expression GetContainerExpression(LayoutConstraint::Attribute attr) const {
+        SimplexSolver::Expression expression;
+        switch (attr) {
+            case LayoutConstraint::Attribute::LEFT:
+                expression.Add(container[CONTAINER_LEFT]);
+                break;
+            case LayoutConstraint::Attribute::RIGHT:
+                expression.Add(container[CONTAINER_RIGHT]);
+                break;
+            case LayoutConstraint::Attribute::TOP:
+                expression.Add(container[CONTAINER_TOP]);
+                break;
+            case LayoutConstraint::Attribute::BOTTOM:
+                expression.Add(container[CONTAINER_BOTTOM]);
+                break;
+            case LayoutConstraint::Attribute::WIDTH:
+                expression.Add(container[CONTAINER_RIGHT]).Add(container[CONTAINER_LEFT], -1.0);
+                break;
+            case LayoutConstraint::Attribute::HEIGHT:
+                expression.Add(container[CONTAINER_BOTTOM]).Add(container[CONTAINER_TOP], -1.0);
+                break;
+            case LayoutConstraint::Attribute::CENTER_X:
+                expression.Add(container[CONTAINER_LEFT], 0.5).Add(container[CONTAINER_RIGHT], 0.5);
+                break;
+            case LayoutConstraint::Attribute::CENTER_Y:
+                expression.Add(container[CONTAINER_TOP], 0.5).Add(container[CONTAINER_BOTTOM], 0.5);
+                break;
+        }
+        return expression;
+    }
+
+    void ApplyEdit(EditRequest& edit) {
+        size_t known = widgets.size();
+        SimplexSolver::Expression binding = GetExpression(edit.widget.get(), edit.attr);
+        if (widgets.size() > known) AddStays(known);
+
+        // Not yet suggested: hold the attribute where it is rather than at 0
+        RECT bounds;
+        edit.widget->GetBounds(bounds);
+        double current = edit.suggested ? (double)edit.value : (double)GetRectValue(bounds, edit.attr);
+
+        edit.variable = solver.AddVariable();
+        binding.Add(edit.variable, -1.0);
+        edit.binding = solver.AddConstraint(binding, SimplexSolver::Relation::EQUAL);
+        solver.AddEditVariable(edit.variable, std::min(GetStrength(edit.priority), CONTAINER_STRENGTH));
+        solver.SuggestValue(edit.variable, current);
+    }
+};
+
 LayoutConstraintSolver::LayoutConstraintSolver()
-    : m_converged(false), m_iterations(0), m_dampingFactor(0.5f) {
+    : m_converged(false), m_iterations(0), m_dampingFactor(0.5f),
+      m_mode(Mode::RELAXATION), m_revision(0), m_simplex(new SimplexState()) {
 }
 
 LayoutConstraintSolver::~LayoutConstraintSolver() {
 }
 
+void LayoutConstraintSolver::SetMode(Mode mode) {
+    if (m_mode == mode) return;
+    
+    m_mode = mode;
+    m_simplex->built = false;
+    ++m_revision;
+}
+
 void LayoutConstraintSolver::AddConstraint(const LayoutConstraint& constraint) {
     m_constraints.push_back(constraint);
+    ++m_revision;
+    
+    // A built tableau takes the constraint in place
+    if (m_mode == Mode::SIMPLEX && m_simplex->built) {
+        size_t known = m_simplex->widgets.size();
+        AddSimplexConstraint(constraint);
+        for (size_t i = known; i < m_simplex->widgets.size(); ++i) {
+            m_simplex->AddStays(i);
+        }
+    }
 }
 
 void LayoutConstraintSolver::ClearConstraints() {
     m_constraints.clear();
+    m_simplex->built = false;
+    ++m_revision;
+}
+
+bool LayoutConstraintSolver::AddEditVariable(std::shared_ptr<Widget> widget, LayoutConstraint::Attribute attr, int priority) {
+    if (m_mode != Mode::SIMPLEX || !widget) return false;
+    for (const auto& edit : m_simplex->edits) {
+        if (edit.widget == widget && edit.attr == attr) return false;
+    }
+    
+    SimplexState::EditRequest edit = { widget, attr, priority, 0, false, 0, SimplexSolver::INVALID_CONSTRAINT };
+    m_simplex->edits.push_back(edit);
+    if (m_simplex->built) {
+        m_simplex->ApplyEdit(m_simplex->edits.back());
+    }
+    ++m_revision;
+    return true;
+}
+
+bool LayoutConstraintSolver::RemoveEditVariable(std::shared_ptr<Widget> widget, LayoutConstraint::Attribute attr) {
+    auto& edits = m_simplex->edits;
+    for (auto it = edits.begin(); it != edits.end(); ++it) {
+        if (it->widget != widget || it->attr != attr) continue;
+        
+        if (m_simplex->built) {
+            m_simplex->solver.RemoveEditVariable(it->variable);
+            m_simplex->solver.RemoveConstraint(it->binding);
+        }
+        edits.erase(it);
+        ++m_revision;
+        return true;
+    }
+    return false;
+}
+
+bool LayoutConstraintSolver::SuggestValue(std::shared_ptr<Widget> widget, LayoutConstraint::Attribute attr, int value) {
+    for (auto& edit : m_simplex->edits) {
+        if (edit.widget != widget || edit.attr != attr) continue;
+        
+        if (edit.suggested && edit.value == value) return true;
+        edit.value = value;
+        edit.suggested = true;
+        if (m_simplex->built) {
+            m_simplex->solver.SuggestValue(edit.variable, value);
+        }
+        ++m_revision;
+        return true;
+    }
+    return false;
+}
+
+bool LayoutConstraintSolver::DependsOnContainer() const {
+    for (const auto& constraint : m_constraints) {
+        if (constraint.IsContainerRelative()) return true;
+    }
+    return false;
 }
 
 int LayoutConstraintSolver::GetAttributeValue(std::shared_ptr<Widget> widget, 
@@ -286,26 +693,7 @@ int LayoutConstraintSolver::GetAttributeValue(std::shared_ptr<Widget> widget,
     
     RECT bounds;
     widget->GetBounds(bounds);
-    
-    switch (attr) {
-        case LayoutConstraint::Attribute::LEFT:
-            return bounds.left;
-        case LayoutConstraint::Attribute::RIGHT:
-            return bounds.right;
-        case LayoutConstraint::Attribute::TOP:
-            return bounds.top;
-        case LayoutConstraint::Attribute::BOTTOM:
-            return bounds.bottom;
-        case LayoutConstraint::Attribute::WIDTH:
-            return bounds.right - bounds.left;
-        case LayoutConstraint::Attribute::HEIGHT:
-            return bounds.bottom - bounds.top;
-        case LayoutConstraint::Attribute::CENTER_X:
-            return (bounds.left + bounds.right) / 2;
-        case LayoutConstraint::Attribute::CENTER_Y:
-            return (bounds.top + bounds.bottom) / 2;
-    }
-    return 0;
+    return GetRectValue(bounds, attr);
 }
 
 void LayoutConstraintSolver::SetAttributeValue(std::shared_ptr<Widget> widget, 
@@ -345,15 +733,19 @@ void LayoutConstraintSolver::SetAttributeValue(std::shared_ptr<Widget> widget,
     }
 }
 
-float LayoutConstraintSolver::EvaluateConstraintError(const LayoutConstraint& constraint) const {
-    int value1 = GetAttributeValue(constraint.GetWidget1(), constraint.GetAttribute1());
+int LayoutConstraintSolver::GetTargetValue(const LayoutConstraint& constraint, const RECT& bounds) const {
     int value2 = 0;
-    
     if (constraint.GetWidget2()) {
         value2 = GetAttributeValue(constraint.GetWidget2(), constraint.GetAttribute2());
+    } else if (constraint.IsContainerRelative()) {
+        value2 = GetRectValue(bounds, constraint.GetAttribute2());
     }
-    
-    int targetValue = value2 + constraint.GetConstant();
+    return value2 + constraint.GetConstant();
+}
+
+float LayoutConstraintSolver::EvaluateConstraintError(const LayoutConstraint& constraint, const RECT& bounds) const {
+    int value1 = GetAttributeValue(constraint.GetWidget1(), constraint.GetAttribute1());
+    int targetValue = GetTargetValue(constraint, bounds);
     
     switch (constraint.GetType()) {
         case LayoutConstraint::Type::EQUAL:
@@ -369,14 +761,22 @@ float LayoutConstraintSolver::EvaluateConstraintError(const LayoutConstraint& co
 bool LayoutConstraintSolver::Solve(const RECT& bounds, 
                                     std::vector<std::shared_ptr<Widget>>& widgets,
                                     int maxIterations, float tolerance) {
+    (void)widgets;
     m_converged = false;
     m_iterations = 0;
     
-    if (m_constraints.empty()) {
+    if (m_constraints.empty() && (m_mode == Mode::RELAXATION || m_simplex->edits.empty())) {
         m_converged = true;
         return true;
     }
     
+    if (m_mode == Mode::SIMPLEX) {
+        return SolveSimplex(bounds);
+    }
+    return SolveRelaxation(bounds, maxIterations, tolerance);
+}
+
+bool LayoutConstraintSolver::SolveRelaxation(const RECT& bounds, int maxIterations, float tolerance) {
     // Sort constraints by priority
     std::sort(m_constraints.begin(), m_constraints.end(),
               [](const LayoutConstraint& a, const LayoutConstraint& b) {
@@ -390,22 +790,13 @@ bool LayoutConstraintSolver::Solve(const RECT& bounds,
         
         // Process each constraint
         for (const auto& constraint : m_constraints) {
-            float error = EvaluateConstraintError(constraint);
+            float error = EvaluateConstraintError(constraint, bounds);
             maxError = std::max(maxError, error);
             
             if (error > tolerance) {
                 // Adjust widget position to satisfy constraint
                 int value1 = GetAttributeValue(constraint.GetWidget1(), constraint.GetAttribute1());
-                int value2 = 0;
-                
-                if (constraint.GetWidget2()) {
-                    value2 = GetAttributeValue(constraint.GetWidget2(), constraint.GetAttribute2());
-                } else {
-                    // Constraint to fixed value
-                    value2 = 0;
-                }
-                
-                int targetValue = value2 + constraint.GetConstant();
+                int targetValue = GetTargetValue(constraint, bounds);
                 
                 // Apply correction with configurable damping to improve convergence
                 int correction = static_cast<int>((targetValue - value1) * m_dampingFactor);
@@ -437,18 +828,123 @@ bool LayoutConstraintSolver::Solve(const RECT& bounds,
     return m_converged;
 }
 
+void LayoutConstraintSolver::AddSimplexConstraint(const LayoutConstraint& constraint) {
+    SimplexState& state = *m_simplex;
+    if (!constraint.GetWidget1()) return;
+    
+    // attr1 - (attr2 + constant) compared against zero
+    SimplexSolver::Expression expression = state.GetExpression(constraint.GetWidget1().get(), constraint.GetAttribute1());
+    SimplexSolver::Expression target;
+    if (constraint.GetWidget2()) {
+        target = state.GetExpression(constraint.GetWidget2().get(), constraint.GetAttribute2());
+    } else if (constraint.IsContainerRelative()) {
+        target = state.GetContainerExpression(constraint.GetAttribute2());
+    }
+    for (const SimplexSolver::Term& term : target.terms) {
+        expression.Add(term.variable, -term.coefficient);
+    }
+    expression.constant -= constraint.GetConstant();
+    
+    SimplexSolver::Relation relation = SimplexSolver::Relation::EQUAL;
+    if (constraint.GetType() == LayoutConstraint::Type::LESS_THAN_OR_EQUAL) {
+        relation = SimplexSolver::Relation::LESS_THAN_OR_EQUAL;
+    } else if (constraint.GetType() == LayoutConstraint::Type::GREATER_THAN_OR_EQUAL) {
+        relation = SimplexSolver::Relation::GREATER_THAN_OR_EQUAL;
+    }
+    
+    // A required constraint that contradicts the others is left out
+    double strength = SimplexState::GetStrength(constraint.GetPriority());
+    if (state.solver.AddConstraint(expression, relation, strength) == SimplexSolver::INVALID_CONSTRAINT) {
+        state.requiredFailed = true;
+    }
+}
+
+void LayoutConstraintSolver::BuildSimplex() {
+    SimplexState& state = *m_simplex;
+    state.solver.Reset();
+    state.widgets.clear();
+    state.widgetIndex.clear();
+    state.requiredFailed = false;
+    state.containerSuggested = false;
+    
+    for (auto& variable : state.container) {
+        variable = state.solver.AddVariable();
+        state.solver.AddEditVariable(variable, SimplexState::CONTAINER_STRENGTH);
+    }
+    
+    for (const auto& constraint : m_constraints) {
+        AddSimplexConstraint(constraint);
+    }
+    for (size_t i = 0; i < state.widgets.size(); ++i) {
+        state.AddStays(i);
+    }
+    for (auto& edit : state.edits) {
+        state.ApplyEdit(edit);
+    }
+    state.built = true;
+}
+
+bool LayoutConstraintSolver::SolveSimplex(const RECT& bounds) {
+    SimplexState& state = *m_simplex;
+    if (!state.built) BuildSimplex();
+    uint64_t pivots = state.solver.GetPivotCount();
+    
+    if (!state.containerSuggested || !SameRect(bounds, state.containerBounds)) {
+        state.solver.SuggestValue(state.container[SimplexState::CONTAINER_LEFT], bounds.left);
+        state.solver.SuggestValue(state.container[SimplexState::CONTAINER_TOP], bounds.top);
+        state.solver.SuggestValue(state.container[SimplexState::CONTAINER_RIGHT], bounds.right);
+        state.solver.SuggestValue(state.container[SimplexState::CONTAINER_BOTTOM], bounds.bottom);
+        state.containerBounds = bounds;
+        state.containerSuggested = true;
+    }
+    
+    // Widgets moved since the last write-back (e.g. by a base layout) are
+    // held at their new bounds; untouched ones cost nothing
+    for (auto& entry : state.widgets) {
+        int values[SimplexState::COUNT];
+        SimplexState::GetBoundsValues(entry.first, values);
+        for (int i = 0; i < SimplexState::COUNT; ++i) {
+            if (values[i] != entry.second.written[i]) {
+                state.solver.SuggestValue(entry.second.variables[i], values[i]);
+            }
+        }
+    }
+    
+    state.solver.UpdateVariables();
+    for (auto& entry : state.widgets) {
+        int values[SimplexState::COUNT];
+        for (int i = 0; i < SimplexState::COUNT; ++i) {
+            values[i] = static_cast<int>(std::lround(state.solver.GetValue(entry.second.variables[i])));
+            entry.second.written[i] = values[i];
+        }
+        // SetBounds returns early for a widget that didn't move
+        entry.first->SetBounds(values[SimplexState::LEFT], values[SimplexState::TOP],
+                               values[SimplexState::WIDTH], values[SimplexState::HEIGHT]);
+    }
+    
+    m_iterations = static_cast<int>(state.solver.GetPivotCount() - pivots);
+    m_converged = !state.requiredFailed;
+    return m_converged;
+}
+
 // ============================================================================
 // LayoutEngine Implementation
 // ============================================================================
 
 LayoutEngine::LayoutEngine()
-    : m_baseLayout(nullptr), m_autoLayout(false) {
+    : m_baseLayout(nullptr), m_autoLayout(false), m_solved(false), m_solvedRevision(0),
+      m_solvedContainer(), m_solveCount(0), m_layoutCacheCapacity(DEFAULT_LAYOUT_CACHE_CAPACITY),
+      m_layoutCacheHits(0), m_layoutCacheMisses(0) {
 }
 
 LayoutEngine::~LayoutEngine() {
 }
 
 void LayoutEngine::SetBaseLayout(std::shared_ptr<Layout> layout) {
+    // A new layout could reuse a freed one's address, and cached results are keyed by it
+    if (m_baseLayout && m_baseLayout != layout) {
+        ClearLayoutCache();
+    }
     m_baseLayout = layout;
 }
 
@@ -462,6 +958,7 @@ void LayoutEngine::ClearConstraints() {
 
 void LayoutEngine::Apply(const RECT& bounds, std::vector<std::shared_ptr<Widget>>& widgets) {
     if (widgets.empty()) return;
+    SDK_PROFILE_ZONE("LayoutEngine::Apply");
     
     // Determine layout
     std::shared_ptr<Layout> layout = m_baseLayout;
@@ -469,20 +966,139 @@ void LayoutEngine::Apply(const RECT& bounds, std::vector<std::shared_ptr<Widget>
         layout = DetermineOptimalLayout(bounds, widgets);
     }
     
+    // A configuration seen before copies its result
+    bool cacheable = layout && m_layoutCacheCapacity > 0;
+    if (cacheable) {
+        if (!MatchesWidgets(widgets, m_cachedWidgets)) {
+            m_layoutCache.clear();
+            m_cachedWidgets.resize(widgets.size());
+            for (size_t i = 0; i < widgets.size(); ++i) {
+                m_cachedWidgets[i] = widgets[i].get();
+            }
+        }
+        
+        // Dirty widgets may lay out differently at the same size
+        bool dirty = false;
+        bool readsSizes = layout->ReadsWidgetSizes();
+        m_sizeScratch.clear();
+        for (const auto& widget : widgets) {
+            dirty = dirty || widget->IsLayoutDirty();
+            if (readsSizes) {
+                int width, height;
+                widget->GetSize(width, height);
+                m_sizeScratch.push_back(width);
+                m_sizeScratch.push_back(height);
+            }
+        }
+        
+        const CachedLayout* cached = dirty ? nullptr : FindCachedLayout(bounds, *layout);
+        if (cached) {
+            ++m_layoutCacheHits;
+            for (size_t i = 0; i < widgets.size(); ++i) {
+                const RECT& rect = cached->result[i];
+                widgets[i]->SetBounds(rect.left, rect.top, rect.right - rect.left, rect.bottom - rect.top);
+                widgets[i]->ClearLayoutDirty();
+            }
+            return;
+        }
+        ++m_layoutCacheMisses;
+    }
+    
     // Apply base layout if available
     if (layout) {
         layout->Apply(bounds, widgets);
     }
     
-    // Apply constraints for fine-tuning
-    m_solver.Solve(bounds, widgets);
+    // Apply constraints for fine-tuning; a solve over the bounds it produced last time is a no-op
+    bool containerChanged = m_solver.DependsOnContainer() && !SameRect(bounds, m_solvedContainer);
+    if (!m_solved || m_solvedRevision != m_solver.GetRevision() || containerChanged ||
+        !MatchesSnapshot(widgets, m_solvedWidgets, m_solvedBounds)) {
+        m_solver.Solve(bounds, widgets);
+        TakeSnapshot(widgets, m_solvedWidgets, m_solvedBounds);
+        m_solved = true;
+        m_solvedRevision = m_solver.GetRevision();
+        m_solvedContainer = bounds;
+        ++m_solveCount;
+        
+        // The solved bounds are the result the layout should compare against next time
+        if (layout) {
+            layout->Commit(widgets);
+        }
+    }
+    
+    if (cacheable) {
+        StoreCachedLayout(bounds, *layout, widgets);
+    }
+}
+
+void LayoutEngine::SetLayoutCacheCapacity(size_t capacity) {
+    m_layoutCacheCapacity = capacity;
+    if (m_layoutCache.size() > capacity) {
+        ClearLayoutCache();
+    }
+}
+
+void LayoutEngine::ClearLayoutCache() {
+    m_layoutCache.clear();
+    m_cachedWidgets.clear();
+}
+
+LayoutEngine::LayoutCacheStats LayoutEngine::GetLayoutCacheStats() const {
+    LayoutCacheStats stats;
+    stats.hits = m_layoutCacheHits;
+    stats.misses = m_layoutCacheMisses;
+    stats.entries = m_layoutCache.size();
+    return stats;
+}
+
+void LayoutEngine::ResetLayoutCacheStats() {
+    m_layoutCacheHits = 0;
+    m_layoutCacheMisses = 0;
+}
+
+LayoutEngine::CachedLayout* LayoutEngine::FindCachedLayout(const RECT& bounds, const Layout& layout) {
+    for (CachedLayout& cached : m_layoutCache) {
+        if (cached.layout == &layout && cached.layoutRevision == layout.GetRevision() &&
+            cached.constraintRevision == m_solver.GetRevision() && SameRect(cached.bounds, bounds) &&
+            cached.sizes == m_sizeScratch) {
+            return &cached;
+        }
+    }
+    return nullptr;
+}
+
+void LayoutEngine::StoreCachedLayout(const RECT& bounds, const Layout& layout,
+                                     const std::vector<std::shared_ptr<Widget>>& widgets) {
+    // Replaces a stale result for the same configuration, e.g. one a dirty widget made
+    CachedLayout* entry = FindCachedLayout(bounds, layout);
+    if (!entry) {
+        if (m_layoutCache.size() >= m_layoutCacheCapacity) {
+            m_layoutCache.clear();
+        }
+        m_layoutCache.emplace_back();
+        entry = &m_layoutCache.back();
+        entry->bounds = bounds;
+        entry->layout = &layout;
+        entry->layoutRevision = layout.GetRevision();
+        entry->constraintRevision = m_solver.GetRevision();
+        entry->sizes = m_sizeScratch;
+    }
+    
+    entry->result.resize(widgets.size());
+    for (size_t i = 0; i < widgets.size(); ++i) {
+        widgets[i]->GetBounds(entry->result[i]);
+    }
 }
 
 std::shared_ptr<Layout> LayoutEngine::SuggestLayout(int widgetCount, 
                                                      int containerWidth, 
                                                      int containerHeight) {
+    return CreateLayout(Suggest(widgetCount, containerWidth, containerHeight));
+}
+
+LayoutEngine::Suggestion LayoutEngine::Suggest(int widgetCount, int containerWidth, int containerHeight) {
     if (widgetCount <= 0) {
-        return std::make_shared<StackLayout>(StackLayout::Orientation::VERTICAL);
+        return { Layout::LayoutType::STACK, static_cast<int>(StackLayout::Orientation::VERTICAL) };
     }
     
     float aspectRatio = static_cast<float>(containerWidth) / static_cast<float>(containerHeight);
@@ -490,9 +1106,9 @@ std::shared_ptr<Layout> LayoutEngine::SuggestLayout(int widgetCount,
     // For few widgets, use stack layout
     if (widgetCount <= 3) {
         if (aspectRatio > 1.5f) {
-            return std::make_shared<StackLayout>(StackLayout::Orientation::HORIZONTAL);
+            return { Layout::LayoutType::STACK, static_cast<int>(StackLayout::Orientation::HORIZONTAL) };
         } else {
-            return std::make_shared<StackLayout>(StackLayout::Orientation::VERTICAL);
+            return { Layout::LayoutType::STACK, static_cast<int>(StackLayout::Orientation::VERTICAL) };
         }
     }
     
@@ -501,11 +1117,22 @@ std::shared_ptr<Layout> LayoutEngine::SuggestLayout(int widgetCount,
         // Calculate optimal columns based on aspect ratio
         int columns = static_cast<int>(std::sqrt(widgetCount * aspectRatio));
         columns = std::max(2, std::min(columns, 6)); // Clamp between 2-6 columns
-        return std::make_shared<GridLayout>(columns, 0);
+        return { Layout::LayoutType::GRID, columns };
     }
     
     // For medium number of widgets, use flow layout
-    return std::make_shared<FlowLayout>(FlowLayout::Direction::LEFT_TO_RIGHT);
+    return { Layout::LayoutType::FLOW, static_cast<int>(FlowLayout::Direction::LEFT_TO_RIGHT) };
+}
+
+std::shared_ptr<Layout> LayoutEngine::CreateLayout(const Suggestion& suggestion) {
+    switch (suggestion.type) {
+        case Layout::LayoutType::GRID:
+            return std::make_shared<GridLayout>(suggestion.variant, 0);
+        case Layout::LayoutType::FLOW:
+            return std::make_shared<FlowLayout>(static_cast<FlowLayout::Direction>(suggestion.variant));
+        default:
+            return std::make_shared<StackLayout>(static_cast<StackLayout::Orientation>(suggestion.variant));
+    }
 }
 
 std::shared_ptr<Layout> LayoutEngine::DetermineOptimalLayout(
@@ -515,7 +1142,15 @@ std::shared_ptr<Layout> LayoutEngine::DetermineOptimalLayout(
     int containerHeight = bounds.bottom - bounds.top;
     int widgetCount = static_cast<int>(widgets.size());
     
-    return SuggestLayout(widgetCount, containerWidth, containerHeight);
+    // Suggestions are few (five grids, a flow, two stacks), so each keeps its layout
+    Suggestion suggestion = Suggest(widgetCount, containerWidth, containerHeight);
+    for (const auto& entry : m_autoLayouts) {
+        if (entry.first.type == suggestion.type && entry.first.variant == suggestion.variant) {
+            return entry.second;
+        }
+    }
+    m_autoLayouts.emplace_back(suggestion, CreateLayout(suggestion));
+    return m_autoLayouts.back().second;
 }
 
 } // namespace SDK
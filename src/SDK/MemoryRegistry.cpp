@@ -0,0 +1,202 @@
+#include "../../include/SDK/MemoryRegistry.h"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+namespace SDK {
+
+namespace {
+    struct Entry {
+        uint64_t id;
+        const char* name;
+        MemoryRegistry::BytesFn bytes;
+        MemoryRegistry::TrimFn trim;
+    };
+
+    struct NameState {
+        const char* name;
+        size_t bytes;
+        size_t peak;
+        size_t budget;
+        size_t sources;
+        uint64_t trims;
+    };
+
+    // Recursive: a trim may destroy objects whose sources unregister
+    struct State {
+        std::recursive_mutex mutex;
+        std::vector<Entry> entries;     // In registration order
+        std::vector<NameState> names;
+        uint64_t nextId = 1;
+        size_t totalBytes = 0;
+        size_t totalPeak = 0;
+    };
+
+    State& GetState() {
+        static State state;
+        return state;
+    }
+
+    // Names are compared by content; the same literal may have several addresses
+    NameState& GetName(State& state, const char* name) {
+        for (NameState& entry : state.names) {
+            if (std::strcmp(entry.name, name) == 0) return entry;
+        }
+        state.names.push_back({ name, 0, 0, 0, 0, 0 });
+        return state.names.back();
+    }
+
+    const Entry* FindEntry(const State& state, uint64_t id) {
+        for (const Entry& entry : state.entries) {
+            if (entry.id == id) return &entry;
+        }
+        return nullptr;
+    }
+
+    // Callbacks are copied out before they run, since they may register or
+    // unregister sources
+    size_t ReadName(State& state, const char* name, std::vector<std::pair<uint64_t, size_t>>* perSource) {
+        std::vector<uint64_t> ids;
+        for (const Entry& entry : state.entries) {
+            if (std::strcmp(entry.name, name) == 0) ids.push_back(entry.id);
+        }
+
+        size_t total = 0;
+        for (uint64_t id : ids) {
+            const Entry* entry = FindEntry(state, id);
+            if (!entry) continue;
+            MemoryRegistry::BytesFn bytes = entry->bytes;
+            size_t value = bytes ? bytes() : 0;
+            total += value;
+            if (perSource) perSource->push_back({ id, value });
+        }
+        return total;
+    }
+
+    // Splits the target between the sources in proportion to what they hold
+    void TrimName(State& state, const char* name, size_t targetBytes) {
+        std::vector<std::pair<uint64_t, size_t>> sources;
+        size_t total = ReadName(state, name, &sources);
+        if (total <= targetBytes && targetBytes != 0) return;
+
+        bool trimmed = false;
+        for (const auto& source : sources) {
+            const Entry* entry = FindEntry(state, source.first);
+            if (!entry || !entry->trim) continue;
+            MemoryRegistry::TrimFn trim = entry->trim;
+            size_t share = total > 0 ? (size_t)((double)source.second * targetBytes / total) : 0;
+            trim(share);
+            trimmed = true;
+        }
+        if (trimmed) GetName(state, name).trims++;
+    }
+}
+
+MemoryRegistry::Source::Source(const char* name, BytesFn bytes, TrimFn trim)
+    : m_id(0) {
+    State& state = GetState();
+    std::lock_guard<std::recursive_mutex> lock(state.mutex);
+    m_id = state.nextId++;
+    state.entries.push_back({ m_id, name, std::move(bytes), std::move(trim) });
+    GetName(state, name);
+}
+
+void MemoryRegistry::Source::Reset() {
+    if (m_id == 0) return;
+
+    State& state = GetState();
+    std::lock_guard<std::recursive_mutex> lock(state.mutex);
+    auto it = std::find_if(state.entries.begin(), state.entries.end(),
+                           [&](const Entry& entry) { return entry.id == m_id; });
+    if (it != state.entries.end()) state.entries.erase(it);
+    m_id = 0;
+}
+
+std::vector<MemoryRegistry::Usage> MemoryRegistry::Sample() {
+    State& state = GetState();
+    std::lock_guard<std::recursive_mutex> lock(state.mutex);
+
+    // Indexes, not references: a callback may add a name
+    for (size_t i = 0; i < state.names.size(); i++) {
+        const char* name = state.names[i].name;
+        size_t budget = state.names[i].budget;
+        if (budget > 0 && ReadName(state, name, nullptr) > budget) {
+            TrimName(state, name, budget);
+        }
+    }
+
+    std::vector<Usage> usage;
+    state.totalBytes = 0;
+    for (size_t i = 0; i < state.names.size(); i++) {
+        const char* name = state.names[i].name;
+        size_t bytes = ReadName(state, name, nullptr);
+        NameState& entry = state.names[i];
+        entry.bytes = bytes;
+        entry.peak = std::max(entry.peak, bytes);
+        entry.sources = 0;
+        for (const Entry& source : state.entries) {
+            if (std::strcmp(source.name, name) == 0) entry.sources++;
+        }
+        state.totalBytes += bytes;
+        usage.push_back({ entry.name, entry.bytes, entry.peak, entry.budget, entry.sources, entry.trims });
+    }
+    state.totalPeak = std::max(state.totalPeak, state.totalBytes);
+
+    std::sort(usage.begin(), usage.end(), [](const Usage& a, const Usage& b) { return a.bytes > b.bytes; });
+    return usage;
+}
+
+size_t MemoryRegistry::GetTotalBytes() {
+    State& state = GetState();
+    std::lock_guard<std::recursive_mutex> lock(state.mutex);
+    return state.totalBytes;
+}
+
+size_t MemoryRegistry::GetTotalPeak() {
+    State& state = GetState();
+    std::lock_guard<std::recursive_mutex> lock(state.mutex);
+    return state.totalPeak;
+}
+
+void MemoryRegistry::SetBudget(const char* name, size_t bytes) {
+    if (!name) return;
+    State& state = GetState();
+    std::lock_guard<std::recursive_mutex> lock(state.mutex);
+    GetName(state, name).budget = bytes;
+}
+
+size_t MemoryRegistry::GetBudget(const char* name) {
+    if (!name) return 0;
+    State& state = GetState();
+    std::lock_guard<std::recursive_mutex> lock(state.mutex);
+    for (const NameState& entry : state.names) {
+        if (std::strcmp(entry.name, name) == 0) return entry.budget;
+    }
+    return 0;
+}
+
+void MemoryRegistry::Trim(const char* name, size_t targetBytes) {
+    if (!name) return;
+    State& state = GetState();
+    std::lock_guard<std::recursive_mutex> lock(state.mutex);
+    TrimName(state, name, targetBytes);
+}
+
+void MemoryRegistry::TrimAll() {
+    State& state = GetState();
+    std::lock_guard<std::recursive_mutex> lock(state.mutex);
+    for (size_t i = 0; i < state.names.size(); i++) {
+        TrimName(state, state.names[i].name, 0);
+    }
+}
+
+void MemoryRegistry::ResetPeaks() {
+    State& state = GetState();
+    std::lock_guard<std::recursive_mutex> lock(state.mutex);
+    for (NameState& entry : state.names) {
+        entry.peak = entry.bytes;
+    }
+    state.totalPeak = state.totalBytes;
+}
+
+} // namespace SDK
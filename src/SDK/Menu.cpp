@@ -0,0 +1,81 @@
+#include "../../include/SDK/Menu.h"
+#include <algorithm>
+
+namespace SDK {
+
+namespace {
+    uint64_t g_menuRevision = 0;
+}
+
+// ==================== MENU ITEM ====================
+
+MenuItem::MenuItem(const std::wstring& text, Type type)
+    : m_text(text)
+    , m_type(type)
+    , m_enabled(true)
+    , m_checked(false)
+    , m_icon(nullptr)
+{
+}
+
+void MenuItem::SetType(Type type) {
+    if (m_type == type) return;
+    m_type = type;
+    g_menuRevision++;
+}
+
+void MenuItem::SetShortcut(const std::wstring& shortcut) {
+    if (m_shortcut == shortcut) return;
+    m_shortcut = shortcut;
+    g_menuRevision++;
+}
+
+void MenuItem::AddSubMenuItem(std::shared_ptr<MenuItem> item) {
+    if (!item) return;
+    m_subItems.push_back(item);
+    g_menuRevision++;
+}
+
+void MenuItem::Click() {
+    if (!m_enabled) return;
+
+    if (m_type == Type::CHECKBOX) {
+        m_checked = !m_checked;
+    } else if (m_type == Type::RADIO) {
+        m_checked = true;
+    }
+
+    if (m_onClick) {
+        m_onClick();
+    }
+}
+
+uint64_t MenuItem::GetRevision() {
+    return g_menuRevision;
+}
+
+// ==================== MENU ====================
+
+void Menu::AddItem(std::shared_ptr<MenuItem> item) {
+    if (!item) return;
+    m_items.push_back(item);
+    g_menuRevision++;
+    Invalidate();
+}
+
+void Menu::RemoveItem(std::shared_ptr<MenuItem> item) {
+    auto it = std::find(m_items.begin(), m_items.end(), item);
+    if (it == m_items.end()) return;
+    m_items.erase(it);
+    g_menuRevision++;
+    Invalidate();
+}
+
+void Menu::Clear() {
+    if (m_items.empty()) return;
+    m_items.clear();
+    g_menuRevision++;
+    Invalidate();
+}
+
+} // namespace SDK
@@ -1,5 +1,6 @@
 #include "SDK/MonitorManager.h"
 #include "SDK/DPIManager.h"
+#include "SDK/StartupTiming.h"
 #include <algorithm>
 
 namespace SDK {
@@ -13,23 +14,39 @@ MonitorManager::~MonitorManager() {
     Shutdown();
 }
 
-MonitorManager& MonitorManager::GetInstance() {
+MonitorManager& MonitorManager::GetStorage() {
     static MonitorManager instance;
     return instance;
 }
 
+MonitorManager& MonitorManager::GetInstance() {
+    MonitorManager& instance = GetStorage();
+    // Monitors are enumerated on first use rather than at SDK startup
+    if (!instance.m_initialized) {
+        instance.Initialize();
+    }
+    return instance;
+}
+
+bool MonitorManager::IsStarted() {
+    return GetStorage().m_initialized;
+}
+
 bool MonitorManager::Initialize() {
     if (m_initialized) {
         return true;
     }
     
-    RefreshMonitors();
+    // Set first: enumeration asks DPIManager, which looks monitors up here
     m_initialized = true;
+    StartupTiming::Scope timing(StartupTiming::Phase::MONITOR_MANAGER);
+    RefreshMonitors();
     return true;
 }
 
 void MonitorManager::Shutdown() {
     m_monitors.clear();
+    m_topology.Clear();
     m_monitorThemes.clear();
     m_windowTracking.clear();
     m_monitorChangeCallbacks.clear();
@@ -37,8 +54,24 @@ void MonitorManager::Shutdown() {
 }
 
 void MonitorManager::RefreshMonitors() {
+    // Cleared first so DPIManager asks the system instead of the stale layout
+    m_topology.Clear();
     m_monitors.clear();
     EnumerateMonitors();
+    
+    std::vector<MonitorTopology::Monitor> monitors;
+    monitors.reserve(m_monitors.size());
+    for (const auto& info : m_monitors) {
+        monitors.push_back({info.hMonitor, info.bounds, info.workArea, info.dpiInfo.dpi});
+    }
+    m_topology.Build(monitors);
+}
+
+void MonitorManager::HandleDisplayChange() {
+    RefreshMonitors();
+    
+    // Handles can change with the layout; tracked windows report their new monitor
+    Update();
 }
 
 void MonitorManager::EnumerateMonitors() {
@@ -156,26 +189,19 @@ void MonitorManager::GatherMonitorDetails(MonitorInfo& info) {
 }
 
 const MonitorInfo* MonitorManager::GetMonitor(HMONITOR hMonitor) const {
-    for (const auto& monitor : m_monitors) {
-        if (monitor.hMonitor == hMonitor) {
-            return &monitor;
-        }
-    }
-    return nullptr;
+    int index = m_topology.FromHandle(hMonitor);
+    return index != MonitorTopology::NOT_FOUND ? &m_monitors[index] : nullptr;
 }
 
 const MonitorInfo* MonitorManager::GetMonitorForWindow(HWND hwnd) const {
-    if (!hwnd || !IsWindow(hwnd)) {
-        return nullptr;
-    }
-    
-    HMONITOR hMonitor = MonitorFromWindow(hwnd, MONITOR_DEFAULTTONEAREST);
-    return GetMonitor(hMonitor);
+    return GetMonitor(GetMonitorHandleForWindow(hwnd));
 }
 
 const MonitorInfo* MonitorManager::GetMonitorAtPoint(const POINT& pt) const {
-    HMONITOR hMonitor = MonitorFromPoint(pt, MONITOR_DEFAULTTONEAREST);
-    return GetMonitor(hMonitor);
+    if (m_topology.IsEmpty()) {
+        return GetMonitor(MonitorFromPoint(pt, MONITOR_DEFAULTTONEAREST));
+    }
+    return &m_monitors[m_topology.FromPoint(pt)];
 }
 
 const MonitorInfo* MonitorManager::GetPrimaryMonitor() const {
@@ -191,7 +217,13 @@ HMONITOR MonitorManager::GetMonitorHandleForWindow(HWND hwnd) const {
     if (!hwnd || !IsWindow(hwnd)) {
         return nullptr;
     }
-    return MonitorFromWindow(hwnd, MONITOR_DEFAULTTONEAREST);
+    
+    // Minimized windows keep their monitor, which their parked rect doesn't show
+    RECT windowRect;
+    if (m_topology.IsEmpty() || IsIconic(hwnd) || !GetWindowRect(hwnd, &windowRect)) {
+        return MonitorFromWindow(hwnd, MONITOR_DEFAULTTONEAREST);
+    }
+    return m_topology.Get(m_topology.FromRect(windowRect))->handle;
 }
 
 bool MonitorManager::IsPointOnMonitor(const POINT& pt, HMONITOR hMonitor) const {
@@ -414,6 +446,10 @@ void MonitorManager::CenterWindowOnMonitor(HWND hwnd, HMONITOR hMonitor) {
 }
 
 RECT MonitorManager::GetVirtualScreenBounds() const {
+    if (!m_topology.IsEmpty()) {
+        return m_topology.GetVirtualBounds();
+    }
+    
     RECT virtualScreen;
     virtualScreen.left = GetSystemMetrics(SM_XVIRTUALSCREEN);
     virtualScreen.top = GetSystemMetrics(SM_YVIRTUALSCREEN);
@@ -0,0 +1,137 @@
+#include "../../include/SDK/MonitorTopology.h"
+#include <algorithm>
+
+namespace SDK {
+
+namespace {
+    inline int64_t OverlapArea(const RECT& a, const RECT& b) {
+        int64_t width = (int64_t)(std::min)(a.right, b.right) - (std::max)(a.left, b.left);
+        int64_t height = (int64_t)(std::min)(a.bottom, b.bottom) - (std::max)(a.top, b.top);
+        return (width > 0 && height > 0) ? width * height : 0;
+    }
+
+    inline int64_t DistanceSquared(const RECT& a, const RECT& b) {
+        int64_t dx = (std::max)({(int64_t)0, (int64_t)b.left - a.right, (int64_t)a.left - b.right});
+        int64_t dy = (std::max)({(int64_t)0, (int64_t)b.top - a.bottom, (int64_t)a.top - b.bottom});
+        return dx * dx + dy * dy;
+    }
+}
+
+MonitorTopology::MonitorTopology()
+    : m_virtualBounds{0, 0, 0, 0}
+    , m_version(0)
+{
+}
+
+void MonitorTopology::Build(const std::vector<Monitor>& monitors) {
+    Clear();
+    m_monitors = monitors;
+    m_version++;
+    if (m_monitors.empty()) return;
+
+    m_virtualBounds = m_monitors[0].bounds;
+    m_handles.reserve(m_monitors.size());
+    for (uint32_t i = 0; i < m_monitors.size(); i++) {
+        const RECT& bounds = m_monitors[i].bounds;
+        m_virtualBounds.left = (std::min)(m_virtualBounds.left, bounds.left);
+        m_virtualBounds.top = (std::min)(m_virtualBounds.top, bounds.top);
+        m_virtualBounds.right = (std::max)(m_virtualBounds.right, bounds.right);
+        m_virtualBounds.bottom = (std::max)(m_virtualBounds.bottom, bounds.bottom);
+        m_slabEdges.push_back(bounds.left);
+        m_slabEdges.push_back(bounds.right);
+        m_handles.emplace_back(m_monitors[i].handle, i);
+    }
+    std::sort(m_handles.begin(), m_handles.end());
+    std::sort(m_slabEdges.begin(), m_slabEdges.end());
+    m_slabEdges.erase(std::unique(m_slabEdges.begin(), m_slabEdges.end()), m_slabEdges.end());
+
+    // Every edge is a slab boundary, so a monitor either spans a slab or misses it
+    size_t slabs = m_slabEdges.size() - 1;
+    m_slabStart.reserve(slabs + 1);
+    for (size_t s = 0; s < slabs; s++) {
+        m_slabStart.push_back((uint32_t)m_slabMonitors.size());
+        for (uint32_t i = 0; i < m_monitors.size(); i++) {
+            const RECT& bounds = m_monitors[i].bounds;
+            if (bounds.left <= m_slabEdges[s] && bounds.right >= m_slabEdges[s + 1]) {
+                m_slabMonitors.push_back(i);
+            }
+        }
+        std::sort(m_slabMonitors.begin() + m_slabStart.back(), m_slabMonitors.end(),
+                  [this](uint32_t a, uint32_t b) { return m_monitors[a].bounds.top < m_monitors[b].bounds.top; });
+    }
+    m_slabStart.push_back((uint32_t)m_slabMonitors.size());
+}
+
+void MonitorTopology::Clear() {
+    m_monitors.clear();
+    m_slabEdges.clear();
+    m_slabStart.clear();
+    m_slabMonitors.clear();
+    m_handles.clear();
+    m_virtualBounds = {0, 0, 0, 0};
+}
+
+int MonitorTopology::SlabAt(int x) const {
+    int slab = (int)(std::upper_bound(m_slabEdges.begin(), m_slabEdges.end(), x) - m_slabEdges.begin()) - 1;
+    return (slab >= 0 && slab + 1 < (int)m_slabEdges.size()) ? slab : NOT_FOUND;
+}
+
+int MonitorTopology::FromPoint(const POINT& pt) const {
+    if (m_monitors.empty()) return NOT_FOUND;
+
+    int slab = SlabAt(pt.x);
+    if (slab != NOT_FOUND) {
+        // Monitors don't overlap, so only the last one starting above pt can hold it
+        auto first = m_slabMonitors.begin() + m_slabStart[slab];
+        auto last = m_slabMonitors.begin() + m_slabStart[slab + 1];
+        auto it = std::partition_point(first, last,
+                                       [&](uint32_t i) { return m_monitors[i].bounds.top <= pt.y; });
+        if (it != first && pt.y < m_monitors[*(it - 1)].bounds.bottom) {
+            return (int)*(it - 1);
+        }
+    }
+    return Nearest({pt.x, pt.y, pt.x + 1, pt.y + 1});
+}
+
+int MonitorTopology::FromRect(const RECT& rect) const {
+    if (m_monitors.empty()) return NOT_FOUND;
+
+    int best = NOT_FOUND;
+    int64_t bestArea = 0;
+    int slab = (std::max)(0, (int)(std::upper_bound(m_slabEdges.begin(), m_slabEdges.end(), rect.left) - m_slabEdges.begin()) - 1);
+    for (; slab + 1 < (int)m_slabEdges.size() && m_slabEdges[slab] < rect.right; slab++) {
+        auto first = m_slabMonitors.begin() + m_slabStart[slab];
+        auto last = m_slabMonitors.begin() + m_slabStart[slab + 1];
+        auto it = std::partition_point(first, last,
+                                       [&](uint32_t i) { return m_monitors[i].bounds.bottom <= rect.top; });
+        for (; it != last && m_monitors[*it].bounds.top < rect.bottom; ++it) {
+            int64_t area = OverlapArea(rect, m_monitors[*it].bounds);
+            if (area > bestArea || (area == bestArea && area > 0 && (int)*it < best)) {
+                best = (int)*it;
+                bestArea = area;
+            }
+        }
+    }
+    return best != NOT_FOUND ? best : Nearest(rect);
+}
+
+int MonitorTopology::FromHandle(HMONITOR handle) const {
+    auto it = std::lower_bound(m_handles.begin(), m_handles.end(), std::make_pair(handle, (uint32_t)0));
+    return (it != m_handles.end() && it->first == handle) ? (int)it->second : NOT_FOUND;
+}
+
+int MonitorTopology::Nearest(const RECT& rect) const {
+    // Only reached off every monitor, which is rare enough for a scan
+    int best = NOT_FOUND;
+    int64_t bestDistance = 0;
+    for (size_t i = 0; i < m_monitors.size(); i++) {
+        int64_t distance = DistanceSquared(rect, m_monitors[i].bounds);
+        if (best == NOT_FOUND || distance < bestDistance) {
+            best = (int)i;
+            bestDistance = distance;
+        }
+    }
+    return best;
+}
+
+} // namespace SDK
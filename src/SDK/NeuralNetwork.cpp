@@ -1,18 +1,365 @@
 #include "../../include/SDK/NeuralNetwork.h"
+#include "../../include/SDK/PixelKernels.h"
+#include "../../include/SDK/JobScheduler.h"
+#include "../../include/SDK/Platform.h"
+#include "../../include/SDK/StartupTiming.h"
+#include "../../include/SDK/FrameArena.h"
+#include "../../include/SDK/SharedAssetCache.h"
 #include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <mutex>
 #include <sstream>
 #include <cctype>
 #include <locale>
 
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define SDK_NEURAL_X86 1
+    #include <immintrin.h>
+#else
+    #define SDK_NEURAL_X86 0
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+    #define SDK_NEURAL_NEON 1
+    #include <arm_neon.h>
+#else
+    #define SDK_NEURAL_NEON 0
+#endif
+
+#if !SDK_PLATFORM_WINDOWS
+    #include <filesystem>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#if SDK_NEURAL_X86 && (defined(__GNUC__) || defined(__clang__))
+    #define SDK_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+    #define SDK_TARGET_AVX2
+#endif
+
 namespace SDK {
 
+namespace {
+    // Dot products and y += scale * x over contiguous rows. The vector kernels
+    // sum in a different order from the scalar one, so results can differ in
+    // the last bits; batched and single inference use the same kernel.
+    float DotScalar(const float* a, const float* b, int count) {
+        float sum = 0.0f;
+        for (int i = 0; i < count; i++) {
+            sum += a[i] * b[i];
+        }
+        return sum;
+    }
+
+    void AxpyScalar(float* y, const float* x, float scale, int count) {
+        for (int i = 0; i < count; i++) {
+            y[i] += scale * x[i];
+        }
+    }
+
+    // Int8 dot products accumulate exactly in int32, so every kernel agrees
+    int32_t DotInt8Scalar(const int8_t* a, const int8_t* b, int count) {
+        int32_t sum = 0;
+        for (int i = 0; i < count; i++) {
+            sum += (int32_t)a[i] * b[i];
+        }
+        return sum;
+    }
+
+#if SDK_NEURAL_X86
+    float DotSSE2(const float* a, const float* b, int count) {
+        __m128 sum = _mm_setzero_ps();
+        int i = 0;
+        for (; i + 4 <= count; i += 4) {
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        }
+        float lanes[4];
+        _mm_storeu_ps(lanes, sum);
+        return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + DotScalar(a + i, b + i, count - i);
+    }
+
+    void AxpySSE2(float* y, const float* x, float scale, int count) {
+        __m128 factor = _mm_set1_ps(scale);
+        int i = 0;
+        for (; i + 4 <= count; i += 4) {
+            _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(factor, _mm_loadu_ps(x + i))));
+        }
+        AxpyScalar(y + i, x + i, scale, count - i);
+    }
+
+    int32_t DotInt8SSE2(const int8_t* a, const int8_t* b, int count) {
+        __m128i sum = _mm_setzero_si128();
+        int i = 0;
+        for (; i + 16 <= count; i += 16) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+            // SSE2 has no byte sign extension: put each byte in both halves of
+            // a 16-bit lane and shift it down arithmetically
+            __m128i xLow = _mm_srai_epi16(_mm_unpacklo_epi8(x, x), 8);
+            __m128i xHigh = _mm_srai_epi16(_mm_unpackhi_epi8(x, x), 8);
+            __m128i yLow = _mm_srai_epi16(_mm_unpacklo_epi8(y, y), 8);
+            __m128i yHigh = _mm_srai_epi16(_mm_unpackhi_epi8(y, y), 8);
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(xLow, yLow));
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(xHigh, yHigh));
+        }
+        int32_t lanes[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), sum);
+        return lanes[0] + lanes[1] + lanes[2] + lanes[3] + DotInt8Scalar(a + i, b + i, count - i);
+    }
+
+    SDK_TARGET_AVX2 float DotAVX2(const float* a, const float* b, int count) {
+        __m256 sum = _mm256_setzero_ps();
+        int i = 0;
+        for (; i + 8 <= count; i += 8) {
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+        }
+        __m128 half = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+        float lanes[4];
+        _mm_storeu_ps(lanes, half);
+        return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + DotScalar(a + i, b + i, count - i);
+    }
+
+    SDK_TARGET_AVX2 void AxpyAVX2(float* y, const float* x, float scale, int count) {
+        __m256 factor = _mm256_set1_ps(scale);
+        int i = 0;
+        for (; i + 8 <= count; i += 8) {
+            _mm256_storeu_ps(y + i, _mm256_add_ps(_mm256_loadu_ps(y + i), _mm256_mul_ps(factor, _mm256_loadu_ps(x + i))));
+        }
+        AxpyScalar(y + i, x + i, scale, count - i);
+    }
+
+    SDK_TARGET_AVX2 int32_t DotInt8AVX2(const int8_t* a, const int8_t* b, int count) {
+        __m256i sum = _mm256_setzero_si256();
+        int i = 0;
+        for (; i + 16 <= count; i += 16) {
+            __m256i x = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+            __m256i y = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(x, y));
+        }
+        __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+        int32_t lanes[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), half);
+        return lanes[0] + lanes[1] + lanes[2] + lanes[3] + DotInt8Scalar(a + i, b + i, count - i);
+    }
+#endif
+
+#if SDK_NEURAL_NEON
+    float DotNEON(const float* a, const float* b, int count) {
+        float32x4_t sum = vdupq_n_f32(0.0f);
+        int i = 0;
+        for (; i + 4 <= count; i += 4) {
+            sum = vmlaq_f32(sum, vld1q_f32(a + i), vld1q_f32(b + i));
+        }
+        float lanes[4];
+        vst1q_f32(lanes, sum);
+        return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + DotScalar(a + i, b + i, count - i);
+    }
+
+    void AxpyNEON(float* y, const float* x, float scale, int count) {
+        float32x4_t factor = vdupq_n_f32(scale);
+        int i = 0;
+        for (; i + 4 <= count; i += 4) {
+            vst1q_f32(y + i, vmlaq_f32(vld1q_f32(y + i), factor, vld1q_f32(x + i)));
+        }
+        AxpyScalar(y + i, x + i, scale, count - i);
+    }
+
+    int32_t DotInt8NEON(const int8_t* a, const int8_t* b, int count) {
+        int32x4_t sum = vdupq_n_s32(0);
+        int i = 0;
+        for (; i + 16 <= count; i += 16) {
+            int8x16_t x = vld1q_s8(a + i);
+            int8x16_t y = vld1q_s8(b + i);
+            sum = vpadalq_s16(sum, vmull_s8(vget_low_s8(x), vget_low_s8(y)));
+            sum = vpadalq_s16(sum, vmull_s8(vget_high_s8(x), vget_high_s8(y)));
+        }
+        int32_t lanes[4];
+        vst1q_s32(lanes, sum);
+        return lanes[0] + lanes[1] + lanes[2] + lanes[3] + DotInt8Scalar(a + i, b + i, count - i);
+    }
+#endif
+
+    struct Kernels {
+        float (*dot)(const float*, const float*, int);
+        void (*axpy)(float*, const float*, float, int);
+        int32_t (*dotInt8)(const int8_t*, const int8_t*, int);
+    };
+
+    // Follows the instruction set PixelKernels dispatches on
+    Kernels GetKernels() {
+        PixelKernels::InstructionSet set = PixelKernels::GetActiveInstructionSet();
+#if SDK_NEURAL_X86
+        if (set == PixelKernels::InstructionSet::AVX2) return Kernels{ DotAVX2, AxpyAVX2, DotInt8AVX2 };
+        if (set == PixelKernels::InstructionSet::SSE2) return Kernels{ DotSSE2, AxpySSE2, DotInt8SSE2 };
+#endif
+#if SDK_NEURAL_NEON
+        if (set == PixelKernels::InstructionSet::NEON) return Kernels{ DotNEON, AxpyNEON, DotInt8NEON };
+#endif
+        (void)set;
+        return Kernels{ DotScalar, AxpyScalar, DotInt8Scalar };
+    }
+
+    // Symmetric int8 over [-127, 127]; returns the scale, value = scale * q
+    float QuantizeValues(const float* values, int count, int8_t* out) {
+        float maxAbs = 0.0f;
+        for (int i = 0; i < count; i++) {
+            maxAbs = std::max(maxAbs, std::fabs(values[i]));
+        }
+        if (maxAbs == 0.0f) {
+            std::fill(out, out + count, (int8_t)0);
+            return 0.0f;
+        }
+        
+        float inverse = 127.0f / maxAbs;
+        for (int i = 0; i < count; i++) {
+            out[i] = (int8_t)std::lround(values[i] * inverse);
+        }
+        return maxAbs / 127.0f;
+    }
+
+    constexpr int PaddedInt8Size(int count) { return (count + 31) / 32 * 32; }
+
+    // Each training task sums the gradient of this many samples into its own
+    // buffer. The buffers are added in order afterwards, so the weights don't
+    // depend on which worker ran what.
+    constexpr int GRADIENT_CHUNK_SIZE = 16;
+
+    struct GradientChunk {
+        std::vector<float> weights;
+        std::vector<float> biases;
+        float loss = 0.0f;
+    };
+
+    // ==================== Model files ====================
+    // A fixed header, then the float sections (32-byte aligned, rows padded
+    // exactly as in memory), then the string tables. Strings are a uint32
+    // length and that many uint32 code units, whatever wchar_t's width.
+
+    constexpr uint32_t MODEL_MAGIC = 0x4E4E4435;  // "5DNN" little-endian
+
+    struct ModelHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t embeddingDim;
+        uint32_t hiddenSize;
+        uint32_t outputSize;
+        uint32_t embeddingRows;
+        uint32_t vocabularyCount;
+        uint32_t keywordCount;
+        uint32_t patternCount;
+        uint32_t reserved;
+        uint64_t fileSize;
+
+        // Byte offsets from the start of the file
+        uint64_t embeddings;
+        uint64_t hiddenWeights;
+        uint64_t hiddenBiases;
+        uint64_t outputWeights;
+        uint64_t outputBiases;
+        uint64_t strings;
+    };
+
+    class ModelWriter {
+    public:
+        std::vector<uint8_t> bytes;
+
+        uint64_t AppendFloats(const float* values, size_t count) {
+            bytes.resize((bytes.size() + 31) / 32 * 32, 0);
+            uint64_t offset = bytes.size();
+            Append(values, count * sizeof(float));
+            return offset;
+        }
+        void AppendU32(uint32_t value) { Append(&value, sizeof(value)); }
+        void AppendString(std::wstring_view text) {
+            AppendU32((uint32_t)text.size());
+            for (wchar_t c : text) {
+                AppendU32((uint32_t)c);
+            }
+        }
+
+    private:
+        void Append(const void* data, size_t size) {
+            const uint8_t* in = static_cast<const uint8_t*>(data);
+            bytes.insert(bytes.end(), in, in + size);
+        }
+    };
+
+    // Bounds-checked reads; after any failure IsOk() is false and reads return zero
+    class ModelReader {
+    public:
+        ModelReader(const uint8_t* data, size_t size, uint64_t position)
+            : m_data(data), m_size(size), m_position((size_t)std::min<uint64_t>(position, size)), m_ok(position <= size) {}
+
+        bool IsOk() const { return m_ok; }
+
+        uint32_t ReadU32() {
+            uint32_t value = 0;
+            if (!Has(sizeof(value))) return 0;
+            std::memcpy(&value, m_data + m_position, sizeof(value));
+            m_position += sizeof(value);
+            return value;
+        }
+
+        std::wstring ReadString() {
+            uint32_t length = ReadU32();
+            std::wstring text;
+            if (!m_ok || length > (m_size - m_position) / sizeof(uint32_t)) {
+                m_ok = false;
+                return text;
+            }
+            text.resize(length);
+            for (uint32_t i = 0; i < length; i++) {
+                text[i] = (wchar_t)ReadU32();
+            }
+            return text;
+        }
+
+    private:
+        bool Has(size_t count) {
+            m_ok = m_ok && count <= m_size - m_position;
+            return m_ok;
+        }
+
+        const uint8_t* m_data;
+        size_t m_size;
+        size_t m_position;
+        bool m_ok;
+    };
+
+    bool ReadFloats(const uint8_t* data, size_t size, uint64_t offset, float* out, size_t count) {
+        size_t bytes = count * sizeof(float);
+        if (offset > size || bytes > size - offset) return false;
+        std::memcpy(out, data + offset, bytes);
+        return true;
+    }
+
+    std::mutex g_sharedMutex;
+    std::shared_ptr<const NeuralNetwork> g_shared;
+    std::wstring g_sharedPath;
+    constexpr const char* SHARED_MODEL_KEY = "NeuralNetwork";
+    NeuralNetwork::Precision g_sharedPrecision = NeuralNetwork::Precision::FLOAT32;
+    
+    // FNV-1a over the UTF-16/UTF-32 code units
+    uint32_t HashWord(std::wstring_view word) {
+        uint32_t hash = 2166136261u;
+        for (wchar_t ch : word) {
+            hash = (hash ^ (uint32_t)ch) * 16777619u;
+        }
+        return hash;
+    }
+}
+
 /**
  * Helper function to check if a wide string consists only of numeric digits.
  * Used throughout the entity extraction logic to validate numeric tokens.
  * @param str The wide string to check
  * @return true if the string is non-empty and contains only digits, false otherwise
  */
-static bool IsAllDigits(const std::wstring& str) {
+static bool IsAllDigits(std::wstring_view str) {
     return !str.empty() && std::all_of(str.begin(), str.end(), [](wchar_t c) { return std::iswdigit(c); });
 }
 
@@ -240,10 +587,12 @@ int NeuralNetwork::ParsedPrompt::GetCount() const {
 }
 
 NeuralNetwork::NeuralNetwork() 
-    : m_rng(std::random_device{}()) {
+    : m_rng(std::random_device{}())
+    , m_memorySource("NeuralNetwork", [this]() { return GetMemoryBytes(); }) {
 }
 
 void NeuralNetwork::Initialize() {
+    DropQuantized();
     InitializeVocabulary();
     InitializeWeights();
     InitializePatterns();
@@ -362,26 +711,90 @@ void NeuralNetwork::InitializeVocabulary() {
     }
     
     // Build vocabulary map and embeddings
-    m_vocabulary.clear();
-    m_embeddings.clear();
+    m_vocabulary.Clear();
+    m_embeddings.Resize(static_cast<int>(words.size()) + 1, EMBEDDING_DIM);
     
     std::uniform_real_distribution<float> dist(-0.1f, 0.1f);
     
     for (size_t i = 0; i < words.size(); i++) {
-        m_vocabulary[words[i]] = static_cast<int>(i);
+        m_vocabulary.Insert(words[i], static_cast<int>(i));
         
         // Create random embedding for each word
-        std::vector<float> embedding(EMBEDDING_DIM);
+        float* embedding = m_embeddings.Row(static_cast<int>(i));
         for (int j = 0; j < EMBEDDING_DIM; j++) {
             embedding[j] = dist(m_rng);
         }
-        m_embeddings.push_back(embedding);
     }
     
-    // Add unknown token
-    m_vocabulary[L"<UNK>"] = static_cast<int>(words.size());
-    std::vector<float> unkEmbedding(EMBEDDING_DIM, 0.0f);
-    m_embeddings.push_back(unkEmbedding);
+    // Add unknown token; its row stays zero
+    m_vocabulary.Insert(L"<UNK>", static_cast<int>(words.size()));
+}
+
+void NeuralNetwork::Matrix::Resize(int rowCount, int colCount) {
+    rows = rowCount;
+    cols = colCount;
+    stride = PaddedSize(colCount);
+    data.assign((size_t)rows * stride, 0.0f);
+}
+
+template <typename Value>
+void NeuralNetwork::WordTable<Value>::Clear() {
+    m_keys.clear();
+    m_entries.clear();
+    m_slots.clear();
+}
+
+template <typename Value>
+void NeuralNetwork::WordTable<Value>::Grow() {
+    std::vector<Slot> slots(std::max<size_t>(16, m_slots.size() * 2), Slot{0, 0});
+    size_t mask = slots.size() - 1;
+    for (const Slot& slot : m_slots) {
+        if (slot.entry == 0) continue;
+        size_t index = slot.hash & mask;
+        while (slots[index].entry != 0) {
+            index = (index + 1) & mask;
+        }
+        slots[index] = slot;
+    }
+    m_slots.swap(slots);
+}
+
+template <typename Value>
+void NeuralNetwork::WordTable<Value>::Insert(std::wstring_view word, Value value) {
+    if ((m_entries.size() + 1) * 2 > m_slots.size()) {
+        Grow();
+    }
+    
+    uint32_t hash = HashWord(word);
+    size_t mask = m_slots.size() - 1;
+    size_t index = hash & mask;
+    while (m_slots[index].entry != 0) {
+        Entry& entry = m_entries[m_slots[index].entry - 1];
+        if (m_slots[index].hash == hash && Key(entry) == word) {
+            entry.value = std::move(value);
+            return;
+        }
+        index = (index + 1) & mask;
+    }
+    
+    m_entries.push_back(Entry{(uint32_t)m_keys.size(), (uint32_t)word.size(), std::move(value)});
+    m_keys.append(word.data(), word.size());
+    m_slots[index] = Slot{hash, (uint32_t)m_entries.size()};
+}
+
+template <typename Value>
+const Value* NeuralNetwork::WordTable<Value>::Find(std::wstring_view word) const {
+    if (m_slots.empty()) return nullptr;
+    
+    uint32_t hash = HashWord(word);
+    size_t mask = m_slots.size() - 1;
+    for (size_t index = hash & mask; m_slots[index].entry != 0; index = (index + 1) & mask) {
+        const Entry& entry = m_entries[m_slots[index].entry - 1];
+        if (m_slots[index].hash == hash && Key(entry) == word) {
+            return &entry.value;
+        }
+    }
+    return nullptr;
 }
 
 void NeuralNetwork::InitializeWeights() {
@@ -391,15 +804,13 @@ void NeuralNetwork::InitializeWeights() {
     
     // Input layer to hidden layer
     Layer hidden;
-    hidden.weights.resize(HIDDEN_LAYER_SIZE);
+    hidden.weights.Resize(HIDDEN_LAYER_SIZE, EMBEDDING_DIM);
     hidden.biases.resize(HIDDEN_LAYER_SIZE);
-    hidden.activations.resize(HIDDEN_LAYER_SIZE);
-    hidden.deltas.resize(HIDDEN_LAYER_SIZE);
     
     for (int i = 0; i < HIDDEN_LAYER_SIZE; i++) {
-        hidden.weights[i].resize(EMBEDDING_DIM);
+        float* row = hidden.weights.Row(i);
         for (int j = 0; j < EMBEDDING_DIM; j++) {
-            hidden.weights[i][j] = dist(m_rng);
+            row[j] = dist(m_rng);
         }
         hidden.biases[i] = dist(m_rng);
     }
@@ -407,15 +818,13 @@ void NeuralNetwork::InitializeWeights() {
     
     // Hidden layer to output layer
     Layer output;
-    output.weights.resize(OUTPUT_SIZE);
+    output.weights.Resize(OUTPUT_SIZE, HIDDEN_LAYER_SIZE);
     output.biases.resize(OUTPUT_SIZE);
-    output.activations.resize(OUTPUT_SIZE);
-    output.deltas.resize(OUTPUT_SIZE);
     
     for (int i = 0; i < OUTPUT_SIZE; i++) {
-        output.weights[i].resize(HIDDEN_LAYER_SIZE);
+        float* row = output.weights.Row(i);
         for (int j = 0; j < HIDDEN_LAYER_SIZE; j++) {
-            output.weights[i][j] = dist(m_rng);
+            row[j] = dist(m_rng);
         }
         output.biases[i] = dist(m_rng);
     }
@@ -424,143 +833,157 @@ void NeuralNetwork::InitializeWeights() {
 
 void NeuralNetwork::InitializePatterns() {
     // Initialize intent keywords with enhanced widget support
-    m_intentKeywords[L"window"] = Intent::CREATE_WINDOW;
-    m_intentKeywords[L"dialog"] = Intent::CREATE_WINDOW;
-    m_intentKeywords[L"frame"] = Intent::CREATE_WINDOW;
-    m_intentKeywords[L"form"] = Intent::CREATE_WINDOW;
-    m_intentKeywords[L"screen"] = Intent::CREATE_WINDOW;
-    m_intentKeywords[L"page"] = Intent::CREATE_WINDOW;
-    
-    m_intentKeywords[L"button"] = Intent::ADD_BUTTON;
-    m_intentKeywords[L"btn"] = Intent::ADD_BUTTON;
-    
-    m_intentKeywords[L"label"] = Intent::ADD_LABEL;
-    m_intentKeywords[L"caption"] = Intent::ADD_LABEL;
-    m_intentKeywords[L"heading"] = Intent::ADD_LABEL;
-    
-    m_intentKeywords[L"textbox"] = Intent::ADD_TEXTBOX;
-    m_intentKeywords[L"input"] = Intent::ADD_TEXTBOX;
-    m_intentKeywords[L"field"] = Intent::ADD_TEXTBOX;
-    m_intentKeywords[L"text"] = Intent::ADD_TEXTBOX;
-    m_intentKeywords[L"entry"] = Intent::ADD_TEXTBOX;
-    
-    m_intentKeywords[L"checkbox"] = Intent::ADD_CHECKBOX;
-    m_intentKeywords[L"check"] = Intent::ADD_CHECKBOX;
-    
-    m_intentKeywords[L"progressbar"] = Intent::ADD_PROGRESSBAR;
-    m_intentKeywords[L"progress"] = Intent::ADD_PROGRESSBAR;
-    m_intentKeywords[L"indicator"] = Intent::ADD_PROGRESSBAR;
-    m_intentKeywords[L"gauge"] = Intent::ADD_PROGRESSBAR;
-    
-    m_intentKeywords[L"tooltip"] = Intent::ADD_TOOLTIP;
-    m_intentKeywords[L"tip"] = Intent::ADD_TOOLTIP;
-    m_intentKeywords[L"hint"] = Intent::ADD_TOOLTIP;
-    m_intentKeywords[L"helptext"] = Intent::ADD_TOOLTIP;
+    m_intentKeywords.Insert(L"window", Intent::CREATE_WINDOW);
+    m_intentKeywords.Insert(L"dialog", Intent::CREATE_WINDOW);
+    m_intentKeywords.Insert(L"frame", Intent::CREATE_WINDOW);
+    m_intentKeywords.Insert(L"form", Intent::CREATE_WINDOW);
+    m_intentKeywords.Insert(L"screen", Intent::CREATE_WINDOW);
+    m_intentKeywords.Insert(L"page", Intent::CREATE_WINDOW);
+    
+    m_intentKeywords.Insert(L"button", Intent::ADD_BUTTON);
+    m_intentKeywords.Insert(L"btn", Intent::ADD_BUTTON);
+    
+    m_intentKeywords.Insert(L"label", Intent::ADD_LABEL);
+    m_intentKeywords.Insert(L"caption", Intent::ADD_LABEL);
+    m_intentKeywords.Insert(L"heading", Intent::ADD_LABEL);
+    
+    m_intentKeywords.Insert(L"textbox", Intent::ADD_TEXTBOX);
+    m_intentKeywords.Insert(L"input", Intent::ADD_TEXTBOX);
+    m_intentKeywords.Insert(L"field", Intent::ADD_TEXTBOX);
+    m_intentKeywords.Insert(L"text", Intent::ADD_TEXTBOX);
+    m_intentKeywords.Insert(L"entry", Intent::ADD_TEXTBOX);
+    
+    m_intentKeywords.Insert(L"checkbox", Intent::ADD_CHECKBOX);
+    m_intentKeywords.Insert(L"check", Intent::ADD_CHECKBOX);
+    
+    m_intentKeywords.Insert(L"progressbar", Intent::ADD_PROGRESSBAR);
+    m_intentKeywords.Insert(L"progress", Intent::ADD_PROGRESSBAR);
+    m_intentKeywords.Insert(L"indicator", Intent::ADD_PROGRESSBAR);
+    m_intentKeywords.Insert(L"gauge", Intent::ADD_PROGRESSBAR);
+    
+    m_intentKeywords.Insert(L"tooltip", Intent::ADD_TOOLTIP);
+    m_intentKeywords.Insert(L"tip", Intent::ADD_TOOLTIP);
+    m_intentKeywords.Insert(L"hint", Intent::ADD_TOOLTIP);
+    m_intentKeywords.Insert(L"helptext", Intent::ADD_TOOLTIP);
     
     // Advanced widgets
-    m_intentKeywords[L"slider"] = Intent::ADD_SLIDER;
-    m_intentKeywords[L"trackbar"] = Intent::ADD_SLIDER;
-    m_intentKeywords[L"range"] = Intent::ADD_SLIDER;
+    m_intentKeywords.Insert(L"slider", Intent::ADD_SLIDER);
+    m_intentKeywords.Insert(L"trackbar", Intent::ADD_SLIDER);
+    m_intentKeywords.Insert(L"range", Intent::ADD_SLIDER);
     
-    m_intentKeywords[L"combobox"] = Intent::ADD_COMBOBOX;
-    m_intentKeywords[L"combo"] = Intent::ADD_COMBOBOX;
-    m_intentKeywords[L"dropdown"] = Intent::ADD_COMBOBOX;
-    m_intentKeywords[L"picker"] = Intent::ADD_COMBOBOX;
+    m_intentKeywords.Insert(L"combobox", Intent::ADD_COMBOBOX);
+    m_intentKeywords.Insert(L"combo", Intent::ADD_COMBOBOX);
+    m_intentKeywords.Insert(L"dropdown", Intent::ADD_COMBOBOX);
+    m_intentKeywords.Insert(L"picker", Intent::ADD_COMBOBOX);
     
-    m_intentKeywords[L"listbox"] = Intent::ADD_LISTBOX;
-    m_intentKeywords[L"list"] = Intent::ADD_LISTBOX;
+    m_intentKeywords.Insert(L"listbox", Intent::ADD_LISTBOX);
+    m_intentKeywords.Insert(L"list", Intent::ADD_LISTBOX);
     
-    m_intentKeywords[L"listview"] = Intent::ADD_LISTVIEW;
+    m_intentKeywords.Insert(L"listview", Intent::ADD_LISTVIEW);
     
-    m_intentKeywords[L"radiobutton"] = Intent::ADD_RADIOBUTTON;
-    m_intentKeywords[L"radio"] = Intent::ADD_RADIOBUTTON;
-    m_intentKeywords[L"option"] = Intent::ADD_RADIOBUTTON;
+    m_intentKeywords.Insert(L"radiobutton", Intent::ADD_RADIOBUTTON);
+    m_intentKeywords.Insert(L"radio", Intent::ADD_RADIOBUTTON);
+    m_intentKeywords.Insert(L"option", Intent::ADD_RADIOBUTTON);
     
-    m_intentKeywords[L"spinbox"] = Intent::ADD_SPINBOX;
-    m_intentKeywords[L"spin"] = Intent::ADD_SPINBOX;
-    m_intentKeywords[L"stepper"] = Intent::ADD_SPINBOX;
-    m_intentKeywords[L"counter"] = Intent::ADD_SPINBOX;
+    m_intentKeywords.Insert(L"spinbox", Intent::ADD_SPINBOX);
+    m_intentKeywords.Insert(L"spin", Intent::ADD_SPINBOX);
+    m_intentKeywords.Insert(L"stepper", Intent::ADD_SPINBOX);
+    m_intentKeywords.Insert(L"counter", Intent::ADD_SPINBOX);
     
-    m_intentKeywords[L"image"] = Intent::ADD_IMAGE;
-    m_intentKeywords[L"picture"] = Intent::ADD_IMAGE;
-    m_intentKeywords[L"photo"] = Intent::ADD_IMAGE;
-    m_intentKeywords[L"graphic"] = Intent::ADD_IMAGE;
+    m_intentKeywords.Insert(L"image", Intent::ADD_IMAGE);
+    m_intentKeywords.Insert(L"picture", Intent::ADD_IMAGE);
+    m_intentKeywords.Insert(L"photo", Intent::ADD_IMAGE);
+    m_intentKeywords.Insert(L"graphic", Intent::ADD_IMAGE);
     
-    m_intentKeywords[L"separator"] = Intent::ADD_SEPARATOR;
-    m_intentKeywords[L"divider"] = Intent::ADD_SEPARATOR;
-    m_intentKeywords[L"hr"] = Intent::ADD_SEPARATOR;
+    m_intentKeywords.Insert(L"separator", Intent::ADD_SEPARATOR);
+    m_intentKeywords.Insert(L"divider", Intent::ADD_SEPARATOR);
+    m_intentKeywords.Insert(L"hr", Intent::ADD_SEPARATOR);
     
-    m_intentKeywords[L"panel"] = Intent::ADD_PANEL;
-    m_intentKeywords[L"container"] = Intent::ADD_PANEL;
-    m_intentKeywords[L"section"] = Intent::ADD_PANEL;
+    m_intentKeywords.Insert(L"panel", Intent::ADD_PANEL);
+    m_intentKeywords.Insert(L"container", Intent::ADD_PANEL);
+    m_intentKeywords.Insert(L"section", Intent::ADD_PANEL);
     
-    m_intentKeywords[L"tabcontrol"] = Intent::ADD_TABCONTROL;
-    m_intentKeywords[L"tabs"] = Intent::ADD_TABCONTROL;
-    m_intentKeywords[L"notebook"] = Intent::ADD_TABCONTROL;
+    m_intentKeywords.Insert(L"tabcontrol", Intent::ADD_TABCONTROL);
+    m_intentKeywords.Insert(L"tabs", Intent::ADD_TABCONTROL);
+    m_intentKeywords.Insert(L"notebook", Intent::ADD_TABCONTROL);
     
-    m_intentKeywords[L"toolbar"] = Intent::ADD_TOOLBAR;
-    m_intentKeywords[L"menubar"] = Intent::ADD_TOOLBAR;
+    m_intentKeywords.Insert(L"toolbar", Intent::ADD_TOOLBAR);
+    m_intentKeywords.Insert(L"menubar", Intent::ADD_TOOLBAR);
     
-    m_intentKeywords[L"callback"] = Intent::SET_CALLBACK;
-    m_intentKeywords[L"handler"] = Intent::SET_CALLBACK;
-    m_intentKeywords[L"event"] = Intent::SET_CALLBACK;
-    m_intentKeywords[L"listener"] = Intent::SET_CALLBACK;
+    m_intentKeywords.Insert(L"callback", Intent::SET_CALLBACK);
+    m_intentKeywords.Insert(L"handler", Intent::SET_CALLBACK);
+    m_intentKeywords.Insert(L"event", Intent::SET_CALLBACK);
+    m_intentKeywords.Insert(L"listener", Intent::SET_CALLBACK);
     
-    m_intentKeywords[L"theme"] = Intent::SET_THEME;
-    m_intentKeywords[L"style"] = Intent::SET_THEME;
-    m_intentKeywords[L"appearance"] = Intent::SET_THEME;
+    m_intentKeywords.Insert(L"theme", Intent::SET_THEME);
+    m_intentKeywords.Insert(L"style", Intent::SET_THEME);
+    m_intentKeywords.Insert(L"appearance", Intent::SET_THEME);
     
     // Layout keywords
-    m_intentKeywords[L"layout"] = Intent::SET_LAYOUT;
-    m_intentKeywords[L"arrange"] = Intent::SET_LAYOUT;
-    m_intentKeywords[L"organize"] = Intent::SET_LAYOUT;
-}
-
-std::vector<std::wstring> NeuralNetwork::Tokenize(const std::wstring& text) {
-    std::vector<std::wstring> tokens;
-    std::wstring current;
-    
-    for (wchar_t ch : text) {
-        if (std::isspace(ch) || ch == L',' || ch == L'.' || ch == L'!' || ch == L'?') {
-            if (!current.empty()) {
-                // Convert to lowercase
-                std::transform(current.begin(), current.end(), current.begin(), ::towlower);
-                tokens.push_back(current);
-                current.clear();
-            }
+    m_intentKeywords.Insert(L"layout", Intent::SET_LAYOUT);
+    m_intentKeywords.Insert(L"arrange", Intent::SET_LAYOUT);
+    m_intentKeywords.Insert(L"organize", Intent::SET_LAYOUT);
+}
+
+void NeuralNetwork::Tokenize(const std::wstring& text, TokenList& out) {
+    out.lower.assign(text);
+    std::transform(out.lower.begin(), out.lower.end(), out.lower.begin(), ::towlower);
+    
+    // Tokens never hold more characters than the prompt, so reserving its
+    // length keeps text from moving under the views
+    out.text.clear();
+    out.text.reserve(text.size());
+    out.tokens.clear();
+    
+    size_t start = 0;        // Where the current token begins in out.text
+    bool allDigits = true;   // Whether the current token is digits only
+    auto endToken = [&]() {
+        if (out.text.size() > start) {
+            out.tokens.emplace_back(out.text.data() + start, out.text.size() - start);
+        }
+        start = out.text.size();
+        allDigits = true;
+    };
+    
+    for (size_t i = 0; i < text.size(); i++) {
+        wchar_t ch = text[i];
+        if (std::iswspace(ch) || ch == L',' || ch == L'.' || ch == L'!' || ch == L'?') {
+            endToken();
         } else if (ch == L'\'') {
             // Skip quotes
             continue;
-        } else if (ch == L'x' && !current.empty() && IsAllDigits(current)) {
+        } else if (ch == L'x' && out.text.size() > start && allDigits) {
             // Handle dimension patterns like "800x600"
-            tokens.push_back(current);
-            current = L"x";
+            endToken();
+            out.text += L'x';
+            allDigits = false;
         } else {
-            current += ch;
+            out.text += out.lower[i];
+            allDigits = allDigits && std::iswdigit(ch);
         }
     }
-    
-    if (!current.empty()) {
-        std::transform(current.begin(), current.end(), current.begin(), ::towlower);
-        tokens.push_back(current);
-    }
-    
-    return tokens;
+    endToken();
 }
 
-std::vector<float> NeuralNetwork::TextToEmbedding(const std::wstring& text) {
-    auto tokens = Tokenize(text);
+void NeuralNetwork::TextToEmbedding(const TokenList& tokens, float* embedding, Precision precision) const {
+    Kernels kernels = GetKernels();
     
     // Average word embeddings
-    std::vector<float> embedding(EMBEDDING_DIM, 0.0f);
+    std::fill(embedding, embedding + EMBEDDING_DIM, 0.0f);
     int count = 0;
     
-    for (const auto& token : tokens) {
-        auto it = m_vocabulary.find(token);
-        int idx = (it != m_vocabulary.end()) ? it->second : m_vocabulary[L"<UNK>"];
-        
-        for (int i = 0; i < EMBEDDING_DIM; i++) {
-            embedding[i] += m_embeddings[idx][i];
+    // Unknown words count toward the average with <UNK>'s zero embedding
+    for (std::wstring_view token : tokens.tokens) {
+        if (const int* index = m_vocabulary.Find(token)) {
+            if (precision == Precision::INT8) {
+                const int8_t* row = m_quantizedEmbeddings.Row(*index);
+                float scale = m_quantizedEmbeddings.scales[*index];
+                for (int i = 0; i < EMBEDDING_DIM; i++) {
+                    embedding[i] += scale * row[i];
+                }
+            } else {
+                kernels.axpy(embedding, m_embeddings.Row(*index), 1.0f, EMBEDDING_DIM);
+            }
         }
         count++;
     }
@@ -571,8 +994,6 @@ std::vector<float> NeuralNetwork::TextToEmbedding(const std::wstring& text) {
             embedding[i] /= count;
         }
     }
-    
-    return embedding;
 }
 
 float NeuralNetwork::Sigmoid(float x) {
@@ -592,64 +1013,206 @@ float NeuralNetwork::ReLUDerivative(float x) {
     return x > 0.0f ? 1.0f : 0.0f;
 }
 
-std::vector<float> NeuralNetwork::Forward(const std::vector<float>& input) {
+void NeuralNetwork::ForwardSample(const float* input, float* hidden, float* output) const {
+    Kernels kernels = GetKernels();
+    const Layer& hiddenLayer = m_layers[0];
+    const Layer& outputLayer = m_layers[1];
+    
     // Input to hidden
     for (int i = 0; i < HIDDEN_LAYER_SIZE; i++) {
-        float sum = m_layers[0].biases[i];
-        for (size_t j = 0; j < input.size(); j++) {
-            sum += m_layers[0].weights[i][j] * input[j];
-        }
-        m_layers[0].activations[i] = ReLU(sum);
+        hidden[i] = ReLU(hiddenLayer.biases[i] + kernels.dot(hiddenLayer.weights.Row(i), input, EMBEDDING_DIM));
     }
     
     // Hidden to output
     for (int i = 0; i < OUTPUT_SIZE; i++) {
-        float sum = m_layers[1].biases[i];
-        for (int j = 0; j < HIDDEN_LAYER_SIZE; j++) {
-            sum += m_layers[1].weights[i][j] * m_layers[0].activations[j];
-        }
-        m_layers[1].activations[i] = Sigmoid(sum);
+        output[i] = Sigmoid(outputLayer.biases[i] + kernels.dot(outputLayer.weights.Row(i), hidden, HIDDEN_LAYER_SIZE));
     }
-    
-    return m_layers[1].activations;
 }
 
-void NeuralNetwork::Backward(const std::vector<float>& target) {
-    // Calculate output layer deltas
+void NeuralNetwork::ForwardSampleInt8(const float* input, float* hidden, float* output) const {
+    Kernels kernels = GetKernels();
+    const Layer& hiddenLayer = m_layers[0];
+    const Layer& outputLayer = m_layers[1];
+    alignas(SIMD_ALIGNMENT) int8_t quantized[PaddedInt8Size(std::max(EMBEDDING_DIM, HIDDEN_LAYER_SIZE))];
+    
+    // Input to hidden
+    float inputScale = QuantizeValues(input, EMBEDDING_DIM, quantized);
+    for (int i = 0; i < HIDDEN_LAYER_SIZE; i++) {
+        int32_t sum = kernels.dotInt8(m_quantizedHidden.Row(i), quantized, EMBEDDING_DIM);
+        hidden[i] = ReLU(hiddenLayer.biases[i] + sum * (m_quantizedHidden.scales[i] * inputScale));
+    }
+    
+    // Hidden to output
+    float hiddenScale = QuantizeValues(hidden, HIDDEN_LAYER_SIZE, quantized);
     for (int i = 0; i < OUTPUT_SIZE; i++) {
-        float error = target[i] - m_layers[1].activations[i];
-        m_layers[1].deltas[i] = error * SigmoidDerivative(m_layers[1].activations[i]);
+        int32_t sum = kernels.dotInt8(m_quantizedOutput.Row(i), quantized, HIDDEN_LAYER_SIZE);
+        output[i] = Sigmoid(outputLayer.biases[i] + sum * (m_quantizedOutput.scales[i] * hiddenScale));
+    }
+}
+
+void NeuralNetwork::Forward(const Matrix& input, Matrix& output, Precision precision) const {
+    output.Resize(input.rows, OUTPUT_SIZE);
+    
+    // Both weight matrices stay in L1 across the batch
+    alignas(SIMD_ALIGNMENT) float hidden[PaddedSize(HIDDEN_LAYER_SIZE)];
+    for (int r = 0; r < input.rows; r++) {
+        if (precision == Precision::INT8) {
+            ForwardSampleInt8(input.Row(r), hidden, output.Row(r));
+        } else {
+            ForwardSample(input.Row(r), hidden, output.Row(r));
+        }
     }
+}
+
+void NeuralNetwork::QuantizedMatrix::Quantize(const Matrix& source) {
+    rows = source.rows;
+    cols = source.cols;
+    stride = PaddedInt8Size(source.cols);
+    data.assign((size_t)rows * stride, 0);
+    scales.resize(rows);
+    for (int r = 0; r < rows; r++) {
+        scales[r] = QuantizeValues(source.Row(r), cols, data.data() + (size_t)r * stride);
+    }
+}
+
+void NeuralNetwork::Quantize() {
+    if (m_layers.size() < 2) return;
     
-    // Calculate hidden layer deltas
-    for (int i = 0; i < HIDDEN_LAYER_SIZE; i++) {
-        float error = 0.0f;
-        for (int j = 0; j < OUTPUT_SIZE; j++) {
-            error += m_layers[1].deltas[j] * m_layers[1].weights[j][i];
+    m_quantizedEmbeddings.Quantize(m_embeddings);
+    m_quantizedHidden.Quantize(m_layers[0].weights);
+    m_quantizedOutput.Quantize(m_layers[1].weights);
+    m_precision = Precision::INT8;
+}
+
+bool NeuralNetwork::SetPrecision(Precision precision) {
+    if (precision == Precision::INT8 && m_quantizedHidden.rows == 0) return false;
+    m_precision = precision;
+    return true;
+}
+
+// Nothing to trim: a model missing its weights can't answer
+size_t NeuralNetwork::GetMemoryBytes() const {
+    auto floatBytes = [](const Matrix& matrix) { return matrix.data.capacity() * sizeof(float); };
+    auto int8Bytes = [](const QuantizedMatrix& matrix) { return matrix.data.capacity() + matrix.scales.capacity() * sizeof(float); };
+    size_t bytes = floatBytes(m_embeddings) + int8Bytes(m_quantizedEmbeddings) +
+                   int8Bytes(m_quantizedHidden) + int8Bytes(m_quantizedOutput);
+    for (const Layer& layer : m_layers) {
+        bytes += floatBytes(layer.weights) + layer.biases.capacity() * sizeof(float);
+    }
+    return bytes;
+}
+
+void NeuralNetwork::DropQuantized() {
+    m_quantizedEmbeddings = QuantizedMatrix();
+    m_quantizedHidden = QuantizedMatrix();
+    m_quantizedOutput = QuantizedMatrix();
+    m_precision = Precision::FLOAT32;
+}
+
+NeuralNetwork::QuantizationReport NeuralNetwork::CompareQuantized(
+    const std::vector<std::pair<std::wstring, ParsedPrompt>>& samples) const {
+    QuantizationReport report = {};
+    
+    auto floatBytes = [](const Matrix& matrix) { return matrix.data.size() * sizeof(float); };
+    auto int8Bytes = [](const QuantizedMatrix& matrix) { return matrix.data.size() + matrix.scales.size() * sizeof(float); };
+    size_t biasBytes = 0;
+    for (const Layer& layer : m_layers) {
+        report.floatBytes += floatBytes(layer.weights);
+        biasBytes += layer.biases.size() * sizeof(float);
+    }
+    report.floatBytes += floatBytes(m_embeddings) + biasBytes;
+    report.int8Bytes = int8Bytes(m_quantizedEmbeddings) + int8Bytes(m_quantizedHidden) +
+                       int8Bytes(m_quantizedOutput) + biasBytes;
+    if (m_layers.size() < 2 || m_quantizedHidden.rows == 0 || samples.empty()) return report;
+    
+    alignas(SIMD_ALIGNMENT) float embedding[PaddedSize(EMBEDDING_DIM)] = {};
+    alignas(SIMD_ALIGNMENT) float hidden[PaddedSize(HIDDEN_LAYER_SIZE)];
+    alignas(SIMD_ALIGNMENT) float floatOutput[PaddedSize(OUTPUT_SIZE)];
+    alignas(SIMD_ALIGNMENT) float int8Output[PaddedSize(OUTPUT_SIZE)];
+    TokenList tokens;
+    int floatCorrect = 0;
+    int int8Correct = 0;
+    int agreeing = 0;
+    double errorSum = 0.0;
+    
+    for (const auto& sample : samples) {
+        Tokenize(sample.first, tokens);
+        TextToEmbedding(tokens, embedding, Precision::FLOAT32);
+        ForwardSample(embedding, hidden, floatOutput);
+        TextToEmbedding(tokens, embedding, Precision::INT8);
+        ForwardSampleInt8(embedding, hidden, int8Output);
+        
+        float confidence;
+        Intent floatIntent = OutputToIntent(floatOutput, confidence);
+        Intent int8Intent = OutputToIntent(int8Output, confidence);
+        floatCorrect += floatIntent == sample.second.intent;
+        int8Correct += int8Intent == sample.second.intent;
+        agreeing += floatIntent == int8Intent;
+        
+        for (int i = 0; i < OUTPUT_SIZE; i++) {
+            float error = std::fabs(int8Output[i] - floatOutput[i]);
+            errorSum += error;
+            report.maxOutputError = std::max(report.maxOutputError, error);
         }
-        m_layers[0].deltas[i] = error * ReLUDerivative(m_layers[0].activations[i]);
     }
     
-    // Update output layer weights
-    for (int i = 0; i < OUTPUT_SIZE; i++) {
-        for (int j = 0; j < HIDDEN_LAYER_SIZE; j++) {
-            m_layers[1].weights[i][j] += LEARNING_RATE * m_layers[1].deltas[i] * m_layers[0].activations[j];
+    float count = (float)samples.size();
+    report.samples = (int)samples.size();
+    report.floatAccuracy = floatCorrect / count;
+    report.int8Accuracy = int8Correct / count;
+    report.agreement = agreeing / count;
+    report.meanOutputError = (float)(errorSum / ((double)samples.size() * OUTPUT_SIZE));
+    return report;
+}
+
+NeuralNetwork::QuantizationReport NeuralNetwork::CompareQuantized() const {
+    std::vector<std::pair<std::wstring, ParsedPrompt>> samples;
+    samples.reserve(m_intentKeywords.size());
+    m_intentKeywords.ForEach([&](std::wstring_view keyword, Intent intent) {
+        ParsedPrompt sample = {};
+        sample.intent = intent;
+        samples.emplace_back(std::wstring(keyword), std::move(sample));
+    });
+    return CompareQuantized(samples);
+}
+
+float NeuralNetwork::AccumulateGradient(const Matrix& inputs, const std::vector<int>& labels, const int* samples, int count,
+                                        float* weightGradient, float* biasGradient) const {
+    Kernels kernels = GetKernels();
+    int stride = m_layers[1].weights.stride;
+    alignas(SIMD_ALIGNMENT) float hidden[PaddedSize(HIDDEN_LAYER_SIZE)];
+    alignas(SIMD_ALIGNMENT) float output[PaddedSize(OUTPUT_SIZE)];
+    
+    float loss = 0.0f;
+    for (int s = 0; s < count; s++) {
+        int sample = samples[s];
+        ForwardSample(inputs.Row(sample), hidden, output);
+        
+        for (int i = 0; i < OUTPUT_SIZE; i++) {
+            // One-hot target; labels outside the output layer train toward all zeros
+            float error = (i == labels[sample] ? 1.0f : 0.0f) - output[i];
+            loss += error * error;
+            if (!weightGradient) continue;
+            
+            float delta = error * SigmoidDerivative(output[i]);
+            kernels.axpy(weightGradient + (size_t)i * stride, hidden, delta, HIDDEN_LAYER_SIZE);
+            biasGradient[i] += delta;
         }
-        m_layers[1].biases[i] += LEARNING_RATE * m_layers[1].deltas[i];
     }
     
-    // Update hidden layer weights (would need input activations - simplified here)
+    // The hidden layer isn't trained (it would need the input activations kept per sample)
+    return loss;
 }
 
-NeuralNetwork::Intent NeuralNetwork::OutputToIntent(const std::vector<float>& output, float& confidence) {
+NeuralNetwork::Intent NeuralNetwork::OutputToIntent(const float* output, float& confidence) const {
     // Find max activation
     int maxIdx = 0;
     float maxVal = output[0];
     
-    for (size_t i = 1; i < output.size() && i < OUTPUT_SIZE; i++) {
+    for (int i = 1; i < OUTPUT_SIZE; i++) {
         if (output[i] > maxVal) {
             maxVal = output[i];
-            maxIdx = static_cast<int>(i);
+            maxIdx = i;
         }
     }
     
@@ -682,9 +1245,9 @@ NeuralNetwork::Intent NeuralNetwork::OutputToIntent(const std::vector<float>& ou
     }
 }
 
-std::map<std::wstring, std::wstring> NeuralNetwork::ExtractEntities(const std::wstring& prompt) {
+std::map<std::wstring, std::wstring> NeuralNetwork::ExtractEntities(const std::wstring& prompt, const TokenList& tokenList) const {
     std::map<std::wstring, std::wstring> entities;
-    auto tokens = Tokenize(prompt);
+    const std::vector<std::wstring_view>& tokens = tokenList.tokens;
     
     // Extract dimensions (e.g., "800x600" or "width 800 height 600")
     for (size_t i = 0; i < tokens.size(); i++) {
@@ -692,9 +1255,9 @@ std::map<std::wstring, std::wstring> NeuralNetwork::ExtractEntities(const std::w
         
         // Check for "WIDTHxHEIGHT" pattern
         size_t xPos = token.find(L'x');
-        if (xPos != std::wstring::npos) {
-            std::wstring widthStr = token.substr(0, xPos);
-            std::wstring heightStr = token.substr(xPos + 1);
+        if (xPos != std::wstring_view::npos) {
+            std::wstring_view widthStr = token.substr(0, xPos);
+            std::wstring_view heightStr = token.substr(xPos + 1);
             
             if (!widthStr.empty() && !heightStr.empty() &&
                 IsAllDigits(widthStr) &&
@@ -850,8 +1413,7 @@ std::map<std::wstring, std::wstring> NeuralNetwork::ExtractEntities(const std::w
     }
     
     // Detect contextual patterns that imply certain widgets
-    std::wstring lowerPrompt = prompt;
-    std::transform(lowerPrompt.begin(), lowerPrompt.end(), lowerPrompt.begin(), ::towlower);
+    const std::wstring& lowerPrompt = tokenList.lower;
     
     // Login form pattern detection
     if (lowerPrompt.find(L"login") != std::wstring::npos || 
@@ -884,59 +1446,105 @@ std::map<std::wstring, std::wstring> NeuralNetwork::ExtractEntities(const std::w
     return entities;
 }
 
-NeuralNetwork::ParsedPrompt NeuralNetwork::ParsePrompt(const std::wstring& prompt) {
+NeuralNetwork::ParsedPrompt NeuralNetwork::MatchPrompt(const std::wstring& prompt, TokenList& tokens) const {
     ParsedPrompt result;
     
     // Use keyword matching for primary intent detection (simple but effective)
-    auto tokens = Tokenize(prompt);
+    Tokenize(prompt, tokens);
     
     // Determine intent based on keywords
     result.intent = Intent::UNKNOWN;
     result.confidence = 0.5f;
     result.layoutType = LayoutType::NONE;
     
-    for (const auto& token : tokens) {
-        auto it = m_intentKeywords.find(token);
-        if (it != m_intentKeywords.end()) {
-            result.intent = it->second;
+    for (std::wstring_view token : tokens.tokens) {
+        if (const Intent* intent = m_intentKeywords.Find(token)) {
+            result.intent = *intent;
             result.confidence = 0.9f;
             break;
         }
     }
     
-    // If still unknown, use neural network
-    if (result.intent == Intent::UNKNOWN) {
-        auto embedding = TextToEmbedding(prompt);
-        auto output = Forward(embedding);
-        result.intent = OutputToIntent(output, result.confidence);
-    }
-    
     // Extract entities
-    result.entities = ExtractEntities(prompt);
+    result.entities = ExtractEntities(prompt, tokens);
     
     // Extract multiple widgets from prompt
-    result.additionalWidgets = ExtractMultipleWidgets(prompt);
+    result.additionalWidgets = ExtractMultipleWidgets(tokens);
     
     // Determine layout type
-    result.layoutType = DetermineLayout(prompt);
+    result.layoutType = DetermineLayout(tokens);
+    
+    return result;
+}
+
+NeuralNetwork::ParsedPrompt NeuralNetwork::ParsePrompt(const std::wstring& prompt) const {
+    // Kept per thread so a prompt box parsing on every keystroke reuses the buffers
+    thread_local TokenList tokens;
+    ParsedPrompt result = MatchPrompt(prompt, tokens);
+    
+    // If still unknown, use neural network
+    if (result.intent == Intent::UNKNOWN) {
+        alignas(SIMD_ALIGNMENT) float embedding[PaddedSize(EMBEDDING_DIM)] = {};
+        alignas(SIMD_ALIGNMENT) float hidden[PaddedSize(HIDDEN_LAYER_SIZE)];
+        alignas(SIMD_ALIGNMENT) float output[PaddedSize(OUTPUT_SIZE)];
+        TextToEmbedding(tokens, embedding, m_precision);
+        if (m_precision == Precision::INT8) {
+            ForwardSampleInt8(embedding, hidden, output);
+        } else {
+            ForwardSample(embedding, hidden, output);
+        }
+        result.intent = OutputToIntent(output, result.confidence);
+    }
     
     return result;
 }
 
-std::vector<NeuralNetwork::Intent> NeuralNetwork::ExtractMultipleWidgets(const std::wstring& prompt) {
+std::vector<NeuralNetwork::ParsedPrompt> NeuralNetwork::ParsePrompts(const std::vector<std::wstring>& prompts) const {
+    std::vector<ParsedPrompt> results;
+    results.reserve(prompts.size());
+    
+    thread_local TokenList tokens;
+    FrameArena::Scope scratch;
+    FrameVector<size_t> unmatched(FrameArena::GetResource());
+    for (size_t i = 0; i < prompts.size(); i++) {
+        results.push_back(MatchPrompt(prompts[i], tokens));
+        if (results.back().intent == Intent::UNKNOWN) {
+            unmatched.push_back(i);
+        }
+    }
+    if (unmatched.empty()) return results;
+    
+    // One embedding row per prompt the keywords left unknown; both matrices
+    // keep their capacity for the next batch
+    thread_local Matrix input;
+    thread_local Matrix output;
+    input.Resize(static_cast<int>(unmatched.size()), EMBEDDING_DIM);
+    for (size_t r = 0; r < unmatched.size(); r++) {
+        Tokenize(prompts[unmatched[r]], tokens);
+        TextToEmbedding(tokens, input.Row(static_cast<int>(r)), m_precision);
+    }
+    
+    Forward(input, output, m_precision);
+    for (size_t r = 0; r < unmatched.size(); r++) {
+        ParsedPrompt& result = results[unmatched[r]];
+        result.intent = OutputToIntent(output.Row(static_cast<int>(r)), result.confidence);
+    }
+    
+    return results;
+}
+
+std::vector<NeuralNetwork::Intent> NeuralNetwork::ExtractMultipleWidgets(const TokenList& tokens) const {
     std::vector<Intent> widgets;
-    auto tokens = Tokenize(prompt);
     
     // Look for multiple widget mentions in the prompt
-    for (const auto& token : tokens) {
-        auto it = m_intentKeywords.find(token);
-        if (it != m_intentKeywords.end()) {
+    for (std::wstring_view token : tokens.tokens) {
+        if (const Intent* intent = m_intentKeywords.Find(token)) {
             // Only add widget-related intents
-            if (it->second != Intent::CREATE_WINDOW && 
-                it->second != Intent::SET_CALLBACK && 
-                it->second != Intent::SET_THEME &&
-                it->second != Intent::SET_LAYOUT) {
-                widgets.push_back(it->second);
+            if (*intent != Intent::CREATE_WINDOW && 
+                *intent != Intent::SET_CALLBACK && 
+                *intent != Intent::SET_THEME &&
+                *intent != Intent::SET_LAYOUT) {
+                widgets.push_back(*intent);
             }
         }
     }
@@ -944,9 +1552,8 @@ std::vector<NeuralNetwork::Intent> NeuralNetwork::ExtractMultipleWidgets(const s
     return widgets;
 }
 
-NeuralNetwork::LayoutType NeuralNetwork::DetermineLayout(const std::wstring& prompt) {
-    auto lowerPrompt = prompt;
-    std::transform(lowerPrompt.begin(), lowerPrompt.end(), lowerPrompt.begin(), ::towlower);
+NeuralNetwork::LayoutType NeuralNetwork::DetermineLayout(const TokenList& tokens) const {
+    const std::wstring& lowerPrompt = tokens.lower;
     
     // Explicit layout keywords take highest priority
     if (lowerPrompt.find(L"vertical layout") != std::wstring::npos ||
@@ -1029,11 +1636,10 @@ NeuralNetwork::LayoutType NeuralNetwork::DetermineLayout(const std::wstring& pro
         lowerPrompt.find(L"cards") != std::wstring::npos ||
         lowerPrompt.find(L"items") != std::wstring::npos) {
         // Check for number indicators suggesting grid
-        auto tokens = Tokenize(prompt);
-        for (const auto& token : tokens) {
+        for (std::wstring_view token : tokens.tokens) {
             if (IsAllDigits(token)) {
                 try {
-                    int count = static_cast<int>(std::stol(token));
+                    int count = static_cast<int>(std::stol(std::wstring(token)));
                     // If count is 6, 9, 12, or other square-ish numbers, suggest grid
                     if (count >= 6 && (count % 3 == 0 || count % 4 == 0)) {
                         return LayoutType::GRID;
@@ -1050,41 +1656,346 @@ NeuralNetwork::LayoutType NeuralNetwork::DetermineLayout(const std::wstring& pro
 }
 
 void NeuralNetwork::Train(const std::vector<std::pair<std::wstring, ParsedPrompt>>& trainingData, int epochs) {
-    // Simple training loop
-    for (int epoch = 0; epoch < epochs; epoch++) {
-        float totalLoss = 0.0f;
+    TrainingOptions options;
+    options.epochs = epochs;
+    Train(trainingData, options);
+}
+
+void NeuralNetwork::Train(const std::vector<std::pair<std::wstring, ParsedPrompt>>& trainingData,
+                          const TrainingOptions& options, EpochCallback callback) {
+    if (trainingData.empty() || m_layers.size() < 2) return;
+    Precision precision = m_precision;
+    int count = static_cast<int>(trainingData.size());
+    
+    // Embeddings aren't trained, so each prompt is embedded once for all epochs
+    Matrix inputs;
+    inputs.Resize(count, EMBEDDING_DIM);
+    std::vector<int> labels(count);
+    TokenList tokens;
+    for (int r = 0; r < count; r++) {
+        Tokenize(trainingData[r].first, tokens);
+        TextToEmbedding(tokens, inputs.Row(r), Precision::FLOAT32);
+        labels[r] = static_cast<int>(trainingData[r].second.intent);
+    }
+    
+    std::vector<int> order(count);
+    for (int r = 0; r < count; r++) {
+        order[r] = r;
+    }
+    if (options.shuffle) {
+        std::shuffle(order.begin(), order.end(), m_rng);
+    }
+    
+    // Held-out samples come off the end of the shuffled order
+    int validationCount = 0;
+    if (options.validationSplit > 0.0f && count > 1) {
+        validationCount = std::min(count - 1, std::max(1, (int)std::lround(options.validationSplit * count)));
+    }
+    std::vector<int> validation(order.end() - validationCount, order.end());
+    order.resize(count - validationCount);
+    
+    Layer& output = m_layers[1];
+    size_t weightCount = output.weights.data.size();
+    int batchSize = std::max(1, options.batchSize);
+    int chunksPerBatch = (batchSize + GRADIENT_CHUNK_SIZE - 1) / GRADIENT_CHUNK_SIZE;
+    std::vector<GradientChunk> chunks(chunksPerBatch);
+    for (auto& chunk : chunks) {
+        chunk.weights.resize(weightCount);
+        chunk.biases.resize(OUTPUT_SIZE);
+    }
+    Kernels kernels = GetKernels();
+    
+    int validationChunks = (validationCount + GRADIENT_CHUNK_SIZE - 1) / GRADIENT_CHUNK_SIZE;
+    std::vector<float> validationLosses(validationChunks);
+    float bestLoss = 0.0f;
+    bool haveBest = false;
+    int staleEpochs = 0;
+    AlignedVector bestWeights;
+    std::vector<float> bestBiases;
+    
+    for (int epoch = 0; epoch < options.epochs; epoch++) {
+        auto start = std::chrono::steady_clock::now();
+        if (options.shuffle && epoch > 0) {
+            std::shuffle(order.begin(), order.end(), m_rng);
+        }
         
-        for (const auto& sample : trainingData) {
-            // Convert prompt to embedding
-            auto embedding = TextToEmbedding(sample.first);
+        float totalLoss = 0.0f;
+        for (size_t first = 0; first < order.size(); first += batchSize) {
+            int batch = std::min(batchSize, static_cast<int>(order.size() - first));
+            int batchChunks = (batch + GRADIENT_CHUNK_SIZE - 1) / GRADIENT_CHUNK_SIZE;
             
-            // Create target vector (one-hot encoding)
-            std::vector<float> target(OUTPUT_SIZE, 0.0f);
-            int intentIdx = static_cast<int>(sample.second.intent);
-            if (intentIdx >= 0 && intentIdx < OUTPUT_SIZE) {
-                target[intentIdx] = 1.0f;
-            }
+            JobScheduler::ParallelFor(batchChunks, 1, [&](int begin, int end) {
+                for (int c = begin; c < end; c++) {
+                    GradientChunk& chunk = chunks[c];
+                    std::fill(chunk.weights.begin(), chunk.weights.end(), 0.0f);
+                    std::fill(chunk.biases.begin(), chunk.biases.end(), 0.0f);
+                    int offset = c * GRADIENT_CHUNK_SIZE;
+                    chunk.loss = AccumulateGradient(inputs, labels, order.data() + first + offset,
+                                                    std::min(GRADIENT_CHUNK_SIZE, batch - offset),
+                                                    chunk.weights.data(), chunk.biases.data());
+                }
+            }, "NeuralNetwork::Train");
             
-            // Forward pass
-            auto output = Forward(embedding);
+            // The summed step moves the weights as far as per-sample SGD over the batch would
+            for (int c = 0; c < batchChunks; c++) {
+                kernels.axpy(output.weights.data.data(), chunks[c].weights.data(), options.learningRate, (int)weightCount);
+                kernels.axpy(output.biases.data(), chunks[c].biases.data(), options.learningRate, OUTPUT_SIZE);
+                totalLoss += chunks[c].loss;
+            }
+        }
+        
+        EpochReport report;
+        report.epoch = epoch;
+        report.samples = static_cast<int>(order.size());
+        report.trainingLoss = order.empty() ? 0.0f : totalLoss / order.size();
+        report.validationLoss = -1.0f;
+        report.stoppingEarly = false;
+        
+        if (validationCount > 0) {
+            JobScheduler::ParallelFor(validationChunks, 1, [&](int begin, int end) {
+                for (int c = begin; c < end; c++) {
+                    int offset = c * GRADIENT_CHUNK_SIZE;
+                    validationLosses[c] = AccumulateGradient(inputs, labels, validation.data() + offset,
+                                                             std::min(GRADIENT_CHUNK_SIZE, validationCount - offset),
+                                                             nullptr, nullptr);
+                }
+            }, "NeuralNetwork::Validate");
             
-            // Calculate loss
-            for (int i = 0; i < OUTPUT_SIZE; i++) {
-                float error = target[i] - output[i];
-                totalLoss += error * error;
+            float validationLoss = 0.0f;
+            for (float loss : validationLosses) {
+                validationLoss += loss;
             }
+            report.validationLoss = validationLoss / validationCount;
             
-            // Backward pass
-            Backward(target);
+            if (!haveBest || report.validationLoss < bestLoss) {
+                bestLoss = report.validationLoss;
+                bestWeights = output.weights.data;
+                bestBiases = output.biases;
+                haveBest = true;
+                staleEpochs = 0;
+            } else if (++staleEpochs >= std::max(1, options.patience)) {
+                report.stoppingEarly = true;
+            }
         }
         
-        // Optional: Print progress every 10 epochs
-        // (commented out to avoid console output in production)
-        // if (epoch % 10 == 0) {
-        //     float avgLoss = totalLoss / trainingData.size();
-        //     // printf("Epoch %d, Loss: %f\n", epoch, avgLoss);
-        // }
+        report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        report.samplesPerSecond = report.seconds > 0.0 ? report.samples / report.seconds : 0.0;
+        if (callback) {
+            callback(report);
+        }
+        if (report.stoppingEarly) break;
+    }
+    
+    if (haveBest) {
+        output.weights.data = bestWeights;
+        output.biases = bestBiases;
+    }
+    
+    // Keep an int8 network int8, now from the trained weights
+    if (m_quantizedHidden.rows > 0) {
+        Quantize();
+        m_precision = precision;
+    }
+}
+
+std::vector<uint8_t> NeuralNetwork::Serialize() const {
+    ModelWriter writer;
+    if (m_layers.size() != 2) return writer.bytes;
+    
+    writer.bytes.resize(sizeof(ModelHeader), 0);
+    ModelHeader header = {};
+    header.magic = MODEL_MAGIC;
+    header.version = MODEL_VERSION;
+    header.embeddingDim = EMBEDDING_DIM;
+    header.hiddenSize = HIDDEN_LAYER_SIZE;
+    header.outputSize = OUTPUT_SIZE;
+    header.embeddingRows = (uint32_t)m_embeddings.rows;
+    header.vocabularyCount = (uint32_t)m_vocabulary.size();
+    header.keywordCount = (uint32_t)m_intentKeywords.size();
+    header.patternCount = (uint32_t)m_entityPatterns.size();
+    
+    header.embeddings = writer.AppendFloats(m_embeddings.data.data(), m_embeddings.data.size());
+    header.hiddenWeights = writer.AppendFloats(m_layers[0].weights.data.data(), m_layers[0].weights.data.size());
+    header.hiddenBiases = writer.AppendFloats(m_layers[0].biases.data(), m_layers[0].biases.size());
+    header.outputWeights = writer.AppendFloats(m_layers[1].weights.data.data(), m_layers[1].weights.data.size());
+    header.outputBiases = writer.AppendFloats(m_layers[1].biases.data(), m_layers[1].biases.size());
+    
+    header.strings = writer.bytes.size();
+    m_vocabulary.ForEach([&](std::wstring_view word, int index) {
+        writer.AppendString(word);
+        writer.AppendU32((uint32_t)index);
+    });
+    m_intentKeywords.ForEach([&](std::wstring_view keyword, Intent intent) {
+        writer.AppendString(keyword);
+        writer.AppendU32((uint32_t)intent);
+    });
+    m_entityPatterns.ForEach([&](std::wstring_view key, const std::wstring& pattern) {
+        writer.AppendString(key);
+        writer.AppendString(pattern);
+    });
+    
+    header.fileSize = writer.bytes.size();
+    std::memcpy(writer.bytes.data(), &header, sizeof(header));
+    return writer.bytes;
+}
+
+bool NeuralNetwork::Deserialize(const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    ModelHeader header;
+    if (!bytes || size < sizeof(header)) return false;
+    std::memcpy(&header, bytes, sizeof(header));
+    
+    if (header.magic != MODEL_MAGIC || header.version != MODEL_VERSION || header.fileSize != size) return false;
+    if (header.embeddingDim != EMBEDDING_DIM || header.hiddenSize != HIDDEN_LAYER_SIZE ||
+        header.outputSize != OUTPUT_SIZE || header.embeddingRows == 0 || header.embeddingRows > size) {
+        return false;
     }
+    
+    // Parsed aside and swapped in, so a bad file changes nothing
+    NeuralNetwork loaded;
+    loaded.m_embeddings.Resize((int)header.embeddingRows, EMBEDDING_DIM);
+    loaded.m_layers.resize(2);
+    Layer& hidden = loaded.m_layers[0];
+    Layer& output = loaded.m_layers[1];
+    hidden.weights.Resize(HIDDEN_LAYER_SIZE, EMBEDDING_DIM);
+    hidden.biases.resize(HIDDEN_LAYER_SIZE);
+    output.weights.Resize(OUTPUT_SIZE, HIDDEN_LAYER_SIZE);
+    output.biases.resize(OUTPUT_SIZE);
+    
+    if (!ReadFloats(bytes, size, header.embeddings, loaded.m_embeddings.data.data(), loaded.m_embeddings.data.size()) ||
+        !ReadFloats(bytes, size, header.hiddenWeights, hidden.weights.data.data(), hidden.weights.data.size()) ||
+        !ReadFloats(bytes, size, header.hiddenBiases, hidden.biases.data(), hidden.biases.size()) ||
+        !ReadFloats(bytes, size, header.outputWeights, output.weights.data.data(), output.weights.data.size()) ||
+        !ReadFloats(bytes, size, header.outputBiases, output.biases.data(), output.biases.size())) {
+        return false;
+    }
+    
+    ModelReader reader(bytes, size, header.strings);
+    for (uint32_t i = 0; i < header.vocabularyCount && reader.IsOk(); i++) {
+        std::wstring word = reader.ReadString();
+        uint32_t index = reader.ReadU32();
+        if (index >= header.embeddingRows) return false;
+        loaded.m_vocabulary.Insert(word, (int)index);
+    }
+    for (uint32_t i = 0; i < header.keywordCount && reader.IsOk(); i++) {
+        std::wstring keyword = reader.ReadString();
+        uint32_t intent = reader.ReadU32();
+        if (intent > (uint32_t)Intent::UNKNOWN) return false;
+        loaded.m_intentKeywords.Insert(keyword, (Intent)intent);
+    }
+    for (uint32_t i = 0; i < header.patternCount && reader.IsOk(); i++) {
+        std::wstring key = reader.ReadString();
+        loaded.m_entityPatterns.Insert(key, reader.ReadString());
+    }
+    if (!reader.IsOk()) return false;
+    
+    m_layers.swap(loaded.m_layers);
+    std::swap(m_vocabulary, loaded.m_vocabulary);
+    std::swap(m_embeddings, loaded.m_embeddings);
+    std::swap(m_intentKeywords, loaded.m_intentKeywords);
+    std::swap(m_entityPatterns, loaded.m_entityPatterns);
+    DropQuantized();
+    return true;
+}
+
+bool NeuralNetwork::Save(const std::wstring& path) const {
+    std::vector<uint8_t> bytes = Serialize();
+    if (bytes.empty()) return false;
+    
+#if SDK_PLATFORM_WINDOWS
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    
+    DWORD written = 0;
+    bool saved = WriteFile(file, bytes.data(), (DWORD)bytes.size(), &written, nullptr) && written == bytes.size();
+    CloseHandle(file);
+    return saved;
+#else
+    int file = open(std::filesystem::path(path).c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (file < 0) return false;
+    
+    size_t written = 0;
+    while (written < bytes.size()) {
+        ssize_t count = write(file, bytes.data() + written, bytes.size() - written);
+        if (count <= 0) break;
+        written += (size_t)count;
+    }
+    bool saved = close(file) == 0 && written == bytes.size();
+    return saved;
+#endif
+}
+
+bool NeuralNetwork::Load(const std::wstring& path) {
+#if SDK_PLATFORM_WINDOWS
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    
+    bool loaded = false;
+    LARGE_INTEGER size;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping) {
+            const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            if (view) {
+                loaded = Deserialize(view, (size_t)size.QuadPart);
+                UnmapViewOfFile(view);
+            }
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+    return loaded;
+#else
+    int file = open(std::filesystem::path(path).c_str(), O_RDONLY);
+    if (file < 0) return false;
+    
+    bool loaded = false;
+    struct stat info;
+    if (fstat(file, &info) == 0 && info.st_size > 0) {
+        void* view = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (view != MAP_FAILED) {
+            loaded = Deserialize(view, (size_t)info.st_size);
+            munmap(view, (size_t)info.st_size);
+        }
+    }
+    close(file);
+    return loaded;
+#endif
+}
+
+std::shared_ptr<const NeuralNetwork> NeuralNetwork::GetShared() {
+    std::lock_guard<std::mutex> lock(g_sharedMutex);
+    if (!g_shared) {
+        StartupTiming::Scope timing(StartupTiming::Phase::NEURAL_NETWORK);
+        auto network = std::make_shared<NeuralNetwork>();
+        SharedAssetCache::Blob blob;
+        bool loaded = SharedAssetCache::FindCurrent(SHARED_MODEL_KEY, blob) &&
+                      network->Deserialize(blob.data, blob.size);
+        if (!loaded && (g_sharedPath.empty() || !network->Load(g_sharedPath))) {
+            network->Initialize();
+        }
+        if (g_sharedPrecision == Precision::INT8) {
+            network->Quantize();
+        }
+        g_shared = network;
+    }
+    return g_shared;
+}
+
+bool NeuralNetwork::ExportShared(SharedAssetCache& cache) const {
+    std::vector<uint8_t> model = Serialize();
+    return cache.Add(SHARED_MODEL_KEY, model.data(), model.size());
+}
+
+void NeuralNetwork::SetSharedModelPath(const std::wstring& path) {
+    std::lock_guard<std::mutex> lock(g_sharedMutex);
+    g_sharedPath = path;
+}
+
+void NeuralNetwork::SetSharedPrecision(Precision precision) {
+    std::lock_guard<std::mutex> lock(g_sharedMutex);
+    g_sharedPrecision = precision;
 }
 
 } // namespace SDK
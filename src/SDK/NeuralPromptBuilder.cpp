@@ -10,73 +10,72 @@ namespace SDK {
 
 NeuralPromptBuilder::NeuralPromptBuilder() 
     : PromptWindowBuilder() {
-    m_neuralNetwork = std::make_shared<NeuralNetwork>();
-    m_neuralNetwork->Initialize();
-    
     // Register widget factories for all supported widget types
     RegisterWidgetFactory(L"button", [](const std::wstring&) {
-        return std::make_shared<Button>(L"Button");
+        return MakeWidget<Button>(L"Button");
     });
     
     RegisterWidgetFactory(L"label", [](const std::wstring&) {
-        return std::make_shared<Label>(L"Label");
+        return MakeWidget<Label>(L"Label");
     });
     
     RegisterWidgetFactory(L"textbox", [](const std::wstring&) {
-        auto textbox = std::make_shared<TextBox>();
+        auto textbox = MakeWidget<TextBox>();
         textbox->SetPlaceholder(L"Enter text...");
         return textbox;
     });
     
     RegisterWidgetFactory(L"checkbox", [](const std::wstring&) {
-        return std::make_shared<CheckBox>(L"Checkbox");
+        return MakeWidget<CheckBox>(L"Checkbox");
     });
     
     RegisterWidgetFactory(L"progressbar", [](const std::wstring&) {
-        return std::make_shared<ProgressBar>();
+        return MakeWidget<ProgressBar>();
     });
     
     RegisterWidgetFactory(L"slider", [](const std::wstring&) {
-        auto slider = std::make_shared<Slider>();
+        auto slider = MakeWidget<Slider>();
         slider->SetRange(0, 100);
         return slider;
     });
     
     RegisterWidgetFactory(L"combobox", [](const std::wstring&) {
-        return std::make_shared<ComboBox>();
+        return MakeWidget<ComboBox>();
     });
     
     RegisterWidgetFactory(L"listbox", [](const std::wstring&) {
-        return std::make_shared<ListBox>();
+        return MakeWidget<ListBox>();
     });
     
     RegisterWidgetFactory(L"listview", [](const std::wstring&) {
-        return std::make_shared<ListView>();
+        return MakeWidget<ListView>();
     });
     
     RegisterWidgetFactory(L"radiobutton", [](const std::wstring&) {
-        return std::make_shared<RadioButton>(L"Radio", 0);
+        return MakeWidget<RadioButton>(L"Radio", 0);
     });
     
     RegisterWidgetFactory(L"spinbox", [](const std::wstring&) {
-        return std::make_shared<SpinBox>();
+        return MakeWidget<SpinBox>();
     });
     
     RegisterWidgetFactory(L"separator", [](const std::wstring&) {
-        return std::make_shared<Separator>();
+        return MakeWidget<Separator>();
     });
     
     RegisterWidgetFactory(L"panel", [](const std::wstring&) {
-        return std::make_shared<Panel>();
+        return MakeWidget<Panel>();
     });
 }
 
-PromptWindowBuilder::WindowSpec NeuralPromptBuilder::ParsePrompt(const std::wstring& prompt) {
+std::shared_ptr<PromptWindowBuilder::CachedPrompt> NeuralPromptBuilder::ParseCachedPrompt(const std::wstring& prompt) {
     // Use neural network to parse the prompt
-    auto parsed = m_neuralNetwork->ParsePrompt(prompt);
+    auto entry = std::make_shared<CachedParse>();
+    entry->parsed = GetNeuralNetwork()->ParsePrompt(prompt);
     
     // Convert to WindowSpec
-    return ConvertToWindowSpec(parsed);
+    entry->spec = ConvertToWindowSpec(entry->parsed);
+    return entry;
 }
 
 PromptWindowBuilder::WindowSpec NeuralPromptBuilder::ConvertToWindowSpec(const NeuralNetwork::ParsedPrompt& parsed) {
@@ -160,45 +159,45 @@ std::vector<std::shared_ptr<Widget>> NeuralPromptBuilder::GenerateWidgetsFromPar
         
         switch (intent) {
             case NeuralNetwork::Intent::ADD_BUTTON: {
-                auto button = std::make_shared<Button>(parsed.GetWidgetText());
+                auto button = MakeWidget<Button>(parsed.GetWidgetText());
                 widget = button;
                 break;
             }
             
             case NeuralNetwork::Intent::ADD_LABEL: {
-                auto label = std::make_shared<Label>(parsed.GetWidgetText());
+                auto label = MakeWidget<Label>(parsed.GetWidgetText());
                 widget = label;
                 break;
             }
             
             case NeuralNetwork::Intent::ADD_TEXTBOX: {
-                auto textbox = std::make_shared<TextBox>();
+                auto textbox = MakeWidget<TextBox>();
                 textbox->SetPlaceholder(parsed.GetWidgetText());
                 widget = textbox;
                 break;
             }
             
             case NeuralNetwork::Intent::ADD_CHECKBOX: {
-                auto checkbox = std::make_shared<CheckBox>(parsed.GetWidgetText());
+                auto checkbox = MakeWidget<CheckBox>(parsed.GetWidgetText());
                 widget = checkbox;
                 break;
             }
             
             case NeuralNetwork::Intent::ADD_PROGRESSBAR: {
-                auto progressbar = std::make_shared<ProgressBar>();
+                auto progressbar = MakeWidget<ProgressBar>();
                 widget = progressbar;
                 break;
             }
             
             case NeuralNetwork::Intent::ADD_TOOLTIP: {
-                auto tooltip = std::make_shared<Tooltip>();
+                auto tooltip = MakeWidget<Tooltip>();
                 tooltip->SetText(parsed.GetWidgetText());
                 widget = tooltip;
                 break;
             }
             
             case NeuralNetwork::Intent::ADD_SLIDER: {
-                auto slider = std::make_shared<Slider>();
+                auto slider = MakeWidget<Slider>();
                 slider->SetRange(0, 100);
                 slider->SetValue(50);
                 widget = slider;
@@ -206,7 +205,7 @@ std::vector<std::shared_ptr<Widget>> NeuralPromptBuilder::GenerateWidgetsFromPar
             }
             
             case NeuralNetwork::Intent::ADD_COMBOBOX: {
-                auto combobox = std::make_shared<ComboBox>();
+                auto combobox = MakeWidget<ComboBox>();
                 // Add items if specified in entities
                 auto items = parsed.GetItems();
                 for (const auto& item : items) {
@@ -217,7 +216,7 @@ std::vector<std::shared_ptr<Widget>> NeuralPromptBuilder::GenerateWidgetsFromPar
             }
             
             case NeuralNetwork::Intent::ADD_LISTBOX: {
-                auto listbox = std::make_shared<ListBox>();
+                auto listbox = MakeWidget<ListBox>();
                 // Add items if specified in entities
                 auto items = parsed.GetItems();
                 for (const auto& item : items) {
@@ -228,7 +227,7 @@ std::vector<std::shared_ptr<Widget>> NeuralPromptBuilder::GenerateWidgetsFromPar
             }
             
             case NeuralNetwork::Intent::ADD_LISTVIEW: {
-                auto listview = std::make_shared<ListView>();
+                auto listview = MakeWidget<ListView>();
                 // Add items if specified in entities
                 auto items = parsed.GetItems();
                 for (const auto& item : items) {
@@ -239,25 +238,25 @@ std::vector<std::shared_ptr<Widget>> NeuralPromptBuilder::GenerateWidgetsFromPar
             }
             
             case NeuralNetwork::Intent::ADD_RADIOBUTTON: {
-                auto radio = std::make_shared<RadioButton>(parsed.GetWidgetText(), 0);
+                auto radio = MakeWidget<RadioButton>(parsed.GetWidgetText(), 0);
                 widget = radio;
                 break;
             }
             
             case NeuralNetwork::Intent::ADD_SPINBOX: {
-                auto spinbox = std::make_shared<SpinBox>();
+                auto spinbox = MakeWidget<SpinBox>();
                 widget = spinbox;
                 break;
             }
             
             case NeuralNetwork::Intent::ADD_SEPARATOR: {
-                auto separator = std::make_shared<Separator>();
+                auto separator = MakeWidget<Separator>();
                 widget = separator;
                 break;
             }
             
             case NeuralNetwork::Intent::ADD_PANEL: {
-                auto panel = std::make_shared<Panel>();
+                auto panel = MakeWidget<Panel>();
                 auto title = parsed.GetWidgetText();
                 if (!title.empty()) {
                     panel->SetTitle(title);
@@ -291,11 +290,10 @@ std::vector<std::shared_ptr<Widget>> NeuralPromptBuilder::GenerateWidgetsFromPar
 }
 
 HWND NeuralPromptBuilder::BuildFromPrompt(const std::wstring& prompt, HINSTANCE hInstance, HWND parent) {
-    // Parse the prompt with neural network
-    auto parsed = m_neuralNetwork->ParsePrompt(prompt);
-    
-    // Convert to WindowSpec
-    auto spec = ConvertToWindowSpec(parsed);
+    // Parsed with the neural network, or taken from the prompt cache
+    auto entry = std::static_pointer_cast<const CachedParse>(LookupPrompt(prompt));
+    const NeuralNetwork::ParsedPrompt& parsed = entry->parsed;
+    const WindowSpec& spec = entry->spec;
     
     // Create the window
     HWND hwnd = CreateWindowFromSpec(spec, hInstance, parent);
@@ -303,12 +301,17 @@ HWND NeuralPromptBuilder::BuildFromPrompt(const std::wstring& prompt, HINSTANCE
         return nullptr;
     }
     
-    // Generate widgets from parsed intent
-    auto widgets = GenerateWidgetsFromParsed(parsed);
-    
-    // Also create widgets from spec (for multi-widget prompts)
-    auto specWidgets = CreateWidgetsFromSpec(spec);
-    widgets.insert(widgets.end(), specWidgets.begin(), specWidgets.end());
+    // Generate widgets from parsed intent, then from the spec (for
+    // multi-widget prompts), all in one arena when enabled
+    std::unique_ptr<WidgetArena> arena = BeginBuildArena();
+    std::vector<std::shared_ptr<Widget>> widgets;
+    {
+        WidgetArena::Scope arenaScope(arena ? arena.get() : WidgetArena::GetCurrent());
+        widgets = GenerateWidgetsFromParsed(parsed);
+        auto specWidgets = CreateWidgetsFromSpec(spec);
+        widgets.insert(widgets.end(), specWidgets.begin(), specWidgets.end());
+    }
+    EndBuildArena(arena.get());
     
     // Create widget manager
     m_lastWidgetManager = std::make_shared<WidgetManager>();
@@ -408,7 +411,8 @@ NeuralPromptBuilder::CallbackSpec NeuralPromptBuilder::ParseCallbackPrompt(const
     CallbackSpec spec;
     
     // Parse with neural network
-    auto parsed = m_neuralNetwork->ParsePrompt(prompt);
+    auto entry = std::static_pointer_cast<const CachedParse>(LookupPrompt(prompt));
+    const NeuralNetwork::ParsedPrompt& parsed = entry->parsed;
     
     spec.widgetText = parsed.GetWidgetText();
     spec.type = parsed.GetCallbackType();
@@ -489,8 +493,21 @@ std::function<void(Widget*, WidgetEvent, void*)> NeuralPromptBuilder::CreateClos
     };
 }
 
+std::shared_ptr<const NeuralNetwork> NeuralPromptBuilder::GetNeuralNetwork() const {
+    // Building the shared model is the expensive part of a builder; one
+    // that is never asked to parse doesn't pay for it
+    if (!m_neuralNetwork) {
+        m_neuralNetwork = NeuralNetwork::GetShared();
+    }
+    return m_neuralNetwork;
+}
+
 void NeuralPromptBuilder::TrainOnData(const std::vector<std::pair<std::wstring, NeuralNetwork::ParsedPrompt>>& trainingData) {
-    m_neuralNetwork->Train(trainingData);
+    // Copy on write: the shared model stays read-only
+    auto trained = std::make_shared<NeuralNetwork>(*GetNeuralNetwork());
+    trained->Train(trainingData);
+    m_neuralNetwork = trained;
+    ClearPromptCache();
 }
 
 } // namespace SDK
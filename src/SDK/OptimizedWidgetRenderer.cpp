@@ -0,0 +1,208 @@
+#include "../../include/SDK/OptimizedWidgetRenderer.h"
+#include "../../include/SDK/Profiler.h"
+#include <chrono>
+
+namespace SDK {
+
+namespace {
+    inline bool Contains(const RECT& outer, const RECT& inner) {
+        return inner.left >= outer.left && inner.top >= outer.top &&
+               inner.right <= outer.right && inner.bottom <= outer.bottom;
+    }
+
+    inline float MillisecondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+OptimizedWidgetRenderer::OptimizedWidgetRenderer(std::shared_ptr<RendererOptimizer> optimizer)
+    : m_optimizer(optimizer)
+{
+}
+
+OptimizedWidgetRenderer::Surface& OptimizedWidgetRenderer::GetSurface(const Widget* widget) {
+    auto it = m_surfaces.find(widget);
+    if (it != m_surfaces.end()) {
+        return it->second;
+    }
+
+    Surface& surface = m_surfaces[widget];
+    widget->GetBounds(surface.bounds);
+    surface.handle = m_optimizer->RegisterElement(
+        "widget:" + std::to_string(reinterpret_cast<uintptr_t>(widget)), surface.bounds);
+    surface.valid = false;
+    return surface;
+}
+
+void OptimizedWidgetRenderer::Render(HDC hdc, const std::vector<std::shared_ptr<Widget>>& widgets,
+                                     const std::vector<RECT>& regions, const RECT& view, Stats& stats,
+                                     LayerCompositor* compositor) {
+    int64_t viewArea = (int64_t)(view.right - view.left) * (view.bottom - view.top);
+
+    // Widgets under opaque ones drawn later are never repainted
+    Widget::CullOccluded(widgets, m_hidden);
+
+    // Widgets to repaint this frame
+    m_frameWidgets.clear();
+    m_frameLayered.clear();
+    m_frameHandles.clear();
+    for (size_t i = 0; i < widgets.size(); i++) {
+        Widget& widget = *widgets[i];
+        RECT bounds;
+        widget.GetCompositeBounds(bounds);
+
+        bool dirty = false;
+        if (widget.IsVisible()) {
+            for (const auto& region : regions) {
+                if (Renderer::RectsIntersect(bounds, region)) {
+                    dirty = true;
+                    break;
+                }
+            }
+        }
+        if (!dirty) {
+            stats.skipped++;
+            continue;
+        }
+        if (m_hidden[i]) {
+            stats.occluded++;
+            continue;
+        }
+
+        // Layers are drawn in order with the rest but not decided on
+        bool layered = compositor && widget.HasLayer();
+        m_frameWidgets.push_back(i);
+        m_frameLayered.push_back(layered ? 1 : 0);
+        if (layered) continue;
+        if (compositor && compositor->HasLayers()) {
+            compositor->RemoveWidget(&widget);
+        }
+
+        Surface& surface = GetSurface(&widget);
+        if (!EqualRect(&bounds, &surface.bounds)) {
+            surface.bounds = bounds;
+            surface.valid = false;
+        }
+        m_optimizer->UpdateElementBounds(surface.handle, bounds, viewArea);
+        m_frameHandles.push_back(surface.handle);
+    }
+    size_t decided = m_frameHandles.size();
+
+    // All of the frame's decisions in one batch
+    m_frameStrategies.resize(decided);
+    m_optimizer->GetOptimalStrategies(m_frameHandles.data(), decided, m_frameStrategies.data());
+
+    size_t next = 0;
+    for (size_t k = 0; k < m_frameWidgets.size(); k++) {
+        SDK_PROFILE_ZONE("Widget::Render");
+        Widget& widget = *widgets[m_frameWidgets[k]];
+        if (m_frameLayered[k]) {
+            if (!compositor->Composite(hdc, widget, stats.layers)) {
+                widget.Render(hdc);
+                stats.rendered++;
+            }
+            continue;
+        }
+
+        Surface& surface = m_surfaces[&widget];
+        const RECT& bounds = surface.bounds;
+        RendererOptimizer::RenderStrategy strategy = m_frameStrategies[next++];
+        auto start = std::chrono::steady_clock::now();
+
+        switch (strategy) {
+            case RendererOptimizer::RenderStrategy::CACHED_RENDER:
+                m_optimizer->RecordCacheAccess(surface.handle, surface.valid);
+                if (surface.valid) {
+                    BitBlt(hdc, bounds.left, bounds.top, bounds.right - bounds.left, bounds.bottom - bounds.top,
+                           surface.cache->GetCacheDC(), 0, 0, SRCCOPY);
+                    stats.cached++;
+                } else {
+                    if (!Capture(hdc, widget, surface, regions)) {
+                        widget.Render(hdc);
+                    }
+                    stats.rendered++;
+                }
+                break;
+
+            case RendererOptimizer::RenderStrategy::LOD_MEDIUM:
+            case RendererOptimizer::RenderStrategy::LOD_LOW:
+                widget.SetDetailLevel(strategy == RendererOptimizer::RenderStrategy::LOD_MEDIUM ? 1 : 2);
+                widget.Render(hdc);
+                widget.SetDetailLevel(0);
+                stats.simplified++;
+                break;
+
+            case RendererOptimizer::RenderStrategy::SKIP_RENDER:
+                // Only occlusion hides a widget, and the cull above did that
+            default:
+                widget.Render(hdc);
+                stats.rendered++;
+                break;
+        }
+
+        m_optimizer->RecordRenderMetrics(surface.handle, MillisecondsSince(start), true);
+    }
+}
+
+bool OptimizedWidgetRenderer::Capture(HDC hdc, Widget& widget, Surface& surface,
+                                      const std::vector<RECT>& regions) {
+    const RECT& bounds = surface.bounds;
+    int width = bounds.right - bounds.left;
+    int height = bounds.bottom - bounds.top;
+    if (width <= 0 || height <= 0) return false;
+
+    // The surface keeps the background, so it must have been repainted under
+    // the whole widget; widgets drawing outside their bounds can't be cached
+    bool fresh = false;
+    for (const auto& region : regions) {
+        if (Contains(region, bounds)) {
+            fresh = true;
+            break;
+        }
+    }
+    RECT hitBounds;
+    widget.GetHitBounds(hitBounds);
+    if (!fresh || !EqualRect(&hitBounds, &bounds)) return false;
+
+    if (!surface.cache || surface.cache->GetWidth() != width || surface.cache->GetHeight() != height) {
+        surface.cache.reset(new Renderer::RenderCache(width, height));
+        if (!surface.cache->GetCacheDC()) {
+            surface.cache.reset();
+            return false;
+        }
+    }
+
+    // Background first, then the widget at its own coordinates
+    HDC cacheDC = surface.cache->GetCacheDC();
+    BitBlt(cacheDC, 0, 0, width, height, hdc, bounds.left, bounds.top, SRCCOPY);
+    POINT origin;
+    SetWindowOrgEx(cacheDC, bounds.left, bounds.top, &origin);
+    widget.Render(cacheDC);
+    SetWindowOrgEx(cacheDC, origin.x, origin.y, nullptr);
+
+    BitBlt(hdc, bounds.left, bounds.top, width, height, cacheDC, 0, 0, SRCCOPY);
+    surface.valid = true;
+    return true;
+}
+
+void OptimizedWidgetRenderer::Invalidate(const RECT& rect) {
+    for (auto& pair : m_surfaces) {
+        Surface& surface = pair.second;
+        if (Renderer::RectsIntersect(surface.bounds, rect)) {
+            surface.valid = false;
+            m_optimizer->MarkElementChanged(surface.handle);
+        }
+    }
+}
+
+void OptimizedWidgetRenderer::InvalidateAll() {
+    for (auto& pair : m_surfaces) {
+        pair.second.valid = false;
+    }
+}
+
+void OptimizedWidgetRenderer::RemoveWidget(const Widget* widget) {
+    m_surfaces.erase(widget);
+}
+
+} // namespace SDK
@@ -0,0 +1,290 @@
+#include "../../include/SDK/ParticleSystem.h"
+#include "../../include/SDK/JobScheduler.h"
+#include "../../include/SDK/PixelKernels.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define SDK_PARTICLE_X86 1
+    #include <emmintrin.h>
+#else
+    #define SDK_PARTICLE_X86 0
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+    #define SDK_PARTICLE_NEON 1
+    #include <arm_neon.h>
+#else
+    #define SDK_PARTICLE_NEON 0
+#endif
+
+namespace SDK {
+
+namespace {
+    // 16K particles is 384 KB of fields per chunk; enough to amortize a task
+    constexpr int INTEGRATE_CHUNK_SIZE = 16 * 1024;
+
+    constexpr float GRAVITY = 50.0f;
+
+    inline uint32_t PackColor(Color color) {
+        return ((uint32_t)color.a << 24) | ((uint32_t)color.r << 16) | ((uint32_t)color.g << 8) | (uint32_t)color.b;
+    }
+
+    inline uint32_t NextRandom(uint32_t& state) {
+        // xorshift32; each queue slot has its own state, so bursts need no lock
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    void IntegrateScalar(float* x, float* y, float* vx, float* vy, float* life,
+                         size_t begin, size_t end, float dt, float gravity, std::vector<uint32_t>& expired) {
+        for (size_t i = begin; i < end; i++) {
+            x[i] += vx[i] * dt;
+            y[i] += vy[i] * dt;
+            life[i] -= dt;
+            vy[i] += gravity * dt;
+            if (life[i] <= 0.0f) expired.push_back((uint32_t)i);
+        }
+    }
+
+#if SDK_PARTICLE_X86
+    void IntegrateSSE2(float* x, float* y, float* vx, float* vy, float* life,
+                       size_t begin, size_t end, float dt, float gravity, std::vector<uint32_t>& expired) {
+        __m128 step = _mm_set1_ps(dt);
+        __m128 fall = _mm_set1_ps(gravity * dt);
+        __m128 zero = _mm_setzero_ps();
+
+        size_t i = begin;
+        for (; i + 4 <= end; i += 4) {
+            __m128 vyi = _mm_loadu_ps(vy + i);
+            _mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i), _mm_mul_ps(_mm_loadu_ps(vx + i), step)));
+            _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(vyi, step)));
+            _mm_storeu_ps(vy + i, _mm_add_ps(vyi, fall));
+
+            __m128 remaining = _mm_sub_ps(_mm_loadu_ps(life + i), step);
+            _mm_storeu_ps(life + i, remaining);
+
+            int dead = _mm_movemask_ps(_mm_cmple_ps(remaining, zero));
+            for (; dead; dead &= dead - 1) {
+                int lane = dead & 1 ? 0 : dead & 2 ? 1 : dead & 4 ? 2 : 3;
+                expired.push_back((uint32_t)(i + lane));
+            }
+        }
+        IntegrateScalar(x, y, vx, vy, life, i, end, dt, gravity, expired);
+    }
+#endif
+
+#if SDK_PARTICLE_NEON
+    void IntegrateNEON(float* x, float* y, float* vx, float* vy, float* life,
+                       size_t begin, size_t end, float dt, float gravity, std::vector<uint32_t>& expired) {
+        float32x4_t step = vdupq_n_f32(dt);
+        float32x4_t fall = vdupq_n_f32(gravity * dt);
+        float32x4_t zero = vdupq_n_f32(0.0f);
+
+        size_t i = begin;
+        for (; i + 4 <= end; i += 4) {
+            float32x4_t vyi = vld1q_f32(vy + i);
+            vst1q_f32(x + i, vmlaq_f32(vld1q_f32(x + i), vld1q_f32(vx + i), step));
+            vst1q_f32(y + i, vmlaq_f32(vld1q_f32(y + i), vyi, step));
+            vst1q_f32(vy + i, vaddq_f32(vyi, fall));
+
+            float32x4_t remaining = vsubq_f32(vld1q_f32(life + i), step);
+            vst1q_f32(life + i, remaining);
+
+            uint32_t lanes[4];
+            vst1q_u32(lanes, vcleq_f32(remaining, zero));
+            for (int lane = 0; lane < 4; lane++) {
+                if (lanes[lane]) expired.push_back((uint32_t)(i + lane));
+            }
+        }
+        IntegrateScalar(x, y, vx, vy, life, i, end, dt, gravity, expired);
+    }
+#endif
+}
+
+ParticleSystem::ParticleSystem(size_t initialCapacity)
+    : m_gravity(GRAVITY)
+    , m_memorySource("ParticleSystem", [this]() { return GetMemoryBytes(); },
+                     [this](size_t targetBytes) { TrimMemory(targetBytes); })
+{
+    Reserve(initialCapacity);
+
+    size_t slots = (size_t)JobScheduler::GetWorkerCount() + 1;
+    for (size_t i = 0; i < slots; i++) {
+        m_pending.push_back(std::make_unique<Pending>());
+        m_pending.back()->random = 0x9E3779B9u * (uint32_t)(i + 1);
+    }
+}
+
+ParticleSystem::Pending& ParticleSystem::GetPending() {
+    // Slot 0 is shared by threads outside the pool; workers get their own
+    size_t slot = (size_t)(JobScheduler::GetCurrentWorkerIndex() + 1);
+    return *m_pending[slot < m_pending.size() ? slot : 0];
+}
+
+void ParticleSystem::Emit(float x, float y, float vx, float vy, float life, Color color) {
+    Pending& pending = GetPending();
+    std::lock_guard<std::mutex> lock(pending.mutex);
+    pending.x.push_back(x);
+    pending.y.push_back(y);
+    pending.vx.push_back(vx);
+    pending.vy.push_back(vy);
+    pending.life.push_back(life);
+    pending.color.push_back(PackColor(color));
+}
+
+void ParticleSystem::EmitBurst(float x, float y, int count, Color color) {
+    if (count <= 0) return;
+
+    Pending& pending = GetPending();
+    std::lock_guard<std::mutex> lock(pending.mutex);
+    uint32_t packed = PackColor(color);
+    for (int i = 0; i < count; i++) {
+        float angle = (float)(NextRandom(pending.random) % 360) * 3.14159f / 180.0f;
+        float speed = 50.0f + (float)(NextRandom(pending.random) % 100);
+        pending.x.push_back(x);
+        pending.y.push_back(y);
+        pending.vx.push_back(std::cos(angle) * speed);
+        pending.vy.push_back(std::sin(angle) * speed - 50.0f);  // Bias upward
+        pending.life.push_back(0.5f + (float)(NextRandom(pending.random) % 100) / 100.0f);
+        pending.color.push_back(packed);
+    }
+}
+
+void ParticleSystem::Kill(size_t index) {
+    Pending& pending = GetPending();
+    std::lock_guard<std::mutex> lock(pending.mutex);
+    pending.kills.push_back((uint32_t)index);
+}
+
+void ParticleSystem::Integrate(size_t begin, size_t end, float deltaTime, std::vector<uint32_t>& expired) {
+    float* x = m_x.data();
+    float* y = m_y.data();
+    float* vx = m_vx.data();
+    float* vy = m_vy.data();
+    float* life = m_life.data();
+
+    PixelKernels::InstructionSet set = PixelKernels::GetActiveInstructionSet();
+#if SDK_PARTICLE_X86
+    if (set == PixelKernels::InstructionSet::SSE2 || set == PixelKernels::InstructionSet::AVX2) {
+        IntegrateSSE2(x, y, vx, vy, life, begin, end, deltaTime, m_gravity, expired);
+        return;
+    }
+#endif
+#if SDK_PARTICLE_NEON
+    if (set == PixelKernels::InstructionSet::NEON) {
+        IntegrateNEON(x, y, vx, vy, life, begin, end, deltaTime, m_gravity, expired);
+        return;
+    }
+#endif
+    (void)set;
+    IntegrateScalar(x, y, vx, vy, life, begin, end, deltaTime, m_gravity, expired);
+}
+
+void ParticleSystem::Update(float deltaTime) {
+    size_t count = m_x.size();
+
+    // Integrate; each chunk records its own expired indices
+    size_t chunks = (count + INTEGRATE_CHUNK_SIZE - 1) / INTEGRATE_CHUNK_SIZE;
+    if (m_expired.size() < chunks) m_expired.resize(chunks);
+    for (size_t i = 0; i < chunks; i++) m_expired[i].clear();
+
+    JobScheduler::ParallelFor((int)count, INTEGRATE_CHUNK_SIZE, [&](int begin, int end) {
+        Integrate((size_t)begin, (size_t)end, deltaTime, m_expired[begin / INTEGRATE_CHUNK_SIZE]);
+    }, "ParticleIntegrate");
+
+    // Highest index first, so the particle swapped into a freed slot has
+    // already been checked
+    std::vector<uint32_t>& kills = m_pending[0]->kills;
+    for (size_t i = 0; i < chunks; i++) {
+        kills.insert(kills.end(), m_expired[i].begin(), m_expired[i].end());
+    }
+    for (size_t slot = 1; slot < m_pending.size(); slot++) {
+        std::vector<uint32_t>& queued = m_pending[slot]->kills;
+        kills.insert(kills.end(), queued.begin(), queued.end());
+        queued.clear();
+    }
+    std::sort(kills.begin(), kills.end(), [](uint32_t a, uint32_t b) { return a > b; });
+    kills.erase(std::unique(kills.begin(), kills.end()), kills.end());
+
+    for (uint32_t index : kills) {
+        if (index >= m_x.size()) continue;
+        size_t last = m_x.size() - 1;
+        m_x[index] = m_x[last];             m_x.pop_back();
+        m_y[index] = m_y[last];             m_y.pop_back();
+        m_vx[index] = m_vx[last];           m_vx.pop_back();
+        m_vy[index] = m_vy[last];           m_vy.pop_back();
+        m_life[index] = m_life[last];       m_life.pop_back();
+        m_color[index] = m_color[last];     m_color.pop_back();
+    }
+    kills.clear();
+
+    // Emissions in slot order, so the layout doesn't depend on timing
+    for (auto& pending : m_pending) {
+        m_x.insert(m_x.end(), pending->x.begin(), pending->x.end());
+        m_y.insert(m_y.end(), pending->y.begin(), pending->y.end());
+        m_vx.insert(m_vx.end(), pending->vx.begin(), pending->vx.end());
+        m_vy.insert(m_vy.end(), pending->vy.begin(), pending->vy.end());
+        m_life.insert(m_life.end(), pending->life.begin(), pending->life.end());
+        m_color.insert(m_color.end(), pending->color.begin(), pending->color.end());
+        pending->x.clear();
+        pending->y.clear();
+        pending->vx.clear();
+        pending->vy.clear();
+        pending->life.clear();
+        pending->color.clear();
+    }
+}
+
+void ParticleSystem::Clear() {
+    m_x.clear();
+    m_y.clear();
+    m_vx.clear();
+    m_vy.clear();
+    m_life.clear();
+    m_color.clear();
+    for (auto& pending : m_pending) {
+        std::lock_guard<std::mutex> lock(pending->mutex);
+        pending->x.clear();
+        pending->y.clear();
+        pending->vx.clear();
+        pending->vy.clear();
+        pending->life.clear();
+        pending->color.clear();
+        pending->kills.clear();
+    }
+}
+
+void ParticleSystem::Reserve(size_t capacity) {
+    m_x.reserve(capacity);
+    m_y.reserve(capacity);
+    m_vx.reserve(capacity);
+    m_vy.reserve(capacity);
+    m_life.reserve(capacity);
+    m_color.reserve(capacity);
+}
+
+size_t ParticleSystem::GetMemoryBytes() const {
+    size_t bytes = (m_x.capacity() + m_y.capacity() + m_vx.capacity() + m_vy.capacity() + m_life.capacity()) * sizeof(float) +
+                   m_color.capacity() * sizeof(uint32_t);
+    for (const auto& expired : m_expired) {
+        bytes += expired.capacity() * sizeof(uint32_t);
+    }
+    return bytes;
+}
+
+// Runs between frames, like Clear(); keeps the live particles
+void ParticleSystem::TrimMemory(size_t targetBytes) {
+    if (GetMemoryBytes() <= targetBytes) return;
+    m_x.shrink_to_fit();
+    m_y.shrink_to_fit();
+    m_vx.shrink_to_fit();
+    m_vy.shrink_to_fit();
+    m_life.shrink_to_fit();
+    m_color.shrink_to_fit();
+    std::vector<std::vector<uint32_t>>().swap(m_expired);
+}
+
+} // namespace SDK
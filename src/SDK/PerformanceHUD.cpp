@@ -0,0 +1,301 @@
+#include "../../include/SDK/PerformanceHUD.h"
+#include "../../include/SDK/WindowManager.h"
+#include "../../include/SDK/FrameClock.h"
+#include "../../include/SDK/FontCache.h"
+#include "../../include/SDK/GdiObjectCache.h"
+#include "../../include/SDK/ShadowCache.h"
+#include "../../include/SDK/TextureAtlas.h"
+#include "../../include/SDK/RendererOptimizer.h"
+#include "../../include/SDK/D2DRenderBackend.h"
+#include "../../include/SDK/ParticleSystem.h"
+#include "../../include/SDK/MemoryRegistry.h"
+#include <algorithm>
+#include <cstdarg>
+#include <cstring>
+#include <cwchar>
+
+namespace SDK {
+
+namespace {
+    const int PADDING = 6;
+    const int HISTOGRAM_HEIGHT = 40;
+    const size_t MEMORY_SOURCES = 3;    // Largest sources listed under the total
+    const double MEGABYTE = 1024.0 * 1024.0;
+
+    std::wstring FormatLine(const wchar_t* format, ...) {
+        wchar_t buffer[256];
+        va_list args;
+        va_start(args, format);
+        vswprintf(buffer, 256, format, args);
+        va_end(args);
+        return buffer;
+    }
+
+    // "--" until the cache has been asked anything
+    std::wstring FormatHitRate(uint64_t hits, uint64_t misses) {
+        if (hits + misses == 0) return L"--";
+        return FormatLine(L"%.1f%%", 100.0 * (double)hits / (double)(hits + misses));
+    }
+
+    struct WindowCost {
+        HWND hwnd;
+        float renderTime;
+        long long pixels;
+        int dirtyRects;
+    };
+}
+
+PerformanceHUD::PerformanceHUD()
+    : Widget()
+    , m_sampleInterval(0.25f)
+    , m_sinceSample(0.0f)
+    , m_maxWindows(4)
+    , m_histogramScale(1.0f / 30.0f)
+    , m_d2dBackend(nullptr)
+    , m_backgroundColor(Color(20, 20, 24, 255))
+    , m_textColor(Color(220, 220, 220, 255))
+    , m_hudTime(0.0f)
+    , m_panelDC(nullptr)
+    , m_panelBitmap(nullptr)
+    , m_panelPixels(nullptr)
+    , m_panelWidth(0)
+    , m_panelHeight(0)
+    , m_panelDirty(true)
+{
+    m_width = 320;
+    m_height = 280;
+    SetFontFamily(L"Consolas");
+    SetFontSize(12);
+}
+
+PerformanceHUD::~PerformanceHUD() {
+    ReleasePanel();
+}
+
+void PerformanceHUD::TrackParticleSystem(const ParticleSystem* system) {
+    if (system && std::find(m_particleSystems.begin(), m_particleSystems.end(), system) == m_particleSystems.end()) {
+        m_particleSystems.push_back(system);
+    }
+}
+
+void PerformanceHUD::UntrackParticleSystem(const ParticleSystem* system) {
+    m_particleSystems.erase(std::remove(m_particleSystems.begin(), m_particleSystems.end(), system),
+                            m_particleSystems.end());
+}
+
+void PerformanceHUD::AddCounter(const std::wstring& label, CounterSource source) {
+    if (source) m_counters.push_back({ label, source });
+}
+
+void PerformanceHUD::Update(float deltaTime) {
+    Widget::Update(deltaTime);
+
+    // Frames from the HUD's own updates when the application doesn't run the frame clock
+    m_updateDeltas.push_back(deltaTime);
+    if ((int)m_updateDeltas.size() > FrameClock::GetFrameHistoryCapacity()) {
+        m_updateDeltas.erase(m_updateDeltas.begin());
+    }
+
+    m_sinceSample += deltaTime;
+    if (m_sinceSample >= m_sampleInterval) {
+        Sample();
+    }
+    ScheduleUpdate();   // Measures frames, so ticks on every one
+}
+
+void PerformanceHUD::Sample() {
+    auto start = std::chrono::steady_clock::now();
+    m_sinceSample = 0.0f;
+    m_lines.clear();
+
+    WindowManager& manager = WindowManager::GetInstance();
+    const FrameClock& clock = manager.GetFrameClock();
+    float history[FrameClock::GetFrameHistoryCapacity()];
+    int count = clock.GetFrameTimeHistory(history, FrameClock::GetFrameHistoryCapacity());
+    if (count > 0) {
+        m_frameTimes.assign(history, history + count);
+    } else {
+        m_frameTimes = m_updateDeltas;
+    }
+
+    float total = 0.0f;
+    float worst = 0.0f;
+    for (float frameTime : m_frameTimes) {
+        total += frameTime;
+        worst = (std::max)(worst, frameTime);
+    }
+    float average = m_frameTimes.empty() ? 0.0f : total / (float)m_frameTimes.size();
+    m_lines.push_back(FormatLine(L"FPS %5.1f  avg %5.2f ms  max %5.2f ms",
+                                 average > 0.0f ? 1.0f / average : 0.0f, average * 1000.0f, worst * 1000.0f));
+    if (count > 0) {
+        const FrameClock::FrameTiming& timing = clock.GetLastFrameTiming();
+        m_lines.push_back(FormatLine(L"work %5.2f ms  wait %5.2f ms  missed %d",
+                                     timing.workTime * 1000.0f, timing.waitTime * 1000.0f, timing.missedRefreshes));
+    }
+
+    // Windows by what their last render cost
+    std::vector<WindowCost> costs;
+    float optimizerHitRate = 0.0f;
+    int optimizedWindows = 0;
+    WindowRegistry::SnapshotPtr windows = manager.GetWindowSnapshot();
+    if (windows) {
+        for (const auto& window : windows->byDepth) {
+            if (!window || !window->IsValid()) continue;
+            const Window::FrameStats& stats = window->GetFrameStats();
+            costs.push_back({ window->GetHandle(), stats.renderTime, stats.repaintedPixels, stats.dirtyRects });
+            if (auto optimizer = window->GetRenderOptimizer()) {
+                optimizerHitRate += optimizer->GetStats().cacheHitRate;
+                optimizedWindows++;
+            }
+        }
+    }
+    float renderTotal = 0.0f;
+    long long pixelTotal = 0;
+    for (const WindowCost& cost : costs) {
+        renderTotal += cost.renderTime;
+        pixelTotal += cost.pixels;
+    }
+    std::sort(costs.begin(), costs.end(),
+              [](const WindowCost& a, const WindowCost& b) { return a.renderTime > b.renderTime; });
+    m_lines.push_back(FormatLine(L"windows %d  render %5.2f ms  %lld px", (int)costs.size(),
+                                 renderTotal * 1000.0f, pixelTotal));
+    for (size_t i = 0; i < costs.size() && (int)i < m_maxWindows; i++) {
+        m_lines.push_back(FormatLine(L"  %p %5.2f ms %9lld px %2d rects", (void*)costs[i].hwnd,
+                                     costs[i].renderTime * 1000.0f, costs[i].pixels, costs[i].dirtyRects));
+    }
+
+    HANDLE process = GetCurrentProcess();
+    m_lines.push_back(FormatLine(L"GDI objects %lu  USER objects %lu",
+                                 (unsigned long)GdiHandleCounter::GetProcessCount(),
+                                 (unsigned long)GetGuiResources(process, GR_USEROBJECTS)));
+    // SDK-held handles by subsystem, the empty ones left out
+    std::wstring handles = L" ";
+    for (int i = 0; i < (int)GdiSubsystem::COUNT; i++) {
+        int64_t live = GdiHandleCounter::GetLive((GdiSubsystem)i);
+        if (live == 0) continue;
+        const char* name = GdiHandleCounter::GetName((GdiSubsystem)i);
+        handles += L" " + std::wstring(name, name + strlen(name)) + FormatLine(L" %lld", (long long)live);
+    }
+    if (handles.size() > 1) m_lines.push_back(handles);
+    if (m_d2dBackend) {
+        D2DRenderBackend::ResourceStats d2d = m_d2dBackend->GetResourceStats();
+        m_lines.push_back(FormatLine(L"D2D brushes %zu  gradients %zu  formats %zu  layouts %zu",
+                                     d2d.brushes, d2d.gradients, d2d.textFormats, d2d.textLayouts));
+        m_lines.push_back(FormatLine(L"D2D bitmaps %zu  effects %zu  resets %llu",
+                                     d2d.scratchBitmaps, d2d.effects, (unsigned long long)d2d.deviceResets));
+    }
+
+    FontCache::Stats fonts = FontCache::GetStats();
+    ShadowCache::Stats shadows = ShadowCache::GetStats();
+    const TextureAtlas& atlas = TextureAtlas::GetShared();
+    m_lines.push_back(L"font " + FormatHitRate(fonts.hits, fonts.misses) + FormatLine(L" (%zu)", fonts.size) +
+                      L"  shadow " + FormatHitRate(shadows.hits, shadows.misses) + FormatLine(L" (%zu)", shadows.size));
+    GdiObjectCache::Stats objects = GdiObjectCache::GetStats();
+    m_lines.push_back(L"pens/brushes " + FormatHitRate(objects.hits, objects.misses) +
+                      FormatLine(L" (%zu)", objects.size));
+    m_lines.push_back(L"atlas " + FormatHitRate(atlas.GetHitCount(), atlas.GetMissCount()) +
+                      FormatLine(L" (%zu)", atlas.GetTextureCount()) + L"  optimizer " +
+                      (optimizedWindows > 0 ? FormatLine(L"%.1f%%", 100.0f * optimizerHitRate / optimizedWindows)
+                                            : std::wstring(L"--")));
+
+    if (!m_particleSystems.empty()) {
+        size_t particles = 0;
+        for (const ParticleSystem* system : m_particleSystems) {
+            particles += system->GetCount();
+        }
+        m_lines.push_back(FormatLine(L"particles %zu in %d systems", particles, (int)m_particleSystems.size()));
+    }
+
+    std::vector<MemoryRegistry::Usage> memory = MemoryRegistry::Sample();
+    m_lines.push_back(FormatLine(L"memory %.2f MB  peak %.2f MB",
+                                 MemoryRegistry::GetTotalBytes() / MEGABYTE,
+                                 MemoryRegistry::GetTotalPeak() / MEGABYTE));
+    std::wstring sources = L" ";
+    for (size_t i = 0; i < memory.size() && i < MEMORY_SOURCES && memory[i].bytes > 0; i++) {
+        const char* name = memory[i].name;
+        sources += L" " + std::wstring(name, name + strlen(name)) + FormatLine(L" %.2f", memory[i].bytes / MEGABYTE);
+    }
+    if (sources.size() > 1) m_lines.push_back(sources);
+
+    for (const Counter& counter : m_counters) {
+        m_lines.push_back(counter.label + FormatLine(L" %.6g", counter.source()));
+    }
+
+    m_lines.push_back(FormatLine(L"HUD %.3f ms per sample", m_hudTime * 1000.0f));
+
+    m_panelDirty = true;
+    m_hudTime = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+    Invalidate();
+}
+
+void PerformanceHUD::Render(HDC hdc) {
+    if (!m_visible || m_width <= 0 || m_height <= 0) return;
+
+    if (!m_panelDC || m_panelWidth != m_width || m_panelHeight != m_height) {
+        ReleasePanel();
+        m_panelDC = Renderer::CreateDIBMemoryDC(m_width, m_height, &m_panelBitmap, &m_panelPixels);
+        if (!m_panelDC) return;
+        m_panelWidth = m_width;
+        m_panelHeight = m_height;
+        m_panelDirty = true;
+    }
+    if (m_panelDirty) {
+        auto start = std::chrono::steady_clock::now();
+        DrawPanel();
+        m_hudTime += std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+        m_panelDirty = false;
+    }
+
+    BitBlt(hdc, m_x, m_y, m_panelWidth, m_panelHeight, m_panelDC, 0, 0, SRCCOPY);
+}
+
+void PerformanceHUD::DrawPanel() {
+    RECT panel = { 0, 0, m_panelWidth, m_panelHeight };
+    HBRUSH background = GdiObjectCache::GetBrush(RGB(m_backgroundColor.r, m_backgroundColor.g, m_backgroundColor.b));
+    FillRect(m_panelDC, &panel, background);
+
+    ScopedFont font(m_panelDC, GetFont());
+    TEXTMETRICW metrics;
+    GetTextMetricsW(m_panelDC, &metrics);
+    int lineHeight = (std::max)(1, (int)metrics.tmHeight);
+    SetBkMode(m_panelDC, TRANSPARENT);
+    ::SetTextColor(m_panelDC, RGB(m_textColor.r, m_textColor.g, m_textColor.b));
+
+    // The FPS line, then the histogram under it
+    int y = PADDING;
+    for (size_t i = 0; i < m_lines.size() && y < m_panelHeight; i++) {
+        TextOutW(m_panelDC, PADDING, y, m_lines[i].c_str(), (int)m_lines[i].size());
+        y += lineHeight;
+        if (i == 0) {
+            y += 2;
+            RECT histogram = { PADDING, y, m_panelWidth - PADDING, y + HISTOGRAM_HEIGHT };
+            int columns = FrameClock::GetFrameHistoryCapacity();
+            int barWidth = (std::max)(1, (int)(histogram.right - histogram.left) / columns);
+
+            // Green within a 60 Hz frame, yellow within two, red beyond
+            HBRUSH good = GdiObjectCache::GetBrush(RGB(80, 200, 120));
+            HBRUSH slow = GdiObjectCache::GetBrush(RGB(230, 190, 60));
+            HBRUSH late = GdiObjectCache::GetBrush(RGB(230, 80, 70));
+            int first = (std::max)(0, (int)m_frameTimes.size() - columns);
+            for (size_t f = first; f < m_frameTimes.size(); f++) {
+                float frameTime = m_frameTimes[f];
+                int height = (int)(HISTOGRAM_HEIGHT * (std::min)(1.0f, frameTime / m_histogramScale));
+                int left = histogram.left + (int)(f - first) * barWidth;
+                RECT bar = { left, histogram.bottom - (std::max)(1, height), left + (std::max)(1, barWidth - 1), histogram.bottom };
+                FillRect(m_panelDC, &bar, frameTime <= 1.05f / 60.0f ? good : frameTime <= 2.1f / 60.0f ? slow : late);
+            }
+            y = histogram.bottom + 4;
+        }
+    }
+}
+
+void PerformanceHUD::ReleasePanel() {
+    if (m_panelDC) Renderer::DeleteMemoryDC(m_panelDC, m_panelBitmap);
+    m_panelDC = nullptr;
+    m_panelBitmap = nullptr;
+    m_panelPixels = nullptr;
+    m_panelWidth = 0;
+    m_panelHeight = 0;
+}
+
+} // namespace SDK
@@ -0,0 +1,1303 @@
+#include "../../include/SDK/PixelKernels.h"
+#include "../../include/SDK/TileScheduler.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define SDK_PIXEL_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #endif
+#else
+    #define SDK_PIXEL_X86 0
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+    #define SDK_PIXEL_NEON 1
+    #include <arm_neon.h>
+#else
+    #define SDK_PIXEL_NEON 0
+#endif
+
+#if SDK_PIXEL_X86 && (defined(__GNUC__) || defined(__clang__))
+    #define SDK_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+    #define SDK_TARGET_AVX2
+#endif
+
+namespace SDK {
+
+namespace {
+    // The SIMD kernels divide by multiplying with a float reciprocal. That is
+    // bit-exact with integer division only while the window stays below this size.
+    constexpr int MAX_SIMD_WINDOW = 8191;
+
+    inline void AddPixel(uint32_t* sum, uint32_t p) {
+        sum[0] += p & 0xFF;
+        sum[1] += (p >> 8) & 0xFF;
+        sum[2] += (p >> 16) & 0xFF;
+        sum[3] += p >> 24;
+    }
+
+    inline void SubPixel(uint32_t* sum, uint32_t p) {
+        sum[0] -= p & 0xFF;
+        sum[1] -= (p >> 8) & 0xFF;
+        sum[2] -= (p >> 16) & 0xFF;
+        sum[3] -= p >> 24;
+    }
+
+    inline uint32_t AveragePixel(const uint32_t* sum, uint32_t count) {
+        return (sum[0] / count) | ((sum[1] / count) << 8) | ((sum[2] / count) << 16) | ((sum[3] / count) << 24);
+    }
+
+    // ==================== SCALAR SLIDING WINDOW ====================
+
+    void BlurRowsScalar(const uint32_t* src, int srcStride, uint32_t* dst, int dstStride,
+                        int width, int height, int radius) {
+        for (int y = 0; y < height; y++) {
+            const uint32_t* in = src + (size_t)y * srcStride;
+            uint32_t* out = dst + (size_t)y * dstStride;
+
+            uint32_t sum[4] = { 0, 0, 0, 0 };
+            uint32_t count = 0;
+            int initEnd = std::min(radius, width - 1);
+            for (int x = 0; x <= initEnd; x++) {
+                AddPixel(sum, in[x]);
+                count++;
+            }
+
+            for (int x = 0; x < width; x++) {
+                out[x] = AveragePixel(sum, count);
+                if (x + radius + 1 < width) {
+                    AddPixel(sum, in[x + radius + 1]);
+                    count++;
+                }
+                if (x - radius >= 0) {
+                    SubPixel(sum, in[x - radius]);
+                    count--;
+                }
+            }
+        }
+    }
+
+    void BlurColumnsScalar(const uint32_t* src, int srcStride, uint32_t* dst, int dstStride,
+                           int width, int height, int radius) {
+        std::vector<uint32_t> sums((size_t)width * 4, 0);
+        uint32_t count = 0;
+
+        int initEnd = std::min(radius, height - 1);
+        for (int y = 0; y <= initEnd; y++) {
+            const uint32_t* in = src + (size_t)y * srcStride;
+            for (int x = 0; x < width; x++) {
+                AddPixel(&sums[(size_t)x * 4], in[x]);
+            }
+            count++;
+        }
+
+        for (int y = 0; y < height; y++) {
+            uint32_t* out = dst + (size_t)y * dstStride;
+            for (int x = 0; x < width; x++) {
+                out[x] = AveragePixel(&sums[(size_t)x * 4], count);
+            }
+            if (y + radius + 1 < height) {
+                const uint32_t* in = src + (size_t)(y + radius + 1) * srcStride;
+                for (int x = 0; x < width; x++) {
+                    AddPixel(&sums[(size_t)x * 4], in[x]);
+                }
+                count++;
+            }
+            if (y - radius >= 0) {
+                const uint32_t* in = src + (size_t)(y - radius) * srcStride;
+                for (int x = 0; x < width; x++) {
+                    SubPixel(&sums[(size_t)x * 4], in[x]);
+                }
+                count--;
+            }
+        }
+    }
+
+    void AddSaturateScalar(uint32_t* dst, const uint32_t* src, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            uint32_t result = 0;
+            for (int shift = 0; shift < 32; shift += 8) {
+                uint32_t c = ((dst[i] >> shift) & 0xFF) + ((src[i] >> shift) & 0xFF);
+                result |= std::min<uint32_t>(c, 255) << shift;
+            }
+            dst[i] = result;
+        }
+    }
+
+    // ==================== PARTICLES ====================
+
+    // 16K particles per binning task
+    constexpr size_t SPLAT_CHUNK_SIZE = 16 * 1024;
+
+    // Top-left of a particle's square; false when it misses the buffer entirely
+    inline bool GetSplatOrigin(float x, float y, int originX, int originY, int width, int height, int size,
+                               int& left, int& top) {
+        float px = x - (float)originX;
+        float py = y - (float)originY;
+        // Also rejects NaN
+        if (!(px > (float)-size && px < (float)(width + size) && py > (float)-size && py < (float)(height + size))) {
+            return false;
+        }
+        left = (int)std::floor(px) - size / 2;
+        top = (int)std::floor(py) - size / 2;
+        return left < width && top < height && left + size > 0 && top + size > 0;
+    }
+
+    // Source-over in two 16-bit lanes per multiply; the alpha lane blends a
+    // source alpha of 255, giving alpha + dstAlpha * (255 - alpha) / 255.
+    // (t + (t >> 8)) >> 8 with t = v + 128 rounds v / 255 exactly.
+    inline uint32_t BlendOver(uint32_t dst, uint32_t src, uint32_t alpha) {
+        uint32_t inv = 255 - alpha;
+        uint32_t rb = (src & 0x00FF00FFu) * alpha + (dst & 0x00FF00FFu) * inv + 0x00800080u;
+        uint32_t ag = (((src >> 8) & 0xFFu) | 0x00FF0000u) * alpha + ((dst >> 8) & 0x00FF00FFu) * inv + 0x00800080u;
+        rb = ((rb + ((rb >> 8) & 0x00FF00FFu)) >> 8) & 0x00FF00FFu;
+        ag = ((ag + ((ag >> 8) & 0x00FF00FFu)) >> 8) & 0x00FF00FFu;
+        return rb | (ag << 8);
+    }
+
+    // Blends one square, clipped to columns [0, width) and rows [rowBegin, rowEnd)
+    void SplatSquare(uint32_t* pixels, int width, int stride, int rowBegin, int rowEnd,
+                     int left, int top, int size, uint32_t color) {
+        uint32_t alpha = color >> 24;
+        if (alpha == 0) return;
+
+        int x0 = std::max(0, left);
+        int x1 = std::min(width, left + size);
+        int y0 = std::max(rowBegin, top);
+        int y1 = std::min(rowEnd, top + size);
+        for (int py = y0; py < y1; py++) {
+            uint32_t* row = pixels + (size_t)py * stride;
+            for (int px = x0; px < x1; px++) {
+                row[px] = alpha == 255 ? color : BlendOver(row[px], color, alpha);
+            }
+        }
+    }
+
+    // ==================== BLENDING ====================
+    // Premultiplied channels all blend alike, so the SIMD kernels need no
+    // per-channel cases and match these bit for bit.
+
+    inline uint32_t ScalePixel(uint32_t p, uint32_t factor) {
+        uint32_t result = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            result |= PremultipliedPixel::MulDiv255((p >> shift) & 0xFF, factor) << shift;
+        }
+        return result;
+    }
+
+    void BlendOverScalar(uint32_t* dst, const uint32_t* src, size_t count, uint32_t opacity) {
+        for (size_t i = 0; i < count; i++) {
+            uint32_t s = opacity == 255 ? src[i] : ScalePixel(src[i], opacity);
+            dst[i] = PremultipliedPixel::Over(dst[i], s);
+        }
+    }
+
+    void BlendMultiplyScalar(uint32_t* dst, const uint32_t* src, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            uint32_t s = src[i];
+            uint32_t d = dst[i];
+            uint32_t invSrc = 255 - (s >> 24);
+            uint32_t invDst = 255 - (d >> 24);
+            uint32_t result = 0;
+            for (int shift = 0; shift < 32; shift += 8) {
+                uint32_t sc = (s >> shift) & 0xFF;
+                uint32_t dc = (d >> shift) & 0xFF;
+                uint32_t c = PremultipliedPixel::MulDiv255(sc, dc) + PremultipliedPixel::MulDiv255(sc, invDst) +
+                             PremultipliedPixel::MulDiv255(dc, invSrc);
+                result |= std::min<uint32_t>(c, 255) << shift;
+            }
+            dst[i] = result;
+        }
+    }
+
+    void ScaleScalar(uint32_t* pixels, size_t count, uint32_t opacity) {
+        for (size_t i = 0; i < count; i++) {
+            pixels[i] = ScalePixel(pixels[i], opacity);
+        }
+    }
+
+    void PremultiplyScalar(uint32_t* pixels, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            pixels[i] = PremultipliedPixel::FromStraight(pixels[i]);
+        }
+    }
+
+    // ==================== SSE2 ====================
+
+#if SDK_PIXEL_X86
+    inline __m128i LoadPixelSSE2(uint32_t p) {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i v = _mm_cvtsi32_si128((int)p);
+        v = _mm_unpacklo_epi8(v, zero);
+        return _mm_unpacklo_epi16(v, zero);
+    }
+
+    inline __m128i DivideSSE2(__m128i sum, __m128 inv) {
+        __m128 f = _mm_mul_ps(_mm_add_ps(_mm_cvtepi32_ps(sum), _mm_set1_ps(0.5f)), inv);
+        return _mm_cvttps_epi32(f);
+    }
+
+    inline uint32_t PackPixelSSE2(__m128i q) {
+        q = _mm_packs_epi32(q, q);
+        q = _mm_packus_epi16(q, q);
+        return (uint32_t)_mm_cvtsi128_si32(q);
+    }
+
+    void BlurRowsSSE2(const uint32_t* src, int srcStride, uint32_t* dst, int dstStride,
+                      int width, int height, int radius) {
+        // Reciprocals only depend on the window size, which repeats for every row
+        std::vector<float> reciprocals((size_t)radius * 2 + 2, 0.0f);
+        for (size_t i = 1; i < reciprocals.size(); i++) {
+            reciprocals[i] = 1.0f / (float)i;
+        }
+
+        for (int y = 0; y < height; y++) {
+            const uint32_t* in = src + (size_t)y * srcStride;
+            uint32_t* out = dst + (size_t)y * dstStride;
+
+            __m128i sum = _mm_setzero_si128();
+            int count = 0;
+            int initEnd = std::min(radius, width - 1);
+            for (int x = 0; x <= initEnd; x++) {
+                sum = _mm_add_epi32(sum, LoadPixelSSE2(in[x]));
+                count++;
+            }
+
+            for (int x = 0; x < width; x++) {
+                out[x] = PackPixelSSE2(DivideSSE2(sum, _mm_set1_ps(reciprocals[count])));
+                if (x + radius + 1 < width) {
+                    sum = _mm_add_epi32(sum, LoadPixelSSE2(in[x + radius + 1]));
+                    count++;
+                }
+                if (x - radius >= 0) {
+                    sum = _mm_sub_epi32(sum, LoadPixelSSE2(in[x - radius]));
+                    count--;
+                }
+            }
+        }
+    }
+
+    void BlurColumnsSSE2(const uint32_t* src, int srcStride, uint32_t* dst, int dstStride,
+                         int width, int height, int radius) {
+        // Plain storage avoids std::vector<__m128i>; each pixel owns four int32 lanes
+        std::vector<int32_t> storage((size_t)width * 4, 0);
+        __m128i* sums = reinterpret_cast<__m128i*>(storage.data());
+        int count = 0;
+
+        int initEnd = std::min(radius, height - 1);
+        for (int y = 0; y <= initEnd; y++) {
+            const uint32_t* in = src + (size_t)y * srcStride;
+            for (int x = 0; x < width; x++) {
+                _mm_storeu_si128(sums + x, _mm_add_epi32(_mm_loadu_si128(sums + x), LoadPixelSSE2(in[x])));
+            }
+            count++;
+        }
+
+        for (int y = 0; y < height; y++) {
+            uint32_t* out = dst + (size_t)y * dstStride;
+            __m128 inv = _mm_set1_ps(1.0f / (float)count);
+            for (int x = 0; x < width; x++) {
+                out[x] = PackPixelSSE2(DivideSSE2(_mm_loadu_si128(sums + x), inv));
+            }
+            if (y + radius + 1 < height) {
+                const uint32_t* in = src + (size_t)(y + radius + 1) * srcStride;
+                for (int x = 0; x < width; x++) {
+                    _mm_storeu_si128(sums + x, _mm_add_epi32(_mm_loadu_si128(sums + x), LoadPixelSSE2(in[x])));
+                }
+                count++;
+            }
+            if (y - radius >= 0) {
+                const uint32_t* in = src + (size_t)(y - radius) * srcStride;
+                for (int x = 0; x < width; x++) {
+                    _mm_storeu_si128(sums + x, _mm_sub_epi32(_mm_loadu_si128(sums + x), LoadPixelSSE2(in[x])));
+                }
+                count--;
+            }
+        }
+    }
+
+    // Premultiplied blends on two pixels at a time, widened to 16-bit lanes
+    inline __m128i MulDiv255SSE2(__m128i a, __m128i b) {
+        __m128i v = _mm_add_epi16(_mm_mullo_epi16(a, b), _mm_set1_epi16(128));
+        return _mm_srli_epi16(_mm_add_epi16(v, _mm_srli_epi16(v, 8)), 8);
+    }
+
+    inline __m128i BroadcastAlphaSSE2(__m128i p) {
+        return _mm_shufflehi_epi16(_mm_shufflelo_epi16(p, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    }
+
+    inline __m128i OverSSE2(__m128i d, __m128i s, __m128i opacity, bool scale) {
+        if (scale) s = MulDiv255SSE2(s, opacity);
+        __m128i inv = _mm_sub_epi16(_mm_set1_epi16(255), BroadcastAlphaSSE2(s));
+        return _mm_add_epi16(s, MulDiv255SSE2(d, inv));
+    }
+
+    inline __m128i MultiplySSE2(__m128i d, __m128i s) {
+        __m128i full = _mm_set1_epi16(255);
+        __m128i invSrc = _mm_sub_epi16(full, BroadcastAlphaSSE2(s));
+        __m128i invDst = _mm_sub_epi16(full, BroadcastAlphaSSE2(d));
+        return _mm_add_epi16(_mm_add_epi16(MulDiv255SSE2(s, d), MulDiv255SSE2(s, invDst)), MulDiv255SSE2(d, invSrc));
+    }
+
+    // Alpha broadcast to the color lanes, 255 in the alpha lane
+    inline __m128i PremultiplyFactorSSE2(__m128i p) {
+        __m128i colorLanes = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+        __m128i alphaLane = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+        return _mm_or_si128(_mm_and_si128(BroadcastAlphaSSE2(p), colorLanes), alphaLane);
+    }
+
+    void BlendOverSSE2(uint32_t* dst, const uint32_t* src, size_t count, uint32_t opacity) {
+        __m128i zero = _mm_setzero_si128();
+        __m128i factor = _mm_set1_epi16((short)opacity);
+        bool scale = opacity != 255;
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+            __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+            __m128i lo = OverSSE2(_mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi8(s, zero), factor, scale);
+            __m128i hi = OverSSE2(_mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi8(s, zero), factor, scale);
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(lo, hi));
+        }
+        BlendOverScalar(dst + i, src + i, count - i, opacity);
+    }
+
+    void BlendMultiplySSE2(uint32_t* dst, const uint32_t* src, size_t count) {
+        __m128i zero = _mm_setzero_si128();
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+            __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+            __m128i lo = MultiplySSE2(_mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi8(s, zero));
+            __m128i hi = MultiplySSE2(_mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi8(s, zero));
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(lo, hi));
+        }
+        BlendMultiplyScalar(dst + i, src + i, count - i);
+    }
+
+    void ScaleSSE2(uint32_t* pixels, size_t count, uint32_t opacity) {
+        __m128i zero = _mm_setzero_si128();
+        __m128i factor = _mm_set1_epi16((short)opacity);
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128i p = _mm_loadu_si128((const __m128i*)(pixels + i));
+            __m128i lo = MulDiv255SSE2(_mm_unpacklo_epi8(p, zero), factor);
+            __m128i hi = MulDiv255SSE2(_mm_unpackhi_epi8(p, zero), factor);
+            _mm_storeu_si128((__m128i*)(pixels + i), _mm_packus_epi16(lo, hi));
+        }
+        ScaleScalar(pixels + i, count - i, opacity);
+    }
+
+    void PremultiplySSE2(uint32_t* pixels, size_t count) {
+        __m128i zero = _mm_setzero_si128();
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128i p = _mm_loadu_si128((const __m128i*)(pixels + i));
+            __m128i lo = _mm_unpacklo_epi8(p, zero);
+            __m128i hi = _mm_unpackhi_epi8(p, zero);
+            lo = MulDiv255SSE2(lo, PremultiplyFactorSSE2(lo));
+            hi = MulDiv255SSE2(hi, PremultiplyFactorSSE2(hi));
+            _mm_storeu_si128((__m128i*)(pixels + i), _mm_packus_epi16(lo, hi));
+        }
+        PremultiplyScalar(pixels + i, count - i);
+    }
+
+    void AddSaturateSSE2(uint32_t* dst, const uint32_t* src, size_t count) {
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128i a = _mm_loadu_si128((const __m128i*)(dst + i));
+            __m128i b = _mm_loadu_si128((const __m128i*)(src + i));
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_adds_epu8(a, b));
+        }
+        AddSaturateScalar(dst + i, src + i, count - i);
+    }
+
+    // ==================== AVX2 ====================
+    // The horizontal pass is a serial dependency chain per row, so AVX2 only
+    // widens the column pass (two pixels per register) and the composite.
+
+    SDK_TARGET_AVX2 inline __m256i LoadPixelPairAVX2(const uint32_t* p) {
+        return _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)p));
+    }
+
+    // Lambdas do not inherit the target attribute, so the accumulate step is a function
+    SDK_TARGET_AVX2 void AccumulateRowAVX2(__m256i* sums, const uint32_t* in, int width, bool add) {
+        int pairs = width / 2;
+        for (int p = 0; p < pairs; p++) {
+            __m256i v = LoadPixelPairAVX2(in + p * 2);
+            __m256i acc = _mm256_loadu_si256(sums + p);
+            _mm256_storeu_si256(sums + p, add ? _mm256_add_epi32(acc, v) : _mm256_sub_epi32(acc, v));
+        }
+        if (width & 1) {
+            __m256i v = _mm256_cvtepu8_epi32(_mm_cvtsi32_si128((int)in[width - 1]));
+            __m256i acc = _mm256_loadu_si256(sums + pairs);
+            _mm256_storeu_si256(sums + pairs, add ? _mm256_add_epi32(acc, v) : _mm256_sub_epi32(acc, v));
+        }
+    }
+
+    SDK_TARGET_AVX2 void BlurColumnsAVX2(const uint32_t* src, int srcStride, uint32_t* dst, int dstStride,
+                                         int width, int height, int radius) {
+        int pairs = width / 2;
+        bool hasTail = (width & 1) != 0;
+        size_t slots = (size_t)pairs + (hasTail ? 1 : 0);
+        std::vector<int32_t> storage(slots * 8, 0);
+        __m256i* sums = reinterpret_cast<__m256i*>(storage.data());
+        int count = 0;
+
+        int initEnd = std::min(radius, height - 1);
+        for (int y = 0; y <= initEnd; y++) {
+            AccumulateRowAVX2(sums, src + (size_t)y * srcStride, width, true);
+            count++;
+        }
+
+        for (int y = 0; y < height; y++) {
+            uint32_t* out = dst + (size_t)y * dstStride;
+            __m256 inv = _mm256_set1_ps(1.0f / (float)count);
+            __m256 half = _mm256_set1_ps(0.5f);
+            for (size_t p = 0; p < slots; p++) {
+                __m256i q = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_add_ps(_mm256_cvtepi32_ps(_mm256_loadu_si256(sums + p)), half), inv));
+                __m128i packed = _mm_packs_epi32(_mm256_castsi256_si128(q), _mm256_extracti128_si256(q, 1));
+                packed = _mm_packus_epi16(packed, packed);
+                if ((int)p < pairs) {
+                    _mm_storel_epi64((__m128i*)(out + p * 2), packed);
+                } else {
+                    out[width - 1] = (uint32_t)_mm_cvtsi128_si32(packed);
+                }
+            }
+            if (y + radius + 1 < height) {
+                AccumulateRowAVX2(sums, src + (size_t)(y + radius + 1) * srcStride, width, true);
+                count++;
+            }
+            if (y - radius >= 0) {
+                AccumulateRowAVX2(sums, src + (size_t)(y - radius) * srcStride, width, false);
+                count--;
+            }
+        }
+    }
+
+    SDK_TARGET_AVX2 void AddSaturateAVX2(uint32_t* dst, const uint32_t* src, size_t count) {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256i a = _mm256_loadu_si256((const __m256i*)(dst + i));
+            __m256i b = _mm256_loadu_si256((const __m256i*)(src + i));
+            _mm256_storeu_si256((__m256i*)(dst + i), _mm256_adds_epu8(a, b));
+        }
+        AddSaturateSSE2(dst + i, src + i, count - i);
+    }
+
+    SDK_TARGET_AVX2 inline __m256i MulDiv255AVX2(__m256i a, __m256i b) {
+        __m256i v = _mm256_add_epi16(_mm256_mullo_epi16(a, b), _mm256_set1_epi16(128));
+        return _mm256_srli_epi16(_mm256_add_epi16(v, _mm256_srli_epi16(v, 8)), 8);
+    }
+
+    SDK_TARGET_AVX2 inline __m256i BroadcastAlphaAVX2(__m256i p) {
+        return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(p, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    }
+
+    // Unpacking and packing both work within 128-bit halves, so pixels keep their order
+    SDK_TARGET_AVX2 void BlendOverAVX2(uint32_t* dst, const uint32_t* src, size_t count, uint32_t opacity) {
+        __m256i zero = _mm256_setzero_si256();
+        __m256i full = _mm256_set1_epi16(255);
+        __m256i factor = _mm256_set1_epi16((short)opacity);
+        bool scale = opacity != 255;
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+            __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+            __m256i halves[2];
+            for (int h = 0; h < 2; h++) {
+                __m256i sw = h == 0 ? _mm256_unpacklo_epi8(s, zero) : _mm256_unpackhi_epi8(s, zero);
+                __m256i dw = h == 0 ? _mm256_unpacklo_epi8(d, zero) : _mm256_unpackhi_epi8(d, zero);
+                if (scale) sw = MulDiv255AVX2(sw, factor);
+                __m256i inv = _mm256_sub_epi16(full, BroadcastAlphaAVX2(sw));
+                halves[h] = _mm256_add_epi16(sw, MulDiv255AVX2(dw, inv));
+            }
+            _mm256_storeu_si256((__m256i*)(dst + i), _mm256_packus_epi16(halves[0], halves[1]));
+        }
+        BlendOverSSE2(dst + i, src + i, count - i, opacity);
+    }
+
+    SDK_TARGET_AVX2 void BlendMultiplyAVX2(uint32_t* dst, const uint32_t* src, size_t count) {
+        __m256i zero = _mm256_setzero_si256();
+        __m256i full = _mm256_set1_epi16(255);
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+            __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+            __m256i halves[2];
+            for (int h = 0; h < 2; h++) {
+                __m256i sw = h == 0 ? _mm256_unpacklo_epi8(s, zero) : _mm256_unpackhi_epi8(s, zero);
+                __m256i dw = h == 0 ? _mm256_unpacklo_epi8(d, zero) : _mm256_unpackhi_epi8(d, zero);
+                __m256i invSrc = _mm256_sub_epi16(full, BroadcastAlphaAVX2(sw));
+                __m256i invDst = _mm256_sub_epi16(full, BroadcastAlphaAVX2(dw));
+                halves[h] = _mm256_add_epi16(_mm256_add_epi16(MulDiv255AVX2(sw, dw), MulDiv255AVX2(sw, invDst)),
+                                             MulDiv255AVX2(dw, invSrc));
+            }
+            _mm256_storeu_si256((__m256i*)(dst + i), _mm256_packus_epi16(halves[0], halves[1]));
+        }
+        BlendMultiplySSE2(dst + i, src + i, count - i);
+    }
+
+    SDK_TARGET_AVX2 void ScaleAVX2(uint32_t* pixels, size_t count, uint32_t opacity) {
+        __m256i zero = _mm256_setzero_si256();
+        __m256i factor = _mm256_set1_epi16((short)opacity);
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256i p = _mm256_loadu_si256((const __m256i*)(pixels + i));
+            __m256i lo = MulDiv255AVX2(_mm256_unpacklo_epi8(p, zero), factor);
+            __m256i hi = MulDiv255AVX2(_mm256_unpackhi_epi8(p, zero), factor);
+            _mm256_storeu_si256((__m256i*)(pixels + i), _mm256_packus_epi16(lo, hi));
+        }
+        ScaleSSE2(pixels + i, count - i, opacity);
+    }
+
+    SDK_TARGET_AVX2 void PremultiplyAVX2(uint32_t* pixels, size_t count) {
+        __m256i zero = _mm256_setzero_si256();
+        __m256i colorLanes = _mm256_set_epi16(0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1);
+        __m256i alphaLane = _mm256_set_epi16(255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0);
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256i p = _mm256_loadu_si256((const __m256i*)(pixels + i));
+            __m256i halves[2];
+            for (int h = 0; h < 2; h++) {
+                __m256i w = h == 0 ? _mm256_unpacklo_epi8(p, zero) : _mm256_unpackhi_epi8(p, zero);
+                __m256i factor = _mm256_or_si256(_mm256_and_si256(BroadcastAlphaAVX2(w), colorLanes), alphaLane);
+                halves[h] = MulDiv255AVX2(w, factor);
+            }
+            _mm256_storeu_si256((__m256i*)(pixels + i), _mm256_packus_epi16(halves[0], halves[1]));
+        }
+        PremultiplySSE2(pixels + i, count - i);
+    }
+
+    bool DetectSSE2() {
+    #if defined(__x86_64__) || defined(_M_X64)
+        return true;
+    #elif defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 1);
+        return (info[3] & (1 << 26)) != 0;
+    #else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse2") != 0;
+    #endif
+    }
+
+    bool DetectAVX2() {
+    #if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx) return false;
+        if ((_xgetbv(0) & 0x6) != 0x6) return false;  // OS must save YMM state
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+    #else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    #endif
+    }
+#endif // SDK_PIXEL_X86
+
+    // ==================== NEON ====================
+
+#if SDK_PIXEL_NEON
+    inline int32x4_t LoadPixelNEON(uint32_t p) {
+        uint16x8_t wide = vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(p)));
+        return vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(wide)));
+    }
+
+    inline uint32_t StorePixelNEON(int32x4_t sum, float32x4_t inv) {
+        float32x4_t f = vmulq_f32(vaddq_f32(vcvtq_f32_s32(sum), vdupq_n_f32(0.5f)), inv);
+        uint16x4_t narrow = vqmovun_s32(vcvtq_s32_f32(f));
+        uint8x8_t bytes = vqmovn_u16(vcombine_u16(narrow, narrow));
+        return vget_lane_u32(vreinterpret_u32_u8(bytes), 0);
+    }
+
+    void BlurRowsNEON(const uint32_t* src, int srcStride, uint32_t* dst, int dstStride,
+                      int width, int height, int radius) {
+        std::vector<float> reciprocals((size_t)radius * 2 + 2, 0.0f);
+        for (size_t i = 1; i < reciprocals.size(); i++) {
+            reciprocals[i] = 1.0f / (float)i;
+        }
+
+        for (int y = 0; y < height; y++) {
+            const uint32_t* in = src + (size_t)y * srcStride;
+            uint32_t* out = dst + (size_t)y * dstStride;
+
+            int32x4_t sum = vdupq_n_s32(0);
+            int count = 0;
+            int initEnd = std::min(radius, width - 1);
+            for (int x = 0; x <= initEnd; x++) {
+                sum = vaddq_s32(sum, LoadPixelNEON(in[x]));
+                count++;
+            }
+
+            for (int x = 0; x < width; x++) {
+                out[x] = StorePixelNEON(sum, vdupq_n_f32(reciprocals[count]));
+                if (x + radius + 1 < width) {
+                    sum = vaddq_s32(sum, LoadPixelNEON(in[x + radius + 1]));
+                    count++;
+                }
+                if (x - radius >= 0) {
+                    sum = vsubq_s32(sum, LoadPixelNEON(in[x - radius]));
+                    count--;
+                }
+            }
+        }
+    }
+
+    void BlurColumnsNEON(const uint32_t* src, int srcStride, uint32_t* dst, int dstStride,
+                         int width, int height, int radius) {
+        std::vector<int32_t> storage((size_t)width * 4, 0);
+        int32_t* sums = storage.data();
+        int count = 0;
+
+        int initEnd = std::min(radius, height - 1);
+        for (int y = 0; y <= initEnd; y++) {
+            const uint32_t* in = src + (size_t)y * srcStride;
+            for (int x = 0; x < width; x++) {
+                vst1q_s32(sums + x * 4, vaddq_s32(vld1q_s32(sums + x * 4), LoadPixelNEON(in[x])));
+            }
+            count++;
+        }
+
+        for (int y = 0; y < height; y++) {
+            uint32_t* out = dst + (size_t)y * dstStride;
+            float32x4_t inv = vdupq_n_f32(1.0f / (float)count);
+            for (int x = 0; x < width; x++) {
+                out[x] = StorePixelNEON(vld1q_s32(sums + x * 4), inv);
+            }
+            if (y + radius + 1 < height) {
+                const uint32_t* in = src + (size_t)(y + radius + 1) * srcStride;
+                for (int x = 0; x < width; x++) {
+                    vst1q_s32(sums + x * 4, vaddq_s32(vld1q_s32(sums + x * 4), LoadPixelNEON(in[x])));
+                }
+                count++;
+            }
+            if (y - radius >= 0) {
+                const uint32_t* in = src + (size_t)(y - radius) * srcStride;
+                for (int x = 0; x < width; x++) {
+                    vst1q_s32(sums + x * 4, vsubq_s32(vld1q_s32(sums + x * 4), LoadPixelNEON(in[x])));
+                }
+                count--;
+            }
+        }
+    }
+
+    void AddSaturateNEON(uint32_t* dst, const uint32_t* src, size_t count) {
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            uint8x16_t a = vld1q_u8((const uint8_t*)(dst + i));
+            uint8x16_t b = vld1q_u8((const uint8_t*)(src + i));
+            vst1q_u8((uint8_t*)(dst + i), vqaddq_u8(a, b));
+        }
+        AddSaturateScalar(dst + i, src + i, count - i);
+    }
+    // Premultiplied blends on two pixels per 16-bit vector
+    inline uint16x8_t MulDiv255NEON(uint16x8_t a, uint16x8_t b) {
+        uint16x8_t v = vaddq_u16(vmulq_u16(a, b), vdupq_n_u16(128));
+        return vshrq_n_u16(vaddq_u16(v, vshrq_n_u16(v, 8)), 8);
+    }
+
+    inline uint16x8_t BroadcastAlphaNEON(uint16x8_t p) {
+        return vcombine_u16(vdup_lane_u16(vget_low_u16(p), 3), vdup_lane_u16(vget_high_u16(p), 3));
+    }
+
+    inline uint8x16_t PackNEON(uint16x8_t lo, uint16x8_t hi) {
+        return vcombine_u8(vqmovn_u16(lo), vqmovn_u16(hi));
+    }
+
+    void BlendOverNEON(uint32_t* dst, const uint32_t* src, size_t count, uint32_t opacity) {
+        uint16x8_t full = vdupq_n_u16(255);
+        uint16x8_t factor = vdupq_n_u16((uint16_t)opacity);
+        bool scale = opacity != 255;
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            uint8x16_t s = vld1q_u8((const uint8_t*)(src + i));
+            uint8x16_t d = vld1q_u8((const uint8_t*)(dst + i));
+            uint16x8_t halves[2];
+            for (int h = 0; h < 2; h++) {
+                uint16x8_t sw = vmovl_u8(h == 0 ? vget_low_u8(s) : vget_high_u8(s));
+                uint16x8_t dw = vmovl_u8(h == 0 ? vget_low_u8(d) : vget_high_u8(d));
+                if (scale) sw = MulDiv255NEON(sw, factor);
+                halves[h] = vaddq_u16(sw, MulDiv255NEON(dw, vsubq_u16(full, BroadcastAlphaNEON(sw))));
+            }
+            vst1q_u8((uint8_t*)(dst + i), PackNEON(halves[0], halves[1]));
+        }
+        BlendOverScalar(dst + i, src + i, count - i, opacity);
+    }
+
+    void BlendMultiplyNEON(uint32_t* dst, const uint32_t* src, size_t count) {
+        uint16x8_t full = vdupq_n_u16(255);
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            uint8x16_t s = vld1q_u8((const uint8_t*)(src + i));
+            uint8x16_t d = vld1q_u8((const uint8_t*)(dst + i));
+            uint16x8_t halves[2];
+            for (int h = 0; h < 2; h++) {
+                uint16x8_t sw = vmovl_u8(h == 0 ? vget_low_u8(s) : vget_high_u8(s));
+                uint16x8_t dw = vmovl_u8(h == 0 ? vget_low_u8(d) : vget_high_u8(d));
+                uint16x8_t invSrc = vsubq_u16(full, BroadcastAlphaNEON(sw));
+                uint16x8_t invDst = vsubq_u16(full, BroadcastAlphaNEON(dw));
+                halves[h] = vaddq_u16(vaddq_u16(MulDiv255NEON(sw, dw), MulDiv255NEON(sw, invDst)),
+                                      MulDiv255NEON(dw, invSrc));
+            }
+            vst1q_u8((uint8_t*)(dst + i), PackNEON(halves[0], halves[1]));
+        }
+        BlendMultiplyScalar(dst + i, src + i, count - i);
+    }
+
+    void ScaleNEON(uint32_t* pixels, size_t count, uint32_t opacity) {
+        uint16x8_t factor = vdupq_n_u16((uint16_t)opacity);
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            uint8x16_t p = vld1q_u8((const uint8_t*)(pixels + i));
+            uint16x8_t lo = MulDiv255NEON(vmovl_u8(vget_low_u8(p)), factor);
+            uint16x8_t hi = MulDiv255NEON(vmovl_u8(vget_high_u8(p)), factor);
+            vst1q_u8((uint8_t*)(pixels + i), PackNEON(lo, hi));
+        }
+        ScaleScalar(pixels + i, count - i, opacity);
+    }
+
+    void PremultiplyNEON(uint32_t* pixels, size_t count) {
+        static const uint16_t colorMask[8] = { 0xFFFF, 0xFFFF, 0xFFFF, 0, 0xFFFF, 0xFFFF, 0xFFFF, 0 };
+        static const uint16_t alphaLane[8] = { 0, 0, 0, 255, 0, 0, 0, 255 };
+        uint16x8_t colorLanes = vld1q_u16(colorMask);
+        uint16x8_t alphaFactor = vld1q_u16(alphaLane);
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            uint8x16_t p = vld1q_u8((const uint8_t*)(pixels + i));
+            uint16x8_t halves[2];
+            for (int h = 0; h < 2; h++) {
+                uint16x8_t w = vmovl_u8(h == 0 ? vget_low_u8(p) : vget_high_u8(p));
+                uint16x8_t factor = vorrq_u16(vandq_u16(BroadcastAlphaNEON(w), colorLanes), alphaFactor);
+                halves[h] = MulDiv255NEON(w, factor);
+            }
+            vst1q_u8((uint8_t*)(pixels + i), PackNEON(halves[0], halves[1]));
+        }
+        PremultiplyScalar(pixels + i, count - i);
+    }
+#endif // SDK_PIXEL_NEON
+
+    // ==================== DISPATCH ====================
+
+    using PassFn = void (*)(const uint32_t*, int, uint32_t*, int, int, int, int);
+
+    std::atomic<int>& ActiveSetStorage() {
+        static std::atomic<int> active((int)PixelKernels::GetBestInstructionSet());
+        return active;
+    }
+
+    void SelectPasses(int radius, PassFn& rows, PassFn& columns) {
+        rows = BlurRowsScalar;
+        columns = BlurColumnsScalar;
+        if (radius * 2 + 1 > MAX_SIMD_WINDOW) return;
+
+        switch (PixelKernels::GetActiveInstructionSet()) {
+#if SDK_PIXEL_X86
+            case PixelKernels::InstructionSet::AVX2:
+                rows = BlurRowsSSE2;
+                columns = BlurColumnsAVX2;
+                break;
+            case PixelKernels::InstructionSet::SSE2:
+                rows = BlurRowsSSE2;
+                columns = BlurColumnsSSE2;
+                break;
+#endif
+#if SDK_PIXEL_NEON
+            case PixelKernels::InstructionSet::NEON:
+                rows = BlurRowsNEON;
+                columns = BlurColumnsNEON;
+                break;
+#endif
+            default:
+                break;
+        }
+    }
+}
+
+bool PixelKernels::IsSupported(InstructionSet set) {
+    switch (set) {
+        case InstructionSet::SCALAR:
+            return true;
+#if SDK_PIXEL_X86
+        case InstructionSet::SSE2: {
+            static const bool supported = DetectSSE2();
+            return supported;
+        }
+        case InstructionSet::AVX2: {
+            static const bool supported = DetectSSE2() && DetectAVX2();
+            return supported;
+        }
+#endif
+#if SDK_PIXEL_NEON
+        case InstructionSet::NEON:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+PixelKernels::InstructionSet PixelKernels::GetBestInstructionSet() {
+    if (IsSupported(InstructionSet::AVX2)) return InstructionSet::AVX2;
+    if (IsSupported(InstructionSet::SSE2)) return InstructionSet::SSE2;
+    if (IsSupported(InstructionSet::NEON)) return InstructionSet::NEON;
+    return InstructionSet::SCALAR;
+}
+
+PixelKernels::InstructionSet PixelKernels::GetActiveInstructionSet() {
+    return (InstructionSet)ActiveSetStorage().load(std::memory_order_relaxed);
+}
+
+void PixelKernels::SetInstructionSet(InstructionSet set) {
+    if (!IsSupported(set)) {
+        set = GetBestInstructionSet();
+    }
+    ActiveSetStorage().store((int)set, std::memory_order_relaxed);
+}
+
+const char* PixelKernels::GetInstructionSetName(InstructionSet set) {
+    switch (set) {
+        case InstructionSet::SSE2: return "SSE2";
+        case InstructionSet::AVX2: return "AVX2";
+        case InstructionSet::NEON: return "NEON";
+        default: return "Scalar";
+    }
+}
+
+void PixelKernels::BoxBlur(uint32_t* pixels, int width, int height, int stride, int radius, int passes) {
+    if (!pixels || width <= 0 || height <= 0 || radius <= 0 || passes <= 0) return;
+
+    PassFn rows, columns;
+    SelectPasses(radius, rows, columns);
+
+    // Rows blur in bands and columns in strips; each tile writes only its own
+    // pixels, so the result doesn't depend on how tiles land on threads
+    std::vector<uint32_t> temp((size_t)width * height);
+    for (int pass = 0; pass < passes; pass++) {
+        TileScheduler::ForEachRowBand(width, height, [&](int begin, int end) {
+            rows(pixels + (size_t)begin * stride, stride, temp.data() + (size_t)begin * width, width,
+                 width, end - begin, radius);
+        });
+        TileScheduler::ForEachColumnStrip(width, height, [&](int begin, int end) {
+            columns(temp.data() + begin, width, pixels + begin, stride, end - begin, height, radius);
+        });
+    }
+}
+
+void PixelKernels::GaussianBlur(uint32_t* pixels, int width, int height, int stride, float sigma) {
+    if (sigma <= 0.0f) return;
+
+    // Box widths whose three-pass convolution matches the gaussian variance
+    const int passes = 3;
+    float idealWidth = std::sqrt(12.0f * sigma * sigma / passes + 1.0f);
+    int lower = (int)std::floor(idealWidth);
+    if (lower % 2 == 0) lower--;
+    int upper = lower + 2;
+    float idealLowerCount = (12.0f * sigma * sigma - passes * lower * lower - 4.0f * passes * lower - 3.0f * passes)
+                            / (-4.0f * lower - 4.0f);
+    int lowerCount = (int)std::round(idealLowerCount);
+
+    for (int pass = 0; pass < passes; pass++) {
+        int boxWidth = pass < lowerCount ? lower : upper;
+        BoxBlur(pixels, width, height, stride, (boxWidth - 1) / 2, 1);
+    }
+}
+
+void PixelKernels::DepthOfField(uint32_t* pixels, int width, int height, int stride, int focalDepth, int blurAmount, float focalRange) {
+    if (!pixels || width <= 0 || height <= 0 || blurAmount <= 0 || focalRange <= 0.0f) return;
+
+    TileScheduler::ForEachRowBand(width, height, [&](int begin, int end) {
+        DepthOfFieldRows(pixels, width, height, stride, begin, end, focalDepth, blurAmount, focalRange);
+    });
+}
+
+void PixelKernels::DepthOfFieldRows(uint32_t* pixels, int width, int height, int stride, int begin, int end,
+                                    int focalDepth, int blurAmount, float focalRange) {
+    if (!pixels || width <= 0 || blurAmount <= 0 || focalRange <= 0.0f) return;
+    begin = std::max(begin, 0);
+    end = std::min(end, height);
+
+    std::vector<uint32_t> row((size_t)width);
+    for (int y = begin; y < end; y++) {
+        float blurFactor = std::min((float)std::abs(y - focalDepth) / focalRange, 1.0f);
+        int radius = (int)(blurAmount * blurFactor);
+        if (radius <= 0) continue;
+
+        PassFn rows, columns;
+        SelectPasses(radius, rows, columns);
+
+        uint32_t* line = pixels + (size_t)y * stride;
+        rows(line, stride, row.data(), width, width, 1, radius);
+        std::copy(row.begin(), row.end(), line);
+    }
+}
+
+void PixelKernels::MotionBlur(uint32_t* pixels, int width, int height, int stride, int directionX, int directionY, float intensity, int samples) {
+    if (!pixels || width <= 0 || height <= 0 || samples <= 0 || intensity <= 0.0f) return;
+
+    uint32_t alpha = (uint32_t)std::min(255.0f, 255.0f * intensity / samples);
+    if (alpha == 0) return;
+
+    // Every band reads the unmodified image
+    std::vector<uint32_t> source((size_t)width * height);
+    TileScheduler::ForEachRowBand(width, height, [&](int begin, int end) {
+        for (int y = begin; y < end; y++) {
+            std::copy(pixels + (size_t)y * stride, pixels + (size_t)y * stride + width, source.data() + (size_t)y * width);
+        }
+    });
+
+    TileScheduler::ForEachRowBand(width, height, [&](int begin, int end) {
+        MotionBlurRows(pixels, source.data(), width, height, stride, begin, end, directionX, directionY, intensity, samples);
+    });
+}
+
+void PixelKernels::MotionBlurRows(uint32_t* pixels, const uint32_t* source, int width, int height, int stride,
+                                  int begin, int end, int directionX, int directionY, float intensity, int samples) {
+    if (!pixels || !source || width <= 0 || samples <= 0 || intensity <= 0.0f) return;
+
+    uint32_t alpha = (uint32_t)std::min(255.0f, 255.0f * intensity / samples);
+    if (alpha == 0) return;
+    begin = std::max(begin, 0);
+    end = std::min(end, height);
+
+    for (int y = begin; y < end; y++) {
+        uint32_t* out = pixels + (size_t)y * stride;
+        for (int i = 0; i < samples; i++) {
+            int sy = y - (directionY * i) / samples;
+            if (sy < 0 || sy >= height) continue;
+
+            int offsetX = (directionX * i) / samples;
+            int first = std::max(0, offsetX);
+            int last = std::min(width, width + offsetX);
+            const uint32_t* in = source + (size_t)sy * width;
+
+            // dst = src * alpha + dst * (1 - alpha), per channel
+            for (int x = first; x < last; x++) {
+                uint32_t s = in[x - offsetX];
+                uint32_t d = out[x];
+                uint32_t blended = 0;
+                for (int shift = 0; shift < 32; shift += 8) {
+                    uint32_t channel = (((s >> shift) & 0xFF) * alpha + ((d >> shift) & 0xFF) * (255 - alpha)) / 255;
+                    blended |= channel << shift;
+                }
+                out[x] = blended;
+            }
+        }
+    }
+}
+
+void PixelKernels::ChromaticAberration(uint32_t* pixels, int width, int height, int stride, float strength, int offsetX, int offsetY) {
+    if (!pixels || width <= 0 || height <= 0) return;
+
+    int shiftX = (int)(offsetX * strength);
+    int shiftY = (int)(offsetY * strength);
+    if (shiftX == 0 && shiftY == 0) return;
+
+    std::vector<uint32_t> source((size_t)width * height);
+    TileScheduler::ForEachRowBand(width, height, [&](int begin, int end) {
+        for (int y = begin; y < end; y++) {
+            std::copy(pixels + (size_t)y * stride, pixels + (size_t)y * stride + width, source.data() + (size_t)y * width);
+        }
+    });
+
+    TileScheduler::ForEachRowBand(width, height, [&](int begin, int end) {
+        ChromaticAberrationRows(pixels, source.data(), width, height, stride, begin, end, shiftX, shiftY);
+    });
+}
+
+void PixelKernels::ChromaticAberrationRows(uint32_t* pixels, const uint32_t* source, int width, int height, int stride,
+                                           int begin, int end, int shiftX, int shiftY) {
+    if (!pixels || !source || width <= 0) return;
+    begin = std::max(begin, 0);
+    end = std::min(end, height);
+
+    // Channels whose sample falls outside the image keep their value
+    for (int y = begin; y < end; y++) {
+        uint32_t* out = pixels + (size_t)y * stride;
+        int redY = y + shiftY;
+        int blueY = y - shiftY;
+        bool redRow = redY >= 0 && redY < height;
+        bool blueRow = blueY >= 0 && blueY < height;
+
+        for (int x = 0; x < width; x++) {
+            uint32_t p = out[x];
+            int redX = x + shiftX;
+            int blueX = x - shiftX;
+            if (redRow && redX >= 0 && redX < width) {
+                p = (p & 0xFF00FFFFu) | (source[(size_t)redY * width + redX] & 0x00FF0000u);
+            }
+            if (blueRow && blueX >= 0 && blueX < width) {
+                p = (p & 0xFFFFFF00u) | (source[(size_t)blueY * width + blueX] & 0x000000FFu);
+            }
+            out[x] = p;
+        }
+    }
+}
+
+void PixelKernels::SplatParticles(uint32_t* pixels, int width, int height, int stride,
+                                  const float* x, const float* y, const uint32_t* colors, size_t count,
+                                  int originX, int originY, int size) {
+    if (!pixels || !x || !y || !colors || width <= 0 || height <= 0 || count == 0 || size <= 0) return;
+
+    // Small batches or a single band aren't worth binning
+    int bands = (height + TileScheduler::TILE_SIZE - 1) / TileScheduler::TILE_SIZE;
+    if (bands == 1 || count * (size_t)size * size < TileScheduler::MIN_PARALLEL_PIXELS) {
+        for (size_t i = 0; i < count; i++) {
+            int left, top;
+            if (GetSplatOrigin(x[i], y[i], originX, originY, width, height, size, left, top)) {
+                SplatSquare(pixels, width, stride, 0, height, left, top, size, colors[i]);
+            }
+        }
+        return;
+    }
+
+    // Bin particle indices by the row bands they touch, one bin list per chunk of
+    // particles, then blend each band from its bins in chunk order. Bands own
+    // their rows, and every pixel sees its particles in index order, so the
+    // result doesn't depend on the worker count.
+    int chunks = (int)((count + SPLAT_CHUNK_SIZE - 1) / SPLAT_CHUNK_SIZE);
+    std::vector<std::vector<uint32_t>> bins((size_t)chunks * bands);
+    TileScheduler::ParallelFor(chunks, 1, [&](int chunkBegin, int chunkEnd) {
+        for (int chunk = chunkBegin; chunk < chunkEnd; chunk++) {
+            std::vector<uint32_t>* chunkBins = bins.data() + (size_t)chunk * bands;
+            size_t end = std::min(count, (size_t)(chunk + 1) * SPLAT_CHUNK_SIZE);
+            for (size_t i = (size_t)chunk * SPLAT_CHUNK_SIZE; i < end; i++) {
+                int left, top;
+                if (!GetSplatOrigin(x[i], y[i], originX, originY, width, height, size, left, top)) continue;
+                int first = std::max(0, top) / TileScheduler::TILE_SIZE;
+                int last = std::min(height - 1, top + size - 1) / TileScheduler::TILE_SIZE;
+                for (int band = first; band <= last; band++) {
+                    chunkBins[band].push_back((uint32_t)i);
+                }
+            }
+        }
+    });
+
+    TileScheduler::ParallelFor(bands, 1, [&](int bandBegin, int bandEnd) {
+        for (int band = bandBegin; band < bandEnd; band++) {
+            int rowBegin = band * TileScheduler::TILE_SIZE;
+            int rowEnd = std::min(height, rowBegin + TileScheduler::TILE_SIZE);
+            for (int chunk = 0; chunk < chunks; chunk++) {
+                for (uint32_t i : bins[(size_t)chunk * bands + band]) {
+                    int left = 0, top = 0;
+                    GetSplatOrigin(x[i], y[i], originX, originY, width, height, size, left, top);   // Binned, so on the buffer
+                    SplatSquare(pixels, width, stride, rowBegin, rowEnd, left, top, size, colors[i]);
+                }
+            }
+        }
+    });
+}
+
+void PixelKernels::AddSaturate(uint32_t* dst, const uint32_t* src, size_t count) {
+    switch (GetActiveInstructionSet()) {
+#if SDK_PIXEL_X86
+        case InstructionSet::AVX2:
+            AddSaturateAVX2(dst, src, count);
+            return;
+        case InstructionSet::SSE2:
+            AddSaturateSSE2(dst, src, count);
+            return;
+#endif
+#if SDK_PIXEL_NEON
+        case InstructionSet::NEON:
+            AddSaturateNEON(dst, src, count);
+            return;
+#endif
+        default:
+            AddSaturateScalar(dst, src, count);
+            return;
+    }
+}
+
+void PixelKernels::BlendOver(uint32_t* dst, const uint32_t* src, size_t count, uint8_t opacity) {
+    if (!dst || !src || opacity == 0) return;
+    switch (GetActiveInstructionSet()) {
+#if SDK_PIXEL_X86
+        case InstructionSet::AVX2:
+            BlendOverAVX2(dst, src, count, opacity);
+            return;
+        case InstructionSet::SSE2:
+            BlendOverSSE2(dst, src, count, opacity);
+            return;
+#endif
+#if SDK_PIXEL_NEON
+        case InstructionSet::NEON:
+            BlendOverNEON(dst, src, count, opacity);
+            return;
+#endif
+        default:
+            BlendOverScalar(dst, src, count, opacity);
+            return;
+    }
+}
+
+void PixelKernels::BlendMultiply(uint32_t* dst, const uint32_t* src, size_t count) {
+    if (!dst || !src) return;
+    switch (GetActiveInstructionSet()) {
+#if SDK_PIXEL_X86
+        case InstructionSet::AVX2:
+            BlendMultiplyAVX2(dst, src, count);
+            return;
+        case InstructionSet::SSE2:
+            BlendMultiplySSE2(dst, src, count);
+            return;
+#endif
+#if SDK_PIXEL_NEON
+        case InstructionSet::NEON:
+            BlendMultiplyNEON(dst, src, count);
+            return;
+#endif
+        default:
+            BlendMultiplyScalar(dst, src, count);
+            return;
+    }
+}
+
+void PixelKernels::Scale(uint32_t* pixels, size_t count, uint8_t opacity) {
+    if (!pixels || opacity == 255) return;
+    switch (GetActiveInstructionSet()) {
+#if SDK_PIXEL_X86
+        case InstructionSet::AVX2:
+            ScaleAVX2(pixels, count, opacity);
+            return;
+        case InstructionSet::SSE2:
+            ScaleSSE2(pixels, count, opacity);
+            return;
+#endif
+#if SDK_PIXEL_NEON
+        case InstructionSet::NEON:
+            ScaleNEON(pixels, count, opacity);
+            return;
+#endif
+        default:
+            ScaleScalar(pixels, count, opacity);
+            return;
+    }
+}
+
+void PixelKernels::Premultiply(uint32_t* pixels, size_t count) {
+    if (!pixels) return;
+    switch (GetActiveInstructionSet()) {
+#if SDK_PIXEL_X86
+        case InstructionSet::AVX2:
+            PremultiplyAVX2(pixels, count);
+            return;
+        case InstructionSet::SSE2:
+            PremultiplySSE2(pixels, count);
+            return;
+#endif
+#if SDK_PIXEL_NEON
+        case InstructionSet::NEON:
+            PremultiplyNEON(pixels, count);
+            return;
+#endif
+        default:
+            PremultiplyScalar(pixels, count);
+            return;
+    }
+}
+
+void PixelKernels::Unpremultiply(uint32_t* pixels, size_t count) {
+    // A division per channel; rare enough (readback, export) to stay scalar
+    if (!pixels) return;
+    for (size_t i = 0; i < count; i++) {
+        pixels[i] = PremultipliedPixel::ToStraight(pixels[i]);
+    }
+}
+
+void PixelKernels::ExtractBright(const uint32_t* pixels, int width, int height, int stride,
+                                 float threshold, float intensity, uint32_t* bright) {
+    if (!pixels || !bright) return;
+
+    for (int y = 0; y < height; y++) {
+        const uint32_t* row = pixels + (size_t)y * stride;
+        uint32_t* out = bright + (size_t)y * width;
+        for (int x = 0; x < width; x++) {
+            out[x] = 0;
+            int r = (row[x] >> 16) & 0xFF;
+            int g = (row[x] >> 8) & 0xFF;
+            int b = row[x] & 0xFF;
+            float brightness = (r + g + b) / (3.0f * 255.0f);
+            if (brightness > threshold) {
+                r = std::min(255, (int)(r * intensity));
+                g = std::min(255, (int)(g * intensity));
+                b = std::min(255, (int)(b * intensity));
+                out[x] = ((uint32_t)r << 16) | ((uint32_t)g << 8) | (uint32_t)b;
+            }
+        }
+    }
+}
+
+void PixelKernels::Bloom(uint32_t* pixels, int width, int height, int stride, float threshold, float intensity, int radius) {
+    if (!pixels || width <= 0 || height <= 0) return;
+
+    std::vector<uint32_t> bright((size_t)width * height);
+    TileScheduler::ForEachRowBand(width, height, [&](int begin, int end) {
+        ExtractBright(pixels + (size_t)begin * stride, width, end - begin, stride, threshold, intensity,
+                      bright.data() + (size_t)begin * width);
+    });
+    BoxBlur(bright.data(), width, height, width, radius, 1);
+
+    TileScheduler::ForEachRowBand(width, height, [&](int begin, int end) {
+        for (int y = begin; y < end; y++) {
+            AddSaturate(pixels + (size_t)y * stride, bright.data() + (size_t)y * width, (size_t)width);
+        }
+    });
+}
+
+void PixelKernels::BoxBlurReference(uint32_t* pixels, int width, int height, int stride, int radius, int passes) {
+    if (!pixels || width <= 0 || height <= 0 || radius <= 0 || passes <= 0) return;
+
+    std::vector<uint32_t> temp((size_t)width * height);
+    for (int pass = 0; pass < passes; pass++) {
+        for (int y = 0; y < height; y++) {
+            const uint32_t* row = pixels + (size_t)y * stride;
+            for (int x = 0; x < width; x++) {
+                uint32_t sum[4] = { 0, 0, 0, 0 };
+                uint32_t count = 0;
+                for (int xx = std::max(0, x - radius); xx <= std::min(width - 1, x + radius); xx++) {
+                    AddPixel(sum, row[xx]);
+                    count++;
+                }
+                temp[(size_t)y * width + x] = AveragePixel(sum, count);
+            }
+        }
+        for (int y = 0; y < height; y++) {
+            uint32_t* row = pixels + (size_t)y * stride;
+            for (int x = 0; x < width; x++) {
+                uint32_t sum[4] = { 0, 0, 0, 0 };
+                uint32_t count = 0;
+                for (int yy = std::max(0, y - radius); yy <= std::min(height - 1, y + radius); yy++) {
+                    AddPixel(sum, temp[(size_t)yy * width + x]);
+                    count++;
+                }
+                row[x] = AveragePixel(sum, count);
+            }
+        }
+    }
+}
+
+void PixelKernels::BloomReference(uint32_t* pixels, int width, int height, int stride, float threshold, float intensity, int radius) {
+    if (!pixels || width <= 0 || height <= 0) return;
+
+    std::vector<uint32_t> bright((size_t)width * height);
+    ExtractBright(pixels, width, height, stride, threshold, intensity, bright.data());
+    BoxBlurReference(bright.data(), width, height, width, radius, 1);
+
+    for (int y = 0; y < height; y++) {
+        AddSaturateScalar(pixels + (size_t)y * stride, bright.data() + (size_t)y * width, (size_t)width);
+    }
+}
+
+} // namespace SDK
@@ -0,0 +1,337 @@
+#include "../../include/SDK/PngEncoder.h"
+#include "../../include/SDK/PixelKernels.h"
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+
+namespace SDK {
+
+namespace {
+    const uint8_t SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    const int BYTES_PER_PIXEL = 4;
+
+    // Deflate (RFC 1951)
+    const int WINDOW_SIZE = 32768;
+    const int HASH_BITS = 15;
+    const int MAX_CHAIN = 32;       // Candidates tried per position
+    const int NICE_MATCH = 64;      // A match this long ends the search
+    const int MIN_MATCH = 3;
+    const int MAX_MATCH = 258;
+
+    const uint16_t LENGTH_BASE[29] = {
+        3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+        35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+    };
+    const uint8_t LENGTH_EXTRA[29] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+        3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+    };
+    const uint16_t DISTANCE_BASE[30] = {
+        1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+        257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+    };
+    const uint8_t DISTANCE_EXTRA[30] = {
+        0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+        7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+    };
+
+    // Deflate packs bits from the least significant end; Huffman codes go most significant bit first
+    class BitWriter {
+    public:
+        explicit BitWriter(std::vector<uint8_t>& out) : m_out(out), m_bits(0), m_count(0) {}
+
+        void Write(uint32_t value, int count) {
+            m_bits |= value << m_count;
+            m_count += count;
+            while (m_count >= 8) {
+                m_out.push_back((uint8_t)m_bits);
+                m_bits >>= 8;
+                m_count -= 8;
+            }
+        }
+
+        void WriteCode(uint32_t code, int length) {
+            uint32_t reversed = 0;
+            for (int i = 0; i < length; i++) {
+                reversed = (reversed << 1) | ((code >> i) & 1);
+            }
+            Write(reversed, length);
+        }
+
+        void Flush() {
+            if (m_count > 0) m_out.push_back((uint8_t)m_bits);
+            m_bits = 0;
+            m_count = 0;
+        }
+
+    private:
+        std::vector<uint8_t>& m_out;
+        uint32_t m_bits;
+        int m_count;
+    };
+
+    // The fixed literal/length code (RFC 1951, 3.2.6)
+    void WriteSymbol(BitWriter& writer, int symbol) {
+        if (symbol < 144) {
+            writer.WriteCode(0x30 + symbol, 8);
+        } else if (symbol < 256) {
+            writer.WriteCode(0x190 + symbol - 144, 9);
+        } else if (symbol < 280) {
+            writer.WriteCode(symbol - 256, 7);
+        } else {
+            writer.WriteCode(0xC0 + symbol - 280, 8);
+        }
+    }
+
+    template<size_t N>
+    int FindCode(const uint16_t (&base)[N], int value) {
+        return (int)(std::upper_bound(base, base + N, value) - base) - 1;
+    }
+
+    void WriteMatch(BitWriter& writer, int length, int distance) {
+        int lengthCode = FindCode(LENGTH_BASE, length);
+        WriteSymbol(writer, 257 + lengthCode);
+        writer.Write(length - LENGTH_BASE[lengthCode], LENGTH_EXTRA[lengthCode]);
+
+        int distanceCode = FindCode(DISTANCE_BASE, distance);
+        writer.WriteCode(distanceCode, 5);
+        writer.Write(distance - DISTANCE_BASE[distanceCode], DISTANCE_EXTRA[distanceCode]);
+    }
+
+    uint32_t Hash(const uint8_t* data) {
+        uint32_t value = data[0] | (data[1] << 8) | (data[2] << 16);
+        return (value * 2654435761u) >> (32 - HASH_BITS);
+    }
+
+    // One final block with fixed codes; greedy matching over hash chains
+    void Deflate(const uint8_t* data, size_t size, std::vector<uint8_t>& out) {
+        BitWriter writer(out);
+        writer.Write(1, 1);     // BFINAL
+        writer.Write(1, 2);     // BTYPE: fixed Huffman
+
+        std::vector<int64_t> head((size_t)1 << HASH_BITS, -1);
+        std::vector<int64_t> previous(WINDOW_SIZE, -1);
+        auto insert = [&](size_t position) {
+            if (position + MIN_MATCH > size) return;
+            uint32_t hash = Hash(data + position);
+            previous[position & (WINDOW_SIZE - 1)] = head[hash];
+            head[hash] = (int64_t)position;
+        };
+
+        size_t position = 0;
+        while (position < size) {
+            int bestLength = 0;
+            int bestDistance = 0;
+            if (position + MIN_MATCH <= size) {
+                int maxLength = (int)std::min<size_t>(MAX_MATCH, size - position);
+                int niceLength = std::min(NICE_MATCH, maxLength);
+                int64_t candidate = head[Hash(data + position)];
+                for (int chain = 0; chain < MAX_CHAIN && candidate >= 0 &&
+                     (int64_t)position - candidate <= WINDOW_SIZE; chain++) {
+                    const uint8_t* a = data + candidate;
+                    const uint8_t* b = data + position;
+                    // Only a candidate that also matches one byte past the best can beat it
+                    if (a[bestLength] == b[bestLength]) {
+                        int length = 0;
+                        while (length < maxLength && a[length] == b[length]) length++;
+                        if (length > bestLength) {
+                            bestLength = length;
+                            bestDistance = (int)(position - candidate);
+                            if (length >= niceLength) break;
+                        }
+                    }
+                    // A newer position has taken the slot once candidate leaves the window
+                    int64_t next = previous[candidate & (WINDOW_SIZE - 1)];
+                    if (next >= candidate) break;
+                    candidate = next;
+                }
+            }
+
+            if (bestLength >= MIN_MATCH) {
+                WriteMatch(writer, bestLength, bestDistance);
+                for (int i = 0; i < bestLength; i++) insert(position + i);
+                position += bestLength;
+            } else {
+                WriteSymbol(writer, data[position]);
+                insert(position);
+                position++;
+            }
+        }
+        WriteSymbol(writer, 256);   // End of block
+        writer.Flush();
+    }
+
+    uint32_t Adler32(const uint8_t* data, size_t size) {
+        const uint32_t MOD = 65521;
+        uint32_t a = 1;
+        uint32_t b = 0;
+        while (size > 0) {
+            // 5552 bytes is the most that can be summed before b overflows
+            size_t block = std::min<size_t>(size, 5552);
+            for (size_t i = 0; i < block; i++) {
+                a += data[i];
+                b += a;
+            }
+            a %= MOD;
+            b %= MOD;
+            data += block;
+            size -= block;
+        }
+        return (b << 16) | a;
+    }
+
+    uint32_t Crc32(const uint8_t* data, size_t size, uint32_t crc = 0) {
+        static const std::array<uint32_t, 256> table = [] {
+            std::array<uint32_t, 256> result;
+            for (uint32_t n = 0; n < 256; n++) {
+                uint32_t c = n;
+                for (int k = 0; k < 8; k++) {
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                }
+                result[n] = c;
+            }
+            return result;
+        }();
+
+        crc = ~crc;
+        for (size_t i = 0; i < size; i++) {
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+
+    void WriteBigEndian(std::vector<uint8_t>& out, uint32_t value) {
+        out.push_back((uint8_t)(value >> 24));
+        out.push_back((uint8_t)(value >> 16));
+        out.push_back((uint8_t)(value >> 8));
+        out.push_back((uint8_t)value);
+    }
+
+    void WriteChunk(std::vector<uint8_t>& png, const char* type, const std::vector<uint8_t>& data) {
+        WriteBigEndian(png, (uint32_t)data.size());
+        size_t start = png.size();
+        png.insert(png.end(), type, type + 4);
+        png.insert(png.end(), data.begin(), data.end());
+        WriteBigEndian(png, Crc32(png.data() + start, png.size() - start));
+    }
+
+    // Written as selects rather than branches; the choice is data-dependent
+    uint8_t Paeth(int a, int b, int c) {
+        int pa = std::abs(b - c);
+        int pb = std::abs(a - c);
+        int pc = std::abs(a + b - 2 * c);
+        int bc = pb <= pc ? b : c;
+        return (uint8_t)(pa <= pb && pa <= pc ? a : bc);
+    }
+
+    // Filters row against previous (zeros for the first row) with filter type 0-4.
+    // The first pixel has nothing to its left, which reduces each predictor to Up or None.
+    void FilterRow(int type, const uint8_t* row, const uint8_t* previous, size_t length, uint8_t* out) {
+        const size_t bpp = BYTES_PER_PIXEL;
+        switch (type) {
+            case 0:
+                std::copy(row, row + length, out);
+                break;
+            case 1:
+                std::copy(row, row + bpp, out);
+                for (size_t i = bpp; i < length; i++) out[i] = (uint8_t)(row[i] - row[i - bpp]);
+                break;
+            case 2:
+                for (size_t i = 0; i < length; i++) out[i] = (uint8_t)(row[i] - previous[i]);
+                break;
+            case 3:
+                for (size_t i = 0; i < bpp; i++) out[i] = (uint8_t)(row[i] - previous[i] / 2);
+                for (size_t i = bpp; i < length; i++) out[i] = (uint8_t)(row[i] - (row[i - bpp] + previous[i]) / 2);
+                break;
+            case 4:
+                for (size_t i = 0; i < bpp; i++) out[i] = (uint8_t)(row[i] - previous[i]);
+                for (size_t i = bpp; i < length; i++) {
+                    out[i] = (uint8_t)(row[i] - Paeth(row[i - bpp], previous[i], previous[i - bpp]));
+                }
+                break;
+        }
+    }
+
+    // Sum of the residuals as signed bytes; the usual stand-in for compressed size
+    uint64_t Cost(const uint8_t* filtered, size_t length) {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < length; i++) {
+            int8_t value = (int8_t)filtered[i];
+            sum += (uint32_t)(value < 0 ? -value : value);
+        }
+        return sum;
+    }
+}
+
+bool PngEncoder::Encode(const uint32_t* pixels, int width, int height, int stride, std::vector<uint8_t>& png) {
+    if (!pixels || width <= 0 || height <= 0 || stride < width) {
+        return false;
+    }
+
+    // Each row: the filter type, then the filtered straight RGBA bytes
+    size_t rowBytes = (size_t)width * BYTES_PER_PIXEL;
+    std::vector<uint8_t> filtered((rowBytes + 1) * height);
+    std::vector<uint8_t> row(rowBytes);
+    std::vector<uint8_t> previous(rowBytes, 0);
+    std::vector<uint8_t> candidates(rowBytes * 5);
+    for (int y = 0; y < height; y++) {
+        const uint32_t* in = pixels + (size_t)y * stride;
+        for (int x = 0; x < width; x++) {
+            uint32_t argb = (in[x] >> 24) == 255 ? in[x] : PremultipliedPixel::ToStraight(in[x]);
+            uint8_t* out = &row[(size_t)x * BYTES_PER_PIXEL];
+            out[0] = (uint8_t)(argb >> 16);
+            out[1] = (uint8_t)(argb >> 8);
+            out[2] = (uint8_t)argb;
+            out[3] = (uint8_t)(argb >> 24);
+        }
+
+        int bestType = 0;
+        uint64_t bestCost = UINT64_MAX;
+        for (int type = 0; type < 5; type++) {
+            uint8_t* candidate = &candidates[rowBytes * type];
+            FilterRow(type, row.data(), previous.data(), rowBytes, candidate);
+            uint64_t cost = Cost(candidate, rowBytes);
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestType = type;
+            }
+        }
+        uint8_t* line = &filtered[(rowBytes + 1) * y];
+        line[0] = (uint8_t)bestType;
+        std::copy_n(&candidates[rowBytes * bestType], rowBytes, line + 1);
+        row.swap(previous);
+    }
+
+    // zlib stream: header (deflate, 32K window, no dictionary), data, Adler-32
+    std::vector<uint8_t> compressed = { 0x78, 0x01 };
+    Deflate(filtered.data(), filtered.size(), compressed);
+    WriteBigEndian(compressed, Adler32(filtered.data(), filtered.size()));
+
+    std::vector<uint8_t> header;
+    WriteBigEndian(header, (uint32_t)width);
+    WriteBigEndian(header, (uint32_t)height);
+    header.push_back(8);    // Bits per channel
+    header.push_back(6);    // RGBA
+    header.push_back(0);    // Deflate
+    header.push_back(0);    // Adaptive filtering
+    header.push_back(0);    // Not interlaced
+
+    png.insert(png.end(), std::begin(SIGNATURE), std::end(SIGNATURE));
+    WriteChunk(png, "IHDR", header);
+    WriteChunk(png, "IDAT", compressed);
+    WriteChunk(png, "IEND", {});
+    return true;
+}
+
+bool PngEncoder::Save(const std::wstring& path, const uint32_t* pixels, int width, int height, int stride) {
+    std::vector<uint8_t> png;
+    if (!Encode(pixels, width, height, stride, png)) return false;
+    std::ofstream file(std::filesystem::path(path), std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+    file.write((const char*)png.data(), (std::streamsize)png.size());
+    return (bool)file;
+}
+
+} // namespace SDK
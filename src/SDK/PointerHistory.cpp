@@ -0,0 +1,62 @@
+#include "../../include/SDK/PointerHistory.h"
+#include <algorithm>
+
+namespace SDK {
+
+namespace {
+    thread_local const std::vector<PointerSample>* t_coalesced = nullptr;
+}
+
+PointerHistory::PointerHistory(size_t capacity)
+    : m_samples(std::max<size_t>(capacity, 1))
+    , m_start(0)
+    , m_count(0)
+{
+}
+
+void PointerHistory::Add(const PointerSample& sample) {
+    if (m_count < m_samples.size()) {
+        m_samples[(m_start + m_count) % m_samples.size()] = sample;
+        m_count++;
+    } else {
+        m_samples[m_start] = sample;
+        m_start = (m_start + 1) % m_samples.size();
+    }
+}
+
+void PointerHistory::Clear() {
+    m_start = 0;
+    m_count = 0;
+}
+
+const PointerSample& PointerHistory::GetSample(size_t index) const {
+    return m_samples[(m_start + index) % m_samples.size()];
+}
+
+size_t PointerHistory::GetSamplesSince(uint32_t time, std::vector<PointerSample>& samples) const {
+    // Samples arrive in time order, so the newer ones are a suffix
+    size_t first = m_count;
+    while (first > 0 && IsLater(GetSample(first - 1).time, time)) {
+        first--;
+    }
+    for (size_t i = first; i < m_count; i++) {
+        samples.push_back(GetSample(i));
+    }
+    return m_count - first;
+}
+
+PointerHistory::CoalescedScope::CoalescedScope(const std::vector<PointerSample>& samples)
+    : m_previous(t_coalesced) {
+    t_coalesced = &samples;
+}
+
+PointerHistory::CoalescedScope::~CoalescedScope() {
+    t_coalesced = m_previous;
+}
+
+const std::vector<PointerSample>& PointerHistory::GetCoalesced() {
+    static const std::vector<PointerSample> empty;
+    return t_coalesced ? *t_coalesced : empty;
+}
+
+} // namespace SDK
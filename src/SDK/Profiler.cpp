@@ -0,0 +1,238 @@
+#include "../../include/SDK/Profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+
+namespace SDK {
+
+namespace {
+    struct ThreadBuffer {
+        std::vector<Profiler::Event> events;    // Power of two entries
+        size_t mask;
+        std::atomic<uint64_t> head;             // Zones ever recorded; only the owner writes
+        std::atomic<uint64_t> floor;            // head as of the last Clear()
+        uint32_t thread;
+        std::string name;                       // Guarded by the registry mutex
+
+        ThreadBuffer(size_t capacity, uint32_t id)
+            : events(capacity), mask(capacity - 1), head(0), floor(0), thread(id) {}
+    };
+
+    struct Registry {
+        std::mutex mutex;       // Thread registration, names and collection; never taken per zone
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+        uint32_t nextThread = 1;
+    };
+
+    Registry& GetRegistry() {
+        static Registry registry;
+        return registry;
+    }
+
+    std::chrono::steady_clock::time_point GetEpoch() {
+        static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+        return epoch;
+    }
+
+    std::atomic<bool> g_enabled(false);
+    std::atomic<size_t> g_capacity(65536);
+
+    // Kept alive by the registry too, so a finished thread's zones stay collectable
+    thread_local std::shared_ptr<ThreadBuffer> t_buffer;
+
+    ThreadBuffer& GetThreadBuffer() {
+        if (!t_buffer) {
+            Registry& registry = GetRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            t_buffer = std::make_shared<ThreadBuffer>(g_capacity.load(std::memory_order_relaxed), registry.nextThread++);
+            registry.buffers.push_back(t_buffer);
+        }
+        return *t_buffer;
+    }
+
+    // Oldest zone still in the ring and not cleared
+    uint64_t FirstKept(const ThreadBuffer& buffer, uint64_t head) {
+        uint64_t capacity = buffer.events.size();
+        uint64_t oldest = head > capacity ? head - capacity : 0;
+        return (std::max)(oldest, buffer.floor.load(std::memory_order_relaxed));
+    }
+
+    void AppendJsonString(std::string& out, const char* text) {
+        out += '"';
+        for (const char* c = text ? text : ""; *c; c++) {
+            switch (*c) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                default:
+                    if ((unsigned char)*c < 0x20) {
+                        char escaped[8];
+                        snprintf(escaped, sizeof(escaped), "\\u%04x", *c);
+                        out += escaped;
+                    } else {
+                        out += *c;
+                    }
+            }
+        }
+        out += '"';
+    }
+}
+
+void Profiler::SetEnabled(bool enabled) {
+    GetEpoch();
+    g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool Profiler::IsEnabled() {
+    return g_enabled.load(std::memory_order_relaxed);
+}
+
+void Profiler::SetBufferCapacity(size_t events) {
+    size_t capacity = 1;
+    while (capacity < events) capacity <<= 1;
+    g_capacity.store(capacity, std::memory_order_relaxed);
+}
+
+size_t Profiler::GetBufferCapacity() {
+    return g_capacity.load(std::memory_order_relaxed);
+}
+
+uint64_t Profiler::Now() {
+    // Offset by one so a zone's start is never 0, which ProfileZone reserves
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - GetEpoch()).count() + 1;
+}
+
+void Profiler::Record(const char* name, const char* category, uint64_t start, uint64_t end) {
+    ThreadBuffer& buffer = GetThreadBuffer();
+    uint64_t index = buffer.head.load(std::memory_order_relaxed);
+    Event& event = buffer.events[index & buffer.mask];
+    event.name = name;
+    event.category = category;
+    event.start = start;
+    event.duration = end > start ? end - start : 0;
+    event.thread = buffer.thread;
+    buffer.head.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::Record(const char* name, const char* category,
+                      std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+    auto sinceEpoch = [](std::chrono::steady_clock::time_point time) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(time - GetEpoch()).count();
+        return elapsed > 0 ? (uint64_t)elapsed + 1 : 1;
+    };
+    Record(name, category, sinceEpoch(start), sinceEpoch(end));
+}
+
+void Profiler::SetThreadName(const char* name) {
+    ThreadBuffer& buffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> lock(GetRegistry().mutex);
+    buffer.name = name ? name : "";
+}
+
+std::vector<Profiler::Event> Profiler::Collect() {
+    std::vector<Event> events;
+    Registry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    for (const auto& buffer : registry.buffers) {
+        uint64_t head = buffer->head.load(std::memory_order_acquire);
+        uint64_t first = FirstKept(*buffer, head);
+        size_t copied = events.size();
+        for (uint64_t i = first; i < head; i++) {
+            events.push_back(buffer->events[i & buffer->mask]);
+        }
+
+        // The owner kept recording during the copy; the slots it reached may
+        // hold newer zones, or a half-written one, so they're dropped
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t headAfter = buffer->head.load(std::memory_order_relaxed);
+        uint64_t capacity = buffer->events.size();
+        if (headAfter + 1 > first + capacity) {
+            uint64_t overwritten = (std::min)(head, headAfter + 1 - capacity) - first;
+            events.erase(events.begin() + copied, events.begin() + copied + (size_t)overwritten);
+        }
+    }
+
+    // Parents before the zones nested in them
+    std::sort(events.begin(), events.end(), [](const Event& a, const Event& b) {
+        if (a.start != b.start) return a.start < b.start;
+        return a.duration > b.duration;
+    });
+    return events;
+}
+
+std::vector<Profiler::ThreadInfo> Profiler::GetThreads() {
+    std::vector<ThreadInfo> threads;
+    Registry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    for (const auto& buffer : registry.buffers) {
+        uint64_t head = buffer->head.load(std::memory_order_acquire);
+        ThreadInfo info;
+        info.thread = buffer->thread;
+        info.name = buffer->name;
+        info.dropped = FirstKept(*buffer, head) - buffer->floor.load(std::memory_order_relaxed);
+        threads.push_back(info);
+    }
+    return threads;
+}
+
+void Profiler::Clear() {
+    Registry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (const auto& buffer : registry.buffers) {
+        buffer->floor.store(buffer->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+std::string Profiler::ToChromeTrace() {
+    std::vector<Event> events = Collect();
+    std::vector<ThreadInfo> threads = GetThreads();
+
+    std::string out;
+    out.reserve(128 + events.size() * 112);
+    out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    char buffer[128];
+
+    for (const ThreadInfo& thread : threads) {
+        if (thread.name.empty()) continue;
+        out += first ? "\n" : ",\n";
+        first = false;
+        snprintf(buffer, sizeof(buffer), "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+                 thread.thread);
+        out += buffer;
+        AppendJsonString(out, thread.name.c_str());
+        out += "}}";
+    }
+
+    for (const Event& event : events) {
+        out += first ? "\n" : ",\n";
+        first = false;
+        out += "{\"name\":";
+        AppendJsonString(out, event.name);
+        out += ",\"cat\":";
+        AppendJsonString(out, event.category);
+        snprintf(buffer, sizeof(buffer), ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+                 event.start / 1000.0, event.duration / 1000.0, event.thread);
+        out += buffer;
+    }
+
+    out += "\n]}\n";
+    return out;
+}
+
+bool Profiler::ExportChromeTrace(const std::wstring& path) {
+    std::string trace = ToChromeTrace();
+    std::ofstream file(std::filesystem::path(path), std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+    file.write(trace.data(), (std::streamsize)trace.size());
+    return (bool)file;
+}
+
+} // namespace SDK
@@ -28,6 +28,7 @@ ProgressBar::ProgressBar()
 
 void ProgressBar::SetValue(float value) {
     m_value = std::max(0.0f, std::min(value, m_maxValue));
+    if (m_displayValue != m_value) ScheduleUpdate();
 }
 
 void ProgressBar::SetMaxValue(float maxValue) {
@@ -103,6 +104,7 @@ void ProgressBar::Update(float deltaTime) {
         float diff = m_value - m_displayValue;
         if (std::abs(diff) > 0.01f) {
             m_displayValue += diff * m_animationSpeed * deltaTime;
+            ScheduleUpdate();
         } else {
             m_displayValue = m_value;
         }
@@ -114,6 +116,8 @@ void ProgressBar::Update(float deltaTime) {
 void ProgressBar::Render(HDC hdc) {
     if (!m_visible) return;
     
+    ScopedFont font(hdc, GetFont());
+    
     RECT bounds;
     GetBounds(bounds);
     
@@ -123,18 +127,16 @@ void ProgressBar::Render(HDC hdc) {
             m_backgroundColor, m_borderColor, 1);
     } else {
         // Simple rect
-        HBRUSH bgBrush = CreateSolidBrush(RGB(m_backgroundColor.r, m_backgroundColor.g, m_backgroundColor.b));
+        HBRUSH bgBrush = GdiObjectCache::GetBrush(RGB(m_backgroundColor.r, m_backgroundColor.g, m_backgroundColor.b));
         FillRect(hdc, &bounds, bgBrush);
-        DeleteObject(bgBrush);
         
         // Border
-        HPEN borderPen = CreatePen(PS_SOLID, 1, RGB(m_borderColor.r, m_borderColor.g, m_borderColor.b));
+        HPEN borderPen = GdiObjectCache::GetPen(RGB(m_borderColor.r, m_borderColor.g, m_borderColor.b));
         HPEN oldPen = (HPEN)SelectObject(hdc, borderPen);
         HBRUSH oldBrush = (HBRUSH)SelectObject(hdc, GetStockObject(NULL_BRUSH));
         Rectangle(hdc, bounds.left, bounds.top, bounds.right, bounds.bottom);
         SelectObject(hdc, oldPen);
         SelectObject(hdc, oldBrush);
-        DeleteObject(borderPen);
     }
     
     // Calculate progress bar fill
@@ -164,9 +166,8 @@ void ProgressBar::Render(HDC hdc) {
                 Renderer::DrawVerticalGradient(hdc, fillRect, m_gradientEnd, m_gradientStart);
             }
         } else {
-            HBRUSH fillBrush = CreateSolidBrush(RGB(m_foregroundColor.r, m_foregroundColor.g, m_foregroundColor.b));
+            HBRUSH fillBrush = GdiObjectCache::GetBrush(RGB(m_foregroundColor.r, m_foregroundColor.g, m_foregroundColor.b));
             FillRect(hdc, &fillRect, fillBrush);
-            DeleteObject(fillBrush);
         }
     }
     
@@ -2,18 +2,35 @@
 #include "../../include/SDK/WindowManager.h"
 #include <algorithm>
 #include <cctype>
+#include <cwctype>
 #include <sstream>
 
 namespace SDK {
 
-PromptWindowBuilder::PromptWindowBuilder() {
+namespace {
+    constexpr size_t DEFAULT_PROMPT_CACHE_CAPACITY = 32;
+}
+
+struct PromptWindowBuilder::WidgetTemplate {
+    // One per widget the spec's factories create, in order
+    std::vector<std::pair<std::wstring, WidgetFactory>> factories;
+};
+
+PromptWindowBuilder::PromptWindowBuilder()
+    : m_promptCapacity(DEFAULT_PROMPT_CACHE_CAPACITY)
+    , m_promptHits(0)
+    , m_promptMisses(0)
+    , m_promptEvictions(0)
+    , m_widgetArenaEnabled(false)
+    , m_widgetArenaBlockSize(WidgetArena::DEFAULT_BLOCK_SIZE)
+{
     // Register default widget factories
     RegisterWidgetFactory(L"progressbar", [](const std::wstring&) {
-        return std::make_shared<ProgressBar>();
+        return MakeWidget<ProgressBar>();
     });
     
     RegisterWidgetFactory(L"tooltip", [](const std::wstring&) {
-        auto tooltip = std::make_shared<Tooltip>();
+        auto tooltip = MakeWidget<Tooltip>();
         tooltip->SetText(L"Tooltip");
         return tooltip;
     });
@@ -185,7 +202,62 @@ void PromptWindowBuilder::ParseSubwindows(const std::vector<Token>& tokens, size
 }
 
 PromptWindowBuilder::WindowSpec PromptWindowBuilder::ParsePrompt(const std::wstring& prompt) {
-    WindowSpec spec;
+    return LookupPrompt(prompt)->spec;
+}
+
+std::wstring PromptWindowBuilder::NormalizePrompt(const std::wstring& prompt) {
+    // Whitespace only separates tokens, except inside quotes
+    std::wstring key;
+    key.reserve(prompt.size());
+    wchar_t quote = 0;
+    
+    for (wchar_t ch : prompt) {
+        if (quote) {
+            if (ch == quote) quote = 0;
+            key += ch;
+        } else if (std::iswspace(ch)) {
+            if (!key.empty() && key.back() != L' ') key += L' ';
+        } else {
+            if (ch == L'\'' || ch == L'"') quote = ch;
+            key += ch;
+        }
+    }
+    
+    if (!quote && !key.empty() && key.back() == L' ') {
+        key.pop_back();
+    }
+    return key;
+}
+
+std::shared_ptr<const PromptWindowBuilder::CachedPrompt> PromptWindowBuilder::LookupPrompt(const std::wstring& prompt) {
+    std::wstring key = NormalizePrompt(prompt);
+    
+    auto it = m_promptIndex.find(key);
+    if (it != m_promptIndex.end()) {
+        m_promptList.splice(m_promptList.begin(), m_promptList, it->second);
+        m_promptHits++;
+        return it->second->second;
+    }
+    
+    // Parse the normalized text, so every prompt with this key gets the same result
+    m_promptMisses++;
+    std::shared_ptr<CachedPrompt> entry = ParseCachedPrompt(key);
+    entry->spec.widgetTemplate = BuildWidgetTemplate(entry->spec);
+    if (m_promptCapacity == 0) return entry;
+    
+    while (m_promptList.size() >= m_promptCapacity) {
+        m_promptIndex.erase(m_promptList.back().first);
+        m_promptList.pop_back();
+        m_promptEvictions++;
+    }
+    m_promptList.emplace_front(key, entry);
+    m_promptIndex[key] = m_promptList.begin();
+    return entry;
+}
+
+std::shared_ptr<PromptWindowBuilder::CachedPrompt> PromptWindowBuilder::ParseCachedPrompt(const std::wstring& prompt) {
+    auto entry = std::make_shared<CachedPrompt>();
+    WindowSpec& spec = entry->spec;
     
     // Set defaults
     spec.width = 800;
@@ -233,7 +305,50 @@ PromptWindowBuilder::WindowSpec PromptWindowBuilder::ParsePrompt(const std::wstr
         index++;
     }
     
-    return spec;
+    return entry;
+}
+
+std::shared_ptr<const PromptWindowBuilder::WidgetTemplate> PromptWindowBuilder::BuildWidgetTemplate(const WindowSpec& spec) const {
+    auto widgetTemplate = std::make_shared<WidgetTemplate>();
+    widgetTemplate->factories.reserve(spec.widgets.size());
+    for (const auto& widgetType : spec.widgets) {
+        auto it = m_widgetFactories.find(widgetType);
+        if (it != m_widgetFactories.end()) {
+            widgetTemplate->factories.emplace_back(widgetType, it->second);
+        }
+    }
+    return widgetTemplate;
+}
+
+PromptWindowBuilder::PromptCacheStats PromptWindowBuilder::GetPromptCacheStats() const {
+    PromptCacheStats stats;
+    stats.hits = m_promptHits;
+    stats.misses = m_promptMisses;
+    stats.evictions = m_promptEvictions;
+    stats.size = m_promptList.size();
+    uint64_t lookups = m_promptHits + m_promptMisses;
+    stats.hitRate = lookups > 0 ? (float)((double)m_promptHits / lookups) : 0.0f;
+    return stats;
+}
+
+void PromptWindowBuilder::ResetPromptCacheStats() {
+    m_promptHits = 0;
+    m_promptMisses = 0;
+    m_promptEvictions = 0;
+}
+
+void PromptWindowBuilder::SetPromptCacheCapacity(size_t maxPrompts) {
+    m_promptCapacity = maxPrompts;
+    while (m_promptList.size() > m_promptCapacity) {
+        m_promptIndex.erase(m_promptList.back().first);
+        m_promptList.pop_back();
+        m_promptEvictions++;
+    }
+}
+
+void PromptWindowBuilder::ClearPromptCache() {
+    m_promptList.clear();
+    m_promptIndex.clear();
 }
 
 HWND PromptWindowBuilder::CreateWindowFromSpec(const WindowSpec& spec, HINSTANCE hInstance, HWND parent) {
@@ -261,24 +376,57 @@ HWND PromptWindowBuilder::CreateWindowFromSpec(const WindowSpec& spec, HINSTANCE
 
 std::vector<std::shared_ptr<Widget>> PromptWindowBuilder::CreateWidgetsFromSpec(const WindowSpec& spec) {
     std::vector<std::shared_ptr<Widget>> widgets;
+    std::unique_ptr<WidgetArena> arena = BeginBuildArena();
+    WidgetArena::Scope arenaScope(arena ? arena.get() : WidgetArena::GetCurrent());
     
     int widgetId = 1;
-    for (const auto& widgetType : spec.widgets) {
-        auto widget = CreateWidget(widgetType);
-        if (widget) {
-            widget->SetId(widgetId++);
-            widgets.push_back(widget);
+    if (spec.widgetTemplate) {
+        // Factories resolved when the spec was cached; the widgets themselves
+        // have no copy, so each build still runs them
+        widgets.reserve(spec.widgetTemplate->factories.size());
+        for (const auto& factory : spec.widgetTemplate->factories) {
+            auto widget = factory.second(factory.first);
+            if (widget) {
+                widget->SetId(widgetId++);
+                widgets.push_back(widget);
+            }
+        }
+    } else {
+        for (const auto& widgetType : spec.widgets) {
+            auto widget = CreateWidget(widgetType);
+            if (widget) {
+                widget->SetId(widgetId++);
+                widgets.push_back(widget);
+            }
         }
     }
     
+    EndBuildArena(arena.get());
+    
     // Auto-layout widgets
     LayoutWidgets(widgets, spec.width, spec.height);
     
     return widgets;
 }
 
+std::unique_ptr<WidgetArena> PromptWindowBuilder::BeginBuildArena() {
+    if (!m_widgetArenaEnabled || WidgetArena::GetCurrent()) return nullptr;
+    return std::unique_ptr<WidgetArena>(new WidgetArena(m_widgetArenaBlockSize));
+}
+
+void PromptWindowBuilder::EndBuildArena(const WidgetArena* arena) {
+    if (!arena) return;
+    
+    // Room for the whole tree next time, with some slack for growth
+    size_t used = arena->GetBytesUsed();
+    m_widgetArenaBlockSize = std::max(WidgetArena::DEFAULT_BLOCK_SIZE, used + used / 4);
+}
+
 void PromptWindowBuilder::RegisterWidgetFactory(const std::wstring& widgetType, WidgetFactory factory) {
     m_widgetFactories[widgetType] = factory;
+    
+    // Cached specs list only the widget types that had factories
+    ClearPromptCache();
 }
 
 HWND PromptWindowBuilder::BuildFromPrompt(const std::wstring& prompt, HINSTANCE hInstance, HWND parent) {
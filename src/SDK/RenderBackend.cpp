@@ -1,4 +1,11 @@
 #include "../../include/SDK/RenderBackend.h"
+#include "../../include/SDK/EffectGraph.h"
+#include "../../include/SDK/HeadlessRenderBackend.h"
+#include "../../include/SDK/RenderCommandList.h"
+#include "../../include/SDK/ParticleSystem.h"
+#include "../../include/SDK/TextureAtlas.h"
+#include <algorithm>
+#include <cmath>
 
 #if SDK_PLATFORM_WINDOWS
 #include "../../include/SDK/GDIRenderBackend.h"
@@ -6,11 +13,16 @@
 #include <d2d1.h>
 #elif SDK_PLATFORM_LINUX && SDK_HAS_X11
 #include "../../include/SDK/X11RenderBackend.h"
+#include "../../include/SDK/GLRenderBackend.h"
 #endif
 
 namespace SDK {
 
 std::unique_ptr<RenderBackend> RenderBackend::Create(BackendType type) {
+    if (type == BackendType::HEADLESS) {
+        return std::make_unique<HeadlessRenderBackend>();
+    }
+    
 #if SDK_PLATFORM_WINDOWS
     if (type == BackendType::AUTO) {
         // Try Direct2D first (hardware accelerated)
@@ -37,104 +49,227 @@ std::unique_ptr<RenderBackend> RenderBackend::Create(BackendType type) {
         return std::make_unique<GDIRenderBackend>();
     }
 #elif SDK_PLATFORM_LINUX && SDK_HAS_X11
-    // On Linux, always use X11 backend
+    // OpenGL where the server offers core contexts, X11 otherwise
+    if (type == BackendType::OPENGL || (type == BackendType::AUTO && GLRenderBackend::IsAvailable())) {
+        return std::make_unique<GLRenderBackend>();
+    }
     return std::make_unique<X11RenderBackend>();
 #else
     return nullptr;
 #endif
 }
 
-void RenderBackend::ApplyEffectPreset(const RECT& rect, EffectPreset preset) {
-    EffectSettings settings;
+namespace {
+    constexpr int PRESET_COUNT = (int)RenderBackend::EffectPreset::CUSTOM + 1;
     
-    switch (preset) {
-        case EffectPreset::CINEMATIC:
-            // Depth of field + subtle blur + bloom
-            settings.enableDepthOfField = true;
-            settings.focalDepth = (rect.bottom - rect.top) / 2;
-            settings.dofBlurAmount = 8;
-            settings.focalRange = 150.0f;
-            settings.enableBloom = true;
-            settings.bloomThreshold = 0.9f;
-            settings.bloomIntensity = 0.8f;
-            break;
+    // Graphs and their scratch buffers live per thread, so backends on
+    // different threads never share them
+    thread_local EffectGraph t_presetGraphs[PRESET_COUNT];
+    thread_local EffectGraph t_customGraph;
+    
+    bool GetPresetSettings(RenderBackend::EffectPreset preset, const RECT& rect, RenderBackend::EffectSettings& settings) {
+        using EffectPreset = RenderBackend::EffectPreset;
+        
+        switch (preset) {
+            case EffectPreset::CINEMATIC:
+                // Depth of field + subtle blur + bloom
+                settings.enableDepthOfField = true;
+                settings.focalDepth = (rect.bottom - rect.top) / 2;
+                settings.dofBlurAmount = 8;
+                settings.focalRange = 150.0f;
+                settings.enableBloom = true;
+                settings.bloomThreshold = 0.9f;
+                settings.bloomIntensity = 0.8f;
+                break;
             
-        case EffectPreset::GAME_UI:
-            // Sharp edges + glow + chromatic aberration
-            settings.enableBloom = true;
-            settings.bloomThreshold = 0.95f;
-            settings.bloomIntensity = 1.2f;
-            settings.enableChromaticAberration = true;
-            settings.chromaticStrength = 0.005f;
-            settings.chromaticOffsetX = 1;
-            settings.chromaticOffsetY = 1;
-            break;
+            case EffectPreset::GAME_UI:
+                // Sharp edges + glow + chromatic aberration
+                settings.enableBloom = true;
+                settings.bloomThreshold = 0.95f;
+                settings.bloomIntensity = 1.2f;
+                settings.enableChromaticAberration = true;
+                settings.chromaticStrength = 0.005f;
+                settings.chromaticOffsetX = 1;
+                settings.chromaticOffsetY = 1;
+                break;
             
-        case EffectPreset::RETRO:
-            // Chromatic aberration + bloom
-            settings.enableChromaticAberration = true;
-            settings.chromaticStrength = 0.02f;
-            settings.chromaticOffsetX = 3;
-            settings.chromaticOffsetY = 3;
-            settings.enableBloom = true;
-            settings.bloomThreshold = 0.7f;
-            settings.bloomIntensity = 1.5f;
-            break;
+            case EffectPreset::RETRO:
+                // Chromatic aberration + bloom
+                settings.enableChromaticAberration = true;
+                settings.chromaticStrength = 0.02f;
+                settings.chromaticOffsetX = 3;
+                settings.chromaticOffsetY = 3;
+                settings.enableBloom = true;
+                settings.bloomThreshold = 0.7f;
+                settings.bloomIntensity = 1.5f;
+                break;
             
-        case EffectPreset::DREAMY:
-            // Soft blur + bloom
-            settings.enableBlur = true;
-            settings.blurRadius = 3;
-            settings.enableBloom = true;
-            settings.bloomThreshold = 0.6f;
-            settings.bloomIntensity = 1.3f;
-            break;
+            case EffectPreset::DREAMY:
+                // Soft blur + bloom
+                settings.enableBlur = true;
+                settings.blurRadius = 3;
+                settings.enableBloom = true;
+                settings.bloomThreshold = 0.6f;
+                settings.bloomIntensity = 1.3f;
+                break;
             
-        case EffectPreset::MOTION:
-            // Motion blur + slight chromatic aberration
-            settings.enableMotionBlur = true;
-            settings.motionDirX = 10;
-            settings.motionDirY = 0;
-            settings.motionIntensity = 0.7f;
-            settings.enableChromaticAberration = true;
-            settings.chromaticStrength = 0.008f;
-            settings.chromaticOffsetX = 2;
-            settings.chromaticOffsetY = 1;
-            break;
+            case EffectPreset::MOTION:
+                // Motion blur + slight chromatic aberration
+                settings.enableMotionBlur = true;
+                settings.motionDirX = 10;
+                settings.motionDirY = 0;
+                settings.motionIntensity = 0.7f;
+                settings.enableChromaticAberration = true;
+                settings.chromaticStrength = 0.008f;
+                settings.chromaticOffsetX = 2;
+                settings.chromaticOffsetY = 1;
+                break;
             
-        case EffectPreset::NONE:
-        case EffectPreset::CUSTOM:
-        default:
-            // No effects
-            return;
+            case EffectPreset::NONE:
+            case EffectPreset::CUSTOM:
+            default:
+                // No effects
+                return false;
+        }
+        return true;
     }
+}
+
+void RenderBackend::ApplyEffectPreset(const RECT& rect, EffectPreset preset) {
+    EffectSettings settings;
+    if (!GetPresetSettings(preset, rect, settings)) return;
     
-    ApplyCustomEffects(rect, settings);
+    // Only CINEMATIC depends on the rect, through its focal row
+    EffectGraph& graph = t_presetGraphs[(int)preset];
+    if (!graph.IsCompiledFrom(settings)) {
+        graph.Compile(settings);
+    }
+    ApplyEffectGraph(rect, graph);
 }
 
 void RenderBackend::ApplyCustomEffects(const RECT& rect, const EffectSettings& settings) {
-    // Apply effects in order: blur -> depth of field -> motion blur -> chromatic aberration -> bloom
+    if (!t_customGraph.IsCompiledFrom(settings)) {
+        t_customGraph.Compile(settings);
+    }
+    ApplyEffectGraph(rect, t_customGraph);
+}
+
+void RenderBackend::ApplyEffectGraph(const RECT& rect, EffectGraph& graph) {
+    const EffectSettings& settings = graph.GetSettings();
     
-    if (settings.enableBlur) {
-        ApplyBlur(rect, settings.blurRadius);
+    for (const EffectGraph::Stage& stage : graph.GetStages()) {
+        switch (stage.type) {
+            case EffectGraph::StageType::BLUR:
+                ApplyBlur(rect, settings.blurRadius);
+                break;
+            case EffectGraph::StageType::DEPTH_OF_FIELD:
+                ApplyDepthOfField(rect, settings.focalDepth, settings.dofBlurAmount, settings.focalRange);
+                break;
+            case EffectGraph::StageType::MOTION_BLUR:
+                ApplyMotionBlur(rect, settings.motionDirX, settings.motionDirY, settings.motionIntensity);
+                break;
+            case EffectGraph::StageType::CHROMATIC_ABERRATION:
+                ApplyChromaticAberration(rect, settings.chromaticStrength,
+                                         settings.chromaticOffsetX, settings.chromaticOffsetY);
+                break;
+            case EffectGraph::StageType::BLOOM:
+                ApplyBloom(rect, settings.bloomThreshold, settings.bloomIntensity);
+                break;
+        }
     }
+}
+
+void RenderBackend::DrawTextLine(const std::wstring& text, const RECT& rect, Color color, const std::wstring& fontFamily, float fontSize, int fontWeight, TextAlign align) {
+    RECT lineRect = rect;
+    int width = MeasureText(text, fontFamily, fontSize, fontWeight);
+    int space = (int)(rect.right - rect.left) - width;
     
-    if (settings.enableDepthOfField) {
-        ApplyDepthOfField(rect, settings.focalDepth, settings.dofBlurAmount, settings.focalRange);
+    if (align == TextAlign::CENTER) {
+        lineRect.left += space / 2;
+    } else if (align == TextAlign::RIGHT) {
+        lineRect.left += space;
     }
+    lineRect.top = (rect.top + rect.bottom) / 2 - (long)(fontSize / 2.0f);
+    lineRect.bottom = lineRect.top + (long)fontSize + 1;
     
-    if (settings.enableMotionBlur) {
-        ApplyMotionBlur(rect, settings.motionDirX, settings.motionDirY, settings.motionIntensity);
+    DrawText(text, lineRect, color, fontFamily, fontSize, fontWeight);
+}
+
+int RenderBackend::MeasureText(const std::wstring& text, const std::wstring& fontFamily, float fontSize, int fontWeight) {
+    (void)fontFamily;
+    
+    // Average glyph of a proportional UI font; bold runs a little wider
+    float glyphWidth = fontSize * (fontWeight >= FW_BOLD ? 0.6f : 0.55f);
+    return (int)(text.length() * glyphWidth + 0.5f);
+}
+
+void RenderBackend::DrawParticleBatch(const float* x, const float* y, const uint32_t* colors, size_t count, int size) {
+    if (!x || !y || !colors || size <= 0) return;
+    
+    for (size_t i = 0; i < count; i++) {
+        uint32_t c = colors[i];
+        Color color((c >> 16) & 0xFF, (c >> 8) & 0xFF, c & 0xFF, c >> 24);
+        if (color.a == 0) continue;
+        
+        RECT rect;
+        rect.left = (long)std::floor(x[i]) - size / 2;
+        rect.top = (long)std::floor(y[i]) - size / 2;
+        rect.right = rect.left + size;
+        rect.bottom = rect.top + size;
+        DrawRectangle(rect, color, color, 0.0f);
     }
+}
+
+void RenderBackend::DrawPolylines(const POINT* points, const DWORD* counts, size_t polylineCount, Color color, float width) {
+    if (!points || !counts) return;
     
-    if (settings.enableChromaticAberration) {
-        ApplyChromaticAberration(rect, settings.chromaticStrength, 
-                                  settings.chromaticOffsetX, settings.chromaticOffsetY);
+    for (size_t i = 0; i < polylineCount; i++) {
+        DWORD count = counts[i];
+        for (DWORD k = 1; k < count; k++) {
+            DrawLine(points[k - 1].x, points[k - 1].y, points[k].x, points[k].y, color, width);
+        }
+        points += count;
     }
+}
+
+void RenderBackend::DrawParticles(const ParticleSystem& particles, int size) {
+    DrawParticleBatch(particles.GetX(), particles.GetY(), particles.GetColors(), particles.GetCount(), size);
+}
+
+void RenderBackend::DrawAtlasTexture(const TextureAtlas& atlas, const std::string& name, const RECT& dest) {
+    HDC hdc = BeginGDIInterop();
+    if (!hdc) return;
     
-    if (settings.enableBloom) {
-        ApplyBloom(rect, settings.bloomThreshold, settings.bloomIntensity);
+    atlas.Draw(hdc, name, dest);
+    EndGDIInterop(hdc);
+}
+
+bool RenderBackend::GetParticleBounds(const float* x, const float* y, size_t count, int size, const RECT& clip, RECT& bounds) {
+    if (!x || !y || count == 0 || size <= 0) return false;
+    
+    // Comparisons skip NaN positions; the splat kernels skip them too
+    float minX = HUGE_VALF, maxX = -HUGE_VALF;
+    float minY = HUGE_VALF, maxY = -HUGE_VALF;
+    for (size_t i = 0; i < count; i++) {
+        if (x[i] < minX) minX = x[i];
+        if (x[i] > maxX) maxX = x[i];
+        if (y[i] < minY) minY = y[i];
+        if (y[i] > maxY) maxY = y[i];
     }
+    if (!(minX <= maxX && minY <= maxY)) return false;
+    
+    // Squares start size / 2 before the particle's pixel; clamp before converting
+    // so far-off particles can't overflow
+    float pad = (float)(size / 2);
+    bounds.left = std::max((long)clip.left, (long)std::floor(std::max(minX - pad, (float)clip.left)));
+    bounds.top = std::max((long)clip.top, (long)std::floor(std::max(minY - pad, (float)clip.top)));
+    bounds.right = std::min((long)clip.right, (long)std::floor(std::min(maxX - pad, (float)clip.right)) + size);
+    bounds.bottom = std::min((long)clip.bottom, (long)std::floor(std::min(maxY - pad, (float)clip.bottom)) + size);
+    return bounds.right > bounds.left && bounds.bottom > bounds.top;
+}
+
+void RenderBackend::ExecuteCommandList(const RenderCommandList& commands) {
+    commands.Replay(*this);
 }
 
 } // namespace SDK
@@ -0,0 +1,432 @@
+#include "../../include/SDK/RenderCommandList.h"
+#include "../../include/SDK/RenderBackend.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <tuple>
+
+namespace SDK {
+
+namespace {
+    using Command = RenderCommandList::Command;
+    using CommandType = RenderCommandList::CommandType;
+
+    constexpr uint64_t FNV_OFFSET = 14695981039346656037ull;
+    constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+    void HashBytes(uint64_t& hash, const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ bytes[i]) * FNV_PRIME;
+        }
+    }
+
+    template <typename T>
+    void HashValue(uint64_t& hash, const T& value) {
+        HashBytes(hash, &value, sizeof(value));
+    }
+
+    uint32_t PackColor(Color color) {
+        return ((uint32_t)color.r << 24) | ((uint32_t)color.g << 16) | ((uint32_t)color.b << 8) | color.a;
+    }
+
+    uint32_t FloatBits(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    Command MakeCommand(CommandType type, const RECT& rect) {
+        Command command = {};
+        command.type = type;
+        command.rect = rect;
+        return command;
+    }
+
+    bool IsEffect(CommandType type) {
+        return type >= CommandType::BLUR;
+    }
+
+    // Everything a backend sets up before drawing: primitive, brushes, pen, font.
+    // Geometry is left out so commands that differ only in position share a batch.
+    using StateKey = std::tuple<int, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, int>;
+
+    StateKey GetStateKey(const Command& command) {
+        bool text = command.type == CommandType::TEXT;
+        return StateKey((int)command.type, PackColor(command.color), PackColor(command.secondColor),
+                        FloatBits(command.width), text ? command.font : 0,
+                        text ? FloatBits(command.value[0]) : 0, text ? command.param[0] : 0);
+    }
+
+    // Pixels a command may touch; conservative where backends differ
+    RECT GetBounds(const Command& command) {
+        RECT bounds = command.rect;
+        long pad = (long)std::ceil(command.width / 2.0f) + 1;
+
+        switch (command.type) {
+            case CommandType::LINE:
+                bounds.left = std::min(command.rect.left, command.rect.right);
+                bounds.right = std::max(command.rect.left, command.rect.right);
+                bounds.top = std::min(command.rect.top, command.rect.bottom);
+                bounds.bottom = std::max(command.rect.top, command.rect.bottom);
+                break;
+            case CommandType::TEXT: {
+                // Text isn't clipped to its rect and backends place the baseline differently
+                long size = (long)std::ceil(command.value[0]);
+                pad = size;
+                bounds.right = LONG_MAX / 2;
+                bounds.bottom = std::max(command.rect.bottom, command.rect.top + 2 * size);
+                break;
+            }
+            case CommandType::SHADOW:
+                bounds.left += command.param[0];
+                bounds.right += command.param[0];
+                bounds.top += command.param[1];
+                bounds.bottom += command.param[1];
+                pad = 3 * std::abs(command.param[2]) + 1;     // Blur reaches about three deviations
+                break;
+            case CommandType::GLOW:
+                pad = std::abs(command.param[0]) + 1;
+                break;
+            default:
+                break;
+        }
+
+        bounds.left -= pad;
+        bounds.top -= pad;
+        bounds.right += pad;
+        bounds.bottom += pad;
+        return bounds;
+    }
+
+    bool Overlaps(const RECT& a, const RECT& b) {
+        return a.left < b.right && b.left < a.right && a.top < b.bottom && b.top < a.bottom;
+    }
+}
+
+RenderCommandList::RenderCommandList()
+    : m_sortingEnabled(true)
+    , m_hash(FNV_OFFSET)
+    , m_orderValid(false)
+{
+}
+
+void RenderCommandList::DrawRectangle(const RECT& rect, Color fillColor, Color borderColor, float borderWidth) {
+    Command command = MakeCommand(CommandType::RECTANGLE, rect);
+    command.color = fillColor;
+    command.secondColor = borderColor;
+    command.width = borderWidth;
+    Push(command);
+}
+
+void RenderCommandList::DrawRoundedRectangle(const RECT& rect, float radius, Color fillColor, Color borderColor, float borderWidth) {
+    Command command = MakeCommand(CommandType::ROUNDED_RECTANGLE, rect);
+    command.color = fillColor;
+    command.secondColor = borderColor;
+    command.width = borderWidth;
+    command.value[0] = radius;
+    Push(command);
+}
+
+void RenderCommandList::DrawLine(int x1, int y1, int x2, int y2, Color color, float width) {
+    RECT ends = { x1, y1, x2, y2 };
+    Command command = MakeCommand(CommandType::LINE, ends);
+    command.color = color;
+    command.width = width;
+    Push(command);
+}
+
+void RenderCommandList::DrawEllipse(int cx, int cy, int rx, int ry, Color fillColor, Color borderColor, float borderWidth) {
+    RECT box = { cx - rx, cy - ry, cx + rx, cy + ry };
+    Command command = MakeCommand(CommandType::ELLIPSE, box);
+    command.color = fillColor;
+    command.secondColor = borderColor;
+    command.width = borderWidth;
+    Push(command);
+}
+
+void RenderCommandList::DrawText(const std::wstring& text, const RECT& rect, Color color, const std::wstring& fontFamily, float fontSize, int fontWeight) {
+    Command command = MakeCommand(CommandType::TEXT, rect);
+    command.color = color;
+    command.value[0] = fontSize;
+    command.param[0] = fontWeight;
+    command.text = AddString(text);
+    command.font = AddString(fontFamily);
+    Push(command);
+}
+
+void RenderCommandList::DrawLinearGradient(const RECT& rect, Color startColor, Color endColor, bool horizontal) {
+    Command command = MakeCommand(CommandType::LINEAR_GRADIENT, rect);
+    command.color = startColor;
+    command.secondColor = endColor;
+    command.param[0] = horizontal ? 1 : 0;
+    Push(command);
+}
+
+void RenderCommandList::DrawRadialGradient(const RECT& rect, Color centerColor, Color edgeColor, int cx, int cy) {
+    Command command = MakeCommand(CommandType::RADIAL_GRADIENT, rect);
+    command.color = centerColor;
+    command.secondColor = edgeColor;
+    command.param[0] = cx;
+    command.param[1] = cy;
+    Push(command);
+}
+
+void RenderCommandList::DrawShadow(const RECT& rect, int offsetX, int offsetY, int blur, Color shadowColor) {
+    Command command = MakeCommand(CommandType::SHADOW, rect);
+    command.color = shadowColor;
+    command.param[0] = offsetX;
+    command.param[1] = offsetY;
+    command.param[2] = blur;
+    Push(command);
+}
+
+void RenderCommandList::DrawGlow(const RECT& rect, int radius, Color glowColor) {
+    Command command = MakeCommand(CommandType::GLOW, rect);
+    command.color = glowColor;
+    command.param[0] = radius;
+    Push(command);
+}
+
+void RenderCommandList::ApplyBlur(const RECT& rect, int blurRadius) {
+    Command command = MakeCommand(CommandType::BLUR, rect);
+    command.param[0] = blurRadius;
+    Push(command);
+}
+
+void RenderCommandList::ApplyBloom(const RECT& rect, float threshold, float intensity) {
+    Command command = MakeCommand(CommandType::BLOOM, rect);
+    command.value[0] = threshold;
+    command.value[1] = intensity;
+    Push(command);
+}
+
+void RenderCommandList::ApplyDepthOfField(const RECT& rect, int focalDepth, int blurAmount, float focalRange) {
+    Command command = MakeCommand(CommandType::DEPTH_OF_FIELD, rect);
+    command.param[0] = focalDepth;
+    command.param[1] = blurAmount;
+    command.value[0] = focalRange;
+    Push(command);
+}
+
+void RenderCommandList::ApplyMotionBlur(const RECT& rect, int directionX, int directionY, float intensity) {
+    Command command = MakeCommand(CommandType::MOTION_BLUR, rect);
+    command.param[0] = directionX;
+    command.param[1] = directionY;
+    command.value[0] = intensity;
+    Push(command);
+}
+
+void RenderCommandList::ApplyChromaticAberration(const RECT& rect, float strength, int offsetX, int offsetY) {
+    Command command = MakeCommand(CommandType::CHROMATIC_ABERRATION, rect);
+    command.value[0] = strength;
+    command.param[0] = offsetX;
+    command.param[1] = offsetY;
+    Push(command);
+}
+
+void RenderCommandList::Reset() {
+    m_commands.clear();
+    m_strings.clear();
+    m_stringIndex.clear();
+    m_hash = FNV_OFFSET;
+    m_orderValid = false;
+}
+
+void RenderCommandList::SetSortingEnabled(bool enabled) {
+    if (m_sortingEnabled != enabled) {
+        m_sortingEnabled = enabled;
+        m_orderValid = false;
+    }
+}
+
+void RenderCommandList::Push(const Command& command) {
+    // Field by field, so struct padding never reaches the hash
+    HashValue(m_hash, command.type);
+    HashValue(m_hash, command.rect.left);
+    HashValue(m_hash, command.rect.top);
+    HashValue(m_hash, command.rect.right);
+    HashValue(m_hash, command.rect.bottom);
+    HashValue(m_hash, PackColor(command.color));
+    HashValue(m_hash, PackColor(command.secondColor));
+    HashValue(m_hash, FloatBits(command.width));
+    HashValue(m_hash, FloatBits(command.value[0]));
+    HashValue(m_hash, FloatBits(command.value[1]));
+    HashBytes(m_hash, command.param, sizeof(command.param));
+    HashValue(m_hash, command.text);
+    HashValue(m_hash, command.font);
+
+    m_commands.push_back(command);
+    m_orderValid = false;
+}
+
+uint32_t RenderCommandList::AddString(const std::wstring& text) {
+    auto it = m_stringIndex.find(text);
+    if (it != m_stringIndex.end()) {
+        return it->second;
+    }
+
+    // New strings are hashed once; repeats are covered by their index
+    HashValue(m_hash, text.length());
+    HashBytes(m_hash, text.data(), text.length() * sizeof(wchar_t));
+
+    uint32_t index = (uint32_t)m_strings.size();
+    m_strings.push_back(text);
+    m_stringIndex.emplace(text, index);
+    return index;
+}
+
+bool RenderCommandList::Matches(const RenderCommandList& other) const {
+    if (m_hash != other.m_hash || m_commands.size() != other.m_commands.size() ||
+        m_strings != other.m_strings) {
+        return false;
+    }
+
+    for (size_t i = 0; i < m_commands.size(); i++) {
+        const Command& a = m_commands[i];
+        const Command& b = other.m_commands[i];
+        if (a.type != b.type ||
+            a.rect.left != b.rect.left || a.rect.top != b.rect.top ||
+            a.rect.right != b.rect.right || a.rect.bottom != b.rect.bottom ||
+            PackColor(a.color) != PackColor(b.color) || PackColor(a.secondColor) != PackColor(b.secondColor) ||
+            FloatBits(a.width) != FloatBits(b.width) ||
+            FloatBits(a.value[0]) != FloatBits(b.value[0]) || FloatBits(a.value[1]) != FloatBits(b.value[1]) ||
+            std::memcmp(a.param, b.param, sizeof(a.param)) != 0 ||
+            a.text != b.text || a.font != b.font) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void RenderCommandList::BuildOrder() const {
+    if (m_orderValid) return;
+
+    size_t count = m_commands.size();
+    m_order.resize(count);
+    m_batches.clear();
+
+    // Small ids in order of first appearance keep the sort cheap
+    std::map<StateKey, uint32_t> stateIds;
+    std::vector<uint32_t> states(count);
+    for (size_t i = 0; i < count; i++) {
+        states[i] = stateIds.emplace(GetStateKey(m_commands[i]), (uint32_t)stateIds.size()).first->second;
+        m_order[i] = (uint32_t)i;
+    }
+
+    if (m_sortingEnabled && count > 1 && count <= MAX_SORTED_COMMANDS) {
+        // A command's level is the earliest pass it can be drawn in: after every
+        // earlier command it overlaps, or alongside one that shares its state.
+        // Effects read back everything before them, so they act as full barriers.
+        std::vector<RECT> bounds(count);
+        std::vector<uint32_t> levels(count, 0);
+        uint32_t barrier = 0;
+        uint32_t highest = 0;
+
+        for (size_t i = 0; i < count; i++) {
+            if (IsEffect(m_commands[i].type)) {
+                levels[i] = ++highest;
+                barrier = highest + 1;
+                continue;
+            }
+
+            bounds[i] = GetBounds(m_commands[i]);
+            uint32_t level = barrier;
+            for (size_t j = i; j-- > 0;) {
+                if (levels[j] < barrier) break;     // At or before the last effect
+                if (!Overlaps(bounds[i], bounds[j])) continue;
+                level = std::max(level, states[j] == states[i] ? levels[j] : levels[j] + 1);
+            }
+            levels[i] = level;
+            highest = std::max(highest, level);
+        }
+
+        std::stable_sort(m_order.begin(), m_order.end(), [&](uint32_t a, uint32_t b) {
+            if (levels[a] != levels[b]) return levels[a] < levels[b];
+            return states[a] < states[b];
+        });
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (m_batches.empty() || states[m_order[i]] != states[m_order[m_batches.back().first]]) {
+            m_batches.push_back(Batch{ i, 0 });
+        }
+        m_batches.back().count++;
+    }
+
+    m_orderValid = true;
+}
+
+const RenderCommandList::Command& RenderCommandList::GetOrderedCommand(size_t index) const {
+    BuildOrder();
+    return m_commands[m_order[index]];
+}
+
+const std::vector<RenderCommandList::Batch>& RenderCommandList::GetBatches() const {
+    BuildOrder();
+    return m_batches;
+}
+
+void RenderCommandList::Replay(RenderBackend& backend) const {
+    for (const Batch& batch : GetBatches()) {
+        Replay(backend, batch);
+    }
+}
+
+void RenderCommandList::Replay(RenderBackend& backend, const Batch& batch) const {
+    BuildOrder();
+
+    for (size_t i = batch.first; i < batch.first + batch.count; i++) {
+        const Command& c = m_commands[m_order[i]];
+        switch (c.type) {
+            case CommandType::RECTANGLE:
+                backend.DrawRectangle(c.rect, c.color, c.secondColor, c.width);
+                break;
+            case CommandType::ROUNDED_RECTANGLE:
+                backend.DrawRoundedRectangle(c.rect, c.value[0], c.color, c.secondColor, c.width);
+                break;
+            case CommandType::LINE:
+                backend.DrawLine(c.rect.left, c.rect.top, c.rect.right, c.rect.bottom, c.color, c.width);
+                break;
+            case CommandType::ELLIPSE:
+                backend.DrawEllipse((c.rect.left + c.rect.right) / 2, (c.rect.top + c.rect.bottom) / 2,
+                                    (c.rect.right - c.rect.left) / 2, (c.rect.bottom - c.rect.top) / 2,
+                                    c.color, c.secondColor, c.width);
+                break;
+            case CommandType::TEXT:
+                backend.DrawText(m_strings[c.text], c.rect, c.color, m_strings[c.font], c.value[0], c.param[0]);
+                break;
+            case CommandType::LINEAR_GRADIENT:
+                backend.DrawLinearGradient(c.rect, c.color, c.secondColor, c.param[0] != 0);
+                break;
+            case CommandType::RADIAL_GRADIENT:
+                backend.DrawRadialGradient(c.rect, c.color, c.secondColor, c.param[0], c.param[1]);
+                break;
+            case CommandType::SHADOW:
+                backend.DrawShadow(c.rect, c.param[0], c.param[1], c.param[2], c.color);
+                break;
+            case CommandType::GLOW:
+                backend.DrawGlow(c.rect, c.param[0], c.color);
+                break;
+            case CommandType::BLUR:
+                backend.ApplyBlur(c.rect, c.param[0]);
+                break;
+            case CommandType::BLOOM:
+                backend.ApplyBloom(c.rect, c.value[0], c.value[1]);
+                break;
+            case CommandType::DEPTH_OF_FIELD:
+                backend.ApplyDepthOfField(c.rect, c.param[0], c.param[1], c.value[0]);
+                break;
+            case CommandType::MOTION_BLUR:
+                backend.ApplyMotionBlur(c.rect, c.param[0], c.param[1], c.value[0]);
+                break;
+            case CommandType::CHROMATIC_ABERRATION:
+                backend.ApplyChromaticAberration(c.rect, c.value[0], c.param[0], c.param[1]);
+                break;
+        }
+    }
+}
+
+} // namespace SDK
@@ -1,4 +1,13 @@
 #include "../../include/SDK/Renderer.h"
+#include "../../include/SDK/PixelKernels.h"
+#include "../../include/SDK/JobScheduler.h"
+#include "../../include/SDK/ShadowCache.h"
+#include "../../include/SDK/RenderBackend.h"
+#include "../../include/SDK/CameraController.h"
+#include "../../include/SDK/AnimationTimeline.h"
+#include "../../include/SDK/Profiler.h"
+#include "../../include/SDK/FrameArena.h"
+#include "../../include/SDK/SharedAssetCache.h"
 #include <cmath>
 #include <cstdlib>
 #include <ctime>
@@ -6,14 +15,317 @@
 #include <string>
 #include <unordered_map>
 
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define SDK_PROJECT_X86 1
+    #include <immintrin.h>
+#else
+    #define SDK_PROJECT_X86 0
+#endif
+
 namespace SDK {
 
 // Rendering constants
 namespace {
     constexpr float CAMERA_DISTANCE = 300.0f;
     constexpr float MIN_PROJECTION_DISTANCE = 1.0f;
+    constexpr float PROJECTION_FOV = 500.0f;
+    
+    // Project3Dto2D's fixed camera as a view-projection matrix
+    const float DEFAULT_VIEW_PROJECTION[16] = {
+        PROJECTION_FOV, 0.0f, 0.0f, 0.0f,
+        0.0f, PROJECTION_FOV, 0.0f, 0.0f,
+        0.0f, 0.0f, 1.0f, 0.0f,
+        0.0f, 0.0f, 1.0f, CAMERA_DISTANCE
+    };
     constexpr float DEPTH_SCALE_MIN = 0.7f;
     constexpr float DEPTH_SCALE_FACTOR = 0.06f;
+    
+    // Smallest particle range worth handing to another worker
+    constexpr size_t PARTICLE_CHUNK_SIZE = 2048;
+    
+    // Uncovered pieces IsRectOccluded tracks before giving up
+    constexpr size_t MAX_OCCLUSION_PIECES = 64;
+    
+    Renderer::PixelAccessMode g_pixelAccessMode = Renderer::PixelAccessMode::DIB_SECTION;
+    
+    // Gathers live particles so they can be splatted in one pass instead of
+    // one brush and Ellipse call each. Lives in the frame arena, so open a
+    // FrameArena::Scope around it.
+    struct ParticleBatch {
+        // Matches the 4 x 4 footprint of the per-particle Ellipse fallback
+        static constexpr int SIZE = 4;
+        
+        FrameVector<float> x, y;
+        FrameVector<uint32_t> colors;
+        
+        ParticleBatch() : x(FrameArena::GetResource()), y(FrameArena::GetResource()), colors(FrameArena::GetResource()) {}
+        
+        void Add(const Renderer::Particle& particle) {
+            x.push_back(particle.x);
+            y.push_back(particle.y);
+            colors.push_back(((uint32_t)particle.color.a << 24) | ((uint32_t)particle.color.r << 16) |
+                             ((uint32_t)particle.color.g << 8) | (uint32_t)particle.color.b);
+        }
+        
+        // False when the DC can't be read back and the caller should draw per particle
+        bool Splat(HDC hdc) const {
+            if (x.empty()) return true;
+            
+            RECT clip;
+            if (GetClipBox(hdc, &clip) == ERROR) return false;
+            RECT bounds;
+            if (!RenderBackend::GetParticleBounds(x.data(), y.data(), x.size(), SIZE, clip, bounds)) return true;
+            
+            Renderer::PixelSurface surface;
+            if (!Renderer::BeginPixelAccess(hdc, bounds, surface)) return false;
+            PixelKernels::SplatParticles(surface.pixels, surface.width, surface.height, surface.width,
+                                         x.data(), y.data(), colors.data(), x.size(), bounds.left, bounds.top, SIZE);
+            Renderer::EndPixelAccess(hdc, bounds, surface);
+            return true;
+        }
+    };
+    
+    // Raw BGRA pixel helpers (DIB section layout: 0xAARRGGBB)
+    inline int PixelR(uint32_t p) { return (int)((p >> 16) & 0xFF); }
+    inline int PixelG(uint32_t p) { return (int)((p >> 8) & 0xFF); }
+    inline int PixelB(uint32_t p) { return (int)(p & 0xFF); }
+    inline uint32_t MakePixel(int r, int g, int b, uint32_t alpha = 0) {
+        return (alpha & 0xFF000000) | ((uint32_t)r << 16) | ((uint32_t)g << 8) | (uint32_t)b;
+    }
+    
+    // Buffer kernels used by the DIB section path. Blur and bloom live in
+    // PixelKernels; these mirror the per-pixel GDI fallbacks below.
+    void ColorCorrectPixels(uint32_t* pixels, size_t count, float brightness, float contrast, float saturation) {
+        for (size_t i = 0; i < count; i++) {
+            float r = PixelR(pixels[i]) / 255.0f + brightness;
+            float g = PixelG(pixels[i]) / 255.0f + brightness;
+            float b = PixelB(pixels[i]) / 255.0f + brightness;
+            
+            r = (r - 0.5f) * contrast + 0.5f;
+            g = (g - 0.5f) * contrast + 0.5f;
+            b = (b - 0.5f) * contrast + 0.5f;
+            
+            float gray = 0.299f * r + 0.587f * g + 0.114f * b;
+            r = std::max(0.0f, std::min(1.0f, gray + (r - gray) * saturation));
+            g = std::max(0.0f, std::min(1.0f, gray + (g - gray) * saturation));
+            b = std::max(0.0f, std::min(1.0f, gray + (b - gray) * saturation));
+            
+            pixels[i] = MakePixel((int)(r * 255), (int)(g * 255), (int)(b * 255), pixels[i]);
+        }
+    }
+    
+    void NoisePixels(uint32_t* pixels, size_t count, float intensity) {
+        for (size_t i = 0; i < count; i++) {
+            int noise = (int)(((rand() % 256) / 255.0f - 0.5f) * intensity * 255);
+            pixels[i] = MakePixel(std::max(0, std::min(255, PixelR(pixels[i]) + noise)),
+                                  std::max(0, std::min(255, PixelG(pixels[i]) + noise)),
+                                  std::max(0, std::min(255, PixelB(pixels[i]) + noise)), pixels[i]);
+        }
+    }
+    
+    // Gradient cache: rasterized radial/conical gradients keyed by kind, size,
+    // center and stops so repeated repaints become a single blit. Entries
+    // found in the current SharedAssetCache point into it instead of owning pixels.
+    struct CachedGradient {
+        std::vector<uint32_t> pixels;
+        std::shared_ptr<const SharedAssetCache> shared;
+        const uint32_t* data;
+        int width;
+        int height;
+        uint64_t lastUse;
+    };
+    
+    // Gradients in a SharedAssetCache are stored under this prefix and the
+    // local key, as width * height pixels
+    constexpr const char* SHARED_GRADIENT_PREFIX = "Gradient:";
+    
+    std::mutex g_gradientCacheMutex;
+    std::unordered_map<std::string, CachedGradient> g_gradientCache;
+    bool g_gradientCacheEnabled = true;
+    size_t g_gradientCacheCapacity = 64;
+    uint64_t g_gradientCacheClock = 0;
+    
+    template<typename T>
+    void AppendKey(std::string& key, const T& value) {
+        key.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    
+    void AppendKey(std::string& key, const Color& color) {
+        key.push_back((char)color.r);
+        key.push_back((char)color.g);
+        key.push_back((char)color.b);
+        key.push_back((char)color.a);
+    }
+    
+    inline uint32_t ColorToPixel(const Color& color) {
+        return MakePixel(color.r, color.g, color.b);
+    }
+    
+    inline TRIVERTEX MakeVertex(LONG x, LONG y, const Color& color) {
+        TRIVERTEX vertex;
+        vertex.x = x;
+        vertex.y = y;
+        vertex.Red = (USHORT)(color.r << 8);
+        vertex.Green = (USHORT)(color.g << 8);
+        vertex.Blue = (USHORT)(color.b << 8);
+        vertex.Alpha = (USHORT)(color.a << 8);
+        return vertex;
+    }
+    
+    Color SampleStops(const std::vector<Renderer::GradientStop>& stops, float t) {
+        if (t <= stops[0].position) return stops[0].color;
+        if (t >= stops[stops.size() - 1].position) return stops[stops.size() - 1].color;
+        
+        for (size_t j = 0; j < stops.size() - 1; j++) {
+            if (t >= stops[j].position && t <= stops[j + 1].position) {
+                float span = stops[j + 1].position - stops[j].position;
+                float localT = span > 0.0f ? (t - stops[j].position) / span : 0.0f;
+                return Renderer::InterpolateColor(stops[j].color, stops[j + 1].color, localT);
+            }
+        }
+        return stops[stops.size() - 1].color;
+    }
+    
+    void BlitPixels(HDC hdc, int x, int y, int width, int height, const uint32_t* pixels) {
+        BITMAPINFO bmi = {};
+        bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+        bmi.bmiHeader.biWidth = width;
+        bmi.bmiHeader.biHeight = -height; // Top-down
+        bmi.bmiHeader.biPlanes = 1;
+        bmi.bmiHeader.biBitCount = 32;
+        bmi.bmiHeader.biCompression = BI_RGB;
+        SetDIBitsToDevice(hdc, x, y, width, height, 0, 0, 0, height, pixels, &bmi, DIB_RGB_COLORS);
+    }
+    
+    // Caller holds g_gradientCacheMutex
+    CachedGradient& InsertGradient(const std::string& key, int width, int height) {
+        if (g_gradientCache.size() >= g_gradientCacheCapacity) {
+            auto oldest = g_gradientCache.begin();
+            for (auto it = g_gradientCache.begin(); it != g_gradientCache.end(); ++it) {
+                if (it->second.lastUse < oldest->second.lastUse) oldest = it;
+            }
+            g_gradientCache.erase(oldest);
+        }
+        
+        CachedGradient& entry = g_gradientCache[key];
+        entry.width = width;
+        entry.height = height;
+        entry.lastUse = ++g_gradientCacheClock;
+        return entry;
+    }
+    
+    // Blit the cached raster for key, else the one in the current
+    // SharedAssetCache, or rasterize(pixels, width, height) into a buffer,
+    // blit it once and remember it
+    template<typename Rasterize>
+    void DrawBufferedGradient(HDC hdc, const RECT& rect, const std::string& key, Rasterize rasterize) {
+        int width = rect.right - rect.left;
+        int height = rect.bottom - rect.top;
+        if (width <= 0 || height <= 0) return;
+        
+        {
+            std::lock_guard<std::mutex> lock(g_gradientCacheMutex);
+            if (g_gradientCacheEnabled) {
+                auto it = g_gradientCache.find(key);
+                if (it != g_gradientCache.end()) {
+                    it->second.lastUse = ++g_gradientCacheClock;
+                    BlitPixels(hdc, rect.left, rect.top, width, height, it->second.data);
+                    return;
+                }
+            }
+        }
+        
+        size_t count = (size_t)width * height;
+        std::string sharedKey = SHARED_GRADIENT_PREFIX + key;
+        SharedAssetCache::Blob blob;
+        std::shared_ptr<const SharedAssetCache> shared = SharedAssetCache::FindCurrent(sharedKey, blob);
+        if (shared && blob.size == count * sizeof(uint32_t)) {
+            const uint32_t* pixels = static_cast<const uint32_t*>(blob.data);
+            BlitPixels(hdc, rect.left, rect.top, width, height, pixels);
+            
+            std::lock_guard<std::mutex> lock(g_gradientCacheMutex);
+            if (!g_gradientCacheEnabled || g_gradientCacheCapacity == 0) return;
+            CachedGradient& entry = InsertGradient(key, width, height);
+            entry.pixels.clear();
+            entry.shared = std::move(shared);
+            entry.data = pixels;
+            return;
+        }
+        
+        std::vector<uint32_t> pixels(count);
+        rasterize(pixels.data(), width, height);
+        BlitPixels(hdc, rect.left, rect.top, width, height, pixels.data());
+        
+        std::lock_guard<std::mutex> lock(g_gradientCacheMutex);
+        if (!g_gradientCacheEnabled || g_gradientCacheCapacity == 0) return;
+        
+        CachedGradient& entry = InsertGradient(key, width, height);
+        entry.pixels = std::move(pixels);
+        entry.shared.reset();
+        entry.data = entry.pixels.data();
+    }
+    
+    // GDI surface attached to a ShadowCache tile on first use
+    struct GdiShadowTile {
+        HDC dc;
+        HBITMAP bitmap;
+        
+        GdiShadowTile() : dc(nullptr), bitmap(nullptr) {}
+        ~GdiShadowTile() {
+            if (dc) Renderer::DeleteMemoryDC(dc, bitmap, GdiSubsystem::SHADOWS);
+        }
+    };
+    
+    std::mutex g_shadowTileMutex;
+    
+    HDC GetShadowTileDC(const ShadowCache::NineSlice& tile) {
+        std::lock_guard<std::mutex> lock(g_shadowTileMutex);
+        if (tile.platformData) {
+            return static_cast<GdiShadowTile*>(tile.platformData.get())->dc;
+        }
+        
+        auto surface = std::make_shared<GdiShadowTile>();
+        uint32_t* bits = nullptr;
+        surface->dc = Renderer::CreateDIBMemoryDC(tile.size, tile.size, &surface->bitmap, &bits, GdiSubsystem::SHADOWS);
+        if (!surface->dc) return nullptr;
+        
+        std::copy(tile.pixels.begin(), tile.pixels.end(), bits);
+        tile.platformData = surface;
+        return surface->dc;
+    }
+    
+    // Nine AlphaBlend calls: corners copied, edges and center stretched
+    void CompositeNineSlice(HDC hdc, const ShadowCache::NineSlice& tile, const RECT& shapeRect) {
+        HDC tileDC = GetShadowTileDC(tile);
+        if (!tileDC) return;
+        
+        RECT outer = ShadowCache::GetOuterRect(tile, shapeRect);
+        ShadowCache::SliceSpans columns = ShadowCache::ComputeSpans(tile, outer.right - outer.left);
+        ShadowCache::SliceSpans rows = ShadowCache::ComputeSpans(tile, outer.bottom - outer.top);
+        
+        BLENDFUNCTION blend;
+        blend.BlendOp = AC_SRC_OVER;
+        blend.BlendFlags = 0;
+        blend.SourceConstantAlpha = 255;
+        blend.AlphaFormat = AC_SRC_ALPHA;
+        
+        for (int row = 0; row < 3; row++) {
+            if (rows.dstLength[row] <= 0) continue;
+            for (int col = 0; col < 3; col++) {
+                if (columns.dstLength[col] <= 0) continue;
+                // Glow tiles are hollow
+                if (row == 1 && col == 1 && tile.kind == ShadowCache::Kind::GLOW) continue;
+                
+                AlphaBlend(hdc,
+                    outer.left + columns.dstStart[col], outer.top + rows.dstStart[row],
+                    columns.dstLength[col], rows.dstLength[row],
+                    tileDC,
+                    columns.srcStart[col], rows.srcStart[row],
+                    columns.srcLength[col], rows.srcLength[row],
+                    blend);
+            }
+        }
+    }
 }
 
 void Renderer::DrawGradient(HDC hdc, const RECT& rect, const Gradient& gradient) {
@@ -32,41 +344,25 @@ void Renderer::DrawGradient(HDC hdc, const RECT& rect, const Gradient& gradient)
 }
 
 void Renderer::DrawVerticalGradient(HDC hdc, const RECT& rect, Color startColor, Color endColor) {
-    int height = rect.bottom - rect.top;
-    if (height <= 0) return;
+    if (rect.bottom - rect.top <= 0 || rect.right - rect.left <= 0) return;
     
-    for (int y = 0; y < height; y++) {
-        float t = (float)y / (float)height;
-        Color color = InterpolateColor(startColor, endColor, t);
-        
-        HPEN pen = CreatePen(PS_SOLID, 1, color.ToCOLORREF());
-        HPEN oldPen = (HPEN)SelectObject(hdc, pen);
-        
-        MoveToEx(hdc, rect.left, rect.top + y, nullptr);
-        LineTo(hdc, rect.right, rect.top + y);
-        
-        SelectObject(hdc, oldPen);
-        DeleteObject(pen);
-    }
+    TRIVERTEX vertices[2] = {
+        MakeVertex(rect.left, rect.top, startColor),
+        MakeVertex(rect.right, rect.bottom, endColor)
+    };
+    GRADIENT_RECT gradientRect = { 0, 1 };
+    GradientFill(hdc, vertices, 2, &gradientRect, 1, GRADIENT_FILL_RECT_V);
 }
 
 void Renderer::DrawHorizontalGradient(HDC hdc, const RECT& rect, Color startColor, Color endColor) {
-    int width = rect.right - rect.left;
-    if (width <= 0) return;
+    if (rect.bottom - rect.top <= 0 || rect.right - rect.left <= 0) return;
     
-    for (int x = 0; x < width; x++) {
-        float t = (float)x / (float)width;
-        Color color = InterpolateColor(startColor, endColor, t);
-        
-        HPEN pen = CreatePen(PS_SOLID, 1, color.ToCOLORREF());
-        HPEN oldPen = (HPEN)SelectObject(hdc, pen);
-        
-        MoveToEx(hdc, rect.left + x, rect.top, nullptr);
-        LineTo(hdc, rect.left + x, rect.bottom);
-        
-        SelectObject(hdc, oldPen);
-        DeleteObject(pen);
-    }
+    TRIVERTEX vertices[2] = {
+        MakeVertex(rect.left, rect.top, startColor),
+        MakeVertex(rect.right, rect.bottom, endColor)
+    };
+    GRADIENT_RECT gradientRect = { 0, 1 };
+    GradientFill(hdc, vertices, 2, &gradientRect, 1, GRADIENT_FILL_RECT_H);
 }
 
 void Renderer::DrawRadialGradient(HDC hdc, const RECT& rect, Color centerColor, Color edgeColor, int cx, int cy) {
@@ -79,113 +375,74 @@ void Renderer::DrawRadialGradient(HDC hdc, const RECT& rect, Color centerColor,
         cy = height / 2;
     }
     
-    // Maximum radius
-    float maxRadius = sqrt((float)(width * width + height * height)) / 2.0f;
-    
-    // Draw pixel by pixel
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            float dx = (float)(x - cx);
+    std::string key(1, 'R');
+    AppendKey(key, width);
+    AppendKey(key, height);
+    AppendKey(key, cx);
+    AppendKey(key, cy);
+    AppendKey(key, centerColor);
+    AppendKey(key, edgeColor);
+    
+    DrawBufferedGradient(hdc, rect, key, [&](uint32_t* pixels, int w, int h) {
+        // Maximum radius
+        float maxRadius = sqrt((float)(w * w + h * h)) / 2.0f;
+        
+        for (int y = 0; y < h; y++) {
             float dy = (float)(y - cy);
-            float distance = sqrt(dx * dx + dy * dy);
-            float t = std::min(distance / maxRadius, 1.0f);
-            
-            Color color = InterpolateColor(centerColor, edgeColor, t);
-            SetPixel(hdc, rect.left + x, rect.top + y, color.ToCOLORREF());
+            uint32_t* row = pixels + (size_t)y * w;
+            for (int x = 0; x < w; x++) {
+                float dx = (float)(x - cx);
+                float distance = sqrt(dx * dx + dy * dy);
+                float t = std::min(distance / maxRadius, 1.0f);
+                row[x] = ColorToPixel(InterpolateColor(centerColor, edgeColor, t));
+            }
         }
-    }
+    });
 }
 
 void Renderer::DrawRoundedRect(HDC hdc, const RECT& rect, int radius, Color fillColor, Color borderColor, int borderWidth) {
-    // Create rounded rectangle region
-    HRGN region = CreateRoundRectRgn(
-        rect.left, rect.top,
-        rect.right + 1, rect.bottom + 1,
-        radius * 2, radius * 2
-    );
-    
-    // Fill with color
-    HBRUSH brush = CreateSolidBrush(fillColor.ToCOLORREF());
-    FillRgn(hdc, region, brush);
-    DeleteObject(brush);
+    // Rounded rectangle region, brush and pen all come from the per-thread cache
+    HRGN region = GdiObjectCache::GetRoundRectRegion(rect, radius);
+    FillRgn(hdc, region, GdiObjectCache::GetBrush(fillColor.ToCOLORREF()));
     
     // Draw border if needed
     if (borderWidth > 0) {
-        HPEN pen = CreatePen(PS_SOLID, borderWidth, borderColor.ToCOLORREF());
-        HPEN oldPen = (HPEN)SelectObject(hdc, pen);
+        HPEN oldPen = (HPEN)SelectObject(hdc, GdiObjectCache::GetPen(borderColor.ToCOLORREF(), borderWidth));
         HBRUSH oldBrush = (HBRUSH)SelectObject(hdc, GetStockObject(NULL_BRUSH));
         
         RoundRect(hdc, rect.left, rect.top, rect.right, rect.bottom, radius * 2, radius * 2);
         
         SelectObject(hdc, oldPen);
         SelectObject(hdc, oldBrush);
-        DeleteObject(pen);
     }
-    
-    DeleteObject(region);
 }
 
-void Renderer::DrawShadow(HDC hdc, const RECT& rect, int offsetX, int offsetY, int blur, Color shadowColor) {
-    // Simple shadow using alpha-blended rectangles
+void Renderer::DrawShadow(HDC hdc, const RECT& rect, int offsetX, int offsetY, int blur, Color shadowColor, int cornerRadius) {
+    if (rect.right <= rect.left || rect.bottom <= rect.top) return;
+    
     RECT shadowRect = rect;
-    shadowRect.left += offsetX;
-    shadowRect.top += offsetY;
-    shadowRect.right += offsetX;
-    shadowRect.bottom += offsetY;
-    
-    // Draw multiple layers for blur effect
-    for (int i = blur; i > 0; i--) {
-        RECT blurRect = shadowRect;
-        blurRect.left -= i;
-        blurRect.top -= i;
-        blurRect.right += i;
-        blurRect.bottom += i;
-        
-        float alpha = (float)shadowColor.a / (float)blur * (float)i;
-        Color blurColor = shadowColor;
-        blurColor.a = (BYTE)alpha;
-        
-        // Draw shadow layer
-        HBRUSH brush = CreateSolidBrush(RGB(blurColor.r, blurColor.g, blurColor.b));
-        
-        // Use alpha blending
-        BLENDFUNCTION blend;
-        blend.BlendOp = AC_SRC_OVER;
-        blend.BlendFlags = 0;
-        blend.SourceConstantAlpha = blurColor.a;
-        blend.AlphaFormat = 0;
-        
-        FillRect(hdc, &blurRect, brush);
-        DeleteObject(brush);
-    }
+    OffsetRect(&shadowRect, offsetX, offsetY);
+    
+    auto tile = ShadowCache::GetShadow(blur, cornerRadius, shadowColor);
+    CompositeNineSlice(hdc, *tile, shadowRect);
 }
 
 void Renderer::DrawGlow(HDC hdc, const RECT& rect, int radius, Color glowColor) {
-    // Draw expanding glow layers
-    for (int i = 0; i < radius; i++) {
-        RECT glowRect = rect;
-        glowRect.left -= i;
-        glowRect.top -= i;
-        glowRect.right += i;
-        glowRect.bottom += i;
-        
-        float alpha = (float)glowColor.a * (1.0f - (float)i / (float)radius);
-        Color layerColor = glowColor;
-        layerColor.a = (BYTE)alpha;
-        
-        HPEN pen = CreatePen(PS_SOLID, 1, RGB(layerColor.r, layerColor.g, layerColor.b));
-        HPEN oldPen = (HPEN)SelectObject(hdc, pen);
-        HBRUSH oldBrush = (HBRUSH)SelectObject(hdc, GetStockObject(NULL_BRUSH));
-        
-        Rectangle(hdc, glowRect.left, glowRect.top, glowRect.right, glowRect.bottom);
-        
-        SelectObject(hdc, oldPen);
-        SelectObject(hdc, oldBrush);
-        DeleteObject(pen);
-    }
+    if (radius <= 0 || rect.right <= rect.left || rect.bottom <= rect.top) return;
+    
+    auto tile = ShadowCache::GetGlow(radius, glowColor);
+    CompositeNineSlice(hdc, *tile, rect);
 }
 
 void Renderer::DrawParticles(HDC hdc, const std::vector<Particle>& particles) {
+    FrameArena::Scope scratch;
+    ParticleBatch batch;
+    for (const auto& particle : particles) {
+        if (particle.life <= 0.0f) continue;
+        batch.Add(particle);
+    }
+    if (batch.Splat(hdc)) return;
+    
     for (const auto& particle : particles) {
         if (particle.life <= 0.0f) continue;
         
@@ -194,13 +451,11 @@ void Renderer::DrawParticles(HDC hdc, const std::vector<Particle>& particles) {
         int y = (int)particle.y;
         int size = 2;
         
-        HBRUSH brush = CreateSolidBrush(particle.color.ToCOLORREF());
-        HBRUSH oldBrush = (HBRUSH)SelectObject(hdc, brush);
+        HBRUSH oldBrush = (HBRUSH)SelectObject(hdc, GdiObjectCache::GetBrush(particle.color.ToCOLORREF()));
         
         Ellipse(hdc, x - size, y - size, x + size, y + size);
         
         SelectObject(hdc, oldBrush);
-        DeleteObject(brush);
     }
 }
 
@@ -250,10 +505,8 @@ void Renderer::DrawIcon(HDC hdc, IconType type, int x, int y, int size, Color co
     Color iconColor = color;
     iconColor.a = (BYTE)(iconColor.a * alpha);
     
-    HBRUSH brush = CreateSolidBrush(iconColor.ToCOLORREF());
-    HBRUSH oldBrush = (HBRUSH)SelectObject(hdc, brush);
-    HPEN pen = CreatePen(PS_SOLID, 2, iconColor.ToCOLORREF());
-    HPEN oldPen = (HPEN)SelectObject(hdc, pen);
+    HBRUSH oldBrush = (HBRUSH)SelectObject(hdc, GdiObjectCache::GetBrush(iconColor.ToCOLORREF()));
+    HPEN oldPen = (HPEN)SelectObject(hdc, GdiObjectCache::GetPen(iconColor.ToCOLORREF(), 2));
     
     switch (type) {
         case IconType::CIRCLE:
@@ -297,8 +550,6 @@ void Renderer::DrawIcon(HDC hdc, IconType type, int x, int y, int size, Color co
     
     SelectObject(hdc, oldBrush);
     SelectObject(hdc, oldPen);
-    DeleteObject(brush);
-    DeleteObject(pen);
 }
 
 Color Renderer::InterpolateColor(Color c1, Color c2, float t) {
@@ -316,7 +567,7 @@ BYTE Renderer::BlendAlpha(BYTE src, BYTE dst, BYTE alpha) {
     return (BYTE)(((int)src * alpha + (int)dst * (255 - alpha)) / 255);
 }
 
-HDC Renderer::CreateMemoryDC(int width, int height, HBITMAP* outBitmap) {
+HDC Renderer::CreateMemoryDC(int width, int height, HBITMAP* outBitmap, GdiSubsystem subsystem) {
     HDC screenDC = GetDC(nullptr);
     HDC memDC = CreateCompatibleDC(screenDC);
     
@@ -325,26 +576,259 @@ HDC Renderer::CreateMemoryDC(int width, int height, HBITMAP* outBitmap) {
     
     ReleaseDC(nullptr, screenDC);
     
+    GdiHandleCounter::Add(subsystem, (memDC ? 1 : 0) + (*outBitmap ? 1 : 0));
     return memDC;
 }
 
-void Renderer::DeleteMemoryDC(HDC hdc, HBITMAP bitmap) {
-    DeleteObject(bitmap);
-    DeleteDC(hdc);
+void Renderer::DeleteMemoryDC(HDC hdc, HBITMAP bitmap, GdiSubsystem subsystem) {
+    // Delete the DC first so the bitmap is no longer selected when it is freed
+    if (hdc) DeleteDC(hdc);
+    if (bitmap) DeleteObject(bitmap);
+    GdiHandleCounter::Remove(subsystem, (hdc ? 1 : 0) + (bitmap ? 1 : 0));
+}
+
+void Renderer::SetPixelAccessMode(PixelAccessMode mode) {
+    g_pixelAccessMode = mode;
+}
+
+Renderer::PixelAccessMode Renderer::GetPixelAccessMode() {
+    return g_pixelAccessMode;
+}
+
+HDC Renderer::CreateDIBMemoryDC(int width, int height, HBITMAP* outBitmap, uint32_t** outPixels,
+                                GdiSubsystem subsystem) {
+    *outBitmap = nullptr;
+    *outPixels = nullptr;
+    if (width <= 0 || height <= 0) return nullptr;
+    
+    BITMAPINFO bmi = {};
+    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bmi.bmiHeader.biWidth = width;
+    bmi.bmiHeader.biHeight = -height; // Top-down
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+    
+    HDC screenDC = GetDC(nullptr);
+    HDC memDC = CreateCompatibleDC(screenDC);
+    void* bits = nullptr;
+    HBITMAP bitmap = CreateDIBSection(screenDC, &bmi, DIB_RGB_COLORS, &bits, nullptr, 0);
+    ReleaseDC(nullptr, screenDC);
+    
+    if (!memDC || !bitmap || !bits) {
+        if (bitmap) DeleteObject(bitmap);
+        if (memDC) DeleteDC(memDC);
+        return nullptr;
+    }
+    
+    SelectObject(memDC, bitmap);
+    *outBitmap = bitmap;
+    *outPixels = static_cast<uint32_t*>(bits);
+    GdiHandleCounter::Add(subsystem, 2);
+    return memDC;
+}
+
+bool Renderer::BeginPixelAccess(HDC hdc, const RECT& rect, PixelSurface& surface) {
+    if (g_pixelAccessMode != PixelAccessMode::DIB_SECTION) return false;
+    
+    int width = rect.right - rect.left;
+    int height = rect.bottom - rect.top;
+    
+    surface.dc = CreateDIBMemoryDC(width, height, &surface.bitmap, &surface.pixels, GdiSubsystem::EFFECTS);
+    if (!surface.dc) {
+        surface = PixelSurface();
+        return false;
+    }
+    
+    surface.width = width;
+    surface.height = height;
+    
+    // One blit in, then make sure GDI has finished writing before the CPU reads
+    BitBlt(surface.dc, 0, 0, width, height, hdc, rect.left, rect.top, SRCCOPY);
+    GdiFlush();
+    return true;
+}
+
+void Renderer::EndPixelAccess(HDC hdc, const RECT& rect, PixelSurface& surface, bool writeBack) {
+    if (!surface.dc) return;
+    
+    if (writeBack) {
+        BitBlt(hdc, rect.left, rect.top, surface.width, surface.height, surface.dc, 0, 0, SRCCOPY);
+    }
+    
+    DeleteMemoryDC(surface.dc, surface.bitmap, GdiSubsystem::EFFECTS);
+    surface = PixelSurface();
 }
 
 // Multi-dimensional rendering implementations
 
+namespace {
+    // out = a * b, row-major
+    void MultiplyMatrix(const float* a, const float* b, float* out) {
+        for (int row = 0; row < 4; row++) {
+            for (int col = 0; col < 4; col++) {
+                out[row * 4 + col] = a[row * 4] * b[col] + a[row * 4 + 1] * b[4 + col] +
+                                     a[row * 4 + 2] * b[8 + col] + a[row * 4 + 3] * b[12 + col];
+            }
+        }
+    }
+    
+    // Projects a scene's vertices in one batch, placed by model when given
+    void ProjectScene(const CameraController* camera, const float* model, const Renderer::Vector3D* points,
+                      POINT* out, size_t count, int originX, int originY) {
+        const float* viewProjection = camera ? camera->GetViewProjectionMatrix() : DEFAULT_VIEW_PROJECTION;
+        float minW = camera ? camera->GetNearPlane() : MIN_PROJECTION_DISTANCE;
+        if (!model) {
+            Renderer::ProjectPoints(viewProjection, minW, points, out, count, originX, originY, 1.0f);
+            return;
+        }
+        float matrix[16];
+        MultiplyMatrix(viewProjection, model, matrix);
+        Renderer::ProjectPoints(matrix, minW, points, out, count, originX, originY, 1.0f);
+    }
+    
+    constexpr int EDGE_WIDTH = 2;
+    constexpr int SCENE_DOT_SIZE = 6;
+    constexpr size_t MAX_EDGES = 32;
+    
+    // Connected hypercube vertices differ in one bit of their index
+    const int HYPERCUBE_EDGES[32][2] = {
+        {0,1}, {2,3}, {4,5}, {6,7}, {8,9}, {10,11}, {12,13}, {14,15},
+        {0,2}, {1,3}, {4,6}, {5,7}, {8,10}, {9,11}, {12,14}, {13,15},
+        {0,4}, {1,5}, {2,6}, {3,7}, {8,12}, {9,13}, {10,14}, {11,15},
+        {0,8}, {1,9}, {2,10}, {3,11}, {4,12}, {5,13}, {6,14}, {7,15}
+    };
+    
+    // Edge list as two-point polylines for one PolyPolyline
+    struct EdgeBatch {
+        POINT points[MAX_EDGES * 2];
+        DWORD counts[MAX_EDGES];
+        size_t count;
+        
+        EdgeBatch(const POINT* vertices, const int (*edges)[2], size_t edgeCount) : count(edgeCount) {
+            for (size_t i = 0; i < edgeCount; i++) {
+                points[i * 2] = vertices[edges[i][0]];
+                points[i * 2 + 1] = vertices[edges[i][1]];
+                counts[i] = 2;
+            }
+        }
+    };
+    
+    // The 16 hypercube vertices, each projected once; false when too small
+    // for any of them to be treated as connected
+    bool ProjectHypercube(const Renderer::Vector4D& center, float size, float time, int originX, int originY,
+                          const CameraController* camera, POINT* projected) {
+        if (std::abs(size) <= 0.1f) return false;
+        float halfSize = size / 2.0f;
+        
+        // Index bits 0-3 pick the x, y, z and w sides
+        Renderer::Vector3D vertices[16];
+        for (int i = 0; i < 16; i++) {
+            Renderer::Vector4D vertex(
+                center.x + ((i & 1) ? halfSize : -halfSize),
+                center.y + ((i & 2) ? halfSize : -halfSize),
+                center.z + ((i & 4) ? halfSize : -halfSize),
+                center.w + ((i & 8) ? halfSize : -halfSize)
+            );
+            Renderer::Project4Dto3D(vertex, vertices[i], time);
+        }
+        ProjectScene(camera, nullptr, vertices, projected, 16, originX, originY);
+        return true;
+    }
+    
+    // Every path point projected once, not once per segment it ends
+    const std::vector<POINT>& ProjectPath(const std::vector<Renderer::Vector6D>& path, int originX, int originY,
+                                          const CameraController* camera) {
+        thread_local std::vector<Renderer::Vector3D> scene;
+        thread_local std::vector<POINT> projected;
+        scene.resize(path.size());
+        projected.resize(path.size());
+        for (size_t i = 0; i < path.size(); i++) {
+            Renderer::Vector5D p5d;
+            Renderer::Project6Dto5D(path[i], p5d);
+            Renderer::Vector4D p4d;
+            Renderer::Project5Dto4D(p5d, p4d, p5d.d);
+            Renderer::Project4Dto3D(p4d, scene[i], path[i].t);
+        }
+        ProjectScene(camera, nullptr, scene.data(), projected.data(), path.size(), originX, originY);
+        return projected;
+    }
+}
+
+void Renderer::DrawPolylines(HDC hdc, const POINT* points, const DWORD* counts, size_t polylineCount, Color color, int width) {
+    if (!points || !counts || polylineCount == 0) return;
+    
+    // Pens wider than a pixel have round caps and joins
+    HPEN oldPen = (HPEN)SelectObject(hdc, GdiObjectCache::GetPen(color.ToCOLORREF(), width));
+    PolyPolyline(hdc, points, counts, (DWORD)polylineCount);
+    SelectObject(hdc, oldPen);
+}
+
+// Scene buffers
+void Renderer::SceneBuffer::SetPoints(const std::vector<Vector5D>& points, const std::vector<Color>& colors) {
+    points_ = points;
+    batches_.clear();
+    
+    // Points without a color are white, as in Render5DScene
+    std::unordered_map<uint32_t, size_t> batchIndex;
+    for (size_t i = 0; i < points.size(); i++) {
+        Color color = (i < colors.size()) ? colors[i] : Color(255, 255, 255, 255);
+        uint32_t key = ((uint32_t)color.a << 24) | ((uint32_t)color.r << 16) | ((uint32_t)color.g << 8) | color.b;
+        auto it = batchIndex.find(key);
+        if (it == batchIndex.end()) {
+            it = batchIndex.emplace(key, batches_.size()).first;
+            batches_.push_back(ColorBatch());
+            batches_.back().color = color;
+        }
+        batches_[it->second].indices.push_back((uint32_t)i);
+    }
+}
+
+void Renderer::SceneBuffer::UpdatePoints(size_t first, const Vector5D* points, size_t count) {
+    if (first >= points_.size()) return;
+    count = std::min(count, points_.size() - first);
+    std::copy(points, points + count, points_.begin() + first);
+}
+
+void Renderer::SceneBuffer::Clear() {
+    points_.clear();
+    batches_.clear();
+}
+
+void Renderer::SceneBuffer::Project(float time, int originX, int originY, const CameraController* camera) {
+    // Down to 3D, then one projection batch for the whole scene
+    scene_.resize(points_.size());
+    projected_.resize(points_.size());
+    for (size_t i = 0; i < points_.size(); i++) {
+        Vector4D point4D;
+        Project5Dto4D(points_[i], point4D, points_[i].d);
+        Project4Dto3D(point4D, scene_[i], time);
+    }
+    ProjectScene(camera, nullptr, scene_.data(), projected_.data(), points_.size(), originX, originY);
+}
+
+size_t Renderer::SceneBuffer::BuildDots(const ColorBatch& batch) {
+    // A dot is a one-pixel stroke widened by the round-capped pen
+    size_t count = batch.indices.size();
+    dots_.resize(count * 2);
+    if (counts_.size() < count) counts_.resize(count, 2);
+    for (size_t i = 0; i < count; i++) {
+        const POINT& p = projected_[batch.indices[i]];
+        dots_[i * 2] = p;
+        dots_[i * 2 + 1].x = p.x + 1;
+        dots_[i * 2 + 1].y = p.y;
+    }
+    return count;
+}
+
 // 3D Rendering
 void Renderer::Render3DPoint(HDC hdc, const Vector3D& point, int originX, int originY, Color color, float scale) {
     int x2D, y2D;
     Project3Dto2D(point, x2D, y2D, originX, originY, scale);
     
-    HBRUSH brush = CreateSolidBrush(color.ToCOLORREF());
-    HBRUSH oldBrush = (HBRUSH)SelectObject(hdc, brush);
+    HBRUSH oldBrush = (HBRUSH)SelectObject(hdc, GdiObjectCache::GetBrush(color.ToCOLORREF()));
     Ellipse(hdc, x2D - 3, y2D - 3, x2D + 3, y2D + 3);
     SelectObject(hdc, oldBrush);
-    DeleteObject(brush);
 }
 
 void Renderer::Render3DLine(HDC hdc, const Vector3D& start, const Vector3D& end, int originX, int originY, Color color, float scale) {
@@ -352,81 +836,65 @@ void Renderer::Render3DLine(HDC hdc, const Vector3D& start, const Vector3D& end,
     Project3Dto2D(start, x1, y1, originX, originY, scale);
     Project3Dto2D(end, x2, y2, originX, originY, scale);
     
-    HPEN pen = CreatePen(PS_SOLID, 2, color.ToCOLORREF());
-    HPEN oldPen = (HPEN)SelectObject(hdc, pen);
+    HPEN oldPen = (HPEN)SelectObject(hdc, GdiObjectCache::GetPen(color.ToCOLORREF(), 2));
     
     MoveToEx(hdc, x1, y1, nullptr);
     LineTo(hdc, x2, y2);
     
     SelectObject(hdc, oldPen);
-    DeleteObject(pen);
 }
 
-void Renderer::Render3DCube(HDC hdc, const Vector3D& center, float size, int originX, int originY, Color color, float rotX, float rotY, float rotZ) {
+void Renderer::Render3DCube(HDC hdc, const Vector3D& center, float size, int originX, int originY, Color color, float rotX, float rotY, float rotZ,
+                            const CameraController* camera) {
     float halfSize = size / 2.0f;
     
     // Define cube vertices relative to origin
-    Vector3D vertices[8] = {
-        Vector3D(-halfSize, -halfSize, -halfSize),
-        Vector3D(halfSize, -halfSize, -halfSize),
-        Vector3D(halfSize, halfSize, -halfSize),
-        Vector3D(-halfSize, halfSize, -halfSize),
-        Vector3D(-halfSize, -halfSize, halfSize),
-        Vector3D(halfSize, -halfSize, halfSize),
-        Vector3D(halfSize, halfSize, halfSize),
-        Vector3D(-halfSize, halfSize, halfSize)
+    static const Vector3D corners[8] = {
+        Vector3D(-1, -1, -1), Vector3D(1, -1, -1), Vector3D(1, 1, -1), Vector3D(-1, 1, -1),
+        Vector3D(-1, -1, 1), Vector3D(1, -1, 1), Vector3D(1, 1, 1), Vector3D(-1, 1, 1)
     };
     
-    // Apply rotation matrices
-    for (int i = 0; i < 8; i++) {
-        Vector3D& v = vertices[i];
-        
-        // Rotation around X axis (use epsilon comparison to avoid unnecessary calculations)
-        if (std::abs(rotX) > 1e-6f) {
-            float cosX = cos(rotX);
-            float sinX = sin(rotX);
-            float y = v.y * cosX - v.z * sinX;
-            float z = v.y * sinX + v.z * cosX;
-            v.y = y;
-            v.z = z;
-        }
-        
-        // Rotation around Y axis
-        if (std::abs(rotY) > 1e-6f) {
-            float cosY = cos(rotY);
-            float sinY = sin(rotY);
-            float x = v.x * cosY + v.z * sinY;
-            float z = -v.x * sinY + v.z * cosY;
-            v.x = x;
-            v.z = z;
-        }
-        
-        // Rotation around Z axis
-        if (std::abs(rotZ) > 1e-6f) {
-            float cosZ = cos(rotZ);
-            float sinZ = sin(rotZ);
-            float x = v.x * cosZ - v.y * sinZ;
-            float y = v.x * sinZ + v.y * cosZ;
-            v.x = x;
-            v.y = y;
-        }
-        
-        // Translate to center position
-        v.x += center.x;
-        v.y += center.y;
-        v.z += center.z;
-    }
+    // Rotation about X, then Y, then Z, then the move to center, as one
+    // matrix; near-zero angles are skipped as before
+    float cosX = 1.0f, sinX = 0.0f, cosY = 1.0f, sinY = 0.0f, cosZ = 1.0f, sinZ = 0.0f;
+    if (std::abs(rotX) > 1e-6f) { cosX = std::cos(rotX); sinX = std::sin(rotX); }
+    if (std::abs(rotY) > 1e-6f) { cosY = std::cos(rotY); sinY = std::sin(rotY); }
+    if (std::abs(rotZ) > 1e-6f) { cosZ = std::cos(rotZ); sinZ = std::sin(rotZ); }
+    
+    const float rotationX[16] = {
+        halfSize, 0, 0, 0,
+        0, cosX * halfSize, -sinX * halfSize, 0,
+        0, sinX * halfSize, cosX * halfSize, 0,
+        0, 0, 0, 1
+    };
+    const float rotationY[16] = {
+        cosY, 0, sinY, 0,
+        0, 1, 0, 0,
+        -sinY, 0, cosY, 0,
+        0, 0, 0, 1
+    };
+    const float rotationZ[16] = {
+        cosZ, -sinZ, 0, center.x,
+        sinZ, cosZ, 0, center.y,
+        0, 0, 1, center.z,
+        0, 0, 0, 1
+    };
+    float rotationYX[16];
+    float model[16];
+    MultiplyMatrix(rotationY, rotationX, rotationYX);
+    MultiplyMatrix(rotationZ, rotationYX, model);
+    
+    POINT projected[8];
+    ProjectScene(camera, model, corners, projected, 8, originX, originY);
     
     // Draw cube edges
-    int edges[12][2] = {
+    static const int edges[12][2] = {
         {0,1}, {1,2}, {2,3}, {3,0},  // Back face
         {4,5}, {5,6}, {6,7}, {7,4},  // Front face
         {0,4}, {1,5}, {2,6}, {3,7}   // Connecting edges
     };
-    
-    for (int i = 0; i < 12; i++) {
-        Render3DLine(hdc, vertices[edges[i][0]], vertices[edges[i][1]], originX, originY, color);
-    }
+    EdgeBatch batch(projected, edges, 12);
+    DrawPolylines(hdc, batch.points, batch.counts, batch.count, color, EDGE_WIDTH);
 }
 
 // 4D Rendering
@@ -436,47 +904,22 @@ void Renderer::Render4DPoint(HDC hdc, const Vector4D& point, float time, int ori
     Render3DPoint(hdc, point3D, originX, originY, color, scale);
 }
 
-void Renderer::Render4DHypercube(HDC hdc, const Vector4D& center, float size, float time, int originX, int originY, Color color) {
-    float halfSize = size / 2.0f;
+void Renderer::Render4DHypercube(HDC hdc, const Vector4D& center, float size, float time, int originX, int originY, Color color,
+                                 const CameraController* camera) {
+    POINT projected[16];
+    if (!ProjectHypercube(center, size, time, originX, originY, camera, projected)) return;
     
-    // Define hypercube vertices in 4D (16 vertices)
-    Vector4D vertices[16];
-    int idx = 0;
-    for (int w = -1; w <= 1; w += 2) {
-        for (int z = -1; z <= 1; z += 2) {
-            for (int y = -1; y <= 1; y += 2) {
-                for (int x = -1; x <= 1; x += 2) {
-                    vertices[idx++] = Vector4D(
-                        center.x + x * halfSize,
-                        center.y + y * halfSize,
-                        center.z + z * halfSize,
-                        center.w + w * halfSize
-                    );
-                }
-            }
-        }
-    }
+    EdgeBatch batch(projected, HYPERCUBE_EDGES, 32);
+    DrawPolylines(hdc, batch.points, batch.counts, batch.count, color, EDGE_WIDTH);
+}
+
+void Renderer::Render4DHypercube(RenderBackend& backend, const Vector4D& center, float size, float time, int originX, int originY,
+                                 Color color, const CameraController* camera) {
+    POINT projected[16];
+    if (!ProjectHypercube(center, size, time, originX, originY, camera, projected)) return;
     
-    // Project to 3D and render edges (simplified)
-    for (int i = 0; i < 16; i++) {
-        Vector3D v1;
-        Project4Dto3D(vertices[i], v1, time);
-        
-        for (int j = i + 1; j < 16; j++) {
-            // Check if vertices are connected (differ in only one dimension)
-            int diffCount = 0;
-            if (std::abs(vertices[i].x - vertices[j].x) > 0.1f) diffCount++;
-            if (std::abs(vertices[i].y - vertices[j].y) > 0.1f) diffCount++;
-            if (std::abs(vertices[i].z - vertices[j].z) > 0.1f) diffCount++;
-            if (std::abs(vertices[i].w - vertices[j].w) > 0.1f) diffCount++;
-            
-            if (diffCount == 1) {
-                Vector3D v2;
-                Project4Dto3D(vertices[j], v2, time);
-                Render3DLine(hdc, v1, v2, originX, originY, color);
-            }
-        }
-    }
+    EdgeBatch batch(projected, HYPERCUBE_EDGES, 32);
+    backend.DrawPolylines(batch.points, batch.counts, batch.count, color, (float)EDGE_WIDTH);
 }
 
 // 5D Rendering
@@ -486,10 +929,34 @@ void Renderer::Render5DPoint(HDC hdc, const Vector5D& point, float time, int ori
     Render4DPoint(hdc, point4D, time, originX, originY, color, scale);
 }
 
-void Renderer::Render5DScene(HDC hdc, const std::vector<Vector5D>& points, float time, int originX, int originY, const std::vector<Color>& colors) {
-    for (size_t i = 0; i < points.size(); i++) {
-        Color color = (i < colors.size()) ? colors[i] : Color(255, 255, 255, 255);
-        Render5DPoint(hdc, points[i], time, originX, originY, color);
+void Renderer::Render5DScene(HDC hdc, const std::vector<Vector5D>& points, float time, int originX, int originY, const std::vector<Color>& colors,
+                             const CameraController* camera) {
+    if (points.empty()) return;
+    
+    thread_local SceneBuffer scene;
+    scene.SetPoints(points, colors);
+    Render5DScene(hdc, scene, time, originX, originY, camera);
+}
+
+void Renderer::Render5DScene(HDC hdc, SceneBuffer& scene, float time, int originX, int originY,
+                             const CameraController* camera) {
+    if (scene.points_.empty()) return;
+    
+    scene.Project(time, originX, originY, camera);
+    for (const auto& batch : scene.batches_) {
+        size_t count = scene.BuildDots(batch);
+        DrawPolylines(hdc, scene.dots_.data(), scene.counts_.data(), count, batch.color, SCENE_DOT_SIZE);
+    }
+}
+
+void Renderer::Render5DScene(RenderBackend& backend, SceneBuffer& scene, float time, int originX, int originY,
+                             const CameraController* camera) {
+    if (scene.points_.empty()) return;
+    
+    scene.Project(time, originX, originY, camera);
+    for (const auto& batch : scene.batches_) {
+        size_t count = scene.BuildDots(batch);
+        backend.DrawPolylines(scene.dots_.data(), scene.counts_.data(), count, batch.color, (float)SCENE_DOT_SIZE);
     }
 }
 
@@ -500,30 +967,28 @@ void Renderer::Render6DPoint(HDC hdc, const Vector6D& point, int originX, int or
     Render5DPoint(hdc, point5D, point.t, originX, originY, color, scale);
 }
 
-void Renderer::Render6DPath(HDC hdc, const std::vector<Vector6D>& path, int originX, int originY, Color color) {
+void Renderer::Render6DPath(HDC hdc, const std::vector<Vector6D>& path, int originX, int originY, Color color,
+                            const CameraController* camera) {
     if (path.size() < 2) return;
     
-    for (size_t i = 0; i < path.size() - 1; i++) {
-        Vector5D p1, p2;
-        Project6Dto5D(path[i], p1);
-        Project6Dto5D(path[i + 1], p2);
-        
-        Vector4D p4d1, p4d2;
-        Project5Dto4D(p1, p4d1, p1.d);
-        Project5Dto4D(p2, p4d2, p2.d);
-        
-        Vector3D p3d1, p3d2;
-        Project4Dto3D(p4d1, p3d1, path[i].t);
-        Project4Dto3D(p4d2, p3d2, path[i + 1].t);
-        
-        Render3DLine(hdc, p3d1, p3d2, originX, originY, color);
-    }
+    const std::vector<POINT>& projected = ProjectPath(path, originX, originY, camera);
+    DWORD count = (DWORD)projected.size();
+    DrawPolylines(hdc, projected.data(), &count, 1, color, EDGE_WIDTH);
+}
+
+void Renderer::Render6DPath(RenderBackend& backend, const std::vector<Vector6D>& path, int originX, int originY, Color color,
+                            const CameraController* camera) {
+    if (path.size() < 2) return;
+    
+    const std::vector<POINT>& projected = ProjectPath(path, originX, originY, camera);
+    DWORD count = (DWORD)projected.size();
+    backend.DrawPolylines(projected.data(), &count, 1, color, (float)EDGE_WIDTH);
 }
 
 // Projection helpers
 void Renderer::Project3Dto2D(const Vector3D& point3D, int& x2D, int& y2D, int originX, int originY, float scale) {
     // Simple perspective projection
-    float fov = 500.0f; // Field of view
+    float fov = PROJECTION_FOV;
     float distance = point3D.z + CAMERA_DISTANCE;
     
     if (distance < MIN_PROJECTION_DISTANCE) distance = MIN_PROJECTION_DISTANCE;
@@ -534,6 +999,88 @@ void Renderer::Project3Dto2D(const Vector3D& point3D, int& x2D, int& y2D, int or
     y2D = originY + (int)(point3D.y * perspectiveScale * scale);
 }
 
+#if SDK_PROJECT_X86
+namespace {
+    static_assert(sizeof(Renderer::Vector3D) == 3 * sizeof(float), "Vector3D must be packed");
+    
+    // Four packed points are three loads, deinterleaved to x, y and z lanes
+    inline void LoadPoints4(const float* in, __m128& x, __m128& y, __m128& z) {
+        __m128 a = _mm_loadu_ps(in);        // x0 y0 z0 x1
+        __m128 b = _mm_loadu_ps(in + 4);    // y1 z1 x2 y2
+        __m128 c = _mm_loadu_ps(in + 8);    // z2 x3 y3 z3
+        x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+        y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)),
+                           _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+        z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)),
+                           _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+    }
+    
+    // Row r of a row-major 4x4 matrix applied to four points
+    inline __m128 ApplyRow4(const float* r, __m128 x, __m128 y, __m128 z) {
+        return _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(r[0])), _mm_mul_ps(y, _mm_set1_ps(r[1]))),
+                          _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(r[2])), _mm_set1_ps(r[3])));
+    }
+}
+#endif
+
+void Renderer::TransformPoints(const float* m, const Vector3D* points, Vector3D* out, size_t count) {
+    size_t i = 0;
+#if SDK_PROJECT_X86
+    const float* in = reinterpret_cast<const float*>(points);
+    for (; i + 4 <= count; i += 4) {
+        __m128 x, y, z;
+        LoadPoints4(in + i * 3, x, y, z);
+        
+        float rows[3][4];
+        for (int row = 0; row < 3; row++) {
+            _mm_storeu_ps(rows[row], ApplyRow4(m + row * 4, x, y, z));
+        }
+        for (int k = 0; k < 4; k++) {
+            out[i + k] = Vector3D(rows[0][k], rows[1][k], rows[2][k]);
+        }
+    }
+#endif
+    for (; i < count; i++) {
+        const Vector3D& p = points[i];
+        out[i] = Vector3D(m[0] * p.x + m[1] * p.y + m[2] * p.z + m[3],
+                          m[4] * p.x + m[5] * p.y + m[6] * p.z + m[7],
+                          m[8] * p.x + m[9] * p.y + m[10] * p.z + m[11]);
+    }
+}
+
+void Renderer::ProjectPoints(const float* m, float minW, const Vector3D* points, POINT* out, size_t count,
+                             int originX, int originY, float scale) {
+    size_t i = 0;
+#if SDK_PROJECT_X86
+    const float* in = reinterpret_cast<const float*>(points);
+    for (; i + 4 <= count; i += 4) {
+        __m128 x, y, z;
+        LoadPoints4(in + i * 3, x, y, z);
+        
+        __m128 px = ApplyRow4(m, x, y, z);
+        __m128 py = ApplyRow4(m + 4, x, y, z);
+        __m128 pw = ApplyRow4(m + 12, x, y, z);
+        __m128 k = _mm_div_ps(_mm_set1_ps(scale), _mm_max_ps(pw, _mm_set1_ps(minW)));
+        
+        // Truncated like the scalar (int) casts
+        int32_t sx[4], sy[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(sx), _mm_cvttps_epi32(_mm_mul_ps(px, k)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(sy), _mm_cvttps_epi32(_mm_mul_ps(py, k)));
+        for (int j = 0; j < 4; j++) {
+            out[i + j].x = originX + sx[j];
+            out[i + j].y = originY + sy[j];
+        }
+    }
+#endif
+    for (; i < count; i++) {
+        const Vector3D& p = points[i];
+        float w = std::max(m[12] * p.x + m[13] * p.y + m[14] * p.z + m[15], minW);
+        float k = scale / w;
+        out[i].x = originX + (int)((m[0] * p.x + m[1] * p.y + m[2] * p.z + m[3]) * k);
+        out[i].y = originY + (int)((m[4] * p.x + m[5] * p.y + m[6] * p.z + m[7]) * k);
+    }
+}
+
 void Renderer::Project4Dto3D(const Vector4D& point4D, Vector3D& point3D, float time) {
     // Project 4D to 3D using time/w-dimension
     float wScale = std::cos(time + point4D.w * 0.1f) * 0.5f + 0.5f;
@@ -570,46 +1117,41 @@ void Renderer::DrawMultiStopGradient(HDC hdc, const RECT& rect, const std::vecto
     if (stops.size() < 2) return;
     
     int dimension = horizontal ? (rect.right - rect.left) : (rect.bottom - rect.top);
-    if (dimension <= 0) return;
-    
-    for (int i = 0; i < dimension; i++) {
-        float t = (float)i / (float)dimension;
-        
-        // Find the two stops to interpolate between
-        Color color;
-        if (t <= stops[0].position) {
-            color = stops[0].color;
-        } else if (t >= stops[stops.size() - 1].position) {
-            color = stops[stops.size() - 1].color;
-        } else {
-            // Find the surrounding stops
-            size_t idx1 = 0, idx2 = 0;
-            for (size_t j = 0; j < stops.size() - 1; j++) {
-                if (t >= stops[j].position && t <= stops[j + 1].position) {
-                    idx1 = j;
-                    idx2 = j + 1;
-                    break;
-                }
-            }
-            
-            // Interpolate between the two stops
-            float localT = (t - stops[idx1].position) / (stops[idx2].position - stops[idx1].position);
-            color = InterpolateColor(stops[idx1].color, stops[idx2].color, localT);
-        }
-        
-        HPEN pen = CreatePen(PS_SOLID, 1, color.ToCOLORREF());
-        HPEN oldPen = (HPEN)SelectObject(hdc, pen);
-        
+    if (dimension <= 0 || (horizontal ? rect.bottom <= rect.top : rect.right <= rect.left)) return;
+    
+    // One GradientFill call: a band per stop pair plus solid bands outside the first/last stop
+    FrameArena::Scope scratch;
+    FrameVector<TRIVERTEX> vertices(FrameArena::GetResource());
+    FrameVector<GRADIENT_RECT> bands(FrameArena::GetResource());
+    vertices.reserve((stops.size() + 1) * 2);
+    bands.reserve(stops.size() + 1);
+    
+    auto addBand = [&](int from, int to, const Color& startColor, const Color& endColor) {
+        if (to <= from) return;
+        ULONG index = (ULONG)vertices.size();
         if (horizontal) {
-            MoveToEx(hdc, rect.left + i, rect.top, nullptr);
-            LineTo(hdc, rect.left + i, rect.bottom);
+            vertices.push_back(MakeVertex(rect.left + from, rect.top, startColor));
+            vertices.push_back(MakeVertex(rect.left + to, rect.bottom, endColor));
         } else {
-            MoveToEx(hdc, rect.left, rect.top + i, nullptr);
-            LineTo(hdc, rect.right, rect.top + i);
+            vertices.push_back(MakeVertex(rect.left, rect.top + from, startColor));
+            vertices.push_back(MakeVertex(rect.right, rect.top + to, endColor));
         }
-        
-        SelectObject(hdc, oldPen);
-        DeleteObject(pen);
+        bands.push_back({ index, index + 1 });
+    };
+    
+    auto toPixel = [&](float position) {
+        return std::max(0, std::min(dimension, (int)std::lround(position * dimension)));
+    };
+    
+    addBand(0, toPixel(stops[0].position), stops[0].color, stops[0].color);
+    for (size_t i = 0; i + 1 < stops.size(); i++) {
+        addBand(toPixel(stops[i].position), toPixel(stops[i + 1].position), stops[i].color, stops[i + 1].color);
+    }
+    addBand(toPixel(stops.back().position), dimension, stops.back().color, stops.back().color);
+    
+    if (!bands.empty()) {
+        GradientFill(hdc, vertices.data(), (ULONG)vertices.size(), bands.data(), (ULONG)bands.size(),
+                     horizontal ? GRADIENT_FILL_RECT_H : GRADIENT_FILL_RECT_V);
     }
 }
 
@@ -624,54 +1166,105 @@ void Renderer::DrawConicalGradient(HDC hdc, const RECT& rect, const std::vector<
         cy = height / 2;
     }
     
-    const float PI = 3.14159265358979323846f;
+    std::string key(1, 'C');
+    AppendKey(key, width);
+    AppendKey(key, height);
+    AppendKey(key, cx);
+    AppendKey(key, cy);
+    AppendKey(key, startAngle);
+    for (const auto& stop : stops) {
+        AppendKey(key, stop.position);
+        AppendKey(key, stop.color);
+    }
     
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            float dx = (float)(x - cx);
+    DrawBufferedGradient(hdc, rect, key, [&](uint32_t* pixels, int w, int h) {
+        const float PI = 3.14159265358979323846f;
+        
+        for (int y = 0; y < h; y++) {
             float dy = (float)(y - cy);
-            float angle = std::atan2(dy, dx) + PI + startAngle;  // 0 to 2*PI
-            
-            // Normalize angle to 0-1
-            float t = std::fmod(angle / (2.0f * PI), 1.0f);
-            if (t < 0) t += 1.0f;
-            
-            // Find color at this angle
-            Color color;
-            if (t <= stops[0].position) {
-                color = stops[0].color;
-            } else if (t >= stops[stops.size() - 1].position) {
-                color = stops[stops.size() - 1].color;
-            } else {
-                size_t idx1 = 0, idx2 = 0;
-                for (size_t j = 0; j < stops.size() - 1; j++) {
-                    if (t >= stops[j].position && t <= stops[j + 1].position) {
-                        idx1 = j;
-                        idx2 = j + 1;
-                        break;
-                    }
-                }
+            uint32_t* row = pixels + (size_t)y * w;
+            for (int x = 0; x < w; x++) {
+                float dx = (float)(x - cx);
+                float angle = std::atan2(dy, dx) + PI + startAngle;  // 0 to 2*PI
+                
+                // Normalize angle to 0-1
+                float t = std::fmod(angle / (2.0f * PI), 1.0f);
+                if (t < 0) t += 1.0f;
                 
-                float localT = (t - stops[idx1].position) / (stops[idx2].position - stops[idx1].position);
-                color = InterpolateColor(stops[idx1].color, stops[idx2].color, localT);
+                row[x] = ColorToPixel(SampleStops(stops, t));
             }
-            
-            SetPixel(hdc, rect.left + x, rect.top + y, color.ToCOLORREF());
         }
+    });
+}
+
+void Renderer::SetGradientCacheEnabled(bool enabled) {
+    std::lock_guard<std::mutex> lock(g_gradientCacheMutex);
+    g_gradientCacheEnabled = enabled;
+    if (!enabled) {
+        g_gradientCache.clear();
+    }
+}
+
+bool Renderer::IsGradientCacheEnabled() {
+    std::lock_guard<std::mutex> lock(g_gradientCacheMutex);
+    return g_gradientCacheEnabled;
+}
+
+void Renderer::SetGradientCacheCapacity(size_t maxEntries) {
+    std::lock_guard<std::mutex> lock(g_gradientCacheMutex);
+    g_gradientCacheCapacity = maxEntries;
+    while (g_gradientCache.size() > g_gradientCacheCapacity) {
+        auto oldest = g_gradientCache.begin();
+        for (auto it = g_gradientCache.begin(); it != g_gradientCache.end(); ++it) {
+            if (it->second.lastUse < oldest->second.lastUse) oldest = it;
+        }
+        g_gradientCache.erase(oldest);
     }
 }
 
+void Renderer::ClearGradientCache() {
+    std::lock_guard<std::mutex> lock(g_gradientCacheMutex);
+    g_gradientCache.clear();
+}
+
+size_t Renderer::GetGradientCacheSize() {
+    std::lock_guard<std::mutex> lock(g_gradientCacheMutex);
+    return g_gradientCache.size();
+}
+
+size_t Renderer::ExportSharedGradients(SharedAssetCache& cache) {
+    std::lock_guard<std::mutex> lock(g_gradientCacheMutex);
+    size_t exported = 0;
+    for (const auto& pair : g_gradientCache) {
+        const CachedGradient& entry = pair.second;
+        if (cache.Add(SHARED_GRADIENT_PREFIX + pair.first, entry.data,
+                      (size_t)entry.width * entry.height * sizeof(uint32_t))) {
+            exported++;
+        }
+    }
+    return exported;
+}
+
 // ==================== ADVANCED VISUAL EFFECTS ====================
 
 void Renderer::ApplyBlur(HDC hdc, const RECT& rect, int blurRadius) {
+    SDK_PROFILE_ZONE("Renderer::ApplyBlur");
     int width = rect.right - rect.left;
     int height = rect.bottom - rect.top;
     
     if (width <= 0 || height <= 0 || blurRadius <= 0) return;
     
-    // Simple box blur implementation
-    std::vector<COLORREF> pixels(width * height);
-    std::vector<COLORREF> tempPixels(width * height);
+    PixelSurface surface;
+    if (BeginPixelAccess(hdc, rect, surface)) {
+        PixelKernels::BoxBlur(surface.pixels, width, height, width, blurRadius);
+        EndPixelAccess(hdc, rect, surface);
+        return;
+    }
+    
+    // Fallback: simple box blur through per-pixel GDI access
+    FrameArena::Scope scratch;
+    FrameVector<COLORREF> pixels((size_t)width * height, FrameArena::GetResource());
+    FrameVector<COLORREF> tempPixels((size_t)width * height, FrameArena::GetResource());
     
     // Read pixels
     for (int y = 0; y < height; y++) {
@@ -722,14 +1315,23 @@ void Renderer::ApplyBlur(HDC hdc, const RECT& rect, int blurRadius) {
 }
 
 void Renderer::ApplyBloom(HDC hdc, const RECT& rect, float threshold, float intensity) {
+    SDK_PROFILE_ZONE("Renderer::ApplyBloom");
     int width = rect.right - rect.left;
     int height = rect.bottom - rect.top;
     
     if (width <= 0 || height <= 0) return;
     
-    std::vector<COLORREF> pixels(width * height);
+    PixelSurface surface;
+    if (BeginPixelAccess(hdc, rect, surface)) {
+        PixelKernels::Bloom(surface.pixels, width, height, width, threshold, intensity);
+        EndPixelAccess(hdc, rect, surface);
+        return;
+    }
+    
+    FrameArena::Scope scratch;
+    FrameVector<COLORREF> pixels((size_t)width * height, FrameArena::GetResource());
     
-    // Read pixels and extract bright areas
+    // Fallback: read pixels and extract bright areas
     for (int y = 0; y < height; y++) {
         for (int x = 0; x < width; x++) {
             COLORREF pixel = GetPixel(hdc, rect.left + x, rect.top + y);
@@ -784,11 +1386,20 @@ void Renderer::ApplyBloom(HDC hdc, const RECT& rect, float threshold, float inte
 }
 
 void Renderer::ApplyColorCorrection(HDC hdc, const RECT& rect, float brightness, float contrast, float saturation) {
+    SDK_PROFILE_ZONE("Renderer::ApplyColorCorrection");
     int width = rect.right - rect.left;
     int height = rect.bottom - rect.top;
     
     if (width <= 0 || height <= 0) return;
     
+    PixelSurface surface;
+    if (BeginPixelAccess(hdc, rect, surface)) {
+        ColorCorrectPixels(surface.pixels, (size_t)width * height, brightness, contrast, saturation);
+        EndPixelAccess(hdc, rect, surface);
+        return;
+    }
+    
+    // Fallback: per-pixel GDI access
     for (int y = 0; y < height; y++) {
         for (int x = 0; x < width; x++) {
             COLORREF pixel = GetPixel(hdc, rect.left + x, rect.top + y);
@@ -823,6 +1434,7 @@ void Renderer::ApplyColorCorrection(HDC hdc, const RECT& rect, float brightness,
 }
 
 void Renderer::ApplyNoiseOverlay(HDC hdc, const RECT& rect, float intensity, int seed) {
+    SDK_PROFILE_ZONE("Renderer::ApplyNoiseOverlay");
     int width = rect.right - rect.left;
     int height = rect.bottom - rect.top;
     
@@ -830,6 +1442,14 @@ void Renderer::ApplyNoiseOverlay(HDC hdc, const RECT& rect, float intensity, int
     
     srand(seed);
     
+    PixelSurface surface;
+    if (BeginPixelAccess(hdc, rect, surface)) {
+        NoisePixels(surface.pixels, (size_t)width * height, intensity);
+        EndPixelAccess(hdc, rect, surface);
+        return;
+    }
+    
+    // Fallback: per-pixel GDI access
     for (int y = 0; y < height; y++) {
         for (int x = 0; x < width; x++) {
             COLORREF pixel = GetPixel(hdc, rect.left + x, rect.top + y);
@@ -848,7 +1468,12 @@ void Renderer::ApplyNoiseOverlay(HDC hdc, const RECT& rect, float intensity, int
 
 // ==================== PARTICLE POOL IMPLEMENTATION ====================
 
-Renderer::ParticlePool::ParticlePool(size_t initialSize) : activeCount_(0) {
+Renderer::ParticlePool::ParticlePool(size_t initialSize)
+    : activeCount_(0)
+    , initialSize_(initialSize)
+    , memorySource_("ParticlePool",
+        [this]() { return GetMemoryBytes(); },
+        [this](size_t) { Shrink(); }) {
     particles_.resize(initialSize);
     available_.reserve(initialSize);
     
@@ -906,7 +1531,30 @@ size_t Renderer::ParticlePool::GetTotalCount() const {
     return particles_.size();
 }
 
+size_t Renderer::ParticlePool::GetMemoryBytes() const {
+    return particles_.capacity() * sizeof(Particle) + available_.capacity() * sizeof(Particle*);
+}
+
+void Renderer::ParticlePool::Shrink() {
+    // Growing moved the particles, so nothing may be holding one
+    if (activeCount_ > 0 || particles_.size() <= initialSize_) return;
+
+    particles_.resize(initialSize_);
+    particles_.shrink_to_fit();
+    available_.clear();
+    available_.shrink_to_fit();
+    ReleaseAll();
+}
+
 void Renderer::DrawParticlesFromPool(HDC hdc, ParticlePool& pool) {
+    FrameArena::Scope scratch;
+    ParticleBatch batch;
+    for (auto& particle : pool.particles_) {
+        if (!particle.active || particle.life <= 0.0f) continue;
+        batch.Add(particle);
+    }
+    if (batch.Splat(hdc)) return;
+    
     for (auto& particle : pool.particles_) {
         if (!particle.active || particle.life <= 0.0f) continue;
         
@@ -914,13 +1562,11 @@ void Renderer::DrawParticlesFromPool(HDC hdc, ParticlePool& pool) {
         int y = (int)particle.y;
         int size = 2;
         
-        HBRUSH brush = CreateSolidBrush(particle.color.ToCOLORREF());
-        HBRUSH oldBrush = (HBRUSH)SelectObject(hdc, brush);
+        HBRUSH oldBrush = (HBRUSH)SelectObject(hdc, GdiObjectCache::GetBrush(particle.color.ToCOLORREF()));
         
         Ellipse(hdc, x - size, y - size, x + size, y + size);
         
         SelectObject(hdc, oldBrush);
-        DeleteObject(brush);
     }
 }
 
@@ -940,135 +1586,43 @@ void Renderer::UpdateParticlesInPool(ParticlePool& pool, float deltaTime) {
 }
 
 void Renderer::UpdateParticlesInPoolMultiThreaded(ParticlePool& pool, float deltaTime, int numThreads) {
-    // Determine number of threads to use
-    if (numThreads <= 0) {
-        numThreads = std::thread::hardware_concurrency();
-        if (numThreads <= 0) numThreads = 4;  // Default fallback
-    }
-    
     size_t totalParticles = pool.particles_.size();
     if (totalParticles == 0) return;
     
-    // Calculate particles per thread
-    size_t particlesPerThread = totalParticles / numThreads;
-    if (particlesPerThread == 0) {
-        // Too few particles, just use single-threaded version
-        UpdateParticlesInPool(pool, deltaTime);
-        return;
-    }
+    // numThreads caps how many chunks the update is split into
+    size_t chunkCount = numThreads > 0 ? (size_t)numThreads : (size_t)JobScheduler::GetWorkerCount() + 1;
+    size_t chunkSize = std::max(PARTICLE_CHUNK_SIZE, (totalParticles + chunkCount - 1) / chunkCount);
+    chunkCount = (totalParticles + chunkSize - 1) / chunkSize;
     
-    std::vector<std::thread> threads;
-    std::mutex releaseMutex;  // Protect Release() calls
+    // Chunks only touch their own particles; expired ones are released
+    // afterwards in index order, so the pool needs no lock
+    std::vector<std::vector<Particle*>> expired(chunkCount);
     
-    // Lambda function to update a range of particles
-    auto updateRange = [&](size_t start, size_t end) {
-        for (size_t i = start; i < end && i < totalParticles; ++i) {
+    JobScheduler::ParallelFor((int)totalParticles, (int)chunkSize, [&](int begin, int end) {
+        std::vector<Particle*>& finished = expired[(size_t)begin / chunkSize];
+        for (int i = begin; i < end; ++i) {
             Particle& particle = pool.particles_[i];
             if (!particle.active) continue;
             
-            // Update particle physics
             particle.x += particle.vx * deltaTime;
             particle.y += particle.vy * deltaTime;
             particle.life -= deltaTime;
             particle.vy += 50.0f * deltaTime;  // Gravity
             
-            // Check if particle should be released
             if (particle.life <= 0.0f) {
-                // Lock when calling Release to avoid race conditions
-                std::lock_guard<std::mutex> lock(releaseMutex);
-                pool.Release(&particle);
+                finished.push_back(&particle);
             }
         }
-    };
-    
-    // Create threads
-    for (int i = 0; i < numThreads; ++i) {
-        size_t start = i * particlesPerThread;
-        size_t end = (i == numThreads - 1) ? totalParticles : (i + 1) * particlesPerThread;
-        threads.emplace_back(updateRange, start, end);
-    }
+    }, "Particles");
     
-    // Wait for all threads to complete
-    for (auto& thread : threads) {
-        if (thread.joinable()) {
-            thread.join();
+    for (const auto& finished : expired) {
+        for (Particle* particle : finished) {
+            pool.Release(particle);
         }
     }
 }
 
 
-// ==================== TEXTURE ATLAS IMPLEMENTATION ====================
-
-Renderer::TextureAtlas::TextureAtlas(int width, int height) 
-    : atlasWidth_(width), atlasHeight_(height), currentX_(0), currentY_(0), rowHeight_(0) {
-}
-
-Renderer::TextureAtlas::~TextureAtlas() {
-    Clear();
-}
-
-bool Renderer::TextureAtlas::AddTexture(const std::string& name, HBITMAP bitmap, int width, int height) {
-    // Check if we need to move to next row
-    if (currentX_ + width > atlasWidth_) {
-        currentX_ = 0;
-        currentY_ += rowHeight_;
-        rowHeight_ = 0;
-    }
-    
-    // Check if we have space
-    if (currentY_ + height > atlasHeight_) {
-        return false;  // Atlas is full
-    }
-    
-    AtlasEntry entry;
-    entry.x = currentX_;
-    entry.y = currentY_;
-    entry.width = width;
-    entry.height = height;
-    entry.bitmap = bitmap;
-    
-    textures_[name] = entry;
-    
-    currentX_ += width;
-    rowHeight_ = std::max(rowHeight_, height);
-    
-    return true;
-}
-
-const Renderer::TextureAtlas::AtlasEntry* Renderer::TextureAtlas::GetTexture(const std::string& name) const {
-    auto it = textures_.find(name);
-    if (it != textures_.end()) {
-        return &it->second;
-    }
-    return nullptr;
-}
-
-bool Renderer::TextureAtlas::RemoveTexture(const std::string& name) {
-    auto it = textures_.find(name);
-    if (it != textures_.end()) {
-        // Delete the bitmap handle
-        if (it->second.bitmap) {
-            DeleteObject(it->second.bitmap);
-        }
-        textures_.erase(it);
-        return true;
-    }
-    return false;
-}
-
-void Renderer::TextureAtlas::Clear() {
-    // Delete all bitmap handles before clearing the map
-    for (auto& pair : textures_) {
-        if (pair.second.bitmap) {
-            DeleteObject(pair.second.bitmap);
-        }
-    }
-    textures_.clear();
-    currentX_ = 0;
-    currentY_ = 0;
-    rowHeight_ = 0;
-}
-
 // ==================== ANIMATION SYSTEM ====================
 
 void Renderer::Animation::AddKeyframe(float time, float value, EasingType easing) {
@@ -1076,11 +1630,11 @@ void Renderer::Animation::AddKeyframe(float time, float value, EasingType easing
     kf.time = time;
     kf.value = value;
     kf.easing = easing;
-    keyframes_.push_back(kf);
     
-    // Keep keyframes sorted by time
-    std::sort(keyframes_.begin(), keyframes_.end(), 
-        [](const Keyframe& a, const Keyframe& b) { return a.time < b.time; });
+    // Keep keyframes sorted by time, after any at the same time
+    auto it = std::upper_bound(keyframes_.begin(), keyframes_.end(), time,
+        [](float t, const Keyframe& k) { return t < k.time; });
+    keyframes_.insert(it, kf);
 }
 
 void Renderer::Animation::Update(float deltaTime) {
@@ -1111,119 +1665,106 @@ float Renderer::Animation::GetValue() const {
         return keyframes_[keyframes_.size() - 1].value;
     }
     
-    for (size_t i = 0; i < keyframes_.size() - 1; i++) {
-        if (currentTime_ >= keyframes_[i].time && currentTime_ <= keyframes_[i + 1].time) {
-            float t = (currentTime_ - keyframes_[i].time) / (keyframes_[i + 1].time - keyframes_[i].time);
-            t = ApplyEasing(t, keyframes_[i].easing);
-            return keyframes_[i].value + (keyframes_[i + 1].value - keyframes_[i].value) * t;
-        }
-    }
-    
-    return keyframes_[keyframes_.size() - 1].value;
+    // Binary search for the first keyframe after the current time
+    auto next = std::upper_bound(keyframes_.begin(), keyframes_.end(), currentTime_,
+        [](float t, const Keyframe& k) { return t < k.time; });
+    auto prev = next - 1;
+    float t = (currentTime_ - prev->time) / (next->time - prev->time);
+    t = ApplyEasing(t, prev->easing);
+    return prev->value + (next->value - prev->value) * t;
 }
 
 float Renderer::ApplyEasing(float t, EasingType type) {
-    const float PI = 3.14159265358979323846f;
-    
-    switch (type) {
-        case EasingType::LINEAR:
-            return t;
-            
-        case EasingType::EASE_IN_QUAD:
-            return t * t;
-            
-        case EasingType::EASE_OUT_QUAD:
-            return t * (2.0f - t);
-            
-        case EasingType::EASE_IN_OUT_QUAD:
-            return t < 0.5f ? 2.0f * t * t : -1.0f + (4.0f - 2.0f * t) * t;
-            
-        case EasingType::EASE_IN_CUBIC:
-            return t * t * t;
-            
-        case EasingType::EASE_OUT_CUBIC:
-            return (--t) * t * t + 1.0f;
-            
-        case EasingType::EASE_IN_OUT_CUBIC:
-            return t < 0.5f ? 4.0f * t * t * t : (t - 1.0f) * (2.0f * t - 2.0f) * (2.0f * t - 2.0f) + 1.0f;
-            
-        case EasingType::EASE_IN_QUART:
-            return t * t * t * t;
-            
-        case EasingType::EASE_OUT_QUART:
-            return 1.0f - (--t) * t * t * t;
-            
-        case EasingType::EASE_IN_OUT_QUART:
-            return t < 0.5f ? 8.0f * t * t * t * t : 1.0f - 8.0f * (--t) * t * t * t;
-            
-        case EasingType::EASE_IN_ELASTIC: {
-            if (t == 0.0f || t == 1.0f) return t;
-            float p = 0.3f;
-            return -std::pow(2.0f, 10.0f * (t - 1.0f)) * std::sin((t - 1.1f) * 2.0f * PI / p);
-        }
-            
-        case EasingType::EASE_OUT_ELASTIC: {
-            if (t == 0.0f || t == 1.0f) return t;
-            float p = 0.3f;
-            return std::pow(2.0f, -10.0f * t) * std::sin((t - 0.1f) * 2.0f * PI / p) + 1.0f;
-        }
-            
-        case EasingType::EASE_IN_OUT_ELASTIC: {
-            if (t == 0.0f || t == 1.0f) return t;
-            float p = 0.45f;
-            t *= 2.0f;
-            if (t < 1.0f) {
-                return -0.5f * std::pow(2.0f, 10.0f * (t - 1.0f)) * std::sin((t - 1.1f) * 2.0f * PI / p);
-            }
-            return std::pow(2.0f, -10.0f * (t - 1.0f)) * std::sin((t - 1.1f) * 2.0f * PI / p) * 0.5f + 1.0f;
-        }
-            
-        case EasingType::EASE_IN_BOUNCE:
-            return 1.0f - ApplyEasing(1.0f - t, EasingType::EASE_OUT_BOUNCE);
-            
-        case EasingType::EASE_OUT_BOUNCE: {
-            if (t < (1.0f / 2.75f)) {
-                return 7.5625f * t * t;
-            } else if (t < (2.0f / 2.75f)) {
-                t -= (1.5f / 2.75f);
-                return 7.5625f * t * t + 0.75f;
-            } else if (t < (2.5f / 2.75f)) {
-                t -= (2.25f / 2.75f);
-                return 7.5625f * t * t + 0.9375f;
-            } else {
-                t -= (2.625f / 2.75f);
-                return 7.5625f * t * t + 0.984375f;
-            }
-        }
-            
-        case EasingType::EASE_IN_OUT_BOUNCE:
-            return t < 0.5f 
-                ? ApplyEasing(t * 2.0f, EasingType::EASE_IN_BOUNCE) * 0.5f
-                : ApplyEasing(t * 2.0f - 1.0f, EasingType::EASE_OUT_BOUNCE) * 0.5f + 0.5f;
-            
-        default:
-            return t;
-    }
+    return AnimationTimeline::Ease(t, type);
 }
 
 // ==================== RENDER CACHE IMPLEMENTATION ====================
 
 Renderer::RenderCache::RenderCache(int width, int height) 
-    : width_(width), height_(height) {
-    cacheDC_ = CreateMemoryDC(width, height, &cacheBitmap_);
+    : width_(width), height_(height)
+    , memorySource_("RenderCache", [this]() { return (size_t)width_ * height_ * 4; }) {
+    cacheDC_ = CreateMemoryDC(width, height, &cacheBitmap_, GdiSubsystem::BACK_BUFFERS);
 }
 
 Renderer::RenderCache::~RenderCache() {
-    DeleteMemoryDC(cacheDC_, cacheBitmap_);
+    DeleteMemoryDC(cacheDC_, cacheBitmap_, GdiSubsystem::BACK_BUFFERS);
 }
 
 void Renderer::RenderCache::MarkDirty(const RECT& rect) {
+    // Clip to the cache surface; empty rects are dropped
+    RECT clipped = {
+        std::max(rect.left, (LONG)0),
+        std::max(rect.top, (LONG)0),
+        std::min(rect.right, (LONG)width_),
+        std::min(rect.bottom, (LONG)height_)
+    };
+    if (clipped.right <= clipped.left || clipped.bottom <= clipped.top) return;
+    
     DirtyRect dr;
-    dr.rect = rect;
+    dr.rect = clipped;
     dr.dirty = true;
     dirtyRegions_.push_back(dr);
 }
 
+void Renderer::RenderCache::MarkAllDirty() {
+    dirtyRegions_.clear();
+    RECT all = { 0, 0, width_, height_ };
+    MarkDirty(all);
+}
+
+void Renderer::RenderCache::MergeDirtyRegions(int mergeDistance, size_t maxRegions) {
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (size_t i = 0; i < dirtyRegions_.size() && !merged; i++) {
+            for (size_t j = i + 1; j < dirtyRegions_.size(); j++) {
+                RECT& a = dirtyRegions_[i].rect;
+                const RECT& b = dirtyRegions_[j].rect;
+                bool nearby = b.left <= a.right + mergeDistance && a.left <= b.right + mergeDistance &&
+                              b.top <= a.bottom + mergeDistance && a.top <= b.bottom + mergeDistance;
+                if (nearby) {
+                    a.left = std::min(a.left, b.left);
+                    a.top = std::min(a.top, b.top);
+                    a.right = std::max(a.right, b.right);
+                    a.bottom = std::max(a.bottom, b.bottom);
+                    dirtyRegions_.erase(dirtyRegions_.begin() + j);
+                    merged = true;
+                    break;
+                }
+            }
+        }
+    }
+    
+    if (dirtyRegions_.size() > maxRegions) {
+        RECT bounds;
+        GetDirtyBounds(bounds);
+        dirtyRegions_.clear();
+        MarkDirty(bounds);
+    }
+}
+
+bool Renderer::RenderCache::GetDirtyBounds(RECT& bounds) const {
+    if (dirtyRegions_.empty()) return false;
+    
+    bounds = dirtyRegions_[0].rect;
+    for (const auto& dr : dirtyRegions_) {
+        bounds.left = std::min(bounds.left, dr.rect.left);
+        bounds.top = std::min(bounds.top, dr.rect.top);
+        bounds.right = std::max(bounds.right, dr.rect.right);
+        bounds.bottom = std::max(bounds.bottom, dr.rect.bottom);
+    }
+    return true;
+}
+
+long long Renderer::RenderCache::GetDirtyPixelCount() const {
+    // Regions are disjoint once merged, so a plain sum is exact
+    long long pixels = 0;
+    for (const auto& dr : dirtyRegions_) {
+        pixels += (long long)(dr.rect.right - dr.rect.left) * (dr.rect.bottom - dr.rect.top);
+    }
+    return pixels;
+}
+
 void Renderer::RenderCache::MarkClean() {
     dirtyRegions_.clear();
 }
@@ -1248,13 +1789,41 @@ void Renderer::RenderCache::CopyToTarget(HDC targetDC, const RECT& srcRect, int
 // ==================== OCCLUSION CULLING ====================
 
 bool Renderer::IsRectOccluded(const RECT& rect, const std::vector<RECT>& occluders) {
-    // Simple check: if rect is completely covered by any occluder
+    // Fast path: one occluder covers the whole rect
     for (const auto& occluder : occluders) {
         if (rect.left >= occluder.left && rect.right <= occluder.right &&
             rect.top >= occluder.top && rect.bottom <= occluder.bottom) {
             return true;
         }
     }
+    if (occluders.size() < 2 || rect.right <= rect.left || rect.bottom <= rect.top) return false;
+    
+    // Covered by the union: cut each occluder out of what is left of the rect
+    // (at most four pieces per cut) until nothing remains
+    thread_local std::vector<RECT> remaining;
+    thread_local std::vector<RECT> next;
+    remaining.assign(1, rect);
+    for (const auto& occluder : occluders) {
+        next.clear();
+        for (const auto& piece : remaining) {
+            if (piece.left >= occluder.right || occluder.left >= piece.right ||
+                piece.top >= occluder.bottom || occluder.top >= piece.bottom) {
+                next.push_back(piece);
+                continue;
+            }
+            
+            LONG top = std::max(piece.top, occluder.top);
+            LONG bottom = std::min(piece.bottom, occluder.bottom);
+            if (piece.top < occluder.top) next.push_back({ piece.left, piece.top, piece.right, occluder.top });
+            if (piece.bottom > occluder.bottom) next.push_back({ piece.left, occluder.bottom, piece.right, piece.bottom });
+            if (piece.left < occluder.left) next.push_back({ piece.left, top, occluder.left, bottom });
+            if (piece.right > occluder.right) next.push_back({ occluder.right, top, piece.right, bottom });
+        }
+        
+        if (next.empty()) return true;
+        if (next.size() > MAX_OCCLUSION_PIECES) return false;   // Too fragmented to be worth proving
+        remaining.swap(next);
+    }
     return false;
 }
 
@@ -1,4 +1,5 @@
 #include "SDK/RendererOptimizer.h"
+#include "SDK/Profiler.h"
 #include <cmath>
 #include <algorithm>
 #include <climits>
@@ -10,14 +11,31 @@ namespace {
     constexpr float GOOD_PERFORMANCE_THRESHOLD_MS = 8.0f;  // Target render time for good performance (60fps = 16ms frame, aim for half)
     constexpr float MAX_CONFIDENCE = 0.95f;  // Maximum confidence to prevent overconfidence
     constexpr float REFERENCE_SCREEN_AREA = 2073600.0f;  // Reference screen size (1920x1080) for normalization
+    
+    // Sigmoid outputs 0.3, 0.5 and 0.7 as weighted sums: ln(p / (1 - p))
+    constexpr float LOW_PRIORITY_SCORE = -0.84729786f;
+    constexpr float MEDIUM_PRIORITY_SCORE = 0.0f;
+    constexpr float HIGH_PRIORITY_SCORE = 0.84729786f;
+    
+    // Pixel area with overflow protection; negative areas become 0
+    int PixelArea(const RECT& bounds) {
+        int64_t width = static_cast<int64_t>(bounds.right) - bounds.left;
+        int64_t height = static_cast<int64_t>(bounds.bottom) - bounds.top;
+        int64_t area = width * height;
+        
+        if (area < 0) {
+            return 0;
+        }
+        return area > INT_MAX ? INT_MAX : static_cast<int>(area);
+    }
 }
 
 // OptimizationModel Implementation
 RendererOptimizer::OptimizationModel::OptimizationModel()
-    : learningRate_(0.01f)
+    : bias_(0.0f)
+    , learningRate_(0.01f)
     , confidence_(0.5f)
     , trainingCount_(0)
-    , bias_(0.0f)
 {
     // Initialize weights for features
     // Features: renderTime, changeFreq, pixelArea, screenCoverage, isAnimated, cacheHitRate
@@ -31,92 +49,135 @@ RendererOptimizer::OptimizationModel::OptimizationModel()
     weights_ = {0.3f, 0.4f, 0.15f, 0.1f, 0.25f, -0.2f};
 }
 
-std::vector<float> RendererOptimizer::OptimizationModel::ExtractFeatures(const ElementMetrics& metrics) const {
-    std::vector<float> features;
-    
+void RendererOptimizer::OptimizationModel::ExtractFeatures(const ElementMetrics& metrics, float* features) {
     // Normalize render time (0-1, assuming max 16ms for 60fps)
-    features.push_back(std::min(metrics.avgRenderTime / 16.0f, 1.0f));
+    features[0] = std::min(metrics.avgRenderTime / 16.0f, 1.0f);
     
     // Change frequency (already 0-1)
-    features.push_back(metrics.changeFrequency);
+    features[1] = metrics.changeFrequency;
     
     // Pixel area (normalize by typical screen size 1920x1080)
-    features.push_back(std::min(metrics.pixelArea / REFERENCE_SCREEN_AREA, 1.0f));
+    features[2] = std::min(metrics.pixelArea / REFERENCE_SCREEN_AREA, 1.0f);
     
     // Screen coverage (already 0-1)
-    features.push_back(metrics.screenCoverage);
+    features[3] = metrics.screenCoverage;
     
     // Is animated (0 or 1)
-    features.push_back(metrics.isAnimated ? 1.0f : 0.0f);
+    features[4] = metrics.isAnimated ? 1.0f : 0.0f;
     
     // Cache hit rate (proper float division)
     float totalCacheAccess = static_cast<float>(metrics.cacheHits + metrics.cacheMisses);
     float cacheHitRate = totalCacheAccess > 0 ? 
         static_cast<float>(metrics.cacheHits) / totalCacheAccess : 0.5f;
-    features.push_back(cacheHitRate);
+    features[5] = cacheHitRate;
+}
+
+void RendererOptimizer::FeatureBatch::Resize(size_t elementCount) {
+    count = elementCount;
+    if (scores.size() >= elementCount) return;
     
-    return features;
+    for (auto& feature : features) {
+        feature.resize(elementCount);
+    }
+    screenCoverage.resize(elementCount);
+    changeFrequency.resize(elementCount);
+    isAnimated.resize(elementCount);
+    scores.resize(elementCount);
+}
+
+void RendererOptimizer::FeatureBatch::Set(size_t index, const ElementMetrics& metrics) {
+    float values[FEATURE_COUNT];
+    OptimizationModel::ExtractFeatures(metrics, values);
+    for (int f = 0; f < FEATURE_COUNT; f++) {
+        features[f][index] = values[f];
+    }
+    screenCoverage[index] = metrics.screenCoverage;
+    changeFrequency[index] = metrics.changeFrequency;
+    isAnimated[index] = metrics.isAnimated ? 1 : 0;
 }
 
 float RendererOptimizer::OptimizationModel::Sigmoid(float x) const {
     return 1.0f / (1.0f + std::exp(-x));
 }
 
-RendererOptimizer::RenderStrategy RendererOptimizer::OptimizationModel::Predict(const ElementMetrics& metrics) const {
-    auto features = ExtractFeatures(metrics);
-    
-    // Compute weighted sum
-    float sum = bias_;
-    for (size_t i = 0; i < features.size() && i < weights_.size(); ++i) {
-        sum += features[i] * weights_[i];
-    }
-    
-    // Apply activation
-    float output = Sigmoid(sum);
-    
+RendererOptimizer::RenderStrategy RendererOptimizer::OptimizationModel::Decide(float score, float screenCoverage,
+                                                                              float changeFrequency, bool isAnimated) {
     // Decision logic based on output and metrics
-    if (metrics.isAnimated || metrics.changeFrequency > 0.8f) {
+    if (isAnimated || changeFrequency > 0.8f) {
         return RenderStrategy::FULL_RENDER;
     }
     
-    if (output < 0.3f) {
+    if (score < LOW_PRIORITY_SCORE) {
         // Low priority - consider caching or LOD
-        if (metrics.screenCoverage < 0.1f) {
+        if (screenCoverage < 0.1f) {
             return RenderStrategy::LOD_LOW;
         }
         return RenderStrategy::CACHED_RENDER;
-    } else if (output < 0.5f) {
+    } else if (score < MEDIUM_PRIORITY_SCORE) {
         // Medium priority
-        if (metrics.screenCoverage < 0.2f) {
+        if (screenCoverage < 0.2f) {
             return RenderStrategy::LOD_MEDIUM;
         }
         return RenderStrategy::CACHED_RENDER;
-    } else if (output < 0.7f) {
+    } else if (score < HIGH_PRIORITY_SCORE) {
         // High priority
-        if (metrics.changeFrequency < 0.2f) {
+        if (changeFrequency < 0.2f) {
             return RenderStrategy::CACHED_RENDER;
         }
         return RenderStrategy::FULL_RENDER;
     } else {
         // Very high priority - always render
-        return metrics.screenCoverage > 0.5f ? RenderStrategy::FULL_RENDER : RenderStrategy::LOD_HIGH;
+        return screenCoverage > 0.5f ? RenderStrategy::FULL_RENDER : RenderStrategy::LOD_HIGH;
+    }
+}
+
+RendererOptimizer::RenderStrategy RendererOptimizer::OptimizationModel::Predict(const ElementMetrics& metrics) const {
+    float features[FEATURE_COUNT];
+    ExtractFeatures(metrics, features);
+    
+    // Compute weighted sum
+    float sum = bias_;
+    for (int i = 0; i < FEATURE_COUNT; ++i) {
+        sum += features[i] * weights_[i];
+    }
+    
+    return Decide(sum, metrics.screenCoverage, metrics.changeFrequency, metrics.isAnimated);
+}
+
+void RendererOptimizer::OptimizationModel::PredictBatch(FeatureBatch& batch, RenderStrategy* strategies) const {
+    size_t count = batch.count;
+    float* scores = batch.scores.data();
+    
+    // Feature by feature over the whole batch, adding in the same order as Predict()
+    std::fill(scores, scores + count, bias_);
+    for (int f = 0; f < FEATURE_COUNT; ++f) {
+        const float* feature = batch.features[f].data();
+        float weight = weights_[f];
+        for (size_t i = 0; i < count; ++i) {
+            scores[i] += feature[i] * weight;
+        }
+    }
+    
+    for (size_t i = 0; i < count; ++i) {
+        strategies[i] = Decide(scores[i], batch.screenCoverage[i], batch.changeFrequency[i], batch.isAnimated[i] != 0);
     }
 }
 
-void RendererOptimizer::OptimizationModel::UpdateWeights(const std::vector<float>& features, float error) {
+void RendererOptimizer::OptimizationModel::UpdateWeights(const float* features, float error) {
     // Gradient descent update
-    for (size_t i = 0; i < features.size() && i < weights_.size(); ++i) {
+    for (int i = 0; i < FEATURE_COUNT; ++i) {
         weights_[i] += learningRate_ * error * features[i];
     }
     bias_ += learningRate_ * error;
 }
 
-void RendererOptimizer::OptimizationModel::Learn(const ElementMetrics& metrics, RenderStrategy actual, float performance) {
-    auto features = ExtractFeatures(metrics);
+void RendererOptimizer::OptimizationModel::Learn(const ElementMetrics& metrics, RenderStrategy /*actual*/, float performance) {
+    float features[FEATURE_COUNT];
+    ExtractFeatures(metrics, features);
     
     // Calculate current prediction
     float sum = bias_;
-    for (size_t i = 0; i < features.size() && i < weights_.size(); ++i) {
+    for (int i = 0; i < FEATURE_COUNT; ++i) {
         sum += features[i] * weights_[i];
     }
     float predicted = Sigmoid(sum);
@@ -148,9 +209,10 @@ RendererOptimizer::RendererOptimizer()
 {
 }
 
-void RendererOptimizer::RegisterElement(const std::string& elementId, const RECT& bounds) {
-    if (elementMetrics_.find(elementId) != elementMetrics_.end()) {
-        return; // Already registered
+RendererOptimizer::ElementHandle RendererOptimizer::RegisterElement(const std::string& elementId, const RECT& bounds) {
+    auto existing = elementHandles_.find(elementId);
+    if (existing != elementHandles_.end()) {
+        return existing->second; // Already registered
     }
     
     ElementMetrics metrics = {};
@@ -162,47 +224,77 @@ void RendererOptimizer::RegisterElement(const std::string& elementId, const RECT
     metrics.isAnimated = false;
     metrics.changeFrequency = 0.5f; // Start with medium frequency
     
-    // Calculate pixel area with overflow protection
-    int64_t width = static_cast<int64_t>(bounds.right) - bounds.left;
-    int64_t height = static_cast<int64_t>(bounds.bottom) - bounds.top;
-    int64_t area = width * height;
-    
-    // Clamp to int range (negative areas become 0)
-    if (area < 0) {
-        metrics.pixelArea = 0;
-    } else if (area > INT_MAX) {
-        metrics.pixelArea = INT_MAX;
-    } else {
-        metrics.pixelArea = static_cast<int>(area);
-    }
-    
+    metrics.pixelArea = PixelArea(bounds);
     metrics.screenCoverage = 0.0f; // Will be updated
     metrics.lastUpdateTime = 0.0f;
     
-    elementMetrics_[elementId] = metrics;
+    ElementHandle handle = static_cast<ElementHandle>(elementMetrics_.size());
+    elementMetrics_.push_back(metrics);
+    elementHandles_[elementId] = handle;
+    return handle;
+}
+
+RendererOptimizer::ElementHandle RendererOptimizer::GetHandle(const std::string& elementId) const {
+    auto it = elementHandles_.find(elementId);
+    return it != elementHandles_.end() ? it->second : INVALID_ELEMENT;
 }
 
 RendererOptimizer::RenderStrategy RendererOptimizer::GetOptimalStrategy(const std::string& elementId) {
+    return GetOptimalStrategy(GetHandle(elementId));
+}
+
+RendererOptimizer::RenderStrategy RendererOptimizer::GetOptimalStrategy(ElementHandle element) {
     if (!enabled_) {
         return RenderStrategy::FULL_RENDER;
     }
     
-    auto it = elementMetrics_.find(elementId);
-    if (it == elementMetrics_.end()) {
+    if (element >= elementMetrics_.size()) {
         return RenderStrategy::FULL_RENDER; // Unknown element, render fully
     }
     
     totalDecisions_++;
-    return model_->Predict(it->second);
+    return model_->Predict(elementMetrics_[element]);
+}
+
+void RendererOptimizer::GetOptimalStrategies(const ElementHandle* handles, size_t count, RenderStrategy* strategies) {
+    SDK_PROFILE_ZONE("RendererOptimizer::GetOptimalStrategies");
+    if (!enabled_) {
+        std::fill(strategies, strategies + count, RenderStrategy::FULL_RENDER);
+        return;
+    }
+    
+    // Unknown handles take a zeroed slot and are overwritten afterwards, so
+    // the batch stays one contiguous run
+    static const ElementMetrics unknown = {};
+    batch_.Resize(count);
+    int known = 0;
+    for (size_t i = 0; i < count; i++) {
+        bool valid = handles[i] < elementMetrics_.size();
+        batch_.Set(i, valid ? elementMetrics_[handles[i]] : unknown);
+        known += valid;
+    }
+    
+    model_->PredictBatch(batch_, strategies);
+    if (known < (int)count) {
+        for (size_t i = 0; i < count; i++) {
+            if (handles[i] >= elementMetrics_.size()) {
+                strategies[i] = RenderStrategy::FULL_RENDER;
+            }
+        }
+    }
+    totalDecisions_ += known;
 }
 
 void RendererOptimizer::RecordRenderMetrics(const std::string& elementId, float renderTime, bool wasVisible) {
-    auto it = elementMetrics_.find(elementId);
-    if (it == elementMetrics_.end()) {
+    RecordRenderMetrics(GetHandle(elementId), renderTime, wasVisible);
+}
+
+void RendererOptimizer::RecordRenderMetrics(ElementHandle element, float renderTime, bool wasVisible) {
+    if (element >= elementMetrics_.size()) {
         return;
     }
     
-    ElementMetrics& metrics = it->second;
+    ElementMetrics& metrics = elementMetrics_[element];
     
     // Update render count
     metrics.renderCount++;
@@ -230,12 +322,15 @@ void RendererOptimizer::RecordRenderMetrics(const std::string& elementId, float
 }
 
 void RendererOptimizer::RecordCacheAccess(const std::string& elementId, bool hit) {
-    auto it = elementMetrics_.find(elementId);
-    if (it == elementMetrics_.end()) {
+    RecordCacheAccess(GetHandle(elementId), hit);
+}
+
+void RendererOptimizer::RecordCacheAccess(ElementHandle element, bool hit) {
+    if (element >= elementMetrics_.size()) {
         return;
     }
     
-    ElementMetrics& metrics = it->second;
+    ElementMetrics& metrics = elementMetrics_[element];
     if (hit) {
         metrics.cacheHits++;
         cacheHits_++;
@@ -246,12 +341,15 @@ void RendererOptimizer::RecordCacheAccess(const std::string& elementId, bool hit
 }
 
 void RendererOptimizer::MarkElementChanged(const std::string& elementId) {
-    auto it = elementMetrics_.find(elementId);
-    if (it == elementMetrics_.end()) {
+    MarkElementChanged(GetHandle(elementId));
+}
+
+void RendererOptimizer::MarkElementChanged(ElementHandle element) {
+    if (element >= elementMetrics_.size()) {
         return;
     }
     
-    UpdateChangeFrequency(it->second, true);
+    UpdateChangeFrequency(elementMetrics_[element], true);
 }
 
 void RendererOptimizer::UpdateChangeFrequency(ElementMetrics& metrics, bool changed) {
@@ -261,20 +359,34 @@ void RendererOptimizer::UpdateChangeFrequency(ElementMetrics& metrics, bool chan
 }
 
 const RendererOptimizer::ElementMetrics* RendererOptimizer::GetMetrics(const std::string& elementId) const {
-    auto it = elementMetrics_.find(elementId);
-    if (it == elementMetrics_.end()) {
+    return GetMetrics(GetHandle(elementId));
+}
+
+const RendererOptimizer::ElementMetrics* RendererOptimizer::GetMetrics(ElementHandle element) const {
+    if (element >= elementMetrics_.size()) {
         return nullptr;
     }
-    return &it->second;
+    return &elementMetrics_[element];
+}
+
+void RendererOptimizer::UpdateElementBounds(ElementHandle element, const RECT& bounds, int64_t screenArea) {
+    if (element >= elementMetrics_.size()) {
+        return;
+    }
+    
+    ElementMetrics& metrics = elementMetrics_[element];
+    metrics.pixelArea = PixelArea(bounds);
+    metrics.screenCoverage = screenArea > 0 ?
+        std::min(static_cast<float>(metrics.pixelArea) / static_cast<float>(screenArea), 1.0f) : 0.0f;
 }
 
 int RendererOptimizer::CalculateLOD(const std::string& elementId, float screenCoverage) {
-    auto it = elementMetrics_.find(elementId);
-    if (it == elementMetrics_.end()) {
+    ElementHandle element = GetHandle(elementId);
+    if (element >= elementMetrics_.size()) {
         return 0; // Highest detail for unknown elements
     }
     
-    ElementMetrics& metrics = it->second;
+    ElementMetrics& metrics = elementMetrics_[element];
     metrics.screenCoverage = screenCoverage;
     
     // Calculate LOD based on screen coverage and other factors
@@ -299,8 +411,8 @@ RendererOptimizer::PerformanceStats RendererOptimizer::GetStats() const {
     stats.skippedRenders = 0;
     int totalRenderCount = 0;
     
-    for (const auto& pair : elementMetrics_) {
-        totalRenderCount += pair.second.renderCount;
+    for (const auto& metrics : elementMetrics_) {
+        totalRenderCount += metrics.renderCount;
     }
     
     // fullRenders represents total render operations (all strategies)
@@ -338,10 +450,10 @@ void RendererOptimizer::ResetStats() {
     cacheHits_ = 0;
     cacheMisses_ = 0;
     
-    for (auto& pair : elementMetrics_) {
-        pair.second.renderCount = 0;
-        pair.second.cacheHits = 0;
-        pair.second.cacheMisses = 0;
+    for (auto& metrics : elementMetrics_) {
+        metrics.renderCount = 0;
+        metrics.cacheHits = 0;
+        metrics.cacheMisses = 0;
     }
 }
 
@@ -1,31 +1,312 @@
 #include "../../include/SDK/RichText.h"
 #include "../../include/SDK/Renderer.h"
 #include <algorithm>
-#include <sstream>
+#include <cwchar>
+#include <iterator>
 
 namespace SDK {
 
+namespace {
+    constexpr size_t LAYOUT_CLEAN = static_cast<size_t>(-1);
+    constexpr int TEXT_PADDING = 5;
+    
+    // Absolute line positions are rebased before they can overflow
+    constexpr int LAYOUT_REBASE_Y = 1 << 30;
+    
+    size_t CountLineBreaks(const std::wstring& text) {
+        return static_cast<size_t>(std::count(text.begin(), text.end(), L'\n'));
+    }
+    
+    bool SameColor(const Color& a, const Color& b) {
+        return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+    }
+    
+    bool SameFormat(const TextSpan& a, const TextSpan& b) {
+        return a.bold == b.bold && a.italic == b.italic && a.underline == b.underline &&
+               a.strikethrough == b.strikethrough && a.fontSize == b.fontSize &&
+               a.isLink == b.isLink && a.linkUrl == b.linkUrl && a.fontFamily == b.fontFamily &&
+               SameColor(a.foregroundColor, b.foregroundColor) &&
+               SameColor(a.backgroundColor, b.backgroundColor);
+    }
+    
+    constexpr size_t NOT_FOUND = std::wstring::npos;
+    
+    // Start of each line, plus the text length; like getline, a final line
+    // break doesn't open another line
+    void SplitMarkdownLines(const std::wstring& text, std::vector<size_t>& starts) {
+        starts.clear();
+        if (!text.empty()) starts.push_back(0);
+        for (const wchar_t* p = text.data(); (p = std::wmemchr(p, L'\n', text.data() + text.size() - p)); p++) {
+            size_t next = static_cast<size_t>(p - text.data()) + 1;
+            if (next < text.size()) starts.push_back(next);
+        }
+        starts.push_back(text.size());
+    }
+    
+    // Appends the spans of one Markdown line, ending with its line break, in
+    // one left-to-right pass; text is copied only into the spans. Searches for
+    // closing markers remember their answer while it lies ahead, so unmatched
+    // markers don't rescan the line. Unmatched markers stay literal text.
+    template <typename Spans>
+    void ParseMarkdownLine(const wchar_t* line, size_t length, Spans& spans) {
+        if (length > 0 && line[length - 1] == L'\r') length--;
+        
+        auto emit = [&](size_t start, size_t count) -> TextSpan& {
+            spans.emplace_back();
+            spans.back().text.assign(line + start, count);
+            return spans.back();
+        };
+        auto next = [&](size_t& cached, size_t from, wchar_t ch) {
+            if (cached < from) {
+                const wchar_t* found = std::wmemchr(line + from, ch, length - from);
+                cached = found ? static_cast<size_t>(found - line) : NOT_FOUND;
+            }
+            return cached;
+        };
+        bool plainLast = false;     // The line break can join a plain last run
+        
+        if (length > 0 && line[0] == L'#') {
+            int level = 0;
+            size_t pos = 0;
+            while (pos < length && line[pos] == L'#') {
+                level++;
+                pos++;
+            }
+            while (pos < length && line[pos] == L' ') {
+                pos++;
+            }
+            TextSpan& heading = emit(pos, length - pos);
+            heading.bold = true;
+            heading.fontSize = RichTextDefaults::DEFAULT_FONT_SIZE + (4 - level) * 4;
+        } else {
+            // Cached searches; each is asked from ever later positions
+            size_t star = 0, pairStar = 0, pair = 0, bracket = 0, paren = 0;
+            size_t plain = 0;       // Start of the text not emitted yet
+            size_t pos = 0;
+            
+            // Ends the pending plain text at pos and emits a styled run, unless empty
+            auto styled = [&](size_t start, size_t count, size_t resume) -> TextSpan* {
+                if (pos > plain) emit(plain, pos - plain);
+                pos = plain = resume;
+                plainLast = false;
+                return count > 0 ? &emit(start, count) : nullptr;
+            };
+            
+            while (pos < length) {
+                wchar_t ch = line[pos];
+                if (ch == L'*') {
+                    // Bold: **text**
+                    if (pos + 1 < length && line[pos + 1] == L'*') {
+                        if (pair < pos + 2) {
+                            size_t from = pos + 2;
+                            while ((pair = next(pairStar, from, L'*')) != NOT_FOUND &&
+                                   (pair + 1 >= length || line[pair + 1] != L'*')) {
+                                from = pair + 1;
+                            }
+                        }
+                        if (pair != NOT_FOUND) {
+                            size_t end = pair;
+                            if (TextSpan* span = styled(pos + 2, end - pos - 2, end + 2)) span->bold = true;
+                            continue;
+                        }
+                    }
+                    
+                    // Italic: *text*
+                    size_t end = next(star, pos + 1, L'*');
+                    if (end != NOT_FOUND) {
+                        if (TextSpan* span = styled(pos + 1, end - pos - 1, end + 1)) span->italic = true;
+                        continue;
+                    }
+                } else if (ch == L'[') {
+                    // Link: [text](url)
+                    size_t textEnd = next(bracket, pos + 1, L']');
+                    if (textEnd != NOT_FOUND && textEnd + 1 < length && line[textEnd + 1] == L'(') {
+                        size_t urlEnd = next(paren, textEnd + 2, L')');
+                        if (urlEnd != NOT_FOUND) {
+                            if (TextSpan* span = styled(pos + 1, textEnd - pos - 1, urlEnd + 1)) {
+                                span->isLink = true;
+                                span->linkUrl.assign(line + textEnd + 2, urlEnd - textEnd - 2);
+                                span->foregroundColor = Color(0, 0, 255, 255); // Blue
+                                span->underline = true;
+                            }
+                            continue;
+                        }
+                    }
+                }
+                pos++;
+            }
+            if (length > plain) {
+                emit(plain, length - plain);
+                plainLast = true;
+            }
+        }
+        
+        if (plainLast) {
+            spans.back().text += L'\n';
+        } else {
+            spans.emplace_back();
+            spans.back().text = L"\n";
+        }
+    }
+    
+    size_t EscapedHtmlLength(const std::wstring& text) {
+        size_t length = text.size();
+        for (wchar_t ch : text) {
+            switch (ch) {
+            case L'&': length += 4; break;
+            case L'<': case L'>': length += 3; break;
+            case L'"': length += 5; break;
+            default: break;
+            }
+        }
+        return length;
+    }
+    
+    void AppendEscapedHtml(std::wstring& html, const std::wstring& text) {
+        for (wchar_t ch : text) {
+            switch (ch) {
+            case L'&': html += L"&amp;"; break;
+            case L'<': html += L"&lt;"; break;
+            case L'>': html += L"&gt;"; break;
+            case L'"': html += L"&quot;"; break;
+            default: html += ch; break;
+            }
+        }
+    }
+}
+
 // RichTextDocument implementation
-RichTextDocument::RichTextDocument() {
+RichTextDocument::RichTextDocument()
+    : m_maxLines(0)
+    , m_lineBreaks(0)
+    , m_hasMarkdown(false)
+    , m_spanBase(0)
+    , m_runBase(0)
+    , m_yBase(0)
+    , m_layoutWidth(-1)
+    , m_layoutLineSpacing(0.0f)
+    , m_dirtySpan(0)
+{
 }
 
 void RichTextDocument::Clear() {
+    ForgetMarkdown();
+    m_markdown.clear();
+    m_markdown.shrink_to_fit();
     m_spans.clear();
+    m_metrics.clear();
+    m_lineBreaks = 0;
+    ResetLayout();
 }
 
 void RichTextDocument::AddSpan(const TextSpan& span) {
+    ForgetMarkdown();
     m_spans.push_back(span);
+    m_metrics.emplace_back();
+    m_lineBreaks += CountLineBreaks(span.text);
+    MarkDirty(m_spans.size() - 1);
 }
 
 void RichTextDocument::InsertSpan(size_t index, const TextSpan& span) {
     if (index <= m_spans.size()) {
+        ForgetMarkdown();
         m_spans.insert(m_spans.begin() + index, span);
+        if (index <= m_metrics.size()) {
+            m_metrics.insert(m_metrics.begin() + index, SpanMetrics());
+        }
+        m_lineBreaks += CountLineBreaks(span.text);
+        MarkDirty(index);
     }
 }
 
 void RichTextDocument::RemoveSpan(size_t index) {
     if (index < m_spans.size()) {
+        ForgetMarkdown();
+        m_lineBreaks -= std::min(m_lineBreaks, CountLineBreaks(m_spans[index].text));
         m_spans.erase(m_spans.begin() + index);
+        if (index < m_metrics.size()) {
+            m_metrics.erase(m_metrics.begin() + index);
+        }
+        MarkDirty(index);
+    }
+}
+
+void RichTextDocument::AppendStream(const TextSpan& span) {
+    const std::wstring& text = span.text;
+    size_t start = 0;
+    while (start < text.length()) {
+        size_t end = text.find(L'\n', start);
+        size_t stop = end == std::wstring::npos ? text.length() : end + 1;
+        
+        // Continue the open last line rather than adding a span per append
+        if (!m_spans.empty() && !m_spans.back().text.empty() && m_spans.back().text.back() != L'\n' &&
+            SameFormat(m_spans.back(), span)) {
+            m_spans.back().text.append(text, start, stop - start);
+            if (end != std::wstring::npos) m_lineBreaks++;
+            InvalidateSpan(m_spans.size() - 1);
+        } else {
+            TextSpan piece = span;
+            piece.text = text.substr(start, stop - start);
+            AddSpan(piece);
+        }
+        start = stop;
+    }
+    
+    TrimToMaxLines();
+}
+
+void RichTextDocument::SetMaxLines(size_t maxLines) {
+    m_maxLines = maxLines;
+    TrimToMaxLines();
+}
+
+void RichTextDocument::TrimToMaxLines() {
+    if (m_maxLines == 0 || m_lineBreaks <= m_maxLines) return;
+    
+    if (m_metrics.size() != m_spans.size()) {
+        m_metrics.assign(m_spans.size(), SpanMetrics());
+        RecountLineBreaks();
+        ResetLayout();
+    }
+    ForgetMarkdown();
+    
+    while (m_lineBreaks > m_maxLines && !m_spans.empty()) {
+        m_lineBreaks -= std::min(m_lineBreaks, CountLineBreaks(m_spans.front().text));
+        m_spans.pop_front();
+        m_metrics.pop_front();
+        m_spanBase++;
+        if (m_dirtySpan != LAYOUT_CLEAN && m_dirtySpan > 0) m_dirtySpan--;
+    }
+    
+    // Drop the lines that began in removed spans
+    while (!m_lines.empty() && m_lines.front().startSpan < m_spanBase) {
+        m_lines.pop_front();
+    }
+    while (!m_runs.empty() && m_runs.front().span < m_spanBase) {
+        m_runs.pop_front();
+        m_runBase++;
+    }
+    
+    // Trimming ends at a line break, so the first kept span starts a line;
+    // if it doesn't (spans with inner breaks), lay the rest out again
+    if (m_lines.empty() || m_lines.front().startSpan != m_spanBase || m_lines.front().startOffset != 0) {
+        ResetLayout();
+        return;
+    }
+    m_yBase = m_lines.front().y;
+    
+    if (m_yBase > LAYOUT_REBASE_Y) {
+        for (auto& line : m_lines) {
+            line.y -= m_yBase;
+        }
+        m_yBase = 0;
+    }
+}
+
+void RichTextDocument::RecountLineBreaks() {
+    m_lineBreaks = 0;
+    for (const auto& span : m_spans) {
+        m_lineBreaks += CountLineBreaks(span.text);
     }
 }
 
@@ -56,91 +337,99 @@ void RichTextDocument::AddParagraph(const std::wstring& text) {
     AddText(text + L"\n", false, false);
 }
 
+void RichTextDocument::ForgetMarkdown() {
+    m_hasMarkdown = false;
+    m_markdownLines.clear();
+    m_markdownSpans.clear();
+}
+
 void RichTextDocument::ParseMarkdown(const std::wstring& markdown) {
+    std::wstring source = markdown;     // May be our own m_markdown
     Clear();
+    m_markdown.swap(source);
+    SplitMarkdownLines(m_markdown, m_markdownLines);
+    
+    size_t lineCount = m_markdownLines.size() - 1;
+    m_markdownSpans.resize(lineCount + 1);
+    for (size_t i = 0; i < lineCount; i++) {
+        m_markdownSpans[i] = m_spans.size();
+        ParseMarkdownLine(m_markdown.data() + m_markdownLines[i], m_markdownLines[i + 1] - m_markdownLines[i],
+                          m_spans);
+    }
+    m_markdownSpans[lineCount] = m_spans.size();
+    m_metrics.resize(m_spans.size());
+    m_lineBreaks = lineCount;       // One per line, and none inside
+    m_hasMarkdown = true;
+}
+
+void RichTextDocument::UpdateMarkdown(const std::wstring& markdown) {
+    // Spans pushed through GetSpans() leave the metrics short
+    if (!m_hasMarkdown || m_metrics.size() != m_spans.size()) {
+        ParseMarkdown(markdown);
+        return;
+    }
     
-    std::wistringstream stream(markdown);
-    std::wstring line;
+    std::vector<size_t> lines;
+    SplitMarkdownLines(markdown, lines);
+    size_t oldCount = m_markdownLines.size() - 1;
+    size_t newCount = lines.size() - 1;
+    auto sameLine = [&](size_t oldLine, size_t newLine) {
+        size_t start = m_markdownLines[oldLine];
+        size_t length = m_markdownLines[oldLine + 1] - start;
+        return lines[newLine + 1] - lines[newLine] == length &&
+               m_markdown.compare(start, length, markdown, lines[newLine], length) == 0;
+    };
+    
+    // Only the lines between the unchanged head and tail are parsed again
+    size_t limit = std::min(oldCount, newCount);
+    size_t head = 0;
+    while (head < limit && sameLine(head, head)) {
+        head++;
+    }
+    size_t tail = 0;
+    while (tail < limit - head && sameLine(oldCount - 1 - tail, newCount - 1 - tail)) {
+        tail++;
+    }
     
-    while (std::getline(stream, line)) {
-        if (line.empty()) {
-            AddText(L"\n");
-            continue;
-        }
-        
-        // Heading
-        if (line[0] == L'#') {
-            int level = 0;
-            size_t pos = 0;
-            while (pos < line.length() && line[pos] == L'#') {
-                level++;
-                pos++;
-            }
-            while (pos < line.length() && line[pos] == L' ') {
-                pos++;
-            }
-            AddHeading(line.substr(pos), level);
-            AddText(L"\n");
-            continue;
-        }
-        
-        // Parse inline formatting
-        size_t pos = 0;
-        while (pos < line.length()) {
-            // Bold: **text**
-            if (pos + 1 < line.length() && line[pos] == L'*' && line[pos + 1] == L'*') {
-                size_t end = line.find(L"**", pos + 2);
-                if (end != std::wstring::npos) {
-                    AddText(line.substr(pos + 2, end - pos - 2), true, false);
-                    pos = end + 2;
-                    continue;
-                }
-            }
-            
-            // Italic: *text*
-            if (line[pos] == L'*') {
-                size_t end = line.find(L'*', pos + 1);
-                if (end != std::wstring::npos) {
-                    AddText(line.substr(pos + 1, end - pos - 1), false, true);
-                    pos = end + 1;
-                    continue;
-                }
-            }
-            
-            // Link: [text](url)
-            if (line[pos] == L'[') {
-                size_t textEnd = line.find(L']', pos + 1);
-                if (textEnd != std::wstring::npos && textEnd + 1 < line.length() && line[textEnd + 1] == L'(') {
-                    size_t urlEnd = line.find(L')', textEnd + 2);
-                    if (urlEnd != std::wstring::npos) {
-                        std::wstring text = line.substr(pos + 1, textEnd - pos - 1);
-                        std::wstring url = line.substr(textEnd + 2, urlEnd - textEnd - 2);
-                        AddLink(text, url);
-                        pos = urlEnd + 1;
-                        continue;
-                    }
-                }
-            }
-            
-            // Regular text
-            size_t nextSpecial = line.find_first_of(L"*[", pos);
-            if (nextSpecial == std::wstring::npos) {
-                AddText(line.substr(pos));
-                break;
-            } else {
-                if (nextSpecial > pos) {
-                    AddText(line.substr(pos, nextSpecial - pos));
-                }
-                pos = nextSpecial;
-            }
+    std::vector<TextSpan> parsed;
+    std::vector<size_t> spans(newCount + 1);
+    std::copy(m_markdownSpans.begin(), m_markdownSpans.begin() + head + 1, spans.begin());
+    size_t first = m_markdownSpans[head];
+    for (size_t i = head; i < newCount - tail; i++) {
+        spans[i] = first + parsed.size();
+        ParseMarkdownLine(markdown.data() + lines[i], lines[i + 1] - lines[i], parsed);
+    }
+    size_t last = m_markdownSpans[oldCount - tail];
+    size_t end = first + parsed.size();
+    for (size_t i = 0; i <= tail; i++) {
+        spans[newCount - tail + i] = m_markdownSpans[oldCount - tail + i] - last + end;
+    }
+    
+    if (last > first || !parsed.empty()) {
+        m_spans.erase(m_spans.begin() + first, m_spans.begin() + last);
+        m_metrics.erase(m_metrics.begin() + first, m_metrics.begin() + last);
+        if (!parsed.empty()) {      // Some deques mishandle empty range inserts
+            m_spans.insert(m_spans.begin() + first, std::make_move_iterator(parsed.begin()),
+                           std::make_move_iterator(parsed.end()));
+            m_metrics.insert(m_metrics.begin() + first, parsed.size(), SpanMetrics());
         }
-        
-        AddText(L"\n");
+        m_lineBreaks = m_lineBreaks - (oldCount - tail - head) + (newCount - tail - head);
+        MarkDirty(first);
     }
+    
+    m_markdown = markdown;
+    m_markdownLines.swap(lines);
+    m_markdownSpans.swap(spans);
 }
 
 std::wstring RichTextDocument::ToPlainText() const {
+    size_t length = 0;
+    for (const auto& span : m_spans) {
+        length += span.text.size();
+    }
+    
     std::wstring result;
+    result.reserve(length);
     for (const auto& span : m_spans) {
         result += span.text;
     }
@@ -148,31 +437,217 @@ std::wstring RichTextDocument::ToPlainText() const {
 }
 
 std::wstring RichTextDocument::ToHtml() const {
+    // Sized exactly first, so the export is one allocation however long
+    size_t length = 0;
+    for (const auto& span : m_spans) {
+        length += EscapedHtmlLength(span.text);
+        length += (span.bold + span.italic + span.underline + span.strikethrough) * 7;    // <b></b>
+        if (span.isLink) length += EscapedHtmlLength(span.linkUrl) + 15;                   // <a href=""></a>
+    }
+    
     std::wstring html;
+    html.reserve(length);
     for (const auto& span : m_spans) {
-        std::wstring spanHtml = span.text;
-        
-        if (span.bold) {
-            spanHtml = L"<b>" + spanHtml + L"</b>";
-        }
-        if (span.italic) {
-            spanHtml = L"<i>" + spanHtml + L"</i>";
-        }
-        if (span.underline) {
-            spanHtml = L"<u>" + spanHtml + L"</u>";
-        }
-        if (span.strikethrough) {
-            spanHtml = L"<s>" + spanHtml + L"</s>";
-        }
         if (span.isLink) {
-            spanHtml = L"<a href=\"" + span.linkUrl + L"\">" + spanHtml + L"</a>";
+            html += L"<a href=\"";
+            AppendEscapedHtml(html, span.linkUrl);
+            html += L"\">";
         }
-        
-        html += spanHtml;
+        if (span.strikethrough) html += L"<s>";
+        if (span.underline) html += L"<u>";
+        if (span.italic) html += L"<i>";
+        if (span.bold) html += L"<b>";
+        AppendEscapedHtml(html, span.text);
+        if (span.bold) html += L"</b>";
+        if (span.italic) html += L"</i>";
+        if (span.underline) html += L"</u>";
+        if (span.strikethrough) html += L"</s>";
+        if (span.isLink) html += L"</a>";
     }
     return html;
 }
 
+void RichTextDocument::InvalidateSpan(size_t index) {
+    ForgetMarkdown();
+    if (index < m_metrics.size()) {
+        m_metrics[index].valid = false;
+    }
+    MarkDirty(index);
+}
+
+void RichTextDocument::InvalidateLayout() {
+    for (auto& metrics : m_metrics) {
+        metrics.valid = false;
+    }
+    RecountLineBreaks();
+    MarkDirty(0);
+}
+
+void RichTextDocument::ResetLayout() {
+    m_lines.clear();
+    m_runs.clear();
+    m_spanBase = 0;
+    m_runBase = 0;
+    m_yBase = 0;
+    m_dirtySpan = 0;
+}
+
+RichTextDocument::LayoutLine RichTextDocument::GetLayoutLine(size_t index) const {
+    LayoutLine line = m_lines[index];
+    line.startSpan -= m_spanBase;
+    line.firstRun -= m_runBase;
+    line.y -= m_yBase;
+    return line;
+}
+
+RichTextDocument::LayoutRun RichTextDocument::GetLayoutRun(size_t index) const {
+    LayoutRun run = m_runs[index];
+    run.span -= m_spanBase;
+    return run;
+}
+
+int RichTextDocument::GetLayoutHeight() const {
+    return m_lines.empty() ? 0 : m_lines.back().y + m_lines.back().height - m_yBase;
+}
+
+size_t RichTextDocument::FindLayoutLine(int y) const {
+    auto it = std::upper_bound(m_lines.begin(), m_lines.end(), y + m_yBase,
+                               [](int value, const LayoutLine& line) { return value < line.y; });
+    return it == m_lines.begin() ? 0 : static_cast<size_t>(it - m_lines.begin()) - 1;
+}
+
+void RichTextDocument::MeasureSpan(HDC hdc, size_t index) {
+    const TextSpan& span = m_spans[index];
+    SpanMetrics& metrics = m_metrics[index];
+    
+    ScopedFont font(hdc, FontCache::Get(span.fontFamily, span.fontSize, span.bold ? FW_BOLD : FW_NORMAL,
+                                        span.italic, span.underline, span.strikethrough));
+    
+    TEXTMETRICW tm;
+    metrics.ascent = GetTextMetricsW(hdc, &tm) ? static_cast<int>(tm.tmAscent) : span.fontSize;
+    metrics.advances.assign(span.text.length(), 0);
+    
+    // One call per line of the span; the extents are cumulative
+    std::vector<int> extents;
+    size_t start = 0;
+    while (start < span.text.length()) {
+        size_t end = span.text.find(L'\n', start);
+        if (end == std::wstring::npos) end = span.text.length();
+        
+        int count = static_cast<int>(end - start);
+        if (count > 0) {
+            extents.resize(count);
+            SIZE size;
+            if (GetTextExtentExPointW(hdc, span.text.c_str() + start, count, 0, nullptr, extents.data(), &size)) {
+                int previous = 0;
+                for (int i = 0; i < count; i++) {
+                    metrics.advances[start + i] = extents[i] - previous;
+                    previous = extents[i];
+                }
+            }
+        }
+        start = end + 1;
+    }
+    
+    metrics.valid = true;
+}
+
+void RichTextDocument::FinishLine(LayoutLine& line, int lineHeight, int ascent) {
+    // Runs hold their own ascent until the line's is known
+    for (size_t i = line.firstRun; i < line.firstRun + line.runCount; i++) {
+        auto& run = m_runs[i - m_runBase];
+        run.yOffset = ascent - run.yOffset;
+    }
+    line.height = lineHeight;
+    m_lines.push_back(line);
+}
+
+void RichTextDocument::UpdateLayout(HDC hdc, int wrapWidth, float lineSpacing) {
+    if (m_metrics.size() != m_spans.size()) {
+        // Spans were added or removed through GetSpans()
+        m_metrics.assign(m_spans.size(), SpanMetrics());
+        RecountLineBreaks();
+        ResetLayout();
+    }
+    if (wrapWidth != m_layoutWidth || lineSpacing != m_layoutLineSpacing) {
+        m_layoutWidth = wrapWidth;
+        m_layoutLineSpacing = lineSpacing;
+        MarkDirty(0);
+    }
+    if (m_dirtySpan == LAYOUT_CLEAN) return;
+    
+    // Restart at the last line beginning before the first changed span;
+    // no earlier line break depended on anything after that point
+    size_t dirtySpan = m_spanBase + m_dirtySpan;
+    auto first = std::lower_bound(m_lines.begin(), m_lines.end(), dirtySpan,
+                                  [](const LayoutLine& line, size_t span) { return line.startSpan < span; });
+    size_t lineIndex = first == m_lines.begin() ? 0 : static_cast<size_t>(first - m_lines.begin()) - 1;
+    
+    LayoutLine line = { m_spanBase, 0, m_runBase, 0, m_yBase, 0 };
+    if (lineIndex < m_lines.size()) {
+        line = m_lines[lineIndex];
+        line.runCount = 0;
+    }
+    m_lines.resize(lineIndex);
+    m_runs.resize(line.firstRun - m_runBase);
+    
+    int x = 0;
+    int lineHeight = 0;
+    int ascent = 0;
+    size_t offset = line.startOffset;
+    
+    for (size_t i = line.startSpan - m_spanBase; i < m_spans.size(); i++, offset = 0) {
+        if (!m_metrics[i].valid) MeasureSpan(hdc, i);
+        
+        const std::wstring& text = m_spans[i].text;
+        const SpanMetrics& metrics = m_metrics[i];
+        int spanHeight = static_cast<int>(m_spans[i].fontSize * lineSpacing);
+        
+        size_t pos = offset;
+        while (pos < text.length()) {
+            size_t runStart = pos;
+            int runX = x;
+            
+            // Every line takes at least one character, however narrow the wrap width
+            while (pos < text.length() && text[pos] != L'\n') {
+                int advance = metrics.advances[pos];
+                if (x > 0 && x + advance > wrapWidth) break;
+                x += advance;
+                pos++;
+            }
+            
+            if (pos > runStart) {
+                m_runs.push_back({ m_spanBase + i, runStart, pos - runStart, runX, x - runX, metrics.ascent });
+                line.runCount++;
+                lineHeight = std::max(lineHeight, spanHeight);
+                ascent = std::max(ascent, metrics.ascent);
+            }
+            if (pos >= text.length()) break;
+            
+            if (text[pos] == L'\n') {
+                lineHeight = std::max(lineHeight, spanHeight);
+                pos++;
+            }
+            
+            // A line starting right after a span's final break starts at the next span
+            FinishLine(line, lineHeight, ascent);
+            if (pos < text.length()) {
+                line = { m_spanBase + i, pos, m_runBase + m_runs.size(), 0, line.y + lineHeight, 0 };
+            } else {
+                line = { m_spanBase + i + 1, 0, m_runBase + m_runs.size(), 0, line.y + lineHeight, 0 };
+            }
+            x = 0;
+            lineHeight = 0;
+            ascent = 0;
+        }
+    }
+    
+    // The last line stays open so appended text continues on it
+    FinishLine(line, lineHeight, ascent);
+    m_yBase = m_lines.front().y;
+    m_dirtySpan = LAYOUT_CLEAN;
+}
+
 // RichTextBox implementation
 RichTextBox::RichTextBox()
     : Widget()
@@ -187,6 +662,8 @@ RichTextBox::RichTextBox()
     , m_maxScrollOffset(0)
     , m_lineSpacing(1.2f)
     , m_paragraphSpacing(5)
+    , m_textRect{ 0, 0, 0, 0 }
+    , m_streaming(false)
     , m_hoveredSpanIndex(-1)
 {
     m_width = 300;
@@ -206,10 +683,48 @@ std::wstring RichTextBox::GetText() const {
 }
 
 void RichTextBox::AppendText(const std::wstring& text) {
-    m_document->AddText(text);
+    AppendText(TextSpan(text));
+}
+
+void RichTextBox::AppendText(const TextSpan& span) {
+    if (!m_streaming) {
+        m_document->AddSpan(span);
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    if (!m_pendingSpans.empty() && SameFormat(m_pendingSpans.back(), span)) {
+        m_pendingSpans.back().text += span.text;
+    } else {
+        m_pendingSpans.push_back(span);
+    }
+}
+
+void RichTextBox::SetStreamingMode(bool streaming, size_t maxLines) {
+    if (m_streaming && !streaming) {
+        FlushPendingText();
+    }
+    m_streaming = streaming;
+    m_document->SetMaxLines(streaming ? maxLines : 0);
+    if (streaming) ScheduleUpdate();
+}
+
+void RichTextBox::FlushPendingText() {
+    std::vector<TextSpan> pending;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        pending.swap(m_pendingSpans);
+    }
+    for (const auto& span : pending) {
+        m_document->AppendStream(span);
+    }
 }
 
 void RichTextBox::Clear() {
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        m_pendingSpans.clear();
+    }
     m_document->Clear();
     m_selectionStart = 0;
     m_selectionEnd = 0;
@@ -242,8 +757,9 @@ void RichTextBox::SetSelectionBold(bool bold) {
         // For this basic version, we apply to recently added content
         for (size_t i = 0; i < spans.size(); i++) {
             // Only modify spans that don't have special formatting (links, headings)
-            if (!spans[i].isLink) {
+            if (!spans[i].isLink && spans[i].bold != bold) {
                 spans[i].bold = bold;
+                m_document->InvalidateSpan(i);
             }
         }
     }
@@ -255,8 +771,9 @@ void RichTextBox::SetSelectionItalic(bool italic) {
     auto& spans = m_document->GetSpans();
     if (!spans.empty()) {
         for (size_t i = 0; i < spans.size(); i++) {
-            if (!spans[i].isLink) {
+            if (!spans[i].isLink && spans[i].italic != italic) {
                 spans[i].italic = italic;
+                m_document->InvalidateSpan(i);
             }
         }
     }
@@ -295,7 +812,10 @@ void RichTextBox::SetSelectionFontSize(int size) {
     auto& spans = m_document->GetSpans();
     if (!spans.empty()) {
         for (size_t i = 0; i < spans.size(); i++) {
-            spans[i].fontSize = size;
+            if (spans[i].fontSize != size) {
+                spans[i].fontSize = size;
+                m_document->InvalidateSpan(i);
+            }
         }
     }
 }
@@ -312,109 +832,76 @@ void RichTextBox::ScrollToPosition(int position) {
     m_scrollOffset = std::max(0, std::min(position, m_maxScrollOffset));
 }
 
-int RichTextBox::GetLineHeight(const TextSpan& span) const {
-    return static_cast<int>(span.fontSize * m_lineSpacing);
-}
-
-void RichTextBox::RenderSpan(HDC hdc, const RECT& rect, const TextSpan& span, int& x, int& y) {
-    // Create font with formatting
-    int fontWeight = span.bold ? FW_BOLD : FW_NORMAL;
-    BOOL italic = span.italic ? TRUE : FALSE;
-    BOOL underline = span.underline ? TRUE : FALSE;
-    BOOL strikeout = span.strikethrough ? TRUE : FALSE;
-    
-    HFONT hFont = CreateFontW(
-        span.fontSize, 0, 0, 0, fontWeight, italic, underline, strikeout,
-        DEFAULT_CHARSET, OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS,
-        CLEARTYPE_QUALITY, DEFAULT_PITCH | FF_DONTCARE,
-        span.fontFamily.c_str()
-    );
-    
-    HFONT oldFont = (HFONT)SelectObject(hdc, hFont);
+void RichTextBox::CalculateLayout(HDC hdc, const RECT& textRect) {
+    bool atBottom = m_scrollOffset >= m_maxScrollOffset;
+    if (m_streaming) {
+        FlushPendingText();
+    }
     
-    // Set colors
-    SetTextColor(hdc, span.foregroundColor.ToCOLORREF());
-    SetBkMode(hdc, TRANSPARENT);
+    m_textRect = textRect;
+    m_document->UpdateLayout(hdc, static_cast<int>(textRect.right - textRect.left), m_lineSpacing);
     
-    if (span.backgroundColor.a > 0) {
-        SetBkMode(hdc, OPAQUE);
-        SetBkColor(hdc, span.backgroundColor.ToCOLORREF());
-    }
+    int viewHeight = static_cast<int>(textRect.bottom - textRect.top);
+    m_maxScrollOffset = std::max(0, m_document->GetLayoutHeight() - viewHeight);
+    m_scrollOffset = (m_streaming && atBottom) ? m_maxScrollOffset : std::min(m_scrollOffset, m_maxScrollOffset);
+}
+
+void RichTextBox::RenderLines(HDC hdc, const RECT& textRect) {
+    const auto& spans = m_document->GetSpans();
+    size_t lineCount = m_document->GetLayoutLineCount();
     
-    // Draw text with word wrapping
-    std::wstring text = span.text;
-    for (size_t i = 0; i < text.length(); i++) {
-        wchar_t ch = text[i];
-        
-        if (ch == L'\n') {
-            y += GetLineHeight(span);
-            x = rect.left + 5;
-            continue;
-        }
+    for (size_t i = m_document->FindLayoutLine(m_scrollOffset); i < lineCount; i++) {
+        auto line = m_document->GetLayoutLine(i);
+        int lineTop = textRect.top + line.y - m_scrollOffset;
+        if (lineTop >= textRect.bottom) break;
         
-        std::wstring charStr(1, ch);
-        SIZE textSize;
-        GetTextExtentPoint32W(hdc, charStr.c_str(), 1, &textSize);
-        
-        // Word wrap
-        if (x + textSize.cx > rect.right - 5) {
-            y += GetLineHeight(span);
-            x = rect.left + 5;
+        for (size_t r = line.firstRun; r < line.firstRun + line.runCount; r++) {
+            auto run = m_document->GetLayoutRun(r);
+            const TextSpan& span = spans[run.span];
+            
+            ScopedFont font(hdc, FontCache::Get(span.fontFamily, span.fontSize, span.bold ? FW_BOLD : FW_NORMAL,
+                                                span.italic, span.underline, span.strikethrough));
+            SetTextColor(hdc, span.foregroundColor.ToCOLORREF());
+            if (span.backgroundColor.a > 0) {
+                SetBkMode(hdc, OPAQUE);
+                SetBkColor(hdc, span.backgroundColor.ToCOLORREF());
+            } else {
+                SetBkMode(hdc, TRANSPARENT);
+            }
+            
+            TextOutW(hdc, textRect.left + run.x, lineTop + run.yOffset,
+                     span.text.c_str() + run.start, static_cast<int>(run.length));
         }
-        
-        // Draw character
-        TextOutW(hdc, x, y - m_scrollOffset, charStr.c_str(), 1);
-        x += textSize.cx;
     }
-    
-    SelectObject(hdc, oldFont);
-    DeleteObject(hFont);
 }
 
-void RichTextBox::CalculateLayout() {
-    RECT bounds;
-    GetBounds(bounds);
+int RichTextBox::HitTestSpan(int x, int y) const {
+    int localX = x - m_textRect.left;
+    int localY = y - m_textRect.top + m_scrollOffset;
+    if (m_document->GetLayoutLineCount() == 0 || localY < 0) return -1;
     
-    int totalHeight = 0;
-    int y = bounds.top + 5;
+    auto line = m_document->GetLayoutLine(m_document->FindLayoutLine(localY));
+    if (localY >= line.y + line.height) return -1;
     
-    for (const auto& span : m_document->GetSpans()) {
-        totalHeight += GetLineHeight(span);
+    for (size_t r = line.firstRun; r < line.firstRun + line.runCount; r++) {
+        auto run = m_document->GetLayoutRun(r);
+        if (localX >= run.x && localX < run.x + run.width) {
+            return static_cast<int>(run.span);
+        }
     }
-    
-    m_maxScrollOffset = std::max(0, totalHeight - (bounds.bottom - bounds.top));
+    return -1;
 }
 
 void RichTextBox::HandleMouseMove(int x, int y) {
-    RECT bounds;
-    GetBounds(bounds);
-    
     if (!HitTest(x, y)) {
         m_hoveredSpanIndex = -1;
         return;
     }
     
     // Find hovered span for link highlighting
-    int currentX = bounds.left + 5;
-    int currentY = bounds.top + 5 - m_scrollOffset;
-    
     const auto& spans = m_document->GetSpans();
-    for (size_t i = 0; i < spans.size(); i++) {
-        const auto& span = spans[i];
-        
-        if (span.isLink) {
-            // Simple hit test for links
-            int spanHeight = GetLineHeight(span);
-            if (y >= currentY && y < currentY + spanHeight) {
-                m_hoveredSpanIndex = static_cast<int>(i);
-                return;
-            }
-        }
-        
-        currentY += GetLineHeight(span);
-    }
-    
-    m_hoveredSpanIndex = -1;
+    int span = HitTestSpan(x, y);
+    m_hoveredSpanIndex = (span >= 0 && span < static_cast<int>(spans.size()) && spans[span].isLink) ? span : -1;
 }
 
 void RichTextBox::HandleMouseClick(int x, int y) {
@@ -434,35 +921,29 @@ void RichTextBox::Render(HDC hdc) {
     GetBounds(bounds);
     
     // Draw background
-    HBRUSH brush = CreateSolidBrush(RGB(255, 255, 255));
+    HBRUSH brush = GdiObjectCache::GetBrush(RGB(255, 255, 255));
     FillRect(hdc, &bounds, brush);
-    DeleteObject(brush);
     
     // Draw border
     Renderer::DrawRoundedRect(hdc, bounds, 4, Color(255, 255, 255, 255), Color(180, 180, 180, 255), 1);
     
-    // Calculate layout
-    CalculateLayout();
+    // Calculate layout (only changed spans are measured again)
+    RECT textRect = { bounds.left + TEXT_PADDING, bounds.top + TEXT_PADDING,
+                      bounds.right - TEXT_PADDING, bounds.bottom - TEXT_PADDING };
+    CalculateLayout(hdc, textRect);
     
     // Set clipping region
     HRGN clipRegion = CreateRectRgn(bounds.left, bounds.top, bounds.right, bounds.bottom);
     SelectClipRgn(hdc, clipRegion);
     
-    // Render spans
-    int x = bounds.left + 5;
-    int y = bounds.top + 5;
-    
-    for (size_t i = 0; i < m_document->GetSpans().size(); i++) {
-        const auto& span = m_document->GetSpans()[i];
-        
-        // Highlight hovered links
-        if (span.isLink && m_hoveredSpanIndex == (int)i) {
-            SetCursor(LoadCursor(nullptr, IDC_HAND));
-        }
-        
-        RenderSpan(hdc, bounds, span, x, y);
+    // Highlight hovered links
+    const auto& spans = m_document->GetSpans();
+    if (m_hoveredSpanIndex >= 0 && m_hoveredSpanIndex < (int)spans.size() && spans[m_hoveredSpanIndex].isLink) {
+        SetCursor(LoadCursor(nullptr, IDC_HAND));
     }
     
+    RenderLines(hdc, textRect);
+    
     // Reset clipping
     SelectClipRgn(hdc, nullptr);
     DeleteObject(clipRegion);
@@ -470,6 +951,24 @@ void RichTextBox::Render(HDC hdc) {
     Widget::Render(hdc);
 }
 
+void RichTextBox::Update(float deltaTime) {
+    Widget::Update(deltaTime);
+    
+    // Coalesce everything queued since the last frame into one repaint
+    if (m_streaming) {
+        bool pending;
+        {
+            std::lock_guard<std::mutex> lock(m_pendingMutex);
+            pending = !m_pendingSpans.empty();
+        }
+        if (pending) {
+            FlushPendingText();
+            Invalidate();
+        }
+        ScheduleUpdate();   // Text may arrive from other threads at any time
+    }
+}
+
 void RichTextBox::HandleEvent(WidgetEvent event, void* data) {
     switch (event) {
         case WidgetEvent::MOUSE_MOVE:
@@ -504,16 +1003,8 @@ void RichTextLabel::Render(HDC hdc) {
     // Draw background (transparent for label)
     SetBkMode(hdc, TRANSPARENT);
     
-    // Calculate layout
-    CalculateLayout();
-    
-    // Render spans
-    int x = bounds.left;
-    int y = bounds.top;
-    
-    for (const auto& span : GetDocument()->GetSpans()) {
-        RenderSpan(hdc, bounds, span, x, y);
-    }
+    CalculateLayout(hdc, bounds);
+    RenderLines(hdc, bounds);
     
     Widget::Render(hdc);
 }
@@ -3,6 +3,8 @@
 #include "../../include/SDK/WindowManager.h"
 #include "../../include/SDK/DPIManager.h"
 #include "../../include/SDK/MonitorManager.h"
+#include "../../include/SDK/StartupTiming.h"
+#include "../../include/SDK/SharedAssetCache.h"
 #include <cstdlib>
 #include <ctime>
 #include <cstdio>
@@ -10,46 +12,81 @@
 namespace SDK {
 
 static bool g_bInitialized = false;
+static bool g_bAttachedAssetCache = false;     // By Initialize(), so Shutdown() detaches it
 
-bool Initialize() {
+static BOOL CALLBACK QueueThreadWindow(HWND hwnd, LPARAM) {
+    WindowManager::GetInstance().QueueWindow(hwnd);
+    return TRUE;
+}
+
+static bool InstallWindowHook(bool queueExisting) {
+    StartupTiming::Scope timing(StartupTiming::Phase::WINDOW_HOOK);
+    
+    // Try to initialize window hook (optional feature)
+    // If this fails, we continue anyway since manual registration still works
+    bool hookInitialized = WindowHook::GetInstance().Initialize();
+    if (hookInitialized) {
+        // Register callback for automatic window registration. Setup of the
+        // window is deferred until it is first used or shown.
+        WindowHook::GetInstance().RegisterCreateCallback([](HWND hwnd) {
+            WindowManager::GetInstance().QueueWindow(hwnd);
+        });
+        // A deferred hook missed the windows created before it
+        if (queueExisting) {
+            EnumThreadWindows(GetCurrentThreadId(), QueueThreadWindow, 0);
+        }
+    }
+    // Note: If hook initialization fails, applications must manually register windows
+    // using WindowManager::GetInstance().RegisterWindow(hwnd)
+    return hookInitialized;
+}
+
+bool Initialize(const InitOptions& options) {
     if (g_bInitialized) {
         return true;
     }
     
+    StartupTiming::Start();
+    StartupTiming::Scope timing(StartupTiming::Phase::INITIALIZE);
+    
     // Initialize random number generator for particle system
     srand((unsigned int)time(nullptr));
     
-    // Initialize DPI manager (v2.0)
-    if (!DPIManager::GetInstance().Initialize(DPIAwareness::PER_MONITOR_V2)) {
-        // DPI manager failed - this is critical, return false
-        return false;
+    // Before anything builds the assets it could hold
+    if (!options.sharedAssetCache.empty()) {
+        g_bAttachedAssetCache = SharedAssetCache::Attach(options.sharedAssetCache);
     }
     
-    // Initialize monitor manager (v2.0)
-    if (!MonitorManager::GetInstance().Initialize()) {
-        DPIManager::GetInstance().Shutdown();
-        // Monitor manager failed - this is critical, return false
-        return false;
+    // DPI awareness must be set before the first window exists, so this one
+    // isn't deferred (v2.0)
+    {
+        StartupTiming::Scope dpiTiming(StartupTiming::Phase::DPI_MANAGER);
+        if (!DPIManager::GetInstance().Initialize(DPIAwareness::PER_MONITOR_V2)) {
+            // DPI manager failed - this is critical, return false
+            return false;
+        }
     }
     
+    // MonitorManager enumerates the monitors on first use (v2.0)
+    
     // Initialize window manager (required)
-    if (!WindowManager::GetInstance().Initialize()) {
-        MonitorManager::GetInstance().Shutdown();
-        DPIManager::GetInstance().Shutdown();
-        return false;
+    {
+        StartupTiming::Scope windowTiming(StartupTiming::Phase::WINDOW_MANAGER);
+        if (!WindowManager::GetInstance().Initialize()) {
+            DPIManager::GetInstance().Shutdown();
+            return false;
+        }
     }
     
-    // Try to initialize window hook (optional feature)
-    // If this fails, we continue anyway since manual registration still works
-    bool hookInitialized = WindowHook::GetInstance().Initialize();
-    if (hookInitialized) {
-        // Register callback for automatic window registration
-        WindowHook::GetInstance().RegisterCreateCallback([](HWND hwnd) {
-            WindowManager::GetInstance().RegisterWindow(hwnd);
+    if (options.deferWindowHook) {
+        WindowManager::GetInstance().RunAfterFirstFrame([]() {
+            if (g_bInitialized) {
+                InstallWindowHook(true);
+            }
         });
+    } else {
+        InstallWindowHook(false);
     }
-    // Note: If hook initialization fails, applications must manually register windows
-    // using WindowManager::GetInstance().RegisterWindow(hwnd)
     
     g_bInitialized = true;
     return true;
@@ -62,8 +99,14 @@ void Shutdown() {
     
     WindowManager::GetInstance().Shutdown();
     WindowHook::GetInstance().Shutdown();
-    MonitorManager::GetInstance().Shutdown();
+    if (MonitorManager::IsStarted()) {
+        MonitorManager::GetInstance().Shutdown();
+    }
     DPIManager::GetInstance().Shutdown();
+    if (g_bAttachedAssetCache) {
+        SharedAssetCache::SetCurrent(nullptr);
+        g_bAttachedAssetCache = false;
+    }
     
     g_bInitialized = false;
 }
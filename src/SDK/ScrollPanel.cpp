@@ -0,0 +1,557 @@
+#include "../../include/SDK/ScrollPanel.h"
+#include "../../include/SDK/GdiObjectCache.h"
+#include <algorithm>
+#include <cmath>
+
+namespace SDK {
+
+namespace {
+    constexpr int DEFAULT_ESTIMATED_EXTENT = 30;
+    constexpr int DEFAULT_ITEM_SPACING = 4;
+
+    // Inset of the viewport inside the panel's border, and the strip right of
+    // it holding the scroll thumb
+    constexpr int VIEWPORT_BORDER = 2;
+    constexpr int SCROLLBAR_WIDTH = 8;
+    constexpr int SCROLL_THUMB_WIDTH = 4;
+    constexpr int MIN_THUMB_HEIGHT = 16;
+
+    // Binding measures lines, which can bring more lines into view; each
+    // pass realizes what the last one uncovered
+    constexpr int MAX_REALIZE_PASSES = 3;
+
+    constexpr int WHEEL_NOTCH = 120;
+    constexpr int WHEEL_LINES = 3;
+    // Animated scrolls close this fraction of the distance per second, exponentially
+    constexpr float SCROLL_SMOOTHING = 18.0f;
+    constexpr float SCROLL_SNAP = 0.5f;
+
+    // Line containing y; offsets are line tops, ascending
+    int FindLine(const std::vector<int>& offsets, int lineCount, int y) {
+        auto it = std::upper_bound(offsets.begin(), offsets.begin() + lineCount, y);
+        return std::max((int)(it - offsets.begin()) - 1, 0);
+    }
+
+    bool Contains(const RECT& rect, int x, int y) {
+        return x >= rect.left && x < rect.right && y >= rect.top && y < rect.bottom;
+    }
+}
+
+ScrollPanel::ScrollPanel()
+    : Panel()
+    , m_itemCount(0)
+    , m_arrangement(Arrangement::STACK)
+    , m_columns(1)
+    , m_estimatedExtent(DEFAULT_ESTIMATED_EXTENT)
+    , m_itemSpacing(DEFAULT_ITEM_SPACING)
+    , m_lineOffsetsDirty(true)
+    , m_realizedViewport{ 0, 0, 0, 0 }
+    , m_realizeDirty(true)
+    , m_scrollOffset(0.0f)
+    , m_scrollTarget(0.0f)
+    , m_draggingThumb(false)
+    , m_dragStartY(0)
+    , m_dragStartOffset(0.0f)
+    , m_stats()
+{
+}
+
+ScrollPanel::~ScrollPanel() {
+}
+
+void ScrollPanel::SetItemSource(int count, ItemFactory factory, ItemBinder binder) {
+    RecycleAll();
+    m_pool.clear();
+    m_factory = std::move(factory);
+    m_binder = std::move(binder);
+    m_itemCount = std::max(count, 0);
+    m_lineExtents.assign(GetLineCount(), -1);
+    m_lineOffsetsDirty = true;
+    m_scrollOffset = m_scrollTarget = 0.0f;
+    Realize();
+    Invalidate();
+}
+
+void ScrollPanel::SetTemplateSelector(TemplateSelector selector) {
+    m_templateSelector = std::move(selector);
+    RefreshItems();
+}
+
+void ScrollPanel::SetItemCount(int count) {
+    count = std::max(count, 0);
+    if (count == m_itemCount) {
+        RefreshItems();
+        return;
+    }
+
+    // A partly filled last line may gain items and has to be measured again
+    int columns = GetColumnCount();
+    if (count > m_itemCount && m_itemCount % columns != 0) {
+        m_lineExtents[m_itemCount / columns] = -1;
+    }
+    m_itemCount = count;
+    m_lineExtents.resize(GetLineCount(), -1);
+    m_lineOffsetsDirty = true;
+    RefreshItems();
+}
+
+void ScrollPanel::RefreshItems() {
+    RecycleAll();
+    Realize();
+    Invalidate();
+}
+
+void ScrollPanel::SetArrangement(Arrangement arrangement, int columns) {
+    columns = arrangement == Arrangement::GRID ? std::max(columns, 1) : 1;
+    if (arrangement == m_arrangement && columns == m_columns) return;
+
+    // Lines regroup, so keep the item at the top of the viewport there
+    int anchorItem = -1;
+    int anchorDelta = 0;
+    int lineCount = GetLineCount();
+    if (lineCount > 0) {
+        const std::vector<int>& offsets = GetLineOffsets();
+        int line = FindLine(offsets, lineCount, (int)m_scrollOffset);
+        anchorItem = line * GetColumnCount();
+        anchorDelta = (int)m_scrollOffset - offsets[line];
+    }
+
+    RecycleAll();
+    m_arrangement = arrangement;
+    m_columns = columns;
+    m_lineExtents.assign(GetLineCount(), -1);
+    m_lineOffsetsDirty = true;
+    if (anchorItem >= 0) {
+        m_scrollOffset = m_scrollTarget = (float)(GetLineOffsets()[anchorItem / GetColumnCount()] + anchorDelta);
+    }
+    Realize();
+    Invalidate();
+}
+
+void ScrollPanel::SetEstimatedItemExtent(int extent) {
+    extent = std::max(extent, 1);
+    if (extent == m_estimatedExtent) return;
+
+    m_estimatedExtent = extent;
+    m_lineOffsetsDirty = true;
+    Realize();
+    Invalidate();
+}
+
+void ScrollPanel::SetItemSpacing(int spacing) {
+    spacing = std::max(spacing, 0);
+    if (spacing == m_itemSpacing) return;
+
+    m_itemSpacing = spacing;
+    m_lineOffsetsDirty = true;
+    Realize();
+    Invalidate();
+}
+
+void ScrollPanel::SetScrollOffset(int offset, bool animate) {
+    SetScrollPosition((float)offset, animate);
+}
+
+void ScrollPanel::SetScrollPosition(float offset, bool animate) {
+    offset = std::min(std::max(offset, 0.0f), (float)GetMaxScroll());
+    m_scrollTarget = offset;
+    if (animate) {
+        ScheduleUpdate();
+        return;
+    }
+    if (offset == m_scrollOffset) return;
+
+    m_scrollOffset = offset;
+    Realize();
+    Invalidate();
+}
+
+int ScrollPanel::GetContentExtent() const {
+    return GetLineOffsets()[GetLineCount()];
+}
+
+int ScrollPanel::GetViewportExtent() const {
+    RECT viewport = GetViewportRect();
+    return viewport.bottom - viewport.top;
+}
+
+void ScrollPanel::ScrollToItem(int index, bool animate) {
+    if (m_itemCount == 0) return;
+
+    index = std::min(std::max(index, 0), m_itemCount - 1);
+    SetScrollPosition((float)GetLineOffsets()[index / GetColumnCount()], animate);
+}
+
+void ScrollPanel::EnsureItemVisible(int index, bool animate) {
+    if (m_itemCount == 0) return;
+
+    index = std::min(std::max(index, 0), m_itemCount - 1);
+    int line = index / GetColumnCount();
+    int top = GetLineOffsets()[line];
+    int bottom = top + GetLineExtent(line);
+    int viewportExtent = GetViewportExtent();
+    if (top < m_scrollTarget) {
+        SetScrollPosition((float)top, animate);
+    } else if (bottom > m_scrollTarget + viewportExtent) {
+        SetScrollPosition((float)(bottom - viewportExtent), animate);
+    }
+}
+
+Widget* ScrollPanel::GetItemWidget(int index) const {
+    auto it = std::lower_bound(m_realized.begin(), m_realized.end(), index,
+                               [](const RealizedItem& item, int value) { return item.index < value; });
+    return it != m_realized.end() && it->index == index ? it->widget.get() : nullptr;
+}
+
+ScrollPanel::Stats ScrollPanel::GetStats() const {
+    Stats stats = m_stats;
+    stats.realized = m_realized.size();
+    stats.pooled = 0;
+    for (const auto& pool : m_pool) {
+        stats.pooled += pool.second.size();
+    }
+    return stats;
+}
+
+void ScrollPanel::ResetStats() {
+    m_stats = Stats();
+}
+
+RECT ScrollPanel::GetViewportRect() const {
+    RECT bounds;
+    GetBounds(bounds);
+
+    const WidgetStyle& style = GetStyle();
+    RECT viewport;
+    viewport.left = bounds.left + VIEWPORT_BORDER + style.paddingLeft;
+    viewport.top = bounds.top + std::max(GetTitleBarHeight(), VIEWPORT_BORDER) + style.paddingTop;
+    viewport.right = bounds.right - VIEWPORT_BORDER - style.paddingRight - SCROLLBAR_WIDTH;
+    viewport.bottom = bounds.bottom - VIEWPORT_BORDER - style.paddingBottom;
+    viewport.right = std::max(viewport.right, viewport.left);
+    viewport.bottom = std::max(viewport.bottom, viewport.top);
+    return viewport;
+}
+
+bool ScrollPanel::GetScrollTrack(RECT& track) const {
+    if (GetMaxScroll() <= 0) return false;
+
+    RECT viewport = GetViewportRect();
+    track = {viewport.right, viewport.top, viewport.right + SCROLLBAR_WIDTH, viewport.bottom};
+    return track.bottom > track.top;
+}
+
+RECT ScrollPanel::GetThumbRect(const RECT& track) const {
+    int trackHeight = track.bottom - track.top;
+    int content = std::max(GetContentExtent(), 1);
+    int thumbHeight = (int)((long long)trackHeight * GetViewportExtent() / content);
+    thumbHeight = std::min(std::max(thumbHeight, MIN_THUMB_HEIGHT), trackHeight);
+
+    int maxScroll = std::max(GetMaxScroll(), 1);
+    int thumbTop = track.top + (int)((trackHeight - thumbHeight) * std::min(m_scrollOffset / maxScroll, 1.0f));
+    return {track.left, thumbTop, track.right, thumbTop + thumbHeight};
+}
+
+int ScrollPanel::GetLineCount() const {
+    int columns = GetColumnCount();
+    return (m_itemCount + columns - 1) / columns;
+}
+
+int ScrollPanel::GetLineExtent(int line) const {
+    int extent = m_lineExtents[line];
+    return extent < 0 ? m_estimatedExtent : extent;
+}
+
+const std::vector<int>& ScrollPanel::GetLineOffsets() const {
+    if (m_lineOffsetsDirty) {
+        int lineCount = GetLineCount();
+        m_lineOffsets.resize(lineCount + 1);
+        int offset = 0;
+        for (int line = 0; line < lineCount; line++) {
+            m_lineOffsets[line] = offset;
+            offset += GetLineExtent(line) + m_itemSpacing;
+        }
+        m_lineOffsets[lineCount] = lineCount > 0 ? offset - m_itemSpacing : 0;
+        m_lineOffsetsDirty = false;
+    }
+    return m_lineOffsets;
+}
+
+int ScrollPanel::GetMaxScroll() const {
+    return std::max(GetContentExtent() - GetViewportExtent(), 0);
+}
+
+int ScrollPanel::GetLineStep() const {
+    return m_estimatedExtent + m_itemSpacing;
+}
+
+int ScrollPanel::GetColumnWidth(const RECT& viewport) const {
+    int columns = GetColumnCount();
+    return std::max((int)(viewport.right - viewport.left - m_itemSpacing * (columns - 1)) / columns, 0);
+}
+
+void ScrollPanel::Realize() {
+    RECT viewport = GetViewportRect();
+    m_realizedViewport = viewport;
+
+    // Collapsing hides the children and restores them by position; leave them be
+    if (IsCollapsed()) {
+        m_realizeDirty = true;
+        return;
+    }
+    m_realizeDirty = false;
+
+    int viewportExtent = viewport.bottom - viewport.top;
+    int lineCount = GetLineCount();
+    if (!m_factory || lineCount == 0 || viewportExtent <= 0) {
+        RecycleAll();
+        m_scrollOffset = m_scrollTarget = 0.0f;
+        return;
+    }
+
+    int columns = GetColumnCount();
+    int columnWidth = GetColumnWidth(viewport);
+    for (int pass = 0; pass < MAX_REALIZE_PASSES; pass++) {
+        float maxScroll = (float)GetMaxScroll();
+        m_scrollOffset = std::min(m_scrollOffset, maxScroll);
+        m_scrollTarget = std::min(m_scrollTarget, maxScroll);
+
+        const std::vector<int>& offsets = GetLineOffsets();
+        int scroll = (int)m_scrollOffset;
+        int firstLine = FindLine(offsets, lineCount, scroll);
+        int lastLine = std::max(FindLine(offsets, lineCount, scroll + viewportExtent - 1), firstLine);
+        RealizeRange(firstLine * columns, std::min((lastLine + 1) * columns, m_itemCount) - 1, columnWidth);
+
+        // A line is as tall as its tallest item
+        bool measured = false;
+        size_t i = 0;
+        while (i < m_realized.size()) {
+            int line = m_realized[i].index / columns;
+            int extent = 0;
+            for (; i < m_realized.size() && m_realized[i].index / columns == line; i++) {
+                int width, height;
+                m_realized[i].widget->GetSize(width, height);
+                extent = std::max(extent, height);
+            }
+            if (m_lineExtents[line] != extent) {
+                m_lineExtents[line] = extent;
+                measured = true;
+            }
+        }
+        if (!measured) break;
+        m_lineOffsetsDirty = true;
+    }
+
+    PlaceItems(viewport);
+}
+
+void ScrollPanel::RealizeRange(int first, int last, int columnWidth) {
+    // Keep what stays in view, pool the rest, then fill the gaps from the pools
+    m_realizeScratch.clear();
+    for (auto& item : m_realized) {
+        if (item.index >= first && item.index <= last) {
+            m_realizeScratch.push_back(std::move(item));
+        } else {
+            RemoveChild(item.widget);
+            m_pool[item.templateId].push_back(std::move(item.widget));
+            m_stats.recycled++;
+        }
+    }
+    m_realized.clear();
+
+    size_t kept = 0;
+    for (int index = first; index <= last; index++) {
+        // Collapsing hides children, including ones later pooled
+        if (kept < m_realizeScratch.size() && m_realizeScratch[kept].index == index) {
+            m_realizeScratch[kept].widget->SetVisible(true);
+            m_realized.push_back(std::move(m_realizeScratch[kept++]));
+            continue;
+        }
+
+        int templateId = m_templateSelector ? m_templateSelector(index) : 0;
+        std::shared_ptr<Widget> widget;
+        auto& pool = m_pool[templateId];
+        if (!pool.empty()) {
+            widget = std::move(pool.back());
+            pool.pop_back();
+        } else {
+            widget = m_factory(templateId);
+            if (!widget) continue;
+            m_stats.created++;
+        }
+
+        // Width first, so binders can size the height to it
+        int width, height;
+        widget->GetSize(width, height);
+        widget->SetSize(columnWidth, height);
+        widget->SetVisible(true);
+        if (m_binder) {
+            m_binder(*widget, index);
+            m_stats.bound++;
+        }
+
+        // Widget::AddChild: Panel's would clamp the item inside the panel
+        Widget::AddChild(widget);
+        m_realized.push_back({index, templateId, std::move(widget)});
+    }
+    m_realizeScratch.clear();
+}
+
+void ScrollPanel::RecycleAll() {
+    for (auto& item : m_realized) {
+        RemoveChild(item.widget);
+        m_pool[item.templateId].push_back(std::move(item.widget));
+        m_stats.recycled++;
+    }
+    m_realized.clear();
+}
+
+void ScrollPanel::PlaceItems(const RECT& viewport) {
+    const std::vector<int>& offsets = GetLineOffsets();
+    int columns = GetColumnCount();
+    int columnWidth = GetColumnWidth(viewport);
+    int scroll = (int)m_scrollOffset;
+
+    for (const auto& item : m_realized) {
+        int line = item.index / columns;
+        int column = item.index % columns;
+        int width, height;
+        item.widget->GetSize(width, height);
+        item.widget->SetBounds(viewport.left + column * (columnWidth + m_itemSpacing),
+                               viewport.top + offsets[line] - scroll, columnWidth, height);
+    }
+}
+
+void ScrollPanel::Update(float deltaTime) {
+    Widget::Update(deltaTime);
+
+    if (m_scrollOffset != m_scrollTarget) {
+        float step = 1.0f - std::exp(-SCROLL_SMOOTHING * deltaTime);
+        m_scrollOffset += (m_scrollTarget - m_scrollOffset) * step;
+        if (std::fabs(m_scrollTarget - m_scrollOffset) < SCROLL_SNAP) {
+            m_scrollOffset = m_scrollTarget;
+        }
+        Realize();
+        Invalidate();
+    }
+
+    if (m_scrollOffset != m_scrollTarget) {
+        ScheduleUpdate();
+    }
+}
+
+void ScrollPanel::Render(HDC hdc) {
+    if (!m_visible) return;
+
+    // Resizes don't reach the panel, so they're caught here
+    RECT viewport = GetViewportRect();
+    if (m_realizeDirty || !EqualRect(&viewport, &m_realizedViewport)) {
+        Realize();
+    }
+
+    if (!RenderChrome(hdc)) return;
+
+    if (viewport.right > viewport.left && viewport.bottom > viewport.top) {
+        int saved = SaveDC(hdc);
+        IntersectClipRect(hdc, viewport.left, viewport.top, viewport.right, viewport.bottom);
+        Widget::Render(hdc);
+        RestoreDC(hdc, saved);
+    }
+
+    RECT track;
+    if (GetScrollTrack(track)) {
+        RECT thumb = GetThumbRect(track);
+        thumb.left += (SCROLLBAR_WIDTH - SCROLL_THUMB_WIDTH) / 2;
+        thumb.right = thumb.left + SCROLL_THUMB_WIDTH;
+        HBRUSH brush = GdiObjectCache::GetBrush(m_draggingThumb ? RGB(140, 140, 140) : RGB(180, 180, 180));
+        FillRect(hdc, &thumb, brush);
+    }
+}
+
+bool ScrollPanel::HandleMouseMove(int x, int y) {
+    if (m_draggingThumb) {
+        RECT track;
+        if (GetScrollTrack(track)) {
+            RECT thumb = GetThumbRect(track);
+            int span = (track.bottom - track.top) - (thumb.bottom - thumb.top);
+            if (span > 0) {
+                SetScrollPosition(m_dragStartOffset + (float)(y - m_dragStartY) * GetMaxScroll() / span, false);
+            }
+        }
+        return true;
+    }
+    return Panel::HandleMouseMove(x, y);
+}
+
+bool ScrollPanel::HandleMouseDown(int x, int y, int button) {
+    if (!m_visible || !m_enabled) return false;
+
+    // Thumb drags; the track either side of it pages
+    RECT track;
+    if (button == 0 && GetScrollTrack(track) && Contains(track, x, y)) {
+        RECT thumb = GetThumbRect(track);
+        if (y >= thumb.top && y < thumb.bottom) {
+            m_draggingThumb = true;
+            m_dragStartY = y;
+            m_dragStartOffset = m_scrollOffset;
+            Invalidate();
+        } else {
+            float page = (float)GetViewportExtent();
+            SetScrollPosition(m_scrollTarget + (y < thumb.top ? -page : page), true);
+        }
+        return true;
+    }
+
+    // Items are clipped to the viewport, and so are clicks on them
+    if (Contains(GetViewportRect(), x, y)) {
+        return Panel::HandleMouseDown(x, y, button);
+    }
+    if (IsCollapsible() && GetTitleBarHeight() > 0 && Contains(GetCollapseButtonRect(), x, y)) {
+        ToggleCollapsed();
+        return true;
+    }
+    return HitTest(x, y);
+}
+
+bool ScrollPanel::HandleMouseUp(int x, int y, int button) {
+    if (m_draggingThumb) {
+        m_draggingThumb = false;
+        Invalidate();
+        return true;
+    }
+    if (Contains(GetViewportRect(), x, y)) {
+        return Panel::HandleMouseUp(x, y, button);
+    }
+    return m_visible && HitTest(x, y);
+}
+
+bool ScrollPanel::HandleMouseWheel(int x, int y, int delta) {
+    if (!m_visible || !m_enabled || !HitTest(x, y)) return false;
+
+    // Nested scrollers under the mouse go first; an unscrollable panel passes
+    if (Contains(GetViewportRect(), x, y) && Widget::HandleMouseWheel(x, y, delta)) {
+        return true;
+    }
+    if (GetMaxScroll() <= 0) return false;
+
+    float lines = -(float)delta / WHEEL_NOTCH * WHEEL_LINES;
+    SetScrollPosition(m_scrollTarget + lines * GetLineStep(), true);
+    return true;
+}
+
+bool ScrollPanel::HandleKeyDown(int keyCode) {
+    if (!m_visible || !m_enabled || !m_focused) return false;
+
+    float line = (float)GetLineStep();
+    float page = (float)GetViewportExtent();
+    switch (keyCode) {
+        case VK_UP:     SetScrollPosition(m_scrollTarget - line, true); return true;
+        case VK_DOWN:   SetScrollPosition(m_scrollTarget + line, true); return true;
+        case VK_PRIOR:  SetScrollPosition(m_scrollTarget - page, true); return true;
+        case VK_NEXT:   SetScrollPosition(m_scrollTarget + page, true); return true;
+        case VK_HOME:   SetScrollPosition(0.0f, true); return true;
+        case VK_END:    SetScrollPosition((float)GetMaxScroll(), true); return true;
+        default:        return Panel::HandleKeyDown(keyCode);
+    }
+}
+
+} // namespace SDK
@@ -0,0 +1,365 @@
+#include "../../include/SDK/ShadowCache.h"
+#include "../../include/SDK/PixelKernels.h"
+#include "../../include/SDK/MemoryRegistry.h"
+#include "../../include/SDK/SharedAssetCache.h"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace SDK {
+
+namespace {
+    constexpr size_t DEFAULT_CAPACITY = 32;
+    constexpr int CORNER_SUPERSAMPLE = 4;
+
+    struct CacheEntry {
+        std::shared_ptr<const ShadowCache::NineSlice> tile;
+        uint64_t lastUse;
+    };
+
+    std::mutex g_cacheMutex;
+    std::unordered_map<std::string, CacheEntry> g_cache;
+    size_t g_capacity = DEFAULT_CAPACITY;
+    uint64_t g_clock = 0;
+    uint64_t g_hits = 0;
+    uint64_t g_misses = 0;
+
+    std::string MakeKey(ShadowCache::Kind kind, int extent, int cornerRadius, Color color) {
+        std::string key;
+        key.push_back((char)kind);
+        key.append(reinterpret_cast<const char*>(&extent), sizeof(extent));
+        key.append(reinterpret_cast<const char*>(&cornerRadius), sizeof(cornerRadius));
+        key.push_back((char)color.r);
+        key.push_back((char)color.g);
+        key.push_back((char)color.b);
+        key.push_back((char)color.a);
+        return key;
+    }
+
+    void EvictOldest() {
+        auto oldest = g_cache.begin();
+        for (auto it = g_cache.begin(); it != g_cache.end(); ++it) {
+            if (it->second.lastUse < oldest->second.lastUse) oldest = it;
+        }
+        if (oldest != g_cache.end()) g_cache.erase(oldest);
+    }
+
+    size_t GetBytes() {
+        size_t bytes = 0;
+        for (const auto& entry : g_cache) {
+            bytes += entry.second.tile->pixels.capacity() * sizeof(uint32_t);
+        }
+        return bytes;
+    }
+
+    // Tiles still drawn elsewhere stay alive until released, like any evicted tile
+    MemoryRegistry::Source g_memorySource("ShadowCache",
+        []() {
+            std::lock_guard<std::mutex> lock(g_cacheMutex);
+            return GetBytes();
+        },
+        [](size_t targetBytes) {
+            std::lock_guard<std::mutex> lock(g_cacheMutex);
+            while (!g_cache.empty() && GetBytes() > targetBytes) {
+                EvictOldest();
+            }
+        });
+
+    inline uint32_t Premultiply(Color color, int coverage) {
+        uint32_t a = (uint32_t)(color.a * coverage / 255);
+        uint32_t r = color.r * a / 255;
+        uint32_t g = color.g * a / 255;
+        uint32_t b = color.b * a / 255;
+        return (a << 24) | (r << 16) | (g << 8) | b;
+    }
+
+    // Coverage (0-255) of a pixel by a rounded rect, supersampled near the corners
+    int RoundedRectCoverage(int x, int y, int left, int top, int right, int bottom, int radius) {
+        if (x < left || x >= right || y < top || y >= bottom) return 0;
+        if (radius <= 0) return 255;
+
+        float cx = (float)std::min(std::max(x, left + radius), right - radius);
+        float cy = (float)std::min(std::max(y, top + radius), bottom - radius);
+        bool inCorner = (x < left + radius || x >= right - radius) && (y < top + radius || y >= bottom - radius);
+        if (!inCorner) return 255;
+
+        int inside = 0;
+        for (int sy = 0; sy < CORNER_SUPERSAMPLE; sy++) {
+            for (int sx = 0; sx < CORNER_SUPERSAMPLE; sx++) {
+                float px = x + (sx + 0.5f) / CORNER_SUPERSAMPLE;
+                float py = y + (sy + 0.5f) / CORNER_SUPERSAMPLE;
+                float dx = px - cx;
+                float dy = py - cy;
+                if (dx * dx + dy * dy <= (float)(radius * radius)) inside++;
+            }
+        }
+        return inside * 255 / (CORNER_SUPERSAMPLE * CORNER_SUPERSAMPLE);
+    }
+
+    std::shared_ptr<ShadowCache::NineSlice> RasterizeShadow(int blur, int cornerRadius, Color color) {
+        auto tile = std::make_shared<ShadowCache::NineSlice>();
+        tile->kind = ShadowCache::Kind::SHADOW;
+        tile->extent = blur;
+        tile->cornerRadius = cornerRadius;
+        tile->slice = blur + std::max(blur, cornerRadius) + 1;
+        tile->size = tile->slice * 2 + 1;
+
+        // Rasterize with a blur-sized margin so the kernel never reads past the tile
+        int pad = blur;
+        int padded = tile->size + pad * 2;
+        int shapeMin = pad + blur;
+        int shapeMax = pad + tile->size - blur;
+
+        std::vector<uint32_t> mask((size_t)padded * padded, 0);
+        for (int y = 0; y < padded; y++) {
+            for (int x = 0; x < padded; x++) {
+                mask[(size_t)y * padded + x] = (uint32_t)RoundedRectCoverage(x, y, shapeMin, shapeMin, shapeMax, shapeMax, cornerRadius);
+            }
+        }
+
+        // Three box passes with sigma = blur / 3 reach roughly blur pixels outward
+        if (blur > 0) {
+            PixelKernels::GaussianBlur(mask.data(), padded, padded, padded, blur / 3.0f);
+        }
+
+        tile->pixels.resize((size_t)tile->size * tile->size);
+        for (int y = 0; y < tile->size; y++) {
+            for (int x = 0; x < tile->size; x++) {
+                int coverage = (int)(mask[(size_t)(y + pad) * padded + (x + pad)] & 0xFF);
+                tile->pixels[(size_t)y * tile->size + x] = Premultiply(color, coverage);
+            }
+        }
+        return tile;
+    }
+
+    std::shared_ptr<ShadowCache::NineSlice> RasterizeGlow(int radius, Color color) {
+        auto tile = std::make_shared<ShadowCache::NineSlice>();
+        tile->kind = ShadowCache::Kind::GLOW;
+        tile->extent = radius;
+        tile->cornerRadius = 0;
+        tile->slice = radius + 1;
+        tile->size = tile->slice * 2 + 1;
+
+        // Full color on the rect border, fading linearly to nothing at radius
+        int innerMin = radius;
+        int innerMax = tile->size - radius - 1;
+        tile->pixels.resize((size_t)tile->size * tile->size);
+        for (int y = 0; y < tile->size; y++) {
+            for (int x = 0; x < tile->size; x++) {
+                int dx = std::max(std::max(innerMin - x, x - innerMax), 0);
+                int dy = std::max(std::max(innerMin - y, y - innerMax), 0);
+                int distance = std::max(dx, dy);
+
+                bool interior = x > innerMin && x < innerMax && y > innerMin && y < innerMax;
+                int coverage = interior ? 0 : 255 * (radius - distance) / std::max(radius, 1);
+                tile->pixels[(size_t)y * tile->size + x] = Premultiply(color, std::max(coverage, 0));
+            }
+        }
+        return tile;
+    }
+
+    // A tile in a SharedAssetCache: this header, then size * size pixels
+    constexpr const char* SHARED_KEY_PREFIX = "ShadowCache:";
+    struct SharedTileHeader {
+        int32_t kind;
+        int32_t extent;
+        int32_t cornerRadius;
+        int32_t slice;
+        int32_t size;
+        int32_t reserved[3];    // Keeps the pixels 16-byte aligned
+    };
+
+    std::shared_ptr<const ShadowCache::NineSlice> LoadShared(const std::string& key) {
+        SharedAssetCache::Blob blob;
+        SharedTileHeader header;
+        if (!SharedAssetCache::FindCurrent(SHARED_KEY_PREFIX + key, blob) || blob.size < sizeof(header)) return nullptr;
+        std::memcpy(&header, blob.data, sizeof(header));
+        bool knownKind = header.kind == (int32_t)ShadowCache::Kind::SHADOW || header.kind == (int32_t)ShadowCache::Kind::GLOW;
+        if (!knownKind || header.size <= 0 || header.slice * 2 + 1 != header.size ||
+            (blob.size - sizeof(header)) / sizeof(uint32_t) != (size_t)header.size * header.size) {
+            return nullptr;
+        }
+
+        auto tile = std::make_shared<ShadowCache::NineSlice>();
+        tile->kind = (ShadowCache::Kind)header.kind;
+        tile->extent = header.extent;
+        tile->cornerRadius = header.cornerRadius;
+        tile->slice = header.slice;
+        tile->size = header.size;
+        const uint32_t* pixels = (const uint32_t*)((const unsigned char*)blob.data + sizeof(header));
+        tile->pixels.assign(pixels, pixels + (size_t)header.size * header.size);
+        return tile;
+    }
+
+    template<typename Rasterize>
+    std::shared_ptr<const ShadowCache::NineSlice> GetOrCreate(const std::string& key, Rasterize rasterize) {
+        {
+            std::lock_guard<std::mutex> lock(g_cacheMutex);
+            auto it = g_cache.find(key);
+            if (it != g_cache.end()) {
+                it->second.lastUse = ++g_clock;
+                g_hits++;
+                return it->second.tile;
+            }
+            g_misses++;
+        }
+
+        std::shared_ptr<const ShadowCache::NineSlice> tile = LoadShared(key);
+        if (!tile) tile = rasterize();
+
+        std::lock_guard<std::mutex> lock(g_cacheMutex);
+        if (g_capacity == 0) return tile;
+        // Another thread may have rasterized the same tile meanwhile
+        auto it = g_cache.find(key);
+        if (it != g_cache.end()) {
+            it->second.lastUse = ++g_clock;
+            return it->second.tile;
+        }
+        while (g_cache.size() >= g_capacity) {
+            EvictOldest();
+        }
+        g_cache[key] = { tile, ++g_clock };
+        return tile;
+    }
+}
+
+std::shared_ptr<const ShadowCache::NineSlice> ShadowCache::GetShadow(int blur, int cornerRadius, Color color) {
+    blur = std::max(0, blur);
+    cornerRadius = std::max(0, cornerRadius);
+    return GetOrCreate(MakeKey(Kind::SHADOW, blur, cornerRadius, color), [&]() {
+        return RasterizeShadow(blur, cornerRadius, color);
+    });
+}
+
+std::shared_ptr<const ShadowCache::NineSlice> ShadowCache::GetGlow(int radius, Color color) {
+    radius = std::max(0, radius);
+    return GetOrCreate(MakeKey(Kind::GLOW, radius, 0, color), [&]() {
+        return RasterizeGlow(radius, color);
+    });
+}
+
+size_t ShadowCache::ExportShared(SharedAssetCache& cache) {
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    size_t added = 0;
+    std::vector<unsigned char> blob;
+    for (const auto& entry : g_cache) {
+        const NineSlice& tile = *entry.second.tile;
+        SharedTileHeader header = { (int32_t)tile.kind, tile.extent, tile.cornerRadius, tile.slice, tile.size, {} };
+        blob.resize(sizeof(header) + tile.pixels.size() * sizeof(uint32_t));
+        std::memcpy(blob.data(), &header, sizeof(header));
+        std::memcpy(blob.data() + sizeof(header), tile.pixels.data(), tile.pixels.size() * sizeof(uint32_t));
+        if (cache.Add(SHARED_KEY_PREFIX + entry.first, blob.data(), blob.size())) added++;
+    }
+    return added;
+}
+
+RECT ShadowCache::GetOuterRect(const NineSlice& tile, const RECT& shapeRect) {
+    RECT outer = shapeRect;
+    outer.left -= tile.extent;
+    outer.top -= tile.extent;
+    outer.right += tile.extent;
+    outer.bottom += tile.extent;
+    return outer;
+}
+
+ShadowCache::SliceSpans ShadowCache::ComputeSpans(const NineSlice& tile, int outerLength) {
+    SliceSpans spans;
+    int lead = std::min(tile.slice, outerLength / 2);
+    int trail = std::min(tile.slice, outerLength - lead);
+    int middle = outerLength - lead - trail;
+
+    spans.dstStart[0] = 0;
+    spans.dstLength[0] = lead;
+    spans.srcStart[0] = 0;
+    spans.srcLength[0] = lead;
+
+    spans.dstStart[1] = lead;
+    spans.dstLength[1] = middle;
+    spans.srcStart[1] = tile.slice;
+    spans.srcLength[1] = 1;
+
+    spans.dstStart[2] = outerLength - trail;
+    spans.dstLength[2] = trail;
+    spans.srcStart[2] = tile.size - trail;
+    spans.srcLength[2] = trail;
+    return spans;
+}
+
+void ShadowCache::Composite(const NineSlice& tile, const RECT& shapeRect,
+                            uint32_t* pixels, int bufferLeft, int bufferTop,
+                            int width, int height, int stride) {
+    if (!pixels || tile.pixels.empty()) return;
+
+    RECT outer = GetOuterRect(tile, shapeRect);
+    int outerWidth = outer.right - outer.left;
+    int outerHeight = outer.bottom - outer.top;
+    if (outerWidth <= 0 || outerHeight <= 0) return;
+
+    // Map each destination column/row of the outer rect to its tile source
+    auto buildMap = [&](int outerLength) {
+        SliceSpans spans = ComputeSpans(tile, outerLength);
+        std::vector<int> map((size_t)outerLength);
+        for (int s = 0; s < 3; s++) {
+            for (int i = 0; i < spans.dstLength[s]; i++) {
+                map[spans.dstStart[s] + i] = spans.srcStart[s] + (spans.srcLength[s] == 1 ? 0 : i);
+            }
+        }
+        return map;
+    };
+    std::vector<int> columns = buildMap(outerWidth);
+    std::vector<int> rows = buildMap(outerHeight);
+
+    int x0 = std::max((int)outer.left, bufferLeft);
+    int y0 = std::max((int)outer.top, bufferTop);
+    int x1 = std::min((int)outer.right, bufferLeft + width);
+    int y1 = std::min((int)outer.bottom, bufferTop + height);
+
+    if (x1 <= x0 || y1 <= y0) return;
+
+    // Gather each mapped source row, then blend it with the SIMD kernel
+    std::vector<uint32_t> row((size_t)(x1 - x0));
+    for (int y = y0; y < y1; y++) {
+        const uint32_t* src = tile.pixels.data() + (size_t)rows[y - outer.top] * tile.size;
+        for (int x = x0; x < x1; x++) {
+            row[x - x0] = src[columns[x - outer.left]];
+        }
+        PixelKernels::BlendOver(pixels + (size_t)(y - bufferTop) * stride + (x0 - bufferLeft), row.data(), row.size());
+    }
+}
+
+void ShadowCache::SetCapacity(size_t maxTiles) {
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    g_capacity = maxTiles;
+    while (g_cache.size() > g_capacity) {
+        EvictOldest();
+    }
+}
+
+void ShadowCache::Clear() {
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    g_cache.clear();
+}
+
+size_t ShadowCache::GetSize() {
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    return g_cache.size();
+}
+
+ShadowCache::Stats ShadowCache::GetStats() {
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    Stats stats;
+    stats.hits = g_hits;
+    stats.misses = g_misses;
+    stats.size = g_cache.size();
+    return stats;
+}
+
+void ShadowCache::ResetStats() {
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    g_hits = 0;
+    g_misses = 0;
+}
+
+} // namespace SDK
@@ -0,0 +1,319 @@
+#include "../../include/SDK/SharedAssetCache.h"
+#include "../../include/SDK/StringUtils.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+
+#if !SDK_PLATFORM_WINDOWS
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace SDK {
+
+struct SharedAssetCache::Entry {
+    uint64_t hash;
+    uint64_t keyOffset;
+    uint64_t dataOffset;
+    uint64_t dataSize;
+    uint32_t keyLength;
+    uint32_t reserved;
+};
+
+namespace {
+    constexpr uint32_t CACHE_MAGIC = 0x43413544;    // "D5AC"
+    constexpr size_t DATA_ALIGNMENT = 16;
+
+    // At the start of the section; published is written last
+    struct CacheHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t capacity;
+        uint64_t dataEnd;           // Bytes in use, header included
+        uint64_t entriesOffset;
+        uint64_t entryCount;
+        uint32_t published;
+        uint32_t reserved[5];
+    };
+    static_assert(sizeof(CacheHeader) == 64, "header keeps the data aligned");
+
+    uint64_t HashKey(std::string_view key) {
+        uint64_t hash = 1469598103934665603ull;     // FNV-1a
+        for (char c : key) {
+            hash = (hash ^ (unsigned char)c) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+    size_t AlignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    std::mutex g_currentMutex;
+    std::shared_ptr<const SharedAssetCache> g_current;
+    std::atomic<uint64_t> g_hits(0);
+    std::atomic<uint64_t> g_misses(0);
+}
+
+SharedAssetCache::SharedAssetCache()
+    : m_base(nullptr)
+    , m_capacity(0)
+    , m_entryCount(0)
+    , m_entries(nullptr)
+    , m_writable(false)
+    , m_published(false)
+#if SDK_PLATFORM_WINDOWS
+    , m_mapping(nullptr)
+#else
+    , m_fd(-1)
+#endif
+{
+}
+
+SharedAssetCache::~SharedAssetCache() {
+    Unmap();
+}
+
+std::unique_ptr<SharedAssetCache> SharedAssetCache::Create(const std::wstring& name, size_t capacity) {
+    if (name.empty() || capacity < sizeof(CacheHeader)) return nullptr;
+
+    std::unique_ptr<SharedAssetCache> cache(new SharedAssetCache());
+    if (!cache->Map(name, capacity, true)) return nullptr;
+
+    CacheHeader header = {};
+    header.magic = CACHE_MAGIC;
+    header.version = FORMAT_VERSION;
+    header.capacity = capacity;
+    header.dataEnd = sizeof(CacheHeader);
+    std::memcpy(cache->m_base, &header, sizeof(header));
+    return cache;
+}
+
+std::shared_ptr<const SharedAssetCache> SharedAssetCache::Open(const std::wstring& name) {
+    if (name.empty()) return nullptr;
+
+    std::shared_ptr<SharedAssetCache> cache(new SharedAssetCache());
+    if (!cache->Map(name, 0, false) || !cache->Validate()) return nullptr;
+    return cache;
+}
+
+bool SharedAssetCache::Map(const std::wstring& name, size_t capacity, bool create) {
+#if SDK_PLATFORM_WINDOWS
+    std::wstring fullName = L"Local\\5DGUI." + name;
+    if (create) {
+        uint64_t size = capacity;
+        m_mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                       (DWORD)(size >> 32), (DWORD)size, fullName.c_str());
+        // Another process already publishes under this name
+        if (m_mapping && GetLastError() == ERROR_ALREADY_EXISTS) {
+            CloseHandle(m_mapping);
+            m_mapping = nullptr;
+        }
+    } else {
+        m_mapping = OpenFileMappingW(FILE_MAP_READ, FALSE, fullName.c_str());
+    }
+    if (!m_mapping) return false;
+
+    m_base = (unsigned char*)MapViewOfFile(m_mapping, create ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0);
+    if (!m_base) return false;
+    if (!create) {
+        MEMORY_BASIC_INFORMATION info;
+        if (!VirtualQuery(m_base, &info, sizeof(info))) return false;
+        capacity = info.RegionSize;
+    }
+#else
+    std::string fullName = "/5DGUI." + WStringToUTF8(name);
+    if (create) {
+        shm_unlink(fullName.c_str());
+        m_fd = shm_open(fullName.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (m_fd < 0) return false;
+        m_unlinkName = fullName;
+        if (ftruncate(m_fd, (off_t)capacity) != 0) return false;
+    } else {
+        m_fd = shm_open(fullName.c_str(), O_RDONLY, 0);
+        if (m_fd < 0) return false;
+        struct stat info;
+        if (fstat(m_fd, &info) != 0 || info.st_size <= 0) return false;
+        capacity = (size_t)info.st_size;
+    }
+
+    void* view = mmap(nullptr, capacity, create ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, m_fd, 0);
+    if (view == MAP_FAILED) return false;
+    m_base = (unsigned char*)view;
+#endif
+    m_capacity = capacity;
+    m_writable = create;
+    return true;
+}
+
+void SharedAssetCache::Unmap() {
+#if SDK_PLATFORM_WINDOWS
+    if (m_base) UnmapViewOfFile(m_base);
+    if (m_mapping) CloseHandle(m_mapping);
+    m_mapping = nullptr;
+#else
+    if (m_base) munmap(m_base, m_capacity);
+    if (m_fd >= 0) close(m_fd);
+    if (!m_unlinkName.empty()) shm_unlink(m_unlinkName.c_str());
+    m_fd = -1;
+    m_unlinkName.clear();
+#endif
+    m_base = nullptr;
+    m_entries = nullptr;
+}
+
+// Everything Find() reads lies inside the section, and the index is sorted
+bool SharedAssetCache::Validate() {
+    CacheHeader header;
+    if (m_capacity < sizeof(header)) return false;
+    std::memcpy(&header, m_base, sizeof(header));
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if (header.magic != CACHE_MAGIC || header.version != FORMAT_VERSION || header.published != 1) return false;
+    if (header.capacity > m_capacity || header.dataEnd > header.capacity) return false;
+    if (header.entriesOffset % alignof(Entry) != 0 || header.entriesOffset > header.dataEnd ||
+        header.entryCount > (header.dataEnd - header.entriesOffset) / sizeof(Entry)) {
+        return false;
+    }
+
+    const Entry* entries = (const Entry*)(m_base + header.entriesOffset);
+    for (uint64_t i = 0; i < header.entryCount; i++) {
+        const Entry& entry = entries[i];
+        if (entry.keyOffset > header.dataEnd || entry.keyLength > header.dataEnd - entry.keyOffset ||
+            entry.dataOffset > header.dataEnd || entry.dataSize > header.dataEnd - entry.dataOffset) {
+            return false;
+        }
+        if (i > 0 && entries[i - 1].hash > entry.hash) return false;
+    }
+
+    m_entries = entries;
+    m_entryCount = (size_t)header.entryCount;
+    m_published = true;
+    return true;
+}
+
+bool SharedAssetCache::Add(std::string_view key, const void* data, size_t size) {
+    if (!m_writable || m_published || (!data && size > 0)) return false;
+
+    uint64_t hash = HashKey(key);
+    for (const Entry& entry : m_pending) {
+        if (entry.hash == hash && entry.keyLength == key.size() &&
+            std::memcmp(m_base + entry.keyOffset, key.data(), key.size()) == 0) {
+            return false;
+        }
+    }
+
+    // Room for the index Publish() writes is kept free
+    CacheHeader* header = (CacheHeader*)m_base;
+    size_t keyOffset = AlignUp((size_t)header->dataEnd, DATA_ALIGNMENT);
+    size_t dataOffset = AlignUp(keyOffset + key.size(), DATA_ALIGNMENT);
+    size_t indexBytes = AlignUp((m_pending.size() + 1) * sizeof(Entry), DATA_ALIGNMENT) + DATA_ALIGNMENT;
+    if (dataOffset > m_capacity || size > m_capacity - dataOffset ||
+        indexBytes > m_capacity - dataOffset - size) {
+        return false;
+    }
+
+    std::memcpy(m_base + keyOffset, key.data(), key.size());
+    if (size > 0) std::memcpy(m_base + dataOffset, data, size);
+    header->dataEnd = dataOffset + size;
+
+    Entry entry = {};
+    entry.hash = hash;
+    entry.keyOffset = keyOffset;
+    entry.dataOffset = dataOffset;
+    entry.dataSize = size;
+    entry.keyLength = (uint32_t)key.size();
+    m_pending.push_back(entry);
+    return true;
+}
+
+bool SharedAssetCache::Publish() {
+    if (!m_writable || m_published) return false;
+
+    std::sort(m_pending.begin(), m_pending.end(), [](const Entry& a, const Entry& b) { return a.hash < b.hash; });
+
+    CacheHeader* header = (CacheHeader*)m_base;
+    size_t entriesOffset = AlignUp((size_t)header->dataEnd, DATA_ALIGNMENT);
+    size_t entriesBytes = m_pending.size() * sizeof(Entry);
+    if (entriesOffset + entriesBytes > m_capacity) return false;
+    if (entriesBytes > 0) std::memcpy(m_base + entriesOffset, m_pending.data(), entriesBytes);
+
+    header->entriesOffset = entriesOffset;
+    header->entryCount = m_pending.size();
+    header->dataEnd = entriesOffset + entriesBytes;
+    std::atomic_thread_fence(std::memory_order_release);
+    header->published = 1;
+
+    m_entries = (const Entry*)(m_base + entriesOffset);
+    m_entryCount = m_pending.size();
+    m_pending.clear();
+    m_pending.shrink_to_fit();
+    m_published = true;
+    return true;
+}
+
+bool SharedAssetCache::Find(std::string_view key, Blob& blob) const {
+    if (!m_published) return false;
+
+    uint64_t hash = HashKey(key);
+    const Entry* end = m_entries + m_entryCount;
+    const Entry* entry = std::lower_bound(m_entries, end, hash,
+                                          [](const Entry& e, uint64_t value) { return e.hash < value; });
+    for (; entry != end && entry->hash == hash; ++entry) {
+        if (entry->keyLength == key.size() && std::memcmp(m_base + entry->keyOffset, key.data(), key.size()) == 0) {
+            blob.data = m_base + entry->dataOffset;
+            blob.size = (size_t)entry->dataSize;
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t SharedAssetCache::GetBytesUsed() const {
+    return m_base ? (size_t)((const CacheHeader*)m_base)->dataEnd : 0;
+}
+
+bool SharedAssetCache::Attach(const std::wstring& name) {
+    std::shared_ptr<const SharedAssetCache> cache = Open(name);
+    if (!cache) return false;
+    SetCurrent(std::move(cache));
+    return true;
+}
+
+void SharedAssetCache::SetCurrent(std::shared_ptr<const SharedAssetCache> cache) {
+    std::lock_guard<std::mutex> lock(g_currentMutex);
+    g_current = std::move(cache);
+}
+
+std::shared_ptr<const SharedAssetCache> SharedAssetCache::GetCurrent() {
+    std::lock_guard<std::mutex> lock(g_currentMutex);
+    return g_current;
+}
+
+std::shared_ptr<const SharedAssetCache> SharedAssetCache::FindCurrent(std::string_view key, Blob& blob) {
+    std::shared_ptr<const SharedAssetCache> cache = GetCurrent();
+    if (!cache) return nullptr;
+    if (!cache->Find(key, blob)) {
+        g_misses.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    g_hits.fetch_add(1, std::memory_order_relaxed);
+    return cache;
+}
+
+SharedAssetCache::Stats SharedAssetCache::GetStats() {
+    Stats stats;
+    stats.hits = g_hits.load(std::memory_order_relaxed);
+    stats.misses = g_misses.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void SharedAssetCache::ResetStats() {
+    g_hits.store(0, std::memory_order_relaxed);
+    g_misses.store(0, std::memory_order_relaxed);
+}
+
+} // namespace SDK
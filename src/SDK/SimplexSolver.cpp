@@ -0,0 +1,562 @@
+#include "../../include/SDK/SimplexSolver.h"
+#include <algorithm>
+#include <limits>
+
+namespace SDK {
+
+namespace {
+    constexpr double EPSILON = 1.0e-8;
+
+    inline bool NearZero(double value) {
+        return value < 0.0 ? -value < EPSILON : value < EPSILON;
+    }
+
+    inline double ClipStrength(double strength) {
+        return std::max(0.0, std::min(SimplexSolver::REQUIRED, strength));
+    }
+}
+
+// ============================================================================
+// Row
+// ============================================================================
+
+std::vector<SimplexSolver::Row::Cell>::iterator SimplexSolver::Row::Find(const Symbol& symbol) {
+    auto it = std::lower_bound(cells.begin(), cells.end(), symbol,
+                               [](const Cell& cell, const Symbol& value) { return cell.first < value; });
+    return it != cells.end() && it->first == symbol ? it : cells.end();
+}
+
+std::vector<SimplexSolver::Row::Cell>::const_iterator SimplexSolver::Row::Find(const Symbol& symbol) const {
+    auto it = std::lower_bound(cells.begin(), cells.end(), symbol,
+                               [](const Cell& cell, const Symbol& value) { return cell.first < value; });
+    return it != cells.end() && it->first == symbol ? it : cells.end();
+}
+
+void SimplexSolver::Row::Insert(const Symbol& symbol, double coefficient) {
+    auto it = std::lower_bound(cells.begin(), cells.end(), symbol,
+                               [](const Cell& cell, const Symbol& value) { return cell.first < value; });
+    if (it != cells.end() && it->first == symbol) {
+        it->second += coefficient;
+        if (NearZero(it->second)) cells.erase(it);
+    } else if (!NearZero(coefficient)) {
+        cells.insert(it, Cell(symbol, coefficient));
+    }
+}
+
+void SimplexSolver::Row::Insert(const Row& other, double coefficient) {
+    constant += other.constant * coefficient;
+    if (other.cells.empty()) return;
+
+    std::vector<Cell> merged;
+    merged.reserve(cells.size() + other.cells.size());
+    auto a = cells.begin();
+    auto b = other.cells.begin();
+    while (a != cells.end() || b != other.cells.end()) {
+        if (b == other.cells.end() || (a != cells.end() && a->first < b->first)) {
+            merged.push_back(*a++);
+        } else if (a == cells.end() || b->first < a->first) {
+            double value = b->second * coefficient;
+            if (!NearZero(value)) merged.push_back(Cell(b->first, value));
+            ++b;
+        } else {
+            double value = a->second + b->second * coefficient;
+            if (!NearZero(value)) merged.push_back(Cell(a->first, value));
+            ++a;
+            ++b;
+        }
+    }
+    cells.swap(merged);
+}
+
+void SimplexSolver::Row::Remove(const Symbol& symbol) {
+    auto it = Find(symbol);
+    if (it != cells.end()) cells.erase(it);
+}
+
+void SimplexSolver::Row::ReverseSign() {
+    constant = -constant;
+    for (auto& cell : cells) {
+        cell.second = -cell.second;
+    }
+}
+
+void SimplexSolver::Row::SolveFor(const Symbol& symbol) {
+    // symbol is in the row here; every caller picked it from the row
+    auto it = Find(symbol);
+    double coefficient = -1.0 / it->second;
+    cells.erase(it);
+    constant *= coefficient;
+    for (auto& cell : cells) {
+        cell.second *= coefficient;
+    }
+}
+
+void SimplexSolver::Row::SolveFor(const Symbol& lhs, const Symbol& rhs) {
+    Insert(lhs, -1.0);
+    SolveFor(rhs);
+}
+
+double SimplexSolver::Row::CoefficientFor(const Symbol& symbol) const {
+    auto it = Find(symbol);
+    return it != cells.end() ? it->second : 0.0;
+}
+
+void SimplexSolver::Row::Substitute(const Symbol& symbol, const Row& row) {
+    auto it = Find(symbol);
+    if (it == cells.end()) return;
+
+    double coefficient = it->second;
+    cells.erase(it);
+    Insert(row, coefficient);
+}
+
+// ============================================================================
+// SimplexSolver
+// ============================================================================
+
+double SimplexSolver::Strength(double strong, double medium, double weak, double weight) {
+    double result = 0.0;
+    result += std::max(0.0, std::min(1000.0, strong * weight)) * 1000000.0;
+    result += std::max(0.0, std::min(1000.0, medium * weight)) * 1000.0;
+    result += std::max(0.0, std::min(1000.0, weak * weight));
+    return result;
+}
+
+SimplexSolver::SimplexSolver()
+    : m_objective(new Row())
+    , m_symbolTick(0)
+    , m_nextConstraint(0)
+    , m_pivots(0)
+{
+}
+
+SimplexSolver::~SimplexSolver() {
+}
+
+void SimplexSolver::Reset() {
+    m_rows.clear();
+    m_variables.clear();
+    m_values.clear();
+    m_constraints.clear();
+    m_edits.clear();
+    m_infeasibleRows.clear();
+    m_objective.reset(new Row());
+    m_artificial.reset();
+    m_symbolTick = 0;
+    m_nextConstraint = 0;
+    m_pivots = 0;
+}
+
+SimplexSolver::Variable SimplexSolver::AddVariable() {
+    m_variables.push_back(NewSymbol(SymbolType::EXTERNAL));
+    m_values.push_back(0.0);
+    return (Variable)m_variables.size() - 1;
+}
+
+double SimplexSolver::GetValue(Variable variable) const {
+    if (variable < 0 || variable >= (Variable)m_values.size()) return 0.0;
+    return m_values[variable];
+}
+
+SimplexSolver::ConstraintId SimplexSolver::AddConstraint(const Expression& expression, Relation relation, double strength) {
+    for (const Term& term : expression.terms) {
+        if (term.variable < 0 || term.variable >= (Variable)m_variables.size()) return INVALID_CONSTRAINT;
+    }
+    strength = ClipStrength(strength);
+
+    Tag tag;
+    std::unique_ptr<Row> row = CreateRow(expression, relation, strength, tag);
+    Symbol subject = ChooseSubject(*row, tag);
+
+    // All dummies: the constraint is either redundant or contradicts the
+    // required constraints already present
+    if (!subject.IsValid() && AllDummies(*row)) {
+        if (!NearZero(row->constant)) return INVALID_CONSTRAINT;
+        subject = tag.marker;
+    }
+
+    ConstraintId id = m_nextConstraint++;
+    m_constraints[id] = ConstraintInfo{ tag, strength };
+
+    if (!subject.IsValid()) {
+        if (!AddWithArtificialVariable(*row)) {
+            // The tableau still encodes the row; back it out so the solver
+            // is left as it was
+            RemoveConstraint(id);
+            return INVALID_CONSTRAINT;
+        }
+    } else {
+        row->SolveFor(subject);
+        Substitute(subject, *row);
+        m_rows[subject] = std::move(row);
+    }
+
+    Optimize(*m_objective);
+    return id;
+}
+
+bool SimplexSolver::RemoveConstraint(ConstraintId constraint) {
+    auto found = m_constraints.find(constraint);
+    if (found == m_constraints.end()) return false;
+
+    ConstraintInfo info = found->second;
+    m_constraints.erase(found);
+
+    // Error weights leave the objective before the row goes, or they'd be
+    // left in it with nothing to cancel them
+    RemoveConstraintEffects(info);
+
+    auto it = m_rows.find(info.tag.marker);
+    if (it != m_rows.end()) {
+        m_rows.erase(it);
+    } else {
+        it = GetMarkerLeavingRow(info.tag.marker);
+        if (it == m_rows.end()) return false;
+
+        Symbol leaving = it->first;
+        std::unique_ptr<Row> row = std::move(it->second);
+        m_rows.erase(it);
+        row->SolveFor(leaving, info.tag.marker);
+        Substitute(info.tag.marker, *row);
+        m_pivots++;
+    }
+
+    Optimize(*m_objective);
+    return true;
+}
+
+bool SimplexSolver::HasConstraint(ConstraintId constraint) const {
+    return m_constraints.find(constraint) != m_constraints.end();
+}
+
+bool SimplexSolver::AddEditVariable(Variable variable, double strength) {
+    if (variable < 0 || variable >= (Variable)m_variables.size()) return false;
+    if (m_edits.find(variable) != m_edits.end()) return false;
+
+    strength = ClipStrength(strength);
+    if (strength >= REQUIRED) return false;
+
+    Expression expression;
+    expression.Add(variable);
+    ConstraintId constraint = AddConstraint(expression, Relation::EQUAL, strength);
+    if (constraint == INVALID_CONSTRAINT) return false;
+
+    m_edits[variable] = EditInfo{ constraint, 0.0 };
+    return true;
+}
+
+bool SimplexSolver::RemoveEditVariable(Variable variable) {
+    auto it = m_edits.find(variable);
+    if (it == m_edits.end()) return false;
+
+    RemoveConstraint(it->second.constraint);
+    m_edits.erase(it);
+    return true;
+}
+
+bool SimplexSolver::HasEditVariable(Variable variable) const {
+    return m_edits.find(variable) != m_edits.end();
+}
+
+bool SimplexSolver::SuggestValue(Variable variable, double value) {
+    auto edit = m_edits.find(variable);
+    if (edit == m_edits.end()) return false;
+
+    EditInfo& info = edit->second;
+    double delta = value - info.constant;
+    info.constant = value;
+    if (delta == 0.0) return true;
+
+    // The edit row is variable - plus + minus = 0; moving its constant only
+    // touches the rows that hold one of the error symbols
+    const Tag& tag = m_constraints[info.constraint].tag;
+
+    auto it = m_rows.find(tag.marker);
+    if (it != m_rows.end()) {
+        if (it->second->Add(-delta) < 0.0) m_infeasibleRows.push_back(it->first);
+        return DualOptimize();
+    }
+
+    it = m_rows.find(tag.other);
+    if (it != m_rows.end()) {
+        if (it->second->Add(delta) < 0.0) m_infeasibleRows.push_back(it->first);
+        return DualOptimize();
+    }
+
+    for (auto& entry : m_rows) {
+        double coefficient = entry.second->CoefficientFor(tag.marker);
+        if (coefficient != 0.0 && entry.second->Add(delta * coefficient) < 0.0 &&
+            entry.first.type != SymbolType::EXTERNAL) {
+            m_infeasibleRows.push_back(entry.first);
+        }
+    }
+    return DualOptimize();
+}
+
+void SimplexSolver::UpdateVariables() {
+    for (size_t i = 0; i < m_variables.size(); i++) {
+        auto it = m_rows.find(m_variables[i]);
+        m_values[i] = it != m_rows.end() ? it->second->constant : 0.0;
+    }
+}
+
+std::unique_ptr<SimplexSolver::Row> SimplexSolver::CreateRow(const Expression& expression, Relation relation,
+                                                             double strength, Tag& tag) {
+    std::unique_ptr<Row> row(new Row(expression.constant));
+
+    // Basic variables are replaced by their rows, so the new row only holds
+    // parametric symbols
+    for (const Term& term : expression.terms) {
+        if (NearZero(term.coefficient)) continue;
+
+        const Symbol& symbol = m_variables[term.variable];
+        auto it = m_rows.find(symbol);
+        if (it != m_rows.end()) {
+            row->Insert(*it->second, term.coefficient);
+        } else {
+            row->Insert(symbol, term.coefficient);
+        }
+    }
+
+    switch (relation) {
+        case Relation::LESS_THAN_OR_EQUAL:
+        case Relation::GREATER_THAN_OR_EQUAL: {
+            double coefficient = relation == Relation::LESS_THAN_OR_EQUAL ? 1.0 : -1.0;
+            Symbol slack = NewSymbol(SymbolType::SLACK);
+            tag.marker = slack;
+            row->Insert(slack, coefficient);
+            if (strength < REQUIRED) {
+                Symbol error = NewSymbol(SymbolType::ERROR_TERM);
+                tag.other = error;
+                row->Insert(error, -coefficient);
+                m_objective->Insert(error, strength);
+            }
+            break;
+        }
+        case Relation::EQUAL:
+            if (strength < REQUIRED) {
+                Symbol plus = NewSymbol(SymbolType::ERROR_TERM);
+                Symbol minus = NewSymbol(SymbolType::ERROR_TERM);
+                tag.marker = plus;
+                tag.other = minus;
+                row->Insert(plus, -1.0);
+                row->Insert(minus, 1.0);
+                m_objective->Insert(plus, strength);
+                m_objective->Insert(minus, strength);
+            } else {
+                Symbol dummy = NewSymbol(SymbolType::DUMMY);
+                tag.marker = dummy;
+                row->Insert(dummy, 1.0);
+            }
+            break;
+    }
+
+    // Rows keep non-negative constants
+    if (row->constant < 0.0) row->ReverseSign();
+    return row;
+}
+
+SimplexSolver::Symbol SimplexSolver::ChooseSubject(const Row& row, const Tag& tag) const {
+    for (const auto& cell : row.cells) {
+        if (cell.first.type == SymbolType::EXTERNAL) return cell.first;
+    }
+    if (tag.marker.type == SymbolType::SLACK || tag.marker.type == SymbolType::ERROR_TERM) {
+        if (row.CoefficientFor(tag.marker) < 0.0) return tag.marker;
+    }
+    if (tag.other.type == SymbolType::SLACK || tag.other.type == SymbolType::ERROR_TERM) {
+        if (row.CoefficientFor(tag.other) < 0.0) return tag.other;
+    }
+    return Symbol();
+}
+
+bool SimplexSolver::AddWithArtificialVariable(const Row& row) {
+    // Phase one: minimise an artificial variable standing for the row; the
+    // constraint is satisfiable when it reaches zero
+    Symbol artificial = NewSymbol(SymbolType::SLACK);
+    m_rows[artificial].reset(new Row(row));
+    m_artificial.reset(new Row(row));
+
+    Optimize(*m_artificial);
+    bool success = NearZero(m_artificial->constant);
+    m_artificial.reset();
+
+    auto it = m_rows.find(artificial);
+    if (it != m_rows.end()) {
+        std::unique_ptr<Row> basic = std::move(it->second);
+        m_rows.erase(it);
+        if (basic->cells.empty()) return success;
+
+        Symbol entering = AnyPivotableSymbol(*basic);
+        if (!entering.IsValid()) return false;
+
+        basic->SolveFor(artificial, entering);
+        Substitute(entering, *basic);
+        m_rows[entering] = std::move(basic);
+        m_pivots++;
+    }
+
+    for (auto& entry : m_rows) {
+        entry.second->Remove(artificial);
+    }
+    m_objective->Remove(artificial);
+    return success;
+}
+
+void SimplexSolver::Substitute(const Symbol& symbol, const Row& row) {
+    for (auto& entry : m_rows) {
+        entry.second->Substitute(symbol, row);
+        if (entry.first.type != SymbolType::EXTERNAL && entry.second->constant < 0.0) {
+            m_infeasibleRows.push_back(entry.first);
+        }
+    }
+    m_objective->Substitute(symbol, row);
+    if (m_artificial) m_artificial->Substitute(symbol, row);
+}
+
+bool SimplexSolver::Optimize(const Row& objective) {
+    for (;;) {
+        Symbol entering = GetEnteringSymbol(objective);
+        if (!entering.IsValid()) return true;
+
+        auto it = GetLeavingRow(entering);
+        if (it == m_rows.end()) return false;   // Unbounded; the objective can't be
+
+        Symbol leaving = it->first;
+        std::unique_ptr<Row> row = std::move(it->second);
+        m_rows.erase(it);
+        row->SolveFor(leaving, entering);
+        Substitute(entering, *row);
+        m_rows[entering] = std::move(row);
+        m_pivots++;
+    }
+}
+
+bool SimplexSolver::DualOptimize() {
+    while (!m_infeasibleRows.empty()) {
+        Symbol leaving = m_infeasibleRows.back();
+        m_infeasibleRows.pop_back();
+
+        auto it = m_rows.find(leaving);
+        if (it == m_rows.end() || NearZero(it->second->constant) || it->second->constant >= 0.0) continue;
+
+        Symbol entering = GetDualEnteringSymbol(*it->second);
+        if (!entering.IsValid()) {
+            m_infeasibleRows.clear();
+            return false;
+        }
+
+        std::unique_ptr<Row> row = std::move(it->second);
+        m_rows.erase(it);
+        row->SolveFor(leaving, entering);
+        Substitute(entering, *row);
+        m_rows[entering] = std::move(row);
+        m_pivots++;
+    }
+    return true;
+}
+
+SimplexSolver::Symbol SimplexSolver::GetEnteringSymbol(const Row& objective) const {
+    for (const auto& cell : objective.cells) {
+        if (cell.first.type != SymbolType::DUMMY && cell.second < 0.0) return cell.first;
+    }
+    return Symbol();
+}
+
+SimplexSolver::Symbol SimplexSolver::GetDualEnteringSymbol(const Row& row) const {
+    Symbol entering;
+    double ratio = std::numeric_limits<double>::max();
+    for (const auto& cell : row.cells) {
+        if (cell.second > 0.0 && cell.first.type != SymbolType::DUMMY) {
+            double r = m_objective->CoefficientFor(cell.first) / cell.second;
+            if (r < ratio) {
+                ratio = r;
+                entering = cell.first;
+            }
+        }
+    }
+    return entering;
+}
+
+SimplexSolver::Symbol SimplexSolver::AnyPivotableSymbol(const Row& row) const {
+    for (const auto& cell : row.cells) {
+        if (cell.first.type == SymbolType::SLACK || cell.first.type == SymbolType::ERROR_TERM) return cell.first;
+    }
+    return Symbol();
+}
+
+std::map<SimplexSolver::Symbol, std::unique_ptr<SimplexSolver::Row>>::iterator
+SimplexSolver::GetLeavingRow(const Symbol& entering) {
+    // Minimum ratio test over the restricted rows
+    double ratio = std::numeric_limits<double>::max();
+    auto found = m_rows.end();
+    for (auto it = m_rows.begin(); it != m_rows.end(); ++it) {
+        if (it->first.type == SymbolType::EXTERNAL) continue;
+
+        double coefficient = it->second->CoefficientFor(entering);
+        if (coefficient < 0.0) {
+            double r = -it->second->constant / coefficient;
+            if (r < ratio) {
+                ratio = r;
+                found = it;
+            }
+        }
+    }
+    return found;
+}
+
+std::map<SimplexSolver::Symbol, std::unique_ptr<SimplexSolver::Row>>::iterator
+SimplexSolver::GetMarkerLeavingRow(const Symbol& marker) {
+    // Prefer a restricted row that stays feasible, then any restricted row,
+    // then an external one
+    double firstRatio = std::numeric_limits<double>::max();
+    double secondRatio = std::numeric_limits<double>::max();
+    auto first = m_rows.end();
+    auto second = m_rows.end();
+    auto third = m_rows.end();
+    for (auto it = m_rows.begin(); it != m_rows.end(); ++it) {
+        double coefficient = it->second->CoefficientFor(marker);
+        if (coefficient == 0.0) continue;
+
+        if (it->first.type == SymbolType::EXTERNAL) {
+            third = it;
+        } else if (coefficient < 0.0) {
+            double r = -it->second->constant / coefficient;
+            if (r < firstRatio) {
+                firstRatio = r;
+                first = it;
+            }
+        } else {
+            double r = it->second->constant / coefficient;
+            if (r < secondRatio) {
+                secondRatio = r;
+                second = it;
+            }
+        }
+    }
+    if (first != m_rows.end()) return first;
+    if (second != m_rows.end()) return second;
+    return third;
+}
+
+void SimplexSolver::RemoveConstraintEffects(const ConstraintInfo& info) {
+    if (info.tag.marker.type == SymbolType::ERROR_TERM) RemoveMarkerEffects(info.tag.marker, info.strength);
+    if (info.tag.other.type == SymbolType::ERROR_TERM) RemoveMarkerEffects(info.tag.other, info.strength);
+}
+
+void SimplexSolver::RemoveMarkerEffects(const Symbol& marker, double strength) {
+    auto it = m_rows.find(marker);
+    if (it != m_rows.end()) {
+        m_objective->Insert(*it->second, -strength);
+    } else {
+        m_objective->Insert(marker, -strength);
+    }
+}
+
+bool SimplexSolver::AllDummies(const Row& row) {
+    for (const auto& cell : row.cells) {
+        if (cell.first.type != SymbolType::DUMMY) return false;
+    }
+    return true;
+}
+
+} // namespace SDK
@@ -0,0 +1,97 @@
+#include "../../include/SDK/StartupTiming.h"
+#include "../../include/SDK/Profiler.h"
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+
+namespace SDK {
+
+namespace {
+    constexpr int PHASE_COUNT = (int)StartupTiming::Phase::COUNT;
+
+    const char* const PHASE_NAMES[PHASE_COUNT] = {
+        "Initialize",
+        "DPIManager",
+        "MonitorManager",
+        "WindowManager",
+        "WindowHook",
+        "NeuralNetwork",
+        "First frame"
+    };
+
+    std::mutex g_timingMutex;
+    StartupTiming::Clock::time_point g_start;
+    bool g_started = false;
+    double g_seconds[PHASE_COUNT] = {};
+    bool g_recorded[PHASE_COUNT] = {};
+    std::atomic<bool> g_firstFrameRecorded(false);
+}
+
+void StartupTiming::Start() {
+    std::lock_guard<std::mutex> lock(g_timingMutex);
+    if (g_started) return;
+    g_start = Clock::now();
+    g_started = true;
+}
+
+void StartupTiming::Record(Phase phase, Clock::time_point start, Clock::time_point end) {
+    int index = (int)phase;
+    if (index < 0 || index >= PHASE_COUNT) return;
+
+    {
+        std::lock_guard<std::mutex> lock(g_timingMutex);
+        if (g_recorded[index]) return;
+        g_seconds[index] = std::chrono::duration<double>(end - start).count();
+        g_recorded[index] = true;
+    }
+    Profiler::Record(PHASE_NAMES[index], "startup", start, end);
+}
+
+void StartupTiming::MarkFirstFrame() {
+    if (g_firstFrameRecorded.load(std::memory_order_relaxed)) return;
+
+    Clock::time_point start;
+    {
+        std::lock_guard<std::mutex> lock(g_timingMutex);
+        if (!g_started) return;
+        start = g_start;
+    }
+    g_firstFrameRecorded.store(true, std::memory_order_relaxed);
+    Record(Phase::FIRST_FRAME, start, Clock::now());
+}
+
+double StartupTiming::GetSeconds(Phase phase) {
+    int index = (int)phase;
+    if (index < 0 || index >= PHASE_COUNT) return -1.0;
+    std::lock_guard<std::mutex> lock(g_timingMutex);
+    return g_recorded[index] ? g_seconds[index] : -1.0;
+}
+
+const char* StartupTiming::GetPhaseName(Phase phase) {
+    int index = (int)phase;
+    return index >= 0 && index < PHASE_COUNT ? PHASE_NAMES[index] : "";
+}
+
+std::string StartupTiming::GetReport() {
+    std::string report;
+    char line[96];
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        double seconds = GetSeconds((Phase)i);
+        if (seconds < 0.0) continue;
+        snprintf(line, sizeof(line), "%-16s %9.3f ms\n", PHASE_NAMES[i], seconds * 1000.0);
+        report += line;
+    }
+    return report;
+}
+
+void StartupTiming::Reset() {
+    std::lock_guard<std::mutex> lock(g_timingMutex);
+    g_started = false;
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        g_seconds[i] = 0.0;
+        g_recorded[i] = false;
+    }
+    g_firstFrameRecorded.store(false, std::memory_order_relaxed);
+}
+
+} // namespace SDK
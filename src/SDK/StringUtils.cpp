@@ -0,0 +1,354 @@
+#include "../../include/SDK/StringUtils.h"
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define SDK_UTF_SSE2 1
+    #include <emmintrin.h>
+#else
+    #define SDK_UTF_SSE2 0
+#endif
+
+#if !SDK_UTF_SSE2 && (defined(__aarch64__) || defined(_M_ARM64))
+    #define SDK_UTF_NEON 1
+    #include <arm_neon.h>
+#else
+    #define SDK_UTF_NEON 0
+#endif
+
+namespace SDK {
+
+namespace {
+    // Characters the ASCII kernels take at once
+    constexpr size_t BLOCK = 16;
+    constexpr uint32_t SKIPPED = 0xFFFFFFFFu;
+    constexpr size_t SCRATCH_BLOCK_SIZE = 16 * 1024;
+    constexpr size_t MAX_UTF8_PER_WCHAR = sizeof(wchar_t) == 2 ? 3 : 4;
+
+    // Packs a block of wide characters into bytes when all are ASCII; with
+    // Store false only checks
+    template <bool Store>
+    bool NarrowBlock(const wchar_t* text, char* out) {
+#if SDK_UTF_SSE2
+        const __m128i* p = reinterpret_cast<const __m128i*>(text);
+        __m128i high;
+        __m128i bytes;
+        if constexpr (sizeof(wchar_t) == 2) {
+            __m128i a = _mm_loadu_si128(p);
+            __m128i b = _mm_loadu_si128(p + 1);
+            high = _mm_and_si128(_mm_or_si128(a, b), _mm_set1_epi16((short)0xFF80));
+            bytes = _mm_packus_epi16(a, b);
+        } else {
+            __m128i a = _mm_loadu_si128(p);
+            __m128i b = _mm_loadu_si128(p + 1);
+            __m128i c = _mm_loadu_si128(p + 2);
+            __m128i d = _mm_loadu_si128(p + 3);
+            high = _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)), _mm_set1_epi32(~0x7F));
+            bytes = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+        }
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(high, _mm_setzero_si128())) != 0xFFFF) return false;
+        if (Store) _mm_storeu_si128(reinterpret_cast<__m128i*>(out), bytes);
+        return true;
+#elif SDK_UTF_NEON
+        uint8x16_t bytes;
+        if constexpr (sizeof(wchar_t) == 2) {
+            const uint16_t* p = reinterpret_cast<const uint16_t*>(text);
+            uint16x8_t a = vld1q_u16(p);
+            uint16x8_t b = vld1q_u16(p + 8);
+            if (vmaxvq_u16(vorrq_u16(a, b)) >= 0x80) return false;
+            bytes = vcombine_u8(vmovn_u16(a), vmovn_u16(b));
+        } else {
+            const uint32_t* p = reinterpret_cast<const uint32_t*>(text);
+            uint32x4_t a = vld1q_u32(p);
+            uint32x4_t b = vld1q_u32(p + 4);
+            uint32x4_t c = vld1q_u32(p + 8);
+            uint32x4_t d = vld1q_u32(p + 12);
+            if (vmaxvq_u32(vorrq_u32(vorrq_u32(a, b), vorrq_u32(c, d))) >= 0x80) return false;
+            uint16x8_t low = vcombine_u16(vmovn_u32(a), vmovn_u32(b));
+            uint16x8_t high = vcombine_u16(vmovn_u32(c), vmovn_u32(d));
+            bytes = vcombine_u8(vmovn_u16(low), vmovn_u16(high));
+        }
+        if (Store) vst1q_u8(reinterpret_cast<uint8_t*>(out), bytes);
+        return true;
+#else
+        uint32_t high = 0;
+        for (size_t i = 0; i < BLOCK; i++) {
+            high |= static_cast<uint32_t>(text[i]);
+        }
+        if (high >= 0x80) return false;
+        if (Store) {
+            for (size_t i = 0; i < BLOCK; i++) {
+                out[i] = static_cast<char>(text[i]);
+            }
+        }
+        return true;
+#endif
+    }
+
+    // Widens a block of bytes when all are ASCII
+    bool WidenBlock(const char* text, wchar_t* out) {
+#if SDK_UTF_SSE2
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text));
+        if (_mm_movemask_epi8(bytes) != 0) return false;
+        __m128i zero = _mm_setzero_si128();
+        __m128i low = _mm_unpacklo_epi8(bytes, zero);
+        __m128i high = _mm_unpackhi_epi8(bytes, zero);
+        __m128i* p = reinterpret_cast<__m128i*>(out);
+        if constexpr (sizeof(wchar_t) == 2) {
+            _mm_storeu_si128(p, low);
+            _mm_storeu_si128(p + 1, high);
+        } else {
+            _mm_storeu_si128(p, _mm_unpacklo_epi16(low, zero));
+            _mm_storeu_si128(p + 1, _mm_unpackhi_epi16(low, zero));
+            _mm_storeu_si128(p + 2, _mm_unpacklo_epi16(high, zero));
+            _mm_storeu_si128(p + 3, _mm_unpackhi_epi16(high, zero));
+        }
+        return true;
+#elif SDK_UTF_NEON
+        uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t*>(text));
+        if (vmaxvq_u8(bytes) >= 0x80) return false;
+        uint16x8_t low = vmovl_u8(vget_low_u8(bytes));
+        uint16x8_t high = vmovl_u8(vget_high_u8(bytes));
+        if constexpr (sizeof(wchar_t) == 2) {
+            uint16_t* p = reinterpret_cast<uint16_t*>(out);
+            vst1q_u16(p, low);
+            vst1q_u16(p + 8, high);
+        } else {
+            uint32_t* p = reinterpret_cast<uint32_t*>(out);
+            vst1q_u32(p, vmovl_u16(vget_low_u16(low)));
+            vst1q_u32(p + 4, vmovl_u16(vget_high_u16(low)));
+            vst1q_u32(p + 8, vmovl_u16(vget_low_u16(high)));
+            vst1q_u32(p + 12, vmovl_u16(vget_high_u16(high)));
+        }
+        return true;
+#else
+        unsigned char high = 0;
+        for (size_t i = 0; i < BLOCK; i++) {
+            high |= static_cast<unsigned char>(text[i]);
+        }
+        if (high >= 0x80) return false;
+        for (size_t i = 0; i < BLOCK; i++) {
+            out[i] = static_cast<wchar_t>(text[i]);
+        }
+        return true;
+#endif
+    }
+
+    // Code point at text[i], advancing i past it; SKIPPED for unpaired
+    // surrogates and values past U+10FFFF
+    uint32_t DecodeWide(const wchar_t* text, size_t length, size_t& i) {
+        // Unsigned first, so a signed wchar_t can't sign-extend
+        uint32_t codepoint = sizeof(wchar_t) == 2 ? static_cast<uint16_t>(text[i])
+                                                  : static_cast<uint32_t>(text[i]);
+        i++;
+        if (codepoint >= 0xD800 && codepoint <= 0xDBFF && sizeof(wchar_t) == 2 && i < length) {
+            uint32_t low = static_cast<uint16_t>(text[i]);
+            if (low >= 0xDC00 && low <= 0xDFFF) {
+                i++;
+                return 0x10000 + (((codepoint & 0x3FF) << 10) | (low & 0x3FF));
+            }
+        }
+        if ((codepoint >= 0xD800 && codepoint <= 0xDFFF) || codepoint >= 0x110000) return SKIPPED;
+        return codepoint;
+    }
+
+    size_t EncodedLength(uint32_t codepoint) {
+        return codepoint < 0x80 ? 1 : codepoint < 0x800 ? 2 : codepoint < 0x10000 ? 3 : 4;
+    }
+
+    void Encode(uint32_t codepoint, char* out) {
+        if (codepoint < 0x80) {
+            out[0] = static_cast<char>(codepoint);
+        } else if (codepoint < 0x800) {
+            out[0] = static_cast<char>(0xC0 | (codepoint >> 6));
+            out[1] = static_cast<char>(0x80 | (codepoint & 0x3F));
+        } else if (codepoint < 0x10000) {
+            out[0] = static_cast<char>(0xE0 | (codepoint >> 12));
+            out[1] = static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+            out[2] = static_cast<char>(0x80 | (codepoint & 0x3F));
+        } else {
+            out[0] = static_cast<char>(0xF0 | (codepoint >> 18));
+            out[1] = static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+            out[2] = static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+            out[3] = static_cast<char>(0x80 | (codepoint & 0x3F));
+        }
+    }
+
+    struct ScratchBlock {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    struct Scratch {
+        std::vector<ScratchBlock> blocks;
+        size_t used = 0;            // In the last block
+        size_t capacity = 0;
+    };
+
+    Scratch& GetScratch() {
+        thread_local Scratch scratch;
+        return scratch;
+    }
+}
+
+size_t UTF8Length(const wchar_t* text, size_t length) {
+    size_t bytes = 0;
+    size_t i = 0;
+    while (i < length) {
+        if (length - i >= BLOCK && NarrowBlock<false>(text + i, nullptr)) {
+            i += BLOCK;
+            bytes += BLOCK;
+            continue;
+        }
+
+        // A block with non-ASCII in it goes a code point at a time
+        size_t stop = std::min(length, i + BLOCK);
+        while (i < stop) {
+            uint32_t codepoint = DecodeWide(text, length, i);
+            if (codepoint != SKIPPED) bytes += EncodedLength(codepoint);
+        }
+    }
+    return bytes;
+}
+
+size_t WideToUTF8(const wchar_t* text, size_t length, char* out, size_t capacity) {
+    size_t written = 0;
+    size_t i = 0;
+    while (i < length) {
+        if (length - i >= BLOCK && capacity - written >= BLOCK && NarrowBlock<true>(text + i, out + written)) {
+            i += BLOCK;
+            written += BLOCK;
+            continue;
+        }
+
+        size_t stop = std::min(length, i + BLOCK);
+        while (i < stop) {
+            uint32_t codepoint = DecodeWide(text, length, i);
+            if (codepoint == SKIPPED) continue;
+            size_t size = EncodedLength(codepoint);
+            if (size > capacity - written) {
+                return written + size + UTF8Length(text + i, length - i);
+            }
+            Encode(codepoint, out + written);
+            written += size;
+        }
+    }
+    return written;
+}
+
+void AppendDecimal(std::wstring& out, int64_t value) {
+    wchar_t digits[20];
+    size_t count = 0;
+    uint64_t magnitude = value < 0 ? 0 - (uint64_t)value : (uint64_t)value;
+    do {
+        digits[count++] = (wchar_t)(L'0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (value < 0) out.push_back(L'-');
+    while (count > 0) {
+        out.push_back(digits[--count]);
+    }
+}
+
+std::string WStringToUTF8(const std::wstring& wstr) {
+    if (wstr.empty()) {
+        return std::string();
+    }
+
+    std::string result(UTF8Length(wstr.data(), wstr.size()), '\0');
+    WideToUTF8(wstr.data(), wstr.size(), &result[0], result.size());
+    return result;
+}
+
+std::wstring UTF8ToWString(const char* text, size_t length) {
+    // Every wide character takes at least one byte, so length bounds the result
+    std::wstring result(length, L'\0');
+    wchar_t* out = &result[0];
+    size_t written = 0;
+
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(text);
+    size_t i = 0;
+    while (i < length) {
+        if (length - i >= BLOCK && WidenBlock(text + i, out + written)) {
+            i += BLOCK;
+            written += BLOCK;
+            continue;
+        }
+
+        uint32_t lead = bytes[i];
+        if (lead < 0x80) {
+            out[written++] = static_cast<wchar_t>(lead);
+            i++;
+            continue;
+        }
+
+        int extra = (lead & 0xE0) == 0xC0 ? 1 : (lead & 0xF0) == 0xE0 ? 2 : (lead & 0xF8) == 0xF0 ? 3 : -1;
+        uint32_t codepoint = extra == 1 ? (lead & 0x1F) : extra == 2 ? (lead & 0x0F) : (lead & 0x07);
+        bool valid = extra > 0;
+        for (int k = 1; valid && k <= extra; k++) {
+            if (i + k >= length || (bytes[i + k] & 0xC0) != 0x80) {
+                valid = false;
+            } else {
+                codepoint = (codepoint << 6) | (bytes[i + k] & 0x3F);
+            }
+        }
+
+        // Overlong forms, surrogates and values past U+10FFFF are malformed too
+        static const uint32_t minimum[4] = { 0, 0x80, 0x800, 0x10000 };
+        if (!valid || codepoint < minimum[extra] || codepoint > 0x10FFFF ||
+            (codepoint >= 0xD800 && codepoint <= 0xDFFF)) {
+            out[written++] = static_cast<wchar_t>(0xFFFD);
+            i++;
+            continue;
+        }
+        i += extra + 1;
+
+        if (sizeof(wchar_t) == 2 && codepoint >= 0x10000) {
+            codepoint -= 0x10000;
+            out[written++] = static_cast<wchar_t>(0xD800 | (codepoint >> 10));
+            out[written++] = static_cast<wchar_t>(0xDC00 | (codepoint & 0x3FF));
+        } else {
+            out[written++] = static_cast<wchar_t>(codepoint);
+        }
+    }
+
+    result.resize(written);
+    return result;
+}
+
+std::string_view UTF8Scratch::Convert(const wchar_t* text, size_t length) {
+    Scratch& scratch = GetScratch();
+
+    // Room for the worst case, so the text is read once
+    size_t needed = length * MAX_UTF8_PER_WCHAR + 1;
+    if (scratch.blocks.empty() || scratch.blocks.back().size - scratch.used < needed) {
+        size_t size = std::max(needed, SCRATCH_BLOCK_SIZE);
+        scratch.blocks.push_back({ std::unique_ptr<char[]>(new char[size]), size });
+        scratch.capacity += size;
+        scratch.used = 0;
+    }
+
+    char* out = scratch.blocks.back().data.get() + scratch.used;
+    size_t written = WideToUTF8(text, length, out, needed - 1);
+    out[written] = '\0';
+    scratch.used += written + 1;
+    return std::string_view(out, written);
+}
+
+void UTF8Scratch::Reset() {
+    Scratch& scratch = GetScratch();
+    scratch.used = 0;
+
+    // A frame that outgrew the arena gets one block big enough for all of it
+    if (scratch.blocks.size() > 1) {
+        scratch.blocks.clear();
+        scratch.blocks.push_back({ std::unique_ptr<char[]>(new char[scratch.capacity]), scratch.capacity });
+    }
+}
+
+size_t UTF8Scratch::GetCapacity() {
+    return GetScratch().capacity;
+}
+
+} // namespace SDK
@@ -0,0 +1,324 @@
+#include "../../include/SDK/TextBuffer.h"
+#include <algorithm>
+#include <utility>
+
+namespace SDK {
+
+struct TextBufferNode {
+    std::shared_ptr<const TextBufferNode> left;
+    std::shared_ptr<const TextBufferNode> right;
+    std::wstring text;      // Leaves only
+    size_t length;
+    size_t lineBreaks;
+    int height;             // 0 for leaves
+
+    bool IsLeaf() const { return !left; }
+};
+
+namespace {
+    using NodePtr = std::shared_ptr<const TextBufferNode>;
+
+    // Leaves are split at this size; adjacent small leaves are merged back
+    constexpr size_t MAX_LEAF = 512;
+
+    int Height(const NodePtr& node) { return node ? node->height : -1; }
+    size_t Length(const NodePtr& node) { return node ? node->length : 0; }
+
+    NodePtr MakeLeaf(std::wstring text) {
+        if (text.empty()) return nullptr;
+        auto node = std::make_shared<TextBufferNode>();
+        node->length = text.length();
+        node->lineBreaks = static_cast<size_t>(std::count(text.begin(), text.end(), L'\n'));
+        node->height = 0;
+        node->text = std::move(text);
+        return node;
+    }
+
+    NodePtr MakeNode(NodePtr left, NodePtr right) {
+        if (!left) return right;
+        if (!right) return left;
+        auto node = std::make_shared<TextBufferNode>();
+        node->length = left->length + right->length;
+        node->lineBreaks = left->lineBreaks + right->lineBreaks;
+        node->height = std::max(left->height, right->height) + 1;
+        node->left = std::move(left);
+        node->right = std::move(right);
+        return node;
+    }
+
+    // Joins subtrees whose heights differ by at most two, rotating once
+    NodePtr Balance(const NodePtr& left, const NodePtr& right) {
+        int leftHeight = Height(left);
+        int rightHeight = Height(right);
+
+        if (leftHeight > rightHeight + 1) {
+            if (Height(left->left) >= Height(left->right)) {
+                return MakeNode(left->left, MakeNode(left->right, right));
+            }
+            return MakeNode(MakeNode(left->left, left->right->left), MakeNode(left->right->right, right));
+        }
+        if (rightHeight > leftHeight + 1) {
+            if (Height(right->right) >= Height(right->left)) {
+                return MakeNode(MakeNode(left, right->left), right->right);
+            }
+            return MakeNode(MakeNode(left, right->left->left), MakeNode(right->left->right, right->right));
+        }
+        return MakeNode(left, right);
+    }
+
+    // Descends the taller tree's inner spine to the other's height; a small
+    // leaf reaches the leaf it lands next to and is merged into it
+    NodePtr Concat(const NodePtr& left, const NodePtr& right) {
+        if (!left) return right;
+        if (!right) return left;
+
+        if (left->IsLeaf() && right->IsLeaf()) {
+            if (left->length + right->length <= MAX_LEAF) {
+                return MakeLeaf(left->text + right->text);
+            }
+            return MakeNode(left, right);
+        }
+        if (left->height > right->height) {
+            return Balance(left->left, Concat(left->right, right));
+        }
+        if (right->height > left->height) {
+            return Balance(Concat(left, right->left), right->right);
+        }
+        return MakeNode(left, right);
+    }
+
+    std::pair<NodePtr, NodePtr> Split(const NodePtr& node, size_t offset) {
+        if (!node || offset == 0) return { nullptr, node };
+        if (offset >= node->length) return { node, nullptr };
+
+        if (node->IsLeaf()) {
+            return { MakeLeaf(node->text.substr(0, offset)), MakeLeaf(node->text.substr(offset)) };
+        }
+
+        size_t leftLength = node->left->length;
+        if (offset <= leftLength) {
+            auto parts = Split(node->left, offset);
+            return { parts.first, Concat(parts.second, node->right) };
+        }
+        auto parts = Split(node->right, offset - leftLength);
+        return { Concat(node->left, parts.first), parts.second };
+    }
+
+    // Typing fast paths: an edit that stays inside one leaf only copies the
+    // path to it, with no split or rebalancing. Null when the edit doesn't fit.
+    NodePtr InsertIntoLeaf(const NodePtr& node, size_t offset, const std::wstring& text) {
+        if (node->IsLeaf()) {
+            if (node->length + text.length() > MAX_LEAF) return nullptr;
+            std::wstring merged = node->text;
+            merged.insert(offset, text);
+            return MakeLeaf(std::move(merged));
+        }
+
+        size_t leftLength = node->left->length;
+        if (offset <= leftLength) {
+            NodePtr left = InsertIntoLeaf(node->left, offset, text);
+            return left ? MakeNode(left, node->right) : nullptr;
+        }
+        NodePtr right = InsertIntoLeaf(node->right, offset - leftLength, text);
+        return right ? MakeNode(node->left, right) : nullptr;
+    }
+
+    NodePtr EraseFromLeaf(const NodePtr& node, size_t offset, size_t length) {
+        if (node->IsLeaf()) {
+            if (length >= node->length) return nullptr;
+            std::wstring remaining = node->text;
+            remaining.erase(offset, length);
+            return MakeLeaf(std::move(remaining));
+        }
+
+        size_t leftLength = node->left->length;
+        if (offset + length <= leftLength) {
+            NodePtr left = EraseFromLeaf(node->left, offset, length);
+            return left ? MakeNode(left, node->right) : nullptr;
+        }
+        if (offset >= leftLength) {
+            NodePtr right = EraseFromLeaf(node->right, offset - leftLength, length);
+            return right ? MakeNode(node->left, right) : nullptr;
+        }
+        return nullptr;
+    }
+
+    // Balanced tree over text[begin, end) with leaves of MAX_LEAF / 2 to MAX_LEAF
+    NodePtr Build(const std::wstring& text, size_t begin, size_t end) {
+        if (end - begin <= MAX_LEAF) {
+            return MakeLeaf(text.substr(begin, end - begin));
+        }
+        size_t middle = begin + (end - begin) / 2;
+        return MakeNode(Build(text, begin, middle), Build(text, middle, end));
+    }
+
+    template<typename String>
+    void AppendRange(const NodePtr& node, size_t offset, size_t length, String& out) {
+        if (!node || length == 0 || offset >= node->length) return;
+
+        if (node->IsLeaf()) {
+            out.append(node->text, offset, length);
+            return;
+        }
+
+        size_t leftLength = node->left->length;
+        if (offset < leftLength) {
+            size_t count = std::min(length, leftLength - offset);
+            AppendRange(node->left, offset, count, out);
+            offset += count;
+            length -= count;
+        }
+        if (length > 0) {
+            AppendRange(node->right, offset - leftLength, length, out);
+        }
+    }
+
+    // Offset of the index-th line break; index < node->lineBreaks
+    size_t FindLineBreak(const NodePtr& root, size_t index) {
+        const TextBufferNode* node = root.get();
+        size_t offset = 0;
+
+        while (!node->IsLeaf()) {
+            size_t leftBreaks = node->left->lineBreaks;
+            if (index < leftBreaks) {
+                node = node->left.get();
+            } else {
+                index -= leftBreaks;
+                offset += node->left->length;
+                node = node->right.get();
+            }
+        }
+
+        for (size_t i = 0; i < node->text.length(); i++) {
+            if (node->text[i] == L'\n' && index-- == 0) {
+                return offset + i;
+            }
+        }
+        return offset + node->text.length();
+    }
+}
+
+TextBuffer::TextBuffer(const std::wstring& text) {
+    SetText(text);
+}
+
+void TextBuffer::SetText(const std::wstring& text) {
+    m_root = Build(text, 0, text.length());
+}
+
+std::wstring TextBuffer::GetText() const {
+    return GetText(0, GetLength());
+}
+
+std::wstring TextBuffer::GetText(size_t offset, size_t length) const {
+    std::wstring text;
+    size_t total = GetLength();
+    if (offset >= total) return text;
+
+    length = std::min(length, total - offset);
+    text.reserve(length);
+    AppendRange(m_root, offset, length, text);
+    return text;
+}
+
+wchar_t TextBuffer::GetChar(size_t offset) const {
+    const TextBufferNode* node = m_root.get();
+    if (!node || offset >= node->length) return L'\0';
+
+    while (!node->IsLeaf()) {
+        if (offset < node->left->length) {
+            node = node->left.get();
+        } else {
+            offset -= node->left->length;
+            node = node->right.get();
+        }
+    }
+    return node->text[offset];
+}
+
+size_t TextBuffer::GetLength() const {
+    return Length(m_root);
+}
+
+void TextBuffer::Insert(size_t offset, const std::wstring& text) {
+    if (text.empty()) return;
+    offset = std::min(offset, GetLength());
+
+    if (m_root) {
+        if (NodePtr root = InsertIntoLeaf(m_root, offset, text)) {
+            m_root = root;
+            return;
+        }
+    }
+
+    auto parts = Split(m_root, offset);
+    m_root = Concat(Concat(parts.first, Build(text, 0, text.length())), parts.second);
+}
+
+void TextBuffer::Erase(size_t offset, size_t length) {
+    size_t total = GetLength();
+    if (offset >= total || length == 0) return;
+    length = std::min(length, total - offset);
+
+    if (NodePtr root = EraseFromLeaf(m_root, offset, length)) {
+        m_root = root;
+        return;
+    }
+
+    auto head = Split(m_root, offset);
+    auto tail = Split(head.second, length);
+    m_root = Concat(head.first, tail.second);
+}
+
+size_t TextBuffer::GetLineCount() const {
+    return (m_root ? m_root->lineBreaks : 0) + 1;
+}
+
+size_t TextBuffer::GetLineStart(size_t line) const {
+    if (line == 0) return 0;
+    if (line >= GetLineCount()) return GetLength();
+    return FindLineBreak(m_root, line - 1) + 1;
+}
+
+size_t TextBuffer::GetLineLength(size_t line) const {
+    size_t lineCount = GetLineCount();
+    if (line >= lineCount) return 0;
+
+    size_t start = GetLineStart(line);
+    size_t end = line + 1 < lineCount ? FindLineBreak(m_root, line) : GetLength();
+    return end - start;
+}
+
+std::wstring TextBuffer::GetLine(size_t line) const {
+    if (line >= GetLineCount()) return std::wstring();
+    return GetText(GetLineStart(line), GetLineLength(line));
+}
+
+void TextBuffer::GetLine(size_t line, std::pmr::wstring& out) const {
+    out.clear();
+    if (line >= GetLineCount()) return;
+    size_t length = GetLineLength(line);
+    out.reserve(length);
+    AppendRange(m_root, GetLineStart(line), length, out);
+}
+
+size_t TextBuffer::GetLineFromOffset(size_t offset) const {
+    const TextBufferNode* node = m_root.get();
+    if (!node) return 0;
+    if (offset >= node->length) return node->lineBreaks;
+
+    // Line breaks before offset
+    size_t line = 0;
+    while (!node->IsLeaf()) {
+        if (offset < node->left->length) {
+            node = node->left.get();
+        } else {
+            line += node->left->lineBreaks;
+            offset -= node->left->length;
+            node = node->right.get();
+        }
+    }
+    return line + static_cast<size_t>(std::count(node->text.begin(), node->text.begin() + offset, L'\n'));
+}
+
+} // namespace SDK
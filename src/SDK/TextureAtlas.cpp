@@ -0,0 +1,390 @@
+#include "../../include/SDK/TextureAtlas.h"
+#include "../../include/SDK/SharedAssetCache.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+#if SDK_PLATFORM_WINDOWS
+#include "../../include/SDK/Renderer.h"
+#endif
+
+namespace SDK {
+
+namespace {
+    // 1024 x 1024 holds a few hundred toolbar icons in 4 MB
+    constexpr int SHARED_ATLAS_SIZE = 1024;
+
+    // Clear gap after each texture so stretched draws don't filter in a neighbour
+    constexpr int TEXTURE_PADDING = 1;
+
+    // Textures in a SharedAssetCache: one blob of records, each this header,
+    // the name padded to 4 bytes, then width * height pixels
+    constexpr const char* SHARED_KEY = "TextureAtlas";
+    struct SharedTextureHeader {
+        int32_t width;
+        int32_t height;
+        int32_t pinned;
+        int32_t nameLength;
+    };
+
+    size_t PaddedNameLength(size_t length) { return (length + 3) & ~(size_t)3; }
+
+#if SDK_PLATFORM_WINDOWS
+    // DIB section mirror of the atlas pixels, refreshed when the version changes
+    struct GdiAtlasSurface {
+        HDC dc;
+        HBITMAP bitmap;
+        uint32_t* bits;
+        uint64_t version;
+
+        GdiAtlasSurface() : dc(nullptr), bitmap(nullptr), bits(nullptr), version(0) {}
+        ~GdiAtlasSurface() {
+            if (dc) Renderer::DeleteMemoryDC(dc, bitmap, GdiSubsystem::ATLAS);
+        }
+    };
+#endif
+}
+
+TextureAtlas::TextureAtlas(int width, int height)
+    : m_width(std::max(1, width))
+    , m_height(std::max(1, height))
+    , m_pixels((size_t)m_width * m_height, 0)
+    , m_usedArea(0)
+    , m_version(1)
+    , m_clock(0)
+    , m_hits(0)
+    , m_misses(0)
+    , m_memorySource("TextureAtlas", [this]() { return GetMemoryBytes(); },
+                     [this](size_t targetBytes) { TrimMemory(targetBytes); })
+{
+    ResetSkyline();
+}
+
+// Backend copies are counted at the size of the pixels they mirror
+size_t TextureAtlas::GetMemoryBytes() const {
+    size_t bytes = m_pixels.capacity() * sizeof(uint32_t) + m_skyline.capacity() * sizeof(SkylineSegment) +
+                   m_textures.size() * sizeof(Entry);
+    for (const auto& surface : m_surfaces) {
+        if (surface) bytes += m_pixels.size() * sizeof(uint32_t);
+    }
+    return bytes;
+}
+
+// The pixels are one fixed buffer, so evicting textures would free nothing;
+// the backend copies go instead
+void TextureAtlas::TrimMemory(size_t targetBytes) {
+    for (auto& surface : m_surfaces) {
+        if (GetMemoryBytes() <= targetBytes) break;
+        surface.reset();
+    }
+}
+
+TextureAtlas& TextureAtlas::GetShared() {
+    static TextureAtlas shared(SHARED_ATLAS_SIZE, SHARED_ATLAS_SIZE);
+    static bool imported = shared.ImportShared();
+    (void)imported;
+    return shared;
+}
+
+bool TextureAtlas::ExportShared(SharedAssetCache& cache) const {
+    std::vector<unsigned char> blob;
+    for (const auto& pair : m_textures) {
+        const AtlasEntry& rect = pair.second.rect;
+        SharedTextureHeader header = { rect.width, rect.height, pair.second.pinned ? 1 : 0, (int32_t)pair.first.size() };
+        size_t offset = blob.size();
+        blob.resize(offset + sizeof(header) + PaddedNameLength(pair.first.size()) + (size_t)rect.width * rect.height * sizeof(uint32_t));
+        unsigned char* out = blob.data() + offset;
+        std::memcpy(out, &header, sizeof(header));
+        std::memcpy(out + sizeof(header), pair.first.data(), pair.first.size());
+        out += sizeof(header) + PaddedNameLength(pair.first.size());
+        for (int row = 0; row < rect.height; row++) {
+            const uint32_t* src = m_pixels.data() + (size_t)(rect.y + row) * m_width + rect.x;
+            std::memcpy(out + (size_t)row * rect.width * sizeof(uint32_t), src, rect.width * sizeof(uint32_t));
+        }
+    }
+    return cache.Add(SHARED_KEY, blob.data(), blob.size());
+}
+
+// Records that don't fit the blob end the import; textures that don't fit the atlas are skipped
+bool TextureAtlas::ImportShared() {
+    SharedAssetCache::Blob blob;
+    if (!SharedAssetCache::FindCurrent(SHARED_KEY, blob)) return false;
+
+    const unsigned char* data = (const unsigned char*)blob.data;
+    size_t offset = 0;
+    while (blob.size - offset >= sizeof(SharedTextureHeader)) {
+        SharedTextureHeader header;
+        std::memcpy(&header, data + offset, sizeof(header));
+        if (header.width <= 0 || header.height <= 0 || header.nameLength < 0 ||
+            header.width > m_width || header.height > m_height) {
+            break;
+        }
+        size_t nameBytes = PaddedNameLength((size_t)header.nameLength);
+        size_t pixelBytes = (size_t)header.width * header.height * sizeof(uint32_t);
+        size_t remaining = blob.size - offset - sizeof(header);
+        if (nameBytes > remaining || pixelBytes > remaining - nameBytes) break;
+
+        std::string name((const char*)data + offset + sizeof(header), (size_t)header.nameLength);
+        const uint32_t* pixels = (const uint32_t*)(data + offset + sizeof(header) + nameBytes);
+        AddTexture(name, pixels, header.width, header.height, header.width, header.pinned != 0);
+        offset += sizeof(header) + nameBytes + pixelBytes;
+    }
+    return true;
+}
+
+void TextureAtlas::ResetSkyline() {
+    m_skyline.clear();
+    m_skyline.push_back(SkylineSegment{ 0, 0, m_width });
+}
+
+bool TextureAtlas::Pack(int width, int height, int& outX, int& outY) {
+    // Bottom-left: the position whose top edge ends lowest, then the
+    // narrowest segment, so wide gaps are kept for wide textures
+    size_t best = m_skyline.size();
+    int bestTop = INT_MAX;
+    int bestWidth = INT_MAX;
+    int bestY = 0;
+
+    for (size_t i = 0; i < m_skyline.size(); i++) {
+        int x = m_skyline[i].x;
+        if (x + width > m_width) break;
+
+        int y = 0;
+        for (size_t j = i; j < m_skyline.size() && m_skyline[j].x < x + width; j++) {
+            y = std::max(y, m_skyline[j].y);
+        }
+        if (y + height > m_height) continue;
+
+        if (y + height < bestTop || (y + height == bestTop && m_skyline[i].width < bestWidth)) {
+            best = i;
+            bestTop = y + height;
+            bestWidth = m_skyline[i].width;
+            bestY = y;
+        }
+    }
+    if (best == m_skyline.size()) return false;
+
+    outX = m_skyline[best].x;
+    outY = bestY;
+
+    // Raise the skyline over the new texture, trimming the segments it covers
+    m_skyline.insert(m_skyline.begin() + best, SkylineSegment{ outX, bestTop, width });
+    int right = outX + width;
+    size_t next = best + 1;
+    while (next < m_skyline.size() && m_skyline[next].x < right) {
+        SkylineSegment& segment = m_skyline[next];
+        int overlap = right - segment.x;
+        if (overlap >= segment.width) {
+            m_skyline.erase(m_skyline.begin() + next);
+            continue;
+        }
+        segment.x += overlap;
+        segment.width -= overlap;
+        break;
+    }
+
+    for (size_t i = 0; i + 1 < m_skyline.size();) {
+        if (m_skyline[i].y == m_skyline[i + 1].y) {
+            m_skyline[i].width += m_skyline[i + 1].width;
+            m_skyline.erase(m_skyline.begin() + i + 1);
+        } else {
+            i++;
+        }
+    }
+    return true;
+}
+
+bool TextureAtlas::Place(const std::string& name, const uint32_t* pixels, int width, int height, int stride, bool pinned) {
+    int x, y;
+    if (!Pack(std::min(m_width, width + TEXTURE_PADDING), std::min(m_height, height + TEXTURE_PADDING), x, y)) {
+        return false;
+    }
+
+    for (int row = 0; row < height; row++) {
+        const uint32_t* src = pixels + (size_t)row * stride;
+        std::copy(src, src + width, m_pixels.data() + (size_t)(y + row) * m_width + x);
+    }
+
+    Entry& entry = m_textures[name];
+    entry.rect = AtlasEntry{ x, y, width, height };
+    entry.pinned = pinned;
+    entry.lastUse = ++m_clock;
+    m_usedArea += (size_t)width * height;
+    m_version++;
+    return true;
+}
+
+bool TextureAtlas::EvictFor(int width, int height) {
+    std::vector<std::pair<uint64_t, const std::string*>> candidates;
+    for (const auto& pair : m_textures) {
+        if (!pair.second.pinned) candidates.emplace_back(pair.second.lastUse, &pair.first);
+    }
+    if (candidates.empty()) return false;
+    std::sort(candidates.begin(), candidates.end());
+
+    // Enough area for the new texture; the repack afterwards decides whether it fits
+    size_t needed = (size_t)(width + TEXTURE_PADDING) * (height + TEXTURE_PADDING);
+    size_t total = (size_t)m_width * m_height;
+    std::vector<std::string> evicted;
+    for (const auto& candidate : candidates) {
+        evicted.push_back(*candidate.second);
+        m_usedArea -= (size_t)m_textures[*candidate.second].rect.width * m_textures[*candidate.second].rect.height;
+        if (total - m_usedArea >= needed) break;
+    }
+    for (const auto& name : evicted) {
+        m_textures.erase(name);
+    }
+    return true;
+}
+
+bool TextureAtlas::AddTexture(const std::string& name, const uint32_t* pixels, int width, int height, int stride, bool pinned) {
+    if (!pixels || width <= 0 || height <= 0 || stride < width || width > m_width || height > m_height) return false;
+
+    RemoveTexture(name);
+    if (Place(name, pixels, width, height, stride, pinned)) return true;
+
+    // Space left by removed textures only comes back on a repack
+    Defragment();
+    if (Place(name, pixels, width, height, stride, pinned)) return true;
+
+    while (EvictFor(width, height)) {
+        Defragment();
+        if (Place(name, pixels, width, height, stride, pinned)) return true;
+    }
+    return false;
+}
+
+bool TextureAtlas::AddTexture(const std::string& name, HBITMAP bitmap, int width, int height, bool pinned) {
+#if SDK_PLATFORM_WINDOWS
+    if (!bitmap || width <= 0 || height <= 0) return false;
+
+    BITMAPINFO bmi = {};
+    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bmi.bmiHeader.biWidth = width;
+    bmi.bmiHeader.biHeight = -height; // Top-down
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+
+    std::vector<uint32_t> pixels((size_t)width * height);
+    HDC screenDC = ::GetDC(nullptr);
+    int rows = GetDIBits(screenDC, bitmap, 0, height, pixels.data(), &bmi, DIB_RGB_COLORS);
+    ::ReleaseDC(nullptr, screenDC);
+    if (rows == 0) return false;
+
+    return AddTexture(name, pixels.data(), width, height, width, pinned);
+#else
+    (void)name; (void)bitmap; (void)width; (void)height; (void)pinned;
+    return false;
+#endif
+}
+
+const TextureAtlas::AtlasEntry* TextureAtlas::GetTexture(const std::string& name) const {
+    auto it = m_textures.find(name);
+    if (it == m_textures.end()) {
+        m_misses++;
+        return nullptr;
+    }
+
+    m_hits++;
+    it->second.lastUse = ++m_clock;
+    return &it->second.rect;
+}
+
+bool TextureAtlas::RemoveTexture(const std::string& name) {
+    auto it = m_textures.find(name);
+    if (it == m_textures.end()) return false;
+
+    // The pixels stay until the next repack; nothing samples them meanwhile
+    m_usedArea -= (size_t)it->second.rect.width * it->second.rect.height;
+    m_textures.erase(it);
+    return true;
+}
+
+void TextureAtlas::Clear() {
+    m_textures.clear();
+    std::fill(m_pixels.begin(), m_pixels.end(), 0u);
+    ResetSkyline();
+    m_usedArea = 0;
+    m_version++;
+}
+
+void TextureAtlas::Defragment() {
+    // Tallest first packs a skyline tightest; names break ties so the layout is repeatable
+    std::vector<std::pair<const std::string*, Entry*>> order;
+    for (auto& pair : m_textures) {
+        order.emplace_back(&pair.first, &pair.second);
+    }
+    std::sort(order.begin(), order.end(), [](const std::pair<const std::string*, Entry*>& a,
+                                             const std::pair<const std::string*, Entry*>& b) {
+        if (a.second->rect.height != b.second->rect.height) return a.second->rect.height > b.second->rect.height;
+        if (a.second->rect.width != b.second->rect.width) return a.second->rect.width > b.second->rect.width;
+        return *a.first < *b.first;
+    });
+
+    std::vector<uint32_t> previous((size_t)m_width * m_height, 0);
+    previous.swap(m_pixels);
+    ResetSkyline();
+    m_usedArea = 0;
+
+    // Textures that no longer fit in the new order are dropped like evictions
+    std::vector<std::string> dropped;
+    for (auto& item : order) {
+        AtlasEntry& rect = item.second->rect;
+        int x, y;
+        if (!Pack(std::min(m_width, rect.width + TEXTURE_PADDING), std::min(m_height, rect.height + TEXTURE_PADDING), x, y)) {
+            dropped.push_back(*item.first);
+            continue;
+        }
+        for (int row = 0; row < rect.height; row++) {
+            const uint32_t* src = previous.data() + (size_t)(rect.y + row) * m_width + rect.x;
+            std::copy(src, src + rect.width, m_pixels.data() + (size_t)(y + row) * m_width + x);
+        }
+        rect.x = x;
+        rect.y = y;
+        m_usedArea += (size_t)rect.width * rect.height;
+    }
+    for (const auto& name : dropped) {
+        m_textures.erase(name);
+    }
+    m_version++;
+}
+
+bool TextureAtlas::Draw(HDC hdc, const std::string& name, const RECT& dest) const {
+#if SDK_PLATFORM_WINDOWS
+    const AtlasEntry* entry = GetTexture(name);
+    if (!hdc || !entry) return false;
+
+    std::shared_ptr<void>& slot = GetPlatformSurface(Surface::GDI);
+    if (!slot) {
+        auto surface = std::make_shared<GdiAtlasSurface>();
+        surface->dc = Renderer::CreateDIBMemoryDC(m_width, m_height, &surface->bitmap, &surface->bits, GdiSubsystem::ATLAS);
+        if (!surface->dc) return false;
+        slot = surface;
+    }
+    GdiAtlasSurface* surface = static_cast<GdiAtlasSurface*>(slot.get());
+    if (surface->version != m_version) {
+        std::copy(m_pixels.begin(), m_pixels.end(), surface->bits);
+        surface->version = m_version;
+    }
+
+    int width = dest.right - dest.left;
+    int height = dest.bottom - dest.top;
+    if (width == entry->width && height == entry->height) {
+        BitBlt(hdc, dest.left, dest.top, width, height, surface->dc, entry->x, entry->y, SRCCOPY);
+    } else {
+        StretchBlt(hdc, dest.left, dest.top, width, height,
+                   surface->dc, entry->x, entry->y, entry->width, entry->height, SRCCOPY);
+    }
+    return true;
+#else
+    (void)hdc; (void)name; (void)dest;
+    return false;
+#endif
+}
+
+float TextureAtlas::GetOccupancy() const {
+    return (float)m_usedArea / ((float)m_width * (float)m_height);
+}
+
+} // namespace SDK
@@ -0,0 +1,24 @@
+#include "../../include/SDK/TileScheduler.h"
+#include "../../include/SDK/JobScheduler.h"
+#include <algorithm>
+
+namespace SDK {
+
+void TileScheduler::ParallelFor(int count, int grain, const std::function<void(int begin, int end)>& fn) {
+    JobScheduler::ParallelFor(count, grain, fn, "PixelTile");
+}
+
+void TileScheduler::ForEachRowBand(int width, int height, const std::function<void(int begin, int end)>& fn) {
+    int rows = (int)std::max<size_t>(TILE_SIZE, MIN_PARALLEL_PIXELS / (size_t)std::max(1, width));
+    ParallelFor(height, rows, fn);
+}
+
+void TileScheduler::ForEachColumnStrip(int width, int height, const std::function<void(int begin, int end)>& fn) {
+    if ((size_t)std::max(0, width) * (size_t)std::max(0, height) < MIN_PARALLEL_PIXELS) {
+        if (width > 0) fn(0, width);
+        return;
+    }
+    ParallelFor(width, TILE_SIZE, fn);
+}
+
+} // namespace SDK
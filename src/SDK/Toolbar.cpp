@@ -2,15 +2,19 @@
 #include "../../include/SDK/Renderer.h"
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <string>
 
 namespace SDK {
 
 // Animation constants
 constexpr float FADE_SPEED = 5.0f;
 constexpr float SLIDE_SPEED = 500.0f;
+constexpr float AUTO_HIDE_POLL_INTERVAL = 0.05f;    // Cursor polls while settled, when scheduled
 
 Toolbar::Toolbar()
     : Widget()
+    , m_revision(0)
     , m_orientation(Orientation::HORIZONTAL)
     , m_autoHide(false)
     , m_currentlyVisible(true)
@@ -35,12 +39,16 @@ Toolbar::Toolbar()
 }
 
 Toolbar::~Toolbar() {
+    for (auto& item : m_items) {
+        ReleaseItemIcon(item);
+    }
 }
 
 void Toolbar::AddItem(int id, const std::wstring& text, const std::wstring& tooltip) {
     ToolbarItem item(id, text);
     item.tooltip = tooltip;
     m_items.push_back(item);
+    m_revision++;
     CalculateLayout();
 }
 
@@ -52,17 +60,25 @@ void Toolbar::AddSeparator() {
 }
 
 void Toolbar::RemoveItem(int id) {
+    for (auto& item : m_items) {
+        if (item.id == id) ReleaseItemIcon(item);
+    }
     m_items.erase(
         std::remove_if(m_items.begin(), m_items.end(),
             [id](const ToolbarItem& item) { return item.id == id; }),
         m_items.end()
     );
+    m_revision++;
     CalculateLayout();
 }
 
 void Toolbar::ClearItems() {
+    for (auto& item : m_items) {
+        ReleaseItemIcon(item);
+    }
     m_items.clear();
     m_itemLayouts.clear();
+    m_revision++;
 }
 
 void Toolbar::SetItemEnabled(int id, bool enabled) {
@@ -74,15 +90,87 @@ void Toolbar::SetItemEnabled(int id, bool enabled) {
     }
 }
 
+void Toolbar::SetItemShortcut(int id, const std::wstring& shortcut) {
+    for (auto& item : m_items) {
+        if (item.id == id && !item.separator) {
+            if (item.shortcut != shortcut) {
+                item.shortcut = shortcut;
+                m_revision++;
+            }
+            break;
+        }
+    }
+}
+
+bool Toolbar::ClickItem(int id) {
+    for (auto& item : m_items) {
+        if (item.id == id && !item.separator) {
+            if (!item.enabled) return false;
+            if (m_itemClickCallback) {
+                m_itemClickCallback(id);
+            }
+            TriggerEvent(WidgetEvent::CLICK, &item.id);
+            return true;
+        }
+    }
+    return false;
+}
+
 void Toolbar::SetItemIcon(int id, HBITMAP icon) {
     for (auto& item : m_items) {
         if (item.id == id) {
+            ReleaseItemIcon(item);
+            if (!icon) break;
+            
+            BITMAP bm;
+            if (!GetObject(icon, sizeof(BITMAP), &bm)) break;
+            
             item.icon = icon;
+            item.iconName = GetIconKey(id);
+            TextureAtlas::GetShared().AddTexture(item.iconName, icon, bm.bmWidth, bm.bmHeight);
+            break;
+        }
+    }
+}
+
+void Toolbar::SetItemIcon(int id, const std::string& atlasName) {
+    for (auto& item : m_items) {
+        if (item.id == id) {
+            ReleaseItemIcon(item);
+            item.iconName = atlasName;
             break;
         }
     }
 }
 
+std::string Toolbar::GetIconKey(int id) const {
+    return "Toolbar:" + std::to_string((uintptr_t)this) + ":" + std::to_string(id);
+}
+
+const TextureAtlas::AtlasEntry* Toolbar::GetItemIcon(const ToolbarItem& item) const {
+    if (item.iconName.empty()) return nullptr;
+    
+    TextureAtlas& atlas = TextureAtlas::GetShared();
+    const TextureAtlas::AtlasEntry* entry = atlas.GetTexture(item.iconName);
+    if (!entry && item.icon) {
+        // Evicted to make room; copy it back from the caller's bitmap
+        BITMAP bm;
+        if (GetObject(item.icon, sizeof(BITMAP), &bm) &&
+            atlas.AddTexture(item.iconName, item.icon, bm.bmWidth, bm.bmHeight)) {
+            entry = atlas.GetTexture(item.iconName);
+        }
+    }
+    return entry;
+}
+
+void Toolbar::ReleaseItemIcon(ToolbarItem& item) {
+    if (item.icon) {
+        TextureAtlas::GetShared().RemoveTexture(item.iconName);
+    }
+    item.icon = nullptr;
+    item.iconName.clear();
+}
+
 void Toolbar::SetOrientation(Orientation orientation) {
     m_orientation = orientation;
     CalculateLayout();
@@ -90,6 +178,7 @@ void Toolbar::SetOrientation(Orientation orientation) {
 
 void Toolbar::SetAutoHide(bool autoHide) {
     m_autoHide = autoHide;
+    ScheduleUpdate();
     if (!autoHide) {
         m_currentlyVisible = true;
         m_visibilityAlpha = 1.0f;
@@ -169,6 +258,8 @@ void Toolbar::Render(HDC hdc) {
         return;
     }
     
+    ScopedFont font(hdc, GetFont());
+    
     // Save DC state
     int savedDC = SaveDC(hdc);
     
@@ -219,9 +310,8 @@ void Toolbar::RenderBackground(HDC hdc) {
         bgColor.a = static_cast<BYTE>(bgColor.a * m_visibilityAlpha);
     }
     
-    HBRUSH bgBrush = CreateSolidBrush(RGB(bgColor.r, bgColor.g, bgColor.b));
+    HBRUSH bgBrush = GdiObjectCache::GetBrush(RGB(bgColor.r, bgColor.g, bgColor.b));
     FillRect(hdc, &bgRect, bgBrush);
-    DeleteObject(bgBrush);
 }
 
 void Toolbar::RenderItems(HDC hdc) {
@@ -246,9 +336,8 @@ void Toolbar::RenderItem(HDC hdc, const ItemLayout& layout) {
             sepColor.a = static_cast<BYTE>(sepColor.a * m_visibilityAlpha);
         }
         
-        HBRUSH sepBrush = CreateSolidBrush(RGB(sepColor.r, sepColor.g, sepColor.b));
+        HBRUSH sepBrush = GdiObjectCache::GetBrush(RGB(sepColor.r, sepColor.g, sepColor.b));
         FillRect(hdc, &layout.rect, sepBrush);
-        DeleteObject(sepBrush);
         return;
     }
     
@@ -273,25 +362,18 @@ void Toolbar::RenderItem(HDC hdc, const ItemLayout& layout) {
     }
     
     // Draw item background
-    HBRUSH itemBrush = CreateSolidBrush(RGB(itemColor.r, itemColor.g, itemColor.b));
+    HBRUSH itemBrush = GdiObjectCache::GetBrush(RGB(itemColor.r, itemColor.g, itemColor.b));
     FillRect(hdc, &layout.rect, itemBrush);
-    DeleteObject(itemBrush);
     
     // Draw icon if present
-    if (layout.item->icon) {
-        HDC hdcMem = CreateCompatibleDC(hdc);
-        HBITMAP oldBitmap = (HBITMAP)SelectObject(hdcMem, layout.item->icon);
+    if (const TextureAtlas::AtlasEntry* icon = GetItemIcon(*layout.item)) {
+        RECT iconRect;
+        iconRect.left = layout.rect.left + (layout.rect.right - layout.rect.left - icon->width) / 2;
+        iconRect.top = layout.rect.top + 5;
+        iconRect.right = iconRect.left + icon->width;
+        iconRect.bottom = iconRect.top + icon->height;
         
-        BITMAP bm;
-        GetObject(layout.item->icon, sizeof(BITMAP), &bm);
-        
-        int iconX = layout.rect.left + (layout.rect.right - layout.rect.left - bm.bmWidth) / 2;
-        int iconY = layout.rect.top + 5;
-        
-        BitBlt(hdc, iconX, iconY, bm.bmWidth, bm.bmHeight, hdcMem, 0, 0, SRCCOPY);
-        
-        SelectObject(hdcMem, oldBitmap);
-        DeleteDC(hdcMem);
+        TextureAtlas::GetShared().Draw(hdc, layout.item->iconName, iconRect);
     }
     
     // Draw text
@@ -311,7 +393,7 @@ void Toolbar::RenderItem(HDC hdc, const ItemLayout& layout) {
         SetTextColor(hdc, RGB(textColor.r, textColor.g, textColor.b));
         
         RECT textRect = layout.rect;
-        if (layout.item->icon) {
+        if (!layout.item->iconName.empty()) {
             textRect.top += 30;
         }
         
@@ -321,7 +403,7 @@ void Toolbar::RenderItem(HDC hdc, const ItemLayout& layout) {
     
     // Draw border for hovered/pressed items
     if (layout.hovered || layout.pressed) {
-        HPEN borderPen = CreatePen(PS_SOLID, 1, RGB(100, 150, 255));
+        HPEN borderPen = GdiObjectCache::GetPen(RGB(100, 150, 255));
         HPEN oldPen = (HPEN)SelectObject(hdc, borderPen);
         HBRUSH oldBrush = (HBRUSH)SelectObject(hdc, GetStockObject(NULL_BRUSH));
         
@@ -330,7 +412,6 @@ void Toolbar::RenderItem(HDC hdc, const ItemLayout& layout) {
         
         SelectObject(hdc, oldPen);
         SelectObject(hdc, oldBrush);
-        DeleteObject(borderPen);
     }
 }
 
@@ -349,6 +430,13 @@ void Toolbar::Update(float deltaTime) {
     // (Assuming m_x, m_y are in client coordinates)
     
     UpdateAutoHideState(cursorPos.x, cursorPos.y, deltaTime);
+    
+    // Every frame while sliding or fading, else just often enough to catch the cursor
+    float hideOffset = (m_orientation == Orientation::HORIZONTAL) ?
+        static_cast<float>(-m_height) : static_cast<float>(-m_width);
+    bool settled = (m_visibilityAlpha == 0.0f && m_slideOffset == hideOffset) ||
+                   (m_visibilityAlpha == 1.0f && m_slideOffset == 0.0f);
+    ScheduleUpdate(settled ? AUTO_HIDE_POLL_INTERVAL : 0.0f);
 }
 
 void Toolbar::UpdateAutoHideState(int mouseX, int mouseY, float deltaTime) {
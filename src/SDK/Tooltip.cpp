@@ -4,6 +4,12 @@
 
 namespace SDK {
 
+namespace {
+    bool SameColor(const Color& a, const Color& b) {
+        return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+    }
+}
+
 Tooltip::Tooltip()
     : Widget()
     , m_text(L"")
@@ -11,7 +17,6 @@ Tooltip::Tooltip()
     , m_targetX(0)
     , m_targetY(0)
     , m_isShowing(false)
-    , m_opacity(0.0f)
     , m_fadeEnabled(true)
     , m_fadeSpeed(5.0f)
     , m_showDelay(0.5f)
@@ -26,15 +31,23 @@ Tooltip::Tooltip()
     m_width = 100;
     m_height = 30;
     m_visible = false;
+    m_opacity = 0.0f;
+    m_animated = true;
 }
 
 void Tooltip::SetText(const std::wstring& text) {
+    if (text == m_text) return;
+    
     m_text = text;
     ParseMultilineText();
+    Invalidate();
 }
 
 void Tooltip::SetLines(const std::vector<std::wstring>& lines) {
+    if (lines == m_lines) return;
+    
     m_lines = lines;
+    Invalidate();
     
     // Rebuild text from lines
     m_text.clear();
@@ -72,14 +85,15 @@ void Tooltip::Show(int x, int y) {
     m_targetX = x;
     m_targetY = y;
     
-    // Only reset timer if we're not already showing
+    // Only reset timer if we're not already showing; one still fading out fades back in
     if (!m_isShowing) {
-        m_delayTimer = 0.0f;
+        m_delayTimer = m_opacity > 0.0f ? m_showDelay : 0.0f;
     }
     
     m_isShowing = true;
-    m_visible = true;
     UpdatePosition();
+    SetVisible(true);
+    ScheduleUpdate();
 }
 
 void Tooltip::ShowNearWidget(const Widget* widget) {
@@ -101,12 +115,13 @@ void Tooltip::ShowAtCursor() {
 void Tooltip::Hide() {
     m_isShowing = false;
     m_delayTimer = 0.0f;
+    ScheduleUpdate();
 }
 
 void Tooltip::SetFadeEnabled(bool enabled) {
     m_fadeEnabled = enabled;
     if (!enabled) {
-        m_opacity = m_isShowing ? 1.0f : 0.0f;
+        SetOpacity(m_isShowing ? 1.0f : 0.0f);
     }
 }
 
@@ -118,37 +133,54 @@ void Tooltip::SetShowDelay(float seconds) {
     m_showDelay = std::max(0.0f, seconds);
 }
 
+// Appearance changes redraw the layer; nothing else does
 void Tooltip::SetBackgroundColor(Color color) {
+    if (SameColor(color, m_backgroundColor)) return;
     m_backgroundColor = color;
+    Invalidate();
 }
 
 void Tooltip::SetTextColor(Color color) {
+    if (SameColor(color, m_textColor)) return;
     m_textColor = color;
+    Invalidate();
 }
 
 void Tooltip::SetBorderColor(Color color) {
+    if (SameColor(color, m_borderColor)) return;
     m_borderColor = color;
+    Invalidate();
 }
 
 void Tooltip::SetShadowEnabled(bool enabled) {
+    if (enabled == m_shadowEnabled) return;
     m_shadowEnabled = enabled;
+    Invalidate();
 }
 
 void Tooltip::SetCornerRadius(int radius) {
-    m_cornerRadius = std::max(0, radius);
+    radius = std::max(0, radius);
+    if (radius == m_cornerRadius) return;
+    m_cornerRadius = radius;
+    Invalidate();
 }
 
 void Tooltip::SetPadding(int padding) {
-    m_padding = std::max(0, padding);
+    padding = std::max(0, padding);
+    if (padding == m_padding) return;
+    m_padding = padding;
+    Invalidate();
 }
 
 void Tooltip::AutoSize(HDC hdc) {
     if (m_lines.empty()) {
-        m_width = 100;
-        m_height = 30;
+        SetSize(100, 30);
         return;
     }
     
+    // Measure with the font Render uses
+    ScopedFont font(hdc, GetFont());
+    
     // Calculate required size for text
     int maxWidth = 0;
     int totalHeight = 0;
@@ -161,67 +193,63 @@ void Tooltip::AutoSize(HDC hdc) {
         }
     }
     
-    m_width = maxWidth + m_padding * 2;
-    m_height = totalHeight + m_padding * 2;
-    
+    SetSize(maxWidth + m_padding * 2, totalHeight + m_padding * 2);
     UpdatePosition();
 }
 
 void Tooltip::UpdatePosition() {
+    // A layered tooltip only recomposites when it moves
+    int x = m_targetX;
+    int y = m_targetY;
+    
     switch (m_positionMode) {
         case Position::AUTO:
         case Position::CURSOR:
             // Position near target with screen bounds checking
-            m_x = m_targetX;
-            m_y = m_targetY;
-            
-            // Check screen bounds and adjust if needed
             {
                 int screenWidth = GetSystemMetrics(SM_CXSCREEN);
                 int screenHeight = GetSystemMetrics(SM_CYSCREEN);
                 
                 // Ensure tooltip doesn't go off right edge
-                if (m_x + m_width > screenWidth) {
-                    m_x = screenWidth - m_width - 5;
+                if (x + m_width > screenWidth) {
+                    x = screenWidth - m_width - 5;
                 }
                 
                 // Ensure tooltip doesn't go off left edge
-                if (m_x < 0) {
-                    m_x = 5;
+                if (x < 0) {
+                    x = 5;
                 }
                 
                 // Ensure tooltip doesn't go off bottom edge
-                if (m_y + m_height > screenHeight) {
-                    m_y = screenHeight - m_height - 5;
+                if (y + m_height > screenHeight) {
+                    y = screenHeight - m_height - 5;
                 }
                 
                 // Ensure tooltip doesn't go off top edge
-                if (m_y < 0) {
-                    m_y = 5;
+                if (y < 0) {
+                    y = 5;
                 }
             }
             break;
             
         case Position::ABOVE:
-            m_x = m_targetX;
-            m_y = m_targetY - m_height - 5;
+            y = m_targetY - m_height - 5;
             break;
             
         case Position::BELOW:
-            m_x = m_targetX;
-            m_y = m_targetY + 5;
+            y = m_targetY + 5;
             break;
             
         case Position::LEFT:
-            m_x = m_targetX - m_width - 5;
-            m_y = m_targetY;
+            x = m_targetX - m_width - 5;
             break;
             
         case Position::RIGHT:
-            m_x = m_targetX + 5;
-            m_y = m_targetY;
+            x = m_targetX + 5;
             break;
     }
+    
+    SetPosition(x, y);
 }
 
 void Tooltip::Update(float deltaTime) {
@@ -229,50 +257,57 @@ void Tooltip::Update(float deltaTime) {
         // Handle show delay
         if (m_showDelay > 0.0f && m_delayTimer < m_showDelay) {
             m_delayTimer += deltaTime;
+            ScheduleUpdate(std::max(0.0f, m_showDelay - m_delayTimer));
             return;
         }
         
         // Fade in
         if (m_fadeEnabled && m_opacity < 1.0f) {
-            m_opacity += m_fadeSpeed * deltaTime;
-            m_opacity = std::min(1.0f, m_opacity);
+            SetOpacity(m_opacity + m_fadeSpeed * deltaTime);
+            ScheduleUpdate();
         } else if (!m_fadeEnabled) {
-            m_opacity = 1.0f;
+            SetOpacity(1.0f);
         }
     } else {
         // Fade out
         if (m_fadeEnabled && m_opacity > 0.0f) {
-            m_opacity -= m_fadeSpeed * deltaTime;
-            m_opacity = std::max(0.0f, m_opacity);
+            SetOpacity(m_opacity - m_fadeSpeed * deltaTime);
             
             if (m_opacity <= 0.0f) {
-                m_visible = false;
+                SetVisible(false);
+            } else {
+                ScheduleUpdate();
             }
         } else if (!m_fadeEnabled) {
-            m_opacity = 0.0f;
-            m_visible = false;
+            SetOpacity(0.0f);
+            SetVisible(false);
         }
     }
 }
 
 void Tooltip::Render(HDC hdc) {
-    if (!m_visible || m_opacity <= 0.0f) return;
+    if (!m_visible) return;
+    
+    // A layer is drawn opaque, whatever the fade, and blended with the opacity
+    // when composited; drawn directly, the fade and delay apply here
+    bool layered = HasLayer();
+    if (!layered && (m_opacity <= 0.0f || m_delayTimer < m_showDelay)) return;
+    float opacity = layered ? 1.0f : m_opacity;
     
-    // Skip if delay not passed
-    if (m_delayTimer < m_showDelay) return;
+    ScopedFont font(hdc, GetFont());
     
     RECT bounds;
     GetBounds(bounds);
     
     // Apply opacity to colors
     Color bgColor = m_backgroundColor;
-    bgColor.a = (BYTE)(m_backgroundColor.a * m_opacity);
+    bgColor.a = (BYTE)(m_backgroundColor.a * opacity);
     
     Color borderColor = m_borderColor;
-    borderColor.a = (BYTE)(m_borderColor.a * m_opacity);
+    borderColor.a = (BYTE)(m_borderColor.a * opacity);
     
     // Note: Text color opacity is limited by GDI's SetTextColor which doesn't support alpha.
-    // For full text fade effect, would need to render text to a memory bitmap and alpha blend.
+    // Layered tooltips fade their text with the rest of the layer.
     Color textColor = m_textColor;
     
     // Draw shadow
@@ -283,7 +318,7 @@ void Tooltip::Render(HDC hdc) {
         shadowRect.right += 2;
         shadowRect.bottom += 2;
         
-        Color shadowColor(0, 0, 0, (BYTE)(100 * m_opacity));
+        Color shadowColor(0, 0, 0, (BYTE)(100 * opacity));
         Renderer::DrawShadow(hdc, shadowRect, 2, 2, 4, shadowColor);
     }
     
@@ -292,17 +327,15 @@ void Tooltip::Render(HDC hdc) {
         Renderer::DrawRoundedRect(hdc, bounds, m_cornerRadius, 
             bgColor, borderColor, 1);
     } else {
-        HBRUSH bgBrush = CreateSolidBrush(RGB(bgColor.r, bgColor.g, bgColor.b));
+        HBRUSH bgBrush = GdiObjectCache::GetBrush(RGB(bgColor.r, bgColor.g, bgColor.b));
         FillRect(hdc, &bounds, bgBrush);
-        DeleteObject(bgBrush);
         
-        HPEN borderPen = CreatePen(PS_SOLID, 1, RGB(borderColor.r, borderColor.g, borderColor.b));
+        HPEN borderPen = GdiObjectCache::GetPen(RGB(borderColor.r, borderColor.g, borderColor.b));
         HPEN oldPen = (HPEN)SelectObject(hdc, borderPen);
         HBRUSH oldBrush = (HBRUSH)SelectObject(hdc, GetStockObject(NULL_BRUSH));
         Rectangle(hdc, bounds.left, bounds.top, bounds.right, bounds.bottom);
         SelectObject(hdc, oldPen);
         SelectObject(hdc, oldBrush);
-        DeleteObject(borderPen);
     }
     
     // Draw text
@@ -0,0 +1,221 @@
+#include "../../include/SDK/UpdateScheduler.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+namespace SDK {
+
+namespace {
+    constexpr uint64_t NEXT_FRAME = 0;     // Ms times start at 1
+
+    // RequestWake() widgets no scheduler has taken yet; the count spares the
+    // lock while there are none
+    std::mutex g_wakeMutex;
+    std::vector<Widget*> g_wakeRequests;
+    std::atomic<size_t> g_wakeRequestCount(0);
+}
+
+UpdateScheduler::UpdateScheduler()
+    : m_origin(Clock::now())
+    , m_cursor(1)
+    , m_slots(SLOT_COUNT)
+    , m_dueNext(0)
+    , m_scheduled(0)
+{
+}
+
+uint64_t UpdateScheduler::ToTicks(Clock::time_point time) const {
+    if (time <= m_origin) return 1;
+    return (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(time - m_origin).count() + 1;
+}
+
+void UpdateScheduler::Register(Widget* widget) {
+    if (!widget) return;
+    m_states.emplace(widget, State{ NEVER, Clock::now() });
+    WakeNextFrame(widget);
+}
+
+void UpdateScheduler::Unregister(Widget* widget) {
+    auto it = m_states.find(widget);
+    if (it == m_states.end()) return;
+    if (it->second.deadline != NEVER) m_scheduled--;
+    m_states.erase(it);
+
+    // Slot entries go stale without the state; the due list holds raw pointers
+    for (size_t i = m_dueNext; i < m_due.size(); i++) {
+        if (m_due[i] == widget) m_due[i] = nullptr;
+    }
+}
+
+bool UpdateScheduler::IsRegistered(const Widget* widget) const {
+    return m_states.count(widget) != 0;
+}
+
+void UpdateScheduler::Clear() {
+    m_states.clear();
+    for (auto& slot : m_slots) {
+        slot.clear();
+    }
+    m_nextFrame.clear();
+    m_due.clear();
+    m_dueNext = 0;
+    m_scheduled = 0;
+}
+
+void UpdateScheduler::Schedule(Widget* widget, State& state, uint64_t deadline) {
+    if (state.deadline <= deadline) return;
+    if (state.deadline == NEVER) m_scheduled++;
+    state.deadline = deadline;
+
+    if (deadline == NEXT_FRAME) {
+        m_nextFrame.push_back(widget);
+    } else {
+        m_slots[(deadline / SLOT_MS) % SLOT_COUNT].push_back({ widget, deadline });
+    }
+}
+
+void UpdateScheduler::WakeNextFrame(Widget* widget) {
+    auto it = m_states.find(widget);
+    if (it != m_states.end()) Schedule(widget, it->second, NEXT_FRAME);
+}
+
+void UpdateScheduler::WakeAfter(Widget* widget, float seconds) {
+    auto it = m_states.find(widget);
+    if (it == m_states.end()) return;
+    if (seconds <= 0.0f) {
+        Schedule(widget, it->second, NEXT_FRAME);
+        return;
+    }
+    uint64_t deadline = ToTicks(Clock::now()) + (uint64_t)(seconds * 1000.0f);
+    Schedule(widget, it->second, std::max(deadline, m_cursor + 1));
+}
+
+void UpdateScheduler::RequestWake(Widget* widget) {
+    if (!widget) return;
+    std::lock_guard<std::mutex> lock(g_wakeMutex);
+    if (std::find(g_wakeRequests.begin(), g_wakeRequests.end(), widget) != g_wakeRequests.end()) return;
+    g_wakeRequests.push_back(widget);
+    g_wakeRequestCount.store(g_wakeRequests.size(), std::memory_order_release);
+}
+
+void UpdateScheduler::CancelWake(Widget* widget) {
+    if (g_wakeRequestCount.load(std::memory_order_acquire) == 0) return;
+    std::lock_guard<std::mutex> lock(g_wakeMutex);
+    g_wakeRequests.erase(std::remove(g_wakeRequests.begin(), g_wakeRequests.end(), widget), g_wakeRequests.end());
+    g_wakeRequestCount.store(g_wakeRequests.size(), std::memory_order_release);
+}
+
+// Requests for widgets registered elsewhere stay for their own scheduler
+void UpdateScheduler::TakeWakeRequests() {
+    if (g_wakeRequestCount.load(std::memory_order_acquire) == 0) return;
+    std::lock_guard<std::mutex> lock(g_wakeMutex);
+    size_t kept = 0;
+    for (Widget* widget : g_wakeRequests) {
+        if (IsRegistered(widget)) {
+            WakeNextFrame(widget);
+        } else {
+            g_wakeRequests[kept++] = widget;
+        }
+    }
+    g_wakeRequests.resize(kept);
+    g_wakeRequestCount.store(kept, std::memory_order_release);
+}
+
+bool UpdateScheduler::HasWakeRequest() const {
+    if (g_wakeRequestCount.load(std::memory_order_acquire) == 0) return false;
+    std::lock_guard<std::mutex> lock(g_wakeMutex);
+    for (Widget* widget : g_wakeRequests) {
+        if (IsRegistered(widget)) return true;
+    }
+    return false;
+}
+
+void UpdateScheduler::CollectDue(Clock::time_point now) {
+    TakeWakeRequests();
+    uint64_t nowTicks = std::max(ToTicks(now), m_cursor);
+    m_due.clear();
+    m_dueNext = 0;
+
+    // Taking a widget clears its deadline, so duplicate entries find it stale
+    auto take = [this](Widget* widget, uint64_t deadline) {
+        auto it = m_states.find(widget);
+        if (it == m_states.end() || it->second.deadline != deadline) return false;
+        it->second.deadline = NEVER;
+        m_scheduled--;
+        m_due.push_back(widget);
+        return true;
+    };
+
+    for (Widget* widget : m_nextFrame) {
+        take(widget, NEXT_FRAME);
+    }
+    m_nextFrame.clear();
+
+    // Slots passed since the last collection; a long gap visits the ring once
+    uint64_t firstSlot = m_cursor / SLOT_MS;
+    uint64_t lastSlot = std::min(nowTicks / SLOT_MS, firstSlot + SLOT_COUNT - 1);
+    for (uint64_t slotIndex = firstSlot; slotIndex <= lastSlot; slotIndex++) {
+        auto& slot = m_slots[slotIndex % SLOT_COUNT];
+        size_t kept = 0;
+        for (size_t i = 0; i < slot.size(); i++) {
+            SlotEntry entry = slot[i];
+            auto it = m_states.find(entry.widget);
+            if (it == m_states.end() || it->second.deadline != entry.deadline) continue;   // Stale
+            if (entry.deadline <= nowTicks) {
+                take(entry.widget, entry.deadline);
+            } else {
+                slot[kept++] = entry;       // A later turn
+            }
+        }
+        slot.resize(kept);
+    }
+    m_cursor = nowTicks;
+}
+
+Widget* UpdateScheduler::PopDue(float& deltaTime) {
+    Clock::time_point now = Clock::now();
+    while (m_dueNext < m_due.size()) {
+        Widget* widget = m_due[m_dueNext++];
+        if (!widget) continue;
+        auto it = m_states.find(widget);
+        if (it == m_states.end()) continue;
+
+        deltaTime = std::chrono::duration<float>(now - it->second.lastTick).count();
+        it->second.lastTick = now;
+        return widget;
+    }
+    m_due.clear();
+    m_dueNext = 0;
+    return nullptr;
+}
+
+float UpdateScheduler::GetTimeUntilNextWake(Clock::time_point now) const {
+    if (HasWakeRequest()) return 0.0f;
+    if (m_scheduled == 0) return -1.0f;
+    for (Widget* widget : m_nextFrame) {
+        auto it = m_states.find(widget);
+        if (it != m_states.end() && it->second.deadline == NEXT_FRAME) return 0.0f;
+    }
+
+    // Walk the ring from the cursor; the first slot holding a deadline of
+    // this turn has the earliest one, else the minimum is a later turn's
+    uint64_t earliest = NEVER;
+    uint64_t firstSlot = m_cursor / SLOT_MS;
+    for (uint64_t slotIndex = firstSlot; slotIndex < firstSlot + SLOT_COUNT; slotIndex++) {
+        uint64_t turnEnd = (slotIndex + 1) * SLOT_MS;
+        bool inTurn = false;
+        for (const SlotEntry& entry : m_slots[slotIndex % SLOT_COUNT]) {
+            auto it = m_states.find(entry.widget);
+            if (it == m_states.end() || it->second.deadline != entry.deadline) continue;
+            earliest = std::min(earliest, entry.deadline);
+            inTurn |= entry.deadline < turnEnd;
+        }
+        if (inTurn) break;
+    }
+    if (earliest == NEVER) return -1.0f;
+
+    uint64_t nowTicks = ToTicks(now);
+    return earliest > nowTicks ? (earliest - nowTicks) / 1000.0f : 0.0f;
+}
+
+} // namespace SDK
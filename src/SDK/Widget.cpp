@@ -1,39 +1,127 @@
 #include "../../include/SDK/Widget.h"
 #include "../../include/SDK/Renderer.h"
+#include "../../include/SDK/EventQueue.h"
+#include "../../include/SDK/WidgetManager.h"
+#include "../../include/SDK/UpdateScheduler.h"
+#include "../../include/SDK/WidgetSpatialIndex.h"
+#include "../../include/SDK/RenderBackend.h"
+#include "../../include/SDK/TextureAtlas.h"
 #include <algorithm>
+#include <cmath>
+#include <atomic>
+
+#if !SDK_PLATFORM_WINDOWS
+#include "../../include/SDK/StringUtils.h"
+#include <sys/stat.h>
+#endif
 
 namespace SDK {
 
+namespace {
+    std::atomic<uint64_t> g_geometryEpoch(0);
+    
+    constexpr size_t MAX_UNDO_STEPS = 100;
+    
+    // Larger images keep their own bitmap rather than crowding out icons
+    constexpr int MAX_ATLAS_IMAGE_SIZE = 256;
+    
+    const Color LABEL_TEXT_COLOR(50, 50, 50, 255);
+    
+    RenderBackend::TextAlign ToTextAlign(UINT format) {
+        if (format & DT_CENTER) return RenderBackend::TextAlign::CENTER;
+        if (format & DT_RIGHT) return RenderBackend::TextAlign::RIGHT;
+        return RenderBackend::TextAlign::LEFT;
+    }
+    
+    // UnionRect without GDI: empty rects add nothing
+    void UnionInto(RECT& rect, const RECT& other) {
+        if (other.right <= other.left || other.bottom <= other.top) return;
+        if (rect.right <= rect.left || rect.bottom <= rect.top) {
+            rect = other;
+            return;
+        }
+        rect.left = std::min(rect.left, other.left);
+        rect.top = std::min(rect.top, other.top);
+        rect.right = std::max(rect.right, other.right);
+        rect.bottom = std::max(rect.bottom, other.bottom);
+    }
+    
+    // Backends have no polygon primitive; fill row by row between the edges
+    void FillTriangle(RenderBackend& backend, const POINT triangle[3], Color color) {
+        int top = std::min({ triangle[0].y, triangle[1].y, triangle[2].y });
+        int bottom = std::max({ triangle[0].y, triangle[1].y, triangle[2].y });
+        
+        for (int y = top; y <= bottom; y++) {
+            float left = 1e9f, right = -1e9f;
+            for (int i = 0; i < 3; i++) {
+                const POINT& a = triangle[i];
+                const POINT& b = triangle[(i + 1) % 3];
+                if ((y < a.y && y < b.y) || (y > a.y && y > b.y)) continue;
+                
+                float x = (a.y == b.y) ? (float)a.x
+                    : a.x + (float)(b.x - a.x) * (y - a.y) / (float)(b.y - a.y);
+                left = std::min(left, a.y == b.y ? (float)std::min(a.x, b.x) : x);
+                right = std::max(right, a.y == b.y ? (float)std::max(a.x, b.x) : x);
+            }
+            if (left <= right) {
+                RECT row = { (LONG)(left + 0.5f), y, (LONG)(right + 0.5f) + 1, y + 1 };
+                backend.DrawRectangle(row, color, color, 0.0f);
+            }
+        }
+    }
+}
+
 // Widget base class implementation
 Widget::Widget()
     : m_x(0), m_y(0), m_width(100), m_height(30)
-    , m_visible(true), m_enabled(true), m_focused(false), m_hovered(false)
+    , m_id(0)
+    , m_zIndex(0)
+    , m_tag(nullptr)
     , m_parent(nullptr)
-    , m_name(L"")
-    , m_paddingLeft(0), m_paddingTop(0), m_paddingRight(0), m_paddingBottom(0)
-    , m_marginLeft(0), m_marginTop(0), m_marginRight(0), m_marginBottom(0)
-    , m_minWidth(0), m_minHeight(0)
-    , m_maxWidth(65535), m_maxHeight(65535)
+    , m_tree(nullptr)
+    , m_manager(nullptr)
+    , m_managerSlot(0)
+    , m_style(WidgetStyle::GetDefault())
+    , m_geometryVersion(0)
     , m_opacity(1.0f)
-    , m_borderWidth(0)
-    , m_borderRadius(0)
-    , m_tooltipText(L"")
-    , m_cursor(nullptr)
-    , m_zIndex(0)
-    , m_fontFamily(L"Segoe UI")
-    , m_fontSize(12)
-    , m_fontBold(false)
-    , m_fontItalic(false)
-    , m_alignment(WidgetAlignment::NONE)
+    , m_dpi(96)
+    , m_detailLevel(0)
+    , m_layerScale(1.0f)
+    , m_contentVersion(0)
+    , m_visible(true), m_enabled(true), m_focused(false), m_hovered(false)
+    , m_layoutDirty(true)
+    , m_animated(false)
+    , m_eventDelivery(EventDelivery::IMMEDIATE)
 {
 }
 
 Widget::~Widget() {
+    if (m_eventDelivery == EventDelivery::COALESCED) {
+        EventQueue::Cancel(this);
+    }
+    UpdateScheduler::CancelWake(this);
+    // Children kept alive elsewhere leave the tree with this widget
+    DetachFromTree();
 }
 
 void Widget::SetPosition(int x, int y) {
+    if (m_x == x && m_y == y) return;
+    
+    // A leaf layer moves as a whole; children don't follow their parent
+    if (HasLayer() && m_children.empty()) {
+        InvalidateLayer();
+        m_x = x;
+        m_y = y;
+        NotifyGeometryChanged();
+        InvalidateLayer();
+        return;
+    }
+    
+    Invalidate();
     m_x = x;
     m_y = y;
+    NotifyGeometryChanged();
+    Invalidate();
 }
 
 void Widget::GetPosition(int& x, int& y) const {
@@ -43,13 +131,19 @@ void Widget::GetPosition(int& x, int& y) const {
 
 void Widget::SetSize(int width, int height) {
     // Apply min/max constraints
-    if (width < m_minWidth) width = m_minWidth;
-    if (height < m_minHeight) height = m_minHeight;
-    if (width > m_maxWidth) width = m_maxWidth;
-    if (height > m_maxHeight) height = m_maxHeight;
-    
+    const WidgetStyle& style = *m_style;
+    if (width < style.minWidth) width = style.minWidth;
+    if (height < style.minHeight) height = style.minHeight;
+    if (width > style.maxWidth) width = style.maxWidth;
+    if (height > style.maxHeight) height = style.maxHeight;
+    if (m_width == width && m_height == height) return;
+    
+    Invalidate();
     m_width = width;
     m_height = height;
+    NotifyGeometryChanged();
+    InvalidateLayout();
+    Invalidate();
 }
 
 void Widget::GetSize(int& width, int& height) const {
@@ -58,10 +152,17 @@ void Widget::GetSize(int& width, int& height) const {
 }
 
 void Widget::SetBounds(int x, int y, int width, int height) {
+    if (m_x == x && m_y == y && m_width == width && m_height == height) return;
+    
+    bool resized = m_width != width || m_height != height;
+    Invalidate();
     m_x = x;
     m_y = y;
     m_width = width;
     m_height = height;
+    NotifyGeometryChanged();
+    if (resized) InvalidateLayout();
+    Invalidate();
 }
 
 void Widget::GetBounds(RECT& rect) const {
@@ -72,16 +173,23 @@ void Widget::GetBounds(RECT& rect) const {
 }
 
 void Widget::SetVisible(bool visible) {
+    if (m_visible == visible) return;
+    
     m_visible = visible;
+    InvalidateRegion(GetInvalidateRect());
 }
 
 void Widget::SetEnabled(bool enabled) {
+    if (m_enabled == enabled) return;
+    
     m_enabled = enabled;
+    Invalidate();
 }
 
 void Widget::SetHovered(bool hovered) {
     if (m_hovered != hovered) {
         m_hovered = hovered;
+        Invalidate();
         if (hovered) {
             OnMouseEnter();
         } else {
@@ -97,7 +205,7 @@ bool Widget::HitTest(int x, int y) const {
 }
 
 void Widget::Update(float deltaTime) {
-    if (!m_visible) return;
+    if (!m_visible || IsUpdateScheduled()) return;
     
     // Update children
     for (auto& child : m_children) {
@@ -132,10 +240,36 @@ void Widget::OnClick() {
 void Widget::SetFocused(bool focused) {
     if (m_focused != focused) {
         m_focused = focused;
+        Invalidate();
         TriggerEvent(focused ? WidgetEvent::FOCUS_GAINED : WidgetEvent::FOCUS_LOST);
     }
 }
 
+void Widget::SetId(int id) {
+    if (m_id == id) return;
+    
+    int previous = m_id;
+    m_id = id;
+#if SDK_PLATFORM_WINDOWS
+    if (m_manager) m_manager->ReindexId(this, previous);
+#else
+    (void)previous;
+#endif
+}
+
+void Widget::SetName(const std::wstring& name) {
+    InternedString interned(name);
+    if (m_name == interned) return;
+    
+    InternedString previous = m_name;
+    m_name = interned;
+#if SDK_PLATFORM_WINDOWS
+    if (m_manager) m_manager->ReindexName(this, previous);
+#else
+    (void)previous;
+#endif
+}
+
 void Widget::SetParent(Widget* parent) {
     m_parent = parent;
 }
@@ -143,13 +277,69 @@ void Widget::SetParent(Widget* parent) {
 void Widget::AddChild(std::shared_ptr<Widget> child) {
     child->SetParent(this);
     m_children.push_back(child);
+    if (m_tree) {
+        child->AttachToTree(m_tree, m_treeHandle);
+    } else {
+        child->DetachFromTree();
+    }
+    InvalidateLayout();
 }
 
 void Widget::RemoveChild(std::shared_ptr<Widget> child) {
     auto it = std::find(m_children.begin(), m_children.end(), child);
     if (it != m_children.end()) {
         (*it)->SetParent(nullptr);
+        (*it)->DetachFromTree();
         m_children.erase(it);
+        InvalidateLayout();
+    }
+}
+
+void Widget::AttachToTree(WidgetTree* tree, WidgetHandle parent) {
+    DetachFromTree();
+    if (!tree) return;
+    
+    m_tree = tree;
+    m_treeHandle = tree->Insert(this, parent);
+    if (UpdateScheduler* scheduler = tree->GetUpdateScheduler()) {
+        scheduler->Register(this);
+    }
+    for (auto& child : m_children) {
+        child->AttachToTree(tree, m_treeHandle);
+    }
+}
+
+void Widget::DetachFromTree() {
+    if (!m_tree) return;
+    
+    m_tree->Remove(m_treeHandle);
+    ClearTreeLinks();
+}
+
+void Widget::ClearTreeLinks() {
+    if (!m_tree) return;
+    if (UpdateScheduler* scheduler = m_tree->GetUpdateScheduler()) {
+        scheduler->Unregister(this);
+    }
+    m_tree = nullptr;
+    m_treeHandle = WidgetHandle();
+    for (auto& child : m_children) {
+        child->ClearTreeLinks();
+    }
+}
+
+void Widget::ScheduleUpdate(float delay) {
+    if (!IsUpdateScheduled()) return;
+    m_tree->GetUpdateScheduler()->WakeAfter(this, delay);
+}
+
+bool Widget::IsUpdateScheduled() const {
+    return m_tree && m_tree->GetUpdateScheduler();
+}
+
+void Widget::InvalidateLayout() {
+    for (Widget* widget = this; widget; widget = widget->m_parent) {
+        widget->m_layoutDirty = true;
     }
 }
 
@@ -162,11 +352,163 @@ void Widget::Render(HDC hdc) {
     }
 }
 
+bool Widget::IsTreeRenderThreadSafe() const {
+    if (!IsRenderThreadSafe()) return false;
+    for (const auto& child : m_children) {
+        if (!child->IsTreeRenderThreadSafe()) return false;
+    }
+    return true;
+}
+
+void Widget::GetPaintBounds(RECT& rect) const {
+    GetBounds(rect);
+    
+    // Attached widgets scan their subtree's range of the flat order
+    if (m_tree && m_tree->Contains(m_treeHandle)) {
+        const auto& order = m_tree->GetOrder();
+        uint32_t first = m_tree->GetOrderIndex(m_treeHandle);
+        uint32_t end = order[first].subtreeEnd;
+        for (uint32_t i = first + 1; i < end;) {
+            const Widget* widget = order[i].widget;
+            if (!widget->IsVisible()) {
+                i = order[i].subtreeEnd;
+                continue;
+            }
+            
+            RECT childRect;
+            widget->GetBounds(childRect);
+            if (childRect.right > childRect.left && childRect.bottom > childRect.top) {
+                UnionInto(rect, childRect);
+            }
+            i++;
+        }
+        return;
+    }
+    
+    for (const auto& child : m_children) {
+        if (!child->IsVisible()) continue;
+        
+        RECT childRect;
+        child->GetPaintBounds(childRect);
+        if (childRect.right <= childRect.left || childRect.bottom <= childRect.top) continue;
+        UnionInto(rect, childRect);
+    }
+}
+
+void Widget::SetAnimated(bool animated) {
+    if (m_animated == animated) return;
+    
+    // The scale only applies while composited
+    InvalidateLayer();
+    m_animated = animated;
+    InvalidateLayer();
+}
+
+void Widget::SetLayerScale(float scale) {
+    scale = std::max(scale, 0.0f);
+    if (m_layerScale == scale) return;
+    
+    InvalidateLayer();
+    m_layerScale = scale;
+    InvalidateLayer();
+}
+
+void Widget::GetLayerBounds(RECT& rect) const {
+    RECT margin = GetInvalidateRect();
+    GetPaintBounds(rect);
+    UnionInto(rect, margin);
+}
+
+void Widget::ApplyLayerTransform(RECT& rect) const {
+    if (!HasLayer() || m_layerScale == 1.0f) return;
+    
+    float cx = m_x + m_width * 0.5f;
+    float cy = m_y + m_height * 0.5f;
+    rect.left = (LONG)std::floor(cx + (rect.left - cx) * m_layerScale);
+    rect.top = (LONG)std::floor(cy + (rect.top - cy) * m_layerScale);
+    rect.right = (LONG)std::ceil(cx + (rect.right - cx) * m_layerScale);
+    rect.bottom = (LONG)std::ceil(cy + (rect.bottom - cy) * m_layerScale);
+}
+
+void Widget::GetCompositeBounds(RECT& rect) const {
+    if (!HasLayer()) {
+        GetBounds(rect);
+        return;
+    }
+    GetLayerBounds(rect);
+    ApplyLayerTransform(rect);
+}
+
+#if SDK_PLATFORM_WINDOWS
+int Widget::CullOccluded(const std::vector<std::shared_ptr<Widget>>& widgets, std::vector<uint8_t>& hidden) {
+    // Only the topmost occluders are kept; past that the test costs more than it saves
+    static constexpr size_t MAX_OCCLUDERS = 64;
+    thread_local std::vector<RECT> occluders;
+    occluders.clear();
+    hidden.assign(widgets.size(), 0);
+    
+    int count = 0;
+    for (size_t i = widgets.size(); i-- > 0;) {
+        const Widget& widget = *widgets[i];
+        if (!widget.IsVisible()) continue;
+        
+        RECT paint;
+        widget.GetPaintBounds(paint);
+        widget.ApplyLayerTransform(paint);
+        if (!occluders.empty() && Renderer::IsRectOccluded(paint, occluders)) {
+            hidden[i] = 1;
+            count++;
+            continue;
+        }
+        
+        RECT opaque;
+        bool scaled = widget.HasLayer() && widget.GetLayerScale() != 1.0f;
+        if (occluders.size() < MAX_OCCLUDERS && widget.GetOpacity() >= 1.0f && !scaled &&
+            widget.GetOpaqueBounds(opaque)) {
+            occluders.push_back(opaque);
+        }
+    }
+    return count;
+}
+#endif
+
+bool Widget::GetRoundedOpaqueBounds(const Color& color, int radius, RECT& rect) const {
+    if (!m_visible || color.a < 255) return false;
+    
+    // A rect inset by r(1 - 1/sqrt(2)) stays clear of the rounded corners
+    int inset = (radius * 3 + 9) / 10;
+    GetBounds(rect);
+    rect.left += inset;
+    rect.top += inset;
+    rect.right -= inset;
+    rect.bottom -= inset;
+    return rect.right > rect.left && rect.bottom > rect.top;
+}
+
+void Widget::Render(RenderBackend& backend) {
+    if (!m_visible) return;
+    
+    HDC hdc = backend.BeginGDIInterop();
+    if (!hdc) return;
+    
+    Render(hdc);
+    backend.EndGDIInterop(hdc);
+}
+
+void Widget::RenderChildren(RenderBackend& backend) {
+    for (auto& child : m_children) {
+        child->Render(backend);
+    }
+}
+
 bool Widget::HandleMouseMove(int x, int y) {
     if (!m_visible || !m_enabled) return false;
     
     bool wasHovered = m_hovered;
     m_hovered = HitTest(x, y);
+    if (m_hovered != wasHovered) {
+        Invalidate();
+    }
     
     if (m_hovered && !wasHovered) {
         TriggerEvent(WidgetEvent::MOUSE_ENTER);
@@ -219,6 +561,17 @@ bool Widget::HandleMouseUp(int x, int y, int button) {
     return HitTest(x, y);
 }
 
+bool Widget::HandleMouseWheel(int x, int y, int delta) {
+    if (!m_visible || !m_enabled) return false;
+    
+    for (auto& child : m_children) {
+        if (child->HandleMouseWheel(x, y, delta)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 bool Widget::HandleKeyDown(int keyCode) {
     if (!m_visible || !m_enabled || !m_focused) return false;
     
@@ -241,7 +594,99 @@ bool Widget::HandleChar(wchar_t ch) {
     return false;
 }
 
+uint64_t Widget::GetGeometryEpoch() {
+    return g_geometryEpoch.load(std::memory_order_relaxed);
+}
+
+#if SDK_PLATFORM_WINDOWS
+FontCache::FontPtr Widget::GetFont(bool bold) const {
+    const WidgetStyle& style = *m_style;
+    return FontCache::Get(style.fontFamily, style.fontSize, (bold || style.fontBold) ? FW_BOLD : FW_NORMAL,
+                          style.fontItalic, false, false, m_dpi);
+}
+#endif
+
+void Widget::NotifyGeometryChanged() {
+    m_geometryVersion++;
+    g_geometryEpoch.fetch_add(1, std::memory_order_relaxed);
+    for (WidgetSpatialIndex* index : m_spatialIndexes) {
+        index->MarkDirty(this);
+    }
+}
+
+void Widget::Invalidate() {
+    // Hidden widgets have nothing on screen to repaint
+    if (!m_visible) {
+        MarkContentChanged();
+        return;
+    }
+    InvalidateRegion(GetInvalidateRect());
+}
+
+void Widget::InvalidateRegion(const RECT& rect) {
+    MarkContentChanged();
+    PropagateInvalidate(rect);
+}
+
+void Widget::InvalidateLayer() {
+    if (!m_visible) return;
+    
+    RECT rect;
+    GetLayerBounds(rect);
+    PropagateInvalidate(rect);
+}
+
+void Widget::MarkContentChanged() {
+    // Layers containing this widget are out of date too
+    for (Widget* widget = this; widget; widget = widget->m_parent) {
+        widget->m_contentVersion++;
+    }
+}
+
+void Widget::PropagateInvalidate(const RECT& rect) {
+    if (rect.right <= rect.left || rect.bottom <= rect.top) return;
+    
+    if (m_invalidateHandler) {
+        // Only a top-level widget has a layer; its content lands transformed
+        RECT target = rect;
+        ApplyLayerTransform(target);
+        (*m_invalidateHandler)(target);
+    } else if (m_parent) {
+        m_parent->PropagateInvalidate(rect);
+    }
+}
+
+RECT Widget::GetInvalidateRect() const {
+    // Borders, focus rings and thumbs may paint slightly outside the bounds
+    RECT rect;
+    GetBounds(rect);
+    int margin = INVALIDATE_MARGIN + m_style->borderWidth;
+    rect.left -= margin;
+    rect.top -= margin;
+    rect.right += margin;
+    rect.bottom += margin;
+    return rect;
+}
+
+void Widget::SetEventCallback(EventCallback callback, EventDelivery delivery) {
+    if (m_eventDelivery == EventDelivery::COALESCED) {
+        EventQueue::Cancel(this);
+    }
+    m_eventCallback = std::move(callback);
+    m_eventDelivery = delivery;
+}
+
 void Widget::TriggerEvent(WidgetEvent event, void* data) {
+    if (!m_eventCallback) return;
+    
+    if (m_eventDelivery == EventDelivery::COALESCED) {
+        EventQueue::Post(this, event, data);
+    } else {
+        m_eventCallback(this, event, data);
+    }
+}
+
+void Widget::DeliverEvent(WidgetEvent event, void* data) {
     if (m_eventCallback) {
         m_eventCallback(this, event, data);
     }
@@ -435,8 +880,11 @@ Button::~Button() {
 }
 
 void Button::Render(HDC hdc) {
+#if SDK_PLATFORM_WINDOWS
     if (!m_visible) return;
     
+    ScopedFont font(hdc, GetFont());
+    
     RECT bounds; GetBounds(bounds);
     
     // Choose color based on state
@@ -447,16 +895,51 @@ void Button::Render(HDC hdc) {
         bgColor = m_hoverColor;
     }
     
-    // Draw button background
-    Renderer::DrawRoundedRect(hdc, bounds, 8, bgColor, Color(0, 0, 0, 100), 1);
+    // Draw button background; flat at reduced detail
+    if (m_detailLevel > 0) {
+        HBRUSH brush = GdiObjectCache::GetBrush(bgColor.ToCOLORREF());
+        FillRect(hdc, &bounds, brush);
+    } else {
+        Renderer::DrawRoundedRect(hdc, bounds, 8, bgColor, Color(0, 0, 0, 100), 1);
+    }
     
     // Draw text
-    SetBkMode(hdc, TRANSPARENT);
-    SetTextColor(hdc, m_textColor.ToCOLORREF());
-    DrawTextW(hdc, m_text.c_str(), -1, &bounds, DT_CENTER | DT_VCENTER | DT_SINGLELINE);
+    if (m_detailLevel < 2) {
+        SetBkMode(hdc, TRANSPARENT);
+        SetTextColor(hdc, m_textColor.ToCOLORREF());
+        DrawTextW(hdc, m_text.c_str(), -1, &bounds, DT_CENTER | DT_VCENTER | DT_SINGLELINE);
+    }
     
     // Render children
     Widget::Render(hdc);
+#else
+    (void)hdc;
+#endif
+}
+
+void Button::Render(RenderBackend& backend) {
+    if (!m_visible) return;
+    
+    RECT bounds; GetBounds(bounds);
+    
+    Color bgColor = m_backgroundColor;
+    if (m_pressed) {
+        bgColor = m_pressColor;
+    } else if (m_hovered) {
+        bgColor = m_hoverColor;
+    }
+    
+    backend.DrawRoundedRectangle(bounds, 8.0f, bgColor, Color(0, 0, 0, 100), 1.0f);
+    backend.DrawTextLine(m_text, bounds, m_textColor, GetFontFamily(), (float)GetFontSize(), GetFontWeight(),
+                         RenderBackend::TextAlign::CENTER);
+    
+    RenderChildren(backend);
+}
+
+bool Button::GetOpaqueBounds(RECT& rect) const {
+    // Flat at reduced detail, but the rounded shape is the conservative one
+    const Color& color = m_pressed ? m_pressColor : (m_hovered ? m_hoverColor : m_backgroundColor);
+    return GetRoundedOpaqueBounds(color, 8, rect);
 }
 
 bool Button::HandleMouseMove(int x, int y) {
@@ -469,6 +952,7 @@ bool Button::HandleMouseDown(int x, int y, int button) {
     
     if (HitTest(x, y) && button == 0) {
         m_pressed = true;
+        Invalidate();
         return true;
     }
     
@@ -480,6 +964,7 @@ bool Button::HandleMouseUp(int x, int y, int button) {
     
     if (m_pressed && button == 0) {
         m_pressed = false;
+        Invalidate();
         if (HitTest(x, y)) {
             TriggerEvent(WidgetEvent::CLICK);
         }
@@ -503,8 +988,11 @@ Label::~Label() {
 }
 
 void Label::Render(HDC hdc) {
+#if SDK_PLATFORM_WINDOWS
     if (!m_visible) return;
     
+    ScopedFont font(hdc, GetFont());
+    
     RECT bounds; GetBounds(bounds);
     
     SetBkMode(hdc, TRANSPARENT);
@@ -512,6 +1000,24 @@ void Label::Render(HDC hdc) {
     DrawTextW(hdc, m_text.c_str(), -1, &bounds, m_textAlignment);
     
     Widget::Render(hdc);
+#else
+    (void)hdc;
+#endif
+}
+
+void Label::Render(RenderBackend& backend) {
+    if (!m_visible) return;
+    
+    RECT bounds; GetBounds(bounds);
+    
+    if (m_textAlignment & DT_SINGLELINE) {
+        backend.DrawTextLine(m_text, bounds, m_textColor, GetFontFamily(), (float)GetFontSize(), GetFontWeight(),
+                             ToTextAlign(m_textAlignment));
+    } else {
+        backend.DrawText(m_text, bounds, m_textColor, GetFontFamily(), (float)GetFontSize(), GetFontWeight());
+    }
+    
+    RenderChildren(backend);
 }
 
 // TextBox implementation
@@ -533,17 +1039,22 @@ TextBox::~TextBox() {
 
 void TextBox::SetText(const std::wstring& text) {
     if (m_maxLength > 0 && text.length() > (size_t)m_maxLength) {
-        m_text = text.substr(0, m_maxLength);
+        m_text.SetText(text.substr(0, m_maxLength));
     } else {
-        m_text = text;
+        m_text.SetText(text);
     }
-    m_cursorPosition = (int)m_text.length();
+    m_undoStack.clear();
+    m_cursorPosition = (int)m_text.GetLength();
+    Invalidate();
     TriggerEvent(WidgetEvent::TEXT_CHANGED);
 }
 
 void TextBox::Render(HDC hdc) {
+#if SDK_PLATFORM_WINDOWS
     if (!m_visible) return;
     
+    ScopedFont font(hdc, GetFont());
+    
     RECT bounds; GetBounds(bounds);
     
     // Draw background and border
@@ -556,31 +1067,68 @@ void TextBox::Render(HDC hdc) {
     
     SetBkMode(hdc, TRANSPARENT);
     
-    if (m_text.empty() && !m_placeholder.empty()) {
+    std::wstring text = m_text.GetText();
+    if (text.empty() && !m_placeholder.empty()) {
         SetTextColor(hdc, RGB(150, 150, 150));
         DrawTextW(hdc, m_placeholder.c_str(), -1, &textRect, DT_LEFT | DT_VCENTER | DT_SINGLELINE);
     } else {
         SetTextColor(hdc, m_textColor.ToCOLORREF());
-        DrawTextW(hdc, m_text.c_str(), -1, &textRect, DT_LEFT | DT_VCENTER | DT_SINGLELINE);
+        DrawTextW(hdc, text.c_str(), -1, &textRect, DT_LEFT | DT_VCENTER | DT_SINGLELINE);
         
         // Draw cursor if focused
         if (m_focused && m_showCursor) {
             SIZE textSize;
-            GetTextExtentPoint32W(hdc, m_text.c_str(), m_cursorPosition, &textSize);
+            GetTextExtentPoint32W(hdc, text.c_str(), m_cursorPosition, &textSize);
             int cursorX = textRect.left + textSize.cx;
             int cursorY1 = textRect.top + 5;
             int cursorY2 = textRect.bottom - 5;
             
-            HPEN pen = CreatePen(PS_SOLID, 1, m_textColor.ToCOLORREF());
+            HPEN pen = GdiObjectCache::GetPen(m_textColor.ToCOLORREF());
             HPEN oldPen = (HPEN)SelectObject(hdc, pen);
             MoveToEx(hdc, cursorX, cursorY1, nullptr);
             LineTo(hdc, cursorX, cursorY2);
             SelectObject(hdc, oldPen);
-            DeleteObject(pen);
         }
     }
     
     Widget::Render(hdc);
+#else
+    (void)hdc;
+#endif
+}
+
+bool TextBox::GetOpaqueBounds(RECT& rect) const {
+    return GetRoundedOpaqueBounds(m_backgroundColor, 4, rect);
+}
+
+void TextBox::Render(RenderBackend& backend) {
+    if (!m_visible) return;
+    
+    RECT bounds; GetBounds(bounds);
+    backend.DrawRoundedRectangle(bounds, 4.0f, m_backgroundColor, m_borderColor, m_focused ? 2.0f : 1.0f);
+    
+    RECT textRect = bounds;
+    textRect.left += 5;
+    textRect.right -= 5;
+    
+    float fontSize = (float)GetFontSize();
+    int fontWeight = GetFontWeight();
+    
+    std::wstring text = m_text.GetText();
+    if (text.empty() && !m_placeholder.empty()) {
+        backend.DrawTextLine(m_placeholder, textRect, Color(150, 150, 150, 255), GetFontFamily(), fontSize, fontWeight,
+                             RenderBackend::TextAlign::LEFT);
+    } else {
+        backend.DrawTextLine(text, textRect, m_textColor, GetFontFamily(), fontSize, fontWeight,
+                             RenderBackend::TextAlign::LEFT);
+        
+        if (m_focused && m_showCursor) {
+            int cursorX = textRect.left + backend.MeasureText(text.substr(0, m_cursorPosition), GetFontFamily(), fontSize, fontWeight);
+            backend.DrawLine(cursorX, textRect.top + 5, cursorX, textRect.bottom - 5, m_textColor, 1.0f);
+        }
+    }
+    
+    RenderChildren(backend);
 }
 
 bool TextBox::HandleMouseDown(int x, int y, int button) {
@@ -598,25 +1146,33 @@ bool TextBox::HandleKeyDown(int keyCode) {
     if (!Widget::HandleKeyDown(keyCode)) return false;
     
     if (keyCode == VK_BACK && m_cursorPosition > 0) {
-        m_text.erase(m_cursorPosition - 1, 1);
+        PushUndo();
+        m_text.Erase(m_cursorPosition - 1, 1);
         m_cursorPosition--;
         TriggerEvent(WidgetEvent::TEXT_CHANGED);
+        Invalidate();
         return true;
-    } else if (keyCode == VK_DELETE && m_cursorPosition < (int)m_text.length()) {
-        m_text.erase(m_cursorPosition, 1);
+    } else if (keyCode == VK_DELETE && m_cursorPosition < (int)m_text.GetLength()) {
+        PushUndo();
+        m_text.Erase(m_cursorPosition, 1);
         TriggerEvent(WidgetEvent::TEXT_CHANGED);
+        Invalidate();
         return true;
     } else if (keyCode == VK_LEFT && m_cursorPosition > 0) {
         m_cursorPosition--;
+        Invalidate();
         return true;
-    } else if (keyCode == VK_RIGHT && m_cursorPosition < (int)m_text.length()) {
+    } else if (keyCode == VK_RIGHT && m_cursorPosition < (int)m_text.GetLength()) {
         m_cursorPosition++;
+        Invalidate();
         return true;
     } else if (keyCode == VK_HOME) {
         m_cursorPosition = 0;
+        Invalidate();
         return true;
     } else if (keyCode == VK_END) {
-        m_cursorPosition = (int)m_text.length();
+        m_cursorPosition = (int)m_text.GetLength();
+        Invalidate();
         return true;
     }
     
@@ -628,10 +1184,12 @@ bool TextBox::HandleChar(wchar_t ch) {
     if (!m_visible || !m_enabled || !m_focused) return false;
     
     if (ch >= 32 && ch != 127) { // Printable character
-        if (m_maxLength <= 0 || (int)m_text.length() < m_maxLength) {
-            m_text.insert(m_cursorPosition, 1, ch);
+        if (m_maxLength <= 0 || (int)m_text.GetLength() < m_maxLength) {
+            PushUndo();
+            m_text.Insert(m_cursorPosition, std::wstring(1, ch));
             m_cursorPosition++;
             TriggerEvent(WidgetEvent::TEXT_CHANGED);
+            Invalidate();
             return true;
         }
     }
@@ -639,6 +1197,24 @@ bool TextBox::HandleChar(wchar_t ch) {
     return false;
 }
 
+bool TextBox::Undo() {
+    if (m_undoStack.empty()) return false;
+    
+    m_text = m_undoStack.back().first;
+    m_cursorPosition = m_undoStack.back().second;
+    m_undoStack.pop_back();
+    TriggerEvent(WidgetEvent::TEXT_CHANGED);
+    Invalidate();
+    return true;
+}
+
+void TextBox::PushUndo() {
+    if (m_undoStack.size() >= MAX_UNDO_STEPS) {
+        m_undoStack.erase(m_undoStack.begin());
+    }
+    m_undoStack.emplace_back(m_text, m_cursorPosition);
+}
+
 void TextBox::UpdateCursorPosition() {
     // Cursor blink animation can be handled in Update()
 }
@@ -661,13 +1237,17 @@ CheckBox::~CheckBox() {
 void CheckBox::SetChecked(bool checked) {
     if (m_checked != checked) {
         m_checked = checked;
+        Invalidate();
         TriggerEvent(WidgetEvent::VALUE_CHANGED, &m_checked);
     }
 }
 
 void CheckBox::Render(HDC hdc) {
+#if SDK_PLATFORM_WINDOWS
     if (!m_visible) return;
     
+    ScopedFont font(hdc, GetFont());
+    
     RECT boxRect = {m_x, m_y, m_x + 20, m_y + 20};
     
     // Draw checkbox box
@@ -675,7 +1255,7 @@ void CheckBox::Render(HDC hdc) {
     
     // Draw checkmark if checked
     if (m_checked) {
-        HPEN pen = CreatePen(PS_SOLID, 2, m_checkColor.ToCOLORREF());
+        HPEN pen = GdiObjectCache::GetPen(m_checkColor.ToCOLORREF(), 2);
         HPEN oldPen = (HPEN)SelectObject(hdc, pen);
         
         // Draw checkmark
@@ -684,7 +1264,6 @@ void CheckBox::Render(HDC hdc) {
         LineTo(hdc, m_x + 16, m_y + 6);
         
         SelectObject(hdc, oldPen);
-        DeleteObject(pen);
     }
     
     // Draw label
@@ -696,6 +1275,29 @@ void CheckBox::Render(HDC hdc) {
     }
     
     Widget::Render(hdc);
+#else
+    (void)hdc;
+#endif
+}
+
+void CheckBox::Render(RenderBackend& backend) {
+    if (!m_visible) return;
+    
+    RECT boxRect = {m_x, m_y, m_x + 20, m_y + 20};
+    backend.DrawRoundedRectangle(boxRect, 3.0f, Color(255, 255, 255, 255), m_boxColor, 2.0f);
+    
+    if (m_checked) {
+        backend.DrawLine(m_x + 4, m_y + 10, m_x + 8, m_y + 14, m_checkColor, 2.0f);
+        backend.DrawLine(m_x + 8, m_y + 14, m_x + 16, m_y + 6, m_checkColor, 2.0f);
+    }
+    
+    if (!m_text.empty()) {
+        RECT textRect = {m_x + 25, m_y, m_x + m_width, m_y + m_height};
+        backend.DrawTextLine(m_text, textRect, LABEL_TEXT_COLOR, GetFontFamily(), (float)GetFontSize(), GetFontWeight(),
+                             RenderBackend::TextAlign::LEFT);
+    }
+    
+    RenderChildren(backend);
 }
 
 bool CheckBox::HandleMouseDown(int x, int y, int button) {
@@ -728,15 +1330,27 @@ Separator::~Separator() {
 }
 
 void Separator::Render(HDC hdc) {
+#if SDK_PLATFORM_WINDOWS
     if (!m_visible) return;
     
     RECT bounds; GetBounds(bounds);
     
-    HBRUSH brush = CreateSolidBrush(m_color.ToCOLORREF());
+    HBRUSH brush = GdiObjectCache::GetBrush(m_color.ToCOLORREF());
     FillRect(hdc, &bounds, brush);
-    DeleteObject(brush);
     
     Widget::Render(hdc);
+#else
+    (void)hdc;
+#endif
+}
+
+void Separator::Render(RenderBackend& backend) {
+    if (!m_visible) return;
+    
+    RECT bounds; GetBounds(bounds);
+    backend.DrawRectangle(bounds, m_color, m_color, 0.0f);
+    
+    RenderChildren(backend);
 }
 
 // Image implementation
@@ -746,70 +1360,163 @@ Image::Image()
     , m_stretch(false)
     , m_imageWidth(0)
     , m_imageHeight(0)
+    , m_requestWidth(0)
+    , m_requestHeight(0)
+    , m_placeholderColor(230, 230, 230, 255)
 {
 }
 
 Image::~Image() {
-    if (m_bitmap) {
-        DeleteObject(m_bitmap);
-    }
+    ReleaseImage();
 }
 
 bool Image::LoadFromFile(const std::wstring& filename) {
-    if (m_bitmap) {
-        DeleteObject(m_bitmap);
-        m_bitmap = nullptr;
-    }
-    
-    m_bitmap = (HBITMAP)LoadImageW(nullptr, filename.c_str(), IMAGE_BITMAP, 0, 0, LR_LOADFROMFILE);
-    
-    if (m_bitmap) {
-        BITMAP bm;
-        GetObject(m_bitmap, sizeof(BITMAP), &bm);
-        m_imageWidth = bm.bmWidth;
-        m_imageHeight = bm.bmHeight;
-        return true;
-    }
-    
-    return false;
+    ReleaseImage();
+    
+    // Decoding happens on a worker; a file that fails to decode draws nothing
+#if SDK_PLATFORM_WINDOWS
+    DWORD attributes = GetFileAttributesW(filename.c_str());
+    if (attributes == INVALID_FILE_ATTRIBUTES || (attributes & FILE_ATTRIBUTE_DIRECTORY)) return false;
+#else
+    struct stat info;
+    if (stat(WStringToUTF8(filename).c_str(), &info) != 0 || S_ISDIR(info.st_mode)) return false;
+#endif
+    
+    m_path = filename;
+    RequestImage();
+    Invalidate();
+    return true;
 }
 
 bool Image::LoadFromResource(HINSTANCE hInstance, int resourceId) {
-    if (m_bitmap) {
-        DeleteObject(m_bitmap);
-        m_bitmap = nullptr;
-    }
+    ReleaseImage();
     
-    m_bitmap = LoadBitmap(hInstance, MAKEINTRESOURCE(resourceId));
-    
-    if (m_bitmap) {
-        BITMAP bm;
-        GetObject(m_bitmap, sizeof(BITMAP), &bm);
-        m_imageWidth = bm.bmWidth;
-        m_imageHeight = bm.bmHeight;
-        return true;
-    }
+#if SDK_PLATFORM_WINDOWS
+    HBITMAP bitmap = LoadBitmap(hInstance, MAKEINTRESOURCE(resourceId));
+    if (!bitmap) return false;
     
+    AdoptBitmap(bitmap);
+    return true;
+#else
+    (void)hInstance; (void)resourceId;
     return false;
+#endif
 }
 
 void Image::SetHBITMAP(HBITMAP bitmap) {
+    AdoptBitmap(bitmap);
+    Invalidate();
+}
+
+void Image::AdoptBitmap(HBITMAP bitmap) {
+    ReleaseImage();
+    if (!bitmap) return;
+    
+#if SDK_PLATFORM_WINDOWS
+    BITMAP bm;
+    GetObject(bitmap, sizeof(BITMAP), &bm);
+    m_imageWidth = bm.bmWidth;
+    m_imageHeight = bm.bmHeight;
+    
+    // No source is kept once the pixels are in the atlas, so the texture is pinned
+    if (m_imageWidth <= MAX_ATLAS_IMAGE_SIZE && m_imageHeight <= MAX_ATLAS_IMAGE_SIZE) {
+        std::string name = "Image:" + std::to_string((uintptr_t)this);
+        if (TextureAtlas::GetShared().AddTexture(name, bitmap, m_imageWidth, m_imageHeight, true)) {
+            m_atlasName = name;
+            DeleteObject(bitmap);
+            return;
+        }
+    }
+    m_bitmap = bitmap;
+#endif
+}
+
+void Image::ReleaseImage() {
+    m_path.clear();
+    m_image.reset();
+    m_pending.reset();
+    m_requestWidth = 0;
+    m_requestHeight = 0;
+#if SDK_PLATFORM_WINDOWS
     if (m_bitmap) {
         DeleteObject(m_bitmap);
+        m_bitmap = nullptr;
     }
+#endif
+    if (!m_atlasName.empty()) {
+        TextureAtlas::GetShared().RemoveTexture(m_atlasName);
+        m_atlasName.clear();
+    }
+    m_imageWidth = 0;
+    m_imageHeight = 0;
+}
+
+void Image::RequestImage() {
+    if (m_path.empty()) return;
+    int width = m_stretch ? m_width : 0;
+    int height = m_stretch ? m_height : 0;
+    if ((m_image || m_pending) && width == m_requestWidth && height == m_requestHeight) return;
+    
+    m_requestWidth = width;
+    m_requestHeight = height;
+    ImageCache::EntryPtr entry = ImageCache::Get(m_path, width, height);
+    if (entry->GetState() == ImageCache::State::LOADING) {
+        m_pending = entry;
+        ScheduleUpdate();
+        return;
+    }
+    m_pending.reset();
+    if (entry->GetState() == ImageCache::State::READY) m_image = entry;
+}
+
+void Image::Update(float deltaTime) {
+    Widget::Update(deltaTime);
+    if (!m_pending) return;
     
-    m_bitmap = bitmap;
-    
-    if (m_bitmap) {
-        BITMAP bm;
-        GetObject(m_bitmap, sizeof(BITMAP), &bm);
-        m_imageWidth = bm.bmWidth;
-        m_imageHeight = bm.bmHeight;
+    ImageCache::State state = m_pending->GetState();
+    if (state == ImageCache::State::LOADING) {
+        ScheduleUpdate();
+        return;
     }
+    if (state == ImageCache::State::READY) m_image = m_pending;
+    m_pending.reset();
+    Invalidate();
+}
+
+RECT Image::GetImageRect() const {
+    RECT bounds; GetBounds(bounds);
+    bounds.right = bounds.left + (m_stretch ? m_width : m_imageWidth);
+    bounds.bottom = bounds.top + (m_stretch ? m_height : m_imageHeight);
+    return bounds;
 }
 
 void Image::Render(HDC hdc) {
-    if (!m_visible || !m_bitmap) return;
+#if SDK_PLATFORM_WINDOWS
+    if (!m_visible) return;
+    
+    if (!m_path.empty()) {
+        RequestImage();     // Resized or stretch mode changed
+        
+        RECT bounds; GetBounds(bounds);
+        if (m_image) {
+            if (!m_stretch) {
+                bounds.right = bounds.left + m_image->GetWidth();
+                bounds.bottom = bounds.top + m_image->GetHeight();
+            }
+            m_image->Draw(hdc, bounds);
+        } else if (m_pending && m_placeholderColor.a > 0) {
+            FillRect(hdc, &bounds, GdiObjectCache::GetBrush(m_placeholderColor.ToCOLORREF()));
+        }
+        Widget::Render(hdc);
+        return;
+    }
+    
+    if (!m_atlasName.empty()) {
+        TextureAtlas::GetShared().Draw(hdc, m_atlasName, GetImageRect());
+        Widget::Render(hdc);
+        return;
+    }
+    if (!m_bitmap) return;
     
     RECT bounds; GetBounds(bounds);
     
@@ -828,6 +1535,22 @@ void Image::Render(HDC hdc) {
     DeleteDC(memDC);
     
     Widget::Render(hdc);
+#else
+    (void)hdc;
+#endif
+}
+
+void Image::Render(RenderBackend& backend) {
+    if (!m_visible) return;
+    
+    // Large images still have their own bitmap and go through GDI interop
+    if (m_atlasName.empty()) {
+        Widget::Render(backend);
+        return;
+    }
+    
+    backend.DrawAtlasTexture(TextureAtlas::GetShared(), m_atlasName, GetImageRect());
+    RenderChildren(backend);
 }
 
 // Slider implementation
@@ -860,6 +1583,7 @@ void Slider::SetValue(float value) {
     
     if (m_value != value) {
         m_value = value;
+        Invalidate();
         TriggerEvent(WidgetEvent::VALUE_CHANGED, &m_value);
     }
 }
@@ -876,6 +1600,7 @@ void Slider::SetRange(float minValue, float maxValue) {
     m_maxValue = maxValue;
     if (m_value < m_minValue) m_value = m_minValue;
     if (m_value > m_maxValue) m_value = m_maxValue;
+    Invalidate();
 }
 
 void Slider::GetRange(float& minValue, float& maxValue) const {
@@ -884,6 +1609,7 @@ void Slider::GetRange(float& minValue, float& maxValue) const {
 }
 
 void Slider::Render(HDC hdc) {
+#if SDK_PLATFORM_WINDOWS
     if (!m_visible) return;
     
     RECT bounds; GetBounds(bounds);
@@ -945,6 +1671,50 @@ void Slider::Render(HDC hdc) {
     }
     
     Widget::Render(hdc);
+#else
+    (void)hdc;
+#endif
+}
+
+void Slider::Render(RenderBackend& backend) {
+    if (!m_visible) return;
+    
+    RECT bounds; GetBounds(bounds);
+    
+    const int trackSize = 4;
+    RECT trackRect;
+    if (m_orientation == Orientation::HORIZONTAL) {
+        int trackY = (bounds.top + bounds.bottom) / 2 - trackSize / 2;
+        trackRect = {bounds.left + 10, trackY, bounds.right - 10, trackY + trackSize};
+    } else {
+        int trackX = (bounds.left + bounds.right) / 2 - trackSize / 2;
+        trackRect = {trackX, bounds.top + 10, trackX + trackSize, bounds.bottom - 10};
+    }
+    backend.DrawRoundedRectangle(trackRect, 2.0f, m_trackColor, m_trackColor, 0.0f);
+    
+    // Protect against division by zero: track only
+    if (m_maxValue != m_minValue) {
+        float ratio = (m_value - m_minValue) / (m_maxValue - m_minValue);
+        RECT fillRect = trackRect;
+        RECT thumbRect;
+        if (m_orientation == Orientation::HORIZONTAL) {
+            int fillWidth = (int)((bounds.right - bounds.left - 20) * ratio);
+            fillRect.right = fillRect.left + fillWidth;
+            int thumbX = fillRect.right - 8;
+            int thumbY = (bounds.top + bounds.bottom) / 2 - 8;
+            thumbRect = {thumbX, thumbY, thumbX + 16, thumbY + 16};
+        } else {
+            int fillHeight = (int)((bounds.bottom - bounds.top - 20) * ratio);
+            fillRect.top = fillRect.bottom - fillHeight;
+            int thumbX = (bounds.left + bounds.right) / 2 - 8;
+            int thumbY = fillRect.top - 8;
+            thumbRect = {thumbX, thumbY, thumbX + 16, thumbY + 16};
+        }
+        backend.DrawRoundedRectangle(fillRect, 2.0f, m_fillColor, m_fillColor, 0.0f);
+        backend.DrawRoundedRectangle(thumbRect, 8.0f, m_thumbColor, Color(50, 50, 50, 255), 1.0f);
+    }
+    
+    RenderChildren(backend);
 }
 
 bool Slider::HandleMouseDown(int x, int y, int button) {
@@ -1033,6 +1803,7 @@ RadioButton::~RadioButton() {
 void RadioButton::SetChecked(bool checked) {
     if (m_checked != checked) {
         m_checked = checked;
+        Invalidate();
         
         // Uncheck other radio buttons in the same group
         if (checked && m_parent) {
@@ -1049,14 +1820,17 @@ void RadioButton::SetChecked(bool checked) {
 }
 
 void RadioButton::Render(HDC hdc) {
+#if SDK_PLATFORM_WINDOWS
     if (!m_visible) return;
     
+    ScopedFont font(hdc, GetFont());
+    
     int radius = 10;
     RECT circleRect = {m_x, m_y, m_x + 20, m_y + 20};
     
     // Draw outer circle
-    HBRUSH outerBrush = CreateSolidBrush(RGB(255, 255, 255));
-    HPEN outerPen = CreatePen(PS_SOLID, 2, m_circleColor.ToCOLORREF());
+    HBRUSH outerBrush = GdiObjectCache::GetBrush(RGB(255, 255, 255));
+    HPEN outerPen = GdiObjectCache::GetPen(m_circleColor.ToCOLORREF(), 2);
     HBRUSH oldBrush = (HBRUSH)SelectObject(hdc, outerBrush);
     HPEN oldPen = (HPEN)SelectObject(hdc, outerPen);
     
@@ -1065,19 +1839,16 @@ void RadioButton::Render(HDC hdc) {
     // Draw inner circle if checked
     if (m_checked) {
         RECT innerCircleRect = {m_x + 5, m_y + 5, m_x + 15, m_y + 15};
-        HBRUSH innerBrush = CreateSolidBrush(m_checkColor.ToCOLORREF());
+        HBRUSH innerBrush = GdiObjectCache::GetBrush(m_checkColor.ToCOLORREF());
         SelectObject(hdc, innerBrush);
         SelectObject(hdc, GetStockObject(NULL_PEN));
         
         Ellipse(hdc, innerCircleRect.left, innerCircleRect.top, innerCircleRect.right, innerCircleRect.bottom);
         
-        DeleteObject(innerBrush);
     }
     
     SelectObject(hdc, oldBrush);
     SelectObject(hdc, oldPen);
-    DeleteObject(outerBrush);
-    DeleteObject(outerPen);
     
     // Draw label
     if (!m_text.empty()) {
@@ -1088,6 +1859,26 @@ void RadioButton::Render(HDC hdc) {
     }
     
     Widget::Render(hdc);
+#else
+    (void)hdc;
+#endif
+}
+
+void RadioButton::Render(RenderBackend& backend) {
+    if (!m_visible) return;
+    
+    backend.DrawEllipse(m_x + 10, m_y + 10, 10, 10, Color(255, 255, 255, 255), m_circleColor, 2.0f);
+    if (m_checked) {
+        backend.DrawEllipse(m_x + 10, m_y + 10, 5, 5, m_checkColor, m_checkColor, 0.0f);
+    }
+    
+    if (!m_text.empty()) {
+        RECT textRect = {m_x + 25, m_y, m_x + m_width, m_y + m_height};
+        backend.DrawTextLine(m_text, textRect, LABEL_TEXT_COLOR, GetFontFamily(), (float)GetFontSize(), GetFontWeight(),
+                             RenderBackend::TextAlign::LEFT);
+    }
+    
+    RenderChildren(backend);
 }
 
 bool RadioButton::HandleMouseDown(int x, int y, int button) {
@@ -1174,10 +1965,11 @@ void Panel::ClampChildPosition(Widget* child) {
     }
     
     // Add padding
-    panelBounds.left += m_paddingLeft;
-    panelBounds.top += m_paddingTop;
-    panelBounds.right -= m_paddingRight;
-    panelBounds.bottom -= m_paddingBottom;
+    const WidgetStyle& style = GetStyle();
+    panelBounds.left += style.paddingLeft;
+    panelBounds.top += style.paddingTop;
+    panelBounds.right -= style.paddingRight;
+    panelBounds.bottom -= style.paddingBottom;
     
     int childX, childY, childWidth, childHeight;
     child->GetPosition(childX, childY);
@@ -1223,17 +2015,11 @@ int Panel::GetCollapsedSize() const {
     }
 }
 
-void Panel::RenderCollapseButton(HDC hdc, const RECT& buttonRect) {
-    // Draw button background
-    Color btnColor = m_hovered ? Color(220, 220, 220, 255) : Color(200, 200, 200, 255);
-    Renderer::DrawRoundedRect(hdc, buttonRect, 3, btnColor, Color(150, 150, 150, 255), 1);
-    
-    // Draw triangle indicator
+void Panel::GetCollapseTriangle(const RECT& buttonRect, POINT triangle[3]) const {
     int centerX = (buttonRect.left + buttonRect.right) / 2;
     int centerY = (buttonRect.top + buttonRect.bottom) / 2;
     int size = 5;
     
-    POINT triangle[3];
     if (m_collapsed) {
         if (m_collapseOrientation == CollapseOrientation::VERTICAL) {
             // Down-pointing triangle (collapsed state for vertical)
@@ -1259,9 +2045,20 @@ void Panel::RenderCollapseButton(HDC hdc, const RECT& buttonRect) {
             triangle[2] = {centerX + size, centerY + size};
         }
     }
+}
+
+void Panel::RenderCollapseButton(HDC hdc, const RECT& buttonRect) {
+#if SDK_PLATFORM_WINDOWS
+    // Draw button background
+    Color btnColor = m_hovered ? Color(220, 220, 220, 255) : Color(200, 200, 200, 255);
+    Renderer::DrawRoundedRect(hdc, buttonRect, 3, btnColor, Color(150, 150, 150, 255), 1);
+    
+    // Draw triangle indicator
+    POINT triangle[3];
+    GetCollapseTriangle(buttonRect, triangle);
     
-    HBRUSH brush = CreateSolidBrush(RGB(80, 80, 80));
-    HPEN pen = CreatePen(PS_SOLID, 1, RGB(80, 80, 80));
+    HBRUSH brush = GdiObjectCache::GetBrush(RGB(80, 80, 80));
+    HPEN pen = GdiObjectCache::GetPen(RGB(80, 80, 80));
     HGDIOBJ oldBrush = SelectObject(hdc, brush);
     HGDIOBJ oldPen = SelectObject(hdc, pen);
     
@@ -1269,8 +2066,18 @@ void Panel::RenderCollapseButton(HDC hdc, const RECT& buttonRect) {
     
     SelectObject(hdc, oldBrush);
     SelectObject(hdc, oldPen);
-    DeleteObject(brush);
-    DeleteObject(pen);
+#else
+    (void)hdc; (void)buttonRect;
+#endif
+}
+
+void Panel::RenderCollapseButton(RenderBackend& backend, const RECT& buttonRect) {
+    Color btnColor = m_hovered ? Color(220, 220, 220, 255) : Color(200, 200, 200, 255);
+    backend.DrawRoundedRectangle(buttonRect, 3.0f, btnColor, Color(150, 150, 150, 255), 1.0f);
+    
+    POINT triangle[3];
+    GetCollapseTriangle(buttonRect, triangle);
+    FillTriangle(backend, triangle, Color(80, 80, 80, 255));
 }
 
 bool Panel::HandleMouseDown(int x, int y, int button) {
@@ -1298,16 +2105,36 @@ bool Panel::HandleMouseDown(int x, int y, int button) {
 
 void Panel::Render(HDC hdc) {
     if (!m_visible) return;
+    if (!RenderChrome(hdc)) return;
+    
+    Widget::Render(hdc);
+}
+
+bool Panel::RenderChrome(HDC hdc) {
+#if SDK_PLATFORM_WINDOWS
+    ScopedFont font(hdc, GetFont());
     
     RECT bounds; GetBounds(bounds);
     
-    // Draw border and background
-    Renderer::DrawRoundedRect(hdc, bounds, 8, m_backgroundColor, m_borderColor, 2);
+    // Reduced detail draws flat rectangles; the lowest level stops at the background
+    if (m_detailLevel > 0) {
+        HBRUSH brush = GdiObjectCache::GetBrush(m_backgroundColor.ToCOLORREF());
+        FillRect(hdc, &bounds, brush);
+        if (m_detailLevel > 1) return false;
+    } else {
+        // Draw border and background
+        Renderer::DrawRoundedRect(hdc, bounds, 8, m_backgroundColor, m_borderColor, 2);
+    }
     
     // Draw title bar if title is set
     if (!m_title.empty()) {
         RECT titleBarRect = {bounds.left, bounds.top, bounds.right, bounds.top + m_titleBarHeight};
-        Renderer::DrawRoundedRect(hdc, titleBarRect, 8, m_titleBarColor, m_titleBarColor, 0);
+        if (m_detailLevel > 0) {
+            HBRUSH brush = GdiObjectCache::GetBrush(m_titleBarColor.ToCOLORREF());
+            FillRect(hdc, &titleBarRect, brush);
+        } else {
+            Renderer::DrawRoundedRect(hdc, titleBarRect, 8, m_titleBarColor, m_titleBarColor, 0);
+        }
         
         // Draw title text
         SetBkMode(hdc, TRANSPARENT);
@@ -1323,8 +2150,39 @@ void Panel::Render(HDC hdc) {
             RenderCollapseButton(hdc, buttonRect);
         }
     }
+    return true;
+#else
+    (void)hdc;
+    return true;
+#endif
+}
+
+bool Panel::GetOpaqueBounds(RECT& rect) const {
+    return GetRoundedOpaqueBounds(m_backgroundColor, 8, rect);
+}
+
+void Panel::Render(RenderBackend& backend) {
+    if (!m_visible) return;
     
-    Widget::Render(hdc);
+    RECT bounds; GetBounds(bounds);
+    backend.DrawRoundedRectangle(bounds, 8.0f, m_backgroundColor, m_borderColor, 2.0f);
+    
+    if (!m_title.empty()) {
+        RECT titleBarRect = {bounds.left, bounds.top, bounds.right, bounds.top + m_titleBarHeight};
+        backend.DrawRoundedRectangle(titleBarRect, 8.0f, m_titleBarColor, m_titleBarColor, 0.0f);
+        
+        RECT titleTextRect = titleBarRect;
+        titleTextRect.left += 10;
+        titleTextRect.right -= (m_collapsible ? m_titleBarHeight : 0);
+        backend.DrawTextLine(m_title, titleTextRect, LABEL_TEXT_COLOR, GetFontFamily(), (float)GetFontSize(), GetFontWeight(),
+                             RenderBackend::TextAlign::LEFT);
+        
+        if (m_collapsible) {
+            RenderCollapseButton(backend, GetCollapseButtonRect());
+        }
+    }
+    
+    RenderChildren(backend);
 }
 
 // SpinBox implementation
@@ -1351,6 +2209,7 @@ void SpinBox::SetValue(int value) {
     
     if (m_value != value) {
         m_value = value;
+        Invalidate();
         TriggerEvent(WidgetEvent::VALUE_CHANGED, &m_value);
     }
 }
@@ -1375,8 +2234,11 @@ void SpinBox::GetRange(int& minValue, int& maxValue) const {
 }
 
 void SpinBox::Render(HDC hdc) {
+#if SDK_PLATFORM_WINDOWS
     if (!m_visible) return;
     
+    ScopedFont font(hdc, GetFont());
+    
     RECT bounds; GetBounds(bounds);
     
     // Draw background
@@ -1399,7 +2261,7 @@ void SpinBox::Render(HDC hdc) {
     // Draw up arrow
     int arrowCenterX = upButtonRect.left + buttonWidth / 2;
     int arrowCenterY = upButtonRect.top + (upButtonRect.bottom - upButtonRect.top) / 2;
-    HPEN arrowPen = CreatePen(PS_SOLID, 2, RGB(50, 50, 50));
+    HPEN arrowPen = GdiObjectCache::GetPen(RGB(50, 50, 50), 2);
     HPEN oldPen = (HPEN)SelectObject(hdc, arrowPen);
     
     MoveToEx(hdc, arrowCenterX - 4, arrowCenterY + 2, nullptr);
@@ -1418,9 +2280,44 @@ void SpinBox::Render(HDC hdc) {
     LineTo(hdc, arrowCenterX + 4, arrowCenterY - 2);
     
     SelectObject(hdc, oldPen);
-    DeleteObject(arrowPen);
     
     Widget::Render(hdc);
+#else
+    (void)hdc;
+#endif
+}
+
+void SpinBox::Render(RenderBackend& backend) {
+    if (!m_visible) return;
+    
+    RECT bounds; GetBounds(bounds);
+    const Color outline(128, 128, 128, 255);
+    const Color arrowColor(50, 50, 50, 255);
+    
+    int buttonWidth = 20;
+    RECT textRect = {bounds.left, bounds.top, bounds.right - buttonWidth, bounds.bottom};
+    backend.DrawRoundedRectangle(textRect, 4.0f, m_backgroundColor, outline, 1.0f);
+    
+    RECT valueTextRect = textRect;
+    valueTextRect.left += 5;
+    backend.DrawTextLine(std::to_wstring(m_value), valueTextRect, m_textColor, GetFontFamily(), (float)GetFontSize(),
+                         GetFontWeight(), RenderBackend::TextAlign::LEFT);
+    
+    int arrowCenterX = bounds.right - buttonWidth + buttonWidth / 2;
+    
+    RECT upButtonRect = {bounds.right - buttonWidth, bounds.top, bounds.right, bounds.top + m_height / 2};
+    backend.DrawRoundedRectangle(upButtonRect, 4.0f, m_buttonColor, outline, 1.0f);
+    int arrowCenterY = upButtonRect.top + (upButtonRect.bottom - upButtonRect.top) / 2;
+    backend.DrawLine(arrowCenterX - 4, arrowCenterY + 2, arrowCenterX, arrowCenterY - 2, arrowColor, 2.0f);
+    backend.DrawLine(arrowCenterX, arrowCenterY - 2, arrowCenterX + 4, arrowCenterY + 2, arrowColor, 2.0f);
+    
+    RECT downButtonRect = {bounds.right - buttonWidth, bounds.top + m_height / 2, bounds.right, bounds.bottom};
+    backend.DrawRoundedRectangle(downButtonRect, 4.0f, m_buttonColor, outline, 1.0f);
+    arrowCenterY = downButtonRect.top + (downButtonRect.bottom - downButtonRect.top) / 2;
+    backend.DrawLine(arrowCenterX - 4, arrowCenterY - 2, arrowCenterX, arrowCenterY + 2, arrowColor, 2.0f);
+    backend.DrawLine(arrowCenterX, arrowCenterY + 2, arrowCenterX + 4, arrowCenterY - 2, arrowColor, 2.0f);
+    
+    RenderChildren(backend);
 }
 
 bool SpinBox::HandleMouseDown(int x, int y, int button) {
@@ -1465,87 +2362,174 @@ bool SpinBox::HandleKeyDown(int keyCode) {
 // New property implementations
 
 void Widget::SetPadding(int padding) {
-    m_paddingLeft = m_paddingTop = m_paddingRight = m_paddingBottom = padding;
+    SetPadding(padding, padding, padding, padding);
 }
 
 void Widget::SetPadding(int left, int top, int right, int bottom) {
-    m_paddingLeft = left;
-    m_paddingTop = top;
-    m_paddingRight = right;
-    m_paddingBottom = bottom;
+    EditStyle([&](WidgetStyle& style) {
+        style.paddingLeft = left;
+        style.paddingTop = top;
+        style.paddingRight = right;
+        style.paddingBottom = bottom;
+    });
 }
 
 void Widget::GetPadding(int& left, int& top, int& right, int& bottom) const {
-    left = m_paddingLeft;
-    top = m_paddingTop;
-    right = m_paddingRight;
-    bottom = m_paddingBottom;
+    left = m_style->paddingLeft;
+    top = m_style->paddingTop;
+    right = m_style->paddingRight;
+    bottom = m_style->paddingBottom;
 }
 
 void Widget::SetMargin(int margin) {
-    m_marginLeft = m_marginTop = m_marginRight = m_marginBottom = margin;
+    SetMargin(margin, margin, margin, margin);
 }
 
 void Widget::SetMargin(int left, int top, int right, int bottom) {
-    m_marginLeft = left;
-    m_marginTop = top;
-    m_marginRight = right;
-    m_marginBottom = bottom;
+    EditStyle([&](WidgetStyle& style) {
+        style.marginLeft = left;
+        style.marginTop = top;
+        style.marginRight = right;
+        style.marginBottom = bottom;
+    });
 }
 
 void Widget::GetMargin(int& left, int& top, int& right, int& bottom) const {
-    left = m_marginLeft;
-    top = m_marginTop;
-    right = m_marginRight;
-    bottom = m_marginBottom;
+    left = m_style->marginLeft;
+    top = m_style->marginTop;
+    right = m_style->marginRight;
+    bottom = m_style->marginBottom;
 }
 
 void Widget::SetMinSize(int minWidth, int minHeight) {
-    m_minWidth = minWidth;
-    m_minHeight = minHeight;
+    EditStyle([&](WidgetStyle& style) {
+        style.minWidth = minWidth;
+        style.minHeight = minHeight;
+    });
     
     // Apply constraints to current size
-    if (m_width < m_minWidth) m_width = m_minWidth;
-    if (m_height < m_minHeight) m_height = m_minHeight;
+    if (m_width < minWidth) m_width = minWidth;
+    if (m_height < minHeight) m_height = minHeight;
 }
 
 void Widget::GetMinSize(int& minWidth, int& minHeight) const {
-    minWidth = m_minWidth;
-    minHeight = m_minHeight;
+    minWidth = m_style->minWidth;
+    minHeight = m_style->minHeight;
 }
 
 void Widget::SetMaxSize(int maxWidth, int maxHeight) {
-    m_maxWidth = maxWidth;
-    m_maxHeight = maxHeight;
+    EditStyle([&](WidgetStyle& style) {
+        style.maxWidth = maxWidth;
+        style.maxHeight = maxHeight;
+    });
     
     // Apply constraints to current size
-    if (m_width > m_maxWidth) m_width = m_maxWidth;
-    if (m_height > m_maxHeight) m_height = m_maxHeight;
+    if (m_width > maxWidth) m_width = maxWidth;
+    if (m_height > maxHeight) m_height = maxHeight;
 }
 
 void Widget::GetMaxSize(int& maxWidth, int& maxHeight) const {
-    maxWidth = m_maxWidth;
-    maxHeight = m_maxHeight;
+    maxWidth = m_style->maxWidth;
+    maxHeight = m_style->maxHeight;
 }
 
 void Widget::SetOpacity(float opacity) {
     // Clamp opacity to valid range [0.0, 1.0]
-    m_opacity = std::min(std::max(opacity, 0.0f), 1.0f);
+    opacity = std::min(std::max(opacity, 0.0f), 1.0f);
+    if (m_opacity == opacity) return;
+    
+    m_opacity = opacity;
+    if (HasLayer()) {
+        InvalidateLayer();
+    } else {
+        Invalidate();
+    }
 }
 
 void Widget::SetBorderWidth(int width) {
     if (width < 0) width = 0;
-    m_borderWidth = width;
+    if (m_style->borderWidth == width) return;
+    
+    Invalidate();
+    EditStyle([width](WidgetStyle& style) { style.borderWidth = width; });
+    Invalidate();
 }
 
 void Widget::SetBorderRadius(int radius) {
     if (radius < 0) radius = 0;
-    m_borderRadius = radius;
+    if (EditStyle([radius](WidgetStyle& style) { style.borderRadius = radius; })) {
+        Invalidate();
+    }
+}
+
+void Widget::SetTooltipText(const std::wstring& text) {
+    EditStyle([&](WidgetStyle& style) { style.tooltipText = text; });
+}
+
+void Widget::SetCursor(HCURSOR cursor) {
+    EditStyle([cursor](WidgetStyle& style) { style.cursor = cursor; });
+}
+
+void Widget::SetTheme(std::shared_ptr<Theme> theme) {
+    EditStyle([&](WidgetStyle& style) { style.theme = theme; });
+}
+
+void Widget::SetAlignment(WidgetAlignment alignment) {
+    EditStyle([alignment](WidgetStyle& style) { style.alignment = alignment; });
+}
+
+void Widget::SetStyle(const WidgetStyle& style) {
+    if (style == *m_style) return;
+    
+    Invalidate();
+    m_style = WidgetStyle::Intern(style);
+    InvalidateLayout();
+    Invalidate();
+}
+
+void Widget::SetInvalidateHandler(InvalidateHandler handler) {
+    if (handler) {
+        m_invalidateHandler.reset(new InvalidateHandler(std::move(handler)));
+    } else {
+        m_invalidateHandler.reset();
+    }
+}
+
+void Widget::SetDPI(int dpi) {
+    if (dpi < 1) dpi = 1;
+    for (auto& child : m_children) {
+        child->SetDPI(dpi);
+    }
+    if (m_dpi == dpi) return;
+    
+    m_dpi = dpi;
+    InvalidateLayout();
+    Invalidate();
+}
+
+void Widget::SetFontFamily(const std::wstring& family) {
+    if (EditStyle([&](WidgetStyle& style) { style.fontFamily = family; })) {
+        Invalidate();
+    }
 }
 
 void Widget::SetFontSize(int size) {
     if (size < 1) size = 1;
-    m_fontSize = size;
+    if (EditStyle([size](WidgetStyle& style) { style.fontSize = size; })) {
+        Invalidate();
+    }
+}
+
+void Widget::SetFontBold(bool bold) {
+    if (EditStyle([bold](WidgetStyle& style) { style.fontBold = bold; })) {
+        Invalidate();
+    }
+}
+
+void Widget::SetFontItalic(bool italic) {
+    if (EditStyle([italic](WidgetStyle& style) { style.fontItalic = italic; })) {
+        Invalidate();
+    }
 }
 
 } // namespace SDK
@@ -2,7 +2,6 @@
 #include "../../include/SDK/Renderer.h"
 #include <cmath>
 #include <algorithm>
-#include <limits>
 
 namespace SDK {
 
@@ -35,6 +34,13 @@ void Widget3D::SetPosition3D(float x, float y, float z) {
     m_position3D.y = y;
     m_position3D.z = z;
     m_screenPositionValid = false;
+    NotifyGeometryChanged();
+}
+
+void Widget3D::SetScale3D(float scale) {
+    if (m_scale3D == scale) return;
+    m_scale3D = scale;
+    NotifyGeometryChanged();
 }
 
 void Widget3D::GetPosition3D(float& x, float& y, float& z) const {
@@ -86,9 +92,13 @@ void Widget3D::Render3D(HDC hdc, CameraController* camera, int originX, int orig
     Render(hdc);
 }
 
+float Widget3D::GetBoundingRadius() const {
+    return std::max(m_width, m_height) * m_scale3D * 0.5f;
+}
+
 bool Widget3D::HitTest3D(const Renderer::Vector3D& rayOrigin, const Renderer::Vector3D& rayDirection, float& distance) const {
-    // Simple sphere hit test (can be overridden for more complex shapes)
-    float radius = std::max(m_width, m_height) * m_scale3D * 0.5f;
+    // Simple sphere hit test
+    float radius = GetBoundingRadius();
     
     // Vector from ray origin to widget center
     Renderer::Vector3D oc;
@@ -127,6 +137,27 @@ float Widget3D::GetDistanceFromCamera(const CameraController* camera) const {
     return std::sqrt(dx * dx + dy * dy + dz * dz);
 }
 
+bool Widget3D::IsInFrustum(const CameraController* camera, int originX, int originY, const RECT* viewport) const {
+    if (!camera) return false;
+    
+    // Behind the camera, or outside the near and far planes
+    const float* view = camera->GetViewMatrix();
+    const Renderer::Vector3D& p = m_position3D;
+    float depth = view[8] * p.x + view[9] * p.y + view[10] * p.z + view[11];
+    if (depth < camera->GetNearPlane() || depth > camera->GetFarPlane()) return false;
+    if (!viewport) return true;
+    
+    // Sides: the rect UpdateScreenPosition would place against the viewport
+    POINT center;
+    camera->ProjectPoints(&p, &center, 1, originX, originY, m_scale3D);
+    RECT rect;
+    rect.left = center.x - m_width / 2;
+    rect.top = center.y - m_height / 2;
+    rect.right = rect.left + m_width;
+    rect.bottom = rect.top + m_height;
+    return Renderer::RectsIntersect(rect, *viewport);
+}
+
 void Widget3D::ScreenToRay(int screenX, int screenY, int screenWidth, int screenHeight,
                           const CameraController* camera,
                           Renderer::Vector3D& rayOrigin, Renderer::Vector3D& rayDirection) {
@@ -197,15 +228,8 @@ void Button3D::Render(HDC hdc) {
     SetBkMode(hdc, TRANSPARENT);
     SetTextColor(hdc, m_textColor.ToCOLORREF());
     
-    HFONT font = CreateFontW(16, 0, 0, 0, FW_NORMAL, FALSE, FALSE, FALSE,
-                            DEFAULT_CHARSET, OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS,
-                            DEFAULT_QUALITY, DEFAULT_PITCH | FF_DONTCARE, L"Arial");
-    HFONT oldFont = (HFONT)SelectObject(hdc, font);
-    
+    ScopedFont font(hdc, FontCache::Get(L"Arial", 16));
     DrawTextW(hdc, m_text.c_str(), -1, &rect, DT_CENTER | DT_VCENTER | DT_SINGLELINE);
-    
-    SelectObject(hdc, oldFont);
-    DeleteObject(font);
 }
 
 bool Button3D::HandleMouseMove(int x, int y) {
@@ -267,15 +291,8 @@ void Label3D::Render(HDC hdc) {
     SetBkMode(hdc, TRANSPARENT);
     SetTextColor(hdc, m_textColor.ToCOLORREF());
     
-    HFONT font = CreateFontW(14, 0, 0, 0, FW_NORMAL, FALSE, FALSE, FALSE,
-                            DEFAULT_CHARSET, OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS,
-                            DEFAULT_QUALITY, DEFAULT_PITCH | FF_DONTCARE, L"Arial");
-    HFONT oldFont = (HFONT)SelectObject(hdc, font);
-    
+    ScopedFont font(hdc, FontCache::Get(L"Arial", 14));
     DrawTextW(hdc, m_text.c_str(), -1, &rect, DT_CENTER | DT_VCENTER | DT_SINGLELINE);
-    
-    SelectObject(hdc, oldFont);
-    DeleteObject(font);
 }
 
 // Panel3D implementation
@@ -303,12 +320,11 @@ void Panel3D::Render(HDC hdc) {
         Renderer::DrawRoundedRect(hdc, rect, m_cornerRadius, m_backgroundColor, m_borderColor, m_borderWidth);
     } else {
         // Draw regular rectangle
-        HBRUSH brush = CreateSolidBrush(m_backgroundColor.ToCOLORREF());
+        HBRUSH brush = GdiObjectCache::GetBrush(m_backgroundColor.ToCOLORREF());
         FillRect(hdc, &rect, brush);
-        DeleteObject(brush);
         
         if (m_borderWidth > 0) {
-            HPEN pen = CreatePen(PS_SOLID, m_borderWidth, m_borderColor.ToCOLORREF());
+            HPEN pen = GdiObjectCache::GetPen(m_borderColor.ToCOLORREF(), m_borderWidth);
             HPEN oldPen = (HPEN)SelectObject(hdc, pen);
             HBRUSH oldBrush = (HBRUSH)SelectObject(hdc, GetStockObject(NULL_BRUSH));
             
@@ -316,7 +332,6 @@ void Panel3D::Render(HDC hdc) {
             
             SelectObject(hdc, oldPen);
             SelectObject(hdc, oldBrush);
-            DeleteObject(pen);
         }
     }
 }
@@ -326,6 +341,7 @@ void Panel3D::Render(HDC hdc) {
 Widget3DManager::Widget3DManager()
     : m_hoveredWidget(nullptr)
     , m_focusedWidget(nullptr)
+    , m_culledCount(0)
 {
 }
 
@@ -335,6 +351,7 @@ Widget3DManager::~Widget3DManager() {
 void Widget3DManager::AddWidget(std::shared_ptr<Widget3D> widget) {
     if (widget) {
         m_widgets.push_back(widget);
+        m_bvh.Insert(widget);
     }
 }
 
@@ -342,11 +359,13 @@ void Widget3DManager::RemoveWidget(std::shared_ptr<Widget3D> widget) {
     auto it = std::find(m_widgets.begin(), m_widgets.end(), widget);
     if (it != m_widgets.end()) {
         m_widgets.erase(it);
+        m_bvh.Remove(widget.get());
     }
 }
 
 void Widget3DManager::ClearWidgets() {
     m_widgets.clear();
+    m_bvh.Clear();
     m_hoveredWidget = nullptr;
     m_focusedWidget = nullptr;
 }
@@ -357,9 +376,18 @@ void Widget3DManager::RenderAll(HDC hdc, CameraController* camera, int originX,
     // Sort widgets by depth (back to front)
     SortByDepth(camera);
     
+    // Widgets outside the frustum are neither positioned nor drawn
+    RECT clip;
+    const RECT* viewport = GetClipBox(hdc, &clip) != ERROR ? &clip : nullptr;
+    m_culledCount = 0;
+    
     // Render all widgets
     for (auto& widget : m_widgets) {
         if (widget && widget->IsVisible()) {
+            if (!widget->IsInFrustum(camera, originX, originY, viewport)) {
+                m_culledCount++;
+                continue;
+            }
             widget->Render3D(hdc, camera, originX, originY);
         }
     }
@@ -413,7 +441,9 @@ void Widget3DManager::UpdateAll(float deltaTime, CameraController* camera, int o
     for (auto& widget : m_widgets) {
         if (widget) {
             widget->Update(deltaTime);
-            widget->UpdateScreenPosition(camera, originX, originY);
+            if (widget->IsInFrustum(camera, originX, originY)) {
+                widget->UpdateScreenPosition(camera, originX, originY);
+            }
         }
     }
 }
@@ -426,32 +456,54 @@ std::shared_ptr<Widget3D> Widget3DManager::FindWidgetAtPosition(int screenX, int
     Widget3D::ScreenToRay(screenX, screenY, screenWidth, screenHeight, camera, rayOrigin, rayDirection);
     
     // Find closest widget hit by ray
-    std::shared_ptr<Widget3D> closestWidget = nullptr;
-    float closestDistance = std::numeric_limits<float>::max();
+    float distance;
+    return m_bvh.Raycast(rayOrigin, rayDirection, distance);
+}
+
+void Widget3DManager::SortByDepth(const CameraController* camera) {
+    if (!camera) return;
     
-    for (auto& widget : m_widgets) {
-        if (!widget || !widget->IsVisible() || !widget->IsEnabled()) continue;
+    // One distance per widget instead of two per comparison
+    size_t count = m_widgets.size();
+    m_depthKeys.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        m_depthKeys[i] = m_widgets[i] ? m_widgets[i]->GetDistanceFromCamera(camera) : 0.0f;
+    }
+    
+    // Far to near. The order changes little between frames, so insertion
+    // sort over the last frame's order is close to linear; a large jump
+    // (the camera turning around) falls back to a full sort
+    size_t budget = count * 4;
+    size_t i = 1;
+    for (; i < count && budget > 0; i++) {
+        float key = m_depthKeys[i];
+        if (m_depthKeys[i - 1] >= key) continue;
         
-        float distance;
-        if (widget->HitTest3D(rayOrigin, rayDirection, distance)) {
-            if (distance < closestDistance) {
-                closestDistance = distance;
-                closestWidget = widget;
-            }
+        std::shared_ptr<Widget3D> widget = std::move(m_widgets[i]);
+        size_t j = i;
+        for (; j > 0 && m_depthKeys[j - 1] < key; j--) {
+            m_depthKeys[j] = m_depthKeys[j - 1];
+            m_widgets[j] = std::move(m_widgets[j - 1]);
         }
+        m_depthKeys[j] = key;
+        m_widgets[j] = std::move(widget);
+        budget -= std::min(budget, i - j);
     }
+    if (i >= count) return;
     
-    return closestWidget;
-}
-
-void Widget3DManager::SortByDepth(const CameraController* camera) {
-    if (!camera) return;
+    m_depthOrder.resize(count);
+    for (size_t k = 0; k < count; k++) {
+        m_depthOrder[k] = k;
+    }
+    std::stable_sort(m_depthOrder.begin(), m_depthOrder.end(),
+        [this](size_t a, size_t b) { return m_depthKeys[a] > m_depthKeys[b]; });
     
-    // Sort widgets by distance from camera (far to near for proper rendering)
-    std::sort(m_widgets.begin(), m_widgets.end(),
-        [camera](const std::shared_ptr<Widget3D>& a, const std::shared_ptr<Widget3D>& b) {
-            return a->GetDistanceFromCamera(camera) > b->GetDistanceFromCamera(camera);
-        });
+    std::vector<std::shared_ptr<Widget3D>> sorted;
+    sorted.reserve(count);
+    for (size_t k = 0; k < count; k++) {
+        sorted.push_back(std::move(m_widgets[m_depthOrder[k]]));
+    }
+    m_widgets.swap(sorted);
 }
 
 } // namespace SDK
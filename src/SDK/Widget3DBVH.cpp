@@ -0,0 +1,262 @@
+#include "../../include/SDK/Widget3DBVH.h"
+#include "../../include/SDK/Widget3D.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace SDK {
+
+namespace {
+    inline float Center(const float* min, const float* max, int axis) {
+        return (min[axis] + max[axis]) * 0.5f;
+    }
+
+    // Ray entry distance into the box, if it enters before maxDistance
+    inline bool EnterBox(const float* min, const float* max, const float* origin, const float* inverse,
+                         float maxDistance, float& enter) {
+        float t0 = 0.0f;
+        float t1 = maxDistance;
+        for (int axis = 0; axis < 3; axis++) {
+            float a = (min[axis] - origin[axis]) * inverse[axis];
+            float b = (max[axis] - origin[axis]) * inverse[axis];
+            if (a > b) std::swap(a, b);
+            t0 = std::max(t0, a);
+            t1 = std::min(t1, b);
+            if (t0 > t1) return false;
+        }
+        enter = t0;
+        return true;
+    }
+}
+
+Widget3DBVH::Widget3DBVH()
+    : m_root(-1)
+    , m_dirty(false)
+    , m_refits(0)
+    , m_syncedEpoch(Widget::GetGeometryEpoch())
+{
+}
+
+void Widget3DBVH::Insert(std::shared_ptr<Widget3D> widget) {
+    if (!widget) return;
+
+    Remove(widget.get());
+
+    Entry entry;
+    entry.widget = widget;
+    entry.version = widget->GetGeometryVersion();
+    entry.node = -1;
+    m_entries.push_back(entry);
+    m_dirty = true;
+}
+
+void Widget3DBVH::Remove(const Widget3D* widget) {
+    for (size_t i = 0; i < m_entries.size(); i++) {
+        if (m_entries[i].widget.get() == widget) {
+            m_entries[i] = std::move(m_entries.back());
+            m_entries.pop_back();
+            m_dirty = true;
+            return;
+        }
+    }
+}
+
+void Widget3DBVH::Clear() {
+    m_entries.clear();
+    m_nodes.clear();
+    m_root = -1;
+    m_dirty = false;
+    m_refits = 0;
+}
+
+Widget3DBVH::Bounds Widget3DBVH::GetBounds(const Widget3D& widget) {
+    Renderer::Vector3D center = widget.GetPosition3D();
+    float radius = widget.GetBoundingRadius();
+    Bounds bounds;
+    bounds.min[0] = center.x - radius;
+    bounds.min[1] = center.y - radius;
+    bounds.min[2] = center.z - radius;
+    bounds.max[0] = center.x + radius;
+    bounds.max[1] = center.y + radius;
+    bounds.max[2] = center.z + radius;
+    return bounds;
+}
+
+void Widget3DBVH::Sync() const {
+    uint64_t epoch = Widget::GetGeometryEpoch();
+    if (!m_dirty && epoch == m_syncedEpoch) return;
+    m_syncedEpoch = epoch;
+
+    if (!m_dirty) {
+        for (auto& entry : m_entries) {
+            uint64_t version = entry.widget->GetGeometryVersion();
+            if (version == entry.version) continue;
+
+            entry.version = version;
+            m_nodes[entry.node].bounds = GetBounds(*entry.widget);
+            for (int node = m_nodes[entry.node].parent; node >= 0; node = m_nodes[node].parent) {
+                Refit(node);
+            }
+            m_refits++;
+        }
+
+        // Refit boxes only ever loosen the split; rebuild once most leaves moved
+        if (m_refits <= m_entries.size()) return;
+    }
+    Build();
+}
+
+void Widget3DBVH::Refit(int node) const {
+    Node& n = m_nodes[node];
+    const Bounds& a = m_nodes[n.left].bounds;
+    const Bounds& b = m_nodes[n.right].bounds;
+    for (int axis = 0; axis < 3; axis++) {
+        n.bounds.min[axis] = std::min(a.min[axis], b.min[axis]);
+        n.bounds.max[axis] = std::max(a.max[axis], b.max[axis]);
+    }
+}
+
+void Widget3DBVH::Build() const {
+    m_nodes.clear();
+    m_root = -1;
+    m_dirty = false;
+    m_refits = 0;
+    if (m_entries.empty()) return;
+
+    // Leaves first, so entry i is node i; inner nodes follow
+    m_nodes.reserve(m_entries.size() * 2 - 1);
+    m_order.resize(m_entries.size());
+    for (size_t i = 0; i < m_entries.size(); i++) {
+        Entry& entry = m_entries[i];
+        entry.version = entry.widget->GetGeometryVersion();
+        entry.node = (int)i;
+
+        Node leaf;
+        leaf.bounds = GetBounds(*entry.widget);
+        leaf.left = -1;
+        leaf.right = -1;
+        leaf.parent = -1;
+        leaf.entry = (int)i;
+        m_nodes.push_back(leaf);
+        m_order[i] = i;
+    }
+    m_root = BuildRange(0, m_order.size(), -1);
+}
+
+int Widget3DBVH::BuildRange(size_t begin, size_t end, int parent) const {
+    if (end - begin == 1) {
+        int leaf = (int)m_order[begin];
+        m_nodes[leaf].parent = parent;
+        return leaf;
+    }
+
+    // Split at the median along the longest axis of the leaf centers
+    float lo[3], hi[3];
+    for (int axis = 0; axis < 3; axis++) {
+        lo[axis] = std::numeric_limits<float>::max();
+        hi[axis] = -std::numeric_limits<float>::max();
+    }
+    for (size_t i = begin; i < end; i++) {
+        const Bounds& b = m_nodes[m_order[i]].bounds;
+        for (int axis = 0; axis < 3; axis++) {
+            float c = Center(b.min, b.max, axis);
+            lo[axis] = std::min(lo[axis], c);
+            hi[axis] = std::max(hi[axis], c);
+        }
+    }
+    int axis = 0;
+    for (int a = 1; a < 3; a++) {
+        if (hi[a] - lo[a] > hi[axis] - lo[axis]) axis = a;
+    }
+
+    size_t mid = begin + (end - begin) / 2;
+    std::nth_element(m_order.begin() + begin, m_order.begin() + mid, m_order.begin() + end,
+        [this, axis](size_t a, size_t b) {
+            const Bounds& ba = m_nodes[a].bounds;
+            const Bounds& bb = m_nodes[b].bounds;
+            return Center(ba.min, ba.max, axis) < Center(bb.min, bb.max, axis);
+        });
+
+    int node = (int)m_nodes.size();
+    Node inner;
+    inner.left = -1;
+    inner.right = -1;
+    inner.parent = parent;
+    inner.entry = -1;
+    m_nodes.push_back(inner);
+
+    // m_nodes may reallocate while building the children
+    int left = BuildRange(begin, mid, node);
+    int right = BuildRange(mid, end, node);
+    m_nodes[node].left = left;
+    m_nodes[node].right = right;
+    Refit(node);
+    return node;
+}
+
+std::shared_ptr<Widget3D> Widget3DBVH::Raycast(const Renderer::Vector3D& origin, const Renderer::Vector3D& direction,
+                                               float& distance) const {
+    Sync();
+    if (m_root < 0) return nullptr;
+
+    float o[3] = { origin.x, origin.y, origin.z };
+    float d[3] = { direction.x, direction.y, direction.z };
+    float inverse[3];
+    for (int axis = 0; axis < 3; axis++) {
+        // Parallel to a slab: only boxes the origin lies within stay in range
+        inverse[axis] = std::fabs(d[axis]) > 1e-12f ? 1.0f / d[axis] : std::copysign(1e12f, d[axis]);
+    }
+
+    const Entry* closest = nullptr;
+    float closestDistance = std::numeric_limits<float>::max();
+    float enter;
+
+    m_stack.clear();
+    if (EnterBox(m_nodes[m_root].bounds.min, m_nodes[m_root].bounds.max, o, inverse, closestDistance, enter)) {
+        m_stack.emplace_back(m_root, enter);
+    }
+    while (!m_stack.empty()) {
+        std::pair<int, float> top = m_stack.back();
+        m_stack.pop_back();
+        if (top.second >= closestDistance) continue;
+        const Node& node = m_nodes[top.first];
+
+        if (node.entry >= 0) {
+            const Entry& entry = m_entries[node.entry];
+            const Widget3D& widget = *entry.widget;
+            float hit;
+            if (widget.IsVisible() && widget.IsEnabled() &&
+                widget.HitTest3D(origin, direction, hit) && hit < closestDistance) {
+                closestDistance = hit;
+                closest = &entry;
+            }
+            continue;
+        }
+
+        // Nearer child on top of the stack; boxes past the closest hit are skipped
+        float enterLeft, enterRight;
+        const Node& left = m_nodes[node.left];
+        const Node& right = m_nodes[node.right];
+        bool hitLeft = EnterBox(left.bounds.min, left.bounds.max, o, inverse, closestDistance, enterLeft);
+        bool hitRight = EnterBox(right.bounds.min, right.bounds.max, o, inverse, closestDistance, enterRight);
+        if (hitLeft && hitRight) {
+            if (enterLeft <= enterRight) {
+                m_stack.emplace_back(node.right, enterRight);
+                m_stack.emplace_back(node.left, enterLeft);
+            } else {
+                m_stack.emplace_back(node.left, enterLeft);
+                m_stack.emplace_back(node.right, enterRight);
+            }
+        } else if (hitLeft) {
+            m_stack.emplace_back(node.left, enterLeft);
+        } else if (hitRight) {
+            m_stack.emplace_back(node.right, enterRight);
+        }
+    }
+
+    if (!closest) return nullptr;
+    distance = closestDistance;
+    return closest->widget;
+}
+
+} // namespace SDK
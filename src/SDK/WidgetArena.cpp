@@ -0,0 +1,74 @@
+#include "../../include/SDK/WidgetArena.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace SDK {
+
+struct WidgetArena::Storage {
+    std::vector<std::unique_ptr<unsigned char[]>> blocks;
+    size_t blockSize;
+    unsigned char* cursor = nullptr;
+    unsigned char* end = nullptr;
+    size_t used = 0;
+    size_t reserved = 0;
+
+    explicit Storage(size_t size) : blockSize(size) {}
+};
+
+namespace {
+    thread_local WidgetArena* t_current = nullptr;
+}
+
+WidgetArena::WidgetArena(size_t blockSize)
+    : m_storage(std::make_shared<Storage>(std::max<size_t>(blockSize, 256))) {
+}
+
+void* WidgetArena::Allocate(size_t size, size_t alignment) {
+    return AllocateFrom(*m_storage, size, alignment);
+}
+
+void* WidgetArena::AllocateFrom(Storage& storage, size_t size, size_t alignment) {
+    uintptr_t cursor = (uintptr_t)storage.cursor;
+    uintptr_t aligned = (cursor + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    if (!storage.cursor || aligned + size > (uintptr_t)storage.end) {
+        // Oversized requests get a block of their own
+        size_t blockSize = std::max(storage.blockSize, size + alignment);
+        storage.blocks.emplace_back(new unsigned char[blockSize]);
+        storage.cursor = storage.blocks.back().get();
+        storage.end = storage.cursor + blockSize;
+        storage.reserved += blockSize;
+        cursor = (uintptr_t)storage.cursor;
+        aligned = (cursor + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    }
+    storage.used += (aligned - cursor) + size;
+    storage.cursor = (unsigned char*)(aligned + size);
+    return (void*)aligned;
+}
+
+size_t WidgetArena::GetBytesUsed() const {
+    return m_storage->used;
+}
+
+size_t WidgetArena::GetBytesReserved() const {
+    return m_storage->reserved;
+}
+
+size_t WidgetArena::GetBlockCount() const {
+    return m_storage->blocks.size();
+}
+
+WidgetArena::Scope::Scope(WidgetArena* arena)
+    : m_previous(t_current) {
+    t_current = arena;
+}
+
+WidgetArena::Scope::~Scope() {
+    t_current = m_previous;
+}
+
+WidgetArena* WidgetArena::GetCurrent() {
+    return t_current;
+}
+
+} // namespace SDK
@@ -1,10 +1,12 @@
 #include "../../include/SDK/WidgetManager.h"
+#include "../../include/SDK/EventQueue.h"
 #include <algorithm>
 
 namespace SDK {
 
 WidgetManager::WidgetManager()
-    : m_hoveredWidget(nullptr)
+    : m_widgetHoles(0)
+    , m_hoveredWidget(nullptr)
     , m_pressedWidget(nullptr)
 {
 }
@@ -13,25 +15,70 @@ WidgetManager::~WidgetManager() {
     Clear();
 }
 
+namespace {
+    template <typename Key>
+    void EraseIndexEntry(std::unordered_multimap<Key, Widget*>& index, const Key& key, Widget* widget) {
+        auto range = index.equal_range(key);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == widget) {
+                index.erase(it);
+                return;
+            }
+        }
+    }
+}
+
+// Earliest added of the widgets under key; slots keep insertion order
+template <typename Key>
+Widget* WidgetManager::FindIndexEntry(const std::unordered_multimap<Key, Widget*>& index, const Key& key) {
+    Widget* found = nullptr;
+    auto range = index.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (!found || it->second->m_managerSlot < found->m_managerSlot) found = it->second;
+    }
+    return found;
+}
+
 void WidgetManager::AddWidget(std::shared_ptr<Widget> widget) {
-    if (widget) {
-        m_widgets.push_back(widget);
+    if (!widget || widget->m_manager == this) return;
+    if (widget->m_manager) {
+        widget->m_manager->RemoveWidget(widget);
+    }
+    
+    widget->m_manager = this;
+    widget->m_managerSlot = (uint32_t)m_widgets.size();
+    m_widgets.push_back(widget);
+    m_widgetsById.emplace(widget->GetId(), widget.get());
+    m_widgetsByName.emplace(widget->m_name, widget.get());
+    m_widgetIndex.Insert(widget);
+    widget->AttachToTree(&m_tree);
+    if (m_optimizedRenderer) {
+        InstallInvalidateHandler(*widget);
     }
 }
 
 void WidgetManager::RemoveWidget(std::shared_ptr<Widget> widget) {
-    if (!widget) return;
+    if (!widget || widget->m_manager != this) return;
     
-    auto it = std::find(m_widgets.begin(), m_widgets.end(), widget);
-    if (it != m_widgets.end()) {
-        if (m_hoveredWidget == widget) {
-            m_hoveredWidget = nullptr;
-        }
-        if (m_pressedWidget == widget) {
-            m_pressedWidget = nullptr;
-        }
-        m_widgets.erase(it);
+    if (m_hoveredWidget == widget) {
+        m_hoveredWidget = nullptr;
+    }
+    if (m_pressedWidget == widget) {
+        m_pressedWidget = nullptr;
     }
+    m_widgetIndex.Remove(widget.get());
+    if (m_optimizedRenderer) {
+        m_optimizedRenderer->RemoveWidget(widget.get());
+        widget->SetInvalidateHandler(nullptr);
+    }
+    m_compositor.RemoveWidget(widget.get());
+    widget->DetachFromTree();
+    
+    EraseIndexEntry(m_widgetsById, widget->GetId(), widget.get());
+    EraseIndexEntry(m_widgetsByName, widget->m_name, widget.get());
+    m_widgets[widget->m_managerSlot].reset();
+    m_widgetHoles++;
+    widget->m_manager = nullptr;
 }
 
 void WidgetManager::RemoveWidgetById(int id) {
@@ -42,39 +89,154 @@ void WidgetManager::RemoveWidgetById(int id) {
 }
 
 void WidgetManager::Clear() {
+    CompactWidgets();
+    if (m_optimizedRenderer) {
+        for (const auto& widget : m_widgets) {
+            widget->SetInvalidateHandler(nullptr);
+        }
+        m_optimizedRenderer->Clear();
+    }
+    m_compositor.Clear();
+    for (const auto& widget : m_widgets) {
+        widget->DetachFromTree();
+        widget->m_manager = nullptr;
+    }
     m_widgets.clear();
+    m_widgetsById.clear();
+    m_widgetsByName.clear();
+    m_widgetIndex.Clear();
     m_hoveredWidget = nullptr;
     m_pressedWidget = nullptr;
 }
 
+void WidgetManager::CompactWidgets() const {
+    if (m_widgetHoles == 0) return;
+    
+    m_widgets.erase(std::remove(m_widgets.begin(), m_widgets.end(), nullptr), m_widgets.end());
+    for (size_t i = 0; i < m_widgets.size(); i++) {
+        m_widgets[i]->m_managerSlot = (uint32_t)i;
+    }
+    m_widgetHoles = 0;
+}
+
+const std::vector<std::shared_ptr<Widget>>& WidgetManager::GetWidgets() const {
+    CompactWidgets();
+    return m_widgets;
+}
+
 std::shared_ptr<Widget> WidgetManager::GetWidgetById(int id) const {
-    for (const auto& widget : m_widgets) {
-        if (widget->GetId() == id) {
-            return widget;
+    Widget* widget = FindIndexEntry(m_widgetsById, id);
+    return widget ? m_widgets[widget->m_managerSlot] : nullptr;
+}
+
+std::shared_ptr<Widget> WidgetManager::GetWidgetByName(const std::wstring& name) const {
+    InternedString interned;
+    if (!InternedString::Find(name, interned)) return nullptr;
+    Widget* widget = FindIndexEntry(m_widgetsByName, interned);
+    return widget ? m_widgets[widget->m_managerSlot] : nullptr;
+}
+
+void WidgetManager::ReindexId(Widget* widget, int previousId) {
+    EraseIndexEntry(m_widgetsById, previousId, widget);
+    m_widgetsById.emplace(widget->GetId(), widget);
+}
+
+void WidgetManager::ReindexName(Widget* widget, InternedString previousName) {
+    EraseIndexEntry(m_widgetsByName, previousName, widget);
+    m_widgetsByName.emplace(widget->m_name, widget);
+}
+
+std::shared_ptr<Widget> WidgetManager::GetWidgetAt(int x, int y) const {
+    // Topmost by z-index, then by insertion order, among the candidates
+    // whose HitTest accepts the point
+    return m_widgetIndex.HitTest(x, y);
+}
+
+void WidgetManager::SetRenderOptimizer(std::shared_ptr<RendererOptimizer> optimizer) {
+    CompactWidgets();
+    if (!optimizer) {
+        if (m_optimizedRenderer) {
+            for (const auto& widget : m_widgets) {
+                widget->SetInvalidateHandler(nullptr);
+            }
         }
+        m_optimizedRenderer.reset();
+        return;
+    }
+    
+    m_optimizedRenderer.reset(new OptimizedWidgetRenderer(optimizer));
+    for (const auto& widget : m_widgets) {
+        InstallInvalidateHandler(*widget);
     }
-    return nullptr;
 }
 
-std::shared_ptr<Widget> WidgetManager::GetWidgetAt(int x, int y) const {
-    // Search in reverse order (top to bottom)
-    for (auto it = m_widgets.rbegin(); it != m_widgets.rend(); ++it) {
-        if ((*it)->HitTest(x, y)) {
-            return *it;
+std::shared_ptr<RendererOptimizer> WidgetManager::GetRenderOptimizer() const {
+    return m_optimizedRenderer ? m_optimizedRenderer->GetOptimizer() : nullptr;
+}
+
+void WidgetManager::InstallInvalidateHandler(Widget& widget) {
+    widget.SetInvalidateHandler([this](const RECT& rect) {
+        if (m_optimizedRenderer) {
+            m_optimizedRenderer->Invalidate(rect);
+        }
+        if (m_invalidateHandler) {
+            m_invalidateHandler(rect);
+        }
+    });
+}
+
+template <typename RenderFn>
+void WidgetManager::RenderUnoccluded(RenderFn render) {
+    CompactWidgets();
+    m_renderStats.occluded = Widget::CullOccluded(m_widgets, m_hiddenWidgets);
+    for (size_t i = 0; i < m_widgets.size(); i++) {
+        if (!m_hiddenWidgets[i] && render(*m_widgets[i])) {
+            m_renderStats.rendered++;
         }
     }
-    return nullptr;
 }
 
 void WidgetManager::RenderAll(HDC hdc) {
-    for (const auto& widget : m_widgets) {
-        widget->Render(hdc);
+    m_renderStats = OptimizedWidgetRenderer::Stats();
+    CompactWidgets();
+    if (m_optimizedRenderer) {
+        RECT clipBox;
+        int clipType = GetClipBox(hdc, &clipBox);
+        if (clipType == NULLREGION) return;
+        if (clipType != ERROR) {
+            // Coverage is measured against the client area of the DC's window
+            RECT view = clipBox;
+            HWND hwnd = WindowFromDC(hdc);
+            if (hwnd) GetClientRect(hwnd, &view);
+            
+            std::vector<RECT> regions(1, clipBox);
+            m_optimizedRenderer->Render(hdc, m_widgets, regions, view, m_renderStats, &m_compositor);
+            return;
+        }
     }
+    
+    RenderUnoccluded([this, hdc](Widget& widget) {
+        if (m_compositor.Composite(hdc, widget, m_renderStats.layers)) return false;
+        widget.Render(hdc);
+        return true;
+    });
+}
+
+void WidgetManager::RenderAll(RenderBackend& backend) {
+    m_renderStats = OptimizedWidgetRenderer::Stats();
+    RenderUnoccluded([&backend](Widget& widget) {
+        widget.Render(backend);
+        return true;
+    });
 }
 
 void WidgetManager::UpdateAll(float deltaTime) {
-    for (const auto& widget : m_widgets) {
-        widget->Update(deltaTime);
+    EventQueue::Dispatch();
+    CompactWidgets();
+    
+    // Widgets removed during the pass leave holes behind
+    for (size_t i = 0; i < m_widgets.size(); i++) {
+        if (m_widgets[i]) m_widgets[i]->Update(deltaTime);
     }
 }
 
@@ -123,6 +285,7 @@ void WidgetManager::HandleMouseUp(int x, int y) {
 }
 
 void WidgetManager::SetAllEnabled(bool enabled) {
+    CompactWidgets();
     for (const auto& widget : m_widgets) {
         widget->SetEnabled(enabled);
     }
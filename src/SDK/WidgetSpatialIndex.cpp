@@ -0,0 +1,252 @@
+#include "../../include/SDK/WidgetSpatialIndex.h"
+#include <algorithm>
+
+namespace SDK {
+
+namespace {
+    // Widgets covering more cells than this are tested on every query instead
+    constexpr int MAX_CELLS_PER_WIDGET = 256;
+
+    inline int FloorDiv(int value, int divisor) {
+        int q = value / divisor;
+        return (value % divisor != 0 && (value < 0) != (divisor < 0)) ? q - 1 : q;
+    }
+
+    inline bool Contains(const RECT& rect, int x, int y) {
+        return x >= rect.left && x < rect.right && y >= rect.top && y < rect.bottom;
+    }
+
+    inline bool Intersects(const RECT& a, const RECT& b) {
+        return a.left < b.right && b.left < a.right && a.top < b.bottom && b.top < a.bottom;
+    }
+}
+
+WidgetSpatialIndex::WidgetSpatialIndex(int cellSize)
+    : m_cellSize(std::max(cellSize, 8))
+    , m_nextOrder(0)
+    , m_queryStamp(0)
+{
+}
+
+WidgetSpatialIndex::~WidgetSpatialIndex() {
+    Clear();
+}
+
+void WidgetSpatialIndex::Insert(std::shared_ptr<Widget> widget) {
+    if (!widget) return;
+
+    Remove(widget.get());
+
+    Entry entry;
+    entry.widget = widget;
+    widget->GetHitBounds(entry.bounds);
+    entry.zIndex = widget->GetZIndex();
+    entry.order = m_nextOrder++;
+    entry.stamp = 0;
+    entry.oversized = false;
+    entry.dirty = false;
+
+    Entry& stored = m_entries[widget.get()];
+    stored = entry;
+    Bin(stored);
+    widget->m_spatialIndexes.push_back(this);
+}
+
+void WidgetSpatialIndex::Remove(const Widget* widget) {
+    auto it = m_entries.find(widget);
+    if (it == m_entries.end()) return;
+
+    Unbin(it->second);
+    auto& indexes = it->second.widget->m_spatialIndexes;
+    indexes.erase(std::find(indexes.begin(), indexes.end(), this));
+    m_entries.erase(it);
+}
+
+void WidgetSpatialIndex::Clear() {
+    for (auto& pair : m_entries) {
+        auto& indexes = pair.second.widget->m_spatialIndexes;
+        indexes.erase(std::find(indexes.begin(), indexes.end(), this));
+    }
+    m_entries.clear();
+    m_cells.clear();
+    m_oversized.clear();
+    m_dirty.clear();
+}
+
+void WidgetSpatialIndex::SetCellSize(int cellSize) {
+    cellSize = std::max(cellSize, 8);
+    if (cellSize == m_cellSize) return;
+
+    m_cellSize = cellSize;
+    m_cells.clear();
+    m_oversized.clear();
+    for (auto& pair : m_entries) {
+        Bin(pair.second);
+    }
+}
+
+bool WidgetSpatialIndex::IsAbove(const Entry& a, const Entry& b) const {
+    if (a.zIndex != b.zIndex) return a.zIndex > b.zIndex;
+    return a.order > b.order;
+}
+
+void WidgetSpatialIndex::Bin(Entry& entry) const {
+    const RECT& r = entry.bounds;
+    entry.oversized = false;
+    if (r.right <= r.left || r.bottom <= r.top) return;
+
+    int cx0 = FloorDiv(r.left, m_cellSize);
+    int cy0 = FloorDiv(r.top, m_cellSize);
+    int cx1 = FloorDiv(r.right - 1, m_cellSize);
+    int cy1 = FloorDiv(r.bottom - 1, m_cellSize);
+
+    const Widget* key = entry.widget.get();
+    if ((long long)(cx1 - cx0 + 1) * (cy1 - cy0 + 1) > MAX_CELLS_PER_WIDGET) {
+        entry.oversized = true;
+        m_oversized.push_back(key);
+        return;
+    }
+
+    for (int cy = cy0; cy <= cy1; cy++) {
+        for (int cx = cx0; cx <= cx1; cx++) {
+            m_cells[CellKey(cx, cy)].push_back(key);
+        }
+    }
+}
+
+void WidgetSpatialIndex::Unbin(const Entry& entry) const {
+    const Widget* key = entry.widget.get();
+    if (entry.oversized) {
+        m_oversized.erase(std::remove(m_oversized.begin(), m_oversized.end(), key), m_oversized.end());
+        return;
+    }
+
+    const RECT& r = entry.bounds;
+    if (r.right <= r.left || r.bottom <= r.top) return;
+
+    int cx0 = FloorDiv(r.left, m_cellSize);
+    int cy0 = FloorDiv(r.top, m_cellSize);
+    int cx1 = FloorDiv(r.right - 1, m_cellSize);
+    int cy1 = FloorDiv(r.bottom - 1, m_cellSize);
+    for (int cy = cy0; cy <= cy1; cy++) {
+        for (int cx = cx0; cx <= cx1; cx++) {
+            auto cell = m_cells.find(CellKey(cx, cy));
+            if (cell == m_cells.end()) continue;
+            auto& list = cell->second;
+            list.erase(std::remove(list.begin(), list.end(), key), list.end());
+            if (list.empty()) m_cells.erase(cell);
+        }
+    }
+}
+
+void WidgetSpatialIndex::MarkDirty(const Widget* widget) {
+    Entry& entry = m_entries.at(widget);
+    if (entry.dirty) return;
+    entry.dirty = true;
+    m_dirty.push_back(widget);
+}
+
+void WidgetSpatialIndex::Sync() const {
+    for (const Widget* key : m_dirty) {
+        auto it = m_entries.find(key);
+        if (it == m_entries.end() || !it->second.dirty) continue;   // Removed since
+
+        Entry& entry = it->second;
+        Unbin(entry);
+        entry.widget->GetHitBounds(entry.bounds);
+        entry.zIndex = entry.widget->GetZIndex();
+        entry.dirty = false;
+        Bin(entry);
+    }
+    m_dirty.clear();
+}
+
+void WidgetSpatialIndex::SortTopmostFirst(std::vector<const Entry*>& entries) const {
+    std::sort(entries.begin(), entries.end(), [this](const Entry* a, const Entry* b) {
+        return IsAbove(*a, *b);
+    });
+}
+
+std::shared_ptr<Widget> WidgetSpatialIndex::HitTest(int x, int y) const {
+    Sync();
+
+    const Entry* best = nullptr;
+    auto consider = [&](const Widget* key) {
+        const Entry& entry = m_entries.at(key);
+        if (best && !IsAbove(entry, *best)) return;
+        if (!Contains(entry.bounds, x, y) || !entry.widget->IsVisible()) return;
+        // Hit bounds only narrow the search; the widget decides its own shape
+        if (!entry.widget->HitTest(x, y)) return;
+        best = &entry;
+    };
+
+    auto cell = m_cells.find(CellKey(FloorDiv(x, m_cellSize), FloorDiv(y, m_cellSize)));
+    if (cell != m_cells.end()) {
+        for (const Widget* key : cell->second) consider(key);
+    }
+    for (const Widget* key : m_oversized) consider(key);
+
+    return best ? best->widget : nullptr;
+}
+
+void WidgetSpatialIndex::QueryPoint(int x, int y, std::vector<std::shared_ptr<Widget>>& results) const {
+    Sync();
+    results.clear();
+
+    std::vector<const Entry*> hits;
+    auto consider = [&](const Widget* key) {
+        const Entry& entry = m_entries.at(key);
+        if (Contains(entry.bounds, x, y) && entry.widget->IsVisible()) {
+            hits.push_back(&entry);
+        }
+    };
+
+    auto cell = m_cells.find(CellKey(FloorDiv(x, m_cellSize), FloorDiv(y, m_cellSize)));
+    if (cell != m_cells.end()) {
+        for (const Widget* key : cell->second) consider(key);
+    }
+    for (const Widget* key : m_oversized) consider(key);
+
+    SortTopmostFirst(hits);
+    for (const Entry* entry : hits) {
+        results.push_back(entry->widget);
+    }
+}
+
+void WidgetSpatialIndex::QueryRect(const RECT& rect, std::vector<std::shared_ptr<Widget>>& results) const {
+    Sync();
+    results.clear();
+    if (rect.right <= rect.left || rect.bottom <= rect.top) return;
+
+    // A widget spanning several cells is seen once per cell; the stamp skips repeats
+    uint64_t stamp = ++m_queryStamp;
+    std::vector<const Entry*> hits;
+    auto consider = [&](const Widget* key) {
+        Entry& entry = m_entries.at(key);
+        if (entry.stamp == stamp) return;
+        entry.stamp = stamp;
+        if (Intersects(entry.bounds, rect)) {
+            hits.push_back(&entry);
+        }
+    };
+
+    int cx0 = FloorDiv(rect.left, m_cellSize);
+    int cy0 = FloorDiv(rect.top, m_cellSize);
+    int cx1 = FloorDiv(rect.right - 1, m_cellSize);
+    int cy1 = FloorDiv(rect.bottom - 1, m_cellSize);
+    for (int cy = cy0; cy <= cy1; cy++) {
+        for (int cx = cx0; cx <= cx1; cx++) {
+            auto cell = m_cells.find(CellKey(cx, cy));
+            if (cell == m_cells.end()) continue;
+            for (const Widget* key : cell->second) consider(key);
+        }
+    }
+    for (const Widget* key : m_oversized) consider(key);
+
+    SortTopmostFirst(hits);
+    for (const Entry* entry : hits) {
+        results.push_back(entry->widget);
+    }
+}
+
+} // namespace SDK
@@ -0,0 +1,92 @@
+#include "../../include/SDK/WidgetStyle.h"
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace SDK {
+
+namespace {
+    struct Pool {
+        std::mutex mutex;
+        std::unordered_multimap<size_t, std::weak_ptr<const WidgetStyle>> styles;  // By Hash()
+    };
+
+    Pool& GetPool() {
+        static Pool* pool = new Pool();     // Outlives static widgets destroyed at exit
+        return *pool;
+    }
+
+    void HashCombine(size_t& seed, size_t value) {
+        seed ^= value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+    }
+}
+
+bool WidgetStyle::operator==(const WidgetStyle& other) const {
+    return paddingLeft == other.paddingLeft && paddingTop == other.paddingTop &&
+           paddingRight == other.paddingRight && paddingBottom == other.paddingBottom &&
+           marginLeft == other.marginLeft && marginTop == other.marginTop &&
+           marginRight == other.marginRight && marginBottom == other.marginBottom &&
+           minWidth == other.minWidth && minHeight == other.minHeight &&
+           maxWidth == other.maxWidth && maxHeight == other.maxHeight &&
+           borderWidth == other.borderWidth && borderRadius == other.borderRadius &&
+           fontSize == other.fontSize && fontBold == other.fontBold && fontItalic == other.fontItalic &&
+           alignment == other.alignment && fontFamily == other.fontFamily &&
+           tooltipText == other.tooltipText && cursor == other.cursor && theme == other.theme;
+}
+
+size_t WidgetStyle::Hash() const {
+    size_t seed = 0;
+    for (int value : { paddingLeft, paddingTop, paddingRight, paddingBottom,
+                       marginLeft, marginTop, marginRight, marginBottom,
+                       minWidth, minHeight, maxWidth, maxHeight,
+                       borderWidth, borderRadius, fontSize, (int)fontBold, (int)fontItalic, (int)alignment }) {
+        HashCombine(seed, std::hash<int>()(value));
+    }
+    HashCombine(seed, std::hash<InternedString>()(fontFamily));
+    HashCombine(seed, std::hash<std::wstring>()(tooltipText));
+    HashCombine(seed, std::hash<const void*>()(cursor));
+    HashCombine(seed, std::hash<const void*>()(theme.get()));
+    return seed;
+}
+
+std::shared_ptr<const WidgetStyle> WidgetStyle::Intern(const WidgetStyle& style) {
+    Pool& pool = GetPool();
+    size_t hash = style.Hash();
+
+    // Blocks locked while searching may turn out to be the last reference; they
+    // are released after the lock, since their deleter takes it
+    std::vector<std::shared_ptr<const WidgetStyle>> candidates;
+    std::lock_guard<std::mutex> lock(pool.mutex);
+
+    auto range = pool.styles.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        candidates.push_back(it->second.lock());    // Empty while a deleter waits for the lock
+        if (candidates.back() && *candidates.back() == style) return candidates.back();
+    }
+
+    // The deleter drops the block's expired pool entries
+    std::shared_ptr<const WidgetStyle> shared(new WidgetStyle(style), [hash](const WidgetStyle* dead) {
+        delete dead;
+        Pool& pool = GetPool();
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        auto range = pool.styles.equal_range(hash);
+        for (auto it = range.first; it != range.second;) {
+            it = it->second.expired() ? pool.styles.erase(it) : std::next(it);
+        }
+    });
+    pool.styles.emplace(hash, shared);
+    return shared;
+}
+
+const std::shared_ptr<const WidgetStyle>& WidgetStyle::GetDefault() {
+    static const std::shared_ptr<const WidgetStyle> defaultStyle = Intern(WidgetStyle());
+    return defaultStyle;
+}
+
+size_t WidgetStyle::GetPoolSize() {
+    Pool& pool = GetPool();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    return pool.styles.size();
+}
+
+} // namespace SDK
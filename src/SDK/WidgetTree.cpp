@@ -0,0 +1,163 @@
+#include "../../include/SDK/WidgetTree.h"
+
+namespace SDK {
+
+WidgetHandle WidgetTree::MakeHandle(uint32_t index) const {
+    WidgetHandle handle;
+    if (index != NONE) {
+        handle.index = index;
+        handle.generation = m_generations[index];
+    }
+    return handle;
+}
+
+bool WidgetTree::IsLive(WidgetHandle handle) const {
+    return handle.index < m_widgets.size() && m_generations[handle.index] == handle.generation &&
+           m_widgets[handle.index] != nullptr;
+}
+
+WidgetHandle WidgetTree::Insert(Widget* widget, WidgetHandle parent) {
+    if (!widget) return WidgetHandle();
+    uint32_t parentIndex = IsLive(parent) ? parent.index : NONE;
+
+    uint32_t index;
+    if (!m_freeSlots.empty()) {
+        index = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        index = (uint32_t)m_widgets.size();
+        m_widgets.push_back(nullptr);
+        m_generations.push_back(0);
+        m_parents.push_back(NONE);
+        m_firstChildren.push_back(NONE);
+        m_lastChildren.push_back(NONE);
+        m_nextSiblings.push_back(NONE);
+        m_prevSiblings.push_back(NONE);
+    }
+
+    m_widgets[index] = widget;
+    m_parents[index] = parentIndex;
+    m_firstChildren[index] = NONE;
+    m_lastChildren[index] = NONE;
+    m_nextSiblings[index] = NONE;
+
+    uint32_t& first = parentIndex != NONE ? m_firstChildren[parentIndex] : m_firstRoot;
+    uint32_t& last = parentIndex != NONE ? m_lastChildren[parentIndex] : m_lastRoot;
+    m_prevSiblings[index] = last;
+    if (last != NONE) {
+        m_nextSiblings[last] = index;
+    } else {
+        first = index;
+    }
+    last = index;
+
+    m_size++;
+    m_orderDirty = true;
+    return MakeHandle(index);
+}
+
+void WidgetTree::Unlink(uint32_t index) {
+    uint32_t parent = m_parents[index];
+    uint32_t prev = m_prevSiblings[index];
+    uint32_t next = m_nextSiblings[index];
+    (prev != NONE ? m_nextSiblings[prev] : (parent != NONE ? m_firstChildren[parent] : m_firstRoot)) = next;
+    (next != NONE ? m_prevSiblings[next] : (parent != NONE ? m_lastChildren[parent] : m_lastRoot)) = prev;
+}
+
+void WidgetTree::Release(uint32_t index) {
+    // Iterative, so deep trees don't recurse
+    std::vector<uint32_t> pending(1, index);
+    while (!pending.empty()) {
+        uint32_t slot = pending.back();
+        pending.pop_back();
+        for (uint32_t child = m_firstChildren[slot]; child != NONE; child = m_nextSiblings[child]) {
+            pending.push_back(child);
+        }
+        m_widgets[slot] = nullptr;
+        m_generations[slot]++;
+        m_freeSlots.push_back(slot);
+        m_size--;
+    }
+}
+
+void WidgetTree::Remove(WidgetHandle handle) {
+    if (!IsLive(handle)) return;
+    Unlink(handle.index);
+    Release(handle.index);
+    m_orderDirty = true;
+}
+
+void WidgetTree::Clear() {
+    // Slots and generations stay, so old handles never match a new widget
+    m_freeSlots.clear();
+    for (uint32_t i = (uint32_t)m_widgets.size(); i-- > 0;) {
+        if (m_widgets[i]) m_generations[i]++;
+        m_widgets[i] = nullptr;
+        m_freeSlots.push_back(i);
+    }
+    m_firstRoot = NONE;
+    m_lastRoot = NONE;
+    m_size = 0;
+    m_orderDirty = true;
+}
+
+Widget* WidgetTree::Get(WidgetHandle handle) const {
+    return IsLive(handle) ? m_widgets[handle.index] : nullptr;
+}
+
+WidgetHandle WidgetTree::GetParent(WidgetHandle handle) const {
+    return IsLive(handle) ? MakeHandle(m_parents[handle.index]) : WidgetHandle();
+}
+
+WidgetHandle WidgetTree::GetFirstChild(WidgetHandle handle) const {
+    return IsLive(handle) ? MakeHandle(m_firstChildren[handle.index]) : WidgetHandle();
+}
+
+WidgetHandle WidgetTree::GetNextSibling(WidgetHandle handle) const {
+    return IsLive(handle) ? MakeHandle(m_nextSiblings[handle.index]) : WidgetHandle();
+}
+
+const std::vector<WidgetTree::OrderEntry>& WidgetTree::GetOrder() const {
+    if (m_orderDirty) RebuildOrder();
+    return m_order;
+}
+
+uint32_t WidgetTree::GetOrderIndex(WidgetHandle handle) const {
+    if (!IsLive(handle)) return WidgetHandle::INVALID;
+    if (m_orderDirty) RebuildOrder();
+    return m_orderIndices[handle.index];
+}
+
+void WidgetTree::RebuildOrder() const {
+    m_order.clear();
+    m_order.reserve(m_size);
+    m_orderIndices.assign(m_widgets.size(), NONE);
+
+    // Walk the sibling links depth first; a node's subtree ends when the
+    // walk climbs back past it
+    uint32_t depth = 0;
+    uint32_t node = m_firstRoot;
+    while (node != NONE) {
+        m_orderIndices[node] = (uint32_t)m_order.size();
+        m_order.push_back({ m_widgets[node], 0, depth });
+
+        if (m_firstChildren[node] != NONE) {
+            node = m_firstChildren[node];
+            depth++;
+            continue;
+        }
+        for (;;) {
+            m_order[m_orderIndices[node]].subtreeEnd = (uint32_t)m_order.size();
+            if (m_nextSiblings[node] != NONE) {
+                node = m_nextSiblings[node];
+                break;
+            }
+            node = m_parents[node];
+            if (node == NONE) break;
+            depth--;
+        }
+    }
+    m_orderDirty = false;
+}
+
+} // namespace SDK
@@ -1,15 +1,37 @@
 #include "../../include/SDK/Window.h"
 #include "../../include/SDK/Widget.h"
+#include "../../include/SDK/OptimizedWidgetRenderer.h"
 #include "../../include/SDK/Renderer.h"
 #include "../../include/SDK/DPIManager.h"
 #include "../../include/SDK/MonitorManager.h"
+#include "../../include/SDK/Profiler.h"
+#include "../../include/SDK/GdiObjectCache.h"
+#include "../../include/SDK/FrameArena.h"
+#include "../../include/SDK/EventQueue.h"
+#include "../../include/SDK/AcceleratorTable.h"
+#include "../../include/SDK/MemoryRegistry.h"
+#include "../../include/SDK/HeadlessRenderBackend.h"
 #include <dwmapi.h>
 #include <algorithm>
+#include <chrono>
 
 #pragma comment(lib, "dwmapi.lib")
 
 namespace SDK {
 
+namespace {
+    constexpr int MAX_MOVE_POINTS = 64;     // GetMouseMovePointsEx's history
+    
+    // Adds the time until it goes out of scope to renderTime, on every way out
+    struct RenderTimer {
+        Window::FrameStats& stats;
+        std::chrono::steady_clock::time_point start;
+        ~RenderTimer() {
+            stats.renderTime += std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+        }
+    };
+}
+
 Window::Window(HWND hwnd)
     : m_hwnd(hwnd)
     , m_depth(WindowDepth::FOREGROUND)
@@ -23,9 +45,23 @@ Window::Window(HWND hwnd)
     , m_shadowIntensity(1.0f)
     , m_theme(nullptr)
     , m_renderCallback(nullptr)
+    , m_renderCallbackThreadSafe(false)
+    , m_coalesceMouseMoves(true)
+    , m_lastMoveTime(0)
     , m_currentMonitor(nullptr)
     , m_deferUpdates(false)
     , m_needsUpdate(false)
+    , m_partialRedraw(true)
+    , m_frameScheduled(false)
+    , m_framePending(true)
+    , m_updateScheduling(false)
+    , m_visibility(WindowVisibility::VISIBLE)
+    , m_throttleInterval(0.25f)
+    , m_backgroundPending(0.0f)
+    , m_liveResizeMode(LiveResizeMode::STRETCH)
+    , m_liveResizeInterval(0.1f)
+    , m_liveResizing(false)
+    , m_resizeFrame(-1)
 {
     // Initialize DPI info
     m_currentDPI = DPIManager::GetInstance().GetDPIForWindow(hwnd);
@@ -35,7 +71,11 @@ Window::Window(HWND hwnd)
 }
 
 Window::~Window() {
-    // Cleanup
+    // Widgets may outlive the window; detach their invalidate handlers
+    for (auto& widget : m_widgets) {
+        widget->SetInvalidateHandler(nullptr);
+        widget->DetachFromTree();
+    }
 }
 
 void Window::SetDepth(WindowDepth depth) {
@@ -66,9 +106,20 @@ void Window::GetDepthOffset(int& x, int& y) const {
 
 void Window::SetTheme(std::shared_ptr<Theme> theme) {
     m_theme = theme;
+    m_themeMetrics.reset();
     UpdateAppearance();
 }
 
+const ThemeMetrics* Window::GetThemeMetrics() {
+    if (!m_theme) return nullptr;
+    
+    // The theme may have been edited since; checking is a few compares
+    if (!m_themeMetrics || !m_themeMetrics->Matches(*m_theme, m_currentDPI.dpi)) {
+        m_themeMetrics = DPIManager::GetInstance().GetThemeMetrics(*m_theme, m_currentDPI.dpi);
+    }
+    return m_themeMetrics.get();
+}
+
 void Window::SetRoundedCorners(bool enabled, int radius) {
     m_roundedCorners = enabled;
     m_cornerRadius = radius;
@@ -94,6 +145,17 @@ void Window::UpdateAppearance() {
         return;
     }
     
+    // Appearance changes affect the whole window
+    if (m_renderCache) {
+        m_renderCache->MarkAllDirty();
+    }
+    if (m_optimizedRenderer) {
+        m_optimizedRenderer->InvalidateAll();
+    }
+    
+    m_framePending = true;
+    if (m_frameScheduled) return;
+    
     // Use FALSE to avoid erasing background, which causes flickering
     // The WM_PAINT handler should clear the background as needed
     InvalidateRect(m_hwnd, nullptr, FALSE);
@@ -125,24 +187,289 @@ void Window::EnableLayeredMode() {
     UpdateLayeredWindow();
 }
 
-void Window::SetRenderCallback(std::function<void(HDC)> callback) {
+void Window::SetRenderCallback(std::function<void(HDC)> callback, bool threadSafe) {
     m_renderCallback = callback;
+    m_renderCallbackThreadSafe = threadSafe;
+    if (m_optimizedRenderer) {
+        m_optimizedRenderer->InvalidateAll();
+    }
+}
+
+void Window::SetRenderOptimizer(std::shared_ptr<RendererOptimizer> optimizer) {
+    if (optimizer) {
+        m_optimizedRenderer.reset(new OptimizedWidgetRenderer(optimizer));
+    } else {
+        m_optimizedRenderer.reset();
+    }
+    UpdateAppearance();
+}
+
+std::shared_ptr<RendererOptimizer> Window::GetRenderOptimizer() const {
+    return m_optimizedRenderer ? m_optimizedRenderer->GetOptimizer() : nullptr;
 }
 
 void Window::Render(HDC hdc) {
-    if (!IsValid()) return;
+    EventQueue::Dispatch();
+    RenderFrame(hdc, true);
+    GdiObjectCache::EndFrame();
+    FrameArena::EndFrame();
+}
+
+void Window::RenderPending(HDC hdc) {
+    RenderFrame(hdc, false);
+}
+
+void Window::RenderFrame(HDC hdc, bool includeClipBox) {
+    SDK_PROFILE_ZONE("Window::Render");
+    if (BeginFrame(hdc, includeClipBox)) {
+        DrawFrame();
+        PresentFrame(hdc);
+    }
+}
+
+bool Window::RenderSnapshot(HeadlessRenderBackend& backend) {
+    if (!IsValid()) return false;
     
     RECT rect;
     GetClientRect(m_hwnd, &rect);
+    if (rect.right <= rect.left || rect.bottom <= rect.top) return false;
+    
+    backend.Resize(rect.right - rect.left, rect.bottom - rect.top);
+    HDC hdc = backend.BeginGDIInterop();
+    if (!hdc) return false;
+    
+    // The frame statistics describe on-screen frames; a snapshot leaves them be
+    FrameStats stats = m_frameStats;
+    RenderContent(hdc, rect, std::vector<RECT>(1, rect));
+    m_frameStats = stats;
+    
+    backend.EndGDIInterop(hdc);
+    return true;
+}
+
+bool Window::BeginFrame(HDC hdc, bool includeClipBox) {
+    if (!IsValid()) return false;
+    m_framePending = false;
+    m_frameRegions.clear();
+    
+    RECT rect;
+    GetClientRect(m_hwnd, &rect);
+    int width = rect.right - rect.left;
+    int height = rect.bottom - rect.top;
+    if (width <= 0 || height <= 0) return false;
+    
+    m_frameStats = FrameStats();
+    RenderTimer renderTimer{m_frameStats, std::chrono::steady_clock::now()};
+    m_frameRect = rect;
+    
+    // Resolved here, so a DrawFrame() on another thread never reaches DPIManager
+    GetThemeMetrics();
     
+    // Mid-drag, a resized window shows its last frame until a full one is due
+    int resizeFrame = m_resizeFrame;
+    m_resizeFrame = -1;
+    if (m_liveResizing && m_renderCache &&
+        (m_renderCache->GetWidth() != width || m_renderCache->GetHeight() != height)) {
+        bool full = resizeFrame >= 0 ? resizeFrame != 0 : TakeResizeFrame();
+        m_resizeFrame = -1;    // The answer was for this frame only
+        if (!full) {
+            RenderResizePreview(hdc, rect);
+            m_frameStats.resizePreview = true;
+            m_framePending = true;
+            return false;
+        }
+    }
+    
+    // (Re)create the back buffer on first paint and resize
+    if (!m_renderCache || m_renderCache->GetWidth() != width || m_renderCache->GetHeight() != height) {
+        m_renderCache.reset(new Renderer::RenderCache(width, height));
+        if (!m_renderCache->GetCacheDC()) {
+            m_renderCache.reset();
+        } else {
+            m_renderCache->MarkAllDirty();
+        }
+        
+        // The background under the widgets changes with the size
+        if (m_optimizedRenderer) {
+            m_optimizedRenderer->InvalidateAll();
+        }
+    }
+    
+    if (!m_renderCache || !m_partialRedraw) {
+        // Direct full repaint
+        std::vector<RECT> regions(1, rect);
+        RenderContent(hdc, rect, regions);
+        m_frameStats.fullRedraw = true;
+        m_frameStats.dirtyRects = 1;
+        m_frameStats.repaintedPixels = (long long)width * height;
+        if (m_renderCache) m_renderCache->MarkClean();
+        return false;
+    }
+    
+    // Anything the system asks to repaint beyond our own invalidations (uncovered
+    // areas, InvalidateRect from the application) is redrawn as well
+    if (includeClipBox) {
+        RECT clipBox;
+        int clipType = GetClipBox(hdc, &clipBox);
+        if (clipType == NULLREGION) return false;
+        if (clipType == ERROR) clipBox = rect;
+        
+        RECT dirtyBounds;
+        bool coveredByDirty = m_renderCache->GetDirtyBounds(dirtyBounds) &&
+            clipBox.left >= dirtyBounds.left && clipBox.top >= dirtyBounds.top &&
+            clipBox.right <= dirtyBounds.right && clipBox.bottom <= dirtyBounds.bottom;
+        if (!coveredByDirty) {
+            m_renderCache->MarkDirty(clipBox);
+        }
+    }
+    m_renderCache->MergeDirtyRegions();
+    
+    for (const auto& dr : m_renderCache->GetDirtyRegions()) {
+        m_frameRegions.push_back(dr.rect);
+    }
+    return !m_frameRegions.empty();
+}
+
+void Window::DrawFrame() {
+    if (!m_renderCache || m_frameRegions.empty()) return;
+    SDK_PROFILE_ZONE("Window::DrawFrame");
+    RenderTimer renderTimer{m_frameStats, std::chrono::steady_clock::now()};
+    
+    // Clip the back buffer to the dirty regions and redraw only there
+    HDC cacheDC = m_renderCache->GetCacheDC();
+    HRGN clipRegion = CreateRectRgn(0, 0, 0, 0);
+    for (const auto& region : m_frameRegions) {
+        HRGN part = CreateRectRgnIndirect(&region);
+        CombineRgn(clipRegion, clipRegion, part, RGN_OR);
+        DeleteObject(part);
+    }
+    SelectClipRgn(cacheDC, clipRegion);
+    
+    RenderContent(cacheDC, m_frameRect, m_frameRegions);
+    
+    SelectClipRgn(cacheDC, nullptr);
+    DeleteObject(clipRegion);
+    
+    // GDI batches calls per thread; finish them before another thread presents
+    GdiFlush();
+}
+
+void Window::PresentFrame(HDC hdc) {
+    if (!m_renderCache || m_frameRegions.empty()) return;
+    RenderTimer renderTimer{m_frameStats, std::chrono::steady_clock::now()};
+    
+    for (const auto& region : m_frameRegions) {
+        m_renderCache->CopyToTarget(hdc, region, region.left, region.top);
+    }
+    
+    long long area = (long long)(m_frameRect.right - m_frameRect.left) * (m_frameRect.bottom - m_frameRect.top);
+    m_frameStats.dirtyRects = (int)m_frameRegions.size();
+    m_frameStats.repaintedPixels = m_renderCache->GetDirtyPixelCount();
+    m_frameStats.fullRedraw = m_frameStats.repaintedPixels >= area;
+    m_renderCache->MarkClean();
+    m_frameRegions.clear();
+}
+
+void Window::BeginLiveResize() {
+    m_liveResizing = true;
+    m_resizeFrame = -1;
+    m_resizeRenderTime = std::chrono::steady_clock::now();
+}
+
+void Window::EndLiveResize() {
+    if (!m_liveResizing) return;
+    m_liveResizing = false;
+    m_resizeFrame = -1;
+    if (IsValid()) {
+        RECT rect;
+        GetClientRect(m_hwnd, &rect);
+        InvalidateRegion(rect);
+    }
+}
+
+bool Window::TakeResizeFrame() {
+    if (!m_liveResizing || m_liveResizeMode == LiveResizeMode::OFF || !m_renderCache) return true;
+    
+    auto now = std::chrono::steady_clock::now();
+    bool full = m_liveResizeInterval > 0.0f &&
+        std::chrono::duration<float>(now - m_resizeRenderTime).count() >= m_liveResizeInterval;
+    if (full) m_resizeRenderTime = now;
+    m_resizeFrame = full ? 1 : 0;
+    return full;
+}
+
+void Window::RenderResizePreview(HDC hdc, const RECT& rect) {
+    HDC cacheDC = m_renderCache->GetCacheDC();
+    int width = rect.right - rect.left;
+    int height = rect.bottom - rect.top;
+    int cacheWidth = m_renderCache->GetWidth();
+    int cacheHeight = m_renderCache->GetHeight();
+    
+    if (m_liveResizeMode == LiveResizeMode::STRETCH) {
+        int oldMode = SetStretchBltMode(hdc, COLORONCOLOR);
+        StretchBlt(hdc, 0, 0, width, height, cacheDC, 0, 0, cacheWidth, cacheHeight, SRCCOPY);
+        SetStretchBltMode(hdc, oldMode);
+        return;
+    }
+    
+    // Crop: the old frame at its own size, background where the window grew
+    int copyWidth = std::min(width, cacheWidth);
+    int copyHeight = std::min(height, cacheHeight);
+    BitBlt(hdc, 0, 0, copyWidth, copyHeight, cacheDC, 0, 0, SRCCOPY);
+    
+    Color bgColor = m_theme ? m_theme->GetBackgroundColor() : Color(255, 255, 255, 255);
+    HBRUSH bgBrush = GdiObjectCache::GetBrush(bgColor.ToCOLORREF());
+    if (copyWidth < width) {
+        RECT right = { copyWidth, 0, width, height };
+        FillRect(hdc, &right, bgBrush);
+    }
+    if (copyHeight < height) {
+        RECT bottom = { 0, copyHeight, copyWidth, height };
+        FillRect(hdc, &bottom, bgBrush);
+    }
+}
+
+bool Window::CanRenderOffscreen() const {
+    if (!IsValid() || !m_partialRedraw || m_optimizedRenderer) return false;
+    if (m_renderCallback && !m_renderCallbackThreadSafe) return false;
+    for (const auto& widget : m_widgets) {
+        if (!widget->IsTreeRenderThreadSafe()) return false;
+    }
+    return true;
+}
+
+void Window::InvalidateRegion(const RECT& rect) {
+    if (!IsValid()) return;
+    
+    if (m_renderCache) {
+        m_renderCache->MarkDirty(rect);
+    }
+    if (m_optimizedRenderer) {
+        m_optimizedRenderer->Invalidate(rect);
+    }
+    m_framePending = true;
+    
+    if (m_deferUpdates) {
+        m_needsUpdate = true;
+        return;
+    }
+    
+    if (m_frameScheduled) return;
+    InvalidateRect(m_hwnd, &rect, FALSE);
+}
+
+void Window::RenderContent(HDC hdc, const RECT& rect, const std::vector<RECT>& regions) {
     // Determine background color
     Color bgColor = m_theme ? m_theme->GetBackgroundColor() : Color(255, 255, 255, 255);
     
+    // Theme metrics come pre-scaled to the window's DPI
+    const ThemeMetrics* metrics = GetThemeMetrics();
+    
     // Render shadow if enabled (before background to avoid overlap)
-    if (m_shadowEnabled && m_theme) {
-        int shadowOffsetX, shadowOffsetY;
-        m_theme->GetShadowOffset(shadowOffsetX, shadowOffsetY);
-        int shadowBlur = m_theme->GetShadowBlur();
+    if (m_shadowEnabled && metrics) {
+        int shadowOffsetX = metrics->shadowOffsetX;
+        int shadowOffsetY = metrics->shadowOffsetY;
+        int shadowBlur = metrics->shadowBlur;
         
         // Scale shadow based on depth
         float depthScale = 1.0f;
@@ -159,7 +486,8 @@ void Window::Render(HDC hdc) {
         shadowBlur = (int)(shadowBlur * depthScale * m_shadowIntensity);
         
         Color shadowColor = m_theme->GetShadowColor();
-        Renderer::DrawShadow(hdc, rect, shadowOffsetX, shadowOffsetY, shadowBlur, shadowColor);
+        Renderer::DrawShadow(hdc, rect, shadowOffsetX, shadowOffsetY, shadowBlur, shadowColor,
+                             m_roundedCorners ? m_cornerRadius : 0);
     }
     
     // Render themed background (handles clearing and decorations)
@@ -167,18 +495,17 @@ void Window::Render(HDC hdc) {
         if (m_roundedCorners) {
             // DrawRoundedRect will fill the background
             Color borderColor = m_theme->GetBorderColor();
-            int borderWidth = m_theme->GetBorderWidth();
+            int borderWidth = metrics->borderWidth;
             Renderer::DrawRoundedRect(hdc, rect, m_cornerRadius, bgColor, borderColor, borderWidth);
         } else {
             // Clear background with solid color
-            HBRUSH bgBrush = CreateSolidBrush(bgColor.ToCOLORREF());
+            HBRUSH bgBrush = GdiObjectCache::GetBrush(bgColor.ToCOLORREF());
             FillRect(hdc, &rect, bgBrush);
-            DeleteObject(bgBrush);
         }
         
         // Render title bar with gradient
         RECT titleRect = rect;
-        titleRect.bottom = titleRect.top + m_theme->GetTitleBarHeight();
+        titleRect.bottom = titleRect.top + metrics->titleBarHeight;
         Gradient titleGradient = m_theme->GetTitleBarGradient();
         Renderer::DrawGradient(hdc, titleRect, titleGradient);
     } else {
@@ -192,10 +519,119 @@ void Window::Render(HDC hdc) {
         m_renderCallback(hdc);
     }
     
-    // Render widgets
-    for (auto& widget : m_widgets) {
-        widget->Render(hdc);
+    // Animated widgets are blended from their layers
+    if (!m_compositor) {
+        m_compositor.reset(new LayerCompositor());
     }
+    
+    if (m_optimizedRenderer) {
+        OptimizedWidgetRenderer::Stats stats;
+        m_optimizedRenderer->Render(hdc, m_widgets, regions, rect, stats, m_compositor.get());
+        m_frameStats.widgetsRendered += stats.rendered;
+        m_frameStats.widgetsSkipped += stats.skipped;
+        m_frameStats.widgetsCached += stats.cached;
+        m_frameStats.widgetsSimplified += stats.simplified;
+        m_frameStats.widgetsOccluded += stats.occluded;
+        m_frameStats.layersComposited += stats.layers.composited;
+        m_frameStats.layersRasterized += stats.layers.rasterized;
+        return;
+    }
+    
+    // Render only widgets that intersect a dirty region and aren't covered
+    // by opaque widgets drawn after them
+    Widget::CullOccluded(m_widgets, m_hiddenWidgets);
+    LayerCompositor::Stats layerStats;
+    for (size_t i = 0; i < m_widgets.size(); i++) {
+        auto& widget = m_widgets[i];
+        RECT bounds;
+        widget->GetCompositeBounds(bounds);
+        bool dirty = false;
+        for (const auto& region : regions) {
+            if (Renderer::RectsIntersect(bounds, region)) {
+                dirty = true;
+                break;
+            }
+        }
+        
+        if (!dirty) {
+            m_frameStats.widgetsSkipped++;
+        } else if (m_hiddenWidgets[i]) {
+            m_frameStats.widgetsOccluded++;
+        } else if (!m_compositor->Composite(hdc, *widget, layerStats)) {
+            SDK_PROFILE_ZONE("Widget::Render");
+            widget->Render(hdc);
+            m_frameStats.widgetsRendered++;
+        }
+    }
+    m_frameStats.layersComposited += layerStats.composited;
+    m_frameStats.layersRasterized += layerStats.rasterized;
+}
+
+WindowVisibility Window::QueryVisibility(bool occluded) const {
+    if (!IsValid() || !IsWindowVisible(m_hwnd)) return WindowVisibility::HIDDEN;
+    if (IsIconic(m_hwnd)) return WindowVisibility::MINIMIZED;
+    
+    DWORD cloaked = 0;
+    if (SUCCEEDED(DwmGetWindowAttribute(m_hwnd, DWMWA_CLOAKED, &cloaked, sizeof(cloaked))) && cloaked) {
+        return WindowVisibility::CLOAKED;
+    }
+    
+    // Child windows go with their top-level window
+    RECT rect;
+    if (!(GetWindowLong(m_hwnd, GWL_STYLE) & WS_CHILD) && GetWindowRect(m_hwnd, &rect) &&
+        !MonitorFromRect(&rect, MONITOR_DEFAULTTONULL)) {
+        return WindowVisibility::OFF_SCREEN;
+    }
+    return occluded ? WindowVisibility::OCCLUDED : WindowVisibility::VISIBLE;
+}
+
+bool Window::AccumulateBackgroundTime(float deltaTime, float& pending) const {
+    pending += deltaTime;
+    switch (m_visibility) {
+        case WindowVisibility::VISIBLE: return true;
+        case WindowVisibility::OCCLUDED: return pending >= m_throttleInterval;
+        default: return false;
+    }
+}
+
+bool Window::TakeBackgroundTick(float deltaTime) {
+    if (!AccumulateBackgroundTime(deltaTime, m_backgroundPending)) return false;
+    m_backgroundPending = 0.0f;
+    return true;
+}
+
+bool Window::GetClientScreenRect(RECT& rect) const {
+    if (!IsValid() || !IsWindowVisible(m_hwnd) || IsIconic(m_hwnd)) return false;
+    
+    // A cloaked window covers nothing
+    DWORD cloaked = 0;
+    if (SUCCEEDED(DwmGetWindowAttribute(m_hwnd, DWMWA_CLOAKED, &cloaked, sizeof(cloaked))) && cloaked) {
+        return false;
+    }
+    
+    GetClientRect(m_hwnd, &rect);
+    MapWindowPoints(m_hwnd, nullptr, reinterpret_cast<POINT*>(&rect), 2);
+    return rect.right > rect.left && rect.bottom > rect.top;
+}
+
+bool Window::GetOpaqueScreenRect(RECT& rect) const {
+    if (m_alpha < 255 || !GetClientScreenRect(rect)) return false;
+    
+    // Layered windows are opaque only with a plain alpha of 255; per-pixel
+    // (UpdateLayeredWindow) and color-keyed ones may show what is beneath
+    if (GetWindowLong(m_hwnd, GWL_EXSTYLE) & WS_EX_LAYERED) {
+        BYTE alpha = 0;
+        DWORD flags = 0;
+        if (!GetLayeredWindowAttributes(m_hwnd, nullptr, &alpha, &flags)) return false;
+        if ((flags & LWA_COLORKEY) || ((flags & LWA_ALPHA) && alpha < 255)) return false;
+    }
+    
+    // Stay clear of the rounded corners, inset by r(1 - 1/sqrt(2))
+    if (m_roundedCorners) {
+        int inset = (m_cornerRadius * 3 + 9) / 10;
+        InflateRect(&rect, -inset, -inset);
+    }
+    return rect.right > rect.left && rect.bottom > rect.top;
 }
 
 void Window::ApplyDepthSettings() {
@@ -252,24 +688,116 @@ void Window::UpdateLayeredWindow() {
 
 // Widget management
 void Window::AddWidget(std::shared_ptr<Widget> widget) {
+    if (!widget) return;
+    
+    widget->SetInvalidateHandler([this](const RECT& rect) { InvalidateRegion(rect); });
     m_widgets.push_back(widget);
+    m_widgetIndex.Insert(widget);
+    widget->AttachToTree(&m_widgetTree);
+    widget->Invalidate();
 }
 
 void Window::RemoveWidget(std::shared_ptr<Widget> widget) {
     auto it = std::find(m_widgets.begin(), m_widgets.end(), widget);
     if (it != m_widgets.end()) {
+        (*it)->Invalidate();
+        (*it)->SetInvalidateHandler(nullptr);
+        m_widgetIndex.Remove(it->get());
+        m_widgetsUnderMouse.erase(std::remove(m_widgetsUnderMouse.begin(), m_widgetsUnderMouse.end(), widget),
+                                  m_widgetsUnderMouse.end());
+        if (m_capturedWidget == widget) m_capturedWidget = nullptr;
+        if (m_activeWidget == widget) m_activeWidget = nullptr;
+        if (m_optimizedRenderer) m_optimizedRenderer->RemoveWidget(widget.get());
+        if (m_compositor) m_compositor->RemoveWidget(widget.get());
+        widget->DetachFromTree();
         m_widgets.erase(it);
     }
 }
 
 void Window::ClearWidgets() {
+    for (auto& widget : m_widgets) {
+        widget->SetInvalidateHandler(nullptr);
+        widget->DetachFromTree();
+    }
     m_widgets.clear();
+    m_widgetIndex.Clear();
+    m_widgetsUnderMouse.clear();
+    m_capturedWidget = nullptr;
+    m_activeWidget = nullptr;
+    if (m_optimizedRenderer) m_optimizedRenderer->Clear();
+    if (m_compositor) m_compositor->Clear();
+    UpdateAppearance();
 }
 
 // Widget input handling
+void Window::CollectMovePoints(int x, int y) {
+    m_moveSamples.clear();
+    DWORD time = (DWORD)GetMessageTime();
+    
+    // The system keeps the last 64 positions in screen coordinates, newest
+    // first; the first is the current one
+    POINT screen = { x, y };
+    if (m_lastMoveTime != 0 && ClientToScreen(m_hwnd, &screen)) {
+        MOUSEMOVEPOINT current = {};
+        current.x = screen.x & 0xFFFF;
+        current.y = screen.y & 0xFFFF;
+        current.time = time;
+        MOUSEMOVEPOINT points[MAX_MOVE_POINTS];
+        int count = GetMouseMovePointsEx(sizeof(MOUSEMOVEPOINT), &current, points, MAX_MOVE_POINTS, GMMP_USE_DISPLAY_POINTS);
+        
+        int offsetX = screen.x - x;
+        int offsetY = screen.y - y;
+        for (int i = count - 1; i >= 1; i--) {
+            if (!PointerHistory::IsLater((uint32_t)points[i].time, m_lastMoveTime)) continue;
+            // Display points left of or above the primary monitor wrap
+            int pointX = points[i].x > 32767 ? points[i].x - 65536 : points[i].x;
+            int pointY = points[i].y > 32767 ? points[i].y - 65536 : points[i].y;
+            m_moveSamples.push_back({ pointX - offsetX, pointY - offsetY, (uint32_t)points[i].time });
+        }
+    }
+    
+    m_moveSamples.push_back({ x, y, (uint32_t)time });
+    for (const PointerSample& sample : m_moveSamples) {
+        m_pointerHistory.Add(sample);
+    }
+    m_lastMoveTime = (uint32_t)time;
+}
+
 bool Window::HandleWidgetMouseMove(int x, int y) {
+    InputTrace::Record(this, InputEvent::Type::MOUSE_MOVE, x, y);
+    if (m_coalesceMouseMoves && m_hwnd) {
+        // A newer position is already waiting; this one would be stale on
+        // arrival, and the newer move collects the path through it
+        MSG pending;
+        if (PeekMessage(&pending, m_hwnd, WM_MOUSEMOVE, WM_MOUSEMOVE, PM_NOREMOVE | PM_NOYIELD)) {
+            return false;
+        }
+    }
+    CollectMovePoints(x, y);
+    PointerHistory::CoalescedScope coalesced(m_moveSamples);
+    return DispatchMouseMove(x, y);
+}
+
+bool Window::DispatchMouseMove(int x, int y) {
+    std::vector<std::shared_ptr<Widget>> candidates;
+    m_widgetIndex.QueryPoint(x, y, candidates);
+
+    // The captured widget keeps tracking drags outside its bounds and widgets
+    // the cursor just left still need the move to drop their hover state
+    std::vector<std::shared_ptr<Widget>> targets;
+    targets.reserve(candidates.size() + m_widgetsUnderMouse.size() + 1);
+    if (m_capturedWidget) targets.push_back(m_capturedWidget);
+    for (const auto* list : { &candidates, &m_widgetsUnderMouse }) {
+        for (const auto& widget : *list) {
+            if (std::find(targets.begin(), targets.end(), widget) == targets.end()) {
+                targets.push_back(widget);
+            }
+        }
+    }
+    m_widgetsUnderMouse = std::move(candidates);
+
     bool handled = false;
-    for (auto& widget : m_widgets) {
+    for (auto& widget : targets) {
         if (widget->HandleMouseMove(x, y)) {
             handled = true;
         }
@@ -278,8 +806,30 @@ bool Window::HandleWidgetMouseMove(int x, int y) {
 }
 
 bool Window::HandleWidgetMouseDown(int x, int y, int button) {
-    for (auto& widget : m_widgets) {
+    InputTrace::Record(this, InputEvent::Type::MOUSE_DOWN, x, y, button);
+    std::vector<std::shared_ptr<Widget>> candidates;
+    m_widgetIndex.QueryPoint(x, y, candidates);
+
+    // The previously pressed widget sees the click first so it can react to
+    // clicks outside itself, e.g. a ComboBox closing its dropdown
+    std::shared_ptr<Widget> previous = std::move(m_activeWidget);
+    m_activeWidget = nullptr;
+    if (previous && std::find(candidates.begin(), candidates.end(), previous) == candidates.end()) {
+        if (previous->HandleMouseDown(x, y, button)) {
+            m_capturedWidget = m_activeWidget = previous;
+            return true;
+        }
+    }
+
+    for (auto& widget : candidates) {
         if (widget->HandleMouseDown(x, y, button)) {
+            m_capturedWidget = m_activeWidget = widget;
+            // Keys go to focused widgets only, so a click that focused one takes focus from the rest
+            if (widget->IsFocused()) {
+                for (auto& other : m_widgets) {
+                    if (other != widget && other->IsFocused()) other->SetFocused(false);
+                }
+            }
             return true;
         }
     }
@@ -287,8 +837,29 @@ bool Window::HandleWidgetMouseDown(int x, int y, int button) {
 }
 
 bool Window::HandleWidgetMouseUp(int x, int y, int button) {
-    for (auto& widget : m_widgets) {
-        if (widget->HandleMouseUp(x, y, button)) {
+    InputTrace::Record(this, InputEvent::Type::MOUSE_UP, x, y, button);
+    std::shared_ptr<Widget> captured = std::move(m_capturedWidget);
+    m_capturedWidget = nullptr;
+    if (captured && captured->HandleMouseUp(x, y, button)) {
+        return true;
+    }
+
+    std::vector<std::shared_ptr<Widget>> candidates;
+    m_widgetIndex.QueryPoint(x, y, candidates);
+    for (auto& widget : candidates) {
+        if (widget != captured && widget->HandleMouseUp(x, y, button)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Window::HandleWidgetMouseWheel(int x, int y, int delta) {
+    InputTrace::Record(this, InputEvent::Type::MOUSE_WHEEL, x, y, delta);
+    std::vector<std::shared_ptr<Widget>> candidates;
+    m_widgetIndex.QueryPoint(x, y, candidates);
+    for (auto& widget : candidates) {
+        if (widget->HandleMouseWheel(x, y, delta)) {
             return true;
         }
     }
@@ -296,6 +867,10 @@ bool Window::HandleWidgetMouseUp(int x, int y, int button) {
 }
 
 bool Window::HandleWidgetKeyDown(int keyCode) {
+    InputTrace::Record(this, InputEvent::Type::KEY_DOWN, 0, 0, keyCode);
+    if (m_accelerators && m_accelerators->Dispatch(keyCode)) {
+        return true;
+    }
     for (auto& widget : m_widgets) {
         if (widget->HandleKeyDown(keyCode)) {
             return true;
@@ -305,6 +880,7 @@ bool Window::HandleWidgetKeyDown(int keyCode) {
 }
 
 bool Window::HandleWidgetKeyUp(int keyCode) {
+    InputTrace::Record(this, InputEvent::Type::KEY_UP, 0, 0, keyCode);
     for (auto& widget : m_widgets) {
         if (widget->HandleKeyUp(keyCode)) {
             return true;
@@ -314,6 +890,7 @@ bool Window::HandleWidgetKeyUp(int keyCode) {
 }
 
 bool Window::HandleWidgetChar(wchar_t ch) {
+    InputTrace::Record(this, InputEvent::Type::CHAR, 0, 0, (int)ch);
     for (auto& widget : m_widgets) {
         if (widget->HandleChar(ch)) {
             return true;
@@ -322,12 +899,92 @@ bool Window::HandleWidgetChar(wchar_t ch) {
     return false;
 }
 
+void Window::ReplayEvent(const InputEvent& event) {
+    if (event.type != InputEvent::Type::MOUSE_MOVE) {
+        FlushReplayedMoves();
+    }
+    switch (event.type) {
+        case InputEvent::Type::MOUSE_MOVE: {
+            InputTrace::Record(this, InputEvent::Type::MOUSE_MOVE, event.x, event.y);
+            PointerSample sample = { event.x, event.y, event.time };
+            m_pointerHistory.Add(sample);
+            m_replayedMoves.push_back(sample);
+            if (!m_coalesceMouseMoves) FlushReplayedMoves();
+            break;
+        }
+        case InputEvent::Type::MOUSE_DOWN:
+            HandleWidgetMouseDown(event.x, event.y, event.value);
+            break;
+        case InputEvent::Type::MOUSE_UP:
+            HandleWidgetMouseUp(event.x, event.y, event.value);
+            break;
+        case InputEvent::Type::MOUSE_WHEEL:
+            HandleWidgetMouseWheel(event.x, event.y, event.value);
+            break;
+        case InputEvent::Type::KEY_DOWN:
+            HandleWidgetKeyDown(event.value);
+            break;
+        case InputEvent::Type::KEY_UP:
+            HandleWidgetKeyUp(event.value);
+            break;
+        case InputEvent::Type::CHAR:
+            HandleWidgetChar((wchar_t)event.value);
+            break;
+        default:
+            // Resizes and closes come from X11 traces; a replay doesn't reshape the window
+            break;
+    }
+}
+
+void Window::ReplayFrame() {
+    FlushReplayedMoves();
+}
+
+void Window::FlushReplayedMoves() {
+    if (m_replayedMoves.empty()) return;
+    
+    m_moveSamples.swap(m_replayedMoves);
+    m_replayedMoves.clear();
+    PointerHistory::CoalescedScope coalesced(m_moveSamples);
+    DispatchMouseMove(m_moveSamples.back().x, m_moveSamples.back().y);
+}
+
 void Window::UpdateWidgets(float deltaTime) {
-    for (auto& widget : m_widgets) {
-        widget->Update(deltaTime);
+    if (!m_updateScheduling) {
+        for (auto& widget : m_widgets) {
+            widget->Update(deltaTime);
+        }
+        return;
+    }
+    
+    // Popped one at a time, so an update may remove widgets still due
+    m_updateScheduler.CollectDue(UpdateScheduler::Clock::now());
+    float widgetDelta;
+    while (Widget* widget = m_updateScheduler.PopDue(widgetDelta)) {
+        widget->Update(widgetDelta);
+    }
+}
+
+void Window::SetUpdateSchedulingEnabled(bool enabled) {
+    if (m_updateScheduling == enabled) return;
+    m_updateScheduling = enabled;
+    
+    if (!enabled) {
+        m_widgetTree.SetUpdateScheduler(nullptr);
+        m_updateScheduler.Clear();
+        return;
+    }
+    m_widgetTree.SetUpdateScheduler(&m_updateScheduler);
+    for (const auto& entry : m_widgetTree.GetOrder()) {
+        m_updateScheduler.Register(entry.widget);
     }
 }
 
+float Window::GetTimeUntilNextUpdate() const {
+    if (!m_updateScheduling) return -1.0f;
+    return m_updateScheduler.GetTimeUntilNextWake(UpdateScheduler::Clock::now());
+}
+
 // DPI Support (v2.0)
 DPIScaleInfo Window::GetDPIScale() const {
     return m_currentDPI;
@@ -351,8 +1008,15 @@ void Window::HandleDPIChange(const DPIScaleInfo& oldDPI, const DPIScaleInfo& new
         height = static_cast<int>(height * scaleFactorY + 0.5f);
         
         widget->SetBounds(x, y, width, height);
+        
+        // Fonts follow the bounds; each DPI's fonts stay in FontCache
+        widget->SetDPI(MulDiv(widget->GetDPI(), newDPI.dpi, oldDPI.dpi));
     }
     
+    // Swap to the theme metrics cached for the new DPI
+    m_themeMetrics.reset();
+    GetThemeMetrics();
+    
     // Update corner radius with DPI scaling
     if (m_roundedCorners) {
         m_cornerRadius = DPIManager::GetInstance().ScaleValueX(12, newDPI);
@@ -394,4 +1058,8 @@ void Window::HandleMonitorChange(HMONITOR oldMonitor, HMONITOR newMonitor) {
     UpdateAppearance();
 }
 
+void Window::HandleLowMemory() {
+    MemoryRegistry::TrimAll();
+}
+
 } // namespace SDK
@@ -1,4 +1,6 @@
 #include "../../include/SDK/WindowAnimation.h"
+#include "../../include/SDK/DeferredWindowPos.h"
+#include <algorithm>
 #include <cmath>
 
 #ifndef M_PI
@@ -15,8 +17,15 @@ WindowAnimation::WindowAnimation(HWND hwnd)
     , m_state(AnimationState::IDLE)
     , m_duration(250)
     , m_easing(EasingType::EASE_OUT)
+    , m_paused(false)
+    , m_reversed(false)
+    , m_pausedDuration(0)
     , m_startAlpha(255)
     , m_targetAlpha(255)
+    , m_layerCompositing(true)
+    , m_layerActive(false)
+    , m_savedExStyle(0)
+    , m_layerAlpha(255)
 {
     m_startRect = {0};
     m_targetRect = {0};
@@ -26,12 +35,13 @@ WindowAnimation::~WindowAnimation() {
     StopAnimation();
 }
 
-float WindowAnimation::GetProgress() const {
-    auto now = std::chrono::steady_clock::now();
+float WindowAnimation::GetProgress(std::chrono::steady_clock::time_point now) const {
     auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
         now - m_startTime).count();
     
+    if (m_duration <= 0) return 1.0f;
     float progress = static_cast<float>(elapsed) / static_cast<float>(m_duration);
+    if (progress < 0.0f) return 0.0f;   // Started after the frame time
     return (progress > 1.0f) ? 1.0f : progress;
 }
 
@@ -49,22 +59,27 @@ float WindowAnimation::ApplyEasing(float t) const {
         case EasingType::EASE_IN_OUT:
             return (t < 0.5f) ? (2.0f * t * t) : (-1.0f + (4.0f - 2.0f * t) * t);
             
-        case EasingType::BOUNCE: {
+        case EasingType::BOUNCE:
             // Bounce out effect - simulates a ball bouncing with decreasing amplitude
-            if (t < (1.0f / 2.75f)) {
-                return 7.5625f * t * t;
-            } else if (t < (2.0f / 2.75f)) {
-                float t2 = t - (1.5f / 2.75f);
-                return 7.5625f * t2 * t2 + 0.75f;
-            } else if (t < (2.5f / 2.75f)) {
-                float t2 = t - (2.25f / 2.75f);
-                return 7.5625f * t2 * t2 + 0.9375f;
-            } else {
-                float t2 = t - (2.625f / 2.75f);
-                return 7.5625f * t2 * t2 + 0.984375f;
-            }
+            return Easing::Evaluate(Renderer::EasingType::EASE_OUT_BOUNCE, t);
+            
+        case EasingType::ELASTIC:
+            return Easing::Evaluate(Renderer::EasingType::EASE_OUT_ELASTIC, t);
+            
+        case EasingType::BACK: {
+            // Overshoots by about 10% before settling
+            const float overshoot = 1.70158f;
+            float u = t - 1.0f;
+            return 1.0f + (overshoot + 1.0f) * u * u * u + overshoot * u * u;
         }
         
+        case EasingType::CUBIC_BEZIER:
+            if (!m_bezierSolver) {
+                m_bezierSolver = Easing::GetCubicBezier(m_bezierCurve.x1, m_bezierCurve.y1,
+                                                        m_bezierCurve.x2, m_bezierCurve.y2);
+            }
+            return m_bezierSolver->Evaluate(t);
+        
         default:
             return t;
     }
@@ -73,6 +88,7 @@ float WindowAnimation::ApplyEasing(float t) const {
 void WindowAnimation::AnimateMinimize() {
     if (!m_hwnd || !IsWindow(m_hwnd)) return;
     
+    EndLayer();
     m_state = AnimationState::MINIMIZING;
     m_startTime = std::chrono::steady_clock::now();
     
@@ -100,6 +116,7 @@ void WindowAnimation::AnimateMinimize() {
 void WindowAnimation::AnimateMaximize() {
     if (!m_hwnd || !IsWindow(m_hwnd)) return;
     
+    EndLayer();
     m_state = AnimationState::MAXIMIZING;
     m_startTime = std::chrono::steady_clock::now();
     
@@ -126,6 +143,7 @@ void WindowAnimation::AnimateMaximize() {
 void WindowAnimation::AnimateRestore() {
     if (!m_hwnd || !IsWindow(m_hwnd)) return;
     
+    EndLayer();
     m_state = AnimationState::RESTORING;
     m_startTime = std::chrono::steady_clock::now();
     
@@ -162,6 +180,7 @@ void WindowAnimation::AnimateRestore() {
 }
 
 void WindowAnimation::StopAnimation() {
+    EndLayer();
     if (m_state == AnimationState::MINIMIZING) {
         ShowWindow(m_hwnd, SW_MINIMIZE);
         m_state = AnimationState::MINIMIZED;
@@ -176,11 +195,13 @@ void WindowAnimation::StopAnimation() {
     }
 }
 
-void WindowAnimation::PerformFadeAnimation(float progress) {
-    BYTE alpha = static_cast<BYTE>(
+BYTE WindowAnimation::GetAlpha(float progress) const {
+    return static_cast<BYTE>(
         m_startAlpha + (m_targetAlpha - m_startAlpha) * progress);
-    
-    SetLayeredWindowAttributes(m_hwnd, 0, alpha, LWA_ALPHA);
+}
+
+void WindowAnimation::PerformFadeAnimation(float progress) {
+    SetLayeredWindowAttributes(m_hwnd, 0, GetAlpha(progress), LWA_ALPHA);
 }
 
 void WindowAnimation::PerformSlideAnimation(float progress) {
@@ -192,7 +213,7 @@ void WindowAnimation::PerformSlideAnimation(float progress) {
     int width = m_startRect.right - m_startRect.left;
     int height = m_startRect.bottom - m_startRect.top;
     
-    SetWindowPos(m_hwnd, nullptr, left, top, width, height,
+    DeferredWindowPos::Move(m_hwnd, nullptr, left, top, width, height,
         SWP_NOZORDER | SWP_NOACTIVATE);
     
     PerformFadeAnimation(progress);
@@ -214,10 +235,7 @@ void WindowAnimation::PerformScaleAnimation(float progress) {
     int top = static_cast<int>(
         m_startRect.top + (m_targetRect.top - m_startRect.top) * progress);
     
-    SetWindowPos(m_hwnd, nullptr, left, top, width, height,
-        SWP_NOZORDER | SWP_NOACTIVATE);
-    
-    PerformFadeAnimation(progress);
+    MoveFrame(left, top, width, height, progress);
 }
 
 void WindowAnimation::PerformZoomAnimation(float progress) {
@@ -247,13 +265,114 @@ void WindowAnimation::PerformZoomAnimation(float progress) {
     int left = finalCenterX - width / 2;
     int top = finalCenterY - height / 2;
     
-    SetWindowPos(m_hwnd, nullptr, left, top, width, height,
+    MoveFrame(left, top, width, height, progress);
+}
+
+void WindowAnimation::MoveFrame(int left, int top, int width, int height, float progress) {
+    if (BeginLayer()) {
+        PresentLayer(left, top, width, height, GetAlpha(progress));
+        return;
+    }
+    
+    DeferredWindowPos::Move(m_hwnd, nullptr, left, top, width, height,
         SWP_NOZORDER | SWP_NOACTIVATE);
     
     PerformFadeAnimation(progress);
 }
 
+bool WindowAnimation::BeginLayer() {
+    if (m_layerActive) return true;
+    if (!m_layerCompositing || IsIconic(m_hwnd) || !IsWindowVisible(m_hwnd)) return false;
+    
+    RECT rect;
+    GetWindowRect(m_hwnd, &rect);
+    int width = rect.right - rect.left;
+    int height = rect.bottom - rect.top;
+    
+    // Frames range between the start and target sizes
+    int frameWidth = std::max({ width, (int)(m_startRect.right - m_startRect.left),
+                                (int)(m_targetRect.right - m_targetRect.left) });
+    int frameHeight = std::max({ height, (int)(m_startRect.bottom - m_startRect.top),
+                                 (int)(m_targetRect.bottom - m_targetRect.top) });
+    
+    m_layer.dc = Renderer::CreateDIBMemoryDC(width, height, &m_layer.bitmap, &m_layer.pixels, GdiSubsystem::ANIMATION);
+    m_frame.dc = Renderer::CreateDIBMemoryDC(frameWidth, frameHeight, &m_frame.bitmap, &m_frame.pixels, GdiSubsystem::ANIMATION);
+    if (!m_layer.dc || !m_frame.dc || !PrintWindow(m_hwnd, m_layer.dc, 0)) {
+        if (m_layer.dc) Renderer::DeleteMemoryDC(m_layer.dc, m_layer.bitmap, GdiSubsystem::ANIMATION);
+        if (m_frame.dc) Renderer::DeleteMemoryDC(m_frame.dc, m_frame.bitmap, GdiSubsystem::ANIMATION);
+        m_layer = Renderer::PixelSurface();
+        m_frame = Renderer::PixelSurface();
+        return false;
+    }
+    m_layer.width = width;
+    m_layer.height = height;
+    m_frame.width = frameWidth;
+    m_frame.height = frameHeight;
+    
+    // GDI leaves the alpha byte undefined; the captured window is opaque
+    GdiFlush();
+    size_t count = (size_t)width * height;
+    for (size_t i = 0; i < count; i++) {
+        m_layer.pixels[i] |= 0xFF000000u;
+    }
+    
+    // UpdateLayeredWindow fails on a window given SetLayeredWindowAttributes
+    // until WS_EX_LAYERED is set afresh
+    m_savedExStyle = GetWindowLong(m_hwnd, GWL_EXSTYLE);
+    if (m_savedExStyle & WS_EX_LAYERED) {
+        SetWindowLong(m_hwnd, GWL_EXSTYLE, m_savedExStyle & ~WS_EX_LAYERED);
+    }
+    SetWindowLong(m_hwnd, GWL_EXSTYLE, m_savedExStyle | WS_EX_LAYERED);
+    m_layerActive = true;
+    return true;
+}
+
+void WindowAnimation::PresentLayer(int left, int top, int width, int height, BYTE alpha) {
+    width = std::min(std::max(width, 1), m_frame.width);
+    height = std::min(std::max(height, 1), m_frame.height);
+    
+    // The capture is opaque, so blending it replaces the frame outright
+    BLENDFUNCTION copy;
+    copy.BlendOp = AC_SRC_OVER;
+    copy.BlendFlags = 0;
+    copy.SourceConstantAlpha = 255;
+    copy.AlphaFormat = AC_SRC_ALPHA;
+    AlphaBlend(m_frame.dc, 0, 0, width, height, m_layer.dc, 0, 0, m_layer.width, m_layer.height, copy);
+    
+    BLENDFUNCTION blend = copy;
+    blend.SourceConstantAlpha = alpha;
+    POINT position = { left, top };
+    SIZE size = { width, height };
+    POINT source = { 0, 0 };
+    UpdateLayeredWindow(m_hwnd, nullptr, &position, &size, m_frame.dc, &source, 0, &blend, ULW_ALPHA);
+    m_layerAlpha = alpha;
+}
+
+void WindowAnimation::EndLayer() {
+    if (!m_layerActive) return;
+    m_layerActive = false;
+    
+    if (IsWindow(m_hwnd)) {
+        // Back to the window's own painting, at the alpha last shown
+        SetWindowLong(m_hwnd, GWL_EXSTYLE, m_savedExStyle & ~WS_EX_LAYERED);
+        if (m_savedExStyle & WS_EX_LAYERED) {
+            SetWindowLong(m_hwnd, GWL_EXSTYLE, m_savedExStyle);
+            SetLayeredWindowAttributes(m_hwnd, 0, m_layerAlpha, LWA_ALPHA);
+        }
+        RedrawWindow(m_hwnd, nullptr, nullptr, RDW_INVALIDATE | RDW_FRAME | RDW_ALLCHILDREN);
+    }
+    
+    Renderer::DeleteMemoryDC(m_layer.dc, m_layer.bitmap, GdiSubsystem::ANIMATION);
+    Renderer::DeleteMemoryDC(m_frame.dc, m_frame.bitmap, GdiSubsystem::ANIMATION);
+    m_layer = Renderer::PixelSurface();
+    m_frame = Renderer::PixelSurface();
+    m_layerAlpha = 255;
+}
+
 void WindowAnimation::CompleteAnimation() {
+    // The last frame's move lands before the window is shown in its new state
+    DeferredWindowPos::Flush(m_hwnd);
+    EndLayer();
     if (m_state == AnimationState::MINIMIZING) {
         ShowWindow(m_hwnd, SW_MINIMIZE);
         m_state = AnimationState::MINIMIZED;
@@ -271,13 +390,17 @@ void WindowAnimation::CompleteAnimation() {
 }
 
 void WindowAnimation::Update() {
+    Update(std::chrono::steady_clock::now());
+}
+
+void WindowAnimation::Update(std::chrono::steady_clock::time_point frameTime) {
     if (!IsAnimating()) return;
     if (!m_hwnd || !IsWindow(m_hwnd)) {
         StopAnimation();
         return;
     }
     
-    float progress = GetProgress();
+    float progress = GetProgress(frameTime);
     float easedProgress = ApplyEasing(progress);
     
     // Apply animation based on type
@@ -318,4 +441,104 @@ void WindowAnimation::Update() {
     }
 }
 
+// AnimationGroup
+AnimationGroup::AnimationGroup(PlayMode mode)
+    : m_playMode(mode)
+    , m_currentIndex(0)
+    , m_playing(false)
+    , m_paused(false)
+{
+}
+
+AnimationGroup::~AnimationGroup() {
+}
+
+void AnimationGroup::AddAnimation(WindowAnimation* animation) {
+    if (!animation) return;
+    if (std::find(m_animations.begin(), m_animations.end(), animation) != m_animations.end()) return;
+    m_animations.push_back(animation);
+}
+
+void AnimationGroup::RemoveAnimation(WindowAnimation* animation) {
+    auto it = std::find(m_animations.begin(), m_animations.end(), animation);
+    if (it == m_animations.end()) return;
+
+    size_t index = (size_t)(it - m_animations.begin());
+    m_animations.erase(it);
+    if (index < m_currentIndex) m_currentIndex--;
+}
+
+void AnimationGroup::Clear() {
+    m_animations.clear();
+    m_currentIndex = 0;
+    m_playing = false;
+    m_paused = false;
+}
+
+void AnimationGroup::Play() {
+    m_currentIndex = 0;
+    m_playing = !m_animations.empty();
+    m_paused = false;
+}
+
+void AnimationGroup::Stop() {
+    for (WindowAnimation* animation : m_animations) {
+        animation->StopAnimation();
+    }
+    m_playing = false;
+    m_paused = false;
+}
+
+void AnimationGroup::Pause() {
+    if (m_playing) m_paused = true;
+}
+
+void AnimationGroup::Resume() {
+    m_paused = false;
+}
+
+void AnimationGroup::Reverse() {
+    // Sequences play back to front from wherever they are
+    std::reverse(m_animations.begin(), m_animations.end());
+    if (m_currentIndex < m_animations.size()) {
+        m_currentIndex = m_animations.size() - 1 - m_currentIndex;
+    }
+}
+
+void AnimationGroup::Update() {
+    Update(std::chrono::steady_clock::now());
+}
+
+void AnimationGroup::Update(std::chrono::steady_clock::time_point frameTime) {
+    if (!m_playing || m_paused) return;
+
+    // Windows animating together move in one pass
+    DeferredWindowPos batch;
+    bool running = false;
+    if (m_playMode == PlayMode::PARALLEL) {
+        for (WindowAnimation* animation : m_animations) {
+            animation->Update(frameTime);
+            running = running || animation->IsAnimating();
+        }
+    } else {
+        // Advance past finished animations in the same frame
+        while (m_currentIndex < m_animations.size()) {
+            WindowAnimation* animation = m_animations[m_currentIndex];
+            animation->Update(frameTime);
+            if (animation->IsAnimating()) {
+                running = true;
+                break;
+            }
+            m_currentIndex++;
+        }
+    }
+
+    if (!running) {
+        m_playing = false;
+        if (m_onComplete) {
+            m_onComplete();
+        }
+    }
+}
+
 } // namespace SDK
@@ -1,4 +1,5 @@
 #include "../../include/SDK/WindowGroup.h"
+#include "../../include/SDK/DeferredWindowPos.h"
 #include <algorithm>
 
 namespace SDK {
@@ -42,13 +43,15 @@ void WindowGroup::ClearWindows() {
 void WindowGroup::MoveGroup(int deltaX, int deltaY) {
     if (!m_linkedMovement) return;
     
+    // The whole group moves and repaints in one pass
+    DeferredWindowPos batch;
     for (auto& window : m_windows) {
         if (!window || !window->IsValid()) continue;
         
         HWND hwnd = window->GetHandle();
         RECT rect;
-        if (GetWindowRect(hwnd, &rect)) {
-            SetWindowPos(hwnd, nullptr,
+        if (DeferredWindowPos::GetRect(hwnd, rect)) {
+            DeferredWindowPos::Move(hwnd, nullptr,
                 rect.left + deltaX, rect.top + deltaY,
                 0, 0,
                 SWP_NOSIZE | SWP_NOZORDER | SWP_NOACTIVATE);
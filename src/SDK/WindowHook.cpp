@@ -19,8 +19,10 @@ WindowHook::WindowHook()
     , m_bIsHooked(false)
     , m_hookType(HookType::INLINE)
     , m_createCallback(nullptr)
+    , m_filteredCount(0)
 {
     memset(m_originalBytes, 0, sizeof(m_originalBytes));
+    SetCreateFilters(GetDefaultFilters());
 }
 
 WindowHook::~WindowHook() {
@@ -73,6 +75,126 @@ void WindowHook::RegisterCreateCallback(CreateWindowCallback callback) {
     m_createCallback = callback;
 }
 
+CreateWindowFilter CreateWindowFilter::ExcludeClass(const std::wstring& name) {
+    CreateWindowFilter filter;
+    filter.className = name;
+    return filter;
+}
+
+CreateWindowFilter CreateWindowFilter::ExcludeStyle(DWORD mask, DWORD value) {
+    CreateWindowFilter filter;
+    filter.styleMask = mask;
+    filter.style = value;
+    return filter;
+}
+
+CreateWindowFilter CreateWindowFilter::ExcludeExStyle(DWORD mask, DWORD value) {
+    CreateWindowFilter filter;
+    filter.exStyleMask = mask;
+    filter.exStyle = value;
+    return filter;
+}
+
+std::vector<CreateWindowFilter> WindowHook::GetDefaultFilters() {
+    // Helper windows created by the system on behalf of the application
+    static const wchar_t* const HELPER_CLASSES[] = {
+        L"tooltips_class32",
+        L"IME",
+        L"MSCTFIME UI",
+        L"OleMainThreadWndClass",
+        L"OleDdeWndClass",
+        L"CicMarshalWndClass",
+        L"CiceroUIWndFrame",
+        L"DDEMLEvent",
+        L"DDEMLMom",
+    };
+    
+    std::vector<CreateWindowFilter> filters;
+    for (const wchar_t* name : HELPER_CLASSES) {
+        filters.push_back(CreateWindowFilter::ExcludeClass(name));
+    }
+    return filters;
+}
+
+uint32_t WindowHook::HashClassName(const wchar_t* name, size_t& length) {
+    // FNV-1a over the name folded to ASCII lower case
+    uint32_t hash = 2166136261u;
+    length = 0;
+    for (; name[length]; length++) {
+        wchar_t c = name[length];
+        if (c >= L'A' && c <= L'Z') c = (wchar_t)(c - L'A' + L'a');
+        hash = (hash ^ (uint32_t)c) * 16777619u;
+    }
+    return hash ? hash : 1;
+}
+
+WindowHook::CompiledFilter WindowHook::CompileFilter(const CreateWindowFilter& filter) {
+    CompiledFilter compiled;
+    compiled.className = filter.className;
+    for (wchar_t& c : compiled.className) {
+        if (c >= L'A' && c <= L'Z') c = (wchar_t)(c - L'A' + L'a');
+    }
+    size_t length;
+    compiled.classHash = compiled.className.empty() ? 0 : HashClassName(compiled.className.c_str(), length);
+    compiled.styleMask = filter.styleMask;
+    compiled.style = filter.style & filter.styleMask;
+    compiled.exStyleMask = filter.exStyleMask;
+    compiled.exStyle = filter.exStyle & filter.exStyleMask;
+    compiled.include = filter.include;
+    return compiled;
+}
+
+void WindowHook::AddCreateFilter(const CreateWindowFilter& filter) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto table = std::make_shared<FilterTable>(*std::atomic_load(&m_filters));
+    table->push_back(CompileFilter(filter));
+    std::atomic_store(&m_filters, std::shared_ptr<const FilterTable>(table));
+}
+
+void WindowHook::SetCreateFilters(const std::vector<CreateWindowFilter>& filters) {
+    auto table = std::make_shared<FilterTable>();
+    table->reserve(filters.size());
+    for (const auto& filter : filters) {
+        table->push_back(CompileFilter(filter));
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::atomic_store(&m_filters, std::shared_ptr<const FilterTable>(table));
+}
+
+bool WindowHook::PassesCreateFilter(HWND hwnd, LPCWSTR className, DWORD style, DWORD exStyle, HWND parent) const {
+    if (parent == HWND_MESSAGE) return false;
+    
+    std::shared_ptr<const FilterTable> table = std::atomic_load(&m_filters);
+    if (!table || table->empty()) return true;
+    
+    // A class given as an atom is looked up by name on the new window
+    wchar_t atomName[256];
+    const wchar_t* name = className;
+    if (!name || IS_INTRESOURCE(name)) {
+        name = (hwnd && GetClassNameW(hwnd, atomName, 256) > 0) ? atomName : L"";
+    }
+    size_t nameLength;
+    uint32_t nameHash = HashClassName(name, nameLength);
+    
+    for (const CompiledFilter& filter : *table) {
+        if ((style & filter.styleMask) != filter.style) continue;
+        if ((exStyle & filter.exStyleMask) != filter.exStyle) continue;
+        if (filter.classHash) {
+            if (filter.classHash != nameHash || filter.className.size() != nameLength) continue;
+            bool same = true;
+            for (size_t i = 0; i < nameLength && same; i++) {
+                wchar_t c = name[i];
+                if (c >= L'A' && c <= L'Z') c = (wchar_t)(c - L'A' + L'a');
+                same = c == filter.className[i];
+            }
+            if (!same) continue;
+        }
+        if (!filter.include) m_filteredCount.fetch_add(1, std::memory_order_relaxed);
+        return filter.include;
+    }
+    return true;
+}
+
 HWND WINAPI WindowHook::HookedCreateWindowExW(
     DWORD dwExStyle,
     LPCWSTR lpClassName,
@@ -95,8 +217,9 @@ HWND WINAPI WindowHook::HookedCreateWindowExW(
         hWndParent, hMenu, hInstance, lpParam
     );
     
-    // Notify callback
-    if (hwnd && hook.m_createCallback) {
+    // Notify callback, for the windows the filter lets through
+    if (hwnd && hook.m_createCallback &&
+        hook.PassesCreateFilter(hwnd, lpClassName, dwStyle, dwExStyle, hWndParent)) {
         hook.m_createCallback(hwnd);
     }
     
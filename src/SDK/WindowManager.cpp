@@ -1,9 +1,26 @@
 #include "../../include/SDK/WindowManager.h"
+#include "../../include/SDK/WindowAnimation.h"
+#include "../../include/SDK/DeferredWindowPos.h"
+#include "../../include/SDK/Profiler.h"
+#include "../../include/SDK/GdiObjectCache.h"
+#include "../../include/SDK/FrameArena.h"
+#include "../../include/SDK/EventQueue.h"
+#include "../../include/SDK/JobScheduler.h"
+#include "../../include/SDK/StartupTiming.h"
 #include <algorithm>
 #include <cmath>
 
 namespace SDK {
 
+namespace {
+    // How RenderWindows() handles each window
+    enum RenderStep : uint8_t {
+        RENDER_HERE,        // Rendered in full on this thread
+        RENDER_PRESENT,     // Drawn on a worker, presented here
+        RENDER_DONE         // BeginFrame() found nothing to draw
+    };
+}
+
 WindowManager& WindowManager::GetInstance() {
     static WindowManager instance;
     return instance;
@@ -14,6 +31,12 @@ WindowManager::WindowManager()
     , m_defaultTheme(nullptr)
     , m_depthAnimation(false)
     , m_animationTime(0.0f)
+    , m_frameScheduling(false)
+    , m_culledWindows(0)
+    , m_backgroundThrottling(true)
+    , m_parallelRendering(true)
+    , m_queuedCount(0)
+    , m_firstFramePresented(false)
 {
 }
 
@@ -28,8 +51,15 @@ bool WindowManager::Initialize() {
 }
 
 void WindowManager::Shutdown() {
-    m_windows.clear();
-    m_sortedWindows.clear();
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_queuedWindows.clear();
+        m_queuedCount = 0;
+    }
+    m_registry.Clear();
+    m_animations.clear();
+    m_animationGroups.clear();
+    m_afterFirstFrame.clear();
     m_defaultTheme = nullptr;
 }
 
@@ -39,10 +69,11 @@ std::shared_ptr<Window> WindowManager::RegisterWindow(HWND hwnd) {
     }
     
     // Check if already registered
-    auto it = m_windows.find(hwnd);
-    if (it != m_windows.end()) {
-        return it->second;
+    std::shared_ptr<Window> existing = m_registry.Find(hwnd);
+    if (existing) {
+        return existing;
     }
+    TakeQueuedWindow(hwnd);
     
     // Create new window
     auto window = std::make_shared<Window>(hwnd);
@@ -58,40 +89,77 @@ std::shared_ptr<Window> WindowManager::RegisterWindow(HWND hwnd) {
     // Enable layered mode for alpha support
     window->EnableLayeredMode();
     
+    window->SetFrameScheduled(m_frameScheduling);
+    
     // End batched updates
     window->EndUpdate();
     
-    // Register
-    m_windows[hwnd] = window;
-    
-    // Update sorted list
-    SortWindowsByDepth();
-    
-    return window;
+    // Register at its place in depth order. A window registered for the
+    // same handle by another thread in the meantime wins.
+    return m_registry.Insert(window);
 }
 
 void WindowManager::UnregisterWindow(HWND hwnd) {
-    auto it = m_windows.find(hwnd);
-    if (it != m_windows.end()) {
-        m_windows.erase(it);
-        SortWindowsByDepth();
+    TakeQueuedWindow(hwnd);
+    m_registry.Remove(hwnd);
+    
+    HWND modal = hwnd;
+    m_activeModal.compare_exchange_strong(modal, nullptr);
+}
+
+std::shared_ptr<Window> WindowManager::GetWindow(HWND hwnd) {
+    std::shared_ptr<Window> window = m_registry.Find(hwnd);
+    if (!window && TakeQueuedWindow(hwnd)) {
+        window = RegisterWindow(hwnd);
     }
+    return window;
+}
+
+void WindowManager::QueueWindow(HWND hwnd) {
+    if (!hwnd) return;
     
-    if (m_activeModal == hwnd) {
-        m_activeModal = nullptr;
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    if (m_queuedWindows.insert(hwnd).second) {
+        m_queuedCount = m_queuedWindows.size();
     }
 }
 
-std::shared_ptr<Window> WindowManager::GetWindow(HWND hwnd) {
-    auto it = m_windows.find(hwnd);
-    if (it != m_windows.end()) {
-        return it->second;
+bool WindowManager::TakeQueuedWindow(HWND hwnd) {
+    if (m_queuedCount.load(std::memory_order_relaxed) == 0) return false;
+    
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    if (m_queuedWindows.erase(hwnd) == 0) return false;
+    m_queuedCount = m_queuedWindows.size();
+    return true;
+}
+
+void WindowManager::RegisterVisibleQueuedWindows() {
+    if (m_queuedCount.load(std::memory_order_relaxed) == 0) return;
+    
+    // Windows about to be painted for the first time; destroyed ones are dropped
+    thread_local std::vector<HWND> visible;
+    visible.clear();
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        for (auto it = m_queuedWindows.begin(); it != m_queuedWindows.end();) {
+            if (!::IsWindow(*it)) {
+                it = m_queuedWindows.erase(it);
+            } else if (IsWindowVisible(*it)) {
+                visible.push_back(*it);
+                it = m_queuedWindows.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        m_queuedCount = m_queuedWindows.size();
+    }
+    for (HWND hwnd : visible) {
+        RegisterWindow(hwnd);
     }
-    return nullptr;
 }
 
 std::vector<std::shared_ptr<Window>> WindowManager::GetWindowsByDepth() const {
-    return m_sortedWindows;
+    return m_registry.GetSnapshot()->byDepth;
 }
 
 void WindowManager::SetActiveModal(HWND hwnd) {
@@ -106,26 +174,332 @@ void WindowManager::SetDefaultTheme(std::shared_ptr<Theme> theme) {
     m_defaultTheme = theme;
     
     // Apply to all existing windows
-    for (auto& pair : m_windows) {
-        pair.second->SetTheme(theme);
+    WindowRegistry::SnapshotPtr windows = m_registry.GetSnapshot();
+    for (auto& window : windows->byDepth) {
+        window->SetTheme(theme);
     }
 }
 
 void WindowManager::RenderAllWindows() {
+    SDK_PROFILE_ZONE("WindowManager::RenderAllWindows");
+    RegisterVisibleQueuedWindows();
+    WindowRegistry::SnapshotPtr windows = m_registry.GetSnapshot();
+    CullOccludedWindows(*windows);
+    
     // Render in depth order (back to front)
-    for (auto& window : m_sortedWindows) {
-        if (window->IsValid()) {
-            HDC hdc = GetDC(window->GetHandle());
-            if (hdc) {
-                window->Render(hdc);
-                ReleaseDC(window->GetHandle(), hdc);
+    m_renderIndices.clear();
+    for (size_t i = 0; i < windows->Size(); i++) {
+        if (windows->byDepth[i]->IsValid() && !m_windowOccluded[i]) {
+            m_renderIndices.push_back(i);
+        }
+    }
+    RenderWindows(*windows, m_renderIndices, false);
+    GdiObjectCache::EndFrame();
+    FrameArena::EndFrame();
+    if (!m_renderIndices.empty()) {
+        FinishFirstFrame();
+    }
+}
+
+void WindowManager::RunAfterFirstFrame(std::function<void()> callback) {
+    if (!callback) return;
+    if (m_firstFramePresented) {
+        callback();
+        return;
+    }
+    m_afterFirstFrame.push_back(std::move(callback));
+}
+
+InputTrace::ReplayStats WindowManager::Replay(const InputTrace& trace,
+                                              const std::vector<std::shared_ptr<Window>>& windows,
+                                              double frameRate) {
+    auto dispatch = [&windows](const InputEvent& event) {
+        if (event.window < windows.size() && windows[event.window] && windows[event.window]->IsValid()) {
+            windows[event.window]->ReplayEvent(event);
+        }
+    };
+    auto frame = [this, &windows](double, float deltaTime) {
+        SDK_PROFILE_ZONE("WindowManager::ReplayFrame");
+        for (auto& window : windows) {
+            if (window && window->IsValid()) window->ReplayFrame();
+        }
+        EventQueue::Dispatch();
+        m_timeline.Advance(deltaTime);
+        Update(deltaTime);
+        for (auto& window : windows) {
+            if (window && window->IsValid()) window->UpdateWidgets(deltaTime);
+        }
+        RenderAllWindows();
+    };
+    return trace.Replay(dispatch, frame, frameRate);
+}
+
+void WindowManager::FinishFirstFrame() {
+    if (m_firstFramePresented) return;
+    m_firstFramePresented = true;
+    StartupTiming::MarkFirstFrame();
+    
+    std::vector<std::function<void()>> callbacks;
+    callbacks.swap(m_afterFirstFrame);
+    for (auto& callback : callbacks) {
+        callback();
+    }
+}
+
+void WindowManager::RenderWindows(const WindowRegistry::Snapshot& windows, const std::vector<size_t>& indices,
+                                  bool pendingOnly) {
+    // Handlers run once for every window, rather than per Render()
+    if (!pendingOnly) {
+        EventQueue::Dispatch();
+    }
+    
+    // Windows that can draw off this thread begin their frames first, then
+    // redraw their back buffers together on the workers
+    m_renderSteps.assign(indices.size(), RENDER_HERE);
+    m_offscreenWindows.clear();
+    if (m_parallelRendering && indices.size() > 1) {
+        for (size_t n = 0; n < indices.size(); n++) {
+            Window& window = *windows.byDepth[indices[n]];
+            if (!window.CanRenderOffscreen()) continue;
+            HDC hdc = GetDC(window.GetHandle());
+            if (!hdc) continue;
+            bool draw = window.BeginFrame(hdc, !pendingOnly);
+            ReleaseDC(window.GetHandle(), hdc);
+            m_renderSteps[n] = draw ? RENDER_PRESENT : RENDER_DONE;
+            if (draw) m_offscreenWindows.push_back(&window);
+        }
+    }
+    if (!m_offscreenWindows.empty()) {
+        SDK_PROFILE_ZONE("WindowManager::DrawFrames");
+        std::vector<Window*>& offscreen = m_offscreenWindows;
+        JobScheduler::ParallelFor((int)offscreen.size(), 1, [&offscreen](int begin, int end) {
+            // The caller runs a chunk too, mid-frame, so scratch goes back per chunk
+            FrameArena::Scope scratch;
+            for (int i = begin; i < end; i++) {
+                offscreen[i]->DrawFrame();
+            }
+            GdiObjectCache::EndFrame();
+        }, "WindowDrawFrame");
+    }
+    
+    // Present and render the rest in the given order
+    for (size_t n = 0; n < indices.size(); n++) {
+        if (m_renderSteps[n] == RENDER_DONE) continue;
+        Window& window = *windows.byDepth[indices[n]];
+        HDC hdc = GetDC(window.GetHandle());
+        if (!hdc) continue;
+        if (m_renderSteps[n] == RENDER_PRESENT) {
+            window.PresentFrame(hdc);
+        } else if (pendingOnly) {
+            window.RenderPending(hdc);
+        } else {
+            window.Render(hdc);
+        }
+        ReleaseDC(window.GetHandle(), hdc);
+    }
+}
+
+void WindowManager::EnableFrameScheduling(bool enabled) {
+    m_frameScheduling = enabled;
+    WindowRegistry::SnapshotPtr windows = m_registry.GetSnapshot();
+    for (auto& window : windows->byDepth) {
+        window->SetFrameScheduled(enabled);
+    }
+}
+
+bool WindowManager::HasPendingFrame() const {
+    if (m_depthAnimation || m_timeline.HasPlayingTracks()) return true;
+    
+    for (WindowAnimation* animation : m_animations) {
+        if (animation->IsAnimating()) return true;
+    }
+    for (AnimationGroup* group : m_animationGroups) {
+        if (group->IsPlaying() && !group->IsPaused()) return true;
+    }
+    WindowRegistry::SnapshotPtr windows = m_registry.GetSnapshot();
+    for (const auto& window : windows->byDepth) {
+        if (window->IsValid() && window->GetTimeUntilNextUpdate() == 0.0f && !IsWindowSuspended(*window)) {
+            return true;
+        }
+    }
+    bool culled = false;
+    for (size_t i = 0; i < windows->Size(); i++) {
+        const auto& window = windows->byDepth[i];
+        if (!window->HasPendingFrame() || !window->IsValid() || IsWindowSuspended(*window)) continue;
+        
+        // A covered window waits until the windows above it move
+        if (!culled) {
+            CullOccludedWindows(*windows);
+            culled = true;
+        }
+        if (!m_windowOccluded[i]) return true;
+    }
+    return false;
+}
+
+void WindowManager::CullOccludedWindows(const WindowRegistry::Snapshot& windows) const {
+    // Top-level windows looked at before giving up on finding the managed ones
+    static constexpr int MAX_Z_ORDER_WALK = 4096;
+    
+    m_windowOccluded.assign(windows.Size(), 0);
+    m_culledWindows = 0;
+    if (windows.Size() < 2) return;
+    
+    // Managed windows in screen z-order, topmost first. Child windows aren't
+    // in the top-level list and are never culled.
+    thread_local std::vector<size_t> order;
+    order.clear();
+    int walked = 0;
+    for (HWND hwnd = GetTopWindow(nullptr); hwnd && order.size() < windows.Size() && walked < MAX_Z_ORDER_WALK;
+         hwnd = ::GetWindow(hwnd, GW_HWNDNEXT), walked++) {
+        size_t index = windows.IndexOf(hwnd);
+        if (index != WindowRegistry::Snapshot::NOT_FOUND) {
+            order.push_back(index);
+        }
+    }
+    
+    // Front to back over the opaque client areas
+    thread_local std::vector<RECT> occluders;
+    occluders.clear();
+    for (size_t i : order) {
+        const Window& window = *windows.byDepth[i];
+        RECT client;
+        if (!window.GetClientScreenRect(client)) continue;
+        
+        if (!occluders.empty() && Renderer::IsRectOccluded(client, occluders)) {
+            m_windowOccluded[i] = 1;
+            m_culledWindows++;
+            continue;
+        }
+        
+        RECT opaque;
+        if (window.GetOpaqueScreenRect(opaque)) {
+            occluders.push_back(opaque);
+        }
+    }
+}
+
+bool WindowManager::RunFrame() {
+    RegisterVisibleQueuedWindows();
+    // Coalesced handlers run before the frame check; they may invalidate
+    EventQueue::Dispatch();
+    if (!HasPendingFrame()) return false;
+    SDK_PROFILE_ZONE("WindowManager::RunFrame");
+    
+    // Every animation samples the same instant, taken at the refresh
+    FrameClock::TimePoint frameTime = m_frameClock.BeginFrame();
+    WindowRegistry::SnapshotPtr windows = m_registry.GetSnapshot();
+    ThrottleWindows(*windows, m_frameClock.GetDeltaTime());
+    {
+        SDK_PROFILE_ZONE("WindowManager::Animate");
+        
+        // Every animating window moves in one pass at the end of the block.
+        // Minimize and restore run on minimized windows, so those always tick.
+        DeferredWindowPos batch;
+        m_timeline.Advance(m_frameClock.GetDeltaTime());
+        for (size_t i = 0; i < m_animations.size(); i++) {
+            size_t index = windows->IndexOf(m_animations[i]->GetHandle());
+            if (index != WindowRegistry::Snapshot::NOT_FOUND && !m_windowTicked[index] &&
+                windows->byDepth[index]->GetVisibility() != WindowVisibility::MINIMIZED) {
+                continue;
             }
+            m_animations[i]->Update(frameTime);
+        }
+        for (size_t i = 0; i < m_animationGroups.size(); i++) {
+            m_animationGroups[i]->Update(frameTime);
+        }
+    }
+    Update(m_frameClock.GetDeltaTime());
+    
+    int rendered = 0;
+    int skipped = 0;
+    int culled = 0;
+    for (size_t i = 0; i < windows->Size(); i++) {
+        auto& window = windows->byDepth[i];
+        if (window->IsValid() && window->IsUpdateSchedulingEnabled() && m_windowTicked[i]) {
+            window->UpdateWidgets(m_frameClock.GetDeltaTime());
         }
     }
+    CullOccludedWindows(*windows);
+    m_renderIndices.clear();
+    for (size_t i = 0; i < windows->Size(); i++) {
+        auto& window = windows->byDepth[i];
+        if (!window->IsValid()) continue;
+        if (m_backgroundThrottling) {
+            window->SetVisibility(window->QueryVisibility(m_windowOccluded[i] != 0));
+        }
+        if (!window->HasPendingFrame()) {
+            skipped++;
+            continue;
+        }
+        if (m_windowOccluded[i] || IsWindowSuspended(*window)) {
+            culled++;
+            continue;
+        }
+        m_renderIndices.push_back(i);
+    }
+    RenderWindows(*windows, m_renderIndices, true);
+    rendered = (int)m_renderIndices.size();
+    
+    GdiObjectCache::EndFrame();
+    FrameArena::EndFrame();
+    m_frameClock.EndFrame(rendered, skipped, culled);
+    if (rendered > 0) {
+        FinishFirstFrame();
+    }
+    return true;
+}
+
+void WindowManager::ThrottleWindows(const WindowRegistry::Snapshot& windows, float deltaTime) {
+    m_windowTicked.assign(windows.Size(), 1);
+    if (!m_backgroundThrottling) return;
+    
+    // Occlusion is last frame's; the cull runs after the windows move
+    for (size_t i = 0; i < windows.Size(); i++) {
+        Window& window = *windows.byDepth[i];
+        window.SetVisibility(window.QueryVisibility(window.GetVisibility() == WindowVisibility::OCCLUDED));
+        m_windowTicked[i] = window.TakeBackgroundTick(deltaTime);
+    }
+}
+
+bool WindowManager::IsWindowSuspended(const Window& window) const {
+    return m_backgroundThrottling && window.QueryVisibility(false) > WindowVisibility::OCCLUDED;
+}
+
+DWORD WindowManager::GetIdleTimeout() const {
+    float earliest = -1.0f;
+    WindowRegistry::SnapshotPtr windows = m_registry.GetSnapshot();
+    for (const auto& window : windows->byDepth) {
+        if (!window->IsValid() || IsWindowSuspended(*window)) continue;
+        float wait = window->GetTimeUntilNextUpdate();
+        if (wait >= 0.0f && (earliest < 0.0f || wait < earliest)) earliest = wait;
+    }
+    if (earliest < 0.0f) return INFINITE;
+    return (DWORD)std::ceil(earliest * 1000.0f);
+}
+
+void WindowManager::AddAnimation(WindowAnimation* animation) {
+    if (animation && std::find(m_animations.begin(), m_animations.end(), animation) == m_animations.end()) {
+        m_animations.push_back(animation);
+    }
+}
+
+void WindowManager::RemoveAnimation(WindowAnimation* animation) {
+    m_animations.erase(std::remove(m_animations.begin(), m_animations.end(), animation), m_animations.end());
+}
+
+void WindowManager::AddAnimationGroup(AnimationGroup* group) {
+    if (group && std::find(m_animationGroups.begin(), m_animationGroups.end(), group) == m_animationGroups.end()) {
+        m_animationGroups.push_back(group);
+    }
+}
+
+void WindowManager::RemoveAnimationGroup(AnimationGroup* group) {
+    m_animationGroups.erase(std::remove(m_animationGroups.begin(), m_animationGroups.end(), group), m_animationGroups.end());
 }
 
 void WindowManager::UpdateWindowDepths() {
-    SortWindowsByDepth();
+    m_registry.Resort();
 }
 
 void WindowManager::EnableDepthAnimation(bool enabled) {
@@ -137,9 +511,9 @@ void WindowManager::Update(float deltaTime) {
         m_animationTime += deltaTime;
         
         // Apply breathing animation to windows
-        for (auto& pair : m_windows) {
-            auto& window = pair.second;
-            if (window->IsValid()) {
+        WindowRegistry::SnapshotPtr windows = m_registry.GetSnapshot();
+        for (auto& window : windows->byDepth) {
+            if (window->IsValid() && !(m_backgroundThrottling && window->IsSuspended())) {
                 // Subtle scale animation based on depth
                 float baseScale = 1.0f;
                 switch (window->GetDepth()) {
@@ -158,19 +532,4 @@ void WindowManager::Update(float deltaTime) {
     }
 }
 
-void WindowManager::SortWindowsByDepth() {
-    m_sortedWindows.clear();
-    m_sortedWindows.reserve(m_windows.size());
-    
-    for (auto& pair : m_windows) {
-        m_sortedWindows.push_back(pair.second);
-    }
-    
-    // Sort by depth (back to front)
-    std::sort(m_sortedWindows.begin(), m_sortedWindows.end(),
-        [](const std::shared_ptr<Window>& a, const std::shared_ptr<Window>& b) {
-            return static_cast<int>(a->GetDepth()) < static_cast<int>(b->GetDepth());
-        });
-}
-
 } // namespace SDK
@@ -0,0 +1,110 @@
+#include "../../include/SDK/WindowRegistry.h"
+#include <algorithm>
+
+namespace SDK {
+
+size_t WindowRegistry::Snapshot::IndexOf(HWND hwnd) const {
+    auto it = std::lower_bound(handles.begin(), handles.end(), hwnd);
+    if (it == handles.end() || *it != hwnd) return NOT_FOUND;
+    return handleIndex[it - handles.begin()];
+}
+
+std::shared_ptr<Window> WindowRegistry::Snapshot::Find(HWND hwnd) const {
+    size_t index = IndexOf(hwnd);
+    return index != NOT_FOUND ? byDepth[index] : nullptr;
+}
+
+WindowRegistry::WindowRegistry()
+    : m_snapshot(std::make_shared<Snapshot>())
+{
+}
+
+std::shared_ptr<Window> WindowRegistry::Insert(const std::shared_ptr<Window>& window) {
+    if (!window) return nullptr;
+
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    SnapshotPtr current = GetSnapshot();
+    std::shared_ptr<Window> existing = current->Find(window->GetHandle());
+    if (existing) return existing;
+
+    auto next = std::make_shared<Snapshot>(*current);
+    int depth = static_cast<int>(window->GetDepth());
+    size_t at = std::upper_bound(next->depths.begin(), next->depths.end(), depth) - next->depths.begin();
+    next->depths.insert(next->depths.begin() + at, depth);
+    next->byDepth.insert(next->byDepth.begin() + at, window);
+    next->handles.insert(std::lower_bound(next->handles.begin(), next->handles.end(), window->GetHandle()),
+                         window->GetHandle());
+    Publish(next);
+    return window;
+}
+
+bool WindowRegistry::Remove(HWND hwnd) {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    SnapshotPtr current = GetSnapshot();
+    size_t index = current->IndexOf(hwnd);
+    if (index == Snapshot::NOT_FOUND) return false;
+
+    auto next = std::make_shared<Snapshot>(*current);
+    next->byDepth.erase(next->byDepth.begin() + index);
+    next->depths.erase(next->depths.begin() + index);
+    next->handles.erase(std::lower_bound(next->handles.begin(), next->handles.end(), hwnd));
+    Publish(next);
+    return true;
+}
+
+void WindowRegistry::Resort() {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    SnapshotPtr current = GetSnapshot();
+
+    bool changed = false;
+    for (size_t i = 0; i < current->Size() && !changed; i++) {
+        changed = static_cast<int>(current->byDepth[i]->GetDepth()) != current->depths[i];
+    }
+    if (!changed) return;
+
+    auto next = std::make_shared<Snapshot>(*current);
+    for (size_t i = 0; i < next->Size(); i++) {
+        next->depths[i] = static_cast<int>(next->byDepth[i]->GetDepth());
+    }
+
+    // Stable insertion sort; windows that kept their depth stay in place
+    std::vector<int>& depths = next->depths;
+    std::vector<std::shared_ptr<Window>>& windows = next->byDepth;
+    for (size_t i = 1; i < depths.size(); i++) {
+        if (depths[i - 1] <= depths[i]) continue;
+        int depth = depths[i];
+        std::shared_ptr<Window> window = std::move(windows[i]);
+        size_t j = i;
+        for (; j > 0 && depths[j - 1] > depth; j--) {
+            depths[j] = depths[j - 1];
+            windows[j] = std::move(windows[j - 1]);
+        }
+        depths[j] = depth;
+        windows[j] = std::move(window);
+    }
+    Publish(next);
+}
+
+void WindowRegistry::Clear() {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    auto next = std::make_shared<Snapshot>();
+    next->version = GetSnapshot()->version;
+    Publish(next);
+}
+
+void WindowRegistry::IndexHandles(Snapshot& snapshot) {
+    snapshot.handleIndex.resize(snapshot.handles.size());
+    for (size_t i = 0; i < snapshot.byDepth.size(); i++) {
+        HWND hwnd = snapshot.byDepth[i]->GetHandle();
+        size_t slot = std::lower_bound(snapshot.handles.begin(), snapshot.handles.end(), hwnd) - snapshot.handles.begin();
+        snapshot.handleIndex[slot] = (uint32_t)i;
+    }
+}
+
+void WindowRegistry::Publish(const std::shared_ptr<Snapshot>& snapshot) {
+    IndexHandles(*snapshot);
+    snapshot->version++;
+    std::atomic_store(&m_snapshot, SnapshotPtr(snapshot));
+}
+
+} // namespace SDK
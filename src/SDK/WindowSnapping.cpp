@@ -1,4 +1,5 @@
 #include "../../include/SDK/WindowSnapping.h"
+#include "../../include/SDK/MonitorManager.h"
 #include <algorithm>
 #include <cmath>
 
@@ -12,6 +13,7 @@ WindowSnapping::WindowSnapping()
     , m_windowSnapThreshold(15)
     , m_gridWidth(100)
     , m_gridHeight(100)
+    , m_moveHwnd(nullptr)
 {
 }
 
@@ -31,6 +33,12 @@ void WindowSnapping::GetGridSize(int& width, int& height) const {
 RECT WindowSnapping::GetScreenWorkArea(HWND hwnd) {
     RECT workArea = {0};
     
+    // The cached monitor layout, when MonitorManager has one
+    const MonitorInfo* monitor = MonitorManager::GetInstance().GetMonitorForWindow(hwnd);
+    if (monitor) {
+        return monitor->workArea;
+    }
+    
     // Get monitor info for the window
     HMONITOR hMonitor = MonitorFromWindow(hwnd, MONITOR_DEFAULTTONEAREST);
     if (hMonitor) {
@@ -52,6 +60,105 @@ RECT WindowSnapping::GetScreenWorkArea(HWND hwnd) {
     return workArea;
 }
 
+RECT WindowSnapping::GetWorkArea(const RECT& proposed, const std::vector<RECT>& workAreas) {
+    // The monitor holding most of the window, as MonitorFromWindow picks it,
+    // or the nearest one when it is on none
+    const RECT* best = nullptr;
+    long long bestArea = 0;
+    long long bestDistance = 0;
+    int centerX = (proposed.left + proposed.right) / 2;
+    int centerY = (proposed.top + proposed.bottom) / 2;
+    for (const RECT& area : workAreas) {
+        long long w = (long long)std::min(proposed.right, area.right) - std::max(proposed.left, area.left);
+        long long h = (long long)std::min(proposed.bottom, area.bottom) - std::max(proposed.top, area.top);
+        long long overlap = (w > 0 && h > 0) ? w * h : 0;
+        long long dx = std::max({ (long long)area.left - centerX, 0LL, (long long)centerX - area.right });
+        long long dy = std::max({ (long long)area.top - centerY, 0LL, (long long)centerY - area.bottom });
+        long long distance = dx * dx + dy * dy;
+        if (!best || overlap > bestArea || (overlap == 0 && bestArea == 0 && distance < bestDistance)) {
+            best = &area;
+            bestArea = overlap;
+            bestDistance = distance;
+        }
+    }
+    
+    if (best) return *best;
+    RECT screen = { 0, 0, GetSystemMetrics(SM_CXSCREEN), GetSystemMetrics(SM_CYSCREEN) };
+    return screen;
+}
+
+void WindowSnapping::CollectWindowEdges(HWND hwnd, const std::vector<std::shared_ptr<Window>>& windows,
+                                        EdgeList& edges)
+{
+    edges.lefts.clear();
+    edges.rights.clear();
+    edges.tops.clear();
+    edges.bottoms.clear();
+    
+    for (const auto& window : windows) {
+        if (!window || !window->IsValid()) continue;
+        
+        HWND otherHwnd = window->GetHandle();
+        if (otherHwnd == hwnd) continue;
+        
+        RECT otherRect;
+        if (!GetWindowRect(otherHwnd, &otherRect)) continue;
+        
+        edges.lefts.push_back(otherRect.left);
+        edges.rights.push_back(otherRect.right);
+        edges.tops.push_back(otherRect.top);
+        edges.bottoms.push_back(otherRect.bottom);
+    }
+    
+    std::sort(edges.lefts.begin(), edges.lefts.end());
+    std::sort(edges.rights.begin(), edges.rights.end());
+    std::sort(edges.tops.begin(), edges.tops.end());
+    std::sort(edges.bottoms.begin(), edges.bottoms.end());
+}
+
+bool WindowSnapping::FindNearest(const std::vector<int>& edges, int value, int threshold, int& nearest) {
+    // Only the edges on either side of value can be the closest
+    auto it = std::lower_bound(edges.begin(), edges.end(), value);
+    bool found = false;
+    if (it != edges.end() && *it - value <= threshold) {
+        nearest = *it;
+        found = true;
+    }
+    if (it != edges.begin() && value - *(it - 1) <= threshold) {
+        if (!found || value - *(it - 1) < nearest - value) {
+            nearest = *(it - 1);
+            found = true;
+        }
+    }
+    return found;
+}
+
+void WindowSnapping::BeginMove(HWND hwnd, const std::vector<std::shared_ptr<Window>>& windows) {
+    m_moveHwnd = hwnd;
+    CollectWindowEdges(hwnd, windows, m_moveEdges);
+    
+    // Without a cached monitor layout, the work areas are read once per move
+    m_moveEdges.workAreas.clear();
+    if (!MonitorManager::GetInstance().GetTopology().IsEmpty()) return;
+    EnumDisplayMonitors(nullptr, nullptr, WorkAreaEnumProc,
+                        reinterpret_cast<LPARAM>(&m_moveEdges.workAreas));
+}
+
+BOOL CALLBACK WindowSnapping::WorkAreaEnumProc(HMONITOR hMonitor, HDC hdcMonitor,
+                                               LPRECT lprcMonitor, LPARAM dwData)
+{
+    MONITORINFO mi = {0};
+    mi.cbSize = sizeof(MONITORINFO);
+    if (GetMonitorInfo(hMonitor, &mi)) {
+        reinterpret_cast<std::vector<RECT>*>(dwData)->push_back(mi.rcWork);
+    }
+    return TRUE;
+}
+
+void WindowSnapping::EndMove() {
+    m_moveHwnd = nullptr;
+}
+
 bool WindowSnapping::IsNearEdge(int value, int edge, int threshold) const {
     return std::abs(value - edge) <= threshold;
 }
@@ -67,7 +174,15 @@ RECT WindowSnapping::SnapToEdges(HWND hwnd, const RECT& proposed) {
     if (!m_edgeSnapEnabled) return proposed;
     
     RECT result = proposed;
-    RECT workArea = GetScreenWorkArea(hwnd);
+    RECT workArea;
+    const MonitorTopology& topology = MonitorManager::GetInstance().GetTopology();
+    if (hwnd != m_moveHwnd) {
+        workArea = GetScreenWorkArea(hwnd);
+    } else if (!topology.IsEmpty()) {
+        workArea = topology.Get(topology.FromRect(proposed))->workArea;
+    } else {
+        workArea = GetWorkArea(proposed, m_moveEdges.workAreas);
+    }
     
     int width = proposed.right - proposed.left;
     int height = proposed.bottom - proposed.top;
@@ -116,42 +231,39 @@ RECT WindowSnapping::SnapToWindows(HWND hwnd, const RECT& proposed,
 {
     if (!m_magneticEnabled) return proposed;
     
+    const EdgeList* edges = &m_moveEdges;
+    if (hwnd != m_moveHwnd) {
+        CollectWindowEdges(hwnd, windows, m_scratchEdges);
+        edges = &m_scratchEdges;
+    }
+    
     RECT result = proposed;
     int width = proposed.right - proposed.left;
     int height = proposed.bottom - proposed.top;
+    int edge;
     
-    for (const auto& window : windows) {
-        if (!window || !window->IsValid()) continue;
-        
-        HWND otherHwnd = window->GetHandle();
-        if (otherHwnd == hwnd) continue;
-        
-        RECT otherRect;
-        if (!GetWindowRect(otherHwnd, &otherRect)) continue;
-        
-        // Snap left edge to other window's right edge
-        if (IsNearEdge(proposed.left, otherRect.right, m_windowSnapThreshold)) {
-            result.left = otherRect.right;
-            result.right = result.left + width;
-        }
-        
-        // Snap right edge to other window's left edge
-        if (IsNearEdge(proposed.right, otherRect.left, m_windowSnapThreshold)) {
-            result.right = otherRect.left;
-            result.left = result.right - width;
-        }
-        
-        // Snap top edge to other window's bottom edge
-        if (IsNearEdge(proposed.top, otherRect.bottom, m_windowSnapThreshold)) {
-            result.top = otherRect.bottom;
-            result.bottom = result.top + height;
-        }
-        
-        // Snap bottom edge to other window's top edge
-        if (IsNearEdge(proposed.bottom, otherRect.top, m_windowSnapThreshold)) {
-            result.bottom = otherRect.top;
-            result.top = result.bottom - height;
-        }
+    // Snap left edge to the nearest other window's right edge
+    if (FindNearest(edges->rights, proposed.left, m_windowSnapThreshold, edge)) {
+        result.left = edge;
+        result.right = result.left + width;
+    }
+    
+    // Snap right edge to the nearest other window's left edge
+    if (FindNearest(edges->lefts, proposed.right, m_windowSnapThreshold, edge)) {
+        result.right = edge;
+        result.left = result.right - width;
+    }
+    
+    // Snap top edge to the nearest other window's bottom edge
+    if (FindNearest(edges->bottoms, proposed.top, m_windowSnapThreshold, edge)) {
+        result.top = edge;
+        result.bottom = result.top + height;
+    }
+    
+    // Snap bottom edge to the nearest other window's top edge
+    if (FindNearest(edges->tops, proposed.bottom, m_windowSnapThreshold, edge)) {
+        result.bottom = edge;
+        result.top = result.bottom - height;
     }
     
     return result;
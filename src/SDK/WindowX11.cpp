@@ -4,9 +4,13 @@
 
 #include "SDK/X11RenderBackend.h"
 #include "SDK/StringUtils.h"
+#include "SDK/FrameArena.h"
 #include <locale>
 #include <cstring>
 #include <algorithm>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
 namespace SDK {
 
@@ -18,6 +22,10 @@ WindowX11::WindowX11()
     , m_shouldClose(false)
     , m_width(0)
     , m_height(0)
+    , m_configureMask(0)
+    , m_frameScheduled(false)
+    , m_framePending(false)
+    , m_coalesceMotion(true)
 {
 }
 
@@ -92,6 +100,12 @@ bool WindowX11::Create(const std::wstring& title, int x, int y, int width, int h
 
 void WindowX11::Destroy()
 {
+    if (m_configureMask) {
+        auto& pending = GetConfigureQueue().windows;
+        pending.erase(std::remove(pending.begin(), pending.end(), this), pending.end());
+        m_configureMask = 0;
+    }
+    
     if (m_renderBackend) {
         m_renderBackend->Shutdown();
         m_renderBackend.reset();
@@ -130,28 +144,95 @@ void WindowX11::SetTitle(const std::wstring& title)
         return;
     }
     
-    // Convert wstring to UTF-8
-    std::string utf8Title = WStringToUTF8(title);
+    std::string_view utf8Title = UTF8Scratch::Convert(title);      // NUL-terminated
     
-    XStoreName(m_display, m_window, utf8Title.c_str());
+    XStoreName(m_display, m_window, utf8Title.data());
     XFlush(m_display);
 }
 
 void WindowX11::SetPosition(int x, int y)
 {
-    if (m_display && m_window) {
-        XMoveWindow(m_display, m_window, x, y);
-        XFlush(m_display);
-    }
+    Configure(CWX | CWY, x, y, 0, 0);
 }
 
 void WindowX11::SetSize(int width, int height)
 {
-    if (m_display && m_window) {
+    Configure(CWWidth | CWHeight, 0, 0, width, height);
+}
+
+void WindowX11::SetBounds(int x, int y, int width, int height)
+{
+    Configure(CWX | CWY | CWWidth | CWHeight, x, y, width, height);
+}
+
+void WindowX11::Configure(unsigned int mask, int x, int y, int width, int height)
+{
+    if (!m_display || !m_window) {
+        return;
+    }
+    
+    if (mask & CWX) {
+        m_configure.x = x;
+        m_configure.y = y;
+    }
+    if (mask & CWWidth) {
         m_width = width;
         m_height = height;
-        XResizeWindow(m_display, m_window, width, height);
+        m_configure.width = width;
+        m_configure.height = height;
+    }
+    
+    ConfigureQueue& queue = GetConfigureQueue();
+    if (queue.depth == 0) {
+        m_configureMask = mask;
+        SendConfigure();
         XFlush(m_display);
+        return;
+    }
+    
+    if (!m_configureMask) {
+        queue.windows.push_back(this);
+    }
+    m_configureMask |= mask;
+}
+
+void WindowX11::SendConfigure()
+{
+    XConfigureWindow(m_display, m_window, m_configureMask, &m_configure);
+    m_configureMask = 0;
+}
+
+WindowX11::ConfigureQueue& WindowX11::GetConfigureQueue()
+{
+    thread_local ConfigureQueue queue;
+    return queue;
+}
+
+WindowX11::ConfigureBatch::ConfigureBatch()
+{
+    GetConfigureQueue().depth++;
+}
+
+WindowX11::ConfigureBatch::~ConfigureBatch()
+{
+    ConfigureQueue& queue = GetConfigureQueue();
+    if (--queue.depth > 0 || queue.windows.empty()) {
+        return;
+    }
+    
+    std::vector<WindowX11*> windows;
+    windows.swap(queue.windows);
+    
+    // Every window's request first, then one flush per connection
+    std::vector<Display*> displays;
+    for (WindowX11* window : windows) {
+        window->SendConfigure();
+        if (std::find(displays.begin(), displays.end(), window->m_display) == displays.end()) {
+            displays.push_back(window->m_display);
+        }
+    }
+    for (Display* display : displays) {
+        XFlush(display);
     }
 }
 
@@ -162,6 +243,13 @@ void WindowX11::GetPosition(int& x, int& y) const
         return;
     }
     
+    // A move still waiting in a batch is where the window is going
+    if (m_configureMask & CWX) {
+        x = m_configure.x;
+        y = m_configure.y;
+        return;
+    }
+    
     XWindowAttributes attrs;
     XGetWindowAttributes(m_display, m_window, &attrs);
     x = attrs.x;
@@ -183,8 +271,50 @@ void WindowX11::ProcessEvents()
     while (XPending(m_display) > 0) {
         XEvent event;
         XNextEvent(m_display, &event);
+        // Motion waits for the run to end; anything else keeps its order after it
+        if (event.type != MotionNotify) {
+            DispatchMotion();
+        }
         ProcessEvent(event);
     }
+    DispatchMotion();
+}
+
+void WindowX11::SetMotionCoalescing(bool enabled)
+{
+    m_coalesceMotion = enabled;
+    if (!enabled) {
+        DispatchMotion();
+    }
+}
+
+void WindowX11::AddMotion(const PointerSample& sample)
+{
+    m_pointerHistory.Add(sample);
+    m_pendingMotion.push_back(sample);
+    if (!m_coalesceMotion) {
+        DispatchMotion();
+    }
+}
+
+void WindowX11::DispatchMotion()
+{
+    if (m_pendingMotion.empty()) {
+        return;
+    }
+    
+    // Cleared first: the callback may process events itself
+    std::vector<PointerSample> samples;
+    samples.swap(m_pendingMotion);
+    if (m_mouseMoveCallback) {
+        PointerHistory::CoalescedScope scope(samples);
+        m_mouseMoveCallback(samples.back().x, samples.back().y);
+    }
+    if (m_pendingMotion.empty()) {
+        // Keeps the capacity for the next run
+        samples.clear();
+        m_pendingMotion.swap(samples);
+    }
 }
 
 bool WindowX11::HasPendingEvents() const
@@ -202,6 +332,11 @@ void WindowX11::Invalidate()
         return;
     }
     
+    if (m_frameScheduled) {
+        m_framePending = true;
+        return;
+    }
+    
     // Send expose event to trigger repaint
     XEvent event;
     memset(&event, 0, sizeof(event));
@@ -231,11 +366,24 @@ void WindowX11::EndPaint()
     }
 }
 
+void WindowX11::RenderPendingFrame()
+{
+    if (!m_framePending) {
+        return;
+    }
+    
+    m_framePending = false;
+    if (m_paintCallback) {
+        m_paintCallback();
+    }
+}
+
 void WindowX11::ProcessEvent(XEvent& event)
 {
     switch (event.type) {
         case Expose:
             if (event.xexpose.count == 0) {
+                m_framePending = false;
                 if (m_paintCallback) {
                     m_paintCallback();
                 }
@@ -244,6 +392,7 @@ void WindowX11::ProcessEvent(XEvent& event)
             
         case ClientMessage:
             if (event.xclient.data.l[0] == static_cast<long>(m_wmDeleteWindow)) {
+                InputTrace::Record(this, InputEvent::Type::CLOSE);
                 m_shouldClose = true;
                 if (m_closeCallback) {
                     m_closeCallback();
@@ -251,16 +400,18 @@ void WindowX11::ProcessEvent(XEvent& event)
             }
             break;
             
-        case MotionNotify:
-            if (m_mouseMoveCallback) {
-                m_mouseMoveCallback(event.xmotion.x, event.xmotion.y);
-            }
+        case MotionNotify: {
+            InputTrace::Record(this, InputEvent::Type::MOUSE_MOVE, event.xmotion.x, event.xmotion.y);
+            AddMotion({ event.xmotion.x, event.xmotion.y, (uint32_t)event.xmotion.time });
             break;
+        }
             
         case ButtonPress:
         case ButtonRelease: {
             bool pressed = (event.type == ButtonPress);
             int button = event.xbutton.button;
+            InputTrace::Record(this, pressed ? InputEvent::Type::MOUSE_DOWN : InputEvent::Type::MOUSE_UP,
+                               event.xbutton.x, event.xbutton.y, button);
             if (m_mouseButtonCallback) {
                 m_mouseButtonCallback(event.xbutton.x, event.xbutton.y, button, pressed);
             }
@@ -272,6 +423,7 @@ void WindowX11::ProcessEvent(XEvent& event)
             bool pressed = (event.type == KeyPress);
             KeySym keysym = XLookupKeysym(&event.xkey, 0);
             int virtualKey = XKeyToVirtualKey(keysym);
+            InputTrace::Record(this, pressed ? InputEvent::Type::KEY_DOWN : InputEvent::Type::KEY_UP, 0, 0, virtualKey);
             if (m_keyCallback) {
                 m_keyCallback(virtualKey, pressed);
             }
@@ -279,12 +431,78 @@ void WindowX11::ProcessEvent(XEvent& event)
         }
         
         case ConfigureNotify:
+            InputTrace::Record(this, InputEvent::Type::RESIZE, event.xconfigure.width, event.xconfigure.height);
             m_width = event.xconfigure.width;
             m_height = event.xconfigure.height;
             break;
     }
 }
 
+void WindowX11::ReplayEvent(const InputEvent& event)
+{
+    if (event.type != InputEvent::Type::MOUSE_MOVE) {
+        DispatchMotion();
+    }
+    
+    switch (event.type) {
+        case InputEvent::Type::MOUSE_MOVE:
+            InputTrace::Record(this, event.type, event.x, event.y);
+            AddMotion({ event.x, event.y, event.time });
+            break;
+            
+        case InputEvent::Type::MOUSE_DOWN:
+        case InputEvent::Type::MOUSE_UP:
+            InputTrace::Record(this, event.type, event.x, event.y, event.value);
+            if (m_mouseButtonCallback) {
+                m_mouseButtonCallback(event.x, event.y, event.value, event.type == InputEvent::Type::MOUSE_DOWN);
+            }
+            break;
+            
+        case InputEvent::Type::MOUSE_WHEEL:
+            // From a Windows trace: X reports the wheel as a click of button 4 (up) or 5
+            InputTrace::Record(this, event.type, event.x, event.y, event.value);
+            if (m_mouseButtonCallback && event.value != 0) {
+                int button = event.value > 0 ? 4 : 5;
+                m_mouseButtonCallback(event.x, event.y, button, true);
+                m_mouseButtonCallback(event.x, event.y, button, false);
+            }
+            break;
+            
+        case InputEvent::Type::KEY_DOWN:
+        case InputEvent::Type::KEY_UP:
+            InputTrace::Record(this, event.type, 0, 0, event.value);
+            if (m_keyCallback) {
+                m_keyCallback(event.value, event.type == InputEvent::Type::KEY_DOWN);
+            }
+            break;
+            
+        case InputEvent::Type::RESIZE:
+            InputTrace::Record(this, event.type, event.x, event.y);
+            m_width = event.x;
+            m_height = event.y;
+            m_framePending = true;
+            break;
+            
+        case InputEvent::Type::CLOSE:
+            InputTrace::Record(this, event.type);
+            m_shouldClose = true;
+            if (m_closeCallback) {
+                m_closeCallback();
+            }
+            break;
+            
+        default:
+            // No character callback here
+            break;
+    }
+}
+
+void WindowX11::ReplayFrame()
+{
+    DispatchMotion();
+    RenderPendingFrame();
+}
+
 int WindowX11::XKeyToVirtualKey(KeySym keysym)
 {
     // Map X11 keysyms to Windows virtual key codes for compatibility
@@ -298,23 +516,45 @@ int WindowX11::XKeyToVirtualKey(KeySym keysym)
     if (keysym >= XK_0 && keysym <= XK_9) {
         return '0' + (keysym - XK_0);
     }
+    if (keysym >= XK_F1 && keysym <= XK_F12) {
+        return VK_F1 + (keysym - XK_F1);
+    }
     
     switch (keysym) {
-        case XK_Return: return 0x0D; // VK_RETURN
-        case XK_Escape: return 0x1B; // VK_ESCAPE
-        case XK_BackSpace: return 0x08; // VK_BACK
-        case XK_Tab: return 0x09; // VK_TAB
-        case XK_space: return 0x20; // VK_SPACE
-        case XK_Left: return 0x25; // VK_LEFT
-        case XK_Up: return 0x26; // VK_UP
-        case XK_Right: return 0x27; // VK_RIGHT
-        case XK_Down: return 0x28; // VK_DOWN
+        case XK_Return: return VK_RETURN;
+        case XK_Escape: return VK_ESCAPE;
+        case XK_BackSpace: return VK_BACK;
+        case XK_Tab: return VK_TAB;
+        case XK_space: return VK_SPACE;
+        case XK_Prior: return VK_PRIOR;
+        case XK_Next: return VK_NEXT;
+        case XK_End: return VK_END;
+        case XK_Home: return VK_HOME;
+        case XK_Left: return VK_LEFT;
+        case XK_Up: return VK_UP;
+        case XK_Right: return VK_RIGHT;
+        case XK_Down: return VK_DOWN;
+        case XK_Delete: return VK_DELETE;
         default: return 0;
     }
 }
 
 // X11WindowManager implementation
 
+X11WindowManager::X11WindowManager()
+    : m_shouldQuit(false)
+    , m_nextTimerId(1)
+    , m_wakeFd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+{
+}
+
+X11WindowManager::~X11WindowManager()
+{
+    if (m_wakeFd >= 0) {
+        close(m_wakeFd);
+    }
+}
+
 X11WindowManager& X11WindowManager::GetInstance()
 {
     static X11WindowManager instance;
@@ -324,6 +564,7 @@ X11WindowManager& X11WindowManager::GetInstance()
 std::shared_ptr<WindowX11> X11WindowManager::CreateWindow(const std::wstring& title, int x, int y, int width, int height)
 {
     auto window = std::make_shared<WindowX11>();
+    window->SetFrameScheduled(true);
     if (window->Create(title, x, y, width, height)) {
         m_windows.push_back(window);
         return window;
@@ -349,6 +590,215 @@ void X11WindowManager::RunEventLoop()
 {
     while (!m_shouldQuit && !m_windows.empty()) {
         ProcessEvents();
+        RunPosted();
+        RunTimers();
+        if (!m_shouldQuit && !RunFrame()) {
+            WaitForEvents();
+        }
+    }
+}
+
+bool X11WindowManager::RunFrame()
+{
+    bool pending = false;
+    for (auto& window : m_windows) {
+        pending = pending || (window && window->IsValid() && window->HasPendingFrame());
+    }
+    if (!pending) {
+        return false;
+    }
+    
+    // No Present extension here, so the clock paces on its timer grid
+    m_frameClock.BeginFrame();
+    int rendered = 0;
+    int skipped = 0;
+    for (size_t i = 0; i < m_windows.size(); i++) {
+        auto window = m_windows[i];
+        if (!window || !window->IsValid()) {
+            continue;
+        }
+        if (window->HasPendingFrame()) {
+            window->RenderPendingFrame();
+            rendered++;
+        } else {
+            skipped++;
+        }
+    }
+    FrameArena::EndFrame();
+    m_frameClock.EndFrame(rendered, skipped);
+    return true;
+}
+
+InputTrace::ReplayStats X11WindowManager::Replay(const InputTrace& trace,
+                                                 const std::vector<std::shared_ptr<WindowX11>>& windows,
+                                                 double frameRate)
+{
+    auto dispatch = [&windows](const InputEvent& event) {
+        if (event.window < windows.size() && windows[event.window] && windows[event.window]->IsValid()) {
+            windows[event.window]->ReplayEvent(event);
+        }
+    };
+    auto frame = [&windows](double, float) {
+        for (auto& window : windows) {
+            if (window && window->IsValid()) {
+                window->ReplayFrame();
+            }
+        }
+        FrameArena::EndFrame();
+    };
+    return trace.Replay(dispatch, frame, frameRate);
+}
+
+void X11WindowManager::WaitForEvents()
+{
+    // Events Xlib has already read won't wake poll(); XPending also flushes
+    // our own requests so replies can arrive
+    FrameArena::Scope scratch;
+    FrameVector<pollfd> fds(FrameArena::GetResource());
+    for (auto& window : m_windows) {
+        if (!window || !window->IsValid()) {
+            continue;
+        }
+        if (XPending(window->GetDisplay()) > 0) {
+            return;
+        }
+        pollfd fd = {};
+        fd.fd = ConnectionNumber(window->GetDisplay());
+        fd.events = POLLIN;
+        fds.push_back(fd);
+    }
+    if (m_wakeFd >= 0) {
+        pollfd fd = {};
+        fd.fd = m_wakeFd;
+        fd.events = POLLIN;
+        fds.push_back(fd);
+    }
+    if (fds.empty()) {
+        return;
+    }
+    
+    // Sleep until input, a wakeup or the nearest timer
+    int timeoutMs = -1;
+    if (!m_timers.empty()) {
+        auto due = m_timers[0].due;
+        for (const auto& timer : m_timers) {
+            due = std::min(due, timer.due);
+        }
+        auto remaining = due - std::chrono::steady_clock::now();
+        // Round up so the timer is due when poll returns
+        auto ms = std::chrono::ceil<std::chrono::milliseconds>(remaining);
+        timeoutMs = (int)std::max<long long>(0, ms.count());
+    }
+    if (m_wakeFd < 0 && timeoutMs < 0) {
+        // Without an eventfd, Quit() and Post() are picked up at the refresh rate
+        timeoutMs = (int)(1000.0 / m_frameClock.GetRefreshRate()) + 1;
+    }
+    
+    if (poll(fds.data(), fds.size(), timeoutMs) > 0 && m_wakeFd >= 0 && (fds.back().revents & POLLIN)) {
+        uint64_t count;
+        ssize_t ignored = read(m_wakeFd, &count, sizeof(count));
+        (void)ignored;
+    }
+}
+
+int X11WindowManager::SetTimer(int intervalMs, Callback callback, bool repeat)
+{
+    if (!callback) {
+        return 0;
+    }
+    
+    Timer timer;
+    timer.id = m_nextTimerId++;
+    if (m_nextTimerId <= 0) {
+        m_nextTimerId = 1;
+    }
+    // A zero repeat interval would keep the loop from ever sleeping
+    timer.interval = std::chrono::milliseconds(std::max(repeat ? 1 : 0, intervalMs));
+    timer.due = std::chrono::steady_clock::now() + timer.interval;
+    timer.callback = std::move(callback);
+    timer.repeat = repeat;
+    m_timers.push_back(std::move(timer));
+    return m_timers.back().id;
+}
+
+void X11WindowManager::KillTimer(int id)
+{
+    m_timers.erase(
+        std::remove_if(m_timers.begin(), m_timers.end(),
+            [id](const Timer& timer) { return timer.id == id; }),
+        m_timers.end()
+    );
+}
+
+void X11WindowManager::RunTimers()
+{
+    auto now = std::chrono::steady_clock::now();
+    std::vector<int> due;
+    for (const auto& timer : m_timers) {
+        if (timer.due <= now) {
+            due.push_back(timer.id);
+        }
+    }
+    
+    // Callbacks may set or kill timers, so look each one up again
+    for (int id : due) {
+        auto it = std::find_if(m_timers.begin(), m_timers.end(),
+            [id](const Timer& timer) { return timer.id == id; });
+        if (it == m_timers.end()) {
+            continue;
+        }
+        
+        Callback callback = it->callback;
+        if (it->repeat) {
+            // Skip missed ticks rather than firing them back to back
+            it->due += it->interval;
+            if (it->due <= now) {
+                it->due = now + it->interval;
+            }
+        } else {
+            m_timers.erase(it);
+        }
+        callback();
+    }
+}
+
+void X11WindowManager::Post(Callback callback)
+{
+    if (!callback) {
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(m_postMutex);
+        m_posted.push_back(std::move(callback));
+    }
+    Wake();
+}
+
+void X11WindowManager::RunPosted()
+{
+    std::vector<Callback> posted;
+    {
+        std::lock_guard<std::mutex> lock(m_postMutex);
+        posted.swap(m_posted);
+    }
+    for (auto& callback : posted) {
+        callback();
+    }
+}
+
+void X11WindowManager::Quit()
+{
+    m_shouldQuit = true;
+    Wake();
+}
+
+void X11WindowManager::Wake()
+{
+    if (m_wakeFd >= 0) {
+        uint64_t one = 1;
+        ssize_t ignored = write(m_wakeFd, &one, sizeof(one));
+        (void)ignored;
     }
 }
 
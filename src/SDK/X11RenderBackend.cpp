@@ -3,13 +3,200 @@
 #if SDK_PLATFORM_LINUX && SDK_HAS_X11
 
 #include "SDK/StringUtils.h"
+#include "SDK/PixelKernels.h"
+#include "SDK/EffectGraph.h"
+#include "SDK/ShadowCache.h"
+#include "SDK/TextureAtlas.h"
+#include "SDK/RenderCommandList.h"
+#include "SDK/XftFontSource.h"
 #include <cmath>
 #include <cstring>
 #include <algorithm>
 #include <locale>
+#include <vector>
+
+#ifndef SDK_HAS_XSHM
+#define SDK_HAS_XSHM 0
+#endif
+#ifndef SDK_HAS_XRENDER
+#define SDK_HAS_XRENDER 0
+#endif
+#ifndef SDK_HAS_XFT
+#define SDK_HAS_XFT 0
+#endif
+
+// Atlas glyphs are composited through XRender; without it core fonts draw text
+#define SDK_X11_ATLAS_TEXT (SDK_HAS_XFT && SDK_HAS_XRENDER)
+
+#if SDK_HAS_XSHM
+#include <X11/extensions/XShm.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#endif
+#if SDK_HAS_XRENDER
+#include <X11/extensions/Xrender.h>
+#endif
 
 namespace SDK {
 
+struct X11Acceleration {
+    Visual* visual = nullptr;
+    int depth = 0;
+    
+#if SDK_HAS_XSHM
+    bool shmSupported = false;
+    bool shmAttached = false;
+    XShmSegmentInfo shm = {};
+    size_t shmSize = 0;                 // Covers the whole back buffer at 32 bpp
+#endif
+    
+#if SDK_HAS_XRENDER
+    bool renderSupported = false;
+    bool gradients = false;             // Render 0.10 gradient pictures
+    XRenderPictFormat* argbFormat = nullptr;
+    XRenderPictFormat* maskFormat = nullptr;    // A8 coverage for antialiased edges
+    Picture backPicture = 0;
+    
+    // 1x1 repeating source, refilled per draw; works on every Render version
+    Pixmap solidPixmap = 0;
+    Picture solidPicture = 0;
+    
+    // Atlas pixels mirrored into a 32-bit pixmap, refreshed by version
+    Pixmap atlasPixmap = 0;
+    Picture atlasPicture = 0;
+    const TextureAtlas* atlas = nullptr;
+    uint64_t atlasVersion = 0;
+#endif
+};
+
+struct X11Text {
+#if SDK_X11_ATLAS_TEXT
+    std::unique_ptr<XftFontSource> fonts;   // Declared before the atlas, which calls into it
+    std::unique_ptr<GlyphAtlas> atlas;
+    
+    // A8 mirror of the atlas coverage, the mask for every glyph composite
+    Pixmap atlasPixmap = 0;
+    Picture atlasPicture = 0;
+    GC atlasGC = nullptr;
+#endif
+};
+
+namespace {
+#if SDK_HAS_XSHM
+    // XShmAttach fails asynchronously (e.g. a remote display); trap the error
+    bool g_shmAttachFailed = false;
+    
+    int TrapShmError(Display*, XErrorEvent*)
+    {
+        g_shmAttachFailed = true;
+        return 0;
+    }
+#endif
+    
+#if SDK_HAS_XRENDER
+    // Fills take premultiplied colors
+    XRenderColor ToPremultiplied(const Color& color)
+    {
+        XRenderColor out;
+        out.red = (unsigned short)(color.r * color.a * 65535 / (255 * 255));
+        out.green = (unsigned short)(color.g * color.a * 65535 / (255 * 255));
+        out.blue = (unsigned short)(color.b * color.a * 65535 / (255 * 255));
+        out.alpha = (unsigned short)(color.a * 257);
+        return out;
+    }
+    
+    // Gradient stops take straight colors
+    XRenderColor ToStraight(const Color& color)
+    {
+        XRenderColor out;
+        out.red = (unsigned short)(color.r * 257);
+        out.green = (unsigned short)(color.g * 257);
+        out.blue = (unsigned short)(color.b * 257);
+        out.alpha = (unsigned short)(color.a * 257);
+        return out;
+    }
+    
+    int ArcSegments(double radius)
+    {
+        return std::max(4, std::min(32, (int)(radius / 2)));
+    }
+    
+    // Quarter arc from startAngle, counter-clockwise in screen space
+    void AppendArc(std::vector<XPointDouble>& points, double cx, double cy, double rx, double ry, double startAngle)
+    {
+        int segments = ArcSegments(std::max(rx, ry));
+        for (int i = 0; i <= segments; i++) {
+            double angle = startAngle + (M_PI / 2) * i / segments;
+            points.push_back(XPointDouble{ cx + rx * std::cos(angle), cy - ry * std::sin(angle) });
+        }
+    }
+    
+    // Outline of a rounded rect, counter-clockwise on screen from the top of the
+    // top-left corner; every outline here winds the same way so rings work
+    void AppendRoundedRect(std::vector<XPointDouble>& points, double left, double top, double right, double bottom, double radius)
+    {
+        radius = std::max(0.0, std::min(radius, std::min(right - left, bottom - top) / 2));
+        if (radius <= 0) {
+            points.push_back(XPointDouble{ left, top });
+            points.push_back(XPointDouble{ left, bottom });
+            points.push_back(XPointDouble{ right, bottom });
+            points.push_back(XPointDouble{ right, top });
+            return;
+        }
+        AppendArc(points, left + radius, top + radius, radius, radius, M_PI / 2);
+        AppendArc(points, left + radius, bottom - radius, radius, radius, M_PI);
+        AppendArc(points, right - radius, bottom - radius, radius, radius, M_PI * 3 / 2);
+        AppendArc(points, right - radius, top + radius, radius, radius, 0);
+    }
+    
+    void AppendEllipse(std::vector<XPointDouble>& points, double cx, double cy, double rx, double ry)
+    {
+        for (int quarter = 0; quarter < 4; quarter++) {
+            AppendArc(points, cx, cy, rx, ry, quarter * M_PI / 2);
+        }
+    }
+    
+    // Outer outline, a zero-width bridge, then the inner outline backwards, so a
+    // single polygon covers only the ring between them
+    void MakeRing(std::vector<XPointDouble>& ring, const std::vector<XPointDouble>& outer, const std::vector<XPointDouble>& inner)
+    {
+        ring = outer;
+        ring.push_back(outer.front());
+        ring.push_back(inner.front());
+        ring.insert(ring.end(), inner.rbegin(), inner.rend());
+        ring.push_back(inner.front());
+    }
+#endif
+}
+
+#if SDK_X11_ATLAS_TEXT
+namespace {
+    constexpr int GLYPH_ATLAS_WIDTH = 1024;
+    constexpr int GLYPH_ATLAS_HEIGHT = 512;
+}
+#endif
+
+#if SDK_HAS_XRENDER
+namespace {
+    Picture SolidSource(Display* display, X11Acceleration& accel, const Color& color)
+    {
+        XRenderColor fill = ToPremultiplied(color);
+        XRenderFillRectangle(display, PictOpSrc, accel.solidPicture, &fill, 0, 0, 1, 1);
+        return accel.solidPicture;
+    }
+    
+    void FillPolygon(Display* display, X11Acceleration& accel, const std::vector<XPointDouble>& points, const Color& color)
+    {
+        if (points.size() < 3) {
+            return;
+        }
+        Picture source = SolidSource(display, accel, color);
+        XRenderCompositeDoublePoly(display, PictOpOver, source, accel.backPicture, accel.maskFormat,
+            0, 0, 0, 0, points.data(), (int)points.size(), 1);
+    }
+}
+#endif
+
 X11RenderBackend::X11RenderBackend()
     : m_display(nullptr)
     , m_window(0)
@@ -18,6 +205,9 @@ X11RenderBackend::X11RenderBackend()
     , m_backBuffer(0)
     , m_width(0)
     , m_height(0)
+    , m_accel(new X11Acceleration())
+    , m_text(new X11Text())
+    , m_extensionsEnabled(true)
     , m_initialized(false)
 {
 }
@@ -58,6 +248,7 @@ bool X11RenderBackend::Initialize(HWND hwnd)
         
         // Create back buffer
         m_backBuffer = XCreatePixmap(m_display, m_window, m_width, m_height, attrs.depth);
+        AttachSurfaces(attrs.visual, attrs.depth);
     }
     
     m_initialized = true;
@@ -78,6 +269,16 @@ void X11RenderBackend::Shutdown()
     }
     m_fontCache.clear();
     
+#if SDK_X11_ATLAS_TEXT
+    X11Text& text = *m_text;
+    if (text.atlasPicture) XRenderFreePicture(m_display, text.atlasPicture);
+    if (text.atlasPixmap) XFreePixmap(m_display, text.atlasPixmap);
+    if (text.atlasGC) XFreeGC(m_display, text.atlasGC);
+    *m_text = X11Text();    // Closes the fonts
+#endif
+    
+    ReleaseSurfaces();
+    
     // Free back buffer
     if (m_backBuffer && m_display) {
         XFreePixmap(m_display, m_backBuffer);
@@ -99,6 +300,152 @@ void X11RenderBackend::Shutdown()
     m_initialized = false;
 }
 
+void X11RenderBackend::AttachSurfaces(Visual* visual, int depth)
+{
+    X11Acceleration& accel = *m_accel;
+    accel.visual = visual;
+    accel.depth = depth;
+    if (!m_extensionsEnabled || !m_backBuffer || m_width <= 0 || m_height <= 0) {
+        return;
+    }
+    
+#if SDK_HAS_XSHM
+    accel.shmSupported = XShmQueryExtension(m_display) == True;
+    if (accel.shmSupported) {
+        accel.shmSize = (size_t)m_width * m_height * 4;
+        accel.shm.shmid = shmget(IPC_PRIVATE, accel.shmSize, IPC_CREAT | 0600);
+        accel.shm.shmaddr = accel.shm.shmid >= 0 ? (char*)shmat(accel.shm.shmid, nullptr, 0) : (char*)-1;
+        if (accel.shm.shmaddr != (char*)-1) {
+            accel.shm.readOnly = False;
+            g_shmAttachFailed = false;
+            XSync(m_display, False);
+            XErrorHandler previous = XSetErrorHandler(TrapShmError);
+            Status attached = XShmAttach(m_display, &accel.shm);
+            XSync(m_display, False);
+            XSetErrorHandler(previous);
+            accel.shmAttached = attached && !g_shmAttachFailed;
+            if (!accel.shmAttached) {
+                shmdt(accel.shm.shmaddr);
+            }
+        }
+        // Marked for removal now; it goes away once both sides detach
+        if (accel.shm.shmid >= 0) {
+            shmctl(accel.shm.shmid, IPC_RMID, nullptr);
+        }
+        if (!accel.shmAttached) {
+            accel.shm = XShmSegmentInfo();
+            accel.shmSize = 0;
+        }
+    }
+#endif
+    
+#if SDK_HAS_XRENDER
+    int eventBase, errorBase;
+    int major = 0, minor = 0;
+    accel.renderSupported = XRenderQueryExtension(m_display, &eventBase, &errorBase) &&
+        XRenderQueryVersion(m_display, &major, &minor);
+    XRenderPictFormat* format = accel.renderSupported ? XRenderFindVisualFormat(m_display, visual) : nullptr;
+    accel.argbFormat = accel.renderSupported ? XRenderFindStandardFormat(m_display, PictStandardARGB32) : nullptr;
+    accel.maskFormat = accel.renderSupported ? XRenderFindStandardFormat(m_display, PictStandardA8) : nullptr;
+    if (!format || !accel.argbFormat || !accel.maskFormat) {
+        accel.renderSupported = false;
+        return;
+    }
+    accel.gradients = major > 0 || minor >= 10;
+    accel.backPicture = XRenderCreatePicture(m_display, m_backBuffer, format, 0, nullptr);
+    
+    XRenderPictureAttributes repeat = {};
+    repeat.repeat = RepeatNormal;
+    accel.solidPixmap = XCreatePixmap(m_display, m_window, 1, 1, 32);
+    accel.solidPicture = XRenderCreatePicture(m_display, accel.solidPixmap, accel.argbFormat, CPRepeat, &repeat);
+#endif
+}
+
+void X11RenderBackend::ReleaseSurfaces()
+{
+    if (!m_display) {
+        return;
+    }
+    X11Acceleration& accel = *m_accel;
+    (void)accel;
+    
+#if SDK_HAS_XSHM
+    if (accel.shmAttached) {
+        XShmDetach(m_display, &accel.shm);
+        XSync(m_display, False);
+        shmdt(accel.shm.shmaddr);
+        accel.shm = XShmSegmentInfo();
+        accel.shmAttached = false;
+        accel.shmSize = 0;
+    }
+#endif
+    
+#if SDK_HAS_XRENDER
+    if (accel.atlasPicture) XRenderFreePicture(m_display, accel.atlasPicture);
+    if (accel.atlasPixmap) XFreePixmap(m_display, accel.atlasPixmap);
+    if (accel.solidPicture) XRenderFreePicture(m_display, accel.solidPicture);
+    if (accel.solidPixmap) XFreePixmap(m_display, accel.solidPixmap);
+    if (accel.backPicture) XRenderFreePicture(m_display, accel.backPicture);
+    accel.atlasPicture = 0;
+    accel.atlasPixmap = 0;
+    accel.atlas = nullptr;
+    accel.atlasVersion = 0;
+    accel.solidPicture = 0;
+    accel.solidPixmap = 0;
+    accel.backPicture = 0;
+    accel.renderSupported = false;
+#endif
+}
+
+void X11RenderBackend::SetExtensionsEnabled(bool enabled)
+{
+    if (enabled == m_extensionsEnabled) {
+        return;
+    }
+    m_extensionsEnabled = enabled;
+    if (m_initialized && m_backBuffer) {
+        ReleaseSurfaces();
+        AttachSurfaces(m_accel->visual, m_accel->depth);
+    }
+}
+
+bool X11RenderBackend::IsRenderActive() const
+{
+#if SDK_HAS_XRENDER
+    return m_accel->backPicture != 0;
+#else
+    return false;
+#endif
+}
+
+bool X11RenderBackend::IsShmActive() const
+{
+#if SDK_HAS_XSHM
+    return m_accel->shmAttached;
+#else
+    return false;
+#endif
+}
+
+bool X11RenderBackend::IsAtlasTextActive() const
+{
+#if SDK_X11_ATLAS_TEXT
+    return IsRenderActive();
+#else
+    return false;
+#endif
+}
+
+GlyphAtlas::Stats X11RenderBackend::GetTextStats() const
+{
+#if SDK_X11_ATLAS_TEXT
+    if (m_text->atlas) {
+        return m_text->atlas->GetStats();
+    }
+#endif
+    return GlyphAtlas::Stats();
+}
+
 bool X11RenderBackend::BeginDraw()
 {
     if (!m_initialized || !m_display) {
@@ -116,12 +463,16 @@ bool X11RenderBackend::BeginDraw()
         m_width = attrs.width;
         m_height = attrs.height;
         
+        ReleaseSurfaces();
         if (m_backBuffer) {
             XFreePixmap(m_display, m_backBuffer);
         }
         m_backBuffer = XCreatePixmap(m_display, m_window, m_width, m_height, attrs.depth);
+        AttachSurfaces(attrs.visual, attrs.depth);
     }
     
+    // Text converted last frame is no longer referenced
+    UTF8Scratch::Reset();
     return true;
 }
 
@@ -166,6 +517,25 @@ void X11RenderBackend::DrawRectangle(const RECT& rect, Color fillColor, Color bo
     int width = rect.right - rect.left;
     int height = rect.bottom - rect.top;
     
+#if SDK_HAS_XRENDER
+    if (m_accel->backPicture) {
+        if (fillColor.a > 0 && width > 0 && height > 0) {
+            XRenderColor fill = ToPremultiplied(fillColor);
+            XRenderFillRectangle(m_display, PictOpOver, m_accel->backPicture, &fill, rect.left, rect.top, width, height);
+        }
+        if (borderColor.a > 0 && borderWidth > 0) {
+            // Centered on the edges, like XDrawRectangle
+            double half = borderWidth / 2.0;
+            std::vector<XPointDouble> outer, inner, ring;
+            AppendRoundedRect(outer, rect.left - half, rect.top - half, rect.right + half, rect.bottom + half, 0);
+            AppendRoundedRect(inner, rect.left + half, rect.top + half, rect.right - half, rect.bottom - half, 0);
+            MakeRing(ring, outer, inner);
+            FillPolygon(m_display, *m_accel, ring, borderColor);
+        }
+        return;
+    }
+#endif
+    
     // Fill if needed
     if (fillColor.a > 0) {
         SetGCColor(fillColor);
@@ -196,6 +566,25 @@ void X11RenderBackend::DrawRoundedRectangle(const RECT& rect, float radius, Colo
     int maxRadius = std::min(width, height) / 2;
     r = std::min(r, maxRadius);
     
+#if SDK_HAS_XRENDER
+    if (m_accel->backPicture) {
+        if (fillColor.a > 0) {
+            std::vector<XPointDouble> outline;
+            AppendRoundedRect(outline, x, y, x + width, y + height, radius);
+            FillPolygon(m_display, *m_accel, outline, fillColor);
+        }
+        if (borderColor.a > 0 && borderWidth > 0) {
+            double half = borderWidth / 2.0;
+            std::vector<XPointDouble> outer, inner, ring;
+            AppendRoundedRect(outer, x - half, y - half, x + width + half, y + height + half, radius + half);
+            AppendRoundedRect(inner, x + half, y + half, x + width - half, y + height - half, std::max(0.0, radius - half));
+            MakeRing(ring, outer, inner);
+            FillPolygon(m_display, *m_accel, ring, borderColor);
+        }
+        return;
+    }
+#endif
+    
     // Fill if needed
     if (fillColor.a > 0) {
         SetGCColor(fillColor);
@@ -237,6 +626,25 @@ void X11RenderBackend::DrawLine(int x1, int y1, int x2, int y2, Color color, flo
         return;
     }
     
+#if SDK_HAS_XRENDER
+    if (m_accel->backPicture) {
+        double dx = x2 - x1;
+        double dy = y2 - y1;
+        double length = std::sqrt(dx * dx + dy * dy);
+        if (length <= 0 || color.a == 0) {
+            return;
+        }
+        // Quad around the segment, half the width to each side
+        double nx = -dy / length * std::max(1.0f, width) / 2;
+        double ny = dx / length * std::max(1.0f, width) / 2;
+        std::vector<XPointDouble> quad = {
+            { x1 + nx, y1 + ny }, { x2 + nx, y2 + ny }, { x2 - nx, y2 - ny }, { x1 - nx, y1 - ny }
+        };
+        FillPolygon(m_display, *m_accel, quad, color);
+        return;
+    }
+#endif
+    
     SetGCColor(color);
     XSetLineAttributes(m_display, m_gc, width, LineSolid, CapRound, JoinRound);
     XDrawLine(m_display, m_backBuffer, m_gc, x1, y1, x2, y2);
@@ -248,6 +656,25 @@ void X11RenderBackend::DrawEllipse(int cx, int cy, int rx, int ry, Color fillCol
         return;
     }
     
+#if SDK_HAS_XRENDER
+    if (m_accel->backPicture) {
+        if (fillColor.a > 0 && rx > 0 && ry > 0) {
+            std::vector<XPointDouble> outline;
+            AppendEllipse(outline, cx, cy, rx, ry);
+            FillPolygon(m_display, *m_accel, outline, fillColor);
+        }
+        if (borderColor.a > 0 && borderWidth > 0) {
+            double half = borderWidth / 2.0;
+            std::vector<XPointDouble> outer, inner, ring;
+            AppendEllipse(outer, cx, cy, rx + half, ry + half);
+            AppendEllipse(inner, cx, cy, std::max(0.0, rx - half), std::max(0.0, ry - half));
+            MakeRing(ring, outer, inner);
+            FillPolygon(m_display, *m_accel, ring, borderColor);
+        }
+        return;
+    }
+#endif
+    
     // Fill if needed
     if (fillColor.a > 0) {
         SetGCColor(fillColor);
@@ -275,6 +702,12 @@ void X11RenderBackend::DrawText(const std::wstring& text, const RECT& rect, Colo
         return;
     }
     
+    int ascent, descent;
+    if (const GlyphAtlas::Run* run = LayoutText(text, fontFamily, fontSize, fontWeight, ascent, descent)) {
+        DrawRun(*run, rect.left + 5, rect.top + ascent + 5, color);
+        return;
+    }
+    
     SetGCColor(color);
     
     // Get or create font
@@ -283,13 +716,71 @@ void X11RenderBackend::DrawText(const std::wstring& text, const RECT& rect, Colo
         XSetFont(m_display, m_gc, font->fid);
     }
     
-    // Convert wstring to UTF-8
-    std::string utf8Text = WStringToUTF8(text);
+    std::string_view utf8Text = UTF8Scratch::Convert(text);
     
     // Draw text
     int x = rect.left + 5; // Small padding
     int y = rect.top + static_cast<int>(fontSize) + 5; // Baseline position
-    XDrawString(m_display, m_backBuffer, m_gc, x, y, utf8Text.c_str(), utf8Text.length());
+    XDrawString(m_display, m_backBuffer, m_gc, x, y, utf8Text.data(), static_cast<int>(utf8Text.size()));
+}
+
+void X11RenderBackend::DrawTextLine(const std::wstring& text, const RECT& rect, Color color,
+                                      const std::wstring& fontFamily, float fontSize, int fontWeight, TextAlign align)
+{
+    if (!m_initialized || !m_display || !m_backBuffer || !m_gc || text.empty()) {
+        return;
+    }
+    
+    int ascent, descent;
+    if (const GlyphAtlas::Run* run = LayoutText(text, fontFamily, fontSize, fontWeight, ascent, descent)) {
+        int x = rect.left;
+        if (align == TextAlign::CENTER) {
+            x += (rect.right - rect.left - run->width) / 2;
+        } else if (align == TextAlign::RIGHT) {
+            x = rect.right - run->width;
+        }
+        DrawRun(*run, x, (rect.top + rect.bottom + ascent - descent) / 2, color);
+        return;
+    }
+    
+    XFontStruct* font = GetOrCreateFont(static_cast<int>(fontSize));
+    if (!font) {
+        RenderBackend::DrawTextLine(text, rect, color, fontFamily, fontSize, fontWeight, align);
+        return;
+    }
+    
+    SetGCColor(color);
+    XSetFont(m_display, m_gc, font->fid);
+    
+    std::string_view utf8Text = UTF8Scratch::Convert(text);
+    int width = XTextWidth(font, utf8Text.data(), static_cast<int>(utf8Text.size()));
+    
+    int x = rect.left;
+    if (align == TextAlign::CENTER) {
+        x += (rect.right - rect.left - width) / 2;
+    } else if (align == TextAlign::RIGHT) {
+        x = rect.right - width;
+    }
+    
+    // Center the font's ascent + descent box on the rect
+    int y = (rect.top + rect.bottom + font->ascent - font->descent) / 2;
+    XDrawString(m_display, m_backBuffer, m_gc, x, y, utf8Text.data(), static_cast<int>(utf8Text.size()));
+}
+
+int X11RenderBackend::MeasureText(const std::wstring& text, const std::wstring& fontFamily, float fontSize, int fontWeight)
+{
+    int ascent, descent;
+    if (const GlyphAtlas::Run* run = LayoutText(text, fontFamily, fontSize, fontWeight, ascent, descent)) {
+        return run->width;
+    }
+    
+    XFontStruct* font = m_display ? GetOrCreateFont(static_cast<int>(fontSize)) : nullptr;
+    if (!font) {
+        return RenderBackend::MeasureText(text, fontFamily, fontSize, fontWeight);
+    }
+    
+    std::string_view utf8Text = UTF8Scratch::Convert(text);
+    return XTextWidth(font, utf8Text.data(), static_cast<int>(utf8Text.size()));
 }
 
 void X11RenderBackend::DrawLinearGradient(const RECT& rect, Color startColor, Color endColor, bool horizontal)
@@ -306,6 +797,23 @@ void X11RenderBackend::DrawLinearGradient(const RECT& rect, Color startColor, Co
         return;
     }
     
+#if SDK_HAS_XRENDER
+    if (m_accel->backPicture && m_accel->gradients && height > 0 && width > 0) {
+        XLinearGradient line;
+        line.p1.x = XDoubleToFixed(rect.left);
+        line.p1.y = XDoubleToFixed(rect.top);
+        line.p2.x = XDoubleToFixed(horizontal ? rect.right : rect.left);
+        line.p2.y = XDoubleToFixed(horizontal ? rect.top : rect.bottom);
+        XFixed stops[2] = { XDoubleToFixed(0), XDoubleToFixed(1) };
+        XRenderColor colors[2] = { ToStraight(startColor), ToStraight(endColor) };
+        Picture gradient = XRenderCreateLinearGradient(m_display, &line, stops, colors, 2);
+        XRenderComposite(m_display, PictOpOver, gradient, None, m_accel->backPicture,
+            rect.left, rect.top, 0, 0, rect.left, rect.top, width, height);
+        XRenderFreePicture(m_display, gradient);
+        return;
+    }
+#endif
+    
     // Draw gradient as series of lines
     for (int i = 0; i < steps; i++) {
         float t = static_cast<float>(i) / static_cast<float>(steps);
@@ -357,6 +865,49 @@ void X11RenderBackend::DrawRadialGradient(const RECT& rect, Color centerColor, C
         return;
     }
     
+#if SDK_HAS_XRENDER
+    if (m_accel->backPicture && m_accel->gradients && rectWidth > 0 && rectHeight > 0) {
+        XRadialGradient circles;
+        circles.inner.x = circles.outer.x = XDoubleToFixed(gradientCx);
+        circles.inner.y = circles.outer.y = XDoubleToFixed(gradientCy);
+        circles.inner.radius = 0;
+        circles.outer.radius = XDoubleToFixed(maxRadius);
+        XFixed stops[2] = { XDoubleToFixed(0), XDoubleToFixed(1) };
+        XRenderColor colors[2] = { ToStraight(centerColor), ToStraight(edgeColor) };
+        Picture gradient = XRenderCreateRadialGradient(m_display, &circles, stops, colors, 2);
+        XRenderComposite(m_display, PictOpOver, gradient, None, m_accel->backPicture,
+            rect.left, rect.top, 0, 0, rect.left, rect.top, rectWidth, rectHeight);
+        XRenderFreePicture(m_display, gradient);
+        return;
+    }
+#endif
+    
+    // One pass over the pixels is fewer requests than a stack of arcs
+    bool drawn = WithBackBufferPixels(rect, [&](uint32_t* pixels, int left, int top, int width, int height, int stride) {
+        float inverseRadius = 1.0f / (float)maxRadius;
+        for (int y = 0; y < height; y++) {
+            uint32_t* row = pixels + (size_t)y * stride;
+            float dy = (float)(top + y - gradientCy);
+            for (int x = 0; x < width; x++) {
+                float dx = (float)(left + x - gradientCx);
+                float t = std::min(1.0f, std::sqrt(dx * dx + dy * dy) * inverseRadius);
+                int a = (int)(centerColor.a + t * (edgeColor.a - centerColor.a));
+                int r = (int)(centerColor.r + t * (edgeColor.r - centerColor.r));
+                int g = (int)(centerColor.g + t * (edgeColor.g - centerColor.g));
+                int b = (int)(centerColor.b + t * (edgeColor.b - centerColor.b));
+                uint32_t dst = row[x];
+                int dr = (dst >> 16) & 0xFF, dg = (dst >> 8) & 0xFF, db = dst & 0xFF;
+                dr += (r - dr) * a / 255;
+                dg += (g - dg) * a / 255;
+                db += (b - db) * a / 255;
+                row[x] = (dst & 0xFF000000u) | ((uint32_t)dr << 16) | ((uint32_t)dg << 8) | (uint32_t)db;
+            }
+        }
+    });
+    if (drawn) {
+        return;
+    }
+    
     // Draw concentric circles from outside to inside for proper layering
     // Use adaptive step count based on radius for better quality/performance balance
     const int steps = std::max(10, std::min(maxRadius / 2, 50));
@@ -388,7 +939,6 @@ void X11RenderBackend::DrawRadialGradient(const RECT& rect, Color centerColor, C
 
 void X11RenderBackend::DrawShadow(const RECT& rect, int offsetX, int offsetY, int blur, Color shadowColor)
 {
-    // Simplified implementation - just draw a slightly offset rectangle
     if (!m_initialized || !m_display || !m_backBuffer || !m_gc) {
         return;
     }
@@ -400,41 +950,381 @@ void X11RenderBackend::DrawShadow(const RECT& rect, int offsetX, int offsetY, in
         rect.bottom + offsetY
     };
     
-    SetGCColor(shadowColor);
-    XFillRectangle(m_display, m_backBuffer, m_gc,
-        shadowRect.left, shadowRect.top,
-        shadowRect.right - shadowRect.left,
-        shadowRect.bottom - shadowRect.top);
+    auto tile = ShadowCache::GetShadow(blur, 0, shadowColor);
+    WithBackBufferPixels(ShadowCache::GetOuterRect(*tile, shadowRect),
+        [&](uint32_t* pixels, int left, int top, int width, int height, int stride) {
+            ShadowCache::Composite(*tile, shadowRect, pixels, left, top, width, height, stride);
+        });
 }
 
 void X11RenderBackend::DrawGlow(const RECT& rect, int radius, Color glowColor)
 {
-    // Simplified implementation - not implemented for basic X11
+    if (!m_initialized || radius <= 0) {
+        return;
+    }
+    
+    auto tile = ShadowCache::GetGlow(radius, glowColor);
+    WithBackBufferPixels(ShadowCache::GetOuterRect(*tile, rect),
+        [&](uint32_t* pixels, int left, int top, int width, int height, int stride) {
+            ShadowCache::Composite(*tile, rect, pixels, left, top, width, height, stride);
+        });
+}
+
+template<typename Fn>
+bool X11RenderBackend::WithBackBufferPixels(const RECT& rect, Fn&& kernel)
+{
+    if (!m_display || !m_backBuffer) return false;
+    
+    int left = std::max(0, (int)rect.left);
+    int top = std::max(0, (int)rect.top);
+    int right = std::min(m_width, (int)rect.right);
+    int bottom = std::min(m_height, (int)rect.bottom);
+    if (right <= left || bottom <= top) return true;
+    
+    int width = right - left;
+    int height = bottom - top;
+    
+    // Kernels operate on 32-bit 0xAARRGGBB words; other visuals are left untouched
+    const uint16_t probe = 1;
+    int hostByteOrder = (*reinterpret_cast<const uint8_t*>(&probe) == 1) ? LSBFirst : MSBFirst;
+    auto usable = [&](const XImage* image) {
+        return image->bits_per_pixel == 32 && image->byte_order == hostByteOrder && image->bytes_per_line % 4 == 0;
+    };
+    
+#if SDK_HAS_XSHM
+    X11Acceleration& accel = *m_accel;
+    if (accel.shmAttached) {
+        // The server reads and writes the shared segment directly. Its next
+        // GetImage is ordered after this PutImage, so no sync is needed between calls.
+        XImage* image = XShmCreateImage(m_display, accel.visual, accel.depth, ZPixmap,
+            accel.shm.shmaddr, &accel.shm, width, height);
+        bool done = false;
+        if (image) {
+            if (usable(image) && (size_t)image->bytes_per_line * height <= accel.shmSize &&
+                XShmGetImage(m_display, m_backBuffer, image, left, top, AllPlanes)) {
+                kernel(reinterpret_cast<uint32_t*>(image->data), left, top, width, height, image->bytes_per_line / 4);
+                XShmPutImage(m_display, m_backBuffer, m_gc, image, 0, 0, left, top, width, height, False);
+                done = true;
+            }
+            image->data = nullptr;  // The segment isn't the image's to free
+            XDestroyImage(image);
+        }
+        if (done) return true;
+    }
+#endif
+    
+    XImage* image = XGetImage(m_display, m_backBuffer, left, top, width, height, AllPlanes, ZPixmap);
+    if (!image) return false;
+    
+    bool done = usable(image);
+    if (done) {
+        kernel(reinterpret_cast<uint32_t*>(image->data), left, top, width, height, image->bytes_per_line / 4);
+        XPutImage(m_display, m_backBuffer, m_gc, image, 0, 0, left, top, width, height);
+    }
+    
+    XDestroyImage(image);
+    return done;
 }
 
 void X11RenderBackend::ApplyBlur(const RECT& rect, int blurRadius)
 {
-    // Not supported in basic X11
+    if (blurRadius <= 0) return;
+    
+    WithBackBufferPixels(rect, [&](uint32_t* pixels, int, int, int width, int height, int stride) {
+        PixelKernels::BoxBlur(pixels, width, height, stride, blurRadius);
+    });
 }
 
 void X11RenderBackend::ApplyBloom(const RECT& rect, float threshold, float intensity)
 {
-    // Not supported in basic X11
+    WithBackBufferPixels(rect, [&](uint32_t* pixels, int, int, int width, int height, int stride) {
+        PixelKernels::Bloom(pixels, width, height, stride, threshold, intensity);
+    });
 }
 
 void X11RenderBackend::ApplyDepthOfField(const RECT& rect, int focalDepth, int blurAmount, float focalRange)
 {
-    // Not supported in basic X11
+    if (blurAmount <= 0) return;
+    
+    // Clipping may drop rows above the rect; keep the focal row where the caller put it
+    WithBackBufferPixels(rect, [&](uint32_t* pixels, int, int top, int width, int height, int stride) {
+        PixelKernels::DepthOfField(pixels, width, height, stride, focalDepth - (top - (int)rect.top), blurAmount, focalRange);
+    });
 }
 
 void X11RenderBackend::ApplyMotionBlur(const RECT& rect, int directionX, int directionY, float intensity)
 {
-    // Not supported in basic X11
+    WithBackBufferPixels(rect, [&](uint32_t* pixels, int, int, int width, int height, int stride) {
+        PixelKernels::MotionBlur(pixels, width, height, stride, directionX, directionY, intensity);
+    });
 }
 
 void X11RenderBackend::ApplyChromaticAberration(const RECT& rect, float strength, int offsetX, int offsetY)
 {
-    // Not supported in basic X11
+    WithBackBufferPixels(rect, [&](uint32_t* pixels, int, int, int width, int height, int stride) {
+        PixelKernels::ChromaticAberration(pixels, width, height, stride, strength, offsetX, offsetY);
+    });
+}
+
+void X11RenderBackend::ApplyEffectGraph(const RECT& rect, EffectGraph& graph)
+{
+    if (graph.IsEmpty()) return;
+    
+    // Clipping may drop rows above the rect, as in ApplyDepthOfField
+    WithBackBufferPixels(rect, [&](uint32_t* pixels, int, int top, int width, int height, int stride) {
+        graph.Run(pixels, width, height, stride, graph.GetSettings().focalDepth - (top - (int)rect.top));
+    });
+}
+
+void X11RenderBackend::ExecuteCommandList(const RenderCommandList& commands)
+{
+    if (!m_initialized || !m_display || !m_backBuffer || !m_gc) {
+        return;
+    }
+    
+    using CommandType = RenderCommandList::CommandType;
+    std::vector<XRectangle> rects;
+    std::vector<XSegment> segments;
+    
+    for (const auto& batch : commands.GetBatches()) {
+        const auto& first = commands.GetOrderedCommand(batch.first);
+        
+        bool filled = first.color.a > 0;
+        bool bordered = first.secondColor.a > 0 && first.width > 0;
+        
+        // Every command in a batch shares colors and width, so one GC setup covers it.
+        // Rectangles with both fill and border stay separate: batched fills would
+        // cover borders of overlapping rectangles drawn earlier.
+#if SDK_HAS_XRENDER
+        if (m_accel->backPicture) {
+            // Blended fills batch into one request; strokes go through the
+            // antialiased primitives
+            if (batch.count > 1 && first.type == CommandType::RECTANGLE && filled && !bordered) {
+                rects.clear();
+                for (size_t i = batch.first; i < batch.first + batch.count; i++) {
+                    const RECT& rect = commands.GetOrderedCommand(i).rect;
+                    rects.push_back(XRectangle{ (short)rect.left, (short)rect.top,
+                        (unsigned short)std::max(0L, rect.right - rect.left),
+                        (unsigned short)std::max(0L, rect.bottom - rect.top) });
+                }
+                XRenderColor fill = ToPremultiplied(first.color);
+                XRenderFillRectangles(m_display, PictOpOver, m_accel->backPicture, &fill, rects.data(), (int)rects.size());
+            } else {
+                commands.Replay(*this, batch);
+            }
+            continue;
+        }
+#endif
+        
+        if (batch.count > 1 && first.type == CommandType::RECTANGLE && filled != bordered) {
+            rects.clear();
+            for (size_t i = batch.first; i < batch.first + batch.count; i++) {
+                const RECT& rect = commands.GetOrderedCommand(i).rect;
+                rects.push_back(XRectangle{ (short)rect.left, (short)rect.top,
+                    (unsigned short)std::max(0L, rect.right - rect.left),
+                    (unsigned short)std::max(0L, rect.bottom - rect.top) });
+            }
+            if (filled) {
+                SetGCColor(first.color);
+                XFillRectangles(m_display, m_backBuffer, m_gc, rects.data(), (int)rects.size());
+            } else {
+                SetGCColor(first.secondColor);
+                XSetLineAttributes(m_display, m_gc, first.width, LineSolid, CapRound, JoinRound);
+                XDrawRectangles(m_display, m_backBuffer, m_gc, rects.data(), (int)rects.size());
+            }
+        } else if (batch.count > 1 && first.type == CommandType::LINE) {
+            segments.clear();
+            for (size_t i = batch.first; i < batch.first + batch.count; i++) {
+                const RECT& ends = commands.GetOrderedCommand(i).rect;
+                segments.push_back(XSegment{ (short)ends.left, (short)ends.top, (short)ends.right, (short)ends.bottom });
+            }
+            SetGCColor(first.color);
+            XSetLineAttributes(m_display, m_gc, first.width, LineSolid, CapRound, JoinRound);
+            XDrawSegments(m_display, m_backBuffer, m_gc, segments.data(), (int)segments.size());
+        } else {
+            commands.Replay(*this, batch);
+        }
+    }
+}
+
+void X11RenderBackend::DrawParticleBatch(const float* x, const float* y, const uint32_t* colors, size_t count, int size)
+{
+    RECT clip = { 0, 0, m_width, m_height };
+    RECT bounds;
+    if (!GetParticleBounds(x, y, count, size, clip, bounds)) return;
+    
+    WithBackBufferPixels(bounds, [&](uint32_t* pixels, int left, int top, int width, int height, int stride) {
+        PixelKernels::SplatParticles(pixels, width, height, stride, x, y, colors, count, left, top, size);
+    });
+}
+
+void X11RenderBackend::DrawAtlasTexture(const TextureAtlas& atlas, const std::string& name, const RECT& dest)
+{
+    const TextureAtlas::AtlasEntry* entry = atlas.GetTexture(name);
+    int destWidth = dest.right - dest.left;
+    int destHeight = dest.bottom - dest.top;
+    if (!entry || destWidth <= 0 || destHeight <= 0) return;
+    
+#if SDK_HAS_XRENDER
+    if (m_accel->backPicture && UploadAtlas(atlas)) {
+        // Map destination pixels back onto the entry; nearest filtering, like the copy below
+        double sx = (double)entry->width / destWidth;
+        double sy = (double)entry->height / destHeight;
+        XTransform transform = {{
+            { XDoubleToFixed(sx), 0, XDoubleToFixed(entry->x - dest.left * sx) },
+            { 0, XDoubleToFixed(sy), XDoubleToFixed(entry->y - dest.top * sy) },
+            { 0, 0, XDoubleToFixed(1) }
+        }};
+        XRenderSetPictureTransform(m_display, m_accel->atlasPicture, &transform);
+        XRenderComposite(m_display, PictOpSrc, m_accel->atlasPicture, None, m_accel->backPicture,
+            dest.left, dest.top, 0, 0, dest.left, dest.top, destWidth, destHeight);
+        return;
+    }
+#endif
+    
+    const uint32_t* source = atlas.GetPixels();
+    int sourceStride = atlas.GetWidth();
+    WithBackBufferPixels(dest, [&](uint32_t* pixels, int left, int top, int width, int height, int stride) {
+        for (int y = 0; y < height; y++) {
+            int sy = entry->y + (int)((int64_t)(top + y - dest.top) * entry->height / destHeight);
+            const uint32_t* in = source + (size_t)sy * sourceStride;
+            uint32_t* out = pixels + (size_t)y * stride;
+            for (int x = 0; x < width; x++) {
+                out[x] = in[entry->x + (int)((int64_t)(left + x - dest.left) * entry->width / destWidth)];
+            }
+        }
+    });
+}
+
+bool X11RenderBackend::UploadAtlas(const TextureAtlas& atlas)
+{
+#if SDK_HAS_XRENDER
+    X11Acceleration& accel = *m_accel;
+    if (accel.atlas == &atlas && accel.atlasVersion == atlas.GetVersion()) {
+        return true;
+    }
+    
+    // Another atlas, or a different size: start over
+    if (accel.atlas != &atlas && accel.atlasPixmap) {
+        XRenderFreePicture(m_display, accel.atlasPicture);
+        XFreePixmap(m_display, accel.atlasPixmap);
+        accel.atlasPicture = 0;
+        accel.atlasPixmap = 0;
+    }
+    
+    // Same depth and format as the back buffer; the atlas alpha is ignored, as on GDI
+    XImage* image = XCreateImage(m_display, accel.visual, accel.depth, ZPixmap, 0,
+        reinterpret_cast<char*>(const_cast<uint32_t*>(atlas.GetPixels())),
+        atlas.GetWidth(), atlas.GetHeight(), 32, atlas.GetWidth() * 4);
+    if (!image) {
+        return false;
+    }
+    const uint16_t probe = 1;
+    int hostByteOrder = (*reinterpret_cast<const uint8_t*>(&probe) == 1) ? LSBFirst : MSBFirst;
+    bool usable = image->bits_per_pixel == 32 && image->byte_order == hostByteOrder;
+    
+    if (usable && !accel.atlasPixmap) {
+        accel.atlasPixmap = XCreatePixmap(m_display, m_window, atlas.GetWidth(), atlas.GetHeight(), accel.depth);
+        accel.atlasPicture = XRenderCreatePicture(m_display, accel.atlasPixmap,
+            XRenderFindVisualFormat(m_display, accel.visual), 0, nullptr);
+    }
+    if (usable) {
+        XPutImage(m_display, accel.atlasPixmap, m_gc, image, 0, 0, 0, 0, atlas.GetWidth(), atlas.GetHeight());
+        accel.atlas = &atlas;
+        accel.atlasVersion = atlas.GetVersion();
+    }
+    
+    image->data = nullptr;  // Still owned by the atlas
+    XDestroyImage(image);
+    return usable;
+#else
+    (void)atlas;
+    return false;
+#endif
+}
+
+const GlyphAtlas::Run* X11RenderBackend::LayoutText(const std::wstring& text, const std::wstring& fontFamily, float fontSize,
+                                                     int fontWeight, int& ascent, int& descent)
+{
+#if SDK_X11_ATLAS_TEXT
+    if (!m_display || !IsRenderActive()) {
+        return nullptr;
+    }
+    X11Text& state = *m_text;
+    if (!state.fonts) {
+        state.fonts.reset(new XftFontSource(m_display));
+    }
+    
+    uint32_t id;
+    if (!state.fonts->GetFont(fontFamily, fontSize, fontWeight, id, ascent, descent)) {
+        return nullptr;
+    }
+    if (!state.atlas) {
+        state.atlas.reset(new GlyphAtlas(GLYPH_ATLAS_WIDTH, GLYPH_ATLAS_HEIGHT, state.fonts->GetRasterizer()));
+    }
+    return &state.atlas->GetRun(id, text);
+#else
+    (void)text; (void)fontFamily; (void)fontSize; (void)fontWeight;
+    ascent = descent = 0;
+    return nullptr;
+#endif
+}
+
+void X11RenderBackend::DrawRun(const GlyphAtlas::Run& run, int x, int baseline, Color color)
+{
+#if SDK_X11_ATLAS_TEXT
+    if (run.glyphs.empty() || !m_accel->backPicture || !UploadGlyphs()) {
+        return;
+    }
+    
+    // One composite per glyph, queued without a round trip; the coverage is the mask
+    Picture source = SolidSource(m_display, *m_accel, color);
+    for (const GlyphAtlas::RunGlyph& placed : run.glyphs) {
+        const GlyphAtlas::Glyph& glyph = *placed.glyph;
+        XRenderComposite(m_display, PictOpOver, source, m_text->atlasPicture, m_accel->backPicture,
+            0, 0, glyph.x, glyph.y, x + placed.x + glyph.left, baseline - glyph.top, glyph.width, glyph.height);
+    }
+#else
+    (void)run; (void)x; (void)baseline; (void)color;
+#endif
+}
+
+bool X11RenderBackend::UploadGlyphs()
+{
+#if SDK_X11_ATLAS_TEXT
+    X11Text& state = *m_text;
+    GlyphAtlas& atlas = *state.atlas;
+    
+    RECT dirty;
+    if (!state.atlasPixmap) {
+        state.atlasPixmap = XCreatePixmap(m_display, m_window, atlas.GetWidth(), atlas.GetHeight(), 8);
+        state.atlasPicture = XRenderCreatePicture(m_display, state.atlasPixmap, m_accel->maskFormat, 0, nullptr);
+        state.atlasGC = XCreateGC(m_display, state.atlasPixmap, 0, nullptr);
+        dirty = { 0, 0, atlas.GetWidth(), atlas.GetHeight() };
+    } else if (!atlas.GetDirtyRect(dirty)) {
+        return true;
+    }
+    
+    // Whole rows from the top of the dirty rect; only its columns are sent
+    int rows = dirty.bottom - dirty.top;
+    XImage* image = XCreateImage(m_display, m_accel->visual, 8, ZPixmap, 0,
+        reinterpret_cast<char*>(const_cast<uint8_t*>(atlas.GetCoverage() + (size_t)dirty.top * atlas.GetWidth())),
+        atlas.GetWidth(), rows, 8, atlas.GetWidth());
+    if (!image) {
+        return false;
+    }
+    bool usable = image->bits_per_pixel == 8;
+    if (usable) {
+        XPutImage(m_display, state.atlasPixmap, state.atlasGC, image, dirty.left, 0, dirty.left, dirty.top,
+            dirty.right - dirty.left, rows);
+        atlas.ClearDirtyRect();
+    }
+    image->data = nullptr;  // Still owned by the atlas
+    XDestroyImage(image);
+    return usable;
+#else
+    return false;
+#endif
 }
 
 RenderBackend::Capabilities X11RenderBackend::GetCapabilities() const
@@ -442,7 +1332,7 @@ RenderBackend::Capabilities X11RenderBackend::GetCapabilities() const
     Capabilities caps;
     caps.supportsGPUAcceleration = false;
     caps.supportsAdvancedEffects = false;
-    caps.supportsAntialiasing = false;
+    caps.supportsAntialiasing = IsRenderActive();
     caps.supportsTransparency = true;
     caps.maxTextureSize = 4096;
     return caps;
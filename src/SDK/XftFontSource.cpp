@@ -0,0 +1,160 @@
+#include "SDK/XftFontSource.h"
+
+#if SDK_PLATFORM_LINUX && SDK_HAS_X11
+
+#include "SDK/StringUtils.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <unordered_map>
+#include <vector>
+
+#ifndef SDK_HAS_XFT
+#define SDK_HAS_XFT 0
+#endif
+
+#if SDK_HAS_XFT
+#include <X11/Xft/Xft.h>
+#endif
+
+namespace SDK {
+
+struct XftFontSet {
+#if SDK_HAS_XFT
+    std::vector<XftFont*> fonts;                        // Indexed by font id; null when opening failed
+    std::unordered_map<std::wstring, uint32_t> ids;     // Keyed by family, size and weight
+    std::wstring key;                                   // Reused for lookups
+#endif
+};
+
+#if SDK_HAS_XFT
+namespace {
+    // Windows-style weights (100-900) to fontconfig's scale
+    int FontconfigWeight(int weight)
+    {
+        if (weight < 350) return FC_WEIGHT_LIGHT;
+        if (weight < 450) return FC_WEIGHT_REGULAR;
+        if (weight < 550) return FC_WEIGHT_MEDIUM;
+        if (weight < 650) return FC_WEIGHT_DEMIBOLD;
+        if (weight < 750) return FC_WEIGHT_BOLD;
+        return FC_WEIGHT_BLACK;
+    }
+
+    // Xft picked and sized the face; FreeType renders the coverage
+    bool RasterizeGlyph(XftFont* font, uint32_t codepoint, GlyphAtlas::Bitmap& bitmap)
+    {
+        FT_Face face = XftLockFace(font);
+        if (!face) {
+            return false;
+        }
+        bool rendered = FT_Load_Char(face, codepoint, FT_LOAD_RENDER) == 0;
+        const FT_GlyphSlot slot = face->glyph;
+        const FT_Bitmap& source = slot->bitmap;
+        rendered = rendered && (source.pixel_mode == FT_PIXEL_MODE_GRAY || source.pixel_mode == FT_PIXEL_MODE_MONO);
+        if (rendered) {
+            bitmap.width = (int)source.width;
+            bitmap.height = (int)source.rows;
+            bitmap.left = slot->bitmap_left;
+            bitmap.top = slot->bitmap_top;
+            bitmap.advance = (int)((slot->advance.x + 32) >> 6);
+            bitmap.coverage.resize((size_t)bitmap.width * bitmap.height);
+            for (int y = 0; y < bitmap.height; y++) {
+                // A negative pitch means the rows are stored bottom-up
+                int row = source.pitch >= 0 ? y : bitmap.height - 1 - y;
+                const uint8_t* in = source.buffer + (ptrdiff_t)row * std::abs(source.pitch);
+                uint8_t* out = &bitmap.coverage[(size_t)y * bitmap.width];
+                for (int x = 0; x < bitmap.width; x++) {
+                    out[x] = source.pixel_mode == FT_PIXEL_MODE_GRAY ? in[x] : ((in[x >> 3] >> (7 - (x & 7))) & 1) * 255;
+                }
+            }
+        }
+        XftUnlockFace(font);
+        return rendered;
+    }
+}
+#endif
+
+XftFontSource::XftFontSource(Display* display)
+    : m_display(display)
+    , m_fonts(new XftFontSet())
+{
+}
+
+XftFontSource::~XftFontSource()
+{
+#if SDK_HAS_XFT
+    for (XftFont* font : m_fonts->fonts) {
+        if (font) XftFontClose(m_display, font);
+    }
+#endif
+}
+
+bool XftFontSource::GetFont(const std::wstring& fontFamily, float fontSize, int fontWeight,
+                            uint32_t& id, int& ascent, int& descent)
+{
+#if SDK_HAS_XFT
+    if (!m_display) {
+        return false;
+    }
+    XftFontSet& set = *m_fonts;
+
+    int pixelSize = std::max(1, (int)std::lround(fontSize > 0 ? fontSize : 12.0f));
+    std::wstring& key = set.key;
+    key.assign(fontFamily).push_back(L'|');
+    AppendDecimal(key, pixelSize);
+    key.push_back(L'|');
+    AppendDecimal(key, fontWeight);
+    auto found = set.ids.find(key);
+    if (found == set.ids.end()) {
+        std::string family = fontFamily.empty() ? std::string("sans-serif") : WStringToUTF8(fontFamily);
+        XftFont* font = XftFontOpen(m_display, DefaultScreen(m_display),
+            FC_FAMILY, FcTypeString, family.c_str(),
+            FC_PIXEL_SIZE, FcTypeDouble, (double)pixelSize,
+            FC_WEIGHT, FcTypeInteger, FontconfigWeight(fontWeight),
+            FC_ANTIALIAS, FcTypeBool, FcTrue,
+            nullptr);
+        found = set.ids.emplace(key, (uint32_t)set.fonts.size()).first;
+        set.fonts.push_back(font);
+    }
+    XftFont* font = set.fonts[found->second];
+    if (!font) {
+        return false;
+    }
+    id = found->second;
+    ascent = font->ascent;
+    descent = font->descent;
+    return true;
+#else
+    (void)fontFamily; (void)fontSize; (void)fontWeight;
+    id = 0;
+    ascent = descent = 0;
+    return false;
+#endif
+}
+
+bool XftFontSource::Rasterize(uint32_t id, uint32_t codepoint, GlyphAtlas::Bitmap& bitmap)
+{
+#if SDK_HAS_XFT
+    const std::vector<XftFont*>& fonts = m_fonts->fonts;
+    return id < fonts.size() && fonts[id] && RasterizeGlyph(fonts[id], codepoint, bitmap);
+#else
+    (void)id; (void)codepoint; (void)bitmap;
+    return false;
+#endif
+}
+
+GlyphAtlas::Rasterizer XftFontSource::GetRasterizer()
+{
+    return [this](uint32_t id, uint32_t codepoint, GlyphAtlas::Bitmap& bitmap) {
+        return Rasterize(id, codepoint, bitmap);
+    };
+}
+
+bool XftFontSource::IsAvailable()
+{
+    return SDK_HAS_XFT != 0;
+}
+
+} // namespace SDK
+
+#endif // SDK_PLATFORM_LINUX && SDK_HAS_X11